@@ -0,0 +1,393 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Render a list of XML scenes in the background and report the time spent in each stage
+ * (scene loading, shader and kernel compilation, BVH building, sampling) as JSON, so the
+ * numbers can be compared across builds and machines. */
+
+#include <stdio.h>
+
+#include "device/device.h"
+#include "render/buffers.h"
+#include "render/camera.h"
+#include "render/scene.h"
+#include "render/session.h"
+#include "render/stats.h"
+
+#include "util/util_args.h"
+#include "util/util_foreach.h"
+#include "util/util_function.h"
+#include "util/util_logging.h"
+#include "util/util_map.h"
+#include "util/util_path.h"
+#include "util/util_progress.h"
+#include "util/util_string.h"
+#include "util/util_system.h"
+#include "util/util_time.h"
+#include "util/util_vector.h"
+#include "util/util_version.h"
+
+#include "app/cycles_xml.h"
+
+CCL_NAMESPACE_BEGIN
+
+struct Options {
+  vector<string> filepaths;
+  int width, height;
+  SceneParams scene_params;
+  SessionParams session_params;
+  string output_path;
+} options;
+
+/* Accumulates wall-clock time per render stage, the stage being derived from the status the
+ * session reports. Progress callbacks are serialized by Progress itself. */
+class StageTimer {
+ public:
+  explicit StageTimer(Progress *progress) : progress_(progress), stage_start_(0.0)
+  {
+  }
+
+  void update()
+  {
+    string status, substatus;
+    progress_->get_status(status, substatus);
+    switch_to(stage_from_status(status, substatus));
+  }
+
+  void finish()
+  {
+    switch_to("");
+  }
+
+  double get(const string &stage) const
+  {
+    map<string, double>::const_iterator it = times_.find(stage);
+    return (it != times_.end()) ? it->second : 0.0;
+  }
+
+ protected:
+  static string stage_from_status(const string &status, const string &substatus)
+  {
+    if (string_startswith(status, "Finished") || string_startswith(status, "Cancel")) {
+      return "";
+    }
+    if (string_endswith(status, "BVH") || string_endswith(substatus, "BVH")) {
+      return "bvh";
+    }
+    if (status == "Updating Shaders") {
+      return "shaders";
+    }
+    if (string_startswith(status, "Loading render kernels") ||
+        string_startswith(status, "Compiling render kernels")) {
+      return "kernels";
+    }
+    if (string_startswith(status, "Updating") || string_startswith(status, "Waiting")) {
+      return "scene_update";
+    }
+    return "render";
+  }
+
+  void switch_to(const string &stage)
+  {
+    if (stage == stage_) {
+      return;
+    }
+    const double now = time_dt();
+    if (!stage_.empty()) {
+      times_[stage_] += now - stage_start_;
+    }
+    stage_ = stage;
+    stage_start_ = now;
+  }
+
+  Progress *progress_;
+  string stage_;
+  double stage_start_;
+  map<string, double> times_;
+};
+
+static bool write_render(const uchar * /*pixels*/, int /*w*/, int /*h*/, int /*channels*/)
+{
+  /* The image itself is not needed, only the time it took. */
+  return true;
+}
+
+/* Render one scene, returning its report as a JSON object. */
+static string benchmark_scene(const string &filepath)
+{
+  Session *session = new Session(options.session_params);
+
+  double sync_time = 0.0;
+  {
+    scoped_timer timer(&sync_time);
+
+    session->scene = new Scene(options.scene_params, session->device);
+    xml_read_file(session->scene, filepath.c_str());
+
+    Camera *camera = session->scene->camera;
+    if (!(options.width == 0 || options.height == 0)) {
+      camera->width = options.width;
+      camera->height = options.height;
+    }
+    camera->compute_auto_viewplane();
+  }
+
+  const int width = session->scene->camera->width;
+  const int height = session->scene->camera->height;
+  const int samples = options.session_params.samples;
+
+  StageTimer stage_timer(&session->progress);
+  session->progress.set_update_callback(function_bind(&StageTimer::update, &stage_timer));
+
+  double total_time = 0.0;
+  {
+    scoped_timer timer(&total_time);
+
+    BufferParams buffer_params;
+    buffer_params.width = buffer_params.full_width = width;
+    buffer_params.height = buffer_params.full_height = height;
+
+    session->reset(buffer_params, samples);
+    session->start();
+    session->wait();
+    stage_timer.finish();
+  }
+
+  const bool cancelled = session->progress.get_cancel() || session->progress.get_error();
+
+  RenderStats stats;
+  session->collect_statistics(&stats);
+
+  delete session;
+
+  const double render_time = stage_timer.get("render");
+  const double pixel_samples = (double)width * height * samples;
+
+  string result = string_printf("{\"file\": %s, ", string_json_quote(filepath).c_str());
+  result += string_printf("\"width\": %d, \"height\": %d, \"samples\": %d, ",
+                          width,
+                          height,
+                          samples);
+  result += string_printf("\"completed\": %s, ", cancelled ? "false" : "true");
+  result += string_printf(
+      "\"times\": {\"sync\": %.3f, \"shaders\": %.3f, \"kernels\": %.3f, \"bvh\": %.3f, "
+      "\"scene_update\": %.3f, \"render\": %.3f, \"total\": %.3f}, ",
+      sync_time,
+      stage_timer.get("shaders"),
+      stage_timer.get("kernels"),
+      stage_timer.get("bvh"),
+      stage_timer.get("scene_update"),
+      render_time,
+      sync_time + total_time);
+  result += string_printf("\"samples_per_second\": %.3f, \"pixel_samples_per_second\": %.1f, ",
+                          (render_time > 0.0) ? samples / render_time : 0.0,
+                          (render_time > 0.0) ? pixel_samples / render_time : 0.0);
+  result += "\"stats\": " + stats.json_report() + "}";
+  return result;
+}
+
+static int files_parse(int argc, const char *argv[])
+{
+  for (int i = 0; i < argc; i++) {
+    options.filepaths.push_back(argv[i]);
+  }
+
+  return 0;
+}
+
+static void options_parse(int argc, const char **argv)
+{
+  options.width = 0;
+  options.height = 0;
+
+  /* device names */
+  string device_names = "";
+  string devicename = "CPU";
+
+  /* List devices for which support is compiled in. */
+  vector<DeviceType> types = Device::available_types();
+  foreach (DeviceType type, types) {
+    if (device_names != "")
+      device_names += ", ";
+
+    device_names += Device::string_from_type(type);
+  }
+
+  /* shading system */
+  string ssname = "svm";
+
+  /* parse options */
+  ArgParse ap;
+  bool help = false, debug = false, version = false;
+  int verbosity = 1;
+
+  options.session_params.samples = 16;
+
+  ap.options("Usage: cycles_benchmark [options] file.xml [file.xml ...]",
+             "%*",
+             files_parse,
+             "",
+             "--device %s",
+             &devicename,
+             ("Devices to use: " + device_names).c_str(),
+#ifdef WITH_OSL
+             "--shadingsys %s",
+             &ssname,
+             "Shading system to use: svm, osl",
+#endif
+             "--samples %d",
+             &options.session_params.samples,
+             "Number of samples to render (default 16)",
+             "--output %s",
+             &options.output_path,
+             "File path to write the JSON report to, instead of the standard output",
+             "--threads %d",
+             &options.session_params.threads,
+             "CPU Rendering Threads",
+             "--width  %d",
+             &options.width,
+             "Override the render width in pixels",
+             "--height %d",
+             &options.height,
+             "Override the render height in pixels",
+             "--tile-width %d",
+             &options.session_params.tile_size.x,
+             "Tile width in pixels",
+             "--tile-height %d",
+             &options.session_params.tile_size.y,
+             "Tile height in pixels",
+             "--profile",
+             &options.session_params.use_profiling,
+             "Include the kernel, shader and object profile in the report (CPU only)",
+#ifdef WITH_CYCLES_LOGGING
+             "--debug",
+             &debug,
+             "Enable debug logging",
+             "--verbose %d",
+             &verbosity,
+             "Set verbosity of the logger",
+#endif
+             "--help",
+             &help,
+             "Print help message",
+             "--version",
+             &version,
+             "Print version number",
+             NULL);
+
+  if (ap.parse(argc, argv) < 0) {
+    fprintf(stderr, "%s\n", ap.geterror().c_str());
+    ap.usage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (debug) {
+    util_logging_start();
+    util_logging_verbosity_set(verbosity);
+  }
+
+  if (version) {
+    printf("%s\n", CYCLES_VERSION_STRING);
+    exit(EXIT_SUCCESS);
+  }
+  else if (help || options.filepaths.empty()) {
+    ap.usage();
+    exit(EXIT_SUCCESS);
+  }
+
+  if (ssname == "osl")
+    options.scene_params.shadingsystem = SHADINGSYSTEM_OSL;
+  else if (ssname == "svm")
+    options.scene_params.shadingsystem = SHADINGSYSTEM_SVM;
+
+  /* Same session setup as the standalone application in background mode. */
+  options.session_params.background = true;
+  options.session_params.progressive = true;
+  options.session_params.write_render_cb = write_render;
+
+  /* find matching device */
+  DeviceType device_type = Device::type_from_string(devicename.c_str());
+  vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK(device_type));
+
+  bool device_available = false;
+  if (!devices.empty()) {
+    options.session_params.device = devices.front();
+    device_available = true;
+  }
+
+  /* handle invalid configurations */
+  if (options.session_params.device.type == DEVICE_NONE || !device_available) {
+    fprintf(stderr, "Unknown device: %s\n", devicename.c_str());
+    exit(EXIT_FAILURE);
+  }
+#ifdef WITH_OSL
+  else if (!(ssname == "osl" || ssname == "svm")) {
+    fprintf(stderr, "Unknown shading system: %s\n", ssname.c_str());
+    exit(EXIT_FAILURE);
+  }
+  else if (options.scene_params.shadingsystem == SHADINGSYSTEM_OSL &&
+           options.session_params.device.type != DEVICE_CPU) {
+    fprintf(stderr, "OSL shading system only works with CPU device\n");
+    exit(EXIT_FAILURE);
+  }
+#endif
+  else if (options.session_params.samples <= 0) {
+    fprintf(stderr, "Invalid number of samples: %d\n", options.session_params.samples);
+    exit(EXIT_FAILURE);
+  }
+}
+
+CCL_NAMESPACE_END
+
+using namespace ccl;
+
+int main(int argc, const char **argv)
+{
+  util_logging_init(argv[0]);
+  path_init();
+  options_parse(argc, argv);
+
+  const DeviceInfo &device = options.session_params.device;
+
+  string report = "{";
+  report += string_printf("\"version\": %s, ", string_json_quote(CYCLES_VERSION_STRING).c_str());
+  report += string_printf("\"device\": %s, ", string_json_quote(device.description).c_str());
+  report += string_printf("\"device_type\": %s, ",
+                          string_json_quote(Device::string_from_type(device.type)).c_str());
+  report += string_printf("\"cpu\": %s, ", string_json_quote(system_cpu_brand_string()).c_str());
+  report += string_printf("\"threads\": %d, ", options.session_params.threads);
+  report += "\"scenes\": [";
+  for (size_t i = 0; i < options.filepaths.size(); i++) {
+    fprintf(stderr, "Rendering %s\n", options.filepaths[i].c_str());
+    report += ((i == 0) ? "" : ", ") + benchmark_scene(options.filepaths[i]);
+  }
+  report += "]}\n";
+
+  if (options.output_path.empty()) {
+    fputs(report.c_str(), stdout);
+  }
+  else {
+    FILE *f = path_fopen(options.output_path, "wb");
+    if (f == NULL) {
+      fprintf(stderr, "Failed to write report to %s\n", options.output_path.c_str());
+      return EXIT_FAILURE;
+    }
+    fputs(report.c_str(), f);
+    fclose(f);
+  }
+
+  return 0;
+}
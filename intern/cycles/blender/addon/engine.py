@@ -70,6 +70,10 @@ def _configure_argument_parser():
     parser.add_argument("--cycles-print-stats",
                         help="Print rendering statistics to stderr",
                         action='store_true')
+    parser.add_argument("--cycles-stats-json",
+                        help="Append rendering statistics as JSON lines to this file, "
+                             "# characters are replaced by the frame number",
+                        default=None)
     return parser
 
 
@@ -101,6 +105,9 @@ def _parse_command_line():
     if args.cycles_print_stats:
         import _cycles
         _cycles.enable_print_stats()
+    if args.cycles_stats_json is not None:
+        import _cycles
+        _cycles.set_stats_json_filepath(args.cycles_stats_json)
 
 
 def init():
@@ -257,6 +264,7 @@ def list_render_passes(scene, srl):
     if crl.pass_debug_bvh_intersections:       yield ("Debug BVH Intersections",       "X",   'VALUE')
     if crl.pass_debug_ray_bounces:             yield ("Debug Ray Bounces",             "X",   'VALUE')
     if crl.pass_debug_sample_count:            yield ("Debug Sample Count",            "X",   'VALUE')
+    if crl.pass_debug_adaptive_error:          yield ("Debug Adaptive Error",          "X",   'VALUE')
     if crl.use_pass_volume_direct:             yield ("VolumeDir",                     "RGB", 'COLOR')
     if crl.use_pass_volume_indirect:           yield ("VolumeInd",                     "RGB", 'COLOR')
 
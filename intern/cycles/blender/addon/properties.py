@@ -391,6 +391,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Sample lights and emissive meshes based on their distance, orientation and strength "
+        "relative to the shading point, reducing noise in scenes with many lights. "
+        "Not used when sampling all lights with branched path tracing",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -794,6 +801,21 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    texture_memory_limit: IntProperty(
+        name="Texture Memory Limit",
+        description="Maximum amount of memory in megabytes used by image textures, the biggest "
+        "textures are scaled down until all of them fit (0 means no limit)",
+        default=0,
+        min=0, soft_max=65536,
+    )
+
+    use_half_float_images: BoolProperty(
+        name="Half Float Images",
+        description="Store float color images as half float, halving their memory usage and upload time "
+        "(non-color data keeps full precision)",
+        default=False,
+    )
+
     ao_bounces: IntProperty(
         name="AO Bounces",
         default=0,
@@ -1363,6 +1385,13 @@ class CyclesRenderLayerSettings(bpy.types.PropertyGroup):
         default=False,
         update=update_render_passes,
     )
+    pass_debug_adaptive_error: BoolProperty(
+        name="Debug Adaptive Error",
+        description="Per pixel error estimate of adaptive sampling relative to the noise threshold, "
+        "pixels with a value below one have converged",
+        default=False,
+        update=update_render_passes,
+    )
     use_pass_volume_direct: BoolProperty(
         name="Volume Direct",
         description="Deliver direct volumetric scattering pass",
@@ -24,6 +24,7 @@
 #include "blender/blender_util.h"
 
 #include "util/util_foreach.h"
+#include "util/util_task.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -115,23 +116,40 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
     return geom;
   }
 
-  progress.set_sync_status("Synchronizing object", b_ob.name());
-
   geometry_synced.insert(geom);
 
   geom->name = ustring(b_ob_data.name().c_str());
 
-  if (b_ob.type() == BL::Object::type_HAIR || use_particle_hair) {
-    Hair *hair = static_cast<Hair *>(geom);
-    sync_hair(b_depsgraph, b_ob, hair, used_shaders);
-  }
-  else if (b_ob.type() == BL::Object::type_VOLUME || object_fluid_gas_domain_find(b_ob)) {
-    Mesh *mesh = static_cast<Mesh *>(geom);
-    sync_volume(b_ob, mesh, used_shaders);
+  const bool is_volume = (geom_type == Geometry::MESH) &&
+                         (b_ob.type() == BL::Object::type_VOLUME ||
+                          object_fluid_gas_domain_find(b_ob));
+
+  TaskRunFunction sync_func = [this, b_depsgraph, b_ob, geom, is_volume, used_shaders]() mutable {
+    progress.set_sync_status("Synchronizing object", b_ob.name());
+
+    if (geom->type == Geometry::HAIR) {
+      Hair *hair = static_cast<Hair *>(geom);
+      sync_hair(b_depsgraph, b_ob, hair, used_shaders);
+    }
+    else if (is_volume) {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      sync_volume(b_ob, mesh, used_shaders);
+    }
+    else {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      sync_mesh(b_depsgraph, b_ob, mesh, used_shaders);
+    }
+  };
+
+  /* Instances point to a temporary object of the depsgraph iterator, which is only valid
+   * during this iteration, so they are synced right away. */
+  if (b_ob.ptr.data != b_ob_instance.ptr.data) {
+    sync_func();
   }
   else {
-    Mesh *mesh = static_cast<Mesh *>(geom);
-    sync_mesh(b_depsgraph, b_ob, mesh, used_shaders);
+    /* Tagged already so the object sync sees the geometry as updated. */
+    geom->need_update = true;
+    defer_geometry_sync(b_ob, std::move(sync_func));
   }
 
   return geom;
@@ -139,9 +157,9 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
 
 void BlenderSync::sync_geometry_motion(BL::Depsgraph &b_depsgraph,
                                        BL::Object &b_ob,
+                                       BL::Object &b_ob_instance,
                                        Object *object,
-                                       float motion_time,
-                                       bool use_particle_hair)
+                                       float motion_time)
 {
   /* Ensure we only sync instanced geometry once. */
   Geometry *geom = object->geometry;
@@ -162,17 +180,62 @@ void BlenderSync::sync_geometry_motion(BL::Depsgraph &b_depsgraph,
     return;
   }
 
-  if (b_ob.type() == BL::Object::type_HAIR || use_particle_hair) {
-    Hair *hair = static_cast<Hair *>(geom);
-    sync_hair_motion(b_depsgraph, b_ob, hair, motion_step);
+  /* No volume motion blur support yet. */
+  if (geom->type == Geometry::MESH &&
+      (b_ob.type() == BL::Object::type_VOLUME || object_fluid_gas_domain_find(b_ob))) {
+    return;
   }
-  else if (b_ob.type() == BL::Object::type_VOLUME || object_fluid_gas_domain_find(b_ob)) {
-    /* No volume motion blur support yet. */
+
+  TaskRunFunction sync_func = [this, b_depsgraph, b_ob, geom, motion_step]() mutable {
+    if (geom->type == Geometry::HAIR) {
+      Hair *hair = static_cast<Hair *>(geom);
+      sync_hair_motion(b_depsgraph, b_ob, hair, motion_step);
+    }
+    else {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      sync_mesh_motion(b_depsgraph, b_ob, mesh, motion_step);
+    }
+  };
+
+  if (b_ob.ptr.data != b_ob_instance.ptr.data) {
+    sync_func();
   }
   else {
-    Mesh *mesh = static_cast<Mesh *>(geom);
-    sync_mesh_motion(b_depsgraph, b_ob, mesh, motion_step);
+    defer_geometry_sync(b_ob, std::move(sync_func));
+  }
+}
+
+void BlenderSync::defer_geometry_sync(BL::Object &b_ob, TaskRunFunction &&func)
+{
+  /* Consecutive exports of the same object, like its mesh and particle hair, share a task. */
+  if (geometry_sync_tasks.empty() || geometry_sync_tasks.back().b_ob != b_ob.ptr.data) {
+    geometry_sync_tasks.push_back(GeometrySyncTask());
+    geometry_sync_tasks.back().b_ob = b_ob.ptr.data;
+  }
+
+  geometry_sync_tasks.back().funcs.push_back(std::move(func));
+}
+
+void BlenderSync::run_deferred_geometry_sync()
+{
+  if (!progress.get_cancel()) {
+    TaskPool pool;
+
+    foreach (GeometrySyncTask &task, geometry_sync_tasks) {
+      pool.push([this, &task]() {
+        foreach (TaskRunFunction &func, task.funcs) {
+          if (progress.get_cancel()) {
+            return;
+          }
+          func();
+        }
+      });
+    }
+
+    pool.wait_work();
   }
+
+  geometry_sync_tasks.clear();
 }
 
 CCL_NAMESPACE_END
@@ -198,7 +198,7 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
 
       /* mesh deformation */
       if (object->geometry)
-        sync_geometry_motion(b_depsgraph, b_ob, object, motion_time, use_particle_hair);
+        sync_geometry_motion(b_depsgraph, b_ob, b_ob_instance, object, motion_time);
     }
 
     return object;
@@ -399,6 +399,9 @@ void BlenderSync::sync_objects(BL::Depsgraph &b_depsgraph,
     cancel = progress.get_cancel();
   }
 
+  /* Export the geometry collected in the loop above. */
+  run_deferred_geometry_sync();
+
   progress.set_sync_status("");
 
   if (!cancel && !motion) {
@@ -702,15 +702,22 @@ static bool image_parse_filepaths(PyObject *pyfilepaths, vector<string> &filepat
 
 static PyObject *denoise_func(PyObject * /*self*/, PyObject *args, PyObject *keywords)
 {
-  static const char *keyword_list[] = {
-      "preferences", "scene", "view_layer", "input", "output", "tile_size", "samples", NULL};
+  static const char *keyword_list[] = {"preferences",
+                                       "scene",
+                                       "view_layer",
+                                       "input",
+                                       "output",
+                                       "tile_size",
+                                       "samples",
+                                       "prefetch_frames",
+                                       NULL};
   PyObject *pypreferences, *pyscene, *pyviewlayer;
   PyObject *pyinput, *pyoutput = NULL;
-  int tile_size = 0, samples = 0;
+  int tile_size = 0, samples = 0, prefetch_frames = -1;
 
   if (!PyArg_ParseTupleAndKeywords(args,
                                    keywords,
-                                   "OOOO|Oii",
+                                   "OOOO|Oiii",
                                    (char **)keyword_list,
                                    &pypreferences,
                                    &pyscene,
@@ -718,7 +725,8 @@ static PyObject *denoise_func(PyObject * /*self*/, PyObject *args, PyObject *key
                                    &pyinput,
                                    &pyoutput,
                                    &tile_size,
-                                   &samples)) {
+                                   &samples,
+                                   &prefetch_frames)) {
     return NULL;
   }
 
@@ -786,6 +794,9 @@ static PyObject *denoise_func(PyObject * /*self*/, PyObject *args, PyObject *key
   if (samples > 0) {
     denoiser.samples_override = samples;
   }
+  if (prefetch_frames >= 0) {
+    denoiser.prefetch_frames = prefetch_frames;
+  }
 
   /* Run denoiser. */
   if (!denoiser.run()) {
@@ -952,6 +963,19 @@ static PyObject *enable_print_stats_func(PyObject * /*self*/, PyObject * /*args*
   Py_RETURN_NONE;
 }
 
+static PyObject *set_stats_json_filepath_func(PyObject * /*self*/, PyObject *args)
+{
+  const char *filepath;
+  if (!PyArg_ParseTuple(args, "s", &filepath)) {
+    return NULL;
+  }
+
+  VLOG(1) << "Writing render statistics to " << filepath;
+  BlenderSession::stats_json_filepath = filepath;
+
+  Py_RETURN_NONE;
+}
+
 static PyObject *get_device_types_func(PyObject * /*self*/, PyObject * /*args*/)
 {
   vector<DeviceType> device_types = Device::available_types();
@@ -999,6 +1023,7 @@ static PyMethodDef methods[] = {
 
     /* Statistics. */
     {"enable_print_stats", enable_print_stats_func, METH_NOARGS, ""},
+    {"set_stats_json_filepath", set_stats_json_filepath_func, METH_VARARGS, ""},
 
     /* Resumable render */
     {"set_resumable_chunk", set_resumable_chunk_func, METH_VARARGS, ""},
@@ -38,6 +38,7 @@
 #include "util/util_hash.h"
 #include "util/util_logging.h"
 #include "util/util_murmurhash.h"
+#include "util/util_path.h"
 #include "util/util_progress.h"
 #include "util/util_time.h"
 
@@ -53,6 +54,7 @@ int BlenderSession::current_resumable_chunk = 0;
 int BlenderSession::start_resumable_chunk = 0;
 int BlenderSession::end_resumable_chunk = 0;
 bool BlenderSession::print_render_stats = false;
+string BlenderSession::stats_json_filepath = "";
 
 BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
                                BL::Preferences &b_userpref,
@@ -168,6 +170,10 @@ void BlenderSession::create_session()
 
 void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsgraph)
 {
+  /* With persistent data the render pipeline keeps its depsgraph between frames, only the IDs
+   * tagged in it changed since the previous render. */
+  const bool is_same_depsgraph = (this->b_depsgraph.ptr.data == b_depsgraph.ptr.data);
+
   /* Update data, scene and depsgraph pointers. These can change after undo. */
   this->b_data = b_data;
   this->b_depsgraph = b_depsgraph;
@@ -222,7 +228,6 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
   }
 
   session->progress.reset();
-  scene->reset();
 
   session->tile_manager.set_tile_order(session_params.tile_order);
 
@@ -231,11 +236,23 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
    */
   session->stats.mem_peak = session->stats.mem_used;
 
-  /* There is no single depsgraph to use for the entire render.
-   * See note on create_session().
-   */
-  /* sync object should be re-created */
-  sync = new BlenderSync(b_engine, b_data, b_scene, scene, !background, session->progress);
+  if (!is_new_session) {
+    if (is_same_depsgraph) {
+      /* Keep the scene with its BVHs, shaders and images, and only sync the IDs which were
+       * updated, typically the animated objects. */
+      sync->sync_recalc(b_depsgraph, b_v3d);
+    }
+    else {
+      /* There is no single depsgraph to use for the entire render.
+       * See note on create_session().
+       */
+      scene->reset();
+
+      /* sync object should be re-created */
+      delete sync;
+      sync = new BlenderSync(b_engine, b_data, b_scene, scene, !background, session->progress);
+    }
+  }
 
   BL::SpaceView3D b_null_space_view3d(PointerRNA_NULL);
   BL::RegionView3D b_null_region_view3d(PointerRNA_NULL);
@@ -361,7 +378,13 @@ void BlenderSession::do_write_update_render_tile(RenderTile &rtile,
       PassType pass_type = BlenderSync::get_pass_type(b_pass);
       int components = b_pass.channels();
 
-      rtile.buffers->set_pass_rect(pass_type, components, (float *)b_pass.rect());
+      float *rect = render_pass_get_rect(b_pass, rtile.w * rtile.h);
+      if (rect) {
+        rtile.buffers->set_pass_rect(pass_type, components, rect);
+      }
+      else {
+        rtile.buffers->set_pass_rect(pass_type, components, (float *)b_pass.rect());
+      }
     }
 
     end_render_result(b_engine, b_rr, false, false, false);
@@ -562,10 +585,16 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     session->start();
     session->wait();
 
-    if (!b_engine.is_preview() && background && print_render_stats) {
+    if (!b_engine.is_preview() && background &&
+        (print_render_stats || !stats_json_filepath.empty())) {
       RenderStats stats;
       session->collect_statistics(&stats);
-      printf("Render statistics:\n%s\n", stats.full_report().c_str());
+      if (print_render_stats) {
+        printf("Render statistics:\n%s\n", stats.full_report().c_str());
+      }
+      if (!stats_json_filepath.empty()) {
+        write_render_stats_json(stats, b_rlay_name, b_rview_name);
+      }
     }
 
     if (session->progress.get_cancel())
@@ -708,7 +737,10 @@ void BlenderSession::do_write_update_render_result(BL::RenderLayer &b_rlay,
 
   float exposure = scene->film->exposure;
 
-  vector<float> pixels(rtile.w * rtile.h * 4);
+  /* Pixels are written directly into the passes of the render result, the temporary buffer is
+   * only used for passes that don't match the tile size. */
+  const int num_pixels = rtile.w * rtile.h;
+  vector<float> pixels;
 
   /* Adjust absolute sample number to the range. */
   int sample = rtile.sample;
@@ -725,30 +757,45 @@ void BlenderSession::do_write_update_render_result(BL::RenderLayer &b_rlay,
       BL::RenderPass b_pass(*b_iter);
       int components = b_pass.channels();
 
+      float *rect = render_pass_get_rect(b_pass, num_pixels);
+      if (rect == NULL) {
+        pixels.resize(num_pixels * components);
+      }
+      float *pass_pixels = (rect) ? rect : &pixels[0];
+
       /* Copy pixels from regular render passes. */
-      bool read = buffers->get_pass_rect(b_pass.name(), exposure, sample, components, &pixels[0]);
+      bool read = buffers->get_pass_rect(b_pass.name(), exposure, sample, components, pass_pixels);
 
       /* If denoising pass, */
       if (!read) {
         int denoising_offset = BlenderSync::get_denoising_pass(b_pass);
         if (denoising_offset >= 0) {
           read = buffers->get_denoising_pass_rect(
-              denoising_offset, exposure, sample, components, &pixels[0]);
+              denoising_offset, exposure, sample, components, pass_pixels);
         }
       }
 
       if (!read) {
-        memset(&pixels[0], 0, pixels.size() * sizeof(float));
+        memset(pass_pixels, 0, sizeof(float) * num_pixels * components);
       }
 
-      b_pass.rect(&pixels[0]);
+      if (rect == NULL) {
+        b_pass.rect(pass_pixels);
+      }
     }
   }
   else {
     /* copy combined pass */
     BL::RenderPass b_combined_pass(b_rlay.passes.find_by_name("Combined", b_rview_name.c_str()));
-    if (buffers->get_pass_rect("Combined", exposure, sample, 4, &pixels[0]))
-      b_combined_pass.rect(&pixels[0]);
+    float *rect = render_pass_get_rect(b_combined_pass, num_pixels);
+    if (rect) {
+      buffers->get_pass_rect("Combined", exposure, sample, 4, rect);
+    }
+    else {
+      pixels.resize(num_pixels * 4);
+      if (buffers->get_pass_rect("Combined", exposure, sample, 4, &pixels[0]))
+        b_combined_pass.rect(&pixels[0]);
+    }
   }
 }
 
@@ -1106,6 +1153,45 @@ void BlenderSession::update_resumable_tile_manager(int num_samples)
   session->tile_manager.range_num_samples = rounded_range_num_samples;
 }
 
+void BlenderSession::write_render_stats_json(RenderStats &stats,
+                                             const string &view_layer_name,
+                                             const string &view_name)
+{
+  const int frame = b_scene.frame_current();
+
+  /* Replace the first run of # by the zero padded frame number. */
+  string filepath = stats_json_filepath;
+  const size_t hash_start = filepath.find('#');
+  if (hash_start != string::npos) {
+    size_t hash_end = filepath.find_first_not_of('#', hash_start);
+    if (hash_end == string::npos) {
+      hash_end = filepath.size();
+    }
+    const int num_digits = (int)(hash_end - hash_start);
+    filepath.replace(hash_start, num_digits, string_printf("%0*d", num_digits, frame));
+  }
+
+  FILE *file = path_fopen(filepath, "a");
+  if (file == NULL) {
+    fprintf(stderr, "Cycles: failed to write render statistics to %s\n", filepath.c_str());
+    return;
+  }
+
+  double total_time, render_time;
+  session->progress.get_time(total_time, render_time);
+
+  fprintf(file,
+          "{\"frame\": %d, \"view_layer\": %s, \"view\": %s, \"total_time\": %.3f, "
+          "\"render_time\": %.3f, \"stats\": %s}\n",
+          frame,
+          string_json_quote(view_layer_name).c_str(),
+          string_json_quote(view_name).c_str(),
+          total_time,
+          render_time,
+          stats.json_report().c_str());
+  fclose(file);
+}
+
 void BlenderSession::free_blender_memory_if_possible()
 {
   if (!background) {
@@ -34,6 +34,7 @@ class ImageMetaData;
 class Scene;
 class Session;
 class RenderBuffers;
+class RenderStats;
 class RenderTile;
 
 class BlenderSession {
@@ -147,9 +148,17 @@ class BlenderSession {
 
   static bool print_render_stats;
 
+  /* File to append render statistics of every rendered view layer to, as one JSON object per
+   * line. A run of # characters is replaced by the frame number. */
+  static string stats_json_filepath;
+
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
+  void write_render_stats_json(RenderStats &stats,
+                               const string &view_layer_name,
+                               const string &view_name);
+
   void do_write_update_render_result(BL::RenderLayer &b_rlay,
                                      RenderTile &rtile,
                                      bool do_update_only);
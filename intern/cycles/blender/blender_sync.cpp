@@ -307,6 +307,7 @@ void BlenderSync::sync_integrator()
   integrator->sample_all_lights_direct = get_boolean(cscene, "sample_all_lights_direct");
   integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
   integrator->light_sampling_threshold = get_float(cscene, "light_sampling_threshold");
+  integrator->use_light_tree = get_boolean(cscene, "use_light_tree");
 
   if (RNA_boolean_get(&cscene, "use_adaptive_sampling")) {
     integrator->sampling_pattern = SAMPLING_PATTERN_PMJ;
@@ -359,6 +360,10 @@ void BlenderSync::sync_integrator()
     integrator->ao_bounces = 0;
   }
 
+  if (integrator->light_tree_enabled() != previntegrator.light_tree_enabled()) {
+    scene->light_manager->tag_update(scene);
+  }
+
   if (integrator->modified(previntegrator))
     integrator->tag_update(scene);
 }
@@ -514,6 +519,7 @@ PassType BlenderSync::get_pass_type(BL::RenderPass &b_pass)
   MAP_PASS("Debug Render Time", PASS_RENDER_TIME);
   MAP_PASS("AdaptiveAuxBuffer", PASS_ADAPTIVE_AUX_BUFFER);
   MAP_PASS("Debug Sample Count", PASS_SAMPLE_COUNT);
+  MAP_PASS("Debug Adaptive Error", PASS_ADAPTIVE_ERROR);
   if (string_startswith(name, cryptomatte_prefix)) {
     return PASS_CRYPTOMATTE;
   }
@@ -629,6 +635,10 @@ vector<Pass> BlenderSync::sync_render_passes(BL::RenderLayer &b_rlay,
     b_engine.add_pass("Debug Sample Count", 1, "X", b_view_layer.name().c_str());
     Pass::add(PASS_SAMPLE_COUNT, passes, "Debug Sample Count");
   }
+  if (get_boolean(crl, "pass_debug_adaptive_error")) {
+    b_engine.add_pass("Debug Adaptive Error", 1, "X", b_view_layer.name().c_str());
+    Pass::add(PASS_ADAPTIVE_ERROR, passes, "Debug Adaptive Error");
+  }
   if (get_boolean(crl, "use_pass_volume_direct")) {
     b_engine.add_pass("VolumeDir", 3, "RGB", b_view_layer.name().c_str());
     Pass::add(PASS_VOLUME_DIRECT, passes, "VolumeDir");
@@ -777,6 +787,9 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  params.texture_memory_limit = (size_t)get_int(cscene, "texture_memory_limit") * 1024 * 1024;
+  params.use_half_float_images = get_boolean(cscene, "use_half_float_images");
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
@@ -935,7 +948,8 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
   }
 
   params.use_profiling = params.device.has_profiling && !b_engine.is_preview() && background &&
-                         BlenderSession::print_render_stats;
+                         (BlenderSession::print_render_stats ||
+                          !BlenderSession::stats_json_filepath.empty());
 
   params.adaptive_sampling = RNA_boolean_get(&cscene, "use_adaptive_sampling");
 
@@ -30,6 +30,7 @@
 
 #include "util/util_map.h"
 #include "util/util_set.h"
+#include "util/util_task.h"
 #include "util/util_transform.h"
 #include "util/util_vector.h"
 
@@ -180,9 +181,11 @@ class BlenderSync {
                           bool use_particle_hair);
   void sync_geometry_motion(BL::Depsgraph &b_depsgraph,
                             BL::Object &b_ob,
+                            BL::Object &b_ob_instance,
                             Object *object,
-                            float motion_time,
-                            bool use_particle_hair);
+                            float motion_time);
+  void defer_geometry_sync(BL::Object &b_ob, TaskRunFunction &&func);
+  void run_deferred_geometry_sync();
 
   /* Light */
   void sync_light(BL::Object &b_parent,
@@ -223,6 +226,14 @@ class BlenderSync {
   id_map<ParticleSystemKey, ParticleSystem> particle_system_map;
   set<Geometry *> geometry_synced;
   set<Geometry *> geometry_motion_synced;
+
+  /* Geometry exports collected in the object loop, to run in parallel after it. Exports of the
+   * same Blender object are grouped, since converting an object to a mesh is not thread safe. */
+  struct GeometrySyncTask {
+    void *b_ob;
+    vector<TaskRunFunction> funcs;
+  };
+  vector<GeometrySyncTask> geometry_sync_tasks;
   set<float> motion_times;
   void *world_map;
   bool world_recalc;
@@ -36,6 +36,7 @@ void BKE_image_user_frame_calc(void *ima, void *iuser, int cfra);
 void BKE_image_user_file_path(void *iuser, void *ima, char *path);
 unsigned char *BKE_image_get_pixels_for_frame(void *image, int frame, int tile);
 float *BKE_image_get_float_pixels_for_frame(void *image, int frame, int tile);
+float *RE_pass_rect_get(void *rpass, int *r_len);
 }
 
 CCL_NAMESPACE_BEGIN
@@ -264,6 +265,15 @@ static inline float *image_get_float_pixels_for_frame(BL::Image &image, int fram
   return BKE_image_get_float_pixels_for_frame(image.ptr.data, frame, tile);
 }
 
+/* Pixels of a render pass, to be written directly. Returns NULL if the pass does not have the
+ * expected number of pixels. */
+static inline float *render_pass_get_rect(BL::RenderPass &b_pass, int num_pixels)
+{
+  int len = 0;
+  float *rect = RE_pass_rect_get(b_pass.ptr.data, &len);
+  return (len == num_pixels * b_pass.channels()) ? rect : NULL;
+}
+
 static inline void render_add_metadata(BL::RenderResult &b_rr, string name, string value)
 {
   b_rr.stamp_data_add_field(name.c_str(), value.c_str());
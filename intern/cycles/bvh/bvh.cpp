@@ -92,7 +92,11 @@ int BVHStackEntry::encodeIdx() const
 BVH::BVH(const BVHParams &params_,
          const vector<Geometry *> &geometry_,
          const vector<Object *> &objects_)
-    : params(params_), geometry(geometry_), objects(objects_)
+    : params(params_),
+      geometry(geometry_),
+      objects(objects_),
+      build_sah_cost(0.0f),
+      sah_cost(0.0f)
 {
 }
 
@@ -175,6 +179,11 @@ void BVH::build(Progress &progress, Stats *)
 
   /* free build nodes */
   root->deleteSubtree();
+
+  /* Reference cost to compare refitted trees against. */
+  if (!params.top_level) {
+    build_sah_cost = sah_cost = compute_sah_cost();
+  }
 }
 
 /* Refitting */
@@ -191,6 +200,16 @@ void BVH::refit(Progress &progress)
   refit_nodes();
 }
 
+/* Check if refitting to deformed primitives made the tree too expensive to traverse,
+ * in which case building it again is faster for rendering. */
+bool BVH::refit_quality_degraded() const
+{
+  if (build_sah_cost <= 0.0f || sah_cost <= 0.0f) {
+    return false;
+  }
+  return sah_cost > build_sah_cost * params.refit_max_sah_ratio;
+}
+
 void BVH::refit_primitives(int start, int end, BoundBox &bbox, uint &visibility)
 {
   /* Refit range of primitives. */
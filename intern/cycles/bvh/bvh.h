@@ -87,6 +87,11 @@ class BVH {
   vector<Geometry *> geometry;
   vector<Object *> objects;
 
+  /* SAH cost of the tree right after building and after the last refit, computed from the
+   * primitive bounds. Zero when not supported by the BVH layout. */
+  float build_sah_cost;
+  float sah_cost;
+
   static BVH *create(const BVHParams &params,
                      const vector<Geometry *> &geometry,
                      const vector<Object *> &objects);
@@ -100,6 +105,7 @@ class BVH {
   }
 
   void refit(Progress &progress);
+  bool refit_quality_degraded() const;
 
  protected:
   BVH(const BVHParams &params,
@@ -119,6 +125,10 @@ class BVH {
   /* for subclasses to implement */
   virtual void pack_nodes(const BVHNode *root) = 0;
   virtual void refit_nodes() = 0;
+  virtual float compute_sah_cost()
+  {
+    return 0.0f;
+  }
 
   virtual BVHNode *widen_children_nodes(const BVHNode *root) = 0;
 };
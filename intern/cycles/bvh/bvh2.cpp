@@ -241,10 +241,34 @@ void BVH2::refit_nodes()
 
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
-  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+  float sah_area = 0.0f;
+  refit_node(0, (pack.root_index == -1) ? true : false, true, bbox, visibility, sah_area);
+
+  const float root_area = bbox.safe_area();
+  sah_cost = (root_area > 0.0f) ? sah_area / root_area : 0.0f;
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+/* Same traversal as refitting, without modifying the nodes. */
+float BVH2::compute_sah_cost()
+{
+  if (pack.nodes.size() == 0 && pack.leaf_nodes.size() == 0) {
+    return 0.0f;
+  }
+
+  BoundBox bbox = BoundBox::empty;
+  uint visibility = 0;
+  float sah_area = 0.0f;
+  refit_node(0, (pack.root_index == -1) ? true : false, false, bbox, visibility, sah_area);
+
+  const float root_area = bbox.safe_area();
+  return (root_area > 0.0f) ? sah_area / root_area : 0.0f;
+}
+
+/* Compute the bounds of the node from its primitives and write them in the packed nodes
+ * when update is true. The SAH cost of the subtree scaled by the root area is added to
+ * sah_area, matching BVHNode::computeSubtreeSAHCost(). */
+void BVH2::refit_node(
+    int idx, bool leaf, bool update, BoundBox &bbox, uint &visibility, float &sah_area)
 {
   if (leaf) {
     /* refit leaf node */
@@ -254,6 +278,11 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c1 = data[0].y;
 
     BVH::refit_primitives(c0, c1, bbox, visibility);
+    sah_area += bbox.safe_area() * params.primitive_cost(c1 - c0);
+
+    if (!update) {
+      return;
+    }
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -274,8 +303,17 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
     uint visibility0 = 0, visibility1 = 0;
 
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), update, bbox0, visibility0, sah_area);
+    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), update, bbox1, visibility1, sah_area);
+
+    bbox.grow(bbox0);
+    bbox.grow(bbox1);
+    visibility = visibility0 | visibility1;
+    sah_area += bbox.safe_area() * params.node_cost(2);
+
+    if (!update) {
+      return;
+    }
 
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
@@ -285,10 +323,6 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     else {
       pack_aligned_node(idx, bbox0, bbox1, c0, c1, visibility0, visibility1);
     }
-
-    bbox.grow(bbox0);
-    bbox.grow(bbox1);
-    visibility = visibility0 | visibility1;
   }
 }
 
@@ -85,7 +85,9 @@ class BVH2 : public BVH {
 
   /* refit */
   void refit_nodes() override;
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  void refit_node(
+      int idx, bool leaf, bool update, BoundBox &bbox, uint &visibility, float &sah_area);
+  float compute_sah_cost() override;
 };
 
 CCL_NAMESPACE_END
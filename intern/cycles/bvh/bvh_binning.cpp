@@ -23,6 +23,8 @@
 
 #include "util/util_algorithm.h"
 #include "util/util_boundbox.h"
+#include "util/util_foreach.h"
+#include "util/util_tbb.h"
 #include "util/util_types.h"
 
 CCL_NAMESPACE_BEGIN
@@ -97,71 +99,30 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   scale = rcp(cent_bounds_.size()) * make_float3((float)num_bins);
 
   /* initialize binning counter and bounds */
-  BoundBox bin_bounds[MAX_BINS][4]; /* bounds for every bin in every dimension */
-  int4 bin_count[MAX_BINS];         /* number of primitives mapped to bin */
-
+  Bins bins;
   for (size_t i = 0; i < num_bins; i++) {
-    bin_count[i] = make_int4(0);
-    bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
+    bins.count[i] = make_int4(0);
+    bins.bounds[i][0] = bins.bounds[i][1] = bins.bounds[i][2] = BoundBox::empty;
   }
 
-  /* map geometry to bins, unrolled once */
-  {
-    ssize_t i;
-
-    for (i = 0; i < ssize_t(size()) - 1; i += 2) {
-      prefetch_L2(&prims[start() + i + 8]);
-
-      /* map even and odd primitive to bin */
-      const BVHReference &prim0 = prims[start() + i + 0];
-      const BVHReference &prim1 = prims[start() + i + 1];
-
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      BoundBox bounds1 = get_prim_bounds(prim1);
-
-      int4 bin0 = get_bin(bounds0);
-      int4 bin1 = get_bin(bounds1);
-
-      /* increase bounds for bins for even primitive */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-
-      /* increase bounds of bins for odd primitive */
-      int b10 = (int)extract<0>(bin1);
-      bin_count[b10][0]++;
-      bin_bounds[b10][0].grow(bounds1);
-      int b11 = (int)extract<1>(bin1);
-      bin_count[b11][1]++;
-      bin_bounds[b11][1].grow(bounds1);
-      int b12 = (int)extract<2>(bin1);
-      bin_count[b12][2]++;
-      bin_bounds[b12][2].grow(bounds1);
-    }
-
-    /* for uneven number of primitives */
-    if (i < ssize_t(size())) {
-      /* map primitive to bin */
-      const BVHReference &prim0 = prims[start() + i];
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      int4 bin0 = get_bin(bounds0);
-
-      /* increase bounds of bins */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
+  /* map geometry to bins, in parallel for the large ranges at the top of the tree */
+  if (size() < PARALLEL_MIN_SIZE) {
+    bin_primitives(prims, start(), end(), bins);
+  }
+  else {
+    enumerable_thread_specific<Bins> thread_bins(bins);
+    parallel_for(blocked_range<size_t>(start(), end(), PARALLEL_GRAIN_SIZE),
+                 [&](const blocked_range<size_t> &r) {
+                   bin_primitives(prims, r.begin(), r.end(), thread_bins.local());
+                 });
+
+    foreach (const Bins &local_bins, thread_bins) {
+      for (size_t i = 0; i < num_bins; i++) {
+        bins.count[i] = bins.count[i] + local_bins.count[i];
+        bins.bounds[i][0].grow(local_bins.bounds[i][0]);
+        bins.bounds[i][1].grow(local_bins.bounds[i][1]);
+        bins.bounds[i][2].grow(local_bins.bounds[i][2]);
+      }
     }
   }
 
@@ -175,14 +136,14 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   BoundBox bz = BoundBox::empty;
 
   for (size_t i = num_bins - 1; i > 0; i--) {
-    count = count + bin_count[i];
+    count = count + bins.count[i];
     r_count[i] = blocks(count);
 
-    bx = merge(bx, bin_bounds[i][0]);
+    bx = merge(bx, bins.bounds[i][0]);
     r_area[i][0] = bx.half_area();
-    by = merge(by, bin_bounds[i][1]);
+    by = merge(by, bins.bounds[i][1]);
     r_area[i][1] = by.half_area();
-    bz = merge(bz, bin_bounds[i][2]);
+    bz = merge(bz, bins.bounds[i][2]);
     r_area[i][2] = bz.half_area();
     r_area[i][3] = r_area[i][2];
   }
@@ -199,13 +160,13 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   bz = BoundBox::empty;
 
   for (size_t i = 1; i < num_bins; i++, ii += make_int4(1)) {
-    count = count + bin_count[i - 1];
+    count = count + bins.count[i - 1];
 
-    bx = merge(bx, bin_bounds[i - 1][0]);
+    bx = merge(bx, bins.bounds[i - 1][0]);
     float Ax = bx.half_area();
-    by = merge(by, bin_bounds[i - 1][1]);
+    by = merge(by, bins.bounds[i - 1][1]);
     float Ay = by.half_area();
-    bz = merge(bz, bin_bounds[i - 1][2]);
+    bz = merge(bz, bins.bounds[i - 1][2]);
     float Az = bz.half_area();
 
     float4 lCount = blocks(count);
@@ -226,6 +187,70 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   leafSAH = bounds_.half_area() * blocks(size());
 }
 
+/* Map the primitives of the given part of the range to bins. */
+void BVHObjectBinning::bin_primitives(const BVHReference *prims,
+                                      size_t begin,
+                                      size_t end,
+                                      Bins &bins) const
+{
+  ssize_t i;
+
+  for (i = begin; i < ssize_t(end) - 1; i += 2) {
+    prefetch_L2(&prims[i + 8]);
+
+    /* map even and odd primitive to bin */
+    const BVHReference &prim0 = prims[i + 0];
+    const BVHReference &prim1 = prims[i + 1];
+
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    BoundBox bounds1 = get_prim_bounds(prim1);
+
+    int4 bin0 = get_bin(bounds0);
+    int4 bin1 = get_bin(bounds1);
+
+    /* increase bounds for bins for even primitive */
+    int b00 = (int)extract<0>(bin0);
+    bins.count[b00][0]++;
+    bins.bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bins.count[b01][1]++;
+    bins.bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bins.count[b02][2]++;
+    bins.bounds[b02][2].grow(bounds0);
+
+    /* increase bounds of bins for odd primitive */
+    int b10 = (int)extract<0>(bin1);
+    bins.count[b10][0]++;
+    bins.bounds[b10][0].grow(bounds1);
+    int b11 = (int)extract<1>(bin1);
+    bins.count[b11][1]++;
+    bins.bounds[b11][1].grow(bounds1);
+    int b12 = (int)extract<2>(bin1);
+    bins.count[b12][2]++;
+    bins.bounds[b12][2].grow(bounds1);
+  }
+
+  /* for uneven number of primitives */
+  if (i < ssize_t(end)) {
+    /* map primitive to bin */
+    const BVHReference &prim0 = prims[i];
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    int4 bin0 = get_bin(bounds0);
+
+    /* increase bounds of bins */
+    int b00 = (int)extract<0>(bin0);
+    bins.count[b00][0]++;
+    bins.bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bins.count[b01][1]++;
+    bins.bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bins.count[b02][2]++;
+    bins.bounds[b02][2].grow(bounds0);
+  }
+}
+
 void BVHObjectBinning::split(BVHReference *prims,
                              BVHObjectBinning &left_o,
                              BVHObjectBinning &right_o) const
@@ -71,6 +71,18 @@ class BVHObjectBinning : public BVHRange {
   enum { MAX_BINS = 32 };
   enum { LOG_BLOCK_SIZE = 2 };
 
+  /* Ranges with more primitives are binned by multiple threads. */
+  enum { PARALLEL_MIN_SIZE = 65536 };
+  enum { PARALLEL_GRAIN_SIZE = 8192 };
+
+  /* Bounds and number of primitives of every bin in every dimension. */
+  struct Bins {
+    BoundBox bounds[MAX_BINS][4];
+    int4 count[MAX_BINS];
+  };
+
+  void bin_primitives(const BVHReference *prims, size_t begin, size_t end, Bins &bins) const;
+
   /* computes the bin numbers for each dimension for a box. */
   __forceinline int4 get_bin(const BoundBox &box) const
   {
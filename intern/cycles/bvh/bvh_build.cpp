@@ -35,6 +35,7 @@
 #include "util/util_queue.h"
 #include "util/util_simd.h"
 #include "util/util_stack_allocator.h"
+#include "util/util_tbb.h"
 #include "util/util_time.h"
 
 CCL_NAMESPACE_BEGIN
@@ -67,7 +68,8 @@ BVHBuild::~BVHBuild()
 
 /* Adding References */
 
-void BVHBuild::add_reference_triangles(BoundBox &root, BoundBox &center, Mesh *mesh, int i)
+void BVHBuild::add_reference_triangles(
+    vector<BVHReference> &refs, BoundBox &root, BoundBox &center, Mesh *mesh, int i)
 {
   const Attribute *attr_mP = NULL;
   if (mesh->has_motion_blur()) {
@@ -81,7 +83,7 @@ void BVHBuild::add_reference_triangles(BoundBox &root, BoundBox &center, Mesh *m
       BoundBox bounds = BoundBox::empty;
       t.bounds_grow(verts, bounds);
       if (bounds.valid() && t.valid(verts)) {
-        references.push_back(BVHReference(bounds, j, i, PRIMITIVE_TRIANGLE));
+        refs.push_back(BVHReference(bounds, j, i, PRIMITIVE_TRIANGLE));
         root.grow(bounds);
         center.grow(bounds.center2());
       }
@@ -101,7 +103,7 @@ void BVHBuild::add_reference_triangles(BoundBox &root, BoundBox &center, Mesh *m
         t.bounds_grow(vert_steps + step * num_verts, bounds);
       }
       if (bounds.valid()) {
-        references.push_back(BVHReference(bounds, j, i, PRIMITIVE_MOTION_TRIANGLE));
+        refs.push_back(BVHReference(bounds, j, i, PRIMITIVE_MOTION_TRIANGLE));
         root.grow(bounds);
         center.grow(bounds.center2());
       }
@@ -139,7 +141,7 @@ void BVHBuild::add_reference_triangles(BoundBox &root, BoundBox &center, Mesh *m
         bounds.grow(curr_bounds);
         if (bounds.valid()) {
           const float prev_time = (float)(bvh_step - 1) * num_bvh_steps_inv_1;
-          references.push_back(
+          refs.push_back(
               BVHReference(bounds, j, i, PRIMITIVE_MOTION_TRIANGLE, prev_time, curr_time));
           root.grow(bounds);
           center.grow(bounds.center2());
@@ -153,7 +155,8 @@ void BVHBuild::add_reference_triangles(BoundBox &root, BoundBox &center, Mesh *m
   }
 }
 
-void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair, int i)
+void BVHBuild::add_reference_curves(
+    vector<BVHReference> &refs, BoundBox &root, BoundBox &center, Hair *hair, int i)
 {
   const Attribute *curve_attr_mP = NULL;
   if (hair->has_motion_blur()) {
@@ -177,7 +180,7 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
         curve.bounds_grow(k, &hair->curve_keys[0], curve_radius, bounds);
         if (bounds.valid()) {
           int packed_type = PRIMITIVE_PACK_SEGMENT(primitive_type, k);
-          references.push_back(BVHReference(bounds, j, i, packed_type));
+          refs.push_back(BVHReference(bounds, j, i, packed_type));
           root.grow(bounds);
           center.grow(bounds.center2());
         }
@@ -198,7 +201,7 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
         }
         if (bounds.valid()) {
           int packed_type = PRIMITIVE_PACK_SEGMENT(primitive_type, k);
-          references.push_back(BVHReference(bounds, j, i, packed_type));
+          refs.push_back(BVHReference(bounds, j, i, packed_type));
           root.grow(bounds);
           center.grow(bounds.center2());
         }
@@ -254,7 +257,7 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
           if (bounds.valid()) {
             const float prev_time = (float)(bvh_step - 1) * num_bvh_steps_inv_1;
             int packed_type = PRIMITIVE_PACK_SEGMENT(primitive_type, k);
-            references.push_back(BVHReference(bounds, j, i, packed_type, prev_time, curr_time));
+            refs.push_back(BVHReference(bounds, j, i, packed_type, prev_time, curr_time));
             root.grow(bounds);
             center.grow(bounds.center2());
           }
@@ -268,21 +271,23 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
   }
 }
 
-void BVHBuild::add_reference_geometry(BoundBox &root, BoundBox &center, Geometry *geom, int i)
+void BVHBuild::add_reference_geometry(
+    vector<BVHReference> &refs, BoundBox &root, BoundBox &center, Geometry *geom, int i)
 {
   if (geom->type == Geometry::MESH) {
     Mesh *mesh = static_cast<Mesh *>(geom);
-    add_reference_triangles(root, center, mesh, i);
+    add_reference_triangles(refs, root, center, mesh, i);
   }
   else if (geom->type == Geometry::HAIR) {
     Hair *hair = static_cast<Hair *>(geom);
-    add_reference_curves(root, center, hair, i);
+    add_reference_curves(refs, root, center, hair, i);
   }
 }
 
-void BVHBuild::add_reference_object(BoundBox &root, BoundBox &center, Object *ob, int i)
+void BVHBuild::add_reference_object(
+    vector<BVHReference> &refs, BoundBox &root, BoundBox &center, Object *ob, int i)
 {
-  references.push_back(BVHReference(ob->bounds, -1, i, 0));
+  refs.push_back(BVHReference(ob->bounds, -1, i, 0));
   root.grow(ob->bounds);
   center.grow(ob->bounds.center2());
 }
@@ -313,49 +318,98 @@ static size_t count_primitives(Geometry *geom)
 
 void BVHBuild::add_references(BVHRange &root)
 {
+  /* Split objects in chunks of roughly the same number of primitives, so
+   * references of large meshes and of many small objects can be added in
+   * parallel. Chunks are concatenated in order afterwards, so the result does
+   * not depend on threading. */
+  struct ReferenceChunk {
+    size_t object_begin, object_end;
+    size_t num_alloc_references;
+    vector<BVHReference> references;
+    BoundBox bounds, center;
+  };
+  vector<ReferenceChunk> chunks;
+
   /* reserve space for references */
   size_t num_alloc_references = 0;
 
-  foreach (Object *ob, objects) {
+  for (size_t i = 0; i < objects.size(); i++) {
+    Object *ob = objects[i];
+    size_t num_object_references = 0;
+
     if (params.top_level) {
       if (!ob->is_traceable()) {
         continue;
       }
       if (!ob->geometry->is_instanced()) {
-        num_alloc_references += count_primitives(ob->geometry);
+        num_object_references = count_primitives(ob->geometry);
       }
       else
-        num_alloc_references++;
+        num_object_references = 1;
     }
     else {
-      num_alloc_references += count_primitives(ob->geometry);
+      num_object_references = count_primitives(ob->geometry);
     }
+
+    if (chunks.empty() || chunks.back().num_alloc_references >= REFERENCES_CHUNK_SIZE) {
+      ReferenceChunk chunk;
+      chunk.object_begin = i;
+      chunk.num_alloc_references = 0;
+      chunks.push_back(chunk);
+    }
+
+    chunks.back().object_end = i + 1;
+    chunks.back().num_alloc_references += num_object_references;
+    num_alloc_references += num_object_references;
   }
 
   references.reserve(num_alloc_references);
 
   /* add references from objects */
-  BoundBox bounds = BoundBox::empty, center = BoundBox::empty;
-  int i = 0;
+  parallel_for(blocked_range<size_t>(0, chunks.size(), 1), [&](const blocked_range<size_t> &r) {
+    for (size_t c = r.begin(); c != r.end(); c++) {
+      ReferenceChunk &chunk = chunks[c];
+      /* The first chunk is added directly, no copy is needed with a single chunk. */
+      vector<BVHReference> &refs = (c == 0) ? references : chunk.references;
+      if (c != 0) {
+        refs.reserve(chunk.num_alloc_references);
+      }
+      chunk.bounds = BoundBox::empty;
+      chunk.center = BoundBox::empty;
 
-  foreach (Object *ob, objects) {
-    if (params.top_level) {
-      if (!ob->is_traceable()) {
-        ++i;
-        continue;
+      for (size_t i = chunk.object_begin; i < chunk.object_end; i++) {
+        Object *ob = objects[i];
+
+        if (params.top_level) {
+          if (!ob->is_traceable()) {
+            continue;
+          }
+          if (!ob->geometry->is_instanced())
+            add_reference_geometry(refs, chunk.bounds, chunk.center, ob->geometry, i);
+          else
+            add_reference_object(refs, chunk.bounds, chunk.center, ob, i);
+        }
+        else
+          add_reference_geometry(refs, chunk.bounds, chunk.center, ob->geometry, i);
+
+        if (progress.get_cancel())
+          return;
       }
-      if (!ob->geometry->is_instanced())
-        add_reference_geometry(bounds, center, ob->geometry, i);
-      else
-        add_reference_object(bounds, center, ob, i);
     }
-    else
-      add_reference_geometry(bounds, center, ob->geometry, i);
+  });
 
-    i++;
+  if (progress.get_cancel())
+    return;
 
-    if (progress.get_cancel())
-      return;
+  BoundBox bounds = BoundBox::empty, center = BoundBox::empty;
+
+  foreach (ReferenceChunk &chunk, chunks) {
+    if (&chunk != &chunks[0]) {
+      references.insert(references.end(), chunk.references.begin(), chunk.references.end());
+      chunk.references.free_memory();
+    }
+    bounds.grow(chunk.bounds);
+    center.grow(chunk.center);
   }
 
   /* happens mostly on empty meshes */
@@ -56,6 +56,10 @@ class BVHParams {
   float sah_node_cost;
   float sah_primitive_cost;
 
+  /* Refitted BVH are built again when their SAH cost grows past this factor
+   * of the cost they had when built. */
+  float refit_max_sah_ratio;
+
   /* number of primitives in leaf */
   int min_leaf_size;
   int max_triangle_leaf_size;
@@ -106,6 +110,8 @@ class BVHParams {
     sah_node_cost = 1.0f;
     sah_primitive_cost = 1.0f;
 
+    refit_max_sah_ratio = 1.5f;
+
     min_leaf_size = 1;
     max_triangle_leaf_size = 8;
     max_motion_triangle_leaf_size = 8;
@@ -59,7 +59,7 @@ class CUDADevice : public Device {
   CUDASplitKernel *split_kernel;
 
   struct CUDAMem {
-    CUDAMem() : texobject(0), array(0), use_mapped_host(false)
+    CUDAMem() : texobject(0), array(0), use_mapped_host(false), host_registered(false)
     {
     }
 
@@ -68,6 +68,8 @@ class CUDADevice : public Device {
 
     /* If true, a mapped host memory in shared_pointer is being used. */
     bool use_mapped_host;
+    /* If true, host_pointer was page-locked by this device. */
+    bool host_registered;
   };
   typedef map<device_memory *, CUDAMem> CUDAMemMap;
   CUDAMemMap cuda_mem_map;
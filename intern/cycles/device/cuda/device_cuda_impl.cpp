@@ -719,6 +719,24 @@ void CUDADevice::load_texture_info()
   }
 }
 
+/* Order in which memory is moved to host when running out of device memory, lowest first.
+ * Image textures are typically only sampled at a few shading points, while the BVH and the
+ * primitive data it references are read by every ray, so these stay on the device longest. */
+static int cuda_mem_residency_priority(const device_memory &mem, bool is_image)
+{
+  if (is_image) {
+    return 0;
+  }
+
+  const char *name = (mem.name) ? mem.name : "";
+  if (string_startswith(name, "__bvh_") || string_startswith(name, "__prim_") ||
+      strcmp(name, "__object_node") == 0) {
+    return 2;
+  }
+
+  return 1;
+}
+
 void CUDADevice::move_textures_to_host(size_t size, bool for_texture)
 {
   /* Break out of recursive call, which can happen when moving memory on a multi device. */
@@ -730,11 +748,14 @@ void CUDADevice::move_textures_to_host(size_t size, bool for_texture)
   /* Signal to reallocate textures in host memory only. */
   move_texture_to_host = true;
 
+  size_t moved_size = 0;
+  string moved_names;
+
   while (size > 0) {
     /* Find suitable memory allocation to move. */
     device_memory *max_mem = NULL;
     size_t max_size = 0;
-    bool max_is_image = false;
+    int max_priority = INT_MAX;
 
     foreach (CUDAMemMap::value_type &pair, cuda_mem_map) {
       device_memory &mem = *pair.first;
@@ -760,9 +781,10 @@ void CUDADevice::move_textures_to_host(size_t size, bool for_texture)
         continue;
       }
 
-      /* Try to move largest allocation, prefer moving images. */
-      if (is_image > max_is_image || (is_image == max_is_image && mem.device_size > max_size)) {
-        max_is_image = is_image;
+      /* Try to move largest allocation of the least frequently accessed kind. */
+      const int priority = cuda_mem_residency_priority(mem, is_image);
+      if (priority < max_priority || (priority == max_priority && mem.device_size > max_size)) {
+        max_priority = priority;
         max_size = mem.device_size;
         max_mem = &mem;
       }
@@ -772,7 +794,11 @@ void CUDADevice::move_textures_to_host(size_t size, bool for_texture)
      * multiple CUDA devices could be moving the memory. The
      * first one will do it, and the rest will adopt the pointer. */
     if (max_mem) {
-      VLOG(1) << "Move memory from device to host: " << max_mem->name;
+      VLOG(1) << "Move memory from device to host: " << max_mem->name << ", "
+              << string_human_readable_size(max_size);
+
+      moved_size += max_size;
+      moved_names += (moved_names.empty()) ? max_mem->name : string(", ") + max_mem->name;
 
       static thread_mutex move_mutex;
       thread_scoped_lock lock(move_mutex);
@@ -799,6 +825,12 @@ void CUDADevice::move_textures_to_host(size_t size, bool for_texture)
   /* Unset flag before texture info is reloaded, since it should stay in device memory. */
   move_texture_to_host = false;
 
+  if (moved_size) {
+    LOG(WARNING) << "Out of GPU memory on " << info.description << ", moved "
+                 << string_human_readable_size(moved_size)
+                 << " to host memory, rendering will be slower: " << moved_names;
+  }
+
   /* Update texture info array with new pointers. */
   load_texture_info();
 }
@@ -917,6 +949,18 @@ CUDADevice::CUDAMem *CUDADevice::generic_alloc(device_memory &mem, size_t pitch_
     cmem->use_mapped_host = false;
   }
 
+  /* Page-lock host memory that is frequently copied from the device, so that
+   * copies are done with DMA directly instead of through a staging buffer.
+   * If another device already registered the memory, it stays page-locked
+   * until that device frees it, which is fine since copies work either way. */
+  cmem->host_registered = false;
+  if (mem.use_pinned_host && !cmem->use_mapped_host && mem.host_pointer) {
+    if (cuMemHostRegister(mem.host_pointer, mem.memory_size(), CU_MEMHOSTREGISTER_PORTABLE) ==
+        CUDA_SUCCESS) {
+      cmem->host_registered = true;
+    }
+  }
+
   return cmem;
 }
 
@@ -942,6 +986,10 @@ void CUDADevice::generic_free(device_memory &mem)
     CUDAContextScope scope(this);
     const CUDAMem &cmem = cuda_mem_map[&mem];
 
+    if (cmem.host_registered) {
+      cuMemHostUnregister(mem.host_pointer);
+    }
+
     /* If cmem.use_mapped_host is true, reference counting is used
      * to safely free a mapped host memory. */
 
@@ -224,6 +224,9 @@ class device_memory {
   void *shared_pointer;
   /* reference counter for shared_pointer */
   int shared_counter;
+  /* Page-lock host memory while allocated on devices that support it, for
+   * faster copies of memory that is frequently read back from the device. */
+  bool use_pinned_host;
 
   virtual ~device_memory();
 
@@ -40,6 +40,9 @@ class MultiDevice : public Device {
     int peer_island_index = -1;
   };
 
+  /* Smallest read-only buffer that is distributed across peer devices. */
+  static const size_t PEER_DISTRIBUTE_MIN_SIZE = 4 * 1024 * 1024;
+
   list<SubDevice> devices, denoising_devices;
   device_ptr unique_key;
   vector<vector<SubDevice *>> peer_islands;
@@ -292,6 +295,33 @@ class MultiDevice : public Device {
     return find_matching_mem_device(key, sub)->ptr_map[key];
   }
 
+  /* Only large buffers are distributed across the devices of a peer island. Kernels access
+   * small read-only buffers (lookup tables, small textures, ...) so often that the peer link
+   * would become the bottleneck, so these are copied to every device of the island instead. */
+  bool is_replicated_mem(device_memory &mem,
+                         device_ptr existing_key,
+                         const vector<SubDevice *> &island)
+  {
+    if (island.size() < 2) {
+      return false;
+    }
+
+    if (existing_key) {
+      /* Keep the placement the memory was first allocated with. */
+      int num_copies = 0;
+      foreach (SubDevice *island_sub, island) {
+        if (island_sub->ptr_map.find(existing_key) != island_sub->ptr_map.end()) {
+          num_copies++;
+        }
+      }
+      return num_copies > 1;
+    }
+
+    const bool is_read_only = (mem.type == MEM_READ_ONLY || mem.type == MEM_GLOBAL ||
+                               mem.type == MEM_TEXTURE);
+    return is_read_only && mem.memory_size() < PEER_DISTRIBUTE_MIN_SIZE;
+  }
+
   void mem_alloc(device_memory &mem)
   {
     device_ptr key = unique_key++;
@@ -313,6 +343,18 @@ class MultiDevice : public Device {
              mem.type == MEM_DEVICE_ONLY);
       /* The remaining memory types can be distributed across devices */
       foreach (const vector<SubDevice *> &island, peer_islands) {
+        if (is_replicated_mem(mem, 0, island)) {
+          foreach (SubDevice *island_sub, island) {
+            mem.device = island_sub->device;
+            mem.device_pointer = 0;
+            mem.device_size = 0;
+
+            island_sub->device->mem_alloc(mem);
+            island_sub->ptr_map[key] = mem.device_pointer;
+          }
+          continue;
+        }
+
         SubDevice *owner_sub = find_suitable_mem_device(key, island);
         mem.device = owner_sub->device;
         mem.device_pointer = 0;
@@ -347,6 +389,18 @@ class MultiDevice : public Device {
     }
     else {
       foreach (const vector<SubDevice *> &island, peer_islands) {
+        if (is_replicated_mem(mem, existing_key, island)) {
+          foreach (SubDevice *island_sub, island) {
+            mem.device = island_sub->device;
+            mem.device_pointer = (existing_key) ? island_sub->ptr_map[existing_key] : 0;
+            mem.device_size = existing_size;
+
+            island_sub->device->mem_copy_to(mem);
+            island_sub->ptr_map[key] = mem.device_pointer;
+          }
+          continue;
+        }
+
         SubDevice *owner_sub = find_suitable_mem_device(existing_key, island);
         mem.device = owner_sub->device;
         mem.device_pointer = (existing_key) ? owner_sub->ptr_map[existing_key] : 0;
@@ -432,6 +486,18 @@ class MultiDevice : public Device {
     }
     else {
       foreach (const vector<SubDevice *> &island, peer_islands) {
+        if (is_replicated_mem(mem, existing_key, island)) {
+          foreach (SubDevice *island_sub, island) {
+            mem.device = island_sub->device;
+            mem.device_pointer = (existing_key) ? island_sub->ptr_map[existing_key] : 0;
+            mem.device_size = existing_size;
+
+            island_sub->device->mem_zero(mem);
+            island_sub->ptr_map[key] = mem.device_pointer;
+          }
+          continue;
+        }
+
         SubDevice *owner_sub = find_suitable_mem_device(existing_key, island);
         mem.device = owner_sub->device;
         mem.device_pointer = (existing_key) ? owner_sub->ptr_map[existing_key] : 0;
@@ -478,6 +544,18 @@ class MultiDevice : public Device {
     }
     else {
       foreach (const vector<SubDevice *> &island, peer_islands) {
+        if (is_replicated_mem(mem, key, island)) {
+          foreach (SubDevice *island_sub, island) {
+            mem.device = island_sub->device;
+            mem.device_pointer = island_sub->ptr_map[key];
+            mem.device_size = existing_size;
+
+            island_sub->device->mem_free(mem);
+            island_sub->ptr_map.erase(island_sub->ptr_map.find(key));
+          }
+          continue;
+        }
+
         SubDevice *owner_sub = find_matching_mem_device(key, *island.front());
         mem.device = owner_sub->device;
         mem.device_pointer = owner_sub->ptr_map[key];
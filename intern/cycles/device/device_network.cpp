@@ -73,8 +73,13 @@ class NetworkDevice : public Device {
       socket.connect(*endpoint_iterator++, error);
     }
 
-    if (error)
+    if (error) {
       error_func.network_error(error.message());
+    }
+    else {
+      /* Messages are small and latency bound, don't let them wait for more data. */
+      socket.set_option(tcp::no_delay(true));
+    }
 
     mem_counter = 0;
   }
@@ -792,6 +797,7 @@ void Device::server_run()
 
       tcp::socket socket(io_service);
       acceptor.accept(socket);
+      socket.set_option(tcp::no_delay(true));
 
       string remote_address = socket.remote_endpoint().address().to_string();
       printf("Connected to remote client at: %s\n", remote_address.c_str());
@@ -29,6 +29,8 @@
 #  include <boost/serialization/vector.hpp>
 #  include <boost/thread.hpp>
 
+#  include <zlib.h>
+
 #  include <deque>
 #  include <iostream>
 #  include <sstream>
@@ -40,14 +42,13 @@
 #  include "util/util_map.h"
 #  include "util/util_param.h"
 #  include "util/util_string.h"
+#  include "util/util_types.h"
 
 CCL_NAMESPACE_BEGIN
 
 using std::cerr;
 using std::cout;
 using std::exception;
-using std::hex;
-using std::setw;
 
 using boost::asio::ip::tcp;
 
@@ -56,6 +57,27 @@ static const int DISCOVER_PORT = 5121;
 static const string DISCOVER_REQUEST_MSG = "REQUEST_RENDER_SERVER_IP";
 static const string DISCOVER_REPLY_MSG = "REPLY_RENDER_SERVER_IP";
 
+/* Binary framing of messages. Every RPC starts with a fixed size header followed by the
+ * serialized arguments, bulk data is sent as separate buffers that may be compressed.
+ * Client and server are expected to have the same endianness. */
+static const uint RPC_MAGIC = 0x43434C31; /* "CCL1" */
+
+struct RPCHeader {
+  uint magic;
+  uint flags;
+  uint64_t size;
+};
+
+struct RPCBufferHeader {
+  /* Size of the data after decompression. */
+  uint64_t size;
+  /* Size of the data sent over the network, equal to size when not compressed. */
+  uint64_t stored_size;
+};
+
+/* Buffers smaller than this are not worth compressing. */
+static const size_t RPC_COMPRESS_MIN_SIZE = 64 * 1024;
+
 #  if 0
 typedef boost::archive::text_oarchive o_archive;
 typedef boost::archive::text_iarchive i_archive;
@@ -160,41 +182,49 @@ class RPCSend {
 
   void write()
   {
-    boost::system::error_code error;
-
     /* get string from stream */
     string archive_str = archive_stream.str();
 
-    /* first send fixed size header with size of following data */
-    ostringstream header_stream;
-    header_stream << setw(8) << hex << archive_str.size();
-    string header_str = header_stream.str();
-
-    boost::asio::write(
-        socket, boost::asio::buffer(header_str), boost::asio::transfer_all(), error);
+    /* send fixed size header with size of following data, in a single write with the data */
+    RPCHeader header;
+    header.magic = RPC_MAGIC;
+    header.flags = 0;
+    header.size = archive_str.size();
 
-    if (error.value())
-      error_func->network_error(error.message());
-
-    /* then send actual data */
-    boost::asio::write(
-        socket, boost::asio::buffer(archive_str), boost::asio::transfer_all(), error);
-
-    if (error.value())
-      error_func->network_error(error.message());
+    boost::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(&header, sizeof(header)), boost::asio::buffer(archive_str)};
+    send(buffers);
 
     sent = true;
   }
 
   void write_buffer(void *buffer, size_t size)
   {
-    boost::system::error_code error;
-
-    boost::asio::write(
-        socket, boost::asio::buffer(buffer, size), boost::asio::transfer_all(), error);
+    RPCBufferHeader header;
+    header.size = size;
+    header.stored_size = size;
+
+    /* Compress large buffers, falling back to the raw data when that does not make them
+     * any smaller. Speed matters more than ratio here, the data is sent right away. */
+    vector<uint8_t> compressed;
+    if (size >= RPC_COMPRESS_MIN_SIZE && size <= UINT_MAX) {
+      uLongf compressed_size = compressBound(size);
+      compressed.resize(compressed_size);
+      if (compress2(&compressed[0],
+                    &compressed_size,
+                    (const Bytef *)buffer,
+                    size,
+                    Z_BEST_SPEED) == Z_OK &&
+          compressed_size < size) {
+        header.stored_size = compressed_size;
+        buffer = &compressed[0];
+      }
+    }
 
-    if (error.value())
-      error_func->network_error(error.message());
+    boost::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(&header, sizeof(header)),
+        boost::asio::buffer(buffer, header.stored_size)};
+    send(buffers);
   }
 
  protected:
@@ -204,6 +234,16 @@ class RPCSend {
   o_archive archive;
   bool sent;
   NetworkError *error_func;
+
+  template<typename T> void send(const T &buffers)
+  {
+    boost::system::error_code error;
+
+    boost::asio::write(socket, buffers, boost::asio::transfer_all(), error);
+
+    if (error.value())
+      error_func->network_error(error.message());
+  }
 };
 
 /* Remote procedure call Receive */
@@ -215,23 +255,18 @@ class RPCReceive {
   {
     error_func = e;
     /* read head with fixed size */
-    vector<char> header(8);
+    RPCHeader header;
     boost::system::error_code error;
-    size_t len = boost::asio::read(socket, boost::asio::buffer(header), error);
+    size_t len = boost::asio::read(socket, boost::asio::buffer(&header, sizeof(header)), error);
 
     if (error.value()) {
       error_func->network_error(error.message());
     }
 
     /* verify if we got something */
-    if (len == header.size()) {
-      /* decode header */
-      string header_str(&header[0], header.size());
-      istringstream header_stream(header_str);
-
-      size_t data_size;
-
-      if ((header_stream >> hex >> data_size)) {
+    if (len == sizeof(header)) {
+      if (header.magic == RPC_MAGIC) {
+        size_t data_size = header.size;
 
         vector<char> data(data_size);
         size_t len = boost::asio::read(socket, boost::asio::buffer(data), error);
@@ -253,7 +288,7 @@ class RPCReceive {
         }
       }
       else {
-        error_func->network_error("Network receive error: can't decode data size from header");
+        error_func->network_error("Network receive error: invalid header, protocol mismatch");
       }
     }
     else {
@@ -291,15 +326,33 @@ class RPCReceive {
 
   void read_buffer(void *buffer, size_t size)
   {
-    boost::system::error_code error;
-    size_t len = boost::asio::read(socket, boost::asio::buffer(buffer, size), error);
+    RPCBufferHeader header;
+    if (!read_data(&header, sizeof(header))) {
+      return;
+    }
 
-    if (error.value()) {
-      error_func->network_error(error.message());
+    if (header.size != size) {
+      error_func->network_error("Network receive error: buffer size doesn't match expected size");
+      return;
     }
 
-    if (len != size)
-      cout << "Network receive error: buffer size doesn't match expected size\n";
+    if (header.stored_size == size) {
+      read_data(buffer, size);
+      return;
+    }
+
+    /* Compressed buffer. */
+    vector<uint8_t> compressed(header.stored_size);
+    if (!read_data(&compressed[0], header.stored_size)) {
+      return;
+    }
+
+    uLongf uncompressed_size = size;
+    if (uncompress((Bytef *)buffer, &uncompressed_size, &compressed[0], header.stored_size) !=
+            Z_OK ||
+        uncompressed_size != size) {
+      error_func->network_error("Network receive error: failed to decompress buffer");
+    }
   }
 
   void read(DeviceTask &task)
@@ -329,6 +382,24 @@ class RPCReceive {
   string name;
 
  protected:
+  bool read_data(void *buffer, size_t size)
+  {
+    boost::system::error_code error;
+    size_t len = boost::asio::read(socket, boost::asio::buffer(buffer, size), error);
+
+    if (error.value()) {
+      error_func->network_error(error.message());
+      return false;
+    }
+
+    if (len != size) {
+      error_func->network_error("Network receive error: buffer size doesn't match expected size");
+      return false;
+    }
+
+    return true;
+  }
+
   tcp::socket &socket;
   string archive_str;
   istringstream *archive_stream;
@@ -33,6 +33,21 @@ CCL_NAMESPACE_BEGIN
 
 #include "kernel/bvh/bvh_types.h"
 
+ccl_device_inline bool scene_intersect_valid(const Ray *ray)
+{
+  /* NOTE: Due to some vectorization code  non-finite origin point might
+   * cause lots of false-positive intersections which will overflow traversal
+   * stack.
+   * This code is a quick way to perform early output, to avoid crashes in
+   * such cases.
+   * From production scenes so far it seems it's enough to test first element
+   * only.
+   * Scene intersection may also called with empty rays for conditional trace
+   * calls that evaluate to false, so filter those out.
+   */
+  return isfinite_safe(ray->P.x) && isfinite_safe(ray->D.x) && len_squared(ray->D) != 0.0f;
+}
+
 #ifndef __KERNEL_OPTIX__
 
 /* Regular BVH traversal */
@@ -61,6 +76,32 @@ CCL_NAMESPACE_BEGIN
 #    include "kernel/bvh/bvh_traversal.h"
 #  endif
 
+/* Packet BVH traversal for opaque shadow rays */
+
+#  if defined(__BVH_PACKET__)
+#    define BVH_FUNCTION_NAME bvh_intersect_occluded_packet
+#    define BVH_FUNCTION_FEATURES 0
+#    include "kernel/bvh/bvh_occluded_packet.h"
+
+#    if defined(__HAIR__)
+#      define BVH_FUNCTION_NAME bvh_intersect_occluded_packet_hair
+#      define BVH_FUNCTION_FEATURES BVH_HAIR
+#      include "kernel/bvh/bvh_occluded_packet.h"
+#    endif
+
+#    if defined(__OBJECT_MOTION__)
+#      define BVH_FUNCTION_NAME bvh_intersect_occluded_packet_motion
+#      define BVH_FUNCTION_FEATURES BVH_MOTION
+#      include "kernel/bvh/bvh_occluded_packet.h"
+#    endif
+
+#    if defined(__HAIR__) && defined(__OBJECT_MOTION__)
+#      define BVH_FUNCTION_NAME bvh_intersect_occluded_packet_hair_motion
+#      define BVH_FUNCTION_FEATURES BVH_HAIR | BVH_MOTION
+#      include "kernel/bvh/bvh_occluded_packet.h"
+#    endif
+#  endif /* __BVH_PACKET__ */
+
 /* Subsurface scattering BVH traversal */
 
 #  if defined(__BVH_LOCAL__)
@@ -136,21 +177,6 @@ CCL_NAMESPACE_BEGIN
 
 #endif /* __KERNEL_OPTIX__ */
 
-ccl_device_inline bool scene_intersect_valid(const Ray *ray)
-{
-  /* NOTE: Due to some vectorization code  non-finite origin point might
-   * cause lots of false-positive intersections which will overflow traversal
-   * stack.
-   * This code is a quick way to perform early output, to avoid crashes in
-   * such cases.
-   * From production scenes so far it seems it's enough to test first element
-   * only.
-   * Scene intersection may also called with empty rays for conditional trace
-   * calls that evaluate to false, so filter those out.
-   */
-  return isfinite_safe(ray->P.x) && isfinite_safe(ray->D.x) && len_squared(ray->D) != 0.0f;
-}
-
 ccl_device_intersect bool scene_intersect(KernelGlobals *kg,
                                           const Ray *ray,
                                           const uint visibility,
@@ -236,6 +262,51 @@ ccl_device_intersect bool scene_intersect(KernelGlobals *kg,
 #endif   /* __KERNEL_OPTIX__ */
 }
 
+#ifdef __BVH_PACKET__
+/* Test a packet of up to BVH_PACKET_SIZE rays with the same time for occlusion,
+ * returning a bit mask of the occluded rays. */
+ccl_device_intersect uint scene_intersect_occluded_packet(KernelGlobals *kg,
+                                                          const Ray *rays,
+                                                          const int num_rays,
+                                                          const uint visibility)
+{
+#  ifdef __EMBREE__
+  if (kernel_data.bvh.scene) {
+    uint occluded = 0;
+    for (int i = 0; i < num_rays; i++) {
+      Intersection isect;
+      if (rays[i].t != 0.0f && scene_intersect(kg, &rays[i], visibility, &isect)) {
+        occluded |= (1 << i);
+      }
+    }
+    return occluded;
+  }
+#  endif /* __EMBREE__ */
+
+  PROFILING_INIT(kg, PROFILING_INTERSECT);
+
+#  ifdef __OBJECT_MOTION__
+  if (kernel_data.bvh.have_motion) {
+#    ifdef __HAIR__
+    if (kernel_data.bvh.have_curves) {
+      return bvh_intersect_occluded_packet_hair_motion(kg, rays, num_rays, visibility);
+    }
+#    endif /* __HAIR__ */
+
+    return bvh_intersect_occluded_packet_motion(kg, rays, num_rays, visibility);
+  }
+#  endif /* __OBJECT_MOTION__ */
+
+#  ifdef __HAIR__
+  if (kernel_data.bvh.have_curves) {
+    return bvh_intersect_occluded_packet_hair(kg, rays, num_rays, visibility);
+  }
+#  endif /* __HAIR__ */
+
+  return bvh_intersect_occluded_packet(kg, rays, num_rays, visibility);
+}
+#endif /* __BVH_PACKET__ */
+
 #ifdef __BVH_LOCAL__
 ccl_device_intersect bool scene_intersect_local(KernelGlobals *kg,
                                                 const Ray *ray,
@@ -151,3 +151,81 @@ ccl_device_forceinline int bvh_node_intersect(KernelGlobals *kg,
     return bvh_aligned_node_intersect(kg, P, idir, t, node_addr, visibility, dist);
   }
 }
+
+#ifdef __BVH_PACKET__
+/* Rays of a packet in structure of arrays layout, one lane per ray. */
+typedef struct BVHRayPacket {
+  ssef P[3];
+  ssef idir[3];
+  ssef t;
+} BVHRayPacket;
+
+ccl_device_forceinline void bvh_ray_packet_set_lane(
+    BVHRayPacket *packet, const int lane, const float3 P, const float3 idir, const float t)
+{
+  packet->P[0][lane] = P.x;
+  packet->P[1][lane] = P.y;
+  packet->P[2][lane] = P.z;
+  packet->idir[0][lane] = idir.x;
+  packet->idir[1][lane] = idir.y;
+  packet->idir[2][lane] = idir.z;
+  packet->t[lane] = t;
+}
+
+/* Intersect all rays of the packet with both children of an aligned node, returning a
+ * lane mask of the rays hitting each child. The distance is the closest entry point of
+ * all those rays, used to decide which child to visit first. */
+ccl_device_forceinline void bvh_aligned_node_intersect_packet(KernelGlobals *kg,
+                                                              const BVHRayPacket *packet,
+                                                              const int node_addr,
+                                                              const uint visibility,
+                                                              const int lane_mask,
+                                                              int child_mask[2],
+                                                              float dist[2])
+{
+  float4 cnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
+  float4 node0 = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+  float4 node1 = kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+  float4 node2 = kernel_tex_fetch(__bvh_nodes, node_addr + 3);
+
+  const ssef c0lox = (ssef(node0.x) - packet->P[0]) * packet->idir[0];
+  const ssef c0hix = (ssef(node0.z) - packet->P[0]) * packet->idir[0];
+  const ssef c0loy = (ssef(node1.x) - packet->P[1]) * packet->idir[1];
+  const ssef c0hiy = (ssef(node1.z) - packet->P[1]) * packet->idir[1];
+  const ssef c0loz = (ssef(node2.x) - packet->P[2]) * packet->idir[2];
+  const ssef c0hiz = (ssef(node2.z) - packet->P[2]) * packet->idir[2];
+  const ssef c0min = max(max(ssef(0.0f), min(c0lox, c0hix)),
+                         max(min(c0loy, c0hiy), min(c0loz, c0hiz)));
+  const ssef c0max = min(min(packet->t, max(c0lox, c0hix)),
+                         min(max(c0loy, c0hiy), max(c0loz, c0hiz)));
+
+  const ssef c1lox = (ssef(node0.y) - packet->P[0]) * packet->idir[0];
+  const ssef c1hix = (ssef(node0.w) - packet->P[0]) * packet->idir[0];
+  const ssef c1loy = (ssef(node1.y) - packet->P[1]) * packet->idir[1];
+  const ssef c1hiy = (ssef(node1.w) - packet->P[1]) * packet->idir[1];
+  const ssef c1loz = (ssef(node2.y) - packet->P[2]) * packet->idir[2];
+  const ssef c1hiz = (ssef(node2.w) - packet->P[2]) * packet->idir[2];
+  const ssef c1min = max(max(ssef(0.0f), min(c1lox, c1hix)),
+                         max(min(c1loy, c1hiy), min(c1loz, c1hiz)));
+  const ssef c1max = min(min(packet->t, max(c1lox, c1hix)),
+                         min(max(c1loy, c1hiy), max(c1loz, c1hiz)));
+
+  child_mask[0] = (int)movemask(c0max >= c0min) & lane_mask;
+  child_mask[1] = (int)movemask(c1max >= c1min) & lane_mask;
+
+#  ifdef __VISIBILITY_FLAG__
+  if (!(__float_as_uint(cnodes.x) & visibility)) {
+    child_mask[0] = 0;
+  }
+  if (!(__float_as_uint(cnodes.y) & visibility)) {
+    child_mask[1] = 0;
+  }
+#  else
+  (void)cnodes;
+  (void)visibility;
+#  endif
+
+  dist[0] = reduce_min(select(sseb(child_mask[0]), c0min, ssef(FLT_MAX)));
+  dist[1] = reduce_min(select(sseb(child_mask[1]), c1min, ssef(FLT_MAX)));
+}
+#endif /* __BVH_PACKET__ */
@@ -0,0 +1,313 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This is a template BVH traversal function for packets of opaque shadow
+ * rays, where various features can be enabled/disabled. This way we can
+ * compile optimized versions for each case without new features slowing
+ * things down.
+ *
+ * Rays of the packet are traversed together, each node being tested against
+ * all of them at once with SSE. Only rays hitting a node take part in the
+ * traversal of its subtree, and a ray leaves the packet as soon as it is
+ * found to be occluded. All rays must have the same time.
+ *
+ * BVH_HAIR: hair curve rendering
+ * BVH_MOTION: motion blur rendering
+ */
+
+ccl_device_noinline uint BVH_FUNCTION_FULL_NAME(BVH)(KernelGlobals *kg,
+                                                     const Ray *rays,
+                                                     const int num_rays,
+                                                     const uint visibility)
+{
+  kernel_assert(num_rays <= BVH_PACKET_SIZE);
+  kernel_assert(visibility & PATH_RAY_SHADOW_OPAQUE);
+
+  /* traversal stack, with the lanes active for each entry */
+  int traversal_stack[BVH_STACK_SIZE];
+  int traversal_lanes[BVH_STACK_SIZE];
+  traversal_stack[0] = ENTRYPOINT_SENTINEL;
+  traversal_lanes[0] = 0;
+
+  /* traversal variables */
+  int stack_ptr = 0;
+  int node_addr = kernel_data.bvh.root;
+  int object = OBJECT_NONE;
+
+  /* per ray parameters */
+  float3 P[BVH_PACKET_SIZE];
+  float3 dir[BVH_PACKET_SIZE];
+  float3 idir[BVH_PACKET_SIZE];
+  Intersection isect[BVH_PACKET_SIZE];
+#if BVH_FEATURE(BVH_MOTION)
+  Transform ob_itfm[BVH_PACKET_SIZE];
+#endif
+  BVHRayPacket packet;
+
+  /* rays still to be traversed, and rays found to be occluded */
+  int valid_lanes = 0;
+  uint occluded = 0;
+
+  for (int lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+    if (lane < num_rays && rays[lane].t != 0.0f && scene_intersect_valid(&rays[lane])) {
+      P[lane] = rays[lane].P;
+      dir[lane] = bvh_clamp_direction(rays[lane].D);
+      idir[lane] = bvh_inverse_direction(dir[lane]);
+      isect[lane].t = rays[lane].t;
+      valid_lanes |= (1 << lane);
+    }
+    else {
+      P[lane] = make_float3(0.0f, 0.0f, 0.0f);
+      idir[lane] = make_float3(0.0f, 0.0f, 0.0f);
+      isect[lane].t = -FLT_MAX;
+    }
+    bvh_ray_packet_set_lane(&packet, lane, P[lane], idir[lane], isect[lane].t);
+  }
+
+  const int packet_lanes = valid_lanes;
+  int node_lanes = valid_lanes;
+
+  /* traversal loop */
+  do {
+    do {
+      /* traverse internal nodes */
+      while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
+        int child_mask[2];
+        float dist[2];
+        float4 cnodes = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
+
+#if BVH_FEATURE(BVH_HAIR)
+        if (__float_as_uint(cnodes.x) & PATH_RAY_NODE_UNALIGNED) {
+          child_mask[0] = child_mask[1] = 0;
+          dist[0] = dist[1] = FLT_MAX;
+          for (int lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+            if (!(node_lanes & (1 << lane))) {
+              continue;
+            }
+            float lane_dist[2];
+            const int traverse_mask = bvh_unaligned_node_intersect(kg,
+                                                                   P[lane],
+                                                                   dir[lane],
+                                                                   idir[lane],
+                                                                   isect[lane].t,
+                                                                   node_addr,
+                                                                   visibility,
+                                                                   lane_dist);
+            if (traverse_mask & 1) {
+              child_mask[0] |= (1 << lane);
+              dist[0] = min(dist[0], lane_dist[0]);
+            }
+            if (traverse_mask & 2) {
+              child_mask[1] |= (1 << lane);
+              dist[1] = min(dist[1], lane_dist[1]);
+            }
+          }
+        }
+        else
+#endif
+        {
+          bvh_aligned_node_intersect_packet(
+              kg, &packet, node_addr, visibility, node_lanes, child_mask, dist);
+        }
+
+        node_addr = __float_as_int(cnodes.z);
+        int node_addr_child1 = __float_as_int(cnodes.w);
+
+        if (child_mask[0] && child_mask[1]) {
+          /* Both children were intersected, push the farther one. */
+          int node_lanes_child1 = child_mask[1];
+          node_lanes = child_mask[0];
+
+          if (dist[1] < dist[0]) {
+            int tmp = node_addr;
+            node_addr = node_addr_child1;
+            node_addr_child1 = tmp;
+            tmp = node_lanes;
+            node_lanes = node_lanes_child1;
+            node_lanes_child1 = tmp;
+          }
+
+          ++stack_ptr;
+          kernel_assert(stack_ptr < BVH_STACK_SIZE);
+          traversal_stack[stack_ptr] = node_addr_child1;
+          traversal_lanes[stack_ptr] = node_lanes_child1;
+        }
+        else if (child_mask[1]) {
+          /* One child was intersected. */
+          node_addr = node_addr_child1;
+          node_lanes = child_mask[1];
+        }
+        else if (child_mask[0]) {
+          node_lanes = child_mask[0];
+        }
+        else {
+          /* Neither child was intersected. */
+          node_addr = traversal_stack[stack_ptr];
+          node_lanes = traversal_lanes[stack_ptr] & valid_lanes;
+          --stack_ptr;
+        }
+      }
+
+      /* if node is leaf, fetch primitive list */
+      if (node_addr < 0) {
+        float4 leaf = kernel_tex_fetch(__bvh_leaf_nodes, (-node_addr - 1));
+        int prim_addr = __float_as_int(leaf.x);
+
+        if (prim_addr >= 0) {
+          const int prim_addr2 = __float_as_int(leaf.y);
+          const uint type = __float_as_int(leaf.w);
+
+          /* primitive intersection, per ray */
+          for (int lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+            if (!(node_lanes & (1 << lane))) {
+              continue;
+            }
+
+            bool hit = false;
+            for (int addr = prim_addr; addr < prim_addr2 && !hit; addr++) {
+              switch (type & PRIMITIVE_ALL) {
+                case PRIMITIVE_TRIANGLE: {
+                  hit = triangle_intersect(
+                      kg, &isect[lane], P[lane], dir[lane], visibility, object, addr);
+                  break;
+                }
+#if BVH_FEATURE(BVH_MOTION)
+                case PRIMITIVE_MOTION_TRIANGLE: {
+                  hit = motion_triangle_intersect(kg,
+                                                  &isect[lane],
+                                                  P[lane],
+                                                  dir[lane],
+                                                  rays[lane].time,
+                                                  visibility,
+                                                  object,
+                                                  addr);
+                  break;
+                }
+#endif /* BVH_FEATURE(BVH_MOTION) */
+#if BVH_FEATURE(BVH_HAIR)
+                case PRIMITIVE_CURVE_THICK:
+                case PRIMITIVE_MOTION_CURVE_THICK:
+                case PRIMITIVE_CURVE_RIBBON:
+                case PRIMITIVE_MOTION_CURVE_RIBBON: {
+                  const uint curve_type = kernel_tex_fetch(__prim_type, addr);
+                  hit = curve_intersect(kg,
+                                        &isect[lane],
+                                        P[lane],
+                                        dir[lane],
+                                        visibility,
+                                        object,
+                                        addr,
+                                        rays[lane].time,
+                                        curve_type);
+                  break;
+                }
+#endif /* BVH_FEATURE(BVH_HAIR) */
+              }
+            }
+
+            if (hit) {
+              /* shadow ray early termination */
+              occluded |= (1 << lane);
+              valid_lanes &= ~(1 << lane);
+            }
+          }
+
+          if (valid_lanes == 0) {
+            return occluded;
+          }
+
+          /* pop */
+          node_addr = traversal_stack[stack_ptr];
+          node_lanes = traversal_lanes[stack_ptr] & valid_lanes;
+          --stack_ptr;
+        }
+        else {
+          /* instance push, rays outside of the subtree are transformed as well
+           * since they are all restored on pop */
+          object = kernel_tex_fetch(__prim_object, -prim_addr - 1);
+
+          for (int lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+            if (packet_lanes & (1 << lane)) {
+#if BVH_FEATURE(BVH_MOTION)
+              isect[lane].t = bvh_instance_motion_push(kg,
+                                                       object,
+                                                       &rays[lane],
+                                                       &P[lane],
+                                                       &dir[lane],
+                                                       &idir[lane],
+                                                       isect[lane].t,
+                                                       &ob_itfm[lane]);
+#else
+              isect[lane].t = bvh_instance_push(
+                  kg, object, &rays[lane], &P[lane], &dir[lane], &idir[lane], isect[lane].t);
+#endif
+              bvh_ray_packet_set_lane(&packet, lane, P[lane], idir[lane], isect[lane].t);
+            }
+          }
+
+          ++stack_ptr;
+          kernel_assert(stack_ptr < BVH_STACK_SIZE);
+          traversal_stack[stack_ptr] = ENTRYPOINT_SENTINEL;
+          traversal_lanes[stack_ptr] = node_lanes;
+
+          node_addr = kernel_tex_fetch(__object_node, object);
+        }
+      }
+    } while (node_addr != ENTRYPOINT_SENTINEL);
+
+    if (stack_ptr >= 0) {
+      kernel_assert(object != OBJECT_NONE);
+
+      /* instance pop */
+      for (int lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+        if (packet_lanes & (1 << lane)) {
+#if BVH_FEATURE(BVH_MOTION)
+          isect[lane].t = bvh_instance_motion_pop(kg,
+                                                  object,
+                                                  &rays[lane],
+                                                  &P[lane],
+                                                  &dir[lane],
+                                                  &idir[lane],
+                                                  isect[lane].t,
+                                                  &ob_itfm[lane]);
+#else
+          isect[lane].t = bvh_instance_pop(
+              kg, object, &rays[lane], &P[lane], &dir[lane], &idir[lane], isect[lane].t);
+#endif
+          bvh_ray_packet_set_lane(&packet, lane, P[lane], idir[lane], isect[lane].t);
+        }
+      }
+
+      object = OBJECT_NONE;
+      node_addr = traversal_stack[stack_ptr];
+      node_lanes = traversal_lanes[stack_ptr] & valid_lanes;
+      --stack_ptr;
+    }
+  } while (node_addr != ENTRYPOINT_SENTINEL);
+
+  return occluded;
+}
+
+ccl_device_inline uint BVH_FUNCTION_NAME(KernelGlobals *kg,
+                                         const Ray *rays,
+                                         const int num_rays,
+                                         const uint visibility)
+{
+  return BVH_FUNCTION_FULL_NAME(BVH)(kg, rays, num_rays, visibility);
+}
+
+#undef BVH_FUNCTION_NAME
+#undef BVH_FUNCTION_FEATURES
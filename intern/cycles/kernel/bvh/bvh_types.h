@@ -31,6 +31,9 @@ CCL_NAMESPACE_BEGIN
 
 /* 64 object BVH + 64 mesh BVH + 64 object node splitting */
 #define BVH_STACK_SIZE 192
+
+/* maximum number of rays traced together by packet traversal */
+#define BVH_PACKET_SIZE 4
 /* BVH intersection function variations */
 
 #define BVH_MOTION 1
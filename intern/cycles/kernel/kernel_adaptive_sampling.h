@@ -37,6 +37,12 @@ ccl_device void kernel_do_adaptive_stopping(KernelGlobals *kg,
     /* Set the fourth component to non-zero value to indicate that this pixel has converged. */
     buffer[kernel_data.film.pass_adaptive_aux_buffer + 3] += 1.0f;
   }
+  if (kernel_data.film.pass_adaptive_error) {
+    /* Error relative to the threshold at the last check, pixels below one have converged. */
+    buffer[kernel_data.film.pass_adaptive_error] = error /
+                                                   (kernel_data.integrator.adaptive_threshold *
+                                                    (float)sample);
+  }
 }
 
 /* Adjust the values of an adaptively sampled pixel. */
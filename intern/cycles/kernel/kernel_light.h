@@ -35,10 +35,257 @@ typedef struct LightSample {
   LightType type; /* type of light */
 } LightSample;
 
+/* Light Tree */
+
+/* Estimate of the light arriving at P from a cluster of emitters, based on its
+ * energy, distance and orientation. Zero only when none of the emitters can
+ * emit light towards P. */
+ccl_device float light_tree_cluster_importance(const float3 P,
+                                               const float3 bbox_min,
+                                               const float3 bbox_max,
+                                               const float3 axis,
+                                               const float theta_o,
+                                               const float theta_e,
+                                               const float energy)
+{
+  if (energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius_squared = 0.25f * len_squared(bbox_max - bbox_min);
+  const float3 centroid_to_P = P - centroid;
+  const float distance_squared = len_squared(centroid_to_P);
+
+  if (distance_squared <= radius_squared) {
+    /* Inside the bounds, light may come from any emitter in any direction. */
+    return energy / max(radius_squared, 1e-12f);
+  }
+
+  float cos_theta_prime = 1.0f;
+  if (theta_o < M_PI_F) {
+    /* Smallest angle between the direction to P and the emitter normals,
+     * accounting for the angle the bounds subtend as seen from P. */
+    const float distance = sqrtf(distance_squared);
+    const float theta = safe_acosf(dot(axis, centroid_to_P) / distance);
+    const float theta_u = safe_asinf(sqrtf(radius_squared / distance_squared));
+    const float theta_prime = max(theta - theta_o - theta_u, 0.0f);
+    if (theta_prime >= theta_e) {
+      return 0.0f;
+    }
+    cos_theta_prime = cosf(theta_prime);
+  }
+
+  return energy * cos_theta_prime / distance_squared;
+}
+
+ccl_device_inline float light_tree_node_importance(KernelGlobals *kg, const float3 P, int index)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, index);
+  return light_tree_cluster_importance(
+      P,
+      make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]),
+      make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]),
+      make_float3(knode->axis[0], knode->axis[1], knode->axis[2]),
+      knode->theta_o,
+      knode->theta_e,
+      knode->energy);
+}
+
+ccl_device_inline float light_tree_emitter_importance(KernelGlobals *kg,
+                                                      const float3 P,
+                                                      int index)
+{
+  const ccl_global KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                         index);
+  return light_tree_cluster_importance(
+      P,
+      make_float3(kemitter->bbox_min[0], kemitter->bbox_min[1], kemitter->bbox_min[2]),
+      make_float3(kemitter->bbox_max[0], kemitter->bbox_max[1], kemitter->bbox_max[2]),
+      make_float3(kemitter->axis[0], kemitter->axis[1], kemitter->axis[2]),
+      kemitter->theta_o,
+      kemitter->theta_e,
+      kemitter->energy);
+}
+
+ccl_device_inline float light_tree_leaf_importance(KernelGlobals *kg,
+                                                   const float3 P,
+                                                   const ccl_global KernelLightTreeNode *knode)
+{
+  float total = 0.0f;
+  for (int i = 0; i < knode->num_emitters; i++) {
+    total += light_tree_emitter_importance(kg, P, knode->child_index + i);
+  }
+  return total;
+}
+
+/* Pick an emitter for shading point P by traversing the light tree, returning
+ * its index in the light distribution or -1 when no emitter reaches P. The
+ * random number is rescaled for reuse, and pdf is the selection probability. */
+ccl_device int light_tree_sample(KernelGlobals *kg, const float3 P, float *randu, float *pdf)
+{
+  float r = *randu;
+  float pdf_select = 1.0f;
+
+  /* Distant lights have no position, pick them with the same probability as
+   * without light tree. */
+  const int num_distant = kernel_data.integrator.num_distant_lights;
+  if (num_distant > 0) {
+    const float pdf_distant = num_distant * kernel_data.integrator.pdf_lights;
+    if (r < pdf_distant) {
+      const float x = r / pdf_distant * num_distant;
+      const int index = min((int)x, num_distant - 1);
+      *randu = min(x - index, 0.99999994f);
+      *pdf = kernel_data.integrator.pdf_lights;
+      return kernel_tex_fetch(__light_tree_emitters, index).distribution_index;
+    }
+    r = (r - pdf_distant) / (1.0f - pdf_distant);
+    pdf_select = 1.0f - pdf_distant;
+  }
+
+  if (kernel_tex_fetch(__light_tree_nodes, 0).energy == 0.0f) {
+    return -1;
+  }
+
+  /* Traverse inner nodes, choosing children proportional to their importance. */
+  int node_index = 0;
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+
+  while (knode->num_emitters == 0) {
+    const float importance_left = light_tree_node_importance(kg, P, node_index + 1);
+    const float importance_right = light_tree_node_importance(kg, P, knode->child_index);
+    const float importance_total = importance_left + importance_right;
+    if (importance_total == 0.0f) {
+      return -1;
+    }
+
+    const float prob_left = importance_left / importance_total;
+    if (r < prob_left) {
+      node_index = node_index + 1;
+      r = r / prob_left;
+      pdf_select *= prob_left;
+    }
+    else {
+      node_index = knode->child_index;
+      r = (r - prob_left) / (1.0f - prob_left);
+      pdf_select *= 1.0f - prob_left;
+    }
+    r = min(r, 0.99999994f);
+
+    knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  }
+
+  /* Pick an emitter in the leaf. */
+  const float importance_total = light_tree_leaf_importance(kg, P, knode);
+  if (importance_total == 0.0f) {
+    return -1;
+  }
+
+  const float target = r * importance_total;
+  float importance_sum = 0.0f;
+  int selected = -1;
+  float selected_importance = 0.0f;
+  float selected_sum = 0.0f;
+
+  for (int i = 0; i < knode->num_emitters; i++) {
+    const float importance = light_tree_emitter_importance(kg, P, knode->child_index + i);
+    if (importance == 0.0f) {
+      continue;
+    }
+
+    /* Fall back to the last emitter in case of float precision issues. */
+    selected = knode->child_index + i;
+    selected_importance = importance;
+    selected_sum = importance_sum;
+
+    if (target < importance_sum + importance) {
+      break;
+    }
+    importance_sum += importance;
+  }
+
+  *randu = clamp((target - selected_sum) / selected_importance, 0.0f, 0.99999994f);
+  *pdf = pdf_select * selected_importance / importance_total;
+  return kernel_tex_fetch(__light_tree_emitters, selected).distribution_index;
+}
+
+/* Probability of light_tree_sample() picking the emitter for shading point P. */
+ccl_device float light_tree_pdf(KernelGlobals *kg, const float3 P, uint emitter)
+{
+  const int num_distant = kernel_data.integrator.num_distant_lights;
+  if (emitter == ~0u) {
+    return 0.0f;
+  }
+  else if (emitter < (uint)num_distant) {
+    return kernel_data.integrator.pdf_lights;
+  }
+
+  float pdf = 1.0f - num_distant * kernel_data.integrator.pdf_lights;
+  const uint bit_trail = kernel_tex_fetch(__light_tree_emitters, emitter).bit_trail;
+
+  /* Follow the path to the leaf of the emitter. */
+  int node_index = 0;
+  int depth = 0;
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+
+  while (knode->num_emitters == 0) {
+    const float importance_left = light_tree_node_importance(kg, P, node_index + 1);
+    const float importance_right = light_tree_node_importance(kg, P, knode->child_index);
+    const float importance_total = importance_left + importance_right;
+    if (importance_total == 0.0f) {
+      return 0.0f;
+    }
+
+    const float prob_left = importance_left / importance_total;
+    if (bit_trail & (1u << depth)) {
+      node_index = knode->child_index;
+      pdf *= 1.0f - prob_left;
+    }
+    else {
+      node_index = node_index + 1;
+      pdf *= prob_left;
+    }
+    depth++;
+
+    knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  }
+
+  const float importance_total = light_tree_leaf_importance(kg, P, knode);
+  if (importance_total == 0.0f) {
+    return 0.0f;
+  }
+
+  return pdf * light_tree_emitter_importance(kg, P, emitter) / importance_total;
+}
+
+ccl_device_inline float light_tree_lamp_pdf(KernelGlobals *kg, const float3 P, int lamp)
+{
+  return light_tree_pdf(kg, P, kernel_tex_fetch(__light_tree_lamp_emitters, lamp));
+}
+
+ccl_device_inline float light_tree_triangle_pdf(KernelGlobals *kg,
+                                                const float3 P,
+                                                int object,
+                                                int prim)
+{
+  const uint offset = kernel_tex_fetch(__light_tree_object_offsets, object * 2 + 0);
+  if (offset == ~0u) {
+    return 0.0f;
+  }
+  const uint prim_offset = kernel_tex_fetch(__light_tree_object_offsets, object * 2 + 1);
+  return light_tree_pdf(
+      kg, P, kernel_tex_fetch(__light_tree_triangle_emitters, offset + prim - prim_offset));
+}
+
 /* Regular Light */
 
-ccl_device_inline bool lamp_light_sample(
-    KernelGlobals *kg, int lamp, float randu, float randv, float3 P, LightSample *ls)
+ccl_device_inline bool lamp_light_sample(KernelGlobals *kg,
+                                         int lamp,
+                                         float randu,
+                                         float randv,
+                                         float3 P,
+                                         float pdf_select,
+                                         LightSample *ls)
 {
   const ccl_global KernelLight *klight = &kernel_tex_fetch(__lights, lamp);
   LightType type = (LightType)klight->type;
@@ -153,7 +400,7 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= pdf_select;
 
   return (ls->pdf > 0.0f);
 }
@@ -291,7 +538,8 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= (kernel_data.integrator.use_light_tree) ? light_tree_lamp_pdf(kg, P, lamp) :
+                                                        kernel_data.integrator.pdf_lights;
 
   return true;
 }
@@ -328,12 +576,11 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
-ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
-                                                const float3 Ng,
+ccl_device_inline float triangle_light_pdf_area(const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                float pdf)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -358,10 +605,14 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
   const float3 N = cross(e0, e1);
   const float distance_to_plane = fabsf(dot(N, sd->I * t)) / dot(N, N);
 
+  /* sd contains the point on the light source
+   * calculate Px, the point that we're shading */
+  const float3 Px = sd->P + sd->I * t;
+  const float pdf_tree = (kernel_data.integrator.use_light_tree) ?
+                             light_tree_triangle_pdf(kg, Px, sd->object, sd->prim) :
+                             0.0f;
+
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
-    /* sd contains the point on the light source
-     * calculate Px, the point that we're shading */
-    const float3 Px = sd->P + sd->I * t;
     const float3 v0_p = V[0] - Px;
     const float3 v1_p = V[1] - Px;
     const float3 v2_p = V[2] - Px;
@@ -389,12 +640,21 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
       else {
         area = 0.5f * len(N);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = (kernel_data.integrator.use_light_tree) ?
+                            pdf_tree :
+                            area * kernel_data.integrator.pdf_triangles;
       return pdf / solid_angle;
     }
   }
+  else if (kernel_data.integrator.use_light_tree) {
+    const float area = 0.5f * len(N);
+    if (UNLIKELY(area == 0.0f)) {
+      return 0.0f;
+    }
+    return triangle_light_pdf_area(sd->Ng, sd->I, t, pdf_tree / area);
+  }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(sd->Ng, sd->I, t, kernel_data.integrator.pdf_triangles);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -418,7 +678,8 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
                                                   float randv,
                                                   float time,
                                                   LightSample *ls,
-                                                  const float3 P)
+                                                  const float3 P,
+                                                  const float pdf_tree)
 {
   /* A naive heuristic to decide between costly solid angle sampling
    * and simple area sampling, comparing the distance to the triangle plane
@@ -542,7 +803,9 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
         triangle_world_space_vertices(kg, object, prim, -1.0f, V);
         area = triangle_area(V[0], V[1], V[2]);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = (kernel_data.integrator.use_light_tree) ?
+                            pdf_tree :
+                            area * kernel_data.integrator.pdf_triangles;
       ls->pdf = pdf / solid_angle;
     }
   }
@@ -564,8 +827,15 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
-    if (has_motion && area != 0.0f) {
+    if (kernel_data.integrator.use_light_tree) {
+      ls->pdf = (area != 0.0f) ? triangle_light_pdf_area(ls->Ng, -ls->D, ls->t, pdf_tree / area) :
+                                 0.0f;
+    }
+    else {
+      ls->pdf = triangle_light_pdf_area(
+          ls->Ng, -ls->D, ls->t, kernel_data.integrator.pdf_triangles);
+    }
+    if (has_motion && area != 0.0f && !kernel_data.integrator.use_light_tree) {
       /* scale the PDF.
        * area = the area the sample was taken from
        * area_pre = the are from which pdf_triangles was calculated from */
@@ -632,9 +902,20 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       int bounce,
                                       LightSample *ls)
 {
+  float pdf_select = kernel_data.integrator.pdf_lights;
+
   if (lamp < 0) {
     /* sample index */
-    int index = light_distribution_sample(kg, &randu);
+    int index;
+    if (kernel_data.integrator.use_light_tree) {
+      index = light_tree_sample(kg, P, &randu, &pdf_select);
+      if (index == -1) {
+        return false;
+      }
+    }
+    else {
+      index = light_distribution_sample(kg, &randu);
+    }
 
     /* fetch light data */
     const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
@@ -645,7 +926,7 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
       int object = kdistribution->mesh_light.object_id;
       int shader_flag = kdistribution->mesh_light.shader_flag;
 
-      triangle_light_sample(kg, prim, object, randu, randv, time, ls, P);
+      triangle_light_sample(kg, prim, object, randu, randv, time, ls, P, pdf_select);
       ls->shader |= shader_flag;
       return (ls->pdf > 0.0f);
     }
@@ -657,7 +938,7 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
     return false;
   }
 
-  return lamp_light_sample(kg, lamp, randu, randv, P, ls);
+  return lamp_light_sample(kg, lamp, randu, randv, P, pdf_select, ls);
 }
 
 ccl_device_inline int light_select_num_samples(KernelGlobals *kg, int index)
@@ -18,6 +18,66 @@ CCL_NAMESPACE_BEGIN
 
 #ifdef __BRANCHED_PATH__
 
+#  ifdef __BVH_PACKET__
+/* Same as kernel_branched_path_ao(), tracing the AO rays in packets. All rays
+ * start from the same point at the same time, which makes them coherent. */
+ccl_device_noinline_cpu void kernel_branched_path_ao_packet(KernelGlobals *kg,
+                                                            ShaderData *sd,
+                                                            PathRadiance *L,
+                                                            ccl_addr_space PathState *state,
+                                                            float3 throughput,
+                                                            float3 ao_N,
+                                                            float3 ao_bsdf,
+                                                            float3 ao_alpha)
+{
+  int num_samples = kernel_data.integrator.ao_samples;
+  float num_samples_inv = 1.0f / num_samples;
+  const float3 ao_P = ray_offset(sd->P, sd->Ng);
+  const float3 ao_shadow = make_float3(1.0f, 1.0f, 1.0f);
+
+  Ray light_rays[BVH_PACKET_SIZE];
+  int num_rays = 0;
+
+  for (int j = 0; j < num_samples; j++) {
+    float bsdf_u, bsdf_v;
+    path_branched_rng_2D(
+        kg, state->rng_hash, state, j, num_samples, PRNG_BSDF_U, &bsdf_u, &bsdf_v);
+
+    float3 ao_D;
+    float ao_pdf;
+
+    sample_cos_hemisphere(ao_N, bsdf_u, bsdf_v, &ao_D, &ao_pdf);
+
+    if (dot(sd->Ng, ao_D) > 0.0f && ao_pdf != 0.0f) {
+      Ray *light_ray = &light_rays[num_rays++];
+
+      light_ray->P = ao_P;
+      light_ray->D = ao_D;
+      light_ray->t = kernel_data.background.ao_distance;
+      light_ray->time = sd->time;
+      light_ray->dP = sd->dP;
+      light_ray->dD = differential3_zero();
+    }
+
+    if (num_rays == BVH_PACKET_SIZE || (num_rays > 0 && j == num_samples - 1)) {
+      const uint blocked = shadow_blocked_packet(kg, state, light_rays, num_rays);
+
+      for (int i = 0; i < num_rays; i++) {
+        if (!(blocked & (1 << i))) {
+          path_radiance_accum_ao(
+              kg, L, state, throughput * num_samples_inv, ao_alpha, ao_bsdf, ao_shadow);
+        }
+        else {
+          path_radiance_accum_total_ao(L, state, throughput * num_samples_inv, ao_bsdf);
+        }
+      }
+
+      num_rays = 0;
+    }
+  }
+}
+#  endif /* __BVH_PACKET__ */
+
 ccl_device_inline void kernel_branched_path_ao(KernelGlobals *kg,
                                                ShaderData *sd,
                                                ShaderData *emission_sd,
@@ -32,6 +92,13 @@ ccl_device_inline void kernel_branched_path_ao(KernelGlobals *kg,
   float3 ao_bsdf = shader_bsdf_ao(kg, sd, ao_factor, &ao_N);
   float3 ao_alpha = shader_bsdf_alpha(kg, sd);
 
+#  ifdef __BVH_PACKET__
+  if (shadow_blocked_packet_supported(kg, state)) {
+    kernel_branched_path_ao_packet(kg, sd, L, state, throughput, ao_N, ao_bsdf, ao_alpha);
+    return;
+  }
+#  endif
+
   for (int j = 0; j < num_samples; j++) {
     float bsdf_u, bsdf_v;
     path_branched_rng_2D(
@@ -461,6 +461,46 @@ ccl_device_inline bool shadow_blocked(KernelGlobals *kg,
 #endif   /* __TRANSPARENT_SHADOWS__ */
 }
 
+#ifdef __BVH_PACKET__
+/* Shadow rays can be traced as a packet when no shading is needed along them,
+ * that is with opaque shadows and outside of volumes. */
+ccl_device_inline bool shadow_blocked_packet_supported(KernelGlobals *kg,
+                                                       ccl_addr_space PathState *state)
+{
+#  ifdef __TRANSPARENT_SHADOWS__
+  if (kernel_data.integrator.transparent_shadows) {
+    return false;
+  }
+#  endif
+#  ifdef __VOLUME__
+  if (state->volume_stack[0].shader != SHADER_NONE) {
+    return false;
+  }
+#  endif
+  (void)kg;
+  (void)state;
+  return true;
+}
+
+/* Same as shadow_blocked() for up to BVH_PACKET_SIZE rays with the same time,
+ * returning a bit mask of the blocked rays. Unblocked rays have no shadow. */
+ccl_device_inline uint shadow_blocked_packet(KernelGlobals *kg,
+                                             ccl_addr_space PathState *state,
+                                             Ray *rays,
+                                             int num_rays)
+{
+  kernel_assert(shadow_blocked_packet_supported(kg, state));
+#  ifdef __SHADOW_TRICKS__
+  const uint visibility = (state->flag & PATH_RAY_SHADOW_CATCHER) ? PATH_RAY_SHADOW_NON_CATCHER :
+                                                                    PATH_RAY_SHADOW;
+#  else
+  const uint visibility = PATH_RAY_SHADOW;
+#  endif
+  return scene_intersect_occluded_packet(
+      kg, rays, num_rays, visibility & PATH_RAY_SHADOW_OPAQUE);
+}
+#endif /* __BVH_PACKET__ */
+
 #undef SHADOW_STACK_MAX_HITS
 
 CCL_NAMESPACE_END
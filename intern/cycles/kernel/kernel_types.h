@@ -128,6 +128,9 @@ CCL_NAMESPACE_BEGIN
 #  endif
 #  define __VOLUME_DECOUPLED__
 #  define __VOLUME_RECORD_ALL__
+#  ifdef __KERNEL_SSE2__
+#    define __BVH_PACKET__
+#  endif
 #endif /* __KERNEL_CPU__ */
 
 #ifdef __KERNEL_CUDA__
@@ -374,6 +377,7 @@ typedef enum PassType {
   PASS_AOV_VALUE,
   PASS_ADAPTIVE_AUX_BUFFER,
   PASS_SAMPLE_COUNT,
+  PASS_ADAPTIVE_ERROR,
   PASS_CATEGORY_MAIN_END = 31,
 
   PASS_MIST = 32,
@@ -1254,7 +1258,8 @@ typedef struct KernelFilm {
   int pass_aov_value;
   int pass_aov_color_num;
   int pass_aov_value_num;
-  int pad1, pad2, pad3;
+  int pass_adaptive_error;
+  int pad2, pad3;
 
   /* XYZ to rendering color space transform. float4 instead of float3 to
    * ensure consistent padding/alignment across devices. */
@@ -1389,7 +1394,9 @@ typedef struct KernelIntegrator {
 
   int max_closures;
 
-  int pad1, pad2;
+  /* light tree */
+  int use_light_tree;
+  int num_distant_lights;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1548,6 +1555,44 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Light tree node. Bounds and orientation cone of all emitters in the node, the
+ * cone axis with spread theta_o contains all emitter normals and theta_e is the
+ * largest angle light is emitted at, relative to those normals. */
+typedef struct KernelLightTreeNode {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+
+  /* Inner nodes: index of the second child, the first child directly follows
+   * the node. Leaves: index of the first emitter. */
+  int child_index;
+  /* Number of emitters in leaves, zero for inner nodes. */
+  int num_emitters;
+  int pad1, pad2;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+/* Emitter in the leaf of a light tree, or one of the distant lights which are
+ * stored ahead of all tree emitters. */
+typedef struct KernelLightTreeEmitter {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+
+  int distribution_index;
+  /* Path from the root to the leaf holding the emitter, one bit per level which
+   * is set when the second child is visited. */
+  uint bit_trail;
+  int pad1, pad2;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
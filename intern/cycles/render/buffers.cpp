@@ -134,6 +134,8 @@ RenderBuffers::RenderBuffers(Device *device)
       map_neighbor_copied(false),
       render_time(0.0f)
 {
+  /* Render buffers are read back for every tile update and written result. */
+  buffer.use_pinned_host = true;
 }
 
 RenderBuffers::~RenderBuffers()
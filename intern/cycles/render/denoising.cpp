@@ -228,7 +228,8 @@ DenoiseTask::DenoiseTask(Device *device,
                          Denoiser *denoiser,
                          int frame,
                          const vector<int> &neighbor_frames)
-    : denoiser(denoiser),
+    : loaded(false),
+      denoiser(denoiser),
       device(device),
       frame(frame),
       neighbor_frames(neighbor_frames),
@@ -439,86 +440,111 @@ void DenoiseTask::create_task(DeviceTask &task)
 
 bool DenoiseTask::load_input_pixels(int layer)
 {
-  int w = image.width;
-  int h = image.height;
   int num_pixels = image.width * image.height;
   int frame_stride = num_pixels * INPUT_NUM_CHANNELS;
+  bool use_cache = !neighbor_frames.empty();
 
-  /* Load center image */
   DenoiseImageLayer &image_layer = image.layers[layer];
 
+  /* Load center image followed by neighbor images. */
   float *buffer_data = input_pixels.data();
-  image.read_pixels(image_layer, buffer_data);
-  buffer_data += frame_stride;
-
-  /* Load neighbor images */
-  for (int i = 0; i < image.in_neighbors.size(); i++) {
-    if (!image.read_neighbor_pixels(i, image_layer, buffer_data)) {
-      error = "Failed to read neighbor frame pixels";
-      return false;
+  for (int neighbor = -1; neighbor < (int)image.in_neighbors.size(); neighbor++) {
+    const int input_frame = (neighbor == -1) ? frame : neighbor_frames[neighbor];
+    const pair<int, string> cache_key(input_frame, image_layer.name);
+
+    bool is_cached = false;
+    if (use_cache) {
+      thread_scoped_lock cache_lock(denoiser->frame_cache_mutex);
+      map<pair<int, string>, array<float>>::iterator cached = denoiser->frame_cache.find(
+          cache_key);
+      if (cached != denoiser->frame_cache.end()) {
+        memcpy(buffer_data, cached->second.data(), sizeof(float) * frame_stride);
+        is_cached = true;
+      }
     }
-    buffer_data += frame_stride;
-  }
 
-  /* Preprocess */
-  buffer_data = input_pixels.data();
-  for (int neighbor = 0; neighbor < image.in_neighbors.size() + 1; neighbor++) {
-    /* Clamp */
-    if (denoiser->params.clamp_input) {
-      for (int i = 0; i < num_pixels * INPUT_NUM_CHANNELS; i++) {
-        buffer_data[i] = clamp(buffer_data[i], -1e8f, 1e8f);
+    if (!is_cached) {
+      if (neighbor == -1) {
+        image.read_pixels(image_layer, buffer_data);
+      }
+      else if (!image.read_neighbor_pixels(neighbor, image_layer, buffer_data)) {
+        error = "Failed to read neighbor frame pixels";
+        return false;
       }
-    }
 
-    /* Box blur */
-    int r = 5 * denoiser->params.radius;
-    float *data = buffer_data + 14;
-    array<float> temp(num_pixels);
+      preprocess_input_pixels(buffer_data);
 
-    for (int y = 0; y < h; y++) {
-      for (int x = 0; x < w; x++) {
-        int n = 0;
-        float sum = 0.0f;
-        for (int dx = max(x - r, 0); dx < min(x + r + 1, w); dx++, n++) {
-          sum += data[INPUT_NUM_CHANNELS * (y * w + dx)];
-        }
-        temp[y * w + x] = sum / n;
+      if (use_cache) {
+        thread_scoped_lock cache_lock(denoiser->frame_cache_mutex);
+        array<float> &cache_pixels = denoiser->frame_cache[cache_key];
+        cache_pixels.resize(frame_stride);
+        memcpy(cache_pixels.data(), buffer_data, sizeof(float) * frame_stride);
       }
     }
 
-    for (int y = 0; y < h; y++) {
-      for (int x = 0; x < w; x++) {
-        int n = 0;
-        float sum = 0.0f;
+    buffer_data += frame_stride;
+  }
 
-        for (int dy = max(y - r, 0); dy < min(y + r + 1, h); dy++, n++) {
-          sum += temp[dy * w + x];
-        }
+  /* Copy to device */
+  input_pixels.copy_to_device();
 
-        data[INPUT_NUM_CHANNELS * (y * w + x)] = sum / n;
-      }
+  return true;
+}
+
+void DenoiseTask::preprocess_input_pixels(float *buffer_data)
+{
+  int w = image.width;
+  int h = image.height;
+  int num_pixels = image.width * image.height;
+
+  /* Clamp */
+  if (denoiser->params.clamp_input) {
+    for (int i = 0; i < num_pixels * INPUT_NUM_CHANNELS; i++) {
+      buffer_data[i] = clamp(buffer_data[i], -1e8f, 1e8f);
     }
+  }
 
-    /* Highlight compression */
-    data = buffer_data + 8;
-    for (int y = 0; y < h; y++) {
-      for (int x = 0; x < w; x++) {
-        int idx = INPUT_NUM_CHANNELS * (y * w + x);
-        float3 color = make_float3(data[idx], data[idx + 1], data[idx + 2]);
-        color = color_highlight_compress(color, NULL);
-        data[idx] = color.x;
-        data[idx + 1] = color.y;
-        data[idx + 2] = color.z;
+  /* Box blur */
+  int r = 5 * denoiser->params.radius;
+  float *data = buffer_data + 14;
+  array<float> temp(num_pixels);
+
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int n = 0;
+      float sum = 0.0f;
+      for (int dx = max(x - r, 0); dx < min(x + r + 1, w); dx++, n++) {
+        sum += data[INPUT_NUM_CHANNELS * (y * w + dx)];
       }
+      temp[y * w + x] = sum / n;
     }
-
-    buffer_data += frame_stride;
   }
 
-  /* Copy to device */
-  input_pixels.copy_to_device();
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int n = 0;
+      float sum = 0.0f;
 
-  return true;
+      for (int dy = max(y - r, 0); dy < min(y + r + 1, h); dy++, n++) {
+        sum += temp[dy * w + x];
+      }
+
+      data[INPUT_NUM_CHANNELS * (y * w + x)] = sum / n;
+    }
+  }
+
+  /* Highlight compression */
+  data = buffer_data + 8;
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int idx = INPUT_NUM_CHANNELS * (y * w + x);
+      float3 color = make_float3(data[idx], data[idx + 1], data[idx + 2]);
+      color = color_highlight_compress(color, NULL);
+      data[idx] = color.x;
+      data[idx + 1] = color.y;
+      data[idx + 2] = color.z;
+    }
+  }
 }
 
 /* Task stages */
@@ -867,8 +893,10 @@ Denoiser::Denoiser(DeviceInfo &device_info)
 {
   samples_override = 0;
   tile_size = make_int2(64, 64);
+  prefetch_frames = 1;
 
   num_frames = 0;
+  prefetch_stop = false;
 
   /* Initialize task scheduler. */
   TaskScheduler::init();
@@ -887,47 +915,123 @@ Denoiser::~Denoiser()
   TaskScheduler::exit();
 }
 
+vector<int> Denoiser::get_neighbor_frames(int frame)
+{
+  /* Determine neighbor frame numbers that should be used for filtering. */
+  vector<int> neighbor_frames;
+  for (int f = frame - params.neighbor_frames; f <= frame + params.neighbor_frames; f++) {
+    if (f >= 0 && f < num_frames && f != frame) {
+      neighbor_frames.push_back(f);
+    }
+  }
+  return neighbor_frames;
+}
+
+/* Load frames ahead, so that reading and preprocessing images overlaps with denoising on the
+ * device. At most prefetch_frames loaded frames are kept waiting, to bound memory usage. */
+void Denoiser::prefetch_tasks(const vector<int> &frames)
+{
+  foreach (int frame, frames) {
+    {
+      thread_scoped_lock lock(prefetch_mutex);
+      prefetch_cond.wait(lock, [&] {
+        return prefetch_stop || prefetch_queue.size() < (size_t)prefetch_frames;
+      });
+      if (prefetch_stop) {
+        return;
+      }
+    }
+
+    DenoiseTask *task = new DenoiseTask(device, this, frame, get_neighbor_frames(frame));
+    task->loaded = task->load();
+
+    thread_scoped_lock lock(prefetch_mutex);
+    prefetch_queue.push_back(task);
+    prefetch_cond.notify_all();
+
+    if (!task->loaded) {
+      return;
+    }
+  }
+}
+
 bool Denoiser::run()
 {
   assert(input.size() == output.size());
 
   num_frames = output.size();
 
+  /* Skip empty output paths. */
+  vector<int> frames;
   for (int frame = 0; frame < num_frames; frame++) {
-    /* Skip empty output paths. */
-    if (output[frame].empty()) {
-      continue;
+    if (!output[frame].empty()) {
+      frames.push_back(frame);
     }
+  }
 
-    /* Determine neighbor frame numbers that should be used for filtering. */
-    vector<int> neighbor_frames;
-    for (int f = frame - params.neighbor_frames; f <= frame + params.neighbor_frames; f++) {
-      if (f >= 0 && f < num_frames && f != frame) {
-        neighbor_frames.push_back(f);
-      }
+  prefetch_stop = false;
+  unique_ptr<thread> prefetch_thread;
+  if (prefetch_frames > 0) {
+    prefetch_thread.reset(new thread(function_bind(&Denoiser::prefetch_tasks, this, frames)));
+  }
+
+  bool ok = true;
+
+  foreach (int frame, frames) {
+    /* Get the loaded task, or load it now when not prefetching. */
+    unique_ptr<DenoiseTask> task;
+    if (prefetch_thread) {
+      thread_scoped_lock lock(prefetch_mutex);
+      prefetch_cond.wait(lock, [&] { return !prefetch_queue.empty(); });
+      task.reset(prefetch_queue.front());
+      prefetch_queue.pop_front();
+      prefetch_cond.notify_all();
+    }
+    else {
+      task.reset(new DenoiseTask(device, this, frame, get_neighbor_frames(frame)));
+      task->loaded = task->load();
     }
 
     /* Execute task. */
-    DenoiseTask task(device, this, frame, neighbor_frames);
-    if (!task.load()) {
-      error = task.error;
-      return false;
+    if (!task->loaded || !task->exec() || !task->save()) {
+      error = task->error;
+      ok = false;
+      break;
     }
 
-    if (!task.exec()) {
-      error = task.error;
-      return false;
+    task->free();
+
+    /* Drop cached frames that are not a neighbor of any of the following frames. */
+    thread_scoped_lock cache_lock(frame_cache_mutex);
+    for (map<pair<int, string>, array<float>>::iterator it = frame_cache.begin();
+         it != frame_cache.end();) {
+      if (it->first.first < frame + 1 - params.neighbor_frames) {
+        it = frame_cache.erase(it);
+      }
+      else {
+        ++it;
+      }
     }
+  }
 
-    if (!task.save()) {
-      error = task.error;
-      return false;
+  if (prefetch_thread) {
+    {
+      thread_scoped_lock lock(prefetch_mutex);
+      prefetch_stop = true;
+      prefetch_cond.notify_all();
     }
+    prefetch_thread->join();
 
-    task.free();
+    /* Free frames that were loaded ahead but not denoised because of an error. */
+    foreach (DenoiseTask *task, prefetch_queue) {
+      delete task;
+    }
+    prefetch_queue.clear();
   }
 
-  return true;
+  frame_cache.clear();
+
+  return ok;
 }
 
 CCL_NAMESPACE_END
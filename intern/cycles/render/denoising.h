@@ -22,7 +22,10 @@
 
 #include "render/buffers.h"
 
+#include "util/util_list.h"
+#include "util/util_map.h"
 #include "util/util_string.h"
+#include "util/util_thread.h"
 #include "util/util_unique_ptr.h"
 #include "util/util_vector.h"
 
@@ -32,6 +35,8 @@ OIIO_NAMESPACE_USING
 
 CCL_NAMESPACE_BEGIN
 
+class DenoiseTask;
+
 /* Denoiser */
 
 class Denoiser {
@@ -55,6 +60,9 @@ class Denoiser {
   int samples_override;
   /* Tile size for processing on device. */
   int2 tile_size;
+  /* Number of frames that are loaded ahead while the current frame is denoised on the device.
+   * Zero loads every frame right before it is denoised. */
+  int prefetch_frames;
 
   /* Equivalent to the settings in the regular denoiser. */
   DenoiseParams params;
@@ -67,6 +75,21 @@ class Denoiser {
   Device *device;
 
   int num_frames;
+
+  /* Frames waiting to be denoised, loaded ahead by the prefetch thread. */
+  thread_mutex prefetch_mutex;
+  thread_condition_variable prefetch_cond;
+  list<DenoiseTask *> prefetch_queue;
+  bool prefetch_stop;
+
+  void prefetch_tasks(const vector<int> &frames);
+  vector<int> get_neighbor_frames(int frame);
+
+  /* Preprocessed input pixels of frames by frame number and layer name. Consecutive frames
+   * share most of their neighbors, so this avoids reading and preprocessing the same frame
+   * again for every frame it is a neighbor of. */
+  map<pair<int, string>, array<float>> frame_cache;
+  thread_mutex frame_cache_mutex;
 };
 
 /* Denoise Image Layer */
@@ -165,6 +188,8 @@ class DenoiseTask {
   void free();
 
   string error;
+  /* Whether load() succeeded, for tasks loaded ahead. */
+  bool loaded;
 
  protected:
   /* Denoiser parameters and device */
@@ -192,6 +217,7 @@ class DenoiseTask {
 
   /* Task handling */
   bool load_input_pixels(int layer);
+  void preprocess_input_pixels(float *buffer_data);
   void create_task(DeviceTask &task);
 
   /* Device task callbacks */
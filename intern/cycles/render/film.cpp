@@ -190,6 +190,12 @@ void Pass::add(PassType type, vector<Pass> &passes, const char *name)
       pass.components = 1;
       pass.exposure = false;
       break;
+    case PASS_ADAPTIVE_ERROR:
+      /* Written as is by the kernel, not accumulated over samples. */
+      pass.components = 1;
+      pass.filter = false;
+      pass.exposure = false;
+      break;
     case PASS_AOV_COLOR:
       pass.components = 4;
       break;
@@ -368,6 +374,7 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
   kfilm->use_light_pass = use_light_visibility;
   kfilm->pass_aov_value_num = 0;
   kfilm->pass_aov_color_num = 0;
+  kfilm->pass_adaptive_error = 0;
 
   bool have_cryptomatte = false;
 
@@ -512,6 +519,9 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
       case PASS_SAMPLE_COUNT:
         kfilm->pass_sample_count = kfilm->pass_stride;
         break;
+      case PASS_ADAPTIVE_ERROR:
+        kfilm->pass_adaptive_error = kfilm->pass_stride;
+        break;
       case PASS_AOV_COLOR:
         if (kfilm->pass_aov_color_num == 0) {
           kfilm->pass_aov_color = kfilm->pass_stride;
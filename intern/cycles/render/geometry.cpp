@@ -192,15 +192,26 @@ void Geometry::compute_bvh(
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild) {
+    bool rebuild = (bvh == NULL || need_update_rebuild);
+
+    if (!rebuild) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->geometry = geometry;
       bvh->objects = objects;
 
       bvh->refit(*progress);
+
+      /* Deforming geometry can make the refitted tree much slower to traverse than a new one,
+       * the time spent building is then won back when rendering. */
+      if (bvh->refit_quality_degraded()) {
+        VLOG(1) << "Rebuilding BVH of " << name << ", SAH cost went from "
+                << bvh->build_sah_cost << " to " << bvh->sah_cost << " after refit.";
+        rebuild = true;
+      }
     }
-    else {
+
+    if (rebuild) {
       progress->set_status(msg, "Building BVH");
 
       BVHParams bparams;
@@ -775,6 +775,30 @@ void ShaderGraph::compute_displacement_hash()
   displacement_hash = md5.get_hex();
 }
 
+/* Compute hash of the whole graph, including links and runtime data of the nodes.
+ * Finalized graphs with the same hash compile to the same nodes, which is used to
+ * compile shaders with identical graphs only once. */
+string ShaderGraph::compute_hash()
+{
+  MD5Hash md5;
+  foreach (ShaderNode *node, nodes) {
+    node->hash(md5);
+    node->hash_runtime(md5);
+    md5.append((uint8_t *)&node->id, sizeof(node->id));
+    md5.append((uint8_t *)&node->bump, sizeof(node->bump));
+
+    foreach (ShaderInput *input, node->inputs) {
+      int link_id = (input->link) ? input->link->parent->id : -1;
+      md5.append((uint8_t *)&link_id, sizeof(link_id));
+      if (input->link) {
+        md5.append(input->link->name().string());
+      }
+    }
+  }
+
+  return md5.get_hex();
+}
+
 void ShaderGraph::clean(Scene *scene)
 {
   /* Graph simplification */
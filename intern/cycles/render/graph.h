@@ -268,6 +268,12 @@ class ShaderNode : public Node {
    * is to be handled in the subclass.
    */
   virtual bool equals(const ShaderNode &other);
+
+  /* Add runtime data of the node which is not stored in sockets but affects the
+   * compiled shader, like image slots, to the hash of the graph. */
+  virtual void hash_runtime(MD5Hash & /*md5*/)
+  {
+  }
 };
 
 /* Node definition utility macros */
@@ -335,6 +341,7 @@ class ShaderGraph {
 
   void remove_proxy_nodes();
   void compute_displacement_hash();
+  string compute_hash();
   void simplify(Scene *scene);
   void finalize(Scene *scene,
                 bool do_bump = false,
@@ -25,6 +25,7 @@
 #include "util/util_image.h"
 #include "util/util_image_impl.h"
 #include "util/util_logging.h"
+#include "util/util_md5.h"
 #include "util/util_path.h"
 #include "util/util_progress.h"
 #include "util/util_task.h"
@@ -80,6 +81,65 @@ const char *name_from_type(ImageDataType type)
   return "";
 }
 
+size_t pixel_size_from_type(ImageDataType type)
+{
+  switch (type) {
+    case IMAGE_DATA_TYPE_FLOAT4:
+      return sizeof(float4);
+    case IMAGE_DATA_TYPE_BYTE4:
+      return sizeof(uchar4);
+    case IMAGE_DATA_TYPE_HALF4:
+      return sizeof(half4);
+    case IMAGE_DATA_TYPE_FLOAT:
+      return sizeof(float);
+    case IMAGE_DATA_TYPE_BYTE:
+      return sizeof(uchar);
+    case IMAGE_DATA_TYPE_HALF:
+      return sizeof(half);
+    case IMAGE_DATA_TYPE_USHORT4:
+      return sizeof(ushort4);
+    case IMAGE_DATA_TYPE_USHORT:
+      return sizeof(uint16_t);
+    case IMAGE_DATA_NUM_TYPES:
+      assert(!"System enumerator type, should never be used");
+      return 0;
+  }
+  assert(!"Unhandled image data type");
+  return 0;
+}
+
+/* Data type of the image on the device, float images may be stored as half float. */
+ImageDataType image_device_type(const ImageManager::Image *img)
+{
+  if (img->use_half_float) {
+    if (img->metadata.type == IMAGE_DATA_TYPE_FLOAT4) {
+      return IMAGE_DATA_TYPE_HALF4;
+    }
+    else if (img->metadata.type == IMAGE_DATA_TYPE_FLOAT) {
+      return IMAGE_DATA_TYPE_HALF;
+    }
+  }
+  return img->metadata.type;
+}
+
+/* Memory used by an image once loaded with the given texture limit, matching the
+ * power of two down-scaling done by file_load_image(). */
+size_t image_memory_size(const ImageManager::Image *img, const int texture_limit)
+{
+  const ImageMetaData &metadata = img->metadata;
+  size_t width = metadata.width, height = metadata.height, depth = metadata.depth;
+  size_t max_size = max(max(width, height), depth);
+
+  while (texture_limit > 0 && max_size > (size_t)texture_limit) {
+    width = max(width / 2, (size_t)1);
+    height = max(height / 2, (size_t)1);
+    depth = max(depth / 2, (size_t)1);
+    max_size /= 2;
+  }
+
+  return width * height * depth * pixel_size_from_type(image_device_type(img));
+}
+
 }  // namespace
 
 /* Image Handle */
@@ -177,6 +237,13 @@ bool ImageHandle::operator==(const ImageHandle &other) const
   return manager == other.manager && tile_slots == other.tile_slots;
 }
 
+void ImageHandle::hash(MD5Hash &md5) const
+{
+  foreach (int slot, tile_slots) {
+    md5.append((const uint8_t *)&slot, sizeof(slot));
+  }
+}
+
 /* Image MetaData */
 
 ImageMetaData::ImageMetaData()
@@ -268,6 +335,7 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   has_half_images = info.has_half_images;
+  use_half_float_images = false;
 }
 
 ImageManager::~ImageManager()
@@ -276,6 +344,11 @@ ImageManager::~ImageManager()
     assert(!images[slot]);
 }
 
+void ImageManager::set_use_half_float_images(bool use_half_float)
+{
+  use_half_float_images = use_half_float;
+}
+
 void ImageManager::set_osl_texture_system(void *texture_system)
 {
   osl_texture_system = texture_system;
@@ -330,6 +403,14 @@ void ImageManager::load_image_metadata(Image *img)
     }
   }
 
+  /* Float color images are stored as half float when requested, the precision is enough
+   * for colors. Non-color data and volumes keep full precision. */
+  img->use_half_float = use_half_float_images && has_half_images &&
+                        (metadata.type == IMAGE_DATA_TYPE_FLOAT4 ||
+                         metadata.type == IMAGE_DATA_TYPE_FLOAT) &&
+                        metadata.depth <= 1 &&
+                        !ColorSpaceManager::colorspace_is_data(img->params.colorspace);
+
   img->need_metadata = false;
 }
 
@@ -409,6 +490,8 @@ int ImageManager::add_image_slot(ImageLoader *loader,
   img->need_load = !(osl_texture_system && !img->loader->osl_filepath().empty());
   img->builtin = builtin;
   img->users = 1;
+  img->texture_limit = 0;
+  img->use_half_float = false;
   img->mem = NULL;
 
   images[slot] = img;
@@ -452,7 +535,7 @@ static bool image_associate_alpha(ImageManager::Image *img)
            img->params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED);
 }
 
-template<TypeDesc::BASETYPE FileFormat, typename StorageType>
+template<TypeDesc::BASETYPE FileFormat, typename StorageType, typename DeviceType>
 bool ImageManager::file_load_image(Image *img, int texture_limit)
 {
   /* we only handle certain number of components */
@@ -475,8 +558,10 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
     return false;
   }
 
-  /* Allocate memory as needed, may be smaller to resize down. */
-  if (texture_limit > 0 && max_size > texture_limit) {
+  /* Allocate memory as needed, may be smaller to resize down or of another type to convert. */
+  const bool need_resize = (texture_limit > 0 && max_size > texture_limit);
+  const bool need_convert = (sizeof(StorageType) != sizeof(DeviceType));
+  if (need_resize || need_convert) {
     pixels_storage.resize(((size_t)width) * height * depth * 4);
     pixels = &pixels_storage[0];
   }
@@ -575,7 +660,7 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   }
 
   /* Scale image down if needed. */
-  if (pixels_storage.size() > 0) {
+  if (need_resize) {
     float scale_factor = 1.0f;
     while (max_size * scale_factor > texture_limit) {
       scale_factor *= 0.5f;
@@ -595,14 +680,31 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
                              &scaled_height,
                              &scaled_depth);
 
-    StorageType *texture_pixels;
+    pixels_storage.swap(scaled_pixels);
+    width = scaled_width;
+    height = scaled_height;
+    depth = scaled_depth;
+  }
+
+  /* Copy to the device texture, converting to its data type if needed. */
+  if (need_resize || need_convert) {
+    DeviceType *texture_pixels;
 
     {
       thread_scoped_lock device_lock(device_mutex);
-      texture_pixels = (StorageType *)img->mem->alloc(scaled_width, scaled_height, scaled_depth);
+      texture_pixels = (DeviceType *)img->mem->alloc(width, height, depth);
     }
 
-    memcpy(texture_pixels, &scaled_pixels[0], scaled_pixels.size() * sizeof(StorageType));
+    const size_t num_texture_values = ((size_t)width) * height * depth * (is_rgba ? 4 : 1);
+    if (need_convert) {
+      for (size_t i = 0; i < num_texture_values; i++) {
+        texture_pixels[i] = util_image_cast_from_float<DeviceType>(
+            util_image_cast_to_float(pixels_storage[i]));
+      }
+    }
+    else {
+      memcpy(texture_pixels, &pixels_storage[0], num_texture_values * sizeof(StorageType));
+    }
   }
 
   return true;
@@ -618,10 +720,13 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
 
   progress->set_status("Updating Images", "Loading " + img->loader->name());
 
-  const int texture_limit = scene->params.texture_limit;
+  int texture_limit = scene->params.texture_limit;
+  if (img->texture_limit > 0 && (texture_limit == 0 || img->texture_limit < texture_limit)) {
+    texture_limit = img->texture_limit;
+  }
 
   load_image_metadata(img);
-  ImageDataType type = img->metadata.type;
+  ImageDataType type = image_device_type(img);
 
   /* Name for debugging. */
   img->mem_name = string_printf("__tex_image_%s_%03d", name_from_type(type), slot);
@@ -682,7 +787,11 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
     }
   }
   else if (type == IMAGE_DATA_TYPE_HALF4) {
-    if (!file_load_image<TypeDesc::HALF, half>(img, texture_limit)) {
+    /* Float images converted to half float are still loaded as float. */
+    const bool loaded = (img->use_half_float) ?
+                            file_load_image<TypeDesc::FLOAT, float, half>(img, texture_limit) :
+                            file_load_image<TypeDesc::HALF, half>(img, texture_limit);
+    if (!loaded) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       half *pixels = (half *)img->mem->alloc(1, 1);
@@ -715,7 +824,11 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
     }
   }
   else if (type == IMAGE_DATA_TYPE_HALF) {
-    if (!file_load_image<TypeDesc::HALF, half>(img, texture_limit)) {
+    /* Float images converted to half float are still loaded as float. */
+    const bool loaded = (img->use_half_float) ?
+                            file_load_image<TypeDesc::FLOAT, float, half>(img, texture_limit) :
+                            file_load_image<TypeDesc::HALF, half>(img, texture_limit);
+    if (!loaded) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
       half *pixels = (half *)img->mem->alloc(1, 1);
@@ -760,12 +873,89 @@ void ImageManager::device_free_image(Device *, int slot)
   images[slot] = NULL;
 }
 
+void ImageManager::device_fit_memory_limit(Scene *scene, Progress &progress, bool builtin_only)
+{
+  const size_t memory_limit = scene->params.texture_memory_limit;
+  if (memory_limit == 0) {
+    return;
+  }
+
+  /* Images that are already on the device keep their resolution, the limit is
+   * applied to the ones that are about to be loaded. */
+  size_t memory_used = 0;
+  vector<Image *> pending;
+  foreach (Image *img, images) {
+    if (img == NULL || img->users == 0) {
+      continue;
+    }
+    if (img->need_load && (img->builtin || !builtin_only)) {
+      pending.push_back(img);
+    }
+    else if (img->mem) {
+      memory_used += img->mem->memory_size();
+    }
+  }
+
+  if (pending.empty()) {
+    return;
+  }
+
+  progress.set_status("Updating Images", "Computing texture sizes");
+
+  const int scene_texture_limit = scene->params.texture_limit;
+  size_t memory_pending = 0;
+  foreach (Image *img, pending) {
+    load_image_metadata(img);
+    img->texture_limit = scene_texture_limit;
+    memory_pending += image_memory_size(img, img->texture_limit);
+  }
+
+  /* Halve the resolution of the biggest remaining image until everything fits,
+   * so small textures keep their full resolution as long as possible. */
+  const size_t memory_available = (memory_limit > memory_used) ? memory_limit - memory_used : 0;
+  while (memory_pending > memory_available) {
+    Image *biggest = NULL;
+    size_t biggest_size = 0;
+    foreach (Image *img, pending) {
+      const size_t size = image_memory_size(img, img->texture_limit);
+      if (size > biggest_size && image_memory_size(img, 1) < size) {
+        biggest = img;
+        biggest_size = size;
+      }
+    }
+
+    if (biggest == NULL) {
+      /* All images are already down to a single pixel. */
+      break;
+    }
+
+    const ImageMetaData &metadata = biggest->metadata;
+    int max_size = (int)max(max(metadata.width, metadata.height), metadata.depth);
+    if (biggest->texture_limit > 0) {
+      max_size = min(max_size, biggest->texture_limit);
+    }
+    biggest->texture_limit = max(max_size / 2, 1);
+
+    memory_pending -= biggest_size;
+    memory_pending += image_memory_size(biggest, biggest->texture_limit);
+  }
+
+  foreach (Image *img, pending) {
+    if (img->texture_limit != scene_texture_limit) {
+      VLOG(1) << "Limiting image " << img->loader->name() << " to " << img->texture_limit
+              << " pixels to fit the texture memory limit.";
+    }
+  }
+}
+
 void ImageManager::device_update(Device *device, Scene *scene, Progress &progress)
 {
   if (!need_update) {
     return;
   }
 
+  device_fit_memory_limit(scene, progress, false);
+
   TaskPool pool;
   for (size_t slot = 0; slot < images.size(); slot++) {
     Image *img = images[slot];
@@ -804,6 +994,8 @@ void ImageManager::device_load_builtin(Device *device, Scene *scene, Progress &p
     return;
   }
 
+  device_fit_memory_limit(scene, progress, true);
+
   TaskPool pool;
   for (size_t slot = 0; slot < images.size(); slot++) {
     Image *img = images[slot];
@@ -35,6 +35,7 @@ class ImageHandle;
 class ImageKey;
 class ImageMetaData;
 class ImageManager;
+class MD5Hash;
 class Progress;
 class RenderStats;
 class Scene;
@@ -140,6 +141,8 @@ class ImageHandle {
 
   bool operator==(const ImageHandle &other) const;
 
+  void hash(MD5Hash &md5) const;
+
   void clear();
 
   bool empty();
@@ -179,6 +182,7 @@ class ImageManager {
   void device_free_builtin(Device *device);
 
   void set_osl_texture_system(void *texture_system);
+  void set_use_half_float_images(bool use_half_float);
   bool set_animation_frame_update(int frame);
 
   void collect_statistics(RenderStats *stats);
@@ -194,6 +198,10 @@ class ImageManager {
     bool need_metadata;
     bool need_load;
     bool builtin;
+    /* Maximum resolution chosen to fit the texture memory limit, 0 for no limit. */
+    int texture_limit;
+    /* Float image stored as half float on the device. */
+    bool use_half_float;
 
     string mem_name;
     device_texture *mem;
@@ -204,6 +212,7 @@ class ImageManager {
 
  private:
   bool has_half_images;
+  bool use_half_float_images;
 
   thread_mutex device_mutex;
   thread_mutex images_mutex;
@@ -218,9 +227,12 @@ class ImageManager {
 
   void load_image_metadata(Image *img);
 
-  template<TypeDesc::BASETYPE FileFormat, typename StorageType>
+  template<TypeDesc::BASETYPE FileFormat,
+           typename StorageType,
+           typename DeviceType = StorageType>
   bool file_load_image(Image *img, int texture_limit);
 
+  void device_fit_memory_limit(Scene *scene, Progress &progress, bool builtin_only);
   void device_load_image(Device *device, Scene *scene, int slot, Progress *progress);
   void device_free_image(Device *device, int slot);
 
@@ -74,6 +74,7 @@ class Integrator : public Node {
   bool sample_all_lights_direct;
   bool sample_all_lights_indirect;
   float light_sampling_threshold;
+  bool use_light_tree;
 
   int adaptive_min_samples;
   float adaptive_threshold;
@@ -99,6 +100,9 @@ class Integrator : public Node {
 
   bool modified(const Integrator &integrator);
   void tag_update(Scene *scene);
+
+  /* The light tree is only used when lights are sampled one at a time. */
+  bool light_tree_enabled() const;
 };
 
 CCL_NAMESPACE_END
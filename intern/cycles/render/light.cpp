@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/integrator.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -324,6 +325,18 @@ void LightManager::device_update_distribution(Device *,
   size_t num_distribution = num_triangles + num_lights;
   VLOG(1) << "Total " << num_distribution << " of light distribution primitives.";
 
+  /* Emitters for the light tree, along with the distribution index of every
+   * triangle of mesh lights and of every light to find them back in the kernel. */
+  const bool use_light_tree = scene->integrator->light_tree_enabled();
+  vector<LightTreePrimitive> tree_prims;
+  vector<int> distant_lights;
+  vector<int> triangle_distribution;
+  vector<int> lamp_distribution;
+  vector<uint> object_offsets;
+  if (use_light_tree) {
+    object_offsets.resize(scene->objects.size() * 2, ~0u);
+  }
+
   /* emission area */
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
@@ -365,6 +378,22 @@ void LightManager::device_update_distribution(Device *,
     }
 
     size_t mesh_num_triangles = mesh->num_triangles();
+
+    /* Rough estimate of the emitted light per area of each shader, only used
+     * to make the light tree prefer brighter emitters. */
+    vector<float> shader_emission;
+    if (use_light_tree) {
+      object_offsets[object_id * 2 + 0] = triangle_distribution.size();
+      object_offsets[object_id * 2 + 1] = mesh->prim_offset;
+      triangle_distribution.resize(triangle_distribution.size() + mesh_num_triangles, -1);
+
+      foreach (Shader *shader, mesh->used_shaders) {
+        float3 emission;
+        shader_emission.push_back(
+            shader->is_constant_emission(&emission) ? max(average(emission), 0.0f) : 1.0f);
+      }
+    }
+
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->shader[i];
       Shader *shader = (shader_index < mesh->used_shaders.size()) ?
@@ -372,6 +401,10 @@ void LightManager::device_update_distribution(Device *,
                            scene->default_surface;
 
       if (shader->use_mis && shader->has_surface_emission) {
+        if (use_light_tree) {
+          triangle_distribution[object_offsets[object_id * 2] + i] = offset;
+        }
+
         distribution[offset].totarea = totarea;
         distribution[offset].prim = i + mesh->prim_offset;
         distribution[offset].mesh_light.shader_flag = shader_flag;
@@ -392,7 +425,22 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          /* Mesh lights emit on both sides. */
+          LightTreePrimitive prim;
+          prim.bbox.grow(p1);
+          prim.bbox.grow(p2);
+          prim.bbox.grow(p3);
+          prim.cone = LightTreeCone::omnidirectional();
+          prim.energy = area * ((shader_index < shader_emission.size()) ?
+                                    shader_emission[shader_index] :
+                                    1.0f);
+          prim.distribution_index = offset - 1;
+          tree_prims.push_back(prim);
+        }
       }
     }
 
@@ -416,6 +464,40 @@ void LightManager::device_update_distribution(Device *,
     distribution[offset].lamp.size = light->size;
     totarea += lightarea;
 
+    if (use_light_tree) {
+      lamp_distribution.push_back(offset);
+
+      if (light->type == LIGHT_DISTANT || light->type == LIGHT_BACKGROUND) {
+        distant_lights.push_back(offset);
+      }
+      else {
+        /* Lamp strength is used as energy estimate, the exact scale relative to
+         * mesh lights only affects sampling efficiency. */
+        LightTreePrimitive prim;
+        if (light->type == LIGHT_AREA) {
+          const float3 axisu = light->axisu * (light->sizeu * light->size);
+          const float3 axisv = light->axisv * (light->sizev * light->size);
+          prim.bbox.grow(light->co - 0.5f * axisu - 0.5f * axisv);
+          prim.bbox.grow(light->co + 0.5f * axisu - 0.5f * axisv);
+          prim.bbox.grow(light->co - 0.5f * axisu + 0.5f * axisv);
+          prim.bbox.grow(light->co + 0.5f * axisu + 0.5f * axisv);
+          /* Area lights only emit on the front side. */
+          prim.cone = LightTreeCone(safe_normalize(light->dir), 0.0f, M_PI_2_F);
+        }
+        else {
+          /* Spot lights are treated as point lights, the cone does not include
+           * light leaking beyond the spot angle due to the light size. */
+          const float3 radius = make_float3(light->size, light->size, light->size);
+          prim.bbox.grow(light->co - radius);
+          prim.bbox.grow(light->co + radius);
+          prim.cone = LightTreeCone::omnidirectional();
+        }
+        prim.energy = max(average(light->strength), 0.0f);
+        prim.distribution_index = offset;
+        tree_prims.push_back(prim);
+      }
+    }
+
     if (light->type == LIGHT_DISTANT) {
       use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
     }
@@ -493,6 +575,20 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree */
+    if (use_light_tree) {
+      device_update_light_tree(dscene,
+                               tree_prims,
+                               distant_lights,
+                               object_offsets,
+                               triangle_distribution,
+                               lamp_distribution);
+    }
+    else {
+      kintegrator->use_light_tree = false;
+      kintegrator->num_distant_lights = 0;
+    }
+
     /* Portals */
     if (num_portals > 0) {
       kbackground->portal_offset = light_index;
@@ -516,6 +612,8 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->pdf_triangles = 0.0f;
     kintegrator->pdf_lights = 0.0f;
     kintegrator->use_lamp_mis = false;
+    kintegrator->use_light_tree = false;
+    kintegrator->num_distant_lights = 0;
 
     kbackground->num_portals = 0;
     kbackground->portal_offset = 0;
@@ -527,6 +625,91 @@ void LightManager::device_update_distribution(Device *,
   }
 }
 
+void LightManager::device_update_light_tree(DeviceScene *dscene,
+                                            const vector<LightTreePrimitive> &prims,
+                                            const vector<int> &distant_lights,
+                                            const vector<uint> &object_offsets,
+                                            const vector<int> &triangle_distribution,
+                                            const vector<int> &lamp_distribution)
+{
+  LightTree tree(prims);
+
+  VLOG(1) << "Light tree with " << tree.nodes.size() << " nodes for " << prims.size()
+          << " emitters and " << distant_lights.size() << " distant lights.";
+
+  /* Nodes, with an empty leaf when there are only distant lights. */
+  const size_t num_nodes = tree.nodes.empty() ? 1 : tree.nodes.size();
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(num_nodes);
+  memset(knodes, 0, sizeof(KernelLightTreeNode) * num_nodes);
+  if (!tree.nodes.empty()) {
+    memcpy(knodes, tree.nodes.data(), sizeof(KernelLightTreeNode) * tree.nodes.size());
+  }
+
+  /* Emitters, distant lights first and then tree emitters in leaf order. */
+  const size_t num_distant = distant_lights.size();
+  const size_t num_emitters = num_distant + tree.primitives.size();
+  KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(num_emitters);
+  memset(kemitters, 0, sizeof(KernelLightTreeEmitter) * num_emitters);
+
+  /* Map from distribution index to emitter index. */
+  vector<uint> distribution_emitter(dscene->light_distribution.size(), ~0u);
+
+  for (size_t i = 0; i < num_distant; i++) {
+    kemitters[i].distribution_index = distant_lights[i];
+    distribution_emitter[distant_lights[i]] = i;
+  }
+
+  for (size_t i = 0; i < tree.primitives.size(); i++) {
+    const LightTreePrimitive &prim = tree.primitives[i];
+    KernelLightTreeEmitter &kemitter = kemitters[num_distant + i];
+
+    kemitter.bbox_min[0] = prim.bbox.min.x;
+    kemitter.bbox_min[1] = prim.bbox.min.y;
+    kemitter.bbox_min[2] = prim.bbox.min.z;
+    kemitter.bbox_max[0] = prim.bbox.max.x;
+    kemitter.bbox_max[1] = prim.bbox.max.y;
+    kemitter.bbox_max[2] = prim.bbox.max.z;
+    kemitter.axis[0] = prim.cone.axis.x;
+    kemitter.axis[1] = prim.cone.axis.y;
+    kemitter.axis[2] = prim.cone.axis.z;
+    kemitter.theta_o = prim.cone.theta_o;
+    kemitter.theta_e = prim.cone.theta_e;
+    kemitter.energy = prim.energy;
+    kemitter.distribution_index = prim.distribution_index;
+    kemitter.bit_trail = prim.bit_trail;
+
+    distribution_emitter[prim.distribution_index] = num_distant + i;
+  }
+
+  /* Lookup of the emitter for lamps and triangles hit by rays. */
+  uint *klamp_emitters = dscene->light_tree_lamp_emitters.alloc(lamp_distribution.size());
+  for (size_t i = 0; i < lamp_distribution.size(); i++) {
+    klamp_emitters[i] = distribution_emitter[lamp_distribution[i]];
+  }
+
+  uint *kobject_offsets = dscene->light_tree_object_offsets.alloc(object_offsets.size());
+  for (size_t i = 0; i < object_offsets.size(); i++) {
+    kobject_offsets[i] = object_offsets[i];
+  }
+
+  uint *ktriangle_emitters = dscene->light_tree_triangle_emitters.alloc(
+      triangle_distribution.size());
+  for (size_t i = 0; i < triangle_distribution.size(); i++) {
+    const int index = triangle_distribution[i];
+    ktriangle_emitters[i] = (index != -1) ? distribution_emitter[index] : ~0u;
+  }
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_emitters.copy_to_device();
+  dscene->light_tree_lamp_emitters.copy_to_device();
+  dscene->light_tree_object_offsets.copy_to_device();
+  dscene->light_tree_triangle_emitters.copy_to_device();
+
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+  kintegrator->use_light_tree = true;
+  kintegrator->num_distant_lights = num_distant;
+}
+
 static void background_cdf(
     int start, int end, int res_x, int res_y, const vector<float3> *pixels, float2 *cond_cdf)
 {
@@ -1001,6 +1184,11 @@ void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_ba
 {
   dscene->light_distribution.free();
   dscene->lights.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
+  dscene->light_tree_lamp_emitters.free();
+  dscene->light_tree_object_offsets.free();
+  dscene->light_tree_triangle_emitters.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
     dscene->light_background_conditional_cdf.free();
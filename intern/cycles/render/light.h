@@ -30,6 +30,7 @@ CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceScene;
+struct LightTreePrimitive;
 class Object;
 class Progress;
 class Scene;
@@ -119,6 +120,12 @@ class LightManager {
                                   DeviceScene *dscene,
                                   Scene *scene,
                                   Progress &progress);
+  void device_update_light_tree(DeviceScene *dscene,
+                                const vector<LightTreePrimitive> &prims,
+                                const vector<int> &distant_lights,
+                                const vector<uint> &object_offsets,
+                                const vector<int> &triangle_distribution,
+                                const vector<int> &lamp_distribution);
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
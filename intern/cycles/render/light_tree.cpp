@@ -0,0 +1,253 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Cone */
+
+void LightTreeCone::grow(const LightTreeCone &other)
+{
+  if (other.is_empty()) {
+    return;
+  }
+  if (is_empty()) {
+    *this = other;
+    return;
+  }
+
+  theta_e = max(theta_e, other.theta_e);
+
+  if (theta_o >= M_PI_F || other.theta_o >= M_PI_F) {
+    axis = make_float3(0.0f, 0.0f, 1.0f);
+    theta_o = M_PI_F;
+    return;
+  }
+
+  /* Make this the wider cone. */
+  float3 a_axis = axis, b_axis = other.axis;
+  float a_theta_o = theta_o, b_theta_o = other.theta_o;
+  if (a_theta_o < b_theta_o) {
+    swap(a_axis, b_axis);
+    swap(a_theta_o, b_theta_o);
+  }
+
+  const float theta_d = safe_acosf(dot(a_axis, b_axis));
+  if (min(theta_d + b_theta_o, M_PI_F) <= a_theta_o) {
+    /* Wider cone contains the other one. */
+    axis = a_axis;
+    theta_o = a_theta_o;
+    return;
+  }
+
+  const float new_theta_o = 0.5f * (a_theta_o + theta_d + b_theta_o);
+  const float3 ortho = b_axis - a_axis * dot(a_axis, b_axis);
+  if (new_theta_o >= M_PI_F || len_squared(ortho) < 1e-12f) {
+    axis = make_float3(0.0f, 0.0f, 1.0f);
+    theta_o = M_PI_F;
+    return;
+  }
+
+  /* Rotate the axis of the wider cone towards the other one. */
+  const float theta_r = new_theta_o - a_theta_o;
+  axis = normalize(a_axis * cosf(theta_r) + normalize(ortho) * sinf(theta_r));
+  theta_o = new_theta_o;
+}
+
+/* Measure of the directions covered by the cone, used to compare splits. */
+static float light_tree_cone_measure(const LightTreeCone &cone)
+{
+  const float theta_o = cone.theta_o;
+  const float theta_w = min(theta_o + cone.theta_e, M_PI_F);
+  const float cos_theta_o = cosf(theta_o);
+  const float sin_theta_o = sinf(theta_o);
+  return M_2PI_F * (1.0f - cos_theta_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(theta_o - 2.0f * theta_w) -
+                     2.0f * theta_o * sin_theta_o + cos_theta_o);
+}
+
+/* Light Tree */
+
+LightTree::LightTree(const vector<LightTreePrimitive> &prims) : primitives(prims)
+{
+  if (primitives.empty()) {
+    return;
+  }
+
+  nodes.reserve(2 * primitives.size() / MAX_LEAF_SIZE + 1);
+  recursive_build(0, primitives.size(), 0, 0);
+}
+
+int LightTree::recursive_build(int start, int end, int depth, uint bit_trail)
+{
+  BoundBox bbox = BoundBox::empty;
+  BoundBox centroid_bbox = BoundBox::empty;
+  LightTreeCone cone;
+  float energy = 0.0f;
+
+  for (int i = start; i < end; i++) {
+    const LightTreePrimitive &prim = primitives[i];
+    bbox.grow(prim.bbox);
+    centroid_bbox.grow(prim.bbox.center());
+    cone.grow(prim.cone);
+    energy += prim.energy;
+  }
+
+  const int node_index = nodes.size();
+  nodes.push_back(KernelLightTreeNode());
+
+  int split = -1;
+  if (end - start > MAX_LEAF_SIZE && depth < MAX_DEPTH) {
+    split = find_split(start, end, centroid_bbox);
+  }
+
+  if (split == -1) {
+    for (int i = start; i < end; i++) {
+      primitives[i].bit_trail = bit_trail;
+    }
+  }
+  else {
+    recursive_build(start, split, depth + 1, bit_trail);
+    const int child_index = recursive_build(split, end, depth + 1, bit_trail | (1u << depth));
+    nodes[node_index].child_index = child_index;
+  }
+
+  KernelLightTreeNode &knode = nodes[node_index];
+  knode.bbox_min[0] = bbox.min.x;
+  knode.bbox_min[1] = bbox.min.y;
+  knode.bbox_min[2] = bbox.min.z;
+  knode.bbox_max[0] = bbox.max.x;
+  knode.bbox_max[1] = bbox.max.y;
+  knode.bbox_max[2] = bbox.max.z;
+  knode.axis[0] = cone.axis.x;
+  knode.axis[1] = cone.axis.y;
+  knode.axis[2] = cone.axis.z;
+  knode.theta_o = cone.theta_o;
+  knode.theta_e = cone.theta_e;
+  knode.energy = energy;
+  if (split == -1) {
+    knode.child_index = start;
+    knode.num_emitters = end - start;
+  }
+  else {
+    knode.num_emitters = 0;
+  }
+
+  return node_index;
+}
+
+/* Split the primitives in two, along the largest dimension of their centroids.
+ * Candidate splits are binned and weighted by energy, surface area and
+ * orientation of both halves. Returns the first primitive of the second half. */
+int LightTree::find_split(int start, int end, const BoundBox &centroid_bbox)
+{
+  const int num_bins = 12;
+  const float3 extent = centroid_bbox.size();
+  const int dim = (extent.x >= extent.y && extent.x >= extent.z) ? 0 :
+                  (extent.y >= extent.z)                          ? 1 :
+                                                                    2;
+  const float dim_min = centroid_bbox.min[dim];
+  const float dim_extent = extent[dim];
+
+  if (!(dim_extent > 0.0f)) {
+    /* All centroids are at the same location, split by count. */
+    return (start + end) / 2;
+  }
+
+  const float inv_bin_size = num_bins / dim_extent;
+  struct Bin {
+    BoundBox bbox = BoundBox::empty;
+    LightTreeCone cone;
+    float energy = 0.0f;
+    int count = 0;
+  } bins[num_bins];
+
+  for (int i = start; i < end; i++) {
+    const LightTreePrimitive &prim = primitives[i];
+    const int bin = clamp(
+        (int)((prim.bbox.center()[dim] - dim_min) * inv_bin_size), 0, num_bins - 1);
+    bins[bin].bbox.grow(prim.bbox);
+    bins[bin].cone.grow(prim.cone);
+    bins[bin].energy += prim.energy;
+    bins[bin].count++;
+  }
+
+  /* Cost of the left side of every split, then sweep from the right. */
+  float left_cost[num_bins - 1];
+  {
+    Bin left;
+    for (int i = 0; i < num_bins - 1; i++) {
+      left.bbox.grow(bins[i].bbox);
+      left.cone.grow(bins[i].cone);
+      left.energy += bins[i].energy;
+      left.count += bins[i].count;
+      left_cost[i] = (left.count == 0) ? 0.0f :
+                                         left.energy * left.bbox.safe_area() *
+                                             light_tree_cone_measure(left.cone);
+    }
+  }
+
+  int best_bin = -1;
+  float best_cost = FLT_MAX;
+  {
+    Bin right;
+    for (int i = num_bins - 1; i > 0; i--) {
+      right.bbox.grow(bins[i].bbox);
+      right.cone.grow(bins[i].cone);
+      right.energy += bins[i].energy;
+      right.count += bins[i].count;
+      const float right_cost = (right.count == 0) ? 0.0f :
+                                                    right.energy * right.bbox.safe_area() *
+                                                        light_tree_cone_measure(right.cone);
+      const float cost = left_cost[i - 1] + right_cost;
+      if (right.count != 0 && right.count != end - start && cost < best_cost) {
+        best_cost = cost;
+        best_bin = i;
+      }
+    }
+  }
+
+  int split = -1;
+  if (best_bin != -1 && best_cost > 0.0f) {
+    LightTreePrimitive *middle = std::partition(
+        &primitives[start], &primitives[0] + end, [&](const LightTreePrimitive &prim) {
+          const int bin = clamp(
+              (int)((prim.bbox.center()[dim] - dim_min) * inv_bin_size), 0, num_bins - 1);
+          return bin < best_bin;
+        });
+    split = middle - &primitives[0];
+  }
+
+  if (split <= start || split >= end) {
+    /* No useful split found, for example for points without any extent, split
+     * at the median centroid instead. */
+    split = (start + end) / 2;
+    std::nth_element(&primitives[start],
+                     &primitives[split],
+                     &primitives[0] + end,
+                     [&](const LightTreePrimitive &a, const LightTreePrimitive &b) {
+                       return a.bbox.center()[dim] < b.bbox.center()[dim];
+                     });
+  }
+
+  return split;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bounding cone of the directions light is emitted in. All emitter normals are
+ * within theta_o of the axis, and light leaves the emitter at most theta_e away
+ * from its normal. */
+
+struct LightTreeCone {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  LightTreeCone() : axis(make_float3(0.0f, 0.0f, 1.0f)), theta_o(-1.0f), theta_e(0.0f)
+  {
+  }
+
+  LightTreeCone(const float3 &axis, float theta_o, float theta_e)
+      : axis(axis), theta_o(theta_o), theta_e(theta_e)
+  {
+  }
+
+  /* Cone of an emitter that emits light in all directions. */
+  static LightTreeCone omnidirectional()
+  {
+    return LightTreeCone(make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F);
+  }
+
+  bool is_empty() const
+  {
+    return theta_o < 0.0f;
+  }
+
+  void grow(const LightTreeCone &other);
+};
+
+/* Emitter to be stored in the light tree. */
+
+struct LightTreePrimitive {
+  BoundBox bbox;
+  LightTreeCone cone;
+  float energy;
+  int distribution_index;
+  /* Filled in when building the tree. */
+  uint bit_trail;
+
+  LightTreePrimitive() : bbox(BoundBox::empty), energy(0.0f), distribution_index(0), bit_trail(0)
+  {
+  }
+};
+
+/* Bounding volume hierarchy over the emitters of the scene, used to pick the
+ * lights that contribute most to a shading point. Every node stores the bounds,
+ * orientation cone and energy of its emitters, from which the kernel estimates
+ * the importance of the node.
+ *
+ * Based on "Importance Sampling of Many Lights with Adaptive Tree Splitting"
+ * by Alejandro Conty Estevez and Christopher Kulla. */
+
+class LightTree {
+ public:
+  /* Depth is limited by the number of bits in the emitter bit trail. */
+  static const int MAX_DEPTH = 32;
+  static const int MAX_LEAF_SIZE = 8;
+
+  explicit LightTree(const vector<LightTreePrimitive> &prims);
+
+  /* Nodes in depth first order, the root being the first one. */
+  vector<KernelLightTreeNode> nodes;
+  /* Primitives in the order referenced by the leaves. */
+  vector<LightTreePrimitive> primitives;
+
+ protected:
+  int recursive_build(int start, int end, int depth, uint bit_trail);
+  int find_split(int start, int end, const BoundBox &centroid_bbox);
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
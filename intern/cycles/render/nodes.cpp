@@ -31,6 +31,7 @@
 
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
+#include "util/util_md5.h"
 #include "util/util_transform.h"
 
 #include "kernel/svm/svm_color_util.h"
@@ -6625,6 +6626,13 @@ ShaderNode *OSLNode::clone() const
   return OSLNode::create(this->inputs.size(), this);
 }
 
+void OSLNode::hash_runtime(MD5Hash &md5)
+{
+  /* Nodes with the same parameters may still run different scripts. */
+  md5.append(filepath);
+  md5.append(bytecode_hash);
+}
+
 OSLNode *OSLNode::create(size_t num_inputs, const OSLNode *from)
 {
   /* allocate space for the node itself and parameters, aligned to 16 bytes
@@ -86,6 +86,11 @@ class ImageSlotTextureNode : public TextureNode {
     return TextureNode::equals(other) && handle == other_node.handle;
   }
 
+  virtual void hash_runtime(MD5Hash &md5)
+  {
+    handle.hash(md5);
+  }
+
   ImageHandle handle;
 };
 
@@ -387,6 +392,11 @@ class PointDensityTextureNode : public ShaderNode {
     const PointDensityTextureNode &other_node = (const PointDensityTextureNode &)other;
     return ShaderNode::equals(other) && handle == other_node.handle;
   }
+
+  virtual void hash_runtime(MD5Hash &md5)
+  {
+    handle.hash(md5);
+  }
 };
 
 class IESLightNode : public TextureNode {
@@ -1521,6 +1531,8 @@ class OSLNode : public ShaderNode {
     return false;
   }
 
+  virtual void hash_runtime(MD5Hash &md5);
+
   string filepath;
   string bytecode_hash;
 };
@@ -31,6 +31,7 @@
 #  include "kernel/osl/osl_services.h"
 #  include "kernel/osl/osl_shader.h"
 
+#  include "util/util_algorithm.h"
 #  include "util/util_aligned_malloc.h"
 #  include "util/util_foreach.h"
 #  include "util/util_logging.h"
@@ -56,8 +57,14 @@ OSLRenderServices *OSLShaderManager::services_shared = NULL;
 int OSLShaderManager::ss_shared_users = 0;
 thread_mutex OSLShaderManager::ss_shared_mutex;
 thread_mutex OSLShaderManager::ss_mutex;
+map<string, OSLCompiledShader> OSLShaderManager::compiled_shaders;
+uint64_t OSLShaderManager::compiled_shaders_update = 0;
 int OSLCompiler::texture_shared_unique_id = 0;
 
+/* Maximum number of compiled shaders kept around for reuse, least recently
+ * used ones are freed first. */
+static const size_t OSL_COMPILED_SHADERS_MAX = 1024;
+
 /* Shader Manager */
 
 OSLShaderManager::OSLShaderManager()
@@ -86,8 +93,8 @@ void OSLShaderManager::free_memory()
 
 void OSLShaderManager::reset(Scene * /*scene*/)
 {
-  shading_system_free();
-  shading_system_init();
+  /* Keep the shared shading system, so the shader groups compiled for it can
+   * be reused when the scene is synchronized again. */
 }
 
 void OSLShaderManager::device_update(Device *device,
@@ -142,6 +149,11 @@ void OSLShaderManager::device_update(Device *device,
 
   need_update = false;
 
+  {
+    thread_scoped_lock lock(ss_mutex);
+    compiled_shaders_trim();
+  }
+
   /* add special builtin texture types */
   services->textures.insert(ustring("@ao"), new OSLTextureHandle(OSLTextureHandle::AO));
   services->textures.insert(ustring("@bevel"), new OSLTextureHandle(OSLTextureHandle::BEVEL));
@@ -291,6 +303,11 @@ void OSLShaderManager::shading_system_free()
   ss_shared_users--;
 
   if (ss_shared_users == 0) {
+    {
+      thread_scoped_lock compiled_lock(ss_mutex);
+      compiled_shaders.clear();
+    }
+
     delete ss_shared;
     ss_shared = NULL;
 
@@ -354,6 +371,57 @@ OSLShaderInfo *OSLShaderManager::shader_loaded_info(const string &hash)
   return (it == loaded_shaders.end()) ? NULL : &it->second;
 }
 
+OSLCompiledShader *OSLShaderManager::compiled_shader_find(const string &key)
+{
+  map<string, OSLCompiledShader>::iterator it = compiled_shaders.find(key);
+  if (it == compiled_shaders.end()) {
+    return NULL;
+  }
+
+  it->second.last_used = compiled_shaders_update;
+  return &it->second;
+}
+
+void OSLShaderManager::compiled_shader_add(const string &key, const OSLCompiledShader &compiled)
+{
+  OSLCompiledShader &entry = compiled_shaders[key];
+  entry = compiled;
+  entry.last_used = compiled_shaders_update;
+}
+
+void OSLShaderManager::compiled_shaders_trim()
+{
+  if (compiled_shaders.size() > OSL_COMPILED_SHADERS_MAX) {
+    /* Free the least recently used groups, the ones still used by shaders stay
+     * alive through their references anyway. */
+    vector<uint64_t> last_used;
+    last_used.reserve(compiled_shaders.size());
+    for (map<string, OSLCompiledShader>::iterator it = compiled_shaders.begin();
+         it != compiled_shaders.end();
+         it++) {
+      last_used.push_back(it->second.last_used);
+    }
+
+    const size_t num_remove = compiled_shaders.size() - OSL_COMPILED_SHADERS_MAX;
+    std::nth_element(last_used.begin(), last_used.begin() + num_remove - 1, last_used.end());
+    const uint64_t remove_before = last_used[num_remove - 1];
+
+    size_t num_removed = 0;
+    for (map<string, OSLCompiledShader>::iterator it = compiled_shaders.begin();
+         it != compiled_shaders.end() && num_removed < num_remove;) {
+      if (it->second.last_used <= remove_before) {
+        compiled_shaders.erase(it++);
+        num_removed++;
+      }
+      else {
+        it++;
+      }
+    }
+  }
+
+  compiled_shaders_update++;
+}
+
 const char *OSLShaderManager::shader_load_filepath(string filepath)
 {
   size_t len = filepath.size();
@@ -578,6 +646,7 @@ OSLCompiler::OSLCompiler(OSLShaderManager *manager,
 {
   current_type = SHADER_TYPE_SURFACE;
   current_shader = NULL;
+  use_svm_textures = false;
   background = false;
 }
 
@@ -1110,6 +1179,48 @@ OSL::ShaderGroupRef OSLCompiler::compile_type(Shader *shader, ShaderGraph *graph
   return group;
 }
 
+static OSLCompiledShader compiled_shader_from(const Shader *shader)
+{
+  OSLCompiledShader compiled;
+  compiled.surface_ref = shader->osl_surface_ref;
+  compiled.surface_bump_ref = shader->osl_surface_bump_ref;
+  compiled.volume_ref = shader->osl_volume_ref;
+  compiled.displacement_ref = shader->osl_displacement_ref;
+  compiled.has_surface = shader->has_surface;
+  compiled.has_surface_emission = shader->has_surface_emission;
+  compiled.has_surface_transparent = shader->has_surface_transparent;
+  compiled.has_surface_bssrdf = shader->has_surface_bssrdf;
+  compiled.has_bump = shader->has_bump;
+  compiled.has_bssrdf_bump = shader->has_bssrdf_bump;
+  compiled.has_volume = shader->has_volume;
+  compiled.has_displacement = shader->has_displacement;
+  compiled.has_surface_spatial_varying = shader->has_surface_spatial_varying;
+  compiled.has_volume_spatial_varying = shader->has_volume_spatial_varying;
+  compiled.has_volume_attribute_dependency = shader->has_volume_attribute_dependency;
+  compiled.has_integrator_dependency = shader->has_integrator_dependency;
+  return compiled;
+}
+
+static void compiled_shader_apply(Shader *shader, const OSLCompiledShader &compiled)
+{
+  shader->osl_surface_ref = compiled.surface_ref;
+  shader->osl_surface_bump_ref = compiled.surface_bump_ref;
+  shader->osl_volume_ref = compiled.volume_ref;
+  shader->osl_displacement_ref = compiled.displacement_ref;
+  shader->has_surface = compiled.has_surface;
+  shader->has_surface_emission = compiled.has_surface_emission;
+  shader->has_surface_transparent = compiled.has_surface_transparent;
+  shader->has_surface_bssrdf = compiled.has_surface_bssrdf;
+  shader->has_bump = compiled.has_bump;
+  shader->has_bssrdf_bump = compiled.has_bssrdf_bump;
+  shader->has_volume = compiled.has_volume;
+  shader->has_displacement = compiled.has_displacement;
+  shader->has_surface_spatial_varying = compiled.has_surface_spatial_varying;
+  shader->has_volume_spatial_varying = compiled.has_volume_spatial_varying;
+  shader->has_volume_attribute_dependency = compiled.has_volume_attribute_dependency;
+  shader->has_integrator_dependency = compiled.has_integrator_dependency;
+}
+
 void OSLCompiler::compile(OSLGlobals *og, Shader *shader)
 {
   if (shader->need_update) {
@@ -1127,50 +1238,26 @@ void OSLCompiler::compile(OSLGlobals *og, Shader *shader)
 
     current_shader = shader;
 
-    shader->has_surface = false;
-    shader->has_surface_emission = false;
-    shader->has_surface_transparent = false;
-    shader->has_surface_bssrdf = false;
-    shader->has_bump = has_bump;
-    shader->has_bssrdf_bump = has_bump;
-    shader->has_volume = false;
-    shader->has_displacement = false;
-    shader->has_surface_spatial_varying = false;
-    shader->has_volume_spatial_varying = false;
-    shader->has_volume_attribute_dependency = false;
-    shader->has_integrator_dependency = false;
-
-    /* generate surface shader */
-    if (shader->used && graph && output->input("Surface")->link) {
-      shader->osl_surface_ref = compile_type(shader, shader->graph, SHADER_TYPE_SURFACE);
-
-      if (has_bump)
-        shader->osl_surface_bump_ref = compile_type(shader, shader->graph, SHADER_TYPE_BUMP);
-      else
-        shader->osl_surface_bump_ref = OSL::ShaderGroupRef();
-
-      shader->has_surface = true;
+    /* Reuse the groups of an identical graph compiled before, by this or an
+     * earlier render sharing the shading system. */
+    const string key = string_printf("%d %d %d %d ",
+                                     (int)background,
+                                     (int)has_bump,
+                                     (int)shader->used,
+                                     (int)shader->displacement_method) +
+                       graph->compute_hash();
+    OSLCompiledShader *compiled = manager->compiled_shader_find(key);
+    if (compiled) {
+      compiled_shader_apply(shader, *compiled);
     }
     else {
-      shader->osl_surface_ref = OSL::ShaderGroupRef();
-      shader->osl_surface_bump_ref = OSL::ShaderGroupRef();
-    }
+      use_svm_textures = false;
+      compile_groups(shader, has_bump);
 
-    /* generate volume shader */
-    if (shader->used && graph && output->input("Volume")->link) {
-      shader->osl_volume_ref = compile_type(shader, shader->graph, SHADER_TYPE_VOLUME);
-      shader->has_volume = true;
-    }
-    else
-      shader->osl_volume_ref = OSL::ShaderGroupRef();
-
-    /* generate displacement shader */
-    if (shader->used && graph && output->input("Displacement")->link) {
-      shader->osl_displacement_ref = compile_type(shader, shader->graph, SHADER_TYPE_DISPLACEMENT);
-      shader->has_displacement = true;
+      if (!use_svm_textures) {
+        manager->compiled_shader_add(key, compiled_shader_from(shader));
+      }
     }
-    else
-      shader->osl_displacement_ref = OSL::ShaderGroupRef();
   }
 
   /* push state to array for lookup */
@@ -1180,6 +1267,57 @@ void OSLCompiler::compile(OSLGlobals *og, Shader *shader)
   og->bump_state.push_back(shader->osl_surface_bump_ref);
 }
 
+void OSLCompiler::compile_groups(Shader *shader, bool has_bump)
+{
+  ShaderGraph *graph = shader->graph;
+  ShaderNode *output = graph->output();
+
+  shader->has_surface = false;
+  shader->has_surface_emission = false;
+  shader->has_surface_transparent = false;
+  shader->has_surface_bssrdf = false;
+  shader->has_bump = has_bump;
+  shader->has_bssrdf_bump = has_bump;
+  shader->has_volume = false;
+  shader->has_displacement = false;
+  shader->has_surface_spatial_varying = false;
+  shader->has_volume_spatial_varying = false;
+  shader->has_volume_attribute_dependency = false;
+  shader->has_integrator_dependency = false;
+
+  /* generate surface shader */
+  if (shader->used && graph && output->input("Surface")->link) {
+    shader->osl_surface_ref = compile_type(shader, shader->graph, SHADER_TYPE_SURFACE);
+
+    if (has_bump)
+      shader->osl_surface_bump_ref = compile_type(shader, shader->graph, SHADER_TYPE_BUMP);
+    else
+      shader->osl_surface_bump_ref = OSL::ShaderGroupRef();
+
+    shader->has_surface = true;
+  }
+  else {
+    shader->osl_surface_ref = OSL::ShaderGroupRef();
+    shader->osl_surface_bump_ref = OSL::ShaderGroupRef();
+  }
+
+  /* generate volume shader */
+  if (shader->used && graph && output->input("Volume")->link) {
+    shader->osl_volume_ref = compile_type(shader, shader->graph, SHADER_TYPE_VOLUME);
+    shader->has_volume = true;
+  }
+  else
+    shader->osl_volume_ref = OSL::ShaderGroupRef();
+
+  /* generate displacement shader */
+  if (shader->used && graph && output->input("Displacement")->link) {
+    shader->osl_displacement_ref = compile_type(shader, shader->graph, SHADER_TYPE_DISPLACEMENT);
+    shader->has_displacement = true;
+  }
+  else
+    shader->osl_displacement_ref = OSL::ShaderGroupRef();
+}
+
 void OSLCompiler::parameter_texture(const char *name, ustring filename, ustring colorspace)
 {
   /* Textured loaded through the OpenImageIO texture cache. For this
@@ -1198,6 +1336,7 @@ void OSLCompiler::parameter_texture(const char *name, int svm_slot)
    * render sessions as the render services are shared. */
   ustring filename(string_printf("@svm%d", texture_shared_unique_id++).c_str());
   services->textures.insert(filename, new OSLTextureHandle(OSLTextureHandle::SVM, svm_slot));
+  use_svm_textures = true;
   parameter(name, filename);
 }
 
@@ -1206,6 +1345,7 @@ void OSLCompiler::parameter_texture_ies(const char *name, int svm_slot)
   /* IES light textures stored in SVM. */
   ustring filename(string_printf("@svm%d", texture_shared_unique_id++).c_str());
   services->textures.insert(filename, new OSLTextureHandle(OSLTextureHandle::IES, svm_slot));
+  use_svm_textures = true;
   parameter(name, filename);
 }
 
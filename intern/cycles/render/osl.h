@@ -18,6 +18,7 @@
 #define __OSL_H__
 
 #include "util/util_array.h"
+#include "util/util_map.h"
 #include "util/util_set.h"
 #include "util/util_string.h"
 #include "util/util_thread.h"
@@ -63,6 +64,38 @@ struct OSLShaderInfo {
   bool has_surface_bssrdf;
 };
 
+/* OSL Compiled Shader
+ * shader groups compiled for a shader graph, along with the flags detected while
+ * compiling them, so identical graphs can reuse them without being compiled and
+ * optimized again */
+
+struct OSLCompiledShader {
+  OSLCompiledShader() : last_used(0)
+  {
+  }
+
+  OSL::ShaderGroupRef surface_ref;
+  OSL::ShaderGroupRef surface_bump_ref;
+  OSL::ShaderGroupRef volume_ref;
+  OSL::ShaderGroupRef displacement_ref;
+
+  bool has_surface;
+  bool has_surface_emission;
+  bool has_surface_transparent;
+  bool has_surface_bssrdf;
+  bool has_bump;
+  bool has_bssrdf_bump;
+  bool has_volume;
+  bool has_displacement;
+  bool has_surface_spatial_varying;
+  bool has_volume_spatial_varying;
+  bool has_volume_attribute_dependency;
+  bool has_integrator_dependency;
+
+  /* Number of the last shading system update the groups were used in. */
+  uint64_t last_used;
+};
+
 /* Shader Manage */
 
 class OSLShaderManager : public ShaderManager {
@@ -92,6 +125,10 @@ class OSLShaderManager : public ShaderManager {
   const char *shader_load_filepath(string filepath);
   OSLShaderInfo *shader_loaded_info(const string &hash);
 
+  /* compiled shader groups, shared between renders along with the shading system */
+  OSLCompiledShader *compiled_shader_find(const string &key);
+  void compiled_shader_add(const string &key, const OSLCompiledShader &compiled);
+
   /* create OSL node using OSLQuery */
   static OSLNode *osl_node(ShaderManager *manager,
                            const std::string &filepath,
@@ -105,6 +142,8 @@ class OSLShaderManager : public ShaderManager {
   void shading_system_init();
   void shading_system_free();
 
+  void compiled_shaders_trim();
+
   OSL::ShadingSystem *ss;
   OSL::TextureSystem *ts;
   OSLRenderServices *services;
@@ -120,6 +159,10 @@ class OSLShaderManager : public ShaderManager {
   static thread_mutex ss_shared_mutex;
   static thread_mutex ss_mutex;
   static int ss_shared_users;
+
+  /* Keyed by the shader graph hash and compiler settings, protected by ss_mutex. */
+  static map<string, OSLCompiledShader> compiled_shaders;
+  static uint64_t compiled_shaders_update;
 };
 
 #endif
@@ -171,6 +214,7 @@ class OSLCompiler {
 #ifdef WITH_OSL
   string id(ShaderNode *node);
   OSL::ShaderGroupRef compile_type(Shader *shader, ShaderGraph *graph, ShaderType type);
+  void compile_groups(Shader *shader, bool has_bump);
   bool node_skip_input(ShaderNode *node, ShaderInput *input);
   string compatible_name(ShaderNode *node, ShaderInput *input);
   string compatible_name(ShaderNode *node, ShaderOutput *output);
@@ -185,6 +229,8 @@ class OSLCompiler {
 
   ShaderType current_type;
   Shader *current_shader;
+  /* Groups referencing textures by SVM slot are only valid for the current scene. */
+  bool use_svm_textures;
 
   static int texture_shared_unique_id;
 };
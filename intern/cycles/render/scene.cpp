@@ -74,6 +74,11 @@ DeviceScene::DeviceScene(Device *device)
       lights(device, "__lights", MEM_GLOBAL),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_GLOBAL),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_GLOBAL),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_GLOBAL),
+      light_tree_emitters(device, "__light_tree_emitters", MEM_GLOBAL),
+      light_tree_lamp_emitters(device, "__light_tree_lamp_emitters", MEM_GLOBAL),
+      light_tree_object_offsets(device, "__light_tree_object_offsets", MEM_GLOBAL),
+      light_tree_triangle_emitters(device, "__light_tree_triangle_emitters", MEM_GLOBAL),
       particles(device, "__particles", MEM_GLOBAL),
       svm_nodes(device, "__svm_nodes", MEM_GLOBAL),
       shaders(device, "__shaders", MEM_GLOBAL),
@@ -107,6 +112,7 @@ Scene::Scene(const SceneParams &params_, Device *device)
   object_manager = new ObjectManager();
   integrator = new Integrator();
   image_manager = new ImageManager(device->info);
+  image_manager->set_use_half_float_images(params.use_half_float_images);
   particle_system_manager = new ParticleSystemManager();
   bake_manager = new BakeManager();
 
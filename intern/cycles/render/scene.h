@@ -108,6 +108,11 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
+  device_vector<uint> light_tree_lamp_emitters;
+  device_vector<uint> light_tree_object_offsets;
+  device_vector<uint> light_tree_triangle_emitters;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -172,6 +177,9 @@ class SceneParams {
   CurveShapeType hair_shape;
   bool persistent_data;
   int texture_limit;
+  /* Maximum memory used by image textures in bytes, 0 for no limit. */
+  size_t texture_memory_limit;
+  bool use_half_float_images;
 
   bool background;
 
@@ -187,6 +195,8 @@ class SceneParams {
     hair_shape = CURVE_RIBBON;
     persistent_data = false;
     texture_limit = 0;
+    texture_memory_limit = 0;
+    use_half_float_images = false;
     background = true;
   }
 
@@ -198,7 +208,9 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data && texture_limit == params.texture_limit &&
+             texture_memory_limit == params.texture_memory_limit &&
+             use_half_float_images == params.use_half_float_images);
   }
 
   int curve_subdivisions()
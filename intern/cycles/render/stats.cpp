@@ -87,6 +87,20 @@ string NamedSizeStats::full_report(int indent_level)
   return result;
 }
 
+string NamedSizeStats::json_report()
+{
+  string result = string_printf("{\"total_size\": %zu, \"entries\": [", total_size);
+  sort(entries.begin(), entries.end(), namedSizeEntryComparator);
+  for (size_t i = 0; i < entries.size(); i++) {
+    result += string_printf("%s{\"name\": %s, \"size\": %zu}",
+                            (i == 0) ? "" : ", ",
+                            string_json_quote(entries[i].name).c_str(),
+                            entries[i].size);
+  }
+  result += "]}";
+  return result;
+}
+
 /* Named time sample statistics. */
 
 NamedNestedSampleStats::NamedNestedSampleStats() : name(""), self_samples(0), sum_samples(0)
@@ -142,6 +156,24 @@ string NamedNestedSampleStats::full_report(int indent_level, uint64_t total_samp
   return result;
 }
 
+string NamedNestedSampleStats::json_report()
+{
+  update_sum();
+
+  string result = string_printf(
+      "{\"name\": %s, \"time\": %.3f, \"self_time\": %.3f, \"entries\": [",
+      string_json_quote(name).c_str(),
+      sum_samples * 0.001,
+      self_samples * 0.001);
+
+  sort(entries.begin(), entries.end(), namedTimeSampleEntryComparator);
+  for (size_t i = 0; i < entries.size(); i++) {
+    result += ((i == 0) ? "" : ", ") + entries[i].json_report();
+  }
+  result += "]}";
+  return result;
+}
+
 /* Named sample count pairs. */
 
 NamedSampleCountPair::NamedSampleCountPair(const ustring &name, uint64_t samples, uint64_t hits)
@@ -164,12 +196,10 @@ void NamedSampleCountStats::add(const ustring &name, uint64_t samples, uint64_t
   entries.emplace(name, NamedSampleCountPair(name, samples, hits));
 }
 
-string NamedSampleCountStats::full_report(int indent_level)
+vector<NamedSampleCountPair> NamedSampleCountStats::sorted_entries(double *avg_samples_per_hit)
 {
-  const string indent(indent_level * kIndentNumSpaces, ' ');
-
-  vector<NamedSampleCountPair> sorted_entries;
-  sorted_entries.reserve(entries.size());
+  vector<NamedSampleCountPair> result;
+  result.reserve(entries.size());
 
   uint64_t total_hits = 0, total_samples = 0;
   foreach (entry_map::const_reference entry, entries) {
@@ -178,14 +208,23 @@ string NamedSampleCountStats::full_report(int indent_level)
     total_hits += pair.hits;
     total_samples += pair.samples;
 
-    sorted_entries.push_back(pair);
+    result.push_back(pair);
   }
-  const double avg_samples_per_hit = ((double)total_samples) / total_hits;
+  *avg_samples_per_hit = ((double)total_samples) / total_hits;
+
+  sort(result.begin(), result.end(), namedSampleCountPairComparator);
+  return result;
+}
 
-  sort(sorted_entries.begin(), sorted_entries.end(), namedSampleCountPairComparator);
+string NamedSampleCountStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+
+  double avg_samples_per_hit;
+  vector<NamedSampleCountPair> sorted = sorted_entries(&avg_samples_per_hit);
 
   string result = "";
-  foreach (const NamedSampleCountPair &entry, sorted_entries) {
+  foreach (const NamedSampleCountPair &entry, sorted) {
     const double seconds = entry.samples * 0.001;
     const double relative = ((double)entry.samples) / (entry.hits * avg_samples_per_hit);
 
@@ -196,6 +235,31 @@ string NamedSampleCountStats::full_report(int indent_level)
   return result;
 }
 
+string NamedSampleCountStats::json_report()
+{
+  double avg_samples_per_hit;
+  vector<NamedSampleCountPair> sorted = sorted_entries(&avg_samples_per_hit);
+
+  string result = "[";
+  for (size_t i = 0; i < sorted.size(); i++) {
+    const NamedSampleCountPair &entry = sorted[i];
+    /* JSON has no infinity or NaN, report entries which were never hit with zero cost. */
+    const double relative = (entry.hits != 0 && avg_samples_per_hit > 0.0) ?
+                                ((double)entry.samples) / (entry.hits * avg_samples_per_hit) :
+                                0.0;
+
+    result += string_printf("%s{\"name\": %s, \"time\": %.3f, \"hits\": %llu, "
+                            "\"relative_cost\": %.3f}",
+                            (i == 0) ? "" : ", ",
+                            string_json_quote(entry.name.string()).c_str(),
+                            entry.samples * 0.001,
+                            (unsigned long long)entry.hits,
+                            relative);
+  }
+  result += "]";
+  return result;
+}
+
 /* Mesh statistics. */
 
 MeshStats::MeshStats()
@@ -210,6 +274,11 @@ string MeshStats::full_report(int indent_level)
   return result;
 }
 
+string MeshStats::json_report()
+{
+  return "{\"geometry\": " + geometry.json_report() + "}";
+}
+
 /* Image statistics. */
 
 ImageStats::ImageStats()
@@ -224,6 +293,11 @@ string ImageStats::full_report(int indent_level)
   return result;
 }
 
+string ImageStats::json_report()
+{
+  return "{\"textures\": " + textures.json_report() + "}";
+}
+
 /* Overall statistics. */
 
 RenderStats::RenderStats()
@@ -317,4 +391,18 @@ string RenderStats::full_report()
   return result;
 }
 
+string RenderStats::json_report()
+{
+  string result = "{";
+  result += "\"mesh\": " + mesh.json_report();
+  result += ", \"image\": " + image.json_report();
+  if (has_profiling) {
+    result += ", \"kernel\": " + kernel.json_report();
+    result += ", \"shaders\": " + shaders.json_report();
+    result += ", \"objects\": " + objects.json_report();
+  }
+  result += "}";
+  return result;
+}
+
 CCL_NAMESPACE_END
@@ -55,6 +55,9 @@ class NamedSizeStats {
   /* Generate full human-readable report. */
   string full_report(int indent_level = 0);
 
+  /* Generate report as a JSON object. */
+  string json_report();
+
   /* Total size of all entries. */
   size_t total_size;
 
@@ -75,6 +78,7 @@ class NamedNestedSampleStats {
   void update_sum();
 
   string full_report(int indent_level = 0, uint64_t total_samples = 0);
+  string json_report();
 
   string name;
 
@@ -103,10 +107,15 @@ class NamedSampleCountStats {
   NamedSampleCountStats();
 
   string full_report(int indent_level = 0);
+  string json_report();
   void add(const ustring &name, uint64_t samples, uint64_t hits);
 
   typedef unordered_map<ustring, NamedSampleCountPair, ustringHash> entry_map;
   entry_map entries;
+
+ protected:
+  /* Entries sorted by decreasing time. */
+  vector<NamedSampleCountPair> sorted_entries(double *avg_samples_per_hit);
 };
 
 /* Statistics about mesh in the render database. */
@@ -117,6 +126,9 @@ class MeshStats {
   /* Generate full human-readable report. */
   string full_report(int indent_level = 0);
 
+  /* Generate report as a JSON object. */
+  string json_report();
+
   /* Input geometry statistics, this is what is coming as an input to render
    * from. say, Blender. This does not include runtime or engine specific
    * memory like BVH.
@@ -132,6 +144,9 @@ class ImageStats {
   /* Generate full human-readable report. */
   string full_report(int indent_level = 0);
 
+  /* Generate report as a JSON object. */
+  string json_report();
+
   NamedSizeStats textures;
 };
 
@@ -143,6 +158,10 @@ class RenderStats {
   /* Return full report as string. */
   string full_report();
 
+  /* Return the report as a JSON object, for tools which gather statistics of many renders.
+   * Times are in seconds, sizes in bytes. */
+  string json_report();
+
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
@@ -46,6 +46,34 @@ void SVMShaderManager::reset(Scene * /*scene*/)
 {
 }
 
+/* Finalize the graph of the shader and compute a hash identifying the nodes it compiles to. */
+void SVMShaderManager::device_update_shader_hash(Scene *scene,
+                                                 Shader *shader,
+                                                 Progress *progress,
+                                                 string *hash)
+{
+  if (progress->get_cancel()) {
+    return;
+  }
+  assert(shader->graph);
+
+  const bool background = (shader == scene->background->get_shader(scene));
+  const bool has_bump = SVMCompiler::shader_has_bump(shader);
+
+  shader->graph->finalize(scene,
+                          has_bump,
+                          shader->has_integrator_dependency,
+                          shader->displacement_method == DISPLACE_BOTH);
+
+  /* Settings of the shader used by the compiler. */
+  *hash = string_printf("%d %d %d %d ",
+                        (int)background,
+                        (int)has_bump,
+                        (int)shader->used,
+                        (int)shader->displacement_method) +
+          shader->graph->compute_hash();
+}
+
 void SVMShaderManager::device_update_shader(Scene *scene,
                                             Shader *shader,
                                             Progress *progress,
@@ -85,36 +113,91 @@ void SVMShaderManager::device_update(Device *device,
   /* test if we need to update */
   device_free(device, dscene, scene);
 
-  /* Build all shaders. */
-  TaskPool task_pool;
-  vector<array<int4>> shader_svm_nodes(num_shaders);
+  /* Finalize all graphs, to find shaders that compile to the same nodes. */
+  vector<string> shader_hashes(num_shaders);
+  {
+    TaskPool task_pool;
+    for (int i = 0; i < num_shaders; i++) {
+      task_pool.push(function_bind(&SVMShaderManager::device_update_shader_hash,
+                                   this,
+                                   scene,
+                                   scene->shaders[i],
+                                   &progress,
+                                   &shader_hashes[i]));
+    }
+    task_pool.wait_work();
+  }
+
+  if (progress.get_cancel()) {
+    return;
+  }
+
+  /* Shaders with the same hash share the nodes of the first one of them. */
+  vector<int> shader_compiled_index(num_shaders);
+  map<string, int> compiled_index_by_hash;
+  int num_deduplicated = 0;
   for (int i = 0; i < num_shaders; i++) {
-    task_pool.push(function_bind(&SVMShaderManager::device_update_shader,
-                                 this,
-                                 scene,
-                                 scene->shaders[i],
-                                 &progress,
-                                 &shader_svm_nodes[i]));
+    map<string, int>::iterator it = compiled_index_by_hash.find(shader_hashes[i]);
+    if (it != compiled_index_by_hash.end()) {
+      shader_compiled_index[i] = it->second;
+      num_deduplicated++;
+    }
+    else {
+      shader_compiled_index[i] = i;
+      compiled_index_by_hash[shader_hashes[i]] = i;
+    }
+  }
+
+  VLOG(1) << "Compiling " << num_shaders - num_deduplicated << " unique shaders, "
+          << num_deduplicated << " shaders deduplicated.";
+
+  /* Build all unique shaders. */
+  vector<array<int4>> shader_svm_nodes(num_shaders);
+  {
+    TaskPool task_pool;
+    for (int i = 0; i < num_shaders; i++) {
+      if (shader_compiled_index[i] == i) {
+        task_pool.push(function_bind(&SVMShaderManager::device_update_shader,
+                                     this,
+                                     scene,
+                                     scene->shaders[i],
+                                     &progress,
+                                     &shader_svm_nodes[i]));
+      }
+    }
+    task_pool.wait_work();
   }
-  task_pool.wait_work();
 
   if (progress.get_cancel()) {
     return;
   }
 
   /* The global node list contains a jump table (one node per shader)
-   * followed by the nodes of all shaders. */
+   * followed by the nodes of all unique shaders. */
   int svm_nodes_size = num_shaders;
   for (int i = 0; i < num_shaders; i++) {
     /* Since we're not copying the local jump node, the size ends up being one node lower. */
-    svm_nodes_size += shader_svm_nodes[i].size() - 1;
+    if (shader_compiled_index[i] == i) {
+      svm_nodes_size += shader_svm_nodes[i].size() - 1;
+    }
   }
 
   int4 *svm_nodes = dscene->svm_nodes.alloc(svm_nodes_size);
 
   int node_offset = num_shaders;
+  vector<int> shader_node_offset(num_shaders);
   for (int i = 0; i < num_shaders; i++) {
     Shader *shader = scene->shaders[i];
+    const int compiled_index = shader_compiled_index[i];
+
+    if (compiled_index == i) {
+      shader_node_offset[i] = node_offset;
+      node_offset += shader_svm_nodes[i].size() - 1;
+    }
+    else {
+      /* Compilation results stored in the shader are the same as well. */
+      SVMCompiler::copy_compiled_flags(shader, scene->shaders[compiled_index]);
+    }
 
     shader->need_update = false;
     if (shader->use_mis && shader->has_surface_emission) {
@@ -125,19 +208,22 @@ void SVMShaderManager::device_update(Device *device,
      * Each compiled shader starts with a jump node that has offsets local
      * to the shader, so copy those and add the offset into the global node list. */
     int4 &global_jump_node = svm_nodes[shader->id];
-    int4 &local_jump_node = shader_svm_nodes[i][0];
+    int4 &local_jump_node = shader_svm_nodes[compiled_index][0];
+    const int offset = shader_node_offset[compiled_index];
 
     global_jump_node.x = NODE_SHADER_JUMP;
-    global_jump_node.y = local_jump_node.y - 1 + node_offset;
-    global_jump_node.z = local_jump_node.z - 1 + node_offset;
-    global_jump_node.w = local_jump_node.w - 1 + node_offset;
-
-    node_offset += shader_svm_nodes[i].size() - 1;
+    global_jump_node.y = local_jump_node.y - 1 + offset;
+    global_jump_node.z = local_jump_node.z - 1 + offset;
+    global_jump_node.w = local_jump_node.w - 1 + offset;
   }
 
-  /* Copy the nodes of each shader into the correct location. */
+  /* Copy the nodes of each unique shader into the correct location. */
   svm_nodes += num_shaders;
   for (int i = 0; i < num_shaders; i++) {
+    if (shader_compiled_index[i] != i) {
+      continue;
+    }
+
     int shader_size = shader_svm_nodes[i].size() - 1;
 
     memcpy(svm_nodes, &shader_svm_nodes[i][1], sizeof(int4) * shader_size);
@@ -825,16 +911,36 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   }
 }
 
-void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary)
+bool SVMCompiler::shader_has_bump(Shader *shader)
 {
-  /* copy graph for shader with bump mapping */
   ShaderNode *output = shader->graph->output();
+  return (shader->displacement_method != DISPLACE_TRUE) && output->input("Surface")->link &&
+         output->input("Displacement")->link;
+}
+
+void SVMCompiler::copy_compiled_flags(Shader *shader, const Shader *compiled_shader)
+{
+  shader->has_surface = compiled_shader->has_surface;
+  shader->has_surface_emission = compiled_shader->has_surface_emission;
+  shader->has_surface_transparent = compiled_shader->has_surface_transparent;
+  shader->has_surface_bssrdf = compiled_shader->has_surface_bssrdf;
+  shader->has_bump = compiled_shader->has_bump;
+  shader->has_bssrdf_bump = compiled_shader->has_bssrdf_bump;
+  shader->has_volume = compiled_shader->has_volume;
+  shader->has_displacement = compiled_shader->has_displacement;
+  shader->has_surface_spatial_varying = compiled_shader->has_surface_spatial_varying;
+  shader->has_volume_spatial_varying = compiled_shader->has_volume_spatial_varying;
+  shader->has_volume_attribute_dependency = compiled_shader->has_volume_attribute_dependency;
+  shader->has_integrator_dependency = compiled_shader->has_integrator_dependency;
+}
+
+void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary)
+{
   int start_num_svm_nodes = svm_nodes.size();
 
   const double time_start = time_dt();
 
-  bool has_bump = (shader->displacement_method != DISPLACE_TRUE) &&
-                  output->input("Surface")->link && output->input("Displacement")->link;
+  bool has_bump = shader_has_bump(shader);
 
   /* finalize */
   {
@@ -50,6 +50,10 @@ class SVMShaderManager : public ShaderManager {
   void device_free(Device *device, DeviceScene *dscene, Scene *scene);
 
  protected:
+  void device_update_shader_hash(Scene *scene,
+                                 Shader *shader,
+                                 Progress *progress,
+                                 string *hash);
   void device_update_shader(Scene *scene,
                             Shader *shader,
                             Progress *progress,
@@ -96,6 +100,11 @@ class SVMCompiler {
   SVMCompiler(Scene *scene);
   void compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary = NULL);
 
+  /* Whether a bump shader is generated for the shader. */
+  static bool shader_has_bump(Shader *shader);
+  /* Copy the flags set on a shader by compilation from a shader with an identical graph. */
+  static void copy_compiled_flags(Shader *shader, const Shader *compiled_shader);
+
   int stack_assign(ShaderOutput *output);
   int stack_assign(ShaderInput *input);
   int stack_assign_if_linked(ShaderInput *input);
@@ -158,6 +158,7 @@ void TileManager::reset(BufferParams &params_, int num_samples_)
   state.resolution_divider = get_divider(params.width, params.height, start_resolution);
   state.render_tiles.clear();
   state.denoising_tiles.clear();
+  state.num_rendering_tiles = 0;
   device_free();
 }
 
@@ -211,6 +212,7 @@ int TileManager::gen_tiles(bool sliced)
   state.denoising_tiles.clear();
   state.render_tiles.resize(num);
   state.denoising_tiles.resize(num);
+  state.num_rendering_tiles = 0;
   state.tile_stride = tile_w;
   vector<list<int>>::iterator tile_list;
   tile_list = state.render_tiles.begin();
@@ -382,6 +384,10 @@ void TileManager::set_tiles()
 
   state.num_tiles = gen_tiles(!background);
 
+  if (can_split_tiles()) {
+    state.tiles.reserve(state.tiles.size() + MAX_SPLIT_TILES);
+  }
+
   state.buffer.width = image_w;
   state.buffer.height = image_h;
 
@@ -447,6 +453,9 @@ bool TileManager::finish_tile(const int index, const bool need_denoise, bool &de
 
   switch (state.tiles[index].state) {
     case Tile::RENDER: {
+      if (state.num_rendering_tiles > 0) {
+        state.num_rendering_tiles--;
+      }
       if (!(schedule_denoising && need_denoise)) {
         state.tiles[index].state = Tile::DONE;
         delete_tile = !progressive;
@@ -528,6 +537,10 @@ bool TileManager::next_tile(Tile *&tile, int device, uint tile_types)
   }
 
   if (tile_types & RenderTile::PATH_TRACE) {
+    if (can_split_tiles()) {
+      split_render_tiles();
+    }
+
     int tile_index = -1;
     int logical_device = preserve_device ? device : 0;
 
@@ -548,6 +561,7 @@ bool TileManager::next_tile(Tile *&tile, int device, uint tile_types)
     }
 
     if (tile_index >= 0) {
+      state.num_rendering_tiles++;
       tile = &state.tiles[tile_index];
       return true;
     }
@@ -556,6 +570,79 @@ bool TileManager::next_tile(Tile *&tile, int device, uint tile_types)
   return false;
 }
 
+/* Tiles can only be split when they are not tied to a device and nothing depends on the regular
+ * tile grid, which is the case for final renders without denoising during rendering. */
+bool TileManager::can_split_tiles()
+{
+  return background && !progressive && !preserve_tile_device && !schedule_denoising &&
+         slice_overlap == 0;
+}
+
+/* All devices and CPU threads acquire their tiles from the same queue, so a device which is done
+ * with its tile takes the next one no matter which device it was generated for. Near the end of
+ * the render however there are fewer tiles left than workers, and devices which finish early
+ * (because they are faster or because adaptive sampling stopped their tiles early) are left idle
+ * while the last tiles are being rendered.
+ *
+ * To avoid that, as soon as the queue holds fewer tiles than there are workers asking for them,
+ * the largest remaining tiles are split in two so that the remaining work is shared between all
+ * of them. Tiles which are already being rendered are not affected. */
+void TileManager::split_render_tiles()
+{
+  int num_queued_tiles = 0;
+  foreach (const list<int> &tile_list, state.render_tiles) {
+    num_queued_tiles += tile_list.size();
+  }
+
+  /* Workers currently rendering will ask for a new tile soon, as will the one asking now. */
+  const int num_workers = state.num_rendering_tiles + 1;
+
+  while (num_queued_tiles > 0 && num_queued_tiles < num_workers &&
+         state.tiles.size() < state.tiles.capacity()) {
+    /* Find the largest queued tile. */
+    list<int> *largest_list = NULL;
+    list<int>::iterator largest_it;
+    int largest_size = 0;
+    foreach (list<int> &tile_list, state.render_tiles) {
+      for (list<int>::iterator it = tile_list.begin(); it != tile_list.end(); ++it) {
+        const Tile &tile = state.tiles[*it];
+        if (tile.w * tile.h > largest_size) {
+          largest_list = &tile_list;
+          largest_it = it;
+          largest_size = tile.w * tile.h;
+        }
+      }
+    }
+
+    Tile &tile = state.tiles[*largest_it];
+    if (max(tile.w, tile.h) < 2 * MIN_SPLIT_TILE_SIZE) {
+      break;
+    }
+
+    /* Split along the longer side, the new tile is queued right after the original one. */
+    const int index = state.tiles.size();
+    Tile split_tile = tile;
+    split_tile.index = index;
+    if (tile.w >= tile.h) {
+      split_tile.w = tile.w / 2;
+      split_tile.x = tile.x + tile.w - split_tile.w;
+      tile.w -= split_tile.w;
+    }
+    else {
+      split_tile.h = tile.h / 2;
+      split_tile.y = tile.y + tile.h - split_tile.h;
+      tile.h -= split_tile.h;
+    }
+
+    /* Capacity was reserved, so this does not invalidate pointers to other tiles. */
+    state.tiles.push_back(split_tile);
+    largest_list->insert(++largest_it, index);
+
+    state.num_tiles++;
+    num_queued_tiles++;
+  }
+}
+
 bool TileManager::done()
 {
   int end_sample = (range_num_samples == -1) ? num_samples :
@@ -86,6 +86,9 @@ class TileManager {
      * Each list in each vector is for one logical device. */
     vector<list<int>> render_tiles;
     vector<list<int>> denoising_tiles;
+
+    /* Number of tiles handed out for path tracing that are not finished yet. */
+    int num_rendering_tiles;
   } state;
 
   int num_samples;
@@ -165,6 +168,17 @@ class TileManager {
   /* Generate tile list, return number of tiles. */
   int gen_tiles(bool sliced);
   void gen_render_tiles();
+
+  /* ** Tile splitting. ** */
+
+  /* Tiles are not split any further when both halves would be smaller than this. */
+  static const int MIN_SPLIT_TILE_SIZE = 16;
+  /* Maximum number of tiles which can be added by splitting, room for them is reserved up front
+   * so that pointers to tiles which are being rendered remain valid. */
+  static const int MAX_SPLIT_TILES = 1024;
+
+  bool can_split_tiles();
+  void split_render_tiles();
 };
 
 CCL_NAMESPACE_END
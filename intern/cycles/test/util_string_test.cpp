@@ -281,4 +281,24 @@ TEST(util_string_remove_trademark, r_space_middle)
   EXPECT_EQ(str, "foo bar baz");
 }
 
+/* ******** Tests for string_json_quote() ******** */
+
+TEST(util_string_json_quote, plain)
+{
+  string str = string_json_quote("foo bar");
+  EXPECT_EQ(str, "\"foo bar\"");
+}
+
+TEST(util_string_json_quote, escape)
+{
+  string str = string_json_quote("a\"b\\c\nd");
+  EXPECT_EQ(str, "\"a\\\"b\\\\c\\nd\"");
+}
+
+TEST(util_string_json_quote, control)
+{
+  string str = string_json_quote("a\x01");
+  EXPECT_EQ(str, "\"a\\u0001\"");
+}
+
 CCL_NAMESPACE_END
@@ -172,6 +172,37 @@ string to_string(const char *str)
   return string(str);
 }
 
+string string_json_quote(const string &s)
+{
+  string result = "\"";
+  for (const char c : s) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          result += string_printf("\\u%04x", (int)c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  result += "\"";
+  return result;
+}
+
 /* Wide char strings helpers for Windows. */
 
 #ifdef _WIN32
@@ -105,6 +105,11 @@
 #  define FFMPEG_HAVE_CANON_H264_RESOLUTION_FIX
 #endif
 
+/* avcodec_get_hw_config() and hardware device contexts. */
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 18, 100)
+#  define FFMPEG_HW_DECODE_SUPPORT
+#endif
+
 #if ((LIBAVCODEC_VERSION_MAJOR > 53) || \
      (LIBAVCODEC_VERSION_MAJOR >= 53) && (LIBAVCODEC_VERSION_MINOR >= 60))
 #  define FFMPEG_HAVE_ENCODE_AUDIO2
@@ -218,6 +218,14 @@ void MEM_init_memleak_detection(void);
 /* Switch allocator to slower but fully guarded mode. */
 void MEM_use_guarded_allocator(void);
 
+/**
+ * Switch allocator to a counted allocator that keeps the counters per thread, to avoid contention
+ * when many threads allocate at once. With \a use_size_class_cache small blocks are reused
+ * through per-thread free lists. Like #MEM_use_guarded_allocator, this has to be called before
+ * any allocation happened.
+ */
+void MEM_use_threadcache_allocator(bool use_size_class_cache);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,679 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup MEM
+ *
+ * Memory allocation which keeps track on allocated memory counters, like the lock-free
+ * allocator, but without touching shared counters on every allocation.
+ *
+ * Each thread accumulates the changes to the counters locally, and merges them into the shared
+ * counters once they grew past #STATS_MERGE_THRESHOLD, or when the thread exits. Reading the
+ * counters sums up the shared counters and the local changes of all threads, so leak detection
+ * stays exact. The peak memory is only updated when merging, so it can be too low by up to
+ * #STATS_MERGE_THRESHOLD per thread.
+ *
+ * Optionally small blocks are not freed immediately, but kept in per-thread free lists, one for
+ * each size class, to be reused by the next allocations of the same size class in that thread.
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h> /* memcpy */
+#include <sys/types.h>
+
+#include "MEM_guardedalloc.h"
+
+/* to ensure strict conversions */
+#include "../../source/blender/blenlib/BLI_strict_flags.h"
+
+#include "mallocn_intern.h"
+
+#ifdef _MSC_VER
+#  define MEM_THREAD_LOCAL __declspec(thread)
+#else
+#  define MEM_THREAD_LOCAL __thread
+#endif
+
+/* Same layout as in the lock-free allocator, so blocks allocated before switching to this
+ * allocator can still be freed. */
+typedef struct MemHead {
+  /* Length of allocated memory block. */
+  size_t len;
+} MemHead;
+
+typedef struct MemHeadAligned {
+  short alignment;
+  size_t len;
+} MemHeadAligned;
+
+/* While a block is in a free list, its header stores the next free block. */
+typedef struct MemFree {
+  struct MemFree *next;
+} MemFree;
+
+enum {
+  MEMHEAD_ALIGN_FLAG = 1,
+  /* The block was allocated with the full length of its size class and can be reused. */
+  MEMHEAD_SIZE_CLASS_FLAG = 2,
+};
+
+#define MEMHEAD_FLAGS ((size_t)(MEMHEAD_ALIGN_FLAG | MEMHEAD_SIZE_CLASS_FLAG))
+
+#define MEMHEAD_FROM_PTR(ptr) (((MemHead *)ptr) - 1)
+#define PTR_FROM_MEMHEAD(memhead) (memhead + 1)
+#define MEMHEAD_ALIGNED_FROM_PTR(ptr) (((MemHeadAligned *)ptr) - 1)
+#define MEMHEAD_IS_ALIGNED(memhead) ((memhead)->len & (size_t)MEMHEAD_ALIGN_FLAG)
+#define MEMHEAD_HAS_SIZE_CLASS(memhead) ((memhead)->len & (size_t)MEMHEAD_SIZE_CLASS_FLAG)
+
+/* Size classes are multiples of 16 bytes, up to #SIZE_CLASS_MAX_LEN. */
+#define SIZE_CLASS_SHIFT 4
+#define SIZE_CLASS_MAX_LEN 512
+#define SIZE_CLASS_NUM ((SIZE_CLASS_MAX_LEN >> SIZE_CLASS_SHIFT) + 1)
+#define SIZE_CLASS_FROM_LEN(len) (((len) + ((1 << SIZE_CLASS_SHIFT) - 1)) >> SIZE_CLASS_SHIFT)
+#define SIZE_CLASS_LEN(size_class) ((size_t)(size_class) << SIZE_CLASS_SHIFT)
+/* Max number of blocks kept in each free list, so threads don't hold on to too much memory. */
+#define SIZE_CLASS_FREE_MAX 64
+
+/* Local changes to the counters are merged into the shared counters past this size (in bytes). */
+#define STATS_MERGE_THRESHOLD (256 * 1024)
+
+typedef struct ThreadData {
+  struct ThreadData *next, *prev;
+
+  /* Changes to the counters since the last merge, negative when the thread frees blocks
+   * allocated by other threads. */
+  ptrdiff_t mem_in_use;
+  int totblock;
+
+  MemFree *free_list[SIZE_CLASS_NUM];
+  unsigned int free_list_len[SIZE_CLASS_NUM];
+} ThreadData;
+
+static unsigned int totblock = 0;
+static size_t mem_in_use = 0, peak_mem = 0;
+static bool malloc_debug_memset = false;
+static bool use_size_class_cache = false;
+
+static void (*error_callback)(const char *) = NULL;
+
+/* Protects the shared counters and the list of threads. */
+static pthread_mutex_t thread_data_lock = PTHREAD_MUTEX_INITIALIZER;
+static ThreadData *thread_data_first = NULL;
+static pthread_key_t thread_data_key;
+static pthread_once_t thread_data_key_once = PTHREAD_ONCE_INIT;
+static MEM_THREAD_LOCAL ThreadData *thread_data = NULL;
+
+#ifdef __GNUC__
+__attribute__((format(printf, 1, 2)))
+#endif
+static void
+print_error(const char *str, ...)
+{
+  char buf[512];
+  va_list ap;
+
+  va_start(ap, str);
+  vsnprintf(buf, sizeof(buf), str, ap);
+  va_end(ap);
+  buf[sizeof(buf) - 1] = '\0';
+
+  if (error_callback) {
+    error_callback(buf);
+  }
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Thread Data
+ * \{ */
+
+/* Call with #thread_data_lock held. */
+static void thread_data_merge_stats(ThreadData *td)
+{
+  mem_in_use += (size_t)td->mem_in_use;
+  totblock += (unsigned int)td->totblock;
+  if (mem_in_use > peak_mem) {
+    peak_mem = mem_in_use;
+  }
+  td->mem_in_use = 0;
+  td->totblock = 0;
+}
+
+/* Called when a thread exits, not for the main thread. */
+static void thread_data_free(void *td_v)
+{
+  ThreadData *td = (ThreadData *)td_v;
+
+  pthread_mutex_lock(&thread_data_lock);
+  thread_data_merge_stats(td);
+  if (td->prev) {
+    td->prev->next = td->next;
+  }
+  else {
+    thread_data_first = td->next;
+  }
+  if (td->next) {
+    td->next->prev = td->prev;
+  }
+  pthread_mutex_unlock(&thread_data_lock);
+
+  for (int size_class = 0; size_class < SIZE_CLASS_NUM; size_class++) {
+    MemFree *block = td->free_list[size_class];
+    while (block) {
+      MemFree *block_next = block->next;
+      free(block);
+      block = block_next;
+    }
+  }
+
+  free(td);
+  thread_data = NULL;
+}
+
+static void thread_data_key_create(void)
+{
+  pthread_key_create(&thread_data_key, thread_data_free);
+}
+
+static ThreadData *thread_data_ensure(void)
+{
+  ThreadData *td = thread_data;
+  if (LIKELY(td)) {
+    return td;
+  }
+
+  /* Not using the guarded allocator for its own data. */
+  td = (ThreadData *)calloc(1, sizeof(ThreadData));
+  if (UNLIKELY(td == NULL)) {
+    return NULL;
+  }
+
+  pthread_once(&thread_data_key_once, thread_data_key_create);
+  pthread_setspecific(thread_data_key, td);
+
+  pthread_mutex_lock(&thread_data_lock);
+  td->next = thread_data_first;
+  if (thread_data_first) {
+    thread_data_first->prev = td;
+  }
+  thread_data_first = td;
+  pthread_mutex_unlock(&thread_data_lock);
+
+  thread_data = td;
+  return td;
+}
+
+MEM_INLINE void thread_data_stats_add(ThreadData *td, const ptrdiff_t len, const int blocks)
+{
+  if (UNLIKELY(td == NULL)) {
+    /* Out of memory for the thread data, update the shared counters directly. */
+    pthread_mutex_lock(&thread_data_lock);
+    mem_in_use += (size_t)len;
+    totblock += (unsigned int)blocks;
+    pthread_mutex_unlock(&thread_data_lock);
+    return;
+  }
+
+  td->mem_in_use += len;
+  td->totblock += blocks;
+  if (UNLIKELY(td->mem_in_use > STATS_MERGE_THRESHOLD ||
+               td->mem_in_use < -STATS_MERGE_THRESHOLD)) {
+    pthread_mutex_lock(&thread_data_lock);
+    thread_data_merge_stats(td);
+    pthread_mutex_unlock(&thread_data_lock);
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Blocks
+ * \{ */
+
+/**
+ * Allocate a block for \a len bytes and its header, taking it from the free list of its size
+ * class when possible.
+ */
+static MemHead *memhead_alloc(ThreadData *td, const size_t len, const bool do_clear)
+{
+  MemHead *memh;
+
+  if (use_size_class_cache && len <= SIZE_CLASS_MAX_LEN) {
+    const size_t size_class = SIZE_CLASS_FROM_LEN(len);
+    MemFree *block = td ? td->free_list[size_class] : NULL;
+
+    if (block) {
+      td->free_list[size_class] = block->next;
+      td->free_list_len[size_class]--;
+      memh = (MemHead *)block;
+      if (do_clear) {
+        memset(memh + 1, 0, len);
+      }
+    }
+    else {
+      const size_t alloc_len = SIZE_CLASS_LEN(size_class) + sizeof(MemHead);
+      memh = (MemHead *)(do_clear ? calloc(1, alloc_len) : malloc(alloc_len));
+    }
+
+    if (LIKELY(memh)) {
+      memh->len = len | (size_t)MEMHEAD_SIZE_CLASS_FLAG;
+    }
+    return memh;
+  }
+
+  memh = (MemHead *)(do_clear ? calloc(1, len + sizeof(MemHead)) :
+                                malloc(len + sizeof(MemHead)));
+  if (LIKELY(memh)) {
+    memh->len = len;
+  }
+  return memh;
+}
+
+static void memhead_free(ThreadData *td, MemHead *memh, const size_t len)
+{
+  if (td && MEMHEAD_HAS_SIZE_CLASS(memh)) {
+    const size_t size_class = SIZE_CLASS_FROM_LEN(len);
+    if (td->free_list_len[size_class] < SIZE_CLASS_FREE_MAX) {
+      MemFree *block = (MemFree *)memh;
+      block->next = td->free_list[size_class];
+      td->free_list[size_class] = block;
+      td->free_list_len[size_class]++;
+      return;
+    }
+  }
+  free(memh);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Allocator API
+ * \{ */
+
+void MEM_threadcache_init(const bool use_size_class_cache_)
+{
+  use_size_class_cache = use_size_class_cache_;
+}
+
+size_t MEM_threadcache_allocN_len(const void *vmemh)
+{
+  if (vmemh) {
+    return MEMHEAD_FROM_PTR(vmemh)->len & ~MEMHEAD_FLAGS;
+  }
+  else {
+    return 0;
+  }
+}
+
+void MEM_threadcache_freeN(void *vmemh)
+{
+  if (leak_detector_has_run) {
+    print_error("%s\n", free_after_leak_detection_message);
+  }
+
+  if (vmemh == NULL) {
+    print_error("Attempt to free NULL pointer\n");
+#ifdef WITH_ASSERT_ABORT
+    abort();
+#endif
+    return;
+  }
+
+  MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+  size_t len = MEM_threadcache_allocN_len(vmemh);
+  ThreadData *td = thread_data_ensure();
+
+  thread_data_stats_add(td, -(ptrdiff_t)len, -1);
+
+  if (UNLIKELY(malloc_debug_memset && len)) {
+    memset(memh + 1, 255, len);
+  }
+  if (UNLIKELY(MEMHEAD_IS_ALIGNED(memh))) {
+    MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+    aligned_free(MEMHEAD_REAL_PTR(memh_aligned));
+  }
+  else {
+    memhead_free(td, memh, len);
+  }
+}
+
+void *MEM_threadcache_dupallocN(const void *vmemh)
+{
+  void *newp = NULL;
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    const size_t prev_size = MEM_threadcache_allocN_len(vmemh);
+    if (UNLIKELY(MEMHEAD_IS_ALIGNED(memh))) {
+      MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+      newp = MEM_threadcache_mallocN_aligned(
+          prev_size, (size_t)memh_aligned->alignment, "dupli_malloc");
+    }
+    else {
+      newp = MEM_threadcache_mallocN(prev_size, "dupli_malloc");
+    }
+    memcpy(newp, vmemh, prev_size);
+  }
+  return newp;
+}
+
+void *MEM_threadcache_reallocN_id(void *vmemh, size_t len, const char *str)
+{
+  void *newp = NULL;
+
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    size_t old_len = MEM_threadcache_allocN_len(vmemh);
+
+    if (LIKELY(!MEMHEAD_IS_ALIGNED(memh))) {
+      newp = MEM_threadcache_mallocN(len, "realloc");
+    }
+    else {
+      MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+      newp = MEM_threadcache_mallocN_aligned(len, (size_t)memh_aligned->alignment, "realloc");
+    }
+
+    if (newp) {
+      if (len < old_len) {
+        /* shrink */
+        memcpy(newp, vmemh, len);
+      }
+      else {
+        /* grow (or remain same size) */
+        memcpy(newp, vmemh, old_len);
+      }
+    }
+
+    MEM_threadcache_freeN(vmemh);
+  }
+  else {
+    newp = MEM_threadcache_mallocN(len, str);
+  }
+
+  return newp;
+}
+
+void *MEM_threadcache_recallocN_id(void *vmemh, size_t len, const char *str)
+{
+  void *newp = NULL;
+
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    size_t old_len = MEM_threadcache_allocN_len(vmemh);
+
+    if (LIKELY(!MEMHEAD_IS_ALIGNED(memh))) {
+      newp = MEM_threadcache_mallocN(len, "recalloc");
+    }
+    else {
+      MemHeadAligned *memh_aligned = MEMHEAD_ALIGNED_FROM_PTR(vmemh);
+      newp = MEM_threadcache_mallocN_aligned(len, (size_t)memh_aligned->alignment, "recalloc");
+    }
+
+    if (newp) {
+      if (len < old_len) {
+        /* shrink */
+        memcpy(newp, vmemh, len);
+      }
+      else {
+        memcpy(newp, vmemh, old_len);
+
+        if (len > old_len) {
+          /* grow */
+          /* zero new bytes */
+          memset(((char *)newp) + old_len, 0, len - old_len);
+        }
+      }
+    }
+
+    MEM_threadcache_freeN(vmemh);
+  }
+  else {
+    newp = MEM_threadcache_callocN(len, str);
+  }
+
+  return newp;
+}
+
+void *MEM_threadcache_callocN(size_t len, const char *str)
+{
+  ThreadData *td = thread_data_ensure();
+  MemHead *memh;
+
+  len = SIZET_ALIGN_4(len);
+
+  memh = memhead_alloc(td, len, true);
+
+  if (LIKELY(memh)) {
+    thread_data_stats_add(td, (ptrdiff_t)len, 1);
+
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Calloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)mem_in_use);
+  return NULL;
+}
+
+void *MEM_threadcache_calloc_arrayN(size_t len, size_t size, const char *str)
+{
+  size_t total_size;
+  if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+    print_error(
+        "Calloc array aborted due to integer overflow: "
+        "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+        SIZET_ARG(len),
+        SIZET_ARG(size),
+        str,
+        (unsigned int)mem_in_use);
+    abort();
+    return NULL;
+  }
+
+  return MEM_threadcache_callocN(total_size, str);
+}
+
+void *MEM_threadcache_mallocN(size_t len, const char *str)
+{
+  ThreadData *td = thread_data_ensure();
+  MemHead *memh;
+
+  len = SIZET_ALIGN_4(len);
+
+  memh = memhead_alloc(td, len, false);
+
+  if (LIKELY(memh)) {
+    if (UNLIKELY(malloc_debug_memset && len)) {
+      memset(memh + 1, 255, len);
+    }
+
+    thread_data_stats_add(td, (ptrdiff_t)len, 1);
+
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)mem_in_use);
+  return NULL;
+}
+
+void *MEM_threadcache_malloc_arrayN(size_t len, size_t size, const char *str)
+{
+  size_t total_size;
+  if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+    print_error(
+        "Malloc array aborted due to integer overflow: "
+        "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+        SIZET_ARG(len),
+        SIZET_ARG(size),
+        str,
+        (unsigned int)mem_in_use);
+    abort();
+    return NULL;
+  }
+
+  return MEM_threadcache_mallocN(total_size, str);
+}
+
+void *MEM_threadcache_mallocN_aligned(size_t len, size_t alignment, const char *str)
+{
+  /* Huge alignment values doesn't make sense and they wouldn't fit into 'short' used in the
+   * MemHead. */
+  assert(alignment < 1024);
+
+  /* We only support alignments that are a power of two. */
+  assert(IS_POW2(alignment));
+
+  /* Some OS specific aligned allocators require a certain minimal alignment. */
+  if (alignment < ALIGNED_MALLOC_MINIMUM_ALIGNMENT) {
+    alignment = ALIGNED_MALLOC_MINIMUM_ALIGNMENT;
+  }
+
+  /* It's possible that MemHead's size is not properly aligned,
+   * do extra padding to deal with this.
+   *
+   * We only support small alignments which fits into short in
+   * order to save some bits in MemHead structure.
+   */
+  size_t extra_padding = MEMHEAD_ALIGN_PADDING(alignment);
+
+  len = SIZET_ALIGN_4(len);
+
+  MemHeadAligned *memh = (MemHeadAligned *)aligned_malloc(
+      len + extra_padding + sizeof(MemHeadAligned), alignment);
+
+  if (LIKELY(memh)) {
+    /* We keep padding in the beginning of MemHead,
+     * this way it's always possible to get MemHead
+     * from the data pointer.
+     */
+    memh = (MemHeadAligned *)((char *)memh + extra_padding);
+
+    if (UNLIKELY(malloc_debug_memset && len)) {
+      memset(memh + 1, 255, len);
+    }
+
+    memh->len = len | (size_t)MEMHEAD_ALIGN_FLAG;
+    memh->alignment = (short)alignment;
+    thread_data_stats_add(thread_data_ensure(), (ptrdiff_t)len, 1);
+
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)mem_in_use);
+  return NULL;
+}
+
+void MEM_threadcache_printmemlist_pydict(void)
+{
+}
+
+void MEM_threadcache_printmemlist(void)
+{
+}
+
+/* unused */
+void MEM_threadcache_callbackmemlist(void (*func)(void *))
+{
+  (void)func; /* Ignored. */
+}
+
+void MEM_threadcache_printmemlist_stats(void)
+{
+  printf("\ntotal memory len: %.3f MB\n",
+         (double)MEM_threadcache_get_memory_in_use() / (double)(1024 * 1024));
+  printf("peak memory len: %.3f MB\n", (double)peak_mem / (double)(1024 * 1024));
+  printf(
+      "\nFor more detailed per-block statistics run Blender with memory debugging command line "
+      "argument.\n");
+
+#ifdef HAVE_MALLOC_STATS
+  printf("System Statistics:\n");
+  malloc_stats();
+#endif
+}
+
+void MEM_threadcache_set_error_callback(void (*func)(const char *))
+{
+  error_callback = func;
+}
+
+bool MEM_threadcache_consistency_check(void)
+{
+  return true;
+}
+
+void MEM_threadcache_set_memory_debug(void)
+{
+  malloc_debug_memset = true;
+}
+
+/* The local changes of other threads are read while they may be modified,
+ * so the result can be slightly out of date when other threads are allocating. */
+size_t MEM_threadcache_get_memory_in_use(void)
+{
+  pthread_mutex_lock(&thread_data_lock);
+  size_t result = mem_in_use;
+  for (ThreadData *td = thread_data_first; td; td = td->next) {
+    result += (size_t)td->mem_in_use;
+  }
+  pthread_mutex_unlock(&thread_data_lock);
+  return result;
+}
+
+unsigned int MEM_threadcache_get_memory_blocks_in_use(void)
+{
+  pthread_mutex_lock(&thread_data_lock);
+  unsigned int result = totblock;
+  for (ThreadData *td = thread_data_first; td; td = td->next) {
+    result += (unsigned int)td->totblock;
+  }
+  pthread_mutex_unlock(&thread_data_lock);
+  return result;
+}
+
+void MEM_threadcache_reset_peak_memory(void)
+{
+  const size_t in_use = MEM_threadcache_get_memory_in_use();
+  pthread_mutex_lock(&thread_data_lock);
+  peak_mem = in_use;
+  pthread_mutex_unlock(&thread_data_lock);
+}
+
+size_t MEM_threadcache_get_peak_memory(void)
+{
+  /* Include the local changes that were not merged yet. */
+  const size_t in_use = MEM_threadcache_get_memory_in_use();
+  return (in_use > peak_mem) ? in_use : peak_mem;
+}
+
+#ifndef NDEBUG
+const char *MEM_threadcache_name_ptr(void *vmemh)
+{
+  if (vmemh) {
+    return "unknown block name ptr";
+  }
+  else {
+    return "MEM_threadcache_name_ptr(NULL)";
+  }
+}
+#endif /* NDEBUG */
+
+/** \} */
@@ -139,6 +139,29 @@ static void CompleteReconstructionLogProgress(
   }
 }
 
+// Group markers by track and by image in a single pass over all markers, so
+// the reconstruction loops below do not scan all the markers for every track
+// and image on every iteration. Markers keep their order from the tracks.
+static void GroupMarkersByTrackAndImage(
+    const Tracks &tracks,
+    vector<vector<Marker> > *markers_for_track,
+    vector<vector<Marker> > *markers_in_image) {
+  markers_for_track->clear();
+  markers_in_image->clear();
+  markers_for_track->resize(tracks.MaxTrack() + 1);
+  markers_in_image->resize(tracks.MaxImage() + 1);
+  vector<Marker> markers = tracks.AllMarkers();
+  for (int i = 0; i < markers.size(); ++i) {
+    const Marker &marker = markers[i];
+    if (marker.track >= 0) {
+      (*markers_for_track)[marker.track].push_back(marker);
+    }
+    if (marker.image >= 0) {
+      (*markers_in_image)[marker.image].push_back(marker);
+    }
+  }
+}
+
 template<typename PipelineRoutines>
 void InternalCompleteReconstruction(
     const Tracks &tracks,
@@ -152,6 +175,8 @@ void InternalCompleteReconstruction(
   LG << "Max track: " << max_track;
   LG << "Max image: " << max_image;
   LG << "Number of markers: " << tracks.NumMarkers();
+  vector<vector<Marker> > markers_for_track, markers_in_image;
+  GroupMarkersByTrackAndImage(tracks, &markers_for_track, &markers_in_image);
   while (num_resects != 0 || num_intersects != 0) {
     // Do all possible intersections.
     num_intersects = 0;
@@ -160,7 +185,7 @@ void InternalCompleteReconstruction(
         LG << "Skipping point: " << track;
         continue;
       }
-      vector<Marker> all_markers = tracks.MarkersForTrack(track);
+      const vector<Marker> &all_markers = markers_for_track[track];
       LG << "Got " << all_markers.size() << " markers for track " << track;
 
       vector<Marker> reconstructed_markers;
@@ -199,7 +224,7 @@ void InternalCompleteReconstruction(
         LG << "Skipping frame: " << image;
         continue;
       }
-      vector<Marker> all_markers = tracks.MarkersInImage(image);
+      const vector<Marker> &all_markers = markers_in_image[image];
       LG << "Got " << all_markers.size() << " markers for image " << image;
 
       vector<Marker> reconstructed_markers;
@@ -239,7 +264,7 @@ void InternalCompleteReconstruction(
       LG << "Skipping frame: " << image;
       continue;
     }
-    vector<Marker> all_markers = tracks.MarkersInImage(image);
+    const vector<Marker> &all_markers = markers_in_image[image];
 
     vector<Marker> reconstructed_markers;
     for (int i = 0; i < all_markers.size(); ++i) {
@@ -35,7 +35,10 @@
 #include "smoke_script.h"
 
 #include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
 #include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_fluid_types.h"
@@ -548,6 +551,11 @@ MANTA::~MANTA()
     cout << "~FLUID: " << mCurrentID << " with res(" << mResX << ", " << mResY << ", " << mResZ
          << ")" << endl;
 
+  if (mPrefetchPool) {
+    BLI_task_pool_cancel(mPrefetchPool);
+    BLI_task_pool_free(mPrefetchPool);
+  }
+
   /* Destruction string for Python. */
   string tmpString = "";
   vector<string> pythonCommands;
@@ -2213,6 +2221,87 @@ bool MANTA::hasGuiding(FluidModifierData *fmd, int framenr, bool sourceDomain)
   return exists;
 }
 
+/* Number of frames after the current one to read ahead, and the read size used for it. */
+#define FLUID_PREFETCH_FRAMES 3
+#define FLUID_PREFETCH_BLOCK_SIZE (1 << 20)
+
+typedef struct FluidPrefetchTask {
+  char directory[FILE_MAX];
+  int framenr;
+} FluidPrefetchTask;
+
+static void fluid_prefetch_task(TaskPool *__restrict pool, void *taskdata)
+{
+  FluidPrefetchTask *task = (FluidPrefetchTask *)taskdata;
+  struct direntry *files;
+  unsigned int totfile = BLI_filelist_dir_contents(task->directory, &files);
+  char *block = (char *)MEM_mallocN(FLUID_PREFETCH_BLOCK_SIZE, __func__);
+
+  /* Matches all files of the frame, whatever their name and (multi-part) extension. */
+  char frame_token[32];
+  BLI_snprintf(frame_token, sizeof(frame_token), "_%04d.", task->framenr);
+
+  for (unsigned int i = 0; i < totfile && !BLI_task_pool_canceled(pool); i++) {
+    if (!strstr(files[i].relname, frame_token)) {
+      continue;
+    }
+    FILE *file = BLI_fopen(files[i].path, "rb");
+    if (file == nullptr) {
+      continue;
+    }
+    /* The data is discarded, it only has to end up in the OS file cache. */
+    while (!BLI_task_pool_canceled(pool) &&
+           fread(block, 1, FLUID_PREFETCH_BLOCK_SIZE, file) == FLUID_PREFETCH_BLOCK_SIZE) {
+    }
+    fclose(file);
+  }
+
+  MEM_freeN(block);
+  BLI_filelist_free(files, totfile);
+}
+
+void MANTA::prefetchCache(FluidModifierData *fmd, int framenr)
+{
+  if (with_debug)
+    cout << "MANTA::prefetchCache()" << endl;
+
+  vector<string> subdirectories;
+  subdirectories.push_back(FLUID_DOMAIN_DIR_DATA);
+  if (mUsingNoise)
+    subdirectories.push_back(FLUID_DOMAIN_DIR_NOISE);
+  if (mUsingMesh)
+    subdirectories.push_back(FLUID_DOMAIN_DIR_MESH);
+  if (mUsingDrops || mUsingBubbles || mUsingFloats || mUsingTracers)
+    subdirectories.push_back(FLUID_DOMAIN_DIR_PARTICLES);
+
+  if (mPrefetchPool == nullptr) {
+    /* Serial, so frames are read in order and the disk isn't hit from many threads. */
+    mPrefetchPool = BLI_task_pool_create_background_serial(nullptr, TASK_PRIORITY_LOW);
+  }
+
+  int first_frame = framenr + 1;
+  int last_frame = framenr + FLUID_PREFETCH_FRAMES;
+  if (mPrefetchFrame >= framenr && mPrefetchFrame <= last_frame) {
+    /* Playing forward, only the frames that just entered the window are new. */
+    first_frame = mPrefetchFrame + 1;
+  }
+  else {
+    /* Jumped to another frame, files read ahead for the old position aren't needed anymore. */
+    BLI_task_pool_cancel(mPrefetchPool);
+  }
+
+  for (int frame = first_frame; frame <= last_frame; frame++) {
+    for (const string &subdirectory : subdirectories) {
+      FluidPrefetchTask *task = (FluidPrefetchTask *)MEM_mallocN(sizeof(FluidPrefetchTask),
+                                                                 __func__);
+      BLI_strncpy(task->directory, getDirectory(fmd, subdirectory).c_str(), FILE_MAX);
+      task->framenr = frame;
+      BLI_task_pool_push(mPrefetchPool, fluid_prefetch_task, task, true, nullptr);
+    }
+  }
+  mPrefetchFrame = last_frame;
+}
+
 string MANTA::getDirectory(FluidModifierData *fmd, string subdirectory)
 {
   char directory[FILE_MAX];
@@ -35,6 +35,8 @@ using std::string;
 using std::unordered_map;
 using std::vector;
 
+struct TaskPool;
+
 struct MANTA {
  public:
   MANTA(int *res, struct FluidModifierData *fmd);
@@ -116,6 +118,10 @@ struct MANTA {
   bool hasParticles(FluidModifierData *fmd, int framenr);
   bool hasGuiding(FluidModifierData *fmd, int framenr, bool sourceDomain);
 
+  /* Read cache files of the next frames in the background, so they come from the OS file cache
+   * when playback reaches them. */
+  void prefetchCache(FluidModifierData *fmd, int framenr);
+
   inline size_t getTotalCells()
   {
     return mTotalCells;
@@ -768,6 +774,10 @@ struct MANTA {
   bool mSmokeFromFile;
   bool mNoiseFromFile;
 
+  /* Cache read-ahead, the last frame pushed to the pool. */
+  struct TaskPool *mPrefetchPool = nullptr;
+  int mPrefetchFrame = 0;
+
   int mResX;
   int mResY;
   int mResZ;
@@ -195,6 +195,13 @@ int manta_has_guiding(MANTA *fluid, FluidModifierData *fmd, int framenr, bool do
   return fluid->hasGuiding(fmd, framenr, domain);
 }
 
+void manta_prefetch_cache(MANTA *fluid, FluidModifierData *fmd, int framenr)
+{
+  if (!fluid || !fmd)
+    return;
+  fluid->prefetchCache(fmd, framenr);
+}
+
 void manta_update_variables(MANTA *fluid, FluidModifierData *fmd)
 {
   if (!fluid)
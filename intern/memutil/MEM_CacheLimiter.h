@@ -142,7 +142,11 @@ template<class T> class MEM_CacheLimiter {
   typedef int (*MEM_CacheLimiter_ItemPriority_Func)(void *item, int default_priority);
   typedef bool (*MEM_CacheLimiter_ItemDestroyable_Func)(void *item);
 
-  MEM_CacheLimiter(MEM_CacheLimiter_DataSize_Func data_size_func) : data_size_func(data_size_func)
+  MEM_CacheLimiter(MEM_CacheLimiter_DataSize_Func data_size_func)
+      : data_size_func(data_size_func),
+        item_priority_func(NULL),
+        item_destroyable_func(NULL),
+        maximum(0)
   {
   }
 
@@ -187,7 +191,7 @@ template<class T> class MEM_CacheLimiter {
 
   void enforce_limits()
   {
-    size_t max = MEM_CacheLimiter_get_maximum();
+    size_t max = get_maximum();
     bool is_disabled = MEM_CacheLimiter_is_disabled();
     size_t mem_in_use, cur_size;
 
@@ -244,6 +248,17 @@ template<class T> class MEM_CacheLimiter {
     }
   }
 
+  /* Limit of this cache, zero uses the global limit. */
+  void set_maximum(size_t maximum)
+  {
+    this->maximum = maximum;
+  }
+
+  size_t get_maximum() const
+  {
+    return maximum ? maximum : MEM_CacheLimiter_get_maximum();
+  }
+
   void set_item_priority_func(MEM_CacheLimiter_ItemPriority_Func item_priority_func)
   {
     this->item_priority_func = item_priority_func;
@@ -319,6 +334,7 @@ template<class T> class MEM_CacheLimiter {
   MEM_CacheLimiter_DataSize_Func data_size_func;
   MEM_CacheLimiter_ItemPriority_Func item_priority_func;
   MEM_CacheLimiter_ItemDestroyable_Func item_destroyable_func;
+  size_t maximum;
 };
 
 #endif  // __MEM_CACHELIMITER_H__
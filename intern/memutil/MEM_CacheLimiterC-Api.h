@@ -149,6 +149,16 @@ void MEM_CacheLimiter_ItemDestroyable_Func_set(
 
 size_t MEM_CacheLimiter_get_memory_in_use(MEM_CacheLimiterC *This);
 
+/**
+ * Set memory limit of this cache only, zero uses the global limit.
+ *
+ * \param This: "This" pointer.
+ */
+
+void MEM_CacheLimiter_set_instance_maximum(MEM_CacheLimiterC *This, size_t m);
+
+size_t MEM_CacheLimiter_get_instance_maximum(MEM_CacheLimiterC *This);
+
 #ifdef __cplusplus
 }
 #endif
@@ -227,3 +227,13 @@ size_t MEM_CacheLimiter_get_memory_in_use(MEM_CacheLimiterC *This)
 {
   return cast(This)->get_cache()->get_memory_in_use();
 }
+
+void MEM_CacheLimiter_set_instance_maximum(MEM_CacheLimiterC *This, size_t m)
+{
+  cast(This)->get_cache()->set_maximum(m);
+}
+
+size_t MEM_CacheLimiter_get_instance_maximum(MEM_CacheLimiterC *This)
+{
+  return cast(This)->get_cache()->get_maximum();
+}
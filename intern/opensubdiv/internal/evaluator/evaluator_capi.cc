@@ -112,6 +112,13 @@ void evaluatePatchesLimit(OpenSubdiv_Evaluator *evaluator,
       patch_coords, num_patch_coords, P, dPdu, dPdv);
 }
 
+OpenSubdiv_LimitStencils *createLimitStencils(OpenSubdiv_Evaluator *evaluator,
+                                              const OpenSubdiv_PatchCoord *patch_coords,
+                                              const int num_patch_coords)
+{
+  return openSubdiv_createLimitStencilsInternal(evaluator->impl, patch_coords, num_patch_coords);
+}
+
 void evaluateVarying(OpenSubdiv_Evaluator *evaluator,
                      const int ptex_face_index,
                      float face_u,
@@ -149,6 +156,8 @@ void assignFunctionPointers(OpenSubdiv_Evaluator *evaluator)
   evaluator->evaluateFaceVarying = evaluateFaceVarying;
 
   evaluator->evaluatePatchesLimit = evaluatePatchesLimit;
+
+  evaluator->createLimitStencils = createLimitStencils;
 }
 
 }  // namespace
@@ -167,3 +176,14 @@ void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator *evaluator)
   openSubdiv_deleteEvaluatorInternal(evaluator->impl);
   OBJECT_GUARDED_DELETE(evaluator, OpenSubdiv_Evaluator);
 }
+
+void openSubdiv_deleteLimitStencils(OpenSubdiv_LimitStencils *stencils)
+{
+  MEM_freeN(stencils->offsets);
+  MEM_freeN(stencils->sizes);
+  MEM_freeN(stencils->indices);
+  MEM_freeN(stencils->weights);
+  MEM_freeN(stencils->du_weights);
+  MEM_freeN(stencils->dv_weights);
+  MEM_freeN(stencils);
+}
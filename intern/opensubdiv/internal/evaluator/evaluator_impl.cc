@@ -28,6 +28,7 @@
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
 #include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/stencilTableFactory.h>
 #include <opensubdiv/osd/cpuEvaluator.h>
 #include <opensubdiv/osd/cpuPatchTable.h>
 #include <opensubdiv/osd/cpuVertexBuffer.h>
@@ -39,8 +40,11 @@
 
 #include "internal/base/type.h"
 #include "internal/topology/topology_refiner_impl.h"
+#include "opensubdiv_evaluator_capi.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
+using OpenSubdiv::Far::LimitStencilTable;
+using OpenSubdiv::Far::LimitStencilTableFactory;
 using OpenSubdiv::Far::PatchMap;
 using OpenSubdiv::Far::PatchTable;
 using OpenSubdiv::Far::PatchTableFactory;
@@ -736,7 +740,7 @@ void CpuEvalOutputAPI::evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_c
 }  // namespace blender
 
 OpenSubdiv_EvaluatorImpl::OpenSubdiv_EvaluatorImpl()
-    : eval_output(NULL), patch_map(NULL), patch_table(NULL)
+    : eval_output(NULL), patch_map(NULL), patch_table(NULL), refiner(NULL)
 {
 }
 
@@ -862,6 +866,7 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
   evaluator_descr->eval_output = new blender::opensubdiv::CpuEvalOutputAPI(eval_output, patch_map);
   evaluator_descr->patch_map = patch_map;
   evaluator_descr->patch_table = patch_table;
+  evaluator_descr->refiner = refiner;
   // TOOD(sergey): Look into whether we've got duplicated stencils arrays.
   delete vertex_stencils;
   delete varying_stencils;
@@ -875,3 +880,73 @@ void openSubdiv_deleteEvaluatorInternal(OpenSubdiv_EvaluatorImpl *evaluator)
 {
   delete evaluator;
 }
+
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencilsInternal(
+    const OpenSubdiv_EvaluatorImpl *evaluator,
+    const OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords)
+{
+  const TopologyRefiner *refiner = evaluator->refiner;
+  const PatchTable *patch_table = evaluator->patch_table;
+  // Limit stencils are factorized over stencils of all refined vertices,
+  // which need to include the coarse vertices and the end cap local points.
+  StencilTableFactory::Options vertex_stencil_options;
+  vertex_stencil_options.generateOffsets = true;
+  vertex_stencil_options.generateIntermediateLevels = !refiner->IsUniform();
+  vertex_stencil_options.generateControlVerts = true;
+  const StencilTable *vertex_stencils = StencilTableFactory::Create(*refiner,
+                                                                    vertex_stencil_options);
+  const StencilTable *local_point_stencil_table = patch_table->GetLocalPointStencilTable();
+  if (local_point_stencil_table != NULL) {
+    const StencilTable *table = StencilTableFactory::AppendLocalPointStencilTable(
+        *refiner, vertex_stencils, local_point_stencil_table);
+    delete vertex_stencils;
+    vertex_stencils = table;
+  }
+  // One location per stencil, so stencils match the order of coordinates.
+  LimitStencilTableFactory::LocationArrayVec locations(num_patch_coords);
+  for (int i = 0; i < num_patch_coords; ++i) {
+    locations[i].ptexIdx = patch_coords[i].ptex_face;
+    locations[i].numLocations = 1;
+    locations[i].s = &patch_coords[i].u;
+    locations[i].t = &patch_coords[i].v;
+  }
+  LimitStencilTableFactory::Options limit_stencil_options;
+  limit_stencil_options.generate1stDerivatives = true;
+  limit_stencil_options.generate2ndDerivatives = false;
+  const LimitStencilTable *limit_stencils = LimitStencilTableFactory::Create(
+      *refiner, locations, vertex_stencils, patch_table, limit_stencil_options);
+  delete vertex_stencils;
+  if (limit_stencils == NULL) {
+    return NULL;
+  }
+  if (limit_stencils->GetNumStencils() != num_patch_coords) {
+    // Some coordinates are outside of the patches.
+    delete limit_stencils;
+    return NULL;
+  }
+  // Copy to arrays owned by the caller.
+  const int num_elements = limit_stencils->GetControlIndices().size();
+  OpenSubdiv_LimitStencils *stencils = (OpenSubdiv_LimitStencils *)MEM_mallocN(
+      sizeof(OpenSubdiv_LimitStencils), __func__);
+  stencils->num_stencils = num_patch_coords;
+  stencils->num_elements = num_elements;
+  stencils->offsets = (int *)MEM_mallocN(sizeof(int) * num_patch_coords, __func__);
+  stencils->sizes = (int *)MEM_mallocN(sizeof(int) * num_patch_coords, __func__);
+  stencils->indices = (int *)MEM_mallocN(sizeof(int) * num_elements, __func__);
+  stencils->weights = (float *)MEM_mallocN(sizeof(float) * num_elements, __func__);
+  stencils->du_weights = (float *)MEM_mallocN(sizeof(float) * num_elements, __func__);
+  stencils->dv_weights = (float *)MEM_mallocN(sizeof(float) * num_elements, __func__);
+  for (int i = 0; i < num_patch_coords; ++i) {
+    stencils->offsets[i] = limit_stencils->GetOffsets()[i];
+    stencils->sizes[i] = limit_stencils->GetSizes()[i];
+  }
+  for (int i = 0; i < num_elements; ++i) {
+    stencils->indices[i] = limit_stencils->GetControlIndices()[i];
+    stencils->weights[i] = limit_stencils->GetWeights()[i];
+    stencils->du_weights[i] = limit_stencils->GetDuWeights()[i];
+    stencils->dv_weights[i] = limit_stencils->GetDvWeights()[i];
+  }
+  delete limit_stencils;
+  return stencils;
+}
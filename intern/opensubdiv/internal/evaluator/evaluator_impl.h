@@ -25,9 +25,11 @@
 
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/topologyRefiner.h>
 
 #include "internal/base/memory.h"
 
+struct OpenSubdiv_LimitStencils;
 struct OpenSubdiv_PatchCoord;
 struct OpenSubdiv_TopologyRefiner;
 
@@ -146,6 +148,9 @@ struct OpenSubdiv_EvaluatorImpl {
   blender::opensubdiv::CpuEvalOutputAPI *eval_output;
   const OpenSubdiv::Far::PatchMap *patch_map;
   const OpenSubdiv::Far::PatchTable *patch_table;
+  // Owned by the topology refiner the evaluator was created from, which
+  // outlives the evaluator.
+  const OpenSubdiv::Far::TopologyRefiner *refiner;
 
   MEM_CXX_CLASS_ALLOC_FUNCS("OpenSubdiv_EvaluatorImpl");
 };
@@ -155,4 +160,9 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
 
 void openSubdiv_deleteEvaluatorInternal(OpenSubdiv_EvaluatorImpl *evaluator);
 
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencilsInternal(
+    const OpenSubdiv_EvaluatorImpl *evaluator,
+    const struct OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords);
+
 #endif  // OPENSUBDIV_EVALUATOR_IMPL_H_
@@ -27,6 +27,22 @@ struct OpenSubdiv_EvaluatorInternal;
 struct OpenSubdiv_PatchCoord;
 struct OpenSubdiv_TopologyRefiner;
 
+// Limit stencils: weights of the coarse vertices giving the limit position and
+// derivatives at a patch coordinate, which don't depend on the coarse positions.
+// Stored in compressed rows, one row per patch coordinate.
+typedef struct OpenSubdiv_LimitStencils {
+  int num_stencils;
+  int num_elements;
+  // Offset of the first element of every stencil, and number of elements.
+  int *offsets;
+  int *sizes;
+  // Coarse vertex index and weights of every element.
+  int *indices;
+  float *weights;
+  float *du_weights;
+  float *dv_weights;
+} OpenSubdiv_LimitStencils;
+
 typedef struct OpenSubdiv_Evaluator {
   // Set coarse positions from a continuous array of coordinates.
   void (*setCoarsePositions)(struct OpenSubdiv_Evaluator *evaluator,
@@ -122,6 +138,16 @@ typedef struct OpenSubdiv_Evaluator {
                                float *dPdu,
                                float *dPdv);
 
+  // Create limit stencils for the given patch coordinates, with first
+  // derivatives. Stencil i corresponds to patch_coords[i].
+  //
+  // Returns NULL if the stencils could not be created.
+  // Free with openSubdiv_deleteLimitStencils().
+  struct OpenSubdiv_LimitStencils *(*createLimitStencils)(
+      struct OpenSubdiv_Evaluator *evaluator,
+      const struct OpenSubdiv_PatchCoord *patch_coords,
+      const int num_patch_coords);
+
   // Implementation of the evaluator.
   struct OpenSubdiv_EvaluatorImpl *impl;
 } OpenSubdiv_Evaluator;
@@ -131,6 +157,8 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
 
 void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator *evaluator);
 
+void openSubdiv_deleteLimitStencils(OpenSubdiv_LimitStencils *stencils);
+
 #ifdef __cplusplus
 }
 #endif
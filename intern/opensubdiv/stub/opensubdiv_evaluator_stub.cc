@@ -29,3 +29,7 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
 void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator * /*evaluator*/)
 {
 }
+
+void openSubdiv_deleteLimitStencils(OpenSubdiv_LimitStencils * /*stencils*/)
+{
+}
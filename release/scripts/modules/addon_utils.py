@@ -26,6 +26,7 @@ __all__ = (
     "disable",
     "disable_all",
     "reset_all",
+    "enable_pending",
     "module_bl_info",
 )
 
@@ -36,6 +37,9 @@ error_encoding = False
 # (name, file, path)
 error_duplicates = []
 addons_fake_modules = {}
+# Add-ons enabled in the preferences but not imported yet,
+# when starting with '--background-fast-start'.
+addons_pending = []
 
 
 # called only once at startup, avoids calling 'reset_all', correct but slower.
@@ -43,10 +47,47 @@ def _initialize():
     path_list = paths()
     for path in path_list:
         _bpy.utils._sys_path_ensure_append(path)
+
+    if _bpy.app.background and _bpy.app.background_fast_start:
+        _initialize_pending()
+        return
+
     for addon in _preferences.addons:
         enable(addon.module)
 
 
+def _initialize_pending():
+    # Only read 'bl_info' of the add-ons,
+    # importing and registering them is what takes time.
+    # Render engines must be registered before a render starts,
+    # all other add-ons are enabled on first use of an operator
+    # that doesn't exist yet, see: 'enable_pending'.
+    modules_refresh()
+    for addon in _preferences.addons:
+        mod = addons_fake_modules.get(addon.module)
+        if mod is not None and mod.bl_info.get("category") != "Render":
+            addons_pending.append(addon.module)
+        else:
+            enable(addon.module)
+
+
+def enable_pending():
+    """
+    Enables add-ons which were deferred at startup,
+    see ``--background-fast-start``.
+
+    :return: True when any add-on was enabled.
+    :rtype: bool
+    """
+    if not addons_pending:
+        return False
+    module_names = addons_pending[:]
+    addons_pending.clear()
+    for module_name in module_names:
+        enable(module_name)
+    return True
+
+
 def paths():
     # RELEASE SCRIPTS: official scripts distributed in Blender releases
     addon_paths = _bpy.utils.script_paths("addons")
@@ -299,6 +340,9 @@ def enable(module_name, *, default_set=False, persistent=False, handle_error=Non
             import traceback
             traceback.print_exc()
 
+    if module_name in addons_pending:
+        addons_pending.remove(module_name)
+
     # reload if the mtime changes
     mod = sys.modules.get(module_name)
     # chances of the file _not_ existing are low, but it could be removed
@@ -461,6 +505,9 @@ def reset_all(*, reload_scripts=False):
     # initializes addons_fake_modules
     modules_refresh()
 
+    # Deferred add-ons are enabled below when they are still enabled in the preferences.
+    addons_pending.clear()
+
     # RELEASE SCRIPTS: official scripts distributed in Blender releases
     paths_list = paths()
 
@@ -163,6 +163,11 @@ class BPyOpsSubModOp:
                 for view_layer in scene.view_layers:
                     view_layer.update()
 
+    @staticmethod
+    def _addons_enable_pending():
+        import addon_utils
+        return addon_utils.enable_pending()
+
     __doc__ = property(_get_doc)
 
     def __init__(self, module, func):
@@ -196,9 +201,17 @@ class BPyOpsSubModOp:
 
         if args:
             C_dict, C_exec, C_undo = BPyOpsSubModOp._parse_args(args)
-            ret = op_call(self.idname_py(), C_dict, kw, C_exec, C_undo)
+            call_args = (C_dict, kw, C_exec, C_undo)
         else:
-            ret = op_call(self.idname_py(), None, kw)
+            call_args = (None, kw)
+
+        try:
+            ret = op_call(self.idname_py(), *call_args)
+        except AttributeError:
+            # The operator may be defined by an add-on which was not enabled yet.
+            if not BPyOpsSubModOp._addons_enable_pending():
+                raise
+            ret = op_call(self.idname_py(), *call_args)
 
         if 'FINISHED' in ret and context.window_manager == wm:
             BPyOpsSubModOp._view_layer_update(context)
@@ -278,6 +278,7 @@ class RENDER_PT_output(RenderOutputButtonsPanel, Panel):
             col = layout.column(heading="Image Sequence")
             col.prop(rd, "use_overwrite")
             col.prop(rd, "use_placeholder")
+            col.prop(rd, "use_write_async")
 
 
 class RENDER_PT_output_views(RenderOutputButtonsPanel, Panel):
@@ -373,6 +373,7 @@ class RENDER_PT_eevee_shadows(RenderButtonsPanel, Panel):
         col.prop(props, "shadow_cascade_size", text="Cascade Size")
         col.prop(props, "use_shadow_high_bitdepth")
         col.prop(props, "use_soft_shadows")
+        col.prop(props, "use_shadow_static_cache")
         col.prop(props, "light_threshold")
 
 
@@ -650,8 +650,10 @@ class NODE_PT_quality(bpy.types.Panel):
         col.prop(tree, "use_groupnode_buffer")
         col.prop(tree, "use_two_pass")
         col.prop(tree, "use_viewer_border")
+        col.prop(tree, "use_half_precision_buffers")
         col.separator()
         col.prop(snode, "use_auto_render")
+        col.prop(snode, "show_statistics")
 
 
 class NODE_UL_interface_sockets(bpy.types.UIList):
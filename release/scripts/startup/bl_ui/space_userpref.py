@@ -633,6 +633,11 @@ class USERPREF_PT_system_video_sequencer(SystemPanel, CenterAlignMixIn, Panel):
         edit = prefs.edit
 
         layout.prop(system, "memory_cache_limit")
+        col = layout.column(align=True)
+        col.prop(system, "memory_cache_sequencer_share", text="Sequencer Share")
+        col.prop(system, "memory_cache_clip_share", text="Movie Clip Share")
+        col.prop(system, "memory_cache_image_share", text="Image Share")
+        layout.prop(system, "memory_cache_compressed_size", text="Compressed Cache")
 
         layout.separator()
 
@@ -2171,6 +2176,11 @@ class USERPREF_PT_experimental_prototypes(ExperimentalPanel, Panel):
         self._draw_items(
             context, (
                 ({"property": "use_new_hair_type"}, "T68981"),
+                ({"property": "use_gpu_mesh_deform"}, None),
+                ({"property": "use_gpu_armature_deform"}, None),
+                ({"property": "use_gpu_subdivision"}, None),
+                ({"property": "use_gpu_shader_cache"}, None),
+                ({"property": "use_hw_video_decode"}, None),
             ),
         )
 
@@ -182,44 +182,51 @@ void blf_batch_draw_begin(FontBLF *font)
 
 static GPUTexture *blf_batch_cache_texture_load(void)
 {
-  GlyphCacheBLF *gc = g_batch.glyph_cache;
-  BLI_assert(gc);
-  BLI_assert(gc->bitmap_len > 0);
+  GlyphAtlasBLF *atlas = g_batch.atlas;
+  BLI_assert(atlas);
+  BLI_assert(atlas->bitmap_len > 0);
 
-  if (gc->bitmap_len > gc->bitmap_len_landed) {
-    const int tex_width = GPU_texture_width(gc->texture);
+  if (atlas->bitmap_len > atlas->bitmap_len_landed) {
+    const int tex_width = GPU_texture_width(atlas->texture);
 
-    int bitmap_len_landed = gc->bitmap_len_landed;
-    int remain = gc->bitmap_len - bitmap_len_landed;
+    int bitmap_len_landed = atlas->bitmap_len_landed;
+    int remain = atlas->bitmap_len - bitmap_len_landed;
     int offset_x = bitmap_len_landed % tex_width;
     int offset_y = bitmap_len_landed / tex_width;
 
-    GPU_texture_bind(gc->texture, 0);
+    GPU_texture_bind(atlas->texture, 0);
 
-    /* TODO(germano): Update more than one row in a single call. */
     while (remain) {
-      int remain_row = tex_width - offset_x;
-      int width = remain > remain_row ? remain_row : remain;
-      GPU_texture_update_sub(gc->texture,
+      /* Update the rest of a partially filled row, or all complete rows in a single call. */
+      int width, height;
+      if (offset_x != 0 || remain < tex_width) {
+        width = MIN2(remain, tex_width - offset_x);
+        height = 1;
+      }
+      else {
+        width = tex_width;
+        height = remain / tex_width;
+      }
+      GPU_texture_update_sub(atlas->texture,
                              GPU_DATA_UNSIGNED_BYTE,
-                             &gc->bitmap_result[bitmap_len_landed],
+                             &atlas->bitmap_result[bitmap_len_landed],
                              offset_x,
                              offset_y,
                              0,
                              width,
-                             1,
+                             height,
                              0);
 
-      bitmap_len_landed += width;
-      remain -= width;
+      bitmap_len_landed += width * height;
+      remain -= width * height;
       offset_x = 0;
-      offset_y += 1;
+      offset_y += height;
     }
 
-    gc->bitmap_len_landed = bitmap_len_landed;
+    atlas->bitmap_len_landed = bitmap_len_landed;
   }
 
-  return gc->texture;
+  return atlas->texture;
 }
 
 void blf_batch_draw(void)
@@ -1307,6 +1314,7 @@ void blf_font_free(FontBLF *font)
   while ((gc = BLI_pophead(&font->cache))) {
     blf_glyph_cache_free(gc);
   }
+  blf_glyph_atlas_free(&font->atlas);
 
   blf_kerning_cache_clear(font);
 
@@ -79,16 +79,23 @@ KerningCacheBLF *blf_kerning_cache_new(FontBLF *font, GlyphCacheBLF *gc)
   kc->prev = NULL;
   kc->mode = font->kerning_mode;
 
+  /* Look up the glyphs once, instead of once per pair. */
+  GlyphBLF *glyphs[0x80];
   unsigned int i, j;
+  for (i = 0; i < 0x80; i++) {
+    GlyphBLF *g = blf_glyph_search(gc, i);
+    if (!g) {
+      FT_UInt glyph_index = FT_Get_Char_Index(font->face, i);
+      g = blf_glyph_add(font, gc, glyph_index, i);
+    }
+    /* Can fail on certain fonts */
+    glyphs[i] = g;
+  }
+
   for (i = 0; i < 0x80; i++) {
     for (j = 0; j < 0x80; j++) {
-      GlyphBLF *g = blf_glyph_search(gc, i);
-      if (!g) {
-        FT_UInt glyph_index = FT_Get_Char_Index(font->face, i);
-        g = blf_glyph_add(font, gc, glyph_index, i);
-      }
-      /* Can fail on certain fonts */
-      GlyphBLF *g_prev = blf_glyph_search(gc, j);
+      GlyphBLF *g = glyphs[i];
+      GlyphBLF *g_prev = glyphs[j];
 
       FT_Vector delta = {
           .x = 0,
@@ -198,6 +205,8 @@ void blf_glyph_cache_clear(FontBLF *font)
   while ((gc = BLI_pophead(&font->cache))) {
     blf_glyph_cache_free(gc);
   }
+  /* The glyphs in the atlas are gone. */
+  blf_glyph_atlas_free(&font->atlas);
 
   BLI_spin_unlock(font->glyph_cache_mutex);
 }
@@ -212,13 +221,18 @@ void blf_glyph_cache_free(GlyphCacheBLF *gc)
       blf_glyph_free(g);
     }
   }
-  if (gc->texture) {
-    GPU_texture_free(gc->texture);
+  MEM_freeN(gc);
+}
+
+void blf_glyph_atlas_free(GlyphAtlasBLF *atlas)
+{
+  if (atlas->texture) {
+    GPU_texture_free(atlas->texture);
   }
-  if (gc->bitmap_result) {
-    MEM_freeN(gc->bitmap_result);
+  if (atlas->bitmap_result) {
+    MEM_freeN(atlas->bitmap_result);
   }
-  MEM_freeN(gc);
+  memset(atlas, 0, sizeof(*atlas));
 }
 
 GlyphBLF *blf_glyph_search(GlyphCacheBLF *gc, unsigned int c)
@@ -487,35 +501,40 @@ void blf_glyph_render(FontBLF *font, GlyphCacheBLF *gc, GlyphBLF *g, float x, fl
     return;
   }
 
+  GlyphAtlasBLF *atlas = &font->atlas;
+
   if (g->glyph_cache == NULL) {
     if (font->tex_size_max == -1) {
       font->tex_size_max = GPU_max_texture_size();
     }
 
-    g->offset = gc->bitmap_len;
+    g->offset = atlas->bitmap_len;
 
     int buff_size = g->dims[0] * g->dims[1];
-    int bitmap_len = gc->bitmap_len + buff_size;
+    int bitmap_len = atlas->bitmap_len + buff_size;
 
-    if (bitmap_len > gc->bitmap_len_alloc) {
+    if (bitmap_len > atlas->bitmap_len_alloc) {
       int w = font->tex_size_max;
-      int h = bitmap_len / w + 1;
+      /* Grow geometrically, since all glyphs are uploaded again to the new texture. */
+      const int h_grow = MIN2(2 * (atlas->bitmap_len_alloc / w), font->tex_size_max);
+      const int h = MAX2(bitmap_len / w + 1, h_grow);
 
-      gc->bitmap_len_alloc = w * h;
-      gc->bitmap_result = MEM_reallocN(gc->bitmap_result, (size_t)gc->bitmap_len_alloc);
+      atlas->bitmap_len_alloc = w * h;
+      atlas->bitmap_result = MEM_reallocN(atlas->bitmap_result,
+                                          (size_t)atlas->bitmap_len_alloc);
 
       /* Keep in sync with the texture. */
-      if (gc->texture) {
-        GPU_texture_free(gc->texture);
+      if (atlas->texture) {
+        GPU_texture_free(atlas->texture);
       }
-      gc->texture = GPU_texture_create_nD(
+      atlas->texture = GPU_texture_create_nD(
           w, h, 0, 1, NULL, GPU_R8, GPU_DATA_UNSIGNED_BYTE, 0, false, NULL);
 
-      gc->bitmap_len_landed = 0;
+      atlas->bitmap_len_landed = 0;
     }
 
-    memcpy(&gc->bitmap_result[gc->bitmap_len], g->bitmap, (size_t)buff_size);
-    gc->bitmap_len = bitmap_len;
+    memcpy(&atlas->bitmap_result[atlas->bitmap_len], g->bitmap, (size_t)buff_size);
+    atlas->bitmap_len = bitmap_len;
 
     gc->glyphs_len_free--;
     g->glyph_cache = gc;
@@ -531,9 +550,9 @@ void blf_glyph_render(FontBLF *font, GlyphCacheBLF *gc, GlyphBLF *g, float x, fl
     }
   }
 
-  if (g_batch.glyph_cache != g->glyph_cache) {
+  if (g_batch.atlas != atlas) {
     blf_batch_draw();
-    g_batch.glyph_cache = g->glyph_cache;
+    g_batch.atlas = atlas;
   }
 
   if (font->flags & BLF_SHADOW) {
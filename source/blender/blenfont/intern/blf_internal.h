@@ -25,6 +25,7 @@
 #define __BLF_INTERNAL_H__
 
 struct FontBLF;
+struct GlyphAtlasBLF;
 struct GlyphBLF;
 struct GlyphCacheBLF;
 struct ResultBLF;
@@ -131,6 +132,7 @@ struct GlyphCacheBLF *blf_glyph_cache_acquire(struct FontBLF *font);
 void blf_glyph_cache_release(struct FontBLF *font);
 void blf_glyph_cache_clear(struct FontBLF *font);
 void blf_glyph_cache_free(struct GlyphCacheBLF *gc);
+void blf_glyph_atlas_free(struct GlyphAtlasBLF *atlas);
 
 struct GlyphBLF *blf_glyph_search(struct GlyphCacheBLF *gc, unsigned int c);
 struct GlyphBLF *blf_glyph_add(struct FontBLF *font,
@@ -39,7 +39,7 @@ typedef struct BatchBLF {
   float ofs[2];    /* copy of font->pos */
   float mat[4][4]; /* previous call modelmatrix. */
   bool enabled, active, simple_shader;
-  struct GlyphCacheBLF *glyph_cache;
+  struct GlyphAtlasBLF *atlas;
 } BatchBLF;
 
 extern BatchBLF g_batch;
@@ -55,6 +55,17 @@ typedef struct KerningCacheBLF {
   int table[0x80][0x80];
 } KerningCacheBLF;
 
+/* Texture holding the bitmaps of the glyphs of all sizes of a font, so text of different sizes
+ * can be drawn in a single batch. The bitmaps are packed one after the other in rows as wide as
+ * the texture, the text shader finds them from their offset and size. */
+typedef struct GlyphAtlasBLF {
+  GPUTexture *texture;
+  char *bitmap_result;
+  int bitmap_len;
+  int bitmap_len_landed;
+  int bitmap_len_alloc;
+} GlyphAtlasBLF;
+
 typedef struct GlyphCacheBLF {
   struct GlyphCacheBLF *next;
   struct GlyphCacheBLF *prev;
@@ -74,13 +85,6 @@ typedef struct GlyphCacheBLF {
   /* fast ascii lookup */
   struct GlyphBLF *glyph_ascii_table[256];
 
-  /* texture array, to draw the glyphs. */
-  GPUTexture *texture;
-  char *bitmap_result;
-  int bitmap_len;
-  int bitmap_len_landed;
-  int bitmap_len_alloc;
-
   /* and the bigger glyph in the font. */
   int glyph_width_max;
   int glyph_height_max;
@@ -114,7 +118,7 @@ typedef struct GlyphBLF {
   /* avoid conversion to int while drawing */
   int advance_i;
 
-  /* position inside the texture where this glyph is store. */
+  /* position inside the atlas texture where this glyph is store. */
   int offset;
 
   /* Bitmap data, from freetype. Take care that this
@@ -226,6 +230,9 @@ typedef struct FontBLF {
    */
   ListBase cache;
 
+  /* Glyph bitmaps of all caches, to draw the glyphs. */
+  GlyphAtlasBLF atlas;
+
   /* list of kerning cache for this font. */
   ListBase kerning_caches;
 
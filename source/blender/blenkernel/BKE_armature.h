@@ -319,6 +319,11 @@ void BKE_pose_constraints_evaluate(struct Depsgraph *depsgraph,
 
 void BKE_pose_bone_done(struct Depsgraph *depsgraph, struct Object *object, int pchan_index);
 
+void BKE_pose_eval_bone_and_done(struct Depsgraph *depsgraph,
+                                 struct Scene *scene,
+                                 struct Object *object,
+                                 int pchan_index);
+
 void BKE_pose_eval_bbone_segments(struct Depsgraph *depsgraph,
                                   struct Object *object,
                                   int pchan_index);
@@ -384,6 +389,30 @@ void BKE_armature_deform_coords_with_editmesh(const struct Object *ob_arm,
                                               const char *defgrp_name,
                                               struct BMEditMesh *em_target);
 
+/* Free the vertex group weights cached in the mesh runtime. */
+void BKE_armature_deform_weights_free(struct Mesh *mesh);
+
+/**
+ * Armature deformation of a mesh left to the draw manager, stored in the evaluated mesh.
+ * The mesh keeps its undeformed coordinates.
+ */
+typedef struct ArmatureDeformGPU {
+  /** Deform matrix of every vertex group in object space of the mesh. Zero for the vertex
+   * groups without a deforming bone, those are ignored like in #BKE_armature_deform_coords. */
+  float (*defbase_mats)[4][4];
+  int defbase_len;
+} ArmatureDeformGPU;
+
+struct ArmatureDeformGPU *BKE_armature_deform_gpu_create(const struct Object *ob_arm,
+                                                         const struct Object *ob_target,
+                                                         int deformflag,
+                                                         const char *defgrp_name,
+                                                         const struct Mesh *me_target);
+void BKE_armature_deform_gpu_minmax(const struct ArmatureDeformGPU *deform_gpu,
+                                    float r_min[3],
+                                    float r_max[3]);
+void BKE_armature_deform_gpu_free(struct Mesh *mesh);
+
 /** \} */
 
 #ifdef __cplusplus
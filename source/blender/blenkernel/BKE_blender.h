@@ -46,6 +46,8 @@ void BKE_blender_userdef_app_template_data_set_and_free(struct UserDef *userdef)
 
 void BKE_blender_userdef_data_free(struct UserDef *userdef, bool clear_fonts);
 
+void BKE_blender_userdef_memcache_limits_update(void);
+
 /* Blenders' own atexit (avoids leaking) */
 void BKE_blender_atexit_register(void (*func)(void *user_data), void *user_data);
 void BKE_blender_atexit_unregister(void (*func)(void *user_data), const void *user_data);
@@ -260,6 +260,10 @@ bool bvhcache_has_tree(const struct BVHCache *bvh_cache, const BVHTree *tree);
 struct BVHCache *bvhcache_init(void);
 void bvhcache_free(struct BVHCache *bvh_cache);
 
+/* Reuse trees of an evaluated mesh for the next evaluation, when only coordinates changed. */
+struct BVHCache *bvhcache_detach_for_refit(struct Mesh *mesh);
+void bvhcache_attach_for_refit(struct Mesh *mesh, struct BVHCache *bvh_cache);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,7 @@
 extern "C" {
 #endif
 
+struct BMHeader;
 struct BMesh;
 struct CustomData;
 struct CustomData_MeshMasks;
@@ -73,6 +74,12 @@ typedef enum eCDAllocType {
   CD_REFERENCE = 3,
   /** Do a full copy of all layers, only allowed if source has same number of elements. */
   CD_DUPLICATE = 4,
+  /**
+   * Share the data of all layers that own it and don't store pointers to other allocations
+   * (the others are duplicated). The data is only freed by its last user, so it must be made
+   * mutable with #CustomData_duplicate_referenced_layer before it can be modified.
+   */
+  CD_SHARE = 5,
 } eCDAllocType;
 
 #define CD_TYPE_AS_MASK(_type) (CustomDataMask)((CustomDataMask)1 << (CustomDataMask)(_type))
@@ -104,7 +111,7 @@ bool CustomData_has_interp(const struct CustomData *data);
 bool CustomData_bmesh_has_free(const struct CustomData *data);
 
 /**
- * Checks if any of the customdata layers is referenced.
+ * Checks if any of the customdata layers is referenced (or shared).
  */
 bool CustomData_has_referenced(const struct CustomData *data);
 
@@ -217,8 +224,8 @@ bool CustomData_has_layer(const struct CustomData *data, int type);
 int CustomData_number_of_layers(const struct CustomData *data, int type);
 int CustomData_number_of_layers_typemask(const struct CustomData *data, CustomDataMask mask);
 
-/* duplicate data of a layer with flag NOFREE, and remove that flag.
- * returns the layer data */
+/* duplicate data of a layer with flag NOFREE (or data shared with other layers),
+ * and remove that flag. returns the layer data */
 void *CustomData_duplicate_referenced_layer(struct CustomData *data,
                                             const int type,
                                             const int totelem);
@@ -231,6 +238,10 @@ void *CustomData_duplicate_referenced_layer_named(struct CustomData *data,
                                                   const char *name,
                                                   const int totelem);
 bool CustomData_is_referenced_layer(struct CustomData *data, int type);
+void CustomData_keep_unchanged_layers(struct CustomData *data,
+                                      struct CustomData *data_old,
+                                      const int totelem,
+                                      const int totelem_old);
 
 /* set the CD_FLAG_NOCOPY flag in custom data layers where the mask is
  * zero for the layer type, so only layer types specified by the mask
@@ -412,6 +423,15 @@ void CustomData_from_bmesh_block(const struct CustomData *source,
                                  struct CustomData *dest,
                                  void *src_block,
                                  int dest_index);
+void CustomData_to_bmesh_blocks(const struct CustomData *source,
+                                struct CustomData *dest,
+                                struct BMHeader *const *elems,
+                                const int totelem,
+                                bool use_default_init);
+void CustomData_from_bmesh_blocks(const struct CustomData *source,
+                                  struct CustomData *dest,
+                                  void *const *src_blocks,
+                                  const int totelem);
 
 void CustomData_file_write_prepare(struct CustomData *data,
                                    struct CustomDataLayer **r_write_layers,
@@ -30,6 +30,7 @@
 extern "C" {
 #endif
 
+struct DataTransferGeomMapCache;
 struct Depsgraph;
 struct Object;
 struct ReportList;
@@ -176,8 +177,13 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                  const float mix_factor,
                                  const char *vgroup_name,
                                  const bool invert_vgroup,
+                                 struct DataTransferGeomMapCache *geom_map_cache,
                                  struct ReportList *reports);
 
+/* Geometry mappings kept between transfers, only recomputed when their inputs change. */
+struct DataTransferGeomMapCache *BKE_object_data_transfer_geom_map_cache_new(void);
+void BKE_object_data_transfer_geom_map_cache_free(struct DataTransferGeomMapCache *cache);
+
 #ifdef __cplusplus
 }
 #endif
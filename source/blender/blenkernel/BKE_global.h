@@ -57,6 +57,9 @@ typedef struct Global {
 
   bool background;
   bool factory_startup;
+  /** Skip UI-only initialization and defer add-ons in background mode,
+   * see `--background-fast-start`. */
+  bool background_fast_start;
 
   short moving;
 
@@ -157,7 +160,8 @@ enum {
   G_DEBUG_XR = (1 << 21),                    /* XR/OpenXR messages */
   G_DEBUG_XR_TIME = (1 << 22),               /* XR/OpenXR timing messages */
 
-  G_DEBUG_GHOST = (1 << 23), /* Debug GHOST module. */
+  G_DEBUG_GHOST = (1 << 23),       /* Debug GHOST module. */
+  G_DEBUG_GPU_TIMINGS = (1 << 24), /* Record GPU timings of the draw passes. */
 };
 
 #define G_DEBUG_ALL \
@@ -43,6 +43,7 @@ struct RenderResult;
 struct ReportList;
 struct Scene;
 struct StampData;
+struct ViewLayer;
 struct anim;
 
 #define IMA_MAX_SPACE 64
@@ -187,6 +188,8 @@ struct ImBuf *BKE_image_pool_acquire_ibuf(struct Image *ima,
                                           struct ImagePool *pool);
 void BKE_image_pool_release_ibuf(struct Image *ima, struct ImBuf *ibuf, struct ImagePool *pool);
 
+void BKE_image_preload_view_layer(struct Scene *scene, struct ViewLayer *view_layer);
+
 /* set an alpha mode based on file extension */
 char BKE_image_alpha_mode_from_extension_ex(const char *filepath);
 void BKE_image_alpha_mode_from_extension(struct Image *image);
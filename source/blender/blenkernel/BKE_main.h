@@ -52,6 +52,7 @@ struct GSet;
 struct ImBuf;
 struct Library;
 struct MainLock;
+struct MainNameMap;
 
 /* Blender thumbnail, as written on file (width, height, and data as char RGBA). */
 /* We pack pixel data after that struct. */
@@ -82,6 +83,10 @@ typedef struct MainIDRelations {
 enum {
   /* Those bmain relations include pointers/usages from editors. */
   MAINIDRELATIONS_INCLUDE_UI = 1 << 0,
+  /* ID pointers were remapped while those relations existed. The users stored in
+   * `id_used_to_user` are kept up to date, but the pointers stored in `id_user_to_used` may be
+   * outdated (the data owning them may have been reallocated). */
+  MAINIDRELATIONS_USED_TO_USER_ONLY = 1 << 1,
 };
 
 typedef struct Main {
@@ -162,6 +167,9 @@ typedef struct Main {
    */
   struct MainIDRelations *relations;
 
+  /** Names of local IDs, maintained by the ID management code, see BKE_main_namemap.h. */
+  struct MainNameMap *name_map;
+
   struct MainLock *lock;
 } Main;
 
@@ -174,6 +182,11 @@ void BKE_main_unlock(struct Main *bmain);
 void BKE_main_relations_create(struct Main *bmain, const short flag);
 void BKE_main_relations_free(struct Main *bmain);
 void BKE_main_relations_ID_remove(struct Main *bmain, struct ID *id);
+void BKE_main_relations_ID_user_add(struct Main *bmain,
+                                    struct ID *id_used,
+                                    struct ID *id_user,
+                                    const int usage_flag);
+struct ID *BKE_main_relations_ID_owner_get(struct Main *bmain, struct ID *id);
 
 struct GSet *BKE_main_gset_create(struct Main *bmain, struct GSet *gset);
 
@@ -0,0 +1,66 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef __BKE_MAIN_NAMEMAP_H__
+#define __BKE_MAIN_NAMEMAP_H__
+
+/** \file
+ * \ingroup bke
+ *
+ * Persistent mapping from the names of local IDs to the IDs, stored in their Main data-base.
+ *
+ * Unlike #BKE_main_idmap_create, the map is kept up to date when IDs are added, renamed or
+ * removed through the regular ID management API, which makes name lookups and unique name
+ * generation independent of the number of IDs of a given type.
+ *
+ * The map of an ID type is built on first use. Code moving IDs in or out of a Main without
+ * going through the ID management API has to call #BKE_main_namemap_clear.
+ *
+ * \section Function Names
+ *
+ * - `BKE_main_namemap_` Should be used for functions in that file.
+ */
+
+#include "BLI_compiler_attrs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ID;
+struct Main;
+
+void BKE_main_namemap_clear(struct Main *bmain) ATTR_NONNULL();
+
+struct ID *BKE_main_namemap_find(struct Main *bmain,
+                                 const short id_type,
+                                 const char *name) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
+void BKE_main_namemap_add(struct Main *bmain, struct ID *id) ATTR_NONNULL();
+void BKE_main_namemap_remove(struct Main *bmain, struct ID *id) ATTR_NONNULL();
+
+int BKE_main_namemap_number_hint_get(struct Main *bmain,
+                                     const short id_type,
+                                     const char *base_name) ATTR_WARN_UNUSED_RESULT
+    ATTR_NONNULL();
+void BKE_main_namemap_number_hint_set(struct Main *bmain,
+                                      const short id_type,
+                                      const char *base_name,
+                                      const int number) ATTR_NONNULL();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BKE_MAIN_NAMEMAP_H__ */
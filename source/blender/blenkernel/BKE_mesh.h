@@ -53,6 +53,7 @@ struct MVert;
 struct Main;
 struct MemArena;
 struct Mesh;
+struct MeshBatchCacheDeform;
 struct ModifierData;
 struct Object;
 struct Scene;
@@ -125,6 +126,9 @@ void BKE_mesh_eval_delete(struct Mesh *me_eval);
 /* Performs copy for use during evaluation,
  * optional referencing original arrays to reduce memory. */
 struct Mesh *BKE_mesh_copy_for_eval(struct Mesh *source, bool reference);
+/* Performs copy for use during evaluation, sharing the arrays with the source until they are
+ * made mutable with #CustomData_duplicate_referenced_layer (the source remains valid to free). */
+struct Mesh *BKE_mesh_copy_for_eval_shared(struct Mesh *source);
 
 /* These functions construct a new Mesh,
  * contrary to BKE_mesh_from_nurbs which modifies ob itself. */
@@ -684,10 +688,18 @@ enum {
   BKE_MESH_BATCH_DIRTY_SHADING,
   BKE_MESH_BATCH_DIRTY_UVEDIT_ALL,
   BKE_MESH_BATCH_DIRTY_UVEDIT_SELECT,
+  /* Only vertex coordinates (and therefore normals) changed. */
+  BKE_MESH_BATCH_DIRTY_DEFORM,
 };
 void BKE_mesh_batch_cache_dirty_tag(struct Mesh *me, int mode);
 void BKE_mesh_batch_cache_free(struct Mesh *me);
 
+bool BKE_mesh_data_hash_except_coords(const struct Mesh *me, uint *r_hash);
+struct MeshBatchCacheDeform *BKE_mesh_batch_cache_detach_for_deform(struct Mesh *me);
+void BKE_mesh_batch_cache_attach_for_deform(struct Mesh *me,
+                                            struct MeshBatchCacheDeform *deform_cache,
+                                            const bool input_changed);
+
 extern void (*BKE_mesh_batch_cache_dirty_tag_cb)(struct Mesh *me, int mode);
 extern void (*BKE_mesh_batch_cache_free_cb)(struct Mesh *me);
 
@@ -143,6 +143,9 @@ typedef enum ModifierApplyFlag {
    * This flag can be checked to ignore rendering display data to the mesh.
    * See `OBJECT_OT_modifier_apply` operator. */
   MOD_APPLY_TO_BASE_MESH = 1 << 4,
+  /** Only the drawn positions and normals of the result need to be correct, so they may be
+   * evaluated when drawing (used by subsurf, see #SubdivMeshStencils). */
+  MOD_APPLY_GPU_SUBDIVISION = 1 << 5,
 } ModifierApplyFlag;
 
 typedef struct ModifierUpdateDepsgraphContext {
@@ -166,6 +166,8 @@ typedef struct ParticleThreadContext {
 
   /* path caching */
   bool editupdate;
+  /* Child path cache buffers are reused and cleared per child instead of reallocated. */
+  bool clear_child_cache;
   int between, segments, extra_segments;
   int totchild, totparent, parent_pass;
 
@@ -621,6 +623,9 @@ void BKE_particle_system_eval_init(struct Depsgraph *depsgraph, struct Object *o
 /* Draw Cache */
 enum {
   BKE_PARTICLE_BATCH_DIRTY_ALL = 0,
+  /* Only the paths changed (e.g. on frame change), the strands and their segments count are
+   * expected to be unchanged. */
+  BKE_PARTICLE_BATCH_DIRTY_POS = 1,
 };
 void BKE_particle_batch_cache_dirty_tag(struct ParticleSystem *psys, int mode);
 void BKE_particle_batch_cache_free(struct ParticleSystem *psys);
@@ -89,6 +89,7 @@ void BKE_sequence_iterator_end(SeqIterator *iter);
 
 typedef enum eSeqTaskId {
   SEQ_TASK_MAIN_RENDER,
+  /* Prefetch workers use this ID plus their index. */
   SEQ_TASK_PREFETCH_RENDER,
 } eSeqTaskId;
 
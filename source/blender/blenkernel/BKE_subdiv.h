@@ -185,6 +185,11 @@ typedef struct Subdiv {
   struct SubdivDisplacement *displacement_evaluator;
   /* Statistics for debugging. */
   SubdivStats stats;
+  /* Hash of the mesh topology this subdivision surface was created for, only set when created
+   * by BKE_subdiv_update_from_mesh(). Allows to skip the comparison of the topology refiner with
+   * the mesh when the topology did not change. */
+  uint topology_hash;
+  bool has_topology_hash;
 
   /* Cached values, are not supposed to be accessed directly. */
   struct {
@@ -241,6 +246,8 @@ Subdiv *BKE_subdiv_new_from_mesh(const SubdivSettings *settings, const struct Me
 Subdiv *BKE_subdiv_update_from_converter(Subdiv *subdiv,
                                          const SubdivSettings *settings,
                                          struct OpenSubdiv_Converter *converter);
+/* Topology of the mesh is compared by hash first, so deforming meshes don't have to be converted
+ * and compared with the existing topology refiner on every update. */
 Subdiv *BKE_subdiv_update_from_mesh(Subdiv *subdiv,
                                     const SubdivSettings *settings,
                                     const struct Mesh *mesh);
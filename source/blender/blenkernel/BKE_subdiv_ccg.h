@@ -195,6 +195,7 @@ typedef struct SubdivCCG {
   SubdivCCGAdjacentVertex *adjacent_vertices;
 
   struct DMFlagMat *grid_flag_mats;
+  /* Hidden elements of every grid, NULL for grids without any hidden element. */
   BLI_bitmap **grid_hidden;
 
   /* TODO(sergey): Consider adding some accessors to a "decoded" geometry,
@@ -31,6 +31,7 @@ extern "C" {
 #endif
 
 struct Mesh;
+struct OpenSubdiv_LimitStencils;
 struct Subdiv;
 
 typedef struct SubdivToMeshSettings {
@@ -50,6 +51,56 @@ struct Mesh *BKE_subdiv_to_mesh(struct Subdiv *subdiv,
                                 const SubdivToMeshSettings *settings,
                                 const struct Mesh *coarse_mesh);
 
+/* Subdivided mesh whose vertex positions and normals are evaluated when drawing, from the
+ * positions of the coarse vertices. Used as long as the topology and the other data of the
+ * coarse mesh don't change. */
+typedef struct SubdivMeshStencils {
+  /* Mesh created by #BKE_subdiv_to_mesh, its vertex positions are the ones of its creation.
+   * Evaluated meshes share its data. */
+  struct Mesh *mesh;
+  int num_coarse_vertices;
+  /* Limit stencil of every vertex of the mesh: the weights of coarse vertices giving the
+   * position and the derivatives along both directions of a ptex face. */
+  int num_elements;
+  /* First element and number of elements of every stencil. */
+  const int *offsets;
+  const int *sizes;
+  /* Coarse vertex and weights of every element. */
+  const int *indices;
+  const float *weights;
+  const float *du_weights;
+  const float *dv_weights;
+  /* Unique for every created stencils, used by draw caches to detect changes. */
+  uint session_uuid;
+  /* The owner and every #SubdivMeshGPU. */
+  int users;
+  struct OpenSubdiv_LimitStencils *limit_stencils;
+} SubdivMeshStencils;
+
+/* Subdivision of a mesh done when drawing, see #Mesh_Runtime.subdiv_gpu. */
+typedef struct SubdivMeshGPU {
+  SubdivMeshStencils *stencils;
+  /* Positions of the coarse vertices. */
+  float (*coarse_coords)[3];
+} SubdivMeshGPU;
+
+/* Create stencils for a mesh created by #BKE_subdiv_to_mesh.
+ * Returns NULL when the subdivided vertices can't all be evaluated from limit stencils,
+ * for example for loose geometry. */
+struct SubdivMeshStencils *BKE_subdiv_mesh_stencils_create(struct Subdiv *subdiv,
+                                                           const SubdivToMeshSettings *settings,
+                                                           const struct Mesh *coarse_mesh,
+                                                           struct Mesh *subdiv_mesh);
+void BKE_subdiv_mesh_stencils_free(struct SubdivMeshStencils *stencils);
+
+/* Create a subdivided mesh for new positions of the coarse vertices, with the data of the
+ * stencils mesh. Only the final positions and normals drawn are correct. */
+struct Mesh *BKE_subdiv_mesh_gpu_create(struct SubdivMeshStencils *stencils,
+                                        const struct Mesh *coarse_mesh);
+/* Extend bounds to contain the subdivided mesh, which is inside of the coarse vertices hull. */
+void BKE_subdiv_mesh_gpu_minmax(const SubdivMeshGPU *subdiv_gpu, float r_min[3], float r_max[3]);
+void BKE_subdiv_mesh_gpu_free(struct Mesh *mesh);
+
 #ifdef __cplusplus
 }
 #endif
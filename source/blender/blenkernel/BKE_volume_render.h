@@ -48,6 +48,12 @@ void BKE_volume_grid_dense_voxels(const struct Volume *volume,
                                   const int64_t min[3],
                                   const int64_t max[3],
                                   float *voxels);
+void BKE_volume_grid_dense_voxels_downsampled(const struct Volume *volume,
+                                              struct VolumeGrid *volume_grid,
+                                              const int64_t min[3],
+                                              const int64_t max[3],
+                                              const int factor,
+                                              float *voxels);
 
 /* Wireframe */
 
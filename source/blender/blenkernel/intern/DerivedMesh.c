@@ -32,8 +32,10 @@
 #include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BLI_array.h"
 #include "BLI_bitmap.h"
@@ -44,6 +46,7 @@
 #include "BLI_utildefines.h"
 
 #include "BKE_DerivedMesh.h"
+#include "BKE_armature.h"
 #include "BKE_bvhutils.h"
 #include "BKE_colorband.h"
 #include "BKE_deform.h"
@@ -67,6 +70,7 @@
 #include "BLI_sys_types.h" /* for intptr_t support */
 
 #include "BKE_shrinkwrap.h"
+#include "BKE_subdiv_mesh.h"
 #include "DEG_depsgraph.h"
 #include "DEG_depsgraph_query.h"
 
@@ -799,6 +803,7 @@ static void mesh_calc_modifier_final_normals(const Mesh *mesh_input,
     if (!CustomData_has_layer(&mesh_final->pdata, CD_NORMAL)) {
       float(*polynors)[3] = CustomData_add_layer(
           &mesh_final->pdata, CD_NORMAL, CD_CALLOC, NULL, mesh_final->totpoly);
+      /* Vertex normals are computed along with them, unless they are still valid. */
       BKE_mesh_calc_normals_poly(mesh_final->mvert,
                                  NULL,
                                  mesh_final->totvert,
@@ -807,7 +812,8 @@ static void mesh_calc_modifier_final_normals(const Mesh *mesh_input,
                                  mesh_final->totloop,
                                  mesh_final->totpoly,
                                  polynors,
-                                 false);
+                                 (mesh_final->runtime.cd_dirty_vert & CD_MASK_NORMAL) == 0);
+      mesh_final->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
     }
   }
 
@@ -869,6 +875,108 @@ void BKE_mesh_wrapper_deferred_finalize(Mesh *me_eval,
   BLI_assert(me_eval->runtime.wrapper_type_finalize == 0);
 }
 
+/**
+ * Find the armature modifier whose deformation can be left to the draw manager, when enabled in
+ * the experimental preferences. Only done for the interactive evaluation of objects in object
+ * mode, when the armature is the last of a stack of deform modifiers and the normals drawn are
+ * the vertex normals, which are deformed along with the positions.
+ */
+static ModifierData *mesh_armature_deform_gpu_modifier_get(struct Depsgraph *depsgraph,
+                                                           Scene *scene,
+                                                           Object *ob,
+                                                           ModifierData *firstmd,
+                                                           const CustomData_MeshMasks *dataMask)
+{
+#ifdef __APPLE__
+  /* Transform feedback is not used for drawing on macOS, see 'draw_mesh_deform.c'. */
+  UNUSED_VARS(depsgraph, scene, ob, firstmd, dataMask);
+  return NULL;
+#else
+  const Mesh *mesh_input = ob->data;
+
+  if (!USER_EXPERIMENTAL_TEST(&U, use_gpu_mesh_deform) ||
+      !USER_EXPERIMENTAL_TEST(&U, use_gpu_armature_deform)) {
+    return NULL;
+  }
+  if (!DEG_is_active(depsgraph) || ob->mode != OB_MODE_OBJECT || ob->particlesystem.first) {
+    return NULL;
+  }
+  if ((scene->r.perf_flag & SCE_PERF_HQ_NORMALS) || (mesh_input->flag & ME_AUTOSMOOTH) ||
+      (dataMask->lmask & CD_MASK_NORMAL)) {
+    return NULL;
+  }
+
+  ModifierData *md_last = NULL;
+  for (ModifierData *md = firstmd; md; md = md->next) {
+    if (!BKE_modifier_is_enabled(scene, md, eModifierMode_Realtime)) {
+      continue;
+    }
+    if (BKE_modifier_get_info(md->type)->type != eModifierTypeType_OnlyDeform) {
+      return NULL;
+    }
+    md_last = md;
+  }
+  if (md_last == NULL || md_last->type != eModifierType_Armature ||
+      ((ArmatureModifierData *)md_last)->multi) {
+    return NULL;
+  }
+
+  /* Flat faces use the face normals, which are not deformed. */
+  const MPoly *mp = mesh_input->mpoly;
+  for (int i = 0; i < mesh_input->totpoly; i++, mp++) {
+    if ((mp->flag & ME_SMOOTH) == 0) {
+      return NULL;
+    }
+  }
+
+  return md_last;
+#endif
+}
+
+/**
+ * Find the subdivision surface modifier whose vertex positions and normals can be evaluated by
+ * the draw manager, when enabled in the experimental preferences. Only done for the interactive
+ * evaluation of objects in object mode when it is the last modifier, and the normals drawn are
+ * the vertex normals. See #MOD_APPLY_GPU_SUBDIVISION.
+ */
+static ModifierData *mesh_subdiv_gpu_modifier_get(struct Depsgraph *depsgraph,
+                                                  Scene *scene,
+                                                  Object *ob,
+                                                  ModifierData *firstmd,
+                                                  const CustomData_MeshMasks *dataMask)
+{
+#ifdef __APPLE__
+  /* Transform feedback is not used for drawing on macOS, see 'draw_mesh_deform.c'. */
+  UNUSED_VARS(depsgraph, scene, ob, firstmd, dataMask);
+  return NULL;
+#else
+  const Mesh *mesh_input = ob->data;
+
+  if (!USER_EXPERIMENTAL_TEST(&U, use_gpu_mesh_deform) ||
+      !USER_EXPERIMENTAL_TEST(&U, use_gpu_subdivision)) {
+    return NULL;
+  }
+  if (!DEG_is_active(depsgraph) || ob->mode != OB_MODE_OBJECT || ob->particlesystem.first) {
+    return NULL;
+  }
+  if ((scene->r.perf_flag & SCE_PERF_HQ_NORMALS) || (mesh_input->flag & ME_AUTOSMOOTH) ||
+      (dataMask->lmask & CD_MASK_NORMAL)) {
+    return NULL;
+  }
+
+  ModifierData *md_last = NULL;
+  for (ModifierData *md = firstmd; md; md = md->next) {
+    if (BKE_modifier_is_enabled(scene, md, eModifierMode_Realtime)) {
+      md_last = md;
+    }
+  }
+  if (md_last == NULL || md_last->type != eModifierType_Subsurf) {
+    return NULL;
+  }
+  return md_last;
+#endif
+}
+
 static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
                                 Scene *scene,
                                 Object *ob,
@@ -919,6 +1027,8 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
   ModifierApplyFlag apply_render = use_render ? MOD_APPLY_RENDER : 0;
   ModifierApplyFlag apply_cache = use_cache ? MOD_APPLY_USECACHE : 0;
   const ModifierEvalContext mectx = {depsgraph, ob, apply_render | apply_cache};
+  const ModifierEvalContext mectx_subdiv_gpu = {
+      depsgraph, ob, apply_render | apply_cache | MOD_APPLY_GPU_SUBDIVISION};
   const ModifierEvalContext mectx_orco = {depsgraph, ob, apply_render | MOD_APPLY_ORCO};
 
   /* Get effective list of modifiers to execute. Some effects like shape keys
@@ -955,6 +1065,17 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
   /* Clear errors before evaluation. */
   BKE_modifiers_clear_errors(ob);
 
+  /* Armature deformation done when drawing, see #BKE_armature_deform_gpu_create. */
+  ModifierData *md_deform_gpu = NULL;
+  ArmatureDeformGPU *armature_deform_gpu = NULL;
+  /* Subdivision done when drawing, see #MOD_APPLY_GPU_SUBDIVISION. */
+  ModifierData *md_subdiv_gpu = NULL;
+  if (use_cache && !use_render && !need_mapping && index == -1 && useDeform > 0) {
+    md_deform_gpu = mesh_armature_deform_gpu_modifier_get(
+        depsgraph, scene, ob, firstmd, &final_datamask);
+    md_subdiv_gpu = mesh_subdiv_gpu_modifier_get(depsgraph, scene, ob, firstmd, &final_datamask);
+  }
+
   /* Apply all leading deform modifiers. */
   if (useDeform) {
     for (; md; md = md->next, md_datamask = md_datamask->next) {
@@ -968,6 +1089,16 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
         continue;
       }
 
+      if (md == md_deform_gpu) {
+        ArmatureModifierData *amd = (ArmatureModifierData *)md;
+        armature_deform_gpu = BKE_armature_deform_gpu_create(
+            amd->object, ob, amd->deformflag, amd->defgrp_name, mesh_input);
+        if (armature_deform_gpu) {
+          isPrevDeform = true;
+          continue;
+        }
+      }
+
       if (mti->type == eModifierTypeType_OnlyDeform && !sculpt_dyntopo) {
         if (!deformed_verts) {
           deformed_verts = BKE_mesh_vert_coords_alloc(mesh_input, &num_deformed_verts);
@@ -1182,7 +1313,8 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
         }
       }
 
-      Mesh *mesh_next = BKE_modifier_modify_mesh(md, &mectx, mesh_final);
+      Mesh *mesh_next = BKE_modifier_modify_mesh(
+          md, (md == md_subdiv_gpu) ? &mectx_subdiv_gpu : &mectx, mesh_final);
       ASSERT_IS_VALID_MESH(mesh_next);
 
       if (mesh_next) {
@@ -1292,7 +1424,7 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
     /* Note: this check on cdmask is a bit dodgy, it handles the issue at stake here (see T68211),
      * but other cases might require similar handling?
      * Could be a good idea to define a proper CustomData_MeshMask for that then. */
-    if (deformed_verts == NULL && allow_shared_mesh &&
+    if (deformed_verts == NULL && allow_shared_mesh && armature_deform_gpu == NULL &&
         (final_datamask.lmask & CD_MASK_NORMAL) == 0 &&
         (final_datamask.pmask & CD_MASK_NORMAL) == 0) {
       mesh_final = mesh_input;
@@ -1311,6 +1443,11 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
    * mesh is shared across multiple objects since there are no effective modifiers. */
   const bool is_own_mesh = (mesh_final != mesh_input);
 
+  if (armature_deform_gpu) {
+    BLI_assert(is_own_mesh);
+    mesh_final->runtime.armature_deform_gpu = armature_deform_gpu;
+  }
+
   /* Add orco coordinates to final and deformed mesh if requested. */
   if (final_datamask.vmask & CD_MASK_ORCO) {
     /* No need in ORCO layer if the mesh was not deformed or modified: undeformed mesh in this case
@@ -1418,6 +1555,7 @@ static void editbmesh_calc_modifier_final_normals(Mesh *mesh_final,
     if (!CustomData_has_layer(&mesh_final->pdata, CD_NORMAL)) {
       float(*polynors)[3] = CustomData_add_layer(
           &mesh_final->pdata, CD_NORMAL, CD_CALLOC, NULL, mesh_final->totpoly);
+      /* Vertex normals are computed along with them, unless they are still valid. */
       BKE_mesh_calc_normals_poly(mesh_final->mvert,
                                  NULL,
                                  mesh_final->totvert,
@@ -1426,7 +1564,8 @@ static void editbmesh_calc_modifier_final_normals(Mesh *mesh_final,
                                  mesh_final->totloop,
                                  mesh_final->totpoly,
                                  polynors,
-                                 false);
+                                 (mesh_final->runtime.cd_dirty_vert & CD_MASK_NORMAL) == 0);
+      mesh_final->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
     }
   }
 
@@ -1572,7 +1711,10 @@ static void editbmesh_calc_modifiers(struct Depsgraph *depsgraph,
       /* apply vertex coordinates or build a DerivedMesh as necessary */
       if (mesh_final) {
         if (deformed_verts) {
-          Mesh *mesh_tmp = BKE_mesh_copy_for_eval(mesh_final, false);
+          /* Arrays can only be shared with the cage when no more modifiers run on them. */
+          Mesh *mesh_tmp = (mesh_final != mesh_cage) ?
+                               BKE_mesh_copy_for_eval_shared(mesh_final) :
+                               BKE_mesh_copy_for_eval(mesh_final, false);
           if (mesh_final != mesh_cage) {
             BKE_id_free(NULL, mesh_final);
           }
@@ -1685,7 +1827,7 @@ static void editbmesh_calc_modifiers(struct Depsgraph *depsgraph,
    * then we need to build one. */
   if (mesh_final) {
     if (deformed_verts) {
-      Mesh *mesh_tmp = BKE_mesh_copy_for_eval(mesh_final, false);
+      Mesh *mesh_tmp = BKE_mesh_copy_for_eval_shared(mesh_final);
       if (mesh_final != mesh_cage) {
         BKE_id_free(NULL, mesh_final);
       }
@@ -1767,6 +1909,16 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
    * they aren't cleaned up properly on mode switch, causing crashes, e.g T58150. */
   BLI_assert(ob->id.tag & LIB_TAG_COPIED_ON_WRITE);
 
+  /* Keep the BVH trees of the previous result, they can be refit when only the coordinates
+   * changed (typical for animation playback of deforming meshes). */
+  struct BVHCache *bvh_cache_prev = NULL;
+  /* Same for the GPU buffers which don't depend on the coordinates. */
+  struct MeshBatchCacheDeform *batch_cache_prev = NULL;
+  if (ob->runtime.data_eval && ob->runtime.is_data_eval_owned) {
+    bvh_cache_prev = bvhcache_detach_for_refit((Mesh *)ob->runtime.data_eval);
+    batch_cache_prev = BKE_mesh_batch_cache_detach_for_deform((Mesh *)ob->runtime.data_eval);
+  }
+
   BKE_object_free_derived_caches(ob);
   if (DEG_is_active(depsgraph)) {
     BKE_sculpt_update_object_before_eval(ob);
@@ -1804,11 +1956,43 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
   const bool is_mesh_eval_owned = (mesh_eval != mesh->runtime.mesh_eval);
   BKE_object_eval_assign_data(ob, &mesh_eval->id, is_mesh_eval_owned);
 
+  if (bvh_cache_prev) {
+    if (is_mesh_eval_owned) {
+      bvhcache_attach_for_refit(mesh_eval, bvh_cache_prev);
+    }
+    else {
+      bvhcache_free(bvh_cache_prev);
+    }
+  }
+  if (batch_cache_prev) {
+    /* Layers referenced from the input mesh can only be compared when it wasn't updated. */
+    const bool input_changed = (mesh->id.recalc & ID_RECALC_ALL) != 0;
+    BKE_mesh_batch_cache_attach_for_deform(
+        mesh_eval, batch_cache_prev, input_changed || !is_mesh_eval_owned);
+  }
+
   ob->runtime.mesh_deform_eval = mesh_deform_eval;
   ob->runtime.last_data_mask = *dataMask;
   ob->runtime.last_need_mapping = need_mapping;
 
   BKE_object_boundbox_calc_from_mesh(ob, mesh_eval);
+  if (mesh_eval->runtime.armature_deform_gpu) {
+    /* The vertices are only deformed when drawing, for culling the bounds have to contain
+     * the deformed mesh. */
+    float min[3], max[3];
+    copy_v3_v3(min, ob->runtime.bb->vec[0]);
+    copy_v3_v3(max, ob->runtime.bb->vec[6]);
+    BKE_armature_deform_gpu_minmax(mesh_eval->runtime.armature_deform_gpu, min, max);
+    BKE_boundbox_init_from_minmax(ob->runtime.bb, min, max);
+  }
+  else if (mesh_eval->runtime.subdiv_gpu) {
+    /* Same for the vertices only subdivided when drawing. */
+    float min[3], max[3];
+    copy_v3_v3(min, ob->runtime.bb->vec[0]);
+    copy_v3_v3(max, ob->runtime.bb->vec[6]);
+    BKE_subdiv_mesh_gpu_minmax(mesh_eval->runtime.subdiv_gpu, min, max);
+    BKE_boundbox_init_from_minmax(ob->runtime.bb, min, max);
+  }
 
   if ((ob->mode & OB_MODE_ALL_SCULPT) && ob->sculpt) {
     if (DEG_is_active(depsgraph)) {
@@ -35,6 +35,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
+#include "BLI_memarena.h"
 #include "BLI_string_utils.h"
 #include "BLI_utildefines.h"
 
@@ -311,6 +312,29 @@ void BKE_keyingsets_free(ListBase *list)
 /* ***************************************** */
 /* Evaluation Data-Setting Backend */
 
+/* Set the array index of an already resolved property, checking it against the array length. */
+static bool animsys_store_rna_setting_index(const PointerRNA *ptr,
+                                            const char *path,
+                                            const int array_index,
+                                            const int array_len,
+                                            PathResolvedRNA *r_result)
+{
+  if (array_len && array_index >= array_len) {
+    if (G.debug & G_DEBUG) {
+      CLOG_WARN(&LOG,
+                "Animato: Invalid array index. ID = '%s',  '%s[%d]', array length is %d",
+                (ptr->owner_id) ? (ptr->owner_id->name + 2) : "<No ID>",
+                path,
+                array_index,
+                array_len - 1);
+    }
+    return false;
+  }
+
+  r_result->prop_index = array_len ? array_index : -1;
+  return true;
+}
+
 bool BKE_animsys_store_rna_setting(PointerRNA *ptr,
                                    /* typically 'fcu->rna_path', 'fcu->array_index' */
                                    const char *rna_path,
@@ -326,21 +350,7 @@ bool BKE_animsys_store_rna_setting(PointerRNA *ptr,
     if (RNA_path_resolve_property(ptr, path, &r_result->ptr, &r_result->prop)) {
       if ((ptr->owner_id == NULL) || RNA_property_animateable(&r_result->ptr, r_result->prop)) {
         int array_len = RNA_property_array_length(&r_result->ptr, r_result->prop);
-
-        if (array_len && array_index >= array_len) {
-          if (G.debug & G_DEBUG) {
-            CLOG_WARN(&LOG,
-                      "Animato: Invalid array index. ID = '%s',  '%s[%d]', array length is %d",
-                      (ptr->owner_id) ? (ptr->owner_id->name + 2) : "<No ID>",
-                      path,
-                      array_index,
-                      array_len - 1);
-          }
-        }
-        else {
-          r_result->prop_index = array_len ? array_index : -1;
-          success = true;
-        }
+        success = animsys_store_rna_setting_index(ptr, path, array_index, array_len, r_result);
       }
     }
     else {
@@ -531,6 +541,57 @@ static void animsys_write_orig_anim_rna(PointerRNA *ptr,
   }
 }
 
+/* The last RNA path resolved while evaluating a list of F-Curves. */
+typedef struct AnimsysPathCache {
+  const char *rna_path;
+  bool is_resolved;
+  PathResolvedRNA anim_rna;
+  int array_len;
+} AnimsysPathCache;
+
+/**
+ * Same as #BKE_animsys_store_rna_setting, but reuses the previous resolution when the path is the
+ * same. Consecutive F-Curves usually animate the items of one array property (location,
+ * rotation...), so this saves most of the path lookups.
+ */
+static bool animsys_store_rna_setting_cached(PointerRNA *ptr,
+                                             const char *rna_path,
+                                             const int array_index,
+                                             AnimsysPathCache *cache,
+                                             PathResolvedRNA *r_result)
+{
+  if (rna_path == NULL) {
+    return false;
+  }
+
+  if (cache->rna_path == NULL || !STREQ(cache->rna_path, rna_path)) {
+    cache->rna_path = rna_path;
+    cache->is_resolved = false;
+
+    PathResolvedRNA *anim_rna = &cache->anim_rna;
+    if (RNA_path_resolve_property(ptr, rna_path, &anim_rna->ptr, &anim_rna->prop)) {
+      if ((ptr->owner_id == NULL) || RNA_property_animateable(&anim_rna->ptr, anim_rna->prop)) {
+        cache->array_len = RNA_property_array_length(&anim_rna->ptr, anim_rna->prop);
+        cache->is_resolved = true;
+      }
+    }
+    else if (G.debug & G_DEBUG) {
+      CLOG_WARN(&LOG,
+                "Animato: Invalid path. ID = '%s',  '%s[%d]'",
+                (ptr->owner_id) ? (ptr->owner_id->name + 2) : "<No ID>",
+                rna_path,
+                array_index);
+    }
+  }
+
+  if (!cache->is_resolved) {
+    return false;
+  }
+
+  *r_result = cache->anim_rna;
+  return animsys_store_rna_setting_index(ptr, rna_path, array_index, cache->array_len, r_result);
+}
+
 /**
  * Evaluate all the F-Curves in the given list
  * This performs a set of standard checks. If extra checks are required,
@@ -541,6 +602,14 @@ static void animsys_evaluate_fcurves(PointerRNA *ptr,
                                      const AnimationEvalContext *anim_eval_context,
                                      bool flush_to_original)
 {
+  AnimsysPathCache path_cache = {NULL};
+  AnimsysPathCache path_cache_orig = {NULL};
+
+  PointerRNA ptr_orig;
+  if (flush_to_original && !animsys_construct_orig_pointer_rna(ptr, &ptr_orig)) {
+    flush_to_original = false;
+  }
+
   /* Calculate then execute each curve. */
   LISTBASE_FOREACH (FCurve *, fcu, list) {
     /* Check if this F-Curve doesn't belong to a muted group. */
@@ -556,11 +625,16 @@ static void animsys_evaluate_fcurves(PointerRNA *ptr,
       continue;
     }
     PathResolvedRNA anim_rna;
-    if (BKE_animsys_store_rna_setting(ptr, fcu->rna_path, fcu->array_index, &anim_rna)) {
+    if (animsys_store_rna_setting_cached(
+            ptr, fcu->rna_path, fcu->array_index, &path_cache, &anim_rna)) {
       const float curval = calculate_fcurve(&anim_rna, fcu, anim_eval_context);
       BKE_animsys_write_rna_setting(&anim_rna, curval);
       if (flush_to_original) {
-        animsys_write_orig_anim_rna(ptr, fcu->rna_path, fcu->array_index, curval);
+        PathResolvedRNA orig_anim_rna;
+        if (animsys_store_rna_setting_cached(
+                &ptr_orig, fcu->rna_path, fcu->array_index, &path_cache_orig, &orig_anim_rna)) {
+          BKE_animsys_write_rna_setting(&orig_anim_rna, curval);
+        }
       }
     }
   }
@@ -975,7 +1049,7 @@ static NlaEvalChannelSnapshot *nlaevalchan_snapshot_new(NlaEvalChannel *nec)
   int length = nec->base_snapshot.length;
 
   size_t byte_size = sizeof(NlaEvalChannelSnapshot) + sizeof(float) * length;
-  NlaEvalChannelSnapshot *nec_snapshot = MEM_callocN(byte_size, "NlaEvalChannelSnapshot");
+  NlaEvalChannelSnapshot *nec_snapshot = BLI_memarena_calloc(nec->owner->arena, byte_size);
 
   nec_snapshot->channel = nec;
   nec_snapshot->length = length;
@@ -983,12 +1057,12 @@ static NlaEvalChannelSnapshot *nlaevalchan_snapshot_new(NlaEvalChannel *nec)
   return nec_snapshot;
 }
 
-/* Free a channel's blending value snapshot. */
+/* Free a channel's blending value snapshot.
+ * The memory itself is only released together with the arena of the evaluation data. */
 static void nlaevalchan_snapshot_free(NlaEvalChannelSnapshot *nec_snapshot)
 {
   BLI_assert(!nec_snapshot->is_base);
-
-  MEM_freeN(nec_snapshot);
+  UNUSED_VARS_NDEBUG(nec_snapshot);
 }
 
 /* Copy all data in the snapshot. */
@@ -1113,6 +1187,9 @@ static void nlaeval_init(NlaEvalData *nlaeval)
 {
   memset(nlaeval, 0, sizeof(*nlaeval));
 
+  /* Channels and snapshots are allocated anew on every evaluation, avoid allocating each of
+   * them separately. */
+  nlaeval->arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "NlaEvalData::arena");
   nlaeval->path_hash = BLI_ghash_str_new("NlaEvalData::path_hash");
   nlaeval->key_hash = BLI_ghash_new(
       nlaevalchan_keyhash, nlaevalchan_keycmp, "NlaEvalData::key_hash");
@@ -1131,9 +1208,10 @@ static void nlaeval_free(NlaEvalData *nlaeval)
     nlaevalchan_free_data(nec);
   }
 
-  BLI_freelistN(&nlaeval->channels);
+  BLI_listbase_clear(&nlaeval->channels);
   BLI_ghash_free(nlaeval->path_hash, NULL, NULL);
   BLI_ghash_free(nlaeval->key_hash, NULL, NULL);
+  BLI_memarena_free(nlaeval->arena);
 }
 
 /* ---------------------- */
@@ -1267,8 +1345,8 @@ static NlaEvalChannel *nlaevalchan_verify_key(NlaEvalData *nlaeval,
   bool is_array = RNA_property_array_check(key->prop);
   int length = is_array ? RNA_property_array_length(&key->ptr, key->prop) : 1;
 
-  NlaEvalChannel *nec = MEM_callocN(sizeof(NlaEvalChannel) + sizeof(float) * length,
-                                    "NlaEvalChannel");
+  NlaEvalChannel *nec = BLI_memarena_calloc(nlaeval->arena,
+                                             sizeof(NlaEvalChannel) + sizeof(float) * length);
 
   /* Initialize the channel. */
   nec->rna_path = path;
@@ -1781,6 +1859,10 @@ static void nlastrip_evaluate_actionclip(PointerRNA *ptr,
       .influence = strip->influence,
   };
 
+  /* Consecutive F-Curves usually share the channel of an array property. */
+  const char *prev_rna_path = NULL;
+  NlaEvalChannel *prev_nec = NULL;
+
   /* Evaluate all the F-Curves in the action,
    * saving the relevant pointers to data that will need to be used. */
   for (fcu = strip->act->curves.first; fcu; fcu = fcu->next) {
@@ -1812,7 +1894,14 @@ static void nlastrip_evaluate_actionclip(PointerRNA *ptr,
     /* Get an NLA evaluation channel to work with,
      * and accumulate the evaluated value with the value(s)
      * stored in this channel if it has been used already. */
-    NlaEvalChannel *nec = nlaevalchan_verify(ptr, channels, fcu->rna_path);
+    NlaEvalChannel *nec;
+    if (prev_rna_path != NULL && fcu->rna_path != NULL && STREQ(prev_rna_path, fcu->rna_path)) {
+      nec = prev_nec;
+    }
+    else {
+      nec = prev_nec = nlaevalchan_verify(ptr, channels, fcu->rna_path);
+      prev_rna_path = fcu->rna_path;
+    }
 
     nlaeval_blend_value(&blend, nec, fcu->array_index, value);
   }
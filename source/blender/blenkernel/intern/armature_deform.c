@@ -35,6 +35,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_armature_types.h"
@@ -50,6 +51,7 @@
 #include "BKE_deform.h"
 #include "BKE_editmesh.h"
 #include "BKE_lattice.h"
+#include "BKE_object.h"
 
 #include "DEG_depsgraph_build.h"
 
@@ -231,6 +233,196 @@ static void pchan_bone_deform(bPoseChannel *pchan,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Flattened Vertex Group Weights
+ *
+ * The weights of all vertices in contiguous arrays instead of one allocation per vertex, cached
+ * in the evaluated mesh so it's only built again when its vertex groups change.
+ * \{ */
+
+typedef struct ArmatureDeformWeights {
+  /** Vertex groups the weights were built from, to detect changes. */
+  const MDeformVert *dverts;
+  int dverts_len;
+
+  /** Weights of vertex i are in range [offsets[i], offsets[i + 1]). */
+  int *offsets;
+  int *def_nrs;
+  float *weights;
+} ArmatureDeformWeights;
+
+static ArmatureDeformWeights *armature_deform_weights_build(const MDeformVert *dverts,
+                                                            const int dverts_len)
+{
+  ArmatureDeformWeights *deform_weights = MEM_mallocN(sizeof(*deform_weights), __func__);
+  int i, weights_len = 0;
+
+  deform_weights->dverts = dverts;
+  deform_weights->dverts_len = dverts_len;
+  deform_weights->offsets = MEM_malloc_arrayN(dverts_len + 1, sizeof(int), __func__);
+
+  for (i = 0; i < dverts_len; i++) {
+    deform_weights->offsets[i] = weights_len;
+    weights_len += dverts[i].totweight;
+  }
+  deform_weights->offsets[dverts_len] = weights_len;
+
+  deform_weights->def_nrs = MEM_malloc_arrayN(max_ii(weights_len, 1), sizeof(int), __func__);
+  deform_weights->weights = MEM_malloc_arrayN(max_ii(weights_len, 1), sizeof(float), __func__);
+
+  for (i = 0; i < dverts_len; i++) {
+    const MDeformWeight *dw = dverts[i].dw;
+    int *def_nrs = deform_weights->def_nrs + deform_weights->offsets[i];
+    float *weights = deform_weights->weights + deform_weights->offsets[i];
+    for (int j = 0; j < dverts[i].totweight; j++) {
+      def_nrs[j] = (int)dw[j].def_nr;
+      weights[j] = dw[j].weight;
+    }
+  }
+
+  return deform_weights;
+}
+
+static void armature_deform_weights_free(ArmatureDeformWeights *deform_weights)
+{
+  MEM_freeN(deform_weights->offsets);
+  MEM_freeN(deform_weights->def_nrs);
+  MEM_freeN(deform_weights->weights);
+  MEM_freeN(deform_weights);
+}
+
+/* Get the flattened weights of \a mesh, building them if they are missing or outdated. */
+static const ArmatureDeformWeights *armature_deform_weights_ensure(Mesh *mesh)
+{
+  ArmatureDeformWeights *deform_weights;
+
+  BLI_mutex_lock(mesh->runtime.eval_mutex);
+  deform_weights = mesh->runtime.deform_weights;
+  if (deform_weights == NULL || deform_weights->dverts != mesh->dvert ||
+      deform_weights->dverts_len != mesh->totvert) {
+    if (deform_weights) {
+      armature_deform_weights_free(deform_weights);
+    }
+    deform_weights = armature_deform_weights_build(mesh->dvert, mesh->totvert);
+    mesh->runtime.deform_weights = deform_weights;
+  }
+  BLI_mutex_unlock(mesh->runtime.eval_mutex);
+
+  return deform_weights;
+}
+
+void BKE_armature_deform_weights_free(Mesh *mesh)
+{
+  if (mesh->runtime.deform_weights) {
+    armature_deform_weights_free(mesh->runtime.deform_weights);
+    mesh->runtime.deform_weights = NULL;
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Armature Deform on the GPU
+ *
+ * When every bone used by the vertex groups is a plain linear transform, the deformation of a
+ * vertex is the weighted average of one matrix per vertex group. Only those matrices are computed
+ * here, the vertices are transformed by the draw manager.
+ * \{ */
+
+/**
+ * Compute the matrices to deform \a me_target with on the GPU.
+ *
+ * \return NULL when the deformation uses features only supported on the CPU: envelopes,
+ * preserve volume, a vertex group limiting the influence or B-Bones.
+ */
+ArmatureDeformGPU *BKE_armature_deform_gpu_create(const Object *ob_arm,
+                                                  const Object *ob_target,
+                                                  const int deformflag,
+                                                  const char *defgrp_name,
+                                                  const Mesh *me_target)
+{
+  const bArmature *arm = ob_arm->data;
+
+  if (arm->edbo || (ob_arm->pose == NULL) || (ob_arm->pose->flag & POSE_RECALC)) {
+    return NULL;
+  }
+  if ((deformflag & (ARM_DEF_ENVELOPE | ARM_DEF_QUATERNION)) ||
+      (deformflag & ARM_DEF_VGROUP) == 0 || (defgrp_name && defgrp_name[0]) ||
+      me_target->dvert == NULL) {
+    return NULL;
+  }
+
+  const int defbase_len = BLI_listbase_count(&ob_target->defbase);
+  if (defbase_len == 0) {
+    return NULL;
+  }
+
+  float obinv[4][4], premat[4][4], postmat[4][4];
+  invert_m4_m4(obinv, ob_target->obmat);
+  mul_m4_m4m4(postmat, obinv, ob_arm->obmat);
+  invert_m4_m4(premat, postmat);
+
+  float(*defbase_mats)[4][4] = MEM_calloc_arrayN(defbase_len, sizeof(*defbase_mats), __func__);
+  const bDeformGroup *dg;
+  int i;
+
+  for (i = 0, dg = ob_target->defbase.first; dg; i++, dg = dg->next) {
+    const bPoseChannel *pchan = BKE_pose_channel_find_name(ob_arm->pose, dg->name);
+    if (pchan == NULL || (pchan->bone->flag & BONE_NO_DEFORM)) {
+      continue;
+    }
+    if ((pchan->bone->segments > 1 && pchan->runtime.bbone_segments == pchan->bone->segments) ||
+        (pchan->bone->flag & BONE_MULT_VG_ENV)) {
+      MEM_freeN(defbase_mats);
+      return NULL;
+    }
+    mul_m4_series(defbase_mats[i], postmat, pchan->chan_mat, premat);
+  }
+
+  ArmatureDeformGPU *deform_gpu = MEM_mallocN(sizeof(*deform_gpu), __func__);
+  deform_gpu->defbase_mats = defbase_mats;
+  deform_gpu->defbase_len = defbase_len;
+  return deform_gpu;
+}
+
+/**
+ * Extend the bounds of the undeformed mesh to contain the deformed one. Each deformed vertex is
+ * a weighted average of its transforms by the matrices, or the vertex itself, so it stays in the
+ * bounds of the transformed boxes.
+ */
+void BKE_armature_deform_gpu_minmax(const ArmatureDeformGPU *deform_gpu,
+                                    float r_min[3],
+                                    float r_max[3])
+{
+  BoundBox bb;
+  float co[3];
+
+  BKE_boundbox_init_from_minmax(&bb, r_min, r_max);
+
+  for (int i = 0; i < deform_gpu->defbase_len; i++) {
+    const float(*mat)[4] = deform_gpu->defbase_mats[i];
+    if (mat[3][3] == 0.0f) {
+      continue;
+    }
+    for (int j = 0; j < 8; j++) {
+      mul_v3_m4v3(co, mat, bb.vec[j]);
+      minmax_v3v3_v3(r_min, r_max, co);
+    }
+  }
+}
+
+void BKE_armature_deform_gpu_free(Mesh *mesh)
+{
+  ArmatureDeformGPU *deform_gpu = mesh->runtime.armature_deform_gpu;
+  if (deform_gpu) {
+    MEM_freeN(deform_gpu->defbase_mats);
+    MEM_freeN(deform_gpu);
+    mesh->runtime.armature_deform_gpu = NULL;
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform #BKE_armature_deform_coords API
  *
@@ -256,8 +448,13 @@ typedef struct ArmatureUserdata {
   int dverts_len;
 
   bPoseChannel **pchan_from_defbase;
+  /** Bones which deform with a single matrix, their weighted matrices are summed up first. */
+  bool *use_matrix_sum_from_defbase;
   int defbase_len;
 
+  /** Optional, same weights as in \a dverts. */
+  const ArmatureDeformWeights *deform_weights;
+
   float premat[4][4];
   float postmat[4][4];
 
@@ -328,17 +525,35 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
   mul_m4_v3(data->premat, co);
 
   if (use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
+    const ArmatureDeformWeights *deform_weights = data->deform_weights;
     const MDeformWeight *dw = dvert->dw;
+    const int *def_nrs = NULL;
+    const float *weights = NULL;
+    float summat4[4][4], sumweight = 0.0f;
     int deformed = 0;
-    unsigned int j;
-    for (j = dvert->totweight; j != 0; j--, dw++) {
-      const uint index = dw->def_nr;
+    int j;
+
+    if (deform_weights) {
+      def_nrs = deform_weights->def_nrs + deform_weights->offsets[i];
+      weights = deform_weights->weights + deform_weights->offsets[i];
+    }
+    zero_m4(summat4);
+
+    for (j = 0; j < dvert->totweight; j++) {
+      const uint index = def_nrs ? (uint)def_nrs[j] : dw[j].def_nr;
       if (index < data->defbase_len && (pchan = data->pchan_from_defbase[index])) {
-        float weight = dw->weight;
+        float weight = weights ? weights[j] : dw[j].weight;
         Bone *bone = pchan->bone;
 
         deformed = 1;
 
+        if (data->use_matrix_sum_from_defbase[index]) {
+          /* Same result as #pchan_deform_accumulate for each bone, with a single transform. */
+          madd_m4_m4m4fl(summat4, summat4, pchan->chan_mat, weight);
+          sumweight += weight;
+          continue;
+        }
+
         if (bone && bone->flag & BONE_MULT_VG_ENV) {
           weight *= distfactor_to_bone(
               co, bone->arm_head, bone->arm_tail, bone->rad_head, bone->rad_tail, bone->dist);
@@ -347,6 +562,21 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
         pchan_bone_deform(pchan, weight, vec, dq, smat, co, &contrib);
       }
     }
+
+    if (sumweight != 0.0f) {
+      float tmp[3];
+      mul_v3_m4v3(tmp, summat4, co);
+      madd_v3_v3fl(tmp, co, -sumweight);
+      add_v3_v3(vec, tmp);
+
+      if (smat) {
+        float tmpmat[3][3];
+        copy_m3_m4(tmpmat, summat4);
+        add_m3_m3m3(smat, smat, tmpmat);
+      }
+
+      contrib += sumweight;
+    }
     /* If there are vertex-groups but not groups with bones (like for soft-body groups). */
     if (deformed == 0 && use_envelope) {
       for (pchan = data->ob_arm->pose->chanbase.first; pchan; pchan = pchan->next) {
@@ -473,6 +703,8 @@ static void armature_deform_coords_impl(const Object *ob_arm,
 {
   bArmature *arm = ob_arm->data;
   bPoseChannel **pchan_from_defbase = NULL;
+  bool *use_matrix_sum_from_defbase = NULL;
+  const ArmatureDeformWeights *deform_weights = NULL;
   const MDeformVert *dverts = NULL;
   bDeformGroup *dg;
   const bool use_envelope = (deformflag & ARM_DEF_ENVELOPE) != 0;
@@ -543,6 +775,8 @@ static void armature_deform_coords_impl(const Object *ob_arm,
 
       if (use_dverts) {
         pchan_from_defbase = MEM_callocN(sizeof(*pchan_from_defbase) * defbase_len, "defnrToBone");
+        use_matrix_sum_from_defbase = MEM_callocN(
+            sizeof(*use_matrix_sum_from_defbase) * defbase_len, "defnrUseMatrixSum");
         /* TODO(sergey): Some considerations here:
          *
          * - Check whether keeping this consistent across frames gives speedup.
@@ -551,9 +785,27 @@ static void armature_deform_coords_impl(const Object *ob_arm,
           pchan_from_defbase[i] = BKE_pose_channel_find_name(ob_arm->pose, dg->name);
           /* exclude non-deforming bones */
           if (pchan_from_defbase[i]) {
-            if (pchan_from_defbase[i]->bone->flag & BONE_NO_DEFORM) {
+            const bPoseChannel *pchan = pchan_from_defbase[i];
+            const Bone *bone = pchan->bone;
+            if (bone->flag & BONE_NO_DEFORM) {
               pchan_from_defbase[i] = NULL;
             }
+            else {
+              const bool is_bbone = (bone->segments > 1 &&
+                                     pchan->runtime.bbone_segments == bone->segments);
+              use_matrix_sum_from_defbase[i] = !use_quaternion && !is_bbone &&
+                                               !(bone->flag & BONE_MULT_VG_ENV);
+            }
+          }
+        }
+
+        /* The weights of the original mesh are cached, modifiers before this one can give other
+         * vertex groups that change every evaluation. */
+        if (ob_target->type == OB_MESH && em_target == NULL) {
+          Mesh *me = ob_target->data;
+          const MDeformVert *dverts_used = me_target ? me_target->dvert : dverts;
+          if (dverts_used == me->dvert && vert_coords_len <= me->totvert) {
+            deform_weights = armature_deform_weights_ensure(me);
           }
         }
       }
@@ -575,7 +827,9 @@ static void armature_deform_coords_impl(const Object *ob_arm,
       .dverts = dverts,
       .dverts_len = dverts_len,
       .pchan_from_defbase = pchan_from_defbase,
+      .use_matrix_sum_from_defbase = use_matrix_sum_from_defbase,
       .defbase_len = defbase_len,
+      .deform_weights = deform_weights,
       .bmesh =
           {
               .cd_dvert_offset = cd_dvert_offset,
@@ -610,6 +864,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
 
   if (pchan_from_defbase) {
     MEM_freeN(pchan_from_defbase);
+    MEM_freeN(use_matrix_sum_from_defbase);
   }
 }
 
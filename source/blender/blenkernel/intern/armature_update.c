@@ -773,6 +773,18 @@ void BKE_pose_bone_done(struct Depsgraph *depsgraph, struct Object *object, int
   }
 }
 
+/* Both steps at once, for bones which nothing modifies in-between: no constraints and not part of
+ * an IK chain. Saves the scheduling of a separate operation for the many simple FK bones of
+ * large rigs. */
+void BKE_pose_eval_bone_and_done(struct Depsgraph *depsgraph,
+                                 Scene *scene,
+                                 Object *object,
+                                 int pchan_index)
+{
+  BKE_pose_eval_bone(depsgraph, scene, object, pchan_index);
+  BKE_pose_bone_done(depsgraph, object, pchan_index);
+}
+
 void BKE_pose_eval_bbone_segments(struct Depsgraph *depsgraph,
                                   struct Object *object,
                                   int pchan_index)
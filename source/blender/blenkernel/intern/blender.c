@@ -27,6 +27,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "MEM_CacheLimiterC-Api.h"
 #include "MEM_guardedalloc.h"
 
 #include "BLI_listbase.h"
@@ -283,6 +284,17 @@ void BKE_blender_userdef_data_free(UserDef *userdef, bool clear_fonts)
  * Write U from userdef.
  * This function defines which settings a template will override for the user preferences.
  */
+/* Apply the memory cache limits of the preferences. */
+void BKE_blender_userdef_memcache_limits_update(void)
+{
+  const size_t limit = ((size_t)U.memcachelimit) * 1024 * 1024;
+
+  MEM_CacheLimiter_set_maximum(limit);
+  IMB_moviecache_set_user_limit(MOVIECACHE_USER_CLIP, limit / 100 * U.memcache_clip_share);
+  IMB_moviecache_set_user_limit(MOVIECACHE_USER_IMAGE, limit / 100 * U.memcache_image_share);
+  IMB_moviecache_set_compressed_limit(limit / 100 * U.memcache_compressed_size);
+}
+
 void BKE_blender_userdef_app_template_data_swap(UserDef *userdef_a, UserDef *userdef_b)
 {
   /* TODO:
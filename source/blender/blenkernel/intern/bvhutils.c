@@ -29,8 +29,10 @@
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 
+#include "BLI_hash_mm2a.h"
 #include "BLI_linklist.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -53,6 +55,17 @@ typedef struct BVHCacheItem {
 typedef struct BVHCache {
   BVHCacheItem items[BVHTREE_MAX_ITEM];
   ThreadMutex mutex;
+
+  /**
+   * Trees built for a previous evaluation of the mesh, with the same topology.
+   * Requesting a tree of that type refits it instead of building a new one,
+   * see #bvhcache_attach_for_refit.
+   */
+  BVHTree *refit_trees[BVHTREE_MAX_ITEM];
+
+  /** Topology of the mesh the trees were built for, only set while detached from it. */
+  int totvert, totedge, totloop, totpoly;
+  uint topology_hash;
 } BVHCache;
 
 /**
@@ -155,11 +168,139 @@ void bvhcache_free(BVHCache *bvh_cache)
     BVHCacheItem *item = &bvh_cache->items[index];
     BLI_bvhtree_free(item->tree);
     item->tree = NULL;
+    BLI_bvhtree_free(bvh_cache->refit_trees[index]);
+    bvh_cache->refit_trees[index] = NULL;
   }
   BLI_mutex_end(&bvh_cache->mutex);
   MEM_freeN(bvh_cache);
 }
 
+static uint bvhcache_topology_hash(const Mesh *mesh)
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  /* Only hash the connectivity, other members (flags & padding) don't affect the trees. */
+  for (int i = 0; i < mesh->totedge; i++) {
+    BLI_hash_mm2a_add_int(&mm2, (int)mesh->medge[i].v1);
+    BLI_hash_mm2a_add_int(&mm2, (int)mesh->medge[i].v2);
+  }
+  for (int i = 0; i < mesh->totpoly; i++) {
+    BLI_hash_mm2a_add_int(&mm2, mesh->mpoly[i].totloop);
+  }
+  BLI_hash_mm2a_add(
+      &mm2, (const uchar *)mesh->mloop, sizeof(*mesh->mloop) * (size_t)mesh->totloop);
+  return BLI_hash_mm2a_end(&mm2);
+}
+
+/**
+ * Detach the cache from a mesh which is about to be freed, to reuse its trees for the next
+ * evaluation of the same object (see #bvhcache_attach_for_refit).
+ *
+ * \return NULL when there are no trees which can be refit.
+ */
+BVHCache *bvhcache_detach_for_refit(Mesh *mesh)
+{
+  BVHCache *bvh_cache = mesh->runtime.bvh_cache;
+  if (bvh_cache == NULL) {
+    return NULL;
+  }
+
+  bool has_refit_trees = false;
+  for (BVHCacheType type = 0; type < BVHTREE_MAX_ITEM; type++) {
+    BVHCacheItem *item = &bvh_cache->items[type];
+    /* Only trees storing all elements in order can be refit. */
+    if (ELEM(type, BVHTREE_FROM_VERTS, BVHTREE_FROM_EDGES, BVHTREE_FROM_LOOPTRI) &&
+        (item->tree != NULL)) {
+      BLI_bvhtree_free(bvh_cache->refit_trees[type]);
+      bvh_cache->refit_trees[type] = item->tree;
+      has_refit_trees = true;
+    }
+    else {
+      BLI_bvhtree_free(item->tree);
+    }
+    item->tree = NULL;
+    item->is_filled = false;
+  }
+
+  mesh->runtime.bvh_cache = NULL;
+
+  if (!has_refit_trees) {
+    bvhcache_free(bvh_cache);
+    return NULL;
+  }
+
+  bvh_cache->totvert = mesh->totvert;
+  bvh_cache->totedge = mesh->totedge;
+  bvh_cache->totloop = mesh->totloop;
+  bvh_cache->totpoly = mesh->totpoly;
+  bvh_cache->topology_hash = bvhcache_topology_hash(mesh);
+  return bvh_cache;
+}
+
+/**
+ * Use a cache detached by #bvhcache_detach_for_refit for a newly evaluated mesh,
+ * when the topology didn't change (otherwise the cache is freed).
+ */
+void bvhcache_attach_for_refit(Mesh *mesh, BVHCache *bvh_cache)
+{
+  if ((mesh->runtime.bvh_cache == NULL) && (bvh_cache->totvert == mesh->totvert) &&
+      (bvh_cache->totedge == mesh->totedge) && (bvh_cache->totloop == mesh->totloop) &&
+      (bvh_cache->totpoly == mesh->totpoly) &&
+      (bvh_cache->topology_hash == bvhcache_topology_hash(mesh))) {
+    mesh->runtime.bvh_cache = bvh_cache;
+  }
+  else {
+    bvhcache_free(bvh_cache);
+  }
+}
+
+/**
+ * Take the tree of a previous evaluation for refitting, see #bvhcache_attach_for_refit.
+ * Must be called with the cache locked.
+ */
+static BVHTree *bvhcache_refit_tree_pop(BVHCache **bvh_cache_p,
+                                        BVHCacheType type,
+                                        const BLI_bitmap *mask,
+                                        const int elems_num)
+{
+  if ((bvh_cache_p == NULL) || (mask != NULL)) {
+    return NULL;
+  }
+  BVHCache *bvh_cache = *bvh_cache_p;
+  BVHTree *tree = bvh_cache->refit_trees[type];
+  if (tree == NULL) {
+    return NULL;
+  }
+  bvh_cache->refit_trees[type] = NULL;
+  if (BLI_bvhtree_get_len(tree) != elems_num) {
+    BLI_bvhtree_free(tree);
+    return NULL;
+  }
+  return tree;
+}
+
+typedef struct BVHTreeRefitData {
+  BVHTree *tree;
+  const MVert *vert;
+  const MEdge *edge;
+  const MLoop *mloop;
+  const MLoopTri *looptri;
+} BVHTreeRefitData;
+
+/**
+ * Update the bounds of all leafs of a tree taken with #bvhcache_refit_tree_pop,
+ * keeping its structure (the nodes are updated over multiple threads).
+ */
+static void bvhtree_refit(BVHTreeRefitData *data, TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, BLI_bvhtree_get_len(data->tree), data, func, &settings);
+
+  BLI_bvhtree_update_tree(data->tree);
+}
+
 /** \} */
 /* -------------------------------------------------------------------- */
 /** \name Local Callbacks
@@ -681,6 +822,14 @@ BVHTree *bvhtree_from_editmesh_verts(
       data, em, NULL, -1, epsilon, tree_type, axis, 0, NULL, NULL);
 }
 
+static void bvhtree_refit_verts_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHTreeRefitData *data = userdata;
+  BLI_bvhtree_update_node(data->tree, i, data->vert[i].co, NULL, 1);
+}
+
 /**
  * Builds a bvh tree where nodes are the given vertices (note: does not copy given mverts!).
  * \param vert_allocated: if true, vert freeing will be done when freeing data.
@@ -709,8 +858,15 @@ BVHTree *bvhtree_from_mesh_verts_ex(BVHTreeFromMesh *data,
   }
 
   if (in_cache == false) {
-    tree = bvhtree_from_mesh_verts_create_tree(
-        epsilon, tree_type, axis, vert, verts_num, verts_mask, verts_num_active);
+    tree = bvhcache_refit_tree_pop(bvh_cache_p, bvh_cache_type, verts_mask, verts_num);
+    if (tree) {
+      BVHTreeRefitData refit_data = {.tree = tree, .vert = vert};
+      bvhtree_refit(&refit_data, bvhtree_refit_verts_cb);
+    }
+    else {
+      tree = bvhtree_from_mesh_verts_create_tree(
+          epsilon, tree_type, axis, vert, verts_num, verts_mask, verts_num_active);
+    }
 
     if (bvh_cache_p) {
       /* Save on cache for later use */
@@ -893,6 +1049,18 @@ BVHTree *bvhtree_from_editmesh_edges(
       data, em, NULL, -1, epsilon, tree_type, axis, 0, NULL, NULL);
 }
 
+static void bvhtree_refit_edges_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHTreeRefitData *data = userdata;
+  float co[2][3];
+  copy_v3_v3(co[0], data->vert[data->edge[i].v1].co);
+  copy_v3_v3(co[1], data->vert[data->edge[i].v2].co);
+
+  BLI_bvhtree_update_node(data->tree, i, co[0], NULL, 2);
+}
+
 /**
  * Builds a bvh tree where nodes are the given edges .
  * \param vert, vert_allocated: if true, elem freeing will be done when freeing data.
@@ -924,8 +1092,15 @@ BVHTree *bvhtree_from_mesh_edges_ex(BVHTreeFromMesh *data,
   }
 
   if (in_cache == false) {
-    tree = bvhtree_from_mesh_edges_create_tree(
-        vert, edge, edges_num, edges_mask, edges_num_active, epsilon, tree_type, axis);
+    tree = bvhcache_refit_tree_pop(bvh_cache_p, bvh_cache_type, edges_mask, edges_num);
+    if (tree) {
+      BVHTreeRefitData refit_data = {.tree = tree, .vert = vert, .edge = edge};
+      bvhtree_refit(&refit_data, bvhtree_refit_edges_cb);
+    }
+    else {
+      tree = bvhtree_from_mesh_edges_create_tree(
+          vert, edge, edges_num, edges_mask, edges_num_active, epsilon, tree_type, axis);
+    }
 
     if (bvh_cache_p) {
       BVHCache *bvh_cache = *bvh_cache_p;
@@ -1263,6 +1438,20 @@ BVHTree *bvhtree_from_editmesh_looptri(
       data, em, NULL, -1, epsilon, tree_type, axis, 0, NULL, NULL);
 }
 
+static void bvhtree_refit_looptri_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHTreeRefitData *data = userdata;
+  const MLoopTri *lt = &data->looptri[i];
+  float co[3][3];
+  copy_v3_v3(co[0], data->vert[data->mloop[lt->tri[0]].v].co);
+  copy_v3_v3(co[1], data->vert[data->mloop[lt->tri[1]].v].co);
+  copy_v3_v3(co[2], data->vert[data->mloop[lt->tri[2]].v].co);
+
+  BLI_bvhtree_update_node(data->tree, i, co[0], NULL, 3);
+}
+
 /**
  * Builds a bvh tree where nodes are the looptri faces of the given dm
  *
@@ -1293,16 +1482,23 @@ BVHTree *bvhtree_from_mesh_looptri_ex(BVHTreeFromMesh *data,
   }
 
   if (in_cache == false) {
-    /* Setup BVHTreeFromMesh */
-    tree = bvhtree_from_mesh_looptri_create_tree(epsilon,
-                                                 tree_type,
-                                                 axis,
-                                                 vert,
-                                                 mloop,
-                                                 looptri,
-                                                 looptri_num,
-                                                 looptri_mask,
-                                                 looptri_num_active);
+    tree = bvhcache_refit_tree_pop(bvh_cache_p, bvh_cache_type, looptri_mask, looptri_num);
+    if (tree) {
+      BVHTreeRefitData refit_data = {
+          .tree = tree, .vert = vert, .mloop = mloop, .looptri = looptri};
+      bvhtree_refit(&refit_data, bvhtree_refit_looptri_cb);
+    }
+    else {
+      tree = bvhtree_from_mesh_looptri_create_tree(epsilon,
+                                                   tree_type,
+                                                   axis,
+                                                   vert,
+                                                   mloop,
+                                                   looptri,
+                                                   looptri_num,
+                                                   looptri_mask,
+                                                   looptri_num_active);
+    }
 
     if (bvh_cache_p) {
       BVHCache *bvh_cache = *bvh_cache_p;
@@ -137,6 +137,40 @@ BVHTree *bvhtree_build_from_mvert(const MVert *mvert,
   return tree;
 }
 
+typedef struct BVHUpdateFromMVertData {
+  BVHTree *bvhtree;
+  const MVert *mvert;
+  const MVert *mvert_moving;
+  const MVertTri *tri;
+} BVHUpdateFromMVertData;
+
+static void bvhtree_update_from_mvert_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHUpdateFromMVertData *data = userdata;
+  const MVertTri *vt = &data->tri[i];
+  float co[3][3];
+
+  copy_v3_v3(co[0], data->mvert[vt->tri[0]].co);
+  copy_v3_v3(co[1], data->mvert[vt->tri[1]].co);
+  copy_v3_v3(co[2], data->mvert[vt->tri[2]].co);
+
+  /* copy new locations into array */
+  if (data->mvert_moving) {
+    float co_moving[3][3];
+    /* update moving positions */
+    copy_v3_v3(co_moving[0], data->mvert_moving[vt->tri[0]].co);
+    copy_v3_v3(co_moving[1], data->mvert_moving[vt->tri[1]].co);
+    copy_v3_v3(co_moving[2], data->mvert_moving[vt->tri[2]].co);
+
+    BLI_bvhtree_update_node(data->bvhtree, i, &co[0][0], &co_moving[0][0], 3);
+  }
+  else {
+    BLI_bvhtree_update_node(data->bvhtree, i, &co[0][0], NULL, 3);
+  }
+}
+
 void bvhtree_update_from_mvert(BVHTree *bvhtree,
                                const MVert *mvert,
                                const MVert *mvert_moving,
@@ -144,9 +178,6 @@ void bvhtree_update_from_mvert(BVHTree *bvhtree,
                                int tri_num,
                                bool moving)
 {
-  const MVertTri *vt;
-  int i;
-
   if ((bvhtree == NULL) || (mvert == NULL)) {
     return;
   }
@@ -155,33 +186,21 @@ void bvhtree_update_from_mvert(BVHTree *bvhtree,
     moving = false;
   }
 
-  for (i = 0, vt = tri; i < tri_num; i++, vt++) {
-    float co[3][3];
-    bool ret;
-
-    copy_v3_v3(co[0], mvert[vt->tri[0]].co);
-    copy_v3_v3(co[1], mvert[vt->tri[1]].co);
-    copy_v3_v3(co[2], mvert[vt->tri[2]].co);
-
-    /* copy new locations into array */
-    if (moving) {
-      float co_moving[3][3];
-      /* update moving positions */
-      copy_v3_v3(co_moving[0], mvert_moving[vt->tri[0]].co);
-      copy_v3_v3(co_moving[1], mvert_moving[vt->tri[1]].co);
-      copy_v3_v3(co_moving[2], mvert_moving[vt->tri[2]].co);
+  BVHUpdateFromMVertData data = {
+      .bvhtree = bvhtree,
+      .mvert = mvert,
+      .mvert_moving = moving ? mvert_moving : NULL,
+      .tri = tri,
+  };
 
-      ret = BLI_bvhtree_update_node(bvhtree, i, &co[0][0], &co_moving[0][0], 3);
-    }
-    else {
-      ret = BLI_bvhtree_update_node(bvhtree, i, &co[0][0], NULL, 3);
-    }
+  /* Don't update past the end of the tree (topology changed after it was built). */
+  tri_num = min_ii(tri_num, BLI_bvhtree_get_len(bvhtree));
 
-    /* check if tree is already full */
-    if (ret == false) {
-      break;
-    }
-  }
+  /* The tree structure is kept, only refit the nodes. */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, tri_num, &data, bvhtree_update_from_mvert_cb, &settings);
 
   BLI_bvhtree_update_tree(bvhtree);
 }
@@ -666,184 +685,432 @@ DO_INLINE void collision_interpolateOnTriangle(float to[3],
   VECADDMUL(to, v3, w3);
 }
 
-static int cloth_collision_response_static(ClothModifierData *clmd,
-                                           CollisionModifierData *collmd,
-                                           Object *collob,
-                                           CollPair *collpair,
-                                           uint collision_count,
-                                           const float dt)
+/* Impulses of a collision pair, for the vertices of the cloth triangle, and for self collisions
+ * also the vertices of the other triangle. */
+typedef struct CollisionImpulse {
+  float impulse_a[3][3];
+  float impulse_b[3][3];
+  bool collided;
+} CollisionImpulse;
+
+typedef struct CollisionResponseData {
+  ClothModifierData *clmd;
+  /* NULL for self collisions. */
+  CollisionModifierData *collmd;
+  Object *collob;
+  CollPair *collisions;
+  CollisionImpulse *impulses;
+} CollisionResponseData;
+
+/* Compute the impulses of a collision pair with an object, returns true when the vertices are
+ * pushed apart. Only reads the simulation state, so all pairs can be computed in parallel. */
+static bool cloth_collision_impulse_compute(ClothModifierData *clmd,
+                                            CollisionModifierData *collmd,
+                                            Object *collob,
+                                            const CollPair *collpair,
+                                            float r_impulse[3][3])
 {
-  int result = 0;
+  bool collided = false;
   Cloth *cloth1;
   float w1, w2, w3, u1, u2, u3;
   float v1[3], v2[3], relativeVelocity[3];
   float magrelVel;
   float epsilon2 = BLI_bvhtree_get_epsilon(collmd->bvhtree);
   const bool is_hair = (clmd->hairdata != NULL);
+  float *i1 = r_impulse[0], *i2 = r_impulse[1], *i3 = r_impulse[2];
 
   cloth1 = clmd->clothObject;
 
-  for (int i = 0; i < collision_count; i++, collpair++) {
-    float i1[3], i2[3], i3[3];
+  zero_v3(i1);
+  zero_v3(i2);
+  zero_v3(i3);
 
-    zero_v3(i1);
-    zero_v3(i2);
-    zero_v3(i3);
+  /* Compute barycentric coordinates and relative "velocity" for both collision points. */
+  if (is_hair) {
+    w2 = line_point_factor_v3(
+        collpair->pa, cloth1->verts[collpair->ap1].tx, cloth1->verts[collpair->ap2].tx);
 
-    /* Only handle static collisions here. */
-    if (collpair->flag & (COLLISION_IN_FUTURE | COLLISION_INACTIVE)) {
-      continue;
-    }
+    w1 = 1.0f - w2;
+
+    interp_v3_v3v3(v1, cloth1->verts[collpair->ap1].tv, cloth1->verts[collpair->ap2].tv, w2);
+  }
+  else {
+    collision_compute_barycentric(collpair->pa,
+                                  cloth1->verts[collpair->ap1].tx,
+                                  cloth1->verts[collpair->ap2].tx,
+                                  cloth1->verts[collpair->ap3].tx,
+                                  &w1,
+                                  &w2,
+                                  &w3);
 
-    /* Compute barycentric coordinates and relative "velocity" for both collision points. */
-    if (is_hair) {
-      w2 = line_point_factor_v3(
-          collpair->pa, cloth1->verts[collpair->ap1].tx, cloth1->verts[collpair->ap2].tx);
+    collision_interpolateOnTriangle(v1,
+                                    cloth1->verts[collpair->ap1].tv,
+                                    cloth1->verts[collpair->ap2].tv,
+                                    cloth1->verts[collpair->ap3].tv,
+                                    w1,
+                                    w2,
+                                    w3);
+  }
 
-      w1 = 1.0f - w2;
+  collision_compute_barycentric(collpair->pb,
+                                collmd->current_xnew[collpair->bp1].co,
+                                collmd->current_xnew[collpair->bp2].co,
+                                collmd->current_xnew[collpair->bp3].co,
+                                &u1,
+                                &u2,
+                                &u3);
 
-      interp_v3_v3v3(v1, cloth1->verts[collpair->ap1].tv, cloth1->verts[collpair->ap2].tv, w2);
+  collision_interpolateOnTriangle(v2,
+                                  collmd->current_v[collpair->bp1].co,
+                                  collmd->current_v[collpair->bp2].co,
+                                  collmd->current_v[collpair->bp3].co,
+                                  u1,
+                                  u2,
+                                  u3);
+
+  sub_v3_v3v3(relativeVelocity, v2, v1);
+
+  /* Calculate the normal component of the relative velocity
+   * (actually only the magnitude - the direction is stored in 'normal'). */
+  magrelVel = dot_v3v3(relativeVelocity, collpair->normal);
+
+  /* If magrelVel < 0 the edges are approaching each other. */
+  if (magrelVel > 0.0f) {
+    /* Calculate Impulse magnitude to stop all motion in normal direction. */
+    float magtangent = 0, repulse = 0, d = 0;
+    double impulse = 0.0;
+    float vrel_t_pre[3];
+    float temp[3];
+    float time_multiplier;
+
+    /* Calculate tangential velocity. */
+    copy_v3_v3(temp, collpair->normal);
+    mul_v3_fl(temp, magrelVel);
+    sub_v3_v3v3(vrel_t_pre, relativeVelocity, temp);
+
+    /* Decrease in magnitude of relative tangential velocity due to coulomb friction
+     * in original formula "magrelVel" should be the
+     * "change of relative velocity in normal direction". */
+    magtangent = min_ff(collob->pd->pdef_cfrict * 0.01f * magrelVel, len_v3(vrel_t_pre));
+
+    /* Apply friction impulse. */
+    if (magtangent > ALMOST_ZERO) {
+      normalize_v3(vrel_t_pre);
+
+      impulse = magtangent / 1.5;
+
+      VECADDMUL(i1, vrel_t_pre, w1 * impulse);
+      VECADDMUL(i2, vrel_t_pre, w2 * impulse);
+
+      if (!is_hair) {
+        VECADDMUL(i3, vrel_t_pre, w3 * impulse);
+      }
     }
-    else {
-      collision_compute_barycentric(collpair->pa,
-                                    cloth1->verts[collpair->ap1].tx,
-                                    cloth1->verts[collpair->ap2].tx,
-                                    cloth1->verts[collpair->ap3].tx,
-                                    &w1,
-                                    &w2,
-                                    &w3);
-
-      collision_interpolateOnTriangle(v1,
-                                      cloth1->verts[collpair->ap1].tv,
-                                      cloth1->verts[collpair->ap2].tv,
-                                      cloth1->verts[collpair->ap3].tv,
-                                      w1,
-                                      w2,
-                                      w3);
+
+    /* Apply velocity stopping impulse. */
+    impulse = magrelVel / 1.5f;
+
+    VECADDMUL(i1, collpair->normal, w1 * impulse);
+    VECADDMUL(i2, collpair->normal, w2 * impulse);
+
+    if (!is_hair) {
+      VECADDMUL(i3, collpair->normal, w3 * impulse);
     }
 
-    collision_compute_barycentric(collpair->pb,
-                                  collmd->current_xnew[collpair->bp1].co,
-                                  collmd->current_xnew[collpair->bp2].co,
-                                  collmd->current_xnew[collpair->bp3].co,
-                                  &u1,
-                                  &u2,
-                                  &u3);
-
-    collision_interpolateOnTriangle(v2,
-                                    collmd->current_v[collpair->bp1].co,
-                                    collmd->current_v[collpair->bp2].co,
-                                    collmd->current_v[collpair->bp3].co,
-                                    u1,
-                                    u2,
-                                    u3);
-
-    sub_v3_v3v3(relativeVelocity, v2, v1);
-
-    /* Calculate the normal component of the relative velocity
-     * (actually only the magnitude - the direction is stored in 'normal'). */
-    magrelVel = dot_v3v3(relativeVelocity, collpair->normal);
-
-    /* If magrelVel < 0 the edges are approaching each other. */
-    if (magrelVel > 0.0f) {
-      /* Calculate Impulse magnitude to stop all motion in normal direction. */
-      float magtangent = 0, repulse = 0, d = 0;
-      double impulse = 0.0;
-      float vrel_t_pre[3];
-      float temp[3];
-      float time_multiplier;
-
-      /* Calculate tangential velocity. */
-      copy_v3_v3(temp, collpair->normal);
-      mul_v3_fl(temp, magrelVel);
-      sub_v3_v3v3(vrel_t_pre, relativeVelocity, temp);
-
-      /* Decrease in magnitude of relative tangential velocity due to coulomb friction
-       * in original formula "magrelVel" should be the
-       * "change of relative velocity in normal direction". */
-      magtangent = min_ff(collob->pd->pdef_cfrict * 0.01f * magrelVel, len_v3(vrel_t_pre));
-
-      /* Apply friction impulse. */
-      if (magtangent > ALMOST_ZERO) {
-        normalize_v3(vrel_t_pre);
-
-        impulse = magtangent / 1.5;
-
-        VECADDMUL(i1, vrel_t_pre, w1 * impulse);
-        VECADDMUL(i2, vrel_t_pre, w2 * impulse);
+    time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
 
-        if (!is_hair) {
-          VECADDMUL(i3, vrel_t_pre, w3 * impulse);
-        }
+    d = clmd->coll_parms->epsilon * 8.0f / 9.0f + epsilon2 * 8.0f / 9.0f - collpair->distance;
+
+    if ((magrelVel < 0.1f * d * time_multiplier) && (d > ALMOST_ZERO)) {
+      repulse = MIN2(d / time_multiplier, 0.1f * d * time_multiplier - magrelVel);
+
+      /* Stay on the safe side and clamp repulse. */
+      if (impulse > ALMOST_ZERO) {
+        repulse = min_ff(repulse, 5.0f * impulse);
       }
 
-      /* Apply velocity stopping impulse. */
-      impulse = magrelVel / 1.5f;
+      repulse = max_ff(impulse, repulse);
 
-      VECADDMUL(i1, collpair->normal, w1 * impulse);
-      cloth1->verts[collpair->ap1].impulse_count++;
+      impulse = repulse / 1.5f;
+
+      VECADDMUL(i1, collpair->normal, impulse);
+      VECADDMUL(i2, collpair->normal, impulse);
+
+      if (!is_hair) {
+        VECADDMUL(i3, collpair->normal, impulse);
+      }
+    }
+
+    collided = true;
+  }
+  else {
+    float time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
+    float d;
+
+    d = clmd->coll_parms->epsilon * 8.0f / 9.0f + epsilon2 * 8.0f / 9.0f - collpair->distance;
 
+    if (d > ALMOST_ZERO) {
+      /* Stay on the safe side and clamp repulse. */
+      float repulse = d / time_multiplier;
+      float impulse = repulse / 4.5f;
+
+      VECADDMUL(i1, collpair->normal, w1 * impulse);
       VECADDMUL(i2, collpair->normal, w2 * impulse);
-      cloth1->verts[collpair->ap2].impulse_count++;
 
       if (!is_hair) {
         VECADDMUL(i3, collpair->normal, w3 * impulse);
-        cloth1->verts[collpair->ap3].impulse_count++;
       }
 
-      time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
+      collided = true;
+    }
+  }
 
-      d = clmd->coll_parms->epsilon * 8.0f / 9.0f + epsilon2 * 8.0f / 9.0f - collpair->distance;
+  return collided;
+}
 
-      if ((magrelVel < 0.1f * d * time_multiplier) && (d > ALMOST_ZERO)) {
-        repulse = MIN2(d / time_multiplier, 0.1f * d * time_multiplier - magrelVel);
+/* Compute the impulses of a self collision pair, returns true when the vertices are pushed
+ * apart. */
+static bool cloth_selfcollision_impulse_compute(ClothModifierData *clmd,
+                                                const CollPair *collpair,
+                                                float ia[3][3],
+                                                float ib[3][3])
+{
+  bool collided = false;
+  Cloth *cloth1;
+  float w1, w2, w3, u1, u2, u3;
+  float v1[3], v2[3], relativeVelocity[3];
+  float magrelVel;
 
-        /* Stay on the safe side and clamp repulse. */
-        if (impulse > ALMOST_ZERO) {
-          repulse = min_ff(repulse, 5.0f * impulse);
-        }
+  cloth1 = clmd->clothObject;
+
+  zero_m3(ia);
+  zero_m3(ib);
+
+  /* Compute barycentric coordinates for both collision points. */
+  collision_compute_barycentric(collpair->pa,
+                                cloth1->verts[collpair->ap1].tx,
+                                cloth1->verts[collpair->ap2].tx,
+                                cloth1->verts[collpair->ap3].tx,
+                                &w1,
+                                &w2,
+                                &w3);
+
+  collision_compute_barycentric(collpair->pb,
+                                cloth1->verts[collpair->bp1].tx,
+                                cloth1->verts[collpair->bp2].tx,
+                                cloth1->verts[collpair->bp3].tx,
+                                &u1,
+                                &u2,
+                                &u3);
 
-        repulse = max_ff(impulse, repulse);
+  /* Calculate relative "velocity". */
+  collision_interpolateOnTriangle(v1,
+                                  cloth1->verts[collpair->ap1].tv,
+                                  cloth1->verts[collpair->ap2].tv,
+                                  cloth1->verts[collpair->ap3].tv,
+                                  w1,
+                                  w2,
+                                  w3);
+
+  collision_interpolateOnTriangle(v2,
+                                  cloth1->verts[collpair->bp1].tv,
+                                  cloth1->verts[collpair->bp2].tv,
+                                  cloth1->verts[collpair->bp3].tv,
+                                  u1,
+                                  u2,
+                                  u3);
 
-        impulse = repulse / 1.5f;
+  sub_v3_v3v3(relativeVelocity, v2, v1);
 
-        VECADDMUL(i1, collpair->normal, impulse);
-        VECADDMUL(i2, collpair->normal, impulse);
+  /* Calculate the normal component of the relative velocity
+   * (actually only the magnitude - the direction is stored in 'normal'). */
+  magrelVel = dot_v3v3(relativeVelocity, collpair->normal);
 
-        if (!is_hair) {
-          VECADDMUL(i3, collpair->normal, impulse);
-        }
+  /* TODO: Impulses should be weighed by mass as this is self col,
+   * this has to be done after mass distribution is implemented. */
+
+  /* If magrelVel < 0 the edges are approaching each other. */
+  if (magrelVel > 0.0f) {
+    /* Calculate Impulse magnitude to stop all motion in normal direction. */
+    float magtangent = 0, repulse = 0, d = 0;
+    double impulse = 0.0;
+    float vrel_t_pre[3];
+    float temp[3], time_multiplier;
+
+    /* Calculate tangential velocity. */
+    copy_v3_v3(temp, collpair->normal);
+    mul_v3_fl(temp, magrelVel);
+    sub_v3_v3v3(vrel_t_pre, relativeVelocity, temp);
+
+    /* Decrease in magnitude of relative tangential velocity due to coulomb friction
+     * in original formula "magrelVel" should be the
+     * "change of relative velocity in normal direction". */
+    magtangent = min_ff(clmd->coll_parms->self_friction * 0.01f * magrelVel, len_v3(vrel_t_pre));
+
+    /* Apply friction impulse. */
+    if (magtangent > ALMOST_ZERO) {
+      normalize_v3(vrel_t_pre);
+
+      impulse = magtangent / 1.5;
+
+      VECADDMUL(ia[0], vrel_t_pre, w1 * impulse);
+      VECADDMUL(ia[1], vrel_t_pre, w2 * impulse);
+      VECADDMUL(ia[2], vrel_t_pre, w3 * impulse);
+
+      VECADDMUL(ib[0], vrel_t_pre, -u1 * impulse);
+      VECADDMUL(ib[1], vrel_t_pre, -u2 * impulse);
+      VECADDMUL(ib[2], vrel_t_pre, -u3 * impulse);
+    }
+
+    /* Apply velocity stopping impulse. */
+    impulse = magrelVel / 3.0f;
+
+    VECADDMUL(ia[0], collpair->normal, w1 * impulse);
+    VECADDMUL(ia[1], collpair->normal, w2 * impulse);
+    VECADDMUL(ia[2], collpair->normal, w3 * impulse);
+
+    VECADDMUL(ib[0], collpair->normal, -u1 * impulse);
+    VECADDMUL(ib[1], collpair->normal, -u2 * impulse);
+    VECADDMUL(ib[2], collpair->normal, -u3 * impulse);
+
+    time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
+
+    d = clmd->coll_parms->selfepsilon * 8.0f / 9.0f * 2.0f - collpair->distance;
+
+    if ((magrelVel < 0.1f * d * time_multiplier) && (d > ALMOST_ZERO)) {
+      repulse = MIN2(d / time_multiplier, 0.1f * d * time_multiplier - magrelVel);
+
+      if (impulse > ALMOST_ZERO) {
+        repulse = min_ff(repulse, 5.0 * impulse);
       }
 
-      result = 1;
+      repulse = max_ff(impulse, repulse);
+
+      impulse = repulse / 1.5f;
+
+      VECADDMUL(ia[0], collpair->normal, w1 * impulse);
+      VECADDMUL(ia[1], collpair->normal, w2 * impulse);
+      VECADDMUL(ia[2], collpair->normal, w3 * impulse);
+
+      VECADDMUL(ib[0], collpair->normal, -u1 * impulse);
+      VECADDMUL(ib[1], collpair->normal, -u2 * impulse);
+      VECADDMUL(ib[2], collpair->normal, -u3 * impulse);
     }
-    else {
-      float time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
-      float d;
 
-      d = clmd->coll_parms->epsilon * 8.0f / 9.0f + epsilon2 * 8.0f / 9.0f - collpair->distance;
+    collided = true;
+  }
+  else {
+    float time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
+    float d;
 
-      if (d > ALMOST_ZERO) {
-        /* Stay on the safe side and clamp repulse. */
-        float repulse = d / time_multiplier;
-        float impulse = repulse / 4.5f;
+    d = clmd->coll_parms->selfepsilon * 8.0f / 9.0f * 2.0f - collpair->distance;
 
-        VECADDMUL(i1, collpair->normal, w1 * impulse);
-        VECADDMUL(i2, collpair->normal, w2 * impulse);
+    if (d > ALMOST_ZERO) {
+      /* Stay on the safe side and clamp repulse. */
+      float repulse = d * 1.0f / time_multiplier;
+      float impulse = repulse / 9.0f;
 
-        if (!is_hair) {
-          VECADDMUL(i3, collpair->normal, w3 * impulse);
-        }
+      VECADDMUL(ia[0], collpair->normal, w1 * impulse);
+      VECADDMUL(ia[1], collpair->normal, w2 * impulse);
+      VECADDMUL(ia[2], collpair->normal, w3 * impulse);
 
-        cloth1->verts[collpair->ap1].impulse_count++;
-        cloth1->verts[collpair->ap2].impulse_count++;
+      VECADDMUL(ib[0], collpair->normal, -u1 * impulse);
+      VECADDMUL(ib[1], collpair->normal, -u2 * impulse);
+      VECADDMUL(ib[2], collpair->normal, -u3 * impulse);
 
-        if (!is_hair) {
-          cloth1->verts[collpair->ap3].impulse_count++;
-        }
+      collided = true;
+    }
+  }
+
+  return collided;
+}
+
+static void cloth_collision_impulse_cb(void *__restrict userdata,
+                                       const int index,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CollisionResponseData *data = userdata;
+  const CollPair *collpair = &data->collisions[index];
+  CollisionImpulse *impulse = &data->impulses[index];
+
+  /* Only handle static collisions here. */
+  if (collpair->flag & (COLLISION_IN_FUTURE | COLLISION_INACTIVE)) {
+    impulse->collided = false;
+    return;
+  }
+
+  if (data->collmd) {
+    impulse->collided = cloth_collision_impulse_compute(
+        data->clmd, data->collmd, data->collob, collpair, impulse->impulse_a);
+  }
+  else {
+    impulse->collided = cloth_selfcollision_impulse_compute(
+        data->clmd, collpair, impulse->impulse_a, impulse->impulse_b);
+  }
+}
+
+/* Compute the impulses of all collision pairs in parallel, the caller accumulates them into the
+ * cloth vertices. */
+static CollisionImpulse *cloth_collision_impulses_compute(ClothModifierData *clmd,
+                                                          CollisionModifierData *collmd,
+                                                          Object *collob,
+                                                          CollPair *collisions,
+                                                          uint collision_count)
+{
+  CollisionResponseData data = {
+      .clmd = clmd,
+      .collmd = collmd,
+      .collob = collob,
+      .collisions = collisions,
+      .impulses = MEM_mallocN(sizeof(CollisionImpulse) * collision_count, "collision impulses"),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = true;
+  BLI_task_parallel_range(0, (int)collision_count, &data, cloth_collision_impulse_cb, &settings);
+
+  return data.impulses;
+}
+
+static int cloth_collision_response_static(ClothModifierData *clmd,
+                                           CollisionModifierData *collmd,
+                                           Object *collob,
+                                           CollPair *collpair,
+                                           uint collision_count,
+                                           const float dt)
+{
+  int result = 0;
+  Cloth *cloth1 = clmd->clothObject;
+  const bool is_hair = (clmd->hairdata != NULL);
+
+  if (collision_count == 0) {
+    return result;
+  }
 
-        result = 1;
+  CollisionImpulse *impulses = cloth_collision_impulses_compute(
+      clmd, collmd, collob, collpair, collision_count);
+
+  /* Accumulate in the order of the pairs, for the same result as computing them serially. */
+  for (int i = 0; i < collision_count; i++, collpair++) {
+    const float *i1 = impulses[i].impulse_a[0];
+    const float *i2 = impulses[i].impulse_a[1];
+    const float *i3 = impulses[i].impulse_a[2];
+
+    /* Only handle static collisions here. */
+    if (collpair->flag & (COLLISION_IN_FUTURE | COLLISION_INACTIVE)) {
+      continue;
+    }
+
+    if (impulses[i].collided) {
+      cloth1->verts[collpair->ap1].impulse_count++;
+      cloth1->verts[collpair->ap2].impulse_count++;
+
+      if (!is_hair) {
+        cloth1->verts[collpair->ap3].impulse_count++;
       }
+
+      result = 1;
     }
 
     if (result) {
@@ -851,6 +1118,7 @@ static int cloth_collision_response_static(ClothModifierData *clmd,
 
       if ((clamp > 0.0f) &&
           ((len_v3(i1) > clamp) || (len_v3(i2) > clamp) || (len_v3(i3) > clamp))) {
+        MEM_freeN(impulses);
         return 0;
       }
 
@@ -875,6 +1143,7 @@ static int cloth_collision_response_static(ClothModifierData *clmd,
     }
   }
 
+  MEM_freeN(impulses);
   return result;
 }
 
@@ -909,157 +1178,28 @@ static int cloth_selfcollision_response_static(ClothModifierData *clmd,
                                                const float dt)
 {
   int result = 0;
-  Cloth *cloth1;
-  float w1, w2, w3, u1, u2, u3;
-  float v1[3], v2[3], relativeVelocity[3];
-  float magrelVel;
+  Cloth *cloth1 = clmd->clothObject;
 
-  cloth1 = clmd->clothObject;
+  if (collision_count == 0) {
+    return result;
+  }
+
+  CollisionImpulse *impulses = cloth_collision_impulses_compute(
+      clmd, NULL, NULL, collpair, collision_count);
 
+  /* Accumulate in the order of the pairs, for the same result as computing them serially. */
   for (int i = 0; i < collision_count; i++, collpair++) {
-    float ia[3][3] = {{0.0f}};
-    float ib[3][3] = {{0.0f}};
+    float(*ia)[3] = impulses[i].impulse_a;
+    float(*ib)[3] = impulses[i].impulse_b;
 
     /* Only handle static collisions here. */
     if (collpair->flag & (COLLISION_IN_FUTURE | COLLISION_INACTIVE)) {
       continue;
     }
 
-    /* Compute barycentric coordinates for both collision points. */
-    collision_compute_barycentric(collpair->pa,
-                                  cloth1->verts[collpair->ap1].tx,
-                                  cloth1->verts[collpair->ap2].tx,
-                                  cloth1->verts[collpair->ap3].tx,
-                                  &w1,
-                                  &w2,
-                                  &w3);
-
-    collision_compute_barycentric(collpair->pb,
-                                  cloth1->verts[collpair->bp1].tx,
-                                  cloth1->verts[collpair->bp2].tx,
-                                  cloth1->verts[collpair->bp3].tx,
-                                  &u1,
-                                  &u2,
-                                  &u3);
-
-    /* Calculate relative "velocity". */
-    collision_interpolateOnTriangle(v1,
-                                    cloth1->verts[collpair->ap1].tv,
-                                    cloth1->verts[collpair->ap2].tv,
-                                    cloth1->verts[collpair->ap3].tv,
-                                    w1,
-                                    w2,
-                                    w3);
-
-    collision_interpolateOnTriangle(v2,
-                                    cloth1->verts[collpair->bp1].tv,
-                                    cloth1->verts[collpair->bp2].tv,
-                                    cloth1->verts[collpair->bp3].tv,
-                                    u1,
-                                    u2,
-                                    u3);
-
-    sub_v3_v3v3(relativeVelocity, v2, v1);
-
-    /* Calculate the normal component of the relative velocity
-     * (actually only the magnitude - the direction is stored in 'normal'). */
-    magrelVel = dot_v3v3(relativeVelocity, collpair->normal);
-
-    /* TODO: Impulses should be weighed by mass as this is self col,
-     * this has to be done after mass distribution is implemented. */
-
-    /* If magrelVel < 0 the edges are approaching each other. */
-    if (magrelVel > 0.0f) {
-      /* Calculate Impulse magnitude to stop all motion in normal direction. */
-      float magtangent = 0, repulse = 0, d = 0;
-      double impulse = 0.0;
-      float vrel_t_pre[3];
-      float temp[3], time_multiplier;
-
-      /* Calculate tangential velocity. */
-      copy_v3_v3(temp, collpair->normal);
-      mul_v3_fl(temp, magrelVel);
-      sub_v3_v3v3(vrel_t_pre, relativeVelocity, temp);
-
-      /* Decrease in magnitude of relative tangential velocity due to coulomb friction
-       * in original formula "magrelVel" should be the
-       * "change of relative velocity in normal direction". */
-      magtangent = min_ff(clmd->coll_parms->self_friction * 0.01f * magrelVel, len_v3(vrel_t_pre));
-
-      /* Apply friction impulse. */
-      if (magtangent > ALMOST_ZERO) {
-        normalize_v3(vrel_t_pre);
-
-        impulse = magtangent / 1.5;
-
-        VECADDMUL(ia[0], vrel_t_pre, w1 * impulse);
-        VECADDMUL(ia[1], vrel_t_pre, w2 * impulse);
-        VECADDMUL(ia[2], vrel_t_pre, w3 * impulse);
-
-        VECADDMUL(ib[0], vrel_t_pre, -u1 * impulse);
-        VECADDMUL(ib[1], vrel_t_pre, -u2 * impulse);
-        VECADDMUL(ib[2], vrel_t_pre, -u3 * impulse);
-      }
-
-      /* Apply velocity stopping impulse. */
-      impulse = magrelVel / 3.0f;
-
-      VECADDMUL(ia[0], collpair->normal, w1 * impulse);
-      VECADDMUL(ia[1], collpair->normal, w2 * impulse);
-      VECADDMUL(ia[2], collpair->normal, w3 * impulse);
-
-      VECADDMUL(ib[0], collpair->normal, -u1 * impulse);
-      VECADDMUL(ib[1], collpair->normal, -u2 * impulse);
-      VECADDMUL(ib[2], collpair->normal, -u3 * impulse);
-
-      time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
-
-      d = clmd->coll_parms->selfepsilon * 8.0f / 9.0f * 2.0f - collpair->distance;
-
-      if ((magrelVel < 0.1f * d * time_multiplier) && (d > ALMOST_ZERO)) {
-        repulse = MIN2(d / time_multiplier, 0.1f * d * time_multiplier - magrelVel);
-
-        if (impulse > ALMOST_ZERO) {
-          repulse = min_ff(repulse, 5.0 * impulse);
-        }
-
-        repulse = max_ff(impulse, repulse);
-
-        impulse = repulse / 1.5f;
-
-        VECADDMUL(ia[0], collpair->normal, w1 * impulse);
-        VECADDMUL(ia[1], collpair->normal, w2 * impulse);
-        VECADDMUL(ia[2], collpair->normal, w3 * impulse);
-
-        VECADDMUL(ib[0], collpair->normal, -u1 * impulse);
-        VECADDMUL(ib[1], collpair->normal, -u2 * impulse);
-        VECADDMUL(ib[2], collpair->normal, -u3 * impulse);
-      }
-
+    if (impulses[i].collided) {
       result = 1;
     }
-    else {
-      float time_multiplier = 1.0f / (clmd->sim_parms->dt * clmd->sim_parms->timescale);
-      float d;
-
-      d = clmd->coll_parms->selfepsilon * 8.0f / 9.0f * 2.0f - collpair->distance;
-
-      if (d > ALMOST_ZERO) {
-        /* Stay on the safe side and clamp repulse. */
-        float repulse = d * 1.0f / time_multiplier;
-        float impulse = repulse / 9.0f;
-
-        VECADDMUL(ia[0], collpair->normal, w1 * impulse);
-        VECADDMUL(ia[1], collpair->normal, w2 * impulse);
-        VECADDMUL(ia[2], collpair->normal, w3 * impulse);
-
-        VECADDMUL(ib[0], collpair->normal, -u1 * impulse);
-        VECADDMUL(ib[1], collpair->normal, -u2 * impulse);
-        VECADDMUL(ib[2], collpair->normal, -u3 * impulse);
-
-        result = 1;
-      }
-    }
 
     if (result) {
       float clamp_sq = clmd->coll_parms->self_clamp * dt;
@@ -1075,6 +1215,7 @@ static int cloth_selfcollision_response_static(ClothModifierData *clmd,
     }
   }
 
+  MEM_freeN(impulses);
   return result;
 }
 
@@ -26,6 +26,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 /* Since we have versioning code here (CustomData_verify_versions()). */
 #define DNA_DEPRECATED_ALLOW
 
@@ -41,6 +43,7 @@
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -2164,6 +2167,73 @@ static bool customdata_typemap_is_valid(const CustomData *data)
 }
 #endif
 
+/* -------------------------------------------------------------------- */
+/** \name Shared Layer Data
+ *
+ * Layers copied with #CD_SHARE use the same data array, which is freed by its last user.
+ * \{ */
+
+typedef struct CustomDataLayerShared {
+  int users;
+} CustomDataLayerShared;
+
+/* Layers storing pointers to other allocations are always duplicated. */
+static bool customData_layer_is_shareable(const CustomDataLayer *layer)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+  return !(layer->flag & CD_FLAG_NOFREE) && layer->data && (typeInfo->copy == NULL) &&
+         (typeInfo->free == NULL);
+}
+
+static bool customData_layer_is_shared(const CustomDataLayer *layer)
+{
+  return layer->shared && (layer->shared->users > 1);
+}
+
+static void customData_layer_share_add_user(CustomDataLayer *layer)
+{
+  /* Several evaluated copies of the same data-block may be created from different threads. */
+  if (layer->shared == NULL) {
+    CustomDataLayerShared *shared = MEM_mallocN(sizeof(*shared), __func__);
+    shared->users = 1;
+    if (atomic_cas_ptr((void **)&layer->shared, NULL, shared) != NULL) {
+      MEM_freeN(shared);
+    }
+  }
+  atomic_add_and_fetch_int32(&layer->shared->users, 1);
+}
+
+/* Stop sharing the layer data, returns true when there are no other users left
+ * (in which case the caller is responsible for the data). */
+static bool customData_layer_share_remove_user(CustomDataLayer *layer)
+{
+  CustomDataLayerShared *shared = layer->shared;
+  layer->shared = NULL;
+  if (atomic_sub_and_fetch_int32(&shared->users, 1) == 0) {
+    MEM_freeN(shared);
+    return true;
+  }
+  return false;
+}
+
+/* Give the layer its own copy of shared data. */
+static void customData_layer_unshare(CustomDataLayer *layer)
+{
+  if (layer->shared->users == 1) {
+    customData_layer_share_remove_user(layer);
+    return;
+  }
+
+  /* Only shareable layers are shared, they can be copied with #MEM_dupallocN. */
+  void *data = MEM_dupallocN(layer->data);
+  if (customData_layer_share_remove_user(layer)) {
+    MEM_freeN(layer->data);
+  }
+  layer->data = data;
+}
+
+/** \} */
+
 bool CustomData_merge(const struct CustomData *source,
                       struct CustomData *dest,
                       CustomDataMask mask,
@@ -2215,6 +2285,7 @@ bool CustomData_merge(const struct CustomData *source,
       case CD_ASSIGN:
       case CD_REFERENCE:
       case CD_DUPLICATE:
+      case CD_SHARE:
         data = layer->data;
         break;
       default:
@@ -2226,6 +2297,20 @@ bool CustomData_merge(const struct CustomData *source,
       newlayer = customData_add_layer__internal(
           dest, type, CD_REFERENCE, data, totelem, layer->name);
     }
+    else if (alloctype == CD_SHARE) {
+      if (customData_layer_is_shareable(layer)) {
+        newlayer = customData_add_layer__internal(
+            dest, type, CD_ASSIGN, data, totelem, layer->name);
+        if (newlayer && newlayer->data == data) {
+          customData_layer_share_add_user(layer);
+          newlayer->shared = layer->shared;
+        }
+      }
+      else {
+        newlayer = customData_add_layer__internal(
+            dest, type, CD_DUPLICATE, data, totelem, layer->name);
+      }
+    }
     else {
       newlayer = customData_add_layer__internal(dest, type, alloctype, data, totelem, layer->name);
     }
@@ -2238,6 +2323,10 @@ bool CustomData_merge(const struct CustomData *source,
       newlayer->active_clone = lastclone;
       newlayer->active_mask = lastmask;
       newlayer->flag |= flag & (CD_FLAG_EXTERNAL | CD_FLAG_IN_MEMORY);
+      if ((alloctype == CD_ASSIGN) && (newlayer->data == layer->data)) {
+        /* The user count is moved over along with the data. */
+        newlayer->shared = layer->shared;
+      }
       changed = true;
     }
   }
@@ -2256,6 +2345,9 @@ void CustomData_realloc(CustomData *data, int totelem)
     if (layer->flag & CD_FLAG_NOFREE) {
       continue;
     }
+    if (layer->shared) {
+      customData_layer_unshare(layer);
+    }
     typeInfo = layerType_getInfo(layer->type);
     layer->data = MEM_reallocN(layer->data, (size_t)totelem * typeInfo->size);
   }
@@ -2281,6 +2373,11 @@ static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
   const LayerTypeInfo *typeInfo;
 
   if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
+    if (layer->shared && !customData_layer_share_remove_user(layer)) {
+      /* Still used by other layers. */
+      return;
+    }
+
     typeInfo = layerType_getInfo(layer->type);
 
     if (typeInfo->free) {
@@ -2680,6 +2777,7 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
   data->layers[index].type = type;
   data->layers[index].flag = flag;
   data->layers[index].data = newlayerdata;
+  data->layers[index].shared = NULL;
 
   /* Set default name if none exists. Note we only call DATA_()  once
    * we know there is a default name, to avoid overhead of locale lookups
@@ -2884,6 +2982,9 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
 
     layer->flag &= ~CD_FLAG_NOFREE;
   }
+  else if (layer->shared) {
+    customData_layer_unshare(layer);
+  }
 
   return layer->data;
 }
@@ -2937,7 +3038,47 @@ bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 
   layer = &data->layers[layer_index];
 
-  return (layer->flag & CD_FLAG_NOFREE) != 0;
+  return (layer->flag & CD_FLAG_NOFREE) || customData_layer_is_shared(layer);
+}
+
+/**
+ * Use the arrays of \a data_old for the layers of \a data which didn't change (same type, name
+ * and content), so unchanged data keeps its memory (and stays identical for undo for example).
+ * The replaced arrays are moved to \a data_old, which is expected to be freed afterwards.
+ */
+void CustomData_keep_unchanged_layers(CustomData *data,
+                                      CustomData *data_old,
+                                      const int totelem,
+                                      const int totelem_old)
+{
+  if (totelem != totelem_old) {
+    return;
+  }
+
+  for (int i = 0; i < data->totlayer; i++) {
+    CustomDataLayer *layer = &data->layers[i];
+    const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+
+    /* Layers referencing other allocations can't be compared. */
+    if ((layer->flag & CD_FLAG_NOFREE) || (layer->data == NULL) || typeInfo->copy ||
+        typeInfo->free) {
+      continue;
+    }
+
+    const int index_old = CustomData_get_named_layer_index(data_old, layer->type, layer->name);
+    if (index_old == -1) {
+      continue;
+    }
+    CustomDataLayer *layer_old = &data_old->layers[index_old];
+    if ((layer_old->flag & CD_FLAG_NOFREE) || (layer_old->data == NULL)) {
+      continue;
+    }
+
+    if (memcmp(layer->data, layer_old->data, (size_t)totelem * typeInfo->size) == 0) {
+      SWAP(void *, layer->data, layer_old->data);
+      SWAP(CustomDataLayerShared *, layer->shared, layer_old->shared);
+    }
+  }
 }
 
 void CustomData_free_temporary(CustomData *data, int totelem)
@@ -3362,6 +3503,15 @@ const char *CustomData_get_layer_name(const CustomData *data, int type, int n)
   return (layer_index == -1) ? NULL : data->layers[layer_index].name;
 }
 
+static void customData_set_layer_data(CustomDataLayer *layer, void *ptr)
+{
+  /* The previous data is left to the other users, or to the caller when there are none left. */
+  if (layer->shared) {
+    customData_layer_share_remove_user(layer);
+  }
+  layer->data = ptr;
+}
+
 void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
 {
   /* get the layer index of the first layer of type */
@@ -3371,7 +3521,7 @@ void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
     return NULL;
   }
 
-  data->layers[layer_index].data = ptr;
+  customData_set_layer_data(&data->layers[layer_index], ptr);
 
   return ptr;
 }
@@ -3384,7 +3534,7 @@ void *CustomData_set_layer_n(const struct CustomData *data, int type, int n, voi
     return NULL;
   }
 
-  data->layers[layer_index].data = ptr;
+  customData_set_layer_data(&data->layers[layer_index], ptr);
 
   return ptr;
 }
@@ -4000,7 +4150,7 @@ bool CustomData_has_referenced(const struct CustomData *data)
 {
   int i;
   for (i = 0; i < data->totlayer; i++) {
-    if (data->layers[i].flag & CD_FLAG_NOFREE) {
+    if ((data->layers[i].flag & CD_FLAG_NOFREE) || customData_layer_is_shared(&data->layers[i])) {
       return true;
     }
   }
@@ -4312,6 +4462,121 @@ void CustomData_from_bmesh_block(const CustomData *source,
   }
 }
 
+typedef struct CustomDataBMeshBlocksData {
+  const CustomData *source;
+  CustomData *dest;
+  BMHeader *const *elems;
+  bool use_default_init;
+
+  /* For a single layer. */
+  const LayerTypeInfo *typeInfo;
+  void *const *blocks;
+  int offset;
+  void *data;
+} CustomDataBMeshBlocksData;
+
+static void customData_to_bmesh_block_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CustomDataBMeshBlocksData *data = userdata;
+  BMHeader *head = data->elems[i];
+  if (head != NULL) {
+    CustomData_to_bmesh_block(data->source, data->dest, i, &head->data, data->use_default_init);
+  }
+}
+
+/**
+ * Same as calling #CustomData_to_bmesh_block for every element, in parallel.
+ *
+ * \param elems: The elements to copy the data of \a source at the same index to,
+ * may contain NULL for elements that are skipped.
+ */
+void CustomData_to_bmesh_blocks(const CustomData *source,
+                                CustomData *dest,
+                                BMHeader *const *elems,
+                                const int totelem,
+                                bool use_default_init)
+{
+  /* The memory pool isn't thread-safe, allocate all blocks up-front. */
+  if (dest->totsize > 0) {
+    for (int i = 0; i < totelem; i++) {
+      if (elems[i] && elems[i]->data == NULL) {
+        elems[i]->data = BLI_mempool_alloc(dest->pool);
+      }
+    }
+  }
+
+  CustomDataBMeshBlocksData data = {
+      .source = source,
+      .dest = dest,
+      .elems = elems,
+      .use_default_init = use_default_init,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, totelem, &data, customData_to_bmesh_block_cb, &settings);
+}
+
+static void customData_from_bmesh_blocks_layer_cb(void *__restrict userdata,
+                                                  const int i,
+                                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CustomDataBMeshBlocksData *data = userdata;
+  const LayerTypeInfo *typeInfo = data->typeInfo;
+  const void *src_data = POINTER_OFFSET(data->blocks[i], data->offset);
+  void *dst_data = POINTER_OFFSET(data->data, (size_t)i * typeInfo->size);
+
+  if (typeInfo->copy) {
+    typeInfo->copy(src_data, dst_data, 1);
+  }
+  else {
+    memcpy(dst_data, src_data, typeInfo->size);
+  }
+}
+
+/**
+ * Same as calling #CustomData_from_bmesh_block for every element, but copies one layer at a time
+ * (in parallel) so every destination array is filled in order and the layer lookup is only done
+ * once.
+ *
+ * \param src_blocks: The custom-data blocks of the elements, in destination index order.
+ */
+void CustomData_from_bmesh_blocks(const CustomData *source,
+                                  CustomData *dest,
+                                  void *const *src_blocks,
+                                  const int totelem)
+{
+  CustomDataBMeshBlocksData data = {
+      .blocks = src_blocks,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+
+  int dest_i = 0;
+  for (int src_i = 0; src_i < source->totlayer; src_i++) {
+    while (dest_i < dest->totlayer && dest->layers[dest_i].type < source->layers[src_i].type) {
+      dest_i++;
+    }
+
+    if (dest_i >= dest->totlayer) {
+      return;
+    }
+
+    if (dest->layers[dest_i].type == source->layers[src_i].type) {
+      data.typeInfo = layerType_getInfo(dest->layers[dest_i].type);
+      data.offset = source->layers[src_i].offset;
+      data.data = dest->layers[dest_i].data;
+      BLI_task_parallel_range(
+          0, totelem, &data, customData_from_bmesh_blocks_layer_cb, &settings);
+
+      dest_i++;
+    }
+  }
+}
+
 void CustomData_file_write_info(int type, const char **r_struct_name, int *r_struct_num)
 {
   const LayerTypeInfo *typeInfo = layerType_getInfo(type);
@@ -4371,7 +4636,8 @@ void CustomData_file_write_prepare(CustomData *data,
         }
         write_layers_size += chunk_size;
       }
-      write_layers[j++] = *layer;
+      write_layers[j] = *layer;
+      write_layers[j++].shared = NULL;
     }
   }
   BLI_assert(j == data->totlayer);
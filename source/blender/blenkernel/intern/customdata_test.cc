@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+
+#include "DNA_customdata_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+static const int totelem = 16;
+
+static CustomData customdata_with_verts()
+{
+  CustomData data;
+  CustomData_reset(&data);
+  MVert *mvert = (MVert *)CustomData_add_layer(&data, CD_MVERT, CD_CALLOC, NULL, totelem);
+  for (int i = 0; i < totelem; i++) {
+    mvert[i].co[0] = (float)i;
+  }
+  return data;
+}
+
+TEST(customdata_share, SharedUntilDuplicated)
+{
+  CustomData data = customdata_with_verts();
+  CustomData copy;
+  CustomData_copy(&data, &copy, CD_MASK_MVERT, CD_SHARE, totelem);
+
+  const MVert *mvert = (const MVert *)CustomData_get_layer(&data, CD_MVERT);
+  EXPECT_EQ(mvert, CustomData_get_layer(&copy, CD_MVERT));
+  EXPECT_TRUE(CustomData_is_referenced_layer(&copy, CD_MVERT));
+  EXPECT_TRUE(CustomData_is_referenced_layer(&data, CD_MVERT));
+
+  MVert *mvert_copy = (MVert *)CustomData_duplicate_referenced_layer(&copy, CD_MVERT, totelem);
+  EXPECT_NE(mvert, mvert_copy);
+  EXPECT_FALSE(CustomData_is_referenced_layer(&copy, CD_MVERT));
+  EXPECT_EQ(mvert[totelem - 1].co[0], mvert_copy[totelem - 1].co[0]);
+
+  /* The last user owns the data again. */
+  EXPECT_FALSE(CustomData_is_referenced_layer(&data, CD_MVERT));
+  EXPECT_EQ(mvert, CustomData_duplicate_referenced_layer(&data, CD_MVERT, totelem));
+
+  CustomData_free(&copy, totelem);
+  CustomData_free(&data, totelem);
+}
+
+TEST(customdata_share, FreeSourceFirst)
+{
+  const size_t blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  CustomData data = customdata_with_verts();
+  CustomData copy_a, copy_b;
+  CustomData_copy(&data, &copy_a, CD_MASK_MVERT, CD_SHARE, totelem);
+  CustomData_copy(&copy_a, &copy_b, CD_MASK_MVERT, CD_SHARE, totelem);
+
+  /* The data stays available for the remaining users. */
+  CustomData_free(&data, totelem);
+  const MVert *mvert = (const MVert *)CustomData_get_layer(&copy_b, CD_MVERT);
+  EXPECT_EQ(mvert, CustomData_get_layer(&copy_a, CD_MVERT));
+  EXPECT_EQ((float)(totelem - 1), mvert[totelem - 1].co[0]);
+
+  CustomData_realloc(&copy_a, totelem * 2);
+  EXPECT_NE(mvert, CustomData_get_layer(&copy_a, CD_MVERT));
+  EXPECT_EQ(mvert, CustomData_get_layer(&copy_b, CD_MVERT));
+
+  CustomData_free(&copy_a, totelem * 2);
+  CustomData_free(&copy_b, totelem);
+
+  EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+}
+
+TEST(customdata_share, MutableWithoutCopyWhenSourceFreed)
+{
+  CustomData data = customdata_with_verts();
+  CustomData copy;
+  CustomData_copy(&data, &copy, CD_MASK_MVERT, CD_SHARE, totelem);
+  const void *mvert = CustomData_get_layer(&data, CD_MVERT);
+  CustomData_free(&data, totelem);
+
+  /* Taking over the data from a temporary mesh doesn't copy it. */
+  EXPECT_FALSE(CustomData_has_referenced(&copy));
+  EXPECT_EQ(mvert, CustomData_duplicate_referenced_layer(&copy, CD_MVERT, totelem));
+
+  CustomData_free(&copy, totelem);
+}
+
+TEST(customdata_share, ComplexLayersDuplicated)
+{
+  CustomData data;
+  CustomData_reset(&data);
+  CustomData_add_layer(&data, CD_MDEFORMVERT, CD_CALLOC, NULL, totelem);
+
+  CustomData copy;
+  CustomData_copy(&data, &copy, CD_MASK_MDEFORMVERT, CD_SHARE, totelem);
+  EXPECT_NE(CustomData_get_layer(&data, CD_MDEFORMVERT),
+            CustomData_get_layer(&copy, CD_MDEFORMVERT));
+  EXPECT_FALSE(CustomData_is_referenced_layer(&copy, CD_MDEFORMVERT));
+
+  CustomData_free(&copy, totelem);
+  CustomData_free(&data, totelem);
+}
+
+}  // namespace blender::bke::tests
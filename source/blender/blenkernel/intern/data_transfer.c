@@ -33,6 +33,7 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 
@@ -1377,6 +1378,130 @@ void BKE_object_data_transfer_layout(struct Depsgraph *depsgraph,
   }
 }
 
+typedef struct DataTransferGeomMapCache {
+  /* One mapping per item type: vertices, edges, face corners and faces. */
+  MeshPairRemap geom_map[4];
+  /* Hash of the inputs each mapping was computed from, zero when it can't be reused. */
+  uint32_t keys[4];
+} DataTransferGeomMapCache;
+
+DataTransferGeomMapCache *BKE_object_data_transfer_geom_map_cache_new(void)
+{
+  return MEM_callocN(sizeof(DataTransferGeomMapCache), __func__);
+}
+
+void BKE_object_data_transfer_geom_map_cache_free(DataTransferGeomMapCache *cache)
+{
+  if (cache == NULL) {
+    return;
+  }
+  for (int i = 0; i < ARRAY_SIZE(cache->geom_map); i++) {
+    BKE_mesh_remap_free(&cache->geom_map[i]);
+  }
+  MEM_freeN(cache);
+}
+
+/* Hash the geometry a mapping can depend on (coordinates, normals, topology, custom normals). */
+static uint32_t data_transfer_mesh_geom_hash(const Mesh *me)
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+
+  BLI_hash_mm2a_add_int(&mm2, me->totvert);
+  BLI_hash_mm2a_add_int(&mm2, me->totedge);
+  BLI_hash_mm2a_add_int(&mm2, me->totpoly);
+  BLI_hash_mm2a_add_int(&mm2, me->totloop);
+  if (me->totvert) {
+    BLI_hash_mm2a_add(&mm2, (const uchar *)me->mvert, sizeof(*me->mvert) * (size_t)me->totvert);
+  }
+  if (me->totedge) {
+    BLI_hash_mm2a_add(&mm2, (const uchar *)me->medge, sizeof(*me->medge) * (size_t)me->totedge);
+  }
+  if (me->totpoly) {
+    BLI_hash_mm2a_add(&mm2, (const uchar *)me->mpoly, sizeof(*me->mpoly) * (size_t)me->totpoly);
+  }
+  if (me->totloop) {
+    BLI_hash_mm2a_add(&mm2, (const uchar *)me->mloop, sizeof(*me->mloop) * (size_t)me->totloop);
+
+    const short(*clnors)[2] = CustomData_get_layer(&me->ldata, CD_CUSTOMLOOPNORMAL);
+    if (clnors) {
+      BLI_hash_mm2a_add(&mm2, (const uchar *)clnors, sizeof(*clnors) * (size_t)me->totloop);
+    }
+  }
+  BLI_hash_mm2a_add_int(&mm2, me->flag & ME_AUTOSMOOTH);
+  BLI_hash_mm2a_add(&mm2, (const uchar *)&me->smoothresh, sizeof(me->smoothresh));
+
+  return BLI_hash_mm2a_end(&mm2);
+}
+
+/**
+ * Compute the key of a geometry mapping, from all the inputs of the `BKE_mesh_remap_calc_*`
+ * functions. Topology mappings only depend on the amount of items, other ones on the geometry of
+ * both meshes, which is hashed once and stored in \a mesh_hashes.
+ */
+static uint32_t data_transfer_geom_map_key(const int item_type,
+                                           const int map_mode,
+                                           const SpaceTransform *space_transform,
+                                           const float max_distance,
+                                           const float ray_radius,
+                                           const bool dirty_nors_dst,
+                                           const Mesh *me_src,
+                                           const Mesh *me_dst,
+                                           uint32_t mesh_hashes[2])
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+
+  BLI_hash_mm2a_add_int(&mm2, item_type);
+  BLI_hash_mm2a_add_int(&mm2, map_mode);
+  BLI_hash_mm2a_add_int(&mm2, dirty_nors_dst);
+  BLI_hash_mm2a_add(&mm2, (const uchar *)&max_distance, sizeof(max_distance));
+  BLI_hash_mm2a_add(&mm2, (const uchar *)&ray_radius, sizeof(ray_radius));
+  if (space_transform) {
+    BLI_hash_mm2a_add(&mm2, (const uchar *)space_transform, sizeof(*space_transform));
+  }
+
+  if (map_mode == MREMAP_MODE_TOPOLOGY) {
+    BLI_hash_mm2a_add_int(&mm2, me_src->totvert);
+    BLI_hash_mm2a_add_int(&mm2, me_src->totedge);
+    BLI_hash_mm2a_add_int(&mm2, me_src->totpoly);
+    BLI_hash_mm2a_add_int(&mm2, me_src->totloop);
+    BLI_hash_mm2a_add_int(&mm2, me_dst->totvert);
+    BLI_hash_mm2a_add_int(&mm2, me_dst->totedge);
+    BLI_hash_mm2a_add_int(&mm2, me_dst->totpoly);
+    BLI_hash_mm2a_add_int(&mm2, me_dst->totloop);
+  }
+  else {
+    if (mesh_hashes[0] == 0) {
+      mesh_hashes[0] = data_transfer_mesh_geom_hash(me_src);
+      mesh_hashes[1] = data_transfer_mesh_geom_hash(me_dst);
+    }
+    BLI_hash_mm2a_add_int(&mm2, (int)mesh_hashes[0]);
+    BLI_hash_mm2a_add_int(&mm2, (int)mesh_hashes[1]);
+  }
+
+  const uint32_t key = BLI_hash_mm2a_end(&mm2);
+  return key ? key : 1;
+}
+
+/**
+ * \return True when the cached mapping of \a index was computed from the same inputs.
+ * Otherwise the mapping is about to be recomputed, and \a key is stored for the next check.
+ */
+static bool data_transfer_geom_map_is_cached(DataTransferGeomMapCache *geom_map_cache,
+                                             const int index,
+                                             const uint32_t key)
+{
+  if (geom_map_cache == NULL) {
+    return false;
+  }
+  if (key != 0 && geom_map_cache->keys[index] == key) {
+    return true;
+  }
+  geom_map_cache->keys[index] = key;
+  return false;
+}
+
 bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                  Scene *scene,
                                  Object *ob_src,
@@ -1399,6 +1524,7 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                  const float mix_factor,
                                  const char *vgroup_name,
                                  const bool invert_vgroup,
+                                 DataTransferGeomMapCache *geom_map_cache,
                                  ReportList *reports)
 {
 #define VDATA 0
@@ -1418,8 +1544,11 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
   int vg_idx = -1;
   float *weights[DATAMAX] = {NULL};
 
-  MeshPairRemap geom_map[DATAMAX] = {{0}};
+  MeshPairRemap geom_map_local[DATAMAX] = {{0}};
+  /* Mappings are kept in the cache when there is one, see #data_transfer_geom_map_is_cached. */
+  MeshPairRemap *geom_map = geom_map_cache ? geom_map_cache->geom_map : geom_map_local;
   bool geom_map_init[DATAMAX] = {0};
+  uint32_t mesh_hashes[2] = {0};
   ListBase lay_map = {NULL};
   bool changed = false;
   bool is_modifier = false;
@@ -1537,15 +1666,27 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_verts_from_mesh(map_vert_mode,
-                                            space_transform,
-                                            max_distance,
-                                            ray_radius,
-                                            verts_dst,
-                                            num_verts_dst,
-                                            dirty_nors_dst,
-                                            me_src,
-                                            &geom_map[VDATA]);
+        const uint32_t key = geom_map_cache ? data_transfer_geom_map_key(ME_VERT,
+                                                                         map_vert_mode,
+                                                                         space_transform,
+                                                                         max_distance,
+                                                                         ray_radius,
+                                                                         dirty_nors_dst,
+                                                                         me_src,
+                                                                         me_dst,
+                                                                         mesh_hashes) :
+                                              0;
+        if (!data_transfer_geom_map_is_cached(geom_map_cache, VDATA, key)) {
+          BKE_mesh_remap_calc_verts_from_mesh(map_vert_mode,
+                                              space_transform,
+                                              max_distance,
+                                              ray_radius,
+                                              verts_dst,
+                                              num_verts_dst,
+                                              dirty_nors_dst,
+                                              me_src,
+                                              &geom_map[VDATA]);
+        }
         geom_map_init[VDATA] = true;
       }
 
@@ -1613,17 +1754,29 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_edges_from_mesh(map_edge_mode,
-                                            space_transform,
-                                            max_distance,
-                                            ray_radius,
-                                            verts_dst,
-                                            num_verts_dst,
-                                            edges_dst,
-                                            num_edges_dst,
-                                            dirty_nors_dst,
-                                            me_src,
-                                            &geom_map[EDATA]);
+        const uint32_t key = geom_map_cache ? data_transfer_geom_map_key(ME_EDGE,
+                                                                         map_edge_mode,
+                                                                         space_transform,
+                                                                         max_distance,
+                                                                         ray_radius,
+                                                                         dirty_nors_dst,
+                                                                         me_src,
+                                                                         me_dst,
+                                                                         mesh_hashes) :
+                                              0;
+        if (!data_transfer_geom_map_is_cached(geom_map_cache, EDATA, key)) {
+          BKE_mesh_remap_calc_edges_from_mesh(map_edge_mode,
+                                              space_transform,
+                                              max_distance,
+                                              ray_radius,
+                                              verts_dst,
+                                              num_verts_dst,
+                                              edges_dst,
+                                              num_edges_dst,
+                                              dirty_nors_dst,
+                                              me_src,
+                                              &geom_map[EDATA]);
+        }
         geom_map_init[EDATA] = true;
       }
 
@@ -1699,27 +1852,41 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_loops_from_mesh(map_loop_mode,
-                                            space_transform,
-                                            max_distance,
-                                            ray_radius,
-                                            verts_dst,
-                                            num_verts_dst,
-                                            edges_dst,
-                                            num_edges_dst,
-                                            loops_dst,
-                                            num_loops_dst,
-                                            polys_dst,
-                                            num_polys_dst,
-                                            ldata_dst,
-                                            pdata_dst,
-                                            (me_dst->flag & ME_AUTOSMOOTH) != 0,
-                                            me_dst->smoothresh,
-                                            dirty_nors_dst,
-                                            me_src,
-                                            island_callback,
-                                            islands_handling_precision,
-                                            &geom_map[LDATA]);
+        /* Islands depend on the transferred data itself (UVs), never reuse such mappings. */
+        const uint32_t key = (geom_map_cache && island_callback == NULL) ?
+                                 data_transfer_geom_map_key(ME_LOOP,
+                                                            map_loop_mode,
+                                                            space_transform,
+                                                            max_distance,
+                                                            ray_radius,
+                                                            dirty_nors_dst,
+                                                            me_src,
+                                                            me_dst,
+                                                            mesh_hashes) :
+                                 0;
+        if (!data_transfer_geom_map_is_cached(geom_map_cache, LDATA, key)) {
+          BKE_mesh_remap_calc_loops_from_mesh(map_loop_mode,
+                                              space_transform,
+                                              max_distance,
+                                              ray_radius,
+                                              verts_dst,
+                                              num_verts_dst,
+                                              edges_dst,
+                                              num_edges_dst,
+                                              loops_dst,
+                                              num_loops_dst,
+                                              polys_dst,
+                                              num_polys_dst,
+                                              ldata_dst,
+                                              pdata_dst,
+                                              (me_dst->flag & ME_AUTOSMOOTH) != 0,
+                                              me_dst->smoothresh,
+                                              dirty_nors_dst,
+                                              me_src,
+                                              island_callback,
+                                              islands_handling_precision,
+                                              &geom_map[LDATA]);
+        }
         geom_map_init[LDATA] = true;
       }
 
@@ -1790,20 +1957,32 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
           continue;
         }
 
-        BKE_mesh_remap_calc_polys_from_mesh(map_poly_mode,
-                                            space_transform,
-                                            max_distance,
-                                            ray_radius,
-                                            verts_dst,
-                                            num_verts_dst,
-                                            loops_dst,
-                                            num_loops_dst,
-                                            polys_dst,
-                                            num_polys_dst,
-                                            pdata_dst,
-                                            dirty_nors_dst,
-                                            me_src,
-                                            &geom_map[PDATA]);
+        const uint32_t key = geom_map_cache ? data_transfer_geom_map_key(ME_POLY,
+                                                                         map_poly_mode,
+                                                                         space_transform,
+                                                                         max_distance,
+                                                                         ray_radius,
+                                                                         dirty_nors_dst,
+                                                                         me_src,
+                                                                         me_dst,
+                                                                         mesh_hashes) :
+                                              0;
+        if (!data_transfer_geom_map_is_cached(geom_map_cache, PDATA, key)) {
+          BKE_mesh_remap_calc_polys_from_mesh(map_poly_mode,
+                                              space_transform,
+                                              max_distance,
+                                              ray_radius,
+                                              verts_dst,
+                                              num_verts_dst,
+                                              loops_dst,
+                                              num_loops_dst,
+                                              polys_dst,
+                                              num_polys_dst,
+                                              pdata_dst,
+                                              dirty_nors_dst,
+                                              me_src,
+                                              &geom_map[PDATA]);
+        }
         geom_map_init[PDATA] = true;
       }
 
@@ -1852,7 +2031,9 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
   }
 
   for (i = 0; i < DATAMAX; i++) {
-    BKE_mesh_remap_free(&geom_map[i]);
+    if (geom_map_cache == NULL) {
+      BKE_mesh_remap_free(&geom_map[i]);
+    }
     MEM_SAFE_FREE(weights[i]);
   }
 
@@ -1910,5 +2091,6 @@ bool BKE_object_data_transfer_mesh(struct Depsgraph *depsgraph,
                                      mix_factor,
                                      vgroup_name,
                                      invert_vgroup,
+                                     NULL,
                                      reports);
 }
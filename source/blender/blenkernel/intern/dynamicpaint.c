@@ -4982,13 +4982,136 @@ static void surface_determineForceTargetPoints(const PaintSurfaceData *sData,
   }
 }
 
+typedef struct DynamicPaintEffectData {
+  const DynamicPaintSurface *surface;
+  Scene *scene;
+
+  float *force;
+  ListBase *effectors;
+  const void *prevPoint;
+  const float eff_scale;
+  const float smudge_strength;
+
+  uint8_t *point_locks;
+
+  const float wave_speed;
+  const float wave_scale;
+  const float wave_max_slope;
+
+  const float dt;
+  const float min_dist;
+  const float damp_factor;
+  const bool reset_wave;
+} DynamicPaintEffectData;
+
+/* Sort of spinlock, but only for given point.
+ * Since the odds a same point is modified at the same time by several threads is very low,
+ * this is much more efficient than a global spin lock. */
+BLI_INLINE void dynamic_paint_point_lock(uint8_t *point_locks, const unsigned int index)
+{
+  const unsigned int lock_idx = index / 8;
+  const uint8_t lock_bitmask = 1 << (index & 7); /* 7 == 0b111 */
+  while (atomic_fetch_and_or_uint8(&point_locks[lock_idx], lock_bitmask) & lock_bitmask) {
+    /* pass */
+  }
+}
+
+BLI_INLINE void dynamic_paint_point_unlock(uint8_t *point_locks, const unsigned int index)
+{
+  const unsigned int lock_idx = index / 8;
+  const uint8_t lock_bitmask = 1 << (index & 7); /* 7 == 0b111 */
+#ifndef NDEBUG
+  {
+    uint8_t ret = atomic_fetch_and_and_uint8(&point_locks[lock_idx], ~lock_bitmask);
+    BLI_assert(ret & lock_bitmask);
+  }
+#else
+  atomic_fetch_and_and_uint8(&point_locks[lock_idx], ~lock_bitmask);
+#endif
+}
+
+static void dynamic_paint_smudge_cb(void *__restrict userdata,
+                                    const int index,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const DynamicPaintEffectData *data = userdata;
+
+  const DynamicPaintSurface *surface = data->surface;
+  const PaintSurfaceData *sData = surface->data;
+
+  if (sData->adj_data->flags[index] & ADJ_BORDER_PIXEL) {
+    return;
+  }
+
+  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
+  PaintPoint *pPoint = &((PaintPoint *)sData->type_data)[index];
+  const PaintPoint *pPoint_prev = &((const PaintPoint *)data->prevPoint)[index];
+  const float *brush_velocity = data->force;
+  const float smudge_str = brush_velocity[index * 4 + 3];
+  const float eff_scale = data->eff_scale;
+
+  /* force targets */
+  int closest_id[2];
+  float closest_d[2];
+
+  if (!smudge_str) {
+    return;
+  }
+
+  /* get force affect points */
+  surface_determineForceTargetPoints(
+      sData, index, &brush_velocity[index * 4], closest_d, closest_id);
+
+  /* Apply movement towards those two points */
+  for (int i = 0; i < 2; i++) {
+    const int n_index = closest_id[i];
+    if (n_index != -1 && closest_d[i] > 0.0f) {
+      const float dir_dot = closest_d[i];
+      const float speed_scale = eff_scale * smudge_str / bNeighs[n_index].dist;
+      const unsigned int n_trgt = (unsigned int)sData->adj_data->n_target[n_index];
+
+      /* just skip if angle is too extreme */
+      if (dir_dot <= 0.0f) {
+        continue;
+      }
+
+      float dir_factor = dir_dot * speed_scale;
+      CLAMP_MAX(dir_factor, data->smudge_strength);
+
+      /* Only the color layers of the target point are written here, and only the wetness
+       * of the current one, so only the target needs to be locked. */
+      dynamic_paint_point_lock(data->point_locks, n_trgt);
+
+      PaintPoint *ePoint = &((PaintPoint *)sData->type_data)[n_trgt];
+
+      /* mix new color and alpha */
+      mixColors(
+          ePoint->color, ePoint->color[3], pPoint_prev->color, pPoint_prev->color[3], dir_factor);
+      ePoint->color[3] = ePoint->color[3] * (1.0f - dir_factor) +
+                         pPoint_prev->color[3] * dir_factor;
+
+      /* smudge "wet layer" */
+      mixColors(ePoint->e_color,
+                ePoint->e_color[3],
+                pPoint_prev->e_color,
+                pPoint_prev->e_color[3],
+                dir_factor);
+      ePoint->e_color[3] = ePoint->e_color[3] * (1.0f - dir_factor) +
+                           pPoint_prev->e_color[3] * dir_factor;
+
+      dynamic_paint_point_unlock(data->point_locks, n_trgt);
+
+      pPoint->wetness *= (1.0f - dir_factor);
+    }
+  }
+}
+
 static void dynamicPaint_doSmudge(DynamicPaintSurface *surface,
                                   DynamicPaintBrushSettings *brush,
                                   float timescale)
 {
   PaintSurfaceData *sData = surface->data;
   PaintBakeData *bData = sData->bData;
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
   int index, steps, step;
   float eff_scale, max_velocity = 0.0f;
 
@@ -5004,88 +5127,37 @@ static void dynamicPaint_doSmudge(DynamicPaintSurface *surface,
 
   steps = (int)ceil((double)max_velocity / bData->average_dist * (double)timescale);
   CLAMP(steps, 0, 12);
+  if (steps == 0) {
+    return;
+  }
   eff_scale = brush->smudge_strength / (float)steps * timescale;
 
-  for (step = 0; step < steps; step++) {
-    for (index = 0; index < sData->total_points; index++) {
-      int i;
-
-      if (sData->adj_data->flags[index] & ADJ_BORDER_PIXEL) {
-        continue;
-      }
-
-      PaintPoint *pPoint = &((PaintPoint *)sData->type_data)[index];
-      float smudge_str = bData->brush_velocity[index * 4 + 3];
-
-      /* force targets */
-      int closest_id[2];
-      float closest_d[2];
+  /* Smudged colors are read from the previous step, so points can be processed in any order. */
+  PaintPoint *prevPoint = MEM_mallocN(sData->total_points * sizeof(*prevPoint), __func__);
+  /* Same as BLI_bitmask, but handled atomicaly as 'ePoint' locks. */
+  const size_t point_locks_size = (sData->total_points / 8) + 1;
+  uint8_t *point_locks = MEM_callocN(sizeof(*point_locks) * point_locks_size, __func__);
 
-      if (!smudge_str) {
-        continue;
-      }
-
-      /* get force affect points */
-      surface_determineForceTargetPoints(
-          sData, index, &bData->brush_velocity[index * 4], closest_d, closest_id);
-
-      /* Apply movement towards those two points */
-      for (i = 0; i < 2; i++) {
-        int n_index = closest_id[i];
-        if (n_index != -1 && closest_d[i] > 0.0f) {
-          float dir_dot = closest_d[i], dir_factor;
-          float speed_scale = eff_scale * smudge_str / bNeighs[n_index].dist;
-          PaintPoint *ePoint = &(
-              (PaintPoint *)sData->type_data)[sData->adj_data->n_target[n_index]];
-
-          /* just skip if angle is too extreme */
-          if (dir_dot <= 0.0f) {
-            continue;
-          }
+  DynamicPaintEffectData data = {
+      .surface = surface,
+      .force = bData->brush_velocity,
+      .prevPoint = prevPoint,
+      .eff_scale = eff_scale,
+      .smudge_strength = brush->smudge_strength,
+      .point_locks = point_locks,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (sData->total_points > 1000);
 
-          dir_factor = dir_dot * speed_scale;
-          CLAMP_MAX(dir_factor, brush->smudge_strength);
-
-          /* mix new color and alpha */
-          mixColors(ePoint->color, ePoint->color[3], pPoint->color, pPoint->color[3], dir_factor);
-          ePoint->color[3] = ePoint->color[3] * (1.0f - dir_factor) +
-                             pPoint->color[3] * dir_factor;
-
-          /* smudge "wet layer" */
-          mixColors(ePoint->e_color,
-                    ePoint->e_color[3],
-                    pPoint->e_color,
-                    pPoint->e_color[3],
-                    dir_factor);
-          ePoint->e_color[3] = ePoint->e_color[3] * (1.0f - dir_factor) +
-                               pPoint->e_color[3] * dir_factor;
-          pPoint->wetness *= (1.0f - dir_factor);
-        }
-      }
-    }
+  for (step = 0; step < steps; step++) {
+    memcpy(prevPoint, sData->type_data, sData->total_points * sizeof(*prevPoint));
+    BLI_task_parallel_range(0, sData->total_points, &data, dynamic_paint_smudge_cb, &settings);
   }
-}
 
-typedef struct DynamicPaintEffectData {
-  const DynamicPaintSurface *surface;
-  Scene *scene;
-
-  float *force;
-  ListBase *effectors;
-  const void *prevPoint;
-  const float eff_scale;
-
-  uint8_t *point_locks;
-
-  const float wave_speed;
-  const float wave_scale;
-  const float wave_max_slope;
-
-  const float dt;
-  const float min_dist;
-  const float damp_factor;
-  const bool reset_wave;
-} DynamicPaintEffectData;
+  MEM_freeN(point_locks);
+  MEM_freeN(prevPoint);
+}
 
 /*
  * Prepare data required by effects for current frame.
@@ -5388,15 +5460,7 @@ static void dynamic_paint_effect_drip_cb(void *__restrict userdata,
 
       const unsigned int n_trgt = (unsigned int)n_target[n_idx];
 
-      /* Sort of spinlock, but only for given ePoint.
-       * Since the odds a same ePoint is modified at the same time by several threads is very low,
-       * this is much more efficient than a global spin lock. */
-      const unsigned int epointlock_idx = n_trgt / 8;
-      const uint8_t epointlock_bitmask = 1 << (n_trgt & 7); /* 7 == 0b111 */
-      while (atomic_fetch_and_or_uint8(&point_locks[epointlock_idx], epointlock_bitmask) &
-             epointlock_bitmask) {
-        /* pass */
-      }
+      dynamic_paint_point_lock(point_locks, n_trgt);
 
       PaintPoint *ePoint = &((PaintPoint *)sData->type_data)[n_trgt];
       const float e_wet = ePoint->wetness;
@@ -5425,38 +5489,16 @@ static void dynamic_paint_effect_drip_cb(void *__restrict userdata,
        * that way we can only lock current point once at the end to apply it). */
       ppoint_wetness_diff += (ePoint->wetness - e_wet);
 
-#ifndef NDEBUG
-      {
-        uint8_t ret = atomic_fetch_and_and_uint8(&point_locks[epointlock_idx],
-                                                 ~epointlock_bitmask);
-        BLI_assert(ret & epointlock_bitmask);
-      }
-#else
-      atomic_fetch_and_and_uint8(&point_locks[epointlock_idx], ~epointlock_bitmask);
-#endif
+      dynamic_paint_point_unlock(point_locks, n_trgt);
     }
   }
 
-  {
-    const unsigned int ppointlock_idx = index / 8;
-    const uint8_t ppointlock_bitmask = 1 << (index & 7); /* 7 == 0b111 */
-    while (atomic_fetch_and_or_uint8(&point_locks[ppointlock_idx], ppointlock_bitmask) &
-           ppointlock_bitmask) {
-      /* pass */
-    }
+  dynamic_paint_point_lock(point_locks, (unsigned int)index);
 
-    pPoint->wetness -= ppoint_wetness_diff;
-    CLAMP(pPoint->wetness, 0.0f, MAX_WETNESS);
+  pPoint->wetness -= ppoint_wetness_diff;
+  CLAMP(pPoint->wetness, 0.0f, MAX_WETNESS);
 
-#ifndef NDEBUG
-    {
-      uint8_t ret = atomic_fetch_and_and_uint8(&point_locks[ppointlock_idx], ~ppointlock_bitmask);
-      BLI_assert(ret & ppointlock_bitmask);
-    }
-#else
-    atomic_fetch_and_and_uint8(&point_locks[ppointlock_idx], ~ppointlock_bitmask);
-#endif
-  }
+  dynamic_paint_point_unlock(point_locks, (unsigned int)index);
 }
 
 static void dynamicPaint_doEffectStep(
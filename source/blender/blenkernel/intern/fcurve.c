@@ -1498,26 +1498,55 @@ static float fcurve_eval_keyframes_extrapolate(
   return endpoint_bezt->vec[1][1] - (fac * dx);
 }
 
+/* Check whether #evaltime lies strictly inside the segment ending at keyframe #index, away from
+ * both keyframes by more than #threshold. In that case the binary search would return #index. */
+static bool fcurve_segment_contains(const FCurve *fcu,
+                                    const BezTriple *bezts,
+                                    int index,
+                                    float evaltime,
+                                    float threshold)
+{
+  if (index < 1 || index >= (int)fcu->totvert) {
+    return false;
+  }
+  return (evaltime - bezts[index - 1].vec[1][0] > threshold) &&
+         (bezts[index].vec[1][0] - evaltime > threshold);
+}
+
 static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, float evaltime)
 {
   const float eps = 1.e-8f;
+  const float threshold = 0.0001f;
   BezTriple *bezt, *prevbezt;
   unsigned int a;
 
   /* evaltime occurs somewhere in the middle of the curve */
   bool exact = false;
 
-  /* Use binary search to find appropriate keyframes...
-   *
-   * The threshold here has the following constraints:
-   * - 0.001 is too coarse:
-   *   We get artifacts with 2cm driver movements at 1BU = 1m (see T40332)
-   *
-   * - 0.00001 is too fine:
-   *   Weird errors, like selecting the wrong keyframe range (see T39207), occur.
-   *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
-   */
-  a = binarysearch_bezt_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+  /* During playback the segment is usually the same as in the last evaluation, or the next one.
+   * The hint may be stale or written by another thread, so it's only used when it matches. */
+  const int hint = fcu->eval_segment_hint;
+  if (fcurve_segment_contains(fcu, bezts, hint, evaltime, threshold)) {
+    a = hint;
+  }
+  else if (fcurve_segment_contains(fcu, bezts, hint + 1, evaltime, threshold)) {
+    a = hint + 1;
+    fcu->eval_segment_hint = a;
+  }
+  else {
+    /* Use binary search to find appropriate keyframes...
+     *
+     * The threshold here has the following constraints:
+     * - 0.001 is too coarse:
+     *   We get artifacts with 2cm driver movements at 1BU = 1m (see T40332)
+     *
+     * - 0.00001 is too fine:
+     *   Weird errors, like selecting the wrong keyframe range (see T39207), occur.
+     *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
+     */
+    a = binarysearch_bezt_index_ex(bezts, evaltime, fcu->totvert, threshold, &exact);
+    fcu->eval_segment_hint = a;
+  }
   bezt = bezts + a;
 
   if (exact) {
@@ -92,6 +92,37 @@ TEST(evaluate_fcurve, InterpolationLinear)
   BKE_fcurve_free(fcu);
 }
 
+TEST(evaluate_fcurve, SegmentHint)
+{
+  FCurve *fcu = BKE_fcurve_create();
+
+  for (int i = 0; i < 8; i++) {
+    insert_vert_fcurve(fcu, i, i * 10.0f, BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  }
+  for (int i = 0; i < 8; i++) {
+    fcu->bezt[i].ipo = BEZT_IPO_LIN;
+  }
+
+  /* Forward playback, moving to the next segment or staying in the same one. */
+  for (float frame = 0.25f; frame < 7.0f; frame += 0.25f) {
+    EXPECT_NEAR(evaluate_fcurve(fcu, frame), frame * 10.0f, 1e-5f);
+  }
+  /* Backward and random access, where the hint doesn't match. */
+  for (float frame = 6.75f; frame > 0.0f; frame -= 0.5f) {
+    EXPECT_NEAR(evaluate_fcurve(fcu, frame), frame * 10.0f, 1e-5f);
+  }
+  EXPECT_NEAR(evaluate_fcurve(fcu, 1.5f), 15.0f, 1e-5f);
+  EXPECT_NEAR(evaluate_fcurve(fcu, 6.5f), 65.0f, 1e-5f);
+  EXPECT_NEAR(evaluate_fcurve(fcu, 3.0f), 30.0f, 1e-5f);
+
+  /* A stale hint, from before keys were removed. */
+  fcu->eval_segment_hint = 7;
+  fcu->totvert = 4;
+  EXPECT_NEAR(evaluate_fcurve(fcu, 2.5f), 25.0f, 1e-5f);
+
+  BKE_fcurve_free(fcu);
+}
+
 TEST(evaluate_fcurve, InterpolationBezier)
 {
   FCurve *fcu = BKE_fcurve_create();
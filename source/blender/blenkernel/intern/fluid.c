@@ -4036,6 +4036,11 @@ static void BKE_fluid_modifier_processDomain(FluidModifierData *fmd,
       break;
   }
 
+  /* Read the next frames of an existing cache ahead, so playback doesn't wait on disk. */
+  if (read_cache && !bake_cache && has_data) {
+    manta_prefetch_cache(fds->fluid, fmd, data_frame);
+  }
+
   /* Trigger bake calls individually */
   if (bake_cache) {
     /* Ensure fresh variables at every animation step */
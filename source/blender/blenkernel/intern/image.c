@@ -51,6 +51,7 @@
 #include "DNA_camera_types.h"
 #include "DNA_defaults.h"
 #include "DNA_light_types.h"
+#include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
@@ -58,12 +59,15 @@
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_simulation_types.h"
+#include "DNA_userdef_types.h"
 #include "DNA_world_types.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 #include "BLI_math_vector.h"
 #include "BLI_mempool.h"
 #include "BLI_system.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_timecode.h" /* For stamp time-code format. */
 #include "BLI_utildefines.h"
@@ -77,6 +81,7 @@
 #include "BKE_image.h"
 #include "BKE_lib_id.h"
 #include "BKE_main.h"
+#include "BKE_material.h"
 #include "BKE_node.h"
 #include "BKE_packedFile.h"
 #include "BKE_report.h"
@@ -290,6 +295,7 @@ static void imagecache_put(Image *image, int index, ImBuf *ibuf)
     image->cache = IMB_moviecache_create(
         "Image Datablock Cache", sizeof(ImageCacheKey), imagecache_hashhash, imagecache_hashcmp);
     IMB_moviecache_set_getdata_callback(image->cache, imagecache_keydata);
+    IMB_moviecache_set_user(image->cache, MOVIECACHE_USER_IMAGE);
   }
 
   key.index = index;
@@ -2977,6 +2983,14 @@ void BKE_image_path_from_imtype(char *string,
   do_makepicstring(string, base, relbase, frame, imtype, NULL, use_ext, use_frames, view);
 }
 
+static int anim_open_flags(int flags)
+{
+  if (USER_EXPERIMENTAL_TEST(&U, use_hw_video_decode)) {
+    flags |= IB_animhwdecode;
+  }
+  return flags;
+}
+
 struct anim *openanim_noload(const char *name,
                              int flags,
                              int streamindex,
@@ -2984,7 +2998,7 @@ struct anim *openanim_noload(const char *name,
 {
   struct anim *anim;
 
-  anim = IMB_open_anim(name, flags, streamindex, colorspace);
+  anim = IMB_open_anim(name, anim_open_flags(flags), streamindex, colorspace);
   return anim;
 }
 
@@ -2994,7 +3008,7 @@ struct anim *openanim(const char *name, int flags, int streamindex, char colorsp
   struct anim *anim;
   struct ImBuf *ibuf;
 
-  anim = IMB_open_anim(name, flags, streamindex, colorspace);
+  anim = IMB_open_anim(name, anim_open_flags(flags), streamindex, colorspace);
   if (anim == NULL) {
     return NULL;
   }
@@ -3923,12 +3937,13 @@ static void image_create_multilayer(Image *ima, ImBuf *ibuf, int framenr)
   const char *colorspace = ima->colorspace_settings.name;
   bool predivide = (ima->alpha_mode == IMA_ALPHA_PREMUL);
 
-  /* only load rr once for multiview */
+  /* only load rr once for multiview, the render result takes ownership of the handle */
   if (!ima->rr) {
     ima->rr = RE_MultilayerConvert(ibuf->userdata, colorspace, predivide, ibuf->x, ibuf->y);
   }
-
-  IMB_exr_close(ibuf->userdata);
+  else {
+    IMB_exr_close(ibuf->userdata);
+  }
 
   ibuf->userdata = NULL;
   if (ima->rr != NULL) {
@@ -4146,6 +4161,7 @@ static ImBuf *image_load_sequence_multilayer(Image *ima, ImageUser *iuser, int e
     if (rpass) {
       // printf("load from pass %s\n", rpass->name);
       /* since we free  render results, we copy the rect */
+      RE_pass_ensure_loaded(ima->rr, rpass);
       ibuf = IMB_allocImBuf(ima->rr->rectx, ima->rr->recty, 32, 0);
       ibuf->rect_float = MEM_dupallocN(rpass->rect);
       ibuf->flags |= IB_rectfloat;
@@ -4475,6 +4491,7 @@ static ImBuf *image_get_ibuf_multilayer(Image *ima, ImageUser *iuser)
     RenderPass *rpass = BKE_image_multilayer_index(ima->rr, iuser);
 
     if (rpass) {
+      RE_pass_ensure_loaded(ima->rr, rpass);
       ibuf = IMB_allocImBuf(ima->rr->rectx, ima->rr->recty, 32, 0);
 
       image_init_after_load(ima, iuser, ibuf);
@@ -5150,6 +5167,201 @@ void BKE_image_pool_release_ibuf(Image *ima, ImBuf *ibuf, ImagePool *pool)
   }
 }
 
+/* Decoding images used by the visible objects of a view layer in parallel, so they are not
+ * loaded one after the other by the first redraw after opening a file. Only the decoding runs in
+ * the worker threads, images are checked and buffers assigned with the image mutex locked. */
+
+typedef struct ImagePreload {
+  Image *ima;
+  char filepath[FILE_MAX];
+  char colorspace[IM_MAX_SPACE];
+  int flag;
+  PackedFile *packedfile;
+  ImBuf *ibuf;
+} ImagePreload;
+
+static void image_preload_add_nodetree(GSet *ids, bNodeTree *ntree)
+{
+  if (ntree == NULL || !BLI_gset_add(ids, ntree)) {
+    return;
+  }
+
+  LISTBASE_FOREACH (bNode *, node, &ntree->nodes) {
+    if (node->id == NULL) {
+      continue;
+    }
+    if (GS(node->id->name) == ID_IM) {
+      BLI_gset_add(ids, node->id);
+    }
+    else if (GS(node->id->name) == ID_NT) {
+      image_preload_add_nodetree(ids, (bNodeTree *)node->id);
+    }
+  }
+}
+
+static bool image_preload_init(ImagePreload *preload, Image *ima)
+{
+  if (ima->source != IMA_SRC_FILE || ima->type != IMA_TYPE_IMAGE ||
+      BKE_image_is_multiview(ima) || !image_quick_test(ima, NULL)) {
+    return false;
+  }
+
+  ImBuf *ibuf = image_get_cached_ibuf_for_index_entry(ima, IMA_NO_INDEX, 0);
+  if (ibuf) {
+    IMB_freeImBuf(ibuf);
+    return false;
+  }
+
+  memset(preload, 0, sizeof(*preload));
+  preload->ima = ima;
+  preload->flag = IB_rect | IB_multilayer | imbuf_alpha_flags_for_image(ima);
+  STRNCPY(preload->colorspace, ima->colorspace_settings.name);
+
+  if (BKE_image_has_packedfile(ima)) {
+    ImagePackedFile *imapf = ima->packedfiles.first;
+    if (imapf->packedfile == NULL) {
+      return false;
+    }
+    preload->packedfile = imapf->packedfile;
+  }
+  else {
+    /* Autopack needs the file path of the loaded image, leave it to the regular loading. */
+    if (G.fileflags & G_FILE_AUTOPACK) {
+      return false;
+    }
+
+    ImageUser iuser;
+    BKE_imageuser_default(&iuser);
+    iuser.framenr = ima->lastframe;
+    BKE_image_user_file_path(&iuser, ima, preload->filepath);
+    preload->flag |= IB_metadata;
+  }
+
+  return true;
+}
+
+static void image_preload_task(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ImagePreload *preload = &((ImagePreload *)userdata)[i];
+
+  if (preload->packedfile) {
+    preload->ibuf = IMB_ibImageFromMemory((unsigned char *)preload->packedfile->data,
+                                          preload->packedfile->size,
+                                          preload->flag,
+                                          preload->colorspace,
+                                          "<packed data>");
+  }
+  else {
+    preload->ibuf = IMB_loadiffname(preload->filepath, preload->flag, preload->colorspace);
+  }
+}
+
+/* Same as the end of #load_image_single, the image is left untouched when loading failed so the
+ * regular loading reports it. */
+static void image_preload_assign(ImagePreload *preload)
+{
+  Image *ima = preload->ima;
+  ImBuf *ibuf = preload->ibuf;
+
+  if (ibuf == NULL) {
+    return;
+  }
+
+  ImBuf *ibuf_cached = image_get_cached_ibuf_for_index_entry(ima, IMA_NO_INDEX, 0);
+  if (ibuf_cached || ima->type != IMA_TYPE_IMAGE) {
+    /* Loaded by another thread meanwhile. */
+    if (ibuf_cached) {
+      IMB_freeImBuf(ibuf_cached);
+    }
+#ifdef WITH_OPENEXR
+    if (ibuf->ftype == IMB_FTYPE_OPENEXR && ibuf->userdata) {
+      IMB_exr_close(ibuf->userdata);
+      ibuf->userdata = NULL;
+    }
+#endif
+    IMB_freeImBuf(ibuf);
+    return;
+  }
+
+  STRNCPY(ima->colorspace_settings.name, preload->colorspace);
+
+#ifdef WITH_OPENEXR
+  if (ibuf->ftype == IMB_FTYPE_OPENEXR && ibuf->userdata) {
+    if (IMB_exr_has_multilayer(ibuf->userdata)) {
+      image_create_multilayer(ima, ibuf, 0);
+      ima->type = IMA_TYPE_MULTILAYER;
+    }
+    else {
+      IMB_exr_close(ibuf->userdata);
+      ibuf->userdata = NULL;
+    }
+    IMB_freeImBuf(ibuf);
+    return;
+  }
+#endif
+
+  image_init_after_load(ima, NULL, ibuf);
+  image_assign_ibuf(ima, ibuf, IMA_NO_INDEX, 0);
+  ibuf->userflags |= IB_PERSISTENT;
+  IMB_freeImBuf(ibuf);
+}
+
+/**
+ * Load the images used by the materials of the visible objects in \a view_layer and the world
+ * of \a scene, decoding them in parallel. Images that are already loaded are skipped.
+ */
+void BKE_image_preload_view_layer(Scene *scene, ViewLayer *view_layer)
+{
+  GSet *ids = BLI_gset_ptr_new(__func__);
+
+  if (scene->world && scene->world->use_nodes) {
+    image_preload_add_nodetree(ids, scene->world->nodetree);
+  }
+
+  LISTBASE_FOREACH (Base *, base, &view_layer->object_bases) {
+    if ((base->flag & BASE_VISIBLE_DEPSGRAPH) == 0) {
+      continue;
+    }
+    Object *ob = base->object;
+    const short *totcol = BKE_object_material_len_p(ob);
+    for (short a = 1; a <= (totcol ? *totcol : 0); a++) {
+      Material *ma = BKE_object_material_get(ob, a);
+      if (ma && ma->use_nodes) {
+        image_preload_add_nodetree(ids, ma->nodetree);
+      }
+    }
+  }
+
+  ImagePreload *preloads = MEM_mallocN(sizeof(*preloads) * BLI_gset_len(ids), __func__);
+  int preloads_len = 0;
+
+  BLI_mutex_lock(image_mutex);
+  GSET_FOREACH_BEGIN (ID *, id, ids) {
+    if (GS(id->name) == ID_IM && image_preload_init(&preloads[preloads_len], (Image *)id)) {
+      preloads_len++;
+    }
+  }
+  GSET_FOREACH_END();
+  BLI_mutex_unlock(image_mutex);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (preloads_len > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, preloads_len, preloads, image_preload_task, &settings);
+
+  BLI_mutex_lock(image_mutex);
+  for (int i = 0; i < preloads_len; i++) {
+    image_preload_assign(&preloads[i]);
+  }
+  BLI_mutex_unlock(image_mutex);
+
+  MEM_freeN(preloads);
+  BLI_gset_free(ids, NULL);
+}
+
 int BKE_image_user_frame_get(const ImageUser *iuser, int cfra, bool *r_is_in_range)
 {
   const int len = iuser->frames;
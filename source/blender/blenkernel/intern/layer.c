@@ -694,6 +694,10 @@ int BKE_layer_collection_findindex(ViewLayer *view_layer, const LayerCollection
  * in at least one layer collection. That list is also synchronized here, and
  * stores state like selection. */
 
+/* From this number of child collections on, they are matched to layer collections through hashes
+ * instead of list searches, which are quadratic in the number of children. */
+#define LAYER_COLLECTION_SYNC_HASH_MIN 32
+
 static void layer_collection_sync(ViewLayer *view_layer,
                                   const ListBase *lb_collections,
                                   ListBase *lb_layer_collections,
@@ -707,14 +711,30 @@ static void layer_collection_sync(ViewLayer *view_layer,
    * For local edits we can make editing operating do the appropriate thing, but for
    * linking we can only sync after the fact. */
 
+  const bool use_hash = BLI_listbase_count_at_most(lb_collections,
+                                                   LAYER_COLLECTION_SYNC_HASH_MIN) ==
+                            LAYER_COLLECTION_SYNC_HASH_MIN;
+  GSet *collections_set = NULL;
+  if (use_hash) {
+    collections_set = BLI_gset_ptr_new(__func__);
+    LISTBASE_FOREACH (const CollectionChild *, child, lb_collections) {
+      BLI_gset_add(collections_set, child->collection);
+    }
+  }
+
   /* Remove layer collections that no longer have a corresponding scene collection. */
   LISTBASE_FOREACH_MUTABLE (LayerCollection *, lc, lb_layer_collections) {
     /* Note that ID remap can set lc->collection to NULL when deleting collections. */
-    Collection *collection = (lc->collection) ?
-                                 BLI_findptr(lb_collections,
-                                             lc->collection,
-                                             offsetof(CollectionChild, collection)) :
-                                 NULL;
+    Collection *collection = NULL;
+    if (lc->collection) {
+      if (collections_set) {
+        collection = BLI_gset_haskey(collections_set, lc->collection) ? lc->collection : NULL;
+      }
+      else {
+        collection = BLI_findptr(
+            lb_collections, lc->collection, offsetof(CollectionChild, collection));
+      }
+    }
 
     if (!collection) {
       if (lc == view_layer->active_collection) {
@@ -727,13 +747,32 @@ static void layer_collection_sync(ViewLayer *view_layer,
     }
   }
 
+  if (collections_set) {
+    BLI_gset_free(collections_set, NULL);
+  }
+
+  GHash *layer_collections_map = NULL;
+  if (use_hash) {
+    layer_collections_map = BLI_ghash_ptr_new(__func__);
+    LISTBASE_FOREACH (LayerCollection *, lc, lb_layer_collections) {
+      /* Keep the first one, like the list search. */
+      void **lc_p;
+      if (!BLI_ghash_ensure_p(layer_collections_map, lc->collection, &lc_p)) {
+        *lc_p = lc;
+      }
+    }
+  }
+
   /* Add layer collections for any new scene collections, and ensure order is the same. */
   ListBase new_lb_layer = {NULL, NULL};
 
   LISTBASE_FOREACH (const CollectionChild *, child, lb_collections) {
     Collection *collection = child->collection;
-    LayerCollection *lc = BLI_findptr(
-        lb_layer_collections, collection, offsetof(LayerCollection, collection));
+    LayerCollection *lc = layer_collections_map ?
+                              BLI_ghash_lookup(layer_collections_map, collection) :
+                              BLI_findptr(lb_layer_collections,
+                                          collection,
+                                          offsetof(LayerCollection, collection));
 
     if (lc) {
       BLI_remlink(lb_layer_collections, lc);
@@ -842,6 +881,10 @@ static void layer_collection_sync(ViewLayer *view_layer,
     }
   }
 
+  if (layer_collections_map) {
+    BLI_ghash_free(layer_collections_map, NULL, NULL);
+  }
+
   /* Replace layer collection list with new one. */
   *lb_layer_collections = new_lb_layer;
   BLI_assert(BLI_listbase_count(lb_collections) == BLI_listbase_count(lb_layer_collections));
@@ -68,6 +68,7 @@
 #include "BKE_lib_query.h"
 #include "BKE_lib_remap.h"
 #include "BKE_main.h"
+#include "BKE_main_namemap.h"
 #include "BKE_node.h"
 #include "BKE_rigidbody.h"
 
@@ -150,7 +151,7 @@ static void lib_id_clear_library_data_ex(Main *bmain, ID *id)
   id->tag &= ~(LIB_TAG_INDIRECT | LIB_TAG_EXTERN);
   id->flag &= ~LIB_INDIRECT_WEAK_LINK;
   if (id_in_mainlist) {
-    if (BKE_id_new_name_validate(which_libbase(bmain, GS(id->name)), id, NULL)) {
+    if (BKE_id_new_name_validate(bmain, which_libbase(bmain, GS(id->name)), id, NULL)) {
       bmain->is_memfile_undo_written = false;
     }
   }
@@ -800,7 +801,7 @@ void BKE_libblock_management_main_add(Main *bmain, void *idv)
   ListBase *lb = which_libbase(bmain, GS(id->name));
   BKE_main_lock(bmain);
   BLI_addtail(lb, id);
-  BKE_id_new_name_validate(lb, id, NULL);
+  BKE_id_new_name_validate(bmain, lb, id, NULL);
   /* alphabetic insertion: is in new_id */
   id->tag &= ~(LIB_TAG_NO_MAIN | LIB_TAG_NO_USER_REFCOUNT);
   bmain->is_memfile_undo_written = false;
@@ -823,6 +824,7 @@ void BKE_libblock_management_main_remove(Main *bmain, void *idv)
 
   ListBase *lb = which_libbase(bmain, GS(id->name));
   BKE_main_lock(bmain);
+  BKE_main_namemap_remove(bmain, id);
   BLI_remlink(lb, id);
   id->tag |= LIB_TAG_NO_MAIN;
   bmain->is_memfile_undo_written = false;
@@ -956,7 +958,7 @@ void BKE_main_id_repair_duplicate_names_listbase(ListBase *lb)
   }
   for (i = 0; i < lb_len; i++) {
     if (!BLI_gset_add(gset, id_array[i]->name + 2)) {
-      BKE_id_new_name_validate(lb, id_array[i], NULL);
+      BKE_id_new_name_validate(NULL, lb, id_array[i], NULL);
     }
   }
   BLI_gset_free(gset, NULL);
@@ -1054,7 +1056,7 @@ void *BKE_libblock_alloc(Main *bmain, short type, const char *name, const int fl
 
       BKE_main_lock(bmain);
       BLI_addtail(lb, id);
-      BKE_id_new_name_validate(lb, id, name);
+      BKE_id_new_name_validate(bmain, lb, id, name);
       bmain->is_memfile_undo_written = false;
       /* alphabetic insertion: is in new_id */
       BKE_main_unlock(bmain);
@@ -1279,7 +1281,14 @@ ID *BKE_libblock_find_name(struct Main *bmain, const short type, const char *nam
 {
   ListBase *lb = which_libbase(bmain, type);
   BLI_assert(lb != NULL);
-  return BLI_findstring(lb, name, offsetof(ID, name) + 2);
+
+  /* Local IDs are sorted before linked ones, so the first ID of that name is the local one if it
+   * exists. Linked ones are not part of the name map. */
+  ID *id = BKE_main_namemap_find(bmain, type, name);
+  if (id == NULL && !BLI_listbase_is_empty(&bmain->libraries)) {
+    id = BLI_findstring(lb, name, offsetof(ID, name) + 2);
+  }
+  return id;
 }
 
 /**
@@ -1423,6 +1432,60 @@ static bool id_name_final_build(char *name, char *base_name, size_t base_name_le
   return true;
 }
 
+/**
+ * Same as #check_for_dupid, using the name map of \a bmain instead of looping over all IDs.
+ *
+ * Picks the smallest unused number suffix.
+ *
+ * \return false if the name could not be handled (when adding a number suffix requires to
+ * truncate the base name), the generic code has to be used then.
+ */
+static bool check_for_dupid_namemap(Main *bmain,
+                                    const short id_type,
+                                    ID *id,
+                                    char *name,
+                                    ID **r_id_sorting_hint,
+                                    bool *r_is_name_changed)
+{
+  ID *id_test = BKE_main_namemap_find(bmain, id_type, name);
+  if (id_test == NULL || id_test == id) {
+    *r_is_name_changed = false;
+    return true;
+  }
+
+  /* Get the name and number parts ("name.number"). */
+  char base_name[MAX_ID_NAME - 2];
+  int number = MIN_NUMBER;
+  const size_t base_name_len = BLI_split_name_num(base_name, &number, name, '.');
+
+  /* All numbers below the hint are already used. */
+  number = MAX2(BKE_main_namemap_number_hint_get(bmain, id_type, base_name), MIN_NUMBER);
+
+  char final_name[MAX_ID_NAME - 2];
+  for (;; number++) {
+    /* id_name_final_build() truncates the base name when it fails, work on copies. */
+    char final_base_name[MAX_ID_NAME - 2];
+    BLI_strncpy(final_base_name, base_name, sizeof(final_base_name));
+    BLI_strncpy(final_name, base_name, sizeof(final_name));
+    if (!id_name_final_build(final_name, final_base_name, base_name_len, number)) {
+      return false;
+    }
+
+    ID *id_number = BKE_main_namemap_find(bmain, id_type, final_name);
+    if (id_number == NULL || id_number == id) {
+      break;
+    }
+    id_test = id_number;
+  }
+
+  BKE_main_namemap_number_hint_set(bmain, id_type, base_name, number + 1);
+
+  *r_id_sorting_hint = id_test;
+  *r_is_name_changed = true;
+  strcpy(name, final_name);
+  return true;
+}
+
 /**
  * Check to see if an ID name is already used, and find a new one if so.
  * Return true if a new name was created (returned in name).
@@ -1430,8 +1493,10 @@ static bool id_name_final_build(char *name, char *base_name, size_t base_name_le
  * Normally the ID that's being checked is already in the ListBase, so ID *id points at the new
  * entry. The Python Library module needs to know what the name of a data-block will be before it
  * is appended, in this case ID *id is NULL.
+ *
+ * \param bmain: Main owning \a lb, to use its name map. May be NULL.
  */
-static bool check_for_dupid(ListBase *lb, ID *id, char *name, ID **r_id_sorting_hint)
+static bool check_for_dupid(Main *bmain, ListBase *lb, ID *id, char *name, ID **r_id_sorting_hint)
 {
   BLI_assert(strlen(name) < MAX_ID_NAME - 2);
 
@@ -1446,6 +1511,13 @@ static bool check_for_dupid(ListBase *lb, ID *id, char *name, ID **r_id_sorting_
 
   const short id_type = (short)GS(id_test->name);
 
+  if (bmain != NULL) {
+    BLI_assert(which_libbase(bmain, id_type) == lb);
+    if (check_for_dupid_namemap(bmain, id_type, id, name, r_id_sorting_hint, &is_name_changed)) {
+      return is_name_changed;
+    }
+  }
+
   /* Static storage of previous handled ID/name info, used to perform a quicker test and optimize
    * creation of huge number of IDs using the same given base name. */
   static char prev_orig_base_name[MAX_ID_NAME - 2] = {0};
@@ -1630,9 +1702,12 @@ static bool check_for_dupid(ListBase *lb, ID *id, char *name, ID **r_id_sorting_
  *
  * Only for local IDs (linked ones already have a unique ID in their library).
  *
+ * \param bmain: Main owning \a lb, its name map is used and kept up to date. Can be NULL when
+ * the ID is not in a Main yet (the name map of that Main then has to be cleared).
+ *
  * \return true if a new name had to be created.
  */
-bool BKE_id_new_name_validate(ListBase *lb, ID *id, const char *tname)
+bool BKE_id_new_name_validate(Main *bmain, ListBase *lb, ID *id, const char *tname)
 {
   bool result;
   char name[MAX_ID_NAME - 2];
@@ -1661,8 +1736,11 @@ bool BKE_id_new_name_validate(ListBase *lb, ID *id, const char *tname)
   }
 
   ID *id_sorting_hint = NULL;
-  result = check_for_dupid(lb, id, name, &id_sorting_hint);
+  result = check_for_dupid(bmain, lb, id, name, &id_sorting_hint);
   strcpy(id->name + 2, name);
+  if (bmain != NULL) {
+    BKE_main_namemap_add(bmain, id);
+  }
 
   /* This was in 2.43 and previous releases
    * however all data in blender should be sorted, not just duplicate names
@@ -1987,10 +2065,9 @@ void BKE_library_make_local(Main *bmain,
    * ID in a separated loop,
    * as lbarray ordering is not enough to ensure us we did catch all dependencies
    * (e.g. if making local a parent object before its child...). See T48907. */
-  /* TODO This is now the biggest step by far (in term of processing time).
-   * We may be able to gain here by using again main->relations mapping, but...
-   * this implies BKE_libblock_remap & co to be able to update main->relations on the fly.
-   * Have to think about it a bit more, and see whether new code is OK first, anyway. */
+  /* Relations are re-generated here, since previous step added new IDs. Remapping keeps them up
+   * to date, and only processes the actual users of each remapped ID with them. */
+  BKE_main_relations_create(bmain, 0);
   for (LinkNode *it = copied_ids; it; it = it->next) {
     ID *id = it->link;
 
@@ -2009,6 +2086,7 @@ void BKE_library_make_local(Main *bmain,
       id_us_ensure_real(id->newid);
     }
   }
+  BKE_main_relations_free(bmain);
 
 #ifdef DEBUG_TIME
   printf("Step 4: Remap local usages of old (linked) ID to new (local) ID: Done.\n");
@@ -2116,8 +2194,10 @@ void BLI_libblock_ensure_unique_name(Main *bmain, const char *name)
   /* search for id */
   idtest = BLI_findstring(lb, name + 2, offsetof(ID, name) + 2);
   if (idtest != NULL) {
+    /* The renamed ID is unknown, so the name map cannot be used nor updated here. */
+    BKE_main_namemap_clear(bmain);
     /* BKE_id_new_name_validate also takes care of sorting. */
-    BKE_id_new_name_validate(lb, idtest, NULL);
+    BKE_id_new_name_validate(NULL, lb, idtest, NULL);
     bmain->is_memfile_undo_written = false;
   }
 }
@@ -2128,7 +2208,7 @@ void BLI_libblock_ensure_unique_name(Main *bmain, const char *name)
 void BKE_libblock_rename(Main *bmain, ID *id, const char *name)
 {
   ListBase *lb = which_libbase(bmain, GS(id->name));
-  if (BKE_id_new_name_validate(lb, id, name)) {
+  if (BKE_id_new_name_validate(bmain, lb, id, name)) {
     bmain->is_memfile_undo_written = false;
   }
 }
@@ -28,6 +28,7 @@
 
 #include "BLI_utildefines.h"
 
+#include "BLI_ghash.h"
 #include "BLI_listbase.h"
 
 #include "BKE_anim_data.h"
@@ -39,6 +40,7 @@
 #include "BKE_lib_remap.h"
 #include "BKE_library.h"
 #include "BKE_main.h"
+#include "BKE_main_namemap.h"
 
 #include "lib_intern.h"
 
@@ -173,6 +175,8 @@ void BKE_id_free_ex(Main *bmain, void *idv, int flag, const bool use_flag_from_i
 
   if ((flag & LIB_ID_FREE_NO_MAIN) == 0) {
     ListBase *lb = which_libbase(bmain, type);
+    BKE_main_namemap_remove(bmain, id);
+    BKE_main_relations_ID_remove(bmain, id);
     BLI_remlink(lb, id);
   }
 
@@ -256,6 +260,12 @@ static void id_delete(Main *bmain, const bool do_tagged_deletion)
      * containing thousands of those.
      * This also means that we have to be very careful here, as we by-pass many 'common'
      * processing, hence risking to 'corrupt' at least user counts, if not IDs themselves. */
+    /* Relations let remapping only visit the actual users of each deleted ID, instead of the
+     * whole Main database. They are kept up to date by the remapping code. */
+    const bool do_relations = (bmain->relations == NULL);
+    if (do_relations) {
+      BKE_main_relations_create(bmain, 0);
+    }
     bool keep_looping = true;
     while (keep_looping) {
       ID *id, *id_next;
@@ -272,6 +282,9 @@ static void id_delete(Main *bmain, const bool do_tagged_deletion)
           id_next = id->next;
           /* Note: in case we delete a library, we also delete all its datablocks! */
           if ((id->tag & tag) || (id->lib != NULL && (id->lib->id.tag & tag))) {
+            BKE_main_namemap_remove(bmain, id);
+            /* Not a user anymore for remapping, but still needed as a used ID. */
+            BLI_ghash_remove(bmain->relations->id_user_to_used, id, NULL, NULL);
             BLI_remlink(lb, id);
             BLI_addtail(&tagged_deleted_ids, id);
             /* Do not tag as no_main now, we want to unlink it first (lower-level ID management
@@ -305,6 +318,9 @@ static void id_delete(Main *bmain, const bool do_tagged_deletion)
         // id->us = 0;  /* Is it actually? */
       }
     }
+    if (do_relations) {
+      BKE_main_relations_free(bmain);
+    }
   }
   else {
     /* First tag all datablocks directly from target lib.
@@ -352,6 +368,7 @@ static void id_delete(Main *bmain, const bool do_tagged_deletion)
 #endif
           BLI_assert(id->us == 0);
         }
+        BKE_main_relations_ID_remove(bmain, id);
         BKE_id_free_ex(bmain, id, free_flag, !do_tagged_deletion);
       }
     }
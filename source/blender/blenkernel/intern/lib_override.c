@@ -29,6 +29,7 @@
 #include "DNA_ID.h"
 #include "DNA_collection_types.h"
 #include "DNA_key_types.h"
+#include "DNA_node_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
@@ -45,6 +46,7 @@
 #include "BKE_lib_query.h"
 #include "BKE_lib_remap.h"
 #include "BKE_main.h"
+#include "BKE_node.h"
 #include "BKE_scene.h"
 
 #include "BLI_ghash.h"
@@ -668,6 +670,7 @@ IDOverrideLibraryProperty *BKE_lib_override_library_property_get(IDOverrideLibra
 
     GHash *override_runtime = override_library_rna_path_mapping_ensure(override);
     BLI_ghash_insert(override_runtime, op->rna_path, op);
+    override->runtime->tag &= ~IDOVERRIDE_LIBRARY_RUNTIME_TAG_DIFF_UP_TO_DATE;
 
     if (r_created) {
       *r_created = true;
@@ -718,6 +721,9 @@ void BKE_lib_override_library_property_delete(IDOverrideLibrary *override,
                      NULL,
                      NULL);
   }
+  if (override->runtime != NULL) {
+    override->runtime->tag &= ~IDOVERRIDE_LIBRARY_RUNTIME_TAG_DIFF_UP_TO_DATE;
+  }
   lib_override_library_property_clear(override_property);
   BLI_freelinkN(&override->properties, override_property);
 }
@@ -1104,6 +1110,10 @@ bool BKE_lib_override_library_operations_create(Main *bmain, ID *local)
     if (report_flags & RNA_OVERRIDE_MATCH_RESULT_CREATED) {
       ret = true;
     }
+
+    /* Rules now match local data, until either gets modified again. */
+    override_library_rna_path_runtime_ensure(local->override_library)->tag |=
+        IDOVERRIDE_LIBRARY_RUNTIME_TAG_DIFF_UP_TO_DATE;
 #ifndef NDEBUG
     if (report_flags & RNA_OVERRIDE_MATCH_RESULT_RESTORED) {
       printf("We did restore some properties of %s from its reference.\n", local->name);
@@ -1127,7 +1137,43 @@ static void lib_override_library_operations_create_cb(TaskPool *__restrict pool,
   BKE_lib_override_library_operations_create(bmain, id);
 }
 
-/** Check all overrides from given \a bmain and create/update overriding operations as needed. */
+/**
+ * Whether given override ID, or data owned by it, was tagged as modified since the last undo
+ * push (or was tagged for auto-refresh by the depsgraph).
+ */
+static bool lib_override_library_id_is_modified(ID *id)
+{
+  if (id->recalc_after_undo_push != 0 || (id->tag & LIB_TAG_OVERRIDE_LIBRARY_AUTOREFRESH)) {
+    return true;
+  }
+
+  /* Embedded IDs and shape keys are 'virtual' overrides, diffed as part of their owner. */
+  bNodeTree *nodetree = ntreeFromID(id);
+  if (nodetree != NULL && nodetree->id.recalc_after_undo_push != 0) {
+    return true;
+  }
+  if (GS(id->name) == ID_SCE) {
+    Scene *scene = (Scene *)id;
+    if (scene->master_collection != NULL &&
+        scene->master_collection->id.recalc_after_undo_push != 0) {
+      return true;
+    }
+  }
+  Key *key = BKE_key_from_id(id);
+  if (key != NULL && key->id.recalc_after_undo_push != 0) {
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Check all overrides from given \a bmain and create/update overriding operations as needed.
+ *
+ * When \a force_auto is set, all overrides not known to be up-to-date are diffed, and their
+ * unused existing properties & operations are removed. Overrides whose local data was not
+ * modified since their last diffing are skipped.
+ */
 void BKE_lib_override_library_main_operations_create(Main *bmain, const bool force_auto)
 {
   ID *id;
@@ -1136,18 +1182,31 @@ void BKE_lib_override_library_main_operations_create(Main *bmain, const bool for
   TIMEIT_START_AVERAGED(BKE_lib_override_library_main_operations_create);
 #endif
 
-  /* When force-auto is set, we also remove all unused existing override properties & operations.
-   */
-  if (force_auto) {
-    BKE_lib_override_library_main_tag(bmain, IDOVERRIDE_LIBRARY_TAG_UNUSED, true);
-  }
-
   TaskPool *task_pool = BLI_task_pool_create(bmain, TASK_PRIORITY_HIGH);
 
   FOREACH_MAIN_ID_BEGIN (bmain, id) {
-    if (ID_IS_OVERRIDE_LIBRARY_REAL(id) &&
-        (force_auto || (id->tag & LIB_TAG_OVERRIDE_LIBRARY_AUTOREFRESH))) {
-      BLI_task_pool_push(task_pool, lib_override_library_operations_create_cb, id, false, NULL);
+    if (ID_IS_OVERRIDE_LIBRARY_REAL(id)) {
+      IDOverrideLibraryRuntime *override_runtime = id->override_library->runtime;
+      /* Modified data is only reported until next undo push, so always invalidate here, even
+       * when this ID is not diffed now. */
+      if (override_runtime != NULL && lib_override_library_id_is_modified(id)) {
+        override_runtime->tag &= ~IDOVERRIDE_LIBRARY_RUNTIME_TAG_DIFF_UP_TO_DATE;
+      }
+      const bool is_up_to_date = override_runtime != NULL &&
+                                 (override_runtime->tag &
+                                  IDOVERRIDE_LIBRARY_RUNTIME_TAG_DIFF_UP_TO_DATE) != 0;
+      const bool do_diff = (force_auto && !is_up_to_date) ||
+                           (id->tag & LIB_TAG_OVERRIDE_LIBRARY_AUTOREFRESH) != 0;
+
+      /* When force-auto is set, we also remove all unused existing override properties &
+       * operations, but only from IDs that actually get diffed. */
+      if (force_auto) {
+        BKE_lib_override_library_properties_tag(
+            id->override_library, IDOVERRIDE_LIBRARY_TAG_UNUSED, do_diff);
+      }
+      if (do_diff) {
+        BLI_task_pool_push(task_pool, lib_override_library_operations_create_cb, id, false, NULL);
+      }
     }
     id->tag &= ~LIB_TAG_OVERRIDE_LIBRARY_AUTOREFRESH;
   }
@@ -1393,6 +1452,10 @@ void BKE_lib_override_library_update(Main *bmain, ID *local)
     return;
   }
 
+  if (local->override_library->runtime != NULL) {
+    local->override_library->runtime->tag &= ~IDOVERRIDE_LIBRARY_RUNTIME_TAG_DIFF_UP_TO_DATE;
+  }
+
   /* Recursively do 'ancestors' overrides first, if any. */
   if (local->override_library->reference->override_library &&
       (local->override_library->reference->tag & LIB_TAG_OVERRIDE_LIBRARY_REFOK) == 0) {
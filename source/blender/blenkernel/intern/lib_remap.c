@@ -22,6 +22,7 @@
 
 #include "CLG_log.h"
 
+#include "BLI_ghash.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_object_types.h"
@@ -192,6 +193,10 @@ static int foreach_libblock_remap_callback(LibraryIDLinkCallbackData *cb_data)
     else {
       if (!is_never_null) {
         *id_p = new_id;
+        if (new_id != NULL) {
+          /* Keep relations valid for the next remappings, see libblock_remap_data(). */
+          BKE_main_relations_ID_user_add(id_remap_data->bmain, new_id, id_self, cb_flag);
+        }
         DEG_id_tag_update_ex(id_remap_data->bmain,
                              id_self,
                              ID_RECALC_COPY_ON_WRITE | ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY);
@@ -345,14 +350,55 @@ static void libblock_remap_data_postprocess_nodetree_update(Main *bmain, ID *new
   ntreeUpdateAllUsers(bmain, new_id);
 }
 
+/**
+ * Only process the IDs using \a old_id, as stored in Main relations.
+ *
+ * IDs removed from the relations (e.g. when deleted) are skipped. The relations are kept up to
+ * date in #foreach_libblock_remap_callback, so they can be used for many remappings in a row.
+ */
+static void libblock_remap_data_users_from_relations(Main *bmain,
+                                                     ID *old_id,
+                                                     IDRemap *r_id_remap_data,
+                                                     const int foreach_id_flags)
+{
+  MainIDRelations *relations = bmain->relations;
+  /* Remapping may reallocate data storing ID pointers (e.g. material arrays). */
+  relations->flag |= MAINIDRELATIONS_USED_TO_USER_ONLY;
+
+  GSet *owners_done = BLI_gset_ptr_new(__func__);
+  for (MainIDRelationsEntry *entry = BLI_ghash_lookup(relations->id_used_to_user, old_id);
+       entry != NULL;
+       entry = entry->next) {
+    /* In 'used to user' relations, the pointer is the user ID itself. */
+    ID *id_user = (ID *)entry->id_pointer;
+    if (!BLI_ghash_haskey(relations->id_user_to_used, id_user)) {
+      continue;
+    }
+    ID *id_owner = BKE_main_relations_ID_owner_get(bmain, id_user);
+    if (id_owner == NULL || !BLI_ghash_haskey(relations->id_user_to_used, id_owner) ||
+        !BLI_gset_add(owners_done, id_owner)) {
+      continue;
+    }
+
+    r_id_remap_data->id_owner = id_owner;
+    libblock_remap_data_preprocess(r_id_remap_data);
+    BKE_library_foreach_ID_link(NULL,
+                                id_owner,
+                                foreach_libblock_remap_callback,
+                                (void *)r_id_remap_data,
+                                foreach_id_flags);
+  }
+  BLI_gset_free(owners_done, NULL);
+}
+
 /**
  * Execute the 'data' part of the remapping (that is, all ID pointers from other ID data-blocks).
  *
  * Behavior differs depending on whether given \a id is NULL or not:
  * - \a id NULL: \a old_id must be non-NULL, \a new_id may be NULL (unlinking \a old_id) or not
  *   (remapping \a old_id to \a new_id).
- *   The whole \a bmain database is checked, and all pointers to \a old_id
- *   are remapped to \a new_id.
+ *   The whole \a bmain database is checked (or only the users of \a old_id when \a bmain has
+ *   relations), and all pointers to \a old_id are remapped to \a new_id.
  * - \a id is non-NULL:
  *   + If \a old_id is NULL, \a new_id must also be NULL,
  *     and all ID pointers from \a id are cleared
@@ -398,6 +444,9 @@ static void libblock_remap_data(
     BKE_library_foreach_ID_link(
         NULL, id, foreach_libblock_remap_callback, (void *)r_id_remap_data, foreach_id_flags);
   }
+  else if (bmain->relations != NULL) {
+    libblock_remap_data_users_from_relations(bmain, old_id, r_id_remap_data, foreach_id_flags);
+  }
   else {
     /* Note that this is a very 'brute force' approach,
      * maybe we could use some depsgraph to only process objects actually using given old_id...
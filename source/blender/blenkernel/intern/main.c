@@ -38,6 +38,7 @@
 #include "BKE_lib_id.h"
 #include "BKE_lib_query.h"
 #include "BKE_main.h"
+#include "BKE_main_namemap.h"
 
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
@@ -63,6 +64,8 @@ void BKE_main_free(Main *mainvar)
 
   MEM_SAFE_FREE(mainvar->blen_thumb);
 
+  BKE_main_namemap_clear(mainvar);
+
   a = set_listbasepointers(mainvar, lbarray);
   while (a--) {
     ListBase *lb = lbarray[a];
@@ -209,6 +212,26 @@ void BKE_main_unlock(struct Main *bmain)
   BLI_spin_unlock((SpinLock *)bmain->lock);
 }
 
+static void main_relations_entry_add(MainIDRelations *rel,
+                                     GHash *map,
+                                     ID *id,
+                                     ID **id_pointer,
+                                     const int usage_flag)
+{
+  MainIDRelationsEntry *entry, **entry_p;
+
+  entry = BLI_mempool_alloc(rel->entry_pool);
+  if (BLI_ghash_ensure_p(map, id, (void ***)&entry_p)) {
+    entry->next = *entry_p;
+  }
+  else {
+    entry->next = NULL;
+  }
+  entry->id_pointer = id_pointer;
+  entry->usage_flag = usage_flag;
+  *entry_p = entry;
+}
+
 static int main_relations_create_idlink_cb(LibraryIDLinkCallbackData *cb_data)
 {
   MainIDRelations *rel = cb_data->user_data;
@@ -217,29 +240,8 @@ static int main_relations_create_idlink_cb(LibraryIDLinkCallbackData *cb_data)
   const int cb_flag = cb_data->cb_flag;
 
   if (*id_pointer) {
-    MainIDRelationsEntry *entry, **entry_p;
-
-    entry = BLI_mempool_alloc(rel->entry_pool);
-    if (BLI_ghash_ensure_p(rel->id_user_to_used, id_self, (void ***)&entry_p)) {
-      entry->next = *entry_p;
-    }
-    else {
-      entry->next = NULL;
-    }
-    entry->id_pointer = id_pointer;
-    entry->usage_flag = cb_flag;
-    *entry_p = entry;
-
-    entry = BLI_mempool_alloc(rel->entry_pool);
-    if (BLI_ghash_ensure_p(rel->id_used_to_user, *id_pointer, (void ***)&entry_p)) {
-      entry->next = *entry_p;
-    }
-    else {
-      entry->next = NULL;
-    }
-    entry->id_pointer = (ID **)id_self;
-    entry->usage_flag = cb_flag;
-    *entry_p = entry;
+    main_relations_entry_add(rel, rel->id_user_to_used, id_self, id_pointer, cb_flag);
+    main_relations_entry_add(rel, rel->id_used_to_user, *id_pointer, (ID **)id_self, cb_flag);
   }
 
   return IDWALK_RET_NOP;
@@ -310,6 +312,37 @@ void BKE_main_relations_ID_remove(Main *bmain, ID *id)
   }
 }
 
+/**
+ * Add \a id_user to the users of \a id_used, e.g. after an ID pointer of \a id_user has been
+ * remapped to \a id_used. Only updates the `id_used_to_user` mapping.
+ */
+void BKE_main_relations_ID_user_add(Main *bmain, ID *id_used, ID *id_user, const int usage_flag)
+{
+  MainIDRelations *rel = bmain->relations;
+  if (rel) {
+    main_relations_entry_add(rel, rel->id_used_to_user, id_used, (ID **)id_user, usage_flag);
+  }
+}
+
+/**
+ * Get the real ID owning given embedded \a id (like a material's node tree), from the relations.
+ * Returns \a id itself if it is not embedded data.
+ */
+ID *BKE_main_relations_ID_owner_get(Main *bmain, ID *id)
+{
+  if ((id->flag & LIB_EMBEDDED_DATA) == 0) {
+    return id;
+  }
+  for (MainIDRelationsEntry *entry = BLI_ghash_lookup(bmain->relations->id_used_to_user, id);
+       entry != NULL;
+       entry = entry->next) {
+    if (entry->usage_flag & IDWALK_CB_EMBEDDED) {
+      return (ID *)entry->id_pointer;
+    }
+  }
+  return NULL;
+}
+
 /**
  * Create a GSet storing all IDs present in given \a bmain, by their pointers.
  *
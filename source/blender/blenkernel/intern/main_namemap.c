@@ -0,0 +1,256 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_ghash.h"
+#include "BLI_listbase.h"
+#include "BLI_memarena.h"
+#include "BLI_string_utils.h"
+#include "BLI_utildefines.h"
+
+#include "DNA_ID.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_main_namemap.h" /* own include */
+
+/** \file
+ * \ingroup bke
+ *
+ * Persistent name to ID mapping of a Main data-base.
+ */
+
+/** \name BKE_main_namemap API
+ *
+ * Only local IDs are stored, linked ones already have unique names in their library and are
+ * never renamed.
+ *
+ * \note Maps are built on demand, most ID types never get any lookup.
+ * \{ */
+
+typedef struct MainNameMapType {
+  /** Name without the ID code -> local ID using it. */
+  GHash *name_to_id;
+  /** ID -> its key in #name_to_id, to remove entries of IDs renamed behind our back. */
+  GHash *id_to_name;
+  /**
+   * Base name -> smallest number suffix that may still be unused. All numbers below it are
+   * known to be taken, see #BKE_main_namemap_number_hint_get.
+   */
+  GHash *base_name_number;
+} MainNameMapType;
+
+typedef struct MainNameMap {
+  MainNameMapType *type_maps[INDEX_ID_MAX];
+  /** Storage of all keys, they are never freed individually. */
+  MemArena *arena;
+} MainNameMap;
+
+static const char *namemap_strdup(MainNameMap *name_map, const char *str)
+{
+  const size_t str_size = strlen(str) + 1;
+  char *str_dup = BLI_memarena_alloc(name_map->arena, str_size);
+  memcpy(str_dup, str, str_size);
+  return str_dup;
+}
+
+static void namemap_type_free(MainNameMapType *type_map)
+{
+  BLI_ghash_free(type_map->name_to_id, NULL, NULL);
+  BLI_ghash_free(type_map->id_to_name, NULL, NULL);
+  BLI_ghash_free(type_map->base_name_number, NULL, NULL);
+  MEM_freeN(type_map);
+}
+
+static MainNameMapType *namemap_type_get(Main *bmain, const short id_type)
+{
+  if (bmain->name_map == NULL) {
+    return NULL;
+  }
+  return bmain->name_map->type_maps[BKE_idtype_idcode_to_index(id_type)];
+}
+
+static void namemap_entry_add(MainNameMap *name_map, MainNameMapType *type_map, ID *id)
+{
+  if (ID_IS_LINKED(id)) {
+    return;
+  }
+
+  const char *name = namemap_strdup(name_map, id->name + 2);
+  void **id_p;
+  /* In case of duplicate names (e.g. from broken files), keep the first ID. */
+  if (!BLI_ghash_ensure_p(type_map->name_to_id, (void *)name, &id_p)) {
+    *id_p = id;
+  }
+  BLI_ghash_insert(type_map->id_to_name, id, (void *)name);
+}
+
+static void namemap_entry_remove(MainNameMapType *type_map, ID *id)
+{
+  const char *name = BLI_ghash_popkey(type_map->id_to_name, id, NULL);
+  if (name == NULL) {
+    return;
+  }
+  /* The map may contain another ID of the same name. */
+  if (BLI_ghash_lookup(type_map->name_to_id, name) == id) {
+    BLI_ghash_remove(type_map->name_to_id, name, NULL, NULL);
+  }
+
+  /* Keep the hint of the freed number valid. */
+  char base_name[MAX_ID_NAME - 2];
+  int number;
+  BLI_split_name_num(base_name, &number, name, '.');
+  if (number > 0) {
+    void **number_p = BLI_ghash_lookup_p(type_map->base_name_number, base_name);
+    if (number_p != NULL && POINTER_AS_INT(*number_p) > number) {
+      *number_p = POINTER_FROM_INT(number);
+    }
+  }
+}
+
+static MainNameMapType *namemap_type_ensure(Main *bmain, const short id_type)
+{
+  if (bmain->name_map == NULL) {
+    bmain->name_map = MEM_callocN(sizeof(*bmain->name_map), __func__);
+    bmain->name_map->arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, __func__);
+  }
+
+  MainNameMap *name_map = bmain->name_map;
+  MainNameMapType **type_map_p = &name_map->type_maps[BKE_idtype_idcode_to_index(id_type)];
+  if (*type_map_p != NULL) {
+    return *type_map_p;
+  }
+
+  ListBase *lb = which_libbase(bmain, id_type);
+  const uint lb_len = (uint)BLI_listbase_count(lb);
+
+  MainNameMapType *type_map = MEM_mallocN(sizeof(*type_map), __func__);
+  type_map->name_to_id = BLI_ghash_str_new_ex(__func__, lb_len);
+  type_map->id_to_name = BLI_ghash_ptr_new_ex(__func__, lb_len);
+  type_map->base_name_number = BLI_ghash_str_new(__func__);
+  LISTBASE_FOREACH (ID *, id, lb) {
+    namemap_entry_add(name_map, type_map, id);
+  }
+
+  *type_map_p = type_map;
+  return type_map;
+}
+
+/**
+ * Free the name maps of \a bmain, they are rebuilt on next use.
+ *
+ * Needed after moving IDs between Main data-bases, or freeing them, without going through the
+ * ID management API.
+ */
+void BKE_main_namemap_clear(Main *bmain)
+{
+  MainNameMap *name_map = bmain->name_map;
+  if (name_map == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < INDEX_ID_MAX; i++) {
+    if (name_map->type_maps[i] != NULL) {
+      namemap_type_free(name_map->type_maps[i]);
+    }
+  }
+  BLI_memarena_free(name_map->arena);
+  MEM_freeN(name_map);
+  bmain->name_map = NULL;
+}
+
+/**
+ * Find the local ID of given type and name (without the ID code), or NULL.
+ */
+ID *BKE_main_namemap_find(Main *bmain, const short id_type, const char *name)
+{
+  MainNameMapType *type_map = namemap_type_ensure(bmain, id_type);
+  ID *id = BLI_ghash_lookup(type_map->name_to_id, name);
+
+  if (id != NULL && !STREQ(id->name + 2, name)) {
+    /* ID was renamed without updating the map, rebuild it. */
+    namemap_type_free(type_map);
+    bmain->name_map->type_maps[BKE_idtype_idcode_to_index(id_type)] = NULL;
+    type_map = namemap_type_ensure(bmain, id_type);
+    id = BLI_ghash_lookup(type_map->name_to_id, name);
+  }
+
+  return id;
+}
+
+/**
+ * Store the current name of \a id, which must be in \a bmain. Its previous name is released.
+ */
+void BKE_main_namemap_add(Main *bmain, ID *id)
+{
+  MainNameMapType *type_map = namemap_type_get(bmain, GS(id->name));
+  if (type_map == NULL) {
+    return;
+  }
+
+  namemap_entry_remove(type_map, id);
+  namemap_entry_add(bmain->name_map, type_map, id);
+}
+
+/**
+ * Release the name of \a id, which is being removed from \a bmain.
+ */
+void BKE_main_namemap_remove(Main *bmain, ID *id)
+{
+  MainNameMapType *type_map = namemap_type_get(bmain, GS(id->name));
+  if (type_map == NULL) {
+    return;
+  }
+
+  namemap_entry_remove(type_map, id);
+}
+
+/**
+ * Get the smallest number suffix for \a base_name that may still be unused, all smaller ones are
+ * taken. This is only a starting point, callers still have to check the resulting names.
+ */
+int BKE_main_namemap_number_hint_get(Main *bmain, const short id_type, const char *base_name)
+{
+  MainNameMapType *type_map = namemap_type_ensure(bmain, id_type);
+  void **number_p = BLI_ghash_lookup_p(type_map->base_name_number, base_name);
+  return (number_p != NULL) ? POINTER_AS_INT(*number_p) : 1;
+}
+
+/**
+ * Store that all number suffixes of \a base_name below \a number are taken.
+ */
+void BKE_main_namemap_number_hint_set(Main *bmain,
+                                      const short id_type,
+                                      const char *base_name,
+                                      const int number)
+{
+  MainNameMapType *type_map = namemap_type_ensure(bmain, id_type);
+  void **number_p = BLI_ghash_lookup_p(type_map->base_name_number, base_name);
+  if (number_p != NULL) {
+    *number_p = POINTER_FROM_INT(number);
+  }
+  else {
+    BLI_ghash_insert(type_map->base_name_number,
+                     (void *)namemap_strdup(bmain->name_map, base_name),
+                     POINTER_FROM_INT(number));
+  }
+}
+
+/** \} */
@@ -575,659 +575,741 @@ static void layer_bucket_init(MaskRasterLayer *layer, const float pixel_size)
   BLI_memarena_free(arena);
 }
 
-void BKE_maskrasterize_handle_init(MaskRasterHandle *mr_handle,
-                                   struct Mask *mask,
-                                   const int width,
-                                   const int height,
-                                   const bool do_aspect_correct,
-                                   const bool do_mask_aa,
-                                   const bool do_feather)
+static void maskrasterize_layer_init(MaskRasterLayer *layer,
+                                     MaskLayer *masklay,
+                                     const int width,
+                                     const int height,
+                                     const float pixel_size,
+                                     const float asp_xy[2],
+                                     const bool do_aspect_correct,
+                                     const bool do_mask_aa,
+                                     const bool do_feather,
+                                     MemArena *sf_arena)
 {
   const rctf default_bounds = {0.0f, 1.0f, 0.0f, 1.0f};
-  const float pixel_size = 1.0f / (float)min_ii(width, height);
-  const float asp_xy[2] = {
-      (do_aspect_correct && width > height) ? (float)height / (float)width : 1.0f,
-      (do_aspect_correct && width < height) ? (float)width / (float)height : 1.0f};
-
   const float zvec[3] = {0.0f, 0.0f, -1.0f};
-  MaskLayer *masklay;
-  unsigned int masklay_index;
-  MemArena *sf_arena;
-
-  mr_handle->layers_tot = (unsigned int)BLI_listbase_count(&mask->masklayers);
-  mr_handle->layers = MEM_mallocN(sizeof(MaskRasterLayer) * mr_handle->layers_tot,
-                                  "MaskRasterLayer");
-  BLI_rctf_init_minmax(&mr_handle->bounds);
-
-  sf_arena = BLI_memarena_new(BLI_SCANFILL_ARENA_SIZE, __func__);
 
-  for (masklay = mask->masklayers.first, masklay_index = 0; masklay;
-       masklay = masklay->next, masklay_index++) {
+  /* we need to store vertex ranges for open splines for filling */
+  unsigned int tot_splines;
+  MaskRasterSplineInfo *open_spline_ranges;
+  unsigned int open_spline_index = 0;
 
-    /* we need to store vertex ranges for open splines for filling */
-    unsigned int tot_splines;
-    MaskRasterSplineInfo *open_spline_ranges;
-    unsigned int open_spline_index = 0;
+  MaskSpline *spline;
 
-    MaskSpline *spline;
+  /* scanfill */
+  ScanFillContext sf_ctx;
+  ScanFillVert *sf_vert = NULL;
+  ScanFillVert *sf_vert_next = NULL;
+  ScanFillFace *sf_tri;
 
-    /* scanfill */
-    ScanFillContext sf_ctx;
-    ScanFillVert *sf_vert = NULL;
-    ScanFillVert *sf_vert_next = NULL;
-    ScanFillFace *sf_tri;
-
-    unsigned int sf_vert_tot = 0;
-    unsigned int tot_feather_quads = 0;
+  unsigned int sf_vert_tot = 0;
+  unsigned int tot_feather_quads = 0;
 
 #ifdef USE_SCANFILL_EDGE_WORKAROUND
-    unsigned int tot_boundary_used = 0;
-    unsigned int tot_boundary_found = 0;
+  unsigned int tot_boundary_used = 0;
+  unsigned int tot_boundary_found = 0;
 #endif
 
-    if (masklay->restrictflag & MASK_RESTRICT_RENDER) {
-      /* skip the layer */
-      mr_handle->layers_tot--;
-      masklay_index--;
-      continue;
-    }
-
-    tot_splines = (unsigned int)BLI_listbase_count(&masklay->splines);
-    open_spline_ranges = MEM_callocN(sizeof(*open_spline_ranges) * tot_splines, __func__);
+  tot_splines = (unsigned int)BLI_listbase_count(&masklay->splines);
+  open_spline_ranges = MEM_callocN(sizeof(*open_spline_ranges) * tot_splines, __func__);
 
-    BLI_scanfill_begin_arena(&sf_ctx, sf_arena);
+  BLI_scanfill_begin_arena(&sf_ctx, sf_arena);
 
-    for (spline = masklay->splines.first; spline; spline = spline->next) {
-      const bool is_cyclic = (spline->flag & MASK_SPLINE_CYCLIC) != 0;
-      const bool is_fill = (spline->flag & MASK_SPLINE_NOFILL) == 0;
+  for (spline = masklay->splines.first; spline; spline = spline->next) {
+    const bool is_cyclic = (spline->flag & MASK_SPLINE_CYCLIC) != 0;
+    const bool is_fill = (spline->flag & MASK_SPLINE_NOFILL) == 0;
 
-      float(*diff_points)[2];
-      unsigned int tot_diff_point;
+    float(*diff_points)[2];
+    unsigned int tot_diff_point;
 
-      float(*diff_feather_points)[2];
-      float(*diff_feather_points_flip)[2];
-      unsigned int tot_diff_feather_points;
+    float(*diff_feather_points)[2];
+    float(*diff_feather_points_flip)[2];
+    unsigned int tot_diff_feather_points;
 
-      const unsigned int resol_a = BKE_mask_spline_resolution(spline, width, height) / 4;
-      const unsigned int resol_b = BKE_mask_spline_feather_resolution(spline, width, height) / 4;
-      const unsigned int resol = CLAMPIS(MAX2(resol_a, resol_b), 4, 512);
+    const unsigned int resol_a = BKE_mask_spline_resolution(spline, width, height) / 4;
+    const unsigned int resol_b = BKE_mask_spline_feather_resolution(spline, width, height) / 4;
+    const unsigned int resol = CLAMPIS(MAX2(resol_a, resol_b), 4, 512);
 
-      diff_points = BKE_mask_spline_differentiate_with_resolution(spline, &tot_diff_point, resol);
+    diff_points = BKE_mask_spline_differentiate_with_resolution(spline, &tot_diff_point, resol);
 
-      if (do_feather) {
-        diff_feather_points = BKE_mask_spline_feather_differentiated_points_with_resolution(
-            spline, &tot_diff_feather_points, resol, false);
-        BLI_assert(diff_feather_points);
-      }
-      else {
-        tot_diff_feather_points = 0;
-        diff_feather_points = NULL;
-      }
+    if (do_feather) {
+      diff_feather_points = BKE_mask_spline_feather_differentiated_points_with_resolution(
+          spline, &tot_diff_feather_points, resol, false);
+      BLI_assert(diff_feather_points);
+    }
+    else {
+      tot_diff_feather_points = 0;
+      diff_feather_points = NULL;
+    }
 
-      if (tot_diff_point > 3) {
-        ScanFillVert *sf_vert_prev;
-        unsigned int j;
+    if (tot_diff_point > 3) {
+      ScanFillVert *sf_vert_prev;
+      unsigned int j;
 
-        float co[3];
-        co[2] = 0.0f;
+      float co[3];
+      co[2] = 0.0f;
 
-        sf_ctx.poly_nr++;
+      sf_ctx.poly_nr++;
 
-        if (do_aspect_correct) {
-          if (width != height) {
-            float *fp;
-            float *ffp;
-            unsigned int i;
-            float asp;
+      if (do_aspect_correct) {
+        if (width != height) {
+          float *fp;
+          float *ffp;
+          unsigned int i;
+          float asp;
 
-            if (width < height) {
-              fp = &diff_points[0][0];
-              ffp = tot_diff_feather_points ? &diff_feather_points[0][0] : NULL;
-              asp = (float)width / (float)height;
-            }
-            else {
-              fp = &diff_points[0][1];
-              ffp = tot_diff_feather_points ? &diff_feather_points[0][1] : NULL;
-              asp = (float)height / (float)width;
-            }
+          if (width < height) {
+            fp = &diff_points[0][0];
+            ffp = tot_diff_feather_points ? &diff_feather_points[0][0] : NULL;
+            asp = (float)width / (float)height;
+          }
+          else {
+            fp = &diff_points[0][1];
+            ffp = tot_diff_feather_points ? &diff_feather_points[0][1] : NULL;
+            asp = (float)height / (float)width;
+          }
 
-            for (i = 0; i < tot_diff_point; i++, fp += 2) {
-              (*fp) = (((*fp) - 0.5f) / asp) + 0.5f;
-            }
+          for (i = 0; i < tot_diff_point; i++, fp += 2) {
+            (*fp) = (((*fp) - 0.5f) / asp) + 0.5f;
+          }
 
-            if (tot_diff_feather_points) {
-              for (i = 0; i < tot_diff_feather_points; i++, ffp += 2) {
-                (*ffp) = (((*ffp) - 0.5f) / asp) + 0.5f;
-              }
+          if (tot_diff_feather_points) {
+            for (i = 0; i < tot_diff_feather_points; i++, ffp += 2) {
+              (*ffp) = (((*ffp) - 0.5f) / asp) + 0.5f;
             }
           }
         }
+      }
 
-        /* fake aa, using small feather */
-        if (do_mask_aa == true) {
-          if (do_feather == false) {
-            tot_diff_feather_points = tot_diff_point;
-            diff_feather_points = MEM_mallocN(
-                sizeof(*diff_feather_points) * (size_t)tot_diff_feather_points, __func__);
-            /* add single pixel feather */
-            maskrasterize_spline_differentiate_point_outset(
-                diff_feather_points, diff_points, tot_diff_point, pixel_size, false);
-          }
-          else {
-            /* ensure single pixel feather, on any zero feather areas */
-            maskrasterize_spline_differentiate_point_outset(
-                diff_feather_points, diff_points, tot_diff_point, pixel_size, true);
-          }
+      /* fake aa, using small feather */
+      if (do_mask_aa == true) {
+        if (do_feather == false) {
+          tot_diff_feather_points = tot_diff_point;
+          diff_feather_points = MEM_mallocN(
+              sizeof(*diff_feather_points) * (size_t)tot_diff_feather_points, __func__);
+          /* add single pixel feather */
+          maskrasterize_spline_differentiate_point_outset(
+              diff_feather_points, diff_points, tot_diff_point, pixel_size, false);
         }
+        else {
+          /* ensure single pixel feather, on any zero feather areas */
+          maskrasterize_spline_differentiate_point_outset(
+              diff_feather_points, diff_points, tot_diff_point, pixel_size, true);
+        }
+      }
 
-        if (is_fill) {
-          /* Apply intersections depending on fill settings. */
-          if (spline->flag & MASK_SPLINE_NOINTERSECT) {
-            BKE_mask_spline_feather_collapse_inner_loops(
-                spline, diff_feather_points, tot_diff_feather_points);
-          }
+      if (is_fill) {
+        /* Apply intersections depending on fill settings. */
+        if (spline->flag & MASK_SPLINE_NOINTERSECT) {
+          BKE_mask_spline_feather_collapse_inner_loops(
+              spline, diff_feather_points, tot_diff_feather_points);
+        }
 
-          copy_v2_v2(co, diff_points[0]);
-          sf_vert_prev = BLI_scanfill_vert_add(&sf_ctx, co);
-          sf_vert_prev->tmp.u = sf_vert_tot;
+        copy_v2_v2(co, diff_points[0]);
+        sf_vert_prev = BLI_scanfill_vert_add(&sf_ctx, co);
+        sf_vert_prev->tmp.u = sf_vert_tot;
 
-          /* Absolute index of feather vert. */
-          sf_vert_prev->keyindex = sf_vert_tot + tot_diff_point;
+        /* Absolute index of feather vert. */
+        sf_vert_prev->keyindex = sf_vert_tot + tot_diff_point;
 
-          sf_vert_tot++;
+        sf_vert_tot++;
 
-          /* TODO, an alternate functions so we can avoid double vector copy! */
-          for (j = 1; j < tot_diff_point; j++) {
-            copy_v2_v2(co, diff_points[j]);
-            sf_vert = BLI_scanfill_vert_add(&sf_ctx, co);
-            sf_vert->tmp.u = sf_vert_tot;
-            sf_vert->keyindex = sf_vert_tot + tot_diff_point; /* absolute index of feather vert */
-            sf_vert_tot++;
-          }
+        /* TODO, an alternate functions so we can avoid double vector copy! */
+        for (j = 1; j < tot_diff_point; j++) {
+          copy_v2_v2(co, diff_points[j]);
+          sf_vert = BLI_scanfill_vert_add(&sf_ctx, co);
+          sf_vert->tmp.u = sf_vert_tot;
+          sf_vert->keyindex = sf_vert_tot + tot_diff_point; /* absolute index of feather vert */
+          sf_vert_tot++;
+        }
 
-          sf_vert = sf_vert_prev;
-          sf_vert_prev = sf_ctx.fillvertbase.last;
+        sf_vert = sf_vert_prev;
+        sf_vert_prev = sf_ctx.fillvertbase.last;
 
-          for (j = 0; j < tot_diff_point; j++) {
-            ScanFillEdge *sf_edge = BLI_scanfill_edge_add(&sf_ctx, sf_vert_prev, sf_vert);
+        for (j = 0; j < tot_diff_point; j++) {
+          ScanFillEdge *sf_edge = BLI_scanfill_edge_add(&sf_ctx, sf_vert_prev, sf_vert);
 
 #ifdef USE_SCANFILL_EDGE_WORKAROUND
-            if (diff_feather_points) {
-              sf_edge->tmp.c = SF_EDGE_IS_BOUNDARY;
-              tot_boundary_used++;
-            }
+          if (diff_feather_points) {
+            sf_edge->tmp.c = SF_EDGE_IS_BOUNDARY;
+            tot_boundary_used++;
+          }
 #else
-            (void)sf_edge;
+          (void)sf_edge;
 #endif
-            sf_vert_prev = sf_vert;
-            sf_vert = sf_vert->next;
-          }
+          sf_vert_prev = sf_vert;
+          sf_vert = sf_vert->next;
+        }
 
-          if (diff_feather_points) {
-            float co_feather[3];
-            co_feather[2] = 1.0f;
-
-            BLI_assert(tot_diff_feather_points == tot_diff_point);
-
-            /* Note: only added for convenience, we don't in fact use these to scan-fill,
-             * only to create feather faces after scan-fill. */
-            for (j = 0; j < tot_diff_feather_points; j++) {
-              copy_v2_v2(co_feather, diff_feather_points[j]);
-              sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
-              sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
-              sf_vert_tot++;
-            }
+        if (diff_feather_points) {
+          float co_feather[3];
+          co_feather[2] = 1.0f;
 
-            tot_feather_quads += tot_diff_point;
+          BLI_assert(tot_diff_feather_points == tot_diff_point);
+
+          /* Note: only added for convenience, we don't in fact use these to scan-fill,
+           * only to create feather faces after scan-fill. */
+          for (j = 0; j < tot_diff_feather_points; j++) {
+            copy_v2_v2(co_feather, diff_feather_points[j]);
+            sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
+            sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
+            sf_vert_tot++;
           }
-        }
-        else {
-          /* unfilled spline */
-          if (diff_feather_points) {
 
-            float co_diff[2];
+          tot_feather_quads += tot_diff_point;
+        }
+      }
+      else {
+        /* unfilled spline */
+        if (diff_feather_points) {
 
-            float co_feather[3];
-            co_feather[2] = 1.0f;
+          float co_diff[2];
 
-            if (spline->flag & MASK_SPLINE_NOINTERSECT) {
-              diff_feather_points_flip = MEM_mallocN(sizeof(float) * 2 * tot_diff_feather_points,
-                                                     "diff_feather_points_flip");
+          float co_feather[3];
+          co_feather[2] = 1.0f;
 
-              for (j = 0; j < tot_diff_point; j++) {
-                sub_v2_v2v2(co_diff, diff_points[j], diff_feather_points[j]);
-                add_v2_v2v2(diff_feather_points_flip[j], diff_points[j], co_diff);
-              }
+          if (spline->flag & MASK_SPLINE_NOINTERSECT) {
+            diff_feather_points_flip = MEM_mallocN(sizeof(float) * 2 * tot_diff_feather_points,
+                                                   "diff_feather_points_flip");
 
-              BKE_mask_spline_feather_collapse_inner_loops(
-                  spline, diff_feather_points, tot_diff_feather_points);
-              BKE_mask_spline_feather_collapse_inner_loops(
-                  spline, diff_feather_points_flip, tot_diff_feather_points);
-            }
-            else {
-              diff_feather_points_flip = NULL;
+            for (j = 0; j < tot_diff_point; j++) {
+              sub_v2_v2v2(co_diff, diff_points[j], diff_feather_points[j]);
+              add_v2_v2v2(diff_feather_points_flip[j], diff_points[j], co_diff);
             }
 
-            open_spline_ranges[open_spline_index].vertex_offset = sf_vert_tot;
-            open_spline_ranges[open_spline_index].vertex_total = tot_diff_point;
-
-            /* TODO, an alternate functions so we can avoid double vector copy! */
-            for (j = 0; j < tot_diff_point; j++) {
+            BKE_mask_spline_feather_collapse_inner_loops(
+                spline, diff_feather_points, tot_diff_feather_points);
+            BKE_mask_spline_feather_collapse_inner_loops(
+                spline, diff_feather_points_flip, tot_diff_feather_points);
+          }
+          else {
+            diff_feather_points_flip = NULL;
+          }
 
-              /* center vert */
-              copy_v2_v2(co, diff_points[j]);
-              sf_vert = BLI_scanfill_vert_add(&sf_ctx, co);
-              sf_vert->tmp.u = sf_vert_tot;
-              sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
-              sf_vert_tot++;
-
-              /* feather vert A */
-              copy_v2_v2(co_feather, diff_feather_points[j]);
-              sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
-              sf_vert->tmp.u = sf_vert_tot;
-              sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
-              sf_vert_tot++;
-
-              /* feather vert B */
-              if (diff_feather_points_flip) {
-                copy_v2_v2(co_feather, diff_feather_points_flip[j]);
-              }
-              else {
-                sub_v2_v2v2(co_diff, co, co_feather);
-                add_v2_v2v2(co_feather, co, co_diff);
-              }
+          open_spline_ranges[open_spline_index].vertex_offset = sf_vert_tot;
+          open_spline_ranges[open_spline_index].vertex_total = tot_diff_point;
 
-              sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
-              sf_vert->tmp.u = sf_vert_tot;
-              sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
-              sf_vert_tot++;
+          /* TODO, an alternate functions so we can avoid double vector copy! */
+          for (j = 0; j < tot_diff_point; j++) {
 
-              tot_feather_quads += 2;
-            }
+            /* center vert */
+            copy_v2_v2(co, diff_points[j]);
+            sf_vert = BLI_scanfill_vert_add(&sf_ctx, co);
+            sf_vert->tmp.u = sf_vert_tot;
+            sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
+            sf_vert_tot++;
 
-            if (!is_cyclic) {
-              tot_feather_quads -= 2;
-            }
+            /* feather vert A */
+            copy_v2_v2(co_feather, diff_feather_points[j]);
+            sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
+            sf_vert->tmp.u = sf_vert_tot;
+            sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
+            sf_vert_tot++;
 
+            /* feather vert B */
             if (diff_feather_points_flip) {
-              MEM_freeN(diff_feather_points_flip);
-              diff_feather_points_flip = NULL;
+              copy_v2_v2(co_feather, diff_feather_points_flip[j]);
             }
+            else {
+              sub_v2_v2v2(co_diff, co, co_feather);
+              add_v2_v2v2(co_feather, co, co_diff);
+            }
+
+            sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
+            sf_vert->tmp.u = sf_vert_tot;
+            sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
+            sf_vert_tot++;
+
+            tot_feather_quads += 2;
+          }
+
+          if (!is_cyclic) {
+            tot_feather_quads -= 2;
+          }
+
+          if (diff_feather_points_flip) {
+            MEM_freeN(diff_feather_points_flip);
+            diff_feather_points_flip = NULL;
+          }
 
-            /* cap ends */
+          /* cap ends */
 
-            /* dummy init value */
-            open_spline_ranges[open_spline_index].vertex_total_cap_head = 0;
-            open_spline_ranges[open_spline_index].vertex_total_cap_tail = 0;
+          /* dummy init value */
+          open_spline_ranges[open_spline_index].vertex_total_cap_head = 0;
+          open_spline_ranges[open_spline_index].vertex_total_cap_tail = 0;
 
-            if (!is_cyclic) {
-              const float *fp_cent;
-              const float *fp_turn;
+          if (!is_cyclic) {
+            const float *fp_cent;
+            const float *fp_turn;
 
-              unsigned int k;
+            unsigned int k;
 
-              fp_cent = diff_points[0];
-              fp_turn = diff_feather_points[0];
+            fp_cent = diff_points[0];
+            fp_turn = diff_feather_points[0];
 
 #define CALC_CAP_RESOL \
-  clampis_uint( \
-      (unsigned int)(len_v2v2(fp_cent, fp_turn) / (pixel_size * SPLINE_RESOL_CAP_PER_PIXEL)), \
-      SPLINE_RESOL_CAP_MIN, \
-      SPLINE_RESOL_CAP_MAX)
-
-              {
-                const unsigned int vertex_total_cap = CALC_CAP_RESOL;
-
-                for (k = 1; k < vertex_total_cap; k++) {
-                  const float angle = (float)k * (1.0f / (float)vertex_total_cap) * (float)M_PI;
-                  rotate_point_v2(co_feather, fp_turn, fp_cent, angle, asp_xy);
-
-                  sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
-                  sf_vert->tmp.u = sf_vert_tot;
-                  sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
-                  sf_vert_tot++;
-                }
-                tot_feather_quads += vertex_total_cap;
-
-                open_spline_ranges[open_spline_index].vertex_total_cap_head = vertex_total_cap;
+clampis_uint( \
+    (unsigned int)(len_v2v2(fp_cent, fp_turn) / (pixel_size * SPLINE_RESOL_CAP_PER_PIXEL)), \
+    SPLINE_RESOL_CAP_MIN, \
+    SPLINE_RESOL_CAP_MAX)
+
+            {
+              const unsigned int vertex_total_cap = CALC_CAP_RESOL;
+
+              for (k = 1; k < vertex_total_cap; k++) {
+                const float angle = (float)k * (1.0f / (float)vertex_total_cap) * (float)M_PI;
+                rotate_point_v2(co_feather, fp_turn, fp_cent, angle, asp_xy);
+
+                sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
+                sf_vert->tmp.u = sf_vert_tot;
+                sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
+                sf_vert_tot++;
               }
+              tot_feather_quads += vertex_total_cap;
 
-              fp_cent = diff_points[tot_diff_point - 1];
-              fp_turn = diff_feather_points[tot_diff_point - 1];
+              open_spline_ranges[open_spline_index].vertex_total_cap_head = vertex_total_cap;
+            }
 
-              {
-                const unsigned int vertex_total_cap = CALC_CAP_RESOL;
+            fp_cent = diff_points[tot_diff_point - 1];
+            fp_turn = diff_feather_points[tot_diff_point - 1];
 
-                for (k = 1; k < vertex_total_cap; k++) {
-                  const float angle = (float)k * (1.0f / (float)vertex_total_cap) * (float)M_PI;
-                  rotate_point_v2(co_feather, fp_turn, fp_cent, -angle, asp_xy);
+            {
+              const unsigned int vertex_total_cap = CALC_CAP_RESOL;
 
-                  sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
-                  sf_vert->tmp.u = sf_vert_tot;
-                  sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
-                  sf_vert_tot++;
-                }
-                tot_feather_quads += vertex_total_cap;
+              for (k = 1; k < vertex_total_cap; k++) {
+                const float angle = (float)k * (1.0f / (float)vertex_total_cap) * (float)M_PI;
+                rotate_point_v2(co_feather, fp_turn, fp_cent, -angle, asp_xy);
 
-                open_spline_ranges[open_spline_index].vertex_total_cap_tail = vertex_total_cap;
+                sf_vert = BLI_scanfill_vert_add(&sf_ctx, co_feather);
+                sf_vert->tmp.u = sf_vert_tot;
+                sf_vert->keyindex = SF_KEYINDEX_TEMP_ID;
+                sf_vert_tot++;
               }
+              tot_feather_quads += vertex_total_cap;
+
+              open_spline_ranges[open_spline_index].vertex_total_cap_tail = vertex_total_cap;
             }
+          }
 
-            open_spline_ranges[open_spline_index].is_cyclic = is_cyclic;
-            open_spline_index++;
+          open_spline_ranges[open_spline_index].is_cyclic = is_cyclic;
+          open_spline_index++;
 
 #undef CALC_CAP_RESOL
-            /* end capping */
-          }
+          /* end capping */
         }
       }
+    }
 
-      if (diff_points) {
-        MEM_freeN(diff_points);
-      }
+    if (diff_points) {
+      MEM_freeN(diff_points);
+    }
 
-      if (diff_feather_points) {
-        MEM_freeN(diff_feather_points);
-      }
+    if (diff_feather_points) {
+      MEM_freeN(diff_feather_points);
     }
+  }
 
-    {
-      unsigned int(*face_array)[4], *face; /* access coords */
-      float(*face_coords)[3], *cos;        /* xy, z 0-1 (1.0 == filled) */
-      unsigned int sf_tri_tot;
-      rctf bounds;
-      unsigned int face_index;
-      int scanfill_flag = 0;
-
-      bool is_isect = false;
-      ListBase isect_remvertbase = {NULL, NULL};
-      ListBase isect_remedgebase = {NULL, NULL};
-
-      /* now we have all the splines */
-      face_coords = MEM_mallocN((sizeof(float) * 3) * sf_vert_tot, "maskrast_face_coords");
-
-      /* init bounds */
-      BLI_rctf_init_minmax(&bounds);
-
-      /* coords */
-      cos = (float *)face_coords;
-      for (sf_vert = sf_ctx.fillvertbase.first; sf_vert; sf_vert = sf_vert_next) {
-        sf_vert_next = sf_vert->next;
-        copy_v3_v3(cos, sf_vert->co);
+  {
+    unsigned int(*face_array)[4], *face; /* access coords */
+    float(*face_coords)[3], *cos;        /* xy, z 0-1 (1.0 == filled) */
+    unsigned int sf_tri_tot;
+    rctf bounds;
+    unsigned int face_index;
+    int scanfill_flag = 0;
 
-        /* remove so as not to interfere with fill (called after) */
-        if (sf_vert->keyindex == SF_KEYINDEX_TEMP_ID) {
-          BLI_remlink(&sf_ctx.fillvertbase, sf_vert);
-        }
+    bool is_isect = false;
+    ListBase isect_remvertbase = {NULL, NULL};
+    ListBase isect_remedgebase = {NULL, NULL};
 
-        /* bounds */
-        BLI_rctf_do_minmax_v(&bounds, cos);
+    /* now we have all the splines */
+    face_coords = MEM_mallocN((sizeof(float) * 3) * sf_vert_tot, "maskrast_face_coords");
 
-        cos += 3;
+    /* init bounds */
+    BLI_rctf_init_minmax(&bounds);
+
+    /* coords */
+    cos = (float *)face_coords;
+    for (sf_vert = sf_ctx.fillvertbase.first; sf_vert; sf_vert = sf_vert_next) {
+      sf_vert_next = sf_vert->next;
+      copy_v3_v3(cos, sf_vert->co);
+
+      /* remove so as not to interfere with fill (called after) */
+      if (sf_vert->keyindex == SF_KEYINDEX_TEMP_ID) {
+        BLI_remlink(&sf_ctx.fillvertbase, sf_vert);
       }
 
-      /* --- inefficient self-intersect case --- */
-      /* if self intersections are found, its too tricky to attempt to map vertices
-       * so just realloc and add entirely new vertices - the result of the self-intersect check.
-       */
-      if ((masklay->flag & MASK_LAYERFLAG_FILL_OVERLAP) &&
-          (is_isect = BLI_scanfill_calc_self_isect(
-               &sf_ctx, &isect_remvertbase, &isect_remedgebase))) {
-        unsigned int sf_vert_tot_isect = (unsigned int)BLI_listbase_count(&sf_ctx.fillvertbase);
-        unsigned int i = sf_vert_tot;
-
-        face_coords = MEM_reallocN(face_coords,
-                                   sizeof(float[3]) * (sf_vert_tot + sf_vert_tot_isect));
-
-        cos = (float *)&face_coords[sf_vert_tot][0];
-
-        for (sf_vert = sf_ctx.fillvertbase.first; sf_vert; sf_vert = sf_vert->next) {
-          copy_v3_v3(cos, sf_vert->co);
-          sf_vert->tmp.u = i++;
-          cos += 3;
-        }
+      /* bounds */
+      BLI_rctf_do_minmax_v(&bounds, cos);
 
-        sf_vert_tot += sf_vert_tot_isect;
+      cos += 3;
+    }
 
-        /* we need to calc polys after self intersect */
-        scanfill_flag |= BLI_SCANFILL_CALC_POLYS;
-      }
-      /* --- end inefficient code --- */
+    /* --- inefficient self-intersect case --- */
+    /* if self intersections are found, its too tricky to attempt to map vertices
+     * so just realloc and add entirely new vertices - the result of the self-intersect check.
+     */
+    if ((masklay->flag & MASK_LAYERFLAG_FILL_OVERLAP) &&
+        (is_isect = BLI_scanfill_calc_self_isect(
+             &sf_ctx, &isect_remvertbase, &isect_remedgebase))) {
+      unsigned int sf_vert_tot_isect = (unsigned int)BLI_listbase_count(&sf_ctx.fillvertbase);
+      unsigned int i = sf_vert_tot;
 
-      /* main scan-fill */
-      if ((masklay->flag & MASK_LAYERFLAG_FILL_DISCRETE) == 0) {
-        scanfill_flag |= BLI_SCANFILL_CALC_HOLES;
-      }
+      face_coords = MEM_reallocN(face_coords,
+                                 sizeof(float[3]) * (sf_vert_tot + sf_vert_tot_isect));
 
-      sf_tri_tot = (unsigned int)BLI_scanfill_calc_ex(&sf_ctx, scanfill_flag, zvec);
+      cos = (float *)&face_coords[sf_vert_tot][0];
 
-      if (is_isect) {
-        /* add removed data back, we only need edges for feather,
-         * but add verts back so they get freed along with others */
-        BLI_movelisttolist(&sf_ctx.fillvertbase, &isect_remvertbase);
-        BLI_movelisttolist(&sf_ctx.filledgebase, &isect_remedgebase);
+      for (sf_vert = sf_ctx.fillvertbase.first; sf_vert; sf_vert = sf_vert->next) {
+        copy_v3_v3(cos, sf_vert->co);
+        sf_vert->tmp.u = i++;
+        cos += 3;
       }
 
-      face_array = MEM_mallocN(sizeof(*face_array) *
-                                   ((size_t)sf_tri_tot + (size_t)tot_feather_quads),
-                               "maskrast_face_index");
-      face_index = 0;
-
-      /* faces */
-      face = (unsigned int *)face_array;
-      for (sf_tri = sf_ctx.fillfacebase.first; sf_tri; sf_tri = sf_tri->next) {
-        *(face++) = sf_tri->v3->tmp.u;
-        *(face++) = sf_tri->v2->tmp.u;
-        *(face++) = sf_tri->v1->tmp.u;
-        *(face++) = TRI_VERT;
-        face_index++;
-        FACE_ASSERT(face - 4, sf_vert_tot);
-      }
+      sf_vert_tot += sf_vert_tot_isect;
 
-      /* start of feather faces... if we have this set,
-       * 'face_index' is kept from loop above */
+      /* we need to calc polys after self intersect */
+      scanfill_flag |= BLI_SCANFILL_CALC_POLYS;
+    }
+    /* --- end inefficient code --- */
 
-      BLI_assert(face_index == sf_tri_tot);
+    /* main scan-fill */
+    if ((masklay->flag & MASK_LAYERFLAG_FILL_DISCRETE) == 0) {
+      scanfill_flag |= BLI_SCANFILL_CALC_HOLES;
+    }
 
-      if (tot_feather_quads) {
-        ScanFillEdge *sf_edge;
+    sf_tri_tot = (unsigned int)BLI_scanfill_calc_ex(&sf_ctx, scanfill_flag, zvec);
 
-        for (sf_edge = sf_ctx.filledgebase.first; sf_edge; sf_edge = sf_edge->next) {
-          if (sf_edge->tmp.c == SF_EDGE_IS_BOUNDARY) {
-            *(face++) = sf_edge->v1->tmp.u;
-            *(face++) = sf_edge->v2->tmp.u;
-            *(face++) = sf_edge->v2->keyindex;
-            *(face++) = sf_edge->v1->keyindex;
-            face_index++;
-            FACE_ASSERT(face - 4, sf_vert_tot);
+    if (is_isect) {
+      /* add removed data back, we only need edges for feather,
+       * but add verts back so they get freed along with others */
+      BLI_movelisttolist(&sf_ctx.fillvertbase, &isect_remvertbase);
+      BLI_movelisttolist(&sf_ctx.filledgebase, &isect_remedgebase);
+    }
+
+    face_array = MEM_mallocN(sizeof(*face_array) *
+                                 ((size_t)sf_tri_tot + (size_t)tot_feather_quads),
+                             "maskrast_face_index");
+    face_index = 0;
+
+    /* faces */
+    face = (unsigned int *)face_array;
+    for (sf_tri = sf_ctx.fillfacebase.first; sf_tri; sf_tri = sf_tri->next) {
+      *(face++) = sf_tri->v3->tmp.u;
+      *(face++) = sf_tri->v2->tmp.u;
+      *(face++) = sf_tri->v1->tmp.u;
+      *(face++) = TRI_VERT;
+      face_index++;
+      FACE_ASSERT(face - 4, sf_vert_tot);
+    }
+
+    /* start of feather faces... if we have this set,
+     * 'face_index' is kept from loop above */
+
+    BLI_assert(face_index == sf_tri_tot);
+
+    if (tot_feather_quads) {
+      ScanFillEdge *sf_edge;
+
+      for (sf_edge = sf_ctx.filledgebase.first; sf_edge; sf_edge = sf_edge->next) {
+        if (sf_edge->tmp.c == SF_EDGE_IS_BOUNDARY) {
+          *(face++) = sf_edge->v1->tmp.u;
+          *(face++) = sf_edge->v2->tmp.u;
+          *(face++) = sf_edge->v2->keyindex;
+          *(face++) = sf_edge->v1->keyindex;
+          face_index++;
+          FACE_ASSERT(face - 4, sf_vert_tot);
 
 #ifdef USE_SCANFILL_EDGE_WORKAROUND
-            tot_boundary_found++;
+          tot_boundary_found++;
 #endif
-          }
         }
       }
+    }
 
 #ifdef USE_SCANFILL_EDGE_WORKAROUND
-      if (tot_boundary_found != tot_boundary_used) {
-        BLI_assert(tot_boundary_found < tot_boundary_used);
-      }
+    if (tot_boundary_found != tot_boundary_used) {
+      BLI_assert(tot_boundary_found < tot_boundary_used);
+    }
 #endif
 
-      /* feather only splines */
-      while (open_spline_index > 0) {
-        const unsigned int vertex_offset = open_spline_ranges[--open_spline_index].vertex_offset;
-        unsigned int vertex_total = open_spline_ranges[open_spline_index].vertex_total;
-        unsigned int vertex_total_cap_head =
-            open_spline_ranges[open_spline_index].vertex_total_cap_head;
-        unsigned int vertex_total_cap_tail =
-            open_spline_ranges[open_spline_index].vertex_total_cap_tail;
-        unsigned int k, j;
+    /* feather only splines */
+    while (open_spline_index > 0) {
+      const unsigned int vertex_offset = open_spline_ranges[--open_spline_index].vertex_offset;
+      unsigned int vertex_total = open_spline_ranges[open_spline_index].vertex_total;
+      unsigned int vertex_total_cap_head =
+          open_spline_ranges[open_spline_index].vertex_total_cap_head;
+      unsigned int vertex_total_cap_tail =
+          open_spline_ranges[open_spline_index].vertex_total_cap_tail;
+      unsigned int k, j;
 
-        j = vertex_offset;
+      j = vertex_offset;
 
-        /* subtract one since we reference next vertex triple */
-        for (k = 0; k < vertex_total - 1; k++, j += 3) {
+      /* subtract one since we reference next vertex triple */
+      for (k = 0; k < vertex_total - 1; k++, j += 3) {
 
-          BLI_assert(j == vertex_offset + (k * 3));
+        BLI_assert(j == vertex_offset + (k * 3));
 
-          *(face++) = j + 3; /* next span */ /* z 1 */
-          *(face++) = j + 0;                 /* z 1 */
-          *(face++) = j + 1;                 /* z 0 */
-          *(face++) = j + 4; /* next span */ /* z 0 */
-          face_index++;
-          FACE_ASSERT(face - 4, sf_vert_tot);
+        *(face++) = j + 3; /* next span */ /* z 1 */
+        *(face++) = j + 0;                 /* z 1 */
+        *(face++) = j + 1;                 /* z 0 */
+        *(face++) = j + 4; /* next span */ /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
 
-          *(face++) = j + 0;                 /* z 1 */
-          *(face++) = j + 3; /* next span */ /* z 1 */
-          *(face++) = j + 5; /* next span */ /* z 0 */
-          *(face++) = j + 2;                 /* z 0 */
-          face_index++;
-          FACE_ASSERT(face - 4, sf_vert_tot);
-        }
+        *(face++) = j + 0;                 /* z 1 */
+        *(face++) = j + 3; /* next span */ /* z 1 */
+        *(face++) = j + 5; /* next span */ /* z 0 */
+        *(face++) = j + 2;                 /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
+      }
 
-        if (open_spline_ranges[open_spline_index].is_cyclic) {
-          *(face++) = vertex_offset + 0; /* next span */ /* z 1 */
-          *(face++) = j + 0;                             /* z 1 */
-          *(face++) = j + 1;                             /* z 0 */
-          *(face++) = vertex_offset + 1; /* next span */ /* z 0 */
-          face_index++;
-          FACE_ASSERT(face - 4, sf_vert_tot);
+      if (open_spline_ranges[open_spline_index].is_cyclic) {
+        *(face++) = vertex_offset + 0; /* next span */ /* z 1 */
+        *(face++) = j + 0;                             /* z 1 */
+        *(face++) = j + 1;                             /* z 0 */
+        *(face++) = vertex_offset + 1; /* next span */ /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
 
-          *(face++) = j + 0;                             /* z 1 */
-          *(face++) = vertex_offset + 0; /* next span */ /* z 1 */
-          *(face++) = vertex_offset + 2; /* next span */ /* z 0 */
-          *(face++) = j + 2;                             /* z 0 */
-          face_index++;
-          FACE_ASSERT(face - 4, sf_vert_tot);
-        }
-        else {
-          unsigned int midvidx = vertex_offset;
-
-          /***************
-           * cap end 'a' */
-          j = midvidx + (vertex_total * 3);
-
-          for (k = 0; k < vertex_total_cap_head - 2; k++, j++) {
-            *(face++) = midvidx + 0; /* z 1 */
-            *(face++) = midvidx + 0; /* z 1 */
-            *(face++) = j + 0;       /* z 0 */
-            *(face++) = j + 1;       /* z 0 */
-            face_index++;
-            FACE_ASSERT(face - 4, sf_vert_tot);
-          }
+        *(face++) = j + 0;                             /* z 1 */
+        *(face++) = vertex_offset + 0; /* next span */ /* z 1 */
+        *(face++) = vertex_offset + 2; /* next span */ /* z 0 */
+        *(face++) = j + 2;                             /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
+      }
+      else {
+        unsigned int midvidx = vertex_offset;
 
-          j = vertex_offset + (vertex_total * 3);
+        /***************
+         * cap end 'a' */
+        j = midvidx + (vertex_total * 3);
 
-          /* 2 tris that join the original */
+        for (k = 0; k < vertex_total_cap_head - 2; k++, j++) {
           *(face++) = midvidx + 0; /* z 1 */
           *(face++) = midvidx + 0; /* z 1 */
-          *(face++) = midvidx + 1; /* z 0 */
           *(face++) = j + 0;       /* z 0 */
+          *(face++) = j + 1;       /* z 0 */
           face_index++;
           FACE_ASSERT(face - 4, sf_vert_tot);
+        }
 
-          *(face++) = midvidx + 0;                   /* z 1 */
-          *(face++) = midvidx + 0;                   /* z 1 */
-          *(face++) = j + vertex_total_cap_head - 2; /* z 0 */
-          *(face++) = midvidx + 2;                   /* z 0 */
-          face_index++;
-          FACE_ASSERT(face - 4, sf_vert_tot);
-
-          /***************
-           * cap end 'b' */
-          /* ... same as previous but v 2-3 flipped, and different initial offsets */
+        j = vertex_offset + (vertex_total * 3);
 
-          j = vertex_offset + (vertex_total * 3) + (vertex_total_cap_head - 1);
+        /* 2 tris that join the original */
+        *(face++) = midvidx + 0; /* z 1 */
+        *(face++) = midvidx + 0; /* z 1 */
+        *(face++) = midvidx + 1; /* z 0 */
+        *(face++) = j + 0;       /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
 
-          midvidx = vertex_offset + (vertex_total * 3) - 3;
+        *(face++) = midvidx + 0;                   /* z 1 */
+        *(face++) = midvidx + 0;                   /* z 1 */
+        *(face++) = j + vertex_total_cap_head - 2; /* z 0 */
+        *(face++) = midvidx + 2;                   /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
 
-          for (k = 0; k < vertex_total_cap_tail - 2; k++, j++) {
-            *(face++) = midvidx; /* z 1 */
-            *(face++) = midvidx; /* z 1 */
-            *(face++) = j + 1;   /* z 0 */
-            *(face++) = j + 0;   /* z 0 */
-            face_index++;
-            FACE_ASSERT(face - 4, sf_vert_tot);
-          }
+        /***************
+         * cap end 'b' */
+        /* ... same as previous but v 2-3 flipped, and different initial offsets */
 
-          j = vertex_offset + (vertex_total * 3) + (vertex_total_cap_head - 1);
+        j = vertex_offset + (vertex_total * 3) + (vertex_total_cap_head - 1);
 
-          /* 2 tris that join the original */
-          *(face++) = midvidx + 0; /* z 1 */
-          *(face++) = midvidx + 0; /* z 1 */
-          *(face++) = j + 0;       /* z 0 */
-          *(face++) = midvidx + 1; /* z 0 */
-          face_index++;
-          FACE_ASSERT(face - 4, sf_vert_tot);
+        midvidx = vertex_offset + (vertex_total * 3) - 3;
 
-          *(face++) = midvidx + 0;                   /* z 1 */
-          *(face++) = midvidx + 0;                   /* z 1 */
-          *(face++) = midvidx + 2;                   /* z 0 */
-          *(face++) = j + vertex_total_cap_tail - 2; /* z 0 */
+        for (k = 0; k < vertex_total_cap_tail - 2; k++, j++) {
+          *(face++) = midvidx; /* z 1 */
+          *(face++) = midvidx; /* z 1 */
+          *(face++) = j + 1;   /* z 0 */
+          *(face++) = j + 0;   /* z 0 */
           face_index++;
           FACE_ASSERT(face - 4, sf_vert_tot);
         }
+
+        j = vertex_offset + (vertex_total * 3) + (vertex_total_cap_head - 1);
+
+        /* 2 tris that join the original */
+        *(face++) = midvidx + 0; /* z 1 */
+        *(face++) = midvidx + 0; /* z 1 */
+        *(face++) = j + 0;       /* z 0 */
+        *(face++) = midvidx + 1; /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
+
+        *(face++) = midvidx + 0;                   /* z 1 */
+        *(face++) = midvidx + 0;                   /* z 1 */
+        *(face++) = midvidx + 2;                   /* z 0 */
+        *(face++) = j + vertex_total_cap_tail - 2; /* z 0 */
+        face_index++;
+        FACE_ASSERT(face - 4, sf_vert_tot);
       }
+    }
 
-      MEM_freeN(open_spline_ranges);
+    MEM_freeN(open_spline_ranges);
 
 #if 0
-      fprintf(stderr,
-              "%u %u (%u %u), %u\n",
-              face_index,
-              sf_tri_tot + tot_feather_quads,
-              sf_tri_tot,
-              tot_feather_quads,
-              tot_boundary_used - tot_boundary_found);
+    fprintf(stderr,
+            "%u %u (%u %u), %u\n",
+            face_index,
+            sf_tri_tot + tot_feather_quads,
+            sf_tri_tot,
+            tot_feather_quads,
+            tot_boundary_used - tot_boundary_found);
 #endif
 
 #ifdef USE_SCANFILL_EDGE_WORKAROUND
-      BLI_assert(face_index + (tot_boundary_used - tot_boundary_found) ==
-                 sf_tri_tot + tot_feather_quads);
+    BLI_assert(face_index + (tot_boundary_used - tot_boundary_found) ==
+               sf_tri_tot + tot_feather_quads);
 #else
-      BLI_assert(face_index == sf_tri_tot + tot_feather_quads);
+    BLI_assert(face_index == sf_tri_tot + tot_feather_quads);
 #endif
-      {
-        MaskRasterLayer *layer = &mr_handle->layers[masklay_index];
-
-        if (BLI_rctf_isect(&default_bounds, &bounds, &bounds)) {
+    {
+      if (BLI_rctf_isect(&default_bounds, &bounds, &bounds)) {
 #ifdef USE_SCANFILL_EDGE_WORKAROUND
-          layer->face_tot = (sf_tri_tot + tot_feather_quads) -
-                            (tot_boundary_used - tot_boundary_found);
+        layer->face_tot = (sf_tri_tot + tot_feather_quads) -
+                          (tot_boundary_used - tot_boundary_found);
 #else
-          layer->face_tot = (sf_tri_tot + tot_feather_quads);
+        layer->face_tot = (sf_tri_tot + tot_feather_quads);
 #endif
-          layer->face_coords = face_coords;
-          layer->face_array = face_array;
-          layer->bounds = bounds;
+        layer->face_coords = face_coords;
+        layer->face_array = face_array;
+        layer->bounds = bounds;
 
-          layer_bucket_init(layer, pixel_size);
+        layer_bucket_init(layer, pixel_size);
+      }
+      else {
+        MEM_freeN(face_coords);
+        MEM_freeN(face_array);
 
-          BLI_rctf_union(&mr_handle->bounds, &bounds);
-        }
-        else {
-          MEM_freeN(face_coords);
-          MEM_freeN(face_array);
+        layer_bucket_init_dummy(layer);
+      }
 
-          layer_bucket_init_dummy(layer);
-        }
+      /* copy as-is */
+      layer->alpha = masklay->alpha;
+      layer->blend = masklay->blend;
+      layer->blend_flag = masklay->blend_flag;
+      layer->falloff = masklay->falloff;
+    }
 
-        /* copy as-is */
-        layer->alpha = masklay->alpha;
-        layer->blend = masklay->blend;
-        layer->blend_flag = masklay->blend_flag;
-        layer->falloff = masklay->falloff;
-      }
+    /* printf("tris %d, feather tris %d\n", sf_tri_tot, tot_feather_quads); */
+  }
+
+  /* add trianges */
+  BLI_scanfill_end_arena(&sf_ctx, sf_arena);
+}
+
+typedef struct MaskRasterizeLayerInitData {
+  MaskRasterLayer *layers;
+  MaskLayer **masklays;
+  int width, height;
+  float pixel_size;
+  float asp_xy[2];
+  bool do_aspect_correct;
+  bool do_mask_aa;
+  bool do_feather;
+} MaskRasterizeLayerInitData;
+
+typedef struct MaskRasterizeLayerInitTLS {
+  MemArena *sf_arena;
+} MaskRasterizeLayerInitTLS;
+
+static void maskrasterize_layer_init_cb(void *__restrict userdata,
+                                        const int index,
+                                        const TaskParallelTLS *__restrict tls)
+{
+  MaskRasterizeLayerInitData *data = userdata;
+  MaskRasterizeLayerInitTLS *tls_data = tls->userdata_chunk;
+
+  if (tls_data->sf_arena == NULL) {
+    tls_data->sf_arena = BLI_memarena_new(BLI_SCANFILL_ARENA_SIZE, __func__);
+  }
 
-      /* printf("tris %d, feather tris %d\n", sf_tri_tot, tot_feather_quads); */
+  maskrasterize_layer_init(&data->layers[index],
+                           data->masklays[index],
+                           data->width,
+                           data->height,
+                           data->pixel_size,
+                           data->asp_xy,
+                           data->do_aspect_correct,
+                           data->do_mask_aa,
+                           data->do_feather,
+                           tls_data->sf_arena);
+}
+
+static void maskrasterize_layer_init_free(const void *__restrict UNUSED(userdata),
+                                          void *__restrict chunk)
+{
+  MaskRasterizeLayerInitTLS *tls_data = chunk;
+  if (tls_data->sf_arena != NULL) {
+    BLI_memarena_free(tls_data->sf_arena);
+    tls_data->sf_arena = NULL;
+  }
+}
+
+void BKE_maskrasterize_handle_init(MaskRasterHandle *mr_handle,
+                                   struct Mask *mask,
+                                   const int width,
+                                   const int height,
+                                   const bool do_aspect_correct,
+                                   const bool do_mask_aa,
+                                   const bool do_feather)
+{
+  MaskLayer *masklay;
+  unsigned int masklay_index;
+
+  MaskRasterizeLayerInitData data = {
+      .width = width,
+      .height = height,
+      .pixel_size = 1.0f / (float)min_ii(width, height),
+      .asp_xy = {(do_aspect_correct && width > height) ? (float)height / (float)width : 1.0f,
+                 (do_aspect_correct && width < height) ? (float)width / (float)height : 1.0f},
+      .do_aspect_correct = do_aspect_correct,
+      .do_mask_aa = do_mask_aa,
+      .do_feather = do_feather,
+  };
+
+  mr_handle->layers_tot = 0;
+  for (masklay = mask->masklayers.first; masklay; masklay = masklay->next) {
+    if ((masklay->restrictflag & MASK_RESTRICT_RENDER) == 0) {
+      mr_handle->layers_tot++;
     }
+  }
+  mr_handle->layers = MEM_mallocN(sizeof(MaskRasterLayer) * mr_handle->layers_tot,
+                                  "MaskRasterLayer");
+  BLI_rctf_init_minmax(&mr_handle->bounds);
 
-    /* add trianges */
-    BLI_scanfill_end_arena(&sf_ctx, sf_arena);
+  data.layers = mr_handle->layers;
+  data.masklays = MEM_mallocN(sizeof(*data.masklays) * mr_handle->layers_tot, __func__);
+  for (masklay = mask->masklayers.first, masklay_index = 0; masklay; masklay = masklay->next) {
+    /* skip the layer */
+    if ((masklay->restrictflag & MASK_RESTRICT_RENDER) == 0) {
+      data.masklays[masklay_index++] = masklay;
+    }
   }
 
-  BLI_memarena_free(sf_arena);
+  /* Layers are tessellated and filled independently of each other. */
+  MaskRasterizeLayerInitTLS tls_data = {NULL};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (mr_handle->layers_tot > 1);
+  settings.userdata_chunk = &tls_data;
+  settings.userdata_chunk_size = sizeof(tls_data);
+  settings.func_free = maskrasterize_layer_init_free;
+  BLI_task_parallel_range(
+      0, (int)mr_handle->layers_tot, &data, maskrasterize_layer_init_cb, &settings);
+
+  MEM_freeN(data.masklays);
+
+  for (masklay_index = 0; masklay_index < mr_handle->layers_tot; masklay_index++) {
+    MaskRasterLayer *layer = &mr_handle->layers[masklay_index];
+    if (layer->face_coords != NULL) {
+      BLI_rctf_union(&mr_handle->bounds, &layer->bounds);
+    }
+  }
 }
 
 /* --------------------------------------------------------------------- */
@@ -110,7 +110,9 @@ static void mesh_copy_data(Main *bmain, ID *id_dst, const ID *id_src, const int
 
   mesh_dst->mat = MEM_dupallocN(mesh_src->mat);
 
-  const eCDAllocType alloc_type = (flag & LIB_ID_COPY_CD_REFERENCE) ? CD_REFERENCE : CD_DUPLICATE;
+  const eCDAllocType alloc_type = (flag & LIB_ID_COPY_CD_REFERENCE) ?
+                                      CD_REFERENCE :
+                                      (flag & LIB_ID_COPY_CD_SHARE) ? CD_SHARE : CD_DUPLICATE;
   CustomData_copy(&mesh_src->vdata, &mesh_dst->vdata, mask.vmask, alloc_type, mesh_dst->totvert);
   CustomData_copy(&mesh_src->edata, &mesh_dst->edata, mask.emask, alloc_type, mesh_dst->totedge);
   CustomData_copy(&mesh_src->ldata, &mesh_dst->ldata, mask.lmask, alloc_type, mesh_dst->totloop);
@@ -811,6 +813,14 @@ Mesh *BKE_mesh_copy_for_eval(struct Mesh *source, bool reference)
   return result;
 }
 
+Mesh *BKE_mesh_copy_for_eval_shared(struct Mesh *source)
+{
+  Mesh *result;
+  BKE_id_copy_ex(
+      NULL, &source->id, (ID **)&result, LIB_ID_COPY_LOCALIZE | LIB_ID_COPY_CD_SHARE);
+  return result;
+}
+
 Mesh *BKE_mesh_copy(Main *bmain, const Mesh *me)
 {
   Mesh *me_copy;
@@ -1643,7 +1653,8 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
   const float split_angle = (mesh->flag & ME_AUTOSMOOTH) != 0 ? mesh->smoothresh : (float)M_PI;
 
   if (CustomData_has_layer(&mesh->ldata, CD_NORMAL)) {
-    r_loopnors = CustomData_get_layer(&mesh->ldata, CD_NORMAL);
+    /* The layer may be shared with the mesh this one was copied from. */
+    r_loopnors = CustomData_duplicate_referenced_layer(&mesh->ldata, CD_NORMAL, mesh->totloop);
     memset(r_loopnors, 0, sizeof(float[3]) * mesh->totloop);
   }
   else {
@@ -1662,6 +1673,7 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
   }
   else {
     polynors = MEM_malloc_arrayN(mesh->totpoly, sizeof(float[3]), __func__);
+    /* Vertex normals are computed along with them, unless they are still valid. */
     BKE_mesh_calc_normals_poly(mesh->mvert,
                                NULL,
                                mesh->totvert,
@@ -1670,7 +1682,7 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
                                mesh->totloop,
                                mesh->totpoly,
                                polynors,
-                               false);
+                               (mesh->runtime.cd_dirty_vert & CD_MASK_NORMAL) == 0);
     free_polynors = true;
   }
 
@@ -78,6 +78,44 @@ static bool mesh_remap_bvhtree_query_nearest(BVHTreeFromMesh *treedata,
   }
 }
 
+/* Same as #mesh_remap_bvhtree_query_nearest, for all given vertices at once (multi-threaded).
+ * Returns an array of results (with a -1 index when nothing was found within max distance),
+ * \a r_cos receives the vertex coordinates converted to tree space. */
+static BVHTreeNearest *mesh_remap_bvhtree_query_nearest_verts(
+    BVHTreeFromMesh *treedata,
+    const MVert *verts_dst,
+    const int numverts_dst,
+    const SpaceTransform *space_transform,
+    const float max_dist_sq,
+    float (**r_cos)[3])
+{
+  float(*cos)[3] = MEM_mallocN(sizeof(*cos) * (size_t)numverts_dst, __func__);
+  BVHTreeNearest *nearest = MEM_mallocN(sizeof(*nearest) * (size_t)numverts_dst, __func__);
+
+  for (int i = 0; i < numverts_dst; i++) {
+    copy_v3_v3(cos[i], verts_dst[i].co);
+
+    /* Convert the vertex to tree coordinates, if needed. */
+    if (space_transform) {
+      BLI_space_transform_apply(space_transform, cos[i]);
+    }
+
+    nearest[i].index = -1;
+    nearest[i].dist_sq = max_dist_sq;
+  }
+
+  BLI_bvhtree_find_nearest_batch(treedata->tree,
+                                 (const float(*)[3])cos,
+                                 numverts_dst,
+                                 nearest,
+                                 treedata->nearest_callback,
+                                 treedata,
+                                 0);
+
+  *r_cos = cos;
+  return nearest;
+}
+
 static bool mesh_remap_bvhtree_query_raycast(BVHTreeFromMesh *treedata,
                                              BVHTreeRayHit *rayhit,
                                              const float co[3],
@@ -519,51 +557,47 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
   }
   else {
     BVHTreeFromMesh treedata = {NULL};
-    BVHTreeNearest nearest = {0};
     BVHTreeRayHit rayhit = {0};
     float hit_dist;
     float tmp_co[3], tmp_no[3];
 
     if (mode == MREMAP_MODE_VERT_NEAREST) {
+      float(*cos)[3];
+
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_VERTS, 2);
-      nearest.index = -1;
+      BVHTreeNearest *nearests = mesh_remap_bvhtree_query_nearest_verts(
+          &treedata, verts_dst, numverts_dst, space_transform, max_dist_sq, &cos);
 
       for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, verts_dst[i].co);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
-
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearest.index, &full_weight);
+        if (nearests[i].index != -1) {
+          hit_dist = sqrtf(nearests[i].dist_sq);
+          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearests[i].index, &full_weight);
         }
         else {
           /* No source for this dest vertex! */
           BKE_mesh_remap_item_define_invalid(r_map, i);
         }
       }
+
+      MEM_freeN(nearests);
+      MEM_freeN(cos);
     }
     else if (ELEM(mode, MREMAP_MODE_VERT_EDGE_NEAREST, MREMAP_MODE_VERT_EDGEINTERP_NEAREST)) {
       MEdge *edges_src = me_src->medge;
       float(*vcos_src)[3] = BKE_mesh_vert_coords_alloc(me_src, NULL);
 
+      float(*cos)[3];
+
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
-      nearest.index = -1;
+      BVHTreeNearest *nearests = mesh_remap_bvhtree_query_nearest_verts(
+          &treedata, verts_dst, numverts_dst, space_transform, max_dist_sq, &cos);
 
       for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, verts_dst[i].co);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+        copy_v3_v3(tmp_co, cos[i]);
 
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          MEdge *me = &edges_src[nearest.index];
+        if (nearests[i].index != -1) {
+          MEdge *me = &edges_src[nearests[i].index];
+          hit_dist = sqrtf(nearests[i].dist_sq);
           const float *v1cos = vcos_src[me->v1];
           const float *v2cos = vcos_src[me->v2];
 
@@ -594,6 +628,8 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
         }
       }
 
+      MEM_freeN(nearests);
+      MEM_freeN(cos);
       MEM_freeN(vcos_src);
     }
     else if (ELEM(mode,
@@ -647,19 +683,14 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
         }
       }
       else {
-        nearest.index = -1;
+        float(*cos)[3];
+        BVHTreeNearest *nearests = mesh_remap_bvhtree_query_nearest_verts(
+            &treedata, verts_dst, numverts_dst, space_transform, max_dist_sq, &cos);
 
         for (i = 0; i < numverts_dst; i++) {
-          copy_v3_v3(tmp_co, verts_dst[i].co);
-
-          /* Convert the vertex to tree coordinates, if needed. */
-          if (space_transform) {
-            BLI_space_transform_apply(space_transform, tmp_co);
-          }
-
-          if (mesh_remap_bvhtree_query_nearest(
-                  &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-            const MLoopTri *lt = &treedata.looptri[nearest.index];
+          if (nearests[i].index != -1) {
+            const MLoopTri *lt = &treedata.looptri[nearests[i].index];
+            hit_dist = sqrtf(nearests[i].dist_sq);
             MPoly *mp = &polys_src[lt->poly];
 
             if (mode == MREMAP_MODE_VERT_POLY_NEAREST) {
@@ -667,7 +698,7 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
               mesh_remap_interp_poly_data_get(mp,
                                               loops_src,
                                               (const float(*)[3])vcos_src,
-                                              nearest.co,
+                                              nearests[i].co,
                                               &tmp_buff_size,
                                               &vcos,
                                               false,
@@ -682,7 +713,7 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
               const int sources_num = mesh_remap_interp_poly_data_get(mp,
                                                                       loops_src,
                                                                       (const float(*)[3])vcos_src,
-                                                                      nearest.co,
+                                                                      nearests[i].co,
                                                                       &tmp_buff_size,
                                                                       &vcos,
                                                                       false,
@@ -699,6 +730,9 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
             BKE_mesh_remap_item_define_invalid(r_map, i);
           }
         }
+
+        MEM_freeN(nearests);
+        MEM_freeN(cos);
       }
 
       MEM_freeN(vcos_src);
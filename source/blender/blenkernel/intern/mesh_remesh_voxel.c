@@ -32,6 +32,7 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_mesh_types.h"
@@ -316,14 +317,60 @@ Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain(Mesh *mesh,
   return new_mesh;
 }
 
-void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
+typedef struct RemeshReprojectData {
+  BVHTreeFromMesh *bvhtree;
+  const MVert *target_verts;
+  const MPoly *target_polys;
+  const MLoop *target_loops;
+  const MLoopTri *source_looptri;
+  int *r_nearest;
+} RemeshReprojectData;
+
+static void remesh_nearest_vert_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  BVHTreeFromMesh *bvhtree = data->bvhtree;
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  BLI_bvhtree_find_nearest(
+      bvhtree->tree, data->target_verts[i].co, &nearest, bvhtree->nearest_callback, bvhtree);
+  data->r_nearest[i] = nearest.index;
+}
+
+/**
+ * Find the closest source vertex of every target vertex, -1 when there is none.
+ * The lookups are independent, so they run in parallel and can be shared by all the layers
+ * that are reprojected.
+ */
+static int *remesh_nearest_verts_find(Mesh *target, Mesh *source)
 {
   BVHTreeFromMesh bvhtree = {
       .nearest_callback = NULL,
   };
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_VERTS, 2);
-  MVert *target_verts = CustomData_get_layer(&target->vdata, CD_MVERT);
 
+  int *nearest_verts = MEM_malloc_arrayN((size_t)target->totvert, sizeof(int), __func__);
+
+  RemeshReprojectData data = {
+      .bvhtree = &bvhtree,
+      .target_verts = CustomData_get_layer(&target->vdata, CD_MVERT),
+      .r_nearest = nearest_verts,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, target->totvert, &data, remesh_nearest_vert_cb, &settings);
+
+  free_bvhtree_from_mesh(&bvhtree);
+  return nearest_verts;
+}
+
+void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
+{
   float *target_mask;
   if (CustomData_has_layer(&target->vdata, CD_PAINT_MASK)) {
     target_mask = CustomData_get_layer(&target->vdata, CD_PAINT_MASK);
@@ -342,18 +389,30 @@ void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
         &source->vdata, CD_PAINT_MASK, CD_CALLOC, NULL, source->totvert);
   }
 
+  int *nearest_verts = remesh_nearest_verts_find(target, source);
   for (int i = 0; i < target->totvert; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    copy_v3_v3(from_co, target_verts[i].co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_mask[i] = source_mask[nearest.index];
+    if (nearest_verts[i] != -1) {
+      target_mask[i] = source_mask[nearest_verts[i]];
     }
   }
-  free_bvhtree_from_mesh(&bvhtree);
+  MEM_freeN(nearest_verts);
+}
+
+static void remesh_nearest_face_set_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  BVHTreeFromMesh *bvhtree = data->bvhtree;
+  float from_co[3];
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  const MPoly *mpoly = &data->target_polys[i];
+  BKE_mesh_calc_poly_center(
+      mpoly, &data->target_loops[mpoly->loopstart], data->target_verts, from_co);
+  BLI_bvhtree_find_nearest(bvhtree->tree, from_co, &nearest, bvhtree->nearest_callback, bvhtree);
+  data->r_nearest[i] = (nearest.index != -1) ? (int)data->source_looptri[nearest.index].poly : -1;
 }
 
 void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
@@ -387,32 +446,43 @@ void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(source);
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_LOOPTRI, 2);
 
+  int *nearest_polys = MEM_malloc_arrayN((size_t)target->totpoly, sizeof(int), __func__);
+
+  RemeshReprojectData data = {
+      .bvhtree = &bvhtree,
+      .target_verts = target_verts,
+      .target_polys = target_polys,
+      .target_loops = target_loops,
+      .source_looptri = looptri,
+      .r_nearest = nearest_polys,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, target->totpoly, &data, remesh_nearest_face_set_cb, &settings);
+
   for (int i = 0; i < target->totpoly; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    const MPoly *mpoly = &target_polys[i];
-    BKE_mesh_calc_poly_center(mpoly, &target_loops[mpoly->loopstart], target_verts, from_co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_face_sets[i] = source_face_sets[looptri[nearest.index].poly];
+    if (nearest_polys[i] != -1) {
+      target_face_sets[i] = source_face_sets[nearest_polys[i]];
     }
     else {
       target_face_sets[i] = 1;
     }
   }
+  MEM_freeN(nearest_polys);
   free_bvhtree_from_mesh(&bvhtree);
 }
 
 void BKE_remesh_reproject_vertex_paint(Mesh *target, Mesh *source)
 {
-  BVHTreeFromMesh bvhtree = {
-      .nearest_callback = NULL,
-  };
-  BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_VERTS, 2);
-
   int tot_color_layer = CustomData_number_of_layers(&source->vdata, CD_PROP_COLOR);
+  if (tot_color_layer == 0) {
+    return;
+  }
+
+  /* All layers share the same closest vertices. */
+  int *nearest_verts = remesh_nearest_verts_find(target, source);
 
   for (int layer_n = 0; layer_n < tot_color_layer; layer_n++) {
     const char *layer_name = CustomData_get_layer_name(&source->vdata, CD_PROP_COLOR, layer_n);
@@ -420,20 +490,14 @@ void BKE_remesh_reproject_vertex_paint(Mesh *target, Mesh *source)
         &target->vdata, CD_PROP_COLOR, CD_CALLOC, NULL, target->totvert, layer_name);
 
     MPropCol *target_color = CustomData_get_layer_n(&target->vdata, CD_PROP_COLOR, layer_n);
-    MVert *target_verts = CustomData_get_layer(&target->vdata, CD_MVERT);
     MPropCol *source_color = CustomData_get_layer_n(&source->vdata, CD_PROP_COLOR, layer_n);
     for (int i = 0; i < target->totvert; i++) {
-      BVHTreeNearest nearest;
-      nearest.index = -1;
-      nearest.dist_sq = FLT_MAX;
-      BLI_bvhtree_find_nearest(
-          bvhtree.tree, target_verts[i].co, &nearest, bvhtree.nearest_callback, &bvhtree);
-      if (nearest.index != -1) {
-        copy_v4_v4(target_color[i].color, source_color[nearest.index].color);
+      if (nearest_verts[i] != -1) {
+        copy_v4_v4(target_color[i].color, source_color[nearest_verts[i]].color);
       }
     }
   }
-  free_bvhtree_from_mesh(&bvhtree);
+  MEM_freeN(nearest_verts);
 }
 
 struct Mesh *BKE_mesh_remesh_voxel_fix_poles(struct Mesh *mesh)
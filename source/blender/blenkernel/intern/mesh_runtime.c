@@ -29,15 +29,19 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_hash_mm2a.h"
 #include "BLI_math_geom.h"
 #include "BLI_threads.h"
 
+#include "BKE_armature.h"
 #include "BKE_bvhutils.h"
+#include "BKE_customdata.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
 #include "BKE_mesh_runtime.h"
 #include "BKE_shrinkwrap.h"
 #include "BKE_subdiv_ccg.h"
+#include "BKE_subdiv_mesh.h"
 
 /* -------------------------------------------------------------------- */
 /** \name Mesh Runtime Struct Utils
@@ -68,6 +72,9 @@ void BKE_mesh_runtime_reset_on_copy(Mesh *mesh, const int UNUSED(flag))
   memset(&runtime->looptris, 0, sizeof(runtime->looptris));
   runtime->bvh_cache = NULL;
   runtime->shrinkwrap_data = NULL;
+  runtime->deform_weights = NULL;
+  runtime->armature_deform_gpu = NULL;
+  runtime->subdiv_gpu = NULL;
 
   mesh->runtime.eval_mutex = MEM_mallocN(sizeof(ThreadMutex), "mesh runtime eval_mutex");
   BLI_mutex_init(mesh->runtime.eval_mutex);
@@ -240,6 +247,9 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
     mesh->runtime.subdiv_ccg = NULL;
   }
   BKE_shrinkwrap_discard_boundary_data(mesh);
+  BKE_armature_deform_weights_free(mesh);
+  BKE_armature_deform_gpu_free(mesh);
+  BKE_subdiv_mesh_gpu_free(mesh);
 }
 
 /** \} */
@@ -265,6 +275,142 @@ void BKE_mesh_batch_cache_free(Mesh *me)
   }
 }
 
+/**
+ * Batch cache of a mesh which is about to be freed, see #BKE_mesh_batch_cache_detach_for_deform.
+ */
+typedef struct MeshBatchCacheDeform {
+  void *batch_cache;
+  int totvert, totedge, totloop, totpoly;
+  uint data_hash;
+} MeshBatchCacheDeform;
+
+static bool mesh_batch_cache_hash_layers(BLI_HashMurmur2A *mm2,
+                                         const CustomData *data,
+                                         const int totelem)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    /* Vertex coordinates and normals are expected to change. */
+    if (ELEM(layer->type, CD_MVERT, CD_NORMAL)) {
+      continue;
+    }
+    BLI_hash_mm2a_add_int(mm2, layer->type);
+    BLI_hash_mm2a_add_int(mm2, layer->active);
+    BLI_hash_mm2a_add_int(mm2, layer->active_rnd);
+    BLI_hash_mm2a_add(mm2, (const uchar *)layer->name, strlen(layer->name));
+
+    if (layer->flag & CD_FLAG_NOFREE) {
+      /* Referenced from the input mesh, which is checked for changes by the caller. */
+      BLI_hash_mm2a_add(mm2, (const uchar *)&layer->data, sizeof(layer->data));
+    }
+    else if (layer->type == CD_MDEFORMVERT) {
+      const MDeformVert *dvert = layer->data;
+      for (int j = 0; j < totelem; j++) {
+        BLI_hash_mm2a_add_int(mm2, dvert[j].totweight);
+        BLI_hash_mm2a_add(
+            mm2, (const uchar *)dvert[j].dw, sizeof(*dvert[j].dw) * (size_t)dvert[j].totweight);
+      }
+    }
+    else if (!ELEM(layer->type, CD_MDISPS, CD_GRID_PAINT_MASK)) {
+      BLI_hash_mm2a_add(
+          mm2, (const uchar *)layer->data, (size_t)CustomData_sizeof(layer->type) * totelem);
+    }
+    else {
+      /* Layers pointing to other allocations can't be compared cheaply. */
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Hash all data that is drawn, except for the vertex coordinates and normals.
+ * Layers referenced from another mesh are hashed by pointer, the caller has to check that mesh
+ * for changes.
+ * \return false when the data can't be hashed.
+ */
+bool BKE_mesh_data_hash_except_coords(const Mesh *me, uint *r_hash)
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  /* Vertex flags are stored next to the coordinates. */
+  for (int i = 0; i < me->totvert; i++) {
+    BLI_hash_mm2a_add_int(&mm2, me->mvert[i].flag);
+    BLI_hash_mm2a_add_int(&mm2, me->mvert[i].bweight);
+  }
+  if (!mesh_batch_cache_hash_layers(&mm2, &me->vdata, me->totvert) ||
+      !mesh_batch_cache_hash_layers(&mm2, &me->edata, me->totedge) ||
+      !mesh_batch_cache_hash_layers(&mm2, &me->ldata, me->totloop) ||
+      !mesh_batch_cache_hash_layers(&mm2, &me->pdata, me->totpoly)) {
+    return false;
+  }
+  *r_hash = BLI_hash_mm2a_end(&mm2);
+  return true;
+}
+
+/**
+ * Detach the batch cache from an evaluated mesh which is about to be freed, so that the GPU
+ * buffers which don't depend on the vertex coordinates can be reused by the next evaluation of the
+ * same object (typical for animation playback of deforming meshes).
+ *
+ * \return NULL when there is nothing to reuse.
+ */
+MeshBatchCacheDeform *BKE_mesh_batch_cache_detach_for_deform(Mesh *me)
+{
+  if (me->runtime.batch_cache == NULL) {
+    return NULL;
+  }
+  uint data_hash;
+  if ((me->edit_mesh != NULL) || !BKE_mesh_data_hash_except_coords(me, &data_hash)) {
+    return NULL;
+  }
+
+  MeshBatchCacheDeform *deform_cache = MEM_mallocN(sizeof(*deform_cache), __func__);
+  deform_cache->batch_cache = me->runtime.batch_cache;
+  deform_cache->totvert = me->totvert;
+  deform_cache->totedge = me->totedge;
+  deform_cache->totloop = me->totloop;
+  deform_cache->totpoly = me->totpoly;
+  deform_cache->data_hash = data_hash;
+  me->runtime.batch_cache = NULL;
+  return deform_cache;
+}
+
+/**
+ * Use a batch cache detached by #BKE_mesh_batch_cache_detach_for_deform for a newly evaluated
+ * mesh. Only the buffers depending on vertex coordinates are updated, as long as nothing else
+ * changed. Otherwise the cache is freed.
+ *
+ * \param input_changed: The input mesh data-block has been updated, so referenced layers can't be
+ * compared by pointer.
+ */
+void BKE_mesh_batch_cache_attach_for_deform(Mesh *me,
+                                            MeshBatchCacheDeform *deform_cache,
+                                            const bool input_changed)
+{
+  uint data_hash;
+  const bool reuse = (me->runtime.batch_cache == NULL) && (me->edit_mesh == NULL) &&
+                     !input_changed && (deform_cache->totvert == me->totvert) &&
+                     (deform_cache->totedge == me->totedge) &&
+                     (deform_cache->totloop == me->totloop) &&
+                     (deform_cache->totpoly == me->totpoly) &&
+                     BKE_mesh_data_hash_except_coords(me, &data_hash) &&
+                     (deform_cache->data_hash == data_hash);
+
+  if (reuse) {
+    me->runtime.batch_cache = deform_cache->batch_cache;
+    BKE_mesh_batch_cache_dirty_tag(me, BKE_MESH_BATCH_DIRTY_DEFORM);
+  }
+  else {
+    /* The free callback needs a mesh, temporarily assign the cache to this one. */
+    void *batch_cache = me->runtime.batch_cache;
+    me->runtime.batch_cache = deform_cache->batch_cache;
+    BKE_mesh_batch_cache_free(me);
+    me->runtime.batch_cache = batch_cache;
+  }
+  MEM_freeN(deform_cache);
+}
+
 /** \} */
 
 /** \name Mesh runtime debug helpers.
@@ -72,6 +72,8 @@
 
 #include "CLG_log.h"
 
+#include "PIL_time.h"
+
 static CLG_LogRef LOG = {"bke.modifier"};
 static ModifierTypeInfo *modifier_types[NUM_MODIFIER_TYPES] = {NULL};
 static VirtualModifierData virtualModifierCommonData;
@@ -965,7 +967,9 @@ static void modwrap_dependsOnNormals(Mesh *me)
       break;
     }
     case ME_WRAPPER_TYPE_MDATA:
-      BKE_mesh_calc_normals(me);
+      /* Normals are only tagged dirty when coordinates or topology changed, reuse them from
+       * the previous modifier or the original mesh otherwise. */
+      BKE_mesh_ensure_normals(me);
       break;
   }
 }
@@ -988,7 +992,11 @@ struct Mesh *BKE_modifier_modify_mesh(ModifierData *md,
   if (mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     modwrap_dependsOnNormals(me);
   }
-  return mti->modifyMesh(md, ctx, me);
+
+  const double start_time = PIL_check_seconds_timer();
+  struct Mesh *result = mti->modifyMesh(md, ctx, me);
+  md->execution_time = (float)(PIL_check_seconds_timer() - start_time);
+  return result;
 }
 
 void BKE_modifier_deform_verts(ModifierData *md,
@@ -1003,7 +1011,10 @@ void BKE_modifier_deform_verts(ModifierData *md,
   if (me && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
     modwrap_dependsOnNormals(me);
   }
+
+  const double start_time = PIL_check_seconds_timer();
   mti->deformVerts(md, ctx, me, vertexCos, numVerts);
+  md->execution_time = (float)(PIL_check_seconds_timer() - start_time);
 }
 
 void BKE_modifier_deform_vertsEM(ModifierData *md,
@@ -1017,9 +1028,12 @@ void BKE_modifier_deform_vertsEM(ModifierData *md,
   BLI_assert(!me || CustomData_has_layer(&me->pdata, CD_NORMAL) == false);
 
   if (me && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
-    BKE_mesh_calc_normals(me);
+    BKE_mesh_ensure_normals(me);
   }
+
+  const double start_time = PIL_check_seconds_timer();
   mti->deformVertsEM(md, ctx, em, me, vertexCos, numVerts);
+  md->execution_time = (float)(PIL_check_seconds_timer() - start_time);
 }
 
 /* end modifier callback wrappers */
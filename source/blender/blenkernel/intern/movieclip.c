@@ -687,6 +687,7 @@ static bool put_imbuf_cache(
                                          moviecache_getprioritydata,
                                          moviecache_getitempriority,
                                          moviecache_prioritydeleter);
+    IMB_moviecache_set_user(moviecache, MOVIECACHE_USER_CLIP);
 
     clip->cache->moviecache = moviecache;
     clip->cache->sequence_offset = -1;
@@ -25,6 +25,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include <limits.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -102,6 +104,9 @@ static void ntree_init_data(ID *id)
   ntree_set_typeinfo(ntree, NULL);
 }
 
+/* Source of unique #bNodeTree.copy_generation values, trees are copied from multiple threads. */
+static int32_t ntree_copy_generation_counter = 0;
+
 static void ntree_copy_data(Main *UNUSED(bmain), ID *id_dst, const ID *id_src, const int flag)
 {
   bNodeTree *ntree_dst = (bNodeTree *)id_dst;
@@ -115,6 +120,8 @@ static void ntree_copy_data(Main *UNUSED(bmain), ID *id_dst, const ID *id_src, c
   /* in case a running nodetree is copied */
   ntree_dst->execdata = NULL;
 
+  ntree_dst->copy_generation = atomic_add_and_fetch_int32(&ntree_copy_generation_counter, 1);
+
   BLI_listbase_clear(&ntree_dst->nodes);
   BLI_listbase_clear(&ntree_dst->links);
 
@@ -28,6 +28,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_listbase.h"
+#include "BLI_memarena.h"
 #include "BLI_string_utf8.h"
 
 #include "BLI_math.h"
@@ -82,6 +83,7 @@ typedef struct DupliContext {
 
   /** Result containers. */
   ListBase *duplilist; /* legacy doubly-linked list */
+  MemArena *duplilist_arena;
 } DupliContext;
 
 typedef struct DupliGenerator {
@@ -116,6 +118,7 @@ static void init_context(DupliContext *r_ctx,
   r_ctx->gen = get_dupli_generator(r_ctx);
 
   r_ctx->duplilist = NULL;
+  r_ctx->duplilist_arena = NULL;
 }
 
 /* create sub-context for recursive duplis */
@@ -150,7 +153,7 @@ static DupliObject *make_dupli(const DupliContext *ctx, Object *ob, float mat[4]
 
   /* add a DupliObject instance to the result container */
   if (ctx->duplilist) {
-    dob = MEM_callocN(sizeof(DupliObject), "dupli object");
+    dob = BLI_memarena_calloc(ctx->duplilist_arena, sizeof(DupliObject));
     BLI_addtail(ctx->duplilist, dob);
   }
   else {
@@ -1120,22 +1123,37 @@ static const DupliGenerator *get_dupli_generator(const DupliContext *ctx)
 
 /* ---- ListBase dupli container implementation ---- */
 
+/* The list and its DupliObjects, which are allocated in blocks. Particle systems and dense
+ * meshes can instance millions of objects, one allocation for each of them is slow to create
+ * and to free. */
+typedef struct DupliList {
+  /* First, so the ListBase given out can be cast back. */
+  ListBase list;
+  MemArena *arena;
+} DupliList;
+
 /* Returns a list of DupliObject */
 ListBase *object_duplilist(Depsgraph *depsgraph, Scene *sce, Object *ob)
 {
-  ListBase *duplilist = MEM_callocN(sizeof(ListBase), "duplilist");
+  DupliList *duplilist = MEM_callocN(sizeof(DupliList), "duplilist");
   DupliContext ctx;
   init_context(&ctx, depsgraph, sce, ob, NULL);
   if (ctx.gen) {
-    ctx.duplilist = duplilist;
+    duplilist->arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "dupli objects");
+    ctx.duplilist = &duplilist->list;
+    ctx.duplilist_arena = duplilist->arena;
     ctx.gen->make_duplis(&ctx);
   }
 
-  return duplilist;
+  return &duplilist->list;
 }
 
+/* Frees the list and all its DupliObjects, these can not be freed separately. */
 void free_object_duplilist(ListBase *lb)
 {
-  BLI_freelistN(lb);
-  MEM_freeN(lb);
+  DupliList *duplilist = (DupliList *)lb;
+  if (duplilist->arena) {
+    BLI_memarena_free(duplilist->arena);
+  }
+  MEM_freeN(duplilist);
 }
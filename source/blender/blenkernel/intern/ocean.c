@@ -168,16 +168,6 @@ static void mul_complex_c(fftw_complex res, const fftw_complex cmpl1, const fftw
   res[1] = temp[1];
 }
 
-static float real_c(fftw_complex cmpl)
-{
-  return cmpl[0];
-}
-
-static float image_c(fftw_complex cmpl)
-{
-  return cmpl[1];
-}
-
 static void conj_complex(fftw_complex res, const fftw_complex cmpl1)
 {
   res[0] = cmpl1[0];
@@ -421,26 +411,36 @@ typedef struct OceanSimulateData {
   float chop_amount;
 } OceanSimulateData;
 
-static void ocean_compute_htilda(void *__restrict userdata,
-                                 const int i,
-                                 const TaskParallelTLS *__restrict UNUSED(tls))
+/**
+ * Computes one row of htilda and, from it, the same row of the input spectrum of every
+ * enabled component. Doing all components per row lets the spectrum generation run in
+ * parallel over rows, instead of one (sequential) component per task.
+ */
+static void ocean_compute_spectrum(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
 {
   OceanSimulateData *osd = userdata;
   const Ocean *o = osd->o;
   const float scale = osd->scale;
   const float t = osd->t;
+  const float chop_amount = osd->chop_amount;
 
   int j;
 
   /* Note the <= _N/2 here, see the FFTW documentation
    * about the mechanics of the complex->real fft storage. */
   for (j = 0; j <= o->_N / 2; j++) {
+    const int index = i * (1 + o->_N / 2) + j;
+    const float k = o->_k[index];
     fftw_complex exp_param1;
     fftw_complex exp_param2;
     fftw_complex conj_param;
+    fftw_complex mul_param;
+    fftw_complex minus_i;
 
-    init_complex(exp_param1, 0.0, omega(o->_k[i * (1 + o->_N / 2) + j], o->_depth) * t);
-    init_complex(exp_param2, 0.0, -omega(o->_k[i * (1 + o->_N / 2) + j], o->_depth) * t);
+    init_complex(exp_param1, 0.0, omega(k, o->_depth) * t);
+    init_complex(exp_param2, 0.0, -omega(k, o->_depth) * t);
     exp_complex(exp_param1, exp_param1);
     exp_complex(exp_param2, exp_param2);
     conj_complex(conj_param, o->_h0_minus[i * o->_N + j]);
@@ -448,8 +448,44 @@ static void ocean_compute_htilda(void *__restrict userdata,
     mul_complex_c(exp_param1, o->_h0[i * o->_N + j], exp_param1);
     mul_complex_c(exp_param2, conj_param, exp_param2);
 
-    add_comlex_c(o->_htilda[i * (1 + o->_N / 2) + j], exp_param1, exp_param2);
-    mul_complex_f(o->_fft_in[i * (1 + o->_N / 2) + j], o->_htilda[i * (1 + o->_N / 2) + j], scale);
+    add_comlex_c(o->_htilda[index], exp_param1, exp_param2);
+    mul_complex_f(o->_fft_in[index], o->_htilda[index], scale);
+
+    if (o->_do_chop) {
+      init_complex(minus_i, 0.0, -1.0);
+      init_complex(mul_param, -scale, 0);
+      mul_complex_f(mul_param, mul_param, chop_amount);
+      mul_complex_c(mul_param, mul_param, minus_i);
+      mul_complex_c(mul_param, mul_param, o->_htilda[index]);
+
+      /* Displacement X. */
+      mul_complex_f(o->_fft_in_x[index], mul_param, ((k == 0.0f) ? 0.0f : o->_kx[i] / k));
+      /* Displacement Z. */
+      mul_complex_f(o->_fft_in_z[index], mul_param, ((k == 0.0f) ? 0.0f : o->_kz[j] / k));
+    }
+
+    if (o->_do_jacobian) {
+      /* init_complex(mul_param, -scale, 0); */
+      init_complex(mul_param, -1, 0);
+
+      mul_complex_f(mul_param, mul_param, chop_amount);
+      mul_complex_c(mul_param, mul_param, o->_htilda[index]);
+
+      mul_complex_f(
+          o->_fft_in_jxx[index], mul_param, ((k == 0.0f) ? 0.0f : o->_kx[i] * o->_kx[i] / k));
+      mul_complex_f(
+          o->_fft_in_jzz[index], mul_param, ((k == 0.0f) ? 0.0f : o->_kz[j] * o->_kz[j] / k));
+      mul_complex_f(
+          o->_fft_in_jxz[index], mul_param, ((k == 0.0f) ? 0.0f : o->_kx[i] * o->_kz[j] / k));
+    }
+
+    if (o->_do_normals) {
+      init_complex(mul_param, 0.0, -1.0);
+      mul_complex_c(mul_param, mul_param, o->_htilda[index]);
+
+      mul_complex_f(o->_fft_in_nx[index], mul_param, o->_kx[i]);
+      mul_complex_f(o->_fft_in_nz[index], mul_param, o->_kz[i]);
+    }
   }
 }
 
@@ -465,28 +501,7 @@ static void ocean_compute_displacement_x(TaskPool *__restrict pool, void *UNUSED
 {
   OceanSimulateData *osd = BLI_task_pool_user_data(pool);
   const Ocean *o = osd->o;
-  const float scale = osd->scale;
-  const float chop_amount = osd->chop_amount;
-  int i, j;
 
-  for (i = 0; i < o->_M; i++) {
-    for (j = 0; j <= o->_N / 2; j++) {
-      fftw_complex mul_param;
-      fftw_complex minus_i;
-
-      init_complex(minus_i, 0.0, -1.0);
-      init_complex(mul_param, -scale, 0);
-      mul_complex_f(mul_param, mul_param, chop_amount);
-      mul_complex_c(mul_param, mul_param, minus_i);
-      mul_complex_c(mul_param, mul_param, o->_htilda[i * (1 + o->_N / 2) + j]);
-      mul_complex_f(mul_param,
-                    mul_param,
-                    ((o->_k[i * (1 + o->_N / 2) + j] == 0.0f) ?
-                         0.0f :
-                         o->_kx[i] / o->_k[i * (1 + o->_N / 2) + j]));
-      init_complex(o->_fft_in_x[i * (1 + o->_N / 2) + j], real_c(mul_param), image_c(mul_param));
-    }
-  }
   fftw_execute(o->_disp_x_plan);
 }
 
@@ -494,28 +509,7 @@ static void ocean_compute_displacement_z(TaskPool *__restrict pool, void *UNUSED
 {
   OceanSimulateData *osd = BLI_task_pool_user_data(pool);
   const Ocean *o = osd->o;
-  const float scale = osd->scale;
-  const float chop_amount = osd->chop_amount;
-  int i, j;
 
-  for (i = 0; i < o->_M; i++) {
-    for (j = 0; j <= o->_N / 2; j++) {
-      fftw_complex mul_param;
-      fftw_complex minus_i;
-
-      init_complex(minus_i, 0.0, -1.0);
-      init_complex(mul_param, -scale, 0);
-      mul_complex_f(mul_param, mul_param, chop_amount);
-      mul_complex_c(mul_param, mul_param, minus_i);
-      mul_complex_c(mul_param, mul_param, o->_htilda[i * (1 + o->_N / 2) + j]);
-      mul_complex_f(mul_param,
-                    mul_param,
-                    ((o->_k[i * (1 + o->_N / 2) + j] == 0.0f) ?
-                         0.0f :
-                         o->_kz[j] / o->_k[i * (1 + o->_N / 2) + j]));
-      init_complex(o->_fft_in_z[i * (1 + o->_N / 2) + j], real_c(mul_param), image_c(mul_param));
-    }
-  }
   fftw_execute(o->_disp_z_plan);
 }
 
@@ -523,26 +517,8 @@ static void ocean_compute_jacobian_jxx(TaskPool *__restrict pool, void *UNUSED(t
 {
   OceanSimulateData *osd = BLI_task_pool_user_data(pool);
   const Ocean *o = osd->o;
-  const float chop_amount = osd->chop_amount;
   int i, j;
 
-  for (i = 0; i < o->_M; i++) {
-    for (j = 0; j <= o->_N / 2; j++) {
-      fftw_complex mul_param;
-
-      /* init_complex(mul_param, -scale, 0); */
-      init_complex(mul_param, -1, 0);
-
-      mul_complex_f(mul_param, mul_param, chop_amount);
-      mul_complex_c(mul_param, mul_param, o->_htilda[i * (1 + o->_N / 2) + j]);
-      mul_complex_f(mul_param,
-                    mul_param,
-                    ((o->_k[i * (1 + o->_N / 2) + j] == 0.0f) ?
-                         0.0f :
-                         o->_kx[i] * o->_kx[i] / o->_k[i * (1 + o->_N / 2) + j]));
-      init_complex(o->_fft_in_jxx[i * (1 + o->_N / 2) + j], real_c(mul_param), image_c(mul_param));
-    }
-  }
   fftw_execute(o->_Jxx_plan);
 
   for (i = 0; i < o->_M; i++) {
@@ -556,26 +532,8 @@ static void ocean_compute_jacobian_jzz(TaskPool *__restrict pool, void *UNUSED(t
 {
   OceanSimulateData *osd = BLI_task_pool_user_data(pool);
   const Ocean *o = osd->o;
-  const float chop_amount = osd->chop_amount;
   int i, j;
 
-  for (i = 0; i < o->_M; i++) {
-    for (j = 0; j <= o->_N / 2; j++) {
-      fftw_complex mul_param;
-
-      /* init_complex(mul_param, -scale, 0); */
-      init_complex(mul_param, -1, 0);
-
-      mul_complex_f(mul_param, mul_param, chop_amount);
-      mul_complex_c(mul_param, mul_param, o->_htilda[i * (1 + o->_N / 2) + j]);
-      mul_complex_f(mul_param,
-                    mul_param,
-                    ((o->_k[i * (1 + o->_N / 2) + j] == 0.0f) ?
-                         0.0f :
-                         o->_kz[j] * o->_kz[j] / o->_k[i * (1 + o->_N / 2) + j]));
-      init_complex(o->_fft_in_jzz[i * (1 + o->_N / 2) + j], real_c(mul_param), image_c(mul_param));
-    }
-  }
   fftw_execute(o->_Jzz_plan);
 
   for (i = 0; i < o->_M; i++) {
@@ -589,26 +547,7 @@ static void ocean_compute_jacobian_jxz(TaskPool *__restrict pool, void *UNUSED(t
 {
   OceanSimulateData *osd = BLI_task_pool_user_data(pool);
   const Ocean *o = osd->o;
-  const float chop_amount = osd->chop_amount;
-  int i, j;
-
-  for (i = 0; i < o->_M; i++) {
-    for (j = 0; j <= o->_N / 2; j++) {
-      fftw_complex mul_param;
-
-      /* init_complex(mul_param, -scale, 0); */
-      init_complex(mul_param, -1, 0);
 
-      mul_complex_f(mul_param, mul_param, chop_amount);
-      mul_complex_c(mul_param, mul_param, o->_htilda[i * (1 + o->_N / 2) + j]);
-      mul_complex_f(mul_param,
-                    mul_param,
-                    ((o->_k[i * (1 + o->_N / 2) + j] == 0.0f) ?
-                         0.0f :
-                         o->_kx[i] * o->_kz[j] / o->_k[i * (1 + o->_N / 2) + j]));
-      init_complex(o->_fft_in_jxz[i * (1 + o->_N / 2) + j], real_c(mul_param), image_c(mul_param));
-    }
-  }
   fftw_execute(o->_Jxz_plan);
 }
 
@@ -616,18 +555,7 @@ static void ocean_compute_normal_x(TaskPool *__restrict pool, void *UNUSED(taskd
 {
   OceanSimulateData *osd = BLI_task_pool_user_data(pool);
   const Ocean *o = osd->o;
-  int i, j;
-
-  for (i = 0; i < o->_M; i++) {
-    for (j = 0; j <= o->_N / 2; j++) {
-      fftw_complex mul_param;
 
-      init_complex(mul_param, 0.0, -1.0);
-      mul_complex_c(mul_param, mul_param, o->_htilda[i * (1 + o->_N / 2) + j]);
-      mul_complex_f(mul_param, mul_param, o->_kx[i]);
-      init_complex(o->_fft_in_nx[i * (1 + o->_N / 2) + j], real_c(mul_param), image_c(mul_param));
-    }
-  }
   fftw_execute(o->_N_x_plan);
 }
 
@@ -635,18 +563,7 @@ static void ocean_compute_normal_z(TaskPool *__restrict pool, void *UNUSED(taskd
 {
   OceanSimulateData *osd = BLI_task_pool_user_data(pool);
   const Ocean *o = osd->o;
-  int i, j;
 
-  for (i = 0; i < o->_M; i++) {
-    for (j = 0; j <= o->_N / 2; j++) {
-      fftw_complex mul_param;
-
-      init_complex(mul_param, 0.0, -1.0);
-      mul_complex_c(mul_param, mul_param, o->_htilda[i * (1 + o->_N / 2) + j]);
-      mul_complex_f(mul_param, mul_param, o->_kz[i]);
-      init_complex(o->_fft_in_nz[i * (1 + o->_N / 2) + j], real_c(mul_param), image_c(mul_param));
-    }
-  }
   fftw_execute(o->_N_z_plan);
 }
 
@@ -667,18 +584,16 @@ void BKE_ocean_simulate(struct Ocean *o, float t, float scale, float chop_amount
 
   BLI_rw_mutex_lock(&o->oceanmutex, THREAD_LOCK_WRITE);
 
-  /* Note about multi-threading here: we have to run a first set of computations (htilda one)
-   * before we can run all others, since they all depend on it.
-   * So we make a first parallelized forloop run for htilda,
-   * and then pack all other computations into a set of parallel tasks.
-   * This is not optimal in all cases,
-   * but remains reasonably simple and should be OK most of the time. */
+  /* Note about multi-threading here: all spectra depend on htilda, which only depends on
+   * values of the same row, so a first parallelized forloop computes htilda and the
+   * input spectra of all components row by row.
+   * The FFTs of the components are independent and then run as a set of parallel tasks. */
 
-  /* compute a new htilda */
+  /* compute a new htilda and the component spectra */
   TaskParallelSettings settings;
   BLI_parallel_range_settings_defaults(&settings);
   settings.use_threading = (o->_M > 16);
-  BLI_task_parallel_range(0, o->_M, &osd, ocean_compute_htilda, &settings);
+  BLI_task_parallel_range(0, o->_M, &osd, ocean_compute_spectrum, &settings);
 
   if (o->_do_disp_y) {
     BLI_task_pool_push(pool, ocean_compute_displacement_y, NULL, false, NULL);
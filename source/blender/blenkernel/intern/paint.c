@@ -1582,6 +1582,7 @@ static void sculpt_update_object(Depsgraph *depsgraph,
     BKE_mesh_vert_poly_map_create(
         &ss->pmap, &ss->pmap_mem, me->mpoly, me->mloop, me->totvert, me->totpoly, me->totloop);
   }
+  BKE_pbvh_pmap_set(ss->pbvh, (ob->type == OB_MESH) ? ss->pmap : NULL);
 
   pbvh_show_mask_set(ss->pbvh, ss->show_mask);
   pbvh_show_face_sets_set(ss->pbvh, ss->show_face_sets);
@@ -319,6 +319,20 @@ static ParticleCacheKey **psys_alloc_path_cache_buffers(ListBase *bufs, int tot,
   return cache;
 }
 
+/* Number of keys per path the buffers were allocated with, zero when there are none. */
+static int psys_path_cache_buffers_totkeys(ListBase *bufs, int tot)
+{
+  LinkData *buf = bufs->first;
+
+  if (buf == NULL) {
+    return 0;
+  }
+
+  tot = MAX2(tot, 1);
+  return MEM_allocN_len(buf->data) /
+         (sizeof(ParticleCacheKey) * (size_t)MIN2(tot, PATH_CACHE_BUF_SIZE));
+}
+
 static void psys_free_path_cache_buffers(ParticleCacheKey **cache, ListBase *bufs)
 {
   LinkData *buf;
@@ -2844,12 +2858,16 @@ static void exec_child_path_cache(TaskPool *__restrict UNUSED(pool), void *taskd
   ParticleThreadContext *ctx = task->ctx;
   ParticleSystem *psys = ctx->sim.psys;
   ParticleCacheKey **cache = psys->childcache;
+  const int totkeys = ctx->segments + ctx->extra_segments + 1;
   ChildParticle *cpa;
   int i;
 
   cpa = psys->child + task->begin;
   for (i = task->begin; i < task->end; i++, cpa++) {
     BLI_assert(i < psys->totchildcache);
+    if (ctx->clear_child_cache) {
+      memset(cache[i], 0, sizeof(ParticleCacheKey) * totkeys);
+    }
     psys_thread_create_path(task, cpa, cache[i], i);
   }
 }
@@ -2863,7 +2881,7 @@ void psys_cache_child_paths(ParticleSimulationData *sim,
   ParticleThreadContext ctx;
   ParticleTask *tasks_parent, *tasks_child;
   int numtasks_parent, numtasks_child;
-  int i, totchild, totparent;
+  int i, totchild, totparent, totkeys;
 
   if (sim->psys->flag & PSYS_GLOBAL_HAIR) {
     return;
@@ -2877,16 +2895,23 @@ void psys_cache_child_paths(ParticleSimulationData *sim,
   task_pool = BLI_task_pool_create(&ctx, TASK_PRIORITY_LOW);
   totchild = ctx.totchild;
   totparent = ctx.totparent;
+  totkeys = ctx.segments + ctx.extra_segments + 1;
 
   if (editupdate && sim->psys->childcache && totchild == sim->psys->totchildcache) {
     /* just overwrite the existing cache */
   }
+  else if (sim->psys->childcache && totchild == sim->psys->totchildcache &&
+           totkeys == psys_path_cache_buffers_totkeys(&sim->psys->childcachebufs, totchild)) {
+    /* Same layout as before, clearing the keys in the tasks avoids freeing and allocating
+     * the buffers again, which is slow for millions of children. */
+    ctx.clear_child_cache = true;
+  }
   else {
     /* clear out old and create new empty path cache */
     free_child_path_cache(sim->psys);
 
     sim->psys->childcache = psys_alloc_path_cache_buffers(
-        &sim->psys->childcachebufs, totchild, ctx.segments + ctx.extra_segments + 1);
+        &sim->psys->childcachebufs, totchild, totkeys);
     sim->psys->totchildcache = totchild;
   }
 
@@ -4956,6 +4956,10 @@ void particle_system_update(struct Depsgraph *depsgraph,
     psys_orig->edit->flags |= PT_CACHE_EDIT_UPDATE_PARTICLE_FROM_EVAL;
   }
 
+  /* Without settings change only the paths moved, drawing keeps the strands data. */
+  const int batch_dirty_mode = (psys->recalc & ID_RECALC_PSYS_ALL) ? BKE_PARTICLE_BATCH_DIRTY_ALL :
+                                                                      BKE_PARTICLE_BATCH_DIRTY_POS;
+
   psys->cfra = cfra;
   psys->recalc = 0;
 
@@ -4976,7 +4980,7 @@ void particle_system_update(struct Depsgraph *depsgraph,
    * at rendertime the actual dupliobject's matrix is used so don't update! */
   invert_m4_m4(psys->imat, ob->obmat);
 
-  BKE_particle_batch_cache_dirty_tag(psys, BKE_PARTICLE_BATCH_DIRTY_ALL);
+  BKE_particle_batch_cache_dirty_tag(psys, batch_dirty_mode);
 }
 
 /* ID looper */
@@ -33,6 +33,7 @@
 
 #include "BKE_ccg.h"
 #include "BKE_mesh.h" /* for BKE_mesh_calc_normals */
+#include "BKE_mesh_mapping.h"
 #include "BKE_paint.h"
 #include "BKE_pbvh.h"
 #include "BKE_subdiv_ccg.h"
@@ -1103,8 +1104,57 @@ static void pbvh_update_normals_store_task_cb(void *__restrict userdata,
   }
 }
 
+/* Gather the normals of the polygons around every updated vertex a node owns. Every vertex is
+ * written by a single thread, so unlike the accumulation above this needs neither atomics nor a
+ * buffer for all vertices of the mesh. */
+static void pbvh_update_normals_gather_task_cb(void *__restrict userdata,
+                                               const int n,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHUpdateData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  PBVHNode *node = data->nodes[n];
+
+  if (node->flag & PBVH_UpdateNormals) {
+    const int *verts = node->vert_indices;
+    const int totvert = node->uniq_verts;
+
+    for (int i = 0; i < totvert; i++) {
+      const int v = verts[i];
+      MVert *mvert = &pbvh->verts[v];
+
+      if (mvert->flag & ME_VERT_PBVH_UPDATE) {
+        const MeshElemMap *vert_map = &pbvh->pmap[v];
+        float no[3] = {0.0f, 0.0f, 0.0f};
+        for (int j = 0; j < vert_map->count; j++) {
+          const MPoly *mp = &pbvh->mpoly[vert_map->indices[j]];
+          float fn[3];
+          BKE_mesh_calc_poly_normal(mp, &pbvh->mloop[mp->loopstart], pbvh->verts, fn);
+          add_v3_v3(no, fn);
+        }
+        normalize_v3(no);
+        normal_float_to_short_v3(mvert->no, no);
+        mvert->flag &= ~ME_VERT_PBVH_UPDATE;
+      }
+    }
+
+    node->flag &= ~PBVH_UpdateNormals;
+  }
+}
+
 static void pbvh_faces_update_normals(PBVH *pbvh, PBVHNode **nodes, int totnode)
 {
+  if (pbvh->pmap != NULL) {
+    PBVHUpdateData data = {
+        .pbvh = pbvh,
+        .nodes = nodes,
+    };
+    TaskParallelSettings settings;
+    BKE_pbvh_parallel_range_settings(&settings, true, totnode);
+    BLI_task_parallel_range(0, totnode, &data, pbvh_update_normals_gather_task_cb, &settings);
+    return;
+  }
+
   /* could be per node to save some memory, but also means
    * we have to store for each vertex which node it is in */
   float(*vnors)[3] = MEM_callocN(sizeof(*vnors) * pbvh->totvert, __func__);
@@ -3075,6 +3125,12 @@ void BKE_pbvh_face_sets_set(PBVH *pbvh, int *face_sets)
   pbvh->face_sets = face_sets;
 }
 
+/* The map has to stay valid as long as the PBVH uses it, and match its polygons. */
+void BKE_pbvh_pmap_set(PBVH *pbvh, const MeshElemMap *pmap)
+{
+  pbvh->pmap = pmap;
+}
+
 void BKE_pbvh_respect_hide_set(PBVH *pbvh, bool respect_hide)
 {
   pbvh->respect_hide = respect_hide;
@@ -135,6 +135,9 @@ struct PBVH {
   const MPoly *mpoly;
   const MLoop *mloop;
   const MLoopTri *looptri;
+  /* Polygons using every vertex, optional. Allows updating normals without accumulating them
+   * for all vertices, see #BKE_pbvh_pmap_set. */
+  const struct MeshElemMap *pmap;
   CustomData *vdata;
   CustomData *ldata;
   CustomData *pdata;
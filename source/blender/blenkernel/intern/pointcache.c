@@ -2396,31 +2396,103 @@ static int ptcache_file_write(PTCacheFile *pf, const void *f, unsigned int tot,
 {
   return (fwrite(f, size, tot, pf->fp) == tot);
 }
-static int ptcache_file_data_read(PTCacheFile *pf)
+
+/* Uncompressed frames store the data of each point one after the other. Points are read and
+ * written in blocks instead of one small read or write per point and data type. */
+#define PTCACHE_FILE_POINTS_BLOCK 4096
+
+static unsigned int ptcache_file_point_size(int data_types)
 {
-  int i;
+  unsigned int point_size = 0;
 
-  for (i = 0; i < BPHYS_TOT_DATA; i++) {
-    if ((pf->data_types & (1 << i)) &&
-        !ptcache_file_read(pf, pf->cur[i], 1, ptcache_data_size[i])) {
-      return 0;
+  for (int i = 0; i < BPHYS_TOT_DATA; i++) {
+    if (data_types & (1 << i)) {
+      point_size += ptcache_data_size[i];
     }
   }
 
-  return 1;
+  return point_size;
 }
-static int ptcache_file_data_write(PTCacheFile *pf)
+static int ptcache_file_points_read(PTCacheFile *pf, PTCacheMem *pm)
 {
-  int i;
+  const unsigned int point_size = ptcache_file_point_size(pf->data_types);
+  unsigned char *block;
+  int error = 0;
 
-  for (i = 0; i < BPHYS_TOT_DATA; i++) {
-    if ((pf->data_types & (1 << i)) &&
-        !ptcache_file_write(pf, pf->cur[i], 1, ptcache_data_size[i])) {
-      return 0;
+  if (point_size == 0 || pm->totpoint == 0) {
+    return 1;
+  }
+
+  block = MEM_mallocN(point_size * min_ii(pm->totpoint, PTCACHE_FILE_POINTS_BLOCK), __func__);
+
+  for (unsigned int start = 0; start < pm->totpoint; start += PTCACHE_FILE_POINTS_BLOCK) {
+    const unsigned int totblock = min_ii(pm->totpoint - start, PTCACHE_FILE_POINTS_BLOCK);
+    unsigned int offset = 0;
+
+    if (!ptcache_file_read(pf, block, totblock, point_size)) {
+      error = 1;
+      break;
+    }
+
+    for (int i = 0; i < BPHYS_TOT_DATA; i++) {
+      if ((pf->data_types & (1 << i)) == 0) {
+        continue;
+      }
+      if (pm->data[i]) {
+        const unsigned int size = ptcache_data_size[i];
+        unsigned char *to = (unsigned char *)pm->data[i] + (size_t)start * size;
+        for (unsigned int p = 0; p < totblock; p++) {
+          memcpy(to + p * size, block + p * point_size + offset, size);
+        }
+      }
+      offset += ptcache_data_size[i];
     }
   }
 
-  return 1;
+  MEM_freeN(block);
+
+  return !error;
+}
+static int ptcache_file_points_write(PTCacheFile *pf, PTCacheMem *pm)
+{
+  const unsigned int point_size = ptcache_file_point_size(pf->data_types);
+  unsigned char *block;
+  int error = 0;
+
+  if (point_size == 0 || pm->totpoint == 0) {
+    return 1;
+  }
+
+  /* Data types missing from the memory frame are written as zeros. */
+  block = MEM_callocN(point_size * min_ii(pm->totpoint, PTCACHE_FILE_POINTS_BLOCK), __func__);
+
+  for (unsigned int start = 0; start < pm->totpoint; start += PTCACHE_FILE_POINTS_BLOCK) {
+    const unsigned int totblock = min_ii(pm->totpoint - start, PTCACHE_FILE_POINTS_BLOCK);
+    unsigned int offset = 0;
+
+    for (int i = 0; i < BPHYS_TOT_DATA; i++) {
+      if ((pf->data_types & (1 << i)) == 0) {
+        continue;
+      }
+      if (pm->data[i]) {
+        const unsigned int size = ptcache_data_size[i];
+        const unsigned char *from = (const unsigned char *)pm->data[i] + (size_t)start * size;
+        for (unsigned int p = 0; p < totblock; p++) {
+          memcpy(block + p * point_size + offset, from + p * size, size);
+        }
+      }
+      offset += ptcache_data_size[i];
+    }
+
+    if (!ptcache_file_write(pf, block, totblock, point_size)) {
+      error = 1;
+      break;
+    }
+  }
+
+  MEM_freeN(block);
+
+  return !error;
 }
 static int ptcache_file_header_begin_read(PTCacheFile *pf)
 {
@@ -2730,18 +2802,8 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
         }
       }
     }
-    else {
-      BKE_ptcache_mem_pointers_init(pm);
-      ptcache_file_pointers_init(pf);
-
-      for (i = 0; i < pm->totpoint; i++) {
-        if (!ptcache_file_data_read(pf)) {
-          error = 1;
-          break;
-        }
-        ptcache_data_copy(pf->cur, pm->cur);
-        BKE_ptcache_mem_pointers_incr(pm);
-      }
+    else if (!ptcache_file_points_read(pf, pm)) {
+      error = 1;
     }
   }
 
@@ -2831,18 +2893,8 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
         }
       }
     }
-    else {
-      BKE_ptcache_mem_pointers_init(pm);
-      ptcache_file_pointers_init(pf);
-
-      for (i = 0; i < pm->totpoint; i++) {
-        ptcache_data_copy(pm->cur, pf->cur);
-        if (!ptcache_file_data_write(pf)) {
-          error = 1;
-          break;
-        }
-        BKE_ptcache_mem_pointers_incr(pm);
-      }
+    else if (!ptcache_file_points_write(pf, pm)) {
+      error = 1;
     }
   }
 
@@ -35,6 +35,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #ifdef WITH_BULLET
 #  include "RBI_api.h"
@@ -1631,21 +1632,32 @@ static void rigidbody_update_sim_world(Scene *scene, RigidBodyWorld *rbw)
   rigidbody_update_ob_array(rbw);
 }
 
+/* Objects which are being moved by the user are temporarily made kinematic. */
+static bool rigidbody_ob_is_transformed(ViewLayer *view_layer, Object *ob)
+{
+  if ((G.moving & G_TRANSFORM_OBJ) == 0) {
+    return false;
+  }
+  Base *base = BKE_view_layer_base_find(view_layer, ob);
+  return base ? (base->flag & BASE_SELECTED) != 0 : false;
+}
+
+/**
+ * Update the shape and the forces of effectors on a simulation object.
+ *
+ * Transformations are synced separately in #rigidbody_update_sim_ob_transform_cb, effectors
+ * can't be evaluated in parallel since they share their random number generator.
+ */
 static void rigidbody_update_sim_ob(
     Depsgraph *depsgraph, Scene *scene, RigidBodyWorld *rbw, Object *ob, RigidBodyOb *rbo)
 {
-  float loc[3];
-  float rot[4];
-  float scale[3];
-
   /* only update if rigid body exists */
   if (rbo->shared->physics_object == NULL) {
     return;
   }
 
   ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
-  Base *base = BKE_view_layer_base_find(view_layer, ob);
-  const bool is_selected = base ? (base->flag & BASE_SELECTED) != 0 : false;
+  const bool is_transformed = rigidbody_ob_is_transformed(view_layer, ob);
 
   if (rbo->shape == RB_SHAPE_TRIMESH && rbo->flag & RBO_FLAG_USE_DEFORM) {
     Mesh *mesh = ob->runtime.mesh_deform_eval;
@@ -1663,32 +1675,14 @@ static void rigidbody_update_sim_ob(
     }
   }
 
-  mat4_decompose(loc, rot, scale, ob->obmat);
-
-  /* update scale for all objects */
-  RB_body_set_scale(rbo->shared->physics_object, scale);
-  /* compensate for embedded convex hull collision margin */
-  if (!(rbo->flag & RBO_FLAG_USE_MARGIN) && rbo->shape == RB_SHAPE_CONVEXH) {
-    RB_shape_set_margin(rbo->shared->physics_shape,
-                        RBO_GET_MARGIN(rbo) * MIN3(scale[0], scale[1], scale[2]));
-  }
-
-  /* Make transformed objects temporarily kinmatic
-   * so that they can be moved by the user during simulation. */
-  if (is_selected && (G.moving & G_TRANSFORM_OBJ)) {
-    RB_body_set_kinematic_state(rbo->shared->physics_object, true);
-    RB_body_set_mass(rbo->shared->physics_object, 0.0f);
+  /* kinematic bodies get their location and rotation from the object instead */
+  if (rbo->flag & RBO_FLAG_KINEMATIC || is_transformed) {
+    return;
   }
 
-  /* update rigid body location and rotation for kinematic bodies */
-  if (rbo->flag & RBO_FLAG_KINEMATIC || (is_selected && (G.moving & G_TRANSFORM_OBJ))) {
-    RB_body_activate(rbo->shared->physics_object);
-    RB_body_set_loc_rot(rbo->shared->physics_object, loc, rot);
-  }
   /* update influence of effectors - but don't do it on an effector */
   /* only dynamic bodies need effector update */
-  else if (rbo->type == RBO_TYPE_ACTIVE &&
-           ((ob->pd == NULL) || (ob->pd->forcefield == PFIELD_NULL))) {
+  if (rbo->type == RBO_TYPE_ACTIVE && ((ob->pd == NULL) || (ob->pd->forcefield == PFIELD_NULL))) {
     EffectorWeights *effector_weights = rbw->effector_weights;
     EffectedPoint epoint;
     ListBase *effectors;
@@ -1738,6 +1732,54 @@ static void rigidbody_update_sim_ob(
    */
 }
 
+typedef struct RigidbodyUpdateSimObData {
+  RigidBodyWorld *rbw;
+  ViewLayer *view_layer;
+} RigidbodyUpdateSimObData;
+
+/* Sync the object transformation to its simulation body, which only touches the body and shape
+ * of that object. */
+static void rigidbody_update_sim_ob_transform_cb(void *__restrict userdata,
+                                                 const int i,
+                                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RigidbodyUpdateSimObData *data = userdata;
+  Object *ob = data->rbw->objects[i];
+  RigidBodyOb *rbo = ob->rigidbody_object;
+  float loc[3];
+  float rot[4];
+  float scale[3];
+
+  if (ob->type != OB_MESH || rbo == NULL || rbo->shared->physics_object == NULL) {
+    return;
+  }
+
+  const bool is_transformed = rigidbody_ob_is_transformed(data->view_layer, ob);
+
+  mat4_decompose(loc, rot, scale, ob->obmat);
+
+  /* update scale for all objects */
+  RB_body_set_scale(rbo->shared->physics_object, scale);
+  /* compensate for embedded convex hull collision margin */
+  if (!(rbo->flag & RBO_FLAG_USE_MARGIN) && rbo->shape == RB_SHAPE_CONVEXH) {
+    RB_shape_set_margin(rbo->shared->physics_shape,
+                        RBO_GET_MARGIN(rbo) * MIN3(scale[0], scale[1], scale[2]));
+  }
+
+  /* Make transformed objects temporarily kinmatic
+   * so that they can be moved by the user during simulation. */
+  if (is_transformed) {
+    RB_body_set_kinematic_state(rbo->shared->physics_object, true);
+    RB_body_set_mass(rbo->shared->physics_object, 0.0f);
+  }
+
+  /* update rigid body location and rotation for kinematic bodies */
+  if (rbo->flag & RBO_FLAG_KINEMATIC || is_transformed) {
+    RB_body_activate(rbo->shared->physics_object);
+    RB_body_set_loc_rot(rbo->shared->physics_object, loc, rot);
+  }
+}
+
 /**
  * Updates and validates world, bodies and shapes.
  *
@@ -1834,6 +1876,18 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
   }
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 
+  /* Every object has its own body and shape, so transformations can be synced in parallel once
+   * all objects are validated. */
+  RigidbodyUpdateSimObData data = {
+      .rbw = rbw,
+      .view_layer = DEG_get_input_view_layer(depsgraph),
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(
+      0, rbw->numbodies, &data, rigidbody_update_sim_ob_transform_cb, &settings);
+
   /* update constraints */
   if (rbw->constraints == NULL) { /* no constraints, move on */
     return;
@@ -1874,26 +1928,41 @@ static void rigidbody_update_simulation(Depsgraph *depsgraph,
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
-static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBodyWorld *rbw)
+static void rigidbody_update_simulation_post_step_cb(
+    void *__restrict userdata, const int i, const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph);
+  RigidbodyUpdateSimObData *data = userdata;
+  Object *ob = data->rbw->objects[i];
+  RigidBodyOb *rbo = ob->rigidbody_object;
 
-  FOREACH_COLLECTION_OBJECT_RECURSIVE_BEGIN (rbw->group, ob) {
-    Base *base = BKE_view_layer_base_find(view_layer, ob);
-    RigidBodyOb *rbo = ob->rigidbody_object;
-    /* Reset kinematic state for transformed objects. */
-    if (rbo && base && (base->flag & BASE_SELECTED) && (G.moving & G_TRANSFORM_OBJ) &&
-        rbo->shared->physics_object) {
-      RB_body_set_kinematic_state(rbo->shared->physics_object,
-                                  rbo->flag & RBO_FLAG_KINEMATIC || rbo->flag & RBO_FLAG_DISABLED);
-      RB_body_set_mass(rbo->shared->physics_object, RBO_GET_MASS(rbo));
-      /* Deactivate passive objects so they don't interfere with deactivation of active objects. */
-      if (rbo->type == RBO_TYPE_PASSIVE) {
-        RB_body_deactivate(rbo->shared->physics_object);
-      }
+  /* Reset kinematic state for transformed objects. */
+  if (rbo && rbo->shared->physics_object && rigidbody_ob_is_transformed(data->view_layer, ob)) {
+    RB_body_set_kinematic_state(rbo->shared->physics_object,
+                                rbo->flag & RBO_FLAG_KINEMATIC || rbo->flag & RBO_FLAG_DISABLED);
+    RB_body_set_mass(rbo->shared->physics_object, RBO_GET_MASS(rbo));
+    /* Deactivate passive objects so they don't interfere with deactivation of active objects. */
+    if (rbo->type == RBO_TYPE_PASSIVE) {
+      RB_body_deactivate(rbo->shared->physics_object);
     }
   }
-  FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
+}
+
+static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBodyWorld *rbw)
+{
+  /* Nothing to reset unless objects are being moved. */
+  if ((G.moving & G_TRANSFORM_OBJ) == 0) {
+    return;
+  }
+
+  RigidbodyUpdateSimObData data = {
+      .rbw = rbw,
+      .view_layer = DEG_get_input_view_layer(depsgraph),
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(
+      0, rbw->numbodies, &data, rigidbody_update_simulation_post_step_cb, &settings);
 }
 
 bool BKE_rigidbody_check_sim_running(RigidBodyWorld *rbw, float ctime)
@@ -26,6 +26,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h" /* for FILE_MAX. */
@@ -42,6 +44,7 @@
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_global.h"
@@ -49,6 +52,16 @@
 #include "BKE_scene.h"
 #include "BKE_sequencer.h"
 
+#include "zlib.h"
+
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#endif
+
 /**
  * Sequencer Cache Design Notes
  * ============================
@@ -81,8 +94,13 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * Zlib compression with user definable level can be used to compress image data(per image)
+ * Image data is compressed per image, LZO for low compression and Zlib for high compression.
+ * Data that doesn't get smaller is stored uncompressed.
  * Images are written in order in which they are rendered.
+ * Writing happens in a background thread, so rendering doesn't wait for compression and I/O.
+ * When too many writes are pending, images are written by the rendering thread instead.
+ * Decompression happens outside of the file lock, so the prefetch job can read ahead while
+ * playback reads other frames.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
  * size specified in user preferences.
@@ -94,11 +112,20 @@
 /* <cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 1
+#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_WRITES_PENDING_MAX 8
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in imb intern */
 
+/* DiskCacheHeaderEntry.compression */
+enum {
+  DCACHE_COMPRESSION_NONE = 0,
+  DCACHE_COMPRESSION_LZO = 1,
+  DCACHE_COMPRESSION_ZLIB = 2,
+};
+
 typedef struct DiskCacheHeaderEntry {
   unsigned char encoding;
+  unsigned char compression;
   uint64_t frameno;
   uint64_t size_compressed;
   uint64_t size_raw;
@@ -116,8 +143,17 @@ typedef struct SeqDiskCache {
   ListBase files;
   ThreadMutex read_write_mutex;
   size_t size_total;
+  /* Background thread writing images, and number of images waiting to be written. */
+  TaskPool *write_pool;
+  int writes_pending;
 } SeqDiskCache;
 
+typedef struct DiskCacheWriteTask {
+  char path[FILE_MAX];
+  float nfra;
+  ImBuf *ibuf;
+} DiskCacheWriteTask;
+
 typedef struct DiskCacheFile {
   struct DiskCacheFile *next, *prev;
   char path[FILE_MAX];
@@ -172,18 +208,27 @@ static char *seq_disk_cache_base_dir(void)
   return U.sequencer_disk_cache_dir;
 }
 
-static int seq_disk_cache_compression_level(void)
+static int seq_disk_cache_compression(int *r_level)
 {
   switch (U.sequencer_disk_cache_compression) {
     case USER_SEQ_DISK_CACHE_COMPRESSION_NONE:
-      return 0;
+      *r_level = 0;
+      return DCACHE_COMPRESSION_NONE;
     case USER_SEQ_DISK_CACHE_COMPRESSION_LOW:
-      return 1;
+#ifdef WITH_LZO
+      *r_level = 1;
+      return DCACHE_COMPRESSION_LZO;
+#else
+      *r_level = 1;
+      return DCACHE_COMPRESSION_ZLIB;
+#endif
     case USER_SEQ_DISK_CACHE_COMPRESSION_HIGH:
-      return 9;
+      *r_level = 9;
+      return DCACHE_COMPRESSION_ZLIB;
   }
 
-  return U.sequencer_disk_cache_compression;
+  *r_level = 0;
+  return DCACHE_COMPRESSION_NONE;
 }
 
 static size_t seq_disk_cache_size_limit(void)
@@ -464,6 +509,12 @@ static void seq_disk_cache_invalidate(Scene *scene,
   int end;
   SeqDiskCache *disk_cache = scene->ed->cache->disk_cache;
 
+  /* Pending writes may contain invalid images, drop them. The pool can't be reused after
+   * canceling, its thread doesn't wait for new tasks anymore. */
+  BLI_task_pool_cancel(disk_cache->write_pool);
+  BLI_task_pool_free(disk_cache->write_pool);
+  disk_cache->write_pool = BLI_task_pool_create_background_serial(disk_cache, TASK_PRIORITY_LOW);
+
   BLI_mutex_lock(&disk_cache->read_write_mutex);
 
   start = seq_changed->startdisp - DCACHE_IMAGES_PER_FILE;
@@ -474,31 +525,81 @@ static void seq_disk_cache_invalidate(Scene *scene,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+static void *seq_disk_cache_imbuf_data(ImBuf *ibuf, uint64_t *r_size)
 {
   if (ibuf->rect) {
-    return BLI_gzip_mem_to_file_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset, level);
-  }
-  else {
-    return BLI_gzip_mem_to_file_at_pos(
-        ibuf->rect_float, header_entry->size_raw, file, header_entry->offset, level);
+    *r_size = (uint64_t)ibuf->x * ibuf->y * ibuf->channels;
+    return ibuf->rect;
   }
+  *r_size = (uint64_t)ibuf->x * ibuf->y * ibuf->channels * 4;
+  return ibuf->rect_float;
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+/* Compress image data using method from user preferences. Returns size of compressed data,
+ * r_data is either a new buffer that must be freed by caller, or data itself when it is stored
+ * uncompressed. */
+static size_t seq_disk_cache_compress(void *data,
+                                      size_t size,
+                                      void **r_data,
+                                      unsigned char *r_compression)
 {
-  if (ibuf->rect) {
-    return BLI_ungzip_file_to_mem_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset);
+  int level;
+  int compression = seq_disk_cache_compression(&level);
+  void *out = NULL;
+  size_t out_size = 0;
+
+  if (compression == DCACHE_COMPRESSION_ZLIB) {
+    uLongf zlib_size = compressBound((uLong)size);
+    out = MEM_mallocN(zlib_size, "seq disk cache compressed data");
+    if (compress2(out, &zlib_size, data, (uLong)size, level) == Z_OK) {
+      out_size = zlib_size;
+    }
   }
-  else {
-    return BLI_ungzip_file_to_mem_at_pos(
-        ibuf->rect_float, header_entry->size_raw, file, header_entry->offset);
+#ifdef WITH_LZO
+  else if (compression == DCACHE_COMPRESSION_LZO) {
+    lzo_uint lzo_size = size + size / 16 + 64 + 3;
+    void *wrkmem = MEM_mallocN(LZO1X_1_MEM_COMPRESS, "seq disk cache lzo wrkmem");
+    out = MEM_mallocN(lzo_size, "seq disk cache compressed data");
+    if (lzo1x_1_compress(data, (lzo_uint)size, out, &lzo_size, wrkmem) == LZO_E_OK) {
+      out_size = lzo_size;
+    }
+    MEM_freeN(wrkmem);
+  }
+#endif
+
+  if (out_size == 0 || out_size >= size) {
+    /* Not compressible, or compression failed. */
+    if (out != NULL) {
+      MEM_freeN(out);
+    }
+    *r_data = data;
+    *r_compression = DCACHE_COMPRESSION_NONE;
+    return size;
+  }
+
+  *r_data = out;
+  *r_compression = compression;
+  return out_size;
+}
+
+static bool seq_disk_cache_decompress(
+    void *data, size_t size, unsigned char compression, void *r_out, size_t out_size)
+{
+  switch (compression) {
+    case DCACHE_COMPRESSION_ZLIB: {
+      uLongf zlib_size = (uLongf)out_size;
+      return uncompress(r_out, &zlib_size, data, (uLong)size) == Z_OK && zlib_size == out_size;
+    }
+#ifdef WITH_LZO
+    case DCACHE_COMPRESSION_LZO: {
+      lzo_uint lzo_size = out_size;
+      return lzo1x_decompress_safe(data, (lzo_uint)size, r_out, &lzo_size, NULL) == LZO_E_OK &&
+             lzo_size == out_size;
+    }
+#endif
   }
+
+  return false;
 }
 
 static void seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
@@ -522,7 +623,7 @@ static size_t seq_disk_cache_write_header(FILE *file, DiskCacheHeader *header)
   return fwrite(header, sizeof(*header), 1, file);
 }
 
-static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCacheHeader *header)
+static int seq_disk_cache_add_header_entry(float nfra, ImBuf *ibuf, DiskCacheHeader *header)
 {
   int i;
   uint64_t offset = sizeof(*header);
@@ -555,16 +656,15 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
   }
 
   header->entry[i].offset = offset;
-  header->entry[i].frameno = key->nfra;
+  header->entry[i].frameno = nfra;
+  seq_disk_cache_imbuf_data(ibuf, &header->entry[i].size_raw);
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
   if (ibuf->rect) {
-    header->entry[i].size_raw = ibuf->x * ibuf->y * ibuf->channels;
     colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
   }
   else {
-    header->entry[i].size_raw = ibuf->x * ibuf->y * ibuf->channels * 4;
     colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
   }
   BLI_strncpy(
@@ -584,42 +684,105 @@ static int seq_disk_cache_get_header_entry(SeqCacheKey *key, DiskCacheHeader *he
   return -1;
 }
 
-static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache,
+                                      const char *path,
+                                      float nfra,
+                                      ImBuf *ibuf)
 {
-  char path[FILE_MAX];
+  uint64_t size_raw;
+  void *rect = seq_disk_cache_imbuf_data(ibuf, &size_raw);
+  void *data;
+  unsigned char compression;
+  bool success = false;
 
-  seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
+  /* Compress before locking, so reading is not blocked. */
+  size_t size = seq_disk_cache_compress(rect, size_raw, &data, &compression);
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
   BLI_make_existing_file(path);
 
   FILE *file = BLI_fopen(path, "rb+");
   if (!file) {
     file = BLI_fopen(path, "wb+");
-    if (!file) {
-      return false;
+    if (file) {
+      seq_disk_cache_add_file_to_list(disk_cache, path);
     }
-    seq_disk_cache_add_file_to_list(disk_cache, path);
   }
 
-  DiskCacheHeader header;
-  memset(&header, 0, sizeof(header));
-  seq_disk_cache_read_header(file, &header);
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
-
-  if (bytes_written != 0) {
-    /* Last step is writing header, as image data can be overwritten,
-     * but missing data would cause problems.
-     */
-    header.entry[entry_index].size_compressed = bytes_written;
-    seq_disk_cache_write_header(file, &header);
-    seq_disk_cache_update_file(disk_cache, path);
+  if (file) {
+    DiskCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    seq_disk_cache_read_header(file, &header);
+    int entry_index = seq_disk_cache_add_header_entry(nfra, ibuf, &header);
+    DiskCacheHeaderEntry *entry = &header.entry[entry_index];
+    entry->compression = compression;
+
+    fseek(file, entry->offset, SEEK_SET);
+    if (fwrite(data, 1, size, file) == size) {
+      /* Last step is writing header, as image data can be overwritten,
+       * but missing data would cause problems.
+       */
+      entry->size_compressed = size;
+      seq_disk_cache_write_header(file, &header);
+      success = true;
+    }
     fclose(file);
+    seq_disk_cache_update_file(disk_cache, (char *)path);
+  }
 
-    return true;
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  if (data != rect) {
+    MEM_freeN(data);
   }
 
-  return false;
+  return success;
+}
+
+static void seq_disk_cache_write_task(TaskPool *__restrict pool, void *taskdata)
+{
+  SeqDiskCache *disk_cache = BLI_task_pool_user_data(pool);
+  DiskCacheWriteTask *task = taskdata;
+
+  seq_disk_cache_write_file(disk_cache, task->path, task->nfra, task->ibuf);
+  seq_disk_cache_enforce_limits(disk_cache);
+}
+
+static void seq_disk_cache_write_task_free(TaskPool *__restrict pool, void *taskdata)
+{
+  SeqDiskCache *disk_cache = BLI_task_pool_user_data(pool);
+  DiskCacheWriteTask *task = taskdata;
+
+  IMB_freeImBuf(task->ibuf);
+  MEM_freeN(task);
+  atomic_sub_and_fetch_int32(&disk_cache->writes_pending, 1);
+}
+
+/* Write image in the background. When writing can't keep up with rendering, the image is
+ * written right away instead, so pending images don't use unlimited memory. */
+static void seq_disk_cache_write(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  char path[FILE_MAX];
+  seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
+
+  if (atomic_add_and_fetch_int32(&disk_cache->writes_pending, 1) > DCACHE_WRITES_PENDING_MAX) {
+    atomic_sub_and_fetch_int32(&disk_cache->writes_pending, 1);
+    seq_disk_cache_write_file(disk_cache, path, key->nfra, ibuf);
+    seq_disk_cache_enforce_limits(disk_cache);
+    return;
+  }
+
+  DiskCacheWriteTask *task = MEM_mallocN(sizeof(DiskCacheWriteTask), "DiskCacheWriteTask");
+  BLI_strncpy(task->path, path, sizeof(task->path));
+  task->nfra = key->nfra;
+  IMB_refImBuf(ibuf);
+  task->ibuf = ibuf;
+
+  BLI_task_pool_push(disk_cache->write_pool,
+                     seq_disk_cache_write_task,
+                     task,
+                     true,
+                     seq_disk_cache_write_task_free);
 }
 
 static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
@@ -628,10 +791,13 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
   DiskCacheHeader header;
 
   seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
   BLI_make_existing_file(path);
 
   FILE *file = BLI_fopen(path, "rb");
   if (!file) {
+    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return NULL;
   }
 
@@ -641,40 +807,62 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
   /* Item not found. */
   if (entry_index < 0) {
     fclose(file);
+    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return NULL;
   }
 
   ImBuf *ibuf;
+  DiskCacheHeaderEntry *entry = &header.entry[entry_index];
   uint64_t size_char = (uint64_t)key->context.rectx * key->context.recty * 4;
   uint64_t size_float = (uint64_t)key->context.rectx * key->context.recty * 16;
-  size_t expected_size;
 
-  if (header.entry[entry_index].size_raw == size_char) {
-    expected_size = size_char;
+  if (entry->size_raw == size_char) {
     ibuf = IMB_allocImBuf(key->context.rectx, key->context.recty, 32, IB_rect);
-    IMB_colormanagement_assign_rect_colorspace(ibuf, header.entry[entry_index].colorspace_name);
+    IMB_colormanagement_assign_rect_colorspace(ibuf, entry->colorspace_name);
   }
-  else if (header.entry[entry_index].size_raw == size_float) {
-    expected_size = size_float;
+  else if (entry->size_raw == size_float) {
     ibuf = IMB_allocImBuf(key->context.rectx, key->context.recty, 32, IB_rectfloat);
-    IMB_colormanagement_assign_float_colorspace(ibuf, header.entry[entry_index].colorspace_name);
+    IMB_colormanagement_assign_float_colorspace(ibuf, entry->colorspace_name);
   }
   else {
     fclose(file);
+    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return NULL;
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
+  uint64_t size_raw;
+  void *rect = seq_disk_cache_imbuf_data(ibuf, &size_raw);
+  void *data = NULL;
+  bool success;
+
+  fseek(file, entry->offset, SEEK_SET);
+  if (entry->compression == DCACHE_COMPRESSION_NONE) {
+    success = entry->size_compressed == size_raw && fread(rect, 1, size_raw, file) == size_raw;
+  }
+  else {
+    data = MEM_mallocN(entry->size_compressed, "seq disk cache compressed data");
+    success = fread(data, 1, entry->size_compressed, file) == entry->size_compressed;
+  }
+
+  if (success) {
+    BLI_file_touch(path);
+    seq_disk_cache_update_file(disk_cache, path);
+  }
+  fclose(file);
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  /* Decompress without holding the lock, other frames can be read and written meanwhile. */
+  if (data != NULL) {
+    success = success && seq_disk_cache_decompress(
+                             data, entry->size_compressed, entry->compression, rect, size_raw);
+    MEM_freeN(data);
+  }
 
   /* Sanity check. */
-  if (bytes_read != expected_size) {
-    fclose(file);
+  if (!success) {
     IMB_freeImBuf(ibuf);
     return NULL;
   }
-  BLI_file_touch(path);
-  seq_disk_cache_update_file(disk_cache, path);
-  fclose(file);
 
   return ibuf;
 }
@@ -683,6 +871,7 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
 #undef DCACHE_IMAGES_PER_FILE
 #undef COLORSPACE_NAME_MAX
 #undef DCACHE_CURRENT_VERSION
+#undef DCACHE_WRITES_PENDING_MAX
 
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
 {
@@ -767,7 +956,12 @@ static void seq_cache_unlock(Scene *scene)
 
 static size_t seq_cache_get_mem_total(void)
 {
-  return ((size_t)U.memcachelimit) * 1024 * 1024;
+  const size_t limit = ((size_t)U.memcachelimit) * 1024 * 1024;
+
+  if (U.memcache_sequencer_share) {
+    return limit / 100 * U.memcache_sequencer_share;
+  }
+  return limit;
 }
 
 static void seq_cache_keyfree(void *val)
@@ -1048,6 +1242,8 @@ static void seq_disk_cache_create(Main *bmain, Scene *scene)
   cache->disk_cache = MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache");
   cache->disk_cache->bmain = bmain;
   BLI_mutex_init(&cache->disk_cache->read_write_mutex);
+  cache->disk_cache->write_pool = BLI_task_pool_create_background_serial(cache->disk_cache,
+                                                                         TASK_PRIORITY_LOW);
   seq_disk_cache_handle_versioning(cache->disk_cache);
   seq_disk_cache_get_files(cache->disk_cache, seq_disk_cache_base_dir());
   cache->disk_cache->timestamp = scene->ed->disk_cache_timestamp;
@@ -1112,6 +1308,8 @@ void BKE_sequencer_cache_destruct(Scene *scene)
   BLI_mutex_end(&cache->iterator_mutex);
 
   if (cache->disk_cache != NULL) {
+    /* Finish pending writes. */
+    BLI_task_pool_free(cache->disk_cache->write_pool);
     BLI_freelistN(&cache->disk_cache->files);
     BLI_mutex_end(&cache->disk_cache->read_write_mutex);
     MEM_freeN(cache->disk_cache);
@@ -1264,9 +1462,7 @@ struct ImBuf *BKE_sequencer_cache_get(
       seq_disk_cache_create(context->bmain, context->scene);
     }
 
-    BLI_mutex_lock(&cache->disk_cache->read_write_mutex);
     ibuf = seq_disk_cache_read_file(cache->disk_cache, &key);
-    BLI_mutex_unlock(&cache->disk_cache->read_write_mutex);
     if (ibuf) {
       if (key.type == SEQ_CACHE_STORE_FINAL_OUT) {
         BKE_sequencer_cache_put_if_possible(context, seq, cfra, type, ibuf, 0.0f, true);
@@ -1409,10 +1605,7 @@ void BKE_sequencer_cache_put(const SeqRenderData *context,
         seq_disk_cache_create(context->bmain, context->scene);
       }
 
-      BLI_mutex_lock(&cache->disk_cache->read_write_mutex);
-      seq_disk_cache_write_file(cache->disk_cache, key, i);
-      BLI_mutex_unlock(&cache->disk_cache->read_write_mutex);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
+      seq_disk_cache_write(cache->disk_cache, key, i);
     }
   }
 }
@@ -49,6 +49,7 @@
 #include "BLI_session_uuid.h"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -3963,6 +3964,127 @@ static ImBuf *seq_render_strip_stack_apply_effect(
   return out;
 }
 
+/* Strips that can be rendered in a worker thread, their rendering only uses data of the strip
+ * and its inputs. Strips rendering other parts of the timeline or data that is not thread safe
+ * to access, like scenes, meta strips and text, are rendered in the calling thread. */
+static bool seq_render_strip_is_threadsafe(const Sequence *seq)
+{
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    if (smd->mask_sequence) {
+      return false;
+    }
+  }
+
+  switch (seq->type) {
+    case SEQ_TYPE_IMAGE:
+    case SEQ_TYPE_MOVIE:
+    case SEQ_TYPE_COLOR:
+      return true;
+    case SEQ_TYPE_SPEED:
+    case SEQ_TYPE_MULTICAM:
+    case SEQ_TYPE_ADJUSTMENT:
+    case SEQ_TYPE_TEXT:
+      return false;
+  }
+
+  if (seq->type & SEQ_TYPE_EFFECT) {
+    return (seq->seq1 == NULL || seq_render_strip_is_threadsafe(seq->seq1)) &&
+           (seq->seq2 == NULL || seq_render_strip_is_threadsafe(seq->seq2)) &&
+           (seq->seq3 == NULL || seq_render_strip_is_threadsafe(seq->seq3));
+  }
+
+  return false;
+}
+
+/* Does rendering seq render input, directly or through effect inputs. */
+static bool seq_render_strip_uses(const Sequence *seq, const Sequence *input)
+{
+  if (seq == input) {
+    return true;
+  }
+  return (seq->seq1 && seq_render_strip_uses(seq->seq1, input)) ||
+         (seq->seq2 && seq_render_strip_uses(seq->seq2, input)) ||
+         (seq->seq3 && seq_render_strip_uses(seq->seq3, input));
+}
+
+static bool seq_render_strips_share_input(const Sequence *seq_a, const Sequence *seq_b)
+{
+  if (seq_render_strip_uses(seq_b, seq_a)) {
+    return true;
+  }
+  return (seq_a->seq1 && seq_render_strips_share_input(seq_a->seq1, seq_b)) ||
+         (seq_a->seq2 && seq_render_strips_share_input(seq_a->seq2, seq_b)) ||
+         (seq_a->seq3 && seq_render_strips_share_input(seq_a->seq3, seq_b));
+}
+
+typedef struct SeqRenderStripTask {
+  const SeqRenderData *context;
+  SeqRenderState *state;
+  Sequence *seq;
+  float cfra;
+  ImBuf *ibuf;
+} SeqRenderStripTask;
+
+static void seq_render_strip_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  SeqRenderStripTask *task = taskdata;
+  task->ibuf = seq_render_strip(task->context, task->state, task->seq, task->cfra);
+}
+
+/* Render the strips of seq_arr that are not NULL into r_ibuf_arr. Strips that are thread safe
+ * and don't share inputs are rendered in parallel, the others one after another afterwards. */
+static void seq_render_strips(const SeqRenderData *context,
+                              SeqRenderState *state,
+                              Sequence **seq_arr,
+                              int count,
+                              float cfra,
+                              ImBuf **r_ibuf_arr)
+{
+  SeqRenderStripTask tasks[MAXSEQ + 1];
+  bool threaded[MAXSEQ + 1];
+  int num_threaded = 0;
+
+  for (int i = 0; i < count; i++) {
+    threaded[i] = seq_arr[i] && seq_render_strip_is_threadsafe(seq_arr[i]);
+    for (int j = 0; j < i && threaded[i]; j++) {
+      if (threaded[j] && seq_render_strips_share_input(seq_arr[i], seq_arr[j])) {
+        threaded[i] = false;
+      }
+    }
+    if (threaded[i]) {
+      num_threaded++;
+    }
+  }
+
+  if (num_threaded > 1) {
+    TaskPool *task_pool = BLI_task_pool_create(NULL, TASK_PRIORITY_HIGH);
+    for (int i = 0; i < count; i++) {
+      if (threaded[i]) {
+        tasks[i].context = context;
+        tasks[i].state = state;
+        tasks[i].seq = seq_arr[i];
+        tasks[i].cfra = cfra;
+        tasks[i].ibuf = NULL;
+        BLI_task_pool_push(task_pool, seq_render_strip_task, &tasks[i], false, NULL);
+      }
+    }
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (seq_arr[i] == NULL) {
+      r_ibuf_arr[i] = NULL;
+    }
+    else if (num_threaded > 1 && threaded[i]) {
+      r_ibuf_arr[i] = tasks[i].ibuf;
+    }
+    else {
+      r_ibuf_arr[i] = seq_render_strip(context, state, seq_arr[i], cfra);
+    }
+  }
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *seqbasep,
@@ -3970,8 +4092,11 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      int chanshown)
 {
   Sequence *seq_arr[MAXSEQ + 1];
+  Sequence *render_arr[MAXSEQ + 1];
+  ImBuf *ibuf_arr[MAXSEQ + 1];
   int count;
-  int i;
+  int i, j;
+  int num_rendered = 0;
   ImBuf *out = NULL;
   clock_t begin;
 
@@ -3981,52 +4106,77 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     return NULL;
   }
 
+  /* Find the lowest strip that contributes to the result, from the top down. */
   for (i = count - 1; i >= 0; i--) {
-    int early_out;
     Sequence *seq = seq_arr[i];
 
     out = BKE_sequencer_cache_get(context, seq, cfra, SEQ_CACHE_STORE_COMPOSITE, false);
 
-    if (out) {
+    if (out || i == 0 || seq->blend_mode == SEQ_BLEND_REPLACE ||
+        ELEM(seq_get_early_out_for_blend_mode(seq), EARLY_NO_INPUT, EARLY_USE_INPUT_2)) {
       break;
     }
-    if (seq->blend_mode == SEQ_BLEND_REPLACE) {
-      out = seq_render_strip(context, state, seq, cfra);
-      break;
+  }
+
+  /* Render all strips used from there up at once, so independent strips are rendered in
+   * parallel. Blending them stays in order. */
+  for (j = 0; j < count; j++) {
+    render_arr[j] = NULL;
+    if (j < i || (j == i && out)) {
+      continue;
     }
+    if (j == i && (seq_arr[j]->blend_mode == SEQ_BLEND_REPLACE ||
+                   seq_get_early_out_for_blend_mode(seq_arr[j]) != EARLY_USE_INPUT_1)) {
+      render_arr[j] = seq_arr[j];
+    }
+    else if (j > i && seq_get_early_out_for_blend_mode(seq_arr[j]) == EARLY_DO_EFFECT) {
+      render_arr[j] = seq_arr[j];
+    }
+    if (render_arr[j]) {
+      num_rendered++;
+    }
+  }
 
-    early_out = seq_get_early_out_for_blend_mode(seq);
+  begin = seq_estimate_render_cost_begin();
+  seq_render_strips(context, state, render_arr, count, cfra, ibuf_arr);
+  /* Strips rendered in parallel can't be told apart, they share the cost evenly. */
+  const float render_cost = (num_rendered) ?
+                                seq_estimate_render_cost_end(context->scene, begin) /
+                                    num_rendered :
+                                0.0f;
 
-    switch (early_out) {
-      case EARLY_NO_INPUT:
-      case EARLY_USE_INPUT_2:
-        out = seq_render_strip(context, state, seq, cfra);
-        break;
-      case EARLY_USE_INPUT_1:
-        if (i == 0) {
+  if (out == NULL) {
+    Sequence *seq = seq_arr[i];
+
+    if (seq->blend_mode == SEQ_BLEND_REPLACE) {
+      out = ibuf_arr[i];
+    }
+    else {
+      switch (seq_get_early_out_for_blend_mode(seq)) {
+        case EARLY_NO_INPUT:
+        case EARLY_USE_INPUT_2:
+          out = ibuf_arr[i];
+          break;
+        case EARLY_USE_INPUT_1:
           out = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-        }
-        break;
-      case EARLY_DO_EFFECT:
-        if (i == 0) {
+          break;
+        case EARLY_DO_EFFECT: {
           begin = seq_estimate_render_cost_begin();
 
           ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-          ImBuf *ibuf2 = seq_render_strip(context, state, seq, cfra);
+          ImBuf *ibuf2 = ibuf_arr[i];
 
           out = seq_render_strip_stack_apply_effect(context, seq, cfra, ibuf1, ibuf2);
 
-          float cost = seq_estimate_render_cost_end(context->scene, begin);
+          float cost = seq_estimate_render_cost_end(context->scene, begin) + render_cost;
           BKE_sequencer_cache_put(
               context, seq_arr[i], cfra, SEQ_CACHE_STORE_COMPOSITE, out, cost, false);
 
           IMB_freeImBuf(ibuf1);
           IMB_freeImBuf(ibuf2);
+          break;
         }
-        break;
-    }
-    if (out) {
-      break;
+      }
     }
   }
 
@@ -4035,9 +4185,9 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     begin = seq_estimate_render_cost_begin();
     Sequence *seq = seq_arr[i];
 
-    if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
+    if (ibuf_arr[i]) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, cfra);
+      ImBuf *ibuf2 = ibuf_arr[i];
 
       out = seq_render_strip_stack_apply_effect(context, seq, cfra, ibuf1, ibuf2);
 
@@ -4046,6 +4196,9 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     }
 
     float cost = seq_estimate_render_cost_end(context->scene, begin);
+    if (ibuf_arr[i]) {
+      cost += render_cost;
+    }
     BKE_sequencer_cache_put(
         context, seq_arr[i], cfra, SEQ_CACHE_STORE_COMPOSITE, out, cost, false);
   }
@@ -122,6 +122,10 @@ static void simulation_free_data(ID *id)
 
   BKE_animdata_free(&simulation->id, false);
 
+  if ((simulation->id.tag & LIB_TAG_COPIED_ON_WRITE) == 0) {
+    blender::sim::free_cached_simulation_influences(simulation);
+  }
+
   if (simulation->nodetree) {
     ntreeFreeEmbeddedTree(simulation->nodetree);
     MEM_freeN(simulation->nodetree);
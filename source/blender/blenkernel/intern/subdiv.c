@@ -27,8 +27,11 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_modifier_types.h"
 
+#include "BLI_hash_mm2a.h"
 #include "BLI_utildefines.h"
 
+#include "BKE_customdata.h"
+
 #include "MEM_guardedalloc.h"
 
 #include "subdiv_converter.h"
@@ -181,14 +184,60 @@ Subdiv *BKE_subdiv_update_from_converter(Subdiv *subdiv,
   return BKE_subdiv_new_from_converter(settings, converter);
 }
 
+/* Hash everything the mesh converter passes to OpenSubdiv, except for vertex coordinates.
+ * UV coordinates are hashed since the face-varying topology is built from them. */
+static uint subdiv_mesh_topology_hash(const SubdivSettings *settings, const Mesh *mesh)
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  BLI_hash_mm2a_add_int(&mm2, mesh->totvert);
+  BLI_hash_mm2a_add_int(&mm2, mesh->totedge);
+  BLI_hash_mm2a_add_int(&mm2, mesh->totloop);
+  BLI_hash_mm2a_add_int(&mm2, mesh->totpoly);
+  BLI_hash_mm2a_add_int(&mm2, settings->use_creases);
+  for (int i = 0; i < mesh->totpoly; i++) {
+    BLI_hash_mm2a_add_int(&mm2, mesh->mpoly[i].loopstart);
+    BLI_hash_mm2a_add_int(&mm2, mesh->mpoly[i].totloop);
+  }
+  for (int i = 0; i < mesh->totloop; i++) {
+    BLI_hash_mm2a_add_int(&mm2, mesh->mloop[i].v);
+    BLI_hash_mm2a_add_int(&mm2, mesh->mloop[i].e);
+  }
+  for (int i = 0; i < mesh->totedge; i++) {
+    const MEdge *edge = &mesh->medge[i];
+    BLI_hash_mm2a_add_int(&mm2, edge->v1);
+    BLI_hash_mm2a_add_int(&mm2, edge->v2);
+    if (settings->use_creases) {
+      BLI_hash_mm2a_add_int(&mm2, edge->crease);
+    }
+  }
+  const int num_uv_layers = CustomData_number_of_layers(&mesh->ldata, CD_MLOOPUV);
+  BLI_hash_mm2a_add_int(&mm2, num_uv_layers);
+  for (int layer_index = 0; layer_index < num_uv_layers; layer_index++) {
+    const MLoopUV *mloopuv = CustomData_get_layer_n(&mesh->ldata, CD_MLOOPUV, layer_index);
+    for (int i = 0; i < mesh->totloop; i++) {
+      BLI_hash_mm2a_add(&mm2, (const uchar *)mloopuv[i].uv, sizeof(mloopuv[i].uv));
+    }
+  }
+  return BLI_hash_mm2a_end(&mm2);
+}
+
 Subdiv *BKE_subdiv_update_from_mesh(Subdiv *subdiv,
                                     const SubdivSettings *settings,
                                     const Mesh *mesh)
 {
+  const uint topology_hash = subdiv_mesh_topology_hash(settings, mesh);
+  if (subdiv != NULL && subdiv->topology_refiner != NULL && subdiv->has_topology_hash &&
+      subdiv->topology_hash == topology_hash &&
+      BKE_subdiv_settings_equal(&subdiv->settings, settings)) {
+    return subdiv;
+  }
   OpenSubdiv_Converter converter;
   BKE_subdiv_converter_init_for_mesh(&converter, settings, mesh);
   subdiv = BKE_subdiv_update_from_converter(subdiv, settings, &converter);
   BKE_subdiv_converter_free(&converter);
+  subdiv->topology_hash = topology_hash;
+  subdiv->has_topology_hash = true;
   return subdiv;
 }
 
@@ -146,12 +146,10 @@ static void subdiv_ccg_alloc_elements(SubdivCCG *subdiv_ccg, Subdiv *subdiv)
   /* Grid material flags. */
   subdiv_ccg->grid_flag_mats = MEM_calloc_arrayN(
       num_grids, sizeof(DMFlagMat), "ccg grid material flags");
-  /* Grid hidden flags. */
+  /* Grid hidden flags. The bitmap of a grid is only allocated once some of its elements get
+   * hidden, grids without one are fully visible. */
   subdiv_ccg->grid_hidden = MEM_calloc_arrayN(
       num_grids, sizeof(BLI_bitmap *), "ccg grid material flags");
-  for (int grid_index = 0; grid_index < num_grids; grid_index++) {
-    subdiv_ccg->grid_hidden[grid_index] = BLI_BITMAP_NEW(grid_area, "ccg grid hidden");
-  }
   /* TODO(sergey): Allocate memory for loose elements. */
   /* Allocate memory for faces. */
   subdiv_ccg->num_faces = num_faces;
@@ -703,12 +703,18 @@ static void subdiv_foreach_inner_vertices(SubdivForeachTaskContext *ctx,
   }
 }
 
-/* Traverse all vertices which are emitted from given coarse polygon. */
+/* Traverse all vertices which are emitted from given coarse polygon. Vertices of the corners and
+ * edges shared with other polygons are emitted by the first polygon claiming them, so all
+ * vertices of a ptex face are mostly evaluated together, by the same thread. */
 static void subdiv_foreach_vertices(SubdivForeachTaskContext *ctx, void *tls, const int poly_index)
 {
   const Mesh *coarse_mesh = ctx->coarse_mesh;
   const MPoly *coarse_mpoly = coarse_mesh->mpoly;
   const MPoly *coarse_poly = &coarse_mpoly[poly_index];
+  if (ctx->foreach_context->vertex_corner != NULL) {
+    subdiv_foreach_corner_vertices(ctx, tls, coarse_poly);
+    subdiv_foreach_edge_vertices(ctx, tls, coarse_poly);
+  }
   if (ctx->foreach_context->vertex_inner != NULL) {
     subdiv_foreach_inner_vertices(ctx, tls, coarse_poly);
   }
@@ -1776,20 +1782,6 @@ static void subdiv_foreach_vertices_of_loose_edges_task(void *__restrict userdat
 /** \name Subdivision process entry points
  * \{ */
 
-static void subdiv_foreach_single_geometry_vertices(SubdivForeachTaskContext *ctx, void *tls)
-{
-  if (ctx->foreach_context->vertex_corner == NULL) {
-    return;
-  }
-  const Mesh *coarse_mesh = ctx->coarse_mesh;
-  const MPoly *coarse_mpoly = coarse_mesh->mpoly;
-  for (int poly_index = 0; poly_index < coarse_mesh->totpoly; poly_index++) {
-    const MPoly *coarse_poly = &coarse_mpoly[poly_index];
-    subdiv_foreach_corner_vertices(ctx, tls, coarse_poly);
-    subdiv_foreach_edge_vertices(ctx, tls, coarse_poly);
-  }
-}
-
 static void subdiv_foreach_mark_non_loose_geometry(SubdivForeachTaskContext *ctx)
 {
   const Mesh *coarse_mesh = ctx->coarse_mesh;
@@ -1815,10 +1807,13 @@ static void subdiv_foreach_single_thread_tasks(SubdivForeachTaskContext *ctx)
    * and boundary edges. */
   subdiv_foreach_every_corner_vertices(ctx, tls);
   subdiv_foreach_every_edge_vertices(ctx, tls);
-  /* Run callbacks which are supposed to be run once per shared geometry. */
-  subdiv_foreach_single_geometry_vertices(ctx, tls);
+  /* Callbacks which are supposed to be run once per shared geometry are run from the threaded
+   * traversal of polygons, see subdiv_foreach_vertices(). */
   subdiv_foreach_tls_free(ctx, tls);
+}
 
+static void subdiv_foreach_loose_geometry_tag(SubdivForeachTaskContext *ctx)
+{
   const SubdivForeachContext *foreach_context = ctx->foreach_context;
   const bool is_loose_geometry_tagged = (foreach_context->vertex_every_edge != NULL &&
                                          foreach_context->vertex_every_corner != NULL);
@@ -1902,6 +1897,8 @@ bool BKE_subdiv_foreach_subdiv_geometry(Subdiv *subdiv,
 
   BLI_task_parallel_range(
       0, coarse_mesh->totpoly, &ctx, subdiv_foreach_task, &parallel_range_settings);
+  /* Vertices and edges used by polygons are only all tagged after the traversal above. */
+  subdiv_foreach_loose_geometry_tag(&ctx);
   if (context->vertex_loose != NULL) {
     BLI_task_parallel_range(0,
                             coarse_mesh->totvert,
@@ -34,6 +34,7 @@
 
 #include "BKE_customdata.h"
 #include "BKE_key.h"
+#include "BKE_lib_id.h"
 #include "BKE_mesh.h"
 #include "BKE_subdiv.h"
 #include "BKE_subdiv_eval.h"
@@ -41,6 +42,10 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
+#include "opensubdiv_evaluator_capi.h"
+#include "opensubdiv_topology_refiner_capi.h"
+
 /* -------------------------------------------------------------------- */
 /** \name Subdivision Context
  * \{ */
@@ -483,8 +488,8 @@ static void subdiv_accumulate_vertex_normal_and_displacement(SubdivMeshContext *
 {
   Subdiv *subdiv = ctx->subdiv;
   const int subdiv_vertex_index = subdiv_vert - ctx->subdiv_mesh->mvert;
-  float dummy_P[3], dPdu[3], dPdv[3], D[3];
-  BKE_subdiv_eval_limit_point_and_derivatives(subdiv, ptex_face_index, u, v, dummy_P, dPdu, dPdv);
+  float P[3], dPdu[3], dPdv[3], D[3];
+  BKE_subdiv_eval_limit_point_and_derivatives(subdiv, ptex_face_index, u, v, P, dPdu, dPdv);
   /* Accumulate normal. */
   if (ctx->can_evaluate_normals) {
     float N[3];
@@ -499,6 +504,11 @@ static void subdiv_accumulate_vertex_normal_and_displacement(SubdivMeshContext *
     BKE_subdiv_eval_displacement(subdiv, ptex_face_index, u, v, dPdu, dPdv, D);
     add_v3_v3(subdiv_vert->co, D);
   }
+  else {
+    /* The limit point is the same from all ptex faces, store it so the vertex doesn't have to be
+     * evaluated again, see subdiv_mesh_limit_point_get(). */
+    copy_v3_v3(subdiv_vert->co, P);
+  }
   ++ctx->accumulated_counters[subdiv_vertex_index];
 }
 
@@ -565,6 +575,23 @@ static void subdiv_vertex_data_interpolate(const SubdivMeshContext *ctx,
   }
 }
 
+/* Limit point of a vertex emitted from a coarse corner or edge, read before the vertex is
+ * overwritten by its custom data. */
+static void subdiv_mesh_limit_point_get(const SubdivMeshContext *ctx,
+                                        const int ptex_face_index,
+                                        const float u,
+                                        const float v,
+                                        const MVert *subdiv_vert,
+                                        float r_P[3])
+{
+  if (ctx->have_displacement) {
+    BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, r_P);
+  }
+  else {
+    copy_v3_v3(r_P, subdiv_vert->co);
+  }
+}
+
 static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext *ctx,
                                                         const int ptex_face_index,
                                                         const float u,
@@ -581,11 +608,11 @@ static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext
     copy_v3_v3(D, subdiv_vert->co);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Copy custom data and evaluate position. */
+  float P[3];
+  subdiv_mesh_limit_point_get(ctx, ptex_face_index, u, v, subdiv_vert, P);
+  /* Copy custom data and apply position. */
   subdiv_vertex_data_copy(ctx, coarse_vert, subdiv_vert);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
-  /* Apply displacement. */
-  add_v3_v3(subdiv_vert->co, D);
+  add_v3_v3v3(subdiv_vert->co, P, D);
   /* Copy normal from accumulated storage. */
   if (ctx->can_evaluate_normals) {
     float N[3];
@@ -614,11 +641,11 @@ static void evaluate_vertex_and_apply_displacement_interpolate(
     copy_v3_v3(D, subdiv_vert->co);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Interpolate custom data and evaluate position. */
+  float P[3];
+  subdiv_mesh_limit_point_get(ctx, ptex_face_index, u, v, subdiv_vert, P);
+  /* Interpolate custom data and apply position. */
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, vertex_interpolation, u, v);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
-  /* Apply displacement. */
-  add_v3_v3(subdiv_vert->co, D);
+  add_v3_v3v3(subdiv_vert->co, P, D);
   /* Copy normal from accumulated storage. */
   if (ctx->can_evaluate_normals) {
     float N[3];
@@ -1236,3 +1263,181 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
 }
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Evaluation when drawing
+ * \{ */
+
+typedef struct SubdivPatchCoordsContext {
+  OpenSubdiv_PatchCoord *patch_coords;
+  int num_vertices;
+} SubdivPatchCoordsContext;
+
+static bool subdiv_patch_coords_topology_info(const SubdivForeachContext *foreach_context,
+                                              const int num_vertices,
+                                              const int UNUSED(num_edges),
+                                              const int UNUSED(num_loops),
+                                              const int UNUSED(num_polygons))
+{
+  SubdivPatchCoordsContext *ctx = foreach_context->user_data;
+  ctx->patch_coords = MEM_malloc_arrayN(num_vertices, sizeof(*ctx->patch_coords), __func__);
+  ctx->num_vertices = num_vertices;
+  /* Vertices of loose geometry are not on a ptex face. */
+  for (int i = 0; i < num_vertices; i++) {
+    ctx->patch_coords[i].ptex_face = -1;
+  }
+  return true;
+}
+
+static void subdiv_patch_coords_set(const SubdivForeachContext *foreach_context,
+                                    const int ptex_face_index,
+                                    const float u,
+                                    const float v,
+                                    const int subdiv_vertex_index)
+{
+  SubdivPatchCoordsContext *ctx = foreach_context->user_data;
+  OpenSubdiv_PatchCoord *patch_coord = &ctx->patch_coords[subdiv_vertex_index];
+  patch_coord->ptex_face = ptex_face_index;
+  patch_coord->u = u;
+  patch_coord->v = v;
+}
+
+static void subdiv_patch_coords_vertex_corner(const SubdivForeachContext *foreach_context,
+                                              void *UNUSED(tls),
+                                              const int ptex_face_index,
+                                              const float u,
+                                              const float v,
+                                              const int UNUSED(coarse_vertex_index),
+                                              const int UNUSED(coarse_poly_index),
+                                              const int UNUSED(coarse_corner),
+                                              const int subdiv_vertex_index)
+{
+  subdiv_patch_coords_set(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void subdiv_patch_coords_vertex_edge(const SubdivForeachContext *foreach_context,
+                                            void *UNUSED(tls),
+                                            const int ptex_face_index,
+                                            const float u,
+                                            const float v,
+                                            const int UNUSED(coarse_edge_index),
+                                            const int UNUSED(coarse_poly_index),
+                                            const int UNUSED(coarse_corner),
+                                            const int subdiv_vertex_index)
+{
+  subdiv_patch_coords_set(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+static void subdiv_patch_coords_vertex_inner(const SubdivForeachContext *foreach_context,
+                                             void *UNUSED(tls),
+                                             const int ptex_face_index,
+                                             const float u,
+                                             const float v,
+                                             const int UNUSED(coarse_poly_index),
+                                             const int UNUSED(coarse_corner),
+                                             const int subdiv_vertex_index)
+{
+  subdiv_patch_coords_set(foreach_context, ptex_face_index, u, v, subdiv_vertex_index);
+}
+
+SubdivMeshStencils *BKE_subdiv_mesh_stencils_create(Subdiv *subdiv,
+                                                    const SubdivToMeshSettings *settings,
+                                                    const Mesh *coarse_mesh,
+                                                    Mesh *subdiv_mesh)
+{
+  static uint session_uuid_last = 0;
+
+  /* Stencils are indexed by the vertices of the refiner, which only match the coarse vertices
+   * without loose ones. */
+  if (subdiv->evaluator == NULL || subdiv->displacement_evaluator != NULL ||
+      subdiv->topology_refiner->getNumVertices(subdiv->topology_refiner) != coarse_mesh->totvert) {
+    return NULL;
+  }
+
+  /* Patch coordinate of every subdivided vertex, in the order of #BKE_subdiv_to_mesh. */
+  SubdivPatchCoordsContext ctx = {NULL};
+  SubdivForeachContext foreach_context = {NULL};
+  foreach_context.topology_info = subdiv_patch_coords_topology_info;
+  foreach_context.vertex_corner = subdiv_patch_coords_vertex_corner;
+  foreach_context.vertex_edge = subdiv_patch_coords_vertex_edge;
+  foreach_context.vertex_inner = subdiv_patch_coords_vertex_inner;
+  foreach_context.user_data = &ctx;
+  BKE_subdiv_foreach_subdiv_geometry(subdiv, &foreach_context, settings, coarse_mesh);
+
+  OpenSubdiv_LimitStencils *limit_stencils = NULL;
+  if (ctx.patch_coords != NULL && ctx.num_vertices == subdiv_mesh->totvert) {
+    bool is_valid = true;
+    for (int i = 0; i < ctx.num_vertices; i++) {
+      if (ctx.patch_coords[i].ptex_face == -1) {
+        is_valid = false;
+        break;
+      }
+    }
+    if (is_valid) {
+      limit_stencils = subdiv->evaluator->createLimitStencils(
+          subdiv->evaluator, ctx.patch_coords, ctx.num_vertices);
+    }
+  }
+  MEM_SAFE_FREE(ctx.patch_coords);
+  if (limit_stencils == NULL) {
+    return NULL;
+  }
+
+  SubdivMeshStencils *stencils = MEM_callocN(sizeof(*stencils), __func__);
+  stencils->mesh = BKE_mesh_copy_for_eval_shared(subdiv_mesh);
+  stencils->num_coarse_vertices = coarse_mesh->totvert;
+  stencils->num_elements = limit_stencils->num_elements;
+  stencils->offsets = limit_stencils->offsets;
+  stencils->sizes = limit_stencils->sizes;
+  stencils->indices = limit_stencils->indices;
+  stencils->weights = limit_stencils->weights;
+  stencils->du_weights = limit_stencils->du_weights;
+  stencils->dv_weights = limit_stencils->dv_weights;
+  stencils->session_uuid = atomic_add_and_fetch_uint32(&session_uuid_last, 1);
+  stencils->users = 1;
+  stencils->limit_stencils = limit_stencils;
+  return stencils;
+}
+
+void BKE_subdiv_mesh_stencils_free(SubdivMeshStencils *stencils)
+{
+  if (atomic_sub_and_fetch_int32(&stencils->users, 1) != 0) {
+    return;
+  }
+  BKE_id_free(NULL, stencils->mesh);
+  openSubdiv_deleteLimitStencils(stencils->limit_stencils);
+  MEM_freeN(stencils);
+}
+
+Mesh *BKE_subdiv_mesh_gpu_create(SubdivMeshStencils *stencils, const Mesh *coarse_mesh)
+{
+  BLI_assert(coarse_mesh->totvert == stencils->num_coarse_vertices);
+  Mesh *result = BKE_mesh_copy_for_eval_shared(stencils->mesh);
+  SubdivMeshGPU *subdiv_gpu = MEM_mallocN(sizeof(*subdiv_gpu), __func__);
+  subdiv_gpu->stencils = stencils;
+  subdiv_gpu->coarse_coords = BKE_mesh_vert_coords_alloc(coarse_mesh, NULL);
+  atomic_add_and_fetch_int32(&stencils->users, 1);
+  result->runtime.subdiv_gpu = subdiv_gpu;
+  return result;
+}
+
+void BKE_subdiv_mesh_gpu_minmax(const SubdivMeshGPU *subdiv_gpu, float r_min[3], float r_max[3])
+{
+  const int num_coarse_vertices = subdiv_gpu->stencils->num_coarse_vertices;
+  for (int i = 0; i < num_coarse_vertices; i++) {
+    minmax_v3v3_v3(r_min, r_max, subdiv_gpu->coarse_coords[i]);
+  }
+}
+
+void BKE_subdiv_mesh_gpu_free(Mesh *mesh)
+{
+  SubdivMeshGPU *subdiv_gpu = mesh->runtime.subdiv_gpu;
+  if (subdiv_gpu) {
+    BKE_subdiv_mesh_stencils_free(subdiv_gpu->stencils);
+    MEM_freeN(subdiv_gpu->coarse_coords);
+    MEM_freeN(subdiv_gpu);
+    mesh->runtime.subdiv_gpu = NULL;
+  }
+}
+
+/** \} */
@@ -679,23 +679,70 @@ static ImBuf *accesscache_get(TrackingImageAccessor *accessor,
   return IMB_moviecache_get(accessor->cache, &key);
 }
 
+/* Get referenced original frame from the shared frames, NULL if it is not there.
+ * Must be called with cache_lock held. */
+static ImBuf *accessor_frames_get(TrackingImageAccessor *accessor, int clip_index, int frame)
+{
+  for (int i = 0; i < MAX_ACCESSOR_FRAMES; i++) {
+    TrackingAccessorFrame *accessor_frame = &accessor->frames[i];
+    if (accessor_frame->ibuf != NULL && accessor_frame->clip_index == clip_index &&
+        accessor_frame->frame == frame) {
+      IMB_refImBuf(accessor_frame->ibuf);
+      return accessor_frame->ibuf;
+    }
+  }
+  return NULL;
+}
+
 static ImBuf *accessor_get_preprocessed_ibuf(TrackingImageAccessor *accessor,
                                              int clip_index,
                                              int frame)
 {
   MovieClip *clip;
   MovieClipUser user;
-  ImBuf *ibuf;
+  ImBuf *ibuf, *shared_ibuf, *evicted_ibuf = NULL;
   int scene_frame;
 
   BLI_assert(clip_index < accessor->num_clips);
 
+  BLI_spin_lock(&accessor->cache_lock);
+  ibuf = accessor_frames_get(accessor, clip_index, frame);
+  BLI_spin_unlock(&accessor->cache_lock);
+  if (ibuf != NULL) {
+    return ibuf;
+  }
+
   clip = accessor->clips[clip_index];
   scene_frame = BKE_movieclip_remap_clip_to_scene_frame(clip, frame);
   BKE_movieclip_user_set_frame(&user, scene_frame);
   user.render_size = MCLIP_PROXY_RENDER_SIZE_FULL;
   user.render_flag = 0;
   ibuf = BKE_movieclip_get_ibuf(clip, &user);
+  if (ibuf == NULL) {
+    return NULL;
+  }
+
+  /* Share the frame with other tracks, unless another thread did it meanwhile. */
+  BLI_spin_lock(&accessor->cache_lock);
+  shared_ibuf = accessor_frames_get(accessor, clip_index, frame);
+  if (shared_ibuf == NULL) {
+    TrackingAccessorFrame *accessor_frame = &accessor->frames[accessor->next_frame_slot];
+    evicted_ibuf = accessor_frame->ibuf;
+    accessor_frame->clip_index = clip_index;
+    accessor_frame->frame = frame;
+    accessor_frame->ibuf = ibuf;
+    IMB_refImBuf(ibuf);
+    accessor->next_frame_slot = (accessor->next_frame_slot + 1) % MAX_ACCESSOR_FRAMES;
+  }
+  BLI_spin_unlock(&accessor->cache_lock);
+
+  if (evicted_ibuf != NULL) {
+    IMB_freeImBuf(evicted_ibuf);
+  }
+  if (shared_ibuf != NULL) {
+    IMB_freeImBuf(ibuf);
+    ibuf = shared_ibuf;
+  }
 
   return ibuf;
 }
@@ -1021,8 +1068,29 @@ TrackingImageAccessor *tracking_image_accessor_new(MovieClip *clips[MAX_ACCESSOR
 
 void tracking_image_accessor_destroy(TrackingImageAccessor *accessor)
 {
+  for (int i = 0; i < MAX_ACCESSOR_FRAMES; i++) {
+    if (accessor->frames[i].ibuf != NULL) {
+      IMB_freeImBuf(accessor->frames[i].ibuf);
+    }
+  }
   IMB_moviecache_free(accessor->cache);
   libmv_FrameAccessorDestroy(accessor->libmv_accessor);
   BLI_spin_end(&accessor->cache_lock);
   MEM_freeN(accessor);
 }
+
+/* Load original frame ahead of time, so it is ready by the time tracks are tracked on it.
+ * Frames outside of the clip are ignored. */
+void tracking_image_accessor_prefetch_frame(TrackingImageAccessor *accessor,
+                                            int clip_index,
+                                            int frame)
+{
+  MovieClip *clip = accessor->clips[clip_index];
+  if (frame < 1 || frame > BKE_movieclip_get_duration(clip)) {
+    return;
+  }
+  ImBuf *ibuf = accessor_get_preprocessed_ibuf(accessor, clip_index, frame);
+  if (ibuf != NULL) {
+    IMB_freeImBuf(ibuf);
+  }
+}
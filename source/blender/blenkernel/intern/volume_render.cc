@@ -163,6 +163,56 @@ void BKE_volume_grid_dense_voxels(const Volume *volume,
 #endif
 }
 
+/* Average blocks of factor^3 voxels, the size of the bounds must be a multiple of the factor.
+ * Only a slab of factor voxels thick is converted to dense at a time, so grids which are too big
+ * to convert at full resolution can still be displayed. */
+void BKE_volume_grid_dense_voxels_downsampled(const Volume *volume,
+                                              VolumeGrid *volume_grid,
+                                              const int64_t min[3],
+                                              const int64_t max[3],
+                                              const int factor,
+                                              float *voxels)
+{
+  if (factor <= 1) {
+    BKE_volume_grid_dense_voxels(volume, volume_grid, min, max, voxels);
+    return;
+  }
+
+  const int64_t channels = BKE_volume_grid_channels(volume_grid);
+  const int64_t resolution[3] = {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
+  const int64_t out_resolution[3] = {
+      resolution[0] / factor, resolution[1] / factor, resolution[2] / factor};
+  const int64_t slab_size = resolution[0] * resolution[1] * factor * channels;
+  const int64_t out_slice_size = out_resolution[0] * out_resolution[1] * channels;
+  const float weight = 1.0f / (float)(factor * factor * factor);
+
+  float *slab = (float *)MEM_malloc_arrayN(slab_size, sizeof(float), __func__);
+
+  for (int64_t out_z = 0; out_z < out_resolution[2]; out_z++) {
+    const int64_t slab_min[3] = {min[0], min[1], min[2] + out_z * factor};
+    const int64_t slab_max[3] = {max[0], max[1], slab_min[2] + factor};
+    BKE_volume_grid_dense_voxels(volume, volume_grid, slab_min, slab_max, slab);
+
+    float *out_slice = voxels + out_z * out_slice_size;
+    memset(out_slice, 0, sizeof(float) * out_slice_size);
+
+    /* X varies fastest in both the slab and the output. */
+    for (int64_t z = 0; z < factor; z++) {
+      for (int64_t y = 0; y < resolution[1]; y++) {
+        const float *in = slab + (z * resolution[1] + y) * resolution[0] * channels;
+        float *out = out_slice + (y / factor) * out_resolution[0] * channels;
+        for (int64_t x = 0; x < resolution[0]; x++) {
+          for (int64_t c = 0; c < channels; c++) {
+            out[(x / factor) * channels + c] += in[x * channels + c] * weight;
+          }
+        }
+      }
+    }
+  }
+
+  MEM_freeN(slab);
+}
+
 /* Wireframe */
 
 #ifdef WITH_OPENVDB
@@ -134,6 +134,9 @@ typedef struct NlaEvalSnapshot {
 typedef struct NlaEvalData {
   ListBase channels;
 
+  /* Storage of the channels and all their value snapshots, freed together with the data. */
+  struct MemArena *arena;
+
   /* Mapping of paths and NlaEvalChannelKeys to channels. */
   GHash *path_hash;
   GHash *key_hash;
@@ -131,6 +131,15 @@ float *tracking_track_get_mask_for_region(int frame_width,
 struct libmv_FrameAccessor;
 
 #define MAX_ACCESSOR_CLIP 64
+#define MAX_ACCESSOR_FRAMES 4
+
+/* Original frame shared by all tracks which are accessing it. */
+typedef struct TrackingAccessorFrame {
+  int clip_index;
+  int frame;
+  struct ImBuf *ibuf;
+} TrackingAccessorFrame;
+
 typedef struct TrackingImageAccessor {
   struct MovieCache *cache;
   struct MovieClip *clips[MAX_ACCESSOR_CLIP];
@@ -140,6 +149,11 @@ typedef struct TrackingImageAccessor {
   int start_frame;
   struct libmv_FrameAccessor *libmv_accessor;
   SpinLock cache_lock;
+  /* Most recently used original frames, so that tracks which are tracked on the same frame do
+   * not go through the clip cache (and its global lock) for every single track.
+   * Protected by cache_lock, replaced in a round-robin manner. */
+  TrackingAccessorFrame frames[MAX_ACCESSOR_FRAMES];
+  int next_frame_slot;
 } TrackingImageAccessor;
 
 TrackingImageAccessor *tracking_image_accessor_new(MovieClip *clips[MAX_ACCESSOR_CLIP],
@@ -148,6 +162,9 @@ TrackingImageAccessor *tracking_image_accessor_new(MovieClip *clips[MAX_ACCESSOR
                                                    int num_tracks,
                                                    int start_frame);
 void tracking_image_accessor_destroy(TrackingImageAccessor *accessor);
+void tracking_image_accessor_prefetch_frame(TrackingImageAccessor *accessor,
+                                            int clip_index,
+                                            int frame);
 
 #ifdef __cplusplus
 }
@@ -47,6 +47,13 @@ void BLI_task_scheduler_init(void);
 void BLI_task_scheduler_exit(void);
 int BLI_task_scheduler_num_threads(void);
 
+/* NUMA aware scheduling: with multiple NUMA nodes, large parallel ranges are split into one part
+ * per node, each processed by threads running on that node. Must be set before
+ * BLI_task_scheduler_init(). */
+void BLI_task_scheduler_numa_set(bool use_numa);
+/* Minimum number of items of a parallel range to split it between NUMA nodes. */
+void BLI_task_scheduler_numa_range_min_set(int range_min);
+
 /* Task Pool
  *
  * Pool of tasks that will be executed by the central task scheduler. For each
@@ -61,11 +68,33 @@ int BLI_task_scheduler_num_threads(void);
  * be launched.
  */
 
+/* Priority classes. When threads are busy, tasks of a higher priority class are started before
+ * any waiting task of a lower class. Running tasks are never interrupted, so long running low
+ * priority tasks should check for cancellation regularly. */
 typedef enum TaskPriority {
+  /* Background work like shader compilation, previews, prefetching and undo compression. */
   TASK_PRIORITY_LOW,
+  /* Regular work, same priority as parallel ranges. */
   TASK_PRIORITY_HIGH,
+  /* Work the user is waiting on, like evaluation and drawing of the active view. */
+  TASK_PRIORITY_INTERACTIVE,
 } TaskPriority;
 
+/* Cancellation Token
+ *
+ * Cooperative cancellation that can be shared between task pools, task graphs and
+ * jobs. Tasks that were not started yet are skipped once the token is canceled, running
+ * tasks are expected to poll the token and return early. Thread-safe. */
+
+typedef struct TaskCancelToken TaskCancelToken;
+
+TaskCancelToken *BLI_task_cancel_token_create(void);
+void BLI_task_cancel_token_free(TaskCancelToken *token);
+void BLI_task_cancel_token_cancel(TaskCancelToken *token);
+/* Clear the canceled state, to reuse the token for new work. */
+void BLI_task_cancel_token_reset(TaskCancelToken *token);
+bool BLI_task_cancel_token_is_canceled(const TaskCancelToken *token);
+
 typedef struct TaskPool TaskPool;
 typedef void (*TaskRunFunction)(TaskPool *__restrict pool, void *taskdata);
 typedef void (*TaskFreeFunction)(TaskPool *__restrict pool, void *taskdata);
@@ -107,6 +136,10 @@ void BLI_task_pool_cancel(TaskPool *pool);
 /* for worker threads, test if canceled */
 bool BLI_task_pool_canceled(TaskPool *pool);
 
+/* Optional cancellation token: once canceled, tasks not yet started are skipped and
+ * BLI_task_pool_canceled() returns true. The token is not owned by the pool. */
+void BLI_task_pool_cancel_token_set(TaskPool *pool, TaskCancelToken *token);
+
 /* optional userdata pointer to pass along to run function */
 void *BLI_task_pool_user_data(TaskPool *pool);
 
@@ -166,6 +199,12 @@ typedef struct TaskParallelSettings {
    * having a global use_threading switch based on just range size.
    */
   int min_iter_per_thread;
+  /* Measure the cost of iterations at runtime, and derive from it how many iterations each
+   * task gets and whether the range is worth threading at all. The cost is learned per range
+   * function, so a function should be used for loops with a similar cost per iteration.
+   * min_iter_per_thread stays a lower bound, and use_threading can still disable threading.
+   */
+  bool use_adaptive_chunking;
 } TaskParallelSettings;
 
 BLI_INLINE void BLI_parallel_range_settings_defaults(TaskParallelSettings *settings);
@@ -231,8 +270,14 @@ BLI_INLINE void BLI_parallel_range_settings_defaults(TaskParallelSettings *setti
   settings->use_threading = true;
   /* Use default heuristic to define actual chunk size. */
   settings->min_iter_per_thread = 0;
+  settings->use_adaptive_chunking = true;
 }
 
+#ifndef NDEBUG
+/* Print the learned cost and chunk size of ranges using adaptive chunking, per function. */
+void BLI_task_parallel_range_profile_print(void);
+#endif
+
 /* Don't use this, store any thread specific data in tls->userdata_chunk instead.
  * Only here for code to be removed. */
 int BLI_task_parallel_thread_id(const TaskParallelTLS *tls);
@@ -304,6 +349,9 @@ typedef void (*TaskGraphNodeRunFunction)(void *__restrict task_data);
 typedef void (*TaskGraphNodeFreeFunction)(void *task_data);
 
 struct TaskGraph *BLI_task_graph_create(void);
+/* Create a task graph with the given priority class. Once the optional cancellation token is
+ * canceled, nodes that did not start yet are skipped, along with all their successors. */
+struct TaskGraph *BLI_task_graph_create_ex(TaskPriority priority, TaskCancelToken *cancel_token);
 void BLI_task_graph_work_and_wait(struct TaskGraph *task_graph);
 void BLI_task_graph_free(struct TaskGraph *task_graph);
 struct TaskNode *BLI_task_graph_node_create(struct TaskGraph *task_graph,
@@ -20,7 +20,7 @@
 /** \file
  * \ingroup bli
  *
- * A general (pointer -> pointer) chaining hash table
+ * A general (pointer -> pointer) open addressing hash table
  * for 'Abstract Data Types' (known as an ADT Hash Table).
  */
 
@@ -45,12 +45,10 @@
 /** \name Structs & Constants
  * \{ */
 
-#define GHASH_USE_MODULO_BUCKETS
-
 /**
  * Next prime after `2^n` (skipping 2 & 3).
  *
- * \note Also used by: `BLI_edgehash` & `BLI_smallhash`.
+ * \note Used by: `BLI_edgehash` & `BLI_smallhash`.
  */
 extern const uint BLI_ghash_hash_sizes[]; /* Quiet warning, this is only used by smallhash.c */
 const uint BLI_ghash_hash_sizes[] = {
@@ -58,31 +56,27 @@ const uint BLI_ghash_hash_sizes[] = {
     2053,    4099,    8209,    16411,   32771,    65537,    131101,   262147,    524309,
     1048583, 2097169, 4194319, 8388617, 16777259, 33554467, 67108879, 134217757, 268435459,
 };
-#define hashsizes BLI_ghash_hash_sizes
 
-#ifdef GHASH_USE_MODULO_BUCKETS
-#  define GHASH_MAX_SIZE 27
-BLI_STATIC_ASSERT(ARRAY_SIZE(hashsizes) == GHASH_MAX_SIZE, "Invalid 'hashsizes' size");
-#else
-#  define GHASH_BUCKET_BIT_MIN 2
-#  define GHASH_BUCKET_BIT_MAX 28 /* About 268M of buckets... */
-#endif
+#define GHASH_BUCKET_BIT_MIN 3
+#define GHASH_BUCKET_BIT_MAX 30 /* About 1G of slots... */
 
 /**
- * \note Max load #GHASH_LIMIT_GROW used to be 3. (pre 2.74).
- * Python uses 0.6666, tommyhashlib even goes down to 0.5.
- * Reducing our from 3 to 0.75 gives huge speedup
- * (about twice quicker pure GHash insertions/lookup,
- * about 25% - 30% quicker 'dynamic-topology' stroke drawing e.g.).
+ * Open addressing needs some free slots to keep probe sequences short,
+ * the max load #GHASH_LIMIT_GROW is the same as Python's dict.
+ * Removed slots count towards that load too, until the next resize clears them.
  * Min load #GHASH_LIMIT_SHRINK is a quarter of max load, to avoid resizing to quickly.
  */
-#define GHASH_LIMIT_GROW(_nbkt) (((_nbkt)*3) / 4)
-#define GHASH_LIMIT_SHRINK(_nbkt) (((_nbkt)*3) / 16)
+#define GHASH_LIMIT_GROW(_nbkt) (((_nbkt)*2) / 3)
+#define GHASH_LIMIT_SHRINK(_nbkt) ((_nbkt) / 6)
+
+/**
+ * Same as `PythonProbingStrategy` in `BLI_probing_strategies.hh` (the default of `BLI_map.hh`),
+ * mixes the higher bits of the hash into the first probes, then visits all slots.
+ */
+#define GHASH_PERTURB_SHIFT 5
 
 /* WARNING! Keep in sync with ugly _gh_Entry in header!!! */
 typedef struct Entry {
-  struct Entry *next;
-
   void *key;
 } Entry;
 
@@ -96,21 +90,33 @@ typedef Entry GSetEntry;
 
 #define GHASH_ENTRY_SIZE(_is_gset) ((_is_gset) ? sizeof(GSetEntry) : sizeof(GHashEntry))
 
+/**
+ * Entries live in a memory pool so that pointers to their keys and values remain valid when the
+ * slots are resized, slots only store the entry and its full hash. Comparing hashes first means
+ * most probes don't need to access the entry itself.
+ */
+typedef struct GHashSlot {
+  /** NULL for never used slots, #GHASH_ENTRY_REMOVED for slots of removed entries. */
+  Entry *entry;
+  uint hash;
+} GHashSlot;
+
+#define GHASH_ENTRY_REMOVED ((Entry *)(uintptr_t)1)
+#define GHASH_SLOT_IS_USED(_slot) ((uintptr_t)(_slot)->entry > (uintptr_t)GHASH_ENTRY_REMOVED)
+
 struct GHash {
   GHashHashFP hashfp;
   GHashCmpFP cmpfp;
 
-  Entry **buckets;
+  GHashSlot *buckets;
   struct BLI_mempool *entrypool;
   uint nbuckets;
   uint limit_grow, limit_shrink;
-#ifdef GHASH_USE_MODULO_BUCKETS
-  uint cursize, size_min;
-#else
   uint bucket_mask, bucket_bit, bucket_bit_min;
-#endif
 
   uint nentries;
+  /** Number of slots tagged with #GHASH_ENTRY_REMOVED. */
+  uint nremoved;
   uint flag;
 };
 
@@ -149,43 +155,37 @@ BLI_INLINE uint ghash_keyhash(GHash *gh, const void *key)
 }
 
 /**
- * Get the full hash for an entry.
+ * Get the first slot-index of the probe sequence for an already-computed full hash.
  */
-BLI_INLINE uint ghash_entryhash(GHash *gh, const Entry *e)
+BLI_INLINE uint ghash_bucket_index(GHash *gh, const uint hash)
 {
-  return gh->hashfp(e->key);
+  return hash & gh->bucket_mask;
 }
 
 /**
- * Get the bucket-index for an already-computed full hash.
+ * Get the next slot-index of the probe sequence, \a perturb is initialized to the full hash.
  */
-BLI_INLINE uint ghash_bucket_index(GHash *gh, const uint hash)
+BLI_INLINE uint ghash_bucket_index_next(GHash *gh, const uint bucket_index, uint *perturb)
 {
-#ifdef GHASH_USE_MODULO_BUCKETS
-  return hash % gh->nbuckets;
-#else
-  return hash & gh->bucket_mask;
-#endif
+  *perturb >>= GHASH_PERTURB_SHIFT;
+  return (5 * bucket_index + 1 + *perturb) & gh->bucket_mask;
 }
 
 /**
- * Find the index of next used bucket, starting from \a curr_bucket (\a gh is assumed non-empty).
+ * Find the index of next used slot, starting from \a curr_bucket (\a gh is assumed non-empty).
  */
 BLI_INLINE uint ghash_find_next_bucket_index(GHash *gh, uint curr_bucket)
 {
   if (curr_bucket >= gh->nbuckets) {
     curr_bucket = 0;
   }
-  if (gh->buckets[curr_bucket]) {
-    return curr_bucket;
-  }
   for (; curr_bucket < gh->nbuckets; curr_bucket++) {
-    if (gh->buckets[curr_bucket]) {
+    if (GHASH_SLOT_IS_USED(&gh->buckets[curr_bucket])) {
       return curr_bucket;
     }
   }
   for (curr_bucket = 0; curr_bucket < gh->nbuckets; curr_bucket++) {
-    if (gh->buckets[curr_bucket]) {
+    if (GHASH_SLOT_IS_USED(&gh->buckets[curr_bucket])) {
       return curr_bucket;
     }
   }
@@ -194,108 +194,75 @@ BLI_INLINE uint ghash_find_next_bucket_index(GHash *gh, uint curr_bucket)
 }
 
 /**
- * Expand buckets to the next size up or down.
+ * Find the first unused or removed slot for given \a hash, to insert a new entry.
+ */
+BLI_INLINE GHashSlot *ghash_find_free_slot(GHash *gh, const uint hash)
+{
+  uint perturb = hash;
+  for (uint i = ghash_bucket_index(gh, hash);; i = ghash_bucket_index_next(gh, i, &perturb)) {
+    if (!GHASH_SLOT_IS_USED(&gh->buckets[i])) {
+      return &gh->buckets[i];
+    }
+  }
+}
+
+/**
+ * Resize slots to the next size up or down (or the same size, to get rid of removed slots).
+ * Stored hashes are re-used, so the hash callback is never called here.
  */
 static void ghash_buckets_resize(GHash *gh, const uint nbuckets)
 {
-  Entry **buckets_old = gh->buckets;
-  Entry **buckets_new;
+  GHashSlot *buckets_old = gh->buckets;
   const uint nbuckets_old = gh->nbuckets;
   uint i;
 
-  BLI_assert((gh->nbuckets != nbuckets) || !gh->buckets);
+  BLI_assert((gh->nbuckets != nbuckets) || !gh->buckets || gh->nremoved);
   //  printf("%s: %d -> %d\n", __func__, nbuckets_old, nbuckets);
 
   gh->nbuckets = nbuckets;
-#ifdef GHASH_USE_MODULO_BUCKETS
-#else
   gh->bucket_mask = nbuckets - 1;
-#endif
+  gh->nremoved = 0;
 
-  buckets_new = (Entry **)MEM_callocN(sizeof(*gh->buckets) * gh->nbuckets, __func__);
+  gh->buckets = (GHashSlot *)MEM_callocN(sizeof(*gh->buckets) * gh->nbuckets, __func__);
 
   if (buckets_old) {
-    if (nbuckets > nbuckets_old) {
-      for (i = 0; i < nbuckets_old; i++) {
-        for (Entry *e = buckets_old[i], *e_next; e; e = e_next) {
-          const uint hash = ghash_entryhash(gh, e);
-          const uint bucket_index = ghash_bucket_index(gh, hash);
-          e_next = e->next;
-          e->next = buckets_new[bucket_index];
-          buckets_new[bucket_index] = e;
-        }
-      }
-    }
-    else {
-      for (i = 0; i < nbuckets_old; i++) {
-#ifdef GHASH_USE_MODULO_BUCKETS
-        for (Entry *e = buckets_old[i], *e_next; e; e = e_next) {
-          const uint hash = ghash_entryhash(gh, e);
-          const uint bucket_index = ghash_bucket_index(gh, hash);
-          e_next = e->next;
-          e->next = buckets_new[bucket_index];
-          buckets_new[bucket_index] = e;
-        }
-#else
-        /* No need to recompute hashes in this case, since our mask is just smaller,
-         * all items in old bucket 'i' will go in same new bucket (i & new_mask)! */
-        const uint bucket_index = ghash_bucket_index(gh, i);
-        BLI_assert(!buckets_old[i] ||
-                   (bucket_index == ghash_bucket_index(gh, ghash_entryhash(gh, buckets_old[i]))));
-        Entry *e;
-        for (e = buckets_old[i]; e && e->next; e = e->next) {
-          /* pass */
-        }
-        if (e) {
-          e->next = buckets_new[bucket_index];
-          buckets_new[bucket_index] = buckets_old[i];
-        }
-#endif
+    for (i = 0; i < nbuckets_old; i++) {
+      if (GHASH_SLOT_IS_USED(&buckets_old[i])) {
+        *ghash_find_free_slot(gh, buckets_old[i].hash) = buckets_old[i];
       }
     }
-  }
-
-  gh->buckets = buckets_new;
-  if (buckets_old) {
     MEM_freeN(buckets_old);
   }
 }
 
 /**
- * Check if the number of items in the GHash is large enough to require more buckets,
- * or small enough to require less buckets, and resize \a gh accordingly.
+ * Check if the number of items in the GHash is large enough to require more slots,
+ * or if there are too many removed slots, and resize \a gh accordingly.
  */
 static void ghash_buckets_expand(GHash *gh, const uint nentries, const bool user_defined)
 {
   uint new_nbuckets;
 
-  if (LIKELY(gh->buckets && (nentries < gh->limit_grow))) {
+  if (LIKELY(gh->buckets && (nentries + gh->nremoved < gh->limit_grow))) {
     return;
   }
 
   new_nbuckets = gh->nbuckets;
 
-#ifdef GHASH_USE_MODULO_BUCKETS
-  while ((nentries > gh->limit_grow) && (gh->cursize < GHASH_MAX_SIZE - 1)) {
-    new_nbuckets = hashsizes[++gh->cursize];
-    gh->limit_grow = GHASH_LIMIT_GROW(new_nbuckets);
-  }
-#else
-  while ((nentries > gh->limit_grow) && (gh->bucket_bit < GHASH_BUCKET_BIT_MAX)) {
+  /* When removed slots fill the table, also grow it if it's already half-full,
+   * otherwise removing and inserting a single entry would have to resize every time. */
+  while ((nentries > gh->limit_grow ||
+          (gh->nremoved && new_nbuckets == gh->nbuckets && nentries >= gh->limit_grow / 2)) &&
+         (gh->bucket_bit < GHASH_BUCKET_BIT_MAX)) {
     new_nbuckets = 1u << ++gh->bucket_bit;
     gh->limit_grow = GHASH_LIMIT_GROW(new_nbuckets);
   }
-#endif
 
   if (user_defined) {
-#ifdef GHASH_USE_MODULO_BUCKETS
-    gh->size_min = gh->cursize;
-#else
     gh->bucket_bit_min = gh->bucket_bit;
-#endif
   }
 
-  if ((new_nbuckets == gh->nbuckets) && gh->buckets) {
+  if ((new_nbuckets == gh->nbuckets) && gh->buckets && (gh->nremoved == 0)) {
     return;
   }
 
@@ -321,24 +288,13 @@ static void ghash_buckets_contract(GHash *gh,
 
   new_nbuckets = gh->nbuckets;
 
-#ifdef GHASH_USE_MODULO_BUCKETS
-  while ((nentries < gh->limit_shrink) && (gh->cursize > gh->size_min)) {
-    new_nbuckets = hashsizes[--gh->cursize];
-    gh->limit_shrink = GHASH_LIMIT_SHRINK(new_nbuckets);
-  }
-#else
   while ((nentries < gh->limit_shrink) && (gh->bucket_bit > gh->bucket_bit_min)) {
     new_nbuckets = 1u << --gh->bucket_bit;
     gh->limit_shrink = GHASH_LIMIT_SHRINK(new_nbuckets);
   }
-#endif
 
   if (user_defined) {
-#ifdef GHASH_USE_MODULO_BUCKETS
-    gh->size_min = gh->cursize;
-#else
     gh->bucket_bit_min = gh->bucket_bit;
-#endif
   }
 
   if ((new_nbuckets == gh->nbuckets) && gh->buckets) {
@@ -351,82 +307,69 @@ static void ghash_buckets_contract(GHash *gh,
 }
 
 /**
- * Clear and reset \a gh buckets, reserve again buckets for given number of entries.
+ * Clear and reset \a gh slots, reserve again slots for given number of entries.
  */
 BLI_INLINE void ghash_buckets_reset(GHash *gh, const uint nentries)
 {
   MEM_SAFE_FREE(gh->buckets);
 
-#ifdef GHASH_USE_MODULO_BUCKETS
-  gh->cursize = 0;
-  gh->size_min = 0;
-  gh->nbuckets = hashsizes[gh->cursize];
-#else
   gh->bucket_bit = GHASH_BUCKET_BIT_MIN;
   gh->bucket_bit_min = GHASH_BUCKET_BIT_MIN;
   gh->nbuckets = 1u << gh->bucket_bit;
   gh->bucket_mask = gh->nbuckets - 1;
-#endif
 
   gh->limit_grow = GHASH_LIMIT_GROW(gh->nbuckets);
   gh->limit_shrink = GHASH_LIMIT_SHRINK(gh->nbuckets);
 
   gh->nentries = 0;
+  gh->nremoved = 0;
 
   ghash_buckets_expand(gh, nentries, (nentries != 0));
 }
 
 /**
  * Internal lookup function.
- * Takes hash and bucket_index arguments to avoid calling #ghash_keyhash and #ghash_bucket_index
- * multiple times.
+ * Takes the hash argument to avoid calling #ghash_keyhash multiple times.
+ *
+ * \param r_slot_free: When not NULL, set to the slot where \a key would be inserted
+ * (the first removed or unused slot of the probe sequence).
+ * \return The slot containing \a key or NULL.
  */
-BLI_INLINE Entry *ghash_lookup_entry_ex(GHash *gh, const void *key, const uint bucket_index)
-{
-  Entry *e;
-  /* If we do not store GHash, not worth computing it for each entry here!
-   * Typically, comparison function will be quicker, and since it's needed in the end anyway... */
-  for (e = gh->buckets[bucket_index]; e; e = e->next) {
-    if (UNLIKELY(gh->cmpfp(key, e->key) == false)) {
-      return e;
+BLI_INLINE GHashSlot *ghash_lookup_slot_ex(GHash *gh,
+                                           const void *key,
+                                           const uint hash,
+                                           GHashSlot **r_slot_free)
+{
+  GHashSlot *slot_free = NULL;
+  uint perturb = hash;
+
+  for (uint i = ghash_bucket_index(gh, hash);; i = ghash_bucket_index_next(gh, i, &perturb)) {
+    GHashSlot *slot = &gh->buckets[i];
+    if (slot->entry == NULL) {
+      if (r_slot_free) {
+        *r_slot_free = slot_free ? slot_free : slot;
+      }
+      return NULL;
     }
-  }
-
-  return NULL;
-}
-
-/**
- * Internal lookup function, returns previous entry of target one too.
- * Takes bucket_index argument to avoid calling #ghash_keyhash and #ghash_bucket_index
- * multiple times.
- * Useful when modifying buckets somehow (like removing an entry...).
- */
-BLI_INLINE Entry *ghash_lookup_entry_prev_ex(GHash *gh,
-                                             const void *key,
-                                             Entry **r_e_prev,
-                                             const uint bucket_index)
-{
-  /* If we do not store GHash, not worth computing it for each entry here!
-   * Typically, comparison function will be quicker, and since it's needed in the end anyway... */
-  for (Entry *e_prev = NULL, *e = gh->buckets[bucket_index]; e; e_prev = e, e = e->next) {
-    if (UNLIKELY(gh->cmpfp(key, e->key) == false)) {
-      *r_e_prev = e_prev;
-      return e;
+    if (slot->entry == GHASH_ENTRY_REMOVED) {
+      if (slot_free == NULL) {
+        slot_free = slot;
+      }
+    }
+    else if (slot->hash == hash && UNLIKELY(gh->cmpfp(key, slot->entry->key) == false)) {
+      return slot;
     }
   }
-
-  *r_e_prev = NULL;
-  return NULL;
 }
 
 /**
- * Internal lookup function. Only wraps #ghash_lookup_entry_ex
+ * Internal lookup function. Only wraps #ghash_lookup_slot_ex
  */
 BLI_INLINE Entry *ghash_lookup_entry(GHash *gh, const void *key)
 {
   const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  return ghash_lookup_entry_ex(gh, key, bucket_index);
+  GHashSlot *slot = ghash_lookup_slot_ex(gh, key, hash, NULL);
+  return slot ? slot->entry : NULL;
 }
 
 static GHash *ghash_new(GHashHashFP hashfp,
@@ -451,65 +394,56 @@ static GHash *ghash_new(GHashHashFP hashfp,
 }
 
 /**
- * Internal insert function.
- * Takes hash and bucket_index arguments to avoid calling #ghash_keyhash and #ghash_bucket_index
- * multiple times.
+ * Store a pre-allocated entry in given free \a slot (as returned by #ghash_lookup_slot_ex).
  */
-BLI_INLINE void ghash_insert_ex(GHash *gh, void *key, void *val, const uint bucket_index)
+BLI_INLINE void ghash_insert_slot(GHash *gh, GHashSlot *slot, Entry *e, const uint hash)
 {
-  GHashEntry *e = BLI_mempool_alloc(gh->entrypool);
+  BLI_assert(!GHASH_SLOT_IS_USED(slot));
 
-  BLI_assert((gh->flag & GHASH_FLAG_ALLOW_DUPES) || (BLI_ghash_haskey(gh, key) == 0));
-  BLI_assert(!(gh->flag & GHASH_FLAG_IS_GSET));
-
-  e->e.next = gh->buckets[bucket_index];
-  e->e.key = key;
-  e->val = val;
-  gh->buckets[bucket_index] = (Entry *)e;
+  if (slot->entry == GHASH_ENTRY_REMOVED) {
+    gh->nremoved--;
+  }
+  slot->entry = e;
+  slot->hash = hash;
 
   ghash_buckets_expand(gh, ++gh->nentries, false);
 }
 
 /**
- * Insert function that takes a pre-allocated entry.
+ * Internal insert function.
+ * Takes hash argument to avoid calling #ghash_keyhash multiple times.
  */
-BLI_INLINE void ghash_insert_ex_keyonly_entry(GHash *gh,
-                                              void *key,
-                                              const uint bucket_index,
-                                              Entry *e)
+BLI_INLINE void ghash_insert_ex(GHash *gh, void *key, void *val, const uint hash)
 {
-  BLI_assert((gh->flag & GHASH_FLAG_ALLOW_DUPES) || (BLI_ghash_haskey(gh, key) == 0));
+  GHashEntry *e = BLI_mempool_alloc(gh->entrypool);
 
-  e->next = gh->buckets[bucket_index];
-  e->key = key;
-  gh->buckets[bucket_index] = e;
+  BLI_assert((gh->flag & GHASH_FLAG_ALLOW_DUPES) || (BLI_ghash_haskey(gh, key) == 0));
+  BLI_assert(!(gh->flag & GHASH_FLAG_IS_GSET));
 
-  ghash_buckets_expand(gh, ++gh->nentries, false);
+  e->e.key = key;
+  e->val = val;
+  ghash_insert_slot(gh, ghash_find_free_slot(gh, hash), (Entry *)e, hash);
 }
 
 /**
  * Insert function that doesn't set the value (use for GSet)
  */
-BLI_INLINE void ghash_insert_ex_keyonly(GHash *gh, void *key, const uint bucket_index)
+BLI_INLINE void ghash_insert_ex_keyonly(GHash *gh, void *key, const uint hash)
 {
   Entry *e = BLI_mempool_alloc(gh->entrypool);
 
   BLI_assert((gh->flag & GHASH_FLAG_ALLOW_DUPES) || (BLI_ghash_haskey(gh, key) == 0));
   BLI_assert((gh->flag & GHASH_FLAG_IS_GSET) != 0);
 
-  e->next = gh->buckets[bucket_index];
   e->key = key;
-  gh->buckets[bucket_index] = e;
-
-  ghash_buckets_expand(gh, ++gh->nentries, false);
+  ghash_insert_slot(gh, ghash_find_free_slot(gh, hash), e, hash);
 }
 
 BLI_INLINE void ghash_insert(GHash *gh, void *key, void *val)
 {
   const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
 
-  ghash_insert_ex(gh, key, val, bucket_index);
+  ghash_insert_ex(gh, key, val, hash);
 }
 
 BLI_INLINE bool ghash_insert_safe(GHash *gh,
@@ -520,13 +454,14 @@ BLI_INLINE bool ghash_insert_safe(GHash *gh,
                                   GHashValFreeFP valfreefp)
 {
   const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  GHashEntry *e = (GHashEntry *)ghash_lookup_entry_ex(gh, key, bucket_index);
+  GHashSlot *slot_free = NULL;
+  GHashSlot *slot = ghash_lookup_slot_ex(gh, key, hash, &slot_free);
 
   BLI_assert(!(gh->flag & GHASH_FLAG_IS_GSET));
 
-  if (e) {
+  if (slot) {
     if (override) {
+      GHashEntry *e = (GHashEntry *)slot->entry;
       if (keyfreefp) {
         keyfreefp(e->e.key);
       }
@@ -539,7 +474,10 @@ BLI_INLINE bool ghash_insert_safe(GHash *gh,
     return false;
   }
   else {
-    ghash_insert_ex(gh, key, val, bucket_index);
+    GHashEntry *e = BLI_mempool_alloc(gh->entrypool);
+    e->e.key = key;
+    e->val = val;
+    ghash_insert_slot(gh, slot_free, (Entry *)e, hash);
     return true;
   }
 }
@@ -550,61 +488,93 @@ BLI_INLINE bool ghash_insert_safe_keyonly(GHash *gh,
                                           GHashKeyFreeFP keyfreefp)
 {
   const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  Entry *e = ghash_lookup_entry_ex(gh, key, bucket_index);
+  GHashSlot *slot_free = NULL;
+  GHashSlot *slot = ghash_lookup_slot_ex(gh, key, hash, &slot_free);
 
   BLI_assert((gh->flag & GHASH_FLAG_IS_GSET) != 0);
 
-  if (e) {
+  if (slot) {
     if (override) {
       if (keyfreefp) {
-        keyfreefp(e->key);
+        keyfreefp(slot->entry->key);
       }
-      e->key = key;
+      slot->entry->key = key;
     }
     return false;
   }
   else {
-    ghash_insert_ex_keyonly(gh, key, bucket_index);
+    Entry *e = BLI_mempool_alloc(gh->entrypool);
+    e->key = key;
+    ghash_insert_slot(gh, slot_free, e, hash);
     return true;
   }
 }
 
 /**
- * Remove the entry and return it, caller must free from gh->entrypool.
+ * Ensure an entry for \a key exists, the key of a new entry is set to \a key.
+ *
+ * \return true if the entry already existed.
  */
-static Entry *ghash_remove_ex(GHash *gh,
-                              const void *key,
-                              GHashKeyFreeFP keyfreefp,
-                              GHashValFreeFP valfreefp,
-                              const uint bucket_index)
+BLI_INLINE bool ghash_ensure_entry(GHash *gh, const void *key, Entry **r_e)
+{
+  const uint hash = ghash_keyhash(gh, key);
+  GHashSlot *slot_free = NULL;
+  GHashSlot *slot = ghash_lookup_slot_ex(gh, key, hash, &slot_free);
+
+  if (slot) {
+    *r_e = slot->entry;
+    return true;
+  }
+
+  Entry *e = BLI_mempool_alloc(gh->entrypool);
+  e->key = (void *)key;
+  ghash_insert_slot(gh, slot_free, e, hash);
+  *r_e = e;
+  return false;
+}
+
+/**
+ * Remove the entry of given used \a slot, and return it, caller must free from gh->entrypool.
+ */
+static Entry *ghash_remove_slot(GHash *gh,
+                                GHashSlot *slot,
+                                GHashKeyFreeFP keyfreefp,
+                                GHashValFreeFP valfreefp)
 {
-  Entry *e_prev;
-  Entry *e = ghash_lookup_entry_prev_ex(gh, key, &e_prev, bucket_index);
+  Entry *e = slot->entry;
 
   BLI_assert(!valfreefp || !(gh->flag & GHASH_FLAG_IS_GSET));
 
-  if (e) {
-    if (keyfreefp) {
-      keyfreefp(e->key);
-    }
-    if (valfreefp) {
-      valfreefp(((GHashEntry *)e)->val);
-    }
+  if (keyfreefp) {
+    keyfreefp(e->key);
+  }
+  if (valfreefp) {
+    valfreefp(((GHashEntry *)e)->val);
+  }
 
-    if (e_prev) {
-      e_prev->next = e->next;
-    }
-    else {
-      gh->buckets[bucket_index] = e->next;
-    }
+  /* Keep the slot as part of probe sequences going through it. */
+  slot->entry = GHASH_ENTRY_REMOVED;
+  gh->nremoved++;
 
-    ghash_buckets_contract(gh, --gh->nentries, false, false);
-  }
+  ghash_buckets_contract(gh, --gh->nentries, false, false);
 
   return e;
 }
 
+/**
+ * Remove the entry and return it, caller must free from gh->entrypool.
+ */
+static Entry *ghash_remove_ex(GHash *gh,
+                              const void *key,
+                              GHashKeyFreeFP keyfreefp,
+                              GHashValFreeFP valfreefp,
+                              const uint hash)
+{
+  GHashSlot *slot = ghash_lookup_slot_ex(gh, key, hash, NULL);
+
+  return slot ? ghash_remove_slot(gh, slot, keyfreefp, valfreefp) : NULL;
+}
+
 /**
  * Remove a random entry and return it (or NULL if empty), caller must free from gh->entrypool.
  */
@@ -616,14 +586,11 @@ static Entry *ghash_pop(GHash *gh, GHashIterState *state)
   }
 
   /* Note: using first_bucket_index here allows us to avoid potential
-   * huge number of loops over buckets,
+   * huge number of loops over slots,
    * in case we are popping from a large ghash with few items in it... */
   curr_bucket = ghash_find_next_bucket_index(gh, curr_bucket);
 
-  Entry *e = gh->buckets[curr_bucket];
-  BLI_assert(e);
-
-  ghash_remove_ex(gh, e->key, NULL, NULL, curr_bucket);
+  Entry *e = ghash_remove_slot(gh, &gh->buckets[curr_bucket], NULL, NULL);
 
   state->curr_bucket = curr_bucket;
   return e;
@@ -640,9 +607,8 @@ static void ghash_free_cb(GHash *gh, GHashKeyFreeFP keyfreefp, GHashValFreeFP va
   BLI_assert(!valfreefp || !(gh->flag & GHASH_FLAG_IS_GSET));
 
   for (i = 0; i < gh->nbuckets; i++) {
-    Entry *e;
-
-    for (e = gh->buckets[i]; e; e = e->next) {
+    if (GHASH_SLOT_IS_USED(&gh->buckets[i])) {
+      Entry *e = gh->buckets[i].entry;
       if (keyfreefp) {
         keyfreefp(e->key);
       }
@@ -660,7 +626,7 @@ static GHash *ghash_copy(GHash *gh, GHashKeyCopyFP keycopyfp, GHashValCopyFP val
 {
   GHash *gh_new;
   uint i;
-  /* This allows us to be sure to get the same number of buckets in gh_new as in ghash. */
+  /* This allows us to be sure to get the same number of slots in gh_new as in ghash. */
   const uint reserve_nentries_new = MAX2(GHASH_LIMIT_GROW(gh->nbuckets) - 1, gh->nentries);
 
   BLI_assert(!valcopyfp || !(gh->flag & GHASH_FLAG_IS_GSET));
@@ -671,23 +637,22 @@ static GHash *ghash_copy(GHash *gh, GHashKeyCopyFP keycopyfp, GHashValCopyFP val
   BLI_assert(gh_new->nbuckets == gh->nbuckets);
 
   for (i = 0; i < gh->nbuckets; i++) {
-    Entry *e;
+    GHashSlot *slot = &gh->buckets[i];
 
-    for (e = gh->buckets[i]; e; e = e->next) {
+    /* Note: We can use 'i' here, since we are sure that 'gh' and 'gh_new' have the same number
+     * of slots! Removed slots are copied too, so that probe sequences remain the same. */
+    if (GHASH_SLOT_IS_USED(slot)) {
       Entry *e_new = BLI_mempool_alloc(gh_new->entrypool);
-      ghash_entry_copy(gh_new, e_new, gh, e, keycopyfp, valcopyfp);
-
-      /* Warning!
-       * This means entries in buckets in new copy will be in reversed order!
-       * This shall not be an issue though, since order should never be assumed in ghash. */
-
-      /* Note: We can use 'i' here, since we are sure that
-       * 'gh' and 'gh_new' have the same number of buckets! */
-      e_new->next = gh_new->buckets[i];
-      gh_new->buckets[i] = e_new;
+      ghash_entry_copy(gh_new, e_new, gh, slot->entry, keycopyfp, valcopyfp);
+      gh_new->buckets[i].entry = e_new;
     }
+    else {
+      gh_new->buckets[i].entry = slot->entry;
+    }
+    gh_new->buckets[i].hash = slot->hash;
   }
   gh_new->nentries = gh->nentries;
+  gh_new->nremoved = gh->nremoved;
 
   return gh_new;
 }
@@ -784,12 +749,10 @@ bool BLI_ghash_reinsert(
  */
 void *BLI_ghash_replace_key(GHash *gh, void *key)
 {
-  const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  GHashEntry *e = (GHashEntry *)ghash_lookup_entry_ex(gh, key, bucket_index);
+  Entry *e = ghash_lookup_entry(gh, key);
   if (e != NULL) {
-    void *key_prev = e->e.key;
-    e->e.key = key;
+    void *key_prev = e->key;
+    e->key = key;
     return key_prev;
   }
   else {
@@ -856,17 +819,10 @@ void **BLI_ghash_lookup_p(GHash *gh, const void *key)
  */
 bool BLI_ghash_ensure_p(GHash *gh, void *key, void ***r_val)
 {
-  const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  GHashEntry *e = (GHashEntry *)ghash_lookup_entry_ex(gh, key, bucket_index);
-  const bool haskey = (e != NULL);
-
-  if (!haskey) {
-    e = BLI_mempool_alloc(gh->entrypool);
-    ghash_insert_ex_keyonly_entry(gh, key, bucket_index, (Entry *)e);
-  }
+  Entry *e;
+  const bool haskey = ghash_ensure_entry(gh, key, &e);
 
-  *r_val = &e->val;
+  *r_val = &((GHashEntry *)e)->val;
   return haskey;
 }
 
@@ -878,20 +834,15 @@ bool BLI_ghash_ensure_p(GHash *gh, void *key, void ***r_val)
  */
 bool BLI_ghash_ensure_p_ex(GHash *gh, const void *key, void ***r_key, void ***r_val)
 {
-  const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  GHashEntry *e = (GHashEntry *)ghash_lookup_entry_ex(gh, key, bucket_index);
-  const bool haskey = (e != NULL);
+  Entry *e;
+  const bool haskey = ghash_ensure_entry(gh, key, &e);
 
   if (!haskey) {
-    /* Pass 'key' in case we resize. */
-    e = BLI_mempool_alloc(gh->entrypool);
-    ghash_insert_ex_keyonly_entry(gh, (void *)key, bucket_index, (Entry *)e);
-    e->e.key = NULL; /* caller must re-assign */
+    e->key = NULL; /* caller must re-assign */
   }
 
-  *r_key = &e->e.key;
-  *r_val = &e->val;
+  *r_key = &e->key;
+  *r_val = &((GHashEntry *)e)->val;
   return haskey;
 }
 
@@ -909,8 +860,7 @@ bool BLI_ghash_remove(GHash *gh,
                       GHashValFreeFP valfreefp)
 {
   const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  Entry *e = ghash_remove_ex(gh, key, keyfreefp, valfreefp, bucket_index);
+  Entry *e = ghash_remove_ex(gh, key, keyfreefp, valfreefp, hash);
   if (e) {
     BLI_mempool_free(gh->entrypool, e);
     return true;
@@ -932,8 +882,7 @@ bool BLI_ghash_remove(GHash *gh,
 void *BLI_ghash_popkey(GHash *gh, const void *key, GHashKeyFreeFP keyfreefp)
 {
   const uint hash = ghash_keyhash(gh, key);
-  const uint bucket_index = ghash_bucket_index(gh, hash);
-  GHashEntry *e = (GHashEntry *)ghash_remove_ex(gh, key, keyfreefp, NULL, bucket_index);
+  GHashEntry *e = (GHashEntry *)ghash_remove_ex(gh, key, keyfreefp, NULL, hash);
   BLI_assert(!(gh->flag & GHASH_FLAG_IS_GSET));
   if (e) {
     void *val = e->val;
@@ -1079,13 +1028,7 @@ void BLI_ghashIterator_init(GHashIterator *ghi, GHash *gh)
   ghi->curEntry = NULL;
   ghi->curBucket = UINT_MAX; /* wraps to zero */
   if (gh->nentries) {
-    do {
-      ghi->curBucket++;
-      if (UNLIKELY(ghi->curBucket == ghi->gh->nbuckets)) {
-        break;
-      }
-      ghi->curEntry = ghi->gh->buckets[ghi->curBucket];
-    } while (!ghi->curEntry);
+    BLI_ghashIterator_step(ghi);
   }
 }
 
@@ -1096,14 +1039,13 @@ void BLI_ghashIterator_init(GHashIterator *ghi, GHash *gh)
  */
 void BLI_ghashIterator_step(GHashIterator *ghi)
 {
-  if (ghi->curEntry) {
-    ghi->curEntry = ghi->curEntry->next;
-    while (!ghi->curEntry) {
-      ghi->curBucket++;
-      if (ghi->curBucket == ghi->gh->nbuckets) {
-        break;
-      }
-      ghi->curEntry = ghi->gh->buckets[ghi->curBucket];
+  /* Only looks at the slots, so the current entry may have been removed meanwhile. */
+  ghi->curEntry = NULL;
+  while (++ghi->curBucket < ghi->gh->nbuckets) {
+    const GHashSlot *slot = &ghi->gh->buckets[ghi->curBucket];
+    if (GHASH_SLOT_IS_USED(slot)) {
+      ghi->curEntry = slot->entry;
+      break;
     }
   }
 }
@@ -1158,8 +1100,7 @@ uint BLI_gset_len(GSet *gs)
 void BLI_gset_insert(GSet *gs, void *key)
 {
   const uint hash = ghash_keyhash((GHash *)gs, key);
-  const uint bucket_index = ghash_bucket_index((GHash *)gs, hash);
-  ghash_insert_ex_keyonly((GHash *)gs, key, bucket_index);
+  ghash_insert_ex_keyonly((GHash *)gs, key, hash);
 }
 
 /**
@@ -1181,15 +1122,10 @@ bool BLI_gset_add(GSet *gs, void *key)
  */
 bool BLI_gset_ensure_p_ex(GSet *gs, const void *key, void ***r_key)
 {
-  const uint hash = ghash_keyhash((GHash *)gs, key);
-  const uint bucket_index = ghash_bucket_index((GHash *)gs, hash);
-  GSetEntry *e = (GSetEntry *)ghash_lookup_entry_ex((GHash *)gs, key, bucket_index);
-  const bool haskey = (e != NULL);
+  GSetEntry *e;
+  const bool haskey = ghash_ensure_entry((GHash *)gs, key, &e);
 
   if (!haskey) {
-    /* Pass 'key' in case we resize */
-    e = BLI_mempool_alloc(((GHash *)gs)->entrypool);
-    ghash_insert_ex_keyonly_entry((GHash *)gs, (void *)key, bucket_index, (Entry *)e);
     e->key = NULL; /* caller must re-assign */
   }
 
@@ -1302,8 +1238,7 @@ void *BLI_gset_lookup(GSet *gs, const void *key)
 void *BLI_gset_pop_key(GSet *gs, const void *key)
 {
   const uint hash = ghash_keyhash((GHash *)gs, key);
-  const uint bucket_index = ghash_bucket_index((GHash *)gs, hash);
-  Entry *e = ghash_remove_ex((GHash *)gs, key, NULL, NULL, bucket_index);
+  Entry *e = ghash_remove_ex((GHash *)gs, key, NULL, NULL, hash);
   if (e) {
     void *key_ret = e->key;
     BLI_mempool_free(((GHash *)gs)->entrypool, e);
@@ -1320,10 +1255,8 @@ void *BLI_gset_pop_key(GSet *gs, const void *key)
 /** \name Debugging & Introspection
  * \{ */
 
-#include "BLI_math.h"
-
 /**
- * \return number of buckets in the GHash.
+ * \return number of slots in the GHash.
  */
 int BLI_ghash_buckets_len(GHash *gh)
 {
@@ -1335,9 +1268,13 @@ int BLI_gset_buckets_len(GSet *gs)
 }
 
 /**
- * Measure how well the hash function performs (1.0 is approx as good as random distribution),
- * and return a few other stats like load,
- * variance of the distribution of the entries in the buckets, etc.
+ * Measure how well the hash function performs, as the average number of slots probed to find an
+ * entry (1.0 is ideal), and return a few other stats like load,
+ * variance of the number of probes, etc.
+ *
+ * Since entries are not stored in buckets, each entry is considered to be in a bucket of the
+ * size of its probe sequence: 'overloaded buckets' are entries not found at their first probe,
+ * and the 'biggest bucket' is the longest probe sequence.
  *
  * Smaller is better!
  */
@@ -1348,7 +1285,6 @@ double BLI_ghash_calc_quality_ex(GHash *gh,
                                  double *r_prop_overloaded_buckets,
                                  int *r_biggest_bucket)
 {
-  double mean;
   uint i;
 
   if (gh->nentries == 0) {
@@ -1371,62 +1307,53 @@ double BLI_ghash_calc_quality_ex(GHash *gh,
     return 0.0;
   }
 
-  mean = (double)gh->nentries / (double)gh->nbuckets;
   if (r_load) {
-    *r_load = mean;
-  }
-  if (r_biggest_bucket) {
-    *r_biggest_bucket = 0;
+    *r_load = (double)gh->nentries / (double)gh->nbuckets;
   }
 
-  if (r_variance) {
-    /* We already know our mean (i.e. load factor), easy to compute variance.
-     * See https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Two-pass_algorithm
-     */
-    double sum = 0.0;
-    for (i = 0; i < gh->nbuckets; i++) {
-      int count = 0;
-      Entry *e;
-      for (e = gh->buckets[i]; e; e = e->next) {
-        count++;
-      }
-      sum += ((double)count - mean) * ((double)count - mean);
-    }
-    *r_variance = sum / (double)(gh->nbuckets - 1);
-  }
+  uint64_t sum = 0, sum_sq = 0;
+  uint64_t sum_overloaded = 0;
+  uint64_t sum_empty = 0;
+  uint probes_max = 0;
 
-  {
-    uint64_t sum = 0;
-    uint64_t overloaded_buckets_threshold = (uint64_t)max_ii(GHASH_LIMIT_GROW(1), 1);
-    uint64_t sum_overloaded = 0;
-    uint64_t sum_empty = 0;
-
-    for (i = 0; i < gh->nbuckets; i++) {
-      uint64_t count = 0;
-      Entry *e;
-      for (e = gh->buckets[i]; e; e = e->next) {
-        count++;
-      }
-      if (r_biggest_bucket) {
-        *r_biggest_bucket = max_ii(*r_biggest_bucket, (int)count);
-      }
-      if (r_prop_overloaded_buckets && (count > overloaded_buckets_threshold)) {
-        sum_overloaded++;
-      }
-      if (r_prop_empty_buckets && !count) {
-        sum_empty++;
-      }
-      sum += count * (count + 1);
+  for (i = 0; i < gh->nbuckets; i++) {
+    const GHashSlot *slot = &gh->buckets[i];
+    if (!GHASH_SLOT_IS_USED(slot)) {
+      sum_empty++;
+      continue;
     }
-    if (r_prop_overloaded_buckets) {
-      *r_prop_overloaded_buckets = (double)sum_overloaded / (double)gh->nbuckets;
+
+    uint probes = 1;
+    uint perturb = slot->hash;
+    for (uint j = ghash_bucket_index(gh, slot->hash); j != i;
+         j = ghash_bucket_index_next(gh, j, &perturb)) {
+      probes++;
     }
-    if (r_prop_empty_buckets) {
-      *r_prop_empty_buckets = (double)sum_empty / (double)gh->nbuckets;
+
+    probes_max = MAX2(probes_max, probes);
+    if (probes > 1) {
+      sum_overloaded++;
     }
-    return ((double)sum * (double)gh->nbuckets /
-            ((double)gh->nentries * (gh->nentries + 2 * gh->nbuckets - 1)));
+    sum += probes;
+    sum_sq += (uint64_t)probes * probes;
+  }
+
+  const double mean = (double)sum / (double)gh->nentries;
+  if (r_variance) {
+    *r_variance = (gh->nentries > 1) ? ((double)sum_sq - (double)sum * mean) /
+                                           (double)(gh->nentries - 1) :
+                                       0.0;
+  }
+  if (r_prop_overloaded_buckets) {
+    *r_prop_overloaded_buckets = (double)sum_overloaded / (double)gh->nentries;
+  }
+  if (r_prop_empty_buckets) {
+    *r_prop_empty_buckets = (double)sum_empty / (double)gh->nbuckets;
+  }
+  if (r_biggest_bucket) {
+    *r_biggest_bucket = (int)probes_max;
   }
+  return mean;
 }
 double BLI_gset_calc_quality_ex(GSet *gs,
                                 double *r_load,
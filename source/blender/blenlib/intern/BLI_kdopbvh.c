@@ -72,6 +72,10 @@
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 1024
 #endif
 
+/* Number of leafs above which the bounds of a single branch are calculated
+ * over multiple threads while balancing. */
+#define KDOPBVH_THREAD_REFIT_THRESHOLD (1 << 14)
+
 /* -------------------------------------------------------------------- */
 /** \name Struct Definitions
  * \{ */
@@ -378,6 +382,62 @@ static void create_kdop_hull(
   }
 }
 
+static void refit_kdop_hull_merge(const BVHTree *tree,
+                                  float *__restrict bv,
+                                  const float *__restrict node_bv)
+{
+  axis_t axis_iter;
+
+  for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
+    bv[(2 * axis_iter)] = min_ff(bv[(2 * axis_iter)], node_bv[(2 * axis_iter)]);
+    bv[(2 * axis_iter) + 1] = max_ff(bv[(2 * axis_iter) + 1], node_bv[(2 * axis_iter) + 1]);
+  }
+}
+
+static void refit_kdop_hull_task_cb(void *__restrict userdata,
+                                    const int j,
+                                    const TaskParallelTLS *__restrict tls)
+{
+  const BVHTree *tree = userdata;
+  refit_kdop_hull_merge(tree, tls->userdata_chunk, tree->nodes[j]->bv);
+}
+
+static void refit_kdop_hull_reduce(const void *__restrict userdata,
+                                   void *__restrict chunk_join,
+                                   void *__restrict chunk)
+{
+  refit_kdop_hull_merge(userdata, chunk_join, chunk);
+}
+
+/**
+ * Same as #refit_kdop_hull for large ranges, splitting the leafs over multiple threads.
+ * Only used for the top levels of the tree, which don't have enough branches
+ * to keep all threads busy.
+ */
+static void refit_kdop_hull_parallel(const BVHTree *tree, BVHNode *node, int start, int end)
+{
+  float bv[13][2];
+  axis_t axis_iter;
+
+  for (axis_iter = 0; axis_iter < 13; axis_iter++) {
+    bv[axis_iter][0] = FLT_MAX;
+    bv[axis_iter][1] = -FLT_MAX;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = KDOPBVH_THREAD_REFIT_THRESHOLD / 16;
+  settings.userdata_chunk = bv;
+  settings.userdata_chunk_size = sizeof(bv);
+  settings.func_reduce = refit_kdop_hull_reduce;
+  BLI_task_parallel_range(start, end, (void *)tree, refit_kdop_hull_task_cb, &settings);
+
+  for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
+    node->bv[(2 * axis_iter)] = bv[axis_iter][0];
+    node->bv[(2 * axis_iter) + 1] = bv[axis_iter][1];
+  }
+}
+
 /**
  * \note depends on the fact that the BVH's for each face is already built
  */
@@ -390,6 +450,11 @@ static void refit_kdop_hull(const BVHTree *tree, BVHNode *node, int start, int e
 
   node_minmax_init(tree, node);
 
+  if ((end - start) > KDOPBVH_THREAD_REFIT_THRESHOLD) {
+    refit_kdop_hull_parallel(tree, node, start, end);
+    return;
+  }
+
   for (j = start; j < end; j++) {
     float *__restrict node_bv = tree->nodes[j]->bv;
 
@@ -1038,8 +1103,20 @@ bool BLI_bvhtree_update_node(
   return true;
 }
 
+static void bvhtree_update_tree_task_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHTree *tree = userdata;
+  node_join(tree, tree->nodes[tree->totleaf + i]);
+}
+
 /**
  * Call #BLI_bvhtree_update_node() first for every node/point/triangle.
+ *
+ * \note #BLI_bvhtree_update_node may be called from multiple threads (for different nodes),
+ * this refits the tree without changing its structure, so it's much cheaper than rebuilding
+ * when only the coordinates changed.
  */
 void BLI_bvhtree_update_tree(BVHTree *tree)
 {
@@ -1047,11 +1124,36 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
    * TRICKY: the way we build the tree all the children have an index greater than the parent
    * This allows us todo a bottom up update by starting on the bigger numbered branch. */
 
-  BVHNode **root = tree->nodes + tree->totleaf;
-  BVHNode **index = tree->nodes + tree->totleaf + tree->totbranch - 1;
+  if (tree->totleaf <= KDOPBVH_THREAD_LEAF_THRESHOLD) {
+    BVHNode **root = tree->nodes + tree->totleaf;
+    BVHNode **index = tree->nodes + tree->totleaf + tree->totbranch - 1;
+
+    for (; index >= root; index--) {
+      node_join(tree, *index);
+    }
+    return;
+  }
+
+  /* Branches of each depth are stored contiguously (see #non_recursive_bvh_div_nodes),
+   * once a level is joined, all branches of its parent level can be joined in parallel. */
+  const int tree_offset = 2 - tree->tree_type;
+  int level_start[32];
+  int levels_num = 0;
+
+  for (int i = 1; i <= tree->totbranch; i = i * tree->tree_type + tree_offset) {
+    BLI_assert(levels_num < (int)ARRAY_SIZE(level_start));
+    level_start[levels_num++] = i - 1;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
 
-  for (; index >= root; index--) {
-    node_join(tree, *index);
+  int level_end = tree->totbranch;
+  while (levels_num--) {
+    BLI_task_parallel_range(
+        level_start[levels_num], level_end, tree, bvhtree_update_tree_task_cb, &settings);
+    level_end = level_start[levels_num];
   }
 }
 /**
@@ -1474,16 +1576,9 @@ static float calc_nearest_point_squared(const float proj[3], BVHNode *node, floa
   int i;
   const float *bv = node->bv;
 
-  /* nearest on AABB hull */
+  /* nearest on AABB hull (clamp without branches, this is the inner loop of the search) */
   for (i = 0; i != 3; i++, bv += 2) {
-    float val = proj[i];
-    if (bv[0] > val) {
-      val = bv[0];
-    }
-    if (bv[1] < val) {
-      val = bv[1];
-    }
-    nearest[i] = val;
+    nearest[i] = min_ff(max_ff(proj[i], bv[0]), bv[1]);
   }
 
   return len_squared_v3v3(proj, nearest);
@@ -1641,6 +1736,74 @@ int BLI_bvhtree_find_nearest(BVHTree *tree,
   return BLI_bvhtree_find_nearest_ex(tree, co, nearest, callback, userdata, 0);
 }
 
+/**
+ * Batched #BLI_bvhtree_find_nearest_ex, queries are split over multiple threads.
+ *
+ * Each thread runs over a contiguous range of coordinates, first testing the element found for
+ * the previous coordinate (when there is a callback), so spatially coherent input (such as the
+ * vertices of a mesh) only needs to visit few nodes per query.
+ */
+typedef struct BVHNearestBatchData {
+  BVHTree *tree;
+  const float (*co)[3];
+  BVHTreeNearest *nearest;
+  BVHTree_NearestPointCallback callback;
+  void *userdata;
+  int flag;
+} BVHNearestBatchData;
+
+static void bvhtree_find_nearest_batch_cb(void *__restrict userdata,
+                                          const int i,
+                                          const TaskParallelTLS *__restrict tls)
+{
+  BVHNearestBatchData *data = userdata;
+  int *index_prev = tls->userdata_chunk;
+  BVHTreeNearest *nearest = &data->nearest[i];
+
+  if (data->callback && (*index_prev != -1)) {
+    /* Tighten the search distance, only closer elements need to be visited. */
+    data->callback(data->userdata, *index_prev, data->co[i], nearest);
+  }
+
+  BLI_bvhtree_find_nearest_ex(
+      data->tree, data->co[i], nearest, data->callback, data->userdata, data->flag);
+
+  if (nearest->index != -1) {
+    *index_prev = nearest->index;
+  }
+}
+
+/**
+ * \param nearest: Array of \a co_len results, initialized by the caller
+ * (only elements closer than `nearest[i].dist_sq` are found).
+ * \note \a callback must be thread-safe.
+ */
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    const int co_len,
+                                    BVHTreeNearest *nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag)
+{
+  BVHNearestBatchData data = {
+      .tree = tree,
+      .co = co,
+      .nearest = nearest,
+      .callback = callback,
+      .userdata = userdata,
+      .flag = flag,
+  };
+  int index_prev = -1;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  settings.userdata_chunk = &index_prev;
+  settings.userdata_chunk_size = sizeof(index_prev);
+  BLI_task_parallel_range(0, co_len, &data, bvhtree_find_nearest_batch_cb, &settings);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -1978,6 +2141,67 @@ int BLI_bvhtree_ray_cast(BVHTree *tree,
       tree, co, dir, radius, hit, callback, userdata, BVH_RAYCAST_DEFAULT);
 }
 
+/**
+ * Batched #BLI_bvhtree_ray_cast_ex, rays are split over multiple threads.
+ */
+typedef struct BVHRayCastBatchData {
+  BVHTree *tree;
+  const float (*co)[3];
+  const float (*dir)[3];
+  float radius;
+  BVHTreeRayHit *hit;
+  BVHTree_RayCastCallback callback;
+  void *userdata;
+  int flag;
+} BVHRayCastBatchData;
+
+static void bvhtree_ray_cast_batch_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHRayCastBatchData *data = userdata;
+  BLI_bvhtree_ray_cast_ex(data->tree,
+                          data->co[i],
+                          data->dir[i],
+                          data->radius,
+                          &data->hit[i],
+                          data->callback,
+                          data->userdata,
+                          data->flag);
+}
+
+/**
+ * \param hit: Array of \a rays_len results, initialized by the caller
+ * (only hits closer than `hit[i].dist` are found).
+ * \note \a callback must be thread-safe.
+ */
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                const int rays_len,
+                                float radius,
+                                BVHTreeRayHit *hit,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag)
+{
+  BVHRayCastBatchData data = {
+      .tree = tree,
+      .co = co,
+      .dir = dir,
+      .radius = radius,
+      .hit = hit,
+      .callback = callback,
+      .userdata = userdata,
+      .flag = flag,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(0, rays_len, &data, bvhtree_ray_cast_batch_cb, &settings);
+}
+
 float BLI_bvhtree_bb_raycast(const float bv[6],
                              const float light_start[3],
                              const float light_end[3],
@@ -0,0 +1,128 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bli
+ *
+ * Read-only memory mapping of files.
+ *
+ * \note Pages of the mapping are only loaded when accessed, so I/O errors
+ * (or the file being truncated by another process) while the mapping is in use
+ * are not reported gracefully. Callers are expected to only map files they don't
+ * expect to change while they are being read (as is the case for loading blend-files).
+ */
+
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+#include "BLI_mmap.h"
+#include "BLI_utildefines.h"
+
+#ifdef WIN32
+#  include "BLI_winstuff.h"
+#  include <io.h>
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+struct BLI_mmap_file {
+  /* The address to which the file was mapped. */
+  char *memory;
+
+  /* The length of the file (and therefore the mapping). */
+  size_t length;
+
+#ifdef WIN32
+  HANDLE handle;
+#endif
+};
+
+BLI_mmap_file *BLI_mmap_open(int fd)
+{
+  void *memory;
+  size_t length = BLI_lseek(fd, 0, SEEK_END);
+  if (length == (size_t)-1 || length == 0) {
+    return NULL;
+  }
+
+#ifdef WIN32
+  /* Create the file mapping. */
+  HANDLE handle = CreateFileMapping(
+      (HANDLE)_get_osfhandle(fd), NULL, PAGE_READONLY, 0, 0, NULL);
+  if (handle == NULL) {
+    return NULL;
+  }
+
+  /* Map the whole file (the view is read-only). */
+  memory = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+  if (memory == NULL) {
+    CloseHandle(handle);
+    return NULL;
+  }
+#else
+  /* Map the whole file (the mapping is read-only, changes to the file are still visible). */
+  memory = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (memory == MAP_FAILED) {
+    return NULL;
+  }
+#endif
+
+  BLI_mmap_file *file = MEM_callocN(sizeof(BLI_mmap_file), __func__);
+  file->memory = memory;
+  file->length = length;
+#ifdef WIN32
+  file->handle = handle;
+#endif
+
+  return file;
+}
+
+bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
+{
+  /* Don't attempt to read past the end of the file. */
+  if (offset > file->length || length > file->length - offset) {
+    return false;
+  }
+
+  memcpy(dest, file->memory + offset, length);
+  return true;
+}
+
+const void *BLI_mmap_get_pointer(const BLI_mmap_file *file)
+{
+  return file->memory;
+}
+
+size_t BLI_mmap_get_length(const BLI_mmap_file *file)
+{
+  return file->length;
+}
+
+void BLI_mmap_free(BLI_mmap_file *file)
+{
+#ifdef WIN32
+  UnmapViewOfFile(file->memory);
+  CloseHandle(file->handle);
+#else
+  munmap((void *)file->memory, file->length);
+#endif
+
+  MEM_freeN(file);
+}
@@ -22,6 +22,7 @@
 
 #include "BLI_kdtree_impl.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_strict_flags.h"
 #include "BLI_utildefines.h"
 
@@ -55,6 +56,8 @@ struct KDTree {
 #define KD_STACK_INIT 100     /* initial size for array (on the stack) */
 #define KD_NEAR_ALLOC_INC 100 /* alloc increment for collecting nearest */
 #define KD_FOUND_ALLOC_INC 50 /* alloc increment for collecting nearest */
+/* Below this number of points duplicates are searched for on a single thread. */
+#define KD_DEDUPLICATE_THREAD_MIN 10000
 
 #define KD_NODE_UNSET ((uint)-1)
 
@@ -806,20 +809,6 @@ finally:
   }
 }
 
-/**
- * Use when we want to loop over nodes ordered by index.
- * Requires indices to be aligned with nodes.
- */
-static uint *kdtree_order(const KDTree *tree)
-{
-  const KDTreeNode *nodes = tree->nodes;
-  uint *order = MEM_mallocN(sizeof(uint) * tree->nodes_len, __func__);
-  for (uint i = 0; i < tree->nodes_len; i++) {
-    order[nodes[i].index] = i;
-  }
-  return order;
-}
-
 /* -------------------------------------------------------------------- */
 /** \name BLI_kdtree_3d_calc_duplicates_fast
  * \{ */
@@ -829,15 +818,17 @@ struct DeDuplicateParams {
   const KDTreeNode *nodes;
   float range;
   float range_sq;
-  int *duplicates;
-  int *duplicates_found;
+  /** Offsets into \a neighbors per node, NULL while counting. */
+  const uint *neighbors_offset;
+  int *neighbors;
 
   /* Per Search */
   float search_co[KD_DIMS];
   int search;
+  uint neighbors_len;
 };
 
-static void deduplicate_recursive(const struct DeDuplicateParams *p, uint i)
+static void deduplicate_recursive(struct DeDuplicateParams *p, uint i)
 {
   const KDTreeNode *node = &p->nodes[i];
   if (p->search_co[node->d] + p->range <= node->co[node->d]) {
@@ -851,10 +842,12 @@ static void deduplicate_recursive(const struct DeDuplicateParams *p, uint i)
     }
   }
   else {
-    if ((p->search != node->index) && (p->duplicates[node->index] == -1)) {
+    if (p->search != node->index) {
       if (len_squared_vnvn(node->co, p->search_co) <= p->range_sq) {
-        p->duplicates[node->index] = (int)p->search;
-        *p->duplicates_found += 1;
+        if (p->neighbors_offset) {
+          p->neighbors[p->neighbors_offset[p->search] + p->neighbors_len] = node->index;
+        }
+        p->neighbors_len += 1;
       }
     }
     if (node->left != KD_NODE_UNSET) {
@@ -866,6 +859,65 @@ static void deduplicate_recursive(const struct DeDuplicateParams *p, uint i)
   }
 }
 
+struct DeDuplicateThreadData {
+  const KDTree *tree;
+  struct DeDuplicateParams p;
+  /** Number of neighbors per index, filled in while counting. */
+  uint *neighbors_len;
+};
+
+/* Searches are independent of each other, so they run in parallel, collecting the neighbors of
+ * every point. Only resolving them into merges depends on the order. */
+static void deduplicate_neighbors_cb(void *__restrict userdata,
+                                     const int node_index,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct DeDuplicateThreadData *data = userdata;
+  const KDTreeNode *node = &data->tree->nodes[node_index];
+  struct DeDuplicateParams p = data->p;
+
+  p.search = node->index;
+  copy_vn_vn(p.search_co, node->co);
+  p.neighbors_len = 0;
+  deduplicate_recursive(&p, data->tree->root);
+  if (p.neighbors_offset == NULL) {
+    data->neighbors_len[node->index] = p.neighbors_len;
+  }
+}
+
+static void deduplicate_neighbors_find(const KDTree *tree,
+                                       struct DeDuplicateThreadData *data,
+                                       const bool use_threading)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = use_threading;
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, (int)tree->nodes_len, data, deduplicate_neighbors_cb, &settings);
+}
+
+/* Merge the unmerged neighbors of \a index into it. */
+static void deduplicate_resolve(const int index,
+                                const uint *neighbors_offset,
+                                const int *neighbors,
+                                int *duplicates,
+                                int *found)
+{
+  if (ELEM(duplicates[index], -1, index)) {
+    const int found_prev = *found;
+    for (uint i = neighbors_offset[index]; i < neighbors_offset[index + 1]; i++) {
+      if (duplicates[neighbors[i]] == -1) {
+        duplicates[neighbors[i]] = index;
+        *found += 1;
+      }
+    }
+    if (*found != found_prev) {
+      /* Prevent chains of doubles. */
+      duplicates[index] = index;
+    }
+  }
+}
+
 /**
  * Find duplicate points in \a range.
  * Favors speed over quality since it doesn't find the best target vertex for merging.
@@ -874,8 +926,7 @@ static void deduplicate_recursive(const struct DeDuplicateParams *p, uint i)
  *
  * \param range: Coordinates in this range are candidates to be merged.
  * \param use_index_order: Loop over the coordinates ordered by #KDTreeNode.index
- * At the expense of some performance, this ensures the layout of the tree doesn't influence
- * the iteration order.
+ * This ensures the layout of the tree doesn't influence the iteration order.
  * \param duplicates: An array of int's the length of #KDTree.nodes_len
  * Values initialized to -1 are candidates to me merged.
  * Setting the index to it's own position in the array prevents it from being touched,
@@ -883,6 +934,7 @@ static void deduplicate_recursive(const struct DeDuplicateParams *p, uint i)
  * \returns The number of merges found (includes any merges already in the \a duplicates array).
  *
  * \note Merging is always a single step (target indices wont be marked for merging).
+ * \note Neighbors are searched for in parallel, the results don't depend on the number of threads.
  */
 int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
                                          const float range,
@@ -890,48 +942,48 @@ int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
                                          int *duplicates)
 {
   int found = 0;
-  struct DeDuplicateParams p = {
-      .nodes = tree->nodes,
-      .range = range,
-      .range_sq = square_f(range),
-      .duplicates = duplicates,
-      .duplicates_found = &found,
+  struct DeDuplicateThreadData data = {
+      .tree = tree,
+      .p =
+          {
+              .nodes = tree->nodes,
+              .range = range,
+              .range_sq = square_f(range),
+          },
   };
+  const bool use_threading = tree->nodes_len > KD_DEDUPLICATE_THREAD_MIN;
+
+  /* Count the neighbors, then store them in one array. */
+  data.neighbors_len = MEM_mallocN(sizeof(uint) * tree->nodes_len, __func__);
+  deduplicate_neighbors_find(tree, &data, use_threading);
+
+  uint *neighbors_offset = MEM_mallocN(sizeof(uint) * (tree->nodes_len + 1), __func__);
+  neighbors_offset[0] = 0;
+  for (uint i = 0; i < tree->nodes_len; i++) {
+    neighbors_offset[i + 1] = neighbors_offset[i] + data.neighbors_len[i];
+  }
+  MEM_freeN(data.neighbors_len);
+  data.neighbors_len = NULL;
+
+  const uint neighbors_len = neighbors_offset[tree->nodes_len];
+  int *neighbors = MEM_mallocN(sizeof(int) * MAX2(neighbors_len, 1u), __func__);
+  data.p.neighbors_offset = neighbors_offset;
+  data.p.neighbors = neighbors;
+  deduplicate_neighbors_find(tree, &data, use_threading);
 
   if (use_index_order) {
-    uint *order = kdtree_order(tree);
     for (uint i = 0; i < tree->nodes_len; i++) {
-      const uint node_index = order[i];
-      const int index = (int)i;
-      if (ELEM(duplicates[index], -1, index)) {
-        p.search = index;
-        copy_vn_vn(p.search_co, tree->nodes[node_index].co);
-        int found_prev = found;
-        deduplicate_recursive(&p, tree->root);
-        if (found != found_prev) {
-          /* Prevent chains of doubles. */
-          duplicates[index] = index;
-        }
-      }
+      deduplicate_resolve((int)i, neighbors_offset, neighbors, duplicates, &found);
     }
-    MEM_freeN(order);
   }
   else {
     for (uint i = 0; i < tree->nodes_len; i++) {
-      const uint node_index = i;
-      const int index = p.nodes[node_index].index;
-      if (ELEM(duplicates[index], -1, index)) {
-        p.search = index;
-        copy_vn_vn(p.search_co, tree->nodes[node_index].co);
-        int found_prev = found;
-        deduplicate_recursive(&p, tree->root);
-        if (found != found_prev) {
-          /* Prevent chains of doubles. */
-          duplicates[index] = index;
-        }
-      }
+      deduplicate_resolve(tree->nodes[i].index, neighbors_offset, neighbors, duplicates, &found);
     }
   }
+
+  MEM_freeN(neighbors_offset);
+  MEM_freeN(neighbors);
   return found;
 }
 
@@ -32,15 +32,40 @@
 #  define TBB_SUPPRESS_DEPRECATED_MESSAGES 1
 #  include <tbb/flow_graph.h>
 #  include <tbb/tbb.h>
+
+#  include "task_intern.hh"
 #endif
 
 /* Task Graph */
 struct TaskGraph {
+  /* Optional cancellation token, not owned by the graph. */
+  TaskCancelToken *cancel_token;
 #ifdef WITH_TBB
+  /* Context holding the priority of all node tasks, must be constructed before the graph. */
+  tbb::task_group_context tbb_context;
   tbb::flow::graph tbb_graph;
 #endif
   std::vector<std::unique_ptr<TaskNode>> nodes;
 
+  TaskGraph(TaskPriority priority, TaskCancelToken *cancel_token)
+      : cancel_token(cancel_token)
+#ifdef WITH_TBB
+        ,
+        tbb_graph(tbb_context)
+#endif
+  {
+#ifdef WITH_TBB
+    task_scheduler_context_priority_set(tbb_context, priority);
+#else
+    UNUSED_VARS(priority);
+#endif
+  }
+
+  bool is_canceled() const
+  {
+    return cancel_token && BLI_task_cancel_token_is_canceled(cancel_token);
+  }
+
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("task_graph:TaskGraph")
 #endif
@@ -54,6 +79,8 @@ struct TaskNode {
 #endif
   /* Successors to execute after this task, for serial execution fallback. */
   std::vector<TaskNode *> successors;
+  /* Graph owning the node, to check for cancellation. */
+  TaskGraph *task_graph;
 
   /* User function to be executed with given task data. */
   TaskGraphNodeRunFunction run_func;
@@ -72,13 +99,11 @@ struct TaskNode {
                  tbb::flow::unlimited,
                  std::bind(&TaskNode::run, this, std::placeholders::_1)),
 #endif
+        task_graph(task_graph),
         run_func(run_func),
         task_data(task_data),
         free_func(free_func)
   {
-#ifndef WITH_TBB
-    UNUSED_VARS(task_graph);
-#endif
   }
 
   TaskNode(const TaskNode &other) = delete;
@@ -94,6 +119,11 @@ struct TaskNode {
 #ifdef WITH_TBB
   tbb::flow::continue_msg run(const tbb::flow::continue_msg UNUSED(input))
   {
+    /* Still forward the message when canceled, successors skip themselves so waiting for
+     * the graph finishes quickly. */
+    if (task_graph->is_canceled()) {
+      return tbb::flow::continue_msg();
+    }
     tbb::this_task_arena::isolate([this] { run_func(task_data); });
     return tbb::flow::continue_msg();
   }
@@ -101,6 +131,9 @@ struct TaskNode {
 
   void run_serial()
   {
+    if (task_graph->is_canceled()) {
+      return;
+    }
     run_func(task_data);
     for (TaskNode *successor : successors) {
       successor->run_serial();
@@ -114,7 +147,12 @@ struct TaskNode {
 
 TaskGraph *BLI_task_graph_create(void)
 {
-  return new TaskGraph();
+  return new TaskGraph(TASK_PRIORITY_HIGH, nullptr);
+}
+
+TaskGraph *BLI_task_graph_create_ex(TaskPriority priority, TaskCancelToken *cancel_token)
+{
+  return new TaskGraph(priority, cancel_token);
 }
 
 void BLI_task_graph_free(TaskGraph *task_graph)
@@ -0,0 +1,48 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bli
+ *
+ * Task scheduler internals, shared between the task implementation files.
+ */
+
+#ifndef __TASK_INTERN_HH__
+#define __TASK_INTERN_HH__
+
+#ifdef WITH_TBB
+
+#  include <tbb/task.h>
+#  include <tbb/task_arena.h>
+
+#  include "BLI_task.h"
+
+/* Set the TBB priority matching the priority class, for all tasks spawned in the context. */
+void task_scheduler_context_priority_set(tbb::task_group_context &context, TaskPriority priority);
+
+/* Number of NUMA nodes to split large parallel ranges between,
+ * 0 when NUMA aware scheduling is disabled or there is only a single node. */
+int task_scheduler_numa_nodes_num();
+/* Minimum number of items of a parallel range to split it between NUMA nodes. */
+int task_scheduler_numa_range_min_get();
+/* Number of processors of the node, to give it a proportional part of the range. */
+int task_scheduler_numa_node_processors(int node_index);
+/* Arena whose worker threads run on the node. */
+tbb::task_arena &task_scheduler_numa_node_arena(int node_index);
+
+#endif /* WITH_TBB */
+
+#endif /* __TASK_INTERN_HH__ */
@@ -37,6 +37,8 @@
 /* Quiet top level deprecation message, unrelated to API usage here. */
 #  define TBB_SUPPRESS_DEPRECATED_MESSAGES 1
 #  include <tbb/tbb.h>
+
+#  include "task_intern.hh"
 #endif
 
 /* Task
@@ -111,15 +113,8 @@ class Task {
   Task &operator=(const Task &other) = delete;
   Task &operator=(Task &&other) = delete;
 
-  /* Execute task. */
-  void operator()() const
-  {
-#ifdef WITH_TBB
-    tbb::this_task_arena::isolate([this] { run(pool, taskdata); });
-#else
-    run(pool, taskdata);
-#endif
-  }
+  /* Execute task, unless the pool was canceled through its token. */
+  void operator()() const;
 };
 
 /* TBB Task Group.
@@ -131,14 +126,7 @@ class TBBTaskGroup : public tbb::task_group {
  public:
   TBBTaskGroup(TaskPriority priority)
   {
-    switch (priority) {
-      case TASK_PRIORITY_LOW:
-        my_context.set_priority(tbb::priority_low);
-        break;
-      case TASK_PRIORITY_HIGH:
-        my_context.set_priority(tbb::priority_normal);
-        break;
-    }
+    task_scheduler_context_priority_set(my_context, priority);
   }
 
   ~TBBTaskGroup()
@@ -164,6 +152,9 @@ struct TaskPool {
   ThreadMutex user_mutex;
   void *userdata;
 
+  /* Optional cancellation token, not owned by the pool. */
+  TaskCancelToken *cancel_token;
+
   /* TBB task pool. */
 #ifdef WITH_TBB
   TBBTaskGroup tbb_group;
@@ -177,6 +168,24 @@ struct TaskPool {
   volatile bool background_is_canceling;
 };
 
+static bool task_pool_token_canceled(const TaskPool *pool)
+{
+  return pool->cancel_token && BLI_task_cancel_token_is_canceled(pool->cancel_token);
+}
+
+void Task::operator()() const
+{
+  /* Skip tasks that did not start before cancellation, freeing happens as usual. */
+  if (task_pool_token_canceled(pool)) {
+    return;
+  }
+#ifdef WITH_TBB
+  tbb::this_task_arena::isolate([this] { run(pool, taskdata); });
+#else
+  run(pool, taskdata);
+#endif
+}
+
 /* TBB Task Pool.
  *
  * Task pool using the TBB scheduler for tasks. When building without TBB
@@ -522,6 +531,10 @@ void BLI_task_pool_cancel(TaskPool *pool)
 
 bool BLI_task_pool_canceled(TaskPool *pool)
 {
+  if (task_pool_token_canceled(pool)) {
+    return true;
+  }
+
   switch (pool->type) {
     case TASK_POOL_TBB:
     case TASK_POOL_TBB_SUSPENDED:
@@ -535,6 +548,11 @@ bool BLI_task_pool_canceled(TaskPool *pool)
   return false;
 }
 
+void BLI_task_pool_cancel_token_set(TaskPool *pool, TaskCancelToken *token)
+{
+  pool->cancel_token = token;
+}
+
 void *BLI_task_pool_user_data(TaskPool *pool)
 {
   return pool->userdata;
@@ -20,7 +20,12 @@
  * Task parallel range functions.
  */
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 
 #include "MEM_guardedalloc.h"
 
@@ -35,35 +40,117 @@
 /* Quiet top level deprecation message, unrelated to API usage here. */
 #  define TBB_SUPPRESS_DEPRECATED_MESSAGES 1
 #  include <tbb/tbb.h>
+
+#  include "task_intern.hh"
 #endif
 
 #ifdef WITH_TBB
 
+/* Adaptive Chunking
+ *
+ * The cost per iteration of each range function is measured while running it, and used the
+ * next time to give every task enough iterations to hide the scheduling overhead, or to not
+ * thread the range at all when it is cheaper than that overhead. Profiles live in a fixed size
+ * lock-free table, indexed by the function pointer. */
+
+/* Time a task should take, well above the overhead of scheduling it. */
+#  define RANGE_CHUNK_TARGET_NS 50000.0
+/* Ranges estimated to take less than this are run on the calling thread. */
+#  define RANGE_THREADING_MIN_NS 50000.0
+#  define RANGE_PROFILES_NUM 1024
+
+struct RangeProfile {
+  std::atomic<TaskParallelRangeFunc> func;
+  /* Running average of the cost of one iteration, 0 until measured. */
+  std::atomic<double> ns_per_iter;
+#  ifndef NDEBUG
+  std::atomic<int> grainsize;
+  std::atomic<int> num_calls;
+  std::atomic<int> num_calls_single_threaded;
+#  endif
+};
+
+static RangeProfile range_profiles[RANGE_PROFILES_NUM];
+
+/* Time spent in the tasks of a single range. */
+struct RangeStats {
+  std::atomic<int64_t> ns;
+  std::atomic<int64_t> iters;
+
+  RangeStats() : ns(0), iters(0)
+  {
+  }
+};
+
+static int64_t range_time_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/* Find or add the profile of the function, NULL when the table is full. */
+static RangeProfile *range_profile_ensure(TaskParallelRangeFunc func)
+{
+  const uintptr_t hash = ((uintptr_t)func >> 4) * 0x9E3779B1u;
+  for (int i = 0; i < RANGE_PROFILES_NUM; i++) {
+    RangeProfile &profile = range_profiles[(hash + i) % RANGE_PROFILES_NUM];
+    TaskParallelRangeFunc slot_func = profile.func.load(std::memory_order_acquire);
+    if (slot_func == nullptr &&
+        profile.func.compare_exchange_strong(slot_func, func, std::memory_order_acq_rel)) {
+      return &profile;
+    }
+    if (slot_func == func) {
+      return &profile;
+    }
+  }
+  return nullptr;
+}
+
+static void range_profile_update(RangeProfile *profile, const RangeStats &stats)
+{
+  if (stats.iters == 0) {
+    return;
+  }
+  const double ns_per_iter = (double)stats.ns / (double)stats.iters;
+  const double ns_per_iter_prev = profile->ns_per_iter.load(std::memory_order_relaxed);
+  /* Concurrent updates may get lost, which only delays adapting a little. */
+  profile->ns_per_iter.store((ns_per_iter_prev == 0.0) ?
+                                 ns_per_iter :
+                                 0.75 * ns_per_iter_prev + 0.25 * ns_per_iter,
+                             std::memory_order_relaxed);
+}
+
 /* Functor for running TBB parallel_for and parallel_reduce. */
 struct RangeTask {
   TaskParallelRangeFunc func;
   void *userdata;
   const TaskParallelSettings *settings;
+  /* Optional timing of the tasks, for adaptive chunking. */
+  RangeStats *stats;
 
   void *userdata_chunk;
 
   /* Root constructor. */
-  RangeTask(TaskParallelRangeFunc func, void *userdata, const TaskParallelSettings *settings)
-      : func(func), userdata(userdata), settings(settings)
+  RangeTask(TaskParallelRangeFunc func,
+            void *userdata,
+            const TaskParallelSettings *settings,
+            RangeStats *stats)
+      : func(func), userdata(userdata), settings(settings), stats(stats)
   {
     init_chunk(settings->userdata_chunk);
   }
 
   /* Copy constructor. */
   RangeTask(const RangeTask &other)
-      : func(other.func), userdata(other.userdata), settings(other.settings)
+      : func(other.func), userdata(other.userdata), settings(other.settings), stats(other.stats)
   {
     init_chunk(settings->userdata_chunk);
   }
 
   /* Splitting constructor for parallel reduce. */
   RangeTask(RangeTask &other, tbb::split /* unused */)
-      : func(other.func), userdata(other.userdata), settings(other.settings)
+      : func(other.func), userdata(other.userdata), settings(other.settings), stats(other.stats)
   {
     init_chunk(settings->userdata_chunk);
   }
@@ -89,6 +176,7 @@ struct RangeTask {
 
   void operator()(const tbb::blocked_range<int> &r) const
   {
+    const int64_t start_ns = (stats) ? range_time_ns() : 0;
     tbb::this_task_arena::isolate([this, r] {
       TaskParallelTLS tls;
       tls.userdata_chunk = userdata_chunk;
@@ -96,6 +184,10 @@ struct RangeTask {
         func(userdata, i, &tls);
       }
     });
+    if (stats) {
+      stats->ns.fetch_add(range_time_ns() - start_ns, std::memory_order_relaxed);
+      stats->iters.fetch_add(r.size(), std::memory_order_relaxed);
+    }
   }
 
   void join(const RangeTask &other)
@@ -104,6 +196,86 @@ struct RangeTask {
   }
 };
 
+/**
+ * Split the range into one contiguous part per NUMA node, and process each part in the arena of
+ * its node. The parts only depend on the range, so loops over the same arrays access the same
+ * parts from the same node every time, which is also the node where memory that was first
+ * touched in such a loop got allocated.
+ */
+static void parallel_range_numa(const int start,
+                                const int stop,
+                                void *userdata,
+                                TaskParallelRangeFunc func,
+                                const TaskParallelSettings *settings,
+                                const size_t grainsize,
+                                RangeStats *stats)
+{
+  const int num_nodes = task_scheduler_numa_nodes_num();
+
+  int num_processors = 0;
+  for (int i = 0; i < num_nodes; i++) {
+    num_processors += task_scheduler_numa_node_processors(i);
+  }
+
+  std::vector<std::unique_ptr<RangeTask>> tasks(num_nodes);
+  std::vector<std::unique_ptr<tbb::task_group>> task_groups(num_nodes);
+
+  int node_start = start;
+  int node_processors_cumulative = 0;
+  for (int i = 0; i < num_nodes; i++) {
+    node_processors_cumulative += task_scheduler_numa_node_processors(i);
+    const int node_stop = start + (int)((int64_t)(stop - start) * node_processors_cumulative /
+                                        num_processors);
+    if (node_start == node_stop) {
+      continue;
+    }
+
+    tasks[i] = std::make_unique<RangeTask>(func, userdata, settings, stats);
+    RangeTask &task = *tasks[i];
+    task_groups[i] = std::make_unique<tbb::task_group>();
+    tbb::task_group &task_group = *task_groups[i];
+    const tbb::blocked_range<int> range(node_start, node_stop, grainsize);
+    task_scheduler_numa_node_arena(i).execute([&task_group, &task, range, settings]() {
+      task_group.run([&task, range, settings]() {
+        if (settings->func_reduce) {
+          parallel_reduce(range, task);
+        }
+        else {
+          parallel_for(range, task);
+        }
+      });
+    });
+    node_start = node_stop;
+  }
+
+  for (int i = 0; i < num_nodes; i++) {
+    if (!task_groups[i]) {
+      continue;
+    }
+    tbb::task_group &task_group = *task_groups[i];
+    task_scheduler_numa_node_arena(i).execute([&task_group]() { task_group.wait(); });
+  }
+
+  if (settings->func_reduce) {
+    /* Reduce in the order of the parts, like the reduction of a single range. */
+    RangeTask *task_reduce = nullptr;
+    for (int i = 0; i < num_nodes; i++) {
+      if (!tasks[i]) {
+        continue;
+      }
+      if (task_reduce == nullptr) {
+        task_reduce = tasks[i].get();
+      }
+      else {
+        task_reduce->join(*tasks[i]);
+      }
+    }
+    if (settings->userdata_chunk && task_reduce) {
+      memcpy(settings->userdata_chunk, task_reduce->userdata_chunk, settings->userdata_chunk_size);
+    }
+  }
+}
+
 #endif
 
 void BLI_task_parallel_range(const int start,
@@ -113,23 +285,67 @@ void BLI_task_parallel_range(const int start,
                              const TaskParallelSettings *settings)
 {
 #ifdef WITH_TBB
-  /* Multithreading. */
-  if (settings->use_threading && BLI_task_scheduler_num_threads() > 1) {
-    RangeTask task(func, userdata, settings);
-    const size_t grainsize = MAX2(settings->min_iter_per_thread, 1);
-    const tbb::blocked_range<int> range(start, stop, grainsize);
-
-    if (settings->func_reduce) {
-      parallel_reduce(range, task);
-      if (settings->userdata_chunk) {
-        memcpy(settings->userdata_chunk, task.userdata_chunk, settings->userdata_chunk_size);
+  RangeProfile *profile = nullptr;
+  RangeStats stats;
+  bool use_threading = settings->use_threading && BLI_task_scheduler_num_threads() > 1;
+  size_t grainsize = MAX2(settings->min_iter_per_thread, 1);
+
+  if (settings->use_adaptive_chunking && stop > start) {
+    profile = range_profile_ensure(func);
+  }
+  if (profile) {
+    const double ns_per_iter = profile->ns_per_iter.load(std::memory_order_relaxed);
+    if (ns_per_iter > 0.0) {
+      if (ns_per_iter * (stop - start) < RANGE_THREADING_MIN_NS) {
+        use_threading = false;
       }
+      /* Leave enough chunks for every thread to get one, even when iterations got more
+       * expensive since they were measured. */
+      const int64_t grainsize_target = (int64_t)(RANGE_CHUNK_TARGET_NS / ns_per_iter);
+      const int64_t grainsize_max = MAX2((stop - start) / BLI_task_scheduler_num_threads(), 1);
+      grainsize = (size_t)MAX2((int64_t)grainsize, MIN2(grainsize_target, grainsize_max));
+    }
+#  ifndef NDEBUG
+    profile->grainsize.store((int)grainsize, std::memory_order_relaxed);
+    profile->num_calls.fetch_add(1, std::memory_order_relaxed);
+    if (!use_threading) {
+      profile->num_calls_single_threaded.fetch_add(1, std::memory_order_relaxed);
+    }
+#  endif
+  }
+
+  /* Multithreading. */
+  if (use_threading) {
+    RangeStats *task_stats = (profile) ? &stats : nullptr;
+
+    if (task_scheduler_numa_nodes_num() > 1 &&
+        stop - start >= task_scheduler_numa_range_min_get()) {
+      parallel_range_numa(start, stop, userdata, func, settings, grainsize, task_stats);
     }
     else {
-      parallel_for(range, task);
+      RangeTask task(func, userdata, settings, task_stats);
+      const tbb::blocked_range<int> range(start, stop, grainsize);
+
+      /* The auto partitioner splits further when threads steal work, but never below the
+       * grain size. */
+      if (settings->func_reduce) {
+        parallel_reduce(range, task, tbb::auto_partitioner());
+        if (settings->userdata_chunk) {
+          memcpy(settings->userdata_chunk, task.userdata_chunk, settings->userdata_chunk_size);
+        }
+      }
+      else {
+        parallel_for(range, task, tbb::auto_partitioner());
+      }
+    }
+
+    if (profile) {
+      range_profile_update(profile, stats);
     }
     return;
   }
+
+  const int64_t start_ns = (profile) ? range_time_ns() : 0;
 #endif
 
   /* Single threaded. Nothing to reduce as everything is accumulated into the
@@ -142,8 +358,38 @@ void BLI_task_parallel_range(const int start,
   if (settings->func_free != NULL) {
     settings->func_free(userdata, settings->userdata_chunk);
   }
+
+#ifdef WITH_TBB
+  if (profile) {
+    stats.ns = range_time_ns() - start_ns;
+    stats.iters = stop - start;
+    range_profile_update(profile, stats);
+  }
+#endif
 }
 
+#ifndef NDEBUG
+void BLI_task_parallel_range_profile_print(void)
+{
+#  ifdef WITH_TBB
+  printf("Parallel range profiles:\n");
+  for (int i = 0; i < RANGE_PROFILES_NUM; i++) {
+    const RangeProfile &profile = range_profiles[i];
+    const TaskParallelRangeFunc func = profile.func.load(std::memory_order_acquire);
+    if (func == nullptr) {
+      continue;
+    }
+    printf("  %p: %.1f ns per iteration, grain size %d, %d calls (%d single threaded)\n",
+           (void *)func,
+           profile.ns_per_iter.load(std::memory_order_relaxed),
+           profile.grainsize.load(std::memory_order_relaxed),
+           profile.num_calls.load(std::memory_order_relaxed),
+           profile.num_calls_single_threaded.load(std::memory_order_relaxed));
+  }
+#  endif
+}
+#endif
+
 int BLI_task_parallel_thread_id(const TaskParallelTLS *UNUSED(tls))
 {
 #ifdef WITH_TBB
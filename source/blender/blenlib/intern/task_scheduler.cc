@@ -20,6 +20,8 @@
  * Task scheduler initialization.
  */
 
+#include <atomic>
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_task.h"
@@ -32,6 +34,10 @@
 #  if TBB_INTERFACE_VERSION_MAJOR >= 10
 #    define WITH_TBB_GLOBAL_CONTROL
 #  endif
+
+#  include "numaapi.h"
+
+#  include "task_intern.hh"
 #endif
 
 /* Task Scheduler */
@@ -41,6 +47,119 @@ static int task_scheduler_num_threads = 1;
 static tbb::global_control *task_scheduler_global_control = nullptr;
 #endif
 
+/* NUMA Nodes
+ *
+ * Each NUMA node gets its own arena, with as many threads as the node has processors. Worker
+ * threads are moved to the node when they join its arena, so the work executed in that arena
+ * stays close to the memory it first touched. */
+
+static bool task_scheduler_use_numa = false;
+static int task_scheduler_numa_range_min = 1 << 16;
+
+#ifdef WITH_TBB
+
+class NumaNodeObserver : public tbb::task_scheduler_observer {
+ private:
+  int node_;
+
+ public:
+  NumaNodeObserver(tbb::task_arena &arena, int node)
+      : tbb::task_scheduler_observer(arena), node_(node)
+  {
+    observe(true);
+  }
+
+  void on_scheduler_entry(bool is_worker) override
+  {
+    /* Threads calling into the arena only wait for its work, don't change their affinity. */
+    if (is_worker) {
+      numaAPI_RunThreadOnNode(node_);
+    }
+  }
+};
+
+struct NumaNodeArena {
+  int num_processors;
+  tbb::task_arena arena;
+  NumaNodeObserver observer;
+
+  NumaNodeArena(int node, int num_processors)
+      : num_processors(num_processors), arena(num_processors), observer(arena, node)
+  {
+  }
+
+  ~NumaNodeArena()
+  {
+    observer.observe(false);
+  }
+};
+
+static NumaNodeArena **task_scheduler_numa_arenas = nullptr;
+static int task_scheduler_numa_arenas_num = 0;
+
+static void task_scheduler_numa_init()
+{
+  if (!task_scheduler_use_numa || numaAPI_Initialize() != NUMAAPI_SUCCESS) {
+    return;
+  }
+
+  const int num_nodes = numaAPI_GetNumNodes();
+  if (num_nodes < 2) {
+    return;
+  }
+
+  task_scheduler_numa_arenas = (NumaNodeArena **)MEM_calloc_arrayN(
+      num_nodes, sizeof(*task_scheduler_numa_arenas), __func__);
+  for (int node = 0; node < num_nodes; node++) {
+    if (!numaAPI_IsNodeAvailable(node)) {
+      continue;
+    }
+    task_scheduler_numa_arenas[task_scheduler_numa_arenas_num++] = OBJECT_GUARDED_NEW(
+        NumaNodeArena, node, numaAPI_GetNumNodeProcessors(node));
+  }
+}
+
+static void task_scheduler_numa_exit()
+{
+  for (int i = 0; i < task_scheduler_numa_arenas_num; i++) {
+    OBJECT_GUARDED_DELETE(task_scheduler_numa_arenas[i], NumaNodeArena);
+  }
+  MEM_SAFE_FREE(task_scheduler_numa_arenas);
+  task_scheduler_numa_arenas_num = 0;
+}
+
+int task_scheduler_numa_nodes_num()
+{
+  return (task_scheduler_numa_arenas_num > 1) ? task_scheduler_numa_arenas_num : 0;
+}
+
+int task_scheduler_numa_range_min_get()
+{
+  return task_scheduler_numa_range_min;
+}
+
+int task_scheduler_numa_node_processors(int node_index)
+{
+  return task_scheduler_numa_arenas[node_index]->num_processors;
+}
+
+tbb::task_arena &task_scheduler_numa_node_arena(int node_index)
+{
+  return task_scheduler_numa_arenas[node_index]->arena;
+}
+
+#endif /* WITH_TBB */
+
+void BLI_task_scheduler_numa_set(bool use_numa)
+{
+  task_scheduler_use_numa = use_numa;
+}
+
+void BLI_task_scheduler_numa_range_min_set(int range_min)
+{
+  task_scheduler_numa_range_min = range_min;
+}
+
 void BLI_task_scheduler_init()
 {
 #ifdef WITH_TBB_GLOBAL_CONTROL
@@ -63,10 +182,17 @@ void BLI_task_scheduler_init()
 #else
   task_scheduler_num_threads = BLI_system_thread_count();
 #endif
+
+#ifdef WITH_TBB
+  task_scheduler_numa_init();
+#endif
 }
 
 void BLI_task_scheduler_exit()
 {
+#ifdef WITH_TBB
+  task_scheduler_numa_exit();
+#endif
 #ifdef WITH_TBB_GLOBAL_CONTROL
   OBJECT_GUARDED_DELETE(task_scheduler_global_control, tbb::global_control);
 #endif
@@ -76,3 +202,61 @@ int BLI_task_scheduler_num_threads()
 {
   return task_scheduler_num_threads;
 }
+
+/* Priorities */
+
+#ifdef WITH_TBB
+void task_scheduler_context_priority_set(tbb::task_group_context &context, TaskPriority priority)
+{
+  switch (priority) {
+    case TASK_PRIORITY_LOW:
+      context.set_priority(tbb::priority_low);
+      break;
+    case TASK_PRIORITY_HIGH:
+      context.set_priority(tbb::priority_normal);
+      break;
+    case TASK_PRIORITY_INTERACTIVE:
+      context.set_priority(tbb::priority_high);
+      break;
+  }
+}
+#endif
+
+/* Cancellation Token */
+
+struct TaskCancelToken {
+  std::atomic<bool> is_canceled;
+
+  TaskCancelToken() : is_canceled(false)
+  {
+  }
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("task_scheduler:TaskCancelToken")
+#endif
+};
+
+TaskCancelToken *BLI_task_cancel_token_create()
+{
+  return new TaskCancelToken();
+}
+
+void BLI_task_cancel_token_free(TaskCancelToken *token)
+{
+  delete token;
+}
+
+void BLI_task_cancel_token_cancel(TaskCancelToken *token)
+{
+  token->is_canceled.store(true, std::memory_order_release);
+}
+
+void BLI_task_cancel_token_reset(TaskCancelToken *token)
+{
+  token->is_canceled.store(false, std::memory_order_release);
+}
+
+bool BLI_task_cancel_token_is_canceled(const TaskCancelToken *token)
+{
+  return token->is_canceled.load(std::memory_order_acquire);
+}
@@ -25,15 +25,27 @@
  * \ingroup blenloader
  */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 struct Scene;
 struct GHash;
+struct MemFileChunkStore;
+struct MemFileDedupJob;
 
 typedef struct {
   void *next, *prev;
   const char *buf;
   /** Size in bytes. */
   unsigned int size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /**
+   * When true, this chunk is identical to the one of the previous step
+   * (it shares the memory with it).
+   *
+   * \note Chunk memory is owned by #MemFile.store, shared between all steps with the same
+   * content, this doesn't mean the memory is unique to this chunk when false.
+   */
   bool is_identical;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
@@ -46,7 +58,10 @@ typedef struct {
 
 typedef struct MemFile {
   ListBase chunks;
+  /** Size of the chunk memory added by this memfile (not shared with other memfiles). */
   size_t size;
+  /** Content addressed storage of the chunk memory, shared by consecutive undo steps. */
+  struct MemFileChunkStore *store;
 } MemFile;
 
 typedef struct MemFileWriteData {
@@ -58,6 +73,9 @@ typedef struct MemFileWriteData {
 
   /** Maps an ID session uuid to its first reference MemFileChunk, if existing. */
   struct GHash *id_session_uuid_mapping;
+
+  /** Changed chunks, looked up in #MemFile.store in the background once writing is done. */
+  struct MemFileDedupJob *dedup_job;
 } MemFileWriteData;
 
 typedef struct MemFileUndoData {
@@ -79,6 +97,8 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, unsigned
 extern void BLO_memfile_free(MemFile *memfile);
 extern void BLO_memfile_merge(MemFile *first, MemFile *second);
 extern void BLO_memfile_clear_future(MemFile *memfile);
+/* Wait for background processing of the memfile, needed before accessing its chunks. */
+extern void BLO_memfile_wait(MemFile *memfile);
 
 /* utilities */
 extern struct Main *BLO_memfile_main_get(struct MemFile *memfile,
@@ -86,4 +106,8 @@ extern struct Main *BLO_memfile_main_get(struct MemFile *memfile,
                                          struct Scene **r_scene);
 extern bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __BLO_UNDOFILE_H__ */
@@ -25,6 +25,10 @@
  * \brief external writefile function prototypes.
  */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 struct BlendThumbnail;
 struct Main;
 struct MemFile;
@@ -58,6 +62,14 @@ struct BlendFileWriteParams {
   /** On write, restore paths after editing them (see #BLO_WRITE_PATH_REMAP_RELATIVE). */
   uint use_save_as_copy : 1;
   uint use_userdef : 1;
+  /**
+   * Update the existing file in place, only writing the parts that changed.
+   * Only used for uncompressed files, without save versions.
+   *
+   * \note Unlike regular saving, the file is not written to a temporary file first,
+   * so it may be left damaged when writing fails.
+   */
+  uint use_incremental : 1;
   const struct BlendThumbnail *thumb;
 };
 
@@ -74,4 +86,8 @@ extern bool BLO_write_file_mem(struct Main *mainvar,
 
 /** \} */
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
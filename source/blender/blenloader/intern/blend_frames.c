@@ -0,0 +1,385 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup blenloader
+ *
+ * Encoding & decoding of single compressed frames, see `blend_frames.h` for the format.
+ *
+ * \note Functions here don't use any global state, so they can be called from worker threads.
+ */
+
+#include <string.h>
+
+#include "BLI_utildefines.h"
+
+#include "zlib.h"
+
+#include "blend_frames.h"
+
+/* Sub-field identifier of the gzip extra field, 'B' 'F' (blend frame). */
+#define FRAME_SUBFIELD_ID1 'B'
+#define FRAME_SUBFIELD_ID2 'F'
+#define FRAME_SUBFIELD_LEN 8
+
+/* Sub-field identifiers of the index ('B' 'I') & footer ('B' 'E') members. */
+#define INDEX_SUBFIELD_ID2 'I'
+#define FOOTER_SUBFIELD_ID2 'E'
+#define FOOTER_SUBFIELD_LEN 12
+
+/* Size of the gzip header excluding the extra field. */
+#define MEMBER_HEADER_SIZE 12
+/* Number of index entries that fit in a single gzip extra field (limited to 64kb). */
+#define INDEX_MEMBER_ENTRIES_MAX ((0xffff - 4) / 8)
+/* A raw deflate stream of no data: a single, final, fixed Huffman block. */
+static const uchar empty_deflate_stream[2] = {0x03, 0x00};
+
+/* Matches the "wb1" mode used for regular gzip writing. */
+#define FRAME_COMPRESS_LEVEL 1
+
+static void frame_uint32_encode(uchar *buf, const uint value)
+{
+  buf[0] = (uchar)(value & 0xff);
+  buf[1] = (uchar)((value >> 8) & 0xff);
+  buf[2] = (uchar)((value >> 16) & 0xff);
+  buf[3] = (uchar)((value >> 24) & 0xff);
+}
+
+static uint frame_uint32_decode(const uchar *buf)
+{
+  return ((uint)buf[0]) | ((uint)buf[1] << 8) | ((uint)buf[2] << 16) | ((uint)buf[3] << 24);
+}
+
+static void member_header_encode(uchar *header, const uint extra_len)
+{
+  header[0] = 0x1f;              /* ID1. */
+  header[1] = 0x8b;              /* ID2. */
+  header[2] = 8;                 /* CM: deflate. */
+  header[3] = 4;                 /* FLG: FEXTRA. */
+  memset(&header[4], 0, 4);      /* MTIME. */
+  header[8] = 0;                 /* XFL. */
+  header[9] = 0xff;              /* OS: unknown. */
+  header[10] = extra_len & 0xff; /* XLEN. */
+  header[11] = (extra_len >> 8) & 0xff;
+}
+
+/**
+ * Write a gzip member without any compressed data, storing \a subfield_len bytes
+ * in a sub-field of the extra field (which are expected to be written by the caller).
+ *
+ * \return The start of the sub-field data.
+ */
+static uchar *member_empty_encode(uchar *buf, const char subfield_id2, const uint subfield_len)
+{
+  member_header_encode(buf, subfield_len + 4);
+  buf[12] = FRAME_SUBFIELD_ID1;
+  buf[13] = (uchar)subfield_id2;
+  buf[14] = subfield_len & 0xff;
+  buf[15] = (subfield_len >> 8) & 0xff;
+
+  uchar *trailer = &buf[MEMBER_HEADER_SIZE + 4 + subfield_len];
+  memcpy(trailer, empty_deflate_stream, sizeof(empty_deflate_stream));
+  /* CRC32 & size of no data. */
+  memset(trailer + sizeof(empty_deflate_stream), 0, BLO_FRAME_TRAILER_SIZE);
+
+  return &buf[16];
+}
+
+/**
+ * Decode a gzip member written by #member_empty_encode.
+ *
+ * \return The start of the sub-field data or NULL when the member isn't valid.
+ */
+static const uchar *member_empty_decode(const uchar *buf,
+                                        const size_t buf_len,
+                                        const char subfield_id2,
+                                        uint *r_subfield_len,
+                                        size_t *r_member_len)
+{
+  if (buf_len < MEMBER_HEADER_SIZE + 4) {
+    return NULL;
+  }
+  if (!(buf[0] == 0x1f && buf[1] == 0x8b && buf[2] == 8 && buf[3] == 4)) {
+    return NULL;
+  }
+  if (!(buf[12] == FRAME_SUBFIELD_ID1 && buf[13] == (uchar)subfield_id2)) {
+    return NULL;
+  }
+  const uint extra_len = (uint)buf[10] | ((uint)buf[11] << 8);
+  const uint subfield_len = (uint)buf[14] | ((uint)buf[15] << 8);
+  const size_t member_len = MEMBER_HEADER_SIZE + extra_len + sizeof(empty_deflate_stream) +
+                            BLO_FRAME_TRAILER_SIZE;
+  if ((extra_len != subfield_len + 4) || (member_len > buf_len)) {
+    return NULL;
+  }
+  if (memcmp(&buf[MEMBER_HEADER_SIZE + extra_len],
+             empty_deflate_stream,
+             sizeof(empty_deflate_stream)) != 0) {
+    return NULL;
+  }
+
+  *r_subfield_len = subfield_len;
+  *r_member_len = member_len;
+  return &buf[16];
+}
+
+static void frame_header_encode(uchar header[BLO_FRAME_HEADER_SIZE],
+                                const uint frame_len,
+                                const uint data_len)
+{
+  member_header_encode(header, FRAME_SUBFIELD_LEN + 4);
+  header[8] = 4; /* XFL: fastest algorithm. */
+  header[12] = FRAME_SUBFIELD_ID1;
+  header[13] = FRAME_SUBFIELD_ID2;
+  header[14] = FRAME_SUBFIELD_LEN;
+  header[15] = 0;
+  frame_uint32_encode(&header[16], frame_len);
+  frame_uint32_encode(&header[20], data_len);
+}
+
+/**
+ * \return The maximum size of a frame holding \a data_len uncompressed bytes.
+ */
+size_t blo_frame_compress_bound(size_t data_len)
+{
+  return BLO_FRAME_HEADER_SIZE + compressBound((uLong)data_len) + BLO_FRAME_TRAILER_SIZE;
+}
+
+/**
+ * Compress \a data into a single self-contained gzip member.
+ *
+ * \param r_frame: Destination, must be at least #blo_frame_compress_bound bytes.
+ * \return The size of the frame or zero on failure.
+ */
+size_t blo_frame_compress(const void *data, size_t data_len, void *r_frame, size_t frame_len_max)
+{
+  uchar *frame = r_frame;
+  z_stream strm = {NULL};
+
+  BLI_assert(data_len <= BLO_FRAME_DATA_SIZE);
+  if (frame_len_max < BLO_FRAME_HEADER_SIZE + BLO_FRAME_TRAILER_SIZE) {
+    return 0;
+  }
+
+  /* Negative window bits for a raw deflate stream, the gzip wrapping is written here. */
+  if (deflateInit2(
+          &strm, FRAME_COMPRESS_LEVEL, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return 0;
+  }
+
+  strm.next_in = (Bytef *)data;
+  strm.avail_in = (uInt)data_len;
+  strm.next_out = frame + BLO_FRAME_HEADER_SIZE;
+  strm.avail_out = (uInt)(frame_len_max - BLO_FRAME_HEADER_SIZE - BLO_FRAME_TRAILER_SIZE);
+
+  const int err = deflate(&strm, Z_FINISH);
+  const size_t stream_len = strm.total_out;
+  deflateEnd(&strm);
+
+  if (err != Z_STREAM_END) {
+    return 0;
+  }
+
+  const size_t frame_len = BLO_FRAME_HEADER_SIZE + stream_len + BLO_FRAME_TRAILER_SIZE;
+  const uint crc = (uint)crc32(crc32(0L, Z_NULL, 0), data, (uInt)data_len);
+
+  frame_header_encode(frame, (uint)frame_len, (uint)data_len);
+  frame_uint32_encode(&frame[frame_len - 8], crc);
+  frame_uint32_encode(&frame[frame_len - 4], (uint)data_len);
+
+  return frame_len;
+}
+
+/**
+ * Check \a header is the start of a frame and extract the sizes stored in it.
+ *
+ * \return false when this isn't a frame (a regular gzip stream for e.g.).
+ */
+bool blo_frame_header_decode(const uchar header[BLO_FRAME_HEADER_SIZE],
+                             uint *r_frame_len,
+                             uint *r_data_len)
+{
+  if (!(header[0] == 0x1f && header[1] == 0x8b && header[2] == 8 && header[3] == 4)) {
+    return false;
+  }
+  if (!(header[10] == FRAME_SUBFIELD_LEN + 4 && header[11] == 0)) {
+    return false;
+  }
+  if (!(header[12] == FRAME_SUBFIELD_ID1 && header[13] == FRAME_SUBFIELD_ID2 &&
+        header[14] == FRAME_SUBFIELD_LEN && header[15] == 0)) {
+    return false;
+  }
+
+  const uint frame_len = frame_uint32_decode(&header[16]);
+  const uint data_len = frame_uint32_decode(&header[20]);
+
+  if ((frame_len < BLO_FRAME_HEADER_SIZE + BLO_FRAME_TRAILER_SIZE) ||
+      (data_len > BLO_FRAME_DATA_SIZE)) {
+    return false;
+  }
+
+  *r_frame_len = frame_len;
+  *r_data_len = data_len;
+  return true;
+}
+
+/**
+ * Decompress a whole frame (as returned by #blo_frame_compress)
+ * into \a r_data, which must be exactly the uncompressed size stored in the header.
+ */
+bool blo_frame_decompress(const void *frame_v, size_t frame_len, void *r_data, size_t data_len)
+{
+  const uchar *frame = frame_v;
+  z_stream strm = {NULL};
+
+  if (frame_len < BLO_FRAME_HEADER_SIZE + BLO_FRAME_TRAILER_SIZE) {
+    return false;
+  }
+
+  if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+    return false;
+  }
+
+  strm.next_in = (Bytef *)(frame + BLO_FRAME_HEADER_SIZE);
+  strm.avail_in = (uInt)(frame_len - BLO_FRAME_HEADER_SIZE - BLO_FRAME_TRAILER_SIZE);
+  strm.next_out = r_data;
+  strm.avail_out = (uInt)data_len;
+
+  const int err = inflate(&strm, Z_FINISH);
+  const size_t total_out = strm.total_out;
+  inflateEnd(&strm);
+
+  if ((err != Z_STREAM_END) || (total_out != data_len)) {
+    return false;
+  }
+
+  const uint crc = (uint)crc32(crc32(0L, Z_NULL, 0), r_data, (uInt)data_len);
+  if ((crc != frame_uint32_decode(&frame[frame_len - 8])) ||
+      ((uint)data_len != frame_uint32_decode(&frame[frame_len - 4]))) {
+    return false;
+  }
+
+  return true;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Frame Index
+ * \{ */
+
+/**
+ * \return The number of bytes needed to store an index of \a entries_len frames.
+ */
+size_t blo_frame_index_encode_len(const uint entries_len)
+{
+  const uint members_len = (entries_len + INDEX_MEMBER_ENTRIES_MAX - 1) /
+                           INDEX_MEMBER_ENTRIES_MAX;
+  return (size_t)members_len * (MEMBER_HEADER_SIZE + 4 + sizeof(empty_deflate_stream) +
+                                BLO_FRAME_TRAILER_SIZE) +
+         (size_t)entries_len * 8;
+}
+
+/**
+ * Store the index as a sequence of gzip members,
+ * \a r_buf must be #blo_frame_index_encode_len bytes.
+ */
+void blo_frame_index_encode(const BLOFrameIndexEntry *entries,
+                            const uint entries_len,
+                            uchar *r_buf)
+{
+  uint entries_done = 0;
+
+  while (entries_done < entries_len) {
+    const uint member_entries_len = MIN2(entries_len - entries_done, INDEX_MEMBER_ENTRIES_MAX);
+    uchar *data = member_empty_encode(r_buf, INDEX_SUBFIELD_ID2, member_entries_len * 8);
+    for (uint i = 0; i < member_entries_len; i++) {
+      frame_uint32_encode(&data[i * 8], entries[entries_done + i].frame_len);
+      frame_uint32_encode(&data[i * 8 + 4], entries[entries_done + i].data_len);
+    }
+    r_buf = data + member_entries_len * 8 + sizeof(empty_deflate_stream) +
+            BLO_FRAME_TRAILER_SIZE;
+    entries_done += member_entries_len;
+  }
+}
+
+/**
+ * Read an index written by #blo_frame_index_encode,
+ * the number of entries is known from the footer.
+ */
+bool blo_frame_index_decode(const uchar *buf,
+                            const size_t buf_len,
+                            BLOFrameIndexEntry *r_entries,
+                            const uint entries_len)
+{
+  size_t buf_used = 0;
+  uint entries_done = 0;
+
+  while (entries_done < entries_len) {
+    uint subfield_len;
+    size_t member_len;
+    const uchar *data = member_empty_decode(
+        buf + buf_used, buf_len - buf_used, INDEX_SUBFIELD_ID2, &subfield_len, &member_len);
+    if ((data == NULL) || (subfield_len % 8 != 0) ||
+        (subfield_len / 8 > entries_len - entries_done)) {
+      return false;
+    }
+    for (uint i = 0; i < subfield_len / 8; i++) {
+      BLOFrameIndexEntry *entry = &r_entries[entries_done++];
+      entry->frame_len = frame_uint32_decode(&data[i * 8]);
+      entry->data_len = frame_uint32_decode(&data[i * 8 + 4]);
+      if ((entry->frame_len < BLO_FRAME_HEADER_SIZE + BLO_FRAME_TRAILER_SIZE) ||
+          (entry->data_len > BLO_FRAME_DATA_SIZE)) {
+        return false;
+      }
+    }
+    buf_used += member_len;
+  }
+
+  return true;
+}
+
+/**
+ * The footer stores the file offset of the index and the number of frames.
+ */
+void blo_frame_footer_encode(uchar r_footer[BLO_FRAME_FOOTER_SIZE],
+                             const uint64_t index_offset,
+                             const uint entries_len)
+{
+  uchar *data = member_empty_encode(r_footer, FOOTER_SUBFIELD_ID2, FOOTER_SUBFIELD_LEN);
+  frame_uint32_encode(&data[0], (uint)(index_offset & 0xffffffff));
+  frame_uint32_encode(&data[4], (uint)(index_offset >> 32));
+  frame_uint32_encode(&data[8], entries_len);
+}
+
+bool blo_frame_footer_decode(const uchar footer[BLO_FRAME_FOOTER_SIZE],
+                             uint64_t *r_index_offset,
+                             uint *r_entries_len)
+{
+  uint subfield_len;
+  size_t member_len;
+  const uchar *data = member_empty_decode(
+      footer, BLO_FRAME_FOOTER_SIZE, FOOTER_SUBFIELD_ID2, &subfield_len, &member_len);
+  if ((data == NULL) || (subfield_len != FOOTER_SUBFIELD_LEN) ||
+      (member_len != BLO_FRAME_FOOTER_SIZE)) {
+    return false;
+  }
+
+  *r_index_offset = (uint64_t)frame_uint32_decode(&data[0]) |
+                    ((uint64_t)frame_uint32_decode(&data[4]) << 32);
+  *r_entries_len = frame_uint32_decode(&data[8]);
+  return true;
+}
+
+/** \} */
@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BLEND_FRAMES_H__
+#define __BLEND_FRAMES_H__
+
+/** \file
+ * \ingroup blenloader
+ *
+ * Framed compression for blend-files.
+ *
+ * The file is split into independent gzip members ("frames") of at most
+ * #BLO_FRAME_DATA_SIZE uncompressed bytes each. Every member stores its own compressed and
+ * uncompressed size in a gzip extra sub-field, so frames can be located without inflating
+ * anything and compressed/decompressed in parallel.
+ *
+ * After the last frame an index is written, mapping frames to their file & data offsets,
+ * followed by a fixed size footer which points to the start of the index.
+ * This allows to seek in the uncompressed data, only decompressing the frames that are needed.
+ * The index and footer are gzip members too (storing their data in the extra field,
+ * with no compressed content), so they don't add anything to the uncompressed stream.
+ *
+ * Since a sequence of gzip members is itself a valid gzip stream,
+ * framed files remain readable by older Blender versions and by regular gzip tools.
+ */
+
+#include "BLI_sys_types.h"
+
+/** Maximum number of uncompressed bytes stored in a single frame. */
+#define BLO_FRAME_DATA_SIZE (1 << 20)
+
+/**
+ * Size of the gzip member header of a frame:
+ * 10 bytes fixed header, 2 bytes extra length, 4 bytes sub-field header
+ * and 8 bytes of sub-field data (compressed & uncompressed size).
+ */
+#define BLO_FRAME_HEADER_SIZE 24
+/** Size of the gzip member trailer (CRC32 & uncompressed size). */
+#define BLO_FRAME_TRAILER_SIZE 8
+/** Size of the footer, the last gzip member of the file. */
+#define BLO_FRAME_FOOTER_SIZE 38
+
+/** Sizes of a single frame, as stored in the index. */
+typedef struct BLOFrameIndexEntry {
+  uint frame_len;
+  uint data_len;
+} BLOFrameIndexEntry;
+
+size_t blo_frame_compress_bound(size_t data_len);
+size_t blo_frame_compress(const void *data, size_t data_len, void *r_frame, size_t frame_len_max);
+
+bool blo_frame_header_decode(const uchar header[BLO_FRAME_HEADER_SIZE],
+                             uint *r_frame_len,
+                             uint *r_data_len);
+bool blo_frame_decompress(const void *frame, size_t frame_len, void *r_data, size_t data_len);
+
+size_t blo_frame_index_encode_len(const uint entries_len);
+void blo_frame_index_encode(const BLOFrameIndexEntry *entries,
+                            const uint entries_len,
+                            uchar *r_buf);
+bool blo_frame_index_decode(const uchar *buf,
+                            const size_t buf_len,
+                            BLOFrameIndexEntry *r_entries,
+                            const uint entries_len);
+
+void blo_frame_footer_encode(uchar r_footer[BLO_FRAME_FOOTER_SIZE],
+                             const uint64_t index_offset,
+                             const uint entries_len);
+bool blo_frame_footer_decode(const uchar footer[BLO_FRAME_FOOTER_SIZE],
+                             uint64_t *r_index_offset,
+                             uint *r_entries_len);
+
+#endif /* __BLEND_FRAMES_H__ */
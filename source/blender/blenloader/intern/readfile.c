@@ -100,6 +100,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.h"
 #include "BLI_blenlib.h"
 #include "BLI_endian_switch.h"
 #include "BLI_ghash.h"
@@ -107,6 +108,8 @@
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BLT_translation.h"
@@ -135,6 +138,7 @@
 #include "BKE_lib_query.h"
 #include "BKE_main.h"  // for Main
 #include "BKE_main_idmap.h"
+#include "BKE_main_namemap.h"
 #include "BKE_material.h"
 #include "BKE_mesh.h"  // for ME_ defines (patching)
 #include "BKE_mesh_runtime.h"
@@ -172,6 +176,7 @@
 
 #include "engines/eevee/eevee_lightcache.h"
 
+#include "blend_frames.h"
 #include "readfile.h"
 
 #include <errno.h>
@@ -523,6 +528,8 @@ static void add_main_to_main(Main *mainvar, Main *from)
   while (a--) {
     BLI_movelisttolist(lbarray[a], fromarray[a]);
   }
+  BKE_main_namemap_clear(mainvar);
+  BKE_main_namemap_clear(from);
 }
 
 void blo_join_main(ListBase *mainlist)
@@ -1196,6 +1203,76 @@ static off64_t fd_seek_data_from_file(FileData *filedata, off64_t offset, int wh
   return filedata->file_offset;
 }
 
+/* Memory mapped file reading. */
+
+static int fd_read_from_mmap(FileData *filedata,
+                             void *buffer,
+                             uint size,
+                             bool *UNUSED(r_is_memchunck_identical))
+{
+  /* Don't read more bytes than there are available in the file. */
+  const size_t length = BLI_mmap_get_length(filedata->mmap_file);
+  const size_t readsize = MIN2(size, length - (size_t)filedata->file_offset);
+
+  if (!BLI_mmap_read(filedata->mmap_file, buffer, (size_t)filedata->file_offset, readsize)) {
+    return 0;
+  }
+
+  filedata->file_offset += readsize;
+
+  return readsize;
+}
+
+static off64_t fd_seek_from_mmap(FileData *filedata, off64_t offset, int whence)
+{
+  const off64_t length = (off64_t)BLI_mmap_get_length(filedata->mmap_file);
+  off64_t new_pos;
+  if (whence == SEEK_CUR) {
+    new_pos = filedata->file_offset + offset;
+  }
+  else if (whence == SEEK_SET) {
+    new_pos = offset;
+  }
+  else if (whence == SEEK_END) {
+    new_pos = length + offset;
+  }
+  else {
+    return -1;
+  }
+
+  if (new_pos < 0 || new_pos > length) {
+    return -1;
+  }
+  filedata->file_offset = new_pos;
+  return filedata->file_offset;
+}
+
+/**
+ * Return the data of a block that was delayed by #USE_BHEAD_READ_ON_DEMAND
+ * directly from the memory mapped file, or NULL when the file isn't mapped.
+ */
+static const void *fd_mmap_bhead_data(FileData *fd, BHead *bhead)
+{
+  if (fd->mmap_file == NULL) {
+    return NULL;
+  }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  const BHeadN *new_bhead = BHEADN_FROM_BHEAD(bhead);
+  if (new_bhead->has_data) {
+    return NULL;
+  }
+  const size_t length = BLI_mmap_get_length(fd->mmap_file);
+  const size_t offset = (size_t)new_bhead->file_offset;
+  if (offset > length || (size_t)bhead->len > length - offset) {
+    return NULL;
+  }
+  return POINTER_OFFSET(BLI_mmap_get_pointer(fd->mmap_file), offset);
+#else
+  UNUSED_VARS(bhead);
+  return NULL;
+#endif
+}
+
 /* GZip file reading. */
 
 static int fd_read_gzip_from_file(FileData *filedata,
@@ -1215,6 +1292,315 @@ static int fd_read_gzip_from_file(FileData *filedata,
   return (readsize);
 }
 
+/* Framed GZip file reading (multi-threaded), see `blend_frames.h`. */
+
+typedef struct FileDataFrame {
+  /** Compressed gzip member, allocation is reused for subsequent frames. */
+  uchar *frame;
+  size_t frame_len;
+  size_t frame_len_alloc;
+  /** Uncompressed data, #BLO_FRAME_DATA_SIZE bytes. */
+  uchar *data;
+  size_t data_len;
+  bool is_valid;
+} FileDataFrame;
+
+typedef struct FileDataFrames {
+  TaskPool *task_pool;
+
+  /** Frames that are read ahead and decompressed in parallel. */
+  FileDataFrame *queue;
+  int queue_len;
+  int queue_len_max;
+  /** Number of frames to read ahead, grows while reading sequentially, reset when seeking. */
+  int read_ahead_len;
+
+  /** Frame in #FileDataFrames.queue and offset in its data, for the next read. */
+  int queue_index;
+  size_t data_offset;
+
+  /**
+   * Frame index (NULL for files written without one), the data & file offsets of each frame,
+   * with an extra item at the end for the total size.
+   */
+  off64_t *index_data_offset;
+  off64_t *index_file_offset;
+  uint index_len;
+  /** Index of the first frame in the queue and of the next frame to read from the file. */
+  uint queue_frame_first;
+  uint frame_next;
+  /** Offset within the first frame read after seeking. */
+  size_t seek_data_offset;
+
+  bool is_eof;
+} FileDataFrames;
+
+static void fd_frame_decompress_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  FileDataFrame *fdf = taskdata;
+  fdf->is_valid = blo_frame_decompress(fdf->frame, fdf->frame_len, fdf->data, fdf->data_len);
+}
+
+/**
+ * Read the compressed frame at the current file position into \a fdf.
+ */
+static bool fd_frame_read(FileData *filedata, FileDataFrame *fdf)
+{
+  uchar header[BLO_FRAME_HEADER_SIZE];
+  uint frame_len, data_len;
+
+  if (read(filedata->filedes, header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  if (!blo_frame_header_decode(header, &frame_len, &data_len)) {
+    return false;
+  }
+
+  if (fdf->frame_len_alloc < frame_len) {
+    MEM_SAFE_FREE(fdf->frame);
+    fdf->frame = MEM_mallocN(frame_len, __func__);
+    fdf->frame_len_alloc = frame_len;
+  }
+  if (fdf->data == NULL) {
+    fdf->data = MEM_mallocN(BLO_FRAME_DATA_SIZE, __func__);
+  }
+
+  memcpy(fdf->frame, header, sizeof(header));
+  const int rest_len = (int)(frame_len - sizeof(header));
+  if (read(filedata->filedes, fdf->frame + sizeof(header), rest_len) != rest_len) {
+    return false;
+  }
+
+  fdf->frame_len = frame_len;
+  fdf->data_len = data_len;
+  fdf->is_valid = false;
+  return true;
+}
+
+/**
+ * Read ahead frames and decompress them in parallel.
+ *
+ * \param size_hint: The number of bytes that are about to be read,
+ * at least as many frames are read as needed for it (limited by the queue size).
+ */
+static void fd_frames_queue_fill(FileData *filedata, const size_t size_hint)
+{
+  FileDataFrames *fdfs = filedata->frames;
+
+  fdfs->queue_frame_first = fdfs->frame_next;
+  fdfs->queue_len = 0;
+  fdfs->queue_index = 0;
+  fdfs->data_offset = fdfs->seek_data_offset;
+  fdfs->seek_data_offset = 0;
+
+  const size_t frames_needed = (fdfs->data_offset + size_hint + BLO_FRAME_DATA_SIZE - 1) /
+                               BLO_FRAME_DATA_SIZE;
+  int frames_len = (int)MIN2(frames_needed, (size_t)fdfs->queue_len_max);
+  frames_len = max_ii(frames_len, fdfs->read_ahead_len);
+  fdfs->read_ahead_len = min_ii(fdfs->queue_len_max, fdfs->read_ahead_len * 2);
+
+  while ((fdfs->is_eof == false) && (fdfs->queue_len < frames_len)) {
+    FileDataFrame *fdf = &fdfs->queue[fdfs->queue_len];
+    if ((fdfs->index_data_offset && (fdfs->frame_next == fdfs->index_len)) ||
+        !fd_frame_read(filedata, fdf)) {
+      /* End of file, or trailing data which isn't a frame. */
+      fdfs->is_eof = true;
+      break;
+    }
+    BLI_task_pool_push(fdfs->task_pool, fd_frame_decompress_task, fdf, false, NULL);
+    fdfs->queue_len++;
+    fdfs->frame_next++;
+  }
+
+  BLI_task_pool_work_and_wait(fdfs->task_pool);
+}
+
+static int fd_read_gzip_frames_from_file(FileData *filedata,
+                                         void *buffer,
+                                         uint size,
+                                         bool *UNUSED(r_is_memchunck_identical))
+{
+  FileDataFrames *fdfs = filedata->frames;
+  uint readsize = 0;
+
+  while (readsize < size) {
+    if (fdfs->queue_index == fdfs->queue_len) {
+      if (fdfs->is_eof) {
+        break;
+      }
+      fd_frames_queue_fill(filedata, size - readsize);
+      continue;
+    }
+
+    FileDataFrame *fdf = &fdfs->queue[fdfs->queue_index];
+    if (fdf->is_valid == false) {
+      printf("fd_read_gzip_frames_from_file: zlib error\n");
+      return EOF;
+    }
+
+    const size_t len = MIN2(size - readsize, fdf->data_len - fdfs->data_offset);
+    memcpy(POINTER_OFFSET(buffer, readsize), fdf->data + fdfs->data_offset, len);
+    readsize += (uint)len;
+    fdfs->data_offset += len;
+
+    if (fdfs->data_offset == fdf->data_len) {
+      fdfs->queue_index++;
+      fdfs->data_offset = 0;
+    }
+  }
+
+  filedata->file_offset += readsize;
+
+  return (int)readsize;
+}
+
+/**
+ * Seeking only decompresses the frame containing the new offset (on the next read),
+ * frames which are skipped over are never decompressed.
+ */
+static off64_t fd_seek_gzip_frames_from_file(FileData *filedata, off64_t offset, int whence)
+{
+  FileDataFrames *fdfs = filedata->frames;
+  const off64_t data_len = fdfs->index_data_offset[fdfs->index_len];
+
+  if (whence == SEEK_CUR) {
+    offset += filedata->file_offset;
+  }
+  else if (whence == SEEK_END) {
+    offset += data_len;
+  }
+  if ((offset < 0) || (offset > data_len)) {
+    return -1;
+  }
+
+  /* Binary search for the frame containing the offset (the extra item for the end). */
+  uint frame_min = 0, frame_max = fdfs->index_len;
+  while (frame_min < frame_max) {
+    const uint frame_mid = frame_min + (frame_max - frame_min + 1) / 2;
+    if (fdfs->index_data_offset[frame_mid] <= offset) {
+      frame_min = frame_mid;
+    }
+    else {
+      frame_max = frame_mid - 1;
+    }
+  }
+  const uint frame = frame_min;
+
+  if ((frame >= fdfs->queue_frame_first) &&
+      (frame < fdfs->queue_frame_first + (uint)fdfs->queue_len)) {
+    /* Already decompressed. */
+    fdfs->queue_index = (int)(frame - fdfs->queue_frame_first);
+    fdfs->data_offset = (size_t)(offset - fdfs->index_data_offset[frame]);
+  }
+  else {
+    if (BLI_lseek(filedata->filedes, fdfs->index_file_offset[frame], SEEK_SET) == -1) {
+      return -1;
+    }
+    fdfs->queue_len = 0;
+    fdfs->queue_index = 0;
+    fdfs->frame_next = frame;
+    fdfs->seek_data_offset = (size_t)(offset - fdfs->index_data_offset[frame]);
+    fdfs->read_ahead_len = 1;
+    fdfs->is_eof = false;
+  }
+
+  filedata->file_offset = offset;
+  return offset;
+}
+
+/**
+ * Read the frame index from the end of the file, when there is none,
+ * only sequential reading is supported.
+ */
+static void fd_frames_index_read(FileData *filedata)
+{
+  FileDataFrames *fdfs = filedata->frames;
+  const int file = filedata->filedes;
+  uchar footer[BLO_FRAME_FOOTER_SIZE];
+  uint64_t index_offset;
+  uint index_len;
+
+  const off64_t file_len = BLI_lseek(file, 0, SEEK_END);
+  if ((file_len < BLO_FRAME_FOOTER_SIZE) ||
+      (BLI_lseek(file, file_len - BLO_FRAME_FOOTER_SIZE, SEEK_SET) == -1) ||
+      (read(file, footer, sizeof(footer)) != sizeof(footer)) ||
+      !blo_frame_footer_decode(footer, &index_offset, &index_len)) {
+    BLI_lseek(file, 0, SEEK_SET);
+    return;
+  }
+
+  const off64_t index_buf_len = file_len - BLO_FRAME_FOOTER_SIZE - (off64_t)index_offset;
+  if ((index_len == 0) || (index_buf_len != (off64_t)blo_frame_index_encode_len(index_len)) ||
+      (BLI_lseek(file, (off64_t)index_offset, SEEK_SET) == -1)) {
+    BLI_lseek(file, 0, SEEK_SET);
+    return;
+  }
+
+  uchar *index_buf = MEM_mallocN((size_t)index_buf_len, __func__);
+  BLOFrameIndexEntry *entries = MEM_mallocN(sizeof(*entries) * index_len, __func__);
+  bool ok = (read(file, index_buf, (size_t)index_buf_len) == index_buf_len) &&
+            blo_frame_index_decode(index_buf, (size_t)index_buf_len, entries, index_len);
+
+  if (ok) {
+    fdfs->index_data_offset = MEM_mallocN(sizeof(off64_t) * (index_len + 1), __func__);
+    fdfs->index_file_offset = MEM_mallocN(sizeof(off64_t) * (index_len + 1), __func__);
+    fdfs->index_data_offset[0] = 0;
+    fdfs->index_file_offset[0] = 0;
+    for (uint i = 0; i < index_len; i++) {
+      fdfs->index_data_offset[i + 1] = fdfs->index_data_offset[i] + entries[i].data_len;
+      fdfs->index_file_offset[i + 1] = fdfs->index_file_offset[i] + entries[i].frame_len;
+    }
+    /* The frames must end exactly where the index starts. */
+    if (fdfs->index_file_offset[index_len] == (off64_t)index_offset) {
+      fdfs->index_len = index_len;
+      /* Start small, so reading the file header doesn't decompress frames that may be skipped. */
+      fdfs->read_ahead_len = 1;
+    }
+    else {
+      MEM_SAFE_FREE(fdfs->index_data_offset);
+      MEM_SAFE_FREE(fdfs->index_file_offset);
+    }
+  }
+
+  MEM_freeN(entries);
+  MEM_freeN(index_buf);
+
+  BLI_lseek(file, 0, SEEK_SET);
+}
+
+static void fd_frames_init(FileData *filedata)
+{
+  FileDataFrames *fdfs = MEM_callocN(sizeof(*fdfs), __func__);
+  fdfs->task_pool = BLI_task_pool_create(NULL, TASK_PRIORITY_HIGH);
+  fdfs->queue_len_max = max_ii(2, BLI_task_scheduler_num_threads() * 2);
+  fdfs->queue = MEM_callocN(sizeof(*fdfs->queue) * fdfs->queue_len_max, __func__);
+  fdfs->read_ahead_len = fdfs->queue_len_max;
+
+  filedata->frames = fdfs;
+
+  fd_frames_index_read(filedata);
+  if (fdfs->index_data_offset != NULL) {
+    filedata->seek = fd_seek_gzip_frames_from_file;
+  }
+}
+
+static void fd_frames_free(FileData *filedata)
+{
+  FileDataFrames *fdfs = filedata->frames;
+
+  BLI_task_pool_free(fdfs->task_pool);
+  for (int i = 0; i < fdfs->queue_len_max; i++) {
+    MEM_SAFE_FREE(fdfs->queue[i].frame);
+    MEM_SAFE_FREE(fdfs->queue[i].data);
+  }
+  MEM_freeN(fdfs->queue);
+  MEM_SAFE_FREE(fdfs->index_data_offset);
+  MEM_SAFE_FREE(fdfs->index_file_offset);
+  MEM_freeN(fdfs);
+
+  filedata->frames = NULL;
+}
+
 /* Memory reading. */
 
 static int fd_read_from_memory(FileData *filedata,
@@ -1360,12 +1746,14 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   FileDataSeekFn *seek_fn = NULL; /* Optional. */
 
   gzFile gzfile = (gzFile)Z_NULL;
+  bool use_frames = false;
 
-  char header[7];
+  char header[BLO_FRAME_HEADER_SIZE];
+  uint frame_len, data_len;
 
   /* Regular file. */
   errno = 0;
-  if (read(file, header, sizeof(header)) != sizeof(header)) {
+  if (read(file, header, 7) != 7) {
     BKE_reportf(reports,
                 RPT_WARNING,
                 "Unable to read '%s': %s",
@@ -1374,13 +1762,34 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
     return NULL;
   }
   else {
+    /* Frames are only used for compressed files, which are always larger than a frame header. */
+    if (read(file, header + 7, sizeof(header) - 7) == sizeof(header) - 7) {
+      use_frames = blo_frame_header_decode((const uchar *)header, &frame_len, &data_len);
+    }
     BLI_lseek(file, 0, SEEK_SET);
   }
 
+  BLI_mmap_file *mmap_file = NULL;
+
   /* Regular file. */
-  if (memcmp(header, "BLENDER", sizeof(header)) == 0) {
-    read_fn = fd_read_data_from_file;
-    seek_fn = fd_seek_data_from_file;
+  if (memcmp(header, "BLENDER", 7) == 0) {
+    /* Prefer memory mapping, so data-blocks can be read without intermediate copies. */
+    mmap_file = BLI_mmap_open(file);
+    if (mmap_file != NULL) {
+      read_fn = fd_read_from_mmap;
+      seek_fn = fd_seek_from_mmap;
+    }
+    else {
+      BLI_lseek(file, 0, SEEK_SET);
+      read_fn = fd_read_data_from_file;
+      seek_fn = fd_seek_data_from_file;
+    }
+  }
+
+  /* Framed gzip file, this is read directly instead of using zlib's file API.
+   * When the file has a frame index, seeking is supported too (set on initialization). */
+  if ((read_fn == NULL) && use_frames) {
+    read_fn = fd_read_gzip_frames_from_file;
   }
 
   /* Gzip file. */
@@ -1414,10 +1823,15 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   fd->filedes = file;
   fd->gzfiledes = gzfile;
+  fd->mmap_file = mmap_file;
 
   fd->read = read_fn;
   fd->seek = seek_fn;
 
+  if (read_fn == fd_read_gzip_frames_from_file) {
+    fd_frames_init(fd);
+  }
+
   return fd;
 }
 
@@ -1554,6 +1968,9 @@ FileData *blo_filedata_from_memfile(MemFile *memfile,
     return NULL;
   }
   else {
+    /* Chunks may still be processed in the background. */
+    BLO_memfile_wait(memfile);
+
     FileData *fd = filedata_new();
     fd->memfile = memfile;
     fd->undo_direction = params->undo_direction;
@@ -1576,6 +1993,14 @@ void blo_filedata_free(FileData *fd)
       gzclose(fd->gzfiledes);
     }
 
+    if (fd->frames != NULL) {
+      fd_frames_free(fd);
+    }
+
+    if (fd->mmap_file != NULL) {
+      BLI_mmap_free(fd->mmap_file);
+    }
+
     if (fd->strm.next_in) {
       if (inflateEnd(&fd->strm) != Z_OK) {
         printf("close gzip stream error\n");
@@ -2188,38 +2613,53 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
     }
 
     if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
+      /* When the file is memory mapped, data that isn't patched in-place
+       * (see endian switching above) is read from the mapping without intermediate copies. */
+      const void *data_mmap = fd_mmap_bhead_data(fd, bh);
+
       if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+        if (data_mmap != NULL) {
+          temp = DNA_struct_reconstruct(
+              fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, data_mmap);
+        }
+        else {
 #ifdef USE_BHEAD_READ_ON_DEMAND
-        if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-          bh = blo_bhead_read_full(fd, bh);
-          if (UNLIKELY(bh == NULL)) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            return NULL;
+          if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
+            bh = blo_bhead_read_full(fd, bh);
+            if (UNLIKELY(bh == NULL)) {
+              fd->flags &= ~FD_FLAGS_FILE_OK;
+              return NULL;
+            }
           }
-        }
 #endif
-        temp = DNA_struct_reconstruct(
-            fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh + 1));
+          temp = DNA_struct_reconstruct(
+              fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh + 1));
+        }
       }
       else {
         /* SDNA_CMP_EQUAL */
         temp = MEM_mallocN(bh->len, blockname);
-#ifdef USE_BHEAD_READ_ON_DEMAND
-        if (BHEADN_FROM_BHEAD(bh)->has_data) {
-          memcpy(temp, (bh + 1), bh->len);
+        if (data_mmap != NULL) {
+          memcpy(temp, data_mmap, bh->len);
         }
         else {
-          /* Instead of allocating the bhead, then copying it,
-           * read the data from the file directly into the memory. */
-          if (UNLIKELY(!blo_bhead_read_data(fd, bh, temp))) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            MEM_freeN(temp);
-            temp = NULL;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+          if (BHEADN_FROM_BHEAD(bh)->has_data) {
+            memcpy(temp, (bh + 1), bh->len);
+          }
+          else {
+            /* Instead of allocating the bhead, then copying it,
+             * read the data from the file directly into the memory. */
+            if (UNLIKELY(!blo_bhead_read_data(fd, bh, temp))) {
+              fd->flags &= ~FD_FLAGS_FILE_OK;
+              MEM_freeN(temp);
+              temp = NULL;
+            }
           }
-        }
 #else
-        memcpy(temp, (bh + 1), bh->len);
+          memcpy(temp, (bh + 1), bh->len);
 #endif
+        }
       }
     }
 
@@ -3481,6 +3921,8 @@ static void direct_link_nodetree(BlendDataReader *reader, bNodeTree *ntree)
   BLO_read_list(reader, &ntree->nodes);
   for (node = ntree->nodes.first; node; node = node->next) {
     node->typeinfo = NULL;
+    node->exec_time = 0.0f;
+    node->exec_memory = 0.0f;
 
     BLO_read_list(reader, &node->inputs);
     BLO_read_list(reader, &node->outputs);
@@ -4745,6 +5187,7 @@ static void direct_link_customdata(BlendDataReader *reader, CustomData *data, in
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
+    layer->shared = NULL;
 
     if (CustomData_verify_versions(data, i)) {
       BLO_read_data_address(reader, &layer->data);
@@ -5301,6 +5744,7 @@ static void direct_link_modifiers(BlendDataReader *reader, ListBase *lb, Object
   for (md = lb->first; md; md = md->next) {
     md->error = NULL;
     md->runtime = NULL;
+    md->execution_time = 0.0f;
 
     /* Modifier data has been allocated as a part of data migration process and
      * no reading of nested fields from file is needed. */
@@ -6058,6 +6502,7 @@ static void direct_link_lightcache(BlendDataReader *reader, LightCache *cache)
 
   BLO_read_data_address(reader, &cache->cube_data);
   BLO_read_data_address(reader, &cache->grid_data);
+  cache->cube_keys = NULL;
 }
 
 static void direct_link_view3dshading(BlendDataReader *reader, View3DShading *shading)
@@ -8980,36 +9425,113 @@ static bool direct_link_id(FileData *fd, Main *main, const int tag, ID *id, ID *
   return success;
 }
 
+/**
+ * Total size of the data-blocks of an ID, before their reconstruction is done using threads.
+ * Reading small ID's (the vast majority) in parallel would only add overhead.
+ */
+#define READ_DATA_PARALLEL_SIZE_MIN (1 << 18)
+
+typedef struct ReadDataBlock {
+  BHead *bhead;
+  void *data;
+} ReadDataBlock;
+
+typedef struct ReadDataParallelData {
+  FileData *fd;
+  ReadDataBlock *blocks;
+  const char *allocname;
+} ReadDataParallelData;
+
+static void read_data_parallel_fn(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ReadDataParallelData *data = userdata;
+  ReadDataBlock *block = &data->blocks[i];
+  block->data = read_struct(data->fd, block->bhead, data->allocname);
+}
+
+/**
+ * Whether #read_struct can be called for this block from multiple threads at once,
+ * this is the case when reading the data doesn't need #FileData.read (which isn't thread-safe
+ * since it modifies the file offset).
+ */
+static bool read_struct_is_threadsafe(FileData *fd, BHead *bhead)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (BHEADN_FROM_BHEAD(bhead)->has_data) {
+    return true;
+  }
+  /* Endian switching needs a copy of the data, read from the file. */
+  return (fd->mmap_file != NULL) && ((fd->flags & FD_FLAGS_SWITCH_ENDIAN) == 0);
+#else
+  UNUSED_VARS(fd, bhead);
+  return true;
+#endif
+}
+
 /* Read all data associated with a datablock into datamap. */
 static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *allocname)
 {
+  ReadDataBlock *blocks = NULL;
+  BLI_array_staticdeclare(blocks, 64);
+  size_t blocks_len_total = 0;
+  bool use_threading = true;
+
+  /* Reading the block headers is sequential, gather them first. */
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == DATA) {
-    /* The code below is useful for debugging leaks in data read from the blend file.
-     * Without this the messages only tell us what ID-type the memory came from,
-     * eg: `Data from OB len 64`, see #dataname.
-     * With the code below we get the struct-name to help tracking down the leak.
-     * This is kept disabled as the #malloc for the text always leaks memory. */
+    ReadDataBlock *block = BLI_array_append_ret(blocks);
+    block->bhead = bhead;
+    block->data = NULL;
+    blocks_len_total += (size_t)bhead->len;
+    use_threading &= read_struct_is_threadsafe(fd, bhead);
+
+    bhead = blo_bhead_next(fd, bhead);
+  }
+
+  const int blocks_len = BLI_array_len(blocks);
+
+  /* The code below is useful for debugging leaks in data read from the blend file.
+   * Without this the messages only tell us what ID-type the memory came from,
+   * eg: `Data from OB len 64`, see #dataname.
+   * With the code below we get the struct-name to help tracking down the leak.
+   * This is kept disabled as the #malloc for the text always leaks memory. */
 #if 0
-    {
-      const short *sp = fd->filesdna->structs[bhead->SDNAnr];
-      allocname = fd->filesdna->types[sp[0]];
-      size_t allocname_size = strlen(allocname) + 1;
-      char *allocname_buf = malloc(allocname_size);
-      memcpy(allocname_buf, allocname, allocname_size);
-      allocname = allocname_buf;
-    }
+  use_threading = false;
+  for (int i = 0; i < blocks_len; i++) {
+    const short *sp = fd->filesdna->structs[blocks[i].bhead->SDNAnr];
+    allocname = fd->filesdna->types[sp[0]];
+    size_t allocname_size = strlen(allocname) + 1;
+    char *allocname_buf = malloc(allocname_size);
+    memcpy(allocname_buf, allocname, allocname_size);
+    blocks[i].data = read_struct(fd, blocks[i].bhead, allocname_buf);
+  }
+#else
+  /* Reconstruct the data-blocks (the expensive part when the DNA doesn't match),
+   * there are no dependencies between them. */
+  ReadDataParallelData parallel_data = {
+      .fd = fd,
+      .blocks = blocks,
+      .allocname = allocname,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = use_threading && (blocks_len > 1) &&
+                           (blocks_len_total >= READ_DATA_PARALLEL_SIZE_MIN);
+  BLI_task_parallel_range(0, blocks_len, &parallel_data, read_data_parallel_fn, &settings);
 #endif
 
-    void *data = read_struct(fd, bhead, allocname);
-    if (data) {
-      oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+  /* Insert in the file order, matching single threaded reading. */
+  for (int i = 0; i < blocks_len; i++) {
+    if (blocks[i].data) {
+      oldnewmap_insert(fd->datamap, blocks[i].bhead->old, blocks[i].data, 0);
     }
-
-    bhead = blo_bhead_next(fd, bhead);
   }
 
+  BLI_array_free(blocks);
+
   return bhead;
 }
 
@@ -9120,6 +9642,8 @@ static void read_libblock_undo_restore_identical(
   ListBase *new_lb = which_libbase(main, idcode);
   BLI_remlink(old_lb, id_old);
   BLI_addtail(new_lb, id_old);
+  BKE_main_namemap_clear(old_bmain);
+  BKE_main_namemap_clear(main);
 
   /* Recalc flags, mostly these just remain as they are. */
   id_old->recalc |= direct_link_id_restore_recalc_exceptions(id_old);
@@ -9175,6 +9699,8 @@ static void read_libblock_undo_restore_at_old_address(FileData *fd, Main *main,
 
   BLI_addtail(new_lb, id_old);
   BLI_addtail(old_lb, id);
+  BKE_main_namemap_clear(old_bmain);
+  BKE_main_namemap_clear(main);
 }
 
 static bool read_libblock_undo_restore(
@@ -9471,6 +9997,78 @@ static void do_versions_userdef(FileData *fd, BlendFileData *bfd)
   }
 }
 
+typedef struct VersioningIDParallelData {
+  FileData *fd;
+  ID **ids;
+  const BLOVersioningIDCallback *callbacks;
+  int callbacks_len;
+} VersioningIDParallelData;
+
+static void versioning_id_parallel_fn(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  VersioningIDParallelData *data = userdata;
+  for (int j = 0; j < data->callbacks_len; j++) {
+    data->callbacks[j].func(data->fd, data->ids[i]);
+  }
+}
+
+/**
+ * Run per ID versioning callbacks, in the order they are given.
+ *
+ * Consecutive callbacks for the same ID type are run in a single pass over the #ListBase.
+ * Thread-safe callbacks (only modifying the ID they are called for and the data it owns)
+ * process multiple IDs in parallel, other callbacks run over the IDs one after another.
+ */
+void blo_do_versions_foreach_id(FileData *fd,
+                                Main *bmain,
+                                const BLOVersioningIDCallback *callbacks,
+                                const int callbacks_len)
+{
+  int group_start = 0;
+  while (group_start < callbacks_len) {
+    const BLOVersioningIDCallback *group = &callbacks[group_start];
+    int group_len = 1;
+    while ((group_start + group_len < callbacks_len) &&
+           (group[group_len].id_code == group->id_code) &&
+           (group[group_len].is_threadsafe == group->is_threadsafe)) {
+      group_len++;
+    }
+    group_start += group_len;
+
+    ListBase *lb = which_libbase(bmain, group->id_code);
+    if (group->is_threadsafe) {
+      const int ids_len = BLI_listbase_count(lb);
+      ID **ids = MEM_malloc_arrayN(MAX2(ids_len, 1), sizeof(*ids), __func__);
+      int i = 0;
+      LISTBASE_FOREACH (ID *, id, lb) {
+        ids[i++] = id;
+      }
+
+      VersioningIDParallelData data = {
+          .fd = fd,
+          .ids = ids,
+          .callbacks = group,
+          .callbacks_len = group_len,
+      };
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      settings.min_iter_per_thread = 16;
+      BLI_task_parallel_range(0, ids_len, &data, versioning_id_parallel_fn, &settings);
+
+      MEM_freeN(ids);
+    }
+    else {
+      LISTBASE_FOREACH (ID *, id, lb) {
+        for (int j = 0; j < group_len; j++) {
+          group[j].func(fd, id);
+        }
+      }
+    }
+  }
+}
+
 static void do_versions(FileData *fd, Library *lib, Main *main)
 {
   /* WATCH IT!!!: pointers from libdata have not been converted */
@@ -9510,6 +10108,9 @@ static void do_versions(FileData *fd, Library *lib, Main *main)
 
   /* don't forget to set version number in BKE_blender_version.h! */
 
+  /* Versioning may rename or add IDs without going through the name map. */
+  BKE_main_namemap_clear(main);
+
   main->is_locked_for_linking = false;
 }
 
@@ -11670,6 +12271,8 @@ static void split_main_newid(Main *mainptr, Main *main_newid)
       }
     }
   }
+  BKE_main_namemap_clear(mainptr);
+  BKE_main_namemap_clear(main_newid);
 }
 
 /**
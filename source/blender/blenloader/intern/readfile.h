@@ -30,7 +30,9 @@
 #include "DNA_windowmanager_types.h" /* for ReportType */
 #include "zlib.h"
 
+struct BLI_mmap_file;
 struct BLOCacheStorage;
+struct FileDataFrames;
 struct GSet;
 struct IDNameLib_Map;
 struct Key;
@@ -94,6 +96,10 @@ typedef struct FileData {
   gzFile gzfiledes;
   /** Gzip stream for memory decompression. */
   z_stream strm;
+  /** Framed gzip file reading, see `blend_frames.h`. */
+  struct FileDataFrames *frames;
+  /** Memory mapped uncompressed file, data-blocks may reference it directly. */
+  struct BLI_mmap_file *mmap_file;
 
   /** Now only in use for library appending. */
   char relabase[FILE_MAX];
@@ -180,6 +186,24 @@ void blo_do_versions_oldnewmap_insert(struct OldNewMap *onm,
 void *blo_do_versions_newlibadr(struct FileData *fd, const void *lib, const void *adr);
 void *blo_do_versions_newlibadr_us(struct FileData *fd, const void *lib, const void *adr);
 
+/** Versioning of a single ID, see #blo_do_versions_foreach_id. */
+typedef void (*BLOVersioningIDFn)(struct FileData *fd, struct ID *id);
+
+typedef struct BLOVersioningIDCallback {
+  short id_code;
+  /**
+   * The callback only accesses the ID it's called for (and data owned by it),
+   * so it may run for multiple IDs at once.
+   */
+  bool is_threadsafe;
+  BLOVersioningIDFn func;
+} BLOVersioningIDCallback;
+
+void blo_do_versions_foreach_id(struct FileData *fd,
+                                struct Main *bmain,
+                                const BLOVersioningIDCallback *callbacks,
+                                const int callbacks_len);
+
 struct PartEff *blo_do_version_give_parteff_245(struct Object *ob);
 void blo_do_version_old_trackto_to_constraints(struct Object *ob);
 void blo_do_versions_view3d_split_250(struct View3D *v3d, struct ListBase *regions);
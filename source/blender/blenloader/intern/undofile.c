@@ -42,6 +42,8 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_task.h"
 
 #include "BLO_readfile.h"
 #include "BLO_undofile.h"
@@ -52,6 +54,200 @@
 /* keep last */
 #include "BLI_strict_flags.h"
 
+/* -------------------------------------------------------------------- */
+/** \name Chunk Store
+ *
+ * Chunk memory is stored by content, so identical data is only stored once,
+ * no matter in which undo step (or where in that step) it's used.
+ *
+ * Looking up chunks by content is done in a background task once a memfile has been written,
+ * so it doesn't delay undo pushes. Any access to the memfiles using the store waits for it.
+ * \{ */
+
+typedef struct MemFileChunkKey {
+  uint hash;
+  uint size;
+  const char *data;
+} MemFileChunkKey;
+
+/** Header of the chunk memory, #MemFileChunk.buf points to the data that follows it. */
+typedef struct MemFileChunkBuffer {
+  MemFileChunkKey key;
+  /** Number of #MemFileChunk using this buffer. */
+  uint users;
+} MemFileChunkBuffer;
+
+#define CHUNK_BUFFER_FROM_DATA(data) (((MemFileChunkBuffer *)(data)) - 1)
+
+/** Chunks of a memfile which still have to be looked up in the store. */
+typedef struct MemFileDedupJob {
+  struct MemFileDedupJob *next, *prev;
+  MemFile *memfile;
+  MemFileChunk **chunks;
+  uint chunks_len;
+  uint chunks_len_alloc;
+  /** Size of the chunks found in the store, subtracted from #MemFile.size once done. */
+  size_t size_shared;
+} MemFileDedupJob;
+
+typedef struct MemFileChunkStore {
+  /** Set of #MemFileChunkBuffer, keyed by their content (#MemFileChunkKey). */
+  GSet *buffers;
+  /** Number of memfiles using this store. */
+  uint users;
+
+  /** Background task pool running #MemFileDedupJob, created on demand. */
+  TaskPool *task_pool;
+  ListBase jobs;
+} MemFileChunkStore;
+
+static uint memfile_chunk_key_hash(const void *key_v)
+{
+  const MemFileChunkKey *key = key_v;
+  return key->hash;
+}
+
+static bool memfile_chunk_key_cmp(const void *a_v, const void *b_v)
+{
+  const MemFileChunkKey *a = a_v;
+  const MemFileChunkKey *b = b_v;
+  return !((a->hash == b->hash) && (a->size == b->size) &&
+           (memcmp(a->data, b->data, a->size) == 0));
+}
+
+static MemFileChunkStore *memfile_chunk_store_new(void)
+{
+  MemFileChunkStore *store = MEM_callocN(sizeof(*store), __func__);
+  store->buffers = BLI_gset_new(memfile_chunk_key_hash, memfile_chunk_key_cmp, __func__);
+  store->users = 1;
+  return store;
+}
+
+/** Wait for background work on the store to finish, must be done before any other access. */
+static void memfile_chunk_store_wait(MemFileChunkStore *store)
+{
+  if (store == NULL || BLI_listbase_is_empty(&store->jobs)) {
+    return;
+  }
+
+  BLI_task_pool_work_and_wait(store->task_pool);
+
+  MemFileDedupJob *job;
+  while ((job = BLI_pophead(&store->jobs))) {
+    BLI_assert(job->memfile->size >= job->size_shared);
+    job->memfile->size -= job->size_shared;
+    MEM_freeN(job->chunks);
+    MEM_freeN(job);
+  }
+}
+
+static void memfile_chunk_store_free(MemFileChunkStore *store)
+{
+  BLI_assert(store->users != 0);
+  if (--store->users != 0) {
+    return;
+  }
+  memfile_chunk_store_wait(store);
+  if (store->task_pool != NULL) {
+    BLI_task_pool_free(store->task_pool);
+  }
+  /* All memfiles using the store release their buffers before. */
+  BLI_assert(BLI_gset_len(store->buffers) == 0);
+  BLI_gset_free(store->buffers, NULL);
+  MEM_freeN(store);
+}
+
+/** New chunk memory, not part of the store until #memfile_chunk_store_insert. */
+static const char *memfile_chunk_buffer_new(const char *data, uint size)
+{
+  MemFileChunkBuffer *buffer = MEM_mallocN(sizeof(*buffer) + size, "Chunk buffer");
+  char *buffer_data = (char *)(buffer + 1);
+  memcpy(buffer_data, data, size);
+  buffer->key.hash = 0;
+  buffer->key.size = size;
+  buffer->key.data = buffer_data;
+  buffer->users = 1;
+  return buffer_data;
+}
+
+/**
+ * Add the memory of a new chunk to the store, when memory of the same content is already stored
+ * the chunk uses that instead (and its own memory is freed).
+ *
+ * \return true when memory was shared.
+ */
+static bool memfile_chunk_store_insert(MemFileChunkStore *store, const char **data_p)
+{
+  MemFileChunkBuffer *buffer = CHUNK_BUFFER_FROM_DATA(*data_p);
+  BLI_assert(buffer->users == 1);
+  buffer->key.hash = BLI_hash_mm2((const uchar *)buffer->key.data, buffer->key.size, 0);
+
+  void **val;
+  if (BLI_gset_ensure_p_ex(store->buffers, &buffer->key, &val)) {
+    MemFileChunkBuffer *buffer_stored = (MemFileChunkBuffer *)*val;
+    buffer_stored->users++;
+    *data_p = buffer_stored->key.data;
+    MEM_freeN(buffer);
+    return true;
+  }
+  *val = &buffer->key;
+  return false;
+}
+
+static void memfile_chunk_store_user_add(MemFileChunkStore *UNUSED(store), const char *data)
+{
+  CHUNK_BUFFER_FROM_DATA(data)->users++;
+}
+
+static void memfile_chunk_store_remove(MemFileChunkStore *store, const char *data)
+{
+  MemFileChunkBuffer *buffer = CHUNK_BUFFER_FROM_DATA(data);
+  BLI_assert(buffer->users != 0);
+  if (--buffer->users == 0) {
+    const bool removed = BLI_gset_remove(store->buffers, &buffer->key, NULL);
+    BLI_assert(removed);
+    UNUSED_VARS_NDEBUG(removed);
+    MEM_freeN(buffer);
+  }
+}
+
+static void memfile_dedup_job_add_chunk(MemFileDedupJob *job, MemFileChunk *chunk)
+{
+  if (job->chunks_len == job->chunks_len_alloc) {
+    job->chunks_len_alloc = MAX2(job->chunks_len_alloc * 2, 64u);
+    job->chunks = MEM_reallocN(job->chunks, sizeof(*job->chunks) * job->chunks_len_alloc);
+  }
+  job->chunks[job->chunks_len++] = chunk;
+}
+
+static void memfile_dedup_job_run(TaskPool *__restrict pool, void *taskdata)
+{
+  MemFileChunkStore *store = BLI_task_pool_user_data(pool);
+  MemFileDedupJob *job = taskdata;
+  for (uint i = 0; i < job->chunks_len; i++) {
+    MemFileChunk *chunk = job->chunks[i];
+    if (memfile_chunk_store_insert(store, &chunk->buf)) {
+      job->size_shared += chunk->size;
+    }
+  }
+}
+
+static void memfile_chunk_store_push_job(MemFileChunkStore *store, MemFileDedupJob *job)
+{
+  if (job->chunks_len == 0) {
+    MEM_SAFE_FREE(job->chunks);
+    MEM_freeN(job);
+    return;
+  }
+  if (store->task_pool == NULL) {
+    store->task_pool = BLI_task_pool_create_background_serial(store, TASK_PRIORITY_LOW);
+  }
+  BLI_addtail(&store->jobs, job);
+  BLI_task_pool_push(store->task_pool, memfile_dedup_job_run, job, false, NULL);
+}
+
+/** \} */
+
 /* **************** support for memory-write, for undo buffers *************** */
 
 /* not memfile itself */
@@ -59,44 +255,47 @@ void BLO_memfile_free(MemFile *memfile)
 {
   MemFileChunk *chunk;
 
+  BLO_memfile_wait(memfile);
+
   while ((chunk = BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
-      MEM_freeN((void *)chunk->buf);
-    }
+    memfile_chunk_store_remove(memfile->store, chunk->buf);
     MEM_freeN(chunk);
   }
   memfile->size = 0;
+
+  if (memfile->store != NULL) {
+    memfile_chunk_store_free(memfile->store);
+    memfile->store = NULL;
+  }
 }
 
 /* to keep list of memfiles consistent, 'first' is always first in list */
 /* result is that 'first' is being freed */
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
-  /* We use this mapping to store the memory buffers from second memfile chunks which are not owned
-   * by it (i.e. shared with some previous memory steps). */
+  BLO_memfile_wait(second);
+
+  /* Memory is owned by the shared chunk store, so it's kept as long as the second memfile uses
+   * it. However chunks of the second memfile which are identical to chunks that changed in the
+   * first memfile are not identical to the step before the first one. */
   GHash *buffer_to_second_memchunk = BLI_ghash_new(
       BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, __func__);
 
-  /* First, detect all memchunks in second memfile that are not owned by it. */
+  /* First, detect all memchunks in second memfile that are identical to the first one. */
   for (MemFileChunk *sc = second->chunks.first; sc != NULL; sc = sc->next) {
     if (sc->is_identical) {
       BLI_ghash_insert(buffer_to_second_memchunk, (void *)sc->buf, sc);
     }
   }
 
-  /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
-   * it is also used by the second memfile, transfer the ownership. */
+  /* Now, check all chunks that changed in the first memfile (the one we are removing). */
   for (MemFileChunk *fc = first->chunks.first; fc != NULL; fc = fc->next) {
     if (!fc->is_identical) {
       MemFileChunk *sc = BLI_ghash_lookup(buffer_to_second_memchunk, fc->buf);
       if (sc != NULL) {
         BLI_assert(sc->is_identical);
         sc->is_identical = false;
-        fc->is_identical = true;
       }
-      /* Note that if the second memfile does not use that chunk, we assume that the first one
-       * fully owns it without sharing it with any other memfile, and hence it should be freed with
-       * it. */
     }
   }
 
@@ -108,6 +307,8 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
 /* Clear is_identical_future before adding next memfile. */
 void BLO_memfile_clear_future(MemFile *memfile)
 {
+  BLO_memfile_wait(memfile);
+
   LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile->chunks) {
     chunk->is_identical_future = false;
   }
@@ -117,10 +318,27 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
                             MemFile *written_memfile,
                             MemFile *reference_memfile)
 {
+  if (reference_memfile != NULL) {
+    BLO_memfile_wait(reference_memfile);
+  }
+
   mem_data->written_memfile = written_memfile;
   mem_data->reference_memfile = reference_memfile;
   mem_data->reference_current_chunk = reference_memfile ? reference_memfile->chunks.first : NULL;
 
+  /* Share the chunk memory with the previous steps. */
+  BLI_assert(written_memfile->store == NULL);
+  if (reference_memfile != NULL && reference_memfile->store != NULL) {
+    written_memfile->store = reference_memfile->store;
+    written_memfile->store->users++;
+  }
+  else {
+    written_memfile->store = memfile_chunk_store_new();
+  }
+
+  mem_data->dedup_job = MEM_callocN(sizeof(*mem_data->dedup_job), __func__);
+  mem_data->dedup_job->memfile = written_memfile;
+
   /* If we have a reference memfile, we generate a mapping between the session_uuid's of the
    * IDs stored in that previous undo step, and its first matching memchunk. This will allow
    * us to easily find the existing undo memory storage of IDs even when some re-ordering in
@@ -152,6 +370,15 @@ void BLO_memfile_write_finalize(MemFileWriteData *mem_data)
   if (mem_data->id_session_uuid_mapping != NULL) {
     BLI_ghash_free(mem_data->id_session_uuid_mapping, NULL, NULL);
   }
+
+  /* Share memory of changed chunks with any step, once writing is done. */
+  memfile_chunk_store_push_job(mem_data->written_memfile->store, mem_data->dedup_job);
+  mem_data->dedup_job = NULL;
+}
+
+void BLO_memfile_wait(MemFile *memfile)
+{
+  memfile_chunk_store_wait(memfile->store);
 }
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, uint size)
@@ -178,17 +405,18 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, uint siz
         curchunk->buf = compchunk->buf;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
+        memfile_chunk_store_user_add(memfile->store, curchunk->buf);
       }
     }
     *compchunk_step = compchunk->next;
   }
 
-  /* not equal... */
+  /* not equal... the same content may still be stored elsewhere (in any step),
+   * this is checked in the background. */
   if (curchunk->buf == NULL) {
-    char *buf_new = MEM_mallocN(size, "Chunk buffer");
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
+    curchunk->buf = memfile_chunk_buffer_new(buf, size);
     memfile->size += size;
+    memfile_dedup_job_add_chunk(mem_data->dedup_job, curchunk);
   }
 }
 
@@ -225,6 +453,8 @@ bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename)
   MemFileChunk *chunk;
   int file, oflags;
 
+  BLO_memfile_wait(memfile);
+
   /* note: This is currently used for autosave and 'quit.blend',
    * where _not_ following symlinks is OK,
    * however if this is ever executed explicitly by the user,
@@ -3426,7 +3426,8 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
             }
             case SPACE_NODE: {
               SpaceNode *snode = (SpaceNode *)sl;
-              snode->flag &= ~(SNODE_FLAG_UNUSED_6 | SNODE_FLAG_UNUSED_10 | SNODE_FLAG_UNUSED_11);
+              snode->flag &= ~(SNODE_SHOW_STATISTICS | SNODE_FLAG_UNUSED_10 |
+                               SNODE_FLAG_UNUSED_11);
               break;
             }
             case SPACE_PROPERTIES: {
@@ -3451,7 +3452,7 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
                          R_MODE_UNUSED_17 | R_MODE_UNUSED_18 | R_MODE_UNUSED_19 |
                          R_MODE_UNUSED_20 | R_MODE_UNUSED_21 | R_MODE_UNUSED_27);
 
-      scene->r.scemode &= ~(R_SCEMODE_UNUSED_8 | R_SCEMODE_UNUSED_11 | R_SCEMODE_UNUSED_13 |
+      scene->r.scemode &= ~(R_SCEMODE_UNUSED_8 | R_EXR_TILE_STREAM | R_SCEMODE_UNUSED_13 |
                             R_SCEMODE_UNUSED_16 | R_SCEMODE_UNUSED_17 | R_SCEMODE_UNUSED_19);
 
       if (scene->toolsettings->sculpt) {
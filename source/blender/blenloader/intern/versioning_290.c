@@ -210,6 +210,86 @@ void do_versions_after_linking_290(Main *bmain, ReportList *UNUSED(reports))
   }
 }
 
+/* Per object versioning for 290.6, these only modify the object they run for,
+ * see #blo_do_versions_foreach_id. */
+
+static void version_290_modifier_ui_expand_flag(FileData *UNUSED(fd), ID *id)
+{
+  Object *object = (Object *)id;
+  LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
+    if (md->mode & eModifierMode_Expanded_DEPRECATED) {
+      md->ui_expand_flag = 1;
+    }
+    else {
+      md->ui_expand_flag = 0;
+    }
+  }
+}
+
+static void version_290_constraint_ui_expand_flag(FileData *UNUSED(fd), ID *id)
+{
+  Object *object = (Object *)id;
+  LISTBASE_FOREACH (bConstraint *, con, &object->constraints) {
+    if (con->flag & CONSTRAINT_EXPAND_DEPRECATED) {
+      con->ui_expand_flag = 1;
+    }
+    else {
+      con->ui_expand_flag = 0;
+    }
+  }
+}
+
+static void version_290_gpencil_modifier_ui_expand_flag(FileData *UNUSED(fd), ID *id)
+{
+  Object *object = (Object *)id;
+  LISTBASE_FOREACH (GpencilModifierData *, md, &object->greasepencil_modifiers) {
+    if (md->mode & eGpencilModifierMode_Expanded_DEPRECATED) {
+      md->ui_expand_flag = 1;
+    }
+    else {
+      md->ui_expand_flag = 0;
+    }
+  }
+}
+
+static void version_290_shaderfx_ui_expand_flag(FileData *UNUSED(fd), ID *id)
+{
+  Object *object = (Object *)id;
+  LISTBASE_FOREACH (ShaderFxData *, fx, &object->shader_fx) {
+    if (fx->mode & eShaderFxMode_Expanded_DEPRECATED) {
+      fx->ui_expand_flag = 1;
+    }
+    else {
+      fx->ui_expand_flag = 0;
+    }
+  }
+}
+
+static void version_290_bevel_profile_type(FileData *UNUSED(fd), ID *id)
+{
+  Object *object = (Object *)id;
+  LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
+    if (md->type == eModifierType_Bevel) {
+      BevelModifierData *bmd = (BevelModifierData *)md;
+      bool use_custom_profile = bmd->flags & MOD_BEVEL_CUSTOM_PROFILE_DEPRECATED;
+      bmd->profile_type = use_custom_profile ? MOD_BEVEL_PROFILE_CUSTOM :
+                                               MOD_BEVEL_PROFILE_SUPERELLIPSE;
+    }
+  }
+}
+
+static void version_290_ocean_ranges(FileData *UNUSED(fd), ID *id)
+{
+  Object *object = (Object *)id;
+  LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
+    if (md->type == eModifierType_Ocean) {
+      OceanModifierData *omd = (OceanModifierData *)md;
+      omd->wave_alignment *= 0.1f;
+      omd->sharpen_peak_jonswap *= 0.1f;
+    }
+  }
+}
+
 void blo_do_versions_290(FileData *fd, Library *UNUSED(lib), Main *bmain)
 {
   UNUSED_VARS(fd);
@@ -292,19 +372,39 @@ void blo_do_versions_290(FileData *fd, Library *UNUSED(lib), Main *bmain)
   }
 
   if (!MAIN_VERSION_ATLEAST(bmain, 290, 6)) {
-    /* Transition to saving expansion for all of a modifier's sub-panels. */
+    /* Object changes only touch the object itself, so they are run in parallel. */
+    BLOVersioningIDCallback callbacks[6];
+    int callbacks_len = 0;
+
+    /* Transition to saving expansion for all of a modifier's, constraint's,
+     * grease pencil modifier's and effect's sub-panels. */
     if (!DNA_struct_elem_find(fd->filesdna, "ModifierData", "short", "ui_expand_flag")) {
-      for (Object *object = bmain->objects.first; object != NULL; object = object->id.next) {
-        LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
-          if (md->mode & eModifierMode_Expanded_DEPRECATED) {
-            md->ui_expand_flag = 1;
-          }
-          else {
-            md->ui_expand_flag = 0;
-          }
-        }
-      }
+      callbacks[callbacks_len++] = (BLOVersioningIDCallback){
+          ID_OB, true, version_290_modifier_ui_expand_flag};
     }
+    if (!DNA_struct_elem_find(fd->filesdna, "bConstraint", "short", "ui_expand_flag")) {
+      callbacks[callbacks_len++] = (BLOVersioningIDCallback){
+          ID_OB, true, version_290_constraint_ui_expand_flag};
+    }
+    if (!DNA_struct_elem_find(fd->filesdna, "GpencilModifierData", "short", "ui_expand_flag")) {
+      callbacks[callbacks_len++] = (BLOVersioningIDCallback){
+          ID_OB, true, version_290_gpencil_modifier_ui_expand_flag};
+    }
+    if (!DNA_struct_elem_find(fd->filesdna, "ShaderFxData", "short", "ui_expand_flag")) {
+      callbacks[callbacks_len++] = (BLOVersioningIDCallback){
+          ID_OB, true, version_290_shaderfx_ui_expand_flag};
+    }
+    /* Refactor bevel profile type to use an enum. */
+    if (!DNA_struct_elem_find(fd->filesdna, "BevelModifierData", "short", "profile_type")) {
+      callbacks[callbacks_len++] = (BLOVersioningIDCallback){
+          ID_OB, true, version_290_bevel_profile_type};
+    }
+    /* Change ocean modifier values from [0, 10] to [0, 1] ranges. */
+    callbacks[callbacks_len++] = (BLOVersioningIDCallback){
+        ID_OB, true, version_290_ocean_ranges};
+
+    BLI_assert(callbacks_len <= ARRAY_SIZE(callbacks));
+    blo_do_versions_foreach_id(fd, bmain, callbacks, callbacks_len);
 
     /* EEVEE Motion blur new parameters. */
     if (!DNA_struct_elem_find(fd->filesdna, "SceneEEVEE", "float", "motion_blur_depth_scale")) {
@@ -319,73 +419,6 @@ void blo_do_versions_290(FileData *fd, Library *UNUSED(lib), Main *bmain)
         scene->eevee.motion_blur_steps = 1;
       }
     }
-
-    /* Transition to saving expansion for all of a constraint's sub-panels. */
-    if (!DNA_struct_elem_find(fd->filesdna, "bConstraint", "short", "ui_expand_flag")) {
-      for (Object *object = bmain->objects.first; object != NULL; object = object->id.next) {
-        LISTBASE_FOREACH (bConstraint *, con, &object->constraints) {
-          if (con->flag & CONSTRAINT_EXPAND_DEPRECATED) {
-            con->ui_expand_flag = 1;
-          }
-          else {
-            con->ui_expand_flag = 0;
-          }
-        }
-      }
-    }
-
-    /* Transition to saving expansion for all of grease pencil modifier's sub-panels. */
-    if (!DNA_struct_elem_find(fd->filesdna, "GpencilModifierData", "short", "ui_expand_flag")) {
-      for (Object *object = bmain->objects.first; object != NULL; object = object->id.next) {
-        LISTBASE_FOREACH (GpencilModifierData *, md, &object->greasepencil_modifiers) {
-          if (md->mode & eGpencilModifierMode_Expanded_DEPRECATED) {
-            md->ui_expand_flag = 1;
-          }
-          else {
-            md->ui_expand_flag = 0;
-          }
-        }
-      }
-    }
-
-    /* Transition to saving expansion for all of an effect's sub-panels. */
-    if (!DNA_struct_elem_find(fd->filesdna, "ShaderFxData", "short", "ui_expand_flag")) {
-      for (Object *object = bmain->objects.first; object != NULL; object = object->id.next) {
-        LISTBASE_FOREACH (ShaderFxData *, fx, &object->shader_fx) {
-          if (fx->mode & eShaderFxMode_Expanded_DEPRECATED) {
-            fx->ui_expand_flag = 1;
-          }
-          else {
-            fx->ui_expand_flag = 0;
-          }
-        }
-      }
-    }
-
-    /* Refactor bevel profile type to use an enum. */
-    if (!DNA_struct_elem_find(fd->filesdna, "BevelModifierData", "short", "profile_type")) {
-      for (Object *object = bmain->objects.first; object != NULL; object = object->id.next) {
-        LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
-          if (md->type == eModifierType_Bevel) {
-            BevelModifierData *bmd = (BevelModifierData *)md;
-            bool use_custom_profile = bmd->flags & MOD_BEVEL_CUSTOM_PROFILE_DEPRECATED;
-            bmd->profile_type = use_custom_profile ? MOD_BEVEL_PROFILE_CUSTOM :
-                                                     MOD_BEVEL_PROFILE_SUPERELLIPSE;
-          }
-        }
-      }
-    }
-
-    /* Change ocean modifier values from [0, 10] to [0, 1] ranges. */
-    for (Object *object = bmain->objects.first; object != NULL; object = object->id.next) {
-      LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
-        if (md->type == eModifierType_Ocean) {
-          OceanModifierData *omd = (OceanModifierData *)md;
-          omd->wave_alignment *= 0.1f;
-          omd->sharpen_peak_jonswap *= 0.1f;
-        }
-      }
-    }
   }
 
   /**
@@ -149,6 +149,7 @@
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "MEM_guardedalloc.h"  // MEM_freeN
 
 #include "BKE_action.h"
@@ -185,6 +186,7 @@
 #include "BLO_undofile.h"
 #include "BLO_writefile.h"
 
+#include "blend_frames.h"
 #include "readfile.h"
 
 #include <errno.h>
@@ -207,10 +209,15 @@
 
 typedef enum {
   WW_WRAP_NONE = 1,
-  WW_WRAP_ZLIB,
+  /** Independently compressed gzip frames, see `blend_frames.h`. */
+  WW_WRAP_ZLIB_FRAMES,
+  /** Update an existing uncompressed file in place, only writing what changed. */
+  WW_WRAP_INCREMENTAL,
 } eWriteWrapType;
 
 typedef struct WriteWrap WriteWrap;
+typedef struct WriteWrapFrames WriteWrapFrames;
+typedef struct WriteWrapIncremental WriteWrapIncremental;
 struct WriteWrap {
   /* callbacks */
   bool (*open)(WriteWrap *ww, const char *filepath);
@@ -223,7 +230,8 @@ struct WriteWrap {
   /* internal */
   union {
     int file_handle;
-    gzFile gz_handle;
+    WriteWrapFrames *frames;
+    WriteWrapIncremental *incremental;
   } _user_data;
 };
 
@@ -254,32 +262,340 @@ static size_t ww_write_none(WriteWrap *ww, const char *buf, size_t buf_len)
 }
 #undef FILE_HANDLE
 
-/* zlib */
-#define FILE_HANDLE(ww) (ww)->_user_data.gz_handle
+/* zlib frames (multi-threaded) */
+#define FRAMES_HANDLE(ww) (ww)->_user_data.frames
+
+typedef struct WriteWrapFrame {
+  /** Uncompressed data, #BLO_FRAME_DATA_SIZE bytes. */
+  uchar *data;
+  size_t data_len;
+  /** Compressed gzip member, #blo_frame_compress_bound bytes. */
+  uchar *frame;
+  size_t frame_len;
+} WriteWrapFrame;
+
+struct WriteWrapFrames {
+  int file_handle;
+  TaskPool *task_pool;
+
+  /** Frames being compressed, written to the file in order once the queue is full. */
+  WriteWrapFrame *queue;
+  int queue_len;
+  int queue_len_max;
+
+  /** Sizes of all frames written so far, stored in the index on close. */
+  BLOFrameIndexEntry *index;
+  uint index_len;
+  uint index_len_alloc;
+  /** Number of bytes written to the file. */
+  uint64_t file_len;
 
-static bool ww_open_zlib(WriteWrap *ww, const char *filepath)
+  bool error;
+};
+
+static void ww_frame_compress_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
 {
-  gzFile file;
+  WriteWrapFrame *wwf = taskdata;
+  wwf->frame_len = blo_frame_compress(
+      wwf->data, wwf->data_len, wwf->frame, blo_frame_compress_bound(BLO_FRAME_DATA_SIZE));
+}
 
-  file = BLI_gzopen(filepath, "wb1");
+/**
+ * Wait for all queued frames to be compressed and write them out.
+ */
+static void ww_frames_queue_flush(WriteWrapFrames *wwfs)
+{
+  BLI_task_pool_work_and_wait(wwfs->task_pool);
 
-  if (file != Z_NULL) {
-    FILE_HANDLE(ww) = file;
-    return true;
+  for (int i = 0; i < wwfs->queue_len; i++) {
+    WriteWrapFrame *wwf = &wwfs->queue[i];
+    if (wwfs->error == false) {
+      if ((wwf->frame_len == 0) ||
+          ((size_t)write(wwfs->file_handle, wwf->frame, wwf->frame_len) != wwf->frame_len)) {
+        wwfs->error = true;
+      }
+      else {
+        if (wwfs->index_len == wwfs->index_len_alloc) {
+          wwfs->index_len_alloc = MAX2(64, wwfs->index_len_alloc * 2);
+          wwfs->index = MEM_reallocN(wwfs->index, sizeof(*wwfs->index) * wwfs->index_len_alloc);
+        }
+        wwfs->index[wwfs->index_len].frame_len = (uint)wwf->frame_len;
+        wwfs->index[wwfs->index_len].data_len = (uint)wwf->data_len;
+        wwfs->index_len++;
+        wwfs->file_len += wwf->frame_len;
+      }
+    }
+    wwf->data_len = 0;
+    wwf->frame_len = 0;
   }
-  else {
+  wwfs->queue_len = 0;
+}
+
+static bool ww_open_zlib_frames(WriteWrap *ww, const char *filepath)
+{
+  int file;
+
+  file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
+
+  if (file == -1) {
     return false;
   }
+
+  WriteWrapFrames *wwfs = MEM_callocN(sizeof(*wwfs), __func__);
+  wwfs->file_handle = file;
+  wwfs->task_pool = BLI_task_pool_create(NULL, TASK_PRIORITY_HIGH);
+  /* Two frames per thread, to keep threads busy while the next frames are filled. */
+  wwfs->queue_len_max = MAX2(2, BLI_task_scheduler_num_threads() * 2);
+  wwfs->queue = MEM_callocN(sizeof(*wwfs->queue) * wwfs->queue_len_max, __func__);
+
+  FRAMES_HANDLE(ww) = wwfs;
+  return true;
 }
-static bool ww_close_zlib(WriteWrap *ww)
+static bool ww_close_zlib_frames(WriteWrap *ww)
 {
-  return (gzclose(FILE_HANDLE(ww)) == Z_OK);
+  WriteWrapFrames *wwfs = FRAMES_HANDLE(ww);
+
+  /* Compress the remaining (partially filled) frame,
+   * the queue is never full here since it's flushed as soon as it is. */
+  WriteWrapFrame *wwf = &wwfs->queue[wwfs->queue_len];
+  if (wwf->data_len != 0) {
+    BLI_task_pool_push(wwfs->task_pool, ww_frame_compress_task, wwf, false, NULL);
+    wwfs->queue_len++;
+  }
+  ww_frames_queue_flush(wwfs);
+
+  /* Write the index & footer, so readers can seek without decompressing all frames. */
+  if (wwfs->error == false) {
+    const size_t index_buf_len = blo_frame_index_encode_len(wwfs->index_len);
+    uchar *index_buf = MEM_mallocN(index_buf_len + BLO_FRAME_FOOTER_SIZE, __func__);
+    blo_frame_index_encode(wwfs->index, wwfs->index_len, index_buf);
+    blo_frame_footer_encode(&index_buf[index_buf_len], wwfs->file_len, wwfs->index_len);
+    if ((size_t)write(wwfs->file_handle, index_buf, index_buf_len + BLO_FRAME_FOOTER_SIZE) !=
+        index_buf_len + BLO_FRAME_FOOTER_SIZE) {
+      wwfs->error = true;
+    }
+    MEM_freeN(index_buf);
+  }
+
+  bool ok = (wwfs->error == false);
+  if (close(wwfs->file_handle) == -1) {
+    ok = false;
+  }
+
+  BLI_task_pool_free(wwfs->task_pool);
+  for (int i = 0; i < wwfs->queue_len_max; i++) {
+    MEM_SAFE_FREE(wwfs->queue[i].data);
+    MEM_SAFE_FREE(wwfs->queue[i].frame);
+  }
+  MEM_freeN(wwfs->queue);
+  MEM_SAFE_FREE(wwfs->index);
+  MEM_freeN(wwfs);
+
+  return ok;
 }
-static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
+static size_t ww_write_zlib_frames(WriteWrap *ww, const char *buf, size_t buf_len)
 {
-  return gzwrite(FILE_HANDLE(ww), buf, buf_len);
+  WriteWrapFrames *wwfs = FRAMES_HANDLE(ww);
+  size_t buf_used = 0;
+
+  while (buf_used < buf_len) {
+    WriteWrapFrame *wwf = &wwfs->queue[wwfs->queue_len];
+    if (wwf->data == NULL) {
+      wwf->data = MEM_mallocN(BLO_FRAME_DATA_SIZE, __func__);
+      wwf->frame = MEM_mallocN(blo_frame_compress_bound(BLO_FRAME_DATA_SIZE), __func__);
+    }
+
+    const size_t len = MIN2(buf_len - buf_used, BLO_FRAME_DATA_SIZE - wwf->data_len);
+    memcpy(wwf->data + wwf->data_len, buf + buf_used, len);
+    wwf->data_len += len;
+    buf_used += len;
+
+    if (wwf->data_len == BLO_FRAME_DATA_SIZE) {
+      BLI_task_pool_push(wwfs->task_pool, ww_frame_compress_task, wwf, false, NULL);
+      wwfs->queue_len++;
+      if (wwfs->queue_len == wwfs->queue_len_max) {
+        ww_frames_queue_flush(wwfs);
+      }
+    }
+  }
+
+  return wwfs->error ? 0 : buf_len;
 }
-#undef FILE_HANDLE
+#undef FRAMES_HANDLE
+
+/* incremental */
+#define INCREMENTAL_HANDLE(ww) (ww)->_user_data.incremental
+
+/**
+ * Granularity of the comparison with the existing file contents,
+ * only blocks that differ are written.
+ */
+#define WW_INCREMENTAL_BLOCK_SIZE 4096
+/** Number of bytes of the existing file read at once. */
+#define WW_INCREMENTAL_READ_SIZE (WW_INCREMENTAL_BLOCK_SIZE * 16)
+
+struct WriteWrapIncremental {
+  int file_handle;
+  /** Size of the file before writing. */
+  off64_t file_len_old;
+  /** Number of bytes passed to #ww_write_incremental so far. */
+  off64_t offset;
+  /** Current position of #WriteWrapIncremental.file_handle. */
+  off64_t file_offset;
+  /** Number of bytes that actually had to be written. */
+  off64_t write_len;
+
+  uchar buf_old[WW_INCREMENTAL_READ_SIZE];
+
+  bool error;
+};
+
+/**
+ * Check if the file at \a filepath can be updated incrementally,
+ * only uncompressed blend-files are supported as compressed data doesn't stay in place.
+ */
+static bool ww_incremental_poll(const char *filepath)
+{
+  char header[7];
+  bool ok = false;
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file != -1) {
+    ok = (read(file, header, sizeof(header)) == sizeof(header)) &&
+         (memcmp(header, "BLENDER", sizeof(header)) == 0);
+    close(file);
+  }
+  return ok;
+}
+
+static bool ww_open_incremental(WriteWrap *ww, const char *filepath)
+{
+  /* No #O_TRUNC, the file is truncated on close (only when it got smaller). */
+  const int file = BLI_open(filepath, O_BINARY | O_RDWR, 0666);
+  if (file == -1) {
+    return false;
+  }
+
+  const off64_t file_len_old = BLI_lseek(file, 0, SEEK_END);
+  if (file_len_old == -1 || BLI_lseek(file, 0, SEEK_SET) == -1) {
+    close(file);
+    return false;
+  }
+
+  WriteWrapIncremental *wwi = MEM_callocN(sizeof(*wwi), __func__);
+  wwi->file_handle = file;
+  wwi->file_len_old = file_len_old;
+  INCREMENTAL_HANDLE(ww) = wwi;
+  return true;
+}
+
+static bool ww_close_incremental(WriteWrap *ww)
+{
+  WriteWrapIncremental *wwi = INCREMENTAL_HANDLE(ww);
+  bool ok = !wwi->error;
+
+  /* Remove data past the end of the new file. */
+  if (ok && wwi->offset < wwi->file_len_old) {
+#ifdef WIN32
+    ok = (_chsize_s(wwi->file_handle, wwi->offset) == 0);
+#else
+    ok = (ftruncate(wwi->file_handle, wwi->offset) == 0);
+#endif
+  }
+
+  if (G.debug & G_DEBUG_IO) {
+    printf("%s: wrote %" PRIu64 " of %" PRIu64 " bytes\n",
+           __func__,
+           (uint64_t)wwi->write_len,
+           (uint64_t)wwi->offset);
+  }
+
+  if (close(wwi->file_handle) == -1) {
+    ok = false;
+  }
+  MEM_freeN(wwi);
+  return ok;
+}
+
+static bool ww_incremental_seek(WriteWrapIncremental *wwi, off64_t offset)
+{
+  if (wwi->file_offset != offset) {
+    if (BLI_lseek(wwi->file_handle, offset, SEEK_SET) != offset) {
+      return false;
+    }
+    wwi->file_offset = offset;
+  }
+  return true;
+}
+
+static bool ww_incremental_write_range(WriteWrapIncremental *wwi,
+                                       const char *buf,
+                                       size_t buf_len,
+                                       off64_t offset)
+{
+  if (!ww_incremental_seek(wwi, offset) ||
+      write(wwi->file_handle, buf, buf_len) != (ssize_t)buf_len) {
+    return false;
+  }
+  wwi->file_offset += buf_len;
+  wwi->write_len += buf_len;
+  return true;
+}
+
+static size_t ww_write_incremental(WriteWrap *ww, const char *buf, size_t buf_len)
+{
+  WriteWrapIncremental *wwi = INCREMENTAL_HANDLE(ww);
+  if (wwi->error) {
+    return 0;
+  }
+
+  size_t buf_offset = 0;
+  while (buf_offset < buf_len) {
+    const off64_t offset = wwi->offset + buf_offset;
+
+    /* Past the end of the existing file, everything is written. */
+    if (offset >= wwi->file_len_old) {
+      if (!ww_incremental_write_range(wwi, buf + buf_offset, buf_len - buf_offset, offset)) {
+        wwi->error = true;
+        return 0;
+      }
+      buf_offset = buf_len;
+      break;
+    }
+
+    /* Read the existing data, clamped so blocks stay aligned to file offsets. */
+    size_t read_len = WW_INCREMENTAL_READ_SIZE - (size_t)(offset % WW_INCREMENTAL_BLOCK_SIZE);
+    read_len = MIN2(read_len, buf_len - buf_offset);
+    read_len = MIN2(read_len, (size_t)(wwi->file_len_old - offset));
+    if (!ww_incremental_seek(wwi, offset) ||
+        read(wwi->file_handle, wwi->buf_old, read_len) != (ssize_t)read_len) {
+      wwi->error = true;
+      return 0;
+    }
+    wwi->file_offset += read_len;
+
+    /* Write runs of blocks that changed. */
+    size_t block_offset = 0;
+    while (block_offset < read_len) {
+      const size_t block_start = (size_t)((offset + block_offset) % WW_INCREMENTAL_BLOCK_SIZE);
+      const size_t block_len = MIN2(WW_INCREMENTAL_BLOCK_SIZE - block_start,
+                                    read_len - block_offset);
+      const char *block = buf + buf_offset + block_offset;
+      if (memcmp(block, wwi->buf_old + block_offset, block_len) != 0) {
+        if (!ww_incremental_write_range(wwi, block, block_len, offset + block_offset)) {
+          wwi->error = true;
+          return 0;
+        }
+      }
+      block_offset += block_len;
+    }
+
+    buf_offset += read_len;
+  }
+
+  wwi->offset += buf_len;
+  return buf_len;
+}
+#undef INCREMENTAL_HANDLE
 
 /* --- end compression types --- */
 
@@ -288,13 +604,20 @@ static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
   memset(r_ww, 0, sizeof(*r_ww));
 
   switch (ww_type) {
-    case WW_WRAP_ZLIB: {
-      r_ww->open = ww_open_zlib;
-      r_ww->close = ww_close_zlib;
-      r_ww->write = ww_write_zlib;
+    case WW_WRAP_ZLIB_FRAMES: {
+      r_ww->open = ww_open_zlib_frames;
+      r_ww->close = ww_close_zlib_frames;
+      r_ww->write = ww_write_zlib_frames;
       r_ww->use_buf = false;
       break;
     }
+    case WW_WRAP_INCREMENTAL: {
+      r_ww->open = ww_open_incremental;
+      r_ww->close = ww_close_incremental;
+      r_ww->write = ww_write_incremental;
+      r_ww->use_buf = true;
+      break;
+    }
     default: {
       r_ww->open = ww_open_none;
       r_ww->close = ww_close_none;
@@ -4359,6 +4682,7 @@ bool BLO_write_file(Main *mainvar,
   const bool use_save_as_copy = params->use_save_as_copy;
   const bool use_userdef = params->use_userdef;
   const BlendThumbnail *thumb = params->thumb;
+  bool use_incremental = params->use_incremental;
 
   /* path backup/restore */
   void *path_list_backup = NULL;
@@ -4370,14 +4694,27 @@ bool BLO_write_file(Main *mainvar,
     BLO_main_validate_shapekeys(mainvar, reports);
   }
 
-  /* open temporary file, so we preserve the original in case we crash */
-  BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
+  if (use_incremental) {
+    if ((write_flags & G_FILE_COMPRESS) || use_save_versions || !ww_incremental_poll(filepath)) {
+      use_incremental = false;
+    }
+  }
 
-  if (write_flags & G_FILE_COMPRESS) {
-    ww_type = WW_WRAP_ZLIB;
+  if (use_incremental) {
+    /* Write directly into the existing file. */
+    BLI_strncpy(tempname, filepath, sizeof(tempname));
+    ww_type = WW_WRAP_INCREMENTAL;
   }
   else {
-    ww_type = WW_WRAP_NONE;
+    /* open temporary file, so we preserve the original in case we crash */
+    BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
+
+    if (write_flags & G_FILE_COMPRESS) {
+      ww_type = WW_WRAP_ZLIB_FRAMES;
+    }
+    else {
+      ww_type = WW_WRAP_NONE;
+    }
   }
 
   ww_handle_init(ww_type, &ww);
@@ -4449,9 +4786,12 @@ bool BLO_write_file(Main *mainvar,
   }
 
   /* actual file writing */
-  const bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, use_userdef, thumb);
+  bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, use_userdef, thumb);
 
-  ww.close(&ww);
+  /* Framed compression writes its remaining frames on close, so failure here is an error too. */
+  if (ww.close(&ww) == false) {
+    err = true;
+  }
 
   if (UNLIKELY(path_list_backup)) {
     BKE_bpath_list_restore(mainvar, path_list_flag, path_list_backup);
@@ -4460,24 +4800,32 @@ bool BLO_write_file(Main *mainvar,
 
   if (err) {
     BKE_report(reports, RPT_ERROR, strerror(errno));
-    remove(tempname);
+    if (use_incremental) {
+      BKE_reportf(reports, RPT_ERROR, "Incremental save failed, '%s' may be damaged", filepath);
+    }
+    else {
+      remove(tempname);
+    }
 
     return 0;
   }
 
-  /* file save to temporary file was successful */
-  /* now do reverse file history (move .blend1 -> .blend2, .blend -> .blend1) */
-  if (use_save_versions) {
-    const bool err_hist = do_history(filepath, reports);
-    if (err_hist) {
-      BKE_report(reports, RPT_ERROR, "Version backup failed (file saved with @)");
-      return 0;
+  /* When saving incrementally the file was updated in place, there is nothing to move. */
+  if (!use_incremental) {
+    /* file save to temporary file was successful */
+    /* now do reverse file history (move .blend1 -> .blend2, .blend -> .blend1) */
+    if (use_save_versions) {
+      const bool err_hist = do_history(filepath, reports);
+      if (err_hist) {
+        BKE_report(reports, RPT_ERROR, "Version backup failed (file saved with @)");
+        return 0;
+      }
     }
-  }
 
-  if (BLI_rename(tempname, filepath) != 0) {
-    BKE_report(reports, RPT_ERROR, "Cannot change old file (file saved with @)");
-    return 0;
+    if (BLI_rename(tempname, filepath) != 0) {
+      BKE_report(reports, RPT_ERROR, "Cannot change old file (file saved with @)");
+      return 0;
+    }
   }
 
   if (G.debug & G_DEBUG_IO && mainvar->lock != NULL) {
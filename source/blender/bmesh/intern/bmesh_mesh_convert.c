@@ -81,6 +81,7 @@
 #include "BLI_alloca.h"
 #include "BLI_listbase.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_mesh.h"
@@ -174,6 +175,83 @@ static BMFace *bm_face_create_from_mpoly(
   return BM_face_create(bm, verts, edges, mp->totloop, NULL, BM_CREATE_SKIP_CD);
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Mesh -> BMesh Element Attributes
+ *
+ * Elements are created one after another (the memory pools aren't thread-safe),
+ * their custom-data and other attributes are then filled in parallel.
+ * \{ */
+
+typedef struct BMeshFromMeshData {
+  const Mesh *me;
+  BMVert **vtable;
+  BMEdge **etable;
+  BMFace **ftable;
+
+  int cd_vert_bweight_offset;
+  int cd_edge_bweight_offset;
+  int cd_edge_crease_offset;
+  int cd_shape_key_offset;
+  int cd_shape_keyindex_offset;
+  const float (**shape_key_table)[3];
+  int tot_shape_keys;
+} BMeshFromMeshData;
+
+static void bm_from_me_vert_attrs_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMeshFromMeshData *data = userdata;
+  BMVert *v = data->vtable[i];
+
+  if (data->cd_vert_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(
+        v, data->cd_vert_bweight_offset, (float)data->me->mvert[i].bweight / 255.0f);
+  }
+
+  /* Set shape key original index. */
+  if (data->cd_shape_keyindex_offset != -1) {
+    BM_ELEM_CD_SET_INT(v, data->cd_shape_keyindex_offset, i);
+  }
+
+  /* Set shape-key data. */
+  if (data->tot_shape_keys) {
+    float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, data->cd_shape_key_offset);
+    for (int j = 0; j < data->tot_shape_keys; j++, co_dst++) {
+      copy_v3_v3(*co_dst, data->shape_key_table[j][i]);
+    }
+  }
+}
+
+static void bm_from_me_edge_attrs_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMeshFromMeshData *data = userdata;
+  BMEdge *e = data->etable[i];
+  const MEdge *medge = &data->me->medge[i];
+
+  if (data->cd_edge_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
+  }
+  if (data->cd_edge_crease_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_crease_offset, (float)medge->crease / 255.0f);
+  }
+}
+
+static void bm_from_me_face_normal_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMeshFromMeshData *data = userdata;
+  BMFace *f = data->ftable[i];
+  if (f != NULL) {
+    BM_face_normal_update(f);
+  }
+}
+
+/** \} */
+
 /**
  * \brief Mesh -> BMesh
  * \param bm: The mesh to write into, while this is typically a newly created BMesh,
@@ -196,6 +274,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
   BMVert *v, **vtable = NULL;
   BMEdge *e, **etable = NULL;
   BMFace *f, **ftable = NULL;
+  BMLoop **ltable = NULL;
   float(*keyco)[3] = NULL;
   int totloops, i;
   CustomData_MeshMasks mask = CD_MASK_BMESH;
@@ -318,31 +397,32 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
     }
 
     normal_short_to_float_v3(v->no, mvert->no);
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->vdata, &bm->vdata, i, &v->head.data, true);
-
-    if (cd_vert_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(v, cd_vert_bweight_offset, (float)mvert->bweight / 255.0f);
-    }
-
-    /* Set shape key original index. */
-    if (cd_shape_keyindex_offset != -1) {
-      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
-    }
-
-    /* Set shape-key data. */
-    if (tot_shape_keys) {
-      float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
-      for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
-        copy_v3_v3(*co_dst, shape_key_table[j][i]);
-      }
-    }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
   }
 
+  BMeshFromMeshData data = {
+      .me = me,
+      .vtable = vtable,
+      .cd_vert_bweight_offset = cd_vert_bweight_offset,
+      .cd_edge_bweight_offset = cd_edge_bweight_offset,
+      .cd_edge_crease_offset = cd_edge_crease_offset,
+      .cd_shape_key_offset = cd_shape_key_offset,
+      .cd_shape_keyindex_offset = cd_shape_keyindex_offset,
+      .shape_key_table = shape_key_table,
+      .tot_shape_keys = tot_shape_keys,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+
+  /* Copy Custom Data */
+  CustomData_to_bmesh_blocks(&me->vdata, &bm->vdata, (BMHeader **)vtable, me->totvert, true);
+  if ((cd_vert_bweight_offset != -1) || (cd_shape_keyindex_offset != -1) || tot_shape_keys) {
+    BLI_task_parallel_range(0, me->totvert, &data, bm_from_me_vert_attrs_cb, &settings);
+  }
+
   etable = MEM_mallocN(sizeof(BMEdge **) * me->totedge, __func__);
 
   medge = me->medge;
@@ -358,36 +438,29 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
     if (medge->flag & SELECT) {
       BM_edge_select_set(bm, e, true);
     }
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->edata, &bm->edata, i, &e->head.data, true);
-
-    if (cd_edge_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
-    }
-    if (cd_edge_crease_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_crease_offset, (float)medge->crease / 255.0f);
-    }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_EDGE; /* Added in order, clear dirty flag. */
   }
 
-  /* Only needed for selection. */
-  if (me->mselect && me->totselect != 0) {
-    ftable = MEM_mallocN(sizeof(BMFace **) * me->totpoly, __func__);
+  /* Copy Custom Data */
+  data.etable = etable;
+  CustomData_to_bmesh_blocks(&me->edata, &bm->edata, (BMHeader **)etable, me->totedge, true);
+  if ((cd_edge_bweight_offset != -1) || (cd_edge_crease_offset != -1)) {
+    BLI_task_parallel_range(0, me->totedge, &data, bm_from_me_edge_attrs_cb, &settings);
   }
 
+  /* Indexed by the mesh elements, skipped faces (and their loops) are NULL. */
+  ftable = MEM_mallocN(sizeof(BMFace **) * me->totpoly, __func__);
+  ltable = MEM_callocN(sizeof(BMLoop **) * me->totloop, __func__);
+
   mloop = me->mloop;
   mp = me->mpoly;
   for (i = 0, totloops = 0; i < me->totpoly; i++, mp++) {
     BMLoop *l_iter;
     BMLoop *l_first;
 
-    f = bm_face_create_from_mpoly(mp, mloop + mp->loopstart, bm, vtable, etable);
-    if (ftable != NULL) {
-      ftable[i] = f;
-    }
+    f = ftable[i] = bm_face_create_from_mpoly(mp, mloop + mp->loopstart, bm, vtable, etable);
 
     if (UNLIKELY(f == NULL)) {
       printf(
@@ -422,20 +495,23 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
       BM_elem_index_set(l_iter, totloops++); /* set_ok */
 
       /* Save index of corresponding #MLoop. */
-      CustomData_to_bmesh_block(&me->ldata, &bm->ldata, j++, &l_iter->head.data, true);
+      ltable[j++] = l_iter;
     } while ((l_iter = l_iter->next) != l_first);
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->pdata, &bm->pdata, i, &f->head.data, true);
-
-    if (params->calc_face_normal) {
-      BM_face_normal_update(f);
-    }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
   }
 
+  /* Copy Custom Data */
+  CustomData_to_bmesh_blocks(&me->ldata, &bm->ldata, (BMHeader **)ltable, me->totloop, true);
+  CustomData_to_bmesh_blocks(&me->pdata, &bm->pdata, (BMHeader **)ftable, me->totpoly, true);
+  MEM_freeN(ltable);
+
+  if (params->calc_face_normal) {
+    data.ftable = ftable;
+    BLI_task_parallel_range(0, me->totpoly, &data, bm_from_me_face_normal_cb, &settings);
+  }
+
   /* -------------------------------------------------------------------- */
   /* MSelect clears the array elements (avoid adding multiple times).
    *
@@ -472,9 +548,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
 
   MEM_freeN(vtable);
   MEM_freeN(etable);
-  if (ftable) {
-    MEM_freeN(ftable);
-  }
+  MEM_freeN(ftable);
 }
 
 /**
@@ -555,6 +629,27 @@ BLI_INLINE void bmesh_quick_edgedraw_flag(MEdge *med, BMEdge *e)
   }
 }
 
+/* Custom-data blocks of all elements, to copy the layers one at a time
+ * (see #CustomData_from_bmesh_blocks). NULL when there is no custom-data to copy. */
+static void **bm_to_me_cd_blocks_alloc(const CustomData *cd, const int totelem)
+{
+  if ((cd->totlayer == 0) || (totelem == 0)) {
+    return NULL;
+  }
+  return MEM_malloc_arrayN((size_t)totelem, sizeof(void *), __func__);
+}
+
+static void bm_to_me_cd_blocks_copy(const CustomData *source,
+                                    CustomData *dest,
+                                    void **blocks,
+                                    const int totelem)
+{
+  if (blocks) {
+    CustomData_from_bmesh_blocks(source, dest, blocks, totelem);
+    MEM_freeN(blocks);
+  }
+}
+
 /**
  *
  * \param bmain: May be NULL in case \a calc_object_remap parameter option is not set.
@@ -583,19 +678,23 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
 #if 0
   oldverts = MEM_dupallocN(me->mvert);
 #else
-    oldverts = me->mvert;
+    /* Data shared with evaluated copies must not be taken over. */
+    oldverts = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
     me->mvert = NULL;
     CustomData_update_typemap(&me->vdata);
     CustomData_set_layer(&me->vdata, CD_MVERT, NULL);
 #endif
   }
 
-  /* Free custom data. */
-  CustomData_free(&me->vdata, me->totvert);
-  CustomData_free(&me->edata, me->totedge);
+  /* Free custom data once the new data is written, to keep the arrays which didn't change. */
+  CustomData vdata_old = me->vdata, edata_old = me->edata, ldata_old = me->ldata,
+             pdata_old = me->pdata;
+  const int ototedge = me->totedge, ototloop = me->totloop, ototpoly = me->totpoly;
+  CustomData_reset(&me->vdata);
+  CustomData_reset(&me->edata);
+  CustomData_reset(&me->ldata);
+  CustomData_reset(&me->pdata);
   CustomData_free(&me->fdata, me->totface);
-  CustomData_free(&me->ldata, me->totloop);
-  CustomData_free(&me->pdata, me->totpoly);
 
   /* Add new custom data. */
   me->totvert = bm->totvert;
@@ -631,6 +730,11 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   /* This is called again, 'dotess' arg is used there. */
   BKE_mesh_update_customdata_pointers(me, 0);
 
+  void **vert_blocks = bm_to_me_cd_blocks_alloc(&bm->vdata, me->totvert);
+  void **edge_blocks = bm_to_me_cd_blocks_alloc(&bm->edata, me->totedge);
+  void **loop_blocks = bm_to_me_cd_blocks_alloc(&bm->ldata, me->totloop);
+  void **poly_blocks = bm_to_me_cd_blocks_alloc(&bm->pdata, me->totpoly);
+
   i = 0;
   BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
     copy_v3_v3(mvert->co, v->co);
@@ -640,8 +744,9 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
 
     BM_elem_index_set(v, i); /* set_inline */
 
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->vdata, &me->vdata, v->head.data, i);
+    if (vert_blocks) {
+      vert_blocks[i] = v->head.data;
+    }
 
     if (cd_vert_bweight_offset != -1) {
       mvert->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, cd_vert_bweight_offset);
@@ -653,6 +758,8 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
     BM_CHECK_ELEMENT(v);
   }
   bm->elem_index_dirty &= ~BM_VERT;
+  /* Copy over custom-data. */
+  bm_to_me_cd_blocks_copy(&bm->vdata, &me->vdata, vert_blocks, me->totvert);
 
   med = medge;
   i = 0;
@@ -664,8 +771,9 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
 
     BM_elem_index_set(e, i); /* set_inline */
 
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->edata, &me->edata, e->head.data, i);
+    if (edge_blocks) {
+      edge_blocks[i] = e->head.data;
+    }
 
     bmesh_quick_edgedraw_flag(med, e);
 
@@ -681,6 +789,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
     BM_CHECK_ELEMENT(e);
   }
   bm->elem_index_dirty &= ~BM_EDGE;
+  bm_to_me_cd_blocks_copy(&bm->edata, &me->edata, edge_blocks, me->totedge);
 
   i = 0;
   j = 0;
@@ -696,8 +805,9 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
       mloop->e = BM_elem_index_get(l_iter->e);
       mloop->v = BM_elem_index_get(l_iter->v);
 
-      /* Copy over custom-data. */
-      CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
+      if (loop_blocks) {
+        loop_blocks[j] = l_iter->head.data;
+      }
 
       j++;
       mloop++;
@@ -710,13 +820,16 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
       me->act_face = i;
     }
 
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->pdata, &me->pdata, f->head.data, i);
+    if (poly_blocks) {
+      poly_blocks[i] = f->head.data;
+    }
 
     i++;
     mpoly++;
     BM_CHECK_ELEMENT(f);
   }
+  bm_to_me_cd_blocks_copy(&bm->ldata, &me->ldata, loop_blocks, me->totloop);
+  bm_to_me_cd_blocks_copy(&bm->pdata, &me->pdata, poly_blocks, me->totpoly);
 
   /* Patch hook indices and vertex parents. */
   if (params->calc_object_remap && (ototvert > 0)) {
@@ -976,6 +1089,16 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
     MEM_freeN(oldverts);
   }
 
+  CustomData_keep_unchanged_layers(&me->vdata, &vdata_old, me->totvert, ototvert);
+  CustomData_keep_unchanged_layers(&me->edata, &edata_old, me->totedge, ototedge);
+  CustomData_keep_unchanged_layers(&me->ldata, &ldata_old, me->totloop, ototloop);
+  CustomData_keep_unchanged_layers(&me->pdata, &pdata_old, me->totpoly, ototpoly);
+  CustomData_free(&vdata_old, ototvert);
+  CustomData_free(&edata_old, ototedge);
+  CustomData_free(&ldata_old, ototloop);
+  CustomData_free(&pdata_old, ototpoly);
+  BKE_mesh_update_customdata_pointers(me, false);
+
   /* Topology could be changed, ensure #CD_MDISPS are ok. */
   multires_topology_changed(me);
 
@@ -1055,6 +1178,11 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
   /* Don't add origindex layer if one already exists. */
   add_orig = !CustomData_has_layer(&bm->pdata, CD_ORIGINDEX);
 
+  void **vert_blocks = bm_to_me_cd_blocks_alloc(&bm->vdata, me->totvert);
+  void **edge_blocks = bm_to_me_cd_blocks_alloc(&bm->edata, me->totedge);
+  void **loop_blocks = bm_to_me_cd_blocks_alloc(&bm->ldata, me->totloop);
+  void **poly_blocks = bm_to_me_cd_blocks_alloc(&bm->pdata, me->totpoly);
+
   index = CustomData_get_layer(&me->vdata, CD_ORIGINDEX);
 
   BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, i) {
@@ -1076,9 +1204,12 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
       *index++ = i;
     }
 
-    CustomData_from_bmesh_block(&bm->vdata, &me->vdata, eve->head.data, i);
+    if (vert_blocks) {
+      vert_blocks[i] = eve->head.data;
+    }
   }
   bm->elem_index_dirty &= ~BM_VERT;
+  bm_to_me_cd_blocks_copy(&bm->vdata, &me->vdata, vert_blocks, me->totvert);
 
   index = CustomData_get_layer(&me->edata, CD_ORIGINDEX);
   BM_ITER_MESH_INDEX (eed, &iter, bm, BM_EDGES_OF_MESH, i) {
@@ -1106,12 +1237,15 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
       med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(eed, cd_edge_bweight_offset);
     }
 
-    CustomData_from_bmesh_block(&bm->edata, &me->edata, eed->head.data, i);
+    if (edge_blocks) {
+      edge_blocks[i] = eed->head.data;
+    }
     if (add_orig) {
       *index++ = i;
     }
   }
   bm->elem_index_dirty &= ~BM_EDGE;
+  bm_to_me_cd_blocks_copy(&bm->edata, &me->edata, edge_blocks, me->totedge);
 
   index = CustomData_get_layer(&me->pdata, CD_ORIGINDEX);
   j = 0;
@@ -1131,7 +1265,9 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
     do {
       mloop->v = BM_elem_index_get(l_iter->v);
       mloop->e = BM_elem_index_get(l_iter->e);
-      CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
+      if (loop_blocks) {
+        loop_blocks[j] = l_iter->head.data;
+      }
 
       BM_elem_index_set(l_iter, j); /* set_inline */
 
@@ -1139,13 +1275,17 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
       mloop++;
     } while ((l_iter = l_iter->next) != l_first);
 
-    CustomData_from_bmesh_block(&bm->pdata, &me->pdata, efa->head.data, i);
+    if (poly_blocks) {
+      poly_blocks[i] = efa->head.data;
+    }
 
     if (add_orig) {
       *index++ = i;
     }
   }
   bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP);
+  bm_to_me_cd_blocks_copy(&bm->ldata, &me->ldata, loop_blocks, me->totloop);
+  bm_to_me_cd_blocks_copy(&bm->pdata, &me->pdata, poly_blocks, me->totpoly);
 
   me->cd_flag = BM_mesh_cd_flag_from_bmesh(bm);
 }
@@ -148,7 +148,8 @@ static BMOpDefine bmo_smooth_vert_def = {
   },
   {{{'\0'}}},  /* no output */
   bmo_smooth_vert_exec,
-  (BMO_OPTYPE_FLAG_NORMALS_CALC),
+  (BMO_OPTYPE_FLAG_NORMALS_CALC |
+   BMO_OPTYPE_FLAG_ELEM_PARALLEL),
 };
 
 /*
@@ -819,7 +820,8 @@ static BMOpDefine bmo_transform_def = {
   },
   {{{'\0'}}},  /* no output */
   bmo_transform_exec,
-  (BMO_OPTYPE_FLAG_NORMALS_CALC),
+  (BMO_OPTYPE_FLAG_NORMALS_CALC |
+   BMO_OPTYPE_FLAG_ELEM_PARALLEL),
 };
 
 /*
@@ -307,6 +307,11 @@ typedef enum {
   BMO_OPTYPE_FLAG_SELECT_FLUSH = (1 << 2),
   BMO_OPTYPE_FLAG_SELECT_VALIDATE = (1 << 3),
   BMO_OPTYPE_FLAG_INVALIDATE_CLNOR_ALL = (1 << 4),
+  /**
+   * Elements of the input buffers are processed independently of each other,
+   * so #BMO_slot_buffer_iter_parallel may split the iteration over multiple threads.
+   */
+  BMO_OPTYPE_FLAG_ELEM_PARALLEL = (1 << 5),
 } BMOpTypeFlag;
 
 typedef struct BMOperator {
@@ -661,6 +666,21 @@ bool BMO_iter_map_value_bool(BMOIter *iter);
        ele; \
        BM_CHECK_TYPE_ELEM_ASSIGN(ele) = BMO_iter_step(iter), i_++)
 
+/**
+ * Callback for #BMO_slot_buffer_iter_parallel,
+ * \a index is the position of \a ele in the slot buffer.
+ */
+typedef void (*BMOSlotIterParallelFunc)(void *__restrict userdata,
+                                        BMElem *ele,
+                                        const int index);
+
+void BMO_slot_buffer_iter_parallel(BMOperator *op,
+                                   BMOpSlot slot_args[BMO_OP_MAX_SLOTS],
+                                   const char *slot_name,
+                                   const char restrictmask,
+                                   void *userdata,
+                                   BMOSlotIterParallelFunc func);
+
 extern const int BMO_OPSLOT_TYPEINFO[BMO_OP_SLOT_TOTAL_TYPES];
 
 int BMO_opcode_from_opname(const char *opname);
@@ -27,6 +27,7 @@
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -1522,6 +1523,57 @@ void *BMO_iter_step(BMOIter *iter)
   return NULL;
 }
 
+typedef struct BMOSlotIterParallelData {
+  BMHeader **buf;
+  char restrictmask;
+  void *userdata;
+  BMOSlotIterParallelFunc func;
+} BMOSlotIterParallelData;
+
+static void bmo_slot_buffer_iter_parallel_cb(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BMOSlotIterParallelData *data = userdata;
+  BMHeader *ele = data->buf[i];
+  if (data->restrictmask & ele->htype) {
+    data->func(data->userdata, (BMElem *)ele, i);
+  }
+}
+
+/**
+ * Run \a func for every element of a slot buffer.
+ *
+ * The elements are only processed in parallel when the operator is flagged with
+ * #BMO_OPTYPE_FLAG_ELEM_PARALLEL, this means \a func may only modify the element it's passed
+ * (and data at \a index owned by the operator), reading neighboring elements is fine as long as
+ * they aren't modified in the same pass.
+ */
+void BMO_slot_buffer_iter_parallel(BMOperator *op,
+                                   BMOpSlot slot_args[BMO_OP_MAX_SLOTS],
+                                   const char *slot_name,
+                                   const char restrictmask,
+                                   void *userdata,
+                                   BMOSlotIterParallelFunc func)
+{
+  BMOpSlot *slot = BMO_slot_get(slot_args, slot_name);
+  BLI_assert(slot->slot_type == BMO_OP_SLOT_ELEMENT_BUF);
+  BLI_assert(restrictmask & slot->slot_subtype.elem);
+
+  BMOSlotIterParallelData data = {
+      .buf = (BMHeader **)slot->data.buf,
+      .restrictmask = restrictmask,
+      .userdata = userdata,
+      .func = func,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (op->type_flag & BMO_OPTYPE_FLAG_ELEM_PARALLEL) != 0;
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, slot->len, &data, bmo_slot_buffer_iter_parallel_cb, &settings);
+}
+
 /* used for iterating over mappings */
 
 /**
@@ -46,10 +46,15 @@ void bmo_create_vert_exec(BMesh *bm, BMOperator *op)
   BMO_slot_buffer_from_enabled_flag(bm, op, op->slots_out, "vert.out", BM_VERT, ELE_NEW);
 }
 
+static void bmo_transform_vert_cb(void *__restrict userdata, BMElem *ele, const int UNUSED(i))
+{
+  const float(*mat)[4] = userdata;
+  BMVert *v = (BMVert *)ele;
+  mul_m4_v3(mat, v->co);
+}
+
 void bmo_transform_exec(BMesh *UNUSED(bm), BMOperator *op)
 {
-  BMOIter iter;
-  BMVert *v;
   float mat[4][4], mat_space[4][4], imat_space[4][4];
 
   BMO_slot_mat4_get(op->slots_in, "matrix", mat);
@@ -60,9 +65,7 @@ void bmo_transform_exec(BMesh *UNUSED(bm), BMOperator *op)
     mul_m4_series(mat, imat_space, mat, mat_space);
   }
 
-  BMO_ITER (v, &iter, op->slots_in, "verts", BM_VERT) {
-    mul_m4_v3(mat, v->co);
-  }
+  BMO_slot_buffer_iter_parallel(op, op->slots_in, "verts", BM_VERT, mat, bmo_transform_vert_cb);
 }
 
 void bmo_translate_exec(BMesh *bm, BMOperator *op)
@@ -351,78 +354,86 @@ void bmo_region_extend_exec(BMesh *bm, BMOperator *op)
   BMO_slot_buffer_from_enabled_flag(bm, op, op->slots_out, "geom.out", BM_ALL_NOLOOP, SEL_FLAG);
 }
 
-void bmo_smooth_vert_exec(BMesh *UNUSED(bm), BMOperator *op)
+typedef struct SmoothVertData {
+  float (*cos)[3];
+  float fac;
+  float clip_dist;
+  bool clip[3];
+  bool axis[3];
+} SmoothVertData;
+
+static void bmo_smooth_vert_calc_cb(void *__restrict userdata, BMElem *ele, const int i)
 {
-  BMOIter siter;
+  const SmoothVertData *data = userdata;
+  BMVert *v = (BMVert *)ele;
   BMIter iter;
-  BMVert *v;
   BMEdge *e;
-  float(*cos)[3] = MEM_mallocN(sizeof(*cos) * BMO_slot_buffer_count(op->slots_in, "verts"),
-                               __func__);
-  float *co, *co2, clip_dist = BMO_slot_float_get(op->slots_in, "clip_dist");
-  const float fac = BMO_slot_float_get(op->slots_in, "factor");
-  int i, j, clipx, clipy, clipz;
-  int xaxis, yaxis, zaxis;
-
-  clipx = BMO_slot_bool_get(op->slots_in, "mirror_clip_x");
-  clipy = BMO_slot_bool_get(op->slots_in, "mirror_clip_y");
-  clipz = BMO_slot_bool_get(op->slots_in, "mirror_clip_z");
-
-  xaxis = BMO_slot_bool_get(op->slots_in, "use_axis_x");
-  yaxis = BMO_slot_bool_get(op->slots_in, "use_axis_y");
-  zaxis = BMO_slot_bool_get(op->slots_in, "use_axis_z");
-
-  i = 0;
-  BMO_ITER (v, &siter, op->slots_in, "verts", BM_VERT) {
-
-    co = cos[i];
-    zero_v3(co);
-
-    j = 0;
-    BM_ITER_ELEM (e, &iter, v, BM_EDGES_OF_VERT) {
-      co2 = BM_edge_other_vert(e, v)->co;
-      add_v3_v3v3(co, co, co2);
-      j += 1;
-    }
-
-    if (!j) {
-      copy_v3_v3(co, v->co);
-      i++;
-      continue;
-    }
+  float *co = data->cos[i];
+  int j = 0;
 
-    mul_v3_fl(co, 1.0f / (float)j);
-    interp_v3_v3v3(co, v->co, co, fac);
+  zero_v3(co);
 
-    if (clipx && fabsf(v->co[0]) <= clip_dist) {
-      co[0] = 0.0f;
-    }
-    if (clipy && fabsf(v->co[1]) <= clip_dist) {
-      co[1] = 0.0f;
-    }
-    if (clipz && fabsf(v->co[2]) <= clip_dist) {
-      co[2] = 0.0f;
-    }
+  BM_ITER_ELEM (e, &iter, v, BM_EDGES_OF_VERT) {
+    add_v3_v3(co, BM_edge_other_vert(e, v)->co);
+    j += 1;
+  }
 
-    i++;
+  if (!j) {
+    copy_v3_v3(co, v->co);
+    return;
   }
 
-  i = 0;
-  BMO_ITER (v, &siter, op->slots_in, "verts", BM_VERT) {
-    if (xaxis) {
-      v->co[0] = cos[i][0];
-    }
-    if (yaxis) {
-      v->co[1] = cos[i][1];
-    }
-    if (zaxis) {
-      v->co[2] = cos[i][2];
+  mul_v3_fl(co, 1.0f / (float)j);
+  interp_v3_v3v3(co, v->co, co, data->fac);
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (data->clip[axis] && fabsf(v->co[axis]) <= data->clip_dist) {
+      co[axis] = 0.0f;
     }
+  }
+}
+
+static void bmo_smooth_vert_apply_cb(void *__restrict userdata, BMElem *ele, const int i)
+{
+  const SmoothVertData *data = userdata;
+  BMVert *v = (BMVert *)ele;
 
-    i++;
+  for (int axis = 0; axis < 3; axis++) {
+    if (data->axis[axis]) {
+      v->co[axis] = data->cos[i][axis];
+    }
   }
+}
 
-  MEM_freeN(cos);
+void bmo_smooth_vert_exec(BMesh *UNUSED(bm), BMOperator *op)
+{
+  SmoothVertData data = {
+      .cos = MEM_mallocN(sizeof(*data.cos) * BMO_slot_buffer_count(op->slots_in, "verts"),
+                         __func__),
+      .fac = BMO_slot_float_get(op->slots_in, "factor"),
+      .clip_dist = BMO_slot_float_get(op->slots_in, "clip_dist"),
+      .clip =
+          {
+              BMO_slot_bool_get(op->slots_in, "mirror_clip_x"),
+              BMO_slot_bool_get(op->slots_in, "mirror_clip_y"),
+              BMO_slot_bool_get(op->slots_in, "mirror_clip_z"),
+          },
+      .axis =
+          {
+              BMO_slot_bool_get(op->slots_in, "use_axis_x"),
+              BMO_slot_bool_get(op->slots_in, "use_axis_y"),
+              BMO_slot_bool_get(op->slots_in, "use_axis_z"),
+          },
+  };
+
+  /* All new coordinates are calculated before any are applied,
+   * so neighboring vertices can be read from other threads. */
+  BMO_slot_buffer_iter_parallel(
+      op, op->slots_in, "verts", BM_VERT, &data, bmo_smooth_vert_calc_cb);
+  BMO_slot_buffer_iter_parallel(
+      op, op->slots_in, "verts", BM_VERT, &data, bmo_smooth_vert_apply_cb);
+
+  MEM_freeN(data.cos);
 }
 
 /**************************************************************************** *
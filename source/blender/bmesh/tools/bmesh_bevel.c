@@ -31,6 +31,8 @@
 #include "BLI_array.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_curveprofile.h"
@@ -313,6 +315,8 @@ typedef struct BevelParams {
   GHash *face_hash;
   /** Use for all allocs while bevel runs. Note: If we need to free we can switch to mempool. */
   MemArena *mem_arena;
+  /** Protects #mem_arena while BevVerts are analyzed in parallel, see #bevel_mem_alloc. */
+  SpinLock mem_arena_lock;
   /** Profile vertex location and spacings. */
   ProfileSpacing pro_spacing;
   /** Parameter values for evenly spaced profile points for the miter profiles. */
@@ -428,11 +432,21 @@ static bool nearly_parallel(const float d1[3], const float d2[3])
   return (fabsf(ang) < BEVEL_EPSILON_ANG) || (fabsf(ang - (float)M_PI) < BEVEL_EPSILON_ANG);
 }
 
+/* Allocate from the bevel memory arena.
+ * Use this for memory allocated while analyzing BevVerts, which may run in parallel. */
+static void *bevel_mem_alloc(BevelParams *bp, size_t size)
+{
+  BLI_spin_lock(&bp->mem_arena_lock);
+  void *ptr = BLI_memarena_alloc(bp->mem_arena, size);
+  BLI_spin_unlock(&bp->mem_arena_lock);
+  return ptr;
+}
+
 /* Make a new BoundVert of the given kind, inserting it at the end of the circular linked
  * list with entry point bv->boundstart, and return it. */
-static BoundVert *add_new_bound_vert(MemArena *mem_arena, VMesh *vm, const float co[3])
+static BoundVert *add_new_bound_vert(BevelParams *bp, VMesh *vm, const float co[3])
 {
-  BoundVert *ans = (BoundVert *)BLI_memarena_alloc(mem_arena, sizeof(BoundVert));
+  BoundVert *ans = (BoundVert *)bevel_mem_alloc(bp, sizeof(BoundVert));
 
   copy_v3_v3(ans->nv.co, co);
   if (!vm->boundstart) {
@@ -1915,11 +1929,10 @@ static void calculate_profile(BevelParams *bp, BoundVert *bndv, bool reversed, b
 
   need_2 = bp->seg != bp->pro_spacing.seg_2;
   if (!pro->prof_co) {
-    pro->prof_co = (float *)BLI_memarena_alloc(bp->mem_arena,
-                                               ((size_t)bp->seg + 1) * 3 * sizeof(float));
+    pro->prof_co = (float *)bevel_mem_alloc(bp, ((size_t)bp->seg + 1) * 3 * sizeof(float));
     if (need_2) {
-      pro->prof_co_2 = (float *)BLI_memarena_alloc(
-          bp->mem_arena, ((size_t)bp->pro_spacing.seg_2 + 1) * 3 * sizeof(float));
+      pro->prof_co_2 = (float *)bevel_mem_alloc(
+          bp, ((size_t)bp->pro_spacing.seg_2 + 1) * 3 * sizeof(float));
     }
     else {
       pro->prof_co_2 = pro->prof_co;
@@ -2540,7 +2553,7 @@ static void build_boundary_vertex_only(BevelParams *bp, BevVert *bv, bool constr
   do {
     slide_dist(e, bv->v, e->offset_l, co);
     if (construct) {
-      v = add_new_bound_vert(bp->mem_arena, vm, co);
+      v = add_new_bound_vert(bp, vm, co);
       v->efirst = v->elast = e;
       e->leftv = e->rightv = v;
     }
@@ -2573,7 +2586,6 @@ static void build_boundary_terminal_edge(BevelParams *bp,
                                          EdgeHalf *efirst,
                                          const bool construct)
 {
-  MemArena *mem_arena = bp->mem_arena;
   VMesh *vm = bv->vmesh;
   BoundVert *bndv;
   EdgeHalf *e;
@@ -2587,7 +2599,7 @@ static void build_boundary_terminal_edge(BevelParams *bp,
     no = e->fprev ? e->fprev->no : (e->fnext ? e->fnext->no : NULL);
     offset_in_plane(e, no, true, co);
     if (construct) {
-      bndv = add_new_bound_vert(mem_arena, vm, co);
+      bndv = add_new_bound_vert(bp, vm, co);
       bndv->efirst = bndv->elast = bndv->ebev = e;
       e->leftv = bndv;
     }
@@ -2597,7 +2609,7 @@ static void build_boundary_terminal_edge(BevelParams *bp,
     no = e->fnext ? e->fnext->no : (e->fprev ? e->fprev->no : NULL);
     offset_in_plane(e, no, false, co);
     if (construct) {
-      bndv = add_new_bound_vert(mem_arena, vm, co);
+      bndv = add_new_bound_vert(bp, vm, co);
       bndv->efirst = bndv->elast = e;
       e->rightv = bndv;
     }
@@ -2607,7 +2619,7 @@ static void build_boundary_terminal_edge(BevelParams *bp,
     /* Make artificial extra point along unbeveled edge, and form triangle. */
     slide_dist(e->next, bv->v, e->offset_l, co);
     if (construct) {
-      bndv = add_new_bound_vert(mem_arena, vm, co);
+      bndv = add_new_bound_vert(bp, vm, co);
       bndv->efirst = bndv->elast = e->next;
       e->next->leftv = e->next->rightv = bndv;
       set_bound_vert_seams(bv, bp->mark_seam, bp->mark_sharp);
@@ -2623,7 +2635,7 @@ static void build_boundary_terminal_edge(BevelParams *bp,
     /* TODO: should do something else if angle between e and e->prev > 180 */
     offset_meet(e->prev, e, bv->v, e->fprev, false, co, NULL);
     if (construct) {
-      bndv = add_new_bound_vert(mem_arena, vm, co);
+      bndv = add_new_bound_vert(bp, vm, co);
       bndv->efirst = e->prev;
       bndv->elast = bndv->ebev = e;
       e->leftv = bndv;
@@ -2635,7 +2647,7 @@ static void build_boundary_terminal_edge(BevelParams *bp,
     e = e->next;
     offset_meet(e->prev, e, bv->v, e->fprev, false, co, NULL);
     if (construct) {
-      bndv = add_new_bound_vert(mem_arena, vm, co);
+      bndv = add_new_bound_vert(bp, vm, co);
       bndv->efirst = e->prev;
       bndv->elast = e;
       e->leftv = e->rightv = bndv;
@@ -2652,7 +2664,7 @@ static void build_boundary_terminal_edge(BevelParams *bp,
     for (e = e->next; e->next != efirst; e = e->next) {
       slide_dist(e, bv->v, d, co);
       if (construct) {
-        bndv = add_new_bound_vert(mem_arena, vm, co);
+        bndv = add_new_bound_vert(bp, vm, co);
         bndv->efirst = bndv->elast = e;
         e->leftv = e->rightv = bndv;
       }
@@ -2794,7 +2806,6 @@ static void adjust_miter_inner_coords(BevelParams *bp, BevVert *bv, EdgeHalf *em
  */
 static void build_boundary(BevelParams *bp, BevVert *bv, bool construct)
 {
-  MemArena *mem_arena = bp->mem_arena;
   EdgeHalf *efirst, *e, *e2, *e3, *enip, *eip, *eon, *emiter;
   BoundVert *v, *v1, *v2, *v3;
   VMesh *vm;
@@ -2882,7 +2893,7 @@ static void build_boundary(BevelParams *bp, BevVert *bv, bool construct)
     }
 
     if (construct) {
-      v = add_new_bound_vert(mem_arena, vm, co);
+      v = add_new_bound_vert(bp, vm, co);
       v->efirst = e;
       v->elast = e2;
       v->ebev = e2;
@@ -2910,12 +2921,12 @@ static void build_boundary(BevelParams *bp, BevVert *bv, bool construct)
         v1 = v;
         v1->ebev = NULL;
         if (ang_kind == ANGLE_LARGER && miter_outer == BEVEL_MITER_PATCH) {
-          v2 = add_new_bound_vert(mem_arena, vm, co);
+          v2 = add_new_bound_vert(bp, vm, co);
         }
         else {
           v2 = NULL;
         }
-        v3 = add_new_bound_vert(mem_arena, vm, co);
+        v3 = add_new_bound_vert(bp, vm, co);
         v3->ebev = e2;
         v3->efirst = e2;
         v3->elast = e2;
@@ -4166,19 +4177,19 @@ static VMesh *cubic_subdiv(BevelParams *bp, VMesh *vm_in)
 }
 
 /* Special case for cube corner, when r is PRO_SQUARE_R, meaning straight sides. */
-static VMesh *make_cube_corner_square(MemArena *mem_arena, int nseg)
+static VMesh *make_cube_corner_square(BevelParams *bp, int nseg)
 {
   VMesh *vm;
   float co[3];
   int i, j, k, ns2;
 
   ns2 = nseg / 2;
-  vm = new_adj_vmesh(mem_arena, 3, nseg, NULL);
+  vm = new_adj_vmesh(bp->mem_arena, 3, nseg, NULL);
   vm->count = 0; /* Reset, so the following loop will end up with correct count. */
   for (i = 0; i < 3; i++) {
     zero_v3(co);
     co[i] = 1.0f;
-    add_new_bound_vert(mem_arena, vm, co);
+    add_new_bound_vert(bp, vm, co);
   }
   for (i = 0; i < 3; i++) {
     for (j = 0; j <= ns2; j++) {
@@ -4203,7 +4214,7 @@ static VMesh *make_cube_corner_square(MemArena *mem_arena, int nseg)
  * We mostly don't want a VMesh at all for this case -- just a three-way weld
  * with a triangle in the middle for odd nseg.
  */
-static VMesh *make_cube_corner_square_in(MemArena *mem_arena, int nseg)
+static VMesh *make_cube_corner_square_in(BevelParams *bp, int nseg)
 {
   VMesh *vm;
   float co[3];
@@ -4212,12 +4223,12 @@ static VMesh *make_cube_corner_square_in(MemArena *mem_arena, int nseg)
 
   ns2 = nseg / 2;
   odd = nseg % 2;
-  vm = new_adj_vmesh(mem_arena, 3, nseg, NULL);
+  vm = new_adj_vmesh(bp->mem_arena, 3, nseg, NULL);
   vm->count = 0; /* Reset, so following loop will end up with correct count. */
   for (i = 0; i < 3; i++) {
     zero_v3(co);
     co[i] = 1.0f;
-    add_new_bound_vert(mem_arena, vm, co);
+    add_new_bound_vert(bp, vm, co);
   }
   if (odd) {
     b = 2.0f / (2.0f * (float)ns2 + (float)M_SQRT2);
@@ -4258,10 +4269,10 @@ static VMesh *make_cube_corner_adj_vmesh(BevelParams *bp)
 
   if (bp->profile_type != BEVEL_PROFILE_CUSTOM) {
     if (r == PRO_SQUARE_R) {
-      return make_cube_corner_square(mem_arena, nseg);
+      return make_cube_corner_square(bp, nseg);
     }
     if (r == PRO_SQUARE_IN_R) {
-      return make_cube_corner_square_in(mem_arena, nseg);
+      return make_cube_corner_square_in(bp, nseg);
     }
   }
 
@@ -4271,7 +4282,7 @@ static VMesh *make_cube_corner_adj_vmesh(BevelParams *bp)
   for (i = 0; i < 3; i++) {
     zero_v3(co);
     co[i] = 1.0f;
-    add_new_bound_vert(mem_arena, vm0, co);
+    add_new_bound_vert(bp, vm0, co);
   }
   bndv = vm0->boundstart;
   for (i = 0; i < 3; i++) {
@@ -5627,51 +5638,72 @@ static void bevel_vert_two_edges(BevelParams *bp, BMesh *bm, BevVert *bv)
 
 /* Given that the boundary is built, now make the actual BMVerts
  * for the boundary and the interior of the vertex mesh. */
-static void build_vmesh(BevelParams *bp, BMesh *bm, BevVert *bv)
+/* Find the two BoundVerts involved in a weld of two beveled edges, if this is a weld case. */
+static bool vmesh_weld_bound_verts(BevVert *bv, BoundVert **r_weld1, BoundVert **r_weld2)
 {
   VMesh *vm = bv->vmesh;
-  BoundVert *bndv, *weld1, *weld2, *vpipe;
-  int n, ns, ns2, i, k, weld;
+  BoundVert *bndv;
+
+  *r_weld1 = *r_weld2 = NULL;
+  /* Special case: just two beveled edges welded together. */
+  if (!((bv->selcount == 2) && (vm->count == 2))) {
+    return false;
+  }
+
+  bndv = vm->boundstart;
+  do {
+    if (bndv->ebev) {
+      if (!*r_weld1) {
+        *r_weld1 = bndv;
+      }
+      else { /* Get the last of the two BoundVerts. */
+        *r_weld2 = bndv;
+      }
+    }
+  } while ((bndv = bndv->next) != vm->boundstart);
+  return true;
+}
+
+/**
+ * Calculate the positions of the boundary vertices of the vertex mesh, without changing the
+ * BMesh. This only depends on \a bv itself, so it may run for multiple BevVerts in parallel,
+ * see #build_vmesh for creating the geometry afterwards.
+ */
+static void build_vmesh_calc(BevelParams *bp, BevVert *bv)
+{
+  VMesh *vm = bv->vmesh;
+  BoundVert *bndv, *weld1, *weld2;
+  int n, ns, ns2, i, k;
   float *v_weld1, *v_weld2, co[3];
 
   n = vm->count;
   ns = vm->seg;
   ns2 = ns / 2;
 
-  vm->mesh = (NewVert *)BLI_memarena_alloc(bp->mem_arena,
-                                           (size_t)(n * (ns2 + 1) * (ns + 1)) * sizeof(NewVert));
+  vm->mesh = (NewVert *)bevel_mem_alloc(bp,
+                                        (size_t)(n * (ns2 + 1) * (ns + 1)) * sizeof(NewVert));
 
-  /* Special case: just two beveled edges welded together. */
-  weld = (bv->selcount == 2) && (vm->count == 2);
-  weld1 = weld2 = NULL; /* Will hold two BoundVerts involved in weld. */
+  const bool weld = vmesh_weld_bound_verts(bv, &weld1, &weld2);
 
   /* Make (i, 0, 0) mesh verts for all i boundverts. */
   bndv = vm->boundstart;
   do {
     i = bndv->index;
     copy_v3_v3(mesh_vert(vm, i, 0, 0)->co, bndv->nv.co); /* Mesh NewVert to boundary NewVert. */
-    create_mesh_bmvert(bm, vm, i, 0, 0, bv->v);          /* Create BMVert for that NewVert. */
-    bndv->nv.v = mesh_vert(vm, i, 0, 0)->v; /* Use the BMVert for the BoundVert's NewVert. */
-
-    /* Find boundverts and move profile planes if this is a weld case. */
-    if (weld && bndv->ebev) {
-      if (!weld1) {
-        weld1 = bndv;
-      }
-      else { /* Get the last of the two BoundVerts. */
-        weld2 = bndv;
-        set_profile_params(bp, bv, weld1);
-        set_profile_params(bp, bv, weld2);
-        move_weld_profile_planes(bv, weld1, weld2);
-      }
-    }
   } while ((bndv = bndv->next) != vm->boundstart);
 
+  /* Move profile planes if this is a weld case. */
+  if (weld && weld2) {
+    set_profile_params(bp, bv, weld1);
+    set_profile_params(bp, bv, weld2);
+    move_weld_profile_planes(bv, weld1, weld2);
+  }
+
   /* It's simpler to calculate all profiles only once at a single moment, so keep just a single
    * profile calculation here, the last point before actual mesh verts are created. */
   calculate_vm_profiles(bp, bv, vm);
 
-  /* Create new vertices and place them based on the profiles. */
+  /* Place the new vertices based on the profiles. */
   /* Copy other ends to (i, 0, ns) for all i, and fill in profiles for edges. */
   bndv = vm->boundstart;
   do {
@@ -5684,10 +5716,6 @@ static void build_vmesh(BevelParams *bp, BMesh *bm, BevVert *bv)
         if (bndv->ebev) {
           get_profile_point(bp, &bndv->profile, k, ns, co);
           copy_v3_v3(mesh_vert(vm, i, 0, k)->co, co);
-          if (!weld) {
-            /* This is done later with (possibly) better positions for the weld case. */
-            create_mesh_bmvert(bm, vm, i, 0, k, bv->v);
-          }
         }
         else if (n == 2 && !bndv->ebev) {
           /* case of one edge beveled and this is the v without ebev */
@@ -5700,7 +5728,6 @@ static void build_vmesh(BevelParams *bp, BMesh *bm, BevVert *bv)
 
   /* Build the profile for the weld case (just a connection between the two boundverts). */
   if (weld) {
-    bv->vmesh->mesh_kind = M_NONE;
     for (k = 1; k < ns; k++) {
       v_weld1 = mesh_vert(bv->vmesh, weld1->index, 0, k)->co;
       v_weld2 = mesh_vert(bv->vmesh, weld2->index, 0, ns - k)->co;
@@ -5722,12 +5749,66 @@ static void build_vmesh(BevelParams *bp, BMesh *bm, BevVert *bv)
         }
       }
       copy_v3_v3(mesh_vert(bv->vmesh, weld1->index, 0, k)->co, co);
-      create_mesh_bmvert(bm, bv->vmesh, weld1->index, 0, k, bv->v);
     }
     for (k = 1; k < ns; k++) {
       copy_mesh_vert(bv->vmesh, weld2->index, 0, ns - k, weld1->index, 0, k);
     }
   }
+}
+
+/**
+ * Create the BMesh geometry for the vertex mesh of \a bv,
+ * the positions must have been calculated by #build_vmesh_calc.
+ */
+static void build_vmesh(BevelParams *bp, BMesh *bm, BevVert *bv)
+{
+  VMesh *vm = bv->vmesh;
+  BoundVert *bndv, *weld1, *weld2, *vpipe;
+  int n, ns, i, k;
+
+  n = vm->count;
+  ns = vm->seg;
+
+  const bool weld = vmesh_weld_bound_verts(bv, &weld1, &weld2);
+
+  /* Create BMVerts for the (i, 0, 0) mesh verts of all i boundverts. */
+  bndv = vm->boundstart;
+  do {
+    i = bndv->index;
+    create_mesh_bmvert(bm, vm, i, 0, 0, bv->v); /* Create BMVert for that NewVert. */
+    bndv->nv.v = mesh_vert(vm, i, 0, 0)->v;     /* Use the BMVert for the BoundVert's NewVert. */
+  } while ((bndv = bndv->next) != vm->boundstart);
+
+  /* Create the BMVerts along the profiles, sharing them in the same order they were copied. */
+  bndv = vm->boundstart;
+  do {
+    i = bndv->index;
+    mesh_vert(vm, i, 0, ns)->v = mesh_vert(vm, bndv->next->index, 0, 0)->v;
+
+    if (vm->mesh_kind != M_ADJ) {
+      for (k = 1; k < ns; k++) {
+        if (bndv->ebev) {
+          if (!weld) {
+            /* This is done later with (possibly) better positions for the weld case. */
+            create_mesh_bmvert(bm, vm, i, 0, k, bv->v);
+          }
+        }
+        else if (n == 2 && !bndv->ebev) {
+          mesh_vert(vm, i, 0, k)->v = mesh_vert(vm, 1 - i, 0, ns - k)->v;
+        }
+      }
+    }
+  } while ((bndv = bndv->next) != vm->boundstart);
+
+  if (weld) {
+    bv->vmesh->mesh_kind = M_NONE;
+    for (k = 1; k < ns; k++) {
+      create_mesh_bmvert(bm, bv->vmesh, weld1->index, 0, k, bv->v);
+    }
+    for (k = 1; k < ns; k++) {
+      mesh_vert(vm, weld2->index, 0, ns - k)->v = mesh_vert(vm, weld1->index, 0, k)->v;
+    }
+  }
 
   /* Make sure the pipe case ADJ mesh is used for both the "Grid Fill" (ADJ) and cutoff options. */
   vpipe = NULL;
@@ -7422,6 +7503,48 @@ static void bevel_limit_offset(BevelParams *bp, BMesh *bm)
   }
 }
 
+typedef void (*BevelVertFunc)(BevelParams *bp, BevVert *bv);
+
+typedef struct BevelVertsParallelData {
+  BevelParams *bp;
+  BevVert **bevverts;
+  BevelVertFunc func;
+} BevelVertsParallelData;
+
+static void bevel_verts_parallel_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BevelVertsParallelData *data = userdata;
+  data->func(data->bp, data->bevverts[i]);
+}
+
+/**
+ * Run \a func for all BevVerts in parallel. This is only valid for the analysis phases which
+ * only change the BevVert they are passed (allocating with #bevel_mem_alloc),
+ * the BMesh must not be modified.
+ */
+static void bevel_verts_parallel(BevelParams *bp,
+                                 BevVert **bevverts,
+                                 const int bevverts_len,
+                                 BevelVertFunc func)
+{
+  BevelVertsParallelData data = {
+      .bp = bp,
+      .bevverts = bevverts,
+      .func = func,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(0, bevverts_len, &data, bevel_verts_parallel_cb, &settings);
+}
+
+static void bevel_build_boundary_cb(BevelParams *bp, BevVert *bv)
+{
+  build_boundary(bp, bv, true);
+}
+
 /**
  * - Currently only bevels BM_ELEM_TAG'd verts and edges.
  *
@@ -7521,6 +7644,7 @@ void BM_mesh_bevel(BMesh *bm,
     bp.vert_hash = BLI_ghash_ptr_new(__func__);
     bp.mem_arena = BLI_memarena_new(MEM_SIZE_OPTIMAL(1 << 16), __func__);
     BLI_memarena_use_calloc(bp.mem_arena);
+    BLI_spin_init(&bp.mem_arena_lock);
 
     /* Get the 2D profile point locations from either the superellipse or the custom profile. */
     set_profile_spacing(&bp, &bp.pro_spacing, bp.profile_type == BEVEL_PROFILE_CUSTOM);
@@ -7541,12 +7665,14 @@ void BM_mesh_bevel(BMesh *bm,
 
     math_layer_info_init(&bp, bm);
 
-    /* Analyze input vertices, sorting edges and assigning initial new vertex positions. */
+    /* Analyze input vertices, sorting edges. */
+    BevVert **bevverts = MEM_mallocN(sizeof(*bevverts) * (size_t)bm->totvert, __func__);
+    int bevverts_len = 0;
     BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
       if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
         bv = bevel_vert_construct(bm, &bp, v);
-        if (!limit_offset && bv) {
-          build_boundary(&bp, bv, true);
+        if (bv) {
+          bevverts[bevverts_len++] = bv;
         }
       }
     }
@@ -7554,18 +7680,11 @@ void BM_mesh_bevel(BMesh *bm,
     /* Perhaps clamp offset to avoid geometry colliisions. */
     if (limit_offset) {
       bevel_limit_offset(&bp, bm);
-
-      /* Assign initial new vertex positions. */
-      BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-        if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
-          bv = find_bevvert(&bp, v);
-          if (bv) {
-            build_boundary(&bp, bv, true);
-          }
-        }
-      }
     }
 
+    /* Assign initial new vertex positions. */
+    bevel_verts_parallel(&bp, bevverts, bevverts_len, bevel_build_boundary_cb);
+
     /* Perhaps do a pass to try to even out widths. */
     if (bp.offset_adjust) {
       adjust_offsets(&bp, bm);
@@ -7580,15 +7699,13 @@ void BM_mesh_bevel(BMesh *bm,
       }
     }
 
-    /* Build the meshes around vertices, now that positions are final. */
-    BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-      if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
-        bv = find_bevvert(&bp, v);
-        if (bv) {
-          build_vmesh(&bp, bm, bv);
-        }
-      }
+    /* Build the meshes around vertices, now that positions are final.
+     * Positions are calculated in parallel, the geometry is created afterwards. */
+    bevel_verts_parallel(&bp, bevverts, bevverts_len, build_vmesh_calc);
+    for (int i = 0; i < bevverts_len; i++) {
+      build_vmesh(&bp, bm, bevverts[i]);
     }
+    MEM_freeN(bevverts);
 
     /* Build polygons for edges. */
     if (bp.affect_type != BEVEL_AFFECT_VERTICES) {
@@ -7660,5 +7777,6 @@ void BM_mesh_bevel(BMesh *bm,
     BLI_ghash_free(bp.vert_hash, NULL, NULL);
     BLI_ghash_free(bp.face_hash, NULL, NULL);
     BLI_memarena_free(bp.mem_arena);
+    BLI_spin_end(&bp.mem_arena_lock);
   }
 }
@@ -842,6 +842,78 @@ finally:
 
 #ifdef USE_BVH
 
+struct TriTriOverlapData {
+  BMLoop *(*looptris)[3];
+  float eps_margin;
+};
+
+/**
+ * Check if all points of \a b lie on the same side of the plane of \a a,
+ * further away than \a dist_min. Calculated in double precision, so the result can be
+ * relied on for coordinates far larger than the intersection epsilon.
+ */
+static bool isect_tri_tri_plane_side_test(BMLoop **a, BMLoop **b, const double dist_min)
+{
+  double a_cos[3][3], n[3], d1[3], d2[3];
+  for (uint i = 0; i < 3; i++) {
+    copy_v3db_v3fl(a_cos[i], a[i]->v->co);
+  }
+  sub_v3_v3v3_db(d1, a_cos[1], a_cos[0]);
+  sub_v3_v3v3_db(d2, a_cos[2], a_cos[0]);
+  cross_v3_v3v3_db(n, d1, d2);
+
+  const double n_len = sqrt(dot_v3v3_db(n, n));
+  if (n_len == 0.0) {
+    /* Degenerate triangle, there is no plane to test against. */
+    return false;
+  }
+
+  int side = 0;
+  for (uint i = 0; i < 3; i++) {
+    double b_co[3];
+    copy_v3db_v3fl(b_co, b[i]->v->co);
+    sub_v3_v3v3_db(d1, b_co, a_cos[0]);
+    const double dist = dot_v3v3_db(n, d1) / n_len;
+    const int side_test = (dist > dist_min) ? 1 : ((dist < -dist_min) ? -1 : 0);
+    if ((side_test == 0) || (side != 0 && side != side_test)) {
+      return false;
+    }
+    side = side_test;
+  }
+  return true;
+}
+
+/**
+ * Overlap callback, runs from the threads of #BLI_bvhtree_overlap_ex.
+ *
+ * Reject triangle pairs where either triangle lies entirely on one side of the other
+ * triangle's plane. Everything #bm_isect_tri_tri detects (touching vertices, vertices on edges
+ * and edge-triangle intersections) needs a point of each triangle within the intersection margin
+ * of the other's plane, so such pairs never create geometry, and rejecting them early means far
+ * fewer pairs are left to intersect serially.
+ */
+static bool bm_isect_tri_tri_overlap_cb(void *userdata,
+                                        int index_a,
+                                        int index_b,
+                                        int UNUSED(thread))
+{
+  const struct TriTriOverlapData *data = userdata;
+  BMLoop **a = data->looptris[index_a];
+  BMLoop **b = data->looptris[index_b];
+
+  /* Account for rounding of the single precision calculations in #bm_isect_tri_tri. */
+  float co_max = 0.0f;
+  for (uint i = 0; i < 3; i++) {
+    for (uint j = 0; j < 3; j++) {
+      co_max = max_fff(co_max, fabsf(a[i]->v->co[j]), fabsf(b[i]->v->co[j]));
+    }
+  }
+  const double dist_min = 2.0 * (double)data->eps_margin + 16.0 * (double)FLT_EPSILON * co_max;
+
+  return !(isect_tri_tri_plane_side_test(a, b, dist_min) ||
+           isect_tri_tri_plane_side_test(b, a, dist_min));
+}
+
 struct RaycastData {
   const float **looptris;
   BLI_Buffer *z_buffer;
@@ -1101,7 +1173,17 @@ bool BM_mesh_intersect(BMesh *bm,
     flag &= ~BVH_OVERLAP_USE_THREADING;
   }
 #  endif
-  overlap = BLI_bvhtree_overlap_ex(tree_b, tree_a, &tree_overlap_tot, NULL, NULL, 0, flag);
+  struct TriTriOverlapData overlap_data = {
+      .looptris = looptris,
+      .eps_margin = s.epsilon.eps_margin,
+  };
+  overlap = BLI_bvhtree_overlap_ex(tree_b,
+                                   tree_a,
+                                   &tree_overlap_tot,
+                                   bm_isect_tri_tri_overlap_cb,
+                                   &overlap_data,
+                                   0,
+                                   flag);
 
   if (overlap) {
     uint i;
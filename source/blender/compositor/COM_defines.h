@@ -109,4 +109,10 @@ typedef enum OrderOfChunks {
 
 #define COM_BLUR_BOKEH_PIXELS 512
 
+/**
+ * \brief Maximum number of pixels in a row passed to SocketReader.readRow,
+ * operations can use it to size their row buffers on the stack.
+ */
+#define COM_ROW_LENGTH_MAX 64
+
 #endif /* __COM_DEFINES_H__ */
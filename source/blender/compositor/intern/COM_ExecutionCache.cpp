@@ -0,0 +1,324 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#include <cstring>
+#include <sstream>
+#include <typeinfo>
+
+#include "COM_ExecutionCache.h"
+#include "COM_CompositorContext.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_Node.h"
+#include "COM_NodeOperation.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+#include "MEM_CacheLimiterC-Api.h"
+#include "MEM_guardedalloc.h"
+
+#include "BLI_hash_md5.h"
+
+#include "DNA_camera_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "RE_pipeline.h"
+
+typedef struct ExecutionCacheItem {
+  /* Float or half float data, like the buffer it was stored from. */
+  void *buffer;
+  int width;
+  int height;
+  int num_channels;
+  int element_size;
+  MEM_CacheLimiterHandleC *c_handle;
+} ExecutionCacheItem;
+
+typedef std::map<std::string, ExecutionCacheItem *> ExecutionCacheItems;
+
+/* All access happens with the compositor mutex locked, see COM_execute. */
+static ExecutionCacheItems g_items;
+static MEM_CacheLimiterC *g_limiter = NULL;
+
+static void execution_cache_destructor(void *p)
+{
+  ExecutionCacheItem *item = (ExecutionCacheItem *)p;
+
+  /* The item stays in g_items without data, it is removed on the next lookup. */
+  MEM_freeN(item->buffer);
+  item->buffer = NULL;
+  item->c_handle = NULL;
+}
+
+static size_t execution_cache_item_size(void *p)
+{
+  ExecutionCacheItem *item = (ExecutionCacheItem *)p;
+  return (size_t)item->element_size * item->width * item->height * item->num_channels;
+}
+
+static void execution_cache_item_free(ExecutionCacheItem *item)
+{
+  if (item->buffer) {
+    MEM_CacheLimiter_unmanage(item->c_handle);
+    MEM_freeN(item->buffer);
+  }
+  MEM_freeN(item);
+}
+
+static int buffer_element_size(MemoryBuffer *buffer)
+{
+  return buffer->isHalfFloat() ? sizeof(unsigned short) : sizeof(float);
+}
+
+static void *buffer_data(MemoryBuffer *buffer)
+{
+  return buffer->isHalfFloat() ? (void *)buffer->getHalfBuffer() : (void *)buffer->getBuffer();
+}
+
+static void hash_append(std::string &r_hash, const void *data, size_t size)
+{
+  char digest[16];
+  char hexdigest[33];
+
+  BLI_hash_md5_buffer((const char *)data, size, digest);
+  r_hash.append(BLI_hash_md5_to_hexdigest(digest, hexdigest));
+}
+
+/* Hash data of the scene used by render layer and defocus nodes. */
+static void hash_scene(std::string &r_hash, const Scene *scene)
+{
+  std::stringstream data;
+  data << scene << " " << scene->camera;
+
+  if (scene->camera && scene->camera->type == OB_CAMERA) {
+    hash_append(r_hash, scene->camera->data, sizeof(Camera));
+  }
+
+  Render *re = RE_GetSceneRender(scene);
+  if (re) {
+    RenderResult *rr = RE_AcquireResultRead(re);
+    if (rr) {
+      data << " " << rr->serial;
+    }
+    RE_ReleaseResult(re);
+  }
+
+  r_hash.append(data.str());
+}
+
+bool ExecutionCache::hashNode(const Node *node, std::string &r_hash)
+{
+  std::stringstream data;
+  /* Enough digits to tell all floats apart. */
+  data.precision(9);
+  data << typeid(*node).name();
+
+  bNode *b_node = node->getbNode();
+  if (b_node) {
+    data << " " << b_node->type << " " << b_node->custom1 << " " << b_node->custom2 << " "
+         << b_node->custom3 << " " << b_node->custom4;
+    if (b_node->storage) {
+      hash_append(r_hash, b_node->storage, MEM_allocN_len(b_node->storage));
+    }
+
+    if (b_node->id) {
+      if (GS(b_node->id->name) != ID_SCE) {
+        /* Images, movie clips, masks and textures can change without any change to the node
+         * tree, results depending on them are never cached. */
+        return false;
+      }
+      hash_scene(r_hash, (Scene *)b_node->id);
+    }
+  }
+
+  for (unsigned int index = 0; index < node->getNumberOfInputSockets(); index++) {
+    bNodeSocket *b_sock = node->getInputSocket(index)->getbNodeSocket();
+    if (b_sock) {
+      data << " " << b_sock->type;
+      if (b_sock->default_value) {
+        hash_append(r_hash, b_sock->default_value, MEM_allocN_len(b_sock->default_value));
+      }
+    }
+  }
+
+  hash_append(r_hash, data.str().c_str(), data.str().size());
+  return true;
+}
+
+/* Hash the settings used by all operations. */
+static std::string context_hash(const CompositorContext &context)
+{
+  const RenderData *rd = context.getRenderData();
+  const ColorManagedViewSettings *view_settings = context.getViewSettings();
+  const ColorManagedDisplaySettings *display_settings = context.getDisplaySettings();
+
+  std::stringstream data;
+  data.precision(9);
+  const char *view_name = context.getViewName() ? context.getViewName() : "";
+  data << context.getScene() << " " << context.getFramenumber() << " " << rd->size << " "
+       << rd->xsch << " " << rd->ysch << " " << view_name << " " << context.getQuality() << " "
+       << context.isFastCalculation() << " " << context.isGroupnodeBufferEnabled();
+  if (view_settings) {
+    data << " " << view_settings->view_transform << " " << view_settings->look << " "
+         << view_settings->exposure << " " << view_settings->gamma;
+  }
+  if (display_settings) {
+    data << " " << display_settings->display_device;
+  }
+
+  std::string hash;
+  hash_append(hash, data.str().c_str(), data.str().size());
+  return hash;
+}
+
+static std::string operation_hash(NodeOperation *operation, ExecutionCache::Keys &keys)
+{
+  ExecutionCache::Keys::iterator found = keys.find(operation);
+  if (found != keys.end()) {
+    return found->second;
+  }
+
+  /* Insert an empty hash first, so cycles can't cause infinite recursion. */
+  std::string &hash = keys[operation];
+  if (!operation->isCacheable()) {
+    return hash;
+  }
+
+  std::stringstream data;
+  data << typeid(*operation).name() << " " << operation->getWidth() << " "
+       << operation->getHeight() << " " << operation->getNodeHash();
+
+  if (operation->isSetOperation()) {
+    float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    operation->readSampled(value, 0.0f, 0.0f, COM_PS_NEAREST);
+    hash_append(hash, value, sizeof(value));
+  }
+
+  if (operation->isReadBufferOperation()) {
+    MemoryProxy *proxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+    if (!proxy || !proxy->getWriteBufferOperation()) {
+      return hash;
+    }
+    std::string input_hash = operation_hash(proxy->getWriteBufferOperation(), keys);
+    if (input_hash.empty()) {
+      hash.clear();
+      return hash;
+    }
+    data << " " << input_hash;
+  }
+
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationOutput *link = operation->getInputSocket(index)->getLink();
+    if (!link) {
+      continue;
+    }
+    std::string input_hash = operation_hash(&link->getOperation(), keys);
+    if (input_hash.empty()) {
+      hash.clear();
+      return hash;
+    }
+    data << " " << input_hash;
+  }
+
+  hash_append(hash, data.str().c_str(), data.str().size());
+  return hash;
+}
+
+std::string ExecutionCache::operationKey(const CompositorContext &context,
+                                         NodeOperation *operation,
+                                         Keys &keys)
+{
+  std::string hash = operation_hash(operation, keys);
+  if (hash.empty()) {
+    return hash;
+  }
+  return context_hash(context) + hash;
+}
+
+bool ExecutionCache::restore(const std::string &key, MemoryBuffer *buffer)
+{
+  ExecutionCacheItems::iterator found = g_items.find(key);
+  if (found == g_items.end()) {
+    return false;
+  }
+
+  ExecutionCacheItem *item = found->second;
+  if (item->buffer == NULL) {
+    /* Freed by the cache limiter. */
+    execution_cache_item_free(item);
+    g_items.erase(found);
+    return false;
+  }
+  if (item->width != buffer->getWidth() || item->height != buffer->getHeight() ||
+      item->num_channels != (int)buffer->get_num_channels() ||
+      item->element_size != buffer_element_size(buffer)) {
+    return false;
+  }
+
+  memcpy(buffer_data(buffer), item->buffer, execution_cache_item_size(item));
+  buffer->setCreatedState();
+  MEM_CacheLimiter_touch(item->c_handle);
+  return true;
+}
+
+void ExecutionCache::store(const std::string &key, MemoryBuffer *buffer)
+{
+  if (g_limiter == NULL) {
+    g_limiter = new_MEM_CacheLimiter(execution_cache_destructor, execution_cache_item_size);
+  }
+
+  /* Remove items freed by the cache limiter, and the previous result for the key. */
+  for (ExecutionCacheItems::iterator it = g_items.begin(); it != g_items.end();) {
+    if (it->second->buffer == NULL || it->first == key) {
+      execution_cache_item_free(it->second);
+      g_items.erase(it++);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  ExecutionCacheItem *item = (ExecutionCacheItem *)MEM_callocN(sizeof(ExecutionCacheItem),
+                                                               __func__);
+  item->width = buffer->getWidth();
+  item->height = buffer->getHeight();
+  item->num_channels = buffer->get_num_channels();
+  item->element_size = buffer_element_size(buffer);
+  item->buffer = MEM_mallocN(execution_cache_item_size(item), __func__);
+  memcpy(item->buffer, buffer_data(buffer), execution_cache_item_size(item));
+  g_items[key] = item;
+
+  item->c_handle = MEM_CacheLimiter_insert(g_limiter, item);
+  MEM_CacheLimiter_ref(item->c_handle);
+  MEM_CacheLimiter_enforce_limits(g_limiter);
+  MEM_CacheLimiter_unref(item->c_handle);
+}
+
+void ExecutionCache::free()
+{
+  for (ExecutionCacheItems::iterator it = g_items.begin(); it != g_items.end(); ++it) {
+    execution_cache_item_free(it->second);
+  }
+  g_items.clear();
+
+  if (g_limiter) {
+    delete_MEM_CacheLimiter(g_limiter);
+    g_limiter = NULL;
+  }
+}
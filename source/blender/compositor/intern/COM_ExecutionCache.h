@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#ifndef __COM_EXECUTIONCACHE_H__
+#define __COM_EXECUTIONCACHE_H__
+
+#include <map>
+#include <string>
+
+class CompositorContext;
+class MemoryBuffer;
+class Node;
+class NodeOperation;
+
+/**
+ * \brief Cache of write buffers between executions of the compositor.
+ *
+ * Every write buffer gets a key that is computed from the settings of all operations
+ * upstream of it, so an unchanged part of the tree gets the same key in the next execution.
+ * Its result is then restored from the cache instead of being calculated again, and the
+ * ExecutionGroups writing to it are not executed.
+ *
+ * Operations created for nodes that read data which is not part of the node settings,
+ * like images or movie clips, are not cacheable. The memory used by the cache is limited
+ * by the memory cache limit of the user preferences.
+ * \ingroup Execution
+ */
+class ExecutionCache {
+ public:
+  typedef std::map<NodeOperation *, std::string> Keys;
+
+  /**
+   * \brief append a digest of the settings of \a node to \a r_hash
+   * \return false when results of the node can't be cached
+   */
+  static bool hashNode(const Node *node, std::string &r_hash);
+
+  /**
+   * \brief compute the cache key of the result of \a operation
+   * \return empty string when the result can't be cached
+   * \param keys: keys of operations computed so far
+   */
+  static std::string operationKey(const CompositorContext &context,
+                                  NodeOperation *operation,
+                                  Keys &keys);
+
+  /**
+   * \brief copy the cached result with the key \a key into \a buffer
+   * \return false when there is no result for the key
+   */
+  static bool restore(const std::string &key, MemoryBuffer *buffer);
+
+  /**
+   * \brief store a copy of \a buffer as the result for the key \a key
+   */
+  static void store(const std::string &key, MemoryBuffer *buffer);
+
+  /**
+   * \brief free all cached results
+   */
+  static void free();
+};
+
+#endif /* __COM_EXECUTIONCACHE_H__ */
@@ -57,6 +57,7 @@ ExecutionGroup::ExecutionGroup()
   this->m_openCL = false;
   this->m_singleThreaded = false;
   this->m_chunksFinished = 0;
+  this->m_executionTime = 0;
   BLI_rcti_init(&this->m_viewerBorder, 0, 0, 0, 0);
   this->m_executionStartTime = 0;
 }
@@ -359,12 +360,15 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
       }
     }
 
-    WorkScheduler::finish();
+    if (!finished) {
+      WorkScheduler::waitForProgress();
+    }
 
     if (bTree->test_break && bTree->test_break(bTree->tbh)) {
       breaked = true;
     }
   }
+  WorkScheduler::finish();
   DebugInfo::execution_group_finished(this);
   DebugInfo::graphviz(graph);
 
@@ -403,6 +407,28 @@ MemoryBuffer *ExecutionGroup::constructConsolidatedMemoryBuffer(MemoryProxy *mem
   return result;
 }
 
+void ExecutionGroup::setChunksExecuted()
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+  }
+}
+
+bool ExecutionGroup::isAllChunksExecuted() const
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ExecutionGroup::addExecutionTime(double seconds)
+{
+  atomic_add_and_fetch_uint64(&this->m_executionTime, (uint64_t)(seconds * 1000000.0));
+}
+
 void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers)
 {
   if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED) {
@@ -151,6 +151,11 @@ class ExecutionGroup {
    */
   unsigned int m_chunksFinished;
 
+  /**
+   * \brief time spent executing chunks of this ExecutionGroup on all devices, in microseconds
+   */
+  uint64_t m_executionTime;
+
   /**
    * \brief the chunkExecutionStates holds per chunk the execution state. this state can be
    *   - COM_ES_NOT_SCHEDULED: not scheduled
@@ -382,6 +387,39 @@ class ExecutionGroup {
    */
   void deinitExecution();
 
+  /**
+   * \brief mark all chunks as executed, so they are not scheduled anymore
+   * \note used when the output buffer was restored from the ExecutionCache
+   */
+  void setChunksExecuted();
+
+  /**
+   * \brief are all chunks of this ExecutionGroup executed
+   */
+  bool isAllChunksExecuted() const;
+
+  /**
+   * \brief add the time a device spent on a chunk of this ExecutionGroup
+   * \note called from the device threads
+   */
+  void addExecutionTime(double seconds);
+
+  /**
+   * \brief total time spent executing chunks of this ExecutionGroup, in seconds
+   */
+  double getExecutionTime() const
+  {
+    return this->m_executionTime / 1000000.0;
+  }
+
+  /**
+   * \brief get the operations of this ExecutionGroup
+   */
+  const Operations &getOperations() const
+  {
+    return this->m_operations;
+  }
+
   /**
    * \brief schedule an ExecutionGroup
    * \note this method will return when all chunks have been calculated, or the execution has
@@ -18,20 +18,27 @@
 
 #include "COM_ExecutionSystem.h"
 
+#include <map>
+#include <set>
+
+#include "BLI_listbase.h"
 #include "BLI_utildefines.h"
 #include "PIL_time.h"
 
+#include "BKE_global.h"
 #include "BKE_node.h"
 
 #include "BLT_translation.h"
 
 #include "COM_Converter.h"
 #include "COM_Debug.h"
+#include "COM_ExecutionCache.h"
 #include "COM_ExecutionGroup.h"
 #include "COM_NodeOperation.h"
 #include "COM_NodeOperationBuilder.h"
 #include "COM_ReadBufferOperation.h"
 #include "COM_WorkScheduler.h"
+#include "COM_WriteBufferOperation.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
@@ -147,6 +154,8 @@ void ExecutionSystem::execute()
   }
   unsigned int index;
 
+  determineHalfFloatBuffers();
+
   // First allocale all write buffer
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
@@ -164,11 +173,14 @@ void ExecutionSystem::execute()
     }
   }
   // initialize other operations
+  vector<double> initTimes(this->m_operations.size(), 0.0);
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
     if (!operation->isWriteBufferOperation()) {
       operation->setbNodeTree(this->m_context.getbNodeTree());
+      const double start_time = PIL_check_seconds_timer();
       operation->initExecution();
+      initTimes[index] = PIL_check_seconds_timer() - start_time;
     }
   }
   for (index = 0; index < this->m_groups.size(); index++) {
@@ -177,6 +189,27 @@ void ExecutionSystem::execute()
     executionGroup->initExecution();
   }
 
+  /* Restore buffers calculated by previous executions, their groups are not executed again.
+   * Not used for final renders, and not while rendering as render results change in place. */
+  const bool use_cache = !this->m_context.isRendering() && !G.is_rendering;
+  vector<std::string> cacheKeys(this->m_operations.size());
+  vector<bool> cacheRestored(this->m_operations.size(), false);
+  if (use_cache) {
+    ExecutionCache::Keys keys;
+    for (index = 0; index < this->m_operations.size(); index++) {
+      NodeOperation *operation = this->m_operations[index];
+      if (operation->isWriteBufferOperation()) {
+        MemoryProxy *proxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+        cacheKeys[index] = ExecutionCache::operationKey(this->m_context, operation, keys);
+        if (!cacheKeys[index].empty() && proxy->getExecutor() &&
+            ExecutionCache::restore(cacheKeys[index], proxy->getBuffer())) {
+          proxy->getExecutor()->setChunksExecuted();
+          cacheRestored[index] = true;
+        }
+      }
+    }
+  }
+
   WorkScheduler::start(this->m_context);
 
   executeGroups(COM_PRIORITY_HIGH);
@@ -188,6 +221,22 @@ void ExecutionSystem::execute()
   WorkScheduler::finish();
   WorkScheduler::stop();
 
+  if (use_cache) {
+    for (index = 0; index < this->m_operations.size(); index++) {
+      NodeOperation *operation = this->m_operations[index];
+      if (cacheKeys[index].empty() || cacheRestored[index]) {
+        continue;
+      }
+      MemoryProxy *proxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+      /* Only complete results, execution may have been canceled. */
+      if (proxy->getExecutor() && proxy->getExecutor()->isAllChunksExecuted()) {
+        ExecutionCache::store(cacheKeys[index], proxy->getBuffer());
+      }
+    }
+  }
+
+  updateNodeStatistics(initTimes);
+
   editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
@@ -199,6 +248,102 @@ void ExecutionSystem::execute()
   }
 }
 
+static void node_tree_clear_statistics(bNodeTree *ntree)
+{
+  LISTBASE_FOREACH (bNode *, node, &ntree->nodes) {
+    node->exec_time = 0.0f;
+    node->exec_memory = 0.0f;
+    if (ELEM(node->type, NODE_GROUP, NODE_CUSTOM_GROUP) && node->id) {
+      node_tree_clear_statistics((bNodeTree *)node->id);
+    }
+  }
+}
+
+void ExecutionSystem::updateNodeStatistics(const vector<double> &initTimes)
+{
+  std::map<bNode *, double> times;
+  std::map<bNode *, size_t> memory;
+
+  for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (operation->getbNode()) {
+      times[operation->getbNode()] += initTimes[index];
+    }
+
+    /* Buffers count for the node writing them. */
+    if (operation->isWriteBufferOperation()) {
+      MemoryBuffer *buffer = ((WriteBufferOperation *)operation)->getMemoryProxy()->getBuffer();
+      NodeOperationOutput *link = operation->getInputSocket(0)->getLink();
+      if (buffer && link && link->getOperation().getbNode()) {
+        const size_t element_size = buffer->isHalfFloat() ? sizeof(unsigned short) :
+                                                            sizeof(float);
+        memory[link->getOperation().getbNode()] += element_size * buffer->getWidth() *
+                                                   buffer->getHeight() *
+                                                   buffer->get_num_channels();
+      }
+    }
+  }
+
+  /* The operations of a group process their pixels interleaved, so the time of the group
+   * can't be measured per operation, it is divided evenly between the nodes in it. */
+  for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+    ExecutionGroup *group = this->m_groups[index];
+    std::set<bNode *> nodes;
+    const ExecutionGroup::Operations &operations = group->getOperations();
+    for (unsigned int op_index = 0; op_index < operations.size(); op_index++) {
+      if (operations[op_index]->getbNode()) {
+        nodes.insert(operations[op_index]->getbNode());
+      }
+    }
+    for (std::set<bNode *>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+      times[*it] += group->getExecutionTime() / nodes.size();
+    }
+  }
+
+  node_tree_clear_statistics((bNodeTree *)this->m_context.getbNodeTree());
+  for (std::map<bNode *, double>::iterator it = times.begin(); it != times.end(); ++it) {
+    it->first->exec_time = (float)(it->second * 1000.0);
+  }
+  for (std::map<bNode *, size_t>::iterator it = memory.begin(); it != memory.end(); ++it) {
+    it->first->exec_memory = (float)it->second / (1024.0f * 1024.0f);
+  }
+}
+
+void ExecutionSystem::determineHalfFloatBuffers()
+{
+  if (!(this->m_context.getbNodeTree()->flag & NTREE_COM_HALF_BUFFERS)) {
+    return;
+  }
+
+  /* Complex operations get the whole buffer and access its float data directly, as do OpenCL
+   * kernels. Only buffers that are exclusively read pixel by pixel can be stored as half. */
+  std::set<MemoryProxy *> float_proxies;
+  for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (!operation->isComplex() && !operation->isOpenCL()) {
+      continue;
+    }
+    for (unsigned int input = 0; input < operation->getNumberOfInputSockets(); input++) {
+      NodeOperationOutput *link = operation->getInputSocket(input)->getLink();
+      if (link && link->getOperation().isReadBufferOperation()) {
+        float_proxies.insert(((ReadBufferOperation &)link->getOperation()).getMemoryProxy());
+      }
+    }
+  }
+
+  for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (!operation->isWriteBufferOperation()) {
+      continue;
+    }
+    MemoryProxy *proxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+    /* Values and vectors are often depths, coordinates or masks that need full precision. */
+    proxy->setUseHalfFloat(proxy->getDataType() == COM_DT_COLOR && proxy->getExecutor() &&
+                           !proxy->getExecutor()->isOpenCL() &&
+                           float_proxies.find(proxy) == float_proxies.end());
+  }
+}
+
 void ExecutionSystem::executeGroups(CompositorPriority priority)
 {
   unsigned int index;
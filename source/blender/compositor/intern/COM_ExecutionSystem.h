@@ -189,6 +189,19 @@ class ExecutionSystem {
  private:
   void executeGroups(CompositorPriority priority);
 
+  /**
+   * \brief enable half float storage for the buffers that can use it
+   * \note called before the write buffers are allocated
+   */
+  void determineHalfFloatBuffers();
+
+  /**
+   * \brief store the execution time and buffer memory of the nodes in their bNode
+   * \param initTimes: time spent initializing each operation
+   * \note called after execution, before the buffers are freed
+   */
+  void updateNodeStatistics(const vector<double> &initTimes);
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
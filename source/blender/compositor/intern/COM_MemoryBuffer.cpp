@@ -58,8 +58,18 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
   this->m_memoryProxy = memoryProxy;
   this->m_chunkNumber = chunkNumber;
   this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
-  this->m_buffer = (float *)MEM_mallocN_aligned(
-      sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  if (memoryProxy->getUseHalfFloat()) {
+    this->m_buffer = NULL;
+    this->m_halfBuffer = (unsigned short *)MEM_mallocN_aligned(
+        sizeof(unsigned short) * determineBufferSize() * this->m_num_channels,
+        16,
+        "COM_MemoryBuffer");
+  }
+  else {
+    this->m_buffer = (float *)MEM_mallocN_aligned(
+        sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+    this->m_halfBuffer = NULL;
+  }
   this->m_state = COM_MB_ALLOCATED;
   this->m_datatype = memoryProxy->getDataType();
 }
@@ -74,6 +84,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
   this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  this->m_halfBuffer = NULL;
   this->m_state = COM_MB_TEMPORARILY;
   this->m_datatype = memoryProxy->getDataType();
 }
@@ -88,28 +99,45 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
   this->m_num_channels = determine_num_channels(dataType);
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  this->m_halfBuffer = NULL;
   this->m_state = COM_MB_TEMPORARILY;
   this->m_datatype = dataType;
 }
 MemoryBuffer *MemoryBuffer::duplicate()
 {
   MemoryBuffer *result = new MemoryBuffer(this->m_memoryProxy, &this->m_rect);
-  memcpy(result->m_buffer,
-         this->m_buffer,
-         this->determineBufferSize() * this->m_num_channels * sizeof(float));
+  result->copyContentFrom(this);
   return result;
 }
 void MemoryBuffer::clear()
 {
+  if (this->m_halfBuffer) {
+    memset(this->m_halfBuffer,
+           0,
+           this->determineBufferSize() * this->m_num_channels * sizeof(unsigned short));
+    return;
+  }
   memset(this->m_buffer, 0, this->determineBufferSize() * this->m_num_channels * sizeof(float));
 }
 
 float MemoryBuffer::getMaximumValue()
 {
-  float result = this->m_buffer[0];
   const unsigned int size = this->determineBufferSize();
   unsigned int i;
 
+  if (this->m_halfBuffer) {
+    const unsigned short *hp_src = this->m_halfBuffer;
+    float result = com_half_to_float(hp_src[0]);
+    for (i = 0; i < size; i++, hp_src += this->m_num_channels) {
+      float value = com_half_to_float(*hp_src);
+      if (value > result) {
+        result = value;
+      }
+    }
+    return result;
+  }
+
+  float result = this->m_buffer[0];
   const float *fp_src = this->m_buffer;
 
   for (i = 0; i < size; i++, fp_src += this->m_num_channels) {
@@ -148,6 +176,10 @@ MemoryBuffer::~MemoryBuffer()
     MEM_freeN(this->m_buffer);
     this->m_buffer = NULL;
   }
+  if (this->m_halfBuffer) {
+    MEM_freeN(this->m_halfBuffer);
+    this->m_halfBuffer = NULL;
+  }
 }
 
 void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
@@ -170,9 +202,25 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
                   this->m_num_channels;
     offset = ((otherY - this->m_rect.ymin) * this->m_width + minX - this->m_rect.xmin) *
              this->m_num_channels;
-    memcpy(&this->m_buffer[offset],
-           &otherBuffer->m_buffer[otherOffset],
-           (maxX - minX) * this->m_num_channels * sizeof(float));
+    const unsigned int length = (maxX - minX) * this->m_num_channels;
+    if (this->m_halfBuffer && otherBuffer->m_halfBuffer) {
+      memcpy(&this->m_halfBuffer[offset],
+             &otherBuffer->m_halfBuffer[otherOffset],
+             length * sizeof(unsigned short));
+    }
+    else if (this->m_halfBuffer) {
+      for (unsigned int i = 0; i < length; i++) {
+        this->m_halfBuffer[offset + i] = com_float_to_half(otherBuffer->m_buffer[otherOffset + i]);
+      }
+    }
+    else if (otherBuffer->m_halfBuffer) {
+      for (unsigned int i = 0; i < length; i++) {
+        this->m_buffer[offset + i] = com_half_to_float(otherBuffer->m_halfBuffer[otherOffset + i]);
+      }
+    }
+    else {
+      memcpy(&this->m_buffer[offset], &otherBuffer->m_buffer[otherOffset], length * sizeof(float));
+    }
   }
 }
 
@@ -182,6 +230,12 @@ void MemoryBuffer::writePixel(int x, int y, const float color[4])
       y < this->m_rect.ymax) {
     const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) *
                        this->m_num_channels;
+    if (this->m_halfBuffer) {
+      for (unsigned int i = 0; i < this->m_num_channels; i++) {
+        this->m_halfBuffer[offset + i] = com_float_to_half(color[i]);
+      }
+      return;
+    }
     memcpy(&this->m_buffer[offset], color, sizeof(float) * this->m_num_channels);
   }
 }
@@ -192,6 +246,13 @@ void MemoryBuffer::addPixel(int x, int y, const float color[4])
       y < this->m_rect.ymax) {
     const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) *
                        this->m_num_channels;
+    if (this->m_halfBuffer) {
+      unsigned short *dst = &this->m_halfBuffer[offset];
+      for (unsigned int i = 0; i < this->m_num_channels; i++) {
+        dst[i] = com_float_to_half(com_half_to_float(dst[i]) + color[i]);
+      }
+      return;
+    }
     float *dst = &this->m_buffer[offset];
     const float *src = color;
     for (int i = 0; i < this->m_num_channels; i++, dst++, src++) {
@@ -200,6 +261,65 @@ void MemoryBuffer::addPixel(int x, int y, const float color[4])
   }
 }
 
+/* Same as BLI_bilinear_interpolation_wrap_fl, for half float data. */
+void MemoryBuffer::readBilinearHalf(float *result, float u, float v, bool wrap_x, bool wrap_y)
+{
+  const int width = this->m_width;
+  const int height = this->m_height;
+  int x1 = (int)floorf(u);
+  int x2 = (int)ceilf(u);
+  int y1 = (int)floorf(v);
+  int y2 = (int)ceilf(v);
+
+  /* pixel value must be already wrapped, however values at boundaries may flip */
+  if (wrap_x) {
+    if (x1 < 0) {
+      x1 = width - 1;
+    }
+    if (x2 >= width) {
+      x2 = 0;
+    }
+  }
+  else if (x2 < 0 || x1 >= width) {
+    copy_vn_fl(result, this->m_num_channels, 0.0f);
+    return;
+  }
+
+  if (wrap_y) {
+    if (y1 < 0) {
+      y1 = height - 1;
+    }
+    if (y2 >= height) {
+      y2 = 0;
+    }
+  }
+  else if (y2 < 0 || y1 >= height) {
+    copy_vn_fl(result, this->m_num_channels, 0.0f);
+    return;
+  }
+
+  /* sample including outside of edges of image */
+  const int xs[4] = {x1, x1, x2, x2};
+  const int ys[4] = {y1, y2, y1, y2};
+  const float a = u - floorf(u);
+  const float b = v - floorf(v);
+  const float weights[4] = {
+      (1.0f - a) * (1.0f - b), (1.0f - a) * b, a * (1.0f - b), a * b};
+
+  copy_vn_fl(result, this->m_num_channels, 0.0f);
+  for (int corner = 0; corner < 4; corner++) {
+    const int x = xs[corner];
+    const int y = ys[corner];
+    if (x < 0 || y < 0 || x > width - 1 || y > height - 1) {
+      continue;
+    }
+    const unsigned short *pixel = &this->m_halfBuffer[(width * y + x) * this->m_num_channels];
+    for (unsigned int i = 0; i < this->m_num_channels; i++) {
+      result[i] += weights[corner] * com_half_to_float(pixel[i]);
+    }
+  }
+}
+
 static void read_ewa_pixel_sampled(void *userdata, int x, int y, float result[4])
 {
   MemoryBuffer *buffer = (MemoryBuffer *)userdata;
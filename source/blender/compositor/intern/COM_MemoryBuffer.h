@@ -50,6 +50,73 @@ typedef enum MemoryBufferExtend {
 
 class MemoryProxy;
 
+/**
+ * \brief convert a float to half float, rounding to nearest even
+ */
+BLI_INLINE unsigned short com_float_to_half(float f)
+{
+  union {
+    float f;
+    unsigned int u;
+  } in;
+  const unsigned int f32_infinity = 255u << 23;
+  const unsigned int f16_max = (127u + 16u) << 23;
+  const unsigned int f16_min_normal = 113u << 23;
+  in.f = f;
+  const unsigned int sign = in.u & 0x80000000u;
+  in.u ^= sign;
+  unsigned short h;
+  if (in.u >= f16_max) {
+    /* Overflow to infinity, NaN stays NaN. */
+    h = (in.u > f32_infinity) ? 0x7e00 : 0x7c00;
+  }
+  else if (in.u < f16_min_normal) {
+    /* Denormal or zero, let the FPU round the mantissa. */
+    union {
+      float f;
+      unsigned int u;
+    } magic;
+    magic.u = (127u - 15u + 23u - 10u + 1u) << 23;
+    in.f += magic.f;
+    h = (unsigned short)(in.u - magic.u);
+  }
+  else {
+    /* Rebias the exponent and round the mantissa. */
+    const unsigned int mantissa_odd = (in.u >> 13) & 1u;
+    in.u += (112u << 23) * 0xffffffffu + 0xfffu;
+    in.u += mantissa_odd;
+    h = (unsigned short)(in.u >> 13);
+  }
+  return h | (unsigned short)(sign >> 16);
+}
+
+/**
+ * \brief convert a half float to float, exact for all values
+ */
+BLI_INLINE float com_half_to_float(unsigned short h)
+{
+  union {
+    float f;
+    unsigned int u;
+  } out, magic;
+  const unsigned int shifted_exponent = 0x7c00u << 13;
+  magic.u = 113u << 23;
+  out.u = (h & 0x7fffu) << 13;
+  const unsigned int exponent = out.u & shifted_exponent;
+  out.u += (127u - 15u) << 23;
+  if (exponent == shifted_exponent) {
+    /* Infinity or NaN. */
+    out.u += (128u - 16u) << 23;
+  }
+  else if (exponent == 0) {
+    /* Denormal or zero. */
+    out.u += 1u << 23;
+    out.f -= magic.f;
+  }
+  out.u |= (unsigned int)(h & 0x8000u) << 16;
+  return out.f;
+}
+
 /**
  * \brief a MemoryBuffer contains access to the data of a chunk
  */
@@ -86,6 +153,12 @@ class MemoryBuffer {
    */
   float *m_buffer;
 
+  /**
+   * \brief the half float data, used instead of m_buffer when the MemoryProxy asks for it.
+   * Only the accessors of this class know how to read it.
+   */
+  unsigned short *m_halfBuffer;
+
   /**
    * \brief the number of channels of a single value in the buffer.
    * For value buffers this is 1, vector 3 and color 4
@@ -135,9 +208,27 @@ class MemoryBuffer {
    */
   float *getBuffer()
   {
+    BLI_assert(this->m_halfBuffer == NULL);
     return this->m_buffer;
   }
 
+  /**
+   * \brief is the data stored as half floats
+   * \see getHalfBuffer
+   */
+  bool isHalfFloat() const
+  {
+    return this->m_halfBuffer != NULL;
+  }
+
+  /**
+   * \brief get the half float data of this MemoryBuffer
+   */
+  unsigned short *getHalfBuffer()
+  {
+    return this->m_halfBuffer;
+  }
+
   /**
    * \brief after execution the state will be set to available by calling this method
    */
@@ -246,6 +337,10 @@ class MemoryBuffer {
       int v = y;
       this->wrap_pixel(u, v, extend_x, extend_y);
       const int offset = (this->m_width * y + x) * this->m_num_channels;
+      if (this->m_halfBuffer) {
+        readHalf(result, offset);
+        return;
+      }
       float *buffer = &this->m_buffer[offset];
       memcpy(result, buffer, sizeof(float) * this->m_num_channels);
     }
@@ -272,6 +367,10 @@ class MemoryBuffer {
     BLI_assert((int)(MEM_allocN_len(this->m_buffer) / sizeof(*this->m_buffer)) ==
                (int)(this->determineBufferSize() * COM_NUMBER_OF_CHANNELS));
 #endif
+    if (this->m_halfBuffer) {
+      readHalf(result, offset);
+      return;
+    }
     float *buffer = &this->m_buffer[offset];
     memcpy(result, buffer, sizeof(float) * this->m_num_channels);
   }
@@ -292,6 +391,10 @@ class MemoryBuffer {
       copy_vn_fl(result, this->m_num_channels, 0.0f);
       return;
     }
+    if (this->m_halfBuffer) {
+      readBilinearHalf(result, u, v, extend_x == COM_MB_REPEAT, extend_y == COM_MB_REPEAT);
+      return;
+    }
     BLI_bilinear_interpolation_wrap_fl(this->m_buffer,
                                        result,
                                        this->m_width,
@@ -353,6 +456,16 @@ class MemoryBuffer {
  private:
   unsigned int determineBufferSize();
 
+  inline void readHalf(float *result, int offset)
+  {
+    const unsigned short *buffer = &this->m_halfBuffer[offset];
+    for (unsigned int i = 0; i < this->m_num_channels; i++) {
+      result[i] = com_half_to_float(buffer[i]);
+    }
+  }
+
+  void readBilinearHalf(float *result, float u, float v, bool wrap_x, bool wrap_y);
+
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryBuffer")
 #endif
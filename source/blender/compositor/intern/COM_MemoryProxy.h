@@ -64,6 +64,11 @@ class MemoryProxy {
    */
   DataType m_datatype;
 
+  /**
+   * \brief store the buffer as half floats
+   */
+  bool m_useHalfFloat;
+
  public:
   MemoryProxy(DataType type);
 
@@ -125,6 +130,20 @@ class MemoryProxy {
     return this->m_datatype;
   }
 
+  /**
+   * \brief set whether the buffer is allocated as half floats
+   * \note only for buffers read with the MemoryBuffer accessors, see MemoryBuffer::isHalfFloat
+   */
+  void setUseHalfFloat(bool useHalfFloat)
+  {
+    this->m_useHalfFloat = useHalfFloat;
+  }
+
+  bool getUseHalfFloat() const
+  {
+    return this->m_useHalfFloat;
+  }
+
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryProxy")
 #endif
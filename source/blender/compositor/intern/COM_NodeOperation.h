@@ -124,6 +124,26 @@ class NodeOperation : public SocketReader {
    */
   bool m_isResolutionSet;
 
+  /**
+   * \brief digest of the settings of the node this operation was created for
+   * \note empty when the operation was not created by a node
+   * \see ExecutionCache
+   */
+  std::string m_nodeHash;
+
+  /**
+   * \brief false when the result depends on data other than the node settings and inputs,
+   * so it can't be cached
+   * \see ExecutionCache
+   */
+  bool m_isCacheable;
+
+  /**
+   * \brief the node this operation was created for, used for execution statistics
+   * \note NULL when the operation was not created by a node
+   */
+  bNode *m_bNode;
+
  public:
   virtual ~NodeOperation();
 
@@ -302,6 +322,29 @@ class NodeOperation : public SocketReader {
     return false;
   }
 
+  void setNodeHash(const std::string &hash, bool cacheable)
+  {
+    this->m_nodeHash = hash;
+    this->m_isCacheable = cacheable;
+  }
+  const std::string &getNodeHash() const
+  {
+    return this->m_nodeHash;
+  }
+  bool isCacheable() const
+  {
+    return this->m_isCacheable;
+  }
+
+  void setbNode(bNode *node)
+  {
+    this->m_bNode = node;
+  }
+  bNode *getbNode() const
+  {
+    return this->m_bNode;
+  }
+
   /**
    * \brief is this operation the active viewer output
    * user can select an ViewerNode to be active
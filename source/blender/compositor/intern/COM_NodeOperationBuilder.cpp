@@ -20,6 +20,7 @@
 
 #include "COM_Converter.h"
 #include "COM_Debug.h"
+#include "COM_ExecutionCache.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_Node.h"
 #include "COM_NodeConverter.h"
@@ -38,7 +39,11 @@
 #include "COM_NodeOperationBuilder.h" /* own include */
 
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree)
-    : m_context(context), m_current_node(NULL), m_active_viewer(NULL)
+    : m_context(context),
+      m_current_node(NULL),
+      m_current_node_cacheable(false),
+      m_current_node_operations(0),
+      m_active_viewer(NULL)
 {
   m_graph.from_bNodeTree(*context, b_nodetree);
 }
@@ -56,6 +61,9 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
     Node *node = (Node *)m_graph.nodes()[index];
 
     m_current_node = node;
+    m_current_node_hash.clear();
+    m_current_node_cacheable = ExecutionCache::hashNode(node, m_current_node_hash);
+    m_current_node_operations = 0;
 
     DebugInfo::node_to_operations(node);
     node->convertToOperations(converter, *m_context);
@@ -125,6 +133,13 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
+  if (m_current_node) {
+    /* Operations of the same node are told apart by the order they are added in. */
+    std::stringstream hash;
+    hash << m_current_node_hash << "#" << m_current_node_operations++;
+    operation->setNodeHash(hash.str(), m_current_node_cacheable);
+    operation->setbNode(m_current_node->getbNode());
+  }
   m_operations.push_back(operation);
 }
 
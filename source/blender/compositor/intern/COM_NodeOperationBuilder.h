@@ -89,6 +89,10 @@ class NodeOperationBuilder {
   OutputSocketMap m_output_map;
 
   Node *m_current_node;
+  /** Settings of the current node and number of operations added for it, see ExecutionCache */
+  std::string m_current_node_hash;
+  bool m_current_node_cacheable;
+  int m_current_node_operations;
 
   /** Operation that will be writing to the viewer image
    *  Only one operation can occupy this place at a time,
@@ -94,6 +94,23 @@ class SocketReader {
   {
   }
 
+  /**
+   * \brief calculate a row of pixels
+   * \note this method is called for non-complex, sampling the nearest pixels.
+   * Operations can override it to read their inputs a row at a time and process the row in a
+   * single loop, instead of going through the virtual functions of all inputs for every pixel.
+   * \param output: array of \a length pixels, each one COM_NUM_CHANNELS_COLOR floats
+   * \param x: the x-coordinate of the first pixel of the row in image space
+   * \param y: the y-coordinate of the row in image space
+   * \param length: number of pixels, at most COM_ROW_LENGTH_MAX
+   */
+  virtual void executeRow(float *output, int x, int y, int length)
+  {
+    for (int i = 0; i < length; i++) {
+      executePixelSampled(&output[i * COM_NUM_CHANNELS_COLOR], x + i, y, COM_PS_NEAREST);
+    }
+  }
+
  public:
   inline void readSampled(float result[4], float x, float y, PixelSampler sampler)
   {
@@ -107,6 +124,10 @@ class SocketReader {
   {
     executePixelFiltered(result, x, y, dx, dy);
   }
+  inline void readRow(float *result, int x, int y, int length)
+  {
+    executeRow(result, x, y, length);
+  }
 
   virtual void *initializeTileData(rcti * /*rect*/)
   {
@@ -71,6 +71,31 @@ static bool g_openclInitialized = false;
 #  endif
 #endif
 
+/// \brief number of scheduled and finished work packages, to wake up the scheduling thread
+static ThreadMutex g_progress_mutex = BLI_MUTEX_INITIALIZER;
+static ThreadCondition g_progress_cond;
+static unsigned int g_packages_scheduled = 0;
+static unsigned int g_packages_finished = 0;
+static unsigned int g_packages_finished_seen = 0;
+
+static void package_finished()
+{
+  BLI_mutex_lock(&g_progress_mutex);
+  g_packages_finished++;
+  BLI_condition_notify_all(&g_progress_cond);
+  BLI_mutex_unlock(&g_progress_mutex);
+}
+
+static void package_execute(Device *device, WorkPackage *package)
+{
+  ExecutionGroup *group = package->getExecutionGroup();
+  const double start_time = PIL_check_seconds_timer();
+  device->execute(package);
+  group->addExecutionTime(PIL_check_seconds_timer() - start_time);
+  delete package;
+  package_finished();
+}
+
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
 void *WorkScheduler::thread_execute_cpu(void *data)
 {
@@ -78,8 +103,7 @@ void *WorkScheduler::thread_execute_cpu(void *data)
   WorkPackage *work;
   BLI_thread_local_set(g_thread_device, device);
   while ((work = (WorkPackage *)BLI_thread_queue_pop(g_cpuqueue))) {
-    device->execute(work);
-    delete work;
+    package_execute(device, work);
   }
 
   return NULL;
@@ -91,8 +115,7 @@ void *WorkScheduler::thread_execute_gpu(void *data)
   WorkPackage *work;
 
   while ((work = (WorkPackage *)BLI_thread_queue_pop(g_gpuqueue))) {
-    device->execute(work);
-    delete work;
+    package_execute(device, work);
   }
 
   return NULL;
@@ -102,10 +125,12 @@ void *WorkScheduler::thread_execute_gpu(void *data)
 void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
 {
   WorkPackage *package = new WorkPackage(group, chunkNumber);
+  BLI_mutex_lock(&g_progress_mutex);
+  g_packages_scheduled++;
+  BLI_mutex_unlock(&g_progress_mutex);
 #if COM_CURRENT_THREADING_MODEL == COM_TM_NOTHREAD
   CPUDevice device(0);
-  device.execute(package);
-  delete package;
+  package_execute(&device, package);
 #elif COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
 #  ifdef COM_OPENCL_ENABLED
   if (group->isOpenCL() && g_openclActive) {
@@ -122,6 +147,10 @@ void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
 
 void WorkScheduler::start(CompositorContext &context)
 {
+  BLI_condition_init(&g_progress_cond);
+  g_packages_scheduled = 0;
+  g_packages_finished = 0;
+  g_packages_finished_seen = 0;
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
   unsigned int index;
   g_cpuqueue = BLI_thread_queue_init();
@@ -158,10 +187,21 @@ void WorkScheduler::finish()
     BLI_thread_queue_wait_finish(g_cpuqueue);
   }
 #  else
-  BLI_thread_queue_wait_finish(cpuqueue);
+  BLI_thread_queue_wait_finish(g_cpuqueue);
 #  endif
 #endif
 }
+
+void WorkScheduler::waitForProgress()
+{
+  BLI_mutex_lock(&g_progress_mutex);
+  while (g_packages_finished == g_packages_finished_seen &&
+         g_packages_finished != g_packages_scheduled) {
+    BLI_condition_wait(&g_progress_cond, &g_progress_mutex);
+  }
+  g_packages_finished_seen = g_packages_finished;
+  BLI_mutex_unlock(&g_progress_mutex);
+}
 void WorkScheduler::stop()
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
@@ -178,6 +218,7 @@ void WorkScheduler::stop()
   }
 #  endif
 #endif
+  BLI_condition_end(&g_progress_cond);
 }
 
 bool WorkScheduler::hasGPUDevices()
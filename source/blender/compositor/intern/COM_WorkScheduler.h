@@ -102,6 +102,15 @@ class WorkScheduler {
    */
   static void finish();
 
+  /**
+   * \brief wait until at least one work package finished since the last call,
+   * or until all scheduled work is completed.
+   *
+   * Unlike finish this does not wait for the slowest chunk, so new chunks can be scheduled
+   * as soon as the chunks they depend on are calculated, while the devices keep working.
+   */
+  static void waitForProgress();
+
   /**
    * \brief Are there OpenCL capable GPU devices initialized?
    * the result of this method is stored in the CompositorContext
@@ -23,6 +23,7 @@
 #include "BKE_node.h"
 #include "BKE_scene.h"
 
+#include "COM_ExecutionCache.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_MovieDistortionOperation.h"
 #include "COM_WorkScheduler.h"
@@ -113,6 +114,7 @@ void COM_deinitialize()
   if (is_compositorMutex_init) {
     BLI_mutex_lock(&s_compositorMutex);
     WorkScheduler::deinitialize();
+    ExecutionCache::free();
     is_compositorMutex_init = false;
     BLI_mutex_unlock(&s_compositorMutex);
     BLI_mutex_end(&s_compositorMutex);
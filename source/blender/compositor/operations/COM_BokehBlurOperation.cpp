@@ -18,10 +18,15 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_FFTConvolution.h"
 #include "COM_OpenCLDevice.h"
+#include "MEM_guardedalloc.h"
 
 #include "RE_pipeline.h"
 
+/* Radius in pixels from which the FFT is faster than the direct convolution. */
+#define BOKEH_BLUR_FFT_MIN_RADIUS 16
+
 BokehBlurOperation::BokehBlurOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -39,6 +44,8 @@ BokehBlurOperation::BokehBlurOperation() : NodeOperation()
   this->m_inputBoundingBoxReader = NULL;
 
   this->m_extend_bounds = false;
+  this->m_useFFT = false;
+  this->m_fftResult = NULL;
 }
 
 void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -48,10 +55,70 @@ void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
     updateSize();
   }
   void *buffer = getInputOperation(0)->initializeTileData(NULL);
+  if (this->m_useFFT) {
+    if (!this->m_fftResult) {
+      this->m_fftResult = createFFTResult((MemoryBuffer *)buffer);
+    }
+    buffer = this->m_fftResult;
+  }
   unlockMutex();
   return buffer;
 }
 
+MemoryBuffer *BokehBlurOperation::createFFTResult(MemoryBuffer *input)
+{
+  const float max_dim = max(this->getWidth(), this->getHeight());
+  const int pixelSize = this->m_size * max_dim / 100.0f;
+  const int kernelSize = 2 * pixelSize + 1;
+  const int width = input->getWidth();
+  const int height = input->getHeight();
+  const float m = this->m_bokehDimension / pixelSize;
+
+  /* Same samples as executePixel, which reads from x - pixelSize to x + pixelSize - 1.
+   * Mirrored, as the convolution reads the image at x + pixelSize - kx. */
+  float *kernel = (float *)MEM_callocN(
+      sizeof(float) * COM_NUM_CHANNELS_COLOR * kernelSize * kernelSize, __func__);
+  for (int ky = 1; ky < kernelSize; ky++) {
+    for (int kx = 1; kx < kernelSize; kx++) {
+      float u = this->m_bokehMidX - (pixelSize - kx) * m;
+      float v = this->m_bokehMidY - (pixelSize - ky) * m;
+      this->m_inputBokehProgram->readSampled(
+          &kernel[(ky * kernelSize + kx) * COM_NUM_CHANNELS_COLOR], u, v, COM_PS_NEAREST);
+    }
+  }
+
+  /* Pixels near the border are normalized by the part of the kernel inside the image,
+   * the convolution of the kernel with an image of ones. */
+  float *ones = (float *)MEM_mallocN(sizeof(float) * width * height, __func__);
+  float *weights = (float *)MEM_mallocN(sizeof(float) * width * height, __func__);
+  for (int i = 0; i < width * height; i++) {
+    ones[i] = 1.0f;
+  }
+
+  MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, input->getRect());
+  result->clear();
+  float *buffer = result->getBuffer();
+
+  FFTConvolution convolution(kernelSize, kernelSize);
+  for (int ch = 0; ch < COM_NUM_CHANNELS_COLOR; ch++) {
+    convolution.setKernel(&kernel[ch], COM_NUM_CHANNELS_COLOR);
+    convolution.convolve(
+        &input->getBuffer()[ch], width, height, COM_NUM_CHANNELS_COLOR, &buffer[ch]);
+
+    memset(weights, 0, sizeof(float) * width * height);
+    convolution.convolve(ones, width, height, 1, weights);
+    for (int i = 0; i < width * height; i++) {
+      float *value = &buffer[i * COM_NUM_CHANNELS_COLOR + ch];
+      *value = (weights[i] != 0.0f) ? *value / weights[i] : 0.0f;
+    }
+  }
+
+  MEM_freeN(weights);
+  MEM_freeN(ones);
+  MEM_freeN(kernel);
+  return result;
+}
+
 void BokehBlurOperation::initExecution()
 {
   initMutex();
@@ -68,6 +135,11 @@ void BokehBlurOperation::initExecution()
   this->m_bokehMidY = height / 2.0f;
   this->m_bokehDimension = dimension / 2.0f;
   QualityStepHelper::initExecution(COM_QH_INCREASE);
+
+  /* Only when the size is known in advance, the whole input is needed then. */
+  const float max_dim = max(this->getWidth(), this->getHeight());
+  this->m_useFFT = this->m_sizeavailable &&
+                   (int)(this->m_size * max_dim / 100.0f) >= BOKEH_BLUR_FFT_MIN_RADIUS;
 }
 
 void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
@@ -77,7 +149,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
   float bokeh[4];
 
   this->m_inputBoundingBoxReader->readSampled(tempBoundingBox, x, y, COM_PS_NEAREST);
-  if (tempBoundingBox[0] > 0.0f) {
+  if (tempBoundingBox[0] > 0.0f && this->m_useFFT) {
+    ((MemoryBuffer *)data)->read(output, x, y);
+  }
+  else if (tempBoundingBox[0] > 0.0f) {
     float multiplier_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
     float *buffer = inputBuffer->getBuffer();
@@ -132,6 +207,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 
 void BokehBlurOperation::deinitExecution()
 {
+  if (this->m_fftResult) {
+    delete this->m_fftResult;
+    this->m_fftResult = NULL;
+  }
   deinitMutex();
   this->m_inputProgram = NULL;
   this->m_inputBokehProgram = NULL;
@@ -146,7 +225,14 @@ bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input,
   rcti bokehInput;
   const float max_dim = max(this->getWidth(), this->getHeight());
 
-  if (this->m_sizeavailable) {
+  if (this->m_useFFT) {
+    NodeOperation *operation = getInputOperation(0);
+    newInput.xmin = 0;
+    newInput.ymin = 0;
+    newInput.xmax = operation->getWidth();
+    newInput.ymax = operation->getHeight();
+  }
+  else if (this->m_sizeavailable) {
     newInput.xmax = input->xmax + (this->m_size * max_dim / 100.0f);
     newInput.xmin = input->xmin - (this->m_size * max_dim / 100.0f);
     newInput.ymax = input->ymax + (this->m_size * max_dim / 100.0f);
@@ -35,6 +35,11 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
   float m_bokehDimension;
   bool m_extend_bounds;
 
+  /** Convolve the whole image at once using the FFT, for large sizes */
+  bool m_useFFT;
+  MemoryBuffer *m_fftResult;
+  MemoryBuffer *createFFTResult(MemoryBuffer *input);
+
  public:
   BokehBlurOperation();
 
@@ -54,6 +54,16 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertValueToColorOperation::executeRow(float *output, int x, int y, int length)
+{
+  this->m_inputOperation->readRow(output, x, y, length);
+  for (int i = 0; i < length; i++) {
+    float *color = &output[i * COM_NUM_CHANNELS_COLOR];
+    color[1] = color[2] = color[0];
+    color[3] = 1.0f;
+  }
+}
+
 /* ******** Color to Value ******** */
 
 ConvertColorToValueOperation::ConvertColorToValueOperation() : ConvertBaseOperation()
@@ -72,6 +82,15 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4],
   output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
 }
 
+void ConvertColorToValueOperation::executeRow(float *output, int x, int y, int length)
+{
+  this->m_inputOperation->readRow(output, x, y, length);
+  for (int i = 0; i < length; i++) {
+    float *color = &output[i * COM_NUM_CHANNELS_COLOR];
+    color[0] = (color[0] + color[1] + color[2]) / 3.0f;
+  }
+}
+
 /* ******** Color to BW ******** */
 
 ConvertColorToBWOperation::ConvertColorToBWOperation() : ConvertBaseOperation()
@@ -90,6 +109,15 @@ void ConvertColorToBWOperation::executePixelSampled(float output[4],
   output[0] = IMB_colormanagement_get_luminance(inputColor);
 }
 
+void ConvertColorToBWOperation::executeRow(float *output, int x, int y, int length)
+{
+  this->m_inputOperation->readRow(output, x, y, length);
+  for (int i = 0; i < length; i++) {
+    float *color = &output[i * COM_NUM_CHANNELS_COLOR];
+    color[0] = IMB_colormanagement_get_luminance(color);
+  }
+}
+
 /* ******** Color to Vector ******** */
 
 ConvertColorToVectorOperation::ConvertColorToVectorOperation() : ConvertBaseOperation()
@@ -108,6 +136,12 @@ void ConvertColorToVectorOperation::executePixelSampled(float output[4],
   copy_v3_v3(output, color);
 }
 
+void ConvertColorToVectorOperation::executeRow(float *output, int x, int y, int length)
+{
+  /* Same memory layout, the fourth channel of a vector is unused. */
+  this->m_inputOperation->readRow(output, x, y, length);
+}
+
 /* ******** Value to Vector ******** */
 
 ConvertValueToVectorOperation::ConvertValueToVectorOperation() : ConvertBaseOperation()
@@ -126,6 +160,15 @@ void ConvertValueToVectorOperation::executePixelSampled(float output[4],
   output[0] = output[1] = output[2] = value;
 }
 
+void ConvertValueToVectorOperation::executeRow(float *output, int x, int y, int length)
+{
+  this->m_inputOperation->readRow(output, x, y, length);
+  for (int i = 0; i < length; i++) {
+    float *vector = &output[i * COM_NUM_CHANNELS_COLOR];
+    vector[1] = vector[2] = vector[0];
+  }
+}
+
 /* ******** Vector to Color ******** */
 
 ConvertVectorToColorOperation::ConvertVectorToColorOperation() : ConvertBaseOperation()
@@ -143,6 +186,14 @@ void ConvertVectorToColorOperation::executePixelSampled(float output[4],
   output[3] = 1.0f;
 }
 
+void ConvertVectorToColorOperation::executeRow(float *output, int x, int y, int length)
+{
+  this->m_inputOperation->readRow(output, x, y, length);
+  for (int i = 0; i < length; i++) {
+    output[i * COM_NUM_CHANNELS_COLOR + 3] = 1.0f;
+  }
+}
+
 /* ******** Vector to Value ******** */
 
 ConvertVectorToValueOperation::ConvertVectorToValueOperation() : ConvertBaseOperation()
@@ -161,6 +212,15 @@ void ConvertVectorToValueOperation::executePixelSampled(float output[4],
   output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
+void ConvertVectorToValueOperation::executeRow(float *output, int x, int y, int length)
+{
+  this->m_inputOperation->readRow(output, x, y, length);
+  for (int i = 0; i < length; i++) {
+    float *vector = &output[i * COM_NUM_CHANNELS_COLOR];
+    vector[0] = (vector[0] + vector[1] + vector[2]) / 3.0f;
+  }
+}
+
 /* ******** RGB to YCC ******** */
 
 ConvertRGBToYCCOperation::ConvertRGBToYCCOperation() : ConvertBaseOperation()
@@ -0,0 +1,78 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#ifndef __COM_FFTCONVOLUTION_H__
+#define __COM_FFTCONVOLUTION_H__
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+/**
+ * \brief 2D convolution of a single channel using the Fast Hartley Transform.
+ *
+ * The cost per pixel grows with the logarithm of the kernel size instead of its area, so this
+ * is used instead of a direct convolution for large kernels. Images of any size are convolved
+ * block by block using the overlap-add method, the transform of the kernel is reused for every
+ * block and every image convolved with the same kernel.
+ */
+class FFTConvolution {
+ private:
+  unsigned int m_kernelWidth;
+  unsigned int m_kernelHeight;
+  /** Size of the transform and its log2, at least twice the kernel size. */
+  unsigned int m_width;
+  unsigned int m_height;
+  unsigned int m_log2Width;
+  unsigned int m_log2Height;
+
+  /** Transformed kernel and transform of the current block. */
+  float *m_kernel;
+  float *m_block;
+
+ public:
+  FFTConvolution(unsigned int kernelWidth, unsigned int kernelHeight);
+  ~FFTConvolution();
+
+  /**
+   * \brief set the kernel to convolve with
+   * \param kernel: kernelWidth * kernelHeight values, \a stride floats apart, so a single
+   * channel of a color buffer can be used.
+   */
+  void setKernel(const float *kernel, unsigned int stride);
+
+  /**
+   * \brief add the convolution of \a image with the kernel to \a result
+   *
+   * The result is centered on the middle of the kernel: pixel (x, y) of the result gets
+   * the image at (x + kernelWidth / 2 - i, y + kernelHeight / 2 - j) times the kernel at (i, j).
+   * Pixels outside the image are zero.
+   * \param stride: number of floats between pixels, in both \a image and \a result
+   */
+  void convolve(const float *image,
+                unsigned int width,
+                unsigned int height,
+                unsigned int stride,
+                float *result);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:FFTConvolution")
+#endif
+};
+
+#endif /* __COM_FFTCONVOLUTION_H__ */
@@ -49,6 +49,26 @@ void GammaOperation::executePixelSampled(float output[4], float x, float y, Pixe
   output[3] = inputValue[3];
 }
 
+void GammaOperation::executeRow(float *output, int x, int y, int length)
+{
+  float inputGamma[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+
+  this->m_inputProgram->readRow(output, x, y, length);
+  this->m_inputGammaProgram->readRow(inputGamma, x, y, length);
+
+  for (int i = 0; i < length; i++) {
+    float *color = &output[i * COM_NUM_CHANNELS_COLOR];
+    const float gamma = inputGamma[i * COM_NUM_CHANNELS_COLOR];
+    if (gamma == 1.0f) {
+      continue;
+    }
+    /* check for negative to avoid nan's */
+    color[0] = color[0] > 0.0f ? powf(color[0], gamma) : color[0];
+    color[1] = color[1] > 0.0f ? powf(color[1], gamma) : color[1];
+    color[2] = color[2] > 0.0f ? powf(color[2], gamma) : color[2];
+  }
+}
+
 void GammaOperation::deinitExecution()
 {
   this->m_inputProgram = NULL;
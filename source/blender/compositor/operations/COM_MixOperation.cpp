@@ -20,6 +20,10 @@
 
 #include "BLI_math.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 /* ******** Mix Base Operation ******** */
 
 MixBaseOperation::MixBaseOperation() : NodeOperation()
@@ -63,6 +67,22 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
   output[3] = inputColor1[3];
 }
 
+void MixBaseOperation::readInputRows(
+    float *value, float *color1, float *color2, int x, int y, int length)
+{
+  this->m_inputValueOperation->readRow(value, x, y, length);
+  this->m_inputColor1Operation->readRow(color1, x, y, length);
+  this->m_inputColor2Operation->readRow(color2, x, y, length);
+
+  /* Pack the factors at the start of the row, reading ahead of the write position. */
+  for (int i = 0; i < length; i++) {
+    value[i] = value[i * COM_NUM_CHANNELS_COLOR];
+    if (this->useValueAlphaMultiply()) {
+      value[i] *= color2[i * COM_NUM_CHANNELS_COLOR + 3];
+    }
+  }
+}
+
 void MixBaseOperation::determineResolution(unsigned int resolution[2],
                                            unsigned int preferredResolution[2])
 {
@@ -124,6 +144,34 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
   clampIfNeeded(output);
 }
 
+void MixAddOperation::executeRow(float *output, int x, int y, int length)
+{
+  float inputValue[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor1[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor2[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+
+  readInputRows(inputValue, inputColor1, inputColor2, x, y, length);
+
+  for (int i = 0; i < length; i++) {
+    const float *color1 = &inputColor1[i * COM_NUM_CHANNELS_COLOR];
+    const float *color2 = &inputColor2[i * COM_NUM_CHANNELS_COLOR];
+    float *result = &output[i * COM_NUM_CHANNELS_COLOR];
+    float value = inputValue[i];
+#ifdef __SSE2__
+    const __m128 value_v = _mm_set1_ps(value);
+    _mm_storeu_ps(result,
+                  _mm_add_ps(_mm_loadu_ps(color1), _mm_mul_ps(value_v, _mm_loadu_ps(color2))));
+#else
+    result[0] = color1[0] + value * color2[0];
+    result[1] = color1[1] + value * color2[1];
+    result[2] = color1[2] + value * color2[2];
+#endif
+    result[3] = color1[3];
+
+    clampIfNeeded(result);
+  }
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
@@ -158,6 +206,37 @@ void MixBlendOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixBlendOperation::executeRow(float *output, int x, int y, int length)
+{
+  float inputValue[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor1[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor2[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+
+  readInputRows(inputValue, inputColor1, inputColor2, x, y, length);
+
+  for (int i = 0; i < length; i++) {
+    const float *color1 = &inputColor1[i * COM_NUM_CHANNELS_COLOR];
+    const float *color2 = &inputColor2[i * COM_NUM_CHANNELS_COLOR];
+    float *result = &output[i * COM_NUM_CHANNELS_COLOR];
+    float value = inputValue[i];
+    float valuem = 1.0f - value;
+#ifdef __SSE2__
+    const __m128 value_v = _mm_set1_ps(value);
+    const __m128 valuem_v = _mm_set1_ps(valuem);
+    _mm_storeu_ps(result,
+                  _mm_add_ps(_mm_mul_ps(valuem_v, _mm_loadu_ps(color1)),
+                             _mm_mul_ps(value_v, _mm_loadu_ps(color2))));
+#else
+    result[0] = valuem * color1[0] + value * color2[0];
+    result[1] = valuem * color1[1] + value * color2[1];
+    result[2] = valuem * color1[2] + value * color2[2];
+#endif
+    result[3] = color1[3];
+
+    clampIfNeeded(result);
+  }
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixColorBurnOperation::MixColorBurnOperation() : MixBaseOperation()
@@ -705,6 +784,38 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::executeRow(float *output, int x, int y, int length)
+{
+  float inputValue[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor1[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor2[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+
+  readInputRows(inputValue, inputColor1, inputColor2, x, y, length);
+
+  for (int i = 0; i < length; i++) {
+    const float *color1 = &inputColor1[i * COM_NUM_CHANNELS_COLOR];
+    const float *color2 = &inputColor2[i * COM_NUM_CHANNELS_COLOR];
+    float *result = &output[i * COM_NUM_CHANNELS_COLOR];
+    float value = inputValue[i];
+    float valuem = 1.0f - value;
+#ifdef __SSE2__
+    const __m128 value_v = _mm_set1_ps(value);
+    const __m128 valuem_v = _mm_set1_ps(valuem);
+    _mm_storeu_ps(
+        result,
+        _mm_mul_ps(_mm_loadu_ps(color1),
+                   _mm_add_ps(valuem_v, _mm_mul_ps(value_v, _mm_loadu_ps(color2)))));
+#else
+    result[0] = color1[0] * (valuem + value * color2[0]);
+    result[1] = color1[1] * (valuem + value * color2[1]);
+    result[2] = color1[2] * (valuem + value * color2[2]);
+#endif
+    result[3] = color1[3];
+
+    clampIfNeeded(result);
+  }
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -909,6 +1020,34 @@ void MixSubtractOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+void MixSubtractOperation::executeRow(float *output, int x, int y, int length)
+{
+  float inputValue[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor1[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+  float inputColor2[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+
+  readInputRows(inputValue, inputColor1, inputColor2, x, y, length);
+
+  for (int i = 0; i < length; i++) {
+    const float *color1 = &inputColor1[i * COM_NUM_CHANNELS_COLOR];
+    const float *color2 = &inputColor2[i * COM_NUM_CHANNELS_COLOR];
+    float *result = &output[i * COM_NUM_CHANNELS_COLOR];
+    float value = inputValue[i];
+#ifdef __SSE2__
+    const __m128 value_v = _mm_set1_ps(value);
+    _mm_storeu_ps(result,
+                  _mm_sub_ps(_mm_loadu_ps(color1), _mm_mul_ps(value_v, _mm_loadu_ps(color2))));
+#else
+    result[0] = color1[0] - value * color2[0];
+    result[1] = color1[1] - value * color2[1];
+    result[2] = color1[2] - value * color2[2];
+#endif
+    result[3] = color1[3];
+
+    clampIfNeeded(result);
+  }
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
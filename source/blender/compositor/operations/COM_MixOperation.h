@@ -43,6 +43,12 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+  /**
+   * Read a row of all inputs for #executeRow. The rows hold COM_ROW_LENGTH_MAX colors, the first
+   * \a length floats of \a value are replaced by the mix factor of every pixel.
+   */
+  void readInputRows(float *value, float *color1, float *color2, int x, int y, int length);
+
  public:
   /**
    * Default constructor
@@ -84,12 +90,14 @@ class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int length);
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int length);
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
@@ -156,6 +164,7 @@ class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int length);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -186,6 +195,7 @@ class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int length);
 };
 
 class MixValueOperation : public MixBaseOperation {
@@ -31,6 +31,11 @@ class WrapOperation : public ReadBufferOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executeRow(float *output, int x, int y, int length)
+  {
+    /* Every pixel is wrapped separately, don't use the row reading of the buffer. */
+    NodeOperation::executeRow(output, x, y, length);
+  }
 
   void setWrapping(int wrapping_type);
   float getWrappedOriginalXPos(float x);
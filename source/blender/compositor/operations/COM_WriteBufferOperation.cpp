@@ -59,7 +59,8 @@ void WriteBufferOperation::deinitExecution()
 void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 {
   MemoryBuffer *memoryBuffer = this->m_memoryProxy->getBuffer();
-  float *buffer = memoryBuffer->getBuffer();
+  /* Half float buffers are written per pixel, converting the values. */
+  float *buffer = memoryBuffer->isHalfFloat() ? NULL : memoryBuffer->getBuffer();
   const int num_channels = memoryBuffer->get_num_channels();
   if (this->m_input->isComplex()) {
     void *data = this->m_input->initializeTileData(rect);
@@ -73,7 +74,14 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     for (y = y1; y < y2 && (!breaked); y++) {
       int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
       for (x = x1; x < x2; x++) {
-        this->m_input->read(&(buffer[offset4]), x, y, data);
+        if (buffer) {
+          this->m_input->read(&(buffer[offset4]), x, y, data);
+        }
+        else {
+          float color[4];
+          this->m_input->read(color, x, y, data);
+          memoryBuffer->writePixel(x, y, color);
+        }
         offset4 += num_channels;
       }
       if (isBraked()) {
@@ -91,14 +99,27 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     int x2 = rect->xmax;
     int y2 = rect->ymax;
 
+    /* Read rows, so operations that support it process many pixels per call. */
+    float row[COM_ROW_LENGTH_MAX * COM_NUM_CHANNELS_COLOR];
+
     int x;
     int y;
     bool breaked = false;
     for (y = y1; y < y2 && (!breaked); y++) {
       int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-      for (x = x1; x < x2; x++) {
-        this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-        offset4 += num_channels;
+      for (x = x1; x < x2; x += COM_ROW_LENGTH_MAX) {
+        const int length = min_ii(x2 - x, COM_ROW_LENGTH_MAX);
+        this->m_input->readRow(row, x, y, length);
+        for (int i = 0; i < length; i++) {
+          if (buffer) {
+            memcpy(
+                &buffer[offset4], &row[i * COM_NUM_CHANNELS_COLOR], sizeof(float) * num_channels);
+          }
+          else {
+            memoryBuffer->writePixel(x + i, y, &row[i * COM_NUM_CHANNELS_COLOR]);
+          }
+          offset4 += num_channels;
+        }
       }
       if (isBraked()) {
         breaked = true;
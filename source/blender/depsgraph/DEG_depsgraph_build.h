@@ -94,6 +94,11 @@ void DEG_graph_relations_update(struct Depsgraph *graph,
 /* Tag all relations in the database for update.*/
 void DEG_relations_tag_update(struct Main *bmain);
 
+/* Tag relations for update after the relations of the given ID changed.
+ * Only dependency graphs which contain the ID are affected: other IDs are only pulled into a
+ * graph through relations of IDs which are already part of it. */
+void DEG_id_relations_tag_update(struct Main *bmain, struct ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /* Handle for components to define their dependencies from callbacks.
@@ -53,6 +53,18 @@ void DEG_stats_simple(const struct Depsgraph *graph,
                       size_t *r_operations,
                       size_t *r_relations);
 
+typedef void (*DEGStatsComponentTimeCallback)(void *user_data,
+                                              const char *id_name,
+                                              const char *component_name,
+                                              double time);
+
+/* Report the time in seconds spent evaluating each ID component during the last evaluation.
+ * Components which were not evaluated are skipped.
+ * Timing is only gathered when time debugging (G_DEBUG_DEPSGRAPH_TIME) is enabled. */
+void DEG_stats_foreach_component_time(const struct Depsgraph *graph,
+                                      DEGStatsComponentTimeCallback callback,
+                                      void *user_data);
+
 /* ************************************************ */
 /* Diagram-Based Graph Debugging */
 
@@ -63,6 +75,17 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Tracing */
+
+/* Write a record of every evaluated operation (start and end time, and the thread it was
+ * evaluated on) to the given file, in the Chrome trace event format which can be opened in
+ * `chrome://tracing` or Perfetto. Applies to all dependency graphs, until #DEG_debug_trace_end.
+ * Returns false when the file could not be opened. */
+bool DEG_debug_trace_begin(const char *filepath);
+void DEG_debug_trace_end(void);
+bool DEG_debug_trace_is_enabled(void);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
@@ -31,7 +31,9 @@
 #include "DNA_layer_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_listbase.h"
 #include "BLI_stack.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_action.h"
@@ -108,6 +110,26 @@ bool DepsgraphBuilder::need_pull_base_into_graph(Base *base)
   return cache_->isPropertyAnimated(&object->id, property_id);
 }
 
+void DepsgraphBuilder::cache_view_layer_animated_properties(ViewLayer *view_layer)
+{
+  const int base_flag = (graph_->mode == DAG_EVAL_VIEWPORT) ? BASE_ENABLED_VIEWPORT :
+                                                              BASE_ENABLED_RENDER;
+  Vector<ID *> ids;
+  LISTBASE_FOREACH (Base *, base, &view_layer->object_bases) {
+    Object *object = base->object;
+    /* Visibility of disabled bases, see need_pull_base_into_graph(). */
+    if ((base->flag & base_flag) == 0) {
+      ids.append(&object->id);
+    }
+    /* B-Bone segments, see check_pchan_has_bbone(). */
+    if (object->type == OB_ARMATURE && object->pose != nullptr) {
+      ids.append(&object->id);
+      ids.append(static_cast<ID *>(object->data));
+    }
+  }
+  cache_->ensureInitializedAnimatedPropertyStorages(ids);
+}
+
 bool DepsgraphBuilder::check_pchan_has_bbone(Object *object, const bPoseChannel *pchan)
 {
   BLI_assert(object->type == OB_ARMATURE);
@@ -202,6 +224,14 @@ void deg_graph_build_flush_visibility(Depsgraph *graph)
   BLI_stack_free(stack);
 }
 
+void finalize_build_id_node_func(void *__restrict data_v,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict /*tls*/)
+{
+  Depsgraph *graph = (Depsgraph *)data_v;
+  graph->id_nodes[i]->finalize_build(graph);
+}
+
 }  // namespace
 
 void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
@@ -210,11 +240,19 @@ void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
   deg_graph_build_flush_visibility(graph);
   deg_graph_remove_unused_noops(graph);
 
+  /* Finalizing only touches nodes owned by the ID node, so it can happen in parallel. */
+  {
+    const int num_id_nodes = graph->id_nodes.size();
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 256;
+    BLI_task_parallel_range(0, num_id_nodes, graph, finalize_build_id_node_func, &settings);
+  }
+
   /* Re-tag IDs for update if it was tagged before the relations
    * update tag. */
   for (IDNode *id_node : graph->id_nodes) {
     ID *id_orig = id_node->id_orig;
-    id_node->finalize_build(graph);
     int flag = 0;
     /* Tag rebuild if special evaluation flags changed. */
     if (id_node->eval_flags != id_node->previous_eval_flags) {
@@ -27,6 +27,7 @@ struct Base;
 struct ID;
 struct Main;
 struct Object;
+struct ViewLayer;
 struct bPoseChannel;
 
 namespace blender {
@@ -49,6 +50,10 @@ class DepsgraphBuilder {
   /* NOTE: The builder does NOT take ownership over any of those resources. */
   DepsgraphBuilder(Main *bmain, Depsgraph *graph, DepsgraphBuilderCache *cache);
 
+  /* Resolve animated properties which are queried while building the view layer in parallel,
+   * instead of resolving them one ID at a time as they are queried. */
+  void cache_view_layer_animated_properties(ViewLayer *view_layer);
+
   /* State which never changes, same for the whole builder time. */
   Main *bmain_;
   Depsgraph *graph_;
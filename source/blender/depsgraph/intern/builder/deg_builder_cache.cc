@@ -27,6 +27,7 @@
 
 #include "DNA_anim_types.h"
 
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_animsys.h"
@@ -81,10 +82,19 @@ uint64_t AnimatedPropertyID::hash() const
 
 namespace {
 
+/* Property of a nested datablock, animated by its parent. */
+struct NestedAnimatedPropertyID {
+  ID *id;
+  AnimatedPropertyID property_id;
+};
+
 struct AnimatedPropertyCallbackData {
   PointerRNA pointer_rna;
   AnimatedPropertyStorage *animated_property_storage;
   DepsgraphBuilderCache *builder_cache;
+  /* When not null, properties of nested datablocks are stored here instead of being tagged in
+   * the storage of their ID. Used when storage of multiple IDs is initialized from threads. */
+  Vector<NestedAnimatedPropertyID> *nested_properties;
 };
 
 void animated_property_cb(ID * /*id*/, FCurve *fcurve, void *data_v)
@@ -104,6 +114,11 @@ void animated_property_cb(ID * /*id*/, FCurve *fcurve, void *data_v)
    * This is needed to deal with cases when nested datablock is animated by its parent. */
   AnimatedPropertyStorage *animated_property_storage = data->animated_property_storage;
   if (pointer_rna.owner_id != data->pointer_rna.owner_id) {
+    if (data->nested_properties != nullptr) {
+      data->nested_properties->append(
+          {pointer_rna.owner_id, AnimatedPropertyID(&pointer_rna, property_rna)});
+      return;
+    }
     animated_property_storage = data->builder_cache->ensureAnimatedPropertyStorage(
         pointer_rna.owner_id);
   }
@@ -111,6 +126,25 @@ void animated_property_cb(ID * /*id*/, FCurve *fcurve, void *data_v)
   animated_property_storage->tagPropertyAsAnimated(&pointer_rna, property_rna);
 }
 
+struct AnimatedPropertyInitializeData {
+  Span<ID *> ids;
+  Span<AnimatedPropertyStorage *> storages;
+  MutableSpan<Vector<NestedAnimatedPropertyID>> nested_properties;
+};
+
+void animated_property_initialize_func(void *__restrict data_v,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict /*tls*/)
+{
+  AnimatedPropertyInitializeData *data = static_cast<AnimatedPropertyInitializeData *>(data_v);
+  AnimatedPropertyCallbackData callback_data;
+  RNA_id_pointer_create(data->ids[i], &callback_data.pointer_rna);
+  callback_data.animated_property_storage = data->storages[i];
+  callback_data.builder_cache = nullptr;
+  callback_data.nested_properties = &data->nested_properties[i];
+  BKE_fcurves_id_cb(data->ids[i], animated_property_cb, &callback_data);
+}
+
 }  // namespace
 
 AnimatedPropertyStorage::AnimatedPropertyStorage() : is_fully_initialized(false)
@@ -123,6 +157,7 @@ void AnimatedPropertyStorage::initializeFromID(DepsgraphBuilderCache *builder_ca
   RNA_id_pointer_create(id, &data.pointer_rna);
   data.animated_property_storage = this;
   data.builder_cache = builder_cache;
+  data.nested_properties = nullptr;
   BKE_fcurves_id_cb(id, animated_property_cb, &data);
 }
 
@@ -178,5 +213,43 @@ AnimatedPropertyStorage *DepsgraphBuilderCache::ensureInitializedAnimatedPropert
   return animated_property_storage;
 }
 
+void DepsgraphBuilderCache::ensureInitializedAnimatedPropertyStorages(Span<ID *> ids)
+{
+  /* Create all the storages up-front, so every thread only modifies the storage of its own ID. */
+  Vector<ID *> ids_to_initialize;
+  Vector<AnimatedPropertyStorage *> storages;
+  for (ID *id : ids) {
+    AnimatedPropertyStorage *animated_property_storage = ensureAnimatedPropertyStorage(id);
+    if (!animated_property_storage->is_fully_initialized) {
+      animated_property_storage->is_fully_initialized = true;
+      ids_to_initialize.append(id);
+      storages.append(animated_property_storage);
+    }
+  }
+  if (ids_to_initialize.is_empty()) {
+    return;
+  }
+
+  Vector<Vector<NestedAnimatedPropertyID>> nested_properties(ids_to_initialize.size());
+  AnimatedPropertyInitializeData data;
+  data.ids = ids_to_initialize;
+  data.storages = storages;
+  data.nested_properties = nested_properties;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0, ids_to_initialize.size(), &data, animated_property_initialize_func, &settings);
+
+  /* Merge properties of nested datablocks, in the same order as the IDs were given. */
+  for (const Vector<NestedAnimatedPropertyID> &id_nested_properties : nested_properties) {
+    for (const NestedAnimatedPropertyID &nested_property : id_nested_properties) {
+      ensureAnimatedPropertyStorage(nested_property.id)
+          ->tagPropertyAsAnimated(nested_property.property_id);
+    }
+  }
+}
+
 }  // namespace deg
 }  // namespace blender
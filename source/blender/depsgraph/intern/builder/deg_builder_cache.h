@@ -88,6 +88,10 @@ class DepsgraphBuilderCache {
   AnimatedPropertyStorage *ensureAnimatedPropertyStorage(ID *id);
   AnimatedPropertyStorage *ensureInitializedAnimatedPropertyStorage(ID *id);
 
+  /* Initialize storage of multiple IDs at once. Animation of the IDs is resolved in parallel,
+   * which is much faster for big scenes than initializing the storage on-demand. */
+  void ensureInitializedAnimatedPropertyStorages(Span<ID *> ids);
+
   /* Shortcuts to go through ensureInitializedAnimatedPropertyStorage and its
    * isPropertyAnimated.
    *
@@ -205,6 +205,30 @@ void DepsgraphNodeBuilder::build_rig(Object *object, bool is_object_visible)
                                OperationCode::POSE_DONE,
                                function_bind(BKE_pose_eval_done, _1, object_cow));
   op_node->set_as_exit();
+  /* Bones which IK solvers modify between their BONE_READY and BONE_DONE steps. */
+  Set<const bPoseChannel *> ik_chain_pchans;
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &object->pose->chanbase) {
+    LISTBASE_FOREACH (bConstraint *, con, &pchan->constraints) {
+      bPoseChannel *rootchan = nullptr;
+      if (con->type == CONSTRAINT_TYPE_KINEMATIC) {
+        rootchan = BKE_armature_ik_solver_find_root(pchan, (bKinematicConstraint *)con->data);
+      }
+      else if (con->type == CONSTRAINT_TYPE_SPLINEIK) {
+        rootchan = BKE_armature_splineik_solver_find_root(pchan,
+                                                          (bSplineIKConstraint *)con->data);
+      }
+      else {
+        continue;
+      }
+      for (bPoseChannel *chain_pchan = pchan; chain_pchan != nullptr;
+           chain_pchan = chain_pchan->parent) {
+        ik_chain_pchans.add(chain_pchan);
+        if (chain_pchan == rootchan) {
+          break;
+        }
+      }
+    }
+  }
   /* Bones. */
   int pchan_index = 0;
   LISTBASE_FOREACH (bPoseChannel *, pchan, &object->pose->chanbase) {
@@ -213,20 +237,42 @@ void DepsgraphNodeBuilder::build_rig(Object *object, bool is_object_visible)
         &object->id, NodeType::BONE, pchan->name, OperationCode::BONE_LOCAL);
     op_node->set_as_entry();
 
-    add_operation_node(&object->id,
-                       NodeType::BONE,
-                       pchan->name,
-                       OperationCode::BONE_POSE_PARENT,
-                       function_bind(BKE_pose_eval_bone, _1, scene_cow, object_cow, pchan_index));
+    /* Nothing happens between the parenting and the final result of bones without constraints
+     * outside of IK chains, so both are done by one operation and BONE_DONE is a no-op. */
+    const bool is_simple_bone = pchan->constraints.first == nullptr &&
+                                !ik_chain_pchans.contains(pchan);
+    if (is_simple_bone) {
+      add_operation_node(
+          &object->id,
+          NodeType::BONE,
+          pchan->name,
+          OperationCode::BONE_POSE_PARENT,
+          function_bind(BKE_pose_eval_bone_and_done, _1, scene_cow, object_cow, pchan_index));
+    }
+    else {
+      add_operation_node(
+          &object->id,
+          NodeType::BONE,
+          pchan->name,
+          OperationCode::BONE_POSE_PARENT,
+          function_bind(BKE_pose_eval_bone, _1, scene_cow, object_cow, pchan_index));
+    }
 
     /* NOTE: Dedicated noop for easier relationship construction. */
     add_operation_node(&object->id, NodeType::BONE, pchan->name, OperationCode::BONE_READY);
 
-    op_node = add_operation_node(&object->id,
-                                 NodeType::BONE,
-                                 pchan->name,
-                                 OperationCode::BONE_DONE,
-                                 function_bind(BKE_pose_bone_done, _1, object_cow, pchan_index));
+    if (is_simple_bone) {
+      op_node = add_operation_node(
+          &object->id, NodeType::BONE, pchan->name, OperationCode::BONE_DONE);
+    }
+    else {
+      op_node = add_operation_node(
+          &object->id,
+          NodeType::BONE,
+          pchan->name,
+          OperationCode::BONE_DONE,
+          function_bind(BKE_pose_bone_done, _1, object_cow, pchan_index));
+    }
 
     /* B-Bone shape computation - the real last step if present. */
     if (check_pchan_has_bbone(object, pchan)) {
@@ -101,6 +101,8 @@ void DepsgraphNodeBuilder::build_view_layer(Scene *scene,
   view_layer_ = view_layer;
   /* Get pointer to a CoW version of scene ID. */
   Scene *scene_cow = get_cow_datablock(scene);
+  /* Animated properties are shared with the relations builder through the cache. */
+  cache_view_layer_animated_properties(view_layer);
   /* Scene objects. */
   /* NOTE: Base is used for function bindings as-is, so need to pass CoW base,
    * but object is expected to be an original one. Hence we go into some
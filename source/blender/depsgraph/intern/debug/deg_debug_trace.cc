@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Trace of the dependency graph evaluation in the Chrome trace event format.
+ *
+ * Every evaluated operation is written as a "complete" event with its start time, duration and
+ * the thread it was evaluated on, nested under an event for the whole graph evaluation. The file
+ * can be opened in `chrome://tracing` or Perfetto.
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <cstdio>
+
+#include "BLI_fileops.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+
+#include "DEG_depsgraph_debug.h"
+
+#include "atomic_ops.h"
+
+#include "intern/depsgraph.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace deg = blender::deg;
+
+namespace blender {
+namespace deg {
+namespace {
+
+struct TraceEvent {
+  string name;
+  const char *category;
+  double start_time;
+  double end_time;
+  int thread_index;
+};
+
+struct Trace {
+  FILE *file = nullptr;
+  /* Time at which tracing began, all event times are relative to it. */
+  double start_time = 0.0;
+  /* Number of events written so far. */
+  int num_written_events = 0;
+  /* Number of threads which recorded events, used to give every thread a small index. */
+  int num_threads = 0;
+
+  /* Operations recorded during the current graph evaluation. */
+  SpinLock lock;
+  Vector<TraceEvent> events;
+};
+
+Trace trace;
+
+thread_local int trace_thread_index = -1;
+
+int trace_get_thread_index()
+{
+  if (trace_thread_index == -1) {
+    trace_thread_index = atomic_fetch_and_add_int32(&trace.num_threads, 1);
+  }
+  return trace_thread_index;
+}
+
+void trace_write_string(const char *str)
+{
+  fputc('"', trace.file);
+  for (const char *c = str; *c != '\0'; c++) {
+    if (ELEM(*c, '"', '\\')) {
+      fputc('\\', trace.file);
+      fputc(*c, trace.file);
+    }
+    else if ((uchar)*c < 0x20) {
+      fprintf(trace.file, "\\u%04x", (uint)*c);
+    }
+    else {
+      fputc(*c, trace.file);
+    }
+  }
+  fputc('"', trace.file);
+}
+
+/* Write a "complete" event, times are converted to microseconds since the start of the trace. */
+void trace_write_event(const TraceEvent &event, const char *depsgraph_name, const float frame)
+{
+  fputs(trace.num_written_events ? ",\n" : "\n", trace.file);
+  fputs("{\"name\":", trace.file);
+  trace_write_string(event.name.c_str());
+  fprintf(trace.file,
+          ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%d",
+          event.category,
+          (event.start_time - trace.start_time) * 1e6,
+          (event.end_time - event.start_time) * 1e6,
+          event.thread_index);
+  fputs(",\"args\":{\"depsgraph\":", trace.file);
+  trace_write_string(depsgraph_name);
+  fprintf(trace.file, ",\"frame\":%g}}", frame);
+  trace.num_written_events++;
+}
+
+}  // namespace
+
+bool deg_debug_trace_is_enabled()
+{
+  return trace.file != nullptr;
+}
+
+void deg_debug_trace_operation(const Depsgraph *UNUSED(graph),
+                               const OperationNode *operation_node,
+                               double start_time,
+                               double end_time)
+{
+  TraceEvent event;
+  event.name = operation_node->full_identifier();
+  event.category = nodeTypeAsString(operation_node->owner->type);
+  event.start_time = start_time;
+  event.end_time = end_time;
+  event.thread_index = trace_get_thread_index();
+
+  BLI_spin_lock(&trace.lock);
+  trace.events.append(std::move(event));
+  BLI_spin_unlock(&trace.lock);
+}
+
+void deg_debug_trace_graph_evaluation(const Depsgraph *graph, double start_time, double end_time)
+{
+  TraceEvent event;
+  event.name = "Depsgraph evaluation";
+  event.category = "depsgraph";
+  event.start_time = start_time;
+  event.end_time = end_time;
+  event.thread_index = trace_get_thread_index();
+
+  /* Graph evaluations may happen from different threads (e.g. viewport and render). */
+  BLI_spin_lock(&trace.lock);
+  const char *depsgraph_name = graph->debug.name.c_str();
+  trace_write_event(event, depsgraph_name, graph->ctime);
+  for (const TraceEvent &operation_event : trace.events) {
+    trace_write_event(operation_event, depsgraph_name, graph->ctime);
+  }
+  trace.events.clear();
+  BLI_spin_unlock(&trace.lock);
+}
+
+}  // namespace deg
+}  // namespace blender
+
+bool DEG_debug_trace_begin(const char *filepath)
+{
+  DEG_debug_trace_end();
+
+  FILE *file = BLI_fopen(filepath, "w");
+  if (file == nullptr) {
+    return false;
+  }
+  BLI_spin_init(&deg::trace.lock);
+  deg::trace.file = file;
+  deg::trace.start_time = PIL_check_seconds_timer();
+  deg::trace.num_written_events = 0;
+  fputs("[", file);
+  return true;
+}
+
+void DEG_debug_trace_end(void)
+{
+  if (deg::trace.file == nullptr) {
+    return;
+  }
+  fputs("\n]\n", deg::trace.file);
+  fclose(deg::trace.file);
+  deg::trace.file = nullptr;
+  deg::trace.events.clear_and_make_inline();
+  BLI_spin_end(&deg::trace.lock);
+}
+
+bool DEG_debug_trace_is_enabled(void)
+{
+  return deg::deg_debug_trace_is_enabled();
+}
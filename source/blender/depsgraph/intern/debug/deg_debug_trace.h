@@ -0,0 +1,50 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Tracing of dependency graph evaluation, see #DEG_debug_trace_begin().
+ */
+
+#pragma once
+
+namespace blender {
+namespace deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/* Check whether evaluation is to be traced. */
+bool deg_debug_trace_is_enabled();
+
+/* Record evaluation of a single operation. Can be called from any thread, times are as returned
+ * by PIL_check_seconds_timer(). */
+void deg_debug_trace_operation(const Depsgraph *graph,
+                               const OperationNode *operation_node,
+                               double start_time,
+                               double end_time);
+
+/* Record evaluation of the whole graph, writing all operations recorded since the previous
+ * graph evaluation to the trace file. */
+void deg_debug_trace_graph_evaluation(const Depsgraph *graph, double start_time, double end_time);
+
+}  // namespace deg
+}  // namespace blender
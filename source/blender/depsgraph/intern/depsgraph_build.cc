@@ -519,3 +519,16 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+void DEG_id_relations_tag_update(Main *bmain, ID *id)
+{
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    /* Graphs which are to be rebuilt anyway, or which don't depend on the ID, are not affected.
+     * Note that graphs which were never built are always tagged for update. */
+    if (depsgraph->need_update || depsgraph->find_id_node(id) == nullptr) {
+      continue;
+    }
+    DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
+  }
+}
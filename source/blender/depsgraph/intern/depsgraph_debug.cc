@@ -245,6 +245,24 @@ void DEG_stats_simple(const Depsgraph *graph,
   }
 }
 
+void DEG_stats_foreach_component_time(const Depsgraph *graph,
+                                      DEGStatsComponentTimeCallback callback,
+                                      void *user_data)
+{
+  const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(graph);
+  for (const deg::IDNode *id_node : deg_graph->id_nodes) {
+    for (const deg::ComponentNode *comp_node : id_node->components.values()) {
+      if (comp_node->stats.current_time == 0.0) {
+        continue;
+      }
+      callback(user_data,
+               id_node->id_orig->name,
+               comp_node->identifier().c_str(),
+               comp_node->stats.current_time);
+    }
+  }
+}
+
 static deg::string depsgraph_name_for_logging(struct Depsgraph *depsgraph)
 {
   const char *name = DEG_debug_name_get(depsgraph);
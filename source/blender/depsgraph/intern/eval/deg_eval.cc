@@ -29,6 +29,7 @@
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_gsqueue.h"
+#include "BLI_stack.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
 
@@ -43,6 +44,7 @@
 
 #include "atomic_ops.h"
 
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/depsgraph.h"
 #include "intern/depsgraph_relation.h"
 #include "intern/eval/deg_eval_copy_on_write.h"
@@ -74,6 +76,51 @@ void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), Tas
   BLI_task_pool_push(pool, deg_task_run_func, node, false, NULL);
 }
 
+/* Total measured time of the cheap operations a thread may keep for itself instead of pushing them
+ * to the pool. Pushing a task costs in the order of a microsecond, more than many operations do
+ * (parenting, bookend operations...). Bounded so that other work waits only briefly. */
+static const float INLINE_OPERATIONS_TIME_BUDGET = 1e-5f;
+
+/* Operations made ready by a thread, which it evaluates itself. */
+struct InlineOperations {
+  Vector<OperationNode *> nodes;
+  float total_time = 0.0f;
+};
+
+/* Schedule children of an evaluated operation: the most expensive child (the one on the critical
+ * path) is evaluated next by the current thread. Other children that were measured as cheap in
+ * previous evaluations are kept by the current thread as well, within a time budget. All other
+ * children are pushed to the pool where they can be picked up by other threads. */
+void schedule_node_to_pool_or_continue(OperationNode *node,
+                                       const int thread_id,
+                                       TaskPool *pool,
+                                       OperationNode **r_next_node,
+                                       InlineOperations *inline_operations)
+{
+  if (*r_next_node == nullptr) {
+    *r_next_node = node;
+    return;
+  }
+  if (node->critical_path_time > (*r_next_node)->critical_path_time) {
+    std::swap(node, *r_next_node);
+  }
+  /* Unmeasured operations are never considered cheap. */
+  if (node->eval_time > 0.0f &&
+      inline_operations->total_time + node->eval_time <= INLINE_OPERATIONS_TIME_BUDGET) {
+    inline_operations->nodes.append(node);
+    inline_operations->total_time += node->eval_time;
+    return;
+  }
+  schedule_node_to_pool(node, thread_id, pool);
+}
+
+void schedule_node_to_vector(OperationNode *node,
+                             const int /*thread_id*/,
+                             Vector<OperationNode *> *nodes)
+{
+  nodes->append(node);
+}
+
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
   /* Stage 1: Only  Copy-on-Write operations are to be evaluated, prior to anything else.
@@ -94,6 +141,7 @@ enum class EvaluationStage {
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  bool do_trace;
   EvaluationStage stage;
   bool need_single_thread_pass;
 };
@@ -105,13 +153,23 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   /* Sanity checks. */
   BLI_assert(!operation_node->is_noop() && "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const double end_time = PIL_check_seconds_timer();
+  const double eval_time = end_time - start_time;
   if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    operation_node->stats.current_time += eval_time;
+  }
+  if (state->do_trace) {
+    deg_debug_trace_operation(state->graph, operation_node, start_time, end_time);
+  }
+  /* Keep a running average, used to estimate the critical path of the next evaluation. An
+   * operation is only evaluated by a single thread at a time, so no synchronization is needed. */
+  if (operation_node->eval_time == 0.0f) {
+    operation_node->eval_time = (float)eval_time;
   }
   else {
-    operation_node->evaluate(depsgraph);
+    operation_node->eval_time = operation_node->eval_time * 0.75f + (float)eval_time * 0.25f;
   }
 }
 
@@ -120,12 +178,47 @@ void deg_task_run_func(TaskPool *pool, void *taskdata)
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
   OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  /* The most expensive operation made ready so far, evaluated once the cheap ones are done. */
+  OperationNode *pending_operation_node = nullptr;
+  InlineOperations inline_operations;
+  while (operation_node != nullptr) {
+    /* Evaluate node. */
+    evaluate_node(state, operation_node);
+
+    /* Schedule children, continuing with the most expensive one in this thread. */
+    OperationNode *next_operation_node = nullptr;
+    schedule_children(state,
+                      operation_node,
+                      schedule_node_to_pool_or_continue,
+                      pool,
+                      &next_operation_node,
+                      &inline_operations);
+
+    if (next_operation_node != nullptr) {
+      if (pending_operation_node == nullptr) {
+        pending_operation_node = next_operation_node;
+      }
+      else {
+        /* Only one operation waits for the cheap ones, the other one can run in another thread. */
+        if (next_operation_node->critical_path_time >
+            pending_operation_node->critical_path_time) {
+          std::swap(next_operation_node, pending_operation_node);
+        }
+        schedule_node_to_pool(next_operation_node, 0, pool);
+      }
+    }
 
-  /* Schedule children. */
-  schedule_children(state, operation_node, schedule_node_to_pool, pool);
+    /* Cheap operations first, they don't hold back the pending one for long. */
+    if (!inline_operations.nodes.is_empty()) {
+      operation_node = inline_operations.nodes.pop_last();
+      inline_operations.total_time -= operation_node->eval_time;
+    }
+    else {
+      operation_node = pending_operation_node;
+      pending_operation_node = nullptr;
+    }
+  }
 }
 
 bool check_operation_node_visible(OperationNode *op_node)
@@ -178,9 +271,61 @@ void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
+bool need_update_operation(OperationNode *node)
+{
+  return check_operation_node_visible(node) && (node->flag & DEPSOP_FLAG_NEEDS_UPDATE);
+}
+
+/* Calculate critical path time of all operations which are to be evaluated, based on timing of
+ * previous evaluations. Operations are visited from the graph leafs back to their parents, the
+ * number of pending children is counted using num_links_pending, which is re-initialized by
+ * calculate_pending_parents() afterwards. */
+void calculate_critical_path(Depsgraph *graph)
+{
+  BLI_Stack *stack = BLI_stack_new(sizeof(OperationNode *), "DEG critical path stack");
+  for (OperationNode *node : graph->operations) {
+    node->num_links_pending = 0;
+    node->critical_path_time = 0.0f;
+    if (!need_update_operation(node)) {
+      continue;
+    }
+    for (Relation *rel : node->outlinks) {
+      OperationNode *to = (OperationNode *)rel->to;
+      if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 && need_update_operation(to)) {
+        ++node->num_links_pending;
+      }
+    }
+    if (node->num_links_pending == 0) {
+      BLI_stack_push(stack, &node);
+    }
+  }
+  while (!BLI_stack_is_empty(stack)) {
+    OperationNode *node;
+    BLI_stack_pop(stack, &node);
+    /* All children are handled, add own time to the longest of their paths. */
+    node->critical_path_time += node->eval_time;
+    for (Relation *rel : node->inlinks) {
+      if (rel->from->type != NodeType::OPERATION || (rel->flag & RELATION_FLAG_CYCLIC) != 0) {
+        continue;
+      }
+      OperationNode *from = (OperationNode *)rel->from;
+      if (!need_update_operation(from)) {
+        continue;
+      }
+      from->critical_path_time = max(from->critical_path_time, node->critical_path_time);
+      BLI_assert(from->num_links_pending > 0);
+      if (--from->num_links_pending == 0) {
+        BLI_stack_push(stack, &from);
+      }
+    }
+  }
+  BLI_stack_free(stack);
+}
+
 void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
 {
   const bool do_stats = state->do_stats;
+  calculate_critical_path(graph);
   calculate_pending_parents(graph);
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
@@ -354,7 +499,11 @@ static TaskPool *deg_evaluate_task_pool_create(DepsgraphEvalState *state)
     return BLI_task_pool_create_no_threads(state);
   }
   else {
-    return BLI_task_pool_create_suspended(state, TASK_PRIORITY_HIGH);
+    /* The active depsgraph is what the user is looking at, let it take threads before any
+     * background work. */
+    const TaskPriority priority = state->graph->is_active ? TASK_PRIORITY_INTERACTIVE :
+                                                            TASK_PRIORITY_HIGH;
+    return BLI_task_pool_create_suspended(state, priority);
   }
 }
 
@@ -373,6 +522,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   }
 
   graph->debug.begin_graph_evaluation();
+  const bool do_trace = deg_debug_trace_is_enabled();
+  const double start_time = do_trace ? PIL_check_seconds_timer() : 0.0;
 
   graph->is_evaluating = true;
   depsgraph_ensure_view_layer(graph);
@@ -380,6 +531,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = do_trace;
   state.need_single_thread_pass = false;
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -392,10 +544,20 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   BLI_task_pool_work_and_wait(task_pool);
   BLI_task_pool_free(task_pool);
 
-  /* After that, process all other nodes. */
+  /* After that, process all other nodes. Operations with the longest path of dependent
+   * operations are started first, so that the last finishing chain doesn't start late. */
   state.stage = EvaluationStage::THREADED_EVALUATION;
   task_pool = deg_evaluate_task_pool_create(&state);
-  schedule_graph(&state, schedule_node_to_pool, task_pool);
+  Vector<OperationNode *> root_nodes;
+  schedule_graph(&state, schedule_node_to_vector, &root_nodes);
+  std::stable_sort(root_nodes.begin(),
+                   root_nodes.end(),
+                   [](const OperationNode *a, const OperationNode *b) {
+                     return a->critical_path_time > b->critical_path_time;
+                   });
+  for (OperationNode *node : root_nodes) {
+    schedule_node_to_pool(node, 0, task_pool);
+  }
   BLI_task_pool_work_and_wait(task_pool);
   BLI_task_pool_free(task_pool);
 
@@ -414,6 +576,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   deg_graph_clear_tags(graph);
   graph->is_evaluating = false;
 
+  if (do_trace) {
+    deg_debug_trace_graph_evaluation(graph, start_time, PIL_check_seconds_timer());
+  }
   graph->debug.end_graph_evaluation();
 }
 
@@ -266,6 +266,13 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Evaluation time of this operation in seconds, averaged over the previous evaluations. */
+  float eval_time;
+  /* Estimated time needed to evaluate the longest chain of operations which starts at this
+   * operation (including the operation itself). Operations on the critical path of the graph
+   * have the biggest value and are scheduled first. */
+  float critical_path_time;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
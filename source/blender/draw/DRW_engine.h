@@ -168,6 +168,10 @@ void DRW_gpu_render_context_disable(void *re_gpu_context);
 
 void DRW_deferred_shader_remove(struct GPUMaterial *mat);
 
+/* draw_manager_profiling.c */
+int DRW_stats_timings_len(void);
+void DRW_stats_timing_get(int index, const char **r_name, int *r_level, double *r_time_ms);
+
 struct DrawDataList *DRW_drawdatalist_from_id(struct ID *id);
 void DRW_drawdata_free(struct ID *id);
 
@@ -180,11 +180,15 @@ void EEVEE_view_layer_data_free(void *storage)
   DRW_UBO_FREE_SAFE(sldata->light_ubo);
   DRW_UBO_FREE_SAFE(sldata->shadow_ubo);
   GPU_FRAMEBUFFER_FREE_SAFE(sldata->shadow_fb);
+  GPU_FRAMEBUFFER_FREE_SAFE(sldata->shadow_static_fb);
   DRW_TEXTURE_FREE_SAFE(sldata->shadow_cube_pool);
+  DRW_TEXTURE_FREE_SAFE(sldata->shadow_cube_static_pool);
   DRW_TEXTURE_FREE_SAFE(sldata->shadow_cascade_pool);
   for (int i = 0; i < 2; i++) {
     MEM_SAFE_FREE(sldata->shcasters_buffers[i].bbox);
     MEM_SAFE_FREE(sldata->shcasters_buffers[i].update);
+    MEM_SAFE_FREE(sldata->shcasters_buffers[i].is_static);
+    MEM_SAFE_FREE(sldata->shcasters_buffers[i].static_update);
   }
 
   if (sldata->fallback_lightcache) {
@@ -250,6 +254,8 @@ static void eevee_object_data_init(DrawData *dd)
   eevee_data->shadow_caster_id = -1;
   eevee_data->need_update = false;
   eevee_data->geom_update = false;
+  eevee_data->shadow_is_static = false;
+  eevee_data->shadow_static_delay = 0;
 }
 
 EEVEE_ObjectEngineData *EEVEE_object_data_get(Object *ob)
@@ -26,6 +26,7 @@
 
 #include "BKE_global.h"
 
+#include "BLI_hash_mm2a.h"
 #include "BLI_threads.h"
 
 #include "DEG_depsgraph_build.h"
@@ -148,6 +149,8 @@ typedef struct EEVEE_LightBake {
   int cube_offset;
   /** Pointer to the owner_id of the probe object. */
   LightProbe **cube_prb;
+  /** Key of the settings each cube is baked with, see #eevee_lightbake_cube_key. */
+  uint *cube_keys;
 
   /* Dummy Textures */
   struct GPUTexture *dummy_color, *dummy_depth;
@@ -470,6 +473,7 @@ void EEVEE_lightcache_free(LightCache *lcache)
 
   MEM_SAFE_FREE(lcache->cube_data);
   MEM_SAFE_FREE(lcache->grid_data);
+  MEM_SAFE_FREE(lcache->cube_keys);
   MEM_freeN(lcache);
 }
 
@@ -713,6 +717,7 @@ void EEVEE_lightbake_job_data_free(void *custom_data)
 
   MEM_SAFE_FREE(lbake->cube_prb);
   MEM_SAFE_FREE(lbake->grid_prb);
+  MEM_SAFE_FREE(lbake->cube_keys);
 
   BLI_mutex_free(lbake->mutex);
 
@@ -854,6 +859,7 @@ static void eevee_lightbake_cache_create(EEVEE_Data *vedata, EEVEE_LightBake *lb
 
   DRW_render_instance_buffer_finish();
   DRW_hair_update();
+  DRW_mesh_deform_update();
 }
 
 static void eevee_lightbake_copy_irradiance(EEVEE_LightBake *lbake, LightCache *lcache)
@@ -1106,10 +1112,11 @@ static void eevee_lightbake_render_probe_sample(void *ved, void *user_data)
                                 clamp);
 
   lcache->cube_len += 1;
+  lcache->cube_keys[lbake->cube_offset] = lbake->cube_keys[lbake->cube_offset];
 
   /* If it's the last probe. */
   if (lbake->cube_offset == lbake->cube_len - 1) {
-    lcache->flag &= ~LIGHTCACHE_UPDATE_CUBE;
+    lcache->flag &= ~(LIGHTCACHE_UPDATE_CUBE | LIGHTCACHE_UPDATE_CUBE_CHANGED);
   }
 }
 
@@ -1137,6 +1144,31 @@ static bool eevee_lightbake_cube_comp(EEVEE_LightProbe *prb_a, EEVEE_LightProbe
   return (vol_a < vol_b);
 }
 
+/* Hash of the settings the cube-map of a reflection probe is baked with, apart from the scene
+ * content itself. Never zero, which is used for cube-maps which are not baked. */
+static uint eevee_lightbake_cube_key(const Scene *scene_eval,
+                                     const LightProbe *prb,
+                                     const EEVEE_LightProbe *eprobe)
+{
+  const float settings[5] = {
+      prb->clipsta,
+      prb->clipend,
+      prb->intensity,
+      scene_eval->eevee.gi_glossy_clamp,
+      scene_eval->eevee.gi_filter_quality,
+  };
+  const int invert_group = (prb->flag & LIGHTPROBE_FLAG_INVERT_GROUP);
+
+  uint key = BLI_hash_mm2((const uchar *)eprobe, sizeof(*eprobe), 0);
+  key = BLI_hash_mm2((const uchar *)settings, sizeof(settings), key);
+  key = BLI_hash_mm2((const uchar *)&invert_group, sizeof(invert_group), key);
+  if (prb->visibility_grp != NULL) {
+    const char *name = prb->visibility_grp->id.name;
+    key = BLI_hash_mm2((const uchar *)name, strlen(name), key);
+  }
+  return (key != 0) ? key : 1;
+}
+
 #define SORT_PROBE(elems_type, prbs, elems, elems_len, comp_fn) \
   { \
     bool sorted = false; \
@@ -1200,6 +1232,15 @@ static void eevee_lightbake_gather_probes(EEVEE_LightBake *lbake)
              lbake->cube_len - 1,
              eevee_lightbake_cube_comp);
 
+  lbake->cube_keys = MEM_callocN(sizeof(uint) * lbake->cube_len, "EEVEE Cube keys");
+  for (int i = 1; i < lbake->cube_len; i++) {
+    lbake->cube_keys[i] = eevee_lightbake_cube_key(
+        scene_eval, lbake->cube_prb[i], &lcache->cube_data[i]);
+  }
+  if (lcache->cube_keys == NULL) {
+    lcache->cube_keys = MEM_callocN(sizeof(uint) * lbake->cube_len, "EEVEE Cube keys");
+  }
+
   lbake->total = lbake->total_irr_samples * lbake->bounce_len + lbake->cube_len;
   lbake->done = 0;
 }
@@ -1277,6 +1318,12 @@ void EEVEE_lightbake_job(void *custom_data, short *stop, short *do_update, float
 
   LightCache *lcache = lbake->lcache;
 
+  /* Probes which did not change can only keep their cube-map when nothing else they depend on
+   * is re-baked. */
+  const bool only_changed_cubes = (lcache->flag & (LIGHTCACHE_UPDATE_CUBE |
+                                                   LIGHTCACHE_UPDATE_GRID |
+                                                   LIGHTCACHE_UPDATE_WORLD)) == 0;
+
   /* HACK: Sleep to delay the first rendering operation
    * that causes a small freeze (caused by VBO generation)
    * because this step is locking at this moment. */
@@ -1311,12 +1358,22 @@ void EEVEE_lightbake_job(void *custom_data, short *stop, short *do_update, float
   }
 
   /* Render reflections */
-  if (lcache->flag & LIGHTCACHE_UPDATE_CUBE) {
+  if (lcache->flag & (LIGHTCACHE_UPDATE_CUBE | LIGHTCACHE_UPDATE_CUBE_CHANGED)) {
     /* Bypass world, start at 1. */
     lbake->probe = lbake->cube_prb + 1;
     lbake->cube = lcache->cube_data + 1;
     for (lbake->cube_offset = 1; lbake->cube_offset < lbake->cube_len;
          lbake->cube_offset++, lbake->probe++, lbake->cube++) {
+      const int i = lbake->cube_offset;
+      if (only_changed_cubes && lcache->cube_keys[i] == lbake->cube_keys[i]) {
+        /* The probe did not change since it was baked, keep its cube-map. */
+        lcache->cube_len += 1;
+        lbake->done += 1;
+        if (i == lbake->cube_len - 1) {
+          lcache->flag &= ~LIGHTCACHE_UPDATE_CUBE_CHANGED;
+        }
+        continue;
+      }
       lightbake_do_sample(lbake, eevee_lightbake_render_probe_sample);
     }
   }
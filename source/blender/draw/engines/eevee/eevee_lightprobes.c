@@ -169,6 +169,8 @@ void EEVEE_lightprobes_init(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
 
   memset(stl->g_data->bake_views, 0, sizeof(stl->g_data->bake_views));
   memset(stl->g_data->cube_views, 0, sizeof(stl->g_data->cube_views));
+  memset(stl->g_data->cube_static_views, 0, sizeof(stl->g_data->cube_static_views));
+  memset(stl->g_data->cube_dynamic_views, 0, sizeof(stl->g_data->cube_dynamic_views));
   memset(stl->g_data->world_views, 0, sizeof(stl->g_data->world_views));
   memset(stl->g_data->planar_views, 0, sizeof(stl->g_data->planar_views));
 
@@ -744,11 +746,14 @@ void EEVEE_lightprobes_cache_finish(EEVEE_ViewLayerData *sldata, EEVEE_Data *ved
       Scene *scene_orig = DEG_get_input_scene(draw_ctx->depsgraph);
       if (scene_orig->eevee.light_cache_data != NULL) {
         if (pinfo->do_grid_update) {
-          scene_orig->eevee.light_cache_data->flag |= LIGHTCACHE_UPDATE_GRID;
+          /* If we update grid we need to update all the cube-maps too. */
+          scene_orig->eevee.light_cache_data->flag |= LIGHTCACHE_UPDATE_GRID |
+                                                      LIGHTCACHE_UPDATE_CUBE;
+        }
+        else {
+          /* Only the cube-maps of the probes which changed need to be re-baked. */
+          scene_orig->eevee.light_cache_data->flag |= LIGHTCACHE_UPDATE_CUBE_CHANGED;
         }
-        /* If we update grid we need to update the cube-maps too.
-         * So always refresh cube-maps. */
-        scene_orig->eevee.light_cache_data->flag |= LIGHTCACHE_UPDATE_CUBE;
         /* Tag the lightcache to auto update. */
         scene_orig->eevee.light_cache_data->flag |= LIGHTCACHE_UPDATE_AUTO;
         /* Use a notifier to trigger the operator after drawing. */
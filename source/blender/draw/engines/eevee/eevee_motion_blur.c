@@ -415,6 +415,7 @@ void EEVEE_motion_blur_cache_finish(EEVEE_Data *vedata)
     /* Also we weed to have a correct fbo bound for DRW_hair_update */
     GPU_framebuffer_bind(vedata->fbl->main_fb);
     DRW_hair_update();
+    DRW_mesh_deform_update();
 
     DRW_cache_restart();
   }
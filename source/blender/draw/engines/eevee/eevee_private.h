@@ -476,6 +476,10 @@ BLI_STATIC_ASSERT(sizeof(EEVEE_Shadow) * MAX_SHADOW +
 typedef struct EEVEE_ShadowCasterBuffer {
   struct EEVEE_BoundBox *bbox;
   BLI_bitmap *update;
+  /* Casters that did not change for a few redraws and are kept in the static shadow maps. */
+  BLI_bitmap *is_static;
+  /* Casters that need the static shadow maps around them to be re-rendered. */
+  BLI_bitmap *static_update;
   uint alloc_count;
   uint count;
 } EEVEE_ShadowCasterBuffer;
@@ -487,7 +491,7 @@ typedef struct EEVEE_LightsInfo {
   int num_cascade_layer, cache_num_cascade_layer;
   int cube_len, cascade_len, shadow_len;
   int shadow_cube_size, shadow_cascade_size;
-  bool shadow_high_bitdepth, soft_shadows;
+  bool shadow_high_bitdepth, soft_shadows, shadow_static_cache;
   /* UBO Storage : data used by UBO */
   struct EEVEE_Light light_data[MAX_LIGHT];
   struct EEVEE_Shadow shadow_data[MAX_SHADOW];
@@ -500,6 +504,8 @@ typedef struct EEVEE_LightsInfo {
   uchar shadow_cascade_light_indices[MAX_SHADOW_CASCADE];
   /* Update bitmap. */
   BLI_bitmap sh_cube_update[BLI_BITMAP_SIZE(MAX_SHADOW_CUBE)];
+  /* Subset of sh_cube_update that also needs the static casters to be re-rendered. */
+  BLI_bitmap sh_cube_static_update[BLI_BITMAP_SIZE(MAX_SHADOW_CUBE)];
   /* Lights tracking */
   struct BoundSphere shadow_bounds[MAX_LIGHT]; /* Tightly packed light bounds  */
   /* List of bbox and update bitmap. Double buffered. */
@@ -816,8 +822,11 @@ typedef struct EEVEE_ViewLayerData {
   struct GPUUniformBuffer *shadow_samples_ubo;
 
   struct GPUFrameBuffer *shadow_fb;
+  struct GPUFrameBuffer *shadow_static_fb;
 
   struct GPUTexture *shadow_cube_pool;
+  /* Same layout as shadow_cube_pool, only contains the static shadow casters. */
+  struct GPUTexture *shadow_cube_static_pool;
   struct GPUTexture *shadow_cascade_pool;
 
   struct EEVEE_ShadowCasterBuffer shcasters_buffers[2];
@@ -876,6 +885,10 @@ typedef struct EEVEE_ObjectEngineData {
   bool need_update;
   bool geom_update;
   uint shadow_caster_id;
+  /* Static shadow caster classification. The object is considered static after
+   * it has not been updated for SH_CASTER_STATIC_DELAY redraws. */
+  bool shadow_is_static;
+  uchar shadow_static_delay;
 } EEVEE_ObjectEngineData;
 
 typedef struct EEVEE_WorldEngineData {
@@ -944,6 +957,9 @@ typedef struct EEVEE_PrivateData {
   struct GPUUniformBuffer *renderpass_ubo;
   /** For rendering shadows. */
   struct DRWView *cube_views[6];
+  /** Same as cube_views but only draw static or dynamic shadow casters. */
+  struct DRWView *cube_static_views[6];
+  struct DRWView *cube_dynamic_views[6];
   /** For rendering probes. */
   struct DRWView *bake_views[6];
   /** Same as bake_views but does not generate culling infos. */
@@ -33,6 +33,8 @@
 #include "eevee_private.h"
 
 #define SH_CASTER_ALLOC_CHUNK 32
+/* Number of redraws without update before a shadow caster is moved to the static shadow maps. */
+#define SH_CASTER_STATIC_DELAY 8
 
 static struct {
   struct GPUShader *shadow_sh;
@@ -78,6 +80,9 @@ void EEVEE_shadows_init(EEVEE_ViewLayerData *sldata)
       sldata->shcasters_buffers[i].bbox = MEM_callocN(
           sizeof(EEVEE_BoundBox) * SH_CASTER_ALLOC_CHUNK, __func__);
       sldata->shcasters_buffers[i].update = BLI_BITMAP_NEW(SH_CASTER_ALLOC_CHUNK, __func__);
+      sldata->shcasters_buffers[i].is_static = BLI_BITMAP_NEW(SH_CASTER_ALLOC_CHUNK, __func__);
+      sldata->shcasters_buffers[i].static_update = BLI_BITMAP_NEW(SH_CASTER_ALLOC_CHUNK,
+                                                                  __func__);
       sldata->shcasters_buffers[i].alloc_count = SH_CASTER_ALLOC_CHUNK;
       sldata->shcasters_buffers[i].count = 0;
     }
@@ -94,12 +99,15 @@ void EEVEE_shadows_init(EEVEE_ViewLayerData *sldata)
   int sh_cascade_size = scene_eval->eevee.shadow_cascade_size;
   const bool sh_high_bitdepth = (scene_eval->eevee.flag & SCE_EEVEE_SHADOW_HIGH_BITDEPTH) != 0;
   sldata->lights->soft_shadows = (scene_eval->eevee.flag & SCE_EEVEE_SHADOW_SOFT) != 0;
+  sldata->lights->shadow_static_cache = (scene_eval->eevee.flag &
+                                         SCE_EEVEE_SHADOW_STATIC_CACHE) != 0;
 
   EEVEE_LightsInfo *linfo = sldata->lights;
   if ((linfo->shadow_cube_size != sh_cube_size) ||
       (linfo->shadow_high_bitdepth != sh_high_bitdepth)) {
     BLI_assert((sh_cube_size > 0) && (sh_cube_size <= 4096));
     DRW_TEXTURE_FREE_SAFE(sldata->shadow_cube_pool);
+    DRW_TEXTURE_FREE_SAFE(sldata->shadow_cube_static_pool);
     CLAMP(sh_cube_size, 1, 4096);
   }
 
@@ -131,8 +139,10 @@ void EEVEE_shadows_cache_init(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
 
   /* Shadow Casters: Reset flags. */
   BLI_bitmap_set_all(backbuffer->update, true, backbuffer->alloc_count);
+  BLI_bitmap_set_all(backbuffer->static_update, true, backbuffer->alloc_count);
   /* Is this one needed? */
   BLI_bitmap_set_all(frontbuffer->update, false, frontbuffer->alloc_count);
+  BLI_bitmap_set_all(frontbuffer->static_update, false, frontbuffer->alloc_count);
 
   INIT_MINMAX(linfo->shcaster_aabb.min, linfo->shcaster_aabb.max);
 
@@ -151,6 +161,8 @@ void EEVEE_shadows_caster_register(EEVEE_ViewLayerData *sldata, Object *ob)
   EEVEE_ShadowCasterBuffer *backbuffer = linfo->shcaster_backbuffer;
   EEVEE_ShadowCasterBuffer *frontbuffer = linfo->shcaster_frontbuffer;
   bool update = true;
+  bool is_static = false;
+  bool static_update = false;
   int id = frontbuffer->count;
 
   /* Make sure shadow_casters is big enough. */
@@ -159,6 +171,8 @@ void EEVEE_shadows_caster_register(EEVEE_ViewLayerData *sldata, Object *ob)
     frontbuffer->bbox = MEM_reallocN(frontbuffer->bbox,
                                      sizeof(EEVEE_BoundBox) * frontbuffer->alloc_count);
     BLI_BITMAP_RESIZE(frontbuffer->update, frontbuffer->alloc_count);
+    BLI_BITMAP_RESIZE(frontbuffer->is_static, frontbuffer->alloc_count);
+    BLI_BITMAP_RESIZE(frontbuffer->static_update, frontbuffer->alloc_count);
   }
 
   if (ob->base_flag & BASE_FROM_DUPLI) {
@@ -170,17 +184,36 @@ void EEVEE_shadows_caster_register(EEVEE_ViewLayerData *sldata, Object *ob)
     EEVEE_ObjectEngineData *oedata = EEVEE_object_data_ensure(ob);
     int past_id = oedata->shadow_caster_id;
     oedata->shadow_caster_id = id;
+    update = oedata->need_update;
+    oedata->need_update = false;
+
+    /* Any update makes the caster dynamic until it stays still for a few redraws. */
+    if (update) {
+      oedata->shadow_static_delay = SH_CASTER_STATIC_DELAY;
+    }
+    else if (oedata->shadow_static_delay > 0) {
+      oedata->shadow_static_delay--;
+    }
+    const bool was_static = oedata->shadow_is_static;
+    is_static = (oedata->shadow_static_delay == 0);
+    oedata->shadow_is_static = is_static;
+    /* The static shadow maps need to be re-rendered where the caster enters or leaves them. */
+    static_update = (is_static != was_static);
+
     /* Update flags in backbuffer. */
     if (past_id > -1 && past_id < backbuffer->count) {
-      BLI_BITMAP_SET(backbuffer->update, past_id, oedata->need_update);
+      BLI_BITMAP_SET(backbuffer->update, past_id, update);
+      BLI_BITMAP_SET(backbuffer->static_update, past_id, update || static_update);
     }
-    update = oedata->need_update;
-    oedata->need_update = false;
   }
 
   if (update) {
     BLI_BITMAP_ENABLE(frontbuffer->update, id);
   }
+  BLI_BITMAP_SET(frontbuffer->is_static, id, is_static);
+  if (static_update) {
+    BLI_BITMAP_ENABLE(frontbuffer->static_update, id);
+  }
 
   /* Update World AABB in frontbuffer. */
   BoundBox *bb = BKE_object_boundbox_get(ob);
@@ -234,11 +267,16 @@ void EEVEE_shadows_update(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
   /* Free textures if number mismatch. */
   if (linfo->num_cube_layer != linfo->cache_num_cube_layer) {
     DRW_TEXTURE_FREE_SAFE(sldata->shadow_cube_pool);
+    DRW_TEXTURE_FREE_SAFE(sldata->shadow_cube_static_pool);
     linfo->cache_num_cube_layer = linfo->num_cube_layer;
     /* Update all lights. */
     BLI_bitmap_set_all(&linfo->sh_cube_update[0], true, MAX_LIGHT);
   }
 
+  if (!linfo->shadow_static_cache) {
+    DRW_TEXTURE_FREE_SAFE(sldata->shadow_cube_static_pool);
+  }
+
   if (linfo->num_cascade_layer != linfo->cache_num_cascade_layer) {
     DRW_TEXTURE_FREE_SAFE(sldata->shadow_cascade_pool);
     linfo->cache_num_cascade_layer = linfo->num_cascade_layer;
@@ -253,6 +291,20 @@ void EEVEE_shadows_update(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
                                                            NULL);
   }
 
+  if (linfo->shadow_static_cache && !sldata->shadow_cube_static_pool) {
+    /* Only used as a source for blitting, no need for filtering or comparison. */
+    sldata->shadow_cube_static_pool = DRW_texture_create_2d_array(
+        linfo->shadow_cube_size,
+        linfo->shadow_cube_size,
+        max_ii(1, linfo->num_cube_layer * 6),
+        shadow_pool_format,
+        0,
+        NULL);
+    /* Static casters of all lights have to be rendered again. */
+    BLI_bitmap_set_all(&linfo->sh_cube_update[0], true, MAX_SHADOW_CUBE);
+    BLI_bitmap_set_all(&linfo->sh_cube_static_update[0], true, MAX_SHADOW_CUBE);
+  }
+
   if (!sldata->shadow_cascade_pool) {
     sldata->shadow_cascade_pool = DRW_texture_create_2d_array(linfo->shadow_cascade_size,
                                                               linfo->shadow_cascade_size,
@@ -266,12 +318,17 @@ void EEVEE_shadows_update(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
     sldata->shadow_fb = GPU_framebuffer_create();
   }
 
+  if (sldata->shadow_static_fb == NULL) {
+    sldata->shadow_static_fb = GPU_framebuffer_create();
+  }
+
   /* Gather all light own update bits. to avoid costly intersection check.  */
   for (int j = 0; j < linfo->cube_len; j++) {
     const EEVEE_Light *evli = linfo->light_data + linfo->shadow_cube_light_indices[j];
     /* Setup shadow cube in UBO and tag for update if necessary. */
     if (EEVEE_shadows_cube_setup(linfo, evli, effects->taa_current_sample - 1)) {
       BLI_BITMAP_ENABLE(&linfo->sh_cube_update[0], j);
+      BLI_BITMAP_ENABLE(&linfo->sh_cube_static_update[0], j);
     }
   }
 
@@ -282,10 +339,17 @@ void EEVEE_shadows_update(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
   for (int i = 0; i < backbuffer->count; i++) {
     /* If the shadowcaster has been deleted or updated. */
     if (BLI_BITMAP_TEST(backbuffer->update, i)) {
+      /* A static caster is baked in the static shadow maps at its previous position. */
+      const bool static_update = BLI_BITMAP_TEST(backbuffer->is_static, i) &&
+                                 BLI_BITMAP_TEST(backbuffer->static_update, i);
       for (int j = 0; j < linfo->cube_len; j++) {
-        if (!BLI_BITMAP_TEST(&linfo->sh_cube_update[0], j)) {
+        if (!BLI_BITMAP_TEST(&linfo->sh_cube_update[0], j) ||
+            (static_update && !BLI_BITMAP_TEST(&linfo->sh_cube_static_update[0], j))) {
           if (sphere_bbox_intersect(&bsphere[j], &bbox[i])) {
             BLI_BITMAP_ENABLE(&linfo->sh_cube_update[0], j);
+            if (static_update) {
+              BLI_BITMAP_ENABLE(&linfo->sh_cube_static_update[0], j);
+            }
           }
         }
       }
@@ -294,12 +358,17 @@ void EEVEE_shadows_update(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
   /* Search for updates in current shadow casters. */
   bbox = frontbuffer->bbox;
   for (int i = 0; i < frontbuffer->count; i++) {
-    /* If the shadowcaster has been updated. */
-    if (BLI_BITMAP_TEST(frontbuffer->update, i)) {
+    /* If the shadowcaster has been updated or has changed from dynamic to static. */
+    const bool static_update = BLI_BITMAP_TEST(frontbuffer->static_update, i);
+    if (BLI_BITMAP_TEST(frontbuffer->update, i) || static_update) {
       for (int j = 0; j < linfo->cube_len; j++) {
-        if (!BLI_BITMAP_TEST(&linfo->sh_cube_update[0], j)) {
+        if (!BLI_BITMAP_TEST(&linfo->sh_cube_update[0], j) ||
+            (static_update && !BLI_BITMAP_TEST(&linfo->sh_cube_static_update[0], j))) {
           if (sphere_bbox_intersect(&bsphere[j], &bbox[i])) {
             BLI_BITMAP_ENABLE(&linfo->sh_cube_update[0], j);
+            if (static_update) {
+              BLI_BITMAP_ENABLE(&linfo->sh_cube_static_update[0], j);
+            }
           }
         }
       }
@@ -316,6 +385,8 @@ void EEVEE_shadows_update(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata)
     frontbuffer->bbox = MEM_reallocN(frontbuffer->bbox,
                                      sizeof(EEVEE_BoundBox) * frontbuffer->alloc_count);
     BLI_BITMAP_RESIZE(frontbuffer->update, frontbuffer->alloc_count);
+    BLI_BITMAP_RESIZE(frontbuffer->is_static, frontbuffer->alloc_count);
+    BLI_BITMAP_RESIZE(frontbuffer->static_update, frontbuffer->alloc_count);
   }
 }
 
@@ -44,6 +44,7 @@ void EEVEE_shadows_cube_add(EEVEE_LightsInfo *linfo, EEVEE_Light *evli, Object *
 
   if (update) {
     BLI_BITMAP_ENABLE(&linfo->sh_cube_update[0], linfo->cube_len);
+    BLI_BITMAP_ENABLE(&linfo->sh_cube_static_update[0], linfo->cube_len);
   }
 
   sh_data->near = max_ff(la->clipsta, 1e-8f);
@@ -136,8 +137,25 @@ bool EEVEE_shadows_cube_setup(EEVEE_LightsInfo *linfo, const EEVEE_Light *evli,
   return update;
 }
 
-static void eevee_ensure_cube_views(
-    float near, float far, int cube_res, const float viewmat[4][4], DRWView *view[6])
+static bool eevee_shadows_static_caster_visibility_cb(bool vis_in, void *user_data)
+{
+  EEVEE_ObjectEngineData *oedata = (EEVEE_ObjectEngineData *)user_data;
+  /* Duplis and casters without engine data are always drawn as dynamic. */
+  return vis_in && (oedata != NULL) && oedata->shadow_is_static;
+}
+
+static bool eevee_shadows_dynamic_caster_visibility_cb(bool vis_in, void *user_data)
+{
+  EEVEE_ObjectEngineData *oedata = (EEVEE_ObjectEngineData *)user_data;
+  return vis_in && ((oedata == NULL) || !oedata->shadow_is_static);
+}
+
+static void eevee_ensure_cube_views(float near,
+                                    float far,
+                                    int cube_res,
+                                    const float viewmat[4][4],
+                                    DRWCallVisibilityFn *visibility_fn,
+                                    DRWView *view[6])
 {
   float winmat[4][4];
   float side = near;
@@ -157,7 +175,7 @@ static void eevee_ensure_cube_views(
     mul_m4_m4m4(tmp, cubefacemat[i], viewmat);
 
     if (view[i] == NULL) {
-      view[i] = DRW_view_create(tmp, winmat, NULL, NULL, NULL);
+      view[i] = DRW_view_create(tmp, winmat, NULL, NULL, visibility_fn);
     }
     else {
       DRW_view_update(view[i], tmp, winmat, NULL, NULL);
@@ -189,11 +207,34 @@ void EEVEE_shadows_draw_cubemap(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata,
   EEVEE_Shadow *shdw_data = linfo->shadow_data + (int)evli->shadow_id;
   EEVEE_ShadowCube *cube_data = linfo->shadow_cube_data + (int)shdw_data->type_data_id;
 
-  eevee_ensure_cube_views(shdw_data->near,
-                          shdw_data->far,
-                          linfo->shadow_cube_size,
-                          cube_data->shadowmat,
-                          g_data->cube_views);
+  /* With the static cache, only the dynamic casters are drawn on top of a copy of the static
+   * shadow map. The static casters are only drawn when something changed around them. */
+  const bool use_static_cache = linfo->shadow_static_cache &&
+                                (sldata->shadow_cube_static_pool != NULL);
+  const bool static_update = BLI_BITMAP_TEST(&linfo->sh_cube_static_update[0], cube_index);
+
+  if (use_static_cache) {
+    eevee_ensure_cube_views(shdw_data->near,
+                            shdw_data->far,
+                            linfo->shadow_cube_size,
+                            cube_data->shadowmat,
+                            eevee_shadows_static_caster_visibility_cb,
+                            g_data->cube_static_views);
+    eevee_ensure_cube_views(shdw_data->near,
+                            shdw_data->far,
+                            linfo->shadow_cube_size,
+                            cube_data->shadowmat,
+                            eevee_shadows_dynamic_caster_visibility_cb,
+                            g_data->cube_dynamic_views);
+  }
+  else {
+    eevee_ensure_cube_views(shdw_data->near,
+                            shdw_data->far,
+                            linfo->shadow_cube_size,
+                            cube_data->shadowmat,
+                            NULL,
+                            g_data->cube_views);
+  }
 
   /* Render shadow cube */
   /* Render 6 faces separately: seems to be faster for the general case.
@@ -213,13 +254,36 @@ void EEVEE_shadows_draw_cubemap(EEVEE_ViewLayerData *sldata, EEVEE_Data *vedata,
     // if (frustum_intersect(g_data->cube_views[j], main_view))
     //   continue;
 
-    DRW_view_set_active(g_data->cube_views[j]);
     int layer = cube_index * 6 + j;
-    GPU_framebuffer_texture_layer_attach(sldata->shadow_fb, sldata->shadow_cube_pool, 0, layer, 0);
-    GPU_framebuffer_bind(sldata->shadow_fb);
-    GPU_framebuffer_clear_depth(sldata->shadow_fb, 1.0f);
-    DRW_draw_pass(psl->shadow_pass);
+
+    if (use_static_cache) {
+      GPU_framebuffer_texture_layer_attach(
+          sldata->shadow_static_fb, sldata->shadow_cube_static_pool, 0, layer, 0);
+      if (static_update) {
+        DRW_view_set_active(g_data->cube_static_views[j]);
+        GPU_framebuffer_bind(sldata->shadow_static_fb);
+        GPU_framebuffer_clear_depth(sldata->shadow_static_fb, 1.0f);
+        DRW_draw_pass(psl->shadow_pass);
+      }
+
+      GPU_framebuffer_texture_layer_attach(
+          sldata->shadow_fb, sldata->shadow_cube_pool, 0, layer, 0);
+      GPU_framebuffer_blit(sldata->shadow_static_fb, 0, sldata->shadow_fb, 0, GPU_DEPTH_BIT);
+
+      DRW_view_set_active(g_data->cube_dynamic_views[j]);
+      GPU_framebuffer_bind(sldata->shadow_fb);
+      DRW_draw_pass(psl->shadow_pass);
+    }
+    else {
+      DRW_view_set_active(g_data->cube_views[j]);
+      GPU_framebuffer_texture_layer_attach(
+          sldata->shadow_fb, sldata->shadow_cube_pool, 0, layer, 0);
+      GPU_framebuffer_bind(sldata->shadow_fb);
+      GPU_framebuffer_clear_depth(sldata->shadow_fb, 1.0f);
+      DRW_draw_pass(psl->shadow_pass);
+    }
   }
 
   BLI_BITMAP_SET(&linfo->sh_cube_update[0], cube_index, false);
+  BLI_BITMAP_SET(&linfo->sh_cube_static_update[0], cube_index, false);
 }
@@ -26,6 +26,8 @@
 
 #include "UI_resources.h"
 
+#include "DEG_depsgraph_query.h"
+
 #include "DRW_engine.h"
 #include "DRW_select_buffer.h"
 
@@ -57,7 +59,10 @@ extern char datatoc_selection_id_frag_glsl[];
 /** \name Utils
  * \{ */
 
-static void select_engine_framebuffer_setup(void)
+/**
+ * \return true when the ID texture has been (re)created, so its content is undefined.
+ */
+static bool select_engine_framebuffer_setup(void)
 {
   DefaultTextureList *dtxl = DRW_viewport_texture_list_get();
   int size[2];
@@ -83,7 +88,9 @@ static void select_engine_framebuffer_setup(void)
     GPU_framebuffer_texture_attach(e_data.framebuffer_select_id, e_data.texture_u32, 0, 0);
 
     GPU_framebuffer_check_valid(e_data.framebuffer_select_id, NULL);
+    return true;
   }
+  return false;
 }
 
 /** \} */
@@ -200,13 +207,29 @@ static void select_cache_init(void *vedata)
   float(*persmat)[4] = draw_ctx->rv3d->persmat;
   e_data.context.is_dirty = !compare_m4m4(e_data.context.persmat, persmat, FLT_EPSILON);
 
+  if (select_engine_framebuffer_setup()) {
+    e_data.context.is_dirty = true;
+  }
+
   if (!e_data.context.is_dirty) {
-    /* Check if any of the drawn objects have been transformed. */
-    Object **ob = &e_data.context.objects_drawn[0];
-    for (uint i = e_data.context.objects_drawn_len; i--; ob++) {
-      DrawData *data = DRW_drawdata_get(&(*ob)->id, &draw_engine_select_type);
-      if (data && (data->recalc & ID_RECALC_TRANSFORM) != 0) {
-        data->recalc &= ~ID_RECALC_TRANSFORM;
+    /* Check if any of the drawn objects have been transformed or had their geometry changed.
+     * Selection changes alone don't change the indices, so the buffer is kept for those. */
+    Object **obj = &e_data.context.objects[0];
+    for (uint remaining = e_data.context.objects_len; remaining--; obj++) {
+      Object *obj_eval = DEG_get_evaluated_object(draw_ctx->depsgraph, *obj);
+      SELECTID_ObjectData *sel_data = (SELECTID_ObjectData *)DRW_drawdata_get(
+          &obj_eval->id, &draw_engine_select_type);
+      if (sel_data == NULL || !sel_data->is_drawn) {
+        continue;
+      }
+      if ((sel_data->drawn_index >= e_data.context.objects_drawn_len) ||
+          (e_data.context.objects_drawn[sel_data->drawn_index] != obj_eval)) {
+        /* Drawn for another context or depsgraph. */
+        e_data.context.is_dirty = true;
+        continue;
+      }
+      if (sel_data->dd.recalc & (ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY)) {
+        sel_data->dd.recalc &= ~(ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY);
         e_data.context.is_dirty = true;
       }
     }
@@ -217,7 +240,6 @@ static void select_cache_init(void *vedata)
     copy_m4_m4(e_data.context.persmat, persmat);
     e_data.context.objects_drawn_len = 0;
     e_data.context.index_drawn_len = 1;
-    select_engine_framebuffer_setup();
     GPU_framebuffer_bind(e_data.framebuffer_select_id);
     GPU_framebuffer_clear_color_depth(e_data.framebuffer_select_id, (const float[4]){0.0f}, 1.0f);
   }
@@ -185,6 +185,7 @@ void workbench_render(void *ved, RenderEngine *engine, RenderLayer *render_layer
   /* Also we weed to have a correct fbo bound for DRW_hair_update */
   GPU_framebuffer_bind(dfbl->default_fb);
   DRW_hair_update();
+  DRW_mesh_deform_update();
 
   GPU_framebuffer_bind(dfbl->default_fb);
   GPU_framebuffer_clear_depth(dfbl->default_fb, 1.0f);
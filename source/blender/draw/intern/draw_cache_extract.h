@@ -23,6 +23,7 @@
 #ifndef __DRAW_CACHE_EXTRACT_H__
 #define __DRAW_CACHE_EXTRACT_H__
 
+struct GPUTexture;
 struct TaskGraph;
 
 /* Vertex Group Selection and display options */
@@ -224,6 +225,50 @@ typedef struct MeshBatchCache {
 
   GPUBatch **surface_per_mat;
 
+  /* Inputs of the transform feedback pass rewriting `final.vbo.pos_nor` when only the vertex
+   * coordinates changed, see #DRW_mesh_deform_pos_nor_add. */
+  struct {
+    /* Vertex index and paint overlay flag of every element of `pos_nor`. */
+    GPUVertBuf *elem_map;
+    /* Position and packed normal of every vertex. */
+    GPUVertBuf *vert_co;
+    GPUVertBuf *vert_no;
+    struct GPUTexture *elem_map_tx;
+    struct GPUTexture *vert_co_tx;
+    struct GPUTexture *vert_no_tx;
+    /* Paint mode of the last extraction of `pos_nor`, the flags depend on it. */
+    bool is_paint_mode;
+
+    /* Armature deformation of `pos_nor` and `lnor`, see #Mesh_Runtime.armature_deform_gpu. */
+    /* Vertex index and flag of every loop of `lnor`. */
+    GPUVertBuf *lnor_elem_map;
+    /* Up to 4 vertex groups of every vertex and their weights. */
+    GPUVertBuf *skin_groups;
+    GPUVertBuf *skin_weights;
+    /* 4 columns of the matrix of every vertex group. */
+    GPUVertBuf *skin_mats;
+    struct GPUTexture *lnor_elem_map_tx;
+    struct GPUTexture *skin_groups_tx;
+    struct GPUTexture *skin_weights_tx;
+    struct GPUTexture *skin_mats_tx;
+    /* Vertex groups with a deforming bone the weights were sorted for. */
+    bool *skin_defbase_used;
+    int skin_defbase_len;
+
+    /* Subdivision of `pos_nor` and `lnor`, see #Mesh_Runtime.subdiv_gpu. `vert_co` then has the
+     * positions of the coarse vertices. */
+    /* First element and number of elements of the limit stencil of every vertex. */
+    GPUVertBuf *stencil_offsets;
+    /* Coarse vertex and weights of every stencil element. */
+    GPUVertBuf *stencil_indices;
+    GPUVertBuf *stencil_weights;
+    struct GPUTexture *stencil_offsets_tx;
+    struct GPUTexture *stencil_indices_tx;
+    struct GPUTexture *stencil_weights_tx;
+    /* #SubdivMeshStencils.session_uuid of the uploaded stencils. */
+    uint stencils_session_uuid;
+  } deform;
+
   DRWBatchFlag batch_requested;
   DRWBatchFlag batch_ready;
 
@@ -234,6 +279,7 @@ typedef struct MeshBatchCache {
   int vert_len;
   int mat_len;
   bool is_dirty; /* Instantly invalidates cache, skipping mesh check */
+  bool is_deform_dirty; /* Only buffers depending on vertex coordinates need to be updated. */
   bool is_editmode;
   bool is_uvsyncsel;
 
@@ -270,4 +316,9 @@ void mesh_buffer_cache_create_requested(struct TaskGraph *task_graph,
                                         const ToolSettings *ts,
                                         const bool use_hide);
 
+void mesh_buffer_cache_pos_nor_elem_map_create(Mesh *me,
+                                               const bool is_paint_mode,
+                                               GPUVertBuf *vbo);
+void mesh_buffer_cache_lnor_elem_map_create(Mesh *me, GPUVertBuf *vbo);
+
 #endif /* __DRAW_CACHE_EXTRACT_H__ */
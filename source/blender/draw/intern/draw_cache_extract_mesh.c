@@ -1900,6 +1900,23 @@ static void extract_pos_nor_iter_poly_bm(const MeshRenderData *mr,
   EXTRACT_POLY_AND_LOOP_FOREACH_BM_END(l);
 }
 
+/* Flag for paint mode overlay. */
+BLI_INLINE int extract_pos_nor_loop_flag_mesh(const MeshRenderData *mr,
+                                              const MPoly *mp,
+                                              const MLoop *ml)
+{
+  const MVert *mv = &mr->mvert[ml->v];
+  if (mp->flag & ME_HIDE || mv->flag & ME_HIDE ||
+      ((mr->extract_type == MR_EXTRACT_MAPPED) && (mr->v_origindex) &&
+       (mr->v_origindex[ml->v] == ORIGINDEX_NONE))) {
+    return -1;
+  }
+  if (mv->flag & SELECT) {
+    return 1;
+  }
+  return 0;
+}
+
 static void extract_pos_nor_iter_poly_mesh(const MeshRenderData *mr,
                                            const ExtractPolyMesh_Params *params,
                                            void *_data)
@@ -1911,18 +1928,7 @@ static void extract_pos_nor_iter_poly_mesh(const MeshRenderData *mr,
     const MVert *mv = &mr->mvert[ml->v];
     copy_v3_v3(vert->pos, mv->co);
     vert->nor = data->packed_nor[ml->v];
-    /* Flag for paint mode overlay. */
-    if (mp->flag & ME_HIDE || mv->flag & ME_HIDE ||
-        ((mr->extract_type == MR_EXTRACT_MAPPED) && (mr->v_origindex) &&
-         (mr->v_origindex[ml->v] == ORIGINDEX_NONE))) {
-      vert->nor.w = -1;
-    }
-    else if (mv->flag & SELECT) {
-      vert->nor.w = 1;
-    }
-    else {
-      vert->nor.w = 0;
-    }
+    vert->nor.w = extract_pos_nor_loop_flag_mesh(mr, mp, ml);
   }
   EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
 }
@@ -2013,6 +2019,85 @@ static const MeshExtract extract_pos_nor = {
 };
 /** \} */
 
+/* ---------------------------------------------------------------------- */
+/** \name Extract Position and Vertex Normal Element Map
+ * \{ */
+
+/**
+ * Fill \a vbo with the vertex index and the paint overlay flag of every element of the `pos_nor`
+ * buffer, in the order #extract_pos_nor writes them. This allows to update the buffer on the GPU
+ * when only the vertex coordinates changed, see #DRW_mesh_deform_pos_nor_add.
+ *
+ * \note Only meshes that are not in edit-mode are supported.
+ */
+void mesh_buffer_cache_pos_nor_elem_map_create(Mesh *me,
+                                               const bool is_paint_mode,
+                                               GPUVertBuf *vbo)
+{
+  BLI_assert(me->edit_mesh == NULL);
+
+  /* Same as #mesh_render_data_create, only with the data used by #extract_pos_nor. */
+  MeshRenderData mr = {
+      .extract_type = MR_EXTRACT_MESH,
+      .me = me,
+      .vert_len = me->totvert,
+      .edge_len = me->totedge,
+      .loop_len = me->totloop,
+      .poly_len = me->totpoly,
+      .mvert = CustomData_get_layer(&me->vdata, CD_MVERT),
+      .medge = CustomData_get_layer(&me->edata, CD_MEDGE),
+      .mloop = CustomData_get_layer(&me->ldata, CD_MLOOP),
+      .mpoly = CustomData_get_layer(&me->pdata, CD_MPOLY),
+      .v_origindex = CustomData_get_layer(&me->vdata, CD_ORIGINDEX),
+  };
+  if (is_paint_mode && !me->runtime.is_original &&
+      (mr.v_origindex || CustomData_has_layer(&me->edata, CD_ORIGINDEX) ||
+       CustomData_has_layer(&me->pdata, CD_ORIGINDEX))) {
+    mr.extract_type = MR_EXTRACT_MAPPED;
+  }
+  mesh_render_data_update_loose_geom(&mr, MR_ITER_LEDGE | MR_ITER_LVERT, 0);
+
+  static GPUVertFormat format = {0};
+  if (format.attr_len == 0) {
+    /* x: vertex index, y: flag. */
+    GPU_vertformat_attr_add(&format, "v", GPU_COMP_I32, 2, GPU_FETCH_INT);
+  }
+  GPU_vertbuf_init_with_format(vbo, &format);
+  GPU_vertbuf_data_alloc(vbo, mr.loop_len + mr.loop_loose_len);
+
+  int(*elem_map)[2] = (int(*)[2])vbo->data;
+
+  const MPoly *mp = mr.mpoly;
+  for (int mp_index = 0; mp_index < mr.poly_len; mp_index++, mp++) {
+    const int ml_index_end = mp->loopstart + mp->totloop;
+    for (int ml_index = mp->loopstart; ml_index < ml_index_end; ml_index++) {
+      const MLoop *ml = &mr.mloop[ml_index];
+      elem_map[ml_index][0] = ml->v;
+      elem_map[ml_index][1] = extract_pos_nor_loop_flag_mesh(&mr, mp, ml);
+    }
+  }
+
+  int(*ledge_map)[2] = &elem_map[mr.loop_len];
+  for (int ledge_index = 0; ledge_index < mr.edge_loose_len; ledge_index++) {
+    const MEdge *med = &mr.medge[mr.ledges[ledge_index]];
+    ledge_map[ledge_index * 2][0] = med->v1;
+    ledge_map[ledge_index * 2][1] = 0;
+    ledge_map[ledge_index * 2 + 1][0] = med->v2;
+    ledge_map[ledge_index * 2 + 1][1] = 0;
+  }
+
+  int(*lvert_map)[2] = &elem_map[mr.loop_len + mr.edge_loose_len * 2];
+  for (int lvert_index = 0; lvert_index < mr.vert_loose_len; lvert_index++) {
+    lvert_map[lvert_index][0] = mr.lverts[lvert_index];
+    lvert_map[lvert_index][1] = 0;
+  }
+
+  MEM_SAFE_FREE(mr.lverts);
+  MEM_SAFE_FREE(mr.ledges);
+}
+
+/** \} */
+
 /* ---------------------------------------------------------------------- */
 /** \name Extract HQ Loop Normal
  * \{ */
@@ -2192,6 +2277,39 @@ static const MeshExtract extract_lnor = {
     .use_threading = true,
 };
 
+/**
+ * Fill \a vbo with the vertex index and the flag of every loop of the `lnor` buffer, like
+ * #mesh_buffer_cache_pos_nor_elem_map_create.
+ *
+ * \note Only valid when all faces are smooth without custom or auto-smooth normals, so the
+ * buffer contains the vertex normals.
+ */
+void mesh_buffer_cache_lnor_elem_map_create(Mesh *me, GPUVertBuf *vbo)
+{
+  BLI_assert(me->edit_mesh == NULL);
+
+  static GPUVertFormat format = {0};
+  if (format.attr_len == 0) {
+    /* x: vertex index, y: flag. */
+    GPU_vertformat_attr_add(&format, "v", GPU_COMP_I32, 2, GPU_FETCH_INT);
+  }
+  GPU_vertbuf_init_with_format(vbo, &format);
+  GPU_vertbuf_data_alloc(vbo, me->totloop);
+
+  int(*elem_map)[2] = (int(*)[2])vbo->data;
+
+  const MPoly *mp = me->mpoly;
+  for (int mp_index = 0; mp_index < me->totpoly; mp_index++, mp++) {
+    /* Same flag as #extract_lnor_iter_poly_mesh. */
+    const int flag = (mp->flag & ME_HIDE) ? -1 : ((mp->flag & ME_FACE_SEL) ? 1 : 0);
+    const int ml_index_end = mp->loopstart + mp->totloop;
+    for (int ml_index = mp->loopstart; ml_index < ml_index_end; ml_index++) {
+      elem_map[ml_index][0] = me->mloop[ml_index].v;
+      elem_map[ml_index][1] = flag;
+    }
+  }
+}
+
 /** \} */
 
 /* ---------------------------------------------------------------------- */
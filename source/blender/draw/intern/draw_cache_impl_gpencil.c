@@ -39,6 +39,7 @@
 
 #include "BLI_hash.h"
 #include "BLI_polyfill_2d.h"
+#include "BLI_task.h"
 
 #include "draw_cache.h"
 #include "draw_cache_impl.h"
@@ -229,6 +230,10 @@ typedef struct gpIterData {
   GPUIndexBufBuilder ibo;
   int vert_len;
   int tri_len;
+  /* Visible strokes, gathered while counting so the buffers can be filled in parallel. */
+  bGPDstroke **strokes;
+  int strokes_len;
+  int strokes_alloc_len;
 } gpIterData;
 
 static GPUVertBuf *gpencil_dummy_buffer_get(void)
@@ -330,18 +335,20 @@ static void gpencil_buffer_add_fill(GPUIndexBufBuilder *ibo, const bGPDstroke *g
 {
   int tri_len = gps->tot_triangles;
   int v = gps->runtime.stroke_start;
+  int t = gps->runtime.fill_start;
   for (int i = 0; i < tri_len; i++) {
     uint *tri = gps->triangles[i].verts;
-    GPU_indexbuf_add_tri_verts(ibo, v + tri[0], v + tri[1], v + tri[2]);
+    GPU_indexbuf_set_tri_verts(ibo, (uint)(t + i), v + tri[0], v + tri[1], v + tri[2]);
   }
 }
 
-static void gpencil_stroke_iter_cb(bGPDlayer *UNUSED(gpl),
-                                   bGPDframe *UNUSED(gpf),
-                                   bGPDstroke *gps,
-                                   void *thunk)
+static void gpencil_stroke_fill_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  gpIterData *iter = (gpIterData *)thunk;
+  gpIterData *iter = (gpIterData *)userdata;
+  const bGPDstroke *gps = iter->strokes[i];
+  /* Each stroke writes its own range of vertices and triangles (see the counting pass). */
   gpencil_buffer_add_stroke(iter->verts, iter->cols, gps);
   if (gps->tot_triangles > 0) {
     gpencil_buffer_add_fill(&iter->ibo, gps);
@@ -360,6 +367,12 @@ static void gpencil_object_verts_count_cb(bGPDlayer *UNUSED(gpl),
   gps->runtime.fill_start = iter->tri_len;
   iter->vert_len += gps->totpoints + 2 + gpencil_stroke_is_cyclic(gps);
   iter->tri_len += gps->tot_triangles;
+
+  if (iter->strokes_len == iter->strokes_alloc_len) {
+    iter->strokes_alloc_len = max_ii(iter->strokes_alloc_len * 2, 64);
+    iter->strokes = MEM_reallocN(iter->strokes, sizeof(*iter->strokes) * iter->strokes_alloc_len);
+  }
+  iter->strokes[iter->strokes_len++] = gps;
 }
 
 static void gpencil_batches_ensure(Object *ob, GpencilBatchCache *cache, int cfra)
@@ -402,7 +415,13 @@ static void gpencil_batches_ensure(Object *ob, GpencilBatchCache *cache, int cfr
     GPU_indexbuf_init(&iter.ibo, GPU_PRIM_TRIS, iter.tri_len, iter.vert_len);
 
     /* Fill buffers with data. */
-    BKE_gpencil_visible_stroke_iter(NULL, ob, NULL, gpencil_stroke_iter_cb, &iter, do_onion, cfra);
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (iter.vert_len > 1024);
+    BLI_task_parallel_range(0, iter.strokes_len, &iter, gpencil_stroke_fill_cb, &settings);
+    /* Triangles were set by index, possibly from several threads. */
+    iter.ibo.index_len = (uint)iter.tri_len * 3;
+    MEM_SAFE_FREE(iter.strokes);
 
     /* Mark last 2 verts as invalid. */
     for (int i = 0; i < 2; i++) {
@@ -41,6 +41,7 @@
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
+#include "BKE_armature.h"
 #include "BKE_customdata.h"
 #include "BKE_deform.h"
 #include "BKE_editmesh.h"
@@ -51,6 +52,7 @@
 #include "BKE_mesh_tangent.h"
 #include "BKE_modifier.h"
 #include "BKE_object_deform.h"
+#include "BKE_subdiv_mesh.h"
 
 #include "atomic_ops.h"
 
@@ -504,12 +506,447 @@ static void mesh_batch_cache_init(Mesh *me)
   drw_mesh_weight_state_clear(&cache->weight_state);
 }
 
+static void mesh_batch_cache_discard_deform(MeshBatchCache *cache)
+{
+  DRW_TEXTURE_FREE_SAFE(cache->deform.elem_map_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.vert_co_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.vert_no_tx);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.elem_map);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.vert_co);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.vert_no);
+
+  DRW_TEXTURE_FREE_SAFE(cache->deform.lnor_elem_map_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.skin_groups_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.skin_weights_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.skin_mats_tx);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.lnor_elem_map);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.skin_groups);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.skin_weights);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.skin_mats);
+  MEM_SAFE_FREE(cache->deform.skin_defbase_used);
+  cache->deform.skin_defbase_len = 0;
+}
+
+/* The stencils are kept when discarding the rest, they only change with
+ * #SubdivMeshStencils.session_uuid. */
+static void mesh_batch_cache_discard_stencils(MeshBatchCache *cache)
+{
+  DRW_TEXTURE_FREE_SAFE(cache->deform.stencil_offsets_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.stencil_indices_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.stencil_weights_tx);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.stencil_offsets);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.stencil_indices);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.stencil_weights);
+  cache->deform.stencils_session_uuid = 0;
+}
+
+/* Return false if the element map doesn't match \a pos_nor. */
+static bool mesh_batch_cache_deform_elem_map_ensure(Mesh *me,
+                                                    MeshBatchCache *cache,
+                                                    GPUVertBuf *pos_nor)
+{
+  if (cache->deform.elem_map == NULL) {
+    cache->deform.elem_map = GPU_vertbuf_create(GPU_USAGE_STATIC);
+    mesh_buffer_cache_pos_nor_elem_map_create(
+        me, cache->deform.is_paint_mode, cache->deform.elem_map);
+    /* Create vbo immediately to bind to texture buffer. */
+    GPU_vertbuf_use(cache->deform.elem_map);
+    cache->deform.elem_map_tx = GPU_texture_create_from_vertbuf(cache->deform.elem_map);
+  }
+  if (cache->deform.elem_map->vertex_len != pos_nor->vertex_len) {
+    BLI_assert(0);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Upload the vertex groups and weights of the vertices and the matrices of the vertex groups of
+ * a mesh deformed by an armature. Only the 4 largest weights of vertex groups with a deforming
+ * bone are kept for every vertex.
+ */
+static void mesh_batch_cache_skin_upload(Mesh *me, MeshBatchCache *cache)
+{
+  const ArmatureDeformGPU *deform_gpu = me->runtime.armature_deform_gpu;
+  const int defbase_len = deform_gpu->defbase_len;
+  bool *defbase_used = BLI_array_alloca(defbase_used, defbase_len);
+  for (int i = 0; i < defbase_len; i++) {
+    defbase_used[i] = (deform_gpu->defbase_mats[i][3][3] != 0.0f);
+  }
+
+  /* The weights only need to be sorted again when other bones deform. */
+  if (cache->deform.skin_groups != NULL &&
+      (cache->deform.skin_defbase_len != defbase_len ||
+       memcmp(cache->deform.skin_defbase_used, defbase_used, sizeof(bool) * defbase_len))) {
+    DRW_TEXTURE_FREE_SAFE(cache->deform.skin_groups_tx);
+    DRW_TEXTURE_FREE_SAFE(cache->deform.skin_weights_tx);
+    GPU_VERTBUF_DISCARD_SAFE(cache->deform.skin_groups);
+    GPU_VERTBUF_DISCARD_SAFE(cache->deform.skin_weights);
+    MEM_SAFE_FREE(cache->deform.skin_defbase_used);
+  }
+
+  static GPUVertFormat groups_format = {0}, weights_format = {0}, mats_format = {0};
+  if (groups_format.attr_len == 0) {
+    GPU_vertformat_attr_add(&groups_format, "g", GPU_COMP_I32, 4, GPU_FETCH_INT);
+    GPU_vertformat_attr_add(&weights_format, "w", GPU_COMP_F32, 4, GPU_FETCH_FLOAT);
+    GPU_vertformat_attr_add(&mats_format, "m", GPU_COMP_F32, 4, GPU_FETCH_FLOAT);
+  }
+
+  if (cache->deform.skin_groups == NULL) {
+    cache->deform.skin_groups = GPU_vertbuf_create_with_format(&groups_format);
+    cache->deform.skin_weights = GPU_vertbuf_create_with_format(&weights_format);
+    GPU_vertbuf_data_alloc(cache->deform.skin_groups, me->totvert);
+    GPU_vertbuf_data_alloc(cache->deform.skin_weights, me->totvert);
+
+    int(*groups)[4] = (int(*)[4])cache->deform.skin_groups->data;
+    float(*weights)[4] = (float(*)[4])cache->deform.skin_weights->data;
+    const MDeformVert *dvert = me->dvert;
+    for (int v = 0; v < me->totvert; v++, dvert++) {
+      groups[v][0] = groups[v][1] = groups[v][2] = groups[v][3] = -1;
+      zero_v4(weights[v]);
+      for (int i = 0; i < dvert->totweight; i++) {
+        const MDeformWeight *dw = &dvert->dw[i];
+        if (dw->def_nr >= defbase_len || !defbase_used[dw->def_nr] || dw->weight <= 0.0f) {
+          continue;
+        }
+        /* Insert sorted by decreasing weight, the smallest one is dropped. */
+        int j = 4;
+        for (; j > 0 && weights[v][j - 1] < dw->weight; j--) {
+          if (j < 4) {
+            groups[v][j] = groups[v][j - 1];
+            weights[v][j] = weights[v][j - 1];
+          }
+        }
+        if (j < 4) {
+          groups[v][j] = dw->def_nr;
+          weights[v][j] = dw->weight;
+        }
+      }
+    }
+
+    GPU_vertbuf_use(cache->deform.skin_groups);
+    GPU_vertbuf_use(cache->deform.skin_weights);
+    cache->deform.skin_groups_tx = GPU_texture_create_from_vertbuf(cache->deform.skin_groups);
+    cache->deform.skin_weights_tx = GPU_texture_create_from_vertbuf(cache->deform.skin_weights);
+    cache->deform.skin_defbase_used = MEM_mallocN(sizeof(bool) * defbase_len, __func__);
+    memcpy(cache->deform.skin_defbase_used, defbase_used, sizeof(bool) * defbase_len);
+    cache->deform.skin_defbase_len = defbase_len;
+  }
+
+  /* The matrices change with every evaluation. */
+  DRW_TEXTURE_FREE_SAFE(cache->deform.skin_mats_tx);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.skin_mats);
+  cache->deform.skin_mats = GPU_vertbuf_create_with_format(&mats_format);
+  GPU_vertbuf_data_alloc(cache->deform.skin_mats, defbase_len * 4);
+  memcpy(cache->deform.skin_mats->data,
+         deform_gpu->defbase_mats,
+         sizeof(*deform_gpu->defbase_mats) * defbase_len);
+  GPU_vertbuf_use(cache->deform.skin_mats);
+  cache->deform.skin_mats_tx = GPU_texture_create_from_vertbuf(cache->deform.skin_mats);
+}
+
+/* Upload the limit stencils of the vertices of a mesh subdivided when drawing. */
+static void mesh_batch_cache_stencils_upload(Mesh *me, MeshBatchCache *cache)
+{
+  const SubdivMeshStencils *stencils = me->runtime.subdiv_gpu->stencils;
+  if (cache->deform.stencil_offsets != NULL &&
+      cache->deform.stencils_session_uuid == stencils->session_uuid) {
+    return;
+  }
+  mesh_batch_cache_discard_stencils(cache);
+
+  static GPUVertFormat offsets_format = {0}, indices_format = {0}, weights_format = {0};
+  if (offsets_format.attr_len == 0) {
+    GPU_vertformat_attr_add(&offsets_format, "offset", GPU_COMP_I32, 2, GPU_FETCH_INT);
+    GPU_vertformat_attr_add(&indices_format, "index", GPU_COMP_I32, 1, GPU_FETCH_INT);
+    /* Weight and its derivatives, texture buffers do not support 3 components. */
+    GPU_vertformat_attr_add(&weights_format, "weight", GPU_COMP_F32, 4, GPU_FETCH_FLOAT);
+  }
+  cache->deform.stencil_offsets = GPU_vertbuf_create_with_format(&offsets_format);
+  cache->deform.stencil_indices = GPU_vertbuf_create_with_format(&indices_format);
+  cache->deform.stencil_weights = GPU_vertbuf_create_with_format(&weights_format);
+  GPU_vertbuf_data_alloc(cache->deform.stencil_offsets, me->totvert);
+  GPU_vertbuf_data_alloc(cache->deform.stencil_indices, stencils->num_elements);
+  GPU_vertbuf_data_alloc(cache->deform.stencil_weights, stencils->num_elements);
+
+  int(*offsets)[2] = (int(*)[2])cache->deform.stencil_offsets->data;
+  for (int v = 0; v < me->totvert; v++) {
+    offsets[v][0] = stencils->offsets[v];
+    offsets[v][1] = stencils->sizes[v];
+  }
+  memcpy(cache->deform.stencil_indices->data,
+         stencils->indices,
+         sizeof(*stencils->indices) * stencils->num_elements);
+  float(*weights)[4] = (float(*)[4])cache->deform.stencil_weights->data;
+  for (int i = 0; i < stencils->num_elements; i++) {
+    weights[i][0] = stencils->weights[i];
+    weights[i][1] = stencils->du_weights[i];
+    weights[i][2] = stencils->dv_weights[i];
+    weights[i][3] = 0.0f;
+  }
+
+  GPU_vertbuf_use(cache->deform.stencil_offsets);
+  GPU_vertbuf_use(cache->deform.stencil_indices);
+  GPU_vertbuf_use(cache->deform.stencil_weights);
+  cache->deform.stencil_offsets_tx = GPU_texture_create_from_vertbuf(
+      cache->deform.stencil_offsets);
+  cache->deform.stencil_indices_tx = GPU_texture_create_from_vertbuf(
+      cache->deform.stencil_indices);
+  cache->deform.stencil_weights_tx = GPU_texture_create_from_vertbuf(
+      cache->deform.stencil_weights);
+  cache->deform.stencils_session_uuid = stencils->session_uuid;
+}
+
+/* Upload the positions of the coarse vertices of a mesh subdivided when drawing, and its
+ * stencils when they changed. */
+static void mesh_batch_cache_subdiv_data_update(Mesh *me,
+                                                MeshBatchCache *cache,
+                                                const GPUVertFormat *co_format)
+{
+  const SubdivMeshGPU *subdiv_gpu = me->runtime.subdiv_gpu;
+  const int num_coarse_vertices = subdiv_gpu->stencils->num_coarse_vertices;
+
+  cache->deform.vert_co = GPU_vertbuf_create_with_format(co_format);
+  GPU_vertbuf_data_alloc(cache->deform.vert_co, num_coarse_vertices);
+  float(*vert_co)[4] = (float(*)[4])cache->deform.vert_co->data;
+  for (int v = 0; v < num_coarse_vertices; v++) {
+    copy_v3_v3(vert_co[v], subdiv_gpu->coarse_coords[v]);
+    vert_co[v][3] = 1.0f;
+  }
+  GPU_vertbuf_use(cache->deform.vert_co);
+  cache->deform.vert_co_tx = GPU_texture_create_from_vertbuf(cache->deform.vert_co);
+
+  mesh_batch_cache_stencils_upload(me, cache);
+}
+
+/* Upload the data read by the transform feedback pass that changes when the mesh deforms. */
+static void mesh_batch_cache_deform_data_update(Mesh *me, MeshBatchCache *cache)
+{
+  DRW_TEXTURE_FREE_SAFE(cache->deform.vert_co_tx);
+  DRW_TEXTURE_FREE_SAFE(cache->deform.vert_no_tx);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.vert_co);
+  GPU_VERTBUF_DISCARD_SAFE(cache->deform.vert_no);
+
+  static GPUVertFormat co_format = {0}, no_format = {0};
+  if (co_format.attr_len == 0) {
+    /* Texture buffers do not support 3 components. */
+    GPU_vertformat_attr_add(&co_format, "pos", GPU_COMP_F32, 4, GPU_FETCH_FLOAT);
+    /* Packed the same way as in the `pos_nor` buffer. */
+    GPU_vertformat_attr_add(&no_format, "nor", GPU_COMP_I32, 1, GPU_FETCH_INT);
+  }
+
+  if (me->runtime.subdiv_gpu) {
+    mesh_batch_cache_subdiv_data_update(me, cache, &co_format);
+    return;
+  }
+  mesh_batch_cache_discard_stencils(cache);
+
+  cache->deform.vert_co = GPU_vertbuf_create_with_format(&co_format);
+  cache->deform.vert_no = GPU_vertbuf_create_with_format(&no_format);
+  GPU_vertbuf_data_alloc(cache->deform.vert_co, me->totvert);
+  GPU_vertbuf_data_alloc(cache->deform.vert_no, me->totvert);
+
+  float(*vert_co)[4] = (float(*)[4])cache->deform.vert_co->data;
+  GPUPackedNormal *vert_no = (GPUPackedNormal *)cache->deform.vert_no->data;
+  const MVert *mv = me->mvert;
+  for (int v = 0; v < me->totvert; v++, mv++) {
+    copy_v3_v3(vert_co[v], mv->co);
+    vert_co[v][3] = 1.0f;
+    vert_no[v] = GPU_normal_convert_i10_s3(mv->no);
+  }
+
+  GPU_vertbuf_use(cache->deform.vert_co);
+  GPU_vertbuf_use(cache->deform.vert_no);
+  cache->deform.vert_co_tx = GPU_texture_create_from_vertbuf(cache->deform.vert_co);
+  cache->deform.vert_no_tx = GPU_texture_create_from_vertbuf(cache->deform.vert_no);
+
+  if (me->runtime.armature_deform_gpu) {
+    mesh_batch_cache_skin_upload(me, cache);
+  }
+}
+
+/* Add a call to the skinning or subdivision pass writing \a target. */
+static bool mesh_batch_cache_deform_target_add(Mesh *me,
+                                               MeshBatchCache *cache,
+                                               GPUVertBuf *target,
+                                               const bool normal_only,
+                                               GPUTexture *elem_map_tx)
+{
+  if (me->runtime.subdiv_gpu) {
+    return DRW_mesh_deform_subdiv_add(target,
+                                      normal_only,
+                                      elem_map_tx,
+                                      cache->deform.vert_co_tx,
+                                      cache->deform.stencil_offsets_tx,
+                                      cache->deform.stencil_indices_tx,
+                                      cache->deform.stencil_weights_tx);
+  }
+  return DRW_mesh_deform_skin_add(target,
+                                  normal_only,
+                                  elem_map_tx,
+                                  cache->deform.vert_co_tx,
+                                  cache->deform.vert_no_tx,
+                                  cache->deform.skin_groups_tx,
+                                  cache->deform.skin_weights_tx,
+                                  cache->deform.skin_mats_tx);
+}
+
+/**
+ * Add the transform feedback calls deforming the `pos_nor` and `lnor` buffers of a mesh
+ * deformed by an armature or subdivided when drawing, see #DRW_mesh_deform_skin_add and
+ * #DRW_mesh_deform_subdiv_add. The buffers have the undeformed or stale vertices when extracted.
+ */
+static bool mesh_batch_cache_skin_add(Mesh *me,
+                                      MeshBatchCache *cache,
+                                      GPUVertBuf *pos_nor,
+                                      GPUVertBuf *lnor)
+{
+  const bool data_valid = (me->runtime.subdiv_gpu) ? (cache->deform.stencil_offsets != NULL) :
+                                                     (cache->deform.skin_mats != NULL);
+  if (cache->deform.vert_co == NULL || !data_valid) {
+    mesh_batch_cache_deform_data_update(me, cache);
+  }
+
+  if (pos_nor) {
+    if (!mesh_batch_cache_deform_elem_map_ensure(me, cache, pos_nor) ||
+        !mesh_batch_cache_deform_target_add(
+            me, cache, pos_nor, false, cache->deform.elem_map_tx)) {
+      return false;
+    }
+  }
+
+  if (lnor) {
+    if (cache->deform.lnor_elem_map == NULL) {
+      cache->deform.lnor_elem_map = GPU_vertbuf_create(GPU_USAGE_STATIC);
+      mesh_buffer_cache_lnor_elem_map_create(me, cache->deform.lnor_elem_map);
+      GPU_vertbuf_use(cache->deform.lnor_elem_map);
+      cache->deform.lnor_elem_map_tx = GPU_texture_create_from_vertbuf(
+          cache->deform.lnor_elem_map);
+    }
+    if (cache->deform.lnor_elem_map->vertex_len != lnor->vertex_len) {
+      BLI_assert(0);
+      return false;
+    }
+    if (!mesh_batch_cache_deform_target_add(
+            me, cache, lnor, true, cache->deform.lnor_elem_map_tx)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Rewrite `final.vbo.pos_nor` with a transform feedback pass, gathering the new vertex positions
+ * and normals. The flags stored in the buffer are kept from the last extraction.
+ * For meshes deformed by an armature or subdivided when drawing, `final.vbo.lnor` is rewritten
+ * too when it's valid.
+ *
+ * \return false if the buffer needs to be extracted on the CPU.
+ */
+static bool mesh_batch_cache_update_deform_gpu(Mesh *me,
+                                               MeshBatchCache *cache,
+                                               bool *r_lnor_on_gpu)
+{
+  GPUVertBuf *pos_nor = cache->final.vbo.pos_nor;
+  GPUVertBuf *lnor = cache->final.vbo.lnor;
+  *r_lnor_on_gpu = false;
+
+  if (!USER_EXPERIMENTAL_TEST(&U, use_gpu_mesh_deform) || me->edit_mesh != NULL ||
+      pos_nor == NULL || pos_nor->vbo_id == 0 || pos_nor->dirty ||
+      !mesh_batch_cache_deform_elem_map_ensure(me, cache, pos_nor)) {
+    mesh_batch_cache_discard_deform(cache);
+    return false;
+  }
+
+  mesh_batch_cache_deform_data_update(me, cache);
+
+  if (me->runtime.armature_deform_gpu || me->runtime.subdiv_gpu) {
+    if (lnor == NULL || lnor->vbo_id == 0 || lnor->dirty) {
+      lnor = NULL;
+    }
+    if (!mesh_batch_cache_skin_add(me, cache, pos_nor, lnor)) {
+      mesh_batch_cache_discard_deform(cache);
+      return false;
+    }
+    *r_lnor_on_gpu = (lnor != NULL);
+    return true;
+  }
+
+  return DRW_mesh_deform_pos_nor_add(pos_nor,
+                                     cache->deform.elem_map_tx,
+                                     cache->deform.vert_co_tx,
+                                     cache->deform.vert_no_tx);
+}
+
+/**
+ * Reset the buffers depending on vertex coordinates in place, so that only those are extracted
+ * again. Index buffers and all other attributes are kept, and so are the batches referencing the
+ * buffers.
+ *
+ * When enabled in the experimental preferences, positions and normals are updated on the GPU.
+ */
+static void mesh_batch_cache_update_deform(Mesh *me, MeshBatchCache *cache)
+{
+  bool lnor_on_gpu;
+  const bool pos_nor_on_gpu = mesh_batch_cache_update_deform_gpu(me, cache, &lnor_on_gpu);
+
+  FOREACH_MESH_BUFFER_CACHE (cache, mbufcache) {
+    GPUVertBuf *vbos[] = {
+        (pos_nor_on_gpu && mbufcache == &cache->final) ? NULL : mbufcache->vbo.pos_nor,
+        (lnor_on_gpu && mbufcache == &cache->final) ? NULL : mbufcache->vbo.lnor,
+        mbufcache->vbo.edge_fac,
+        mbufcache->vbo.tan,
+        mbufcache->vbo.stretch_area,
+        mbufcache->vbo.stretch_angle,
+        mbufcache->vbo.mesh_analysis,
+        mbufcache->vbo.fdots_pos,
+        mbufcache->vbo.fdots_nor,
+        mbufcache->vbo.skin_roots,
+    };
+    for (int i = 0; i < ARRAY_SIZE(vbos); i++) {
+      if (vbos[i] != NULL) {
+        /* Leaves the buffer in the requested state, see #DRW_vbo_requested. */
+        GPUUsageType usage = vbos[i]->usage;
+        GPU_vertbuf_clear(vbos[i]);
+        GPU_vertbuf_init(vbos[i], usage);
+      }
+    }
+  }
+
+  /* The vertex array objects still reference the freed buffers. */
+  for (int i = 0; i < sizeof(cache->batch) / sizeof(void *); i++) {
+    GPUBatch **batch = (GPUBatch **)&cache->batch;
+    if (batch[i] != NULL) {
+      GPU_batch_vao_cache_clear(batch[i]);
+    }
+  }
+  for (int i = 0; i < cache->mat_len; i++) {
+    if (cache->surface_per_mat[i] != NULL) {
+      GPU_batch_vao_cache_clear(cache->surface_per_mat[i]);
+    }
+  }
+
+  cache->tot_area = 0.0f;
+  cache->tot_uv_area = 0.0f;
+
+  /* Make sure the buffers are extracted on the next request. */
+  cache->batch_ready = 0;
+  cache->is_deform_dirty = false;
+}
+
 void DRW_mesh_batch_cache_validate(Mesh *me)
 {
   if (!mesh_batch_cache_valid(me)) {
     mesh_batch_cache_clear(me);
     mesh_batch_cache_init(me);
   }
+  else {
+    MeshBatchCache *cache = me->runtime.batch_cache;
+    if (cache->is_deform_dirty) {
+      mesh_batch_cache_update_deform(me, cache);
+    }
+  }
 }
 
 static MeshBatchCache *mesh_batch_cache_get(Mesh *me)
@@ -671,6 +1108,10 @@ void DRW_mesh_batch_cache_dirty_tag(Mesh *me, int mode)
     case BKE_MESH_BATCH_DIRTY_ALL:
       cache->is_dirty = true;
       break;
+    case BKE_MESH_BATCH_DIRTY_DEFORM:
+      /* Handled in #DRW_mesh_batch_cache_validate, where the GPU context is available. */
+      cache->is_deform_dirty = true;
+      break;
     case BKE_MESH_BATCH_DIRTY_SHADING:
       mesh_batch_cache_discard_shaded_tri(cache);
       mesh_batch_cache_discard_uvedit(cache);
@@ -721,6 +1162,9 @@ static void mesh_batch_cache_clear(Mesh *me)
 
   mesh_batch_cache_discard_uvedit(cache);
 
+  mesh_batch_cache_discard_deform(cache);
+  mesh_batch_cache_discard_stencils(cache);
+
   cache->batch_ready = 0;
 
   drw_mesh_weight_state_clear(&cache->weight_state);
@@ -1535,6 +1979,18 @@ void DRW_mesh_batch_cache_create_requested(struct TaskGraph *task_graph,
                                        true);
   }
 
+  const bool pos_nor_requested = DRW_vbo_requested(cache->final.vbo.pos_nor);
+  const bool lnor_requested = DRW_vbo_requested(cache->final.vbo.lnor);
+  if (pos_nor_requested) {
+    /* The element map of the GPU deform update has to match the new extraction. */
+    mesh_batch_cache_discard_deform(cache);
+    cache->deform.is_paint_mode = is_paint_mode;
+  }
+  else if (lnor_requested) {
+    DRW_TEXTURE_FREE_SAFE(cache->deform.lnor_elem_map_tx);
+    GPU_VERTBUF_DISCARD_SAFE(cache->deform.lnor_elem_map);
+  }
+
   mesh_buffer_cache_create_requested(task_graph,
                                      cache,
                                      cache->final,
@@ -1549,6 +2005,16 @@ void DRW_mesh_batch_cache_create_requested(struct TaskGraph *task_graph,
                                      scene,
                                      ts,
                                      use_hide);
+
+  if ((me->runtime.armature_deform_gpu || me->runtime.subdiv_gpu) && !is_editmode &&
+      (pos_nor_requested || lnor_requested)) {
+    /* The buffers are extracted from the undeformed or stale subdivided vertices. */
+    mesh_batch_cache_skin_add(me,
+                              cache,
+                              pos_nor_requested ? cache->final.vbo.pos_nor : NULL,
+                              lnor_requested ? cache->final.vbo.lnor : NULL);
+  }
+
 #ifdef DEBUG
   drw_mesh_batch_cache_check_available(task_graph, me);
 #endif
@@ -52,6 +52,7 @@
 #include "draw_hair_private.h"
 
 static void particle_batch_cache_clear(ParticleSystem *psys);
+static void particle_batch_cache_clear_pos(ParticleSystem *psys);
 
 /* ---------------------------------------------------------------------- */
 /* Particle GPUBatch Cache */
@@ -86,6 +87,8 @@ typedef struct ParticleBatchCache {
 
   /* Settings to determine if cache is invalid. */
   bool is_dirty;
+  /* Only the strands positions need an update, see #particle_batch_cache_clear_pos. */
+  bool is_pos_dirty;
   bool edit_is_weight;
 } ParticleBatchCache;
 
@@ -155,6 +158,9 @@ static ParticleBatchCache *particle_batch_cache_get(ParticleSystem *psys)
     particle_batch_cache_clear(psys);
     particle_batch_cache_init(psys);
   }
+  else if (((ParticleBatchCache *)psys->batch_cache)->is_pos_dirty) {
+    particle_batch_cache_clear_pos(psys);
+  }
   return psys->batch_cache;
 }
 
@@ -168,6 +174,9 @@ void DRW_particle_batch_cache_dirty_tag(ParticleSystem *psys, int mode)
     case BKE_PARTICLE_BATCH_DIRTY_ALL:
       cache->is_dirty = true;
       break;
+    case BKE_PARTICLE_BATCH_DIRTY_POS:
+      cache->is_pos_dirty = true;
+      break;
     default:
       BLI_assert(0);
   }
@@ -179,12 +188,8 @@ static void particle_batch_cache_clear_point(ParticlePointCache *point_cache)
   GPU_VERTBUF_DISCARD_SAFE(point_cache->pos);
 }
 
-void particle_batch_cache_clear_hair(ParticleHairCache *hair_cache)
+static void particle_batch_cache_clear_hair_strand_data(ParticleHairCache *hair_cache)
 {
-  /* TODO more granular update tagging. */
-  GPU_VERTBUF_DISCARD_SAFE(hair_cache->proc_point_buf);
-  DRW_TEXTURE_FREE_SAFE(hair_cache->point_tex);
-
   GPU_VERTBUF_DISCARD_SAFE(hair_cache->proc_strand_buf);
   GPU_VERTBUF_DISCARD_SAFE(hair_cache->proc_strand_seg_buf);
   DRW_TEXTURE_FREE_SAFE(hair_cache->strand_tex);
@@ -198,6 +203,16 @@ void particle_batch_cache_clear_hair(ParticleHairCache *hair_cache)
     GPU_VERTBUF_DISCARD_SAFE(hair_cache->proc_col_buf[i]);
     DRW_TEXTURE_FREE_SAFE(hair_cache->col_tex[i]);
   }
+}
+
+void particle_batch_cache_clear_hair(ParticleHairCache *hair_cache)
+{
+  /* TODO more granular update tagging. */
+  GPU_VERTBUF_DISCARD_SAFE(hair_cache->proc_point_buf);
+  DRW_TEXTURE_FREE_SAFE(hair_cache->point_tex);
+
+  particle_batch_cache_clear_hair_strand_data(hair_cache);
+
   for (int i = 0; i < MAX_HAIR_SUBDIV; i++) {
     GPU_VERTBUF_DISCARD_SAFE(hair_cache->final[i].proc_buf);
     DRW_TEXTURE_FREE_SAFE(hair_cache->final[i].proc_tex);
@@ -277,6 +292,44 @@ static void ensure_seg_pt_count(PTCacheEdit *edit,
   }
 }
 
+/* Only discard the buffers holding the strands positions. For procedural hair, the strand data,
+ * attributes and indices are kept as long as the strands and their segments count stay the same,
+ * so that playing back animated hair only uploads the control points of the path cache. */
+static void particle_batch_cache_clear_pos(ParticleSystem *psys)
+{
+  ParticleBatchCache *cache = psys->batch_cache;
+  ParticleHairCache *hair_cache = &cache->hair;
+
+  particle_batch_cache_clear_point(&cache->point);
+  particle_batch_cache_clear_hair(&cache->edit_hair);
+
+  GPU_BATCH_DISCARD_SAFE(cache->edit_inner_points);
+  GPU_VERTBUF_DISCARD_SAFE(cache->edit_inner_pos);
+  GPU_BATCH_DISCARD_SAFE(cache->edit_tip_points);
+  GPU_VERTBUF_DISCARD_SAFE(cache->edit_tip_pos);
+
+  /* "Normal" legacy hairs */
+  GPU_BATCH_DISCARD_SAFE(hair_cache->hairs);
+  GPU_VERTBUF_DISCARD_SAFE(hair_cache->pos);
+  GPU_INDEXBUF_DISCARD_SAFE(hair_cache->indices);
+
+  GPU_VERTBUF_DISCARD_SAFE(hair_cache->proc_point_buf);
+  DRW_TEXTURE_FREE_SAFE(hair_cache->point_tex);
+
+  const int strands_len = hair_cache->strands_len;
+  const int elems_len = hair_cache->elems_len;
+  const int point_len = hair_cache->point_len;
+
+  ensure_seg_pt_count(NULL, psys, hair_cache);
+
+  if (hair_cache->strands_len != strands_len || hair_cache->elems_len != elems_len ||
+      hair_cache->point_len != point_len) {
+    particle_batch_cache_clear_hair(hair_cache);
+  }
+
+  cache->is_pos_dirty = false;
+}
+
 static void particle_pack_mcol(MCol *mcol, ushort r_scol[3])
 {
   /* Convert to linear ushort and swizzle */
@@ -814,17 +867,19 @@ static void particle_batch_cache_ensure_procedural_final_points(ParticleHairCach
   cache->final[subdiv].proc_tex = GPU_texture_create_from_vertbuf(cache->final[subdiv].proc_buf);
 }
 
-static void particle_batch_cache_ensure_procedural_strand_data(PTCacheEdit *edit,
-                                                               ParticleSystem *psys,
-                                                               ModifierData *md,
-                                                               ParticleHairCache *cache)
+/* Get the UV and color layers of the emitter mesh, and the attribute names they are bound to. */
+static void particle_batch_cache_procedural_layers_get(ParticleSystemModifierData *psmd,
+                                                       ParticleHairCache *cache)
 {
   int active_uv = 0;
   int render_uv = 0;
   int active_col = 0;
   int render_col = 0;
 
-  ParticleSystemModifierData *psmd = (ParticleSystemModifierData *)md;
+  cache->num_uv_layers = 0;
+  cache->num_col_layers = 0;
+  memset(cache->uv_layer_names, 0, sizeof(cache->uv_layer_names));
+  memset(cache->col_layer_names, 0, sizeof(cache->col_layer_names));
 
   if (psmd != NULL && psmd->mesh_final != NULL) {
     if (CustomData_has_layer(&psmd->mesh_final->ldata, CD_MLOOPUV)) {
@@ -839,6 +894,71 @@ static void particle_batch_cache_ensure_procedural_strand_data(PTCacheEdit *edit
     }
   }
 
+  for (int i = 0; i < cache->num_uv_layers; i++) {
+    char attr_safe_name[GPU_MAX_SAFE_ATTR_NAME];
+    const char *name = CustomData_get_layer_name(&psmd->mesh_final->ldata, CD_MLOOPUV, i);
+    GPU_vertformat_safe_attr_name(name, attr_safe_name, GPU_MAX_SAFE_ATTR_NAME);
+
+    int n = 0;
+    BLI_snprintf(cache->uv_layer_names[i][n++], MAX_LAYER_NAME_LEN, "u%s", attr_safe_name);
+    BLI_snprintf(cache->uv_layer_names[i][n++], MAX_LAYER_NAME_LEN, "a%s", attr_safe_name);
+
+    if (i == active_uv) {
+      BLI_strncpy(cache->uv_layer_names[i][n++], "au", MAX_LAYER_NAME_LEN);
+    }
+    if (i == render_uv) {
+      BLI_strncpy(cache->uv_layer_names[i][n++], "u", MAX_LAYER_NAME_LEN);
+    }
+  }
+  for (int i = 0; i < cache->num_col_layers; i++) {
+    char attr_safe_name[GPU_MAX_SAFE_ATTR_NAME];
+    const char *name = CustomData_get_layer_name(&psmd->mesh_final->ldata, CD_MLOOPCOL, i);
+    GPU_vertformat_safe_attr_name(name, attr_safe_name, GPU_MAX_SAFE_ATTR_NAME);
+
+    int n = 0;
+    BLI_snprintf(cache->col_layer_names[i][n++], MAX_LAYER_NAME_LEN, "c%s", attr_safe_name);
+
+    /* We only do vcols auto name that are not overridden by uvs */
+    if (CustomData_get_named_layer_index(&psmd->mesh_final->ldata, CD_MLOOPUV, name) == -1) {
+      BLI_snprintf(cache->col_layer_names[i][n++], MAX_LAYER_NAME_LEN, "a%s", attr_safe_name);
+    }
+
+    if (i == active_col) {
+      BLI_strncpy(cache->col_layer_names[i][n++], "ac", MAX_LAYER_NAME_LEN);
+    }
+    if (i == render_col) {
+      BLI_strncpy(cache->col_layer_names[i][n++], "c", MAX_LAYER_NAME_LEN);
+    }
+  }
+}
+
+/* Kept strand data needs to be rebuilt when the layers of the emitter mesh changed. */
+static bool particle_batch_cache_procedural_layers_changed(ParticleSystemModifierData *psmd,
+                                                           ParticleHairCache *cache)
+{
+  const int num_uv_layers = cache->num_uv_layers;
+  const int num_col_layers = cache->num_col_layers;
+  char uv_layer_names[MAX_MTFACE][MAX_LAYER_NAME_CT][MAX_LAYER_NAME_LEN];
+  char col_layer_names[MAX_MCOL][MAX_LAYER_NAME_CT][MAX_LAYER_NAME_LEN];
+  memcpy(uv_layer_names, cache->uv_layer_names, sizeof(uv_layer_names));
+  memcpy(col_layer_names, cache->col_layer_names, sizeof(col_layer_names));
+
+  particle_batch_cache_procedural_layers_get(psmd, cache);
+
+  return (cache->num_uv_layers != num_uv_layers) || (cache->num_col_layers != num_col_layers) ||
+         memcmp(uv_layer_names, cache->uv_layer_names, sizeof(uv_layer_names)) != 0 ||
+         memcmp(col_layer_names, cache->col_layer_names, sizeof(col_layer_names)) != 0;
+}
+
+static void particle_batch_cache_ensure_procedural_strand_data(PTCacheEdit *edit,
+                                                               ParticleSystem *psys,
+                                                               ModifierData *md,
+                                                               ParticleHairCache *cache)
+{
+  ParticleSystemModifierData *psmd = (ParticleSystemModifierData *)md;
+
+  particle_batch_cache_procedural_layers_get(psmd, cache);
+
   GPUVertBufRaw data_step, seg_step;
   GPUVertBufRaw uv_step[MAX_MTFACE];
   GPUVertBufRaw col_step[MAX_MCOL];
@@ -861,9 +981,6 @@ static void particle_batch_cache_ensure_procedural_strand_data(PTCacheEdit *edit
   uint col_id = GPU_vertformat_attr_add(
       &format_col, "col", GPU_COMP_U16, 4, GPU_FETCH_INT_TO_FLOAT_UNIT);
 
-  memset(cache->uv_layer_names, 0, sizeof(cache->uv_layer_names));
-  memset(cache->col_layer_names, 0, sizeof(cache->col_layer_names));
-
   /* Strand Data */
   cache->proc_strand_buf = GPU_vertbuf_create_with_format(&format_data);
   GPU_vertbuf_data_alloc(cache->proc_strand_buf, cache->strands_len);
@@ -878,46 +995,12 @@ static void particle_batch_cache_ensure_procedural_strand_data(PTCacheEdit *edit
     cache->proc_uv_buf[i] = GPU_vertbuf_create_with_format(&format_uv);
     GPU_vertbuf_data_alloc(cache->proc_uv_buf[i], cache->strands_len);
     GPU_vertbuf_attr_get_raw_data(cache->proc_uv_buf[i], uv_id, &uv_step[i]);
-
-    char attr_safe_name[GPU_MAX_SAFE_ATTR_NAME];
-    const char *name = CustomData_get_layer_name(&psmd->mesh_final->ldata, CD_MLOOPUV, i);
-    GPU_vertformat_safe_attr_name(name, attr_safe_name, GPU_MAX_SAFE_ATTR_NAME);
-
-    int n = 0;
-    BLI_snprintf(cache->uv_layer_names[i][n++], MAX_LAYER_NAME_LEN, "u%s", attr_safe_name);
-    BLI_snprintf(cache->uv_layer_names[i][n++], MAX_LAYER_NAME_LEN, "a%s", attr_safe_name);
-
-    if (i == active_uv) {
-      BLI_strncpy(cache->uv_layer_names[i][n++], "au", MAX_LAYER_NAME_LEN);
-    }
-    if (i == render_uv) {
-      BLI_strncpy(cache->uv_layer_names[i][n++], "u", MAX_LAYER_NAME_LEN);
-    }
   }
   /* Vertex colors */
   for (int i = 0; i < cache->num_col_layers; i++) {
     cache->proc_col_buf[i] = GPU_vertbuf_create_with_format(&format_col);
     GPU_vertbuf_data_alloc(cache->proc_col_buf[i], cache->strands_len);
     GPU_vertbuf_attr_get_raw_data(cache->proc_col_buf[i], col_id, &col_step[i]);
-
-    char attr_safe_name[GPU_MAX_SAFE_ATTR_NAME];
-    const char *name = CustomData_get_layer_name(&psmd->mesh_final->ldata, CD_MLOOPCOL, i);
-    GPU_vertformat_safe_attr_name(name, attr_safe_name, GPU_MAX_SAFE_ATTR_NAME);
-
-    int n = 0;
-    BLI_snprintf(cache->col_layer_names[i][n++], MAX_LAYER_NAME_LEN, "c%s", attr_safe_name);
-
-    /* We only do vcols auto name that are not overridden by uvs */
-    if (CustomData_get_named_layer_index(&psmd->mesh_final->ldata, CD_MLOOPUV, name) == -1) {
-      BLI_snprintf(cache->col_layer_names[i][n++], MAX_LAYER_NAME_LEN, "a%s", attr_safe_name);
-    }
-
-    if (i == active_col) {
-      BLI_strncpy(cache->col_layer_names[i][n++], "ac", MAX_LAYER_NAME_LEN);
-    }
-    if (i == render_col) {
-      BLI_strncpy(cache->col_layer_names[i][n++], "c", MAX_LAYER_NAME_LEN);
-    }
   }
 
   if (cache->num_uv_layers || cache->num_col_layers) {
@@ -1672,6 +1755,11 @@ bool particles_ensure_procedural_data(Object *object,
   }
 
   /* Refreshed if active layer or custom data changes. */
+  if ((*r_hair_cache)->strand_tex != NULL &&
+      particle_batch_cache_procedural_layers_changed((ParticleSystemModifierData *)source.md,
+                                                     &cache->hair)) {
+    particle_batch_cache_clear_hair_strand_data(&cache->hair);
+  }
   if ((*r_hair_cache)->strand_tex == NULL) {
     particle_batch_cache_ensure_procedural_strand_data(
         source.edit, source.psys, source.md, &cache->hair);
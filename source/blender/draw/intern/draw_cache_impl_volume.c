@@ -40,6 +40,7 @@
 #include "BKE_volume_render.h"
 
 #include "GPU_batch.h"
+#include "GPU_extensions.h"
 #include "GPU_texture.h"
 
 #include "DRW_render.h"
@@ -209,6 +210,27 @@ GPUBatch *DRW_volume_batch_cache_get_wireframes_face(Volume *volume)
   return cache->face_wire.batch;
 }
 
+/* Largest number of values uploaded for a single grid, 256 MB of half floats. */
+#define VOLUME_GRID_MAX_VOXELS (1 << 27)
+
+/* Factor to downsample grids with, so their textures fit within the GPU limits and memory
+ * budget. */
+static int volume_grid_downsample_factor(const int64_t resolution[3], const size_t channels)
+{
+  const int64_t max_size = GPU_max_texture_size();
+  const int64_t max_voxels = VOLUME_GRID_MAX_VOXELS / channels;
+
+  for (int factor = 1;; factor++) {
+    const int64_t size[3] = {divide_ceil_u(resolution[0], factor),
+                             divide_ceil_u(resolution[1], factor),
+                             divide_ceil_u(resolution[2], factor)};
+    if (size[0] <= max_size && size[1] <= max_size && size[2] <= max_size &&
+        size[0] * size[1] * size[2] <= max_voxels) {
+      return factor;
+    }
+  }
+}
+
 static DRWVolumeGrid *volume_grid_cache_get(Volume *volume,
                                             VolumeGrid *grid,
                                             VolumeBatchCache *cache)
@@ -244,10 +266,18 @@ static DRWVolumeGrid *volume_grid_cache_get(Volume *volume,
 
   /* Compute dense voxel grid size. */
   int64_t dense_min[3], dense_max[3], resolution[3] = {0};
+  int factor = 1;
   if (BKE_volume_grid_dense_bounds(volume, grid, dense_min, dense_max)) {
     resolution[0] = dense_max[0] - dense_min[0];
     resolution[1] = dense_max[1] - dense_min[1];
     resolution[2] = dense_max[2] - dense_min[2];
+
+    /* Pad the bounds to whole blocks of the downsample factor, the padding is empty space. */
+    factor = volume_grid_downsample_factor(resolution, channels);
+    for (int i = 0; i < 3; i++) {
+      resolution[i] = divide_ceil_u(resolution[i], factor);
+      dense_max[i] = dense_min[i] + resolution[i] * factor;
+    }
   }
   size_t num_voxels = resolution[0] * resolution[1] * resolution[2];
   size_t elem_size = sizeof(float) * channels;
@@ -255,7 +285,8 @@ static DRWVolumeGrid *volume_grid_cache_get(Volume *volume,
   /* Allocate and load voxels. */
   float *voxels = (num_voxels > 0) ? MEM_malloc_arrayN(num_voxels, elem_size, __func__) : NULL;
   if (voxels != NULL) {
-    BKE_volume_grid_dense_voxels(volume, grid, dense_min, dense_max, voxels);
+    BKE_volume_grid_dense_voxels_downsampled(
+        volume, grid, dense_min, dense_max, factor, voxels);
 
     /* Create GPU texture. */
     cache_grid->texture = GPU_texture_create_3d(resolution[0],
@@ -28,6 +28,8 @@ struct DRWShadingGroup;
 struct GPUMaterial;
 struct ModifierData;
 struct FluidModifierData;
+struct GPUTexture;
+struct GPUVertBuf;
 struct Object;
 struct ParticleSystem;
 struct RegionView3D;
@@ -190,6 +192,30 @@ void DRW_hair_init(void);
 void DRW_hair_update(void);
 void DRW_hair_free(void);
 
+/* draw_mesh_deform.c */
+void DRW_mesh_deform_init(void);
+bool DRW_mesh_deform_pos_nor_add(struct GPUVertBuf *pos_nor,
+                                 struct GPUTexture *elem_map_tx,
+                                 struct GPUTexture *vert_co_tx,
+                                 struct GPUTexture *vert_no_tx);
+bool DRW_mesh_deform_skin_add(struct GPUVertBuf *target,
+                              const bool normal_only,
+                              struct GPUTexture *elem_map_tx,
+                              struct GPUTexture *vert_co_tx,
+                              struct GPUTexture *vert_no_tx,
+                              struct GPUTexture *skin_groups_tx,
+                              struct GPUTexture *skin_weights_tx,
+                              struct GPUTexture *skin_mats_tx);
+bool DRW_mesh_deform_subdiv_add(struct GPUVertBuf *target,
+                                const bool normal_only,
+                                struct GPUTexture *elem_map_tx,
+                                struct GPUTexture *vert_co_tx,
+                                struct GPUTexture *stencil_offsets_tx,
+                                struct GPUTexture *stencil_indices_tx,
+                                struct GPUTexture *stencil_weights_tx);
+void DRW_mesh_deform_update(void);
+void DRW_mesh_deform_free(void);
+
 /* draw_fluid.c */
 
 /* Fluid simulation.  */
@@ -131,7 +131,7 @@ static void drw_state_ensure_not_reused(DRWManager *dst)
 static void drw_task_graph_init(void)
 {
   BLI_assert(DST.task_graph == NULL);
-  DST.task_graph = BLI_task_graph_create();
+  DST.task_graph = BLI_task_graph_create_ex(TASK_PRIORITY_INTERACTIVE, NULL);
   DST.delayed_extraction = BLI_gset_ptr_new(__func__);
 }
 
@@ -1460,6 +1460,7 @@ void DRW_draw_render_loop_ex(struct Depsgraph *depsgraph,
 
   drw_debug_init();
   DRW_hair_init();
+  DRW_mesh_deform_init();
 
   /* No framebuffer allowed before drawing. */
   BLI_assert(GPU_framebuffer_active_get() == NULL);
@@ -1514,6 +1515,7 @@ void DRW_draw_render_loop_ex(struct Depsgraph *depsgraph,
   GPU_framebuffer_clear_depth_stencil(DST.default_framebuffer, 1.0f, 0xFF);
 
   DRW_hair_update();
+  DRW_mesh_deform_update();
 
   DRW_draw_callbacks_pre_scene();
 
@@ -1811,6 +1813,7 @@ void DRW_render_object_iter(
 {
   const DRWContextState *draw_ctx = DRW_context_state_get();
   DRW_hair_init();
+  DRW_mesh_deform_init();
 
   drw_task_graph_init();
   const int object_type_exclude_viewport = draw_ctx->v3d ?
@@ -1872,6 +1875,7 @@ void DRW_custom_pipeline(DrawEngineType *draw_engine_type,
   drw_viewport_var_init();
 
   DRW_hair_init();
+  DRW_mesh_deform_init();
 
   ViewportEngineData *data = drw_viewport_engine_data_ensure(draw_engine_type);
 
@@ -1910,6 +1914,7 @@ void DRW_cache_restart(void)
   DST.buffer_finish_called = false;
 
   DRW_hair_init();
+  DRW_mesh_deform_init();
 
   /* Restore. */
   copy_v2_v2(DST.size, size);
@@ -2077,6 +2082,7 @@ void DRW_draw_select_loop(struct Depsgraph *depsgraph,
   /* Init engines */
   drw_engines_init();
   DRW_hair_init();
+  DRW_mesh_deform_init();
 
   {
     drw_engines_cache_init();
@@ -2157,6 +2163,7 @@ void DRW_draw_select_loop(struct Depsgraph *depsgraph,
   DRW_draw_callbacks_pre_scene();
 
   DRW_hair_update();
+  DRW_mesh_deform_update();
 
   DRW_state_lock(DRW_STATE_WRITE_DEPTH | DRW_STATE_DEPTH_ALWAYS | DRW_STATE_DEPTH_LESS_EQUAL |
                  DRW_STATE_DEPTH_EQUAL | DRW_STATE_DEPTH_GREATER | DRW_STATE_DEPTH_ALWAYS);
@@ -2241,6 +2248,7 @@ static void drw_draw_depth_loop_imp(struct Depsgraph *depsgraph,
   /* Init engines */
   drw_engines_init();
   DRW_hair_init();
+  DRW_mesh_deform_init();
 
   {
     drw_engines_cache_init();
@@ -2273,6 +2281,7 @@ static void drw_draw_depth_loop_imp(struct Depsgraph *depsgraph,
   DRW_state_reset();
 
   DRW_hair_update();
+  DRW_mesh_deform_update();
 
   drw_engines_draw_scene();
 
@@ -2687,6 +2696,7 @@ void DRW_engines_free(void)
   GPU_FRAMEBUFFER_FREE_SAFE(g_select_buffer.framebuffer_depth_only);
 
   DRW_hair_free();
+  DRW_mesh_deform_free();
   DRW_shape_cache_free();
   DRW_stats_free();
   DRW_globals_free();
@@ -469,7 +469,7 @@ typedef struct DRWDebugSphere {
 
 /* ------------- DRAW MANAGER ------------ */
 
-#define DST_MAX_SLOTS 64  /* Cannot be changed without modifying RST.bound_tex_slots */
+#define DST_MAX_SLOTS 64  /* Texture units tracked by DST.bound_texs. */
 #define MAX_CLIP_PLANES 6 /* GL_MAX_CLIP_PLANES is at least 6 */
 #define STENCIL_UNDEFINED 256
 #define DRW_DRAWLIST_LEN 256
@@ -501,6 +501,12 @@ typedef struct DRWManager {
   /* Rendering state */
   GPUShader *shader;
   GPUBatch *batch;
+  /** Textures bound by the pass being drawn, to skip binding them again for every
+   * shading group. Reset at the start of each pass. */
+  struct {
+    GPUTexture *tex;
+    eGPUSamplerState sampler_state;
+  } bound_texs[DST_MAX_SLOTS];
 
   /* Managed by `DRW_state_set`, `DRW_state_reset` */
   DRWState state;
@@ -26,6 +26,7 @@
 #include "BLI_math.h"
 #include "BLI_math_bits.h"
 #include "BLI_memblock.h"
+#include "BLI_task.h"
 
 #include "BKE_global.h"
 
@@ -595,45 +596,100 @@ void DRW_culling_frustum_planes_get(const DRWView *view, float planes[6][4])
   memcpy(planes, view->frustum_planes, sizeof(float) * 6 * 4);
 }
 
+static void draw_compute_culling_state(DRWView *view, DRWCullingState *cull)
+{
+  if (cull->bsphere.radius < 0.0) {
+    cull->mask = 0;
+  }
+  else {
+    bool culled = !draw_culling_sphere_test(
+        &view->frustum_bsphere, view->frustum_planes, &cull->bsphere);
+
+#ifdef DRW_DEBUG_CULLING
+    if (G.debug_value != 0) {
+      if (culled) {
+        DRW_debug_sphere(cull->bsphere.center, cull->bsphere.radius, (const float[4]){1, 0, 0, 1});
+      }
+      else {
+        DRW_debug_sphere(cull->bsphere.center, cull->bsphere.radius, (const float[4]){0, 1, 0, 1});
+      }
+    }
+#endif
+
+    if (view->visibility_fn) {
+      culled = !view->visibility_fn(!culled, cull->user_data);
+    }
+
+    SET_FLAG_FROM_TEST(cull->mask, culled, view->culling_mask);
+  }
+}
+
+typedef struct DRWCullingTaskData {
+  DRWView *view;
+  /* Number of resources in the last used chunk. */
+  int last_chunk_len;
+  int chunk_len;
+} DRWCullingTaskData;
+
+static void draw_compute_culling_chunk_cb(void *__restrict userdata,
+                                          const int chunk,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  DRWCullingTaskData *data = userdata;
+  const int elem_len = (chunk == data->chunk_len - 1) ? data->last_chunk_len :
+                                                         DRW_RESOURCE_CHUNK_LEN;
+  /* Each chunk is only accessed by one thread, the culling states are independent. */
+  for (int i = 0; i < elem_len; i++) {
+    DRWCullingState *cull = BLI_memblock_elem_get(DST.vmempool->cullstates, chunk, i);
+    draw_compute_culling_state(data->view, cull);
+  }
+}
+
 static void draw_compute_culling(DRWView *view)
 {
   view = view->parent ? view->parent : view;
 
-  /* TODO(fclem) multithread this. */
   /* TODO(fclem) compute all dirty views at once. */
   if (!view->is_dirty) {
     return;
   }
 
-  BLI_memblock_iter iter;
-  BLI_memblock_iternew(DST.vmempool->cullstates, &iter);
-  DRWCullingState *cull;
-  while ((cull = BLI_memblock_iterstep(&iter))) {
-    if (cull->bsphere.radius < 0.0) {
-      cull->mask = 0;
-    }
-    else {
-      bool culled = !draw_culling_sphere_test(
-          &view->frustum_bsphere, view->frustum_planes, &cull->bsphere);
-
+  bool use_threading = true;
+  /* The visibility callbacks are free to modify engine data. */
+  if (view->visibility_fn) {
+    use_threading = false;
+  }
 #ifdef DRW_DEBUG_CULLING
-      if (G.debug_value != 0) {
-        if (culled) {
-          DRW_debug_sphere(
-              cull->bsphere.center, cull->bsphere.radius, (const float[4]){1, 0, 0, 1});
-        }
-        else {
-          DRW_debug_sphere(
-              cull->bsphere.center, cull->bsphere.radius, (const float[4]){0, 1, 0, 1});
-        }
-      }
+  /* Debug shapes are not thread safe. */
+  if (G.debug_value != 0) {
+    use_threading = false;
+  }
 #endif
 
-      if (view->visibility_fn) {
-        culled = !view->visibility_fn(!culled, cull->user_data);
-      }
+  if (use_threading) {
+    /* There is one culling state per resource handle. */
+    const int chunk_id = DRW_handle_chunk_get(&DST.resource_handle);
+    const int elem_id = DRW_handle_id_get(&DST.resource_handle);
 
-      SET_FLAG_FROM_TEST(cull->mask, culled, view->culling_mask);
+    DRWCullingTaskData data = {
+        .view = view,
+        .chunk_len = 1 + chunk_id - ((elem_id == 0) ? 1 : 0),
+        .last_chunk_len = (elem_id == 0) ? DRW_RESOURCE_CHUNK_LEN : elem_id,
+    };
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
+    /* Not worth the threading overhead for small scenes. */
+    settings.use_threading = (data.chunk_len > 1);
+    BLI_task_parallel_range(0, data.chunk_len, &data, draw_compute_culling_chunk_cb, &settings);
+  }
+  else {
+    BLI_memblock_iter iter;
+    BLI_memblock_iternew(DST.vmempool->cullstates, &iter);
+    DRWCullingState *cull;
+    while ((cull = BLI_memblock_iterstep(&iter))) {
+      draw_compute_culling_state(view, cull);
     }
   }
 
@@ -785,6 +841,25 @@ static bool ubo_bindings_validate(DRWShadingGroup *shgroup)
 }
 #endif
 
+static void draw_texture_bind_reset(void)
+{
+  memset(DST.bound_texs, 0, sizeof(DST.bound_texs));
+}
+
+/* Consecutive shading groups often use the same textures (i.e: the common textures of all
+ * the materials of an engine), only bind them if they changed. */
+static void draw_texture_bind(GPUTexture *tex, eGPUSamplerState sampler_state, int unit)
+{
+  if (unit < DST_MAX_SLOTS) {
+    if (DST.bound_texs[unit].tex == tex && DST.bound_texs[unit].sampler_state == sampler_state) {
+      return;
+    }
+    DST.bound_texs[unit].tex = tex;
+    DST.bound_texs[unit].sampler_state = sampler_state;
+  }
+  GPU_texture_bind_ex(tex, sampler_state, unit, false);
+}
+
 static void draw_update_uniforms(DRWShadingGroup *shgroup,
                                  DRWCommandsState *state,
                                  bool *use_tfeedback)
@@ -810,10 +885,10 @@ static void draw_update_uniforms(DRWShadingGroup *shgroup,
               shgroup->shader, uni->location, uni->length, uni->arraysize, uni->pvalue);
           break;
         case DRW_UNIFORM_TEXTURE:
-          GPU_texture_bind_ex(uni->texture, uni->sampler_state, uni->location, false);
+          draw_texture_bind(uni->texture, uni->sampler_state, uni->location);
           break;
         case DRW_UNIFORM_TEXTURE_REF:
-          GPU_texture_bind_ex(*uni->texture_ref, uni->sampler_state, uni->location, false);
+          draw_texture_bind(*uni->texture_ref, uni->sampler_state, uni->location);
           break;
         case DRW_UNIFORM_BLOCK:
           GPU_uniformbuffer_bind(uni->block, uni->location);
@@ -1106,6 +1181,7 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 
       /* Unbinding can be costly. Skip in normal condition. */
       if (G.debug & G_DEBUG_GPU) {
+        draw_texture_bind_reset();
         GPU_texture_unbind_all();
         GPU_uniformbuffer_unbind_all();
       }
@@ -1269,6 +1345,8 @@ static void drw_draw_pass_ex(DRWPass *pass,
   }
 
   DST.shader = NULL;
+  /* Textures could have been bound or freed outside of the draw manager since the last pass. */
+  draw_texture_bind_reset();
 
   BLI_assert(DST.buffer_finish_called &&
              "DRW_render_instance_buffer_finish had not been called before drawing");
@@ -20,10 +20,13 @@
  * \ingroup draw
  */
 
+#include "BLI_fileops.h"
 #include "BLI_listbase.h"
+#include "BLI_path_util.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
 
+#include "BKE_appdir.h"
 #include "BKE_global.h"
 
 #include "BLF_api.h"
@@ -44,11 +47,15 @@
 #define GPU_TIMER_FALLOFF 0.1
 
 typedef struct DRWTimer {
-  GLuint query[2];
+  /* Timestamps queries at the start and the end of the timer.
+   * The queries of the previous redraw are read while the current ones are issued. */
+  GLuint query[2][2];
   GLuint64 time_average;
+  /* Result of the previous redraw. */
+  GLuint64 time_start;
+  GLuint64 time_last;
   char name[MAX_TIMER_NAME];
-  int lvl;       /* Hierarchy level for nested timer. */
-  bool is_query; /* Does this timer actually perform queries or is it just a group. */
+  int lvl; /* Hierarchy level for nested timer. */
 } DRWTimer;
 
 static struct DRWTimerPool {
@@ -57,25 +64,40 @@ static struct DRWTimerPool {
   int timer_count;     /* chunk_count * CHUNK_SIZE */
   int timer_increment; /* Keep track of where we are in the stack. */
   int end_increment;   /* Keep track of bad usage. */
-  bool is_recording;   /* Are we in the render loop? */
-  bool is_querying;    /* Keep track of bad usage. */
+  /* Indices of the timers started but not ended yet. */
+  int stack[MAX_NESTED_TIMER];
+  int stack_len;
+  bool is_recording; /* Are we in the render loop? */
+  /* Trace of all the recorded redraws, in the Chrome trace event format. */
+  FILE *trace_file;
+  bool trace_is_empty;
 } DTP = {NULL};
 
+static void drw_stats_trace_close(void)
+{
+  if (DTP.trace_file != NULL) {
+    fprintf(DTP.trace_file, "\n]\n");
+    fclose(DTP.trace_file);
+    DTP.trace_file = NULL;
+  }
+}
+
 void DRW_stats_free(void)
 {
   if (DTP.timers != NULL) {
     for (int i = 0; i < DTP.timer_count; i++) {
       DRWTimer *timer = &DTP.timers[i];
-      glDeleteQueries(2, timer->query);
+      glDeleteQueries(4, &timer->query[0][0]);
     }
     MEM_freeN(DTP.timers);
     DTP.timers = NULL;
   }
+  drw_stats_trace_close();
 }
 
 void DRW_stats_begin(void)
 {
-  if (G.debug_value > 20 && G.debug_value < 30) {
+  if ((G.debug_value > 20 && G.debug_value < 30) || (G.debug & G_DEBUG_GPU_TIMINGS)) {
     DTP.is_recording = true;
   }
 
@@ -88,7 +110,7 @@ void DRW_stats_begin(void)
     DRW_stats_free();
   }
 
-  DTP.is_querying = false;
+  DTP.stack_len = 0;
   DTP.timer_increment = 0;
   DTP.end_increment = 0;
 }
@@ -105,58 +127,87 @@ static DRWTimer *drw_stats_timer_get(void)
   return &DTP.timers[DTP.timer_increment++];
 }
 
-static void drw_stats_timer_start_ex(const char *name, const bool is_query)
+static void drw_stats_timer_start(const char *name)
 {
   if (DTP.is_recording) {
+    BLI_assert(DTP.stack_len < MAX_NESTED_TIMER);
+    DTP.stack[DTP.stack_len] = DTP.timer_increment;
+
     DRWTimer *timer = drw_stats_timer_get();
     BLI_strncpy(timer->name, name, MAX_TIMER_NAME);
-    timer->lvl = DTP.timer_increment - DTP.end_increment - 1;
-    timer->is_query = is_query;
-
-    /* Queries cannot be nested or interleaved. */
-    BLI_assert(!DTP.is_querying);
-    if (timer->is_query) {
-      if (timer->query[0] == 0) {
-        glGenQueries(1, timer->query);
-      }
+    timer->lvl = DTP.stack_len++;
 
-      glFinish();
-      /* Issue query for the next frame */
-      glBeginQuery(GL_TIME_ELAPSED, timer->query[0]);
-      DTP.is_querying = true;
+    if (timer->query[0][0] == 0) {
+      glGenQueries(2, timer->query[0]);
     }
+    /* Timestamps do not stall the pipeline and can be nested. */
+    glQueryCounter(timer->query[0][0], GL_TIMESTAMP);
+  }
+}
+
+static void drw_stats_timer_end(void)
+{
+  if (DTP.is_recording) {
+    DTP.end_increment++;
+    BLI_assert(DTP.stack_len > 0);
+    DRWTimer *timer = &DTP.timers[DTP.stack[--DTP.stack_len]];
+    glQueryCounter(timer->query[0][1], GL_TIMESTAMP);
   }
 }
 
-/* Use this to group the queries. It does NOT keep track
- * of the time, it only sum what the queries inside it. */
+/* Use this to group the queries. */
 void DRW_stats_group_start(const char *name)
 {
-  drw_stats_timer_start_ex(name, false);
+  drw_stats_timer_start(name);
 }
 
 void DRW_stats_group_end(void)
 {
-  if (DTP.is_recording) {
-    BLI_assert(!DTP.is_querying);
-    DTP.end_increment++;
-  }
+  drw_stats_timer_end();
 }
 
-/* NOTE: Only call this when no sub timer will be called. */
 void DRW_stats_query_start(const char *name)
 {
-  drw_stats_timer_start_ex(name, true);
+  drw_stats_timer_start(name);
 }
 
 void DRW_stats_query_end(void)
 {
-  if (DTP.is_recording) {
-    DTP.end_increment++;
-    BLI_assert(DTP.is_querying);
-    glEndQuery(GL_TIME_ELAPSED);
-    DTP.is_querying = false;
+  drw_stats_timer_end();
+}
+
+static void drw_stats_trace_write(void)
+{
+  if (DTP.trace_file == NULL) {
+    char filepath[FILE_MAX];
+    BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_base(), "blender_gpu_timings.json");
+    DTP.trace_file = BLI_fopen(filepath, "w");
+    if (DTP.trace_file == NULL) {
+      printf("Error writing GPU timings to: %s\n", filepath);
+      G.debug &= ~G_DEBUG_GPU_TIMINGS;
+      return;
+    }
+    printf("Writing GPU timings to: %s\n", filepath);
+    fprintf(DTP.trace_file, "[");
+    DTP.trace_is_empty = true;
+  }
+
+  for (int i = 0; i < DTP.timer_increment; i++) {
+    DRWTimer *timer = &DTP.timers[i];
+    if (timer->time_start == 0) {
+      continue;
+    }
+    /* Times are in microseconds. */
+    fprintf(DTP.trace_file,
+            "%s\n{\"name\": \"%s\", \"cat\": \"GPU\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, "
+            "\"ts\": %.3f, \"dur\": %.3f}",
+            DTP.trace_is_empty ? "" : ",",
+            timer->name,
+            (double)timer->time_start / 1000.0,
+            (double)timer->time_last / 1000.0);
+    DTP.trace_is_empty = false;
   }
+  fflush(DTP.trace_file);
 }
 
 void DRW_stats_reset(void)
@@ -167,40 +218,61 @@ void DRW_stats_reset(void)
              "You forgot a DRW_stats_group/query_start somewhere!");
 
   if (DTP.is_recording) {
-    GLuint64 lvl_time[MAX_NESTED_TIMER] = {0};
-
-    /* Swap queries for the next frame and sum up each lvl time. */
+    /* Swap queries for the next frame and read the results of the previous one. */
     for (int i = DTP.timer_increment - 1; i >= 0; i--) {
       DRWTimer *timer = &DTP.timers[i];
-      SWAP(GLuint, timer->query[0], timer->query[1]);
+      SWAP(GLuint, timer->query[0][0], timer->query[1][0]);
+      SWAP(GLuint, timer->query[0][1], timer->query[1][1]);
 
       BLI_assert(timer->lvl < MAX_NESTED_TIMER);
 
-      if (timer->is_query) {
-        GLuint64 time;
-        if (timer->query[0] != 0) {
-          glGetQueryObjectui64v(timer->query[0], GL_QUERY_RESULT, &time);
-        }
-        else {
-          time = 1000000000; /* 1ms default */
-        }
-
-        timer->time_average = timer->time_average * (1.0 - GPU_TIMER_FALLOFF) +
-                              time * GPU_TIMER_FALLOFF;
-        timer->time_average = MIN2(timer->time_average, 1000000000);
+      GLuint64 time;
+      if (timer->query[0][0] != 0) {
+        GLuint64 time_end;
+        glGetQueryObjectui64v(timer->query[0][0], GL_QUERY_RESULT, &timer->time_start);
+        glGetQueryObjectui64v(timer->query[0][1], GL_QUERY_RESULT, &time_end);
+        time = (time_end > timer->time_start) ? time_end - timer->time_start : 0;
       }
       else {
-        timer->time_average = lvl_time[timer->lvl + 1];
-        lvl_time[timer->lvl + 1] = 0;
+        timer->time_start = 0;
+        time = 1000000000; /* 1s default */
       }
+      timer->time_last = time;
 
-      lvl_time[timer->lvl] += timer->time_average;
+      timer->time_average = timer->time_average * (1.0 - GPU_TIMER_FALLOFF) +
+                            time * GPU_TIMER_FALLOFF;
+      timer->time_average = MIN2(timer->time_average, 1000000000);
+    }
+
+    if (G.debug & G_DEBUG_GPU_TIMINGS) {
+      drw_stats_trace_write();
+    }
+    else {
+      drw_stats_trace_close();
     }
 
     DTP.is_recording = false;
   }
 }
 
+/**
+ * Access the GPU timings of the previous redraw, only available when recording them
+ * (see #G_DEBUG_GPU_TIMINGS).
+ */
+int DRW_stats_timings_len(void)
+{
+  return (DTP.timers != NULL) ? DTP.timer_increment : 0;
+}
+
+void DRW_stats_timing_get(int index, const char **r_name, int *r_level, double *r_time_ms)
+{
+  BLI_assert(index >= 0 && index < DRW_stats_timings_len());
+  const DRWTimer *timer = &DTP.timers[index];
+  *r_name = timer->name;
+  *r_level = timer->lvl;
+  *r_time_ms = (double)timer->time_last / 1000000.0;
+}
+
 static void draw_stat_5row(const rcti *rect, int u, int v, const char *txt, const int size)
 {
   BLF_draw_default_ascii(rect->xmin + (1 + u * 5) * U.widget_unit,
@@ -63,18 +63,34 @@ typedef struct DRWDeferredShader {
   GPUMaterial *mat;
 } DRWDeferredShader;
 
-typedef struct DRWShaderCompiler {
-  ListBase queue;          /* DRWDeferredShader */
-  ListBase queue_conclude; /* DRWDeferredShader */
-  SpinLock list_lock;
+/* Maximum number of threads compiling shaders at the same time.
+ * Each of them needs its own GL context. */
+#define DRW_DEFERRED_SHADER_WORKERS_MAX 4
+
+typedef struct DRWShaderCompilerWorker {
+  struct DRWShaderCompiler *comp;
 
   DRWDeferredShader *mat_compiling;
   ThreadMutex compilation_lock;
 
   void *gl_context;
+} DRWShaderCompilerWorker;
+
+typedef struct DRWShaderCompiler {
+  ListBase queue;          /* DRWDeferredShader */
+  ListBase queue_conclude; /* DRWDeferredShader */
+  SpinLock list_lock;
+
+  DRWShaderCompilerWorker workers[DRW_DEFERRED_SHADER_WORKERS_MAX];
+  int workers_len;
   bool own_context;
 
   int shaders_done; /* To compute progress. */
+
+  /* Job status, only accessed while holding `list_lock`. */
+  short *stop;
+  short *do_update;
+  float *progress;
 } DRWShaderCompiler;
 
 static void drw_deferred_shader_free(DRWDeferredShader *dsh)
@@ -91,16 +107,11 @@ static void drw_deferred_shader_queue_free(ListBase *queue)
   }
 }
 
-static void drw_deferred_shader_compilation_exec(
-    void *custom_data,
-    /* Cannot be const, this function implements wm_jobs_start_callback.
-     * NOLINTNEXTLINE: readability-non-const-parameter. */
-    short *stop,
-    short *do_update,
-    float *progress)
+static void *drw_deferred_shader_compilation_worker(void *worker_v)
 {
-  DRWShaderCompiler *comp = (DRWShaderCompiler *)custom_data;
-  void *gl_context = comp->gl_context;
+  DRWShaderCompilerWorker *worker = (DRWShaderCompilerWorker *)worker_v;
+  DRWShaderCompiler *comp = worker->comp;
+  void *gl_context = worker->gl_context;
 
 #if TRUST_NO_ONE
   BLI_assert(gl_context != NULL);
@@ -111,7 +122,7 @@ static void drw_deferred_shader_compilation_exec(
   while (true) {
     BLI_spin_lock(&comp->list_lock);
 
-    if (*stop != 0) {
+    if (*comp->stop != 0) {
       /* We don't want user to be able to cancel the compilation
        * but wm can kill the task if we are closing blender. */
       BLI_spin_unlock(&comp->list_lock);
@@ -119,41 +130,75 @@ static void drw_deferred_shader_compilation_exec(
     }
 
     /* Pop tail because it will be less likely to lock the main thread
-     * if all GPUMaterials are to be freed (see DRW_deferred_shader_remove()). */
-    comp->mat_compiling = BLI_poptail(&comp->queue);
-    if (comp->mat_compiling == NULL) {
+     * if all GPUMaterials are to be freed (see DRW_deferred_shader_remove()).
+     * This also compiles the materials needed by the last redraw first
+     * (see drw_deferred_shader_priority_raise()). */
+    worker->mat_compiling = BLI_poptail(&comp->queue);
+    if (worker->mat_compiling == NULL) {
       /* No more Shader to compile. */
       BLI_spin_unlock(&comp->list_lock);
       break;
     }
 
-    comp->shaders_done++;
-    int total = BLI_listbase_count(&comp->queue) + comp->shaders_done;
-
-    BLI_mutex_lock(&comp->compilation_lock);
+    BLI_mutex_lock(&worker->compilation_lock);
     BLI_spin_unlock(&comp->list_lock);
 
     /* Do the compilation. */
-    GPU_material_compile(comp->mat_compiling->mat);
-
-    *progress = (float)comp->shaders_done / (float)total;
-    *do_update = true;
+    GPU_material_compile(worker->mat_compiling->mat);
 
     GPU_flush();
-    BLI_mutex_unlock(&comp->compilation_lock);
+    BLI_mutex_unlock(&worker->compilation_lock);
 
     BLI_spin_lock(&comp->list_lock);
-    if (GPU_material_status(comp->mat_compiling->mat) == GPU_MAT_QUEUED) {
-      BLI_addtail(&comp->queue_conclude, comp->mat_compiling);
+    comp->shaders_done++;
+    int total = BLI_listbase_count(&comp->queue) + comp->shaders_done;
+    *comp->progress = (float)comp->shaders_done / (float)total;
+    *comp->do_update = true;
+
+    if (GPU_material_status(worker->mat_compiling->mat) == GPU_MAT_QUEUED) {
+      BLI_addtail(&comp->queue_conclude, worker->mat_compiling);
     }
     else {
-      drw_deferred_shader_free(comp->mat_compiling);
+      drw_deferred_shader_free(worker->mat_compiling);
     }
-    comp->mat_compiling = NULL;
+    worker->mat_compiling = NULL;
     BLI_spin_unlock(&comp->list_lock);
   }
 
   WM_opengl_context_release(gl_context);
+
+  return NULL;
+}
+
+static void drw_deferred_shader_compilation_exec(
+    void *custom_data,
+    /* Cannot be const, this function implements wm_jobs_start_callback.
+     * NOLINTNEXTLINE: readability-non-const-parameter. */
+    short *stop,
+    short *do_update,
+    float *progress)
+{
+  DRWShaderCompiler *comp = (DRWShaderCompiler *)custom_data;
+
+  comp->stop = stop;
+  comp->do_update = do_update;
+  comp->progress = progress;
+
+  /* The job thread is the first worker, the others run in their own thread. */
+  ListBase threads;
+  if (comp->workers_len > 1) {
+    BLI_threadpool_init(
+        &threads, drw_deferred_shader_compilation_worker, comp->workers_len - 1);
+    for (int i = 1; i < comp->workers_len; i++) {
+      BLI_threadpool_insert(&threads, &comp->workers[i]);
+    }
+  }
+
+  drw_deferred_shader_compilation_worker(&comp->workers[0]);
+
+  if (comp->workers_len > 1) {
+    BLI_threadpool_end(&threads);
+  }
 }
 
 static void drw_deferred_shader_compilation_free(void *custom_data)
@@ -174,11 +219,14 @@ static void drw_deferred_shader_compilation_free(void *custom_data)
   }
 
   BLI_spin_end(&comp->list_lock);
-  BLI_mutex_end(&comp->compilation_lock);
 
-  if (comp->own_context) {
-    /* Only destroy if the job owns the context. */
-    WM_opengl_context_dispose(comp->gl_context);
+  for (int i = 0; i < comp->workers_len; i++) {
+    DRWShaderCompilerWorker *worker = &comp->workers[i];
+    BLI_mutex_end(&worker->compilation_lock);
+    if (comp->own_context) {
+      /* Only destroy if the job owns the contexts. */
+      WM_opengl_context_dispose(worker->gl_context);
+    }
   }
 
   MEM_freeN(comp);
@@ -217,15 +265,17 @@ static void drw_deferred_shader_add(GPUMaterial *mat, bool deferred)
 
   DRWShaderCompiler *comp = MEM_callocN(sizeof(DRWShaderCompiler), "DRWShaderCompiler");
   BLI_spin_init(&comp->list_lock);
-  BLI_mutex_init(&comp->compilation_lock);
 
   if (old_comp) {
     BLI_spin_lock(&old_comp->list_lock);
     BLI_movelisttolist(&comp->queue, &old_comp->queue);
     BLI_spin_unlock(&old_comp->list_lock);
-    /* Do not recreate context, just pass ownership. */
-    if (old_comp->gl_context) {
-      comp->gl_context = old_comp->gl_context;
+    /* Do not recreate contexts, just pass ownership. */
+    if (old_comp->workers_len > 0) {
+      for (int i = 0; i < old_comp->workers_len; i++) {
+        comp->workers[i].gl_context = old_comp->workers[i].gl_context;
+      }
+      comp->workers_len = old_comp->workers_len;
       old_comp->own_context = false;
       comp->own_context = true;
     }
@@ -233,13 +283,22 @@ static void drw_deferred_shader_add(GPUMaterial *mat, bool deferred)
 
   BLI_addtail(&comp->queue, dsh);
 
-  /* Create only one context. */
-  if (comp->gl_context == NULL) {
-    comp->gl_context = WM_opengl_context_create();
+  /* Create the contexts only once. */
+  if (comp->workers_len == 0) {
+    comp->workers_len = clamp_i(
+        BLI_system_thread_count() - 1, 1, DRW_DEFERRED_SHADER_WORKERS_MAX);
+    for (int i = 0; i < comp->workers_len; i++) {
+      comp->workers[i].gl_context = WM_opengl_context_create();
+    }
     WM_opengl_context_activate(DST.gl_context);
     comp->own_context = true;
   }
 
+  for (int i = 0; i < comp->workers_len; i++) {
+    comp->workers[i].comp = comp;
+    BLI_mutex_init(&comp->workers[i].compilation_lock);
+  }
+
   WM_jobs_customdata_set(wm_job, comp, drw_deferred_shader_compilation_free);
   WM_jobs_timer(wm_job, 0.1, NC_MATERIAL | ND_SHADING_DRAW, 0);
   WM_jobs_delay_start(wm_job, 0.1);
@@ -250,6 +309,42 @@ static void drw_deferred_shader_add(GPUMaterial *mat, bool deferred)
   WM_jobs_start(wm, wm_job);
 }
 
+/**
+ * Move a material waiting for compilation to the end of the queue, so it is compiled before the
+ * materials that are not used by the current redraw.
+ */
+static void drw_deferred_shader_priority_raise(GPUMaterial *mat)
+{
+  if (DST.draw_ctx.evil_C == NULL) {
+    return;
+  }
+
+  wmWindowManager *wm = CTX_wm_manager(DST.draw_ctx.evil_C);
+  wmWindow *win = CTX_wm_window(DST.draw_ctx.evil_C);
+  Scene *scene = (Scene *)DEG_get_original_id(&DST.draw_ctx.scene->id);
+
+  if (WM_jobs_test(wm, scene, WM_JOB_TYPE_SHADER_COMPILATION) == false) {
+    /* No job running, do not create a new one by calling WM_jobs_get. */
+    return;
+  }
+
+  wmJob *wm_job = WM_jobs_get(
+      wm, win, scene, "Shaders Compilation", WM_JOB_PROGRESS, WM_JOB_TYPE_SHADER_COMPILATION);
+  DRWShaderCompiler *comp = (DRWShaderCompiler *)WM_jobs_customdata_get(wm_job);
+  if (comp == NULL) {
+    return;
+  }
+
+  BLI_spin_lock(&comp->list_lock);
+  DRWDeferredShader *dsh = (DRWDeferredShader *)BLI_findptr(
+      &comp->queue, mat, offsetof(DRWDeferredShader, mat));
+  if (dsh && dsh != comp->queue.last) {
+    BLI_remlink(&comp->queue, dsh);
+    BLI_addtail(&comp->queue, dsh);
+  }
+  BLI_spin_unlock(&comp->list_lock);
+}
+
 void DRW_deferred_shader_remove(GPUMaterial *mat)
 {
   Scene *scene = GPU_material_scene(mat);
@@ -274,9 +369,12 @@ void DRW_deferred_shader_remove(GPUMaterial *mat)
         }
 
         /* Wait for compilation to finish */
-        if ((comp->mat_compiling != NULL) && (comp->mat_compiling->mat == mat)) {
-          BLI_mutex_lock(&comp->compilation_lock);
-          BLI_mutex_unlock(&comp->compilation_lock);
+        for (int i = 0; i < comp->workers_len; i++) {
+          DRWShaderCompilerWorker *worker = &comp->workers[i];
+          if ((worker->mat_compiling != NULL) && (worker->mat_compiling->mat == mat)) {
+            BLI_mutex_lock(&worker->compilation_lock);
+            BLI_mutex_unlock(&worker->compilation_lock);
+          }
         }
 
         BLI_spin_unlock(&comp->list_lock);
@@ -401,6 +499,9 @@ GPUMaterial *DRW_shader_find_from_world(World *wo,
       return NULL;
     }
   }
+  else if (mat != NULL && GPU_material_status(mat) == GPU_MAT_QUEUED) {
+    drw_deferred_shader_priority_raise(mat);
+  }
   return mat;
 }
 
@@ -417,6 +518,9 @@ GPUMaterial *DRW_shader_find_from_material(Material *ma,
       return NULL;
     }
   }
+  else if (mat != NULL && GPU_material_status(mat) == GPU_MAT_QUEUED) {
+    drw_deferred_shader_priority_raise(mat);
+  }
   return mat;
 }
 
@@ -0,0 +1,286 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup draw
+ *
+ * \brief Updates the positions and normals of deforming meshes on the GPU.
+ *
+ * When only the vertex coordinates of a mesh changed, the `pos_nor` buffer of its batch cache
+ * is rewritten by a transform feedback pass instead of being extracted again on the CPU. The pass
+ * gathers the new vertex positions and normals using a map from buffer elements to vertices that
+ * is created once.
+ *
+ * Meshes deformed by an armature are skinned by the same pass, from their undeformed vertices and
+ * the matrices of their vertex groups. This also rewrites the `lnor` buffer, which contains the
+ * vertex normals for such meshes.
+ *
+ * Meshes subdivided when drawing are evaluated the same way, from the positions of the coarse
+ * vertices and the limit stencils of the subdivided vertices.
+ */
+
+#include "DRW_render.h"
+
+#include "BLI_linklist.h"
+#include "BLI_utildefines.h"
+
+#include "GPU_shader.h"
+#include "GPU_vertex_buffer.h"
+
+#ifndef __APPLE__
+/* Transform feedback is not reliable on macOS, see T58489 and T60171.
+ * Deforming meshes are always extracted on the CPU there. */
+#  define USE_TRANSFORM_FEEDBACK
+#endif
+
+typedef enum eMeshDeformShader {
+  MESH_DEFORM_SH_POS_NOR = 0,
+  MESH_DEFORM_SH_SKIN_POS_NOR,
+  MESH_DEFORM_SH_SKIN_NOR,
+  MESH_DEFORM_SH_SUBDIV_POS_NOR,
+  MESH_DEFORM_SH_SUBDIV_NOR,
+
+  MESH_DEFORM_SH_LEN,
+} eMeshDeformShader;
+
+static GPUShader *g_deform_shaders[MESH_DEFORM_SH_LEN] = {NULL};
+/* Only valid between #DRW_mesh_deform_init and #DRW_mesh_deform_update. */
+static DRWPass *g_tf_pass = NULL;
+/* Buffers written by the pass, they may not be uploaded yet when just extracted. */
+static LinkNode *g_tf_targets = NULL;
+
+extern char datatoc_common_mesh_deform_vert_glsl[];
+
+#ifdef USE_TRANSFORM_FEEDBACK
+static GPUShader *mesh_deform_shader_get(eMeshDeformShader sh_type)
+{
+  if (g_deform_shaders[sh_type] == NULL) {
+    const char *var_names[2] = {"finalPos", "finalNor"};
+    switch (sh_type) {
+      case MESH_DEFORM_SH_POS_NOR:
+        g_deform_shaders[sh_type] = DRW_shader_create_with_transform_feedback(
+            datatoc_common_mesh_deform_vert_glsl, NULL, NULL, GPU_SHADER_TFB_POINTS, var_names, 2);
+        break;
+      case MESH_DEFORM_SH_SKIN_POS_NOR:
+        g_deform_shaders[sh_type] = DRW_shader_create_with_transform_feedback(
+            datatoc_common_mesh_deform_vert_glsl,
+            NULL,
+            "#define USE_SKINNING\n",
+            GPU_SHADER_TFB_POINTS,
+            var_names,
+            2);
+        break;
+      case MESH_DEFORM_SH_SKIN_NOR:
+        g_deform_shaders[sh_type] = DRW_shader_create_with_transform_feedback(
+            datatoc_common_mesh_deform_vert_glsl,
+            NULL,
+            "#define USE_SKINNING\n"
+            "#define USE_NORMAL_ONLY\n",
+            GPU_SHADER_TFB_POINTS,
+            &var_names[1],
+            1);
+        break;
+      case MESH_DEFORM_SH_SUBDIV_POS_NOR:
+        g_deform_shaders[sh_type] = DRW_shader_create_with_transform_feedback(
+            datatoc_common_mesh_deform_vert_glsl,
+            NULL,
+            "#define USE_LIMIT_STENCILS\n",
+            GPU_SHADER_TFB_POINTS,
+            var_names,
+            2);
+        break;
+      case MESH_DEFORM_SH_SUBDIV_NOR:
+        g_deform_shaders[sh_type] = DRW_shader_create_with_transform_feedback(
+            datatoc_common_mesh_deform_vert_glsl,
+            NULL,
+            "#define USE_LIMIT_STENCILS\n"
+            "#define USE_NORMAL_ONLY\n",
+            GPU_SHADER_TFB_POINTS,
+            &var_names[1],
+            1);
+        break;
+      case MESH_DEFORM_SH_LEN:
+        BLI_assert(0);
+        break;
+    }
+  }
+  return g_deform_shaders[sh_type];
+}
+
+static DRWShadingGroup *mesh_deform_shgroup_create(eMeshDeformShader sh_type,
+                                                   GPUVertBuf *target,
+                                                   GPUTexture *elem_map_tx,
+                                                   GPUTexture *vert_co_tx,
+                                                   GPUTexture *vert_no_tx)
+{
+  DRWShadingGroup *tf_shgrp = DRW_shgroup_transform_feedback_create(
+      mesh_deform_shader_get(sh_type), g_tf_pass, target);
+  DRW_shgroup_uniform_texture(tf_shgrp, "elemMapBuffer", elem_map_tx);
+  DRW_shgroup_uniform_texture(tf_shgrp, "vertCoBuffer", vert_co_tx);
+  if (vert_no_tx) {
+    DRW_shgroup_uniform_texture(tf_shgrp, "vertNorBuffer", vert_no_tx);
+  }
+  BLI_linklist_prepend(&g_tf_targets, target);
+  return tf_shgrp;
+}
+#endif
+
+void DRW_mesh_deform_init(void)
+{
+  BLI_linklist_free(g_tf_targets, NULL);
+  g_tf_targets = NULL;
+#ifdef USE_TRANSFORM_FEEDBACK
+  g_tf_pass = DRW_pass_create("Update Mesh Deform Pass", 0);
+#else
+  g_tf_pass = NULL;
+#endif
+}
+
+/**
+ * Add a transform feedback call writing the deformed positions and normals to \a pos_nor.
+ * The textures are created from the vertex buffers of #MeshBatchCache.deform and must stay
+ * valid until #DRW_mesh_deform_update.
+ *
+ * \return false when the update cannot be done on the GPU. The buffer then has to be extracted
+ * on the CPU as usual.
+ */
+bool DRW_mesh_deform_pos_nor_add(GPUVertBuf *pos_nor,
+                                 GPUTexture *elem_map_tx,
+                                 GPUTexture *vert_co_tx,
+                                 GPUTexture *vert_no_tx)
+{
+#ifdef USE_TRANSFORM_FEEDBACK
+  if (g_tf_pass == NULL) {
+    return false;
+  }
+
+  DRWShadingGroup *tf_shgrp = mesh_deform_shgroup_create(
+      MESH_DEFORM_SH_POS_NOR, pos_nor, elem_map_tx, vert_co_tx, vert_no_tx);
+  DRW_shgroup_call_procedural_points(tf_shgrp, NULL, pos_nor->vertex_len);
+  return true;
+#else
+  UNUSED_VARS(pos_nor, elem_map_tx, vert_co_tx, vert_no_tx);
+  return false;
+#endif
+}
+
+/**
+ * Add a transform feedback call writing the positions and normals of the vertices deformed by
+ * an armature to \a target, which is either a `pos_nor` or a `lnor` buffer (\a normal_only).
+ * The vertex coordinates and normals are the undeformed ones, the other textures are created
+ * from the skinning buffers of #MeshBatchCache.deform.
+ *
+ * Unlike #DRW_mesh_deform_pos_nor_add, \a target can be just extracted and not uploaded yet.
+ */
+bool DRW_mesh_deform_skin_add(GPUVertBuf *target,
+                              const bool normal_only,
+                              GPUTexture *elem_map_tx,
+                              GPUTexture *vert_co_tx,
+                              GPUTexture *vert_no_tx,
+                              GPUTexture *skin_groups_tx,
+                              GPUTexture *skin_weights_tx,
+                              GPUTexture *skin_mats_tx)
+{
+#ifdef USE_TRANSFORM_FEEDBACK
+  if (g_tf_pass == NULL) {
+    return false;
+  }
+
+  DRWShadingGroup *tf_shgrp = mesh_deform_shgroup_create(
+      normal_only ? MESH_DEFORM_SH_SKIN_NOR : MESH_DEFORM_SH_SKIN_POS_NOR,
+      target,
+      elem_map_tx,
+      vert_co_tx,
+      vert_no_tx);
+  DRW_shgroup_uniform_texture(tf_shgrp, "skinGroupBuffer", skin_groups_tx);
+  DRW_shgroup_uniform_texture(tf_shgrp, "skinWeightBuffer", skin_weights_tx);
+  DRW_shgroup_uniform_texture(tf_shgrp, "skinMatBuffer", skin_mats_tx);
+  DRW_shgroup_call_procedural_points(tf_shgrp, NULL, target->vertex_len);
+  return true;
+#else
+  UNUSED_VARS(target, normal_only, elem_map_tx, vert_co_tx, vert_no_tx);
+  UNUSED_VARS(skin_groups_tx, skin_weights_tx, skin_mats_tx);
+  return false;
+#endif
+}
+
+/**
+ * Add a transform feedback call writing the positions and normals of the vertices of a mesh
+ * subdivided when drawing to \a target, which is either a `pos_nor` or a `lnor` buffer
+ * (\a normal_only). The vertex coordinates are the ones of the coarse vertices, the other
+ * textures are created from the stencil buffers of #MeshBatchCache.deform.
+ *
+ * Like #DRW_mesh_deform_skin_add, \a target can be just extracted and not uploaded yet.
+ */
+bool DRW_mesh_deform_subdiv_add(GPUVertBuf *target,
+                                const bool normal_only,
+                                GPUTexture *elem_map_tx,
+                                GPUTexture *vert_co_tx,
+                                GPUTexture *stencil_offsets_tx,
+                                GPUTexture *stencil_indices_tx,
+                                GPUTexture *stencil_weights_tx)
+{
+#ifdef USE_TRANSFORM_FEEDBACK
+  if (g_tf_pass == NULL) {
+    return false;
+  }
+
+  DRWShadingGroup *tf_shgrp = mesh_deform_shgroup_create(
+      normal_only ? MESH_DEFORM_SH_SUBDIV_NOR : MESH_DEFORM_SH_SUBDIV_POS_NOR,
+      target,
+      elem_map_tx,
+      vert_co_tx,
+      NULL);
+  DRW_shgroup_uniform_texture(tf_shgrp, "stencilOffsetBuffer", stencil_offsets_tx);
+  DRW_shgroup_uniform_texture(tf_shgrp, "stencilIndexBuffer", stencil_indices_tx);
+  DRW_shgroup_uniform_texture(tf_shgrp, "stencilWeightBuffer", stencil_weights_tx);
+  DRW_shgroup_call_procedural_points(tf_shgrp, NULL, target->vertex_len);
+  return true;
+#else
+  UNUSED_VARS(target, normal_only, elem_map_tx, vert_co_tx);
+  UNUSED_VARS(stencil_offsets_tx, stencil_indices_tx, stencil_weights_tx);
+  return false;
+#endif
+}
+
+void DRW_mesh_deform_update(void)
+{
+  if (g_tf_pass == NULL) {
+    return;
+  }
+  /* Make sure all targets have a buffer object to write to. */
+  for (LinkNode *link = g_tf_targets; link; link = link->next) {
+    GPU_vertbuf_use(link->link);
+  }
+  BLI_linklist_free(g_tf_targets, NULL);
+  g_tf_targets = NULL;
+
+  DRW_draw_pass(g_tf_pass);
+  /* The pass is freed with the rest of the frame data. */
+  g_tf_pass = NULL;
+}
+
+void DRW_mesh_deform_free(void)
+{
+  for (int i = 0; i < MESH_DEFORM_SH_LEN; i++) {
+    DRW_SHADER_FREE_SAFE(g_deform_shaders[i]);
+  }
+  BLI_linklist_free(g_tf_targets, NULL);
+  g_tf_targets = NULL;
+}
@@ -527,6 +527,14 @@ void DRW_select_buffer_context_create(Base **bases, const uint bases_len, short
 {
   struct SELECTID_Context *select_ctx = DRW_select_engine_context_get();
 
+  /* Keep the drawn indices when the context doesn't change (e.g. between two box selections),
+   * the engine still redraws on view, transform or geometry changes. */
+  bool is_same_context = (select_mode != -1) && (select_ctx->select_mode == select_mode) &&
+                         (select_ctx->objects_len == bases_len);
+  for (uint base_index = 0; is_same_context && (base_index < bases_len); base_index++) {
+    is_same_context = (select_ctx->objects[base_index] == bases[base_index]->object);
+  }
+
   select_ctx->objects = MEM_reallocN(select_ctx->objects,
                                      sizeof(*select_ctx->objects) * bases_len);
 
@@ -544,6 +552,10 @@ void DRW_select_buffer_context_create(Base **bases, const uint bases_len, short
     obj->runtime.select_id = base_index;
   }
 
+  if (is_same_context) {
+    return;
+  }
+
   select_ctx->objects_len = bases_len;
   select_ctx->select_mode = select_mode;
   memset(select_ctx->persmat, 0, sizeof(select_ctx->persmat));
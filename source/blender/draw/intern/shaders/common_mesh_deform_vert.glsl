@@ -0,0 +1,126 @@
+
+/* Gather the deformed position and normal of every element of a mesh `pos_nor` vertex buffer.
+ * Only used with transform feedback, the output matches the `PosNorLoop` layout.
+ *
+ * USE_NORMAL_ONLY: Output only the normal, matching the `lnor` vertex buffer.
+ * USE_SKINNING: Deform the positions and normals by the vertex groups of an armature.
+ * USE_LIMIT_STENCILS: Evaluate the positions and normals of subdivided vertices from the
+ *                     positions of the coarse vertices. */
+
+uniform samplerBuffer vertCoBuffer;   /* RGBA32F, xyz: vertex position. */
+uniform isamplerBuffer elemMapBuffer; /* RG32I, x: vertex index, y: paint overlay flag. */
+
+#ifdef USE_LIMIT_STENCILS
+/* The vertex positions are the ones of the coarse vertices. */
+uniform isamplerBuffer stencilOffsetBuffer; /* RG32I, first stencil element and their number. */
+uniform isamplerBuffer stencilIndexBuffer;  /* R32I, coarse vertex of every stencil element. */
+uniform samplerBuffer stencilWeightBuffer;  /* RGBA32F, xyz: weight and its derivatives. */
+#else
+uniform isamplerBuffer vertNorBuffer; /* R32I, vertex normal packed as 10_10_10_2. */
+#endif
+
+#ifdef USE_SKINNING
+uniform isamplerBuffer skinGroupBuffer; /* RGBA32I, up to 4 vertex groups, -1 when unused. */
+uniform samplerBuffer skinWeightBuffer; /* RGBA32F, weight of each vertex group. */
+uniform samplerBuffer skinMatBuffer;    /* RGBA32F, 4 columns per vertex group matrix. */
+#endif
+
+#ifndef USE_NORMAL_ONLY
+out vec3 finalPos;
+#endif
+flat out int finalNor;
+
+#ifdef USE_SKINNING
+/* Average of the vertex group matrices, false when the vertex has no weight and stays in place
+ * like on the CPU. */
+bool skin_matrix_get(int v, out mat4 r_mat)
+{
+  ivec4 groups = texelFetch(skinGroupBuffer, v);
+  vec4 weights = texelFetch(skinWeightBuffer, v);
+  float contrib = 0.0;
+
+  r_mat = mat4(0.0);
+  for (int i = 0; i < 4; i++) {
+    if (groups[i] < 0) {
+      continue;
+    }
+    int col = groups[i] * 4;
+    r_mat += weights[i] * mat4(texelFetch(skinMatBuffer, col),
+                               texelFetch(skinMatBuffer, col + 1),
+                               texelFetch(skinMatBuffer, col + 2),
+                               texelFetch(skinMatBuffer, col + 3));
+    contrib += weights[i];
+  }
+
+  if (contrib <= 0.0001) {
+    return false;
+  }
+  r_mat *= 1.0 / contrib;
+  return true;
+}
+#endif
+
+#ifdef USE_LIMIT_STENCILS
+/* Limit position and normal of the subdivided vertex \a v. */
+void stencil_eval(int v, out vec3 r_pos, out vec3 r_nor)
+{
+  ivec2 stencil = texelFetch(stencilOffsetBuffer, v).xy;
+  vec3 du = vec3(0.0);
+  vec3 dv = vec3(0.0);
+
+  r_pos = vec3(0.0);
+  for (int i = stencil.x; i < stencil.x + stencil.y; i++) {
+    vec3 co = texelFetch(vertCoBuffer, texelFetch(stencilIndexBuffer, i).x).xyz;
+    vec3 weights = texelFetch(stencilWeightBuffer, i).xyz;
+    r_pos += weights.x * co;
+    du += weights.y * co;
+    dv += weights.z * co;
+  }
+
+  r_nor = cross(du, dv);
+  float len = length(r_nor);
+  /* Degenerate derivatives give no normal, like #normalize_v3 on the CPU. */
+  r_nor = (len > 1e-35) ? r_nor / len : vec3(0.0);
+}
+#endif
+
+vec3 normal_unpack(int packed_nor)
+{
+  /* Sign extend the 10 bits components. */
+  return vec3((ivec3(packed_nor) << ivec3(22, 12, 2)) >> 22) / 511.0;
+}
+
+int normal_pack(vec3 nor)
+{
+  ivec3 n = ivec3(round(clamp(nor, -1.0, 1.0) * 511.0)) & 0x3FF;
+  return n.x | (n.y << 10) | (n.z << 20);
+}
+
+void main(void)
+{
+  ivec2 elem = texelFetch(elemMapBuffer, gl_VertexID).xy;
+
+#ifdef USE_LIMIT_STENCILS
+  vec3 pos, limit_nor;
+  stencil_eval(elem.x, pos, limit_nor);
+  int nor = normal_pack(limit_nor);
+#else
+  vec3 pos = texelFetch(vertCoBuffer, elem.x).xyz;
+  int nor = texelFetch(vertNorBuffer, elem.x).x;
+#endif
+
+#ifdef USE_SKINNING
+  mat4 skin_mat;
+  if (skin_matrix_get(elem.x, skin_mat)) {
+    pos = (skin_mat * vec4(pos, 1.0)).xyz;
+    /* Not the inverse transpose, normals are approximate with non uniform scale. */
+    nor = normal_pack(normalize(mat3(skin_mat) * normal_unpack(nor)));
+  }
+#endif
+
+#ifndef USE_NORMAL_ONLY
+  finalPos = pos;
+#endif
+  /* Replace the 2 bits of the w component by the flag of the element. */
+  finalNor = (nor & 0x3FFFFFFF) | ((elem.y & 0x3) << 30);
+}
@@ -147,7 +147,8 @@ void ED_draw_imbuf_clipping(struct ImBuf *ibuf,
                             float clip_max_x,
                             float clip_max_y,
                             float zoom_x,
-                            float zoom_y);
+                            float zoom_y,
+                            bool use_cached_texture);
 
 void ED_draw_imbuf_ctx(const struct bContext *C,
                        struct ImBuf *ibuf,
@@ -166,7 +167,8 @@ void ED_draw_imbuf_ctx_clipping(const struct bContext *C,
                                 float clip_max_x,
                                 float clip_max_y,
                                 float zoom_x,
-                                float zoom_y);
+                                float zoom_y,
+                                bool use_cached_texture);
 
 int ED_draw_imbuf_method(struct ImBuf *ibuf);
 
@@ -60,7 +60,7 @@ void ED_spacetype_topbar(void);
 /* calls for instancing and freeing spacetype static data
  * called in WM_init_exit */
 /* in space_file.c */
-void ED_file_init(void);
+void ED_file_init(const bool read_bookmarks);
 void ED_file_exit(void);
 
 #define REGION_DRAW_POST_VIEW 0
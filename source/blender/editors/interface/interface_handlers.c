@@ -8198,8 +8198,14 @@ static void button_activate_exit(
     WM_cursor_modal_restore(data->window);
   }
 
-  /* redraw and refresh (for popups) */
-  ED_region_tag_redraw_no_rebuild(data->region);
+  /* redraw and refresh (for popups), a value may have been applied so the layout has to be
+   * rebuilt then, highlight changes only need the existing blocks redrawn */
+  if (!onfree && !data->cancel) {
+    ED_region_tag_redraw(data->region);
+  }
+  else {
+    ED_region_tag_redraw_no_rebuild(data->region);
+  }
   ED_region_tag_refresh_ui(data->region);
 
   /* clean up button */
@@ -38,6 +38,8 @@
 #endif
 
 #include "io_cache.h"
+#include "io_obj.h"
+#include "io_stl.h"
 
 void ED_operatortypes_io(void)
 {
@@ -52,8 +54,12 @@ void ED_operatortypes_io(void)
 #endif
 #ifdef WITH_USD
   WM_operatortype_append(WM_OT_usd_export);
+  WM_operatortype_append(WM_OT_usd_import);
 #endif
 
+  WM_operatortype_append(WM_OT_obj_export);
+  WM_operatortype_append(WM_OT_stl_import);
+
   WM_operatortype_append(CACHEFILE_OT_open);
   WM_operatortype_append(CACHEFILE_OT_reload);
 }
@@ -22,6 +22,7 @@
  */
 
 #ifdef WITH_USD
+#  include "DNA_object_types.h"
 #  include "DNA_space_types.h"
 
 #  include "BKE_context.h"
@@ -39,6 +40,8 @@
 #  include "RNA_access.h"
 #  include "RNA_define.h"
 
+#  include "ED_object.h"
+
 #  include "UI_interface.h"
 #  include "UI_resources.h"
 
@@ -232,4 +235,105 @@ void WM_OT_usd_export(struct wmOperatorType *ot)
                "are different settings for viewport and rendering");
 }
 
+/* ====== USD Import ====== */
+
+static int wm_usd_import_invoke(bContext *C, wmOperator *op, const wmEvent *event)
+{
+  eUSDOperatorOptions *options = MEM_callocN(sizeof(eUSDOperatorOptions), "eUSDOperatorOptions");
+  options->as_background_job = true;
+  op->customdata = options;
+
+  return WM_operator_filesel(C, op, event);
+}
+
+static int wm_usd_import_exec(bContext *C, wmOperator *op)
+{
+  if (!RNA_struct_property_is_set(op->ptr, "filepath")) {
+    BKE_report(op->reports, RPT_ERROR, "No filename given");
+    return OPERATOR_CANCELLED;
+  }
+
+  char filename[FILE_MAX];
+  RNA_string_get(op->ptr, "filepath", filename);
+
+  eUSDOperatorOptions *options = (eUSDOperatorOptions *)op->customdata;
+  const bool as_background_job = (options != NULL && options->as_background_job);
+  MEM_SAFE_FREE(op->customdata);
+
+  struct USDImportParams params = {
+      RNA_float_get(op->ptr, "scale"),
+      RNA_boolean_get(op->ptr, "import_uvmaps"),
+      RNA_boolean_get(op->ptr, "load_payloads"),
+  };
+
+  /* Switch out of edit mode to avoid being stuck in it (T54326). */
+  Object *obedit = CTX_data_edit_object(C);
+  if (obedit) {
+    ED_object_mode_set(C, OB_MODE_OBJECT);
+  }
+
+  bool ok = USD_import(C, filename, &params, as_background_job);
+
+  return as_background_job || ok ? OPERATOR_FINISHED : OPERATOR_CANCELLED;
+}
+
+static void wm_usd_import_draw(bContext *UNUSED(C), wmOperator *op)
+{
+  uiLayout *layout = op->layout;
+  struct PointerRNA *ptr = op->ptr;
+
+  uiLayoutSetPropSep(layout, true);
+
+  uiLayout *box = uiLayoutBox(layout);
+  uiLayout *col = uiLayoutColumn(box, true);
+  uiItemR(col, ptr, "scale", 0, NULL, ICON_NONE);
+  uiItemR(col, ptr, "import_uvmaps", 0, NULL, ICON_NONE);
+  uiItemR(col, ptr, "load_payloads", 0, NULL, ICON_NONE);
+}
+
+void WM_OT_usd_import(struct wmOperatorType *ot)
+{
+  ot->name = "Import USD";
+  ot->description = "Import a USD file";
+  ot->idname = "WM_OT_usd_import";
+
+  ot->invoke = wm_usd_import_invoke;
+  ot->exec = wm_usd_import_exec;
+  ot->poll = WM_operator_winactive;
+  ot->ui = wm_usd_import_draw;
+  ot->flag = OPTYPE_REGISTER | OPTYPE_UNDO;
+
+  WM_operator_properties_filesel(ot,
+                                 FILE_TYPE_FOLDER | FILE_TYPE_USD,
+                                 FILE_BLENDER,
+                                 FILE_OPENFILE,
+                                 WM_FILESEL_FILEPATH | WM_FILESEL_SHOW_PROPS,
+                                 FILE_DEFAULTDISPLAY,
+                                 FILE_SORT_ALPHA);
+
+  RNA_def_float(ot->srna,
+                "scale",
+                1.0f,
+                0.0001f,
+                1000.0f,
+                "Scale",
+                "Value by which to enlarge or shrink the objects with respect to the world's "
+                "origin",
+                0.0001f,
+                1000.0f);
+
+  RNA_def_boolean(ot->srna,
+                  "import_uvmaps",
+                  true,
+                  "UV Maps",
+                  "When checked, texture coordinate primvars of meshes are imported as UV maps");
+
+  RNA_def_boolean(ot->srna,
+                  "load_payloads",
+                  true,
+                  "Load Payloads",
+                  "When unchecked, payloads are not loaded and the prims holding them are "
+                  "imported as empties, which makes importing the hierarchy of large stages fast");
+}
+
 #endif /* WITH_USD */
@@ -2499,6 +2499,24 @@ static void ed_panel_draw(const bContext *C,
   UI_panel_end(area, region, block, w, h, open);
 }
 
+/**
+ * Redraws tagged with #ED_region_tag_redraw_no_rebuild (button highlighting, scrolling) don't
+ * change any data the layout depends on, so the blocks of the previous layout can be drawn again.
+ * Only their window matrices need updating, which #ED_region_panels_draw takes care of.
+ */
+static bool region_panels_layout_is_reusable(const ARegion *region)
+{
+  if (!(region->do_draw & RGN_DRAW_NO_REBUILD) || (region->do_draw & RGN_DRAW)) {
+    return false;
+  }
+  if (BLI_listbase_is_empty(&region->uiblocks)) {
+    return false;
+  }
+  /* Panel widths follow the region size. */
+  return (region->runtime.layout_winx == region->winx) &&
+         (region->runtime.layout_winy == region->winy);
+}
+
 /**
  * \param contexts: A NULL terminated array of context strings to match against.
  * Matching against any of these strings will draw the panel.
@@ -2512,6 +2530,11 @@ void ED_region_panels_layout_ex(const bContext *C,
                                 const bool vertical,
                                 const char *category_override)
 {
+  /* Keeps #ARegion_Runtime.category from the previous layout too. */
+  if (region_panels_layout_is_reusable(region)) {
+    return;
+  }
+
   /* collect panels to draw */
   WorkSpace *workspace = CTX_wm_workspace(C);
   LinkNode *panel_types_stack = NULL;
@@ -2744,6 +2767,9 @@ void ED_region_panels_layout_ex(const bContext *C,
   if (use_category_tabs) {
     region->runtime.category = category;
   }
+
+  region->runtime.layout_winx = region->winx;
+  region->runtime.layout_winy = region->winy;
 }
 
 void ED_region_panels_layout(const bContext *C, ARegion *region)
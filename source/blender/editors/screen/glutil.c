@@ -35,6 +35,7 @@
 #include "BIF_glutil.h"
 
 #include "IMB_colormanagement.h"
+#include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
 #include "GPU_immediate.h"
@@ -361,7 +362,40 @@ void immDrawPixelsTex_clipping(IMMDrawPixelsTexState *state,
 
 /* **** Color management helper functions for GLSL display/transform ***** */
 
-/* Draw given image buffer on a screen using GLSL for display transform */
+/* Draw a texture with the whole image, with the currently bound shader */
+static void draw_imbuf_texture(IMMDrawPixelsTexState *state,
+                               GPUTexture *tex,
+                               float x,
+                               float y,
+                               int img_w,
+                               int img_h,
+                               bool use_filter,
+                               float zoom_x,
+                               float zoom_y)
+{
+  GPU_texture_filter_mode(tex, use_filter);
+  GPU_texture_bind(tex, 0);
+
+  immBegin(GPU_PRIM_TRI_FAN, 4);
+  immAttr2f(state->texco, 0.0f, 0.0f);
+  immVertex2f(state->pos, x, y);
+
+  immAttr2f(state->texco, 1.0f, 0.0f);
+  immVertex2f(state->pos, x + img_w * zoom_x, y);
+
+  immAttr2f(state->texco, 1.0f, 1.0f);
+  immVertex2f(state->pos, x + img_w * zoom_x, y + img_h * zoom_y);
+
+  immAttr2f(state->texco, 0.0f, 1.0f);
+  immVertex2f(state->pos, x, y + img_h * zoom_y);
+  immEnd();
+
+  GPU_texture_unbind(tex);
+}
+
+/* Draw given image buffer on a screen using GLSL for display transform.
+ * With use_cached_texture the pixels are uploaded once and kept with the image buffer,
+ * only for buffers of which all changes are tagged for the display buffers. */
 void ED_draw_imbuf_clipping(ImBuf *ibuf,
                             float x,
                             float y,
@@ -373,7 +407,8 @@ void ED_draw_imbuf_clipping(ImBuf *ibuf,
                             float clip_max_x,
                             float clip_max_y,
                             float zoom_x,
-                            float zoom_y)
+                            float zoom_y,
+                            bool use_cached_texture)
 {
   bool force_fallback = false;
   bool need_fallback = true;
@@ -386,8 +421,11 @@ void ED_draw_imbuf_clipping(ImBuf *ibuf,
   /* Single channel images could not be transformed using GLSL yet */
   force_fallback |= ibuf->channels == 1;
 
-  /* If user decided not to use GLSL, fallback to glaDrawPixelsAuto */
-  force_fallback |= (ED_draw_imbuf_method(ibuf) != IMAGE_DRAW_METHOD_GLSL);
+  /* If user decided not to use GLSL, fallback to glaDrawPixelsAuto.
+   * Automatic choice is only needed to avoid uploading large images on every redraw. */
+  if (!(use_cached_texture && U.image_draw_method == IMAGE_DRAW_METHOD_AUTO)) {
+    force_fallback |= (ED_draw_imbuf_method(ibuf) != IMAGE_DRAW_METHOD_GLSL);
+  }
 
   /* Try to draw buffer using GLSL display transform */
   if (force_fallback == false) {
@@ -414,7 +452,12 @@ void ED_draw_imbuf_clipping(ImBuf *ibuf,
     }
 
     if (ok) {
-      if (ibuf->rect_float) {
+      GPUTexture *tex = (use_cached_texture) ? IMB_draw_gpu_texture_ensure(ibuf) : NULL;
+
+      if (tex) {
+        draw_imbuf_texture(&state, tex, x, y, ibuf->x, ibuf->y, use_filter, zoom_x, zoom_y);
+      }
+      else if (ibuf->rect_float) {
         eGPUTextureFormat format = 0;
 
         if (ibuf->channels == 3) {
@@ -521,7 +564,8 @@ void ED_draw_imbuf(ImBuf *ibuf,
                          0.0f,
                          0.0f,
                          zoom_x,
-                         zoom_y);
+                         zoom_y,
+                         false);
 }
 
 void ED_draw_imbuf_ctx_clipping(const bContext *C,
@@ -534,7 +578,8 @@ void ED_draw_imbuf_ctx_clipping(const bContext *C,
                                 float clip_max_x,
                                 float clip_max_y,
                                 float zoom_x,
-                                float zoom_y)
+                                float zoom_y,
+                                bool use_cached_texture)
 {
   ColorManagedViewSettings *view_settings;
   ColorManagedDisplaySettings *display_settings;
@@ -552,13 +597,15 @@ void ED_draw_imbuf_ctx_clipping(const bContext *C,
                          clip_max_x,
                          clip_max_y,
                          zoom_x,
-                         zoom_y);
+                         zoom_y,
+                         use_cached_texture);
 }
 
 void ED_draw_imbuf_ctx(
     const bContext *C, ImBuf *ibuf, float x, float y, bool use_filter, float zoom_x, float zoom_y)
 {
-  ED_draw_imbuf_ctx_clipping(C, ibuf, x, y, use_filter, 0.0f, 0.0f, 0.0f, 0.0f, zoom_x, zoom_y);
+  ED_draw_imbuf_ctx_clipping(
+      C, ibuf, x, y, use_filter, 0.0f, 0.0f, 0.0f, 0.0f, zoom_x, zoom_y, false);
 }
 
 int ED_draw_imbuf_method(ImBuf *ibuf)
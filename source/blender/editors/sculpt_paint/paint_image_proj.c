@@ -4710,16 +4710,29 @@ static bool project_image_refresh_tagged(ProjPaintState *ps)
 
   for (a = 0, projIma = ps->projImages; a < ps->image_tot; a++, projIma++) {
     if (projIma->touch) {
-      /* look over each bound cell */
-      for (i = 0; i < PROJ_BOUNDBOX_SQUARED; i++) {
-        pr = &(projIma->partRedrawRect[i]);
-        if (pr->x2 != -1) { /* TODO - use 'enabled' ? */
-          set_imapaintpartial(pr);
-          imapaint_image_update(NULL, projIma->ima, projIma->ibuf, &projIma->iuser, true);
-          redraw = 1;
+      /* Look over each bound cell, touched cells next to each other in a row are merged
+       * so they are updated with a single texture upload. */
+      for (int y = 0; y < PROJ_BOUNDBOX_DIV; y++) {
+        ImagePaintPartialRedraw pr_row;
+        partial_redraw_single_init(&pr_row);
+
+        for (int x = 0; x < PROJ_BOUNDBOX_DIV; x++) {
+          pr = &projIma->partRedrawRect[x + y * PROJ_BOUNDBOX_DIV];
+          const bool is_touched = (pr->x2 != -1); /* TODO - use 'enabled' ? */
+          if (is_touched) {
+            partial_redraw_array_merge(&pr_row, pr, 1);
+          }
+          if ((!is_touched || x == PROJ_BOUNDBOX_DIV - 1) && pr_row.x2 != -1) {
+            set_imapaintpartial(&pr_row);
+            imapaint_image_update(NULL, projIma->ima, projIma->ibuf, &projIma->iuser, true);
+            partial_redraw_single_init(&pr_row);
+            redraw = 1;
+          }
         }
+      }
 
-        partial_redraw_single_init(pr);
+      for (i = 0; i < PROJ_BOUNDBOX_SQUARED; i++) {
+        partial_redraw_single_init(&projIma->partRedrawRect[i]);
       }
 
       /* clear for reuse */
@@ -5731,9 +5744,9 @@ static void paint_proj_stroke_ps(const bContext *UNUSED(C),
     }
   }
 
+  /* Image updates are accumulated and done on redraw, see #paint_proj_redraw. */
   if (project_paint_op(ps, prev_pos, pos)) {
     ps_handle->need_redraw = true;
-    project_image_refresh_tagged(ps);
   }
 }
 
@@ -5992,6 +6005,12 @@ void paint_proj_redraw(const bContext *C, void *ps_handle_p, bool final)
 
   if (ps_handle->need_redraw) {
     ps_handle->need_redraw = false;
+
+    /* Update the images once for all dabs painted since the last redraw,
+     * instead of after every dab. */
+    for (int i = 0; i < ps_handle->ps_views_tot; i++) {
+      project_image_refresh_tagged(ps_handle->ps_views[i]);
+    }
   }
   else if (!final) {
     return;
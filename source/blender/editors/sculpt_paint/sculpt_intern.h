@@ -536,6 +536,10 @@ typedef struct SculptUndoNode {
   /* Sculpt Face Sets */
   int *face_sets;
 
+  /* co, orig_co, mask and col of a finished stroke, compressed in the background. The arrays
+   * themselves are NULL while this is set, see sculpt_undo.c. */
+  struct SculptUndoCompressed *compressed;
+
   size_t undo_size;
 } SculptUndoNode;
 
@@ -27,6 +27,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_ghash.h"
+#include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_string.h"
@@ -70,6 +71,8 @@
 #include "bmesh.h"
 #include "sculpt_intern.h"
 
+#include "zlib.h"
+
 /* Implementation of undo system for objects in sculpt mode.
  *
  * Each undo step in sculpt mode consists of list of nodes, each node contains:
@@ -113,9 +116,25 @@ typedef struct UndoSculpt {
   ListBase nodes;
 
   size_t undo_size;
+
+  /* Compression of the nodes was started, see sculpt_undo_compress_step. */
+  bool is_compressed;
 } UndoSculpt;
 
+#define SCULPT_UNDO_COMPRESS_ARRAYS 4
+
+typedef struct SculptUndoCompressed {
+  void *data;
+  size_t size;
+  /* Size of the co, orig_co, mask and col arrays before compression,
+   * zero for arrays the node does not have. */
+  size_t raw_size[SCULPT_UNDO_COMPRESS_ARRAYS];
+  size_t raw_size_total;
+} SculptUndoCompressed;
+
 static UndoSculpt *sculpt_undo_get_nodes(void);
+static UndoSculpt *sculpt_undosys_step_get_nodes(UndoStep *us_p);
+static void sculpt_undo_decompress(UndoSculpt *usculpt);
 
 static void update_cb(PBVHNode *node, void *rebuild)
 {
@@ -872,6 +891,10 @@ static void sculpt_undo_free_list(ListBase *lb)
     if (unode->face_sets) {
       MEM_freeN(unode->face_sets);
     }
+    if (unode->compressed) {
+      MEM_freeN(unode->compressed->data);
+      MEM_freeN(unode->compressed);
+    }
 
     MEM_freeN(unode);
 
@@ -910,6 +933,8 @@ SculptUndoNode *SCULPT_undo_get_node(PBVHNode *node)
     return NULL;
   }
 
+  sculpt_undo_decompress(usculpt);
+
   return BLI_findptr(&usculpt->nodes, node, offsetof(SculptUndoNode, node));
 }
 
@@ -921,6 +946,8 @@ SculptUndoNode *SCULPT_undo_get_first_node()
     return NULL;
   }
 
+  sculpt_undo_decompress(usculpt);
+
   return usculpt->nodes.first;
 }
 
@@ -1340,6 +1367,227 @@ SculptUndoNode *SCULPT_undo_push_node(Object *ob, PBVHNode *node, SculptUndoType
   return unode;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Undo Node Compression
+ *
+ * Coordinates, masks and colors stored for a finished stroke are only read again on undo, so
+ * they are compressed in a background thread once the stroke ends, and decompressed before the
+ * step is restored.
+ *
+ * Before compression the floats are split into byte planes, and each byte is stored as the
+ * difference to the same byte of the previous vertex. Vertices of a PBVH node are close to each
+ * other, so the high bytes mostly become zero and compress well.
+ * \{ */
+
+/* Pool compressing the steps in sculpt_undo_compress_steps, only accessed from the main thread.
+ * The nodes of these steps are not touched until sculpt_undo_compress_wait. */
+static TaskPool *sculpt_undo_compress_pool = NULL;
+static LinkNode *sculpt_undo_compress_steps = NULL;
+
+static void sculpt_undo_compress_arrays(SculptUndoNode *unode,
+                                        void **r_arrays[SCULPT_UNDO_COMPRESS_ARRAYS],
+                                        int r_components[SCULPT_UNDO_COMPRESS_ARRAYS])
+{
+  r_arrays[0] = (void **)&unode->co;
+  r_components[0] = 3;
+  r_arrays[1] = (void **)&unode->orig_co;
+  r_components[1] = 3;
+  r_arrays[2] = (void **)&unode->mask;
+  r_components[2] = 1;
+  r_arrays[3] = (void **)&unode->col;
+  r_components[3] = 4;
+}
+
+static void sculpt_undo_filter_encode(const uchar *src,
+                                      uchar *dst,
+                                      const size_t size,
+                                      const int components)
+{
+  const size_t totfloat = size / sizeof(float);
+  const size_t stride = sizeof(float) * components;
+
+  for (size_t b = 0; b < sizeof(float); b++) {
+    uchar *plane = dst + b * totfloat;
+    for (size_t i = 0; i < totfloat; i++) {
+      const size_t offset = i * sizeof(float) + b;
+      plane[i] = (offset >= stride) ? (uchar)(src[offset] - src[offset - stride]) : src[offset];
+    }
+  }
+}
+
+static void sculpt_undo_filter_decode(const uchar *src,
+                                      uchar *dst,
+                                      const size_t size,
+                                      const int components)
+{
+  const size_t totfloat = size / sizeof(float);
+  const size_t stride = sizeof(float) * components;
+
+  for (size_t b = 0; b < sizeof(float); b++) {
+    const uchar *plane = src + b * totfloat;
+    for (size_t i = 0; i < totfloat; i++) {
+      const size_t offset = i * sizeof(float) + b;
+      dst[offset] = (offset >= stride) ? (uchar)(plane[i] + dst[offset - stride]) : plane[i];
+    }
+  }
+}
+
+static bool sculpt_undo_node_use_compression(const SculptUndoNode *unode)
+{
+  return ELEM(unode->type, SCULPT_UNDO_COORDS, SCULPT_UNDO_MASK, SCULPT_UNDO_COLOR) &&
+         unode->bm_entry == NULL;
+}
+
+static void sculpt_undo_node_compress_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  SculptUndoNode *unode = taskdata;
+  void **arrays[SCULPT_UNDO_COMPRESS_ARRAYS];
+  int components[SCULPT_UNDO_COMPRESS_ARRAYS];
+  size_t raw_size[SCULPT_UNDO_COMPRESS_ARRAYS];
+  size_t raw_size_total = 0;
+
+  sculpt_undo_compress_arrays(unode, arrays, components);
+  for (int i = 0; i < SCULPT_UNDO_COMPRESS_ARRAYS; i++) {
+    raw_size[i] = (*arrays[i]) ? MEM_allocN_len(*arrays[i]) : 0;
+    raw_size_total += raw_size[i];
+  }
+  if (raw_size_total == 0) {
+    return;
+  }
+
+  uchar *filtered = MEM_mallocN(raw_size_total, "sculpt undo filtered");
+  size_t offset = 0;
+  for (int i = 0; i < SCULPT_UNDO_COMPRESS_ARRAYS; i++) {
+    if (raw_size[i]) {
+      sculpt_undo_filter_encode(*arrays[i], filtered + offset, raw_size[i], components[i]);
+      offset += raw_size[i];
+    }
+  }
+
+  uLongf size = compressBound((uLong)raw_size_total);
+  void *data = MEM_mallocN(size, "sculpt undo compressed");
+  const int result = compress2(data, &size, filtered, (uLong)raw_size_total, Z_BEST_SPEED);
+  MEM_freeN(filtered);
+
+  if (result != Z_OK || size >= raw_size_total) {
+    /* Not compressible, keep the arrays as they are. */
+    MEM_freeN(data);
+    return;
+  }
+
+  SculptUndoCompressed *compressed = MEM_callocN(sizeof(*compressed), __func__);
+  compressed->data = MEM_reallocN(data, size);
+  compressed->size = size;
+  compressed->raw_size_total = raw_size_total;
+  for (int i = 0; i < SCULPT_UNDO_COMPRESS_ARRAYS; i++) {
+    compressed->raw_size[i] = raw_size[i];
+    MEM_SAFE_FREE(*arrays[i]);
+  }
+  unode->compressed = compressed;
+}
+
+static void sculpt_undo_node_decompress(SculptUndoNode *unode)
+{
+  SculptUndoCompressed *compressed = unode->compressed;
+  void **arrays[SCULPT_UNDO_COMPRESS_ARRAYS];
+  int components[SCULPT_UNDO_COMPRESS_ARRAYS];
+  const char *names[SCULPT_UNDO_COMPRESS_ARRAYS] = {
+      "SculptUndoNode.co", "undoSculpt orig_cos", "SculptUndoNode.mask", "SculptUndoNode.col"};
+
+  uchar *filtered = MEM_callocN(compressed->raw_size_total, "sculpt undo filtered");
+  uLongf size = (uLongf)compressed->raw_size_total;
+  if (uncompress(filtered, &size, compressed->data, (uLong)compressed->size) != Z_OK ||
+      size != compressed->raw_size_total) {
+    BLI_assert(!"Sculpt undo node decompression failed");
+  }
+
+  sculpt_undo_compress_arrays(unode, arrays, components);
+  size_t offset = 0;
+  for (int i = 0; i < SCULPT_UNDO_COMPRESS_ARRAYS; i++) {
+    if (compressed->raw_size[i]) {
+      *arrays[i] = MEM_mallocN(compressed->raw_size[i], names[i]);
+      sculpt_undo_filter_decode(
+          filtered + offset, *arrays[i], compressed->raw_size[i], components[i]);
+      offset += compressed->raw_size[i];
+    }
+  }
+  MEM_freeN(filtered);
+
+  MEM_freeN(compressed->data);
+  MEM_freeN(compressed);
+  unode->compressed = NULL;
+}
+
+/* Wait for running compression, and account the compressed size in the undo steps. */
+static void sculpt_undo_compress_wait(void)
+{
+  if (sculpt_undo_compress_pool == NULL) {
+    return;
+  }
+
+  BLI_task_pool_work_and_wait(sculpt_undo_compress_pool);
+  BLI_task_pool_free(sculpt_undo_compress_pool);
+  sculpt_undo_compress_pool = NULL;
+
+  for (LinkNode *link = sculpt_undo_compress_steps; link; link = link->next) {
+    UndoStep *us = link->link;
+    UndoSculpt *usculpt = sculpt_undosys_step_get_nodes(us);
+    size_t saved = 0;
+
+    LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+      if (unode->compressed) {
+        saved += unode->compressed->raw_size_total - unode->compressed->size;
+      }
+    }
+    usculpt->undo_size = (usculpt->undo_size > saved) ? usculpt->undo_size - saved : 0;
+    us->data_size = usculpt->undo_size;
+  }
+  BLI_linklist_free(sculpt_undo_compress_steps, NULL);
+  sculpt_undo_compress_steps = NULL;
+}
+
+/* Start compressing the nodes of a step in the background. */
+static void sculpt_undo_compress_step(UndoStep *us)
+{
+  UndoSculpt *usculpt = sculpt_undosys_step_get_nodes(us);
+  BLI_assert(!usculpt->is_compressed);
+
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    if (sculpt_undo_node_use_compression(unode)) {
+      if (sculpt_undo_compress_pool == NULL) {
+        sculpt_undo_compress_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+      }
+      BLI_task_pool_push(
+          sculpt_undo_compress_pool, sculpt_undo_node_compress_task, unode, false, NULL);
+      usculpt->is_compressed = true;
+    }
+  }
+
+  if (usculpt->is_compressed) {
+    BLI_linklist_prepend(&sculpt_undo_compress_steps, us);
+  }
+}
+
+/* Make the arrays of all nodes available again, before the step is restored. */
+static void sculpt_undo_decompress(UndoSculpt *usculpt)
+{
+  if (!usculpt->is_compressed) {
+    return;
+  }
+
+  sculpt_undo_compress_wait();
+
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    if (unode->compressed) {
+      usculpt->undo_size += unode->compressed->raw_size_total - unode->compressed->size;
+      sculpt_undo_node_decompress(unode);
+    }
+  }
+  usculpt->is_compressed = false;
+}
+
+/** \} */
+
 void SCULPT_undo_push_begin(const char *name)
 {
   UndoStack *ustack = ED_undo_stack_get();
@@ -1360,6 +1608,9 @@ void SCULPT_undo_push_end_ex(const bool use_nested_undo)
   UndoSculpt *usculpt = sculpt_undo_get_nodes();
   SculptUndoNode *unode;
 
+  /* Account the compressed size of the previous stroke before limiting undo memory. */
+  sculpt_undo_compress_wait();
+
   /* We don't need normals in the undo stack. */
   for (unode = usculpt->nodes.first; unode; unode = unode->next) {
     if (unode->no) {
@@ -1373,6 +1624,12 @@ void SCULPT_undo_push_end_ex(const bool use_nested_undo)
   if (wm->op_undo_depth == 0 || use_nested_undo) {
     UndoStack *ustack = ED_undo_stack_get();
     BKE_undosys_step_push(ustack, NULL, NULL);
+
+    UndoStep *us = BKE_undosys_stack_active_with_type(ustack, BKE_UNDOSYS_TYPE_SCULPT);
+    if (us && sculpt_undosys_step_get_nodes(us) == usculpt) {
+      sculpt_undo_compress_step(us);
+    }
+
     if (wm->op_undo_depth == 0) {
       BKE_undosys_stack_limit_steps_and_memory_defaults(ustack);
     }
@@ -1424,7 +1681,9 @@ static void sculpt_undosys_step_decode_undo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == true);
+  sculpt_undo_decompress(&us->data);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
+  sculpt_undo_compress_step(&us->step);
   us->step.is_applied = false;
 }
 
@@ -1433,7 +1692,9 @@ static void sculpt_undosys_step_decode_redo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == false);
+  sculpt_undo_decompress(&us->data);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
+  sculpt_undo_compress_step(&us->step);
   us->step.is_applied = true;
 }
 
@@ -1522,6 +1783,8 @@ static void sculpt_undosys_step_decode(
 static void sculpt_undosys_step_free(UndoStep *us_p)
 {
   SculptUndoStep *us = (SculptUndoStep *)us_p;
+  /* The compression tasks may still access the nodes. */
+  sculpt_undo_compress_wait();
   sculpt_undo_free_list(&us->data.nodes);
 }
 
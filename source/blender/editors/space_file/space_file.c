@@ -769,9 +769,11 @@ void ED_spacetype_file(void)
   BKE_spacetype_register(st);
 }
 
-void ED_file_init(void)
+void ED_file_init(const bool read_bookmarks)
 {
-  ED_file_read_bookmarks();
+  if (read_bookmarks) {
+    ED_file_read_bookmarks();
+  }
 
   if (G.background == false) {
     filelist_init_icons();
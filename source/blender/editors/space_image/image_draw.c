@@ -609,8 +609,22 @@ static void draw_image_buffer(const bContext *C,
 
     /* If RGBA display with color management */
     if ((sima_flag & (SI_SHOW_R | SI_SHOW_G | SI_SHOW_B | SI_SHOW_ALPHA)) == 0) {
-
-      ED_draw_imbuf_ctx_clipping(C, ibuf, x, y, false, 0, 0, clip_max_x, clip_max_y, zoomx, zoomy);
+      /* Render results and viewers are updated without tagging the display buffers. */
+      const bool use_cached_texture = sima->image &&
+                                      ELEM(sima->image->type, IMA_TYPE_IMAGE, IMA_TYPE_MULTILAYER);
+
+      ED_draw_imbuf_ctx_clipping(C,
+                                 ibuf,
+                                 x,
+                                 y,
+                                 false,
+                                 0,
+                                 0,
+                                 clip_max_x,
+                                 clip_max_y,
+                                 zoomx,
+                                 zoomy,
+                                 use_cached_texture);
     }
     else {
       float shuffle[4] = {0.0f, 0.0f, 0.0f, 0.0f};
@@ -1161,6 +1161,36 @@ void node_draw_sockets(View2D *v2d,
   GPU_blend(false);
 }
 
+/* Execution time and buffer memory of compositor nodes, drawn above the node. */
+static void node_draw_statistics(SpaceNode *snode, bNodeTree *ntree, bNode *node)
+{
+  if (!(snode->flag & SNODE_SHOW_STATISTICS) || ntree->type != NTREE_COMPOSIT) {
+    return;
+  }
+  if (node->exec_time == 0.0f && node->exec_memory == 0.0f) {
+    return;
+  }
+
+  char info[64];
+  BLI_snprintf(info, sizeof(info), "%.2f ms  %.1f MB", node->exec_time, node->exec_memory);
+
+  rctf *rct = &node->totr;
+  uiDefBut(node->block,
+           UI_BTYPE_LABEL,
+           0,
+           info,
+           (int)rct->xmin,
+           (int)rct->ymax,
+           (short)BLI_rctf_size_x(rct),
+           (short)NODE_DY,
+           NULL,
+           0,
+           0,
+           0,
+           0,
+           "");
+}
+
 static void node_draw_basis(const bContext *C,
                             ARegion *region,
                             SpaceNode *snode,
@@ -1386,6 +1416,8 @@ static void node_draw_basis(const bContext *C,
 
   UI_ThemeClearColor(color_id);
 
+  node_draw_statistics(snode, ntree, node);
+
   UI_block_end(C, node->block);
   UI_block_draw(C, node->block);
   node->block = NULL;
@@ -1545,6 +1577,8 @@ static void node_draw_hidden(const bContext *C,
 
   node_draw_sockets(v2d, C, ntree, node, true, false);
 
+  node_draw_statistics(snode, ntree, node);
+
   UI_block_end(C, node->block);
   UI_block_draw(C, node->block);
   node->block = NULL;
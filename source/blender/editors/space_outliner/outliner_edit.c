@@ -193,7 +193,7 @@ static int outliner_item_openclose_modal(bContext *C, wmOperator *op, const wmEv
         outliner_item_openclose(te, data->open, false);
 
         /* Avoid rebuild if possible. */
-        if (outliner_element_needs_rebuild_on_open_change(TREESTORE(te))) {
+        if (outliner_element_needs_rebuild_on_open_change(te, false)) {
           ED_region_tag_redraw(region);
         }
         else {
@@ -239,7 +239,7 @@ static int outliner_item_openclose_invoke(bContext *C, wmOperator *op, const wmE
 
     outliner_item_openclose(te, open, toggle_all);
     /* Avoid rebuild if possible. */
-    if (outliner_element_needs_rebuild_on_open_change(TREESTORE(te))) {
+    if (outliner_element_needs_rebuild_on_open_change(te, toggle_all)) {
       ED_region_tag_redraw(region);
     }
     else {
@@ -129,6 +129,7 @@ enum {
   /* Closed items display their children as icon within the row. TE_ICONROW is for
    * these child-items that are visible but only within the row of the closed parent. */
   TE_ICONROW = (1 << 1),
+  /* Closed item that skipped adding (some of) its children, opening it needs a tree rebuild. */
   TE_LAZY_CLOSED = (1 << 2),
   TE_FREE_NAME = (1 << 3),
   TE_DISABLED = (1 << 4),
@@ -237,7 +238,7 @@ void outliner_build_tree(struct Main *mainvar,
                          struct SpaceOutliner *soops,
                          struct ARegion *region);
 
-bool outliner_element_needs_rebuild_on_open_change(const TreeStoreElem *tselem);
+bool outliner_element_needs_rebuild_on_open_change(const TreeElement *te, const bool recursive);
 
 typedef struct IDsSelectedData {
   struct ListBase selected_array;
@@ -236,14 +236,28 @@ static TreeElement *outliner_add_element(
 /* -------------------------------------------------------- */
 
 /**
- * Check if an element type needs a full rebuild if the open/collapsed state changes.
- * These element types don't add children if collapsed.
+ * Check if an element needs a full rebuild if the open/collapsed state changes.
+ * These element types don't add children if collapsed, other elements skipped some of their
+ * children while collapsed (#TE_LAZY_CLOSED).
  *
  * This current check isn't great really. A per element-type flag would be preferable.
+ *
+ * \param recursive: Also check the sub-tree, for when the state of all children changed too.
  */
-bool outliner_element_needs_rebuild_on_open_change(const TreeStoreElem *tselem)
+bool outliner_element_needs_rebuild_on_open_change(const TreeElement *te, const bool recursive)
 {
-  return ELEM(tselem->type, TSE_RNA_STRUCT, TSE_RNA_PROPERTY, TSE_KEYMAP);
+  if (ELEM(TREESTORE(te)->type, TSE_RNA_STRUCT, TSE_RNA_PROPERTY, TSE_KEYMAP) ||
+      (te->flag & TE_LAZY_CLOSED)) {
+    return true;
+  }
+  if (recursive) {
+    LISTBASE_FOREACH (const TreeElement *, te_child, &te->subtree) {
+      if (outliner_element_needs_rebuild_on_open_change(te_child, true)) {
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
 /* special handling of hierarchical non-lib data */
@@ -346,6 +360,10 @@ static void outliner_add_object_contents(SpaceOutliner *soops,
                                          TreeStoreElem *tselem,
                                          Object *ob)
 {
+  /* The items of the data lists below are only visible once the object is open. Skip them for
+   * closed objects, the tree is rebuilt when opening (see #TE_LAZY_CLOSED). */
+  const bool show_items = TSELEM_OPEN(tselem, soops);
+
   if (outliner_animdata_test(ob->adt)) {
     outliner_add_element(soops, &te->subtree, ob, te, TSE_ANIM_DATA, 0);
   }
@@ -433,11 +451,17 @@ static void outliner_add_object_contents(SpaceOutliner *soops,
       int a = 0;
 
       ten_bonegrp->name = IFACE_("Bone Groups");
-      for (agrp = ob->pose->agroups.first; agrp; agrp = agrp->next, a++) {
-        TreeElement *ten;
-        ten = outliner_add_element(soops, &ten_bonegrp->subtree, ob, ten_bonegrp, TSE_POSEGRP, a);
-        ten->name = agrp->name;
-        ten->directdata = agrp;
+      if (show_items) {
+        for (agrp = ob->pose->agroups.first; agrp; agrp = agrp->next, a++) {
+          TreeElement *ten;
+          ten = outliner_add_element(
+              soops, &ten_bonegrp->subtree, ob, ten_bonegrp, TSE_POSEGRP, a);
+          ten->name = agrp->name;
+          ten->directdata = agrp;
+        }
+      }
+      else {
+        te->flag |= TE_LAZY_CLOSED;
       }
     }
   }
@@ -455,23 +479,28 @@ static void outliner_add_object_contents(SpaceOutliner *soops,
     int a;
 
     tenla->name = IFACE_("Constraints");
-    for (con = ob->constraints.first, a = 0; con; con = con->next, a++) {
-      ten = outliner_add_element(soops, &tenla->subtree, ob, tenla, TSE_CONSTRAINT, a);
+    if (show_items) {
+      for (con = ob->constraints.first, a = 0; con; con = con->next, a++) {
+        ten = outliner_add_element(soops, &tenla->subtree, ob, tenla, TSE_CONSTRAINT, a);
 #if 0 /* disabled due to constraints system targets recode... code here needs review */
-      target = get_constraint_target(con, &str);
-      if (str && str[0]) {
-        ten->name = str;
-      }
-      else if (target) {
-        ten->name = target->id.name + 2;
-      }
-      else {
+        target = get_constraint_target(con, &str);
+        if (str && str[0]) {
+          ten->name = str;
+        }
+        else if (target) {
+          ten->name = target->id.name + 2;
+        }
+        else {
+          ten->name = con->name;
+        }
+#endif
         ten->name = con->name;
+        ten->directdata = con;
+        /* possible add all other types links? */
       }
-#endif
-      ten->name = con->name;
-      ten->directdata = con;
-      /* possible add all other types links? */
+    }
+    else {
+      te->flag |= TE_LAZY_CLOSED;
     }
   }
 
@@ -481,37 +510,42 @@ static void outliner_add_object_contents(SpaceOutliner *soops,
     int index;
 
     ten_mod->name = IFACE_("Modifiers");
-    for (index = 0, md = ob->modifiers.first; md; index++, md = md->next) {
-      TreeElement *ten = outliner_add_element(
-          soops, &ten_mod->subtree, ob, ten_mod, TSE_MODIFIER, index);
-      ten->name = md->name;
-      ten->directdata = md;
-
-      if (md->type == eModifierType_Lattice) {
-        outliner_add_element(
-            soops, &ten->subtree, ((LatticeModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
-      }
-      else if (md->type == eModifierType_Curve) {
-        outliner_add_element(
-            soops, &ten->subtree, ((CurveModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
-      }
-      else if (md->type == eModifierType_Armature) {
-        outliner_add_element(
-            soops, &ten->subtree, ((ArmatureModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
-      }
-      else if (md->type == eModifierType_Hook) {
-        outliner_add_element(
-            soops, &ten->subtree, ((HookModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
-      }
-      else if (md->type == eModifierType_ParticleSystem) {
-        ParticleSystem *psys = ((ParticleSystemModifierData *)md)->psys;
-        TreeElement *ten_psys;
+    if (show_items) {
+      for (index = 0, md = ob->modifiers.first; md; index++, md = md->next) {
+        TreeElement *ten = outliner_add_element(
+            soops, &ten_mod->subtree, ob, ten_mod, TSE_MODIFIER, index);
+        ten->name = md->name;
+        ten->directdata = md;
+
+        if (md->type == eModifierType_Lattice) {
+          outliner_add_element(
+              soops, &ten->subtree, ((LatticeModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
+        }
+        else if (md->type == eModifierType_Curve) {
+          outliner_add_element(
+              soops, &ten->subtree, ((CurveModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
+        }
+        else if (md->type == eModifierType_Armature) {
+          outliner_add_element(
+              soops, &ten->subtree, ((ArmatureModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
+        }
+        else if (md->type == eModifierType_Hook) {
+          outliner_add_element(
+              soops, &ten->subtree, ((HookModifierData *)md)->object, ten, TSE_LINKED_OB, 0);
+        }
+        else if (md->type == eModifierType_ParticleSystem) {
+          ParticleSystem *psys = ((ParticleSystemModifierData *)md)->psys;
+          TreeElement *ten_psys;
 
-        ten_psys = outliner_add_element(soops, &ten->subtree, ob, te, TSE_LINKED_PSYS, 0);
-        ten_psys->directdata = psys;
-        ten_psys->name = psys->part->id.name + 2;
+          ten_psys = outliner_add_element(soops, &ten->subtree, ob, te, TSE_LINKED_PSYS, 0);
+          ten_psys->directdata = psys;
+          ten_psys->name = psys->part->id.name + 2;
+        }
       }
     }
+    else {
+      te->flag |= TE_LAZY_CLOSED;
+    }
   }
 
   /* vertex groups */
@@ -522,10 +556,15 @@ static void outliner_add_object_contents(SpaceOutliner *soops,
     int a;
 
     tenla->name = IFACE_("Vertex Groups");
-    for (defgroup = ob->defbase.first, a = 0; defgroup; defgroup = defgroup->next, a++) {
-      ten = outliner_add_element(soops, &tenla->subtree, ob, tenla, TSE_DEFGROUP, a);
-      ten->name = defgroup->name;
-      ten->directdata = defgroup;
+    if (show_items) {
+      for (defgroup = ob->defbase.first, a = 0; defgroup; defgroup = defgroup->next, a++) {
+        ten = outliner_add_element(soops, &tenla->subtree, ob, tenla, TSE_DEFGROUP, a);
+        ten->name = defgroup->name;
+        ten->directdata = defgroup;
+      }
+    }
+    else {
+      te->flag |= TE_LAZY_CLOSED;
     }
   }
 
@@ -805,7 +844,8 @@ static void outliner_add_id_contents(SpaceOutliner *soops,
  *
  * \note: "ID" is not always a real ID
  * \note: If child items are only added to the tree if the item is open, the TSE_ type _must_ be
- *        added to #outliner_element_needs_rebuild_on_open_change().
+ *        added to #outliner_element_needs_rebuild_on_open_change(), or the element be flagged
+ *        with #TE_LAZY_CLOSED.
  */
 static TreeElement *outliner_add_element(
     SpaceOutliner *soops, ListBase *lb, void *idv, TreeElement *parent, short type, short index)
@@ -27,6 +27,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_armature_types.h"
@@ -106,6 +107,17 @@ typedef struct SnapObjectData {
   };
 } SnapObjectData;
 
+/** Object collected by #iter_snap_objects, before it is tested by the snap callbacks. */
+typedef struct SnapObjectCandidate {
+  Object *ob;
+  /** Copied, dupli-object matrices are freed along with the dupli-list. */
+  float obmat[4][4];
+  /** The bound-box the snap callback rejects the object with, NULL to never cull it. */
+  const BoundBox *bb;
+  bool is_object_active;
+  bool is_culled;
+} SnapObjectCandidate;
+
 struct SnapObjectContext {
   Scene *scene;
 
@@ -125,6 +137,9 @@ struct SnapObjectContext {
     /** Map object-data to objects so objects share edit mode data. */
     GHash *data_to_object_map;
     MemArena *mem_arena;
+    /** Re-used between snapping queries to avoid reallocating on every mouse move. */
+    SnapObjectCandidate *candidates;
+    int candidates_len_alloc;
   } cache;
 
   /* Filter data, returns true to check this value */
@@ -374,12 +389,74 @@ typedef void (*IterSnapObjsCallback)(SnapObjectContext *sctx,
                                      bool is_object_active,
                                      void *data);
 
+/**
+ * Returns true when the candidate can't be snapped to, only reads the candidate and `cull_data`
+ * since it runs in parallel. Must not reject objects the #IterSnapObjsCallback would accept.
+ */
+typedef bool (*IterSnapObjsCullCallback)(const SnapObjectCandidate *candidate,
+                                         const void *cull_data);
+
+/* Below this number of candidates culling isn't worth the threading overhead. */
+#define SNAP_CULL_PARALLEL_MIN 1024
+
+static void snap_object_candidate_add(SnapObjectContext *sctx,
+                                      int *candidates_len,
+                                      Object *ob,
+                                      const float obmat[4][4],
+                                      bool is_object_active)
+{
+  if (*candidates_len == sctx->cache.candidates_len_alloc) {
+    const int len_alloc = max_ii(64, sctx->cache.candidates_len_alloc * 2);
+    sctx->cache.candidates = MEM_reallocN(sctx->cache.candidates,
+                                          sizeof(*sctx->cache.candidates) * len_alloc);
+    sctx->cache.candidates_len_alloc = len_alloc;
+  }
+
+  SnapObjectCandidate *candidate = &sctx->cache.candidates[(*candidates_len)++];
+  candidate->ob = ob;
+  copy_m4_m4(candidate->obmat, obmat);
+  candidate->is_object_active = is_object_active;
+  candidate->is_culled = false;
+
+  /* Only use bound-boxes that are already calculated,
+   * calculating them isn't thread safe and may not be needed by the snap callback. */
+  candidate->bb = NULL;
+  if (ELEM(ob->type, OB_MESH, OB_CURVE, OB_SURF, OB_FONT) && !BKE_object_is_in_editmode(ob)) {
+    if (ob->runtime.bb && !(ob->runtime.bb->flag & BOUNDBOX_DIRTY)) {
+      candidate->bb = ob->runtime.bb;
+    }
+  }
+}
+
+typedef struct SnapCullTaskData {
+  SnapObjectCandidate *candidates;
+  IterSnapObjsCullCallback cull_callback;
+  const void *cull_data;
+} SnapCullTaskData;
+
+static void snap_objects_cull_fn(void *__restrict userdata,
+                                 const int index,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SnapCullTaskData *data = userdata;
+  SnapObjectCandidate *candidate = &data->candidates[index];
+  if (candidate->bb) {
+    candidate->is_culled = data->cull_callback(candidate, data->cull_data);
+  }
+}
+
 /**
  * Walks through all objects in the scene to create the list of objects to snap.
+ *
+ * Objects are collected first, so the ones that can be rejected by their bound-box alone
+ * (the common case with many objects in the scene) are culled in parallel,
+ * #sob_callback is only called for the remaining ones.
  */
 static void iter_snap_objects(SnapObjectContext *sctx,
                               Depsgraph *depsgraph,
                               const struct SnapObjectParams *params,
+                              IterSnapObjsCullCallback cull_callback,
+                              const void *cull_data,
                               IterSnapObjsCallback sob_callback,
                               void *data)
 {
@@ -388,6 +465,7 @@ static void iter_snap_objects(SnapObjectContext *sctx,
   const eSnapSelect snap_select = params->snap_select;
   const bool use_object_edit_cage = params->use_object_edit_cage;
   const bool use_backface_culling = params->use_backface_culling;
+  int candidates_len = 0;
 
   Base *base_act = view_layer->basact;
   for (Base *base = view_layer->object_bases.first; base != NULL; base = base->next) {
@@ -419,23 +497,38 @@ static void iter_snap_objects(SnapObjectContext *sctx,
       DupliObject *dupli_ob;
       ListBase *lb = object_duplilist(depsgraph, sctx->scene, obj_eval);
       for (dupli_ob = lb->first; dupli_ob; dupli_ob = dupli_ob->next) {
-        sob_callback(sctx,
-                     dupli_ob->ob,
-                     dupli_ob->mat,
-                     use_object_edit_cage,
-                     use_backface_culling,
-                     is_object_active,
-                     data);
+        snap_object_candidate_add(
+            sctx, &candidates_len, dupli_ob->ob, dupli_ob->mat, is_object_active);
       }
       free_object_duplilist(lb);
     }
 
+    snap_object_candidate_add(sctx, &candidates_len, obj_eval, obj_eval->obmat, is_object_active);
+  }
+
+  if (cull_callback) {
+    SnapCullTaskData cull_task_data = {
+        .candidates = sctx->cache.candidates,
+        .cull_callback = cull_callback,
+        .cull_data = cull_data,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (candidates_len >= SNAP_CULL_PARALLEL_MIN);
+    BLI_task_parallel_range(0, candidates_len, &cull_task_data, snap_objects_cull_fn, &settings);
+  }
+
+  for (int i = 0; i < candidates_len; i++) {
+    SnapObjectCandidate *candidate = &sctx->cache.candidates[i];
+    if (candidate->is_culled) {
+      continue;
+    }
     sob_callback(sctx,
-                 obj_eval,
-                 obj_eval->obmat,
+                 candidate->ob,
+                 candidate->obmat,
                  use_object_edit_cage,
                  use_backface_culling,
-                 is_object_active,
+                 candidate->is_object_active,
                  data);
   }
 }
@@ -1074,6 +1167,33 @@ static void raycast_obj_fn(SnapObjectContext *sctx,
   }
 }
 
+struct RaycastCullData {
+  const float *ray_start;
+  const float *ray_dir;
+};
+
+/**
+ * Same bound-box test as #raycastMesh, which all objects with a candidate bound-box use.
+ */
+static bool raycast_obj_cull_fn(const SnapObjectCandidate *candidate, const void *cull_data)
+{
+  const struct RaycastCullData *cd = cull_data;
+  float imat[4][4];
+  float ray_start_local[3], ray_normal_local[3];
+
+  invert_m4_m4(imat, candidate->obmat);
+
+  copy_v3_v3(ray_start_local, cd->ray_start);
+  copy_v3_v3(ray_normal_local, cd->ray_dir);
+
+  mul_m4_v3(imat, ray_start_local);
+  mul_mat3_m4_v3(imat, ray_normal_local);
+  normalize_v3(ray_normal_local);
+
+  return !isect_ray_aabb_v3_simple(
+      ray_start_local, ray_normal_local, candidate->bb->vec[0], candidate->bb->vec[6], NULL, NULL);
+}
+
 /**
  * Main RayCast Function
  * ======================
@@ -1131,8 +1251,13 @@ static bool raycastObjects(SnapObjectContext *sctx,
       .use_occlusion_test = params->use_occlusion_test,
       .ret = false,
   };
+  const struct RaycastCullData cull_data = {
+      .ray_start = ray_start,
+      .ray_dir = ray_dir,
+  };
 
-  iter_snap_objects(sctx, depsgraph, params, raycast_obj_fn, &data);
+  iter_snap_objects(
+      sctx, depsgraph, params, raycast_obj_cull_fn, &cull_data, raycast_obj_fn, &data);
 
   return data.ret;
 }
@@ -2761,6 +2886,32 @@ static void snap_obj_fn(SnapObjectContext *sctx,
   }
 }
 
+struct SnapObjCullData {
+  const SnapData *snapdata;
+  float dist_px_sq;
+};
+
+/**
+ * Same bound-box test as #snapMesh, which non edit-mode meshes, surfaces and text use.
+ * Curves snap to their control points instead, which may lie outside of the bound-box.
+ */
+static bool snap_obj_cull_fn(const SnapObjectCandidate *candidate, const void *cull_data)
+{
+  const struct SnapObjCullData *cd = cull_data;
+  if (!ELEM(candidate->ob->type, OB_MESH, OB_SURF, OB_FONT)) {
+    return false;
+  }
+
+  float lpmat[4][4];
+  mul_m4_m4m4(lpmat, cd->snapdata->pmat, candidate->obmat);
+  return !snap_bound_box_check_dist(candidate->bb->vec[0],
+                                    candidate->bb->vec[6],
+                                    lpmat,
+                                    cd->snapdata->win_size,
+                                    cd->snapdata->mval,
+                                    cd->dist_px_sq);
+}
+
 /**
  * Main Snapping Function
  * ======================
@@ -2811,8 +2962,13 @@ static short snapObjectsRay(SnapObjectContext *sctx,
       .r_obmat = r_obmat,
       .ret = 0,
   };
+  /* The distance only decreases while snapping, so culling with the initial one is safe. */
+  const struct SnapObjCullData cull_data = {
+      .snapdata = snapdata,
+      .dist_px_sq = square_f(*dist_px),
+  };
 
-  iter_snap_objects(sctx, depsgraph, params, snap_obj_fn, &data);
+  iter_snap_objects(sctx, depsgraph, params, snap_obj_cull_fn, &cull_data, snap_obj_fn, &data);
 
   return data.ret;
 }
@@ -2867,6 +3023,7 @@ void ED_transform_snap_object_context_destroy(SnapObjectContext *sctx)
     BLI_ghash_free(sctx->cache.data_to_object_map, NULL, NULL);
   }
   BLI_memarena_free(sctx->cache.mem_arena);
+  MEM_SAFE_FREE(sctx->cache.candidates);
 
   MEM_freeN(sctx);
 }
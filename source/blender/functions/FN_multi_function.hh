@@ -103,6 +103,11 @@ class MultiFunction {
     return signature_.depends_on_context;
   }
 
+  bool is_thread_safe() const
+  {
+    return signature_.is_thread_safe;
+  }
+
   const MFSignature &signature() const
   {
     return signature_;
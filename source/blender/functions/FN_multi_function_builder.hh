@@ -29,6 +29,145 @@
 
 namespace blender::fn {
 
+namespace mf_builder_detail {
+
+/**
+ * Accessors that are used instead of a #VSpan in the inner loops of the functions below. Unlike
+ * #VSpan::operator[], they don't have to check the category of the span for every element, so
+ * that the element function can be inlined and the loop can be auto-vectorized.
+ */
+template<typename T> struct SingleAccessor {
+  const T &value;
+
+  const T &operator[](const int64_t UNUSED(index)) const
+  {
+    return value;
+  }
+};
+
+template<typename T> struct ArrayAccessor {
+  const T *data;
+
+  const T &operator[](const int64_t index) const
+  {
+    return data[index];
+  }
+};
+
+/**
+ * Returns true when the span can be passed to #devirtualize_vspan.
+ */
+template<typename T> inline bool vspan_is_devirtualizable(const VSpan<T> &span)
+{
+  return span.is_single_element() || span.is_full_array();
+}
+
+/**
+ * Calls the given callback with either a #SingleAccessor or an #ArrayAccessor for the span.
+ */
+template<typename T, typename Func>
+inline void devirtualize_vspan(const VSpan<T> &span, const Func &func)
+{
+  BLI_assert(vspan_is_devirtualizable(span));
+  if (span.is_single_element()) {
+    func(SingleAccessor<T>{span.as_single_element()});
+  }
+  else {
+    func(ArrayAccessor<T>{span.as_full_array().data()});
+  }
+}
+
+template<typename Out, typename ElementFuncT, typename... Accessors>
+inline void execute_element_fn_loop(IndexMask mask,
+                                    Out *__restrict out,
+                                    const ElementFuncT &element_fn,
+                                    const Accessors &... in)
+{
+  if (mask.is_range()) {
+    const IndexRange range = mask.as_range();
+    for (int64_t i = range.start(); i < range.one_after_last(); i++) {
+      new (static_cast<void *>(out + i)) Out(element_fn(in[i]...));
+    }
+  }
+  else {
+    for (const int64_t i : mask.indices()) {
+      new (static_cast<void *>(out + i)) Out(element_fn(in[i]...));
+    }
+  }
+}
+
+template<typename Out, typename ElementFuncT, typename In1>
+inline void execute_element_fn_devirtualized(IndexMask mask,
+                                             Out *out,
+                                             const ElementFuncT &element_fn,
+                                             const VSpan<In1> &in1)
+{
+  devirtualize_vspan(in1, [&](const auto &acc1) {
+    execute_element_fn_loop(mask, out, element_fn, acc1);
+  });
+}
+
+template<typename Out, typename ElementFuncT, typename In1, typename In2>
+inline void execute_element_fn_devirtualized(IndexMask mask,
+                                             Out *out,
+                                             const ElementFuncT &element_fn,
+                                             const VSpan<In1> &in1,
+                                             const VSpan<In2> &in2)
+{
+  devirtualize_vspan(in1, [&](const auto &acc1) {
+    devirtualize_vspan(in2, [&](const auto &acc2) {
+      execute_element_fn_loop(mask, out, element_fn, acc1, acc2);
+    });
+  });
+}
+
+template<typename Out, typename ElementFuncT, typename In1, typename In2, typename In3>
+inline void execute_element_fn_devirtualized(IndexMask mask,
+                                             Out *out,
+                                             const ElementFuncT &element_fn,
+                                             const VSpan<In1> &in1,
+                                             const VSpan<In2> &in2,
+                                             const VSpan<In3> &in3)
+{
+  devirtualize_vspan(in1, [&](const auto &acc1) {
+    devirtualize_vspan(in2, [&](const auto &acc2) {
+      devirtualize_vspan(in3, [&](const auto &acc3) {
+        execute_element_fn_loop(mask, out, element_fn, acc1, acc2, acc3);
+      });
+    });
+  });
+}
+
+/**
+ * Constructs the output for every index in the mask. When all inputs are single values, the
+ * element function is only called once. Otherwise a specialized loop is generated for every
+ * combination of single and array inputs, with a separate loop for masks that are a range.
+ */
+template<typename Out, typename ElementFuncT, typename... In>
+inline void execute_element_fn(IndexMask mask,
+                               MutableSpan<Out> out,
+                               const ElementFuncT &element_fn,
+                               const VSpan<In> &... in)
+{
+  if (mask.size() == 0) {
+    return;
+  }
+  if ((in.is_single_element() && ...)) {
+    const Out value = element_fn(in.as_single_element()...);
+    mask.foreach_index([&](const int64_t i) { new (static_cast<void *>(&out[i])) Out(value); });
+    return;
+  }
+  if (!(vspan_is_devirtualizable(in) && ...)) {
+    mask.foreach_index(
+        [&](const int64_t i) { new (static_cast<void *>(&out[i])) Out(element_fn(in[i]...)); });
+    return;
+  }
+  Out *out_data = out.data();
+  execute_element_fn_devirtualized(mask, out_data, element_fn, in...);
+}
+
+}  // namespace mf_builder_detail
+
 /**
  * Generates a multi-function with the following parameters:
  * 1. single input (SI) of type In1
@@ -59,7 +198,7 @@ template<typename In1, typename Out1> class CustomMF_SI_SO : public MultiFunctio
   template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
   {
     return [=](IndexMask mask, VSpan<In1> in1, MutableSpan<Out1> out1) {
-      mask.foreach_index([&](int i) { new ((void *)&out1[i]) Out1(element_fn(in1[i])); });
+      mf_builder_detail::execute_element_fn(mask, out1, element_fn, in1);
     };
   }
 
@@ -101,7 +240,7 @@ class CustomMF_SI_SI_SO : public MultiFunction {
   template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
   {
     return [=](IndexMask mask, VSpan<In1> in1, VSpan<In2> in2, MutableSpan<Out1> out1) {
-      mask.foreach_index([&](int i) { new ((void *)&out1[i]) Out1(element_fn(in1[i], in2[i])); });
+      mf_builder_detail::execute_element_fn(mask, out1, element_fn, in1, in2);
     };
   }
 
@@ -151,8 +290,7 @@ class CustomMF_SI_SI_SI_SO : public MultiFunction {
                VSpan<In2> in2,
                VSpan<In3> in3,
                MutableSpan<Out1> out1) {
-      mask.foreach_index(
-          [&](int i) { new ((void *)&out1[i]) Out1(element_fn(in1[i], in2[i], in3[i])); });
+      mf_builder_detail::execute_element_fn(mask, out1, element_fn, in1, in2, in3);
     };
   }
 
@@ -220,9 +358,8 @@ template<typename From, typename To> class CustomMF_Convert : public MultiFuncti
     VSpan<From> inputs = params.readonly_single_input<From>(0);
     MutableSpan<To> outputs = params.uninitialized_single_output<To>(1);
 
-    for (int64_t i : mask) {
-      new ((void *)&outputs[i]) To(inputs[i]);
-    }
+    mf_builder_detail::execute_element_fn(
+        mask, outputs, [](const From &value) { return To(value); }, inputs);
   }
 };
 
@@ -255,6 +392,8 @@ class CustomMF_GenericConstantArray : public MultiFunction {
  public:
   CustomMF_GenericConstantArray(GSpan array);
   void call(IndexMask mask, MFParams params, MFContext context) const override;
+  uint64_t hash() const override;
+  bool equals(const MultiFunction &other) const override;
 };
 
 /**
@@ -21,25 +21,37 @@
  * \ingroup fn
  */
 
+#include <memory>
+
 #include "FN_multi_function_network.hh"
 
 namespace blender::fn {
 
 class MFNetworkEvaluationStorage;
+class MFNetworkEvaluationBufferPool;
 
 class MFNetworkEvaluator : public MultiFunction {
  private:
   Vector<const MFOutputSocket *> inputs_;
   Vector<const MFInputSocket *> outputs_;
+  /** When true, large masks are split into chunks that are evaluated on multiple threads. */
+  bool use_threading_;
+  /** Buffers for intermediate values that are reused by later evaluations. */
+  std::unique_ptr<MFNetworkEvaluationBufferPool> buffer_pool_;
 
  public:
   MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs, Vector<const MFInputSocket *> outputs);
+  ~MFNetworkEvaluator();
 
   void call(IndexMask mask, MFParams params, MFContext context) const override;
 
  private:
   using Storage = MFNetworkEvaluationStorage;
 
+  bool check_thread_safety() const;
+  void call_chunked(IndexMask mask, MFParams params, MFContext context) const;
+  void evaluate_mask(IndexMask mask, MFParams params, MFContext context) const;
+
   void copy_inputs_to_storage(MFParams params, Storage &storage) const;
   void copy_outputs_to_storage(
       MFParams params,
@@ -36,6 +36,7 @@ struct MFSignature {
   Vector<MFParamType> param_types;
   Vector<int> param_data_indices;
   bool depends_on_context = false;
+  bool is_thread_safe = true;
 
   int data_index(int param_index) const
   {
@@ -166,6 +167,15 @@ class MFSignatureBuilder {
   {
     data_.depends_on_context = true;
   }
+
+  /* Threading */
+
+  /** This indicates that the function must not be called from multiple threads at the same time.
+   * Networks that contain such a function are always evaluated on a single thread. */
+  void not_thread_safe()
+  {
+    data_.is_thread_safe = false;
+  }
 };
 
 }  // namespace blender::fn
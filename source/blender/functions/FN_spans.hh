@@ -165,6 +165,14 @@ class GMutableSpan {
     return POINTER_OFFSET(data_, type_->size() * index);
   }
 
+  GMutableSpan slice(const int64_t start, const int64_t size)
+  {
+    BLI_assert(start >= 0);
+    BLI_assert(size >= 0);
+    BLI_assert(start + size <= size_);
+    return GMutableSpan(*type_, POINTER_OFFSET(data_, type_->size() * start), size);
+  }
+
   template<typename T> MutableSpan<T> typed()
   {
     BLI_assert(type_->is<T>());
@@ -435,6 +443,31 @@ class GVSpan : public VSpanBase<void> {
     return GSpan(*this->type_, data, this->virtual_size_);
   }
 
+  /**
+   * Returns a virtual span that references the given range of this span. Index 0 of the new span
+   * corresponds to the index `start` in this span.
+   */
+  GVSpan slice(const int64_t start, const int64_t size) const
+  {
+    BLI_assert(start >= 0);
+    BLI_assert(size >= 0);
+    BLI_assert(start + size <= this->virtual_size_);
+    GVSpan ref = *this;
+    ref.virtual_size_ = size;
+    switch (this->category_) {
+      case VSpanCategory::Single:
+        break;
+      case VSpanCategory::FullArray:
+        ref.data_.full_array.data = POINTER_OFFSET(this->data_.full_array.data,
+                                                   type_->size() * start);
+        break;
+      case VSpanCategory::FullPointerArray:
+        ref.data_.full_pointer_array.data = this->data_.full_pointer_array.data + start;
+        break;
+    }
+    return ref;
+  }
+
   void materialize_to_uninitialized(void *dst) const
   {
     this->materialize_to_uninitialized(IndexRange(virtual_size_), dst);
@@ -87,6 +87,38 @@ void CustomMF_GenericConstantArray::call(IndexMask mask,
   }
 }
 
+uint64_t CustomMF_GenericConstantArray::hash() const
+{
+  const CPPType &type = array_.type();
+  uint64_t hash = (uint64_t)array_.size();
+  for (int64_t i : IndexRange(array_.size())) {
+    hash = hash * 33 ^ type.hash(array_[i]);
+  }
+  return hash;
+}
+
+bool CustomMF_GenericConstantArray::equals(const MultiFunction &other) const
+{
+  const CustomMF_GenericConstantArray *_other =
+      dynamic_cast<const CustomMF_GenericConstantArray *>(&other);
+  if (_other == nullptr) {
+    return false;
+  }
+  const CPPType &type = array_.type();
+  if (type != _other->array_.type()) {
+    return false;
+  }
+  if (array_.size() != _other->array_.size()) {
+    return false;
+  }
+  for (int64_t i : IndexRange(array_.size())) {
+    if (!type.is_equal(array_[i], _other->array_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 CustomMF_DefaultOutput::CustomMF_DefaultOutput(StringRef name,
                                                Span<MFDataType> input_types,
                                                Span<MFDataType> output_types)
@@ -28,21 +28,83 @@
  * - Avoids data copies in many cases.
  * - Every node is executed at most once.
  * - Can compute sub-functions on a single element, when the result is the same for all elements.
+ * - Large masks are split into chunks that are evaluated on multiple threads, when all functions
+ *   in the network are thread-safe and the network only has single value parameters.
+ *
+ * - Buffers of intermediate values are reused once their last user has been evaluated. They are
+ *   kept alive between evaluations, so that evaluating the same network repeatedly does not
+ *   allocate after the first evaluation.
  *
  * Possible improvements:
- * - Cache and reuse buffers.
  * - Use "deepest depth first" heuristic to decide which order the inputs of a node should be
  *   computed. This reduces the number of required temporary buffers when they are reused.
  */
 
 #include "FN_multi_function_network_evaluation.hh"
 
+#include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_stack.hh"
+#include "BLI_task.h"
+
+#include <mutex>
 
 namespace blender::fn {
 
 struct Value;
 
+/**
+ * Buffers of intermediate values that are larger than this are allocated for every evaluation and
+ * freed afterwards. The limit allows buffers of all types for the chunks of a threaded evaluation.
+ */
+static constexpr int64_t max_pooled_buffer_size = 4096 * 64;
+static constexpr int64_t pooled_buffer_alignment = 64;
+
+/**
+ * Pooled buffers are rounded up to a power of two, so that they can be reused when the size of the
+ * mask changes between evaluations.
+ */
+static int64_t pooled_buffer_size(const int64_t size)
+{
+  int64_t pooled_size = pooled_buffer_alignment;
+  while (pooled_size < size) {
+    pooled_size *= 2;
+  }
+  return pooled_size;
+}
+
+/**
+ * Keeps the buffers of intermediate values alive between evaluations of a network. An evaluation
+ * storage takes buffers from the pool when it runs out of free buffers, and gives all of them back
+ * when it is destructed. The memory is only freed when the pool is freed.
+ */
+class MFNetworkEvaluationBufferPool : NonCopyable, NonMovable {
+ private:
+  std::mutex mutex_;
+  LinearAllocator<> allocator_;
+  Map<int64_t, Vector<void *>> free_buffers_by_size_;
+
+ public:
+  void *take(const int64_t size)
+  {
+    BLI_assert(size <= max_pooled_buffer_size);
+    std::lock_guard<std::mutex> lock{mutex_};
+    Vector<void *> &free_buffers = free_buffers_by_size_.lookup_or_add_default(size);
+    if (free_buffers.is_empty()) {
+      return allocator_.allocate(size, pooled_buffer_alignment);
+    }
+    return free_buffers.pop_last();
+  }
+
+  void give_back(Span<std::pair<int64_t, void *>> buffers)
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (const std::pair<int64_t, void *> &item : buffers) {
+      free_buffers_by_size_.lookup_or_add_default(item.first).append(item.second);
+    }
+  }
+};
+
 /**
  * This keeps track of all the values that flow through the multi-function network. Therefore it
  * maintains a mapping between output sockets and their corresponding values. Every `value`
@@ -53,12 +115,22 @@ struct Value;
 class MFNetworkEvaluationStorage {
  private:
   LinearAllocator<> allocator_;
+  /** Used by the allocator first, so small networks don't need heap allocations for values. */
+  AlignedBuffer<1024, 8> allocator_inline_buffer_;
   IndexMask mask_;
-  Array<Value *> value_per_output_id_;
+  Array<Value *, 32> value_per_output_id_;
   int64_t min_array_size_;
 
+  MFNetworkEvaluationBufferPool &buffer_pool_;
+  /** Buffers taken from the pool, with their size. All of them are given back in the end. */
+  Vector<std::pair<int64_t, void *>> pooled_buffers_;
+  /** Buffers taken from the pool that are not used by a value currently. */
+  Vector<std::pair<int64_t, void *>> free_pooled_buffers_;
+
  public:
-  MFNetworkEvaluationStorage(IndexMask mask, int socket_id_amount);
+  MFNetworkEvaluationStorage(IndexMask mask,
+                             int socket_id_amount,
+                             MFNetworkEvaluationBufferPool &buffer_pool);
   ~MFNetworkEvaluationStorage();
 
   /* Add the values that have been provided by the caller of the multi-function network. */
@@ -97,11 +169,17 @@ class MFNetworkEvaluationStorage {
   bool socket_is_computed(const MFOutputSocket &socket);
   bool is_same_value_for_every_index(const MFOutputSocket &socket);
   bool socket_has_buffer_for_output(const MFOutputSocket &socket);
+
+ private:
+  void *allocate_full_buffer(const CPPType &type);
+  void free_full_buffer(const CPPType &type, void *buffer);
 };
 
 MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
                                        Vector<const MFInputSocket *> outputs)
-    : inputs_(std::move(inputs)), outputs_(std::move(outputs))
+    : inputs_(std::move(inputs)),
+      outputs_(std::move(outputs)),
+      buffer_pool_(std::make_unique<MFNetworkEvaluationBufferPool>())
 {
   BLI_assert(outputs_.size() > 0);
   MFSignatureBuilder signature = this->get_builder("Function Tree");
@@ -133,16 +211,149 @@ MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
         break;
     }
   }
+
+  const bool is_thread_safe = this->check_thread_safety();
+  if (!is_thread_safe) {
+    signature.not_thread_safe();
+  }
+
+  /* Vector arrays can't be split into chunks and the caller's vector outputs can't be appended to
+   * from multiple threads. */
+  use_threading_ = is_thread_safe;
+  for (const int param_index : this->param_indices()) {
+    if (this->param_type(param_index).data_type().category() != MFDataType::Single) {
+      use_threading_ = false;
+    }
+  }
+}
+
+MFNetworkEvaluator::~MFNetworkEvaluator() = default;
+
+/**
+ * Returns true when all function nodes that can be evaluated to compute the outputs are
+ * thread-safe.
+ */
+bool MFNetworkEvaluator::check_thread_safety() const
+{
+  Stack<const MFNode *> nodes_to_check;
+  Set<const MFNode *> checked_nodes;
+  for (const MFInputSocket *socket : outputs_) {
+    nodes_to_check.push(&socket->origin()->node());
+  }
+
+  while (!nodes_to_check.is_empty()) {
+    const MFNode &node = *nodes_to_check.pop();
+    if (!checked_nodes.add(&node)) {
+      continue;
+    }
+    if (node.is_dummy()) {
+      continue;
+    }
+    if (!node.as_function().function().is_thread_safe()) {
+      return false;
+    }
+    for (const MFInputSocket *input_socket : node.inputs()) {
+      const MFOutputSocket *origin = input_socket->origin();
+      if (origin != nullptr) {
+        nodes_to_check.push(&origin->node());
+      }
+    }
+  }
+  return true;
 }
 
+/**
+ * Number of elements that are evaluated together when the mask is split into chunks. Every chunk
+ * allocates its own temporary buffers, the size is chosen so that they stay in the CPU cache.
+ * Masks with less than two chunks are evaluated on the calling thread.
+ */
+static constexpr int64_t evaluation_chunk_size = 4096;
+
 void MFNetworkEvaluator::call(IndexMask mask, MFParams params, MFContext context) const
 {
   if (mask.size() == 0) {
     return;
   }
 
+  if (use_threading_ && mask.size() >= 2 * evaluation_chunk_size) {
+    this->call_chunked(mask, params, context);
+  }
+  else {
+    this->evaluate_mask(mask, params, context);
+  }
+}
+
+BLI_NOINLINE void MFNetworkEvaluator::call_chunked(IndexMask mask,
+                                                   MFParams params,
+                                                   MFContext context) const
+{
+  const int64_t chunks_num = (mask.size() + evaluation_chunk_size - 1) / evaluation_chunk_size;
+
+  auto evaluate_chunk = [&](const int64_t chunk_index) {
+    const int64_t chunk_start = chunk_index * evaluation_chunk_size;
+    const IndexMask chunk_mask = mask.indices().slice(
+        chunk_start, std::min(evaluation_chunk_size, mask.size() - chunk_start));
+
+    /* Evaluate the chunk with indices relative to its first index, so that the temporary buffers
+     * only have to be as large as the chunk. */
+    const int64_t offset = chunk_mask[0];
+    const int64_t chunk_array_size = chunk_mask.last() - offset + 1;
+
+    Vector<int64_t> relative_indices;
+    IndexMask relative_mask;
+    if (chunk_mask.is_range()) {
+      relative_mask = IndexRange(chunk_array_size);
+    }
+    else {
+      relative_indices.reserve(chunk_mask.size());
+      for (const int64_t i : chunk_mask) {
+        relative_indices.append(i - offset);
+      }
+      relative_mask = relative_indices.as_span();
+    }
+
+    MFParamsBuilder chunk_params{*this, chunk_array_size};
+    for (const int param_index : this->param_indices()) {
+      switch (this->param_type(param_index).category()) {
+        case MFParamType::SingleInput: {
+          GVSpan values = params.readonly_single_input(param_index);
+          chunk_params.add_readonly_single_input(values.slice(offset, chunk_array_size));
+          break;
+        }
+        case MFParamType::SingleOutput: {
+          GMutableSpan values = params.uninitialized_single_output(param_index);
+          chunk_params.add_uninitialized_single_output(values.slice(offset, chunk_array_size));
+          break;
+        }
+        default:
+          BLI_assert(false);
+          break;
+      }
+    }
+
+    this->evaluate_mask(relative_mask, chunk_params, context);
+  };
+  using EvaluateChunkFn = decltype(evaluate_chunk);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0,
+      (int)chunks_num,
+      &evaluate_chunk,
+      [](void *__restrict userdata, const int chunk_index, const TaskParallelTLS *__restrict) {
+        (*static_cast<EvaluateChunkFn *>(userdata))(chunk_index);
+      },
+      &settings);
+}
+
+BLI_NOINLINE void MFNetworkEvaluator::evaluate_mask(IndexMask mask,
+                                                    MFParams params,
+                                                    MFContext context) const
+{
   const MFNetwork &network = outputs_[0]->node().network();
-  Storage storage(mask, network.socket_id_amount());
+  Storage storage(mask, network.socket_id_amount(), *buffer_pool_);
 
   Vector<const MFInputSocket *> outputs_to_initialize_in_the_end;
 
@@ -506,11 +717,15 @@ struct OwnVectorValue : public Value {
 /** \name Storage methods
  * \{ */
 
-MFNetworkEvaluationStorage::MFNetworkEvaluationStorage(IndexMask mask, int socket_id_amount)
+MFNetworkEvaluationStorage::MFNetworkEvaluationStorage(IndexMask mask,
+                                                       int socket_id_amount,
+                                                       MFNetworkEvaluationBufferPool &buffer_pool)
     : mask_(mask),
       value_per_output_id_(socket_id_amount, nullptr),
-      min_array_size_(mask.min_array_size())
+      min_array_size_(mask.min_array_size()),
+      buffer_pool_(buffer_pool)
 {
+  allocator_.provide_buffer(allocator_inline_buffer_);
 }
 
 MFNetworkEvaluationStorage::~MFNetworkEvaluationStorage()
@@ -528,7 +743,7 @@ MFNetworkEvaluationStorage::~MFNetworkEvaluationStorage()
       }
       else {
         type.destruct_indices(span.data(), mask_);
-        MEM_freeN(span.data());
+        this->free_full_buffer(type, span.data());
       }
     }
     else if (any_value->type == ValueType::OwnVector) {
@@ -536,6 +751,41 @@ MFNetworkEvaluationStorage::~MFNetworkEvaluationStorage()
       delete value->vector_array;
     }
   }
+  buffer_pool_.give_back(pooled_buffers_);
+}
+
+/**
+ * Get an uninitialized buffer that can hold a value of the given type for every index.
+ * Buffers that have been freed before in the same evaluation are reused.
+ */
+void *MFNetworkEvaluationStorage::allocate_full_buffer(const CPPType &type)
+{
+  const int64_t size = min_array_size_ * type.size();
+  if (size > max_pooled_buffer_size || type.alignment() > pooled_buffer_alignment) {
+    return MEM_mallocN_aligned(size, type.alignment(), AT);
+  }
+  const int64_t pooled_size = pooled_buffer_size(size);
+  for (const int64_t i : free_pooled_buffers_.index_range()) {
+    if (free_pooled_buffers_[i].first == pooled_size) {
+      void *buffer = free_pooled_buffers_[i].second;
+      free_pooled_buffers_.remove_and_reorder(i);
+      return buffer;
+    }
+  }
+  void *buffer = buffer_pool_.take(pooled_size);
+  pooled_buffers_.append({pooled_size, buffer});
+  return buffer;
+}
+
+void MFNetworkEvaluationStorage::free_full_buffer(const CPPType &type, void *buffer)
+{
+  const int64_t size = min_array_size_ * type.size();
+  if (size > max_pooled_buffer_size || type.alignment() > pooled_buffer_alignment) {
+    MEM_freeN(buffer);
+  }
+  else {
+    free_pooled_buffers_.append({pooled_buffer_size(size), buffer});
+  }
 }
 
 IndexMask MFNetworkEvaluationStorage::mask() const
@@ -638,7 +888,7 @@ void MFNetworkEvaluationStorage::finish_input_socket(const MFInputSocket &socket
         }
         else {
           type.destruct_indices(span.data(), mask_);
-          MEM_freeN(span.data());
+          this->free_full_buffer(type, span.data());
         }
         value_per_output_id_[origin.id()] = nullptr;
       }
@@ -702,7 +952,7 @@ GMutableSpan MFNetworkEvaluationStorage::get_single_output__full(const MFOutputS
   Value *any_value = value_per_output_id_[socket.id()];
   if (any_value == nullptr) {
     const CPPType &type = socket.data_type().single_type();
-    void *buffer = MEM_mallocN_aligned(min_array_size_ * type.size(), type.alignment(), AT);
+    void *buffer = this->allocate_full_buffer(type);
     GMutableSpan span(type, buffer, min_array_size_);
 
     auto *value = allocator_.construct<OwnSingleValue>(span, socket.targets().size(), false);
@@ -806,7 +1056,7 @@ GMutableSpan MFNetworkEvaluationStorage::get_mutable_single__full(const MFInputS
   }
 
   GVSpan virtual_span = this->get_single_input__full(input);
-  void *new_buffer = MEM_mallocN_aligned(min_array_size_ * type.size(), type.alignment(), AT);
+  void *new_buffer = this->allocate_full_buffer(type);
   GMutableSpan new_array_ref(type, new_buffer, min_array_size_);
   virtual_span.materialize_to_uninitialized(mask_, new_array_ref.data());
 
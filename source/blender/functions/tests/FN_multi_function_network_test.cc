@@ -5,6 +5,7 @@
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_network.hh"
 #include "FN_multi_function_network_evaluation.hh"
+#include "FN_multi_function_network_optimization.hh"
 
 namespace blender::fn::tests {
 
@@ -64,6 +65,61 @@ TEST(multi_function_network, Test1)
   }
 }
 
+TEST(multi_function_network, LargeMask)
+{
+  CustomMF_SI_SI_SO<int, int, int> add_fn("add", [](int a, int b) { return a + b; });
+  CustomMF_SI_SO<int, int> square_fn("square", [](int value) { return value * value; });
+
+  MFNetwork network;
+
+  MFNode &node1 = network.add_function(add_fn);
+  MFNode &node2 = network.add_function(square_fn);
+  MFOutputSocket &input_a = network.add_input("A", MFDataType::ForSingle<int>());
+  MFOutputSocket &input_b = network.add_input("B", MFDataType::ForSingle<int>());
+  MFInputSocket &output_socket = network.add_output("Output", MFDataType::ForSingle<int>());
+  network.add_link(input_a, node1.input(0));
+  network.add_link(input_b, node1.input(1));
+  network.add_link(node1.output(0), node2.input(0));
+  network.add_link(node2.output(0), output_socket);
+
+  MFNetworkEvaluator network_fn{{&input_a, &input_b}, {&output_socket}};
+  EXPECT_TRUE(network_fn.is_thread_safe());
+
+  const int64_t size = 50000;
+  Array<int> values(size);
+  for (const int64_t i : values.index_range()) {
+    values[i] = (int)(i % 1000);
+  }
+  const int offset = 3;
+
+  /* Skip every third index, so that the chunks are not ranges. */
+  Vector<int64_t> indices;
+  for (const int64_t i : IndexRange(size)) {
+    if (i % 3 != 0) {
+      indices.append(i);
+    }
+  }
+
+  Array<int> results(size, -1);
+  MFParamsBuilder params(network_fn, size);
+  params.add_readonly_single_input(values.as_span());
+  params.add_readonly_single_input(&offset);
+  params.add_uninitialized_single_output(results.as_mutable_span());
+
+  MFContextBuilder context;
+  network_fn.call(indices.as_span(), params, context);
+
+  for (const int64_t i : IndexRange(size)) {
+    if (i % 3 == 0) {
+      EXPECT_EQ(results[i], -1);
+    }
+    else {
+      const int expected = (values[i] + offset) * (values[i] + offset);
+      EXPECT_EQ(results[i], expected);
+    }
+  }
+}
+
 class ConcatVectorsFunction : public MultiFunction {
  public:
   ConcatVectorsFunction()
@@ -250,4 +306,51 @@ TEST(multi_function_network, Test2)
   }
 }
 
+TEST(multi_function_network, ConstantFoldingAndDeduplication)
+{
+  CustomMF_Constant<int> constant_a_fn{3};
+  CustomMF_Constant<int> constant_b_fn{3};
+  CreateRangeFunction create_range_fn;
+
+  MFNetwork network;
+
+  MFInputSocket &output1 = network.add_output("Output 1", MFDataType::ForVector<int>());
+  MFInputSocket &output2 = network.add_output("Output 2", MFDataType::ForVector<int>());
+
+  MFNode &node1 = network.add_function(constant_a_fn);
+  MFNode &node2 = network.add_function(constant_b_fn);
+  MFNode &node3 = network.add_function(create_range_fn);
+  MFNode &node4 = network.add_function(create_range_fn);
+
+  network.add_link(node1.output(0), node3.input(0));
+  network.add_link(node2.output(0), node4.input(0));
+  network.add_link(node3.output(0), output1);
+  network.add_link(node4.output(0), output2);
+
+  ResourceCollector resources;
+  mf_network_optimization::constant_folding(network, resources);
+  mf_network_optimization::common_subnetwork_elimination(network);
+  mf_network_optimization::dead_node_removal(network);
+
+  /* Both vectors are folded into constants, which are then deduplicated. */
+  EXPECT_EQ(output1.origin(), output2.origin());
+  EXPECT_EQ(network.function_nodes().size(), 1);
+
+  MFNetworkEvaluator network_fn{{}, {&output1, &output2}};
+
+  GVectorArray output_value_1(CPPType::get<int32_t>(), 2);
+  GVectorArray output_value_2(CPPType::get<int32_t>(), 2);
+
+  MFParamsBuilder params(network_fn, 2);
+  params.add_vector_output(output_value_1);
+  params.add_vector_output(output_value_2);
+
+  MFContextBuilder context;
+  network_fn.call({0, 1}, params, context);
+
+  EXPECT_EQ(output_value_1[1].size(), 3);
+  EXPECT_EQ(output_value_2[1].size(), 3);
+  EXPECT_EQ(GVectorArrayRef<int>(output_value_2)[1][2], 2);
+}
+
 }  // namespace blender::fn::tests
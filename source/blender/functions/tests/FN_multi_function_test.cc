@@ -248,6 +248,46 @@ TEST(multi_function, CustomMF_SI_SI_SO)
   EXPECT_EQ(outputs[3], 90);
 }
 
+TEST(multi_function, CustomMF_SI_SI_SO_SingleInputs)
+{
+  CustomMF_SI_SI_SO<int, int, int> fn("add", [](int a, int b) { return a + b; });
+
+  Array<int> values = {1, 2, 3, 4, 5};
+  int value_a = 10;
+  int value_b = 20;
+  Array<int> outputs(values.size(), -1);
+
+  MFContextBuilder context;
+
+  {
+    MFParamsBuilder params(fn, values.size());
+    params.add_readonly_single_input(&value_a);
+    params.add_readonly_single_input(values.as_span());
+    params.add_uninitialized_single_output(outputs.as_mutable_span());
+    fn.call({0, 2, 3}, params, context);
+  }
+
+  EXPECT_EQ(outputs[0], 11);
+  EXPECT_EQ(outputs[1], -1);
+  EXPECT_EQ(outputs[2], 13);
+  EXPECT_EQ(outputs[3], 14);
+  EXPECT_EQ(outputs[4], -1);
+
+  {
+    MFParamsBuilder params(fn, values.size());
+    params.add_readonly_single_input(&value_a);
+    params.add_readonly_single_input(&value_b);
+    params.add_uninitialized_single_output(outputs.as_mutable_span());
+    fn.call(IndexRange(1, 4), params, context);
+  }
+
+  EXPECT_EQ(outputs[0], 11);
+  EXPECT_EQ(outputs[1], 30);
+  EXPECT_EQ(outputs[2], 30);
+  EXPECT_EQ(outputs[3], 30);
+  EXPECT_EQ(outputs[4], 30);
+}
+
 TEST(multi_function, CustomMF_SI_SI_SI_SO)
 {
   CustomMF_SI_SI_SI_SO<int, std::string, bool, uint> fn{
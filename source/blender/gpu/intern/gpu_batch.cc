@@ -816,10 +816,15 @@ typedef struct GPUDrawCommandIndexed {
   uint i_first;
 } GPUDrawCommandIndexed;
 
+/* Number of command buffers of the requested length in a persistently mapped draw list.
+ * Each of them is fenced separately. */
+#define DRAW_LIST_SEGMENT_LEN 8
+
 struct GPUDrawList {
   GPUBatch *batch;
   uint base_index;  /* Avoid dereferencing batch. */
   uint cmd_offset;  /* in bytes, offset  inside indirect command buffer. */
+  uint cmd_end;     /* in bytes, end of the range the next commands are written to. */
   uint cmd_len;     /* Number of used command for the next call. */
   uint buffer_size; /* in bytes, size of indirect command buffer. */
   GLuint buffer_id; /* Draw Indirect Buffer id */
@@ -827,6 +832,10 @@ struct GPUDrawList {
     GPUDrawCommand *commands;
     GPUDrawCommandIndexed *commands_indexed;
   };
+  /* Only set when the buffer is persistently mapped, it is then used as a ring buffer. */
+  GLubyte *persistent_data;
+  uint segment_size; /* in bytes */
+  GLsync segment_fence[DRAW_LIST_SEGMENT_LEN];
 };
 
 GPUDrawList *GPU_draw_list_create(int length)
@@ -834,10 +843,22 @@ GPUDrawList *GPU_draw_list_create(int length)
   GPUDrawList *list = (GPUDrawList *)MEM_callocN(sizeof(GPUDrawList), "GPUDrawList");
   /* Alloc the biggest possible command list which is indexed. */
   list->buffer_size = sizeof(GPUDrawCommandIndexed) * length;
+  list->cmd_end = list->buffer_size;
   if (USE_MULTI_DRAW_INDIRECT) {
     list->buffer_id = GPU_buf_alloc();
     glBindBuffer(GL_DRAW_INDIRECT_BUFFER, list->buffer_id);
-    glBufferData(GL_DRAW_INDIRECT_BUFFER, list->buffer_size, NULL, GL_DYNAMIC_DRAW);
+    if (GPU_arb_buffer_storage_is_supported()) {
+      /* Map once instead of mapping for every batch. */
+      const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+      list->segment_size = list->buffer_size;
+      list->buffer_size *= DRAW_LIST_SEGMENT_LEN;
+      glBufferStorage(GL_DRAW_INDIRECT_BUFFER, list->buffer_size, NULL, flags);
+      list->persistent_data = (GLubyte *)glMapBufferRange(
+          GL_DRAW_INDIRECT_BUFFER, 0, list->buffer_size, flags | GL_MAP_FLUSH_EXPLICIT_BIT);
+    }
+    else {
+      glBufferData(GL_DRAW_INDIRECT_BUFFER, list->buffer_size, NULL, GL_DYNAMIC_DRAW);
+    }
   }
   else {
     list->commands = (GPUDrawCommand *)MEM_mallocN(list->buffer_size, "GPUDrawList data");
@@ -847,6 +868,15 @@ GPUDrawList *GPU_draw_list_create(int length)
 
 void GPU_draw_list_discard(GPUDrawList *list)
 {
+  if (list->persistent_data) {
+    for (int i = 0; i < DRAW_LIST_SEGMENT_LEN; i++) {
+      if (list->segment_fence[i]) {
+        glDeleteSync(list->segment_fence[i]);
+      }
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, list->buffer_id);
+    glUnmapBuffer(GL_DRAW_INDIRECT_BUFFER);
+  }
   if (list->buffer_id) {
     GPU_buf_free(list->buffer_id);
   }
@@ -856,6 +886,30 @@ void GPU_draw_list_discard(GPUDrawList *list)
   MEM_freeN(list);
 }
 
+/**
+ * Point the commands to the next free range of a persistently mapped list. Before starting to
+ * write to a segment, wait until the GPU is done reading its previous commands.
+ */
+static void draw_list_persistent_begin(GPUDrawList *list)
+{
+  if (list->cmd_offset >= list->buffer_size) {
+    list->cmd_offset = 0;
+  }
+  const uint segment = list->cmd_offset / list->segment_size;
+  GLsync fence = list->segment_fence[segment];
+  if (fence != NULL && (list->cmd_offset % list->segment_size) == 0) {
+    /* Flush the first time so the fence is guaranteed to be signaled eventually. */
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(fence, flags, 1000000000) == GL_TIMEOUT_EXPIRED) {
+      flags = 0;
+    }
+    glDeleteSync(fence);
+    list->segment_fence[segment] = NULL;
+  }
+  list->cmd_end = (segment + 1) * list->segment_size;
+  list->commands = (GPUDrawCommand *)(list->persistent_data + list->cmd_offset);
+}
+
 void GPU_draw_list_init(GPUDrawList *list, GPUBatch *batch)
 {
   BLI_assert(batch->phase == GPU_BATCH_READY_TO_DRAW);
@@ -863,7 +917,12 @@ void GPU_draw_list_init(GPUDrawList *list, GPUBatch *batch)
   list->base_index = batch->elem ? BASE_INDEX(batch->elem) : UINT_MAX;
   list->cmd_len = 0;
 
-  if (USE_MULTI_DRAW_INDIRECT) {
+  if (list->persistent_data) {
+    if (list->commands == NULL) {
+      draw_list_persistent_begin(list);
+    }
+  }
+  else if (USE_MULTI_DRAW_INDIRECT) {
     if (list->commands == NULL) {
       glBindBuffer(GL_DRAW_INDIRECT_BUFFER, list->buffer_id);
       if (list->cmd_offset >= list->buffer_size) {
@@ -909,7 +968,7 @@ void GPU_draw_list_command_add(
   list->cmd_len++;
   uint offset = list->cmd_offset + list->cmd_len * sizeof(GPUDrawCommandIndexed);
 
-  if (offset == list->buffer_size) {
+  if (offset == list->cmd_end) {
     GPU_draw_list_submit(list);
     GPU_draw_list_init(list, list->batch);
   }
@@ -938,14 +997,20 @@ void GPU_draw_list_submit(GPUDrawList *list)
    * not very instance friendly.
    * BUT we also need to take into account the case where only
    * a few instances are needed to finish filling a call buffer. */
-  const bool do_mdi = (cmd_len > 2) || (list->cmd_offset + bytes_used == list->buffer_size);
+  const bool do_mdi = (cmd_len > 2) || (list->cmd_offset + bytes_used == list->cmd_end);
 
   if (USE_MULTI_DRAW_INDIRECT && do_mdi) {
     GLenum prim = batch->gl_prim_type;
 
     glBindBuffer(GL_DRAW_INDIRECT_BUFFER, list->buffer_id);
-    glFlushMappedBufferRange(GL_DRAW_INDIRECT_BUFFER, 0, bytes_used);
-    glUnmapBuffer(GL_DRAW_INDIRECT_BUFFER);
+    if (list->persistent_data) {
+      /* The whole buffer is mapped, the range is relative to its start. */
+      glFlushMappedBufferRange(GL_DRAW_INDIRECT_BUFFER, offset, bytes_used);
+    }
+    else {
+      glFlushMappedBufferRange(GL_DRAW_INDIRECT_BUFFER, 0, bytes_used);
+      glUnmapBuffer(GL_DRAW_INDIRECT_BUFFER);
+    }
     list->commands = NULL; /* Unmapped */
     list->cmd_offset += bytes_used;
 
@@ -955,6 +1020,12 @@ void GPU_draw_list_submit(GPUDrawList *list)
     else {
       glMultiDrawArraysIndirect(prim, (void *)offset, cmd_len, 0);
     }
+
+    if (list->persistent_data && list->cmd_offset == list->cmd_end) {
+      /* The segment is full, all draws reading from it have been issued. */
+      const uint segment = (list->cmd_offset - 1) / list->segment_size;
+      list->segment_fence[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
   }
   else {
     /* Fallback */
@@ -874,6 +874,7 @@ GPUPass *GPU_generate_pass(GPUMaterial *material,
     pass->geometrycode = geometrycode;
     pass->defines = (defines) ? BLI_strdup(defines) : NULL;
     pass->compiled = false;
+    BLI_mutex_init(&pass->compile_lock);
 
     BLI_spin_lock(&pass_cache_spin);
     if (pass_hash != NULL) {
@@ -978,6 +979,7 @@ static bool gpu_pass_shader_validate(GPUPass *pass, GPUShader *shader)
 bool GPU_pass_compile(GPUPass *pass, const char *shname)
 {
   bool success = true;
+  BLI_mutex_lock(&pass->compile_lock);
   if (!pass->compiled) {
     GPUShader *shader = GPU_shader_create(
         pass->vertexcode, pass->fragmentcode, pass->geometrycode, NULL, pass->defines, shname);
@@ -1007,6 +1009,7 @@ bool GPU_pass_compile(GPUPass *pass, const char *shname)
         pass->binary.content, pass->binary.format, pass->binary.len, shname);
     MEM_SAFE_FREE(pass->binary.content);
   }
+  BLI_mutex_unlock(&pass->compile_lock);
 
   return success;
 }
@@ -1030,6 +1033,7 @@ static void gpu_pass_free(GPUPass *pass)
   if (pass->binary.content) {
     MEM_freeN(pass->binary.content);
   }
+  BLI_mutex_end(&pass->compile_lock);
   MEM_freeN(pass);
 }
 
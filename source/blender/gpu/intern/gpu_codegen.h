@@ -26,6 +26,8 @@
 #ifndef __GPU_CODEGEN_H__
 #define __GPU_CODEGEN_H__
 
+#include "BLI_threads.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -53,6 +55,8 @@ typedef struct GPUPass {
     int len;
   } binary;
   bool compiled; /* Did we already tried to compile the attached GPUShader. */
+  /* Materials sharing this pass can be compiled from different threads. */
+  ThreadMutex compile_lock;
 } GPUPass;
 
 /* Pass */
@@ -82,6 +82,10 @@ static struct GPUGlobal {
   bool glew_arb_base_instance_is_supported;
   /* Cubemap Array support. */
   bool glew_arb_texture_cube_map_array_is_supported;
+  /* Persistently mapped buffers, used for immediate mode drawing. */
+  bool glew_arb_buffer_storage_is_supported;
+  /* Retrieving and loading program binaries, used for the shader disk cache. */
+  bool glew_arb_get_program_binary_is_supported;
   /* Some Intel drivers have issues with using mips as framebuffer targets if
    * GL_TEXTURE_MAX_LEVEL is higher than the target mip.
    * We need a workaround in this cases. */
@@ -210,6 +214,16 @@ bool GPU_arb_texture_cube_map_array_is_supported(void)
   return GG.glew_arb_texture_cube_map_array_is_supported;
 }
 
+bool GPU_arb_buffer_storage_is_supported(void)
+{
+  return GG.glew_arb_buffer_storage_is_supported;
+}
+
+bool GPU_arb_get_program_binary_is_supported(void)
+{
+  return GG.glew_arb_get_program_binary_is_supported;
+}
+
 bool GPU_mip_render_workaround(void)
 {
   return GG.mip_render_workaround;
@@ -336,6 +350,13 @@ void gpu_extensions_init(void)
    * disable it when we don't have an OpenGL4 context (See T77657) */
   GG.glew_arb_base_instance_is_supported = GLEW_ARB_base_instance && GLEW_VERSION_4_0;
   GG.glew_arb_texture_cube_map_array_is_supported = GLEW_ARB_texture_cube_map_array;
+  GG.glew_arb_buffer_storage_is_supported = GLEW_ARB_buffer_storage;
+  if (GLEW_ARB_get_program_binary) {
+    /* Some drivers expose the extension without supporting any binary format. */
+    int binary_formats_len = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binary_formats_len);
+    GG.glew_arb_get_program_binary_is_supported = (binary_formats_len > 0);
+  }
   gpu_detect_mip_render_workaround();
 
   if (G.debug & G_DEBUG_GPU_FORCE_WORKAROUNDS) {
@@ -349,6 +370,8 @@ void gpu_extensions_init(void)
     GG.depth_blitting_workaround = true;
     GG.unused_fb_slot_workaround = true;
     GG.texture_copy_workaround = true;
+    GG.glew_arb_buffer_storage_is_supported = false;
+    GG.glew_arb_get_program_binary_is_supported = false;
   }
 
   /* Special fix for theses specific GPUs.
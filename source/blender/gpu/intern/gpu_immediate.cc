@@ -28,6 +28,7 @@
 #endif
 
 #include "GPU_attr_binding.h"
+#include "GPU_extensions.h"
 #include "GPU_immediate.h"
 #include "GPU_matrix.h"
 #include "GPU_texture.h"
@@ -41,11 +42,22 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Number of parts of a persistently mapped buffer that are fenced separately. */
+#define IMM_BUFFER_SEGMENT_LEN 4
+
 typedef struct ImmediateDrawBuffer {
   GLuint vbo_id;
   GLubyte *buffer_data;
   uint buffer_offset;
   uint buffer_size;
+
+  /* Only used with persistent mapping, the buffer is then used as a ring buffer. */
+  GLubyte *persistent_data;
+  /* Signaled when the GPU is done reading a segment. */
+  GLsync segment_fence[IMM_BUFFER_SEGMENT_LEN];
+  /* Range of segments written since the last fences were set. */
+  uint segment_first, segment_last;
+  bool segment_used;
 } ImmediateDrawBuffer;
 
 typedef struct {
@@ -54,6 +66,9 @@ typedef struct {
   GPUBatch *batch;
   GPUContext *context;
 
+  /* Draw buffers are mapped once and written without any map / unmap per draw. */
+  bool use_persistent_mapping;
+
   /* current draw call */
   bool strict_vertex_len;
   uint vertex_len;
@@ -84,6 +99,101 @@ typedef struct {
 static bool initialized = false;
 static Immediate imm;
 
+/* -------------------------------------------------------------------- */
+/** \name Persistently Mapped Draw Buffers
+ *
+ * The buffer is split in segments. Before writing to a segment again, we wait for a fence that
+ * was set after the last draw reading from it. In practice the GPU is always done with a segment
+ * by the time the ring buffer wraps around, so waiting does not stall.
+ * \{ */
+
+static void imm_buffer_persistent_create(ImmediateDrawBuffer *buffer)
+{
+  const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+
+  buffer->vbo_id = GPU_buf_alloc();
+  glBindBuffer(GL_ARRAY_BUFFER, buffer->vbo_id);
+  glBufferStorage(GL_ARRAY_BUFFER, buffer->buffer_size, NULL, flags);
+  /* Written ranges are flushed in #immEnd. */
+  buffer->persistent_data = (GLubyte *)glMapBufferRange(
+      GL_ARRAY_BUFFER, 0, buffer->buffer_size, flags | GL_MAP_FLUSH_EXPLICIT_BIT);
+  buffer->buffer_offset = 0;
+  buffer->segment_used = false;
+}
+
+static void imm_buffer_persistent_free(ImmediateDrawBuffer *buffer)
+{
+  for (int i = 0; i < IMM_BUFFER_SEGMENT_LEN; i++) {
+    if (buffer->segment_fence[i]) {
+      glDeleteSync(buffer->segment_fence[i]);
+      buffer->segment_fence[i] = NULL;
+    }
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, buffer->vbo_id);
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+  /* The driver keeps the storage alive until pending draws are done. */
+  GPU_buf_free(buffer->vbo_id);
+  buffer->vbo_id = 0;
+  buffer->persistent_data = NULL;
+}
+
+static void imm_buffer_segment_fence(ImmediateDrawBuffer *buffer, uint segment)
+{
+  if (buffer->segment_fence[segment]) {
+    glDeleteSync(buffer->segment_fence[segment]);
+  }
+  buffer->segment_fence[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+static void imm_buffer_segment_wait(ImmediateDrawBuffer *buffer, uint segment)
+{
+  GLsync fence = buffer->segment_fence[segment];
+  if (fence == NULL) {
+    return;
+  }
+  /* Flush the first time so the fence is guaranteed to be signaled eventually. */
+  GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+  while (glClientWaitSync(fence, flags, 1000000000) == GL_TIMEOUT_EXPIRED) {
+    flags = 0;
+  }
+  glDeleteSync(fence);
+  buffer->segment_fence[segment] = NULL;
+}
+
+/**
+ * Make sure the GPU is done reading the segments overlapping the \a bytes_needed bytes at
+ * `buffer_offset`, and fence the segments that are not written to anymore.
+ */
+static void imm_buffer_persistent_sync(ImmediateDrawBuffer *buffer,
+                                       const uint bytes_needed,
+                                       const bool wrapped)
+{
+  const uint segment_size = (buffer->buffer_size + IMM_BUFFER_SEGMENT_LEN - 1) /
+                            IMM_BUFFER_SEGMENT_LEN;
+  const uint first = buffer->buffer_offset / segment_size;
+  const uint last = (buffer->buffer_offset + bytes_needed - 1) / segment_size;
+
+  if (buffer->segment_used && (wrapped || first != buffer->segment_last)) {
+    /* All draws reading from these segments have been issued at this point. */
+    for (uint i = buffer->segment_first; i <= buffer->segment_last; i++) {
+      imm_buffer_segment_fence(buffer, i);
+    }
+    buffer->segment_used = false;
+  }
+
+  for (uint i = first; i <= last; i++) {
+    imm_buffer_segment_wait(buffer, i);
+  }
+
+  if (!buffer->segment_used) {
+    buffer->segment_first = first;
+    buffer->segment_used = true;
+  }
+  buffer->segment_last = last;
+}
+
+/** \} */
+
 void immInit(void)
 {
 #if TRUST_NO_ONE
@@ -91,14 +201,22 @@ void immInit(void)
 #endif
   memset(&imm, 0, sizeof(Immediate));
 
-  imm.draw_buffer.vbo_id = GPU_buf_alloc();
+  imm.use_persistent_mapping = GPU_arb_buffer_storage_is_supported();
+
   imm.draw_buffer.buffer_size = DEFAULT_INTERNAL_BUFFER_SIZE;
-  glBindBuffer(GL_ARRAY_BUFFER, imm.draw_buffer.vbo_id);
-  glBufferData(GL_ARRAY_BUFFER, imm.draw_buffer.buffer_size, NULL, GL_DYNAMIC_DRAW);
-  imm.draw_buffer_strict.vbo_id = GPU_buf_alloc();
   imm.draw_buffer_strict.buffer_size = DEFAULT_INTERNAL_BUFFER_SIZE;
-  glBindBuffer(GL_ARRAY_BUFFER, imm.draw_buffer_strict.vbo_id);
-  glBufferData(GL_ARRAY_BUFFER, imm.draw_buffer_strict.buffer_size, NULL, GL_DYNAMIC_DRAW);
+  if (imm.use_persistent_mapping) {
+    imm_buffer_persistent_create(&imm.draw_buffer);
+    imm_buffer_persistent_create(&imm.draw_buffer_strict);
+  }
+  else {
+    imm.draw_buffer.vbo_id = GPU_buf_alloc();
+    glBindBuffer(GL_ARRAY_BUFFER, imm.draw_buffer.vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, imm.draw_buffer.buffer_size, NULL, GL_DYNAMIC_DRAW);
+    imm.draw_buffer_strict.vbo_id = GPU_buf_alloc();
+    glBindBuffer(GL_ARRAY_BUFFER, imm.draw_buffer_strict.vbo_id);
+    glBufferData(GL_ARRAY_BUFFER, imm.draw_buffer_strict.buffer_size, NULL, GL_DYNAMIC_DRAW);
+  }
 
   imm.prim_type = GPU_PRIM_NONE;
   imm.strict_vertex_len = true;
@@ -132,8 +250,14 @@ void immDeactivate(void)
 
 void immDestroy(void)
 {
-  GPU_buf_free(imm.draw_buffer.vbo_id);
-  GPU_buf_free(imm.draw_buffer_strict.vbo_id);
+  if (imm.use_persistent_mapping) {
+    imm_buffer_persistent_free(&imm.draw_buffer);
+    imm_buffer_persistent_free(&imm.draw_buffer_strict);
+  }
+  else {
+    GPU_buf_free(imm.draw_buffer.vbo_id);
+    GPU_buf_free(imm.draw_buffer_strict.vbo_id);
+  }
   initialized = false;
 }
 
@@ -256,7 +380,24 @@ void immBegin(GPUPrimType prim_type, uint vertex_len)
   /* Might waste a little space, but it's safe. */
   const uint pre_padding = padding(active_buffer->buffer_offset, imm.vertex_format.stride);
 
-  if (!recreate_buffer && ((bytes_needed + pre_padding) <= available_bytes)) {
+  if (imm.use_persistent_mapping) {
+    bool wrapped = false;
+    if (recreate_buffer) {
+      /* Storage is immutable, a new buffer is needed to change its size. */
+      imm_buffer_persistent_free(active_buffer);
+      imm_buffer_persistent_create(active_buffer);
+    }
+    else if ((bytes_needed + pre_padding) <= available_bytes) {
+      active_buffer->buffer_offset += pre_padding;
+    }
+    else {
+      /* Wrap around to the start of the ring buffer. */
+      active_buffer->buffer_offset = 0;
+      wrapped = true;
+    }
+    imm_buffer_persistent_sync(active_buffer, bytes_needed, wrapped);
+  }
+  else if (!recreate_buffer && ((bytes_needed + pre_padding) <= available_bytes)) {
     active_buffer->buffer_offset += pre_padding;
   }
   else {
@@ -277,12 +418,17 @@ void immBegin(GPUPrimType prim_type, uint vertex_len)
   }
 #endif
 
-  active_buffer->buffer_data = (GLubyte *)glMapBufferRange(
-      GL_ARRAY_BUFFER,
-      active_buffer->buffer_offset,
-      bytes_needed,
-      GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
-          (imm.strict_vertex_len ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT));
+  if (imm.use_persistent_mapping) {
+    active_buffer->buffer_data = active_buffer->persistent_data + active_buffer->buffer_offset;
+  }
+  else {
+    active_buffer->buffer_data = (GLubyte *)glMapBufferRange(
+        GL_ARRAY_BUFFER,
+        active_buffer->buffer_offset,
+        bytes_needed,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+            (imm.strict_vertex_len ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT));
+  }
 
 #if TRUST_NO_ONE
   assert(active_buffer->buffer_data != NULL);
@@ -413,8 +559,10 @@ void immEnd(void)
       buffer_bytes_used = vertex_buffer_size(&imm.vertex_format, imm.vertex_len);
       /* unused buffer bytes are available to the next immBegin */
     }
-    /* tell OpenGL what range was modified so it doesn't copy the whole mapped range */
-    glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, buffer_bytes_used);
+    if (!imm.use_persistent_mapping) {
+      /* tell OpenGL what range was modified so it doesn't copy the whole mapped range */
+      glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, buffer_bytes_used);
+    }
   }
 
   if (imm.batch) {
@@ -427,7 +575,16 @@ void immEnd(void)
     imm.batch = NULL; /* don't free, batch belongs to caller */
   }
   else {
-    glUnmapBuffer(GL_ARRAY_BUFFER);
+    if (imm.use_persistent_mapping) {
+      /* The whole buffer is mapped, make the written range visible to the GPU. */
+      if (buffer_bytes_used > 0) {
+        glFlushMappedBufferRange(
+            GL_ARRAY_BUFFER, imm.active_buffer->buffer_offset, buffer_bytes_used);
+      }
+    }
+    else {
+      glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
 
     if (imm.vertex_len > 0) {
       immDrawSetup();
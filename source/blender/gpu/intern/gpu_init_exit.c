@@ -51,6 +51,7 @@ void GPU_init(void)
   gpu_extensions_init(); /* must come first */
 
   gpu_codegen_init();
+  gpu_shader_cache_init();
   gpu_material_library_init();
   gpu_framebuffer_module_init();
 
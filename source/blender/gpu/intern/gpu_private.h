@@ -37,6 +37,9 @@ void gpu_extensions_exit(void);
 void gpu_debug_init(void);
 void gpu_debug_exit(void);
 
+/* gpu_shader.cc */
+void gpu_shader_cache_init(void);
+
 /* gpu_framebuffer.c */
 void gpu_framebuffer_module_init(void);
 void gpu_framebuffer_module_exit(void);
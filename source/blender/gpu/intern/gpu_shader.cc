@@ -23,6 +23,9 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_dynstr.h"
+#include "BLI_fileops.h"
+#include "BLI_hash_md5.h"
 #include "BLI_math_base.h"
 #include "BLI_math_vector.h"
 #include "BLI_path_util.h"
@@ -34,6 +37,7 @@
 #include "BKE_global.h"
 
 #include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
 
 #include "GPU_extensions.h"
 #include "GPU_matrix.h"
@@ -42,6 +46,7 @@
 #include "GPU_texture.h"
 #include "GPU_uniformbuffer.h"
 
+#include "gpu_private.h"
 #include "gpu_shader_private.h"
 
 extern "C" char datatoc_gpu_shader_colorspace_lib_glsl[];
@@ -220,6 +225,161 @@ static void gpu_dump_shaders(const char **code, const int num_shaders, const cha
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Program Binary Cache
+ *
+ * Linked programs are stored on disk using `GL_ARB_get_program_binary`, so shaders with the
+ * same sources don't have to be compiled again in later sessions. Files are named after a hash
+ * of all the sources given to the driver and of the driver identification strings, a driver
+ * update then simply misses the cache.
+ * \{ */
+
+#define SHADER_CACHE_MAGIC "BGSC"
+#define SHADER_CACHE_VERSION 1
+
+typedef struct ShaderCacheHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t binary_format;
+  int32_t binary_len;
+} ShaderCacheHeader;
+
+/* Set once on startup, read only afterwards so it can be used by the shader compilation jobs. */
+static char g_shader_cache_dir[FILE_MAX] = "";
+
+void gpu_shader_cache_init(void)
+{
+  const char *cache_dir = BKE_appdir_folder_id_user_notest(BLENDER_USER_DATAFILES,
+                                                           "shader_cache");
+  BLI_strncpy(g_shader_cache_dir, cache_dir ? cache_dir : "", sizeof(g_shader_cache_dir));
+}
+
+static bool gpu_shader_cache_is_enabled(void)
+{
+  return (U.experimental.use_gpu_shader_cache && GPU_arb_get_program_binary_is_supported() &&
+          g_shader_cache_dir[0] != '\0');
+}
+
+static void gpu_shader_cache_key_append(DynStr *ds, const char *str)
+{
+  /* Prefix with the length so the boundaries between sources are part of the key. */
+  if (str == NULL) {
+    BLI_dynstr_append(ds, "-1:");
+    return;
+  }
+  BLI_dynstr_appendf(ds, "%d:", (int)strlen(str));
+  BLI_dynstr_append(ds, str);
+}
+
+static void gpu_shader_cache_filepath(const char **sources,
+                                      const int sources_len,
+                                      char r_filepath[FILE_MAX])
+{
+  DynStr *ds = BLI_dynstr_new();
+  gpu_shader_cache_key_append(ds, (const char *)glGetString(GL_VENDOR));
+  gpu_shader_cache_key_append(ds, (const char *)glGetString(GL_RENDERER));
+  gpu_shader_cache_key_append(ds, (const char *)glGetString(GL_VERSION));
+  for (int i = 0; i < sources_len; i++) {
+    gpu_shader_cache_key_append(ds, sources[i]);
+  }
+
+  int key_len = BLI_dynstr_get_len(ds);
+  char *key = BLI_dynstr_get_cstring(ds);
+  BLI_dynstr_free(ds);
+
+  uchar digest[16];
+  char hex_digest[33];
+  BLI_hash_md5_buffer(key, (size_t)key_len, digest);
+  BLI_hash_md5_to_hexdigest(digest, hex_digest);
+  MEM_freeN(key);
+
+  char filename[64];
+  BLI_snprintf(filename, sizeof(filename), "%s.bin", hex_digest);
+  BLI_join_dirfile(r_filepath, FILE_MAX, g_shader_cache_dir, filename);
+}
+
+/**
+ * \return the linked program or 0 if there is no valid cached binary for \a filepath.
+ */
+static GLuint gpu_shader_cache_load(const char *filepath)
+{
+  FILE *file = BLI_fopen(filepath, "rb");
+  if (file == NULL) {
+    return 0;
+  }
+
+  ShaderCacheHeader header;
+  char *binary = NULL;
+  bool valid = (fread(&header, sizeof(header), 1, file) == 1) &&
+               (memcmp(header.magic, SHADER_CACHE_MAGIC, sizeof(header.magic)) == 0) &&
+               (header.version == SHADER_CACHE_VERSION) && (header.binary_len > 0);
+  if (valid) {
+    binary = (char *)MEM_mallocN((size_t)header.binary_len, __func__);
+    valid = (fread(binary, (size_t)header.binary_len, 1, file) == 1);
+  }
+  fclose(file);
+
+  GLuint program = 0;
+  if (valid) {
+    GLint status;
+    program = glCreateProgram();
+    glProgramBinary(program, header.binary_format, binary, header.binary_len);
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (!status) {
+      /* The driver is allowed to reject any binary, even one it created itself. */
+      glDeleteProgram(program);
+      program = 0;
+    }
+  }
+  MEM_SAFE_FREE(binary);
+
+  if (program == 0) {
+    /* Remove the invalid file, it is written again once the shader is compiled. */
+    BLI_delete(filepath, false, false);
+  }
+  return program;
+}
+
+static void gpu_shader_cache_save(GLuint program, const char *filepath)
+{
+  GLint binary_len = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_len);
+  if (binary_len <= 0) {
+    return;
+  }
+
+  ShaderCacheHeader header;
+  memcpy(header.magic, SHADER_CACHE_MAGIC, sizeof(header.magic));
+  header.version = SHADER_CACHE_VERSION;
+  header.binary_len = binary_len;
+
+  GLenum binary_format;
+  char *binary = (char *)MEM_mallocN((size_t)binary_len, __func__);
+  glGetProgramBinary(program, binary_len, NULL, &binary_format, binary);
+  header.binary_format = binary_format;
+
+  if (!BLI_is_dir(g_shader_cache_dir)) {
+    BLI_dir_create_recursive(g_shader_cache_dir);
+  }
+
+  /* Write to a temporary file first so other sessions never read a partially written file. */
+  char filepath_tmp[FILE_MAX];
+  BLI_snprintf(filepath_tmp, sizeof(filepath_tmp), "%s@", filepath);
+
+  FILE *file = BLI_fopen(filepath_tmp, "wb");
+  if (file != NULL) {
+    const bool written = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+                         (fwrite(binary, (size_t)binary_len, 1, file) == 1);
+    fclose(file);
+    if (!written || BLI_rename(filepath_tmp, filepath) != 0) {
+      BLI_delete(filepath_tmp, false, false);
+    }
+  }
+  MEM_freeN(binary);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Creation / Destruction
  * \{ */
@@ -318,6 +478,46 @@ GPUShader *GPU_shader_create_ex(const char *vertexcode,
   /* At least a vertex shader and a fragment shader are required. */
   BLI_assert((fragcode != NULL) && (vertexcode != NULL));
 
+  gpu_shader_standard_defines(standard_defines);
+  gpu_shader_standard_extensions(standard_extensions);
+
+  char cache_filepath[FILE_MAX] = "";
+  if (gpu_shader_cache_is_enabled() && ((G.debug & G_DEBUG_GPU_SHADERS) == 0)) {
+    const char *cache_sources[] = {
+        gpu_shader_version(),
+        standard_extensions,
+        standard_defines,
+        defines,
+        vertexcode,
+        geocode,
+        libcode,
+        fragcode,
+    };
+    DynStr *ds_tf = BLI_dynstr_new();
+    BLI_dynstr_appendf(ds_tf, "%d", (int)tf_type);
+    for (int i = 0; tf_names && i < tf_count; i++) {
+      BLI_dynstr_appendf(ds_tf, " %s", tf_names[i]);
+    }
+    char *tf_key = BLI_dynstr_get_cstring(ds_tf);
+    BLI_dynstr_free(ds_tf);
+
+    const char *sources[ARRAY_SIZE(cache_sources) + 1];
+    memcpy(sources, cache_sources, sizeof(cache_sources));
+    sources[ARRAY_SIZE(cache_sources)] = tf_key;
+    gpu_shader_cache_filepath(sources, ARRAY_SIZE(sources), cache_filepath);
+    MEM_freeN(tf_key);
+
+    shader->program = gpu_shader_cache_load(cache_filepath);
+    if (shader->program) {
+      if (tf_names != NULL) {
+        shader->feedback_transform_type = tf_type;
+      }
+      glUseProgram(shader->program);
+      shader->interface = GPU_shaderinterface_create(shader->program);
+      return shader;
+    }
+  }
+
   if (vertexcode) {
     shader->vertex = glCreateShader(GL_VERTEX_SHADER);
   }
@@ -337,9 +537,6 @@ GPUShader *GPU_shader_create_ex(const char *vertexcode,
     return NULL;
   }
 
-  gpu_shader_standard_defines(standard_defines);
-  gpu_shader_standard_extensions(standard_extensions);
-
   if (vertexcode) {
     const char *source[7];
     /* custom limit, may be too small, beware */
@@ -454,6 +651,10 @@ GPUShader *GPU_shader_create_ex(const char *vertexcode,
     shader->feedback_transform_type = tf_type;
   }
 
+  if (cache_filepath[0] != '\0') {
+    glProgramParameteri(shader->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+
   glLinkProgram(shader->program);
   glGetProgramiv(shader->program, GL_LINK_STATUS, &status);
   if (!status) {
@@ -479,6 +680,10 @@ GPUShader *GPU_shader_create_ex(const char *vertexcode,
     return NULL;
   }
 
+  if (cache_filepath[0] != '\0') {
+    gpu_shader_cache_save(shader->program, cache_filepath);
+  }
+
   glUseProgram(shader->program);
   shader->interface = GPU_shaderinterface_create(shader->program);
 
@@ -516,6 +516,19 @@ void IMB_buffer_byte_from_float(unsigned char *rect_to,
                                 int height,
                                 int stride_to,
                                 int stride_from);
+void IMB_buffer_byte_from_float_ex(unsigned char *rect_to,
+                                   const float *rect_from,
+                                   int channels_from,
+                                   float dither,
+                                   int profile_to,
+                                   int profile_from,
+                                   bool predivide,
+                                   int width,
+                                   int height,
+                                   int stride_to,
+                                   int stride_from,
+                                   int dither_y,
+                                   int dither_height);
 void IMB_buffer_byte_from_float_mask(unsigned char *rect_to,
                                      const float *rect_from,
                                      int channels_from,
@@ -751,6 +764,7 @@ void IMB_update_gpu_texture_sub(struct GPUTexture *tex,
                                 int h,
                                 bool use_high_bitdepth,
                                 bool use_premult);
+struct GPUTexture *IMB_draw_gpu_texture_ensure(struct ImBuf *ibuf);
 
 /**
  *
@@ -170,6 +170,8 @@ typedef enum eImBufFlags {
   IB_thumbnail = 1 << 16,
   IB_multiview = 1 << 17,
   IB_halffloat = 1 << 18,
+  /** decode movies using hardware acceleration when available */
+  IB_animhwdecode = 1 << 19,
 } eImBufFlags;
 
 /** \} */
@@ -278,6 +280,10 @@ typedef struct ImBuf {
   int colormanage_flag;
   rcti invalid_rect;
 
+  /** texture of the pixels for drawing with the GLSL display transform,
+   * see #IMB_draw_gpu_texture_ensure */
+  struct GPUTexture *draw_gputexture;
+
   /* information for compressed textures */
   struct DDSData dds_data;
 } ImBuf;
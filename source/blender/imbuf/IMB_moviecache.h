@@ -38,6 +38,14 @@ extern "C" {
 struct ImBuf;
 struct MovieCache;
 
+/* Users with their own memory limit, see #IMB_moviecache_set_user_limit. */
+typedef enum eMovieCacheUser {
+  MOVIECACHE_USER_OTHER = 0,
+  MOVIECACHE_USER_CLIP = 1,
+  MOVIECACHE_USER_IMAGE = 2,
+  MOVIECACHE_USER_MAX = 3,
+} eMovieCacheUser;
+
 typedef void (*MovieCacheGetKeyDataFP)(void *userkey, int *framenr, int *proxy, int *render_flags);
 
 typedef void *(*MovieCacheGetPriorityDataFP)(void *userkey);
@@ -47,6 +55,9 @@ typedef void (*MovieCachePriorityDeleterFP)(void *priority_data);
 void IMB_moviecache_init(void);
 void IMB_moviecache_destruct(void);
 
+void IMB_moviecache_set_user_limit(eMovieCacheUser user, size_t limit);
+void IMB_moviecache_set_compressed_limit(size_t limit);
+
 struct MovieCache *IMB_moviecache_create(const char *name,
                                          int keysize,
                                          GHashHashFP hashfp,
@@ -57,6 +68,7 @@ void IMB_moviecache_set_priority_callback(struct MovieCache *cache,
                                           MovieCacheGetPriorityDataFP getprioritydatafp,
                                           MovieCacheGetItemPriorityFP getitempriorityfp,
                                           MovieCachePriorityDeleterFP prioritydeleterfp);
+void IMB_moviecache_set_user(struct MovieCache *cache, eMovieCacheUser user);
 
 void IMB_moviecache_put(struct MovieCache *cache, void *userkey, struct ImBuf *ibuf);
 bool IMB_moviecache_put_if_possible(struct MovieCache *cache, void *userkey, struct ImBuf *ibuf);
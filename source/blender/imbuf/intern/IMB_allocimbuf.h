@@ -48,6 +48,9 @@ void imb_mmap_unlock(void);
 bool imb_addencodedbufferImBuf(struct ImBuf *ibuf);
 bool imb_enlargeencodedbufferImBuf(struct ImBuf *ibuf);
 
+/* defined in util_gpu.c */
+void imb_free_draw_gpu_texture(struct ImBuf *ibuf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -63,6 +63,8 @@
 #  include <libavcodec/avcodec.h>
 #  include <libavformat/avformat.h>
 #  include <libswscale/swscale.h>
+
+#  include "ffmpeg_compat.h"
 #endif
 
 /* more endianness... should move to a separate file... */
@@ -131,8 +133,16 @@ struct anim {
   AVFrame *pFrameRGB;
   AVFrame *pFrameDeinterlaced;
   struct SwsContext *img_convert_ctx;
+  /* Pixel format img_convert_ctx converts from. */
+  enum AVPixelFormat img_convert_pix_fmt;
   int videoStream;
 
+#  ifdef FFMPEG_HW_DECODE_SUPPORT
+  /* Hardware decoding, frames in hw_pix_fmt are copied to pFrameHW in system memory. */
+  enum AVPixelFormat hw_pix_fmt;
+  AVFrame *pFrameHW;
+#  endif
+
   struct ImBuf *last_frame;
   int64_t last_pts;
   int64_t next_pts;
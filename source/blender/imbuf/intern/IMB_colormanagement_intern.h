@@ -93,6 +93,7 @@ void colormanagement_init(void);
 void colormanagement_exit(void);
 
 void colormanage_cache_free(struct ImBuf *ibuf);
+bool colormanage_display_buffer_changes_consume(struct ImBuf *ibuf);
 
 const char *colormanage_display_get_default_name(void);
 struct ColorManagedDisplay *colormanage_display_get_default(void);
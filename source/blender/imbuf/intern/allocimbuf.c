@@ -106,6 +106,7 @@ void imb_freerectfloatImBuf(ImBuf *ibuf)
   }
 
   imb_freemipmapImBuf(ibuf);
+  imb_free_draw_gpu_texture(ibuf);
 
   ibuf->rect_float = NULL;
   ibuf->mall &= ~IB_rectfloat;
@@ -124,6 +125,7 @@ void imb_freerectImBuf(ImBuf *ibuf)
   ibuf->rect = NULL;
 
   imb_freemipmapImBuf(ibuf);
+  imb_free_draw_gpu_texture(ibuf);
 
   ibuf->mall &= ~IB_rect;
 }
@@ -621,6 +623,7 @@ ImBuf *IMB_dupImBuf(const ImBuf *ibuf1)
 
   tbuf.display_buffer_flags = NULL;
   tbuf.colormanage_cache = NULL;
+  tbuf.draw_gputexture = NULL;
 
   *ibuf2 = tbuf;
 
@@ -55,6 +55,7 @@
 
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "MEM_guardedalloc.h"
@@ -82,6 +83,10 @@
 #  include <libswscale/swscale.h>
 
 #  include "ffmpeg_compat.h"
+
+#  ifdef FFMPEG_HW_DECODE_SUPPORT
+#    include <libavutil/hwcontext.h>
+#  endif
 #endif  // WITH_FFMPEG
 
 int ismovie(const char *UNUSED(filepath))
@@ -505,6 +510,123 @@ BLI_INLINE bool need_aligned_ffmpeg_buffer(struct anim *anim)
   return (anim->x & 31) != 0;
 }
 
+/* (Re)create context converting frames in pix_fmt to RGBA. */
+static bool ffmpeg_sws_context_create(struct anim *anim, enum AVPixelFormat pix_fmt)
+{
+#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
+  /* The following for color space determination */
+  int srcRange, dstRange, brightness, contrast, saturation;
+  int *table;
+  const int *inv_table;
+#  endif
+
+  if (anim->img_convert_ctx) {
+    sws_freeContext(anim->img_convert_ctx);
+  }
+
+  anim->img_convert_pix_fmt = pix_fmt;
+  anim->img_convert_ctx = sws_getContext(anim->x,
+                                         anim->y,
+                                         pix_fmt,
+                                         anim->x,
+                                         anim->y,
+                                         AV_PIX_FMT_RGBA,
+                                         SWS_FAST_BILINEAR | SWS_PRINT_INFO | SWS_FULL_CHR_H_INT,
+                                         NULL,
+                                         NULL,
+                                         NULL);
+
+  if (!anim->img_convert_ctx) {
+    return false;
+  }
+
+#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
+  /* Try do detect if input has 0-255 YCbCR range (JFIF Jpeg MotionJpeg) */
+  if (!sws_getColorspaceDetails(anim->img_convert_ctx,
+                                (int **)&inv_table,
+                                &srcRange,
+                                &table,
+                                &dstRange,
+                                &brightness,
+                                &contrast,
+                                &saturation)) {
+    srcRange = srcRange || anim->pCodecCtx->color_range == AVCOL_RANGE_JPEG;
+    inv_table = sws_getCoefficients(anim->pCodecCtx->colorspace);
+
+    if (sws_setColorspaceDetails(anim->img_convert_ctx,
+                                 (int *)inv_table,
+                                 srcRange,
+                                 table,
+                                 dstRange,
+                                 brightness,
+                                 contrast,
+                                 saturation)) {
+      fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+    }
+  }
+  else {
+    fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+  }
+#  endif
+
+  return true;
+}
+
+#  ifdef FFMPEG_HW_DECODE_SUPPORT
+static enum AVPixelFormat ffmpeg_get_hw_format(AVCodecContext *pCodecCtx,
+                                               const enum AVPixelFormat *pix_fmts)
+{
+  struct anim *anim = pCodecCtx->opaque;
+
+  for (const enum AVPixelFormat *pix_fmt = pix_fmts; *pix_fmt != AV_PIX_FMT_NONE; pix_fmt++) {
+    if (*pix_fmt == anim->hw_pix_fmt) {
+      return *pix_fmt;
+    }
+  }
+
+  /* The device can't decode this stream, decode in software. */
+  av_log(pCodecCtx, AV_LOG_INFO, "Hardware decoding not supported for stream\n");
+  return avcodec_default_get_format(pCodecCtx, pix_fmts);
+}
+
+/* Use the first hardware device which supports the codec and can be created, VAAPI, NVDEC,
+ * VideoToolbox or D3D11VA depending on the platform and how FFmpeg was built. Frames are still
+ * copied to system memory, but decoding itself doesn't use the CPU anymore. */
+static void ffmpeg_hw_decode_init(struct anim *anim, AVCodecContext *pCodecCtx, AVCodec *pCodec)
+{
+  anim->hw_pix_fmt = AV_PIX_FMT_NONE;
+
+  /* Deinterlacing is done on frames in the decoder pixel format. */
+  if (!(anim->ib_flags & IB_animhwdecode) || (anim->ib_flags & IB_animdeinterlace)) {
+    return;
+  }
+
+  for (int i = 0;; i++) {
+    const AVCodecHWConfig *config = avcodec_get_hw_config(pCodec, i);
+    if (config == NULL) {
+      break;
+    }
+    if (!(config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX)) {
+      continue;
+    }
+    /* Owned by the codec context from now on. */
+    if (av_hwdevice_ctx_create(&pCodecCtx->hw_device_ctx, config->device_type, NULL, NULL, 0) <
+        0) {
+      continue;
+    }
+
+    av_log(pCodecCtx,
+           AV_LOG_INFO,
+           "Using %s hardware decoding\n",
+           av_hwdevice_get_type_name(config->device_type));
+    anim->hw_pix_fmt = config->pix_fmt;
+    pCodecCtx->opaque = anim;
+    pCodecCtx->get_format = ffmpeg_get_hw_format;
+    return;
+  }
+}
+#  endif
+
 static int startffmpeg(struct anim *anim)
 {
   int i, video_stream_index;
@@ -518,13 +640,6 @@ static int startffmpeg(struct anim *anim)
   double frs_den;
   int streamcount;
 
-#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
-  /* The following for color space determination */
-  int srcRange, dstRange, brightness, contrast, saturation;
-  int *table;
-  const int *inv_table;
-#  endif
-
   if (anim == NULL) {
     return (-1);
   }
@@ -573,6 +688,10 @@ static int startffmpeg(struct anim *anim)
 
   pCodecCtx->workaround_bugs = 1;
 
+#  ifdef FFMPEG_HW_DECODE_SUPPORT
+  ffmpeg_hw_decode_init(anim, pCodecCtx, pCodec);
+#  endif
+
   if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0) {
     avformat_close_input(&pFormatCtx);
     return -1;
@@ -645,6 +764,9 @@ static int startffmpeg(struct anim *anim)
   anim->pFrameComplete = false;
   anim->pFrameDeinterlaced = av_frame_alloc();
   anim->pFrameRGB = av_frame_alloc();
+#  ifdef FFMPEG_HW_DECODE_SUPPORT
+  anim->pFrameHW = av_frame_alloc();
+#  endif
 
   if (need_aligned_ffmpeg_buffer(anim)) {
     anim->pFrameRGB->format = AV_PIX_FMT_RGBA;
@@ -692,18 +814,10 @@ static int startffmpeg(struct anim *anim)
     anim->preseek = 0;
   }
 
-  anim->img_convert_ctx = sws_getContext(anim->x,
-                                         anim->y,
-                                         anim->pCodecCtx->pix_fmt,
-                                         anim->x,
-                                         anim->y,
-                                         AV_PIX_FMT_RGBA,
-                                         SWS_FAST_BILINEAR | SWS_PRINT_INFO | SWS_FULL_CHR_H_INT,
-                                         NULL,
-                                         NULL,
-                                         NULL);
-
-  if (!anim->img_convert_ctx) {
+  /* With hardware decoding the context is created again when the format of copied frames is
+   * known. */
+  anim->img_convert_ctx = NULL;
+  if (!ffmpeg_sws_context_create(anim, anim->pCodecCtx->pix_fmt)) {
     fprintf(stderr, "Can't transform color space??? Bailing out...\n");
     avcodec_close(anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -714,37 +828,140 @@ static int startffmpeg(struct anim *anim)
     return -1;
   }
 
+  return (0);
+}
+
 #  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
-  /* Try do detect if input has 0-255 YCbCR range (JFIF Jpeg MotionJpeg) */
-  if (!sws_getColorspaceDetails(anim->img_convert_ctx,
-                                (int **)&inv_table,
-                                &srcRange,
-                                &table,
-                                &dstRange,
-                                &brightness,
-                                &contrast,
-                                &saturation)) {
-    srcRange = srcRange || anim->pCodecCtx->color_range == AVCOL_RANGE_JPEG;
-    inv_table = sws_getCoefficients(anim->pCodecCtx->colorspace);
+typedef struct FFmpegYUVConvertData {
+  const AVFrame *frame;
+  unsigned char *rect;
+  int width, height;
+  /* Chroma subsampling, and distance between chroma samples of a row. */
+  int chroma_shift_x, chroma_shift_y;
+  int chroma_step;
+  /* 16.16 fixed point conversion coefficients. */
+  int y_offset, y_mul;
+  int v_r, u_g, v_g, u_b;
+} FFmpegYUVConvertData;
+
+BLI_INLINE unsigned char ffmpeg_yuv_clamp(int value)
+{
+  return (value < 0) ? 0 : (value > 255) ? 255 : (unsigned char)value;
+}
 
-    if (sws_setColorspaceDetails(anim->img_convert_ctx,
-                                 (int *)inv_table,
-                                 srcRange,
-                                 table,
-                                 dstRange,
-                                 brightness,
-                                 contrast,
-                                 saturation)) {
-      fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+static void ffmpeg_yuv_to_rgba_row(void *__restrict userdata,
+                                   const int y,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const FFmpegYUVConvertData *data = userdata;
+  const AVFrame *frame = data->frame;
+  const int chroma_y = y >> data->chroma_shift_y;
+  const int chroma_step = data->chroma_step;
+  const int chroma_last = ((data->width - 1) >> data->chroma_shift_x) * chroma_step;
+  const uint8_t *src_y = frame->data[0] + (size_t)y * frame->linesize[0];
+  const uint8_t *src_u = frame->data[1] + (size_t)chroma_y * frame->linesize[1];
+  /* NV12 has interleaved U and V samples in the second plane. */
+  const uint8_t *src_v = (chroma_step == 2) ?
+                             src_u + 1 :
+                             frame->data[2] + (size_t)chroma_y * frame->linesize[2];
+  /* ImBuf rows are stored bottom to top. */
+  unsigned char *dst = data->rect + (size_t)(data->height - 1 - y) * data->width * 4;
+
+  for (int x = 0; x < data->width; x++) {
+    const int chroma_x = (x >> data->chroma_shift_x) * chroma_step;
+    int u = src_u[chroma_x];
+    int v = src_v[chroma_x];
+
+    /* Pixels between chroma samples get their average, like SWS_FULL_CHR_H_INT. */
+    if ((x & data->chroma_shift_x) && chroma_x < chroma_last) {
+      u = (u + src_u[chroma_x + chroma_step] + 1) >> 1;
+      v = (v + src_v[chroma_x + chroma_step] + 1) >> 1;
     }
+    u -= 128;
+    v -= 128;
+
+    const int luma = (src_y[x] - data->y_offset) * data->y_mul + (1 << 15);
+    dst[0] = ffmpeg_yuv_clamp((luma + data->v_r * v) >> 16);
+    dst[1] = ffmpeg_yuv_clamp((luma - data->u_g * u - data->v_g * v) >> 16);
+    dst[2] = ffmpeg_yuv_clamp((luma + data->u_b * u) >> 16);
+    dst[3] = 255;
+    dst += 4;
+  }
+}
+
+/* Convert common 8 bit YUV formats straight into the flipped ImBuf, one row per task, instead of
+ * converting the whole frame with swscale on a single thread and flipping or copying it after.
+ * Returns false for other formats, which still go through swscale. */
+static bool ffmpeg_yuv_to_rgba(struct anim *anim, const AVFrame *input, ImBuf *ibuf)
+{
+  FFmpegYUVConvertData data;
+  bool full_range = anim->pCodecCtx->color_range == AVCOL_RANGE_JPEG;
+
+  data.chroma_step = 1;
+
+  switch (anim->img_convert_pix_fmt) {
+    case AV_PIX_FMT_YUVJ420P:
+      full_range = true;
+      ATTR_FALLTHROUGH;
+    case AV_PIX_FMT_YUV420P:
+      data.chroma_shift_x = 1;
+      data.chroma_shift_y = 1;
+      break;
+    case AV_PIX_FMT_YUVJ422P:
+      full_range = true;
+      ATTR_FALLTHROUGH;
+    case AV_PIX_FMT_YUV422P:
+      data.chroma_shift_x = 1;
+      data.chroma_shift_y = 0;
+      break;
+    case AV_PIX_FMT_YUVJ444P:
+      full_range = true;
+      ATTR_FALLTHROUGH;
+    case AV_PIX_FMT_YUV444P:
+      data.chroma_shift_x = 0;
+      data.chroma_shift_y = 0;
+      break;
+    case AV_PIX_FMT_NV12:
+      data.chroma_shift_x = 1;
+      data.chroma_shift_y = 1;
+      data.chroma_step = 2;
+      break;
+    default:
+      return false;
+  }
+
+  /* Same matrices as swscale, for limited range chroma. */
+  const int *coefficients = sws_getCoefficients(anim->pCodecCtx->colorspace);
+  if (full_range) {
+    data.y_offset = 0;
+    data.y_mul = 1 << 16;
+    data.v_r = coefficients[0] * 224 / 255;
+    data.u_b = coefficients[1] * 224 / 255;
+    data.u_g = coefficients[2] * 224 / 255;
+    data.v_g = coefficients[3] * 224 / 255;
   }
   else {
-    fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
+    data.y_offset = 16;
+    data.y_mul = (int)(65536.0 * 255.0 / 219.0 + 0.5);
+    data.v_r = coefficients[0];
+    data.u_b = coefficients[1];
+    data.u_g = coefficients[2];
+    data.v_g = coefficients[3];
   }
-#  endif
 
-  return (0);
+  data.frame = input;
+  data.rect = (unsigned char *)ibuf->rect;
+  data.width = anim->x;
+  data.height = anim->y;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 16;
+  BLI_task_parallel_range(0, anim->y, &data, ffmpeg_yuv_to_rgba_row, &settings);
+
+  return true;
 }
+#  endif
 
 /* postprocess the image in anim->pFrame and do color conversion
  * and deinterlacing stuff.
@@ -779,6 +996,25 @@ static void ffmpeg_postprocess(struct anim *anim)
          input->data[2],
          input->data[3]);
 
+#  ifdef FFMPEG_HW_DECODE_SUPPORT
+  if (input->format == anim->hw_pix_fmt && anim->hw_pix_fmt != AV_PIX_FMT_NONE) {
+    /* Copy frame from the device, usually in NV12 format. */
+    av_frame_unref(anim->pFrameHW);
+    if (av_hwframe_transfer_data(anim->pFrameHW, input, 0) < 0) {
+      fprintf(stderr, "ffmpeg_fetchibuf: failed to copy frame from hardware decoder\n");
+      return;
+    }
+    input = anim->pFrameHW;
+  }
+#  endif
+
+  if (input->format != anim->img_convert_pix_fmt) {
+    if (!ffmpeg_sws_context_create(anim, input->format)) {
+      fprintf(stderr, "Can't transform color space??? Bailing out...\n");
+      return;
+    }
+  }
+
   if (anim->ib_flags & IB_animdeinterlace) {
     if (avpicture_deinterlace((AVPicture *)anim->pFrameDeinterlaced,
                               (const AVPicture *)anim->pFrame,
@@ -792,6 +1028,15 @@ static void ffmpeg_postprocess(struct anim *anim)
     }
   }
 
+#  ifdef FFMPEG_SWSCALE_COLOR_SPACE_SUPPORT
+  if (ffmpeg_yuv_to_rgba(anim, input, ibuf)) {
+    if (filter_y) {
+      IMB_filtery(ibuf);
+    }
+    return;
+  }
+#  endif
+
   if (!need_aligned_ffmpeg_buffer(anim)) {
     avpicture_fill((AVPicture *)anim->pFrameRGB,
                    (unsigned char *)ibuf->rect,
@@ -1270,6 +1515,9 @@ static void free_anim_ffmpeg(struct anim *anim)
     }
     av_frame_free(&anim->pFrameRGB);
     av_frame_free(&anim->pFrameDeinterlaced);
+#  ifdef FFMPEG_HW_DECODE_SUPPORT
+    av_frame_free(&anim->pFrameHW);
+#  endif
 
     sws_freeContext(anim->img_convert_ctx);
     IMB_freeImBuf(anim->last_frame);
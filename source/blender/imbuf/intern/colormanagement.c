@@ -787,6 +787,33 @@ void colormanage_cache_free(ImBuf *ibuf)
   }
 }
 
+/* Consume the changes of pixels marked for display buffers, for drawing code keeping its own
+ * copy of the pixels. Display buffers are invalidated as a whole, since the changed region is
+ * no longer known when acquiring them. Returns true when the pixels changed. */
+bool colormanage_display_buffer_changes_consume(ImBuf *ibuf)
+{
+  bool changed = false;
+
+  BLI_thread_lock(LOCK_COLORMANAGE);
+
+  if (ibuf->invalid_rect.xmin != ibuf->invalid_rect.xmax) {
+    BLI_rcti_init(&ibuf->invalid_rect, 0, 0, 0, 0);
+    ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+  }
+
+  if (ibuf->userflags & IB_DISPLAY_BUFFER_INVALID) {
+    if (ibuf->display_buffer_flags) {
+      memset(ibuf->display_buffer_flags, 0, global_tot_display * sizeof(unsigned int));
+    }
+    ibuf->userflags &= ~IB_DISPLAY_BUFFER_INVALID;
+    changed = true;
+  }
+
+  BLI_thread_unlock(LOCK_COLORMANAGE);
+
+  return changed;
+}
+
 void IMB_colormanagement_display_settings_from_ctx(
     const bContext *C,
     ColorManagedViewSettings **r_view_settings,
@@ -1465,6 +1492,8 @@ const float *IMB_colormangement_get_xyz_to_rgb()
 
 typedef struct DisplayBufferThread {
   ColormanageProcessor *cm_processor;
+  /* Transform of the buffer to scene linear, NULL when it is already linear. */
+  ColormanageProcessor *linear_processor;
 
   const float *buffer;
   unsigned char *byte_buffer;
@@ -1480,14 +1509,12 @@ typedef struct DisplayBufferThread {
   float dither;
   bool is_data;
   bool predivide;
-
-  const char *byte_colorspace;
-  const char *float_colorspace;
 } DisplayBufferThread;
 
 typedef struct DisplayBufferInitData {
   ImBuf *ibuf;
   ColormanageProcessor *cm_processor;
+  ColormanageProcessor *linear_processor;
   const float *buffer;
   unsigned char *byte_buffer;
 
@@ -1495,11 +1522,12 @@ typedef struct DisplayBufferInitData {
   unsigned char *display_buffer_byte;
 
   int width;
-
-  const char *byte_colorspace;
-  const char *float_colorspace;
 } DisplayBufferInitData;
 
+/* Number of floats of the intermediate buffer converted at once, small enough for all
+ * conversion steps to work on data in the CPU cache. */
+#define DISPLAY_BUFFER_BLOCK_SIZE (64 * 1024)
+
 static void display_buffer_init_handle(void *handle_v,
                                        int start_line,
                                        int tot_line,
@@ -1519,6 +1547,7 @@ static void display_buffer_init_handle(void *handle_v,
   memset(handle, 0, sizeof(DisplayBufferThread));
 
   handle->cm_processor = init_data->cm_processor;
+  handle->linear_processor = init_data->linear_processor;
 
   if (init_data->buffer) {
     handle->buffer = init_data->buffer + offset;
@@ -1545,9 +1574,6 @@ static void display_buffer_init_handle(void *handle_v,
   handle->dither = dither;
   handle->is_data = is_data;
   handle->predivide = IMB_alpha_affects_rgb(ibuf);
-
-  handle->byte_colorspace = init_data->byte_colorspace;
-  handle->float_colorspace = init_data->float_colorspace;
 }
 
 static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
@@ -1560,16 +1586,11 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
 
   size_t buffer_size = ((size_t)channels) * width * height;
 
-  bool is_data = handle->is_data;
-  bool is_data_display = handle->cm_processor->is_data_result;
   bool predivide = handle->predivide;
 
   if (!handle->buffer) {
     unsigned char *byte_buffer = handle->byte_buffer;
 
-    const char *from_colorspace = handle->byte_colorspace;
-    const char *to_colorspace = global_role_scene_linear;
-
     float *fp;
     unsigned char *cp;
     const size_t i_last = ((size_t)width) * height;
@@ -1589,33 +1610,14 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
       }
     }
 
-    if (!is_data && !is_data_display) {
+    if (handle->linear_processor) {
       /* convert float buffer to scene linear space */
-      IMB_colormanagement_transform(
-          linear_buffer, width, height, channels, from_colorspace, to_colorspace, false);
+      IMB_colormanagement_processor_apply(
+          handle->linear_processor, linear_buffer, width, height, channels, false);
     }
 
     *is_straight_alpha = true;
   }
-  else if (handle->float_colorspace) {
-    /* currently float is non-linear only in sequencer, which is working
-     * in it's own color space even to handle float buffers.
-     * This color space is the same for byte and float images.
-     * Need to convert float buffer to linear space before applying display transform
-     */
-
-    const char *from_colorspace = handle->float_colorspace;
-    const char *to_colorspace = global_role_scene_linear;
-
-    memcpy(linear_buffer, handle->buffer, buffer_size * sizeof(float));
-
-    if (!is_data && !is_data_display) {
-      IMB_colormanagement_transform(
-          linear_buffer, width, height, channels, from_colorspace, to_colorspace, predivide);
-    }
-
-    *is_straight_alpha = false;
-  }
   else {
     /* some processors would want to modify float original buffer
      * before converting it into display byte buffer, so we need to
@@ -1625,10 +1627,92 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
 
     memcpy(linear_buffer, handle->buffer, buffer_size * sizeof(float));
 
+    if (handle->linear_processor) {
+      /* currently float is non-linear only in sequencer, which is working
+       * in it's own color space even to handle float buffers.
+       * This color space is the same for byte and float images.
+       * Need to convert float buffer to linear space before applying display transform
+       */
+      IMB_colormanagement_processor_apply(
+          handle->linear_processor, linear_buffer, width, height, channels, predivide);
+    }
+
     *is_straight_alpha = false;
   }
 }
 
+/* Apply all conversion steps to tot_line lines starting at line of the lines of the handle. */
+static void display_buffer_apply_block(DisplayBufferThread *handle,
+                                       int line,
+                                       int tot_line,
+                                       float *linear_buffer)
+{
+  DisplayBufferThread block = *handle;
+  int channels = handle->channels;
+  int width = handle->width;
+  size_t offset = ((size_t)channels) * line * width;
+  bool is_straight_alpha;
+
+  if (block.buffer) {
+    block.buffer += offset;
+  }
+  if (block.byte_buffer) {
+    block.byte_buffer += offset;
+  }
+  block.start_line += line;
+  block.tot_line = tot_line;
+
+  display_buffer_apply_get_linear_buffer(&block, tot_line, linear_buffer, &is_straight_alpha);
+
+  bool predivide = handle->predivide && (is_straight_alpha == false);
+
+  if (handle->is_data) {
+    /* special case for data buffers - no color space conversions,
+     * only generate byte buffers
+     */
+  }
+  else {
+    /* apply processor */
+    IMB_colormanagement_processor_apply(
+        handle->cm_processor, linear_buffer, width, tot_line, channels, predivide);
+  }
+
+  /* copy result to output buffers */
+  if (handle->display_buffer_byte) {
+    /* do conversion, with the dither pattern of the whole handle */
+    IMB_buffer_byte_from_float_ex(handle->display_buffer_byte +
+                                      ((size_t)DISPLAY_BUFFER_CHANNELS) * line * width,
+                                  linear_buffer,
+                                  channels,
+                                  handle->dither,
+                                  IB_PROFILE_SRGB,
+                                  IB_PROFILE_SRGB,
+                                  predivide,
+                                  width,
+                                  tot_line,
+                                  width,
+                                  width,
+                                  line,
+                                  handle->tot_line);
+  }
+
+  if (handle->display_buffer) {
+    float *display_buffer = handle->display_buffer + offset;
+
+    memcpy(display_buffer, linear_buffer, ((size_t)width) * tot_line * channels * sizeof(float));
+
+    if (is_straight_alpha && channels == 4) {
+      const size_t i_last = ((size_t)width) * tot_line;
+      size_t i;
+      float *fp;
+
+      for (i = 0, fp = display_buffer; i != i_last; i++, fp += channels) {
+        straight_to_premul_v4(fp);
+      }
+    }
+  }
+}
+
 static void *do_display_buffer_apply_thread(void *handle_v)
 {
   DisplayBufferThread *handle = (DisplayBufferThread *)handle_v;
@@ -1638,8 +1722,6 @@ static void *do_display_buffer_apply_thread(void *handle_v)
   int channels = handle->channels;
   int width = handle->width;
   int height = handle->tot_line;
-  float dither = handle->dither;
-  bool is_data = handle->is_data;
 
   if (cm_processor == NULL) {
     if (display_buffer_byte && display_buffer_byte != handle->byte_buffer) {
@@ -1667,53 +1749,16 @@ static void *do_display_buffer_apply_thread(void *handle_v)
     }
   }
   else {
-    bool is_straight_alpha;
-    float *linear_buffer = MEM_mallocN(((size_t)channels) * width * height * sizeof(float),
+    /* Convert a few lines at a time instead of doing every step on all lines,
+     * so the intermediate buffer isn't evicted from the cache between the steps. */
+    const int block_lines = min_ii(height,
+                                   max_ii(1, DISPLAY_BUFFER_BLOCK_SIZE / (width * channels)));
+    float *linear_buffer = MEM_mallocN(((size_t)channels) * width * block_lines * sizeof(float),
                                        "color conversion linear buffer");
 
-    display_buffer_apply_get_linear_buffer(handle, height, linear_buffer, &is_straight_alpha);
-
-    bool predivide = handle->predivide && (is_straight_alpha == false);
-
-    if (is_data) {
-      /* special case for data buffers - no color space conversions,
-       * only generate byte buffers
-       */
-    }
-    else {
-      /* apply processor */
-      IMB_colormanagement_processor_apply(
-          cm_processor, linear_buffer, width, height, channels, predivide);
-    }
-
-    /* copy result to output buffers */
-    if (display_buffer_byte) {
-      /* do conversion */
-      IMB_buffer_byte_from_float(display_buffer_byte,
-                                 linear_buffer,
-                                 channels,
-                                 dither,
-                                 IB_PROFILE_SRGB,
-                                 IB_PROFILE_SRGB,
-                                 predivide,
-                                 width,
-                                 height,
-                                 width,
-                                 width);
-    }
-
-    if (display_buffer) {
-      memcpy(display_buffer, linear_buffer, ((size_t)width) * height * channels * sizeof(float));
-
-      if (is_straight_alpha && channels == 4) {
-        const size_t i_last = ((size_t)width) * height;
-        size_t i;
-        float *fp;
-
-        for (i = 0, fp = display_buffer; i != i_last; i++, fp += channels) {
-          straight_to_premul_v4(fp);
-        }
-      }
+    for (int line = 0; line < height; line += block_lines) {
+      display_buffer_apply_block(
+          handle, line, min_ii(block_lines, height - line), linear_buffer);
     }
 
     MEM_freeN(linear_buffer);
@@ -1730,30 +1775,39 @@ static void display_buffer_apply_threaded(ImBuf *ibuf,
                                           ColormanageProcessor *cm_processor)
 {
   DisplayBufferInitData init_data;
+  const char *from_colorspace = NULL;
 
   init_data.ibuf = ibuf;
   init_data.cm_processor = cm_processor;
+  init_data.linear_processor = NULL;
   init_data.buffer = buffer;
   init_data.byte_buffer = byte_buffer;
   init_data.display_buffer = display_buffer;
   init_data.display_buffer_byte = display_buffer_byte;
 
-  if (ibuf->rect_colorspace != NULL) {
-    init_data.byte_colorspace = ibuf->rect_colorspace->name;
-  }
-  else {
-    /* happens for viewer images, which are not so simple to determine where to
-     * set image buffer's color spaces
-     */
-    init_data.byte_colorspace = global_role_default_byte;
+  if (buffer == NULL) {
+    if (ibuf->rect_colorspace != NULL) {
+      from_colorspace = ibuf->rect_colorspace->name;
+    }
+    else {
+      /* happens for viewer images, which are not so simple to determine where to
+       * set image buffer's color spaces
+       */
+      from_colorspace = global_role_default_byte;
+    }
   }
-
-  if (ibuf->float_colorspace != NULL) {
+  else if (ibuf->float_colorspace != NULL) {
     /* sequencer stores float buffers in non-linear space */
-    init_data.float_colorspace = ibuf->float_colorspace->name;
+    from_colorspace = ibuf->float_colorspace->name;
   }
-  else {
-    init_data.float_colorspace = NULL;
+
+  /* The transform to scene linear is created once here, rather than for every part
+   * of the buffer converted by the threads. */
+  if (cm_processor && from_colorspace && from_colorspace[0] != '\0' &&
+      !STREQ(from_colorspace, global_role_scene_linear) &&
+      (ibuf->colormanage_flag & IMB_COLORMANAGE_IS_DATA) == 0 && !cm_processor->is_data_result) {
+    init_data.linear_processor = IMB_colormanagement_colorspace_processor_new(
+        from_colorspace, global_role_scene_linear);
   }
 
   IMB_processor_apply_threaded(ibuf->y,
@@ -1761,6 +1815,10 @@ static void display_buffer_apply_threaded(ImBuf *ibuf,
                                &init_data,
                                display_buffer_init_handle,
                                do_display_buffer_apply_thread);
+
+  if (init_data.linear_processor) {
+    IMB_colormanagement_processor_free(init_data.linear_processor);
+  }
 }
 
 static bool is_ibuf_rect_in_display_space(ImBuf *ibuf,
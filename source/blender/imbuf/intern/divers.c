@@ -102,24 +102,28 @@ bool IMB_alpha_affects_rgb(const ImBuf *ibuf)
   return (ibuf->flags & IB_alphamode_channel_packed) == 0;
 }
 
-/* float to byte pixels, output 4-channel RGBA */
-void IMB_buffer_byte_from_float(uchar *rect_to,
-                                const float *rect_from,
-                                int channels_from,
-                                float dither,
-                                int profile_to,
-                                int profile_from,
-                                bool predivide,
-                                int width,
-                                int height,
-                                int stride_to,
-                                int stride_from)
+/* float to byte pixels, output 4-channel RGBA,
+ * the rows are lines dither_y to dither_y + height of a buffer of dither_height lines,
+ * so converting a buffer in parts gives the same dither pattern as converting it at once */
+void IMB_buffer_byte_from_float_ex(uchar *rect_to,
+                                   const float *rect_from,
+                                   int channels_from,
+                                   float dither,
+                                   int profile_to,
+                                   int profile_from,
+                                   bool predivide,
+                                   int width,
+                                   int height,
+                                   int stride_to,
+                                   int stride_from,
+                                   int dither_y,
+                                   int dither_height)
 {
   float tmp[4];
   int x, y;
   DitherContext *di = NULL;
   float inv_width = 1.0f / width;
-  float inv_height = 1.0f / height;
+  float inv_height = 1.0f / dither_height;
 
   /* we need valid profiles */
   BLI_assert(profile_to != IB_PROFILE_NONE);
@@ -130,7 +134,7 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
   }
 
   for (y = 0; y < height; y++) {
-    float t = y * inv_height;
+    float t = (dither_y + y) * inv_height;
 
     if (channels_from == 1) {
       /* single channel input */
@@ -269,6 +273,34 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
   }
 }
 
+/* float to byte pixels, output 4-channel RGBA */
+void IMB_buffer_byte_from_float(uchar *rect_to,
+                                const float *rect_from,
+                                int channels_from,
+                                float dither,
+                                int profile_to,
+                                int profile_from,
+                                bool predivide,
+                                int width,
+                                int height,
+                                int stride_to,
+                                int stride_from)
+{
+  IMB_buffer_byte_from_float_ex(rect_to,
+                                rect_from,
+                                channels_from,
+                                dither,
+                                profile_to,
+                                profile_from,
+                                predivide,
+                                width,
+                                height,
+                                stride_to,
+                                stride_from,
+                                0,
+                                height);
+}
+
 /* float to byte pixels, output 4-channel RGBA */
 void IMB_buffer_byte_from_float_mask(uchar *rect_to,
                                      const float *rect_from,
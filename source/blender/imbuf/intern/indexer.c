@@ -29,6 +29,7 @@
 #include "BLI_ghash.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #ifdef _WIN32
 #  include "BLI_winstuff.h"
@@ -541,6 +542,10 @@ static struct proxy_output_ctx *alloc_proxy_output_ffmpeg(
     return 0;
   }
 
+  /* Proxies are intra only, encode several frames at once. */
+  rv->c->thread_count = 0;
+  rv->c->thread_type = FF_THREAD_FRAME;
+
   avcodec_open2(rv->c, rv->codec, NULL);
 
   rv->orig_height = av_get_cropped_height_from_codec(st->codec);
@@ -686,6 +691,16 @@ static void free_proxy_output_ffmpeg(struct proxy_output_ctx *ctx, int rollback)
   MEM_freeN(ctx);
 }
 
+/* Key frames remembered to find the seek position of delayed frames, the delay of threaded
+ * decoding can span many key frames of intra only movies. */
+#define FFMPEG_INDEX_SEEK_POINTS_MAX 64
+
+typedef struct FFmpegIndexSeekPoint {
+  unsigned long long pos;
+  unsigned long long dts;
+  unsigned long long pts;
+} FFmpegIndexSeekPoint;
+
 typedef struct FFmpegIndexBuilderContext {
   int anim_type;
 
@@ -704,11 +719,9 @@ typedef struct FFmpegIndexBuilderContext {
   IMB_Timecode_Type tcs_in_use;
   IMB_Proxy_Size proxy_sizes_in_use;
 
-  unsigned long long seek_pos;
-  unsigned long long last_seek_pos;
-  unsigned long long seek_pos_dts;
-  unsigned long long seek_pos_pts;
-  unsigned long long last_seek_pos_dts;
+  /* Ring buffer of the most recent key frames in decoding order. */
+  FFmpegIndexSeekPoint seek_points[FFMPEG_INDEX_SEEK_POINTS_MAX];
+  int num_seek_points;
   unsigned long long start_pts;
   double frame_rate;
   double pts_time_base;
@@ -779,6 +792,9 @@ static IndexBuildContext *index_ffmpeg_create_context(struct anim *anim,
   }
 
   context->iCodecCtx->workaround_bugs = 1;
+  /* Decoding is usually the bottleneck of building proxies and timecodes. */
+  context->iCodecCtx->thread_count = 0;
+  context->iCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
 
   if (avcodec_open2(context->iCodecCtx, context->iCodec, NULL) < 0) {
     avformat_close_input(&context->iFormatCtx);
@@ -839,18 +855,71 @@ static void index_rebuild_ffmpeg_finish(FFmpegIndexBuilderContext *context, int
   MEM_freeN(context);
 }
 
+static void index_rebuild_ffmpeg_add_seek_point(FFmpegIndexBuilderContext *context,
+                                                AVPacket *packet)
+{
+  FFmpegIndexSeekPoint *point =
+      &context->seek_points[context->num_seek_points % FFMPEG_INDEX_SEEK_POINTS_MAX];
+
+  point->pos = packet->pos;
+  point->dts = packet->dts;
+  /* Compare against the decoding time when the container doesn't store presentation times. */
+  point->pts = (packet->pts != AV_NOPTS_VALUE) ? packet->pts : packet->dts;
+  context->num_seek_points++;
+}
+
+/* Find the last key frame before \a pts, decoding starts *always* on I-Frames,
+ * so: P-Frames won't work, even if all the information is in place, when we seek
+ * to the I-Frame presented *after* the P-Frame, but located before the P-Frame
+ * within the stream. */
+static const FFmpegIndexSeekPoint *index_rebuild_ffmpeg_find_seek_point(
+    FFmpegIndexBuilderContext *context, unsigned long long pts)
+{
+  static const FFmpegIndexSeekPoint start_point = {0};
+  const int num_points = MIN2(context->num_seek_points, FFMPEG_INDEX_SEEK_POINTS_MAX);
+  const FFmpegIndexSeekPoint *point = &start_point;
+  int i;
+
+  for (i = 0; i < num_points; i++) {
+    point = &context->seek_points[(context->num_seek_points - 1 - i) %
+                                  FFMPEG_INDEX_SEEK_POINTS_MAX];
+    if (point->pts <= pts) {
+      break;
+    }
+  }
+
+  return point;
+}
+
+typedef struct FFmpegProxyEncodeData {
+  FFmpegIndexBuilderContext *context;
+  AVFrame *frame;
+} FFmpegProxyEncodeData;
+
+static void index_rebuild_ffmpeg_encode_proxy(void *__restrict userdata,
+                                              const int i,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  FFmpegProxyEncodeData *data = userdata;
+  add_to_proxy_output_ffmpeg(data->context->proxy_ctx[i], data->frame);
+}
+
 static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *context,
                                                     AVPacket *curr_packet,
                                                     AVFrame *in_frame)
 {
   int i;
-  unsigned long long s_pos = context->seek_pos;
-  unsigned long long s_dts = context->seek_pos_dts;
   unsigned long long pts = av_get_pts_from_frame(context->iFormatCtx, in_frame);
+  const FFmpegIndexSeekPoint *seek_point;
 
-  for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
-  }
+  /* Every proxy size has its own scaler, encoder and file, so they can be written in
+   * parallel. The decoded frame is only read. */
+  FFmpegProxyEncodeData data = {context, in_frame};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0, context->num_proxy_sizes, &data, index_rebuild_ffmpeg_encode_proxy, &settings);
 
   if (!context->start_pts_set) {
     context->start_pts = pts;
@@ -860,17 +929,7 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
   context->frameno = floor(
       (pts - context->start_pts) * context->pts_time_base * context->frame_rate + 0.5);
 
-  /* decoding starts *always* on I-Frames,
-   * so: P-Frames won't work, even if all the
-   * information is in place, when we seek
-   * to the I-Frame presented *after* the P-Frame,
-   * but located before the P-Frame within
-   * the stream */
-
-  if (pts < context->seek_pos_pts) {
-    s_pos = context->last_seek_pos;
-    s_dts = context->last_seek_pos_dts;
-  }
+  seek_point = index_rebuild_ffmpeg_find_seek_point(context, pts);
 
   for (i = 0; i < context->num_indexers; i++) {
     if (context->tcs_in_use & tc_types[i]) {
@@ -884,8 +943,8 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
                                    curr_packet->data,
                                    curr_packet->size,
                                    tc_frameno,
-                                   s_pos,
-                                   s_dts,
+                                   seek_point->pos,
+                                   seek_point->dts,
                                    pts);
     }
   }
@@ -928,11 +987,7 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
 
     if (next_packet.stream_index == context->videoStream) {
       if (next_packet.flags & AV_PKT_FLAG_KEY) {
-        context->last_seek_pos = context->seek_pos;
-        context->last_seek_pos_dts = context->seek_pos_dts;
-        context->seek_pos = next_packet.pos;
-        context->seek_pos_dts = next_packet.dts;
-        context->seek_pos_pts = next_packet.pts;
+        index_rebuild_ffmpeg_add_seek_point(context, &next_packet);
       }
 
       avcodec_decode_video2(context->iCodecCtx, in_frame, &frame_finished, &next_packet);
@@ -40,6 +40,18 @@
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
+#include "IMB_colormanagement_intern.h"
+
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#else
+#  include <zlib.h>
+#endif
+
 #ifdef DEBUG_MESSAGES
 #  if defined __GNUC__
 #    define PRINT(format, args...) printf(format, ##args)
@@ -53,6 +65,15 @@
 static MEM_CacheLimiterC *limitor = NULL;
 static pthread_mutex_t limitor_lock = BLI_MUTEX_INITIALIZER;
 
+/* Users with a limit of their own don't share memory with the other caches. */
+static MEM_CacheLimiterC *user_limitors[MOVIECACHE_USER_MAX] = {NULL};
+static size_t user_limits[MOVIECACHE_USER_MAX] = {0};
+
+/* Items evicted from the caches above are compressed instead of freed while this limit allows,
+ * zero disables compression. */
+static MEM_CacheLimiterC *compressed_limitor = NULL;
+static size_t compressed_limit = 0;
+
 typedef struct MovieCache {
   char name[64];
 
@@ -74,7 +95,7 @@ typedef struct MovieCache {
   void *last_userkey;
 
   int totseg, *points, proxy, render_flags; /* for visual statistics optimization */
-  int pad;
+  eMovieCacheUser user;
 } MovieCache;
 
 typedef struct MovieCacheKey {
@@ -82,11 +103,22 @@ typedef struct MovieCacheKey {
   void *userkey;
 } MovieCacheKey;
 
+/* Pixels of an item evicted from the memory cache, losslessly compressed. */
+typedef struct MovieCacheCompressed {
+  /* Buffer without pixels, keeps the size, flags, metadata and color spaces. */
+  ImBuf *ibuf;
+  void *rect, *rect_float;
+  size_t rect_size, rect_float_size;
+  MEM_CacheLimiterHandleC *c_handle;
+} MovieCacheCompressed;
+
 typedef struct MovieCacheItem {
   MovieCache *cache_owner;
   ImBuf *ibuf;
   MEM_CacheLimiterHandleC *c_handle;
   void *priority_data;
+  /* Set instead of ibuf while the item is in the compressed cache. */
+  MovieCacheCompressed *compressed;
 } MovieCacheItem;
 
 static unsigned int moviecache_hashhash(const void *keyv)
@@ -113,6 +145,72 @@ static void moviecache_keyfree(void *val)
   BLI_mempool_free(key->cache_owner->keys_pool, key);
 }
 
+static size_t moviecache_rect_size(const ImBuf *ibuf)
+{
+  return (size_t)ibuf->x * (size_t)ibuf->y * 4 * sizeof(unsigned char);
+}
+
+static size_t moviecache_rect_float_size(const ImBuf *ibuf)
+{
+  return (size_t)ibuf->x * (size_t)ibuf->y * (size_t)ibuf->channels * sizeof(float);
+}
+
+/* Fast lossless compression, returns NULL when the data doesn't compress well. */
+static void *moviecache_compress(const void *data, size_t size, size_t *r_size)
+{
+  /* Not worth the time spent decompressing when it saves less than an eighth. */
+  const size_t max_size = size - size / 8;
+  void *out = NULL;
+  bool ok = false;
+
+#ifdef WITH_LZO
+  lzo_uint out_size = size + size / 16 + 64 + 3;
+  void *wrkmem = MEM_mallocN(LZO1X_1_MEM_COMPRESS, "movie cache lzo wrkmem");
+
+  out = MEM_mallocN(out_size, "movie cache compressed pixels");
+  ok = lzo1x_1_compress(data, (lzo_uint)size, out, &out_size, wrkmem) == LZO_E_OK &&
+       out_size <= max_size;
+  MEM_freeN(wrkmem);
+#else
+  uLongf out_size = compressBound(size);
+
+  out = MEM_mallocN(out_size, "movie cache compressed pixels");
+  ok = compress2(out, &out_size, data, size, 1) == Z_OK && out_size <= max_size;
+#endif
+
+  if (!ok) {
+    MEM_freeN(out);
+    return NULL;
+  }
+
+  *r_size = out_size;
+  return MEM_reallocN(out, out_size);
+}
+
+static bool moviecache_decompress(const void *data, size_t size, void *out, size_t out_size)
+{
+#ifdef WITH_LZO
+  lzo_uint lzo_size = out_size;
+  return lzo1x_decompress_safe(data, (lzo_uint)size, out, &lzo_size, NULL) == LZO_E_OK &&
+         lzo_size == out_size;
+#else
+  uLongf zlib_size = out_size;
+  return uncompress(out, &zlib_size, data, size) == Z_OK && zlib_size == out_size;
+#endif
+}
+
+static void moviecache_compressed_free(MovieCacheCompressed *compressed)
+{
+  MEM_SAFE_FREE(compressed->rect);
+  MEM_SAFE_FREE(compressed->rect_float);
+
+  if (compressed->ibuf) {
+    IMB_freeImBuf(compressed->ibuf);
+  }
+
+  MEM_freeN(compressed);
+}
+
 static void moviecache_valfree(void *val)
 {
   MovieCacheItem *item = (MovieCacheItem *)val;
@@ -125,6 +223,11 @@ static void moviecache_valfree(void *val)
     IMB_freeImBuf(item->ibuf);
   }
 
+  if (item->compressed) {
+    MEM_CacheLimiter_unmanage(item->compressed->c_handle);
+    moviecache_compressed_free(item->compressed);
+  }
+
   if (item->priority_data && cache->prioritydeleterfp) {
     cache->prioritydeleterfp(item->priority_data);
   }
@@ -145,7 +248,7 @@ static void check_unused_keys(MovieCache *cache)
 
     BLI_ghashIterator_step(&gh_iter);
 
-    remove = !item->ibuf;
+    remove = !item->ibuf && !item->compressed;
 
     if (remove) {
       PRINT("%s: cache '%s' remove item %p without buffer\n", __func__, cache->name, item);
@@ -164,6 +267,65 @@ static int compare_int(const void *av, const void *bv)
   return *a - *b;
 }
 
+static bool moviecache_can_compress(const ImBuf *ibuf)
+{
+  /* Only buffers owned by the cache alone, with no other data than the pixels. */
+  if (ibuf->refcounter != 0 || (ibuf->rect == NULL && ibuf->rect_float == NULL)) {
+    return false;
+  }
+  if ((ibuf->rect && !(ibuf->mall & IB_rect)) ||
+      (ibuf->rect_float && !(ibuf->mall & IB_rectfloat))) {
+    return false;
+  }
+  return ibuf->zbuf == NULL && ibuf->zbuf_float == NULL && ibuf->tiles == NULL &&
+         ibuf->encodedbuffer == NULL && ibuf->dds_data.data == NULL;
+}
+
+/* Move an item evicted from the memory cache to the compressed cache. */
+static bool moviecache_compress_item(MovieCacheItem *item)
+{
+  ImBuf *ibuf = item->ibuf;
+  MovieCacheCompressed *compressed;
+
+  if (compressed_limit == 0 || !moviecache_can_compress(ibuf)) {
+    return false;
+  }
+
+  compressed = MEM_callocN(sizeof(MovieCacheCompressed), "movie cache compressed item");
+
+  if (ibuf->rect) {
+    compressed->rect = moviecache_compress(
+        ibuf->rect, moviecache_rect_size(ibuf), &compressed->rect_size);
+  }
+  if (ibuf->rect_float) {
+    compressed->rect_float = moviecache_compress(
+        ibuf->rect_float, moviecache_rect_float_size(ibuf), &compressed->rect_float_size);
+  }
+
+  if ((ibuf->rect && !compressed->rect) || (ibuf->rect_float && !compressed->rect_float)) {
+    moviecache_compressed_free(compressed);
+    return false;
+  }
+
+  PRINT("%s: cache '%s' compress item %p buffer %p\n",
+        __func__,
+        item->cache_owner->name,
+        item,
+        ibuf);
+
+  imb_freerectImBuf(ibuf);
+  imb_freerectfloatImBuf(ibuf);
+  colormanage_cache_free(ibuf);
+
+  compressed->ibuf = ibuf;
+  item->compressed = compressed;
+
+  compressed->c_handle = MEM_CacheLimiter_insert(compressed_limitor, item);
+  MEM_CacheLimiter_enforce_limits(compressed_limitor);
+
+  return true;
+}
+
 static void IMB_moviecache_destructor(void *p)
 {
   MovieCacheItem *item = (MovieCacheItem *)p;
@@ -173,7 +335,9 @@ static void IMB_moviecache_destructor(void *p)
 
     PRINT("%s: cache '%s' destroy item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
 
-    IMB_freeImBuf(item->ibuf);
+    if (!moviecache_compress_item(item)) {
+      IMB_freeImBuf(item->ibuf);
+    }
 
     item->ibuf = NULL;
     item->c_handle = NULL;
@@ -186,6 +350,26 @@ static void IMB_moviecache_destructor(void *p)
   }
 }
 
+static void moviecache_compressed_destructor(void *p)
+{
+  MovieCacheItem *item = (MovieCacheItem *)p;
+
+  if (item && item->compressed) {
+    MovieCache *cache = item->cache_owner;
+
+    PRINT("%s: cache '%s' destroy compressed item %p\n", __func__, cache->name, item);
+
+    item->compressed->c_handle = NULL;
+    moviecache_compressed_free(item->compressed);
+    item->compressed = NULL;
+
+    if (cache->points) {
+      MEM_freeN(cache->points);
+      cache->points = NULL;
+    }
+  }
+}
+
 static size_t get_size_in_memory(ImBuf *ibuf)
 {
   /* Keep textures in the memory to avoid constant file reload on viewport update. */
@@ -208,6 +392,19 @@ static size_t get_item_size(void *p)
   return size;
 }
 
+static size_t get_compressed_item_size(void *p)
+{
+  size_t size = sizeof(MovieCacheItem);
+  MovieCacheItem *item = (MovieCacheItem *)p;
+
+  if (item->compressed) {
+    size += sizeof(MovieCacheCompressed) + sizeof(ImBuf) + item->compressed->rect_size +
+            item->compressed->rect_float_size;
+  }
+
+  return size;
+}
+
 static int get_item_priority(void *item_v, int default_priority)
 {
   MovieCacheItem *item = (MovieCacheItem *)item_v;
@@ -245,19 +442,96 @@ static bool get_item_destroyable(void *item_v)
   return true;
 }
 
+static MEM_CacheLimiterC *moviecache_limitor_new(void)
+{
+  MEM_CacheLimiterC *new_limitor = new_MEM_CacheLimiter(IMB_moviecache_destructor,
+                                                        get_item_size);
+
+  MEM_CacheLimiter_ItemPriority_Func_set(new_limitor, get_item_priority);
+  MEM_CacheLimiter_ItemDestroyable_Func_set(new_limitor, get_item_destroyable);
+
+  return new_limitor;
+}
+
+/* A limit of one byte frees all compressed items, zero would use the global limit. */
+static void moviecache_compressed_limit_apply(void)
+{
+  MEM_CacheLimiter_set_instance_maximum(compressed_limitor, MAX2(compressed_limit, 1));
+  MEM_CacheLimiter_enforce_limits(compressed_limitor);
+}
+
 void IMB_moviecache_init(void)
 {
-  limitor = new_MEM_CacheLimiter(IMB_moviecache_destructor, get_item_size);
+  int user;
+
+  limitor = moviecache_limitor_new();
 
-  MEM_CacheLimiter_ItemPriority_Func_set(limitor, get_item_priority);
-  MEM_CacheLimiter_ItemDestroyable_Func_set(limitor, get_item_destroyable);
+  for (user = MOVIECACHE_USER_OTHER + 1; user < MOVIECACHE_USER_MAX; user++) {
+    user_limitors[user] = moviecache_limitor_new();
+    MEM_CacheLimiter_set_instance_maximum(user_limitors[user], user_limits[user]);
+  }
+
+  compressed_limitor = new_MEM_CacheLimiter(moviecache_compressed_destructor,
+                                            get_compressed_item_size);
+  MEM_CacheLimiter_ItemPriority_Func_set(compressed_limitor, get_item_priority);
+  moviecache_compressed_limit_apply();
 }
 
 void IMB_moviecache_destruct(void)
 {
+  int user;
+
   if (limitor) {
     delete_MEM_CacheLimiter(limitor);
+    limitor = NULL;
+  }
+
+  for (user = 0; user < MOVIECACHE_USER_MAX; user++) {
+    if (user_limitors[user]) {
+      delete_MEM_CacheLimiter(user_limitors[user]);
+      user_limitors[user] = NULL;
+    }
+  }
+
+  if (compressed_limitor) {
+    delete_MEM_CacheLimiter(compressed_limitor);
+    compressed_limitor = NULL;
+  }
+}
+
+/* Set the memory limit of all caches of a user, zero shares the global limit with the caches
+ * of other users. */
+void IMB_moviecache_set_user_limit(eMovieCacheUser user, size_t limit)
+{
+  BLI_assert(user != MOVIECACHE_USER_OTHER);
+
+  BLI_mutex_lock(&limitor_lock);
+  user_limits[user] = limit;
+  if (user_limitors[user]) {
+    MEM_CacheLimiter_set_instance_maximum(user_limitors[user], limit);
+    MEM_CacheLimiter_enforce_limits(user_limitors[user]);
+  }
+  BLI_mutex_unlock(&limitor_lock);
+}
+
+/* Set the memory limit of compressed items evicted from the caches, zero disables
+ * compression. */
+void IMB_moviecache_set_compressed_limit(size_t limit)
+{
+  BLI_mutex_lock(&limitor_lock);
+  compressed_limit = limit;
+  if (compressed_limitor) {
+    moviecache_compressed_limit_apply();
+  }
+  BLI_mutex_unlock(&limitor_lock);
+}
+
+static MEM_CacheLimiterC *moviecache_limitor_get(MovieCache *cache)
+{
+  if (user_limits[cache->user] != 0) {
+    return user_limitors[cache->user];
   }
+  return limitor;
 }
 
 MovieCache *IMB_moviecache_create(const char *name,
@@ -292,6 +566,11 @@ void IMB_moviecache_set_getdata_callback(MovieCache *cache, MovieCacheGetKeyData
   cache->getdatafp = getdatafp;
 }
 
+void IMB_moviecache_set_user(MovieCache *cache, eMovieCacheUser user)
+{
+  cache->user = user;
+}
+
 void IMB_moviecache_set_priority_callback(struct MovieCache *cache,
                                           MovieCacheGetPriorityDataFP getprioritydatafp,
                                           MovieCacheGetItemPriorityFP getitempriorityfp,
@@ -304,6 +583,18 @@ void IMB_moviecache_set_priority_callback(struct MovieCache *cache,
   cache->prioritydeleterfp = prioritydeleterfp;
 }
 
+/* Manage the buffer of an item by the memory limit of its cache. */
+static void moviecache_limitor_insert(MovieCache *cache, MovieCacheItem *item)
+{
+  MEM_CacheLimiterC *cache_limitor = moviecache_limitor_get(cache);
+
+  item->c_handle = MEM_CacheLimiter_insert(cache_limitor, item);
+
+  MEM_CacheLimiter_ref(item->c_handle);
+  MEM_CacheLimiter_enforce_limits(cache_limitor);
+  MEM_CacheLimiter_unref(item->c_handle);
+}
+
 static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, bool need_lock)
 {
   MovieCacheKey *key;
@@ -328,6 +619,7 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
   item->cache_owner = cache;
   item->c_handle = NULL;
   item->priority_data = NULL;
+  item->compressed = NULL;
 
   if (cache->getprioritydatafp) {
     item->priority_data = cache->getprioritydatafp(userkey);
@@ -343,11 +635,7 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
     BLI_mutex_lock(&limitor_lock);
   }
 
-  item->c_handle = MEM_CacheLimiter_insert(limitor, item);
-
-  MEM_CacheLimiter_ref(item->c_handle);
-  MEM_CacheLimiter_enforce_limits(limitor);
-  MEM_CacheLimiter_unref(item->c_handle);
+  moviecache_limitor_insert(cache, item);
 
   if (need_lock) {
     BLI_mutex_unlock(&limitor_lock);
@@ -372,11 +660,15 @@ bool IMB_moviecache_put_if_possible(MovieCache *cache, void *userkey, ImBuf *ibu
   size_t mem_in_use, mem_limit, elem_size;
   bool result = false;
 
+  if (!limitor) {
+    IMB_moviecache_init();
+  }
+
   elem_size = get_size_in_memory(ibuf);
-  mem_limit = MEM_CacheLimiter_get_maximum();
 
   BLI_mutex_lock(&limitor_lock);
-  mem_in_use = MEM_CacheLimiter_get_memory_in_use(limitor);
+  mem_limit = MEM_CacheLimiter_get_instance_maximum(moviecache_limitor_get(cache));
+  mem_in_use = MEM_CacheLimiter_get_memory_in_use(moviecache_limitor_get(cache));
 
   if (mem_in_use + elem_size <= mem_limit) {
     do_moviecache_put(cache, userkey, ibuf, false);
@@ -396,6 +688,55 @@ void IMB_moviecache_remove(MovieCache *cache, void *userkey)
   BLI_ghash_remove(cache->hash, &key, moviecache_keyfree, moviecache_valfree);
 }
 
+/* Move an item from the compressed cache back to the memory cache. */
+static ImBuf *moviecache_decompress_item(MovieCache *cache, MovieCacheItem *item)
+{
+  MovieCacheCompressed *compressed = item->compressed;
+  ImBuf *ibuf = compressed->ibuf;
+  bool ok = true;
+
+  PRINT("%s: cache '%s' decompress item %p buffer %p\n", __func__, cache->name, item, ibuf);
+
+  MEM_CacheLimiter_unmanage(compressed->c_handle);
+  item->compressed = NULL;
+
+  if (compressed->rect) {
+    ibuf->rect = MEM_mallocN(moviecache_rect_size(ibuf), "movie cache rect");
+    ibuf->mall |= IB_rect;
+    ok &= moviecache_decompress(
+        compressed->rect, compressed->rect_size, ibuf->rect, moviecache_rect_size(ibuf));
+  }
+  if (compressed->rect_float) {
+    ibuf->rect_float = MEM_mallocN(moviecache_rect_float_size(ibuf), "movie cache rect_float");
+    ibuf->mall |= IB_rectfloat;
+    ok &= moviecache_decompress(compressed->rect_float,
+                                compressed->rect_float_size,
+                                ibuf->rect_float,
+                                moviecache_rect_float_size(ibuf));
+  }
+
+  compressed->ibuf = NULL;
+  moviecache_compressed_free(compressed);
+
+  if (!ok) {
+    /* The item is removed with the other items without buffer. */
+    IMB_freeImBuf(ibuf);
+    return NULL;
+  }
+
+  item->ibuf = ibuf;
+  moviecache_limitor_insert(cache, item);
+
+  if (cache->points) {
+    MEM_freeN(cache->points);
+    cache->points = NULL;
+  }
+
+  IMB_refImBuf(ibuf);
+
+  return ibuf;
+}
+
 ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey)
 {
   MovieCacheKey key;
@@ -415,6 +756,17 @@ ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey)
 
       return item->ibuf;
     }
+    else {
+      ImBuf *ibuf = NULL;
+
+      BLI_mutex_lock(&limitor_lock);
+      if (item->compressed) {
+        ibuf = moviecache_decompress_item(cache, item);
+      }
+      BLI_mutex_unlock(&limitor_lock);
+
+      return ibuf;
+    }
   }
 
   return NULL;
@@ -467,9 +819,11 @@ void IMB_moviecache_cleanup(MovieCache *cache,
     MovieCacheKey *key = BLI_ghashIterator_getKey(&gh_iter);
     MovieCacheItem *item = BLI_ghashIterator_getValue(&gh_iter);
 
+    ImBuf *ibuf = item->ibuf ? item->ibuf : item->compressed->ibuf;
+
     BLI_ghashIterator_step(&gh_iter);
 
-    if (cleanup_check_cb(item->ibuf, key->userkey, userdata)) {
+    if (cleanup_check_cb(ibuf, key->userkey, userdata)) {
       PRINT("%s: cache '%s' remove item %p\n", __func__, cache->name, item);
 
       BLI_ghash_remove(cache->hash, key, moviecache_keyfree, moviecache_valfree);
@@ -512,7 +866,7 @@ void IMB_moviecache_get_cache_segments(
       MovieCacheItem *item = BLI_ghashIterator_getValue(&gh_iter);
       int framenr, curproxy, curflags;
 
-      if (item->ibuf) {
+      if (item->ibuf || item->compressed) {
         cache->getdatafp(key->userkey, &framenr, &curproxy, &curflags);
 
         if (curproxy == proxy && curflags == render_flags) {
@@ -568,12 +922,25 @@ void IMB_moviecache_get_cache_segments(
   }
 }
 
+/* Iterators only visit items with an uncompressed buffer. */
+static void moviecache_iter_skip_compressed(GHashIterator *iter)
+{
+  while (!BLI_ghashIterator_done(iter)) {
+    MovieCacheItem *item = BLI_ghashIterator_getValue(iter);
+    if (item->ibuf) {
+      break;
+    }
+    BLI_ghashIterator_step(iter);
+  }
+}
+
 struct MovieCacheIter *IMB_moviecacheIter_new(MovieCache *cache)
 {
   GHashIterator *iter;
 
   check_unused_keys(cache);
   iter = BLI_ghashIterator_new(cache->hash);
+  moviecache_iter_skip_compressed(iter);
 
   return (struct MovieCacheIter *)iter;
 }
@@ -591,6 +958,7 @@ bool IMB_moviecacheIter_done(struct MovieCacheIter *iter)
 void IMB_moviecacheIter_step(struct MovieCacheIter *iter)
 {
   BLI_ghashIterator_step((GHashIterator *)iter);
+  moviecache_iter_skip_compressed((GHashIterator *)iter);
 }
 
 ImBuf *IMB_moviecacheIter_getImBuf(struct MovieCacheIter *iter)
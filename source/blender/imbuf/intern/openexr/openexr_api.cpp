@@ -625,6 +625,8 @@ typedef struct ExrHandle {
 
   IStream *ifile_stream;
   MultiPartInputFile *ifile;
+  /** Copy of the file data for handles loaded from memory, pixels are read after loading. */
+  unsigned char *ifile_mem;
 
   OFileStream *ofile_stream;
   MultiPartOutputFile *mpofile;
@@ -654,6 +656,7 @@ typedef struct ExrChannel {
   struct MultiViewChannelName *m; /* struct to store all multipart channel info */
   int xstride, ystride;           /* step to next pixel, to next scanline */
   float *rect;                    /* first pointer to write in */
+  int pass_offset;                /* offset of the channel in the rect of its pass, for reading */
   char chan_id;                   /* quick lookup of channel char */
   int view_id;                    /* quick lookup of channel view */
   bool use_half_float;            /* when saving use half float for file storage */
@@ -893,10 +896,16 @@ int IMB_exr_begin_write(void *handle,
   return (data->ofile != NULL);
 }
 
-/* only used for writing temp. render results (not image files)
- * (FSA and Save Buffers) */
-void IMB_exrtile_begin_write(
-    void *handle, const char *filename, int mipmap, int width, int height, int tilex, int tiley)
+/* only used for writing tiled render results (FSA and Save Buffers), either to a
+ * temporary file or directly to the output file */
+bool IMB_exrtile_begin_write(void *handle,
+                             const char *filename,
+                             int mipmap,
+                             int width,
+                             int height,
+                             int tilex,
+                             int tiley,
+                             int compress)
 {
   ExrHandle *data = (ExrHandle *)handle;
   Header header(width, height);
@@ -910,7 +919,7 @@ void IMB_exrtile_begin_write(
   data->mipmap = mipmap;
 
   header.setTileDescription(TileDescription(tilex, tiley, (mipmap) ? MIPMAP_LEVELS : ONE_LEVEL));
-  header.compression() = RLE_COMPRESSION;
+  openexr_header_compression(&header, compress);
   header.setType(TILEDIMAGE);
 
   header.insert("BlenderMultiChannel", StringAttribute("Blender V2.43"));
@@ -958,6 +967,8 @@ void IMB_exrtile_begin_write(
     data->mpofile = NULL;
     data->ofile_stream = NULL;
   }
+
+  return (data->mpofile != NULL);
 }
 
 /* read from file */
@@ -1204,9 +1215,8 @@ void IMB_exrtile_write_channels(
   }
 }
 
-void IMB_exr_read_channels(void *handle)
+static void imb_exr_read_channels(ExrHandle *data, bool warn_missing_rect)
 {
-  ExrHandle *data = (ExrHandle *)handle;
   int numparts = data->ifile->parts();
 
   /* Check if EXR was saved with previous versions of blender which flipped images. */
@@ -1233,6 +1243,7 @@ void IMB_exr_read_channels(void *handle)
     /* Insert all matching channel into framebuffer. */
     FrameBuffer frameBuffer;
     ExrChannel *echan;
+    bool has_channels = false;
 
     for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
       if (echan->m->part_number != i) {
@@ -1264,12 +1275,18 @@ void IMB_exr_read_channels(void *handle)
 
         frameBuffer.insert(echan->m->internal_name,
                            Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
+        has_channels = true;
       }
-      else {
+      else if (warn_missing_rect) {
         printf("warning, channel with no rect set %s\n", echan->m->internal_name.c_str());
       }
     }
 
+    /* Parts without any requested channel don't need to be decoded. */
+    if (!has_channels) {
+      continue;
+    }
+
     /* Read pixels. */
     try {
       in.setFrameBuffer(frameBuffer);
@@ -1283,19 +1300,31 @@ void IMB_exr_read_channels(void *handle)
   }
 }
 
-void IMB_exr_multilayer_convert(void *handle,
-                                void *base,
-                                void *(*addview)(void *base, const char *str),
-                                void *(*addlayer)(void *base, const char *str),
-                                void (*addpass)(void *base,
-                                                void *lay,
-                                                const char *str,
-                                                float *rect,
-                                                int totchan,
-                                                const char *chan_id,
-                                                const char *view))
+void IMB_exr_read_channels(void *handle)
+{
+  imb_exr_read_channels((ExrHandle *)handle, true);
+}
+
+static void imb_exr_pass_set_rect(ExrPass *pass, float *rect)
+{
+  for (int a = 0; a < pass->totchan; a++) {
+    ExrChannel *echan = pass->chan[a];
+    echan->rect = rect ? rect + echan->pass_offset : NULL;
+  }
+}
+
+static void imb_exr_multilayer_convert(ExrHandle *data,
+                                       void *base,
+                                       void *(*addview)(void *base, const char *str),
+                                       void *(*addlayer)(void *base, const char *str),
+                                       void (*addpass)(void *base,
+                                                       void *lay,
+                                                       const char *str,
+                                                       float *rect,
+                                                       int totchan,
+                                                       const char *chan_id,
+                                                       const char *view))
 {
-  ExrHandle *data = (ExrHandle *)handle;
   ExrLayer *lay;
   ExrPass *pass;
 
@@ -1333,6 +1362,78 @@ void IMB_exr_multilayer_convert(void *handle,
   }
 }
 
+void IMB_exr_multilayer_convert(void *handle,
+                                void *base,
+                                void *(*addview)(void *base, const char *str),
+                                void *(*addlayer)(void *base, const char *str),
+                                void (*addpass)(void *base,
+                                                void *lay,
+                                                const char *str,
+                                                float *rect,
+                                                int totchan,
+                                                const char *chan_id,
+                                                const char *view))
+{
+  ExrHandle *data = (ExrHandle *)handle;
+
+  /* Read all passes. */
+  for (ExrLayer *lay = (ExrLayer *)data->layers.first; lay; lay = lay->next) {
+    for (ExrPass *pass = (ExrPass *)lay->passes.first; pass; pass = pass->next) {
+      if (pass->totchan && pass->rect == NULL) {
+        pass->rect = (float *)MEM_callocN(
+            sizeof(float) * data->width * data->height * pass->totchan, "pass rect");
+        imb_exr_pass_set_rect(pass, pass->rect);
+      }
+    }
+  }
+  imb_exr_read_channels(data, true);
+
+  imb_exr_multilayer_convert(data, base, addview, addlayer, addpass);
+}
+
+/* Convert without reading pixels, passes are added without rect and are read a layer at a time
+ * with #IMB_exr_read_layer. The handle has to be kept open until then. */
+void IMB_exr_multilayer_convert_lazy(void *handle,
+                                     void *base,
+                                     void *(*addview)(void *base, const char *str),
+                                     void *(*addlayer)(void *base, const char *str),
+                                     void (*addpass)(void *base,
+                                                     void *lay,
+                                                     const char *str,
+                                                     float *rect,
+                                                     int totchan,
+                                                     const char *chan_id,
+                                                     const char *view))
+{
+  imb_exr_multilayer_convert((ExrHandle *)handle, base, addview, addlayer, addpass);
+}
+
+/* Read the passes of one layer, into the rects given by \a getpassrect for the pass name
+ * (without view) and view. Only the parts of the file holding the layer are decoded. */
+void IMB_exr_read_layer(void *handle,
+                        const char *layname,
+                        void *base,
+                        float *(*getpassrect)(void *base, const char *str, const char *view))
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  ExrLayer *lay = (ExrLayer *)BLI_findstring(&data->layers, layname, offsetof(ExrLayer, name));
+  ExrPass *pass;
+
+  if (lay == NULL) {
+    return;
+  }
+
+  for (pass = (ExrPass *)lay->passes.first; pass; pass = pass->next) {
+    imb_exr_pass_set_rect(pass, getpassrect(base, pass->internal_name, pass->view));
+  }
+
+  imb_exr_read_channels(data, false);
+
+  for (pass = (ExrPass *)lay->passes.first; pass; pass = pass->next) {
+    imb_exr_pass_set_rect(pass, NULL);
+  }
+}
+
 void IMB_exr_close(void *handle)
 {
   ExrHandle *data = (ExrHandle *)handle;
@@ -1349,6 +1450,7 @@ void IMB_exr_close(void *handle)
 
   data->ifile = NULL;
   data->ifile_stream = NULL;
+  MEM_SAFE_FREE(data->ifile_mem);
   data->ofile = NULL;
   data->mpofile = NULL;
   data->ofile_stream = NULL;
@@ -1595,15 +1697,14 @@ static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
     return NULL;
   }
 
-  /* with some heuristics, try to merge the channels in buffers */
+  /* with some heuristics, try to merge the channels in buffers,
+   * memory for the passes is allocated when reading them */
   for (lay = (ExrLayer *)data->layers.first; lay; lay = lay->next) {
     for (pass = (ExrPass *)lay->passes.first; pass; pass = pass->next) {
       if (pass->totchan) {
-        pass->rect = (float *)MEM_callocN(width * height * pass->totchan * sizeof(float),
-                                          "pass rect");
         if (pass->totchan == 1) {
           echan = pass->chan[0];
-          echan->rect = pass->rect;
+          echan->pass_offset = 0;
           echan->xstride = 1;
           echan->ystride = width;
           pass->chan_id[0] = echan->chan_id;
@@ -1636,7 +1737,7 @@ static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
             }
             for (a = 0; a < pass->totchan; a++) {
               echan = pass->chan[a];
-              echan->rect = pass->rect + lookup[(unsigned int)echan->chan_id];
+              echan->pass_offset = lookup[(unsigned int)echan->chan_id];
               echan->xstride = pass->totchan;
               echan->ystride = width * pass->totchan;
               pass->chan_id[(unsigned int)lookup[(unsigned int)echan->chan_id]] = echan->chan_id;
@@ -1645,7 +1746,7 @@ static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
           else { /* unknown */
             for (a = 0; a < pass->totchan; a++) {
               echan = pass->chan[a];
-              echan->rect = pass->rect + a;
+              echan->pass_offset = a;
               echan->xstride = pass->totchan;
               echan->ystride = width * pass->totchan;
               pass->chan_id[a] = echan->chan_id;
@@ -1967,12 +2068,33 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem,
 
         /* Only enters with IB_multilayer flag set. */
         if (is_multi && ((flags & IB_thumbnail) == 0)) {
-          /* constructs channels for reading, allocates memory in channels */
+          /* Pixels are read when converting the handle, possibly much later when only some
+           * layers are used, so it needs its own copy of the file data. */
+          unsigned char *mem_copy = (unsigned char *)MEM_mallocN(size, "exr file data");
+          memcpy(mem_copy, mem, size);
+
+          delete file;
+          delete membuf;
+          file = NULL;
+          membuf = new IMemStream(mem_copy, size);
+          try {
+            file = new MultiPartInputFile(*membuf);
+          }
+          catch (...) {
+            MEM_freeN(mem_copy);
+            throw;
+          }
+
+          /* constructs channels for reading */
           ExrHandle *handle = imb_exr_begin_read_mem(*membuf, *file, width, height);
           if (handle) {
-            IMB_exr_read_channels(handle);
+            handle->ifile_mem = mem_copy;
             ibuf->userdata = handle; /* potential danger, the caller has to check for this! */
           }
+          else {
+            /* Stream and file were freed with the handle. */
+            MEM_freeN(mem_copy);
+          }
         }
         else {
           const char *rgb_channels[3];
@@ -58,8 +58,14 @@ int IMB_exr_begin_write(void *handle,
                         int height,
                         int compress,
                         const struct StampData *stamp);
-void IMB_exrtile_begin_write(
-    void *handle, const char *filename, int mipmap, int width, int height, int tilex, int tiley);
+bool IMB_exrtile_begin_write(void *handle,
+                             const char *filename,
+                             int mipmap,
+                             int width,
+                             int height,
+                             int tilex,
+                             int tiley,
+                             int compress);
 
 void IMB_exr_set_channel(void *handle,
                          const char *layname,
@@ -90,6 +96,22 @@ void IMB_exr_multilayer_convert(void *handle,
                                                 const char *chan_id,
                                                 const char *view));
 
+void IMB_exr_multilayer_convert_lazy(void *handle,
+                                     void *base,
+                                     void *(*addview)(void *base, const char *str),
+                                     void *(*addlayer)(void *base, const char *str),
+                                     void (*addpass)(void *base,
+                                                     void *lay,
+                                                     const char *str,
+                                                     float *rect,
+                                                     int totchan,
+                                                     const char *chan_id,
+                                                     const char *view));
+void IMB_exr_read_layer(void *handle,
+                        const char *layname,
+                        void *base,
+                        float *(*getpassrect)(void *base, const char *str, const char *view));
+
 void IMB_exr_close(void *handle);
 
 void IMB_exr_add_view(void *handle, const char *name);
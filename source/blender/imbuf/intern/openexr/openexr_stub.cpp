@@ -59,14 +59,16 @@ int IMB_exr_begin_write(void * /*handle*/,
 {
   return 0;
 }
-void IMB_exrtile_begin_write(void * /*handle*/,
+bool IMB_exrtile_begin_write(void * /*handle*/,
                              const char * /*filename*/,
                              int /*mipmap*/,
                              int /*width*/,
                              int /*height*/,
                              int /*tilex*/,
-                             int /*tiley*/)
+                             int /*tiley*/,
+                             int /*compress*/)
 {
+  return false;
 }
 
 void IMB_exr_set_channel(void * /*handle*/,
@@ -117,6 +119,27 @@ void IMB_exr_multilayer_convert(void * /*handle*/,
 {
 }
 
+void IMB_exr_multilayer_convert_lazy(void * /*handle*/,
+                                     void * /*base*/,
+                                     void *(*/*addview*/)(void *base, const char *str),
+                                     void *(*/*addlayer*/)(void *base, const char *str),
+                                     void (*/*addpass*/)(void *base,
+                                                         void *lay,
+                                                         const char *str,
+                                                         float *rect,
+                                                         int totchan,
+                                                         const char *chan_id,
+                                                         const char *view))
+{
+}
+
+void IMB_exr_read_layer(void * /*handle*/,
+                        const char * /*layname*/,
+                        void * /*base*/,
+                        float *(*/*getpassrect*/)(void *base, const char *str, const char *view))
+{
+}
+
 void IMB_exr_close(void * /*handle*/)
 {
 }
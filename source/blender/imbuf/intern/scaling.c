@@ -24,6 +24,7 @@
 
 #include "BLI_math_color.h"
 #include "BLI_math_interp.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #include "MEM_guardedalloc.h"
 
@@ -906,22 +907,137 @@ static bool q_scale_linear_interpolation(struct ImBuf *ibuf, int newx, int newy)
   return true;
 }
 
-static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+typedef struct ScaleDownData {
+  const uchar *rect;
+  const float *rectf;
+  uchar *newrect;
+  float *newrectf;
+  /* Size of the input. */
+  int x, y;
+  /* New width or height. */
+  int newsize;
+  float add;
+} ScaleDownData;
+
+/* Number of columns scaled by a task in #scaledowny. */
+#define SCALE_DOWN_Y_COLUMNS 64
+
+static bool scale_use_threading(const ImBuf *ibuf)
 {
-  const int do_rect = (ibuf->rect != NULL);
-  const int do_float = (ibuf->rect_float != NULL);
-  const size_t rect_size = ibuf->x * ibuf->y * 4;
+  return (size_t)ibuf->x * ibuf->y > 64 * 1024;
+}
 
-  uchar *rect, *_newrect, *newrect;
-  float *rectf, *_newrectf, *newrectf;
-  float sample, add, val[4], nval[4], valf[4], nvalf[4];
-  int x, y;
+static void scaledownx_row(void *__restrict userdata,
+                           const int y,
+                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ScaleDownData *data = userdata;
+  const int do_rect = (data->rect != NULL);
+  const int do_float = (data->rectf != NULL);
+  const uchar *rect = NULL;
+  const float *rectf = NULL;
+  uchar *newrect = NULL;
+  float *newrectf = NULL;
+  const float add = data->add;
+  float sample, val[4], nval[4], valf[4], nvalf[4];
+  int x;
+
+  if (do_rect) {
+    rect = data->rect + (size_t)y * data->x * 4;
+    newrect = data->newrect + (size_t)y * data->newsize * 4;
+  }
+  if (do_float) {
+    rectf = data->rectf + (size_t)y * data->x * 4;
+    newrectf = data->newrectf + (size_t)y * data->newsize * 4;
+  }
 
-  rectf = _newrectf = newrectf = NULL;
-  rect = _newrect = newrect = NULL;
+  sample = 0.0f;
+  val[0] = val[1] = val[2] = val[3] = 0.0f;
+  valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
   nval[0] = nval[1] = nval[2] = nval[3] = 0.0f;
   nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
 
+  for (x = data->newsize; x > 0; x--) {
+    if (do_rect) {
+      nval[0] = -val[0] * sample;
+      nval[1] = -val[1] * sample;
+      nval[2] = -val[2] * sample;
+      nval[3] = -val[3] * sample;
+    }
+    if (do_float) {
+      nvalf[0] = -valf[0] * sample;
+      nvalf[1] = -valf[1] * sample;
+      nvalf[2] = -valf[2] * sample;
+      nvalf[3] = -valf[3] * sample;
+    }
+
+    sample += add;
+
+    while (sample >= 1.0f) {
+      sample -= 1.0f;
+
+      if (do_rect) {
+        nval[0] += rect[0];
+        nval[1] += rect[1];
+        nval[2] += rect[2];
+        nval[3] += rect[3];
+        rect += 4;
+      }
+      if (do_float) {
+        nvalf[0] += rectf[0];
+        nvalf[1] += rectf[1];
+        nvalf[2] += rectf[2];
+        nvalf[3] += rectf[3];
+        rectf += 4;
+      }
+    }
+
+    if (do_rect) {
+      val[0] = rect[0];
+      val[1] = rect[1];
+      val[2] = rect[2];
+      val[3] = rect[3];
+      rect += 4;
+
+      newrect[0] = ((nval[0] + sample * val[0]) / add + 0.5f);
+      newrect[1] = ((nval[1] + sample * val[1]) / add + 0.5f);
+      newrect[2] = ((nval[2] + sample * val[2]) / add + 0.5f);
+      newrect[3] = ((nval[3] + sample * val[3]) / add + 0.5f);
+
+      newrect += 4;
+    }
+    if (do_float) {
+
+      valf[0] = rectf[0];
+      valf[1] = rectf[1];
+      valf[2] = rectf[2];
+      valf[3] = rectf[3];
+      rectf += 4;
+
+      newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
+      newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
+      newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
+      newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
+
+      newrectf += 4;
+    }
+
+    sample -= 1.0f;
+  }
+
+  /* see bug [#26502] */
+  BLI_assert(!do_rect || rect == data->rect + (size_t)(y + 1) * data->x * 4);
+  BLI_assert(!do_float || rectf == data->rectf + (size_t)(y + 1) * data->x * 4);
+}
+
+static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+{
+  const int do_rect = (ibuf->rect != NULL);
+  const int do_float = (ibuf->rect_float != NULL);
+
+  uchar *_newrect = NULL;
+  float *_newrectf = NULL;
+
   if (!do_rect && !do_float) {
     return (ibuf);
   }
@@ -942,126 +1058,137 @@ static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
     }
   }
 
-  add = (ibuf->x - 0.01) / newx;
+  ScaleDownData data = {
+      .rect = (uchar *)ibuf->rect,
+      .rectf = ibuf->rect_float,
+      .newrect = _newrect,
+      .newrectf = _newrectf,
+      .x = ibuf->x,
+      .y = ibuf->y,
+      .newsize = newx,
+      .add = (ibuf->x - 0.01) / newx,
+  };
+
+  /* Rows are scaled independently. */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = scale_use_threading(ibuf);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(0, ibuf->y, &data, scaledownx_row, &settings);
 
   if (do_rect) {
-    rect = (uchar *)ibuf->rect;
-    newrect = _newrect;
+    imb_freerectImBuf(ibuf);
+    ibuf->mall |= IB_rect;
+    ibuf->rect = (unsigned int *)_newrect;
   }
   if (do_float) {
-    rectf = ibuf->rect_float;
-    newrectf = _newrectf;
+    imb_freerectfloatImBuf(ibuf);
+    ibuf->mall |= IB_rectfloat;
+    ibuf->rect_float = _newrectf;
   }
 
-  for (y = ibuf->y; y > 0; y--) {
-    sample = 0.0f;
-    val[0] = val[1] = val[2] = val[3] = 0.0f;
-    valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
+  ibuf->x = newx;
+  return (ibuf);
+}
 
-    for (x = newx; x > 0; x--) {
-      if (do_rect) {
-        nval[0] = -val[0] * sample;
-        nval[1] = -val[1] * sample;
-        nval[2] = -val[2] * sample;
-        nval[3] = -val[3] * sample;
-      }
-      if (do_float) {
-        nvalf[0] = -valf[0] * sample;
-        nvalf[1] = -valf[1] * sample;
-        nvalf[2] = -valf[2] * sample;
-        nvalf[3] = -valf[3] * sample;
-      }
+/* Scale a range of columns, going over the rows in order for cache efficiency. The sample
+ * position is the same for all columns, the accumulated values are kept per column. */
+static void scaledowny_columns(void *__restrict userdata,
+                               const int chunk,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ScaleDownData *data = userdata;
+  const int do_rect = (data->rect != NULL);
+  const int do_float = (data->rectf != NULL);
+  const int xstart = chunk * SCALE_DOWN_Y_COLUMNS;
+  const int width = min_ii(SCALE_DOWN_Y_COLUMNS, data->x - xstart);
+  const size_t skipx = 4 * (size_t)data->x;
+  const uchar *rect = NULL;
+  const float *rectf = NULL;
+  uchar *newrect = NULL;
+  float *newrectf = NULL;
+  const float add = data->add;
+  float sample;
+  float val[SCALE_DOWN_Y_COLUMNS * 4], nval[SCALE_DOWN_Y_COLUMNS * 4];
+  float valf[SCALE_DOWN_Y_COLUMNS * 4], nvalf[SCALE_DOWN_Y_COLUMNS * 4];
+  int i, y;
 
-      sample += add;
+  if (do_rect) {
+    rect = data->rect + 4 * xstart;
+    newrect = data->newrect + 4 * xstart;
+  }
+  if (do_float) {
+    rectf = data->rectf + 4 * xstart;
+    newrectf = data->newrectf + 4 * xstart;
+  }
 
-      while (sample >= 1.0f) {
-        sample -= 1.0f;
+  sample = 0.0f;
+  memset(val, 0, sizeof(val));
+  memset(valf, 0, sizeof(valf));
 
-        if (do_rect) {
-          nval[0] += rect[0];
-          nval[1] += rect[1];
-          nval[2] += rect[2];
-          nval[3] += rect[3];
-          rect += 4;
-        }
-        if (do_float) {
-          nvalf[0] += rectf[0];
-          nvalf[1] += rectf[1];
-          nvalf[2] += rectf[2];
-          nvalf[3] += rectf[3];
-          rectf += 4;
-        }
+  for (y = data->newsize; y > 0; y--) {
+    if (do_rect) {
+      for (i = 0; i < width * 4; i++) {
+        nval[i] = -val[i] * sample;
+      }
+    }
+    if (do_float) {
+      for (i = 0; i < width * 4; i++) {
+        nvalf[i] = -valf[i] * sample;
       }
+    }
 
-      if (do_rect) {
-        val[0] = rect[0];
-        val[1] = rect[1];
-        val[2] = rect[2];
-        val[3] = rect[3];
-        rect += 4;
+    sample += add;
 
-        newrect[0] = ((nval[0] + sample * val[0]) / add + 0.5f);
-        newrect[1] = ((nval[1] + sample * val[1]) / add + 0.5f);
-        newrect[2] = ((nval[2] + sample * val[2]) / add + 0.5f);
-        newrect[3] = ((nval[3] + sample * val[3]) / add + 0.5f);
+    while (sample >= 1.0f) {
+      sample -= 1.0f;
 
-        newrect += 4;
+      if (do_rect) {
+        for (i = 0; i < width * 4; i++) {
+          nval[i] += rect[i];
+        }
+        rect += skipx;
       }
       if (do_float) {
-
-        valf[0] = rectf[0];
-        valf[1] = rectf[1];
-        valf[2] = rectf[2];
-        valf[3] = rectf[3];
-        rectf += 4;
-
-        newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-        newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-        newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-        newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
-
-        newrectf += 4;
+        for (i = 0; i < width * 4; i++) {
+          nvalf[i] += rectf[i];
+        }
+        rectf += skipx;
       }
+    }
 
-      sample -= 1.0f;
+    if (do_rect) {
+      for (i = 0; i < width * 4; i++) {
+        val[i] = rect[i];
+        newrect[i] = ((nval[i] + sample * val[i]) / add + 0.5f);
+      }
+      rect += skipx;
+      newrect += skipx;
+    }
+    if (do_float) {
+      for (i = 0; i < width * 4; i++) {
+        valf[i] = rectf[i];
+        newrectf[i] = ((nvalf[i] + sample * valf[i]) / add);
+      }
+      rectf += skipx;
+      newrectf += skipx;
     }
-  }
 
-  if (do_rect) {
-    // printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-    BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
-    imb_freerectImBuf(ibuf);
-    ibuf->mall |= IB_rect;
-    ibuf->rect = (unsigned int *)_newrect;
+    sample -= 1.0f;
   }
-  if (do_float) {
-    // printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-    BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
-    imb_freerectfloatImBuf(ibuf);
-    ibuf->mall |= IB_rectfloat;
-    ibuf->rect_float = _newrectf;
-  }
-  (void)rect_size; /* UNUSED in release builds */
 
-  ibuf->x = newx;
-  return (ibuf);
+  /* see bug [#26502] */
+  BLI_assert(!do_rect || rect == data->rect + 4 * xstart + skipx * data->y);
+  BLI_assert(!do_float || rectf == data->rectf + 4 * xstart + skipx * data->y);
 }
 
 static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
 {
   const int do_rect = (ibuf->rect != NULL);
   const int do_float = (ibuf->rect_float != NULL);
-  const size_t rect_size = ibuf->x * ibuf->y * 4;
-
-  uchar *rect, *_newrect, *newrect;
-  float *rectf, *_newrectf, *newrectf;
-  float sample, add, val[4], nval[4], valf[4], nvalf[4];
-  int x, y, skipx;
 
-  rectf = _newrectf = newrectf = NULL;
-  rect = _newrect = newrect = NULL;
-  nval[0] = nval[1] = nval[2] = nval[3] = 0.0f;
-  nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
+  uchar *_newrect = NULL;
+  float *_newrectf = NULL;
 
   if (!do_rect && !do_float) {
     return (ibuf);
@@ -1083,107 +1210,37 @@ static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
     }
   }
 
-  add = (ibuf->y - 0.01) / newy;
-  skipx = 4 * ibuf->x;
-
-  for (x = skipx - 4; x >= 0; x -= 4) {
-    if (do_rect) {
-      rect = ((uchar *)ibuf->rect) + x;
-      newrect = _newrect + x;
-    }
-    if (do_float) {
-      rectf = ibuf->rect_float + x;
-      newrectf = _newrectf + x;
-    }
-
-    sample = 0.0f;
-    val[0] = val[1] = val[2] = val[3] = 0.0f;
-    valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
-
-    for (y = newy; y > 0; y--) {
-      if (do_rect) {
-        nval[0] = -val[0] * sample;
-        nval[1] = -val[1] * sample;
-        nval[2] = -val[2] * sample;
-        nval[3] = -val[3] * sample;
-      }
-      if (do_float) {
-        nvalf[0] = -valf[0] * sample;
-        nvalf[1] = -valf[1] * sample;
-        nvalf[2] = -valf[2] * sample;
-        nvalf[3] = -valf[3] * sample;
-      }
-
-      sample += add;
-
-      while (sample >= 1.0f) {
-        sample -= 1.0f;
-
-        if (do_rect) {
-          nval[0] += rect[0];
-          nval[1] += rect[1];
-          nval[2] += rect[2];
-          nval[3] += rect[3];
-          rect += skipx;
-        }
-        if (do_float) {
-          nvalf[0] += rectf[0];
-          nvalf[1] += rectf[1];
-          nvalf[2] += rectf[2];
-          nvalf[3] += rectf[3];
-          rectf += skipx;
-        }
-      }
-
-      if (do_rect) {
-        val[0] = rect[0];
-        val[1] = rect[1];
-        val[2] = rect[2];
-        val[3] = rect[3];
-        rect += skipx;
-
-        newrect[0] = ((nval[0] + sample * val[0]) / add + 0.5f);
-        newrect[1] = ((nval[1] + sample * val[1]) / add + 0.5f);
-        newrect[2] = ((nval[2] + sample * val[2]) / add + 0.5f);
-        newrect[3] = ((nval[3] + sample * val[3]) / add + 0.5f);
-
-        newrect += skipx;
-      }
-      if (do_float) {
-
-        valf[0] = rectf[0];
-        valf[1] = rectf[1];
-        valf[2] = rectf[2];
-        valf[3] = rectf[3];
-        rectf += skipx;
-
-        newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-        newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-        newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-        newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
-
-        newrectf += skipx;
-      }
-
-      sample -= 1.0f;
-    }
-  }
+  ScaleDownData data = {
+      .rect = (uchar *)ibuf->rect,
+      .rectf = ibuf->rect_float,
+      .newrect = _newrect,
+      .newrectf = _newrectf,
+      .x = ibuf->x,
+      .y = ibuf->y,
+      .newsize = newy,
+      .add = (ibuf->y - 0.01) / newy,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = scale_use_threading(ibuf);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0,
+                          (ibuf->x + SCALE_DOWN_Y_COLUMNS - 1) / SCALE_DOWN_Y_COLUMNS,
+                          &data,
+                          scaledowny_columns,
+                          &settings);
 
   if (do_rect) {
-    // printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-    BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
     imb_freerectImBuf(ibuf);
     ibuf->mall |= IB_rect;
     ibuf->rect = (unsigned int *)_newrect;
   }
   if (do_float) {
-    // printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-    BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
     imb_freerectfloatImBuf(ibuf);
     ibuf->mall |= IB_rectfloat;
     ibuf->rect_float = (float *)_newrectf;
   }
-  (void)rect_size; /* UNUSED in release builds */
 
   ibuf->y = newy;
   return (ibuf);
@@ -1659,23 +1716,57 @@ struct imbufRGBA {
   float r, g, b, a;
 };
 
+typedef struct ScaleFastData {
+  const unsigned int *rect;
+  const struct imbufRGBA *rectf;
+  unsigned int *newrect;
+  struct imbufRGBA *newrectf;
+  int x;
+  int newx;
+  size_t stepx, stepy;
+} ScaleFastData;
+
+static void scalefast_row(void *__restrict userdata,
+                          const int y,
+                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ScaleFastData *data = userdata;
+  const size_t ofsy = 32768 + y * data->stepy;
+  size_t ofsx;
+  int x;
+
+  if (data->rect) {
+    const unsigned int *rect = data->rect + (ofsy >> 16) * data->x;
+    unsigned int *newrect = data->newrect + (size_t)y * data->newx;
+    ofsx = 32768;
+
+    for (x = data->newx; x > 0; x--, ofsx += data->stepx) {
+      *newrect++ = rect[ofsx >> 16];
+    }
+  }
+
+  if (data->rectf) {
+    const struct imbufRGBA *rectf = data->rectf + (ofsy >> 16) * data->x;
+    struct imbufRGBA *newrectf = data->newrectf + (size_t)y * data->newx;
+    ofsx = 32768;
+
+    for (x = data->newx; x > 0; x--, ofsx += data->stepx) {
+      *newrectf++ = rectf[ofsx >> 16];
+    }
+  }
+}
+
 /**
  * Return true if \a ibuf is modified.
  */
 bool IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned int newy)
 {
-  unsigned int *rect, *_newrect, *newrect;
-  struct imbufRGBA *rectf, *_newrectf, *newrectf;
-  int x, y;
+  unsigned int *_newrect;
+  struct imbufRGBA *_newrectf;
   bool do_float = false, do_rect = false;
-  size_t ofsx, ofsy, stepx, stepy;
 
-  rect = NULL;
   _newrect = NULL;
-  newrect = NULL;
-  rectf = NULL;
   _newrectf = NULL;
-  newrectf = NULL;
 
   if (ibuf == NULL) {
     return false;
@@ -1699,7 +1790,6 @@ bool IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned int newy
     if (_newrect == NULL) {
       return false;
     }
-    newrect = _newrect;
   }
 
   if (do_float) {
@@ -1710,34 +1800,24 @@ bool IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned int newy
       }
       return false;
     }
-    newrectf = _newrectf;
   }
 
-  stepx = (65536.0 * (ibuf->x - 1.0) / (newx - 1.0)) + 0.5;
-  stepy = (65536.0 * (ibuf->y - 1.0) / (newy - 1.0)) + 0.5;
-  ofsy = 32768;
-
-  for (y = newy; y > 0; y--, ofsy += stepy) {
-    if (do_rect) {
-      rect = ibuf->rect;
-      rect += (ofsy >> 16) * ibuf->x;
-      ofsx = 32768;
-
-      for (x = newx; x > 0; x--, ofsx += stepx) {
-        *newrect++ = rect[ofsx >> 16];
-      }
-    }
-
-    if (do_float) {
-      rectf = (struct imbufRGBA *)ibuf->rect_float;
-      rectf += (ofsy >> 16) * ibuf->x;
-      ofsx = 32768;
-
-      for (x = newx; x > 0; x--, ofsx += stepx) {
-        *newrectf++ = rectf[ofsx >> 16];
-      }
-    }
-  }
+  ScaleFastData data = {
+      .rect = ibuf->rect,
+      .rectf = (struct imbufRGBA *)ibuf->rect_float,
+      .newrect = _newrect,
+      .newrectf = _newrectf,
+      .x = ibuf->x,
+      .newx = newx,
+      .stepx = (65536.0 * (ibuf->x - 1.0) / (newx - 1.0)) + 0.5,
+      .stepy = (65536.0 * (ibuf->y - 1.0) / (newy - 1.0)) + 0.5,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (size_t)newx * newy > 64 * 1024;
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(0, newy, &data, scalefast_row, &settings);
 
   if (do_rect) {
     imb_freerectImBuf(ibuf);
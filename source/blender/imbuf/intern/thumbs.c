@@ -82,10 +82,9 @@
 
 #define URI_MAX (FILE_MAX * 3 + 8)
 
-static bool get_thumb_dir(char *dir, ThumbSize size)
+static bool get_thumb_dir_ex(char *dir, const char *subdir)
 {
   char *s = dir;
-  const char *subdir;
 #ifdef WIN32
   wchar_t dir_16[MAX_PATH];
   /* yes, applications shouldn't store data there, but so does GIMP :)*/
@@ -110,6 +109,17 @@ static bool get_thumb_dir(char *dir, ThumbSize size)
   }
 #  endif
 #endif
+
+  s += BLI_strncpy_rlen(s, subdir, FILE_MAX - (s - dir));
+  (void)s;
+
+  return 1;
+}
+
+static bool get_thumb_dir(char *dir, ThumbSize size)
+{
+  const char *subdir;
+
   switch (size) {
     case THB_NORMAL:
       subdir = "/" THUMBNAILS "/normal/";
@@ -124,10 +134,13 @@ static bool get_thumb_dir(char *dir, ThumbSize size)
       return 0; /* unknown size */
   }
 
-  s += BLI_strncpy_rlen(s, subdir, FILE_MAX - (s - dir));
-  (void)s;
+  return get_thumb_dir_ex(dir, subdir);
+}
 
-  return 1;
+/* Blender specific, the index files are not part of the thumbnail standard. */
+static bool get_thumb_index_dir(char *dir)
+{
+  return get_thumb_dir_ex(dir, "/" THUMBNAILS "/blender_index/");
 }
 
 #undef THUMBNAILS
@@ -316,6 +329,9 @@ void IMB_thumb_makedirs(void)
   if (get_thumb_dir(tpath, THB_FAIL)) {
     BLI_dir_create_recursive(tpath);
   }
+  if (get_thumb_index_dir(tpath)) {
+    BLI_dir_create_recursive(tpath);
+  }
 }
 
 /* create thumbnail for file and returns new imbuf for thumbnail */
@@ -558,6 +574,274 @@ void IMB_thumb_delete(const char *path, ThumbSize size)
   }
 }
 
+/* ***** Directory Index ***** */
+/* While thumbnail locks are held (i.e. by the file browser), the thumbnails of a directory are
+ * also packed in a single index file, so browsing the directory again reads a single file instead
+ * of one PNG file per thumbnail. Records are only appended, the last record of a file wins.
+ * The thumbnail files are still written and read, they remain the reference. */
+
+#define THUMB_INDEX_MAGIC "BTHI"
+#define THUMB_INDEX_VERSION 1
+/* Start over with an empty index when outdated records take more than this, and more than the
+ * valid records. */
+#define THUMB_INDEX_STALE_MAX (16 * 1024 * 1024)
+
+typedef struct ThumbIndexHeader {
+  char magic[4];
+  int version;
+} ThumbIndexHeader;
+
+typedef struct ThumbIndexRecord {
+  /** MD5 hex digest of the file URI, same as the thumbnail file name. */
+  char name[32];
+  /** The "X-Blender::Hash" of the thumbnail, zeroed when unused. */
+  char hash[32];
+  int64_t mtime;
+  /** Size of the PNG data following the record, zero for failed thumbnails. */
+  uint32_t size;
+  uint32_t _pad;
+} ThumbIndexRecord;
+
+typedef struct ThumbIndexEntry {
+  char name[33];
+  ThumbIndexRecord record;
+  /** Offset of the PNG data in the index file. */
+  long offset;
+} ThumbIndexEntry;
+
+typedef struct ThumbIndex {
+  FILE *file;
+  /** Thumbnail name -> #ThumbIndexEntry. */
+  GHash *entries;
+} ThumbIndex;
+
+/* Directory path -> #ThumbIndex, only exists while thumbnail locks are held. */
+static GHash *thumb_indices = NULL;
+static ThreadMutex thumb_index_mutex = BLI_MUTEX_INITIALIZER;
+
+static void thumb_index_record_init(ThumbIndexRecord *record,
+                                    const char *name,
+                                    const int64_t mtime,
+                                    const char *hash,
+                                    const uint32_t size)
+{
+  memset(record, 0, sizeof(*record));
+  memcpy(record->name, name, sizeof(record->name));
+  if (hash) {
+    memcpy(record->hash, hash, sizeof(record->hash));
+  }
+  record->mtime = mtime;
+  record->size = size;
+}
+
+static void thumb_index_entry_set(ThumbIndex *index, const ThumbIndexRecord *record, long offset)
+{
+  ThumbIndexEntry *entry = BLI_ghash_lookup(index->entries, record->name);
+
+  if (entry == NULL) {
+    entry = MEM_mallocN(sizeof(*entry), __func__);
+    memcpy(entry->name, record->name, sizeof(record->name));
+    entry->name[32] = '\0';
+    BLI_ghash_insert(index->entries, entry->name, entry);
+  }
+  entry->record = *record;
+  entry->offset = offset;
+}
+
+/* Read all records of the index file, returns false if the file is invalid or wastes too
+ * much space. */
+static bool thumb_index_read(ThumbIndex *index)
+{
+  ThumbIndexHeader header;
+  ThumbIndexRecord record;
+  size_t stale_size = 0, valid_size = 0;
+  long file_size;
+
+  if (fseek(index->file, 0, SEEK_END) != 0 || (file_size = ftell(index->file)) <= 0 ||
+      fseek(index->file, 0, SEEK_SET) != 0) {
+    return false;
+  }
+  if (fread(&header, sizeof(header), 1, index->file) != 1 ||
+      memcmp(header.magic, THUMB_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != THUMB_INDEX_VERSION) {
+    return false;
+  }
+
+  while (fread(&record, sizeof(record), 1, index->file) == 1) {
+    const long offset = ftell(index->file);
+    const ThumbIndexEntry *entry;
+
+    if (offset + (long)record.size > file_size) {
+      /* Truncated by a crash while writing. */
+      return false;
+    }
+    if ((entry = BLI_ghash_lookup(index->entries, record.name))) {
+      stale_size += sizeof(record) + entry->record.size;
+      valid_size -= sizeof(record) + entry->record.size;
+    }
+    thumb_index_entry_set(index, &record, offset);
+    valid_size += sizeof(record) + record.size;
+
+    if (fseek(index->file, (long)record.size, SEEK_CUR) != 0) {
+      return false;
+    }
+  }
+
+  if (ftell(index->file) != file_size) {
+    /* Partial record at the end. */
+    return false;
+  }
+
+  return !(stale_size > THUMB_INDEX_STALE_MAX && stale_size > valid_size);
+}
+
+static ThumbIndex *thumb_index_open(const char *dir)
+{
+  char index_dir[FILE_MAX];
+  char index_path[FILE_MAX];
+  char hexdigest[33];
+  unsigned char digest[16];
+
+  if (!get_thumb_index_dir(index_dir)) {
+    return NULL;
+  }
+  BLI_hash_md5_buffer(dir, strlen(dir), digest);
+  BLI_snprintf(index_path,
+               sizeof(index_path),
+               "%s%s.idx",
+               index_dir,
+               BLI_hash_md5_to_hexdigest(digest, hexdigest));
+
+  ThumbIndex *index = MEM_callocN(sizeof(*index), __func__);
+  index->entries = BLI_ghash_str_new(__func__);
+
+  /* Writes always append with this mode, reading works anywhere. */
+  index->file = BLI_fopen(index_path, "a+b");
+  if (index->file && !thumb_index_read(index)) {
+    BLI_ghash_clear(index->entries, NULL, MEM_freeN);
+    fclose(index->file);
+
+    index->file = BLI_fopen(index_path, "w+b");
+    if (index->file) {
+      ThumbIndexHeader header = {THUMB_INDEX_MAGIC, THUMB_INDEX_VERSION};
+      if (fwrite(&header, sizeof(header), 1, index->file) != 1) {
+        fclose(index->file);
+        index->file = NULL;
+      }
+    }
+  }
+
+  return index;
+}
+
+static void thumb_index_free(void *index_v)
+{
+  ThumbIndex *index = index_v;
+
+  if (index->file) {
+    fclose(index->file);
+  }
+  BLI_ghash_free(index->entries, NULL, MEM_freeN);
+  MEM_freeN(index);
+}
+
+/* Get the index of directory \a dir, NULL when no index is used.
+ * Must be called with #thumb_index_mutex locked, the index can be freed once it is unlocked. */
+static ThumbIndex *thumb_index_get_locked(const char *dir)
+{
+  ThumbIndex *index = NULL;
+
+  if (thumb_indices) {
+    void **key_p, **index_p;
+    if (!BLI_ghash_ensure_p_ex(thumb_indices, dir, &key_p, &index_p)) {
+      *key_p = BLI_strdup(dir);
+      *index_p = thumb_index_open(dir);
+    }
+    index = *index_p;
+  }
+
+  return (index && index->file) ? index : NULL;
+}
+
+/**
+ * Look up the thumbnail in the index.
+ * \return false when the index has no up to date thumbnail, otherwise \a r_img is set to the
+ * thumbnail or NULL for failed thumbnails.
+ */
+static bool thumb_index_lookup(
+    const char *dir, const char *name, const int64_t mtime, const char *hash, ImBuf **r_img)
+{
+  ThumbIndexRecord record;
+  unsigned char *mem = NULL;
+  bool found = false;
+
+  thumb_index_record_init(&record, name, mtime, hash, 0);
+
+  BLI_mutex_lock(&thumb_index_mutex);
+  ThumbIndex *index = thumb_index_get_locked(dir);
+  const ThumbIndexEntry *entry = index ? BLI_ghash_lookup(index->entries, record.name) : NULL;
+  if (entry && entry->record.mtime == record.mtime &&
+      memcmp(entry->record.hash, record.hash, sizeof(record.hash)) == 0) {
+    if (entry->record.size == 0) {
+      found = true;
+    }
+    else if (fseek(index->file, entry->offset, SEEK_SET) == 0) {
+      mem = MEM_mallocN(entry->record.size, __func__);
+      record.size = entry->record.size;
+      if (fread(mem, record.size, 1, index->file) != 1) {
+        MEM_freeN(mem);
+        mem = NULL;
+      }
+    }
+  }
+  BLI_mutex_unlock(&thumb_index_mutex);
+
+  *r_img = NULL;
+  if (mem) {
+    /* Decode outside of the lock, other threads can read meanwhile. */
+    *r_img = IMB_ibImageFromMemory(mem, record.size, IB_rect, NULL, "thumbnail index");
+    found = (*r_img != NULL);
+    MEM_freeN(mem);
+  }
+
+  return found;
+}
+
+/* Add the thumbnail file at \a thumb_path to the index, or a failed thumbnail when NULL. */
+static void thumb_index_add(const char *dir,
+                            const char *name,
+                            const int64_t mtime,
+                            const char *hash,
+                            const char *thumb_path)
+{
+  ThumbIndexRecord record;
+  void *mem = NULL;
+  size_t size = 0;
+
+  if (thumb_path) {
+    mem = BLI_file_read_binary_as_mem(thumb_path, 0, &size);
+    if (mem == NULL || size == 0 || size > UINT32_MAX) {
+      MEM_SAFE_FREE(mem);
+      return;
+    }
+  }
+
+  thumb_index_record_init(&record, name, mtime, hash, (uint32_t)size);
+
+  BLI_mutex_lock(&thumb_index_mutex);
+  ThumbIndex *index = thumb_index_get_locked(dir);
+  if (index && fseek(index->file, 0, SEEK_END) == 0) {
+    const long offset = ftell(index->file) + (long)sizeof(record);
+    if (fwrite(&record, sizeof(record), 1, index->file) == 1 &&
+        (size == 0 || fwrite(mem, size, 1, index->file) == 1) && fflush(index->file) == 0) {
+      thumb_index_entry_set(index, &record, offset);
+    }
+  }
+  BLI_mutex_unlock(&thumb_index_mutex);
+
+  MEM_SAFE_FREE(mem);
+}
+
 /* create the thumb if necessary and manage failed and old thumbs */
 ImBuf *IMB_thumb_manage(const char *org_path, ThumbSize size, ThumbSource source)
 {
@@ -570,6 +854,9 @@ ImBuf *IMB_thumb_manage(const char *org_path, ThumbSize size, ThumbSource source
   BLI_stat_t st;
   ImBuf *img = NULL;
   char *blen_group = NULL, *blen_id = NULL;
+  bool use_index = false;
+  char index_dir[FILE_MAX];
+  char index_hash[33];
 
   path = file_path = org_path;
   if (source == THB_SOURCE_BLEND) {
@@ -590,6 +877,19 @@ ImBuf *IMB_thumb_manage(const char *org_path, ThumbSize size, ThumbSource source
   if (!uri_from_filename(path, uri)) {
     return NULL;
   }
+
+  if (size == THB_LARGE) {
+    use_index = true;
+    BLI_split_dir_part(file_path, index_dir, sizeof(index_dir));
+    thumbname_from_uri(uri, thumb_name, sizeof(thumb_name));
+    if (!thumbhash_from_path(file_path, source, index_hash)) {
+      memset(index_hash, 0, sizeof(index_hash));
+    }
+    if (thumb_index_lookup(index_dir, thumb_name, st.st_mtime, index_hash, &img)) {
+      return img;
+    }
+  }
+
   if (thumbpath_from_uri(uri, thumb_path, sizeof(thumb_path), THB_FAIL)) {
     /* failure thumb exists, don't try recreating */
     if (BLI_exists(thumb_path)) {
@@ -598,6 +898,9 @@ ImBuf *IMB_thumb_manage(const char *org_path, ThumbSize size, ThumbSource source
         BLI_delete(thumb_path, false, false);
       }
       else {
+        if (use_index) {
+          thumb_index_add(index_dir, thumb_name, st.st_mtime, index_hash, NULL);
+        }
         return NULL;
       }
     }
@@ -607,6 +910,7 @@ ImBuf *IMB_thumb_manage(const char *org_path, ThumbSize size, ThumbSource source
           uri, thumb_path, sizeof(thumb_path), thumb_name, sizeof(thumb_name), size)) {
     if (BLI_path_ncmp(path, thumb_path, sizeof(thumb_path)) == 0) {
       img = IMB_loadiffname(path, IB_rect, NULL);
+      use_index = false;
     }
     else {
       img = IMB_loadiffname(thumb_path, IB_rect | IB_metadata, NULL);
@@ -658,6 +962,10 @@ ImBuf *IMB_thumb_manage(const char *org_path, ThumbSize size, ThumbSource source
     }
   }
 
+  if (use_index) {
+    thumb_index_add(index_dir, thumb_name, st.st_mtime, index_hash, img ? thumb_path : NULL);
+  }
+
   /* Our imbuf **must** have a valid rect (i.e. 8-bits/channels)
    * data, we rely on this in draw code.
    * However, in some cases we may end loading 16bits PNGs, which generated float buffers.
@@ -690,6 +998,10 @@ void IMB_thumb_locks_acquire(void)
     BLI_assert(thumb_locks.locked_paths == NULL);
     thumb_locks.locked_paths = BLI_gset_str_new(__func__);
     BLI_condition_init(&thumb_locks.cond);
+
+    BLI_mutex_lock(&thumb_index_mutex);
+    thumb_indices = BLI_ghash_str_new(__func__);
+    BLI_mutex_unlock(&thumb_index_mutex);
   }
   thumb_locks.lock_counter++;
 
@@ -708,6 +1020,11 @@ void IMB_thumb_locks_release(void)
     BLI_gset_free(thumb_locks.locked_paths, MEM_freeN);
     thumb_locks.locked_paths = NULL;
     BLI_condition_end(&thumb_locks.cond);
+
+    BLI_mutex_lock(&thumb_index_mutex);
+    BLI_ghash_free(thumb_indices, MEM_freeN, thumb_index_free);
+    thumb_indices = NULL;
+    BLI_mutex_unlock(&thumb_index_mutex);
   }
 
   BLI_thread_unlock(LOCK_IMAGE);
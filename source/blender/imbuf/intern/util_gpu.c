@@ -25,6 +25,7 @@
 #include "imbuf.h"
 
 #include "BLI_math.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 #include "MEM_guardedalloc.h"
 
@@ -37,6 +38,9 @@
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
+#include "IMB_allocimbuf.h"
+#include "IMB_colormanagement_intern.h"
+
 /* gpu ibuf utils */
 
 static void imb_gpu_get_format(const ImBuf *ibuf,
@@ -259,3 +263,113 @@ GPUTexture *IMB_create_gpu_texture(ImBuf *ibuf, bool use_high_bitdepth, bool use
 
   return tex;
 }
+
+/* Draw textures, for the few most recently drawn image buffers only, since they are as large
+ * as the image buffers themselves. Buffers can be freed from any thread. */
+#define DRAW_GPU_TEXTURES_MAX 4
+
+static ImBuf *draw_gpu_texture_users[DRAW_GPU_TEXTURES_MAX];
+static ThreadMutex draw_gpu_texture_lock = BLI_MUTEX_INITIALIZER;
+
+static void draw_gpu_texture_users_remove(ImBuf *ibuf)
+{
+  for (int i = 0; i < DRAW_GPU_TEXTURES_MAX; i++) {
+    if (draw_gpu_texture_users[i] == ibuf) {
+      memmove(&draw_gpu_texture_users[i],
+              &draw_gpu_texture_users[i + 1],
+              sizeof(ImBuf *) * (DRAW_GPU_TEXTURES_MAX - i - 1));
+      draw_gpu_texture_users[DRAW_GPU_TEXTURES_MAX - 1] = NULL;
+      break;
+    }
+  }
+}
+
+void imb_free_draw_gpu_texture(ImBuf *ibuf)
+{
+  if (ibuf->draw_gputexture == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&draw_gpu_texture_lock);
+  /* Check again, the texture may have been freed by #IMB_draw_gpu_texture_ensure meanwhile. */
+  if (ibuf->draw_gputexture) {
+    draw_gpu_texture_users_remove(ibuf);
+    /* Deletion is delayed until a GPU context is active when freed from other threads. */
+    GPU_texture_free(ibuf->draw_gputexture);
+    ibuf->draw_gputexture = NULL;
+  }
+  BLI_mutex_unlock(&draw_gpu_texture_lock);
+}
+
+/* Texture with the pixels of the float buffer, or the byte buffer if there is none, without any
+ * color space conversion, for drawing with the GLSL display transform.
+ * The texture is kept with the buffer and uploaded again only when the pixels are marked as
+ * changed for the display buffers, so changing view settings doesn't upload the pixels again.
+ * Must be called from the main thread, returns NULL when the buffer can't be drawn this way. */
+GPUTexture *IMB_draw_gpu_texture_ensure(ImBuf *ibuf)
+{
+  if (colormanage_display_buffer_changes_consume(ibuf)) {
+    imb_free_draw_gpu_texture(ibuf);
+  }
+
+  if (ibuf->draw_gputexture == NULL) {
+    const int max_size = GPU_max_texture_size();
+    eGPUTextureFormat tex_format;
+    eGPUDataFormat data_format;
+    void *data;
+
+    if (ibuf->x > max_size || ibuf->y > max_size) {
+      return NULL;
+    }
+
+    if (ibuf->rect_float) {
+      if (ibuf->channels == 3) {
+        tex_format = GPU_RGB16F;
+      }
+      else if (ibuf->channels == 4) {
+        tex_format = GPU_RGBA16F;
+      }
+      else {
+        return NULL;
+      }
+      data_format = GPU_DATA_FLOAT;
+      data = ibuf->rect_float;
+    }
+    else if (ibuf->rect) {
+      /* ibuf->rect is always RGBA */
+      tex_format = GPU_RGBA8;
+      data_format = GPU_DATA_UNSIGNED_BYTE;
+      data = ibuf->rect;
+    }
+    else {
+      return NULL;
+    }
+
+    GPUTexture *tex = GPU_texture_create_nD(
+        ibuf->x, ibuf->y, 0, 2, data, tex_format, data_format, 0, false, NULL);
+    if (tex == NULL) {
+      return NULL;
+    }
+    GPU_texture_wrap_mode(tex, false, true);
+
+    BLI_mutex_lock(&draw_gpu_texture_lock);
+    ibuf->draw_gputexture = tex;
+    BLI_mutex_unlock(&draw_gpu_texture_lock);
+  }
+
+  /* Move to the front of the most recently drawn buffers, freeing the texture of the oldest. */
+  BLI_mutex_lock(&draw_gpu_texture_lock);
+  draw_gpu_texture_users_remove(ibuf);
+  ImBuf *oldest = draw_gpu_texture_users[DRAW_GPU_TEXTURES_MAX - 1];
+  if (oldest) {
+    GPU_texture_free(oldest->draw_gputexture);
+    oldest->draw_gputexture = NULL;
+  }
+  memmove(&draw_gpu_texture_users[1],
+          &draw_gpu_texture_users[0],
+          sizeof(ImBuf *) * (DRAW_GPU_TEXTURES_MAX - 1));
+  draw_gpu_texture_users[0] = ibuf;
+  BLI_mutex_unlock(&draw_gpu_texture_lock);
+
+  return ibuf->draw_gputexture;
+}
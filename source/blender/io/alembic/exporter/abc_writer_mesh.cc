@@ -24,6 +24,7 @@
 
 #include "BLI_assert.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_lib_id.h"
@@ -460,15 +461,74 @@ void ABCGenericMeshWriter::get_geo_groups(Object *object,
 
 /* NOTE: Alembic's polygon winding order is clockwise, to match with Renderman. */
 
+/* Meshes below this size are converted on a single thread. */
+#define ABC_MESH_THREAD_MIN 10000
+
+static void get_parallel_settings(TaskParallelSettings *settings, const int len)
+{
+  BLI_parallel_range_settings_defaults(settings);
+  settings->use_threading = len > ABC_MESH_THREAD_MIN;
+  settings->min_iter_per_thread = 1024;
+}
+
+/* Start of every polygon in the reversed loop order of Alembic,
+ * the loops of the mesh don't need to be in polygon order. */
+static void get_poly_offsets(struct Mesh *mesh, std::vector<int> &poly_offsets)
+{
+  poly_offsets.resize(mesh->totpoly);
+
+  int offset = 0;
+  for (int i = 0; i < mesh->totpoly; i++) {
+    poly_offsets[i] = offset;
+    offset += mesh->mpoly[i].totloop;
+  }
+}
+
+struct VerticesData {
+  const MVert *verts;
+  Imath::V3f *points;
+};
+
+static void get_vertices_cb(void *__restrict userdata,
+                            const int i,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  const VerticesData *data = static_cast<const VerticesData *>(userdata);
+  copy_yup_from_zup(data->points[i].getValue(), data->verts[i].co);
+}
+
 static void get_vertices(struct Mesh *mesh, std::vector<Imath::V3f> &points)
 {
   points.clear();
   points.resize(mesh->totvert);
 
-  MVert *verts = mesh->mvert;
+  VerticesData data;
+  data.verts = mesh->mvert;
+  data.points = points.data();
 
-  for (int i = 0, e = mesh->totvert; i < e; i++) {
-    copy_yup_from_zup(points[i].getValue(), verts[i].co);
+  TaskParallelSettings settings;
+  get_parallel_settings(&settings, mesh->totvert);
+  BLI_task_parallel_range(0, mesh->totvert, &data, get_vertices_cb, &settings);
+}
+
+struct TopologyData {
+  const MPoly *mpoly;
+  const MLoop *mloop;
+  const int *poly_offsets;
+  int32_t *poly_verts;
+};
+
+static void get_topology_cb(void *__restrict userdata,
+                            const int i,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  const TopologyData *data = static_cast<const TopologyData *>(userdata);
+  const MPoly &poly = data->mpoly[i];
+  const MLoop *loop = data->mloop + poly.loopstart + (poly.totloop - 1);
+  int32_t *poly_verts = data->poly_verts + data->poly_offsets[i];
+
+  for (int j = 0; j < poly.totloop; j++, loop--) {
+    poly_verts[j] = loop->v;
   }
 }
 
@@ -479,28 +539,32 @@ static void get_topology(struct Mesh *mesh,
 {
   const int num_poly = mesh->totpoly;
   const int num_loops = mesh->totloop;
-  MLoop *mloop = mesh->mloop;
   MPoly *mpoly = mesh->mpoly;
   r_has_flat_shaded_poly = false;
 
   poly_verts.clear();
   loop_counts.clear();
-  poly_verts.reserve(num_loops);
-  loop_counts.reserve(num_poly);
+  poly_verts.resize(num_loops);
+  loop_counts.resize(num_poly);
 
-  /* NOTE: data needs to be written in the reverse order. */
   for (int i = 0; i < num_poly; i++) {
-    MPoly &poly = mpoly[i];
-    loop_counts.push_back(poly.totloop);
-
-    r_has_flat_shaded_poly |= (poly.flag & ME_SMOOTH) == 0;
+    loop_counts[i] = mpoly[i].totloop;
+    r_has_flat_shaded_poly |= (mpoly[i].flag & ME_SMOOTH) == 0;
+  }
 
-    MLoop *loop = mloop + poly.loopstart + (poly.totloop - 1);
+  std::vector<int> poly_offsets;
+  get_poly_offsets(mesh, poly_offsets);
 
-    for (int j = 0; j < poly.totloop; j++, loop--) {
-      poly_verts.push_back(loop->v);
-    }
-  }
+  /* NOTE: data needs to be written in the reverse order. */
+  TopologyData data;
+  data.mpoly = mpoly;
+  data.mloop = mesh->mloop;
+  data.poly_offsets = poly_offsets.data();
+  data.poly_verts = poly_verts.data();
+
+  TaskParallelSettings settings;
+  get_parallel_settings(&settings, num_loops);
+  BLI_task_parallel_range(0, num_poly, &data, get_topology_cb, &settings);
 }
 
 static void get_creases(struct Mesh *mesh,
@@ -529,6 +593,27 @@ static void get_creases(struct Mesh *mesh,
   lengths.resize(sharpnesses.size(), 2);
 }
 
+struct LoopNormalsData {
+  const MPoly *mpoly;
+  const float(*lnors)[3];
+  const int *poly_offsets;
+  Imath::V3f *normals;
+};
+
+static void get_loop_normals_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict /*tls*/)
+{
+  const LoopNormalsData *data = static_cast<const LoopNormalsData *>(userdata);
+  const MPoly &poly = data->mpoly[i];
+  int abc_index = data->poly_offsets[i];
+
+  for (int j = poly.totloop - 1; j >= 0; j--, abc_index++) {
+    int blender_index = poly.loopstart + j;
+    copy_yup_from_zup(data->normals[abc_index].getValue(), data->lnors[blender_index]);
+  }
+}
+
 static void get_loop_normals(struct Mesh *mesh,
                              std::vector<Imath::V3f> &normals,
                              bool has_flat_shaded_poly)
@@ -548,15 +633,19 @@ static void get_loop_normals(struct Mesh *mesh,
 
   normals.resize(mesh->totloop);
 
+  std::vector<int> poly_offsets;
+  get_poly_offsets(mesh, poly_offsets);
+
   /* NOTE: data needs to be written in the reverse order. */
-  int abc_index = 0;
-  MPoly *mp = mesh->mpoly;
-  for (int i = 0, e = mesh->totpoly; i < e; i++, mp++) {
-    for (int j = mp->totloop - 1; j >= 0; j--, abc_index++) {
-      int blender_index = mp->loopstart + j;
-      copy_yup_from_zup(normals[abc_index].getValue(), lnors[blender_index]);
-    }
-  }
+  LoopNormalsData data;
+  data.mpoly = mesh->mpoly;
+  data.lnors = lnors;
+  data.poly_offsets = poly_offsets.data();
+  data.normals = normals.data();
+
+  TaskParallelSettings settings;
+  get_parallel_settings(&settings, mesh->totloop);
+  BLI_task_parallel_range(0, mesh->totpoly, &data, get_loop_normals_cb, &settings);
 }
 
 ABCMeshWriter::ABCMeshWriter(const ABCWriterConstructorArgs &args) : ABCGenericMeshWriter(args)
@@ -34,6 +34,7 @@
 
 #include "BLI_compiler_compat.h"
 #include "BLI_math_geom.h"
+#include "BLI_task.h"
 
 #include "BKE_main.h"
 #include "BKE_material.h"
@@ -57,6 +58,7 @@ using Alembic::AbcGeom::IV2fGeomParam;
 using Alembic::AbcGeom::kWrapExisting;
 using Alembic::AbcGeom::N3fArraySample;
 using Alembic::AbcGeom::N3fArraySamplePtr;
+using Alembic::AbcGeom::index_t;
 using Alembic::AbcGeom::UInt32ArraySamplePtr;
 using Alembic::AbcGeom::V2fArraySamplePtr;
 
@@ -66,6 +68,9 @@ namespace alembic {
 
 /* NOTE: Alembic's polygon winding order is clockwise, to match with Renderman. */
 
+/* Number of samples following the current one read in the background during playback. */
+#define ABC_PREFETCH_SAMPLES 3
+
 /* Some helpers for mesh generation */
 namespace utils {
 
@@ -258,6 +263,44 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
   }
 }
 
+/* Only read the UVs, for when the polygons of the mesh are kept from a previous sample. */
+static void read_mloopuvs(CDStreamConfig &config, const AbcMeshData &mesh_data)
+{
+  MLoopUV *mloopuvs = config.mloopuv;
+
+  const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
+  const V2fArraySamplePtr &uvs = mesh_data.uvs;
+  const UInt32ArraySamplePtr &uvs_indices = mesh_data.uvs_indices;
+
+  if (!(mloopuvs && uvs && uvs_indices) ||
+      (uvs_indices->size() != mesh_data.face_indices->size())) {
+    return;
+  }
+
+  const size_t uvs_size = uvs->size();
+  unsigned int loop_index = 0;
+
+  for (int i = 0; i < face_counts->size(); i++) {
+    const int face_size = (*face_counts)[i];
+
+    /* NOTE: Alembic data is stored in the reverse order. */
+    unsigned int rev_loop_index = loop_index + (face_size - 1);
+
+    for (int f = 0; f < face_size; f++, loop_index++, rev_loop_index--) {
+      const unsigned int uv_index = (*uvs_indices)[loop_index];
+
+      /* Some Alembic files are broken (or at least export UVs in a way we don't expect). */
+      if (uv_index >= uvs_size) {
+        continue;
+      }
+
+      MLoopUV &loopuv = mloopuvs[rev_loop_index];
+      loopuv.uv[0] = (*uvs)[uv_index][0];
+      loopuv.uv[1] = (*uvs)[uv_index][1];
+    }
+  }
+}
+
 static void process_no_normals(CDStreamConfig &config)
 {
   /* Absense of normals in the Alembic mesh is interpreted as 'smooth'. */
@@ -411,14 +454,18 @@ static void get_weight_and_index(CDStreamConfig &config,
   config.ceil_index = i1;
 }
 
+/**
+ * \param keep_topology: The polygons and edges of the mesh already match the sample,
+ * only the data that can vary over time is read.
+ */
 static void read_mesh_sample(const std::string &iobject_full_name,
                              ImportSettings *settings,
                              const IPolyMeshSchema &schema,
+                             const IPolyMeshSchema::Sample &sample,
                              const ISampleSelector &selector,
+                             const bool keep_topology,
                              CDStreamConfig &config)
 {
-  const IPolyMeshSchema::Sample sample = schema.getValue(selector);
-
   AbcMeshData abc_mesh_data;
   abc_mesh_data.face_counts = sample.getFaceCounts();
   abc_mesh_data.face_indices = sample.getFaceIndices();
@@ -433,7 +480,12 @@ static void read_mesh_sample(const std::string &iobject_full_name,
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_UV) != 0) {
-    read_uvs_params(config, abc_mesh_data, schema.getUVsParam(), selector);
+    const IV2fGeomParam &uv = schema.getUVsParam();
+    /* Constant UVs were already read along with the topology. */
+    if (!keep_topology || !uv.valid() || !uv.isConstant() ||
+        !CustomData_has_layer(config.loopdata, CD_MLOOPUV)) {
+      read_uvs_params(config, abc_mesh_data, uv, selector);
+    }
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_VERT) != 0) {
@@ -441,7 +493,12 @@ static void read_mesh_sample(const std::string &iobject_full_name,
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
-    read_mpolys(config, abc_mesh_data);
+    if (keep_topology) {
+      read_mloopuvs(config, abc_mesh_data);
+    }
+    else {
+      read_mpolys(config, abc_mesh_data);
+    }
     process_normals(config, schema.getNormalsParam(), selector);
   }
 
@@ -471,7 +528,7 @@ CDStreamConfig get_config(Mesh *mesh)
 /* ************************************************************************** */
 
 AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
-    : AbcObjectReader(object, settings)
+    : AbcObjectReader(object, settings), m_prefetch_pool(nullptr), m_prefetch_index(-1)
 {
   m_settings->read_flag |= MOD_MESHSEQ_READ_ALL;
 
@@ -481,6 +538,113 @@ AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
   get_min_max_time(m_iobject, m_schema, m_min_time, m_max_time);
 }
 
+AbcMeshReader::~AbcMeshReader()
+{
+  if (m_prefetch_pool) {
+    BLI_task_pool_cancel(m_prefetch_pool);
+    BLI_task_pool_free(m_prefetch_pool);
+  }
+}
+
+IPolyMeshSchema::Sample AbcMeshReader::read_sample(const ISampleSelector &sample_sel)
+{
+  if (m_prefetch_pool) {
+    const index_t index = sample_sel.getIndex(m_schema.getTimeSampling(),
+                                              m_schema.getNumSamples());
+    std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+    std::map<index_t, IPolyMeshSchema::Sample>::const_iterator found = m_prefetch_samples.find(
+        index);
+    if (found != m_prefetch_samples.end()) {
+      return found->second;
+    }
+  }
+
+  return m_schema.getValue(sample_sel);
+}
+
+void AbcMeshReader::prefetch_sample(index_t index)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+    if (m_prefetch_samples.find(index) != m_prefetch_samples.end()) {
+      return;
+    }
+  }
+
+  IPolyMeshSchema::Sample sample;
+  try {
+    sample = m_schema.getValue(ISampleSelector(index));
+  }
+  catch (Alembic::Util::Exception & /*ex*/) {
+    /* Reported when the sample is read for the frame it belongs to. */
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+  m_prefetch_samples[index] = sample;
+}
+
+struct AbcMeshPrefetchTask {
+  AbcMeshReader *reader;
+  index_t index;
+};
+
+static void abc_mesh_prefetch_task(TaskPool *__restrict pool, void *taskdata)
+{
+  AbcMeshPrefetchTask *task = static_cast<AbcMeshPrefetchTask *>(taskdata);
+  if (!BLI_task_pool_canceled(pool)) {
+    task->reader->prefetch_sample(task->index);
+  }
+}
+
+void AbcMeshReader::prefetch(const ISampleSelector &sample_sel)
+{
+  const size_t num_samples = m_schema.getNumSamples();
+  if (num_samples < 2) {
+    return;
+  }
+
+  const index_t index = sample_sel.getIndex(m_schema.getTimeSampling(), num_samples);
+  const index_t last_index = std::min(index + ABC_PREFETCH_SAMPLES, index_t(num_samples) - 1);
+
+  /* Keep the memory bounded, only samples ahead of the current one are used. */
+  {
+    std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+    std::map<index_t, IPolyMeshSchema::Sample>::iterator it = m_prefetch_samples.begin();
+    while (it != m_prefetch_samples.end()) {
+      if (it->first < index || it->first > last_index) {
+        it = m_prefetch_samples.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+
+  if (m_prefetch_pool == nullptr) {
+    m_prefetch_pool = BLI_task_pool_create_background_serial(nullptr, TASK_PRIORITY_LOW);
+  }
+
+  index_t first_index = index + 1;
+  if (m_prefetch_index >= index && m_prefetch_index <= last_index) {
+    /* Playing forward, the samples up to the last queued one are read or being read. */
+    first_index = m_prefetch_index + 1;
+  }
+  else {
+    /* Jumped to another frame, the queued samples won't be needed soon. */
+    BLI_task_pool_cancel(m_prefetch_pool);
+  }
+
+  for (index_t i = first_index; i <= last_index; i++) {
+    AbcMeshPrefetchTask *task = static_cast<AbcMeshPrefetchTask *>(
+        MEM_mallocN(sizeof(AbcMeshPrefetchTask), __func__));
+    task->reader = this;
+    task->index = i;
+    BLI_task_pool_push(m_prefetch_pool, abc_mesh_prefetch_task, task, true, nullptr);
+  }
+  m_prefetch_index = last_index;
+}
+
 bool AbcMeshReader::valid() const
 {
   return m_schema.valid();
@@ -550,7 +714,7 @@ bool AbcMeshReader::topology_changed(Mesh *existing_mesh, const ISampleSelector
 {
   IPolyMeshSchema::Sample sample;
   try {
-    sample = m_schema.getValue(sample_sel);
+    sample = read_sample(sample_sel);
   }
   catch (Alembic::Util::Exception &ex) {
     printf("Alembic: error reading mesh sample for '%s/%s' at time %f: %s\n",
@@ -578,7 +742,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
 {
   IPolyMeshSchema::Sample sample;
   try {
-    sample = m_schema.getValue(sample_sel);
+    sample = read_sample(sample_sel);
   }
   catch (Alembic::Util::Exception &ex) {
     if (err_str != nullptr) {
@@ -612,6 +776,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   }
 
   Mesh *new_mesh = NULL;
+  bool keep_topology = false;
 
   /* Only read point data when streaming meshes, unless we need to create new ones. */
   ImportSettings settings;
@@ -637,13 +802,20 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
             " mesh. Only vertices will be read!";
       }
     }
+    else if (m_schema.getTopologyVariance() != Alembic::AbcGeom::kHeterogenousTopology) {
+      /* The topology never changes in the file, so the polygons and edges of the existing mesh
+       * were read from it before. Rebuilding them every frame dominates playback of large
+       * caches. */
+      keep_topology = true;
+    }
   }
 
   CDStreamConfig config = get_config(new_mesh ? new_mesh : existing_mesh);
   config.time = sample_sel.getRequestedTime();
   config.modifier_error_message = err_str;
 
-  read_mesh_sample(m_iobject.getFullName(), &settings, m_schema, sample_sel, config);
+  read_mesh_sample(
+      m_iobject.getFullName(), &settings, m_schema, sample, sample_sel, keep_topology, config);
 
   if (new_mesh) {
     /* Here we assume that the number of materials doesn't change, i.e. that
@@ -22,7 +22,11 @@
 #include "abc_customdata.h"
 #include "abc_reader_object.h"
 
+#include <map>
+#include <mutex>
+
 struct Mesh;
+struct TaskPool;
 
 namespace blender {
 namespace io {
@@ -33,8 +37,17 @@ class AbcMeshReader : public AbcObjectReader {
 
   CDStreamConfig m_mesh_data;
 
+  /** Samples following the current one, read on a background thread during playback. */
+  std::map<Alembic::AbcGeom::index_t, Alembic::AbcGeom::IPolyMeshSchema::Sample>
+      m_prefetch_samples;
+  std::mutex m_prefetch_mutex;
+  struct TaskPool *m_prefetch_pool;
+  /** Last sample index pushed to the pool. */
+  Alembic::AbcGeom::index_t m_prefetch_index;
+
  public:
   AbcMeshReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+  ~AbcMeshReader();
 
   bool valid() const override;
   bool accepts_object_type(const Alembic::AbcCoreAbstract::ObjectHeader &alembic_header,
@@ -48,8 +61,16 @@ class AbcMeshReader : public AbcObjectReader {
                          const char **err_str) override;
   bool topology_changed(Mesh *existing_mesh,
                         const Alembic::Abc::ISampleSelector &sample_sel) override;
+  void prefetch(const Alembic::Abc::ISampleSelector &sample_sel) override;
+
+  /** Read a sample on a background thread, storing it for #read_sample. */
+  void prefetch_sample(Alembic::AbcGeom::index_t index);
 
  private:
+  /** Get a sample, from the prefetched ones when available. */
+  Alembic::AbcGeom::IPolyMeshSchema::Sample read_sample(
+      const Alembic::Abc::ISampleSelector &sample_sel);
+
   void readFaceSetsSample(Main *bmain,
                           Mesh *mesh,
                           const Alembic::AbcGeom::ISampleSelector &sample_sel);
@@ -189,6 +189,10 @@ bool AbcObjectReader::topology_changed(Mesh * /*existing_mesh*/,
   return false;
 }
 
+void AbcObjectReader::prefetch(const Alembic::Abc::ISampleSelector & /*sample_sel*/)
+{
+}
+
 void AbcObjectReader::setupObjectTransform(const float time)
 {
   bool is_constant = false;
@@ -147,6 +147,8 @@ class AbcObjectReader {
                                  const char **err_str);
   virtual bool topology_changed(Mesh *existing_mesh,
                                 const Alembic::Abc::ISampleSelector &sample_sel);
+  /** Start reading the samples following \a sample_sel in the background. */
+  virtual void prefetch(const Alembic::Abc::ISampleSelector &sample_sel);
 
   /** Reads the object matrix and sets up an object transform if animated. */
   void setupObjectTransform(const float time);
@@ -799,7 +799,12 @@ Mesh *ABC_read_mesh(CacheReader *reader,
   }
 
   ISampleSelector sample_sel = sample_selector_for_time(time);
-  return abc_reader->read_mesh(existing_mesh, sample_sel, read_flag, err_str);
+  Mesh *result = abc_reader->read_mesh(existing_mesh, sample_sel, read_flag, err_str);
+
+  /* Read the following samples while the rest of the frame is evaluated and drawn. */
+  abc_reader->prefetch(sample_sel);
+
+  return result;
 }
 
 bool ABC_mesh_topology_changed(
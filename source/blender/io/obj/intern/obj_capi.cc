@@ -0,0 +1,76 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup obj
+ */
+
+#include "obj.h"
+#include "obj_file_writer.h"
+#include "obj_hierarchy_iterator.h"
+
+#include <cstdio>
+
+#include "BKE_blender_version.h"
+#include "BKE_context.h"
+#include "BKE_scene.h"
+
+#include "BLI_fileops.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+
+#include "WM_api.h"
+#include "WM_types.h"
+
+bool OBJ_export(bContext *C, const char *filepath, const OBJExportParams *params)
+{
+  using namespace blender::io::obj;
+
+  Main *bmain = CTX_data_main(C);
+  Scene *scene = CTX_data_scene(C);
+  ViewLayer *view_layer = CTX_data_view_layer(C);
+
+  FILE *file = BLI_fopen(filepath, "wb");
+  if (file == nullptr) {
+    WM_reportf(RPT_ERROR, "OBJ Export: cannot open file %s for writing", filepath);
+    return false;
+  }
+  /* The formatted chunks are large already, avoid splitting them into small writes. */
+  setvbuf(file, nullptr, _IOFBF, 1 << 20);
+  fprintf(file, "# Blender v%s OBJ File\n", BKE_blender_version_string());
+
+  Depsgraph *depsgraph = DEG_graph_new(bmain, scene, view_layer, params->evaluation_mode);
+  DEG_graph_build_from_view_layer(depsgraph, bmain, scene, view_layer);
+  BKE_scene_graph_update_tagged(depsgraph, bmain);
+
+  OBJFileWriter file_writer(file, *params);
+  OBJHierarchyIterator iter(depsgraph, file_writer, *params);
+  iter.iterate_and_write();
+  iter.release_writers();
+
+  DEG_graph_free(depsgraph);
+
+  const bool ok = !ferror(file);
+  if (fclose(file) != 0 || !ok) {
+    WM_reportf(RPT_ERROR, "OBJ Export: error writing file %s", filepath);
+    return false;
+  }
+  return true;
+}
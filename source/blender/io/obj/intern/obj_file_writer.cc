@@ -0,0 +1,212 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup obj
+ */
+
+#include "obj_file_writer.h"
+
+#include <algorithm>
+#include <cstdarg>
+
+#include "BLI_array.hh"
+#include "BLI_math_matrix.h"
+#include "BLI_math_rotation.h"
+#include "BLI_math_vector.h"
+#include "BLI_task.h"
+#include "BLI_vector.hh"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::io::obj {
+
+/* Number of elements formatted by one task. Each task formats into its own buffer, and the
+ * buffers are written in order, so the output doesn't depend on the number of threads. */
+static const int64_t OBJ_CHUNK_SIZE = 32768;
+
+OBJFileWriter::OBJFileWriter(FILE *file, const OBJExportParams &params)
+    : file_(file), params_(params)
+{
+}
+
+static void append_format(std::string &buf, const char *format, ...) ATTR_PRINTF_FORMAT(2, 3);
+static void append_format(std::string &buf, const char *format, ...)
+{
+  char line[256];
+  va_list args;
+  va_start(args, format);
+  const int len = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  buf.append(line, std::min<size_t>(len, sizeof(line) - 1));
+}
+
+template<typename FormatElemFn> struct FormatTaskData {
+  const FormatElemFn *format_elem;
+  int64_t elems_len;
+  Array<std::string> *chunks;
+};
+
+template<typename FormatElemFn>
+static void format_chunk_cb(void *__restrict userdata,
+                            const int chunk,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  const FormatTaskData<FormatElemFn> *data = static_cast<FormatTaskData<FormatElemFn> *>(
+      userdata);
+  std::string &buf = (*data->chunks)[chunk];
+  const int64_t start = chunk * OBJ_CHUNK_SIZE;
+  const int64_t end = std::min(start + OBJ_CHUNK_SIZE, data->elems_len);
+  for (int64_t i = start; i < end; i++) {
+    (*data->format_elem)(i, buf);
+  }
+}
+
+template<typename FormatElemFn>
+void OBJFileWriter::write_elements(const int64_t elems_len, const FormatElemFn &format_elem)
+{
+  const int64_t chunks_len = (elems_len + OBJ_CHUNK_SIZE - 1) / OBJ_CHUNK_SIZE;
+  Array<std::string> chunks(chunks_len);
+  FormatTaskData<FormatElemFn> data = {&format_elem, elems_len, &chunks};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, chunks_len, &data, format_chunk_cb<FormatElemFn>, &settings);
+
+  for (const std::string &buf : chunks) {
+    fwrite(buf.data(), 1, buf.size(), file_);
+  }
+}
+
+void OBJFileWriter::write_mesh(const std::string &name, const Mesh *mesh, const float obmat[4][4])
+{
+  /* OBJ files are Y-up. */
+  float mat[4][4], axis_mat[4][4];
+  axis_angle_to_mat4_single(axis_mat, 'X', -M_PI_2);
+  mul_m4_m4m4(mat, axis_mat, obmat);
+  mul_m4_fl(mat, params_.scale);
+  mat[3][3] = 1.0f;
+
+  float normal_mat[3][3];
+  copy_m3_m4(normal_mat, mat);
+  invert_m3(normal_mat);
+  transpose_m3(normal_mat);
+
+  const MVert *mverts = mesh->mvert;
+  const MPoly *mpolys = mesh->mpoly;
+  const MLoop *mloops = mesh->mloop;
+  const MLoopUV *mloopuvs = params_.export_uvs ? static_cast<const MLoopUV *>(
+                                                     CustomData_get_layer(&mesh->ldata,
+                                                                          CD_MLOOPUV)) :
+                                                 nullptr;
+
+  fprintf(file_, "o %s\n", name.c_str());
+
+  write_elements(mesh->totvert, [&](const int64_t i, std::string &buf) {
+    float co[3];
+    mul_v3_m4v3(co, mat, mverts[i].co);
+    append_format(buf, "v %.6f %.6f %.6f\n", co[0], co[1], co[2]);
+  });
+
+  if (mloopuvs) {
+    write_elements(mesh->totloop, [&](const int64_t i, std::string &buf) {
+      append_format(buf, "vt %.6f %.6f\n", mloopuvs[i].uv[0], mloopuvs[i].uv[1]);
+    });
+  }
+
+  /* Smooth faces use the vertex normals, flat faces get a normal each, after those. */
+  Array<int> flat_normal_indices(params_.export_normals ? mesh->totpoly : 0);
+  int flat_normals_len = 0;
+  if (params_.export_normals) {
+    for (int i = 0; i < mesh->totpoly; i++) {
+      if ((mpolys[i].flag & ME_SMOOTH) == 0) {
+        flat_normal_indices[i] = mesh->totvert + flat_normals_len++;
+      }
+    }
+
+    write_elements(mesh->totvert, [&](const int64_t i, std::string &buf) {
+      float no[3];
+      normal_short_to_float_v3(no, mverts[i].no);
+      mul_m3_v3(normal_mat, no);
+      normalize_v3(no);
+      append_format(buf, "vn %.4f %.4f %.4f\n", no[0], no[1], no[2]);
+    });
+    write_elements(mesh->totpoly, [&](const int64_t i, std::string &buf) {
+      const MPoly &mpoly = mpolys[i];
+      if (mpoly.flag & ME_SMOOTH) {
+        return;
+      }
+      float no[3];
+      BKE_mesh_calc_poly_normal(&mpoly, &mloops[mpoly.loopstart], mverts, no);
+      mul_m3_v3(normal_mat, no);
+      normalize_v3(no);
+      append_format(buf, "vn %.4f %.4f %.4f\n", no[0], no[1], no[2]);
+    });
+  }
+
+  /* OBJ indices start at one. */
+  const int64_t vertex_offset = vertex_offset_ + 1;
+  const int64_t uv_offset = uv_offset_ + 1;
+  const int64_t normal_offset = normal_offset_ + 1;
+  write_elements(mesh->totpoly, [&](const int64_t i, std::string &buf) {
+    const MPoly &mpoly = mpolys[i];
+    const bool use_vertex_normals = (mpoly.flag & ME_SMOOTH) != 0;
+    buf += 'f';
+    for (int loop = mpoly.loopstart; loop < mpoly.loopstart + mpoly.totloop; loop++) {
+      const int64_t v = vertex_offset + mloops[loop].v;
+      if (!params_.export_normals) {
+        if (mloopuvs) {
+          append_format(buf, " %lld/%lld", (long long)v, (long long)(uv_offset + loop));
+        }
+        else {
+          append_format(buf, " %lld", (long long)v);
+        }
+        continue;
+      }
+      const int64_t vn = normal_offset +
+                         (use_vertex_normals ? mloops[loop].v : flat_normal_indices[i]);
+      if (mloopuvs) {
+        append_format(buf,
+                      " %lld/%lld/%lld",
+                      (long long)v,
+                      (long long)(uv_offset + loop),
+                      (long long)vn);
+      }
+      else {
+        append_format(buf, " %lld//%lld", (long long)v, (long long)vn);
+      }
+    }
+    buf += '\n';
+  });
+
+  vertex_offset_ += mesh->totvert;
+  if (mloopuvs) {
+    uv_offset_ += mesh->totloop;
+  }
+  if (params_.export_normals) {
+    normal_offset_ += mesh->totvert + flat_normals_len;
+  }
+}
+
+}  // namespace blender::io::obj
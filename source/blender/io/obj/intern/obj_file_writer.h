@@ -0,0 +1,59 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#ifndef __OBJ_FILE_WRITER_H__
+#define __OBJ_FILE_WRITER_H__
+
+/** \file
+ * \ingroup obj
+ */
+
+#include "obj.h"
+
+#include <cstdio>
+#include <string>
+
+struct Mesh;
+
+namespace blender::io::obj {
+
+/* Writes meshes to an opened OBJ file. Indices in OBJ are global to the file, so one writer is
+ * used for all meshes and keeps track of the elements written so far. */
+class OBJFileWriter {
+ private:
+  FILE *file_;
+  const OBJExportParams &params_;
+
+  int64_t vertex_offset_ = 0;
+  int64_t uv_offset_ = 0;
+  int64_t normal_offset_ = 0;
+
+ public:
+  OBJFileWriter(FILE *file, const OBJExportParams &params);
+
+  /* Write the mesh as object #name, with #obmat transforming it to world space. */
+  void write_mesh(const std::string &name, const Mesh *mesh, const float obmat[4][4]);
+
+ private:
+  template<typename FormatElemFn>
+  void write_elements(int64_t elems_len, const FormatElemFn &format_elem);
+};
+
+}  // namespace blender::io::obj
+
+#endif /* __OBJ_FILE_WRITER_H__ */
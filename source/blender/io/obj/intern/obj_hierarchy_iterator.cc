@@ -0,0 +1,112 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup obj
+ */
+
+#include "obj_hierarchy_iterator.h"
+#include "obj_file_writer.h"
+
+#include "BKE_object.h"
+
+#include "BLI_utildefines.h"
+
+#include "DNA_layer_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_object_types.h"
+
+namespace blender::io::obj {
+
+/* Transforms are baked into the vertex positions, so there is nothing to write for them. The
+ * writer only exists because the hierarchy iterator needs one to descend into children. */
+class OBJTransformWriter : public AbstractHierarchyWriter {
+ public:
+  void write(HierarchyContext & /*context*/) override
+  {
+  }
+};
+
+class OBJMeshWriter : public AbstractHierarchyWriter {
+ private:
+  OBJFileWriter &file_writer_;
+
+ public:
+  OBJMeshWriter(OBJFileWriter &file_writer) : file_writer_(file_writer)
+  {
+  }
+
+  void write(HierarchyContext &context) override
+  {
+    const Mesh *mesh = BKE_object_get_evaluated_mesh(context.object);
+    if (mesh == nullptr || mesh->totpoly == 0) {
+      return;
+    }
+
+    /* The export path of the data's parent is the path of the object. */
+    const std::string &object_path = context.higher_up_export_path;
+    const std::string name = object_path.substr(object_path.rfind('/') + 1);
+    file_writer_.write_mesh(name, mesh, context.matrix_world);
+  }
+};
+
+OBJHierarchyIterator::OBJHierarchyIterator(Depsgraph *depsgraph,
+                                           OBJFileWriter &file_writer,
+                                           const OBJExportParams &params)
+    : AbstractHierarchyIterator(depsgraph), file_writer_(file_writer), params_(params)
+{
+}
+
+bool OBJHierarchyIterator::mark_as_weak_export(const Object *object) const
+{
+  return params_.selected_objects_only && (object->base_flag & BASE_SELECTED) == 0;
+}
+
+void OBJHierarchyIterator::release_writer(AbstractHierarchyWriter *writer)
+{
+  delete writer;
+}
+
+AbstractHierarchyWriter *OBJHierarchyIterator::create_transform_writer(
+    const HierarchyContext * /*context*/)
+{
+  return new OBJTransformWriter();
+}
+
+AbstractHierarchyWriter *OBJHierarchyIterator::create_data_writer(const HierarchyContext *context)
+{
+  if (context->object->type != OB_MESH) {
+    return nullptr;
+  }
+  return new OBJMeshWriter(file_writer_);
+}
+
+AbstractHierarchyWriter *OBJHierarchyIterator::create_hair_writer(
+    const HierarchyContext * /*context*/)
+{
+  return nullptr;
+}
+
+AbstractHierarchyWriter *OBJHierarchyIterator::create_particle_writer(
+    const HierarchyContext * /*context*/)
+{
+  return nullptr;
+}
+
+}  // namespace blender::io::obj
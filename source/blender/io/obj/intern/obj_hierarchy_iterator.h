@@ -0,0 +1,63 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#ifndef __OBJ_HIERARCHY_ITERATOR_H__
+#define __OBJ_HIERARCHY_ITERATOR_H__
+
+/** \file
+ * \ingroup obj
+ */
+
+#include "IO_abstract_hierarchy_iterator.h"
+#include "obj.h"
+
+struct Depsgraph;
+struct Object;
+
+namespace blender::io::obj {
+
+class OBJFileWriter;
+
+/* OBJ has no hierarchy, all meshes are written in world space. The hierarchy iterator is still
+ * used, so that selection, visibility and instancing are handled like the other exporters. */
+class OBJHierarchyIterator : public AbstractHierarchyIterator {
+ private:
+  OBJFileWriter &file_writer_;
+  const OBJExportParams &params_;
+
+ public:
+  OBJHierarchyIterator(Depsgraph *depsgraph,
+                       OBJFileWriter &file_writer,
+                       const OBJExportParams &params);
+
+ protected:
+  virtual bool mark_as_weak_export(const Object *object) const override;
+
+  virtual AbstractHierarchyWriter *create_transform_writer(
+      const HierarchyContext *context) override;
+  virtual AbstractHierarchyWriter *create_data_writer(const HierarchyContext *context) override;
+  virtual AbstractHierarchyWriter *create_hair_writer(const HierarchyContext *context) override;
+  virtual AbstractHierarchyWriter *create_particle_writer(
+      const HierarchyContext *context) override;
+
+  virtual void release_writer(AbstractHierarchyWriter *writer) override;
+};
+
+}  // namespace blender::io::obj
+
+#endif /* __OBJ_HIERARCHY_ITERATOR_H__ */
@@ -0,0 +1,50 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#ifndef __OBJ_H__
+#define __OBJ_H__
+
+/** \file
+ * \ingroup obj
+ */
+
+#include "DEG_depsgraph.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct bContext;
+
+struct OBJExportParams {
+  bool selected_objects_only;
+  bool export_uvs;
+  bool export_normals;
+  float scale;
+  enum eEvaluationMode evaluation_mode;
+};
+
+/* Write the meshes of the scene, in world space and converted to Y-up, to an OBJ file.
+ * Returns false and reports an error when the file can't be written. */
+bool OBJ_export(struct bContext *C, const char *filepath, const struct OBJExportParams *params);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OBJ_H__ */
@@ -0,0 +1,123 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup stl
+ */
+
+#include "stl.h"
+#include "stl_import.hh"
+
+#include <fcntl.h>
+
+#ifndef WIN32
+#  include <unistd.h> /* For close. */
+#else
+#  include <io.h>
+#endif
+
+#include "BLI_fileops.h"
+#include "BLI_mmap.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+
+#include "BKE_collection.h"
+#include "BKE_context.h"
+#include "BKE_layer.h"
+#include "BKE_object.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+
+#include "DNA_collection_types.h"
+#include "DNA_layer_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "WM_api.h"
+#include "WM_types.h"
+
+namespace blender::io::stl {
+
+static bool read_stl_file(const char *filepath, Vector<float3> &r_corners)
+{
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    WM_reportf(RPT_ERROR, "STL Import: cannot open file %s", filepath);
+    return false;
+  }
+
+  /* The file is parsed from the mapped memory, without copying it first. */
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file);
+  bool ok = false;
+  if (mmap_file == nullptr) {
+    WM_reportf(RPT_ERROR, "STL Import: cannot read file %s", filepath);
+  }
+  else {
+    const StringRef data(static_cast<const char *>(BLI_mmap_get_pointer(mmap_file)),
+                         int64_t(BLI_mmap_get_length(mmap_file)));
+    ok = parse_stl(data, r_corners);
+    if (!ok) {
+      WM_reportf(RPT_ERROR, "STL Import: %s is not a valid STL file", filepath);
+    }
+    BLI_mmap_free(mmap_file);
+  }
+
+  close(file);
+  return ok;
+}
+
+}  // namespace blender::io::stl
+
+bool STL_import(bContext *C, const char *filepath, const STLImportParams *params)
+{
+  using namespace blender::io::stl;
+
+  blender::Vector<blender::float3> corners;
+  if (!read_stl_file(filepath, corners)) {
+    return false;
+  }
+
+  Main *bmain = CTX_data_main(C);
+  Scene *scene = CTX_data_scene(C);
+  ViewLayer *view_layer = CTX_data_view_layer(C);
+
+  char name[FILE_MAX];
+  BLI_split_file_part(filepath, name, sizeof(name));
+  BLI_path_extension_replace(name, sizeof(name), "");
+
+  Mesh *mesh = mesh_from_stl_corners(bmain, name, corners, params->scale);
+  Object *ob = BKE_object_add_only_object(bmain, OB_MESH, name);
+  ob->data = mesh;
+
+  BKE_view_layer_base_deselect_all(view_layer);
+  LayerCollection *lc = BKE_layer_collection_get_active(view_layer);
+  BKE_collection_object_add(bmain, lc->collection, ob);
+  Base *base = BKE_view_layer_base_find(view_layer, ob);
+  BKE_view_layer_base_select_and_set_active(view_layer, base);
+
+  DEG_id_tag_update(&lc->collection->id, ID_RECALC_COPY_ON_WRITE);
+  DEG_id_tag_update_ex(
+      bmain, &ob->id, ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY | ID_RECALC_BASE_FLAGS);
+  DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
+  DEG_relations_tag_update(bmain);
+  WM_main_add_notifier(NC_SCENE | ND_OB_ACTIVE, scene);
+
+  return true;
+}
@@ -0,0 +1,276 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup stl
+ */
+
+#include "stl_import.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "BLI_endian_switch.h"
+#include "BLI_map.hh"
+#include "BLI_task.h"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::io::stl {
+
+/* Binary STL: an 80 byte header, the triangle count, then 50 bytes per triangle holding the
+ * normal, the three corners and an unused attribute. */
+static const int64_t STL_BINARY_HEADER_SIZE = 84;
+static const int64_t STL_BINARY_TRIANGLE_SIZE = 50;
+
+/* Size of the pieces an ASCII file is split into for parsing in parallel. */
+static const int64_t STL_ASCII_CHUNK_SIZE = 1 << 20;
+
+static bool is_binary_stl(StringRef data)
+{
+  if (data.size() < STL_BINARY_HEADER_SIZE) {
+    return false;
+  }
+  uint32_t triangles_len;
+  memcpy(&triangles_len, data.data() + 80, sizeof(triangles_len));
+#ifdef __BIG_ENDIAN__
+  BLI_endian_switch_uint32(&triangles_len);
+#endif
+  /* Some binary files start with "solid" too, so test the size instead of the header. */
+  return data.size() == STL_BINARY_HEADER_SIZE + triangles_len * STL_BINARY_TRIANGLE_SIZE;
+}
+
+struct BinaryParseData {
+  const char *triangles;
+  float3 *corners;
+};
+
+static void parse_binary_triangle_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict /*tls*/)
+{
+  const BinaryParseData *data = static_cast<const BinaryParseData *>(userdata);
+  /* Skip the normal, it is recomputed from the corners. */
+  const char *src = data->triangles + i * STL_BINARY_TRIANGLE_SIZE + sizeof(float[3]);
+  float3 *dst = data->corners + i * 3;
+  memcpy(dst, src, sizeof(float[3][3]));
+#ifdef __BIG_ENDIAN__
+  BLI_endian_switch_float_array(*dst, 9);
+#endif
+}
+
+static bool parse_binary_stl(StringRef data, Vector<float3> &r_corners)
+{
+  const int64_t triangles_len = (data.size() - STL_BINARY_HEADER_SIZE) /
+                                STL_BINARY_TRIANGLE_SIZE;
+  if (triangles_len * 3 > INT_MAX) {
+    return false;
+  }
+  r_corners.resize(triangles_len * 3);
+
+  BinaryParseData parse_data = {data.data() + STL_BINARY_HEADER_SIZE, r_corners.data()};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 4096;
+  BLI_task_parallel_range(0, triangles_len, &parse_data, parse_binary_triangle_cb, &settings);
+  return true;
+}
+
+static bool is_space(const char c)
+{
+  return ELEM(c, ' ', '\t', '\n', '\r', '\f', '\v');
+}
+
+/* Return the next whitespace separated token at or after pos, and move pos past it. */
+static StringRef next_token(StringRef text, int64_t &pos)
+{
+  while (pos < text.size() && is_space(text[pos])) {
+    pos++;
+  }
+  const int64_t start = pos;
+  while (pos < text.size() && !is_space(text[pos])) {
+    pos++;
+  }
+  return text.substr(start, pos - start);
+}
+
+static bool parse_float(StringRef token, float &r_value)
+{
+  /* The mapped file isn't null terminated, so copy the token for strtof. */
+  char buf[64];
+  if (token.size() == 0 || token.size() >= int64_t(sizeof(buf))) {
+    return false;
+  }
+  token.unsafe_copy(buf);
+  char *end;
+  r_value = strtof(buf, &end);
+  return end == buf + token.size();
+}
+
+/* Return the position just past the first "endfacet" at or after pos, or the end of text. */
+static int64_t find_facet_end(StringRef text, const int64_t pos)
+{
+  const StringRef keyword = "endfacet";
+  const char *found = std::search(text.begin() + pos, text.end(), keyword.begin(), keyword.end());
+  return std::min(found - text.begin() + keyword.size(), text.size());
+}
+
+struct ASCIIChunk {
+  StringRef text;
+  Vector<float3> corners;
+  bool is_valid = true;
+};
+
+static void parse_ascii_chunk_cb(void *__restrict userdata,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict /*tls*/)
+{
+  ASCIIChunk &chunk = static_cast<ASCIIChunk *>(userdata)[i];
+  const StringRef text = chunk.text;
+
+  /* Only the vertex lines matter, the other keywords only give the file its structure. */
+  int64_t pos = 0;
+  while (pos < text.size()) {
+    const StringRef token = next_token(text, pos);
+    if (token != "vertex") {
+      continue;
+    }
+    float3 co;
+    if (!parse_float(next_token(text, pos), co.x) || !parse_float(next_token(text, pos), co.y) ||
+        !parse_float(next_token(text, pos), co.z)) {
+      chunk.is_valid = false;
+      return;
+    }
+    chunk.corners.append(co);
+  }
+  chunk.is_valid = chunk.corners.size() % 3 == 0;
+}
+
+static bool parse_ascii_stl(StringRef data, Vector<float3> &r_corners)
+{
+  /* Split the file at facet ends, so that every chunk holds whole triangles. */
+  Vector<ASCIIChunk> chunks;
+  const int64_t chunks_len = std::max<int64_t>(1, data.size() / STL_ASCII_CHUNK_SIZE);
+  int64_t start = 0;
+  for (int64_t i = 1; i <= chunks_len && start < data.size(); i++) {
+    const int64_t end = (i == chunks_len) ?
+                            data.size() :
+                            find_facet_end(data, std::max(start, data.size() * i / chunks_len));
+    ASCIIChunk chunk;
+    chunk.text = data.substr(start, end - start);
+    chunks.append(std::move(chunk));
+    start = end;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, chunks.size(), chunks.data(), parse_ascii_chunk_cb, &settings);
+
+  int64_t corners_len = 0;
+  for (const ASCIIChunk &chunk : chunks) {
+    if (!chunk.is_valid) {
+      return false;
+    }
+    corners_len += chunk.corners.size();
+  }
+  if (corners_len > INT_MAX) {
+    return false;
+  }
+
+  r_corners.reserve(corners_len);
+  for (const ASCIIChunk &chunk : chunks) {
+    r_corners.extend(chunk.corners);
+  }
+  return true;
+}
+
+bool parse_stl(StringRef data, Vector<float3> &r_corners)
+{
+  r_corners.clear();
+  if (is_binary_stl(data)) {
+    return parse_binary_stl(data, r_corners);
+  }
+
+  int64_t pos = 0;
+  if (next_token(data, pos) != "solid") {
+    return false;
+  }
+  return parse_ascii_stl(data, r_corners);
+}
+
+Mesh *mesh_from_stl_corners(Main *bmain, const char *name, Span<float3> corners, float scale)
+{
+  /* STL stores every triangle separately, merge the corners that share a position. */
+  Vector<float3> positions;
+  Vector<int> corner_verts(corners.size());
+  Map<float3, int> vert_indices;
+  vert_indices.reserve(corners.size() / 4);
+
+  for (const int64_t i : corners.index_range()) {
+    /* Adding zero turns -0.0 into 0.0, so that both hash the same. */
+    const float3 co(corners[i].x + 0.0f, corners[i].y + 0.0f, corners[i].z + 0.0f);
+    const int vert_index = vert_indices.lookup_or_add(co, int(positions.size()));
+    if (vert_index == positions.size()) {
+      positions.append(co * scale);
+    }
+    corner_verts[i] = vert_index;
+  }
+
+  Vector<int> tris;
+  tris.reserve(corners.size() / 3);
+  for (int64_t i = 0; i < corners.size(); i += 3) {
+    const int v1 = corner_verts[i], v2 = corner_verts[i + 1], v3 = corner_verts[i + 2];
+    if (v1 != v2 && v2 != v3 && v3 != v1) {
+      tris.append(int(i));
+    }
+  }
+
+  Mesh *mesh = BKE_mesh_add(bmain, name);
+  mesh->totvert = int(positions.size());
+  mesh->totpoly = int(tris.size());
+  mesh->totloop = int(tris.size()) * 3;
+
+  CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, nullptr, mesh->totvert);
+  CustomData_add_layer(&mesh->pdata, CD_MPOLY, CD_CALLOC, nullptr, mesh->totpoly);
+  CustomData_add_layer(&mesh->ldata, CD_MLOOP, CD_CALLOC, nullptr, mesh->totloop);
+  BKE_mesh_update_customdata_pointers(mesh, false);
+
+  for (int i = 0; i < mesh->totvert; i++) {
+    copy_v3_v3(mesh->mvert[i].co, positions[i]);
+  }
+  for (int i = 0; i < mesh->totpoly; i++) {
+    mesh->mpoly[i].loopstart = i * 3;
+    mesh->mpoly[i].totloop = 3;
+    for (int j = 0; j < 3; j++) {
+      mesh->mloop[i * 3 + j].v = corner_verts[tris[i] + j];
+    }
+  }
+
+  BKE_mesh_calc_edges(mesh, false, false);
+  BKE_mesh_calc_normals(mesh);
+  return mesh;
+}
+
+}  // namespace blender::io::stl
@@ -0,0 +1,47 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+/** \file
+ * \ingroup stl
+ */
+
+#ifndef __IO_STL_IMPORT_HH__
+#define __IO_STL_IMPORT_HH__
+
+#include "BLI_float3.hh"
+#include "BLI_span.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_vector.hh"
+
+struct Main;
+struct Mesh;
+
+namespace blender::io::stl {
+
+/* Parse the contents of a binary or ASCII STL file into the corner positions of its triangles,
+ * three per triangle. Returns false when the data is not valid STL. Large files are parsed in
+ * parallel chunks. */
+bool parse_stl(StringRef data, Vector<float3> &r_corners);
+
+/* Create a mesh in bmain from triangle corner positions. Corners at the same position become
+ * one vertex, triangles that become degenerate are skipped. */
+Mesh *mesh_from_stl_corners(Main *bmain, const char *name, Span<float3> corners, float scale);
+
+}  // namespace blender::io::stl
+
+#endif /* __IO_STL_IMPORT_HH__ */
@@ -0,0 +1,93 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#include "stl_import.hh"
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <string>
+
+namespace blender::io::stl::tests {
+
+static const char *ascii_facet =
+    "  facet normal 0 0 1\n"
+    "    outer loop\n"
+    "      vertex 0 0 0\n"
+    "      vertex 1.5 0 0\n"
+    "      vertex 0 -2e1 0.25\n"
+    "    endloop\n"
+    "  endfacet\n";
+
+TEST(stl_import, parse_ascii)
+{
+  const std::string text = std::string("solid test\n") + ascii_facet + "endsolid test\n";
+
+  Vector<float3> corners;
+  EXPECT_TRUE(parse_stl(text, corners));
+  ASSERT_EQ(corners.size(), 3);
+  EXPECT_EQ(corners[1], float3(1.5f, 0.0f, 0.0f));
+  EXPECT_EQ(corners[2], float3(0.0f, -20.0f, 0.25f));
+}
+
+TEST(stl_import, parse_ascii_chunked)
+{
+  /* Large enough to be split into several chunks. */
+  const int facets_len = 40000;
+  std::string text = "solid test\n";
+  for (int i = 0; i < facets_len; i++) {
+    text += ascii_facet;
+  }
+  text += "endsolid test\n";
+
+  Vector<float3> corners;
+  EXPECT_TRUE(parse_stl(text, corners));
+  ASSERT_EQ(corners.size(), facets_len * 3);
+  for (int i = 0; i < facets_len; i++) {
+    EXPECT_EQ(corners[i * 3 + 1], float3(1.5f, 0.0f, 0.0f));
+  }
+}
+
+TEST(stl_import, parse_ascii_invalid)
+{
+  Vector<float3> corners;
+  EXPECT_FALSE(parse_stl("not an stl file", corners));
+  EXPECT_FALSE(parse_stl("solid test\n facet\n vertex 1 2\n endfacet\n", corners));
+  EXPECT_FALSE(parse_stl("solid test\n facet\n vertex 1 2 x\n endfacet\n", corners));
+}
+
+TEST(stl_import, parse_binary)
+{
+  /* Starts with "solid" like some binary files do, the size tells them apart. */
+  std::string data(84 + 2 * 50, '\0');
+  memcpy(&data[0], "solid", 5);
+  const uint32_t triangles_len = 2;
+  memcpy(&data[80], &triangles_len, sizeof(triangles_len));
+  for (int i = 0; i < 2; i++) {
+    const float tri[4][3] = {{0, 0, 1}, {0, 0, 0}, {1, 0, 0}, {0, float(i + 1), 0}};
+    memcpy(&data[84 + i * 50], tri, sizeof(tri));
+  }
+
+  Vector<float3> corners;
+  EXPECT_TRUE(parse_stl(data, corners));
+  ASSERT_EQ(corners.size(), 6);
+  EXPECT_EQ(corners[1], float3(1.0f, 0.0f, 0.0f));
+  EXPECT_EQ(corners[5], float3(0.0f, 2.0f, 0.0f));
+}
+
+}  // namespace blender::io::stl::tests
@@ -0,0 +1,44 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#ifndef __STL_H__
+#define __STL_H__
+
+/** \file
+ * \ingroup stl
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct bContext;
+
+struct STLImportParams {
+  float scale;
+};
+
+/* Import the binary or ASCII STL file at filepath as a new mesh object in the active collection.
+ * Returns false and reports an error when the file can't be read or parsed. */
+bool STL_import(struct bContext *C, const char *filepath, const struct STLImportParams *params);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STL_H__ */
@@ -19,9 +19,11 @@
 
 #include "usd.h"
 #include "usd_hierarchy_iterator.h"
+#include "usd_reader_prim.h"
 
 #include <pxr/pxr.h>
 #include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/metrics.h>
 #include <pxr/usd/usdGeom/tokens.h>
 
 #include "MEM_guardedalloc.h"
@@ -30,16 +32,24 @@
 #include "DEG_depsgraph_build.h"
 #include "DEG_depsgraph_query.h"
 
+#include "DNA_collection_types.h"
+#include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
 #include "BKE_blender_version.h"
+#include "BKE_collection.h"
 #include "BKE_context.h"
 #include "BKE_global.h"
+#include "BKE_layer.h"
+#include "BKE_lib_id.h"
 #include "BKE_scene.h"
 
 #include "BLI_fileops.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
+
+#include "ED_undo.h"
 
 #include "WM_api.h"
 #include "WM_types.h"
@@ -164,6 +174,178 @@ static void export_endjob(void *customdata)
   WM_set_locked_interface(data->wm, false);
 }
 
+struct ImportJobData {
+  bContext *C;
+  Main *bmain;
+  Scene *scene;
+  ViewLayer *view_layer;
+  wmWindowManager *wm;
+
+  char filename[FILE_MAX];
+  USDImportParams params;
+
+  std::vector<USDPrimReader *> readers;
+  pxr::UsdTimeCode time;
+
+  bool was_cancelled;
+  bool import_ok;
+  bool is_background_job;
+};
+
+static void import_read_usd_data_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict /*tls*/)
+{
+  ImportJobData *data = static_cast<ImportJobData *>(userdata);
+  data->readers[i]->read_usd_data(data->time);
+}
+
+static void import_read_object_data_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict /*tls*/)
+{
+  ImportJobData *data = static_cast<ImportJobData *>(userdata);
+  data->readers[i]->read_object_data();
+}
+
+static bool import_is_cancelled(ImportJobData *data, short *stop)
+{
+  if (G.is_break || (stop != nullptr && *stop)) {
+    data->was_cancelled = true;
+  }
+  return data->was_cancelled;
+}
+
+static void import_startjob(void *customdata, short *stop, short *do_update, float *progress)
+{
+  ImportJobData *data = static_cast<ImportJobData *>(customdata);
+  data->import_ok = false;
+
+  WM_set_locked_interface(data->wm, true);
+
+  /* Payloads that aren't loaded are never read from disk, which keeps opening large stages
+   * cheap when only their upper hierarchy is needed. */
+  const pxr::UsdStage::InitialLoadSet load_set = data->params.load_payloads ?
+                                                      pxr::UsdStage::LoadAll :
+                                                      pxr::UsdStage::LoadNone;
+  pxr::UsdStageRefPtr stage = pxr::UsdStage::Open(data->filename, load_set);
+  if (!stage) {
+    WM_reportf(RPT_ERROR, "USD Import: unable to open stage %s", data->filename);
+    return;
+  }
+
+  data->time = stage->HasAuthoredTimeCodeRange() ? pxr::UsdTimeCode(stage->GetStartTimeCode()) :
+                                                   pxr::UsdTimeCode::Default();
+  const bool is_y_up = pxr::UsdGeomGetStageUpAxis(stage) == pxr::UsdGeomTokens->y;
+
+  create_prim_readers(stage, data->params, data->readers);
+  const int readers_len = static_cast<int>(data->readers.size());
+
+  *progress = 0.1f;
+  *do_update = true;
+  if (import_is_cancelled(data, stop)) {
+    return;
+  }
+
+  /* Reading from the stage is thread-safe, and is where most of the time goes. */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, readers_len, data, import_read_usd_data_cb, &settings);
+
+  *progress = 0.5f;
+  *do_update = true;
+  if (import_is_cancelled(data, stop)) {
+    return;
+  }
+
+  /* Adding data-blocks to Main isn't thread-safe. */
+  for (USDPrimReader *reader : data->readers) {
+    reader->create_object(data->bmain);
+  }
+
+  BLI_task_parallel_range(0, readers_len, data, import_read_object_data_cb, &settings);
+
+  *progress = 0.9f;
+  *do_update = true;
+  if (import_is_cancelled(data, stop)) {
+    return;
+  }
+
+  for (USDPrimReader *reader : data->readers) {
+    Object *ob = reader->object();
+    ob->parent = reader->parent_reader ? reader->parent_reader->object() : nullptr;
+  }
+  for (USDPrimReader *reader : data->readers) {
+    reader->read_transform(data->time, data->params.scale, is_y_up);
+  }
+
+  data->import_ok = true;
+  *progress = 1.0f;
+  *do_update = true;
+}
+
+static void import_endjob(void *customdata)
+{
+  ImportJobData *data = static_cast<ImportJobData *>(customdata);
+
+  if (!data->import_ok) {
+    /* Delete objects on cancellation or failure. */
+    for (USDPrimReader *reader : data->readers) {
+      Object *ob = reader->object();
+      if (ob == nullptr) {
+        continue;
+      }
+      ID *ob_data = static_cast<ID *>(ob->data);
+      BKE_id_free_us(data->bmain, ob);
+      if (ob_data) {
+        BKE_id_free_us(data->bmain, ob_data);
+      }
+    }
+  }
+  else {
+    ViewLayer *view_layer = data->view_layer;
+    BKE_view_layer_base_deselect_all(view_layer);
+    LayerCollection *lc = BKE_layer_collection_get_active(view_layer);
+
+    for (USDPrimReader *reader : data->readers) {
+      Object *ob = reader->object();
+      BKE_collection_object_add(data->bmain, lc->collection, ob);
+
+      Base *base = BKE_view_layer_base_find(view_layer, ob);
+      BKE_view_layer_base_select_and_set_active(view_layer, base);
+
+      DEG_id_tag_update_ex(data->bmain,
+                           &ob->id,
+                           ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY | ID_RECALC_BASE_FLAGS);
+    }
+
+    DEG_id_tag_update(&lc->collection->id, ID_RECALC_COPY_ON_WRITE);
+    DEG_id_tag_update(&data->scene->id, ID_RECALC_BASE_FLAGS);
+    DEG_relations_tag_update(data->bmain);
+
+    if (data->is_background_job) {
+      /* Blender already returned from the import operator, so we need to store our own extra undo
+       * step. */
+      ED_undo_push(data->C, "USD Import Finished");
+    }
+  }
+
+  for (USDPrimReader *reader : data->readers) {
+    delete reader;
+  }
+  data->readers.clear();
+
+  WM_set_locked_interface(data->wm, false);
+  WM_main_add_notifier(NC_SCENE | ND_FRAME, data->scene);
+}
+
+static void import_freejob(void *customdata)
+{
+  ImportJobData *data = static_cast<ImportJobData *>(customdata);
+  delete data;
+}
+
 }  // namespace usd
 }  // namespace io
 }  // namespace blender
@@ -218,6 +400,57 @@ bool USD_export(bContext *C,
   return export_ok;
 }
 
+bool USD_import(bContext *C,
+                const char *filepath,
+                const USDImportParams *params,
+                bool as_background_job)
+{
+  /* Using new here since the job data holds C++ containers. */
+  blender::io::usd::ImportJobData *job = new blender::io::usd::ImportJobData();
+  job->C = C;
+  job->bmain = CTX_data_main(C);
+  job->scene = CTX_data_scene(C);
+  job->view_layer = CTX_data_view_layer(C);
+  job->wm = CTX_wm_manager(C);
+  job->params = *params;
+  job->was_cancelled = false;
+  job->import_ok = false;
+  job->is_background_job = as_background_job;
+  BLI_strncpy(job->filename, filepath, sizeof(job->filename));
+
+  G.is_break = false;
+
+  bool import_ok = false;
+  if (as_background_job) {
+    wmJob *wm_job = WM_jobs_get(
+        job->wm, CTX_wm_window(C), job->scene, "USD Import", WM_JOB_PROGRESS, WM_JOB_TYPE_ALEMBIC);
+
+    /* setup job */
+    WM_jobs_customdata_set(wm_job, job, blender::io::usd::import_freejob);
+    WM_jobs_timer(wm_job, 0.1, NC_SCENE | ND_FRAME, NC_SCENE | ND_FRAME);
+    WM_jobs_callbacks(wm_job,
+                      blender::io::usd::import_startjob,
+                      nullptr,
+                      nullptr,
+                      blender::io::usd::import_endjob);
+
+    WM_jobs_start(CTX_wm_manager(C), wm_job);
+  }
+  else {
+    /* Fake a job context, so that we don't need NULL pointer checks while importing. */
+    short stop = 0, do_update = 0;
+    float progress = 0.f;
+
+    blender::io::usd::import_startjob(job, &stop, &do_update, &progress);
+    blender::io::usd::import_endjob(job);
+    import_ok = job->import_ok;
+
+    blender::io::usd::import_freejob(job);
+  }
+
+  return import_ok;
+}
+
 int USD_get_version(void)
 {
   /* USD 19.11 defines:
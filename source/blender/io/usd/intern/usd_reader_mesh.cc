@@ -0,0 +1,208 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#include "usd_reader_mesh.h"
+
+#include <pxr/usd/sdf/types.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/primvarsAPI.h>
+
+#include "BLI_math_vector.h"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+#include "BKE_object.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+namespace blender {
+namespace io {
+namespace usd {
+
+USDMeshReader::USDMeshReader(const pxr::UsdPrim &prim, const USDImportParams &params)
+    : USDPrimReader(prim), params_(params), is_left_handed_(false)
+{
+}
+
+void USDMeshReader::read_usd_data(pxr::UsdTimeCode time)
+{
+  pxr::UsdGeomMesh usd_mesh(prim_);
+
+  usd_mesh.GetPointsAttr().Get(&points_, time);
+  usd_mesh.GetFaceVertexCountsAttr().Get(&face_counts_, time);
+  usd_mesh.GetFaceVertexIndicesAttr().Get(&face_indices_, time);
+
+  pxr::TfToken orientation;
+  usd_mesh.GetOrientationAttr().Get(&orientation);
+  is_left_handed_ = (orientation == pxr::UsdGeomTokens->leftHanded);
+
+  if (!is_valid()) {
+    printf("USD Import warning: invalid topology of mesh %s, importing it without geometry\n",
+           prim_.GetPath().GetText());
+    points_.clear();
+    face_counts_.clear();
+    face_indices_.clear();
+    return;
+  }
+
+  if (params_.import_uvmaps) {
+    read_uv_maps(time);
+  }
+}
+
+bool USDMeshReader::is_valid() const
+{
+  size_t loop_count = 0;
+  for (const int face_count : face_counts_) {
+    if (face_count < 3) {
+      return false;
+    }
+    loop_count += face_count;
+  }
+  if (loop_count != face_indices_.size()) {
+    return false;
+  }
+
+  const int points_count = static_cast<int>(points_.size());
+  for (const int index : face_indices_) {
+    if (index < 0 || index >= points_count) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void USDMeshReader::read_uv_maps(pxr::UsdTimeCode time)
+{
+  pxr::UsdGeomPrimvarsAPI primvars_api(prim_);
+
+  for (const pxr::UsdGeomPrimvar &primvar : primvars_api.GetPrimvars()) {
+    const pxr::SdfValueTypeName type = primvar.GetTypeName();
+    if (type != pxr::SdfValueTypeNames->TexCoord2fArray &&
+        type != pxr::SdfValueTypeNames->Float2Array) {
+      continue;
+    }
+
+    const pxr::TfToken interpolation = primvar.GetInterpolation();
+    const bool is_face_varying = (interpolation == pxr::UsdGeomTokens->faceVarying);
+    const bool is_vertex = (interpolation == pxr::UsdGeomTokens->vertex);
+    if (!is_face_varying && !is_vertex) {
+      continue;
+    }
+
+    /* Resolves indexed primvars. */
+    pxr::VtValue value;
+    if (!primvar.ComputeFlattened(&value, time) ||
+        !value.IsHolding<pxr::VtArray<pxr::GfVec2f>>()) {
+      continue;
+    }
+    const pxr::VtArray<pxr::GfVec2f> &values = value.UncheckedGet<pxr::VtArray<pxr::GfVec2f>>();
+
+    UVMap uv_map;
+    uv_map.name = primvar.GetPrimvarName().GetString();
+
+    if (is_face_varying) {
+      if (values.size() != face_indices_.size()) {
+        continue;
+      }
+      uv_map.uvs = values;
+    }
+    else {
+      if (values.size() != points_.size()) {
+        continue;
+      }
+      uv_map.uvs.resize(face_indices_.size());
+      for (size_t i = 0; i < face_indices_.size(); i++) {
+        uv_map.uvs[i] = values[face_indices_[i]];
+      }
+    }
+
+    uv_maps_.push_back(uv_map);
+  }
+}
+
+void USDMeshReader::create_object(Main *bmain)
+{
+  Mesh *mesh = BKE_mesh_add(bmain, name_.c_str());
+
+  object_ = BKE_object_add_only_object(bmain, OB_MESH, name_.c_str());
+  object_->data = mesh;
+}
+
+void USDMeshReader::read_object_data()
+{
+  Mesh *mesh = static_cast<Mesh *>(object_->data);
+
+  mesh->totvert = static_cast<int>(points_.size());
+  mesh->totpoly = static_cast<int>(face_counts_.size());
+  mesh->totloop = static_cast<int>(face_indices_.size());
+
+  CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, nullptr, mesh->totvert);
+  CustomData_add_layer(&mesh->pdata, CD_MPOLY, CD_CALLOC, nullptr, mesh->totpoly);
+  CustomData_add_layer(&mesh->ldata, CD_MLOOP, CD_CALLOC, nullptr, mesh->totloop);
+
+  std::vector<MLoopUV *> mloopuvs;
+  for (const UVMap &uv_map : uv_maps_) {
+    mloopuvs.push_back(static_cast<MLoopUV *>(CustomData_add_layer_named(
+        &mesh->ldata, CD_MLOOPUV, CD_CALLOC, nullptr, mesh->totloop, uv_map.name.c_str())));
+  }
+
+  BKE_mesh_update_customdata_pointers(mesh, false);
+
+  const pxr::GfVec3f *points = points_.cdata();
+  for (int i = 0; i < mesh->totvert; i++) {
+    copy_v3_v3(mesh->mvert[i].co, points[i].data());
+  }
+
+  const int *face_counts = face_counts_.cdata();
+  const int *face_indices = face_indices_.cdata();
+  int loop_index = 0;
+  for (int i = 0; i < mesh->totpoly; i++) {
+    const int face_count = face_counts[i];
+    MPoly &mpoly = mesh->mpoly[i];
+    mpoly.loopstart = loop_index;
+    mpoly.totloop = face_count;
+
+    for (int j = 0; j < face_count; j++) {
+      /* Blender uses the right handed winding order. */
+      const int usd_index = is_left_handed_ ? loop_index + face_count - 1 - j : loop_index + j;
+      mesh->mloop[loop_index + j].v = face_indices[usd_index];
+
+      for (size_t uv_index = 0; uv_index < uv_maps_.size(); uv_index++) {
+        const pxr::GfVec2f &uv = uv_maps_[uv_index].uvs.cdata()[usd_index];
+        copy_v2_v2(mloopuvs[uv_index][loop_index + j].uv, uv.data());
+      }
+    }
+    loop_index += face_count;
+  }
+
+  BKE_mesh_calc_edges(mesh, false, false);
+  BKE_mesh_calc_normals(mesh);
+
+  /* The USD data isn't needed anymore. */
+  points_.clear();
+  face_counts_.clear();
+  face_indices_.clear();
+  uv_maps_.clear();
+}
+
+}  // namespace usd
+}  // namespace io
+}  // namespace blender
@@ -0,0 +1,66 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#ifndef __USD_READER_MESH_H__
+#define __USD_READER_MESH_H__
+
+#include "usd_reader_prim.h"
+
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/vt/array.h>
+
+struct Mesh;
+
+namespace blender {
+namespace io {
+namespace usd {
+
+class USDMeshReader : public USDPrimReader {
+ private:
+  struct UVMap {
+    std::string name;
+    /* One coordinate per face corner. */
+    pxr::VtArray<pxr::GfVec2f> uvs;
+  };
+
+  USDImportParams params_;
+
+  pxr::VtArray<pxr::GfVec3f> points_;
+  pxr::VtIntArray face_counts_;
+  pxr::VtIntArray face_indices_;
+  bool is_left_handed_;
+  std::vector<UVMap> uv_maps_;
+
+ public:
+  USDMeshReader(const pxr::UsdPrim &prim, const USDImportParams &params);
+
+  void read_usd_data(pxr::UsdTimeCode time) override;
+  void create_object(Main *bmain) override;
+  void read_object_data() override;
+
+ private:
+  bool is_valid() const;
+  void read_uv_maps(pxr::UsdTimeCode time);
+};
+
+}  // namespace usd
+}  // namespace io
+}  // namespace blender
+
+#endif /* __USD_READER_MESH_H__ */
@@ -0,0 +1,147 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#include "usd_reader_prim.h"
+#include "usd_reader_mesh.h"
+
+#include <pxr/usd/usdGeom/imageable.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/scope.h>
+#include <pxr/usd/usdGeom/xform.h>
+#include <pxr/usd/usdGeom/xformable.h>
+
+#include "BLI_math_matrix.h"
+
+#include "BKE_object.h"
+
+#include "DNA_object_types.h"
+
+namespace blender {
+namespace io {
+namespace usd {
+
+USDPrimReader::USDPrimReader(const pxr::UsdPrim &prim)
+    : prim_(prim), name_(prim.GetName().GetString()), object_(nullptr), parent_reader(nullptr)
+{
+}
+
+void USDPrimReader::read_usd_data(pxr::UsdTimeCode /*time*/)
+{
+}
+
+void USDPrimReader::create_object(Main *bmain)
+{
+  object_ = BKE_object_add_only_object(bmain, OB_EMPTY, name_.c_str());
+  object_->empty_drawsize = 0.1f;
+}
+
+void USDPrimReader::read_object_data()
+{
+}
+
+void USDPrimReader::read_transform(pxr::UsdTimeCode time, float scale, bool is_y_up)
+{
+  float mat[4][4];
+  unit_m4(mat);
+
+  bool resets_xform_stack = false;
+  pxr::UsdGeomXformable xformable(prim_);
+  if (xformable) {
+    pxr::GfMatrix4d usd_mat;
+    xformable.GetLocalTransformation(&usd_mat, &resets_xform_stack, time);
+
+    /* USD matrices transform row vectors, so their memory layout matches Blender's. */
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) {
+        mat[i][j] = static_cast<float>(usd_mat[i][j]);
+      }
+    }
+  }
+
+  if (resets_xform_stack) {
+    /* The transform is in world space. */
+    object_->parent = nullptr;
+  }
+
+  if (object_->parent == nullptr) {
+    if (is_y_up) {
+      float rot[4][4];
+      axis_angle_to_mat4_single(rot, 'X', M_PI_2);
+      mul_m4_m4m4(mat, rot, mat);
+    }
+
+    float scale_mat[4][4];
+    scale_m4_fl(scale_mat, scale);
+    mul_m4_m4m4(mat, scale_mat, mat);
+  }
+
+  BKE_object_apply_mat4(object_, mat, true, false);
+}
+
+Object *USDPrimReader::object() const
+{
+  return object_;
+}
+
+const pxr::UsdPrim &USDPrimReader::prim() const
+{
+  return prim_;
+}
+
+static void create_prim_readers_recursive(const pxr::UsdPrim &prim,
+                                          const USDImportParams &params,
+                                          USDPrimReader *parent_reader,
+                                          std::vector<USDPrimReader *> &r_readers)
+{
+  USDPrimReader *reader = nullptr;
+
+  if (prim.IsA<pxr::UsdGeomMesh>()) {
+    reader = new USDMeshReader(prim, params);
+  }
+  else if (prim.IsA<pxr::UsdGeomXform>() || prim.IsA<pxr::UsdGeomScope>() ||
+           !prim.HasAuthoredTypeName() || (prim.HasAuthoredPayloads() && !prim.IsLoaded())) {
+    reader = new USDPrimReader(prim);
+  }
+  else if (!prim.IsA<pxr::UsdGeomImageable>()) {
+    /* Materials, shaders and geometry subsets are not objects. */
+    return;
+  }
+
+  if (reader) {
+    reader->parent_reader = parent_reader;
+    r_readers.push_back(reader);
+    parent_reader = reader;
+  }
+
+  for (const pxr::UsdPrim &child : prim.GetChildren()) {
+    create_prim_readers_recursive(child, params, parent_reader, r_readers);
+  }
+}
+
+void create_prim_readers(const pxr::UsdStageRefPtr &stage,
+                         const USDImportParams &params,
+                         std::vector<USDPrimReader *> &r_readers)
+{
+  for (const pxr::UsdPrim &prim : stage->GetPseudoRoot().GetChildren()) {
+    create_prim_readers_recursive(prim, params, nullptr, r_readers);
+  }
+}
+
+}  // namespace usd
+}  // namespace io
+}  // namespace blender
@@ -0,0 +1,80 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#ifndef __USD_READER_PRIM_H__
+#define __USD_READER_PRIM_H__
+
+#include "usd.h"
+
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/stage.h>
+
+#include <string>
+#include <vector>
+
+struct Main;
+struct Object;
+
+namespace blender {
+namespace io {
+namespace usd {
+
+/* Creates a Blender object from a USD prim.
+ *
+ * Importing happens in steps, so that the parts that don't touch the Main database can run in
+ * parallel for all prims: the USD data is read first, then the objects are created, then their
+ * data is filled in. */
+class USDPrimReader {
+ protected:
+  pxr::UsdPrim prim_;
+  std::string name_;
+  Object *object_;
+
+ public:
+  /* Reader of the closest ancestor prim that has an object, nullptr for root objects. */
+  USDPrimReader *parent_reader;
+
+  USDPrimReader(const pxr::UsdPrim &prim);
+  virtual ~USDPrimReader() = default;
+
+  /* Read the data of the prim from the stage. Called in parallel for different prims. */
+  virtual void read_usd_data(pxr::UsdTimeCode time);
+  /* Create the object and its data-block in #bmain. */
+  virtual void create_object(Main *bmain);
+  /* Fill in the data-block of the object. Called in parallel for different prims. */
+  virtual void read_object_data();
+
+  /* Set the transform of the object, relative to its parent. */
+  void read_transform(pxr::UsdTimeCode time, float scale, bool is_y_up);
+
+  Object *object() const;
+  const pxr::UsdPrim &prim() const;
+};
+
+/* Create readers for all prims of the stage that become objects, in hierarchy order.
+ * Prims below payloads that aren't loaded don't exist on the stage, the payload prim itself is
+ * imported as an empty to keep its place in the hierarchy. */
+void create_prim_readers(const pxr::UsdStageRefPtr &stage,
+                         const USDImportParams &params,
+                         std::vector<USDPrimReader *> &r_readers);
+
+}  // namespace usd
+}  // namespace io
+}  // namespace blender
+
+#endif /* __USD_READER_PRIM_H__ */
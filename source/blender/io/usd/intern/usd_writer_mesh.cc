@@ -25,6 +25,7 @@
 
 #include "BLI_assert.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_lib_id.h"
@@ -170,7 +171,6 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
 
   pxr::UsdGeomMesh usd_mesh = pxr::UsdGeomMesh::Define(stage, usd_path);
   USDMeshData usd_mesh_data;
-  get_geometry_data(mesh, usd_mesh_data);
 
   if (usd_export_context_.export_params.use_instancing && context.is_instance()) {
     // This object data is instanced, just reference the original instead of writing a copy.
@@ -194,11 +194,15 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
     of its own subtree. It does work when we override the material with exactly the same path,
     though.*/
     if (usd_export_context_.export_params.export_materials) {
+      /* The geometry itself comes from the reference, only the face groups are needed. */
+      get_face_groups(mesh, usd_mesh_data);
       assign_materials(context, usd_mesh, usd_mesh_data.face_groups);
     }
     return;
   }
 
+  get_geometry_data(mesh, usd_mesh_data);
+
   pxr::UsdAttribute attr_points = usd_mesh.CreatePointsAttr(pxr::VtValue(), true);
   pxr::UsdAttribute attr_face_vertex_counts = usd_mesh.CreateFaceVertexCountsAttr(pxr::VtValue(),
                                                                                   true);
@@ -259,37 +263,99 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   }
 }
 
+/* Meshes below this size are converted on a single thread. */
+#define USD_MESH_THREAD_MIN 10000
+
+static void get_parallel_settings(TaskParallelSettings *settings, const int len)
+{
+  BLI_parallel_range_settings_defaults(settings);
+  settings->use_threading = len > USD_MESH_THREAD_MIN;
+  settings->min_iter_per_thread = 1024;
+}
+
+struct VerticesData {
+  const MVert *verts;
+  pxr::GfVec3f *points;
+};
+
+static void get_vertices_cb(void *__restrict userdata,
+                            const int i,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  const VerticesData *data = static_cast<const VerticesData *>(userdata);
+  data->points[i] = pxr::GfVec3f(data->verts[i].co);
+}
+
 static void get_vertices(const Mesh *mesh, USDMeshData &usd_mesh_data)
 {
-  usd_mesh_data.points.reserve(mesh->totvert);
+  usd_mesh_data.points.resize(mesh->totvert);
 
-  const MVert *verts = mesh->mvert;
-  for (int i = 0; i < mesh->totvert; ++i) {
-    usd_mesh_data.points.push_back(pxr::GfVec3f(verts[i].co));
+  VerticesData data;
+  data.verts = mesh->mvert;
+  data.points = usd_mesh_data.points.data();
+
+  TaskParallelSettings settings;
+  get_parallel_settings(&settings, mesh->totvert);
+  BLI_task_parallel_range(0, mesh->totvert, &data, get_vertices_cb, &settings);
+}
+
+struct LoopsPolysData {
+  const MPoly *mpoly;
+  const MLoop *mloop;
+  const int *poly_offsets;
+  int *face_indices;
+};
+
+static void get_loops_polys_cb(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  const LoopsPolysData *data = static_cast<const LoopsPolysData *>(userdata);
+  const MPoly *mpoly = &data->mpoly[i];
+  const MLoop *loop = data->mloop + mpoly->loopstart;
+  int *face_indices = data->face_indices + data->poly_offsets[i];
+
+  for (int j = 0; j < mpoly->totloop; ++j, ++loop) {
+    face_indices[j] = loop->v;
   }
 }
 
 static void get_loops_polys(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  usd_mesh_data.face_vertex_counts.resize(mesh->totpoly);
+
+  /* The loops of the mesh don't need to be in polygon order. */
+  std::vector<int> poly_offsets(mesh->totpoly);
+  int offset = 0;
+  for (int i = 0; i < mesh->totpoly; ++i) {
+    usd_mesh_data.face_vertex_counts[i] = mesh->mpoly[i].totloop;
+    poly_offsets[i] = offset;
+    offset += mesh->mpoly[i].totloop;
+  }
+  usd_mesh_data.face_indices.resize(offset);
+
+  LoopsPolysData data;
+  data.mpoly = mesh->mpoly;
+  data.mloop = mesh->mloop;
+  data.poly_offsets = poly_offsets.data();
+  data.face_indices = usd_mesh_data.face_indices.data();
+
+  TaskParallelSettings settings;
+  get_parallel_settings(&settings, offset);
+  BLI_task_parallel_range(0, mesh->totpoly, &data, get_loops_polys_cb, &settings);
+}
+
+static void get_face_groups(const Mesh *mesh, USDMeshData &usd_mesh_data)
 {
   /* Only construct face groups (a.k.a. geometry subsets) when we need them for material
    * assignments. */
-  bool construct_face_groups = mesh->totcol > 1;
-
-  usd_mesh_data.face_vertex_counts.reserve(mesh->totpoly);
-  usd_mesh_data.face_indices.reserve(mesh->totloop);
+  if (mesh->totcol <= 1) {
+    return;
+  }
 
-  MLoop *mloop = mesh->mloop;
-  MPoly *mpoly = mesh->mpoly;
+  const MPoly *mpoly = mesh->mpoly;
   for (int i = 0; i < mesh->totpoly; ++i, ++mpoly) {
-    MLoop *loop = mloop + mpoly->loopstart;
-    usd_mesh_data.face_vertex_counts.push_back(mpoly->totloop);
-    for (int j = 0; j < mpoly->totloop; ++j, ++loop) {
-      usd_mesh_data.face_indices.push_back(loop->v);
-    }
-
-    if (construct_face_groups) {
-      usd_mesh_data.face_groups[mpoly->mat_nr].push_back(i);
-    }
+    usd_mesh_data.face_groups[mpoly->mat_nr].push_back(i);
   }
 }
 
@@ -322,6 +388,7 @@ void USDGenericMeshWriter::get_geometry_data(const Mesh *mesh, USDMeshData &usd_
 {
   get_vertices(mesh, usd_mesh_data);
   get_loops_polys(mesh, usd_mesh_data);
+  get_face_groups(mesh, usd_mesh_data);
   get_creases(mesh, usd_mesh_data);
 }
 
@@ -54,6 +54,19 @@ bool USD_export(struct bContext *C,
                 const struct USDExportParams *params,
                 bool as_background_job);
 
+struct USDImportParams {
+  float scale;
+  bool import_uvmaps;
+  /* When false, payloads are not loaded, only the prims that hold them are imported. */
+  bool load_payloads;
+};
+
+/* Same return values as USD_export. */
+bool USD_import(struct bContext *C,
+                const char *filepath,
+                const struct USDImportParams *params,
+                bool as_background_job);
+
 int USD_get_version(void);
 
 #ifdef __cplusplus
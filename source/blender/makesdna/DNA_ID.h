@@ -229,6 +229,9 @@ typedef struct IDOverrideLibraryRuntime {
 enum {
   /** This override needs to be reloaded. */
   IDOVERRIDE_LIBRARY_RUNTIME_TAG_NEEDS_RELOAD = 1 << 0,
+  /** Override rules were generated from the current local data, and neither that data nor the
+   * rules have been modified since. Diffing can be skipped for such overrides. */
+  IDOVERRIDE_LIBRARY_RUNTIME_TAG_DIFF_UP_TO_DATE = 1 << 1,
 };
 
 /* Main container for all overriding data info of a data-block. */
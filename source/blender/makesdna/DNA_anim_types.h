@@ -591,7 +591,11 @@ typedef struct FCurve {
   /* value cache + settings */
   /** Value stored from last time curve was evaluated (not threadsafe, debug display only!). */
   float curval;
-  char _pad2[4];
+  /**
+   * Keyframe segment found by the last evaluation, to skip the search during playback.
+   * Only a hint, validated before use (not threadsafe either).
+   */
+  int eval_segment_hint;
   /** User-editable settings for this curve. */
   short flag;
   /** Value-extending mode for this curve (does not cover). */
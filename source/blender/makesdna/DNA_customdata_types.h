@@ -54,6 +54,8 @@ typedef struct CustomDataLayer {
   char name[64];
   /** Layer data. */
   void *data;
+  /** Runtime: user count of `data` when it is shared with other layers, see #CD_SHARE. */
+  struct CustomDataLayerShared *shared;
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 64
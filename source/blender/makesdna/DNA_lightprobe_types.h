@@ -183,6 +183,9 @@ typedef struct LightCache {
   /* All lightprobes data contained in the cache. */
   LightProbeCache *cube_data;
   LightGridCache *grid_data;
+  /** Runtime: key of the probe settings each cube-map was baked with (0 if not baked),
+   * used to only re-bake the cube-maps of probes which changed. */
+  unsigned int *cube_keys;
 } LightCache;
 
 /* Bump the version number for lightcache data structure changes. */
@@ -204,6 +207,8 @@ enum {
   LIGHTCACHE_UPDATE_GRID = (1 << 5),
   LIGHTCACHE_UPDATE_WORLD = (1 << 6),
   LIGHTCACHE_UPDATE_AUTO = (1 << 7),
+  /** Only update the cube-maps of the probes which changed since they were baked. */
+  LIGHTCACHE_UPDATE_CUBE_CHANGED = (1 << 8),
 };
 
 /* EEVEE_LightCacheTexture->data_type */
@@ -107,6 +107,14 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /** Flattened vertex group weights for armature deform, defined in 'armature_deform.c'. */
+  struct ArmatureDeformWeights *deform_weights;
+
+  /** Armature deformation done when drawing, defined in 'BKE_armature.h'. */
+  struct ArmatureDeformGPU *armature_deform_gpu;
+  /** Subdivision done when drawing, defined in 'BKE_subdiv_mesh.h'. */
+  struct SubdivMeshGPU *subdiv_gpu;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
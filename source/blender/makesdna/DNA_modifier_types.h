@@ -126,6 +126,9 @@ typedef struct ModifierData {
   /* Pointer to a ModifierData in the original domain. */
   struct ModifierData *orig_modifier_data;
   void *runtime;
+  /** Runtime: seconds spent in the last evaluation of the modifier (mesh modifiers only). */
+  float execution_time;
+  char _pad[4];
 } ModifierData;
 
 typedef enum {
@@ -303,6 +303,13 @@ typedef struct bNode {
    * needs to be a float to feed GPU_uniform.
    */
   float sss_id;
+
+  /**
+   * Statistics of the last compositor execution, runtime only:
+   * time in milliseconds and memory of the buffers written by the node in megabytes.
+   */
+  float exec_time;
+  float exec_memory;
 } bNode;
 
 /* node->flag */
@@ -449,7 +456,11 @@ typedef struct bNodeTree {
   short is_updating;
   /** Generic temporary flag for recursion check (DFS/BFS). */
   short done;
-  char _pad2[4];
+  /**
+   * Unique value assigned whenever the tree is copied. Evaluated trees are copied again when the
+   * original changes, so this can be used to detect changes in evaluated trees.
+   */
+  int copy_generation;
 
   /** Specific node type this tree is used for. */
   int nodetype DNA_DEPRECATED;
@@ -519,6 +530,7 @@ typedef struct bNodeTree {
 
 /* tree is localized copy, free when deleting node groups */
 /* #define NTREE_IS_LOCALIZED           (1 << 5) */
+#define NTREE_COM_HALF_BUFFERS (1 << 6) /* store intermediate color buffers as half float */
 
 /* ntree->update */
 typedef enum eNodeTreeUpdate {
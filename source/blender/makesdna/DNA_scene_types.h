@@ -1825,6 +1825,7 @@ typedef struct Scene {
 #define R_EDGE_FRS (1 << 25)        /* R_EDGE reserved for Freestyle */
 #define R_PERSISTENT_DATA (1 << 26) /* keep data around for re-render */
 #define R_MODE_UNUSED_27 (1 << 27)  /* cleared */
+#define R_WRITE_ASYNC (1 << 27)     /* write frames while the next frame renders */
 
 /** #RenderData.seq_flag */
 enum {
@@ -1859,7 +1860,7 @@ enum {
 #define R_SCEMODE_UNUSED_8 (1 << 8) /* cleared */
 #define R_SINGLE_LAYER (1 << 9)
 #define R_EXR_TILE_FILE (1 << 10)
-#define R_SCEMODE_UNUSED_11 (1 << 11) /* cleared */
+#define R_EXR_TILE_STREAM (1 << 11)
 #define R_NO_IMAGE_LOAD (1 << 12)
 #define R_SCEMODE_UNUSED_13 (1 << 13) /* cleared */
 #define R_NO_FRAME_UPDATE (1 << 14)
@@ -2391,6 +2392,7 @@ enum {
   SCE_EEVEE_GI_AUTOBAKE = (1 << 19),
   SCE_EEVEE_SHADOW_SOFT = (1 << 20),
   SCE_EEVEE_OVERSCAN = (1 << 21),
+  SCE_EEVEE_SHADOW_STATIC_CACHE = (1 << 22),
 };
 
 /* SceneEEVEE->shadow_method */
@@ -406,6 +406,11 @@ typedef struct ARegion_Runtime {
 
   /* The offset needed to not overlap with window scrollbars. Only used by HUD regions for now. */
   int offset_x, offset_y;
+
+  /* Region size the panel layout was last computed for, it can be reused for redraws without
+   * rebuild as long as this matches. */
+  short layout_winx, layout_winy;
+  char _pad[4];
 } ARegion_Runtime;
 
 typedef struct ARegion {
@@ -694,7 +699,9 @@ enum {
   RGN_DRAW_PARTIAL = 2,
   /* For outliner, to do faster redraw without rebuilding outliner tree.
    * For 3D viewport, to display a new progressive render sample without
-   * while other buffers and overlays remain unchanged. */
+   * while other buffers and overlays remain unchanged.
+   * For panel regions, to redraw button highlights and scrolling with the
+   * blocks of the previous layout. */
   RGN_DRAW_NO_REBUILD = 4,
 
   /* Set while region is being drawn. */
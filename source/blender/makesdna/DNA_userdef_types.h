@@ -623,8 +623,12 @@ typedef struct UserDef_Experimental {
   char use_new_hair_type;
   char use_cycles_debug;
   char use_sculpt_vertex_colors;
-  /** `makesdna` does not allow empty structs. */
-  char _pad[3];
+  char use_gpu_mesh_deform;
+  char use_gpu_armature_deform;
+  char use_gpu_subdivision;
+  char use_gpu_shader_cache;
+  char use_hw_video_decode;
+  char _pad0[6];
 } UserDef_Experimental;
 
 #define USER_EXPERIMENTAL_TEST(userdef, member) \
@@ -750,7 +754,13 @@ typedef struct UserDef {
   int prefetchframes;
   /** Control the rotation step of the view when PAD2, PAD4, PAD6&PAD8 is use. */
   float pad_rot_angle;
-  char _pad12[4];
+  /** Percentage of the memory cache limit kept for movie clips, images and the sequencer,
+   * zero shares the memory with the other caches. */
+  char memcache_clip_share;
+  char memcache_image_share;
+  char memcache_sequencer_share;
+  /** Memory for compressed frames evicted from the cache, percentage of the limit. */
+  char memcache_compressed_size;
   /** Rotating view icon size. */
   short rvisize;
   /** Rotating view icon brightness. */
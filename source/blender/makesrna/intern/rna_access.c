@@ -37,6 +37,8 @@
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 
+#include "atomic_ops.h"
+
 #include "BLF_api.h"
 #include "BLT_translation.h"
 
@@ -70,23 +72,47 @@ const PointerRNA PointerRNA_NULL = {NULL};
 
 /* Init/Exit */
 
+static GHash *rna_struct_prophash_create(StructRNA *srna)
+{
+  GHash *prophash = BLI_ghash_str_new_ex(__func__, BLI_listbase_count(&srna->cont.properties));
+  LISTBASE_FOREACH (PropertyRNA *, prop, &srna->cont.properties) {
+    if (!(prop->flag_internal & PROP_INTERN_BUILTIN)) {
+      BLI_ghash_insert(prophash, (void *)prop->identifier, prop);
+    }
+  }
+  return prophash;
+}
+
+/* Return the hash of the properties of the struct (without its bases), created on first use.
+ * Structs registered at runtime don't get one in #RNA_init, and are looked up from threads too
+ * (drivers for example), so publish it atomically. Once it exists, properties added or removed at
+ * runtime keep it up to date. */
+GHash *rna_struct_prophash_ensure(StructRNA *srna)
+{
+  GHash *prophash = srna->cont.prophash;
+  if (prophash == NULL) {
+    GHash *prophash_new = rna_struct_prophash_create(srna);
+    prophash = atomic_cas_ptr((void **)&srna->cont.prophash, NULL, prophash_new);
+    if (prophash == NULL) {
+      prophash = prophash_new;
+    }
+    else {
+      BLI_ghash_free(prophash_new, NULL, NULL);
+    }
+  }
+  return prophash;
+}
+
 void RNA_init(void)
 {
   StructRNA *srna;
-  PropertyRNA *prop;
 
   BLENDER_RNA.structs_map = BLI_ghash_str_new_ex(__func__, 2048);
   BLENDER_RNA.structs_len = 0;
 
   for (srna = BLENDER_RNA.structs.first; srna; srna = srna->cont.next) {
     if (!srna->cont.prophash) {
-      srna->cont.prophash = BLI_ghash_str_new("RNA_init gh");
-
-      for (prop = srna->cont.properties.first; prop; prop = prop->next) {
-        if (!(prop->flag_internal & PROP_INTERN_BUILTIN)) {
-          BLI_ghash_insert(srna->cont.prophash, (void *)prop->identifier, prop);
-        }
-      }
+      srna->cont.prophash = rna_struct_prophash_create(srna);
     }
     BLI_assert(srna->flag & STRUCT_PUBLIC_NAMESPACE);
     BLI_ghash_insert(BLENDER_RNA.structs_map, (void *)srna->identifier, srna);
@@ -25,6 +25,7 @@
 
 #include "rna_internal_types.h"
 
+struct GHash;
 struct IDProperty;
 struct PropertyRNAOrID;
 
@@ -35,4 +36,6 @@ void rna_property_rna_or_id_get(PropertyRNA *prop,
 void rna_idproperty_touch(struct IDProperty *idprop);
 struct IDProperty *rna_idproperty_find(PointerRNA *ptr, const char *name);
 
+struct GHash *rna_struct_prophash_ensure(StructRNA *srna);
+
 #endif /* __ACCESS_RNA_INTERNAL_H__ */
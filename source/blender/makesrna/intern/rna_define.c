@@ -210,6 +210,11 @@ static void rna_brna_structs_remove_and_free(BlenderRNA *brna, StructRNA *srna)
 
   RNA_def_struct_free_pointers(NULL, srna);
 
+  if (srna->cont.prophash) {
+    BLI_ghash_free(srna->cont.prophash, NULL, NULL);
+    srna->cont.prophash = NULL;
+  }
+
   if (srna->flag & STRUCT_RUNTIME) {
     rna_freelinkN(&brna->structs, srna);
   }
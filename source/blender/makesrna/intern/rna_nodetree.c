@@ -8254,6 +8254,7 @@ static void rna_def_shader_node(BlenderRNA *brna)
 static void rna_def_compositor_node(BlenderRNA *brna)
 {
   StructRNA *srna;
+  PropertyRNA *prop;
   FunctionRNA *func;
 
   srna = RNA_def_struct(brna, "CompositorNode", "NodeInternal");
@@ -8264,6 +8265,22 @@ static void rna_def_compositor_node(BlenderRNA *brna)
   /* compositor node need_exec flag */
   func = RNA_def_function(srna, "tag_need_exec", "rna_CompositorNode_tag_need_exec");
   RNA_def_function_ui_description(func, "Tag the node for compositor update");
+
+  prop = RNA_def_property(srna, "execution_time", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_float_sdna(prop, NULL, "exec_time");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(
+      prop,
+      "Execution Time",
+      "Time spent on the node in the last execution of the compositor, in milliseconds");
+
+  prop = RNA_def_property(srna, "execution_memory", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_float_sdna(prop, NULL, "exec_memory");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop,
+                           "Execution Memory",
+                           "Memory of the buffers written by the node in the last execution of "
+                           "the compositor, in megabytes");
 }
 
 static void rna_def_texture_node(BlenderRNA *brna)
@@ -9923,6 +9940,14 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Viewer Border", "Use boundaries for viewer nodes and composite backdrop");
   RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
+
+  prop = RNA_def_property(srna, "use_half_precision_buffers", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_HALF_BUFFERS);
+  RNA_def_property_ui_text(prop,
+                           "Half Precision Buffers",
+                           "Store intermediate color buffers with half float precision, "
+                           "using less memory at the cost of precision");
+  RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
 }
 
 static void rna_def_shader_nodetree(BlenderRNA *brna)
@@ -129,6 +129,8 @@ const EnumPropertyItem rna_enum_property_unit_items[] = {
 
 #  include "BKE_lib_override.h"
 
+#  include "rna_access_internal.h"
+
 /* Struct */
 
 static void rna_Struct_identifier_get(PointerRNA *ptr, char *value)
@@ -419,27 +421,15 @@ int rna_builtin_properties_lookup_string(PointerRNA *ptr, const char *key, Point
   srna = ptr->type;
 
   do {
-    if (srna->cont.prophash) {
-      prop = BLI_ghash_lookup(srna->cont.prophash, (void *)key);
-
-      if (prop) {
-        propptr.type = &RNA_Property;
-        propptr.data = prop;
+    /* Hashed for all structs, including the ones registered at runtime (Python classes). */
+    prop = BLI_ghash_lookup(rna_struct_prophash_ensure(srna), (void *)key);
 
-        *r_ptr = propptr;
-        return true;
-      }
-    }
-    else {
-      for (prop = srna->cont.properties.first; prop; prop = prop->next) {
-        if (!(prop->flag_internal & PROP_INTERN_BUILTIN) && STREQ(prop->identifier, key)) {
-          propptr.type = &RNA_Property;
-          propptr.data = prop;
+    if (prop) {
+      propptr.type = &RNA_Property;
+      propptr.data = prop;
 
-          *r_ptr = propptr;
-          return true;
-        }
-      }
+      *r_ptr = propptr;
+      return true;
     }
   } while ((srna = srna->base));
 
@@ -6021,6 +6021,15 @@ static void rna_def_scene_render_data(BlenderRNA *brna)
       "Create empty placeholder files while rendering frames (similar to Unix 'touch')");
   RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
 
+  prop = RNA_def_property(srna, "use_write_async", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "mode", R_WRITE_ASYNC);
+  RNA_def_property_clear_flag(prop, PROP_ANIMATABLE);
+  RNA_def_property_ui_text(prop,
+                           "Write in Background",
+                           "Save rendered frames in the background while the next frame renders, "
+                           "render write handlers are run once the frame is saved");
+  RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
+
   prop = RNA_def_property(srna, "use_overwrite", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, NULL, "mode", R_NO_OVERWRITE);
   RNA_def_property_ui_text(prop, "Overwrite", "Overwrite existing files while rendering");
@@ -6083,6 +6092,17 @@ static void rna_def_scene_render_data(BlenderRNA *brna)
       "(saves memory, required for Full Sample)");
   RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
 
+  prop = RNA_def_property(srna, "use_save_buffers_stream", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "scemode", R_EXR_TILE_STREAM);
+  RNA_def_property_clear_flag(prop, PROP_ANIMATABLE);
+  RNA_def_property_ui_text(
+      prop,
+      "Stream to Output",
+      "When rendering a multilayer OpenEXR image from the command line, write the saved tiles "
+      "directly into the output file instead of loading the full render result into memory. "
+      "Only used without compositing and sequencer, and with full float precision");
+  RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
+
   prop = RNA_def_property(srna, "use_full_sample", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "scemode", R_FULL_SAMPLE);
   RNA_def_property_ui_text(prop,
@@ -7221,6 +7241,16 @@ static void rna_def_scene_eevee(BlenderRNA *brna)
   RNA_def_property_override_flag(prop, PROPOVERRIDE_OVERRIDABLE_LIBRARY);
   RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
 
+  prop = RNA_def_property(srna, "use_shadow_static_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", SCE_EEVEE_SHADOW_STATIC_CACHE);
+  RNA_def_property_ui_text(prop,
+                           "Cache Static Shadows",
+                           "Keep the shadows of objects that do not move in separate cube maps, "
+                           "only moving objects are redrawn when a light shadow is updated "
+                           "(uses more video memory)");
+  RNA_def_property_override_flag(prop, PROPOVERRIDE_OVERRIDABLE_LIBRARY);
+  RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
+
   prop = RNA_def_property(srna, "light_threshold", PROP_FLOAT, PROP_UNSIGNED);
   RNA_def_property_ui_text(prop,
                            "Light Threshold",
@@ -196,7 +196,6 @@ static const EnumPropertyItem rna_enum_userdef_viewport_aa_items[] = {
 
 #  include "BLI_path_util.h"
 
-#  include "MEM_CacheLimiterC-Api.h"
 #  include "MEM_guardedalloc.h"
 
 #  include "UI_interface.h"
@@ -551,7 +550,7 @@ static void rna_Userdef_memcache_update(Main *UNUSED(bmain),
                                         Scene *UNUSED(scene),
                                         PointerRNA *UNUSED(ptr))
 {
-  MEM_CacheLimiter_set_maximum(((size_t)U.memcachelimit) * 1024 * 1024);
+  BKE_blender_userdef_memcache_limits_update();
   USERDEF_TAG_DIRTY;
 }
 
@@ -5294,6 +5293,42 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "memory_cache_clip_share", PROP_INT, PROP_PERCENTAGE);
+  RNA_def_property_int_sdna(prop, NULL, "memcache_clip_share");
+  RNA_def_property_range(prop, 0, 100);
+  RNA_def_property_ui_text(prop,
+                           "Movie Clip Share",
+                           "Part of the memory cache limit kept for movie clips, "
+                           "zero shares the memory with other caches");
+  RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
+
+  prop = RNA_def_property(srna, "memory_cache_image_share", PROP_INT, PROP_PERCENTAGE);
+  RNA_def_property_int_sdna(prop, NULL, "memcache_image_share");
+  RNA_def_property_range(prop, 0, 100);
+  RNA_def_property_ui_text(prop,
+                           "Image Share",
+                           "Part of the memory cache limit kept for images, "
+                           "zero shares the memory with other caches");
+  RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
+
+  prop = RNA_def_property(srna, "memory_cache_sequencer_share", PROP_INT, PROP_PERCENTAGE);
+  RNA_def_property_int_sdna(prop, NULL, "memcache_sequencer_share");
+  RNA_def_property_range(prop, 0, 100);
+  RNA_def_property_ui_text(prop,
+                           "Sequencer Share",
+                           "Part of the memory cache limit used by the sequencer cache, "
+                           "zero uses the whole limit");
+  RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
+
+  prop = RNA_def_property(srna, "memory_cache_compressed_size", PROP_INT, PROP_PERCENTAGE);
+  RNA_def_property_int_sdna(prop, NULL, "memcache_compressed_size");
+  RNA_def_property_range(prop, 0, 100);
+  RNA_def_property_ui_text(prop,
+                           "Compressed Cache",
+                           "Memory for losslessly compressed movie clip and image frames evicted "
+                           "from the memory cache, in percent of the memory cache limit");
+  RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
+
   /* Sequencer disk cache */
 
   prop = RNA_def_property(srna, "use_sequencer_disk_cache", PROP_BOOLEAN, PROP_NONE);
@@ -6119,6 +6154,42 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   prop = RNA_def_property(srna, "use_sculpt_vertex_colors", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "use_sculpt_vertex_colors", 1);
   RNA_def_property_ui_text(prop, "Sculpt Vertex Colors", "Use the new Vertex Painting system");
+
+  prop = RNA_def_property(srna, "use_gpu_mesh_deform", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_gpu_mesh_deform", 1);
+  RNA_def_property_ui_text(prop,
+                           "GPU Mesh Deform",
+                           "Update positions and normals of deforming meshes on the GPU, instead "
+                           "of extracting them again for every frame");
+
+  prop = RNA_def_property(srna, "use_gpu_armature_deform", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_gpu_armature_deform", 1);
+  RNA_def_property_ui_text(prop,
+                           "GPU Armature Deform",
+                           "Deform meshes by armatures on the GPU when drawing in object mode, "
+                           "requires GPU Mesh Deform");
+
+  prop = RNA_def_property(srna, "use_gpu_subdivision", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_gpu_subdivision", 1);
+  RNA_def_property_ui_text(prop,
+                           "GPU Subdivision",
+                           "Evaluate the subdivision surface modifier on the GPU when it is the "
+                           "last modifier of a smooth mesh drawn in object mode, requires GPU "
+                           "Mesh Deform");
+
+  prop = RNA_def_property(srna, "use_gpu_shader_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_gpu_shader_cache", 1);
+  RNA_def_property_ui_text(prop,
+                           "GPU Shader Cache",
+                           "Store compiled shaders on disk and reuse them in later sessions, "
+                           "instead of compiling them again");
+
+  prop = RNA_def_property(srna, "use_hw_video_decode", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_hw_video_decode", 1);
+  RNA_def_property_ui_text(prop,
+                           "Hardware Video Decoding",
+                           "Decode movies using the GPU or dedicated video hardware when "
+                           "available, for movies opened afterwards");
 }
 
 static void rna_def_userdef_addon_collection(BlenderRNA *brna, PropertyRNA *cprop)
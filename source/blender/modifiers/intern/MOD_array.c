@@ -28,6 +28,7 @@
 #include "BLI_utildefines.h"
 
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -363,17 +364,84 @@ static void mesh_merge_transform(Mesh *result,
   }
 }
 
+typedef struct ArrayChunkData {
+  const Mesh *mesh;
+  Mesh *result;
+  /* Cumulative offset of each copy. */
+  float (*offsets)[4][4];
+  int chunk_nverts, chunk_nedges, chunk_nloops, chunk_npolys;
+  bool use_recalc_normals;
+} ArrayChunkData;
+
+/* Copy the original geometry to copy number c and transform it, copies don't share any data. */
+static void array_chunk_copy_cb(void *__restrict userdata,
+                                const int c,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ArrayChunkData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const int chunk_nverts = data->chunk_nverts;
+  const int chunk_nedges = data->chunk_nedges;
+  const int chunk_nloops = data->chunk_nloops;
+  const int chunk_npolys = data->chunk_npolys;
+  float(*current_offset)[4] = data->offsets[c];
+  MVert *mv;
+  MEdge *me;
+  MLoop *ml;
+  MPoly *mp;
+  int i;
+
+  /* copy customdata to new geometry */
+  CustomData_copy_data(&mesh->vdata, &result->vdata, 0, c * chunk_nverts, chunk_nverts);
+  CustomData_copy_data(&mesh->edata, &result->edata, 0, c * chunk_nedges, chunk_nedges);
+  CustomData_copy_data(&mesh->ldata, &result->ldata, 0, c * chunk_nloops, chunk_nloops);
+  CustomData_copy_data(&mesh->pdata, &result->pdata, 0, c * chunk_npolys, chunk_npolys);
+
+  /* apply offset to all new verts */
+  mv = result->mvert + c * chunk_nverts;
+  for (i = 0; i < chunk_nverts; i++, mv++) {
+    mul_m4_v3(current_offset, mv->co);
+
+    /* We have to correct normals too, if we do not tag them as dirty! */
+    if (!data->use_recalc_normals) {
+      float no[3];
+      normal_short_to_float_v3(no, mv->no);
+      mul_mat3_m4_v3(current_offset, no);
+      normalize_v3(no);
+      normal_float_to_short_v3(mv->no, no);
+    }
+  }
+
+  /* adjust edge vertex indices */
+  me = result->medge + c * chunk_nedges;
+  for (i = 0; i < chunk_nedges; i++, me++) {
+    me->v1 += c * chunk_nverts;
+    me->v2 += c * chunk_nverts;
+  }
+
+  mp = result->mpoly + c * chunk_npolys;
+  for (i = 0; i < chunk_npolys; i++, mp++) {
+    mp->loopstart += c * chunk_nloops;
+  }
+
+  /* adjust loop vertex and edge indices */
+  ml = result->mloop + c * chunk_nloops;
+  for (i = 0; i < chunk_nloops; i++, ml++) {
+    ml->v += c * chunk_nverts;
+    ml->e += c * chunk_nedges;
+  }
+}
+
 static Mesh *arrayModifier_doArray(ArrayModifierData *amd,
                                    const ModifierEvalContext *ctx,
                                    Mesh *mesh)
 {
   const MVert *src_mvert;
-  MVert *mv, *mv_prev, *result_dm_verts;
+  MVert *result_dm_verts;
 
-  MEdge *me;
-  MLoop *ml;
-  MPoly *mp;
   int i, j, c, count;
+  float(*offsets)[4][4];
   float length = amd->length;
   /* offset matrix */
   float offset[4][4];
@@ -577,53 +645,32 @@ static Mesh *arrayModifier_doArray(ArrayModifierData *amd,
   first_chunk_start = 0;
   first_chunk_nverts = chunk_nverts;
 
-  unit_m4(current_offset);
+  /* recalculate cumulative offsets here, then build the copies in parallel */
+  offsets = MEM_malloc_arrayN(count, sizeof(*offsets), __func__);
+  unit_m4(offsets[0]);
   for (c = 1; c < count; c++) {
-    /* copy customdata to new geometry */
-    CustomData_copy_data(&mesh->vdata, &result->vdata, 0, c * chunk_nverts, chunk_nverts);
-    CustomData_copy_data(&mesh->edata, &result->edata, 0, c * chunk_nedges, chunk_nedges);
-    CustomData_copy_data(&mesh->ldata, &result->ldata, 0, c * chunk_nloops, chunk_nloops);
-    CustomData_copy_data(&mesh->pdata, &result->pdata, 0, c * chunk_npolys, chunk_npolys);
-
-    mv_prev = result_dm_verts;
-    mv = mv_prev + c * chunk_nverts;
-
-    /* recalculate cumulative offset here */
-    mul_m4_m4m4(current_offset, current_offset, offset);
-
-    /* apply offset to all new verts */
-    for (i = 0; i < chunk_nverts; i++, mv++, mv_prev++) {
-      mul_m4_v3(current_offset, mv->co);
-
-      /* We have to correct normals too, if we do not tag them as dirty! */
-      if (!use_recalc_normals) {
-        float no[3];
-        normal_short_to_float_v3(no, mv->no);
-        mul_mat3_m4_v3(current_offset, no);
-        normalize_v3(no);
-        normal_float_to_short_v3(mv->no, no);
-      }
-    }
-
-    /* adjust edge vertex indices */
-    me = result->medge + c * chunk_nedges;
-    for (i = 0; i < chunk_nedges; i++, me++) {
-      me->v1 += c * chunk_nverts;
-      me->v2 += c * chunk_nverts;
-    }
-
-    mp = result->mpoly + c * chunk_npolys;
-    for (i = 0; i < chunk_npolys; i++, mp++) {
-      mp->loopstart += c * chunk_nloops;
-    }
-
-    /* adjust loop vertex and edge indices */
-    ml = result->mloop + c * chunk_nloops;
-    for (i = 0; i < chunk_nloops; i++, ml++) {
-      ml->v += c * chunk_nverts;
-      ml->e += c * chunk_nedges;
-    }
+    mul_m4_m4m4(offsets[c], offsets[c - 1], offset);
+  }
+  copy_m4_m4(current_offset, offsets[count - 1]);
+
+  ArrayChunkData chunk_data = {
+      .mesh = mesh,
+      .result = result,
+      .offsets = offsets,
+      .chunk_nverts = chunk_nverts,
+      .chunk_nedges = chunk_nedges,
+      .chunk_nloops = chunk_nloops,
+      .chunk_npolys = chunk_npolys,
+      .use_recalc_normals = use_recalc_normals,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (result_nverts > 1000);
+  BLI_task_parallel_range(1, count, &chunk_data, array_chunk_copy_cb, &settings);
+
+  MEM_freeN(offsets);
 
+  for (c = 1; c < count; c++) {
     /* Handle merge between chunk n and n-1 */
     if (use_merge && (c >= 1)) {
       if (!offset_has_scale && (c >= 2)) {
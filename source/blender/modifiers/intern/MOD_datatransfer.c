@@ -87,6 +87,18 @@ static void initData(ModifierData *md)
   dtmd->flags = MOD_DATATRANSFER_OBSRC_TRANSFORM;
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  /* The runtime data keeps the geometry mappings between evaluations. */
+  BKE_object_data_transfer_geom_map_cache_free(runtime_data_v);
+}
+
+static void freeData(ModifierData *md)
+{
+  freeRuntimeData(md->runtime);
+  md->runtime = NULL;
+}
+
 static void requiredDataMask(Object *UNUSED(ob),
                              ModifierData *md,
                              CustomData_MeshMasks *r_cddata_masks)
@@ -203,6 +215,10 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
 
   BKE_reports_init(&reports, RPT_STORE);
 
+  if (md->runtime == NULL) {
+    md->runtime = BKE_object_data_transfer_geom_map_cache_new();
+  }
+
   /* Note: no islands precision for now here. */
   BKE_object_data_transfer_ex(ctx->depsgraph,
                               scene,
@@ -226,6 +242,7 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
                               dtmd->mix_factor,
                               dtmd->defgrp_name,
                               invert_vgroup,
+                              md->runtime,
                               &reports);
 
   if (BKE_reports_contain(&reports, RPT_ERROR)) {
@@ -496,7 +513,7 @@ ModifierTypeInfo modifierType_DataTransfer = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
-    /* freeData */ NULL,
+    /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
     /* dependsOnTime */ NULL,
@@ -504,7 +521,7 @@ ModifierTypeInfo modifierType_DataTransfer = {
     /* foreachObjectLink */ foreachObjectLink,
     /* foreachIDLink */ NULL,
     /* foreachTexLink */ NULL,
-    /* freeRuntimeData */ NULL,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ NULL,
     /* blendRead */ NULL,
@@ -31,6 +31,7 @@
 #include "BLT_translation.h"
 
 #include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
@@ -62,9 +63,24 @@
 
 #include "intern/CCGSubSurf.h"
 
+/* Everything the subdivided mesh depends on, except for the positions of the coarse vertices. */
+typedef struct SubsurfGPUInput {
+  SubdivSettings settings;
+  SubdivToMeshSettings mesh_settings;
+  int totvert, totedge, totloop, totpoly;
+  uint data_hash;
+  bool is_valid;
+} SubsurfGPUInput;
+
 typedef struct SubsurfRuntimeData {
   /* Cached subdivision surface descriptor, with topology and settings. */
   struct Subdiv *subdiv;
+
+  /* Subdivided mesh evaluated when drawing, see #MOD_APPLY_GPU_SUBDIVISION. */
+  struct SubdivMeshStencils *stencils;
+  SubsurfGPUInput stencils_input;
+  /* Input of the last evaluation, stencils are only created when it didn't change. */
+  SubsurfGPUInput last_input;
 } SubsurfRuntimeData;
 
 static void initData(ModifierData *md)
@@ -119,6 +135,9 @@ static void freeRuntimeData(void *runtime_data_v)
   if (runtime_data->subdiv != NULL) {
     BKE_subdiv_free(runtime_data->subdiv);
   }
+  if (runtime_data->stencils != NULL) {
+    BKE_subdiv_mesh_stencils_free(runtime_data->stencils);
+  }
   MEM_freeN(runtime_data);
 }
 
@@ -204,6 +223,73 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
   return result;
 }
 
+/* Subdivide when drawing. */
+
+static void subdiv_gpu_input_init(SubsurfGPUInput *r_input,
+                                  const SubsurfModifierData *smd,
+                                  const ModifierEvalContext *ctx,
+                                  const SubdivSettings *subdiv_settings,
+                                  const Mesh *mesh)
+{
+  memset(r_input, 0, sizeof(*r_input));
+  r_input->settings = *subdiv_settings;
+  subdiv_mesh_settings_init(&r_input->mesh_settings, smd, ctx);
+  r_input->totvert = mesh->totvert;
+  r_input->totedge = mesh->totedge;
+  r_input->totloop = mesh->totloop;
+  r_input->totpoly = mesh->totpoly;
+  /* Layers referenced from the object data can only be compared when it wasn't updated. */
+  const ID *id_data = ctx->object->data;
+  r_input->is_valid = ((id_data->recalc & ID_RECALC_ALL) == 0) &&
+                      BKE_mesh_data_hash_except_coords(mesh, &r_input->data_hash);
+}
+
+static bool subdiv_gpu_input_equal(const SubsurfGPUInput *input_a, const SubsurfGPUInput *input_b)
+{
+  return input_a->is_valid && input_b->is_valid &&
+         BKE_subdiv_settings_equal(&input_a->settings, &input_b->settings) &&
+         (input_a->mesh_settings.resolution == input_b->mesh_settings.resolution) &&
+         (input_a->mesh_settings.use_optimal_display ==
+          input_b->mesh_settings.use_optimal_display) &&
+         (input_a->totvert == input_b->totvert) && (input_a->totedge == input_b->totedge) &&
+         (input_a->totloop == input_b->totloop) && (input_a->totpoly == input_b->totpoly) &&
+         (input_a->data_hash == input_b->data_hash);
+}
+
+/* Flat faces use the face normals, which are not evaluated when drawing. */
+static bool subdiv_gpu_mesh_is_smooth(const Mesh *mesh)
+{
+  const MPoly *mp = mesh->mpoly;
+  for (int i = 0; i < mesh->totpoly; i++, mp++) {
+    if ((mp->flag & ME_SMOOTH) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Create the stencils to evaluate the next subdivisions when drawing. Creating them costs more
+ * than subdividing once, so this is only done when the same input is subdivided again with other
+ * coarse positions, typically during animation playback. */
+static void subdiv_gpu_stencils_update(SubsurfRuntimeData *runtime_data,
+                                       const SubsurfGPUInput *input,
+                                       Subdiv *subdiv,
+                                       const Mesh *mesh,
+                                       Mesh *result)
+{
+  if (runtime_data->stencils != NULL) {
+    BKE_subdiv_mesh_stencils_free(runtime_data->stencils);
+    runtime_data->stencils = NULL;
+  }
+  if (result != mesh && subdiv_gpu_input_equal(input, &runtime_data->last_input) &&
+      subdiv_gpu_mesh_is_smooth(mesh)) {
+    runtime_data->stencils = BKE_subdiv_mesh_stencils_create(
+        subdiv, &input->mesh_settings, mesh, result);
+    runtime_data->stencils_input = *input;
+  }
+  runtime_data->last_input = *input;
+}
+
 /* Subdivide into CCG. */
 
 static void subdiv_ccg_settings_init(SubdivToCCGSettings *settings,
@@ -258,6 +344,16 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   }
   BKE_subdiv_settings_validate_for_mesh(&subdiv_settings, mesh);
   SubsurfRuntimeData *runtime_data = subsurf_ensure_runtime(smd);
+  SubsurfGPUInput gpu_input;
+  const bool use_gpu = (ctx->flag & MOD_APPLY_GPU_SUBDIVISION) != 0;
+  if (use_gpu) {
+    subdiv_gpu_input_init(&gpu_input, smd, ctx, &subdiv_settings, mesh);
+    if (runtime_data->stencils != NULL &&
+        subdiv_gpu_input_equal(&gpu_input, &runtime_data->stencils_input)) {
+      /* Only the coarse positions changed, the subdivided ones are evaluated when drawing. */
+      return BKE_subdiv_mesh_gpu_create(runtime_data->stencils, mesh);
+    }
+  }
   Subdiv *subdiv = subdiv_descriptor_ensure(smd, &subdiv_settings, mesh);
   if (subdiv == NULL) {
     /* Happens on bad topology, but also on empty input mesh. */
@@ -281,6 +377,10 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
     result = subdiv_as_ccg(smd, ctx, mesh, subdiv);
   }
 
+  if (use_gpu && !use_clnors) {
+    subdiv_gpu_stencils_update(runtime_data, &gpu_input, subdiv, mesh, result);
+  }
+
   if (use_clnors) {
     float(*lnors)[3] = CustomData_get_layer(&result->ldata, CD_NORMAL);
     BLI_assert(lnors != NULL);
@@ -143,6 +143,18 @@ static void local_sync(bNodeTree *localtree, bNodeTree *ntree)
   BKE_node_preview_sync_tree(ntree, localtree);
 }
 
+/* Sum the execution statistics of the nodes inside a group. */
+static void node_group_statistics(bNodeTree *ngroup, float *r_time, float *r_memory)
+{
+  LISTBASE_FOREACH (bNode *, node, &ngroup->nodes) {
+    *r_time += node->exec_time;
+    *r_memory += node->exec_memory;
+    if (ELEM(node->type, NODE_GROUP, NODE_CUSTOM_GROUP) && node->id) {
+      node_group_statistics((bNodeTree *)node->id, r_time, r_memory);
+    }
+  }
+}
+
 static void local_merge(Main *bmain, bNodeTree *localtree, bNodeTree *ntree)
 {
   bNode *lnode;
@@ -153,6 +165,13 @@ static void local_merge(Main *bmain, bNodeTree *localtree, bNodeTree *ntree)
 
   for (lnode = localtree->nodes.first; lnode; lnode = lnode->next) {
     if (ntreeNodeExists(ntree, lnode->new_node)) {
+      lnode->new_node->exec_time = lnode->exec_time;
+      lnode->new_node->exec_memory = lnode->exec_memory;
+      if (ELEM(lnode->type, NODE_GROUP, NODE_CUSTOM_GROUP) && lnode->id) {
+        node_group_statistics(
+            (bNodeTree *)lnode->id, &lnode->new_node->exec_time, &lnode->new_node->exec_memory);
+      }
+
       if (ELEM(lnode->type, CMP_NODE_VIEWER, CMP_NODE_SPLITVIEWER)) {
         if (lnode->id && (lnode->flag & NODE_DO_OUTPUT)) {
           /* image_merge does sanity check for pointers */
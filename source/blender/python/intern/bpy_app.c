@@ -53,6 +53,8 @@
 
 #include "DNA_ID.h"
 
+#include "DRW_engine.h"
+
 #include "UI_interface_icons.h"
 
 /* for notifiers */
@@ -90,6 +92,9 @@ static PyStructSequence_Field app_info_fields[] = {
     {"background",
      "Boolean, True when blender is running without a user interface (started with -b)"},
     {"factory_startup", "Boolean, True when blender is running with --factory-startup)"},
+    {"background_fast_start",
+     "Boolean, True when blender is running with --background-fast-start, "
+     "add-ons are then enabled on first use when running in background mode"},
 
     /* buildinfo */
     {"build_date", "The date this blender instance was built"},
@@ -168,6 +173,7 @@ static PyObject *make_app_info(void)
   SetStrItem(BKE_appdir_program_path());
   SetObjItem(PyBool_FromLong(G.background));
   SetObjItem(PyBool_FromLong(G.factory_startup));
+  SetObjItem(PyBool_FromLong(G.background_fast_start));
 
   /* build info, use bytes since we can't assume _any_ encoding:
    * see patch [#30154] for issue */
@@ -364,6 +370,27 @@ static PyObject *bpy_app_tempdir_get(PyObject *UNUSED(self), void *UNUSED(closur
   return PyC_UnicodeFromByte(BKE_tempdir_session());
 }
 
+PyDoc_STRVAR(bpy_app_gpu_timings_doc,
+             "Tuple of (name, level, milliseconds) with the GPU time of each draw pass and group "
+             "of the last viewport redraw, only recorded when :data:`debug_gpu_timings` is "
+             "enabled (read-only)");
+static PyObject *bpy_app_gpu_timings_get(PyObject *UNUSED(self), void *UNUSED(closure))
+{
+  const int timings_len = DRW_stats_timings_len();
+  PyObject *ret = PyTuple_New(timings_len);
+  for (int i = 0; i < timings_len; i++) {
+    const char *name;
+    int level;
+    double time_ms;
+    DRW_stats_timing_get(i, &name, &level, &time_ms);
+    PyObject *item = PyTuple_New(3);
+    PyTuple_SET_ITEMS(
+        item, PyUnicode_FromString(name), PyLong_FromLong(level), PyFloat_FromDouble(time_ms));
+    PyTuple_SET_ITEM(ret, i, item);
+  }
+  return ret;
+}
+
 PyDoc_STRVAR(
     bpy_app_driver_dict_doc,
     "Dictionary for drivers namespace, editable in-place, reset on file load (read-only)");
@@ -460,6 +487,11 @@ static PyGetSetDef bpy_app_getsets[] = {
      bpy_app_debug_doc,
      (void *)G_DEBUG_GPU_MEM},
     {"debug_io", bpy_app_debug_get, bpy_app_debug_set, bpy_app_debug_doc, (void *)G_DEBUG_IO},
+    {"debug_gpu_timings",
+     bpy_app_debug_get,
+     bpy_app_debug_set,
+     bpy_app_debug_doc,
+     (void *)G_DEBUG_GPU_TIMINGS},
 
     {"use_event_simulate",
      bpy_app_global_flag_get,
@@ -485,6 +517,7 @@ static PyGetSetDef bpy_app_getsets[] = {
      bpy_app_debug_value_doc,
      NULL},
     {"tempdir", bpy_app_tempdir_get, NULL, bpy_app_tempdir_doc, NULL},
+    {"gpu_timings", bpy_app_gpu_timings_get, NULL, bpy_app_gpu_timings_doc, NULL},
     {"driver_namespace", bpy_app_driver_dict_get, NULL, bpy_app_driver_dict_doc, NULL},
 
     {"render_icon_size",
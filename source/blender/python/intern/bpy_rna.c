@@ -5427,6 +5427,108 @@ static PyObject *pyrna_prop_collection_foreach_set(BPy_PropertyRNA *self, PyObje
   return foreach_getset(self, args, 1);
 }
 
+PyDoc_STRVAR(pyrna_prop_collection_foreach_view_doc,
+             ".. method:: foreach_view(attr)\n"
+             "\n"
+             "   Give direct access to an attribute of all items in a collection, without\n"
+             "   copying.\n"
+             "\n"
+             "   Writing to the view changes the data in place, but does not send any update,\n"
+             "   call ``update_tag()`` on the owning ID, or ``Mesh.update()``, once done\n"
+             "   writing.\n"
+             "   The view must not be used after the collection is resized, since its memory is\n"
+             "   reallocated then.\n"
+             "\n"
+             "   :arg attr: Name of the attribute of the collection items.\n"
+             "   :type attr: string\n"
+             "   :return: A view with one row per item, and one column per array element for\n"
+             "      array attributes.\n"
+             "   :rtype: :class:`memoryview`\n"
+             "   :raises TypeError: when the attribute is not stored in a plain array, use\n"
+             "      :meth:`foreach_get` and :meth:`foreach_set` for those.\n");
+static PyObject *pyrna_prop_collection_foreach_view(BPy_PropertyRNA *self, PyObject *args)
+{
+  const char *attr;
+
+  PYRNA_PROP_CHECK_OBJ(self);
+
+  if (!PyArg_ParseTuple(args, "s:foreach_view", &attr)) {
+    return NULL;
+  }
+
+  PointerRNA itemptr_base;
+  RNA_pointer_create(
+      NULL, RNA_property_pointer_type(&self->ptr, self->prop), NULL, &itemptr_base);
+  PropertyRNA *itemprop = RNA_struct_find_property(&itemptr_base, attr);
+  if (itemprop == NULL) {
+    PyErr_Format(PyExc_AttributeError,
+                 "foreach_view '%.200s.%200s[...]' elements have no attribute '%.200s'",
+                 RNA_struct_identifier(self->ptr.type),
+                 RNA_property_identifier(self->prop),
+                 attr);
+    return NULL;
+  }
+
+  RawArray raw;
+  const RawPropertyType raw_type = RNA_property_raw_type(itemprop);
+  if (raw_type == PROP_RAW_UNSET ||
+      !RNA_property_collection_raw_array(&self->ptr, self->prop, itemprop, &raw)) {
+    PyErr_Format(PyExc_TypeError,
+                 "foreach_view '%.200s.%200s[...].%.200s' is not stored in a plain array",
+                 RNA_struct_identifier(self->ptr.type),
+                 RNA_property_identifier(self->prop),
+                 attr);
+    return NULL;
+  }
+
+  const bool is_signed = (RNA_property_subtype(itemprop) != PROP_UNSIGNED);
+  const char *format = NULL;
+  switch (raw_type) {
+    case PROP_RAW_CHAR:
+      format = is_signed ? "b" : "B";
+      break;
+    case PROP_RAW_SHORT:
+      format = is_signed ? "h" : "H";
+      break;
+    case PROP_RAW_INT:
+      format = is_signed ? "i" : "I";
+      break;
+    case PROP_RAW_BOOLEAN:
+      format = "?";
+      break;
+    case PROP_RAW_FLOAT:
+      format = "f";
+      break;
+    case PROP_RAW_DOUBLE:
+      format = "d";
+      break;
+    case PROP_RAW_UNSET:
+      BLI_assert(0);
+      break;
+  }
+
+  /* Items are usually structs, so rows are strided by the item size. */
+  const int itemsize = RNA_raw_type_sizeof(raw_type);
+  const int arraylen = RNA_property_array_length(&itemptr_base, itemprop);
+  const int row_len = MAX2(arraylen, 1);
+  Py_ssize_t shape[2] = {raw.len, arraylen};
+  /* The stride is unset for empty collections. */
+  Py_ssize_t strides[2] = {raw.len ? raw.stride : itemsize * row_len, itemsize};
+
+  Py_buffer view = {NULL};
+  view.buf = raw.array;
+  view.itemsize = itemsize;
+  view.len = (Py_ssize_t)raw.len * row_len * itemsize;
+  view.readonly = 0;
+  view.ndim = (arraylen != 0) ? 2 : 1;
+  view.format = (char *)format;
+  /* The memory-view copies the shape and strides. */
+  view.shape = shape;
+  view.strides = strides;
+
+  return PyMemoryView_FromBuffer(&view);
+}
+
 static PyObject *pyprop_array_foreach_getset(BPy_PropertyArrayRNA *self,
                                              PyObject *args,
                                              const bool do_set)
@@ -5764,6 +5866,10 @@ static struct PyMethodDef pyrna_prop_collection_methods[] = {
      (PyCFunction)pyrna_prop_collection_foreach_set,
      METH_VARARGS,
      pyrna_prop_collection_foreach_set_doc},
+    {"foreach_view",
+     (PyCFunction)pyrna_prop_collection_foreach_view,
+     METH_VARARGS,
+     pyrna_prop_collection_foreach_view_doc},
 
     {"keys", (PyCFunction)pyrna_prop_collection_keys, METH_NOARGS, pyrna_prop_collection_keys_doc},
     {"items",
@@ -156,6 +156,14 @@ typedef struct RenderResult {
   char *error;
 
   struct StampData *stamp_data;
+
+  /* unique number of this result, to detect when cached data derived from it is outdated */
+  unsigned int serial;
+
+  /* multilayer EXR the passes are read from on first use, see RE_pass_ensure_loaded */
+  void *exrhandle;
+  char exr_colorspace[64];
+  bool exr_predivide;
 } RenderResult;
 
 typedef struct RenderStats {
@@ -322,6 +330,8 @@ bool RE_WriteRenderResult(struct ReportList *reports,
                           int layer);
 struct RenderResult *RE_MultilayerConvert(
     void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty);
+void RE_pass_ensure_loaded(struct RenderResult *rr, struct RenderPass *rpass);
+void RE_render_result_ensure_loaded(struct RenderResult *rr);
 
 /* display and event callbacks */
 void RE_display_init_cb(struct Render *re,
@@ -360,6 +370,7 @@ struct RenderPass *RE_pass_find_by_name(volatile struct RenderLayer *rl,
 struct RenderPass *RE_pass_find_by_type(volatile struct RenderLayer *rl,
                                         int passtype,
                                         const char *viewname);
+float *RE_pass_rect_get(struct RenderPass *rpass, int *r_len);
 
 /* shaded view or baking options */
 #define RE_BAKE_NORMALS 0
@@ -154,6 +154,11 @@ struct Render {
   void **movie_ctx_arr;
   char viewname[MAX_NAME];
 
+  /* Output file that save buffers tiles are written to directly, empty when not streaming. */
+  char exr_stream_filepath[1024]; /* FILE_MAX */
+  /* The output file was written while rendering, no need to save the render result. */
+  bool exr_stream_written;
+
   /* TODO replace by a whole draw manager. */
   void *gl_context;
   void *gpu_context;
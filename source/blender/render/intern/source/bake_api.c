@@ -66,6 +66,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -322,7 +323,8 @@ static bool cast_ray_highpoly(BVHTreeFromMesh *treeData,
                               const float dir[3],
                               const int pixel_id,
                               const int tot_highpoly,
-                              const float max_ray_distance)
+                              const float max_ray_distance,
+                              BVHTreeRayHit *hits)
 {
   int i;
   int hit_mesh = -1;
@@ -332,9 +334,6 @@ static bool cast_ray_highpoly(BVHTreeFromMesh *treeData,
     hit_distance = FLT_MAX;
   }
 
-  BVHTreeRayHit *hits;
-  hits = MEM_mallocN(sizeof(BVHTreeRayHit) * tot_highpoly, "Bake Highpoly to Lowpoly: BVH Rays");
-
   for (i = 0; i < tot_highpoly; i++) {
     float co_high[3], dir_high[3];
 
@@ -436,7 +435,6 @@ static bool cast_ray_highpoly(BVHTreeFromMesh *treeData,
     pixel_array[pixel_id].object_id = -1;
   }
 
-  MEM_freeN(hits);
   return hit_mesh != -1;
 }
 
@@ -517,6 +515,122 @@ static TriTessFace *mesh_calc_tri_tessface(Mesh *me, bool tangent, Mesh *me_eval
   return triangles;
 }
 
+typedef struct BakeHighPolyPixelsData {
+  BakePixel *pixel_array_from;
+  BakePixel *pixel_array_to;
+  BakeHighPolyData *highpoly;
+  int tot_highpoly;
+  bool is_custom_cage;
+  bool is_cage;
+  float cage_extrusion;
+  float max_ray_distance;
+  float (*mat_low)[4];
+  float (*mat_cage)[4];
+  float imat_low[4][4];
+  TriTessFace *tris_low;
+  TriTessFace *tris_cage;
+  TriTessFace **tris_high;
+  BVHTreeFromMesh *treeData;
+} BakeHighPolyPixelsData;
+
+typedef struct BakeHighPolyPixelsTLS {
+  /* Ray hits for every highpoly object, allocated once per thread. */
+  BVHTreeRayHit *hits;
+} BakeHighPolyPixelsTLS;
+
+static void bake_highpoly_pixels_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict tls)
+{
+  BakeHighPolyPixelsData *data = userdata;
+  BakeHighPolyPixelsTLS *tls_data = tls->userdata_chunk;
+  BakePixel *pixel_array_from = data->pixel_array_from;
+  BakePixel *pixel_array_to = data->pixel_array_to;
+  float co[3];
+  float dir[3];
+  TriTessFace *tri_low;
+
+  const int primitive_id = pixel_array_from[i].primitive_id;
+
+  if (primitive_id == -1) {
+    pixel_array_to[i].primitive_id = -1;
+    return;
+  }
+
+  const float u = pixel_array_from[i].uv[0];
+  const float v = pixel_array_from[i].uv[1];
+
+  /* calculate from low poly mesh cage */
+  if (data->is_custom_cage) {
+    calc_point_from_barycentric_cage(data->tris_low,
+                                     data->tris_cage,
+                                     data->mat_low,
+                                     data->mat_cage,
+                                     primitive_id,
+                                     u,
+                                     v,
+                                     co,
+                                     dir);
+    tri_low = &data->tris_cage[primitive_id];
+  }
+  else if (data->is_cage) {
+    calc_point_from_barycentric_extrusion(data->tris_cage,
+                                          data->mat_low,
+                                          data->imat_low,
+                                          primitive_id,
+                                          u,
+                                          v,
+                                          data->cage_extrusion,
+                                          co,
+                                          dir,
+                                          true);
+    tri_low = &data->tris_cage[primitive_id];
+  }
+  else {
+    calc_point_from_barycentric_extrusion(data->tris_low,
+                                          data->mat_low,
+                                          data->imat_low,
+                                          primitive_id,
+                                          u,
+                                          v,
+                                          data->cage_extrusion,
+                                          co,
+                                          dir,
+                                          false);
+    tri_low = &data->tris_low[primitive_id];
+  }
+
+  if (tls_data->hits == NULL) {
+    tls_data->hits = MEM_mallocN(sizeof(BVHTreeRayHit) * data->tot_highpoly,
+                                 "Bake Highpoly to Lowpoly: BVH Rays");
+  }
+
+  /* cast ray */
+  if (!cast_ray_highpoly(data->treeData,
+                         tri_low,
+                         data->tris_high,
+                         pixel_array_from,
+                         pixel_array_to,
+                         data->mat_low,
+                         data->highpoly,
+                         co,
+                         dir,
+                         i,
+                         data->tot_highpoly,
+                         data->max_ray_distance,
+                         tls_data->hits)) {
+    /* if it fails mask out the original pixel array */
+    pixel_array_from[i].primitive_id = -1;
+  }
+}
+
+static void bake_highpoly_pixels_free(const void *__restrict UNUSED(userdata),
+                                      void *__restrict chunk)
+{
+  BakeHighPolyPixelsTLS *tls_data = chunk;
+  MEM_SAFE_FREE(tls_data->hits);
+}
+
 bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
                                           BakePixel pixel_array_from[],
                                           BakePixel pixel_array_to[],
@@ -531,8 +645,6 @@ bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
                                           struct Mesh *me_cage)
 {
   size_t i;
-  int primitive_id;
-  float u, v;
   float imat_low[4][4];
   bool is_cage = me_cage != NULL;
   bool result = true;
@@ -586,54 +698,37 @@ bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
     }
   }
 
-  for (i = 0; i < num_pixels; i++) {
-    float co[3];
-    float dir[3];
-    TriTessFace *tri_low;
-
-    primitive_id = pixel_array_from[i].primitive_id;
-
-    if (primitive_id == -1) {
-      pixel_array_to[i].primitive_id = -1;
-      continue;
-    }
-
-    u = pixel_array_from[i].uv[0];
-    v = pixel_array_from[i].uv[1];
-
-    /* calculate from low poly mesh cage */
-    if (is_custom_cage) {
-      calc_point_from_barycentric_cage(
-          tris_low, tris_cage, mat_low, mat_cage, primitive_id, u, v, co, dir);
-      tri_low = &tris_cage[primitive_id];
-    }
-    else if (is_cage) {
-      calc_point_from_barycentric_extrusion(
-          tris_cage, mat_low, imat_low, primitive_id, u, v, cage_extrusion, co, dir, true);
-      tri_low = &tris_cage[primitive_id];
-    }
-    else {
-      calc_point_from_barycentric_extrusion(
-          tris_low, mat_low, imat_low, primitive_id, u, v, cage_extrusion, co, dir, false);
-      tri_low = &tris_low[primitive_id];
-    }
-
-    /* cast ray */
-    if (!cast_ray_highpoly(treeData,
-                           tri_low,
-                           tris_high,
-                           pixel_array_from,
-                           pixel_array_to,
-                           mat_low,
-                           highpoly,
-                           co,
-                           dir,
-                           i,
-                           tot_highpoly,
-                           max_ray_distance)) {
-      /* if it fails mask out the original pixel array */
-      pixel_array_from[i].primitive_id = -1;
-    }
+  /* Every pixel only writes to its own elements of the pixel arrays, and the BVH trees are only
+   * read, so pixels can be handled in parallel. */
+  {
+    BakeHighPolyPixelsData data = {
+        .pixel_array_from = pixel_array_from,
+        .pixel_array_to = pixel_array_to,
+        .highpoly = highpoly,
+        .tot_highpoly = tot_highpoly,
+        .is_custom_cage = is_custom_cage,
+        .is_cage = is_cage,
+        .cage_extrusion = cage_extrusion,
+        .max_ray_distance = max_ray_distance,
+        .mat_low = mat_low,
+        .mat_cage = mat_cage,
+        .tris_low = tris_low,
+        .tris_cage = tris_cage,
+        .tris_high = tris_high,
+        .treeData = treeData,
+    };
+    copy_m4_m4(data.imat_low, imat_low);
+
+    BakeHighPolyPixelsTLS tls_data = {NULL};
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (num_pixels > 1024);
+    settings.min_iter_per_thread = 1024;
+    settings.userdata_chunk = &tls_data;
+    settings.userdata_chunk_size = sizeof(tls_data);
+    settings.func_free = bake_highpoly_pixels_free;
+    BLI_task_parallel_range(0, (int)num_pixels, &data, bake_highpoly_pixels_cb, &settings);
   }
 
   /* garbage collection */
@@ -148,6 +148,11 @@ void RE_engine_free(RenderEngine *engine)
   }
 #endif
 
+  if (engine->depsgraph) {
+    /* Kept around for persistent data. */
+    DEG_graph_free(engine->depsgraph);
+  }
+
   BLI_mutex_end(&engine->update_render_passes_mutex);
 
   MEM_freeN(engine);
@@ -591,13 +596,37 @@ RenderData *RE_engine_get_render_data(Render *re)
 }
 
 /* Depsgraph */
+
+/* With persistent data the depsgraph is kept between renders, so that the engine only has to
+ * update the IDs which changed since the previous frame. */
+static bool engine_keep_depsgraph(RenderEngine *engine)
+{
+  return (engine->re->r.mode & R_PERSISTENT_DATA) && !(engine->re->r.scemode & R_BUTS_PREVIEW);
+}
+
+static void engine_depsgraph_free(RenderEngine *engine)
+{
+  DEG_graph_free(engine->depsgraph);
+
+  engine->depsgraph = NULL;
+}
+
 static void engine_depsgraph_init(RenderEngine *engine, ViewLayer *view_layer)
 {
   Main *bmain = engine->re->main;
   Scene *scene = engine->re->scene;
 
-  engine->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(engine->depsgraph, "RENDER");
+  /* Only reuse the depsgraph of the previous render when it was built for the same view layer,
+   * a new depsgraph tags all IDs as updated so the engine does a full sync. */
+  if (engine->depsgraph && (DEG_get_input_scene(engine->depsgraph) != scene ||
+                            DEG_get_input_view_layer(engine->depsgraph) != view_layer)) {
+    engine_depsgraph_free(engine);
+  }
+
+  if (engine->depsgraph == NULL) {
+    engine->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+    DEG_debug_name_set(engine->depsgraph, "RENDER");
+  }
 
   if (engine->re->r.scemode & R_BUTS_PREVIEW) {
     Depsgraph *depsgraph = engine->depsgraph;
@@ -607,15 +636,26 @@ static void engine_depsgraph_init(RenderEngine *engine, ViewLayer *view_layer)
     DEG_ids_clear_recalc(bmain, depsgraph);
   }
   else {
-    BKE_scene_graph_update_for_newframe(engine->depsgraph, bmain);
+    /* When the depsgraph is kept the recalc flags are cleared after rendering instead, so the
+     * engine can find which IDs changed since the previous frame. */
+    BKE_scene_graph_update_for_newframe_ex(
+        engine->depsgraph, bmain, !engine_keep_depsgraph(engine));
   }
 }
 
-static void engine_depsgraph_free(RenderEngine *engine)
+static void engine_depsgraph_exit(RenderEngine *engine)
 {
-  DEG_graph_free(engine->depsgraph);
+  if (engine->depsgraph == NULL) {
+    return;
+  }
 
-  engine->depsgraph = NULL;
+  if (engine_keep_depsgraph(engine)) {
+    /* The engine has handled all updates of this frame by now. */
+    DEG_ids_clear_recalc(engine->re->main, engine->depsgraph);
+  }
+  else {
+    engine_depsgraph_free(engine);
+  }
 }
 
 void RE_engine_frame_set(RenderEngine *engine, int frame, float subframe)
@@ -691,6 +731,10 @@ bool RE_bake_engine(Render *re,
   BLI_rw_mutex_unlock(&re->partsmutex);
 
   if (type->bake) {
+    if (engine->depsgraph) {
+      /* Depsgraph kept by a previous render with persistent data. */
+      engine_depsgraph_free(engine);
+    }
     engine->depsgraph = depsgraph;
 
     /* update is only called so we create the engine.session */
@@ -883,7 +927,7 @@ int RE_engine_render(Render *re, int do_all)
         DRW_render_gpencil(engine, engine->depsgraph);
       }
 
-      engine_depsgraph_free(engine);
+      engine_depsgraph_exit(engine);
 
       if (RE_engine_test_break(engine)) {
         break;
@@ -975,7 +1019,7 @@ void RE_engine_free_blender_memory(RenderEngine *engine)
    *
    * TODO(sergey): Find better solution for this.
    */
-  if (DRW_render_check_grease_pencil(engine->depsgraph)) {
+  if (DRW_render_check_grease_pencil(engine->depsgraph) || engine_keep_depsgraph(engine)) {
     return;
   }
   DEG_graph_free(engine->depsgraph);
@@ -46,6 +46,7 @@
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_timecode.h"
 
@@ -155,12 +156,15 @@ static void render_callback_exec_id(Render *re, Main *bmain, ID *id, eCbEvent ev
 
 /* ********* alloc and free ******** */
 
+typedef struct RenderWriteQueue RenderWriteQueue;
+
 static int do_write_image_or_movie(Render *re,
                                    Main *bmain,
                                    Scene *scene,
                                    bMovieHandle *mh,
                                    const int totvideos,
-                                   const char *name_override);
+                                   const char *name_override,
+                                   RenderWriteQueue *write_queue);
 
 /* default callbacks, set in each new render */
 static void result_nothing(void *UNUSED(arg), RenderResult *UNUSED(rr))
@@ -291,6 +295,7 @@ bool RE_HasSingleLayer(Render *re)
   return (re->r.scemode & R_SINGLE_LAYER);
 }
 
+/* The render result takes ownership of the handle, passes are read on demand. */
 RenderResult *RE_MultilayerConvert(
     void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty)
 {
@@ -1987,6 +1992,47 @@ static void render_init_depsgraph(Render *re)
   re->pipeline_scene_eval = DEG_get_evaluated_scene(re->pipeline_depsgraph);
 }
 
+/* Tiles saved with save buffers can be written directly into the output file, instead of reading
+ * the full render result back into memory and saving it afterwards. This is only possible when
+ * the render result is not needed for anything else and is saved as is. */
+static void render_exr_stream_init(
+    Render *re, Main *bmain, Scene *scene, const bool write_output, const bool use_frames)
+{
+  const RenderData *rd = &re->r;
+
+  re->exr_stream_filepath[0] = '\0';
+  re->exr_stream_written = false;
+
+  if (!write_output || !G.background) {
+    return;
+  }
+  if ((rd->scemode & (R_EXR_TILE_FILE | R_EXR_TILE_STREAM)) !=
+      (R_EXR_TILE_FILE | R_EXR_TILE_STREAM)) {
+    return;
+  }
+  /* Tiles are written with full float precision. */
+  if (rd->im_format.imtype != R_IMF_IMTYPE_MULTILAYER ||
+      rd->im_format.depth == R_IMF_CHAN_DEPTH_16) {
+    return;
+  }
+  if ((rd->scemode & R_MULTIVIEW) || ((rd->mode & R_BORDER) && !(rd->mode & R_CROP))) {
+    return;
+  }
+  if (((rd->scemode & R_DOCOMP) && scene->use_nodes && scene->nodetree) ||
+      RE_seq_render_active(scene, &scene->r)) {
+    return;
+  }
+
+  BKE_image_path_from_imformat(re->exr_stream_filepath,
+                               rd->pic,
+                               BKE_main_blendfile_path(bmain),
+                               scene->r.cfra,
+                               &rd->im_format,
+                               (rd->scemode & R_EXTENSION) != 0,
+                               use_frames,
+                               NULL);
+}
+
 /* general Blender frame render call */
 void RE_RenderFrame(Render *re,
                     Main *bmain,
@@ -2012,6 +2058,9 @@ void RE_RenderFrame(Render *re,
 
     render_init_depsgraph(re);
 
+    render_exr_stream_init(
+        re, bmain, scene, write_still && !BKE_imtype_is_movie(rd.im_format.imtype), false);
+
     do_render_all_options(re);
 
     if (write_still && !G.is_break) {
@@ -2031,7 +2080,7 @@ void RE_RenderFrame(Render *re,
                                      NULL);
 
         /* reports only used for Movie */
-        do_write_image_or_movie(re, bmain, scene, NULL, 0, name);
+        do_write_image_or_movie(re, bmain, scene, NULL, 0, name, NULL);
       }
     }
 
@@ -2299,12 +2348,88 @@ bool RE_WriteRenderViewsMovie(ReportList *reports,
   return ok;
 }
 
+/* Images of an animation can be written on a separate thread while the next frame renders.
+ * Only a single frame is queued at a time, which bounds the memory used by the copies of the
+ * render results. */
+typedef struct RenderWriteTask {
+  /* Copies, so the next frame doesn't change what is written. */
+  RenderResult *rr;
+  Scene scene;
+  char name[FILE_MAX];
+  ReportList reports;
+  bool ok;
+} RenderWriteTask;
+
+struct RenderWriteQueue {
+  TaskPool *pool;
+  RenderWriteTask *task;
+};
+
+static void render_write_task_run(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  RenderWriteTask *task = taskdata;
+  task->ok = RE_WriteRenderViewsImage(&task->reports, task->rr, &task->scene, true, task->name);
+}
+
+static void render_write_queue_push(RenderWriteQueue *queue,
+                                    Scene *scene,
+                                    RenderResult *rr,
+                                    const char *name)
+{
+  BLI_assert(queue->task == NULL);
+
+  RenderWriteTask *task = MEM_callocN(sizeof(RenderWriteTask), "RenderWriteTask");
+  const bool is_exr = ELEM(
+      scene->r.im_format.imtype, R_IMF_IMTYPE_OPENEXR, R_IMF_IMTYPE_MULTILAYER);
+
+  /* Layers are only written to EXR, other formats only need the combined views. */
+  RenderResult rr_write = *rr;
+  if (!is_exr) {
+    BLI_listbase_clear(&rr_write.layers);
+  }
+  task->rr = RE_DuplicateRenderResult(&rr_write);
+  task->scene = *scene;
+  BLI_strncpy(task->name, name, sizeof(task->name));
+  BKE_reports_init(&task->reports, RPT_STORE);
+
+  queue->task = task;
+  BLI_task_pool_push(queue->pool, render_write_task_run, task, false, NULL);
+}
+
+/* Wait for the queued frame to be written, returns false if writing it failed. */
+static bool render_write_queue_finish(Render *re, RenderWriteQueue *queue, Scene *scene)
+{
+  if (queue == NULL || queue->task == NULL) {
+    return true;
+  }
+
+  BLI_task_pool_work_and_wait(queue->pool);
+
+  RenderWriteTask *task = queue->task;
+  const bool ok = task->ok;
+  queue->task = NULL;
+
+  LISTBASE_FOREACH (Report *, report, &task->reports.list) {
+    BKE_report(re->reports, report->type, report->message);
+  }
+  BKE_reports_clear(&task->reports);
+  RE_FreeRenderResult(task->rr);
+  MEM_freeN(task);
+
+  if (ok) {
+    render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
+  }
+
+  return ok;
+}
+
 static int do_write_image_or_movie(Render *re,
                                    Main *bmain,
                                    Scene *scene,
                                    bMovieHandle *mh,
                                    const int totvideos,
-                                   const char *name_override)
+                                   const char *name_override,
+                                   RenderWriteQueue *write_queue)
 {
   char name[FILE_MAX];
   RenderResult rres;
@@ -2318,6 +2443,10 @@ static int do_write_image_or_movie(Render *re,
     RE_WriteRenderViewsMovie(
         re->reports, &rres, scene, &re->r, mh, re->movie_ctx_arr, totvideos, false);
   }
+  else if (re->exr_stream_written) {
+    /* Tiles were already written to the output file while rendering. */
+    printf("Saved: '%s'\n", re->exr_stream_filepath);
+  }
   else {
     if (name_override) {
       BLI_strncpy(name, name_override, sizeof(name));
@@ -2333,8 +2462,13 @@ static int do_write_image_or_movie(Render *re,
                                    NULL);
     }
 
-    /* write images as individual images or stereo */
-    ok = RE_WriteRenderViewsImage(re->reports, &rres, scene, true, name);
+    if (write_queue != NULL) {
+      render_write_queue_push(write_queue, scene, &rres, name);
+    }
+    else {
+      /* write images as individual images or stereo */
+      ok = RE_WriteRenderViewsImage(re->reports, &rres, scene, true, name);
+    }
   }
 
   RE_ReleaseResultImageViews(re, &rres);
@@ -2419,6 +2553,7 @@ void RE_RenderAnim(Render *re,
   const bool is_movie = BKE_imtype_is_movie(rd.im_format.imtype);
   const bool is_multiview_name = ((rd.scemode & R_MULTIVIEW) != 0 &&
                                   (rd.im_format.views_format == R_IMF_VIEWS_INDIVIDUAL));
+  RenderWriteQueue write_queue_data = {NULL}, *write_queue = NULL;
 
   /* do not fully call for each frame, it initializes & pops output window */
   if (!render_init_from_main(re, &rd, bmain, scene, single_layer, camera_override, 0, 1)) {
@@ -2474,6 +2609,11 @@ void RE_RenderAnim(Render *re,
 
   re->flag |= R_ANIMATION;
 
+  if ((rd.mode & R_WRITE_ASYNC) && !is_movie) {
+    write_queue_data.pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_HIGH);
+    write_queue = &write_queue_data;
+  }
+
   {
     for (nfra = sfra, scene->r.cfra = sfra; scene->r.cfra <= efra; scene->r.cfra++) {
       char name[FILE_MAX];
@@ -2588,12 +2728,16 @@ void RE_RenderAnim(Render *re,
       /* run callbacks before rendering, before the scene is updated */
       render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_PRE);
 
+      render_exr_stream_init(re, bmain, scene, !is_movie, true);
+
       do_render_all_options(re);
       totrendered++;
 
       if (re->test_break(re->tbh) == 0) {
         if (!G.is_break) {
-          if (!do_write_image_or_movie(re, bmain, scene, mh, totvideos, NULL)) {
+          /* Wait for the previous frame to be written before queuing this one. */
+          if (!render_write_queue_finish(re, write_queue, scene) ||
+              !do_write_image_or_movie(re, bmain, scene, mh, totvideos, NULL, write_queue)) {
             G.is_break = true;
           }
         }
@@ -2638,11 +2782,21 @@ void RE_RenderAnim(Render *re,
       if (G.is_break == false) {
         /* keep after file save */
         render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_POST);
-        render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
+        /* Frames which are still being written run the callback once they are saved. */
+        if (write_queue == NULL || write_queue->task == NULL) {
+          render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_WRITE);
+        }
       }
     }
   }
 
+  if (write_queue != NULL) {
+    if (!render_write_queue_finish(re, write_queue, scene)) {
+      G.is_break = true;
+    }
+    BLI_task_pool_free(write_queue->pool);
+  }
+
   /* end movie */
   if (is_movie) {
     re_movie_free_all(re, mh, totvideos);
@@ -2871,6 +3025,16 @@ RenderPass *RE_pass_find_by_name(volatile RenderLayer *rl, const char *name, con
   return rp;
 }
 
+/**
+ * Direct access to the pixels of a pass, so render engines can write their results into it
+ * without going through an intermediate buffer. \a r_len is the number of floats in the pass.
+ */
+float *RE_pass_rect_get(RenderPass *rpass, int *r_len)
+{
+  *r_len = rpass->rectx * rpass->recty * rpass->channels;
+  return rpass->rect;
+}
+
 /* Only provided for API compatibility, don't use this in new code! */
 RenderPass *RE_pass_find_by_type(volatile RenderLayer *rl, int passtype, const char *viewname)
 {
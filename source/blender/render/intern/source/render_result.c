@@ -28,6 +28,9 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
+#include "BLI_fileops.h"
 #include "BLI_ghash.h"
 #include "BLI_hash_md5.h"
 #include "BLI_listbase.h"
@@ -103,6 +106,10 @@ void render_result_free(RenderResult *res)
     MEM_freeN(rl);
   }
 
+  if (res->exrhandle) {
+    IMB_exr_close(res->exrhandle);
+  }
+
   render_result_views_free(res);
 
   if (res->rect32) {
@@ -213,6 +220,12 @@ static void set_pass_full_name(
 
 /********************************** New **************************************/
 
+static unsigned int render_result_serial_next(void)
+{
+  static unsigned int serial = 0;
+  return atomic_add_and_fetch_u(&serial, 1);
+}
+
 RenderPass *render_layer_add_pass(RenderResult *rr,
                                   RenderLayer *rl,
                                   int channels,
@@ -307,6 +320,7 @@ RenderResult *render_result_new(Render *re,
   rr = MEM_callocN(sizeof(RenderResult), "new render result");
   rr->rectx = rectx;
   rr->recty = recty;
+  rr->serial = render_result_serial_next();
   rr->renrect.xmin = 0;
   rr->renrect.xmax = rectx - 2 * crop;
   /* crop is one or two extra pixels rendered for filtering, is used for merging and display too */
@@ -745,20 +759,24 @@ static int order_render_passes(const void *a, const void *b)
 }
 
 /* From imbuf, if a handle was returned and
- * it's not a singlelayer multiview we convert this to render result. */
+ * it's not a singlelayer multiview we convert this to render result.
+ * Only the layers and passes are created, the render result takes ownership of the handle
+ * and reads the pixels of a layer when one of its passes is first used. */
 RenderResult *render_result_new_from_exr(
     void *exrhandle, const char *colorspace, bool predivide, int rectx, int recty)
 {
   RenderResult *rr = MEM_callocN(sizeof(RenderResult), __func__);
   RenderLayer *rl;
   RenderPass *rpass;
-  const char *to_colorspace = IMB_colormanagement_role_colorspace_name_get(
-      COLOR_ROLE_SCENE_LINEAR);
 
   rr->rectx = rectx;
   rr->recty = recty;
+  rr->serial = render_result_serial_next();
+  rr->exrhandle = exrhandle;
+  BLI_strncpy(rr->exr_colorspace, colorspace, sizeof(rr->exr_colorspace));
+  rr->exr_predivide = predivide;
 
-  IMB_exr_multilayer_convert(exrhandle, rr, ml_addview_cb, ml_addlayer_cb, ml_addpass_cb);
+  IMB_exr_multilayer_convert_lazy(exrhandle, rr, ml_addview_cb, ml_addlayer_cb, ml_addpass_cb);
 
   for (rl = rr->layers.first; rl; rl = rl->next) {
     rl->rectx = rectx;
@@ -769,20 +787,97 @@ RenderResult *render_result_new_from_exr(
     for (rpass = rl->passes.first; rpass; rpass = rpass->next) {
       rpass->rectx = rectx;
       rpass->recty = recty;
+    }
+  }
+
+  return rr;
+}
+
+/* Lazy loading may happen from any thread using the image. */
+static ThreadMutex exr_load_lock = BLI_MUTEX_INITIALIZER;
+
+typedef struct ExrLoadLayerData {
+  RenderLayer *rl;
+} ExrLoadLayerData;
+
+static float *ml_getpassrect_cb(void *base, const char *name, const char *view)
+{
+  ExrLoadLayerData *data = base;
+
+  for (RenderPass *rpass = data->rl->passes.first; rpass; rpass = rpass->next) {
+    if (STREQ(rpass->name, name) && STREQ(rpass->view, view)) {
+      return rpass->rect;
+    }
+  }
+  return NULL;
+}
+
+static void render_result_exr_load_layer(RenderResult *rr, RenderLayer *rl)
+{
+  const char *to_colorspace = IMB_colormanagement_role_colorspace_name_get(
+      COLOR_ROLE_SCENE_LINEAR);
+  ExrLoadLayerData data = {rl};
+  RenderPass *rpass;
+  bool need_load = false;
+
+  for (rpass = rl->passes.first; rpass; rpass = rpass->next) {
+    if (rpass->rect == NULL) {
+      rpass->rect = MEM_callocN(sizeof(float) * rpass->rectx * rpass->recty * rpass->channels,
+                                "loaded pass rect");
+      need_load = true;
+    }
+  }
+
+  if (!need_load) {
+    return;
+  }
+
+  IMB_exr_read_layer(rr->exrhandle, rl->name, &data, ml_getpassrect_cb);
 
-      if (rpass->channels >= 3) {
-        IMB_colormanagement_transform(rpass->rect,
-                                      rpass->rectx,
-                                      rpass->recty,
-                                      rpass->channels,
-                                      colorspace,
-                                      to_colorspace,
-                                      predivide);
+  for (rpass = rl->passes.first; rpass; rpass = rpass->next) {
+    if (rpass->channels >= 3) {
+      IMB_colormanagement_transform(rpass->rect,
+                                    rpass->rectx,
+                                    rpass->recty,
+                                    rpass->channels,
+                                    rr->exr_colorspace,
+                                    to_colorspace,
+                                    rr->exr_predivide);
+    }
+  }
+}
+
+/* Read the layer of a pass from the EXR file, if the render result was loaded from one. */
+void RE_pass_ensure_loaded(RenderResult *rr, RenderPass *rpass)
+{
+  if (rr == NULL || rpass == NULL || rr->exrhandle == NULL || rpass->rect != NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&exr_load_lock);
+  if (rpass->rect == NULL) {
+    for (RenderLayer *rl = rr->layers.first; rl; rl = rl->next) {
+      if (BLI_findindex(&rl->passes, rpass) != -1) {
+        render_result_exr_load_layer(rr, rl);
+        break;
       }
     }
   }
+  BLI_mutex_unlock(&exr_load_lock);
+}
 
-  return rr;
+/* Read all layers, for code accessing passes without #RE_pass_ensure_loaded. */
+void RE_render_result_ensure_loaded(RenderResult *rr)
+{
+  if (rr == NULL || rr->exrhandle == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&exr_load_lock);
+  for (RenderLayer *rl = rr->layers.first; rl; rl = rl->next) {
+    render_result_exr_load_layer(rr, rl);
+  }
+  BLI_mutex_unlock(&exr_load_lock);
 }
 
 void render_result_view_new(RenderResult *rr, const char *viewname)
@@ -1233,6 +1328,11 @@ void render_result_exr_file_begin(Render *re, RenderEngine *engine)
 {
   char str[FILE_MAX];
 
+  /* All passes must end up in the output file, which is only the case with a single layer. */
+  if (re->result->next || !BLI_listbase_is_single(&re->result->layers)) {
+    re->exr_stream_filepath[0] = '\0';
+  }
+
   for (RenderResult *rr = re->result; rr; rr = rr->next) {
     LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
       /* Get passes needed by engine. Normally we would wait for the
@@ -1253,9 +1353,30 @@ void render_result_exr_file_begin(Render *re, RenderEngine *engine)
       BLI_freelistN(&templates);
 
       /* Open EXR file for writing. */
+      if (re->exr_stream_filepath[0]) {
+        BLI_make_existing_file(re->exr_stream_filepath);
+        printf("write exr output file, %dx%d, %s\n",
+               rr->rectx,
+               rr->recty,
+               re->exr_stream_filepath);
+        if (IMB_exrtile_begin_write(rl->exrhandle,
+                                    re->exr_stream_filepath,
+                                    0,
+                                    rr->rectx,
+                                    rr->recty,
+                                    re->partx,
+                                    re->party,
+                                    re->r.im_format.exr_codec)) {
+          continue;
+        }
+        printf("cannot write: %s\n", re->exr_stream_filepath);
+        re->exr_stream_filepath[0] = '\0';
+      }
+
       render_result_exr_file_path(re->scene, rl->name, rr->sample_nr, str);
       printf("write exr tmp file, %dx%d, %s\n", rr->rectx, rr->recty, str);
-      IMB_exrtile_begin_write(rl->exrhandle, str, 0, rr->rectx, rr->recty, re->partx, re->party);
+      IMB_exrtile_begin_write(
+          rl->exrhandle, str, 0, rr->rectx, rr->recty, re->partx, re->party, R_IMF_EXR_CODEC_RLE);
     }
   }
 }
@@ -1273,6 +1394,27 @@ void render_result_exr_file_end(Render *re, RenderEngine *engine)
     rr->do_exr_tile = false;
   }
 
+  if (re->exr_stream_filepath[0]) {
+    /* Tiles were written to the output file, only keep the passes that are in memory
+     * instead of reading the file back. */
+    BLI_rw_mutex_lock(&re->resultmutex, THREAD_LOCK_WRITE);
+    for (RenderResult *rr = re->result; rr; rr = rr->next) {
+      LISTBASE_FOREACH (RenderLayer *, rl, &rr->layers) {
+        LISTBASE_FOREACH_MUTABLE (RenderPass *, rpass, &rl->passes) {
+          if (rpass->rect == NULL) {
+            BLI_remlink(&rl->passes, rpass);
+            MEM_freeN(rpass);
+          }
+        }
+      }
+    }
+    BLI_rw_mutex_unlock(&re->resultmutex);
+
+    re->exr_stream_written = true;
+    UNUSED_VARS(engine);
+    return;
+  }
+
   /* Create new render result in memory instead of on disk. */
   BLI_rw_mutex_lock(&re->resultmutex, THREAD_LOCK_WRITE);
   render_result_free_list(&re->fullresult, re->result);
@@ -1678,8 +1820,10 @@ static RenderView *duplicate_render_view(RenderView *rview)
 RenderResult *RE_DuplicateRenderResult(RenderResult *rr)
 {
   RenderResult *new_rr = MEM_mallocN(sizeof(RenderResult), "new duplicated render result");
+  RE_render_result_ensure_loaded(rr);
   *new_rr = *rr;
   new_rr->next = new_rr->prev = NULL;
+  new_rr->exrhandle = NULL;
   new_rr->layers.first = new_rr->layers.last = NULL;
   new_rr->views.first = new_rr->views.last = NULL;
   for (RenderLayer *rl = rr->layers.first; rl != NULL; rl = rl->next) {
@@ -29,6 +29,8 @@ void update_simulation_in_depsgraph(Depsgraph *depsgraph,
 
 bool update_simulation_dependencies(Simulation *simulation);
 
+void free_cached_simulation_influences(const Simulation *simulation_orig);
+
 }  // namespace blender::sim
 
 #endif /* __SIM_SIMULATION_UPDATE_HH__ */
@@ -34,6 +34,7 @@
 #  include "DNA_texture_types.h"
 
 #  include "BLI_math.h"
+#  include "BLI_task.h"
 #  include "BLI_utildefines.h"
 
 #  include "BKE_cloth.h"
@@ -638,6 +639,93 @@ DO_INLINE void mul_bfmatrix_lfvector(float (*to)[3], fmatrix3x3 *from, lfVector
   del_lfvector(temp);
 }
 
+/* Off-diagonal blocks touching each vertex, for multiplying big matrices that share the block
+ * layout with a long vector one vertex at a time. Blocks where the vertex is the row are stored
+ * as their index, blocks where it is the column as -(index + 1). */
+typedef struct BlockMap {
+  int *vert_offset; /* vcount + 1 */
+  int *vert_blocks; /* 2 * scount */
+  /* Number of blocks the map was built for, or -1 when the layout changed. */
+  int num_blocks;
+} BlockMap;
+
+static void block_map_build(BlockMap *map, fmatrix3x3 *matrix, int num_blocks)
+{
+  unsigned int vcount = matrix[0].vcount;
+  int *vert_offset = map->vert_offset;
+
+  memset(vert_offset, 0, sizeof(int) * (vcount + 1));
+  for (unsigned int i = vcount; i < vcount + num_blocks; i++) {
+    vert_offset[matrix[i].r + 1]++;
+    vert_offset[matrix[i].c + 1]++;
+  }
+  for (unsigned int i = 0; i < vcount; i++) {
+    vert_offset[i + 1] += vert_offset[i];
+  }
+
+  int *vert_fill = MEM_dupallocN(vert_offset);
+  for (unsigned int i = vcount; i < vcount + num_blocks; i++) {
+    map->vert_blocks[vert_fill[matrix[i].r]++] = (int)i;
+    map->vert_blocks[vert_fill[matrix[i].c]++] = -(int)i - 1;
+  }
+  MEM_freeN(vert_fill);
+
+  map->num_blocks = num_blocks;
+}
+
+typedef struct MulBlockMapData {
+  float (*to)[3];
+  fmatrix3x3 *from;
+  lfVector *fLongVector;
+  const BlockMap *map;
+} MulBlockMapData;
+
+static void mul_bfmatrix_lfvector_map_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MulBlockMapData *data = userdata;
+  fmatrix3x3 *from = data->from;
+  lfVector *fLongVector = data->fLongVector;
+  const BlockMap *map = data->map;
+  float *to = data->to[i];
+
+  /* Diagonal block. */
+  mul_v3_m3v3(to, from[i].m, fLongVector[i]);
+
+  for (int j = map->vert_offset[i]; j < map->vert_offset[i + 1]; j++) {
+    const int block = map->vert_blocks[j];
+    if (block >= 0) {
+      muladd_fmatrix_fvector(to, from[block].m, fLongVector[from[block].c]);
+    }
+    else {
+      /* This is the lower triangle of the sparse matrix,
+       * therefore multiplication occurs with transposed submatrices. */
+      muladd_fmatrixT_fvector(to, from[-block - 1].m, fLongVector[from[-block - 1].r]);
+    }
+  }
+}
+
+/* SPARSE SYMMETRIC multiply big matrix with long vector, in parallel over the vertices. Only uses
+ * the first map->num_blocks off-diagonal blocks, the others must be zero. */
+DO_INLINE void mul_bfmatrix_lfvector_map(float (*to)[3],
+                                         fmatrix3x3 *from,
+                                         lfVector *fLongVector,
+                                         const BlockMap *map)
+{
+  MulBlockMapData data = {
+      .to = to,
+      .from = from,
+      .fLongVector = fLongVector,
+      .map = map,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 512;
+  BLI_task_parallel_range(0, (int)from[0].vcount, &data, mul_bfmatrix_lfvector_map_cb, &settings);
+}
+
 /* SPARSE SYMMETRIC sub big matrix with big matrix*/
 /* A -= B * float + C * float --> for big matrix */
 /* VERIFIED */
@@ -677,6 +765,9 @@ typedef struct Implicit_Data {
   lfVector *z;          /* target velocity in constrained directions */
   fmatrix3x3 *S;        /* filtering matrix for constraints */
   fmatrix3x3 *P, *Pinv; /* pre-conditioning matrix */
+
+  /* Off-diagonal blocks per vertex, reused while the springs stay the same. */
+  BlockMap block_map;
 } Implicit_Data;
 
 Implicit_Data *SIM_mass_spring_solver_create(int numverts, int numsprings)
@@ -702,6 +793,11 @@ Implicit_Data *SIM_mass_spring_solver_create(int numverts, int numsprings)
   id->dV = create_lfvector(numverts);
   id->z = create_lfvector(numverts);
 
+  id->block_map.vert_offset = MEM_mallocN(sizeof(int) * (numverts + 1), "cloth block map");
+  id->block_map.vert_blocks = MEM_mallocN(sizeof(int) * 2 * max_ii(numsprings, 1),
+                                          "cloth block map");
+  id->block_map.num_blocks = -1;
+
   initdiag_bfmatrix(id->bigI, I);
 
   return id;
@@ -728,6 +824,9 @@ void SIM_mass_spring_solver_free(Implicit_Data *id)
   del_lfvector(id->dV);
   del_lfvector(id->z);
 
+  MEM_freeN(id->block_map.vert_offset);
+  MEM_freeN(id->block_map.vert_blocks);
+
   MEM_freeN(id);
 }
 
@@ -840,6 +939,7 @@ static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z,
 
 static int cg_filtered(lfVector *ldV,
                        fmatrix3x3 *lA,
+                       const BlockMap *map,
                        lfVector *lB,
                        lfVector *z,
                        fmatrix3x3 *S,
@@ -867,7 +967,7 @@ static int cg_filtered(lfVector *ldV,
   delta_target = conjgrad_epsilon * conjgrad_epsilon * bnorm2;
 
   /* r = filter(B - A * dV) */
-  mul_bfmatrix_lfvector(AdV, lA, ldV);
+  mul_bfmatrix_lfvector_map(AdV, lA, ldV, map);
   sub_lfvector_lfvector(r, lB, AdV, numverts);
   filter(r, S);
 
@@ -890,7 +990,7 @@ static int cg_filtered(lfVector *ldV,
 #  endif
 
   while (delta_new > delta_target && conjgrad_loopcount < conjgrad_looplimit) {
-    mul_bfmatrix_lfvector(q, lA, c);
+    mul_bfmatrix_lfvector_map(q, lA, c, map);
     filter(q, S);
 
     alpha = delta_new / dot_lfvector(c, q, numverts);
@@ -1150,7 +1250,12 @@ bool SIM_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 
   subadd_bfmatrixS_bfmatrixS(data->A, data->dFdV, dt, data->dFdX, (dt * dt));
 
-  mul_bfmatrix_lfvector(dFdXmV, data->dFdX, data->V);
+  /* All big matrices share the block layout, which only changes with the springs. */
+  if (data->block_map.num_blocks != data->num_blocks) {
+    block_map_build(&data->block_map, data->A, data->num_blocks);
+  }
+
+  mul_bfmatrix_lfvector_map(dFdXmV, data->dFdX, data->V, &data->block_map);
 
   add_lfvectorS_lfvectorS(data->B, data->F, dt, dFdXmV, (dt * dt), numverts);
 
@@ -1159,7 +1264,7 @@ bool SIM_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 #  endif
 
   /* Conjugate gradient algorithm to solve Ax=b. */
-  cg_filtered(data->dV, data->A, data->B, data->z, data->S, result);
+  cg_filtered(data->dV, data->A, &data->block_map, data->B, data->z, data->S, result);
 
   // cg_filtered_pre(id->dV, id->A, id->B, id->z, id->S, id->P, id->Pinv, id->bigI);
 
@@ -1279,6 +1384,10 @@ static int SIM_mass_spring_add_block(Implicit_Data *data, int v1, int v2)
   BLI_assert(s < data->M[0].vcount + data->M[0].scount);
   ++data->num_blocks;
 
+  if (data->A[s].r != v1 || data->A[s].c != v2) {
+    data->block_map.num_blocks = -1;
+  }
+
   /* tfm and S don't have spring entries (diagonal blocks only) */
   init_fmatrix(data->bigI + s, v1, v2);
   init_fmatrix(data->M + s, v1, v2);
@@ -18,22 +18,39 @@
 
 #include "BLI_rand.hh"
 
+#include <algorithm>
+
 namespace blender::sim {
 
 AttributesAllocator::~AttributesAllocator()
 {
-  for (std::unique_ptr<AttributesBlock> &block : allocated_blocks_) {
+  AttributesBlock *block = last_block_;
+  while (block != nullptr) {
     for (int i : attributes_info_.index_range()) {
       const fn::CPPType &type = attributes_info_.type_of(i);
       type.destruct_n(block->buffers[i], block->size);
       MEM_freeN(block->buffers[i]);
     }
+    AttributesBlock *next_block = block->next;
+    delete block;
+    block = next_block;
+  }
+}
+
+Vector<fn::MutableAttributesRef> AttributesAllocator::get_allocations() const
+{
+  Vector<fn::MutableAttributesRef> allocations;
+  for (AttributesBlock *block = last_block_; block != nullptr; block = block->next) {
+    allocations.append({attributes_info_, block->buffers, block->size});
   }
+  /* The list is built back to front. */
+  std::reverse(allocations.begin(), allocations.end());
+  return allocations;
 }
 
 fn::MutableAttributesRef AttributesAllocator::allocate_uninitialized(int size)
 {
-  std::unique_ptr<AttributesBlock> block = std::make_unique<AttributesBlock>();
+  AttributesBlock *block = new AttributesBlock();
   block->buffers = Array<void *>(attributes_info_.size(), nullptr);
   block->size = size;
 
@@ -45,12 +62,13 @@ fn::MutableAttributesRef AttributesAllocator::allocate_uninitialized(int size)
 
   fn::MutableAttributesRef attributes{attributes_info_, block->buffers, size};
 
-  {
-    std::lock_guard lock{mutex_};
-    allocated_blocks_.append(std::move(block));
-    allocated_attributes_.append(attributes);
-    total_allocated_ += size;
+  /* Push the block onto the list without locking, so that emitters on different threads don't
+   * have to wait for each other. */
+  block->next = last_block_.load(std::memory_order_relaxed);
+  while (!last_block_.compare_exchange_weak(
+      block->next, block, std::memory_order_release, std::memory_order_relaxed)) {
   }
+  total_allocated_.fetch_add(size, std::memory_order_relaxed);
 
   return attributes;
 }
@@ -23,7 +23,6 @@
 #include "FN_attributes_ref.hh"
 
 #include <atomic>
-#include <mutex>
 
 namespace blender::sim {
 
@@ -32,13 +31,13 @@ class AttributesAllocator : NonCopyable, NonMovable {
   struct AttributesBlock {
     Array<void *> buffers;
     int size;
+    /* Blocks form a singly linked list, so that new blocks can be added without a lock. */
+    AttributesBlock *next;
   };
 
   const fn::AttributesInfo &attributes_info_;
-  Vector<std::unique_ptr<AttributesBlock>> allocated_blocks_;
-  Vector<fn::MutableAttributesRef> allocated_attributes_;
-  int total_allocated_ = 0;
-  std::mutex mutex_;
+  std::atomic<AttributesBlock *> last_block_{nullptr};
+  std::atomic<int> total_allocated_{0};
 
  public:
   AttributesAllocator(const fn::AttributesInfo &attributes_info)
@@ -48,10 +47,11 @@ class AttributesAllocator : NonCopyable, NonMovable {
 
   ~AttributesAllocator();
 
-  Span<fn::MutableAttributesRef> get_allocations() const
-  {
-    return allocated_attributes_;
-  }
+  /**
+   * Returns the allocated attributes in the order they were allocated in. This must not be called
+   * while other threads are still allocating.
+   */
+  Vector<fn::MutableAttributesRef> get_allocations() const;
 
   int total_allocated() const
   {
@@ -83,7 +83,7 @@ class ParticleAllocator : NonCopyable, NonMovable {
     return attributes_allocator_.attributes_info();
   }
 
-  Span<fn::MutableAttributesRef> get_allocations() const
+  Vector<fn::MutableAttributesRef> get_allocations() const
   {
     return attributes_allocator_.get_allocations();
   }
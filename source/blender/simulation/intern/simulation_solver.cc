@@ -21,6 +21,7 @@
 
 #include "BLI_rand.hh"
 #include "BLI_set.hh"
+#include "BLI_task.h"
 
 #include "DEG_depsgraph_query.h"
 
@@ -337,6 +338,50 @@ BLI_NOINLINE static void simulate_particle_chunk(SimulationSolveContext &solve_c
   }
 }
 
+/**
+ * Particles are simulated independently of each other, so the attributes can be split up into
+ * chunks that are simulated on separate threads. Particles emitted by actions in the meantime are
+ * collected by the (thread-safe) particle allocators and merged into the state at the end of the
+ * time step.
+ */
+BLI_NOINLINE static void simulate_particles_in_chunks(SimulationSolveContext &solve_context,
+                                                      ParticleSimulationState &state,
+                                                      MutableAttributesRef attributes,
+                                                      MutableSpan<float> remaining_durations,
+                                                      float end_time)
+{
+  const int64_t particle_amount = attributes.size();
+  const int64_t chunk_size = 1000;
+  const int64_t chunks_num = (particle_amount + chunk_size - 1) / chunk_size;
+  if (chunks_num <= 1) {
+    simulate_particle_chunk(solve_context, state, attributes, remaining_durations, end_time);
+    return;
+  }
+
+  auto simulate_chunk = [&](const int chunk_index) {
+    const int64_t start = chunk_index * chunk_size;
+    const IndexRange range(start, std::min(chunk_size, particle_amount - start));
+    simulate_particle_chunk(solve_context,
+                            state,
+                            attributes.slice(range),
+                            remaining_durations.slice(range.start(), range.size()),
+                            end_time);
+  };
+  using SimulateChunkFn = decltype(simulate_chunk);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0,
+      (int)chunks_num,
+      &simulate_chunk,
+      [](void *__restrict userdata, const int chunk_index, const TaskParallelTLS *__restrict) {
+        (*static_cast<SimulateChunkFn *>(userdata))(chunk_index);
+      },
+      &settings);
+}
+
 BLI_NOINLINE static void simulate_existing_particles(SimulationSolveContext &solve_context,
                                                      ParticleSimulationState &state,
                                                      const AttributesInfo &attributes_info)
@@ -346,7 +391,7 @@ BLI_NOINLINE static void simulate_existing_particles(SimulationSolveContext &sol
   MutableAttributesRef attributes = custom_data_attributes;
 
   Array<float> remaining_durations(state.tot_particles, solve_context.solve_interval.duration());
-  simulate_particle_chunk(
+  simulate_particles_in_chunks(
       solve_context, state, attributes, remaining_durations, solve_context.solve_interval.stop());
 }
 
@@ -510,7 +555,8 @@ void solve_simulation_time_step(Simulation &simulation,
       for (int i : attributes.index_range()) {
         remaining_durations[i] = end_time - birth_times[i];
       }
-      simulate_particle_chunk(solve_context, *state, attributes, remaining_durations, end_time);
+      simulate_particles_in_chunks(
+          solve_context, *state, attributes, remaining_durations, end_time);
     }
 
     remove_dead_and_add_new_particles(*state, allocator);
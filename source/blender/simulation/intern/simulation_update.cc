@@ -18,10 +18,12 @@
 
 #include "BKE_customdata.h"
 #include "BKE_lib_id.h"
+#include "BKE_node.h"
 #include "BKE_object.h"
 #include "BKE_simulation.h"
 
 #include "DNA_modifier_types.h"
+#include "DNA_node_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_simulation_types.h"
 
@@ -41,6 +43,10 @@
 #include "simulation_collect_influences.hh"
 #include "simulation_solver.hh"
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
 namespace blender::sim {
 
 static void copy_states_to_cow(const Simulation *simulation_orig, Simulation *simulation_cow)
@@ -219,6 +225,92 @@ static void prepare_dependency_animations(Depsgraph &depsgraph,
   }
 }
 
+/**
+ * Collecting the influences requires expanding the node tree and building a multi-function network
+ * from it, which can take a while when node groups are nested deeply. The result only depends on
+ * the node trees, so it is reused across frames until one of the evaluated trees changes.
+ */
+struct CollectedSimulationInfluences : NonCopyable, NonMovable {
+  /** Identifies the evaluated node trees the influences have been collected from. */
+  Vector<int> tree_generations;
+  ResourceCollector resources;
+  SimulationInfluences influences;
+  RequiredStates required_states;
+};
+
+using InfluencesCache = Map<const Simulation *, std::shared_ptr<CollectedSimulationInfluences>>;
+
+static InfluencesCache &get_influences_cache()
+{
+  static InfluencesCache cache;
+  return cache;
+}
+
+static std::mutex &get_influences_cache_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+/* Returns false when the influences should not be cached. */
+static bool find_tree_generations(const bNodeTree &ntree, Vector<int> &r_generations)
+{
+  /* Animated values change without the tree being copied again. */
+  if (ntree.adt != nullptr) {
+    return false;
+  }
+  r_generations.append(ntree.copy_generation);
+  LISTBASE_FOREACH (const bNode *, node, &ntree.nodes) {
+    if (node->type == NODE_GROUP && node->id != nullptr) {
+      if (!find_tree_generations(*(const bNodeTree *)node->id, r_generations)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static std::shared_ptr<const CollectedSimulationInfluences> get_simulation_influences(
+    const Simulation *simulation_orig, Simulation *simulation_cow)
+{
+  Vector<int> tree_generations;
+  const bool use_cache = find_tree_generations(*simulation_cow->nodetree, tree_generations);
+
+  if (use_cache) {
+    std::lock_guard lock{get_influences_cache_mutex()};
+    std::shared_ptr<CollectedSimulationInfluences> cached =
+        get_influences_cache().lookup_default(simulation_orig, {});
+    if (cached && cached->tree_generations.size() == tree_generations.size() &&
+        std::equal(tree_generations.begin(),
+                   tree_generations.end(),
+                   cached->tree_generations.begin())) {
+      return cached;
+    }
+  }
+
+  auto collected = std::make_shared<CollectedSimulationInfluences>();
+  collect_simulation_influences(*simulation_cow,
+                                collected->resources,
+                                collected->influences,
+                                collected->required_states);
+  collected->tree_generations = std::move(tree_generations);
+
+  std::lock_guard lock{get_influences_cache_mutex()};
+  if (use_cache) {
+    get_influences_cache().add_overwrite(simulation_orig, collected);
+  }
+  else {
+    get_influences_cache().remove(simulation_orig);
+  }
+  return collected;
+}
+
+void free_cached_simulation_influences(const Simulation *simulation_orig)
+{
+  std::lock_guard lock{get_influences_cache_mutex()};
+  get_influences_cache().remove(simulation_orig);
+}
+
 void update_simulation_in_depsgraph(Depsgraph *depsgraph,
                                     Scene *scene_cow,
                                     Simulation *simulation_cow)
@@ -235,11 +327,10 @@ void update_simulation_in_depsgraph(Depsgraph *depsgraph,
 
   Simulation *simulation_orig = (Simulation *)DEG_get_original_id(&simulation_cow->id);
 
-  ResourceCollector resources;
-  SimulationInfluences influences;
-  RequiredStates required_states;
-
-  collect_simulation_influences(*simulation_cow, resources, influences, required_states);
+  std::shared_ptr<const CollectedSimulationInfluences> collected = get_simulation_influences(
+      simulation_orig, simulation_cow);
+  const SimulationInfluences &influences = collected->influences;
+  const RequiredStates &required_states = collected->required_states;
 
   bke::PersistentDataHandleMap handle_map;
   LISTBASE_FOREACH (SimulationDependency *, dependency, &simulation_orig->dependencies) {
@@ -4307,6 +4307,22 @@ static wmEvent *wm_event_add_mousemove(wmWindow *win, const wmEvent *event)
 {
   wmEvent *event_last = win->queue.last;
 
+  /* Coalesce motion: when the only queued event is a mouse move and no modal handler is
+   * running (strokes, gestures, active buttons...), nothing can use the in-between positions,
+   * so move the queued event instead of handling (and redrawing for) each one.
+   * Tablet motion is always kept for the full stroke history. */
+  if (event_last && event_last->type == MOUSEMOVE && event_last == win->queue.first &&
+      BLI_listbase_is_empty(&win->modalhandlers) &&
+      (event->tablet.active == EVT_TABLET_NONE) &&
+      (event_last->tablet.active == EVT_TABLET_NONE)) {
+    int prev_xy[2];
+    copy_v2_v2_int(prev_xy, &event_last->prevx);
+    *event_last = *event;
+    event_last->next = event_last->prev = NULL;
+    copy_v2_v2_int(&event_last->prevx, prev_xy);
+    return event_last;
+  }
+
   /* some painting operators want accurate mouse events, they can
    * handle in between mouse move moves, others can happily ignore
    * them for better performance */
@@ -46,7 +46,6 @@
 #  include <shlobj.h>
 #endif
 
-#include "MEM_CacheLimiterC-Api.h"
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
@@ -77,6 +76,7 @@
 #include "BKE_context.h"
 #include "BKE_global.h"
 #include "BKE_idprop.h"
+#include "BKE_image.h"
 #include "BKE_lib_id.h"
 #include "BKE_lib_override.h"
 #include "BKE_main.h"
@@ -402,7 +402,7 @@ static void wm_init_userdef(Main *bmain)
     SET_FLAG_FROM_TEST(G.f, (U.flag & USER_SCRIPT_AUTOEXEC_DISABLE) == 0, G_FLAG_SCRIPT_AUTOEXEC);
   }
 
-  MEM_CacheLimiter_set_maximum(((size_t)U.memcachelimit) * 1024 * 1024);
+  BKE_blender_userdef_memcache_limits_update();
   BKE_sound_init(bmain);
 
   /* update tempdir from user preferences */
@@ -629,6 +629,12 @@ static void wm_file_read_post(bContext *C,
      * before evaluating the depsgraph. */
     wm_event_do_depsgraph(C, true);
 
+    if (!G.background) {
+      /* Load the textures of the visible objects in parallel, instead of one after the other
+       * while drawing. */
+      BKE_image_preload_view_layer(CTX_data_scene(C), CTX_data_view_layer(C));
+    }
+
     ED_editors_init(C);
 
 #if 1
@@ -1633,8 +1639,15 @@ void wm_autosave_timer(Main *bmain, wmWindowManager *wm, wmTimer *UNUSED(wt))
 
     ED_editors_flush_edits(bmain);
 
-    /* Error reporting into console. */
-    BLO_write_file(bmain, filepath, fileflags, &(const struct BlendFileWriteParams){0}, NULL);
+    /* Error reporting into console.
+     * Auto-save overwrites the same file over and over, only write what changed. */
+    BLO_write_file(bmain,
+                   filepath,
+                   fileflags,
+                   &(const struct BlendFileWriteParams){
+                       .use_incremental = true,
+                   },
+                   NULL);
   }
   /* do timer after file write, just in case file write takes a long time */
   wm->autosavetimer = WM_event_add_timer(wm, NULL, TIMERAUTOSAVE, U.savetime * 60.0);
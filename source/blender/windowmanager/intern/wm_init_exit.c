@@ -222,6 +222,9 @@ static void sound_jack_sync_callback(Main *bmain, int mode, double time)
 /* only called once, for startup */
 void WM_init(bContext *C, int argc, const char **argv)
 {
+  /* Background jobs like farm renders skip initialization only needed by the UI,
+   * or defer it until first used. */
+  const bool use_fast_start = G.background && G.background_fast_start;
 
   if (!G.background) {
     wm_ghost_init(C); /* note: it assigns C to ghost! */
@@ -282,8 +285,11 @@ void WM_init(bContext *C, int argc, const char **argv)
   const bool use_userdef = true;
 
   /* Studio-lights needs to be init before we read the home-file,
-   * otherwise the versioning cannot find the default studio-light. */
-  BKE_studiolight_init();
+   * otherwise the versioning cannot find the default studio-light.
+   * With fast start they are initialized by the first lookup instead. */
+  if (!use_fast_start) {
+    BKE_studiolight_init();
+  }
 
   BLI_assert((G.fileflags & G_FILE_NO_UI) == 0);
 
@@ -301,7 +307,7 @@ void WM_init(bContext *C, int argc, const char **argv)
   BLT_lang_set(NULL);
 
   /* For fsMenu. Called here so can include user preference paths if needed. */
-  ED_file_init();
+  ED_file_init(!use_fast_start);
 
   /* That one is generated on demand, we need to be sure it's clear on init. */
   IMB_thumb_clear_translations();
@@ -350,7 +356,10 @@ void WM_init(bContext *C, int argc, const char **argv)
 
   // GPU_blend_set_func(GPU_SRC_ALPHA, GPU_ONE_MINUS_SRC_ALPHA, GPU_ONE, GPU_ONE_MINUS_SRC_ALPHA);
 
-  wm_history_file_read();
+  /* Recent files are only shown in the UI, and never written in background mode. */
+  if (!use_fast_start) {
+    wm_history_file_read();
+  }
 
   /* allow a path of "", this is what happens when making a new file */
 #if 0
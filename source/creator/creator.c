@@ -287,16 +287,26 @@ int main(int argc,
    */
   {
     int i;
+    bool use_guarded_allocator = false, use_threadcache_allocator = false;
     for (i = 0; i < argc; i++) {
       if (STR_ELEM(argv[i], "-d", "--debug", "--debug-memory", "--debug-all")) {
-        printf("Switching to fully guarded memory allocator.\n");
-        MEM_use_guarded_allocator();
-        break;
+        use_guarded_allocator = true;
+      }
+      else if (STREQ(argv[i], "--memory-thread-cache")) {
+        use_threadcache_allocator = true;
       }
       else if (STREQ(argv[i], "--")) {
         break;
       }
     }
+    /* Memory debugging takes precedence. */
+    if (use_guarded_allocator) {
+      printf("Switching to fully guarded memory allocator.\n");
+      MEM_use_guarded_allocator();
+    }
+    else if (use_threadcache_allocator) {
+      MEM_use_threadcache_allocator(true);
+    }
     MEM_init_memleak_detection();
   }
 
@@ -40,11 +40,13 @@
 #  include "BLI_string.h"
 #  include "BLI_string_utf8.h"
 #  include "BLI_system.h"
+#  include "BLI_task.h"
 #  include "BLI_threads.h"
 #  include "BLI_utildefines.h"
 
 #  include "BLO_readfile.h" /* only for BLO_has_bfile_extension */
 
+#  include "BKE_blender.h"
 #  include "BKE_blender_version.h"
 #  include "BKE_context.h"
 
@@ -526,6 +528,8 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_argsPrintArgDoc(ba, "--render-output");
   BLI_argsPrintArgDoc(ba, "--engine");
   BLI_argsPrintArgDoc(ba, "--threads");
+  BLI_argsPrintArgDoc(ba, "--numa");
+  BLI_argsPrintArgDoc(ba, "--numa-range-min");
 
   printf("\n");
   printf("Format Options:\n");
@@ -597,9 +601,11 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-no-threads");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-time");
   BLI_argsPrintArgDoc(ba, "--debug-depsgraph-pretty");
+  BLI_argsPrintArgDoc(ba, "--debug-depsgraph-trace");
   BLI_argsPrintArgDoc(ba, "--debug-gpu");
   BLI_argsPrintArgDoc(ba, "--debug-gpumem");
   BLI_argsPrintArgDoc(ba, "--debug-gpu-shaders");
+  BLI_argsPrintArgDoc(ba, "--debug-gpu-timings");
   BLI_argsPrintArgDoc(ba, "--debug-gpu-force-workarounds");
   BLI_argsPrintArgDoc(ba, "--debug-wm");
 #  ifdef WITH_XR_OPENXR
@@ -619,6 +625,8 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_argsPrintArgDoc(ba, "--app-template");
   BLI_argsPrintArgDoc(ba, "--factory-startup");
   BLI_argsPrintArgDoc(ba, "--enable-event-simulate");
+  BLI_argsPrintArgDoc(ba, "--memory-thread-cache");
+  BLI_argsPrintArgDoc(ba, "--background-fast-start");
   printf("\n");
   BLI_argsPrintArgDoc(ba, "--env-system-datafiles");
   BLI_argsPrintArgDoc(ba, "--env-system-scripts");
@@ -981,6 +989,10 @@ static const char arg_handle_debug_mode_generic_set_doc_depsgraph_pretty[] =
 static const char arg_handle_debug_mode_generic_set_doc_gpumem[] =
     "\n\t"
     "Enable GPU memory stats in status bar.";
+static const char arg_handle_debug_mode_generic_set_doc_gpu_timings[] =
+    "\n\t"
+    "Record the GPU time of every draw pass, available from Python (bpy.app.gpu_timings)\n"
+    "\tand written to 'blender_gpu_timings.json' in the temporary directory.";
 
 static int arg_handle_debug_mode_generic_set(int UNUSED(argc),
                                              const char **UNUSED(argv),
@@ -1080,6 +1092,33 @@ static int arg_handle_debug_value_set(int argc, const char **argv, void *UNUSED(
   }
 }
 
+static void callback_debug_depsgraph_trace_end(void *UNUSED(user_data))
+{
+  DEG_debug_trace_end();
+}
+
+static const char arg_handle_debug_depsgraph_trace_set_doc[] =
+    "<filepath>\n"
+    "\tWrite a trace of dependency graph evaluation to <filepath>,\n"
+    "\tin the Chrome trace event format (can be opened in 'chrome://tracing' or Perfetto).";
+static int arg_handle_debug_depsgraph_trace_set(int argc, const char **argv, void *UNUSED(data))
+{
+  if (argc > 1) {
+    if (DEG_debug_trace_begin(argv[1])) {
+      BKE_blender_atexit_unregister(callback_debug_depsgraph_trace_end, NULL);
+      BKE_blender_atexit_register(callback_debug_depsgraph_trace_end, NULL);
+    }
+    else {
+      printf("\nError: unable to open depsgraph trace file '%s'.\n", argv[1]);
+    }
+    return 1;
+  }
+  else {
+    printf("\nError: you must specify a file path after '--debug-depsgraph-trace'.\n");
+    return 0;
+  }
+}
+
 static const char arg_handle_debug_fpe_set_doc[] =
     "\n\t"
     "Enable floating point exceptions.";
@@ -1107,6 +1146,32 @@ static int arg_handle_app_template(int argc, const char **argv, void *UNUSED(dat
   }
 }
 
+static const char arg_handle_memory_thread_cache_set_doc[] =
+    "\n\t"
+    "Use per-thread memory counters and caches of small memory blocks,\n"
+    "\tto reduce contention when many threads allocate memory at once.";
+static int arg_handle_memory_thread_cache_set(int UNUSED(argc),
+                                              const char **UNUSED(argv),
+                                              void *UNUSED(data))
+{
+  /* The allocator is switched in 'main', before any allocation happens. */
+  return 0;
+}
+
+static const char arg_handle_background_fast_start_set_doc[] =
+    "\n\t"
+    "In background mode, skip initialization only needed by the user interface,\n"
+    "\tand only enable render engine add-ons at startup.\n"
+    "\tOther enabled add-ons are imported and registered on first use,\n"
+    "\twhen calling an operator that does not exist yet.";
+static int arg_handle_background_fast_start_set(int UNUSED(argc),
+                                                const char **UNUSED(argv),
+                                                void *UNUSED(data))
+{
+  G.background_fast_start = true;
+  return 0;
+}
+
 static const char arg_handle_factory_startup_set_doc[] =
     "\n\t"
     "Skip reading the " STRINGIFY(BLENDER_STARTUP_FILE) " in the users home directory.";
@@ -1481,6 +1546,45 @@ static int arg_handle_threads_set(int argc, const char **argv, void *UNUSED(data
   }
 }
 
+static const char arg_handle_numa_set_doc[] =
+    "\n\t"
+    "On systems with multiple NUMA nodes, process large parallel loops\n"
+    "\twith one part per node, each on the processors of that node.";
+static int arg_handle_numa_set(int UNUSED(argc), const char **UNUSED(argv), void *UNUSED(data))
+{
+  BLI_task_scheduler_numa_set(true);
+  return 0;
+}
+
+static const char arg_handle_numa_range_min_set_doc[] =
+    "<items>\n"
+    "\tMinimum number of items of a parallel loop to split it between NUMA nodes (default 65536).";
+static int arg_handle_numa_range_min_set(int argc, const char **argv, void *UNUSED(data))
+{
+  const char *arg_id = "--numa-range-min";
+  const int min = 1, max = INT_MAX;
+  if (argc > 1) {
+    const char *err_msg = NULL;
+    int range_min;
+    if (!parse_int_strict_range(argv[1], NULL, min, max, &range_min, &err_msg)) {
+      printf("\nError: %s '%s %s', expected number in [%d..%d].\n",
+             err_msg,
+             arg_id,
+             argv[1],
+             min,
+             max);
+      return 1;
+    }
+
+    BLI_task_scheduler_numa_range_min_set(range_min);
+    return 1;
+  }
+  else {
+    printf("\nError: you must specify a number of items '%s'.\n", arg_id);
+    return 0;
+  }
+}
+
 static const char arg_handle_verbosity_set_doc[] =
     "<verbose>\n"
     "\tSet the logging verbosity level for debug messages that support it.";
@@ -2189,6 +2293,12 @@ void main_args_setup(bContext *C, bArgs *ba)
               "--debug-depsgraph-pretty",
               CB_EX(arg_handle_debug_mode_generic_set, depsgraph_pretty),
               (void *)G_DEBUG_DEPSGRAPH_PRETTY);
+  BLI_argsAdd(ba,
+              1,
+              NULL,
+              "--debug-depsgraph-trace",
+              CB(arg_handle_debug_depsgraph_trace_set),
+              NULL);
   BLI_argsAdd(ba,
               1,
               NULL,
@@ -2207,6 +2317,12 @@ void main_args_setup(bContext *C, bArgs *ba)
               "--debug-gpu-shaders",
               CB_EX(arg_handle_debug_mode_generic_set, gpumem),
               (void *)G_DEBUG_GPU_SHADERS);
+  BLI_argsAdd(ba,
+              1,
+              NULL,
+              "--debug-gpu-timings",
+              CB_EX(arg_handle_debug_mode_generic_set, gpu_timings),
+              (void *)G_DEBUG_GPU_TIMINGS);
   BLI_argsAdd(ba,
               1,
               NULL,
@@ -2218,6 +2334,9 @@ void main_args_setup(bContext *C, bArgs *ba)
 
   BLI_argsAdd(ba, 1, NULL, "--app-template", CB(arg_handle_app_template), NULL);
   BLI_argsAdd(ba, 1, NULL, "--factory-startup", CB(arg_handle_factory_startup_set), NULL);
+  BLI_argsAdd(ba, 1, NULL, "--memory-thread-cache", CB(arg_handle_memory_thread_cache_set), NULL);
+  BLI_argsAdd(
+      ba, 1, NULL, "--background-fast-start", CB(arg_handle_background_fast_start_set), NULL);
   BLI_argsAdd(ba, 1, NULL, "--enable-event-simulate", CB(arg_handle_enable_event_simulate), NULL);
 
   /* TODO, add user env vars? */
@@ -2264,6 +2383,8 @@ void main_args_setup(bContext *C, bArgs *ba)
 
   BLI_argsAdd(ba, 4, "-F", "--render-format", CB(arg_handle_image_type_set), C);
   BLI_argsAdd(ba, 1, "-t", "--threads", CB(arg_handle_threads_set), NULL);
+  BLI_argsAdd(ba, 1, NULL, "--numa", CB(arg_handle_numa_set), NULL);
+  BLI_argsAdd(ba, 1, NULL, "--numa-range-min", CB(arg_handle_numa_range_min_set), NULL);
   BLI_argsAdd(ba, 4, "-x", "--use-extension", CB(arg_handle_extension_set), C);
 
 #  undef CB
@@ -0,0 +1,634 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_ghash.h"
+#include "BLI_map.hh"
+#include "BLI_probing_strategies.hh"
+#include "BLI_rand.hh"
+#include "BLI_set.hh"
+#include "BLI_timeit.hh"
+#include "BLI_utildefines.h"
+#include "BLI_vector.hh"
+#include "BLI_vector_set.hh"
+
+/**
+ * Benchmarks of the C++ containers of blenlib,
+ * compared to #GHash / #GSet and the standard library.
+ *
+ * Every measurement is printed as one CSV line starting with `benchmark,`, so the results can be
+ * extracted with `grep '^benchmark,'`. The columns are:
+ * `benchmark,container,keys,operation,size,fill,seconds`.
+ *
+ * Hash tables are filled with a fraction (`fill`) of a power of two elements. Since the Blender
+ * containers keep their max load factor at 1/2, `fill` is also their load at the end of the
+ * insertions, the other tables have their own load factors and just get the same keys.
+ */
+
+/* Number of elements, as power of two, `fill` is relative to that. */
+#define BENCHMARK_SIZE_BIT 20
+
+/* Run each measurement several times, to get a feeling for the noise. */
+#define BENCHMARK_REPEAT 2
+
+namespace blender::tests {
+
+static const float benchmark_fills[] = {0.26f, 0.38f, 0.49f};
+
+static void print_header()
+{
+  static bool is_printed = false;
+  if (!is_printed) {
+    printf("benchmark,container,keys,operation,size,fill,seconds\n");
+    is_printed = true;
+  }
+}
+
+static void print_result(const char *container,
+                         const char *keys,
+                         const char *operation,
+                         const int64_t size,
+                         const float fill,
+                         const double seconds)
+{
+  printf("benchmark,%s,%s,%s,%" PRId64 ",%.2f,%.6f\n",
+         container,
+         keys,
+         operation,
+         size,
+         fill,
+         seconds);
+}
+
+template<typename FuncT> static double time_seconds(const FuncT &func)
+{
+  const timeit::TimePoint start = timeit::Clock::now();
+  func();
+  const timeit::Nanoseconds duration = timeit::Clock::now() - start;
+  return (double)duration.count() * 1e-9;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Keys
+ *
+ * Random ints are close to the best case for hash tables, strided ints have their lower bits
+ * all zero (like pointers or offsets), which hurts tables that only use the lower bits of
+ * their hash. Strings are slower to hash and compare, and are not stored inline.
+ * \{ */
+
+#define STRIDED_INT_STRIDE (3 << 10)
+
+static Vector<int> keys_random_int(const int64_t size, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Vector<int> keys(size);
+  for (int &key : keys) {
+    key = rng.get_int32();
+  }
+  return keys;
+}
+
+/** \param offset: Use an offset smaller than the stride to get keys that are not in the table. */
+static Vector<int> keys_strided_int(const int64_t size, const int offset)
+{
+  Vector<int> keys(size);
+  for (const int64_t i : keys.index_range()) {
+    keys[i] = (int)i * STRIDED_INT_STRIDE + offset;
+  }
+  return keys;
+}
+
+static Vector<std::string> keys_string(const int64_t size, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Vector<std::string> keys;
+  keys.reserve(size);
+  for (int64_t i = 0; i < size; i++) {
+    keys.append("key_" + std::to_string(rng.get_int32()));
+  }
+  return keys;
+}
+
+static int64_t key_weight(const int key)
+{
+  return key;
+}
+
+static int64_t key_weight(const std::string &key)
+{
+  return (int64_t)key.size();
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Containers
+ *
+ * Thin wrappers giving all containers the same interface. Maps store the index of the first
+ * insertion of each key, sets only store the keys. #add never overwrites an existing value.
+ * \{ */
+
+template<typename Key> static GHash *ghash_new_for_keys();
+template<> GHash *ghash_new_for_keys<int>()
+{
+  return BLI_ghash_int_new(__func__);
+}
+template<> GHash *ghash_new_for_keys<std::string>()
+{
+  return BLI_ghash_str_new(__func__);
+}
+
+template<typename Key> static GSet *gset_new_for_keys();
+template<> GSet *gset_new_for_keys<int>()
+{
+  return BLI_gset_int_new(__func__);
+}
+template<> GSet *gset_new_for_keys<std::string>()
+{
+  return BLI_gset_str_new(__func__);
+}
+
+/* The keys outlive the tables, so the string buffers can be used as keys directly. */
+static void *ghash_key(const int key)
+{
+  return POINTER_FROM_INT(key);
+}
+
+static void *ghash_key(const std::string &key)
+{
+  return (void *)key.c_str();
+}
+
+template<typename Key, typename MapT> class BlenderMapBenchmark {
+ private:
+  MapT map_;
+
+ public:
+  void add(const Key &key, const int value)
+  {
+    map_.add(key, value);
+  }
+
+  int64_t lookup(const Key &key) const
+  {
+    const int *value = map_.lookup_ptr(key);
+    return value ? *value : -1;
+  }
+
+  int64_t sum() const
+  {
+    int64_t sum = 0;
+    for (const int value : map_.values()) {
+      sum += value;
+    }
+    return sum;
+  }
+
+  bool remove(const Key &key)
+  {
+    return map_.remove(key);
+  }
+};
+
+template<typename Key> class StdMapBenchmark {
+ private:
+  std::unordered_map<Key, int, DefaultHash<Key>> map_;
+
+ public:
+  void add(const Key &key, const int value)
+  {
+    map_.insert({key, value});
+  }
+
+  int64_t lookup(const Key &key) const
+  {
+    const auto it = map_.find(key);
+    return (it != map_.end()) ? it->second : -1;
+  }
+
+  int64_t sum() const
+  {
+    int64_t sum = 0;
+    for (const auto &item : map_) {
+      sum += item.second;
+    }
+    return sum;
+  }
+
+  bool remove(const Key &key)
+  {
+    return map_.erase(key) != 0;
+  }
+};
+
+template<typename Key> class GHashBenchmark {
+ private:
+  GHash *ghash_;
+
+ public:
+  GHashBenchmark() : ghash_(ghash_new_for_keys<Key>())
+  {
+  }
+
+  ~GHashBenchmark()
+  {
+    BLI_ghash_free(ghash_, nullptr, nullptr);
+  }
+
+  void add(const Key &key, const int value)
+  {
+    void **value_p;
+    if (!BLI_ghash_ensure_p(ghash_, ghash_key(key), &value_p)) {
+      *value_p = POINTER_FROM_INT(value);
+    }
+  }
+
+  int64_t lookup(const Key &key) const
+  {
+    void **value_p = BLI_ghash_lookup_p(ghash_, ghash_key(key));
+    return value_p ? POINTER_AS_INT(*value_p) : -1;
+  }
+
+  int64_t sum() const
+  {
+    int64_t sum = 0;
+    GHashIterator gh_iter;
+    GHASH_ITER (gh_iter, ghash_) {
+      sum += POINTER_AS_INT(BLI_ghashIterator_getValue(&gh_iter));
+    }
+    return sum;
+  }
+
+  bool remove(const Key &key)
+  {
+    return BLI_ghash_remove(ghash_, ghash_key(key), nullptr, nullptr);
+  }
+};
+
+template<typename Key, typename SetT> class BlenderSetBenchmark {
+ private:
+  SetT set_;
+
+ public:
+  void add(const Key &key, const int UNUSED(value))
+  {
+    set_.add(key);
+  }
+
+  int64_t lookup(const Key &key) const
+  {
+    return set_.contains(key) ? 1 : 0;
+  }
+
+  int64_t sum() const
+  {
+    int64_t sum = 0;
+    for (const Key &key : set_) {
+      sum += key_weight(key);
+    }
+    return sum;
+  }
+
+  bool remove(const Key &key)
+  {
+    return set_.remove(key);
+  }
+};
+
+template<typename Key> class StdSetBenchmark {
+ private:
+  std::unordered_set<Key, DefaultHash<Key>> set_;
+
+ public:
+  void add(const Key &key, const int UNUSED(value))
+  {
+    set_.insert(key);
+  }
+
+  int64_t lookup(const Key &key) const
+  {
+    return (set_.find(key) != set_.end()) ? 1 : 0;
+  }
+
+  int64_t sum() const
+  {
+    int64_t sum = 0;
+    for (const Key &key : set_) {
+      sum += key_weight(key);
+    }
+    return sum;
+  }
+
+  bool remove(const Key &key)
+  {
+    return set_.erase(key) != 0;
+  }
+};
+
+template<typename Key> class GSetBenchmark {
+ private:
+  GSet *gset_;
+
+ public:
+  GSetBenchmark() : gset_(gset_new_for_keys<Key>())
+  {
+  }
+
+  ~GSetBenchmark()
+  {
+    BLI_gset_free(gset_, nullptr);
+  }
+
+  void add(const Key &key, const int UNUSED(value))
+  {
+    BLI_gset_add(gset_, ghash_key(key));
+  }
+
+  int64_t lookup(const Key &key) const
+  {
+    return BLI_gset_haskey(gset_, ghash_key(key)) ? 1 : 0;
+  }
+
+  int64_t sum() const
+  {
+    int64_t sum = 0;
+    GSetIterator gs_iter;
+    GSET_ITER (gs_iter, gset_) {
+      const void *key = BLI_gsetIterator_getKey(&gs_iter);
+      if constexpr (std::is_same_v<Key, int>) {
+        sum += key_weight(POINTER_AS_INT(key));
+      }
+      else {
+        sum += key_weight(std::string((const char *)key));
+      }
+    }
+    return sum;
+  }
+
+  bool remove(const Key &key)
+  {
+    return BLI_gset_remove(gset_, ghash_key(key), nullptr);
+  }
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Hash Table Benchmarks
+ * \{ */
+
+/**
+ * Run all operations on one container type.
+ * \return A checksum of the results, which has to match between containers with the same keys.
+ */
+template<typename Key, typename BenchmarkT>
+static int64_t benchmark_hash_table(const char *container,
+                                    const char *keys_name,
+                                    Span<Key> keys,
+                                    Span<Key> miss_keys,
+                                    const float fill)
+{
+  int64_t checksum = 0;
+
+  for (int repeat = 0; repeat < BENCHMARK_REPEAT; repeat++) {
+    BenchmarkT table;
+    const int64_t size = keys.size();
+    checksum = 0;
+
+    print_result(container, keys_name, "add", size, fill, time_seconds([&]() {
+                   for (const int64_t i : keys.index_range()) {
+                     table.add(keys[i], (int)i);
+                   }
+                 }));
+    print_result(container, keys_name, "lookup", size, fill, time_seconds([&]() {
+                   for (const Key &key : keys) {
+                     checksum += table.lookup(key);
+                   }
+                 }));
+    print_result(container, keys_name, "lookup_miss", size, fill, time_seconds([&]() {
+                   for (const Key &key : miss_keys) {
+                     checksum += table.lookup(key);
+                   }
+                 }));
+    print_result(container, keys_name, "iterate", size, fill, time_seconds([&]() {
+                   checksum += table.sum();
+                 }));
+    print_result(container, keys_name, "remove", size, fill, time_seconds([&]() {
+                   for (const Key &key : keys) {
+                     checksum += table.remove(key);
+                   }
+                 }));
+  }
+
+  return checksum;
+}
+
+template<typename Key, typename ProbingStrategy>
+using MapBenchmark = BlenderMapBenchmark<Key, Map<Key, int, 4, ProbingStrategy>>;
+
+template<typename Key>
+static void benchmark_maps(const char *keys_name, Span<Key> keys, Span<Key> miss_keys, float fill)
+{
+  const int64_t checksum = benchmark_hash_table<Key, MapBenchmark<Key, PythonProbingStrategy<>>>(
+      "Map<Python>", keys_name, keys, miss_keys, fill);
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, MapBenchmark<Key, PythonProbingStrategy<1, true>>>(
+                "Map<PythonPreShuffle>", keys_name, keys, miss_keys, fill)));
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, MapBenchmark<Key, ShuffleProbingStrategy<>>>(
+                "Map<Shuffle>", keys_name, keys, miss_keys, fill)));
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, MapBenchmark<Key, QuadraticProbingStrategy>>(
+                "Map<Quadratic>", keys_name, keys, miss_keys, fill)));
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, MapBenchmark<Key, LinearProbingStrategy>>(
+                "Map<Linear>", keys_name, keys, miss_keys, fill)));
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, GHashBenchmark<Key>>(
+                "GHash", keys_name, keys, miss_keys, fill)));
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, StdMapBenchmark<Key>>(
+                "std::unordered_map", keys_name, keys, miss_keys, fill)));
+}
+
+template<typename Key>
+static void benchmark_sets(const char *keys_name, Span<Key> keys, Span<Key> miss_keys, float fill)
+{
+  const int64_t checksum = benchmark_hash_table<Key, BlenderSetBenchmark<Key, Set<Key>>>(
+      "Set<Python>", keys_name, keys, miss_keys, fill);
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, BlenderSetBenchmark<Key, VectorSet<Key>>>(
+                "VectorSet<Python>", keys_name, keys, miss_keys, fill)));
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, GSetBenchmark<Key>>(
+                "GSet", keys_name, keys, miss_keys, fill)));
+  EXPECT_EQ(checksum,
+            (benchmark_hash_table<Key, StdSetBenchmark<Key>>(
+                "std::unordered_set", keys_name, keys, miss_keys, fill)));
+}
+
+static int64_t benchmark_size(const float fill)
+{
+  return (int64_t)((float)(1 << BENCHMARK_SIZE_BIT) * fill);
+}
+
+TEST(containers_performance, MapRandomInt)
+{
+  print_header();
+  for (const float fill : benchmark_fills) {
+    const int64_t size = benchmark_size(fill);
+    const Vector<int> keys = keys_random_int(size, 0);
+    const Vector<int> miss_keys = keys_random_int(size, 1);
+    benchmark_maps<int>("random_int", keys, miss_keys, fill);
+  }
+}
+
+TEST(containers_performance, MapStridedInt)
+{
+  print_header();
+  for (const float fill : benchmark_fills) {
+    const int64_t size = benchmark_size(fill);
+    const Vector<int> keys = keys_strided_int(size, 0);
+    const Vector<int> miss_keys = keys_strided_int(size, 1);
+    benchmark_maps<int>("strided_int", keys, miss_keys, fill);
+  }
+}
+
+TEST(containers_performance, MapString)
+{
+  print_header();
+  for (const float fill : benchmark_fills) {
+    const int64_t size = benchmark_size(fill);
+    const Vector<std::string> keys = keys_string(size, 0);
+    const Vector<std::string> miss_keys = keys_string(size, 1);
+    benchmark_maps<std::string>("string", keys, miss_keys, fill);
+  }
+}
+
+TEST(containers_performance, SetRandomInt)
+{
+  print_header();
+  for (const float fill : benchmark_fills) {
+    const int64_t size = benchmark_size(fill);
+    const Vector<int> keys = keys_random_int(size, 0);
+    const Vector<int> miss_keys = keys_random_int(size, 1);
+    benchmark_sets<int>("random_int", keys, miss_keys, fill);
+  }
+}
+
+TEST(containers_performance, SetStridedInt)
+{
+  print_header();
+  for (const float fill : benchmark_fills) {
+    const int64_t size = benchmark_size(fill);
+    const Vector<int> keys = keys_strided_int(size, 0);
+    const Vector<int> miss_keys = keys_strided_int(size, 1);
+    benchmark_sets<int>("strided_int", keys, miss_keys, fill);
+  }
+}
+
+TEST(containers_performance, SetString)
+{
+  print_header();
+  for (const float fill : benchmark_fills) {
+    const int64_t size = benchmark_size(fill);
+    const Vector<std::string> keys = keys_string(size, 0);
+    const Vector<std::string> miss_keys = keys_string(size, 1);
+    benchmark_sets<std::string>("string", keys, miss_keys, fill);
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Vector Benchmarks
+ * \{ */
+
+template<typename Key, typename VectorT>
+static int64_t benchmark_vector(const char *container, const char *keys_name, Span<Key> keys)
+{
+  const int64_t size = keys.size();
+  int64_t checksum = 0;
+
+  RandomNumberGenerator rng(0);
+  Vector<int64_t> indices(size);
+  for (int64_t &index : indices) {
+    index = (int64_t)(rng.get_uint32() % (uint32_t)size);
+  }
+
+  for (int repeat = 0; repeat < BENCHMARK_REPEAT; repeat++) {
+    checksum = 0;
+    {
+      VectorT vector;
+      print_result(container, keys_name, "append", size, 1.0f, time_seconds([&]() {
+                     for (const Key &key : keys) {
+                       vector.push_back(key);
+                     }
+                   }));
+    }
+
+    VectorT vector;
+    print_result(container, keys_name, "append_reserved", size, 1.0f, time_seconds([&]() {
+                   vector.reserve(size);
+                   for (const Key &key : keys) {
+                     vector.push_back(key);
+                   }
+                 }));
+    print_result(container, keys_name, "iterate", size, 1.0f, time_seconds([&]() {
+                   for (const Key &key : vector) {
+                     checksum += key_weight(key);
+                   }
+                 }));
+    print_result(container, keys_name, "random_access", size, 1.0f, time_seconds([&]() {
+                   for (const int64_t index : indices) {
+                     checksum += key_weight(vector[index]);
+                   }
+                 }));
+  }
+
+  return checksum;
+}
+
+/** Adds `push_back` to #blender::Vector, to use the same code for both vector types. */
+template<typename Key> class BlenderVectorBenchmark : public Vector<Key> {
+ public:
+  void push_back(const Key &key)
+  {
+    this->append(key);
+  }
+};
+
+TEST(containers_performance, Vector)
+{
+  print_header();
+  const int64_t size = 1 << BENCHMARK_SIZE_BIT;
+  {
+    const Vector<int> keys = keys_random_int(size, 0);
+    const int64_t checksum = benchmark_vector<int, BlenderVectorBenchmark<int>>(
+        "Vector", "random_int", keys);
+    EXPECT_EQ(checksum,
+              (benchmark_vector<int, std::vector<int>>("std::vector", "random_int", keys)));
+  }
+  {
+    const Vector<std::string> keys = keys_string(size, 0);
+    const int64_t checksum = benchmark_vector<std::string, BlenderVectorBenchmark<std::string>>(
+        "Vector", "string", keys);
+    EXPECT_EQ(checksum,
+              (benchmark_vector<std::string, std::vector<std::string>>(
+                  "std::vector", "string", keys)));
+  }
+}
+
+/** \} */
+
+}  // namespace blender::tests
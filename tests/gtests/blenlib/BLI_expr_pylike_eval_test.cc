@@ -111,6 +111,10 @@ TEST_PARSE_FAIL(Truncated7, "1 and")
 TEST_PARSE_FAIL(Truncated8, "1 or")
 TEST_PARSE_FAIL(Truncated9, "sqrt(1")
 TEST_PARSE_FAIL(Truncated10, "fmod(1,")
+TEST_PARSE_FAIL(Truncated11, "2 **")
+TEST_PARSE_FAIL(Truncated12, "2 //")
+TEST_PARSE_FAIL(Truncated13, "2 %")
+TEST_PARSE_FAIL(TriplePow, "2 *** 2")
 
 /* Constant expression with working constant folding */
 #define TEST_CONST(name, str, value) \
@@ -143,6 +147,8 @@ TEST_CONST(TenE, "1.e+1", 10.0)
 TEST_CONST(Half, ".5", 0.5)
 
 TEST_CONST(Pi, "pi", M_PI)
+TEST_CONST(Tau, "tau", 2.0 * M_PI)
+TEST_CONST(E, "e", M_E)
 TEST_CONST(True, "True", TRUE_VAL)
 TEST_CONST(False, "False", FALSE_VAL)
 
@@ -156,6 +162,19 @@ TEST_CONST(Pow, "pow(4, 0.5)", 2.0)
 TEST_EVAL(Pow, "pow(4, x)", 0.5, 2.0)
 
 TEST_CONST(Log2_1, "log(4, 2)", 2.0)
+TEST_CONST(Log2_2, "log2(8)", 3.0)
+TEST_CONST(Log10, "log10(1000)", 3.0)
+
+TEST_CONST(Hypot, "hypot(3, 4)", 5.0)
+TEST_EVAL(Hypot, "hypot(x, 4)", 3, 5.0)
+
+TEST_CONST(CopySign, "copysign(2, -1)", -2.0)
+TEST_EVAL(CopySign, "copysign(2, x)", -0.5, -2.0)
+
+TEST_CONST(Sinh, "sinh(0)", 0.0)
+TEST_CONST(Cosh, "cosh(0)", 1.0)
+TEST_CONST(Tanh, "tanh(0)", 0.0)
+TEST_CONST(Atanh, "atanh(tanh(0.5))", 0.5)
 
 TEST_CONST(Round1, "round(-0.5)", -1.0)
 TEST_CONST(Round2, "round(-0.4)", 0.0)
@@ -205,10 +224,28 @@ TEST_EVAL(BinaryMul, "x*3", 2, 6.0)
 TEST_CONST(BinaryDiv, "3/2", 1.5)
 TEST_EVAL(BinaryDiv, "3/x", 2, 1.5)
 
+TEST_CONST(BinaryFloorDiv1, "7//2", 3.0)
+TEST_CONST(BinaryFloorDiv2, "-7//2", -4.0)
+TEST_EVAL(BinaryFloorDiv, "x//2", 7.5, 3.0)
+
+TEST_CONST(BinaryMod1, "7%3", 1.0)
+TEST_CONST(BinaryMod2, "-7%3", 2.0)
+TEST_CONST(BinaryMod3, "7%-3", -2.0)
+TEST_CONST(BinaryMod4, "-7%-3", -1.0)
+TEST_EVAL(BinaryMod, "x%360", -90, 270.0)
+
+TEST_CONST(BinaryPow1, "2**3", 8.0)
+TEST_CONST(BinaryPow2, "2**3**2", 512.0)
+TEST_CONST(BinaryPow3, "-2**2", -4.0)
+TEST_CONST(BinaryPow4, "2**-1", 0.5)
+TEST_CONST(BinaryPow5, "(-2)**2", 4.0)
+TEST_EVAL(BinaryPow, "x**2", 3, 9.0)
+
 TEST_CONST(Arith1, "1 + -2 * 3", -5.0)
 TEST_CONST(Arith2, "(1 + -2) * 3", -3.0)
 TEST_CONST(Arith3, "-1 + 2 * 3", 5.0)
 TEST_CONST(Arith4, "3 * (-2 + 1)", -3.0)
+TEST_CONST(Arith5, "1 + 2 * 3 ** 2 % 5", 4.0)
 
 TEST_EVAL(Arith1, "1 + -x * 3", 2, -5.0)
 
@@ -329,6 +366,7 @@ TEST_ERROR(DivZero1, "0 / 0", 0.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(DivZero2, "1 / 0", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 TEST_ERROR(DivZero3, "1 / x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 TEST_ERROR(DivZero4, "1 / x", 1.0, EXPR_PYLIKE_SUCCESS)
+TEST_ERROR(DivZero5, "1 // x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 
 TEST_ERROR(SqrtDomain1, "sqrt(-1)", 0.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(SqrtDomain2, "sqrt(x)", -1.0, EXPR_PYLIKE_MATH_ERROR)
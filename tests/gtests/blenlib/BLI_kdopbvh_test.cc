@@ -134,3 +134,103 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+static void find_nearest_callback(void *userdata,
+                                  int index,
+                                  const float co[3],
+                                  BVHTreeNearest *nearest)
+{
+  float(*points)[3] = (float(*)[3])userdata;
+  const float dist_sq = len_squared_v3v3(co, points[index]);
+  if (dist_sq < nearest->dist_sq) {
+    nearest->index = index;
+    nearest->dist_sq = dist_sq;
+    copy_v3_v3(nearest->co, points[index]);
+  }
+}
+
+/* Batched queries must find the same points as individual ones. */
+static void find_nearest_batch_test(int points_len, int random_seed)
+{
+  struct RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  float(*cos)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * points_len,
+                                                          __func__);
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(cos[i], 3, rng, 1000, 1.0f);
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+  }
+
+  BLI_bvhtree_find_nearest_batch(
+      tree, (const float(*)[3])cos, points_len, nearest, find_nearest_callback, points, 0);
+
+  for (int i = 0; i < points_len; i++) {
+    BVHTreeNearest nearest_single;
+    nearest_single.index = -1;
+    nearest_single.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, cos[i], &nearest_single, find_nearest_callback, points);
+
+    EXPECT_GE(nearest[i].index, 0);
+    EXPECT_EQ(nearest_single.dist_sq, nearest[i].dist_sq);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(cos);
+  MEM_freeN(nearest);
+}
+
+TEST(kdopbvh, FindNearestBatch_1)
+{
+  find_nearest_batch_test(1, 1234);
+}
+TEST(kdopbvh, FindNearestBatch_5000)
+{
+  find_nearest_batch_test(5000, 12);
+}
+
+/* Refitting a tree after moving its points must give the same results as building a new one. */
+TEST(kdopbvh, UpdateTree)
+{
+  const int points_len = 5000;
+  struct RNG *rng = BLI_rng_new(1234);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 4, 8);
+
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_update_node(tree, i, points[i], NULL, 1);
+  }
+  BLI_bvhtree_update_tree(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    BVHTreeNearest nearest;
+    nearest.index = -1;
+    nearest.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, points[i], &nearest, find_nearest_callback, points);
+    EXPECT_EQ(0.0f, nearest.dist_sq);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+}
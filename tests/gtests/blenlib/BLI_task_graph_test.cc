@@ -186,3 +186,44 @@ TEST(task, GraphTaskData)
   EXPECT_EQ(1, data.value);
   EXPECT_EQ(0, data.store);
 }
+
+struct CancelData {
+  TaskCancelToken *token;
+  int value;
+};
+
+static void CancelData_increase_and_cancel(void *taskdata)
+{
+  CancelData *data = (CancelData *)taskdata;
+  data->value += 1;
+  BLI_task_cancel_token_cancel(data->token);
+}
+
+TEST(task, GraphCancel)
+{
+  CancelData data = {BLI_task_cancel_token_create(), 0};
+  TaskGraph *graph = BLI_task_graph_create_ex(TASK_PRIORITY_INTERACTIVE, data.token);
+  TaskNode *node_a = BLI_task_graph_node_create(
+      graph, CancelData_increase_and_cancel, &data, NULL);
+  TaskNode *node_b = BLI_task_graph_node_create(
+      graph, CancelData_increase_and_cancel, &data, NULL);
+  BLI_task_graph_edge_create(node_a, node_b);
+
+  /* Successors of the canceling node are skipped. */
+  EXPECT_TRUE(BLI_task_graph_node_push_work(node_a));
+  BLI_task_graph_work_and_wait(graph);
+  EXPECT_EQ(1, data.value);
+
+  /* Nothing runs until the token is reset. */
+  EXPECT_TRUE(BLI_task_graph_node_push_work(node_a));
+  BLI_task_graph_work_and_wait(graph);
+  EXPECT_EQ(1, data.value);
+
+  BLI_task_cancel_token_reset(data.token);
+  EXPECT_TRUE(BLI_task_graph_node_push_work(node_b));
+  BLI_task_graph_work_and_wait(graph);
+  EXPECT_EQ(2, data.value);
+
+  BLI_task_graph_free(graph);
+  BLI_task_cancel_token_free(data.token);
+}
@@ -0,0 +1,199 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_appdir.h"
+#include "BKE_customdata.h"
+#include "BKE_global.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+
+#include "BLO_readfile.h"
+#include "BLO_undofile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_sdna_types.h"
+
+class BlendfileWritingTest : public BlendfileLoadingBaseTest {
+ protected:
+  char filepath[FILE_MAX];
+
+  static void SetUpTestCase()
+  {
+    BlendfileLoadingBaseTest::SetUpTestCase();
+    /* Session directory, removed again in #BlendfileLoadingBaseTest::TearDownTestCase. */
+    BKE_tempdir_init(NULL);
+  }
+
+  virtual void SetUp()
+  {
+    BLI_path_join(
+        filepath, sizeof(filepath), BKE_tempdir_session(), "blendfile_write_test.blend", NULL);
+  }
+
+  virtual void TearDown()
+  {
+    BLI_delete(filepath, false, false);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  /* Write a file with a single mesh, large enough to be split over multiple compressed frames. */
+  bool blendfile_write_mesh(const int totvert,
+                            const int write_flags,
+                            const bool use_incremental = false,
+                            const float offset = 0.0f)
+  {
+    Main *bmain = BKE_main_new();
+    Mesh *me = BKE_mesh_add(bmain, "Mesh");
+    me->totvert = totvert;
+    me->mvert = (MVert *)CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, totvert);
+    for (int i = 0; i < totvert; i++) {
+      me->mvert[i].co[0] = (float)i;
+      me->mvert[i].co[1] = (float)(i % 7);
+      me->mvert[i].co[2] = (float)(i % 13);
+    }
+    me->mvert[totvert / 2].co[0] += offset;
+
+    BlendFileWriteParams params = {BLO_WRITE_PATH_REMAP_NONE};
+    params.use_incremental = use_incremental;
+    const bool ok = BLO_write_file(bmain, filepath, write_flags, &params, NULL);
+    BKE_main_free(bmain);
+    return ok;
+  }
+
+  void blendfile_check_mesh(const int totvert, const float offset = 0.0f)
+  {
+    bfile = BLO_read_from_file(filepath, BLO_READ_SKIP_NONE, NULL);
+    ASSERT_NE(nullptr, bfile);
+
+    Mesh *me = (Mesh *)bfile->main->meshes.first;
+    ASSERT_NE(nullptr, me);
+    ASSERT_EQ(totvert, me->totvert);
+    ASSERT_NE(nullptr, me->mvert);
+    for (int i = 0; i < totvert; i++) {
+      EXPECT_EQ((float)i + ((i == totvert / 2) ? offset : 0.0f), me->mvert[i].co[0]);
+      EXPECT_EQ((float)(i % 7), me->mvert[i].co[1]);
+      EXPECT_EQ((float)(i % 13), me->mvert[i].co[2]);
+    }
+  }
+};
+
+TEST_F(BlendfileWritingTest, Uncompressed)
+{
+  const int totvert = 1000;
+  ASSERT_TRUE(blendfile_write_mesh(totvert, 0));
+  blendfile_check_mesh(totvert);
+}
+
+TEST_F(BlendfileWritingTest, Compressed)
+{
+  /* About 10MB of vertices. */
+  const int totvert = 500000;
+  ASSERT_TRUE(blendfile_write_mesh(totvert, G_FILE_COMPRESS));
+  blendfile_check_mesh(totvert);
+}
+
+TEST_F(BlendfileWritingTest, CompressedGzipCompatible)
+{
+  const int totvert = 500000;
+  ASSERT_TRUE(blendfile_write_mesh(totvert, G_FILE_COMPRESS));
+
+  /* Frames & index must decompress as a regular gzip stream, ending with the #ENDB block. */
+  int data_len;
+  char *data = BLI_file_ungzip_to_mem(filepath, &data_len);
+  ASSERT_NE(nullptr, data);
+  ASSERT_GT(data_len, totvert * (int)sizeof(MVert));
+  EXPECT_EQ(0, memcmp(data, "BLENDER", 7));
+  EXPECT_EQ(0, memcmp(data + data_len - sizeof(BHead), "ENDB", 4));
+  MEM_freeN(data);
+}
+
+TEST_F(BlendfileWritingTest, Incremental)
+{
+  const int totvert = 100000;
+  ASSERT_TRUE(blendfile_write_mesh(totvert, 0));
+
+  /* Update a single vertex in place. */
+  ASSERT_TRUE(blendfile_write_mesh(totvert, 0, true, 0.5f));
+  blendfile_check_mesh(totvert, 0.5f);
+  BLO_blendfiledata_free(bfile);
+  bfile = nullptr;
+
+  /* Smaller file, the remaining data must be truncated. */
+  ASSERT_TRUE(blendfile_write_mesh(totvert / 2, 0, true));
+  EXPECT_LT(BLI_file_size(filepath), (size_t)totvert * sizeof(MVert));
+  blendfile_check_mesh(totvert / 2);
+}
+
+TEST_F(BlendfileWritingTest, MemFileSharedChunks)
+{
+  const size_t blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  const int totvert = 100000;
+  const size_t mvert_size = totvert * sizeof(MVert);
+  Main *bmain = BKE_main_new();
+  Mesh *me = BKE_mesh_add(bmain, "Mesh");
+  me->totvert = totvert;
+  me->mvert = (MVert *)CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, totvert);
+  for (int i = 0; i < totvert; i++) {
+    me->mvert[i].co[0] = (float)i;
+  }
+
+  MemFile memfile_a = {{0}};
+  MemFile memfile_b = {{0}};
+  MemFile memfile_c = {{0}};
+  ASSERT_TRUE(BLO_write_file_mem(bmain, NULL, &memfile_a, 0));
+  BLO_memfile_wait(&memfile_a);
+  EXPECT_GT(memfile_a.size, mvert_size);
+
+  /* Only the changed part of the vertices is stored again. */
+  me->mvert[0].co[0] = -1.0f;
+  ASSERT_TRUE(BLO_write_file_mem(bmain, &memfile_a, &memfile_b, 0));
+  BLO_memfile_wait(&memfile_b);
+  EXPECT_LT(memfile_b.size, mvert_size);
+
+  /* Reverting the change shares the memory of the first step, even though it differs from the
+   * step it's written after. */
+  me->mvert[0].co[0] = 0.0f;
+  ASSERT_TRUE(BLO_write_file_mem(bmain, &memfile_b, &memfile_c, 0));
+  /* Content is shared in the background. */
+  BLO_memfile_wait(&memfile_c);
+  EXPECT_LT(memfile_c.size, memfile_b.size);
+
+  /* Removing the first step keeps memory used by the others. */
+  BLO_memfile_merge(&memfile_a, &memfile_b);
+  size_t memfile_c_len = 0;
+  LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile_c.chunks) {
+    memfile_c_len += chunk->size;
+  }
+  EXPECT_GT(memfile_c_len, mvert_size);
+
+  BLO_memfile_free(&memfile_b);
+  BLO_memfile_free(&memfile_c);
+  BKE_main_free(bmain);
+
+  EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+}
@@ -4,6 +4,13 @@
 #include "BLI_utildefines.h"
 #include "bmesh.h"
 
+#include "BKE_customdata.h"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
 TEST(bmesh_core, BMVertCreate)
 {
   BMesh *bm;
@@ -38,3 +45,84 @@ TEST(bmesh_core, BMVertCreate)
   EXPECT_EQ(BM_mesh_elem_count(bm, BM_VERT), 3);
   BM_mesh_free(bm);
 }
+
+TEST(bmesh_core, MeshConvertCustomData)
+{
+  BKE_idtype_init();
+
+  BMeshCreateParams bm_params;
+  bm_params.use_toolflags = false;
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bm_params);
+  BM_data_layer_add(bm, &bm->vdata, CD_PROP_FLOAT);
+  BM_data_layer_add(bm, &bm->ldata, CD_MLOOPUV);
+  BM_data_layer_add(bm, &bm->ldata, CD_MLOOPUV);
+
+  BMVert *verts[4];
+  for (int i = 0; i < 4; i++) {
+    const float co[3] = {(float)(i & 1), (float)(i >> 1), 0.0f};
+    verts[i] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+    BM_elem_float_data_set(&bm->vdata, verts[i], CD_PROP_FLOAT, (float)i);
+  }
+  BMVert *quad[4] = {verts[0], verts[1], verts[3], verts[2]};
+  BMFace *f = BM_face_create_verts(bm, quad, 4, NULL, BM_CREATE_NOP, true);
+  ASSERT_TRUE(f != NULL);
+
+  const int cd_uv_offset_a = CustomData_get_n_offset(&bm->ldata, CD_MLOOPUV, 0);
+  const int cd_uv_offset_b = CustomData_get_n_offset(&bm->ldata, CD_MLOOPUV, 1);
+  BMLoop *l_iter = BM_FACE_FIRST_LOOP(f);
+  for (int i = 0; i < 4; i++, l_iter = l_iter->next) {
+    ((MLoopUV *)BM_ELEM_CD_GET_VOID_P(l_iter, cd_uv_offset_a))->uv[0] = (float)i;
+    ((MLoopUV *)BM_ELEM_CD_GET_VOID_P(l_iter, cd_uv_offset_b))->uv[0] = (float)-i;
+  }
+
+  Mesh *me = (Mesh *)BKE_id_new_nomain(ID_ME, NULL);
+  BM_mesh_bm_to_me_for_eval(bm, me, NULL);
+  EXPECT_EQ(me->totvert, 4);
+  EXPECT_EQ(me->totloop, 4);
+
+  const float *values = (const float *)CustomData_get_layer(&me->vdata, CD_PROP_FLOAT);
+  const MLoopUV *uv_a = (const MLoopUV *)CustomData_get_layer_n(&me->ldata, CD_MLOOPUV, 0);
+  const MLoopUV *uv_b = (const MLoopUV *)CustomData_get_layer_n(&me->ldata, CD_MLOOPUV, 1);
+  ASSERT_TRUE(values != NULL && uv_a != NULL && uv_b != NULL);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(values[i], (float)i);
+    EXPECT_EQ(uv_a[i].uv[0], (float)i);
+    EXPECT_EQ(uv_b[i].uv[0], (float)-i);
+  }
+
+  /* Convert back. */
+  BMesh *bm_copy = BM_mesh_create(&bm_mesh_allocsize_default, &bm_params);
+  BMeshFromMeshParams from_me_params = {0};
+  from_me_params.calc_face_normal = true;
+  BM_mesh_bm_from_me(bm_copy, me, &from_me_params);
+  EXPECT_EQ(bm_copy->totvert, 4);
+  EXPECT_EQ(bm_copy->totface, 1);
+
+  BMVert *v;
+  BMIter iter;
+  int i;
+  BM_ITER_MESH_INDEX (v, &iter, bm_copy, BM_VERTS_OF_MESH, i) {
+    EXPECT_EQ(BM_elem_float_data_get(&bm_copy->vdata, v, CD_PROP_FLOAT), (float)i);
+  }
+  BMFace *f_copy = BM_face_at_index_find(bm_copy, 0);
+  EXPECT_EQ(f_copy->no[2], 1.0f);
+  l_iter = BM_FACE_FIRST_LOOP(f_copy);
+  for (i = 0; i < 4; i++, l_iter = l_iter->next) {
+    const int cd_uv_offset = CustomData_get_n_offset(&bm_copy->ldata, CD_MLOOPUV, 1);
+    EXPECT_EQ(((MLoopUV *)BM_ELEM_CD_GET_VOID_P(l_iter, cd_uv_offset))->uv[0], (float)-i);
+  }
+
+  /* Writing back unchanged data keeps the arrays. */
+  const void *uv_layer = CustomData_get_layer_n(&me->ldata, CD_MLOOPUV, 1);
+  const void *values_layer = CustomData_get_layer(&me->vdata, CD_PROP_FLOAT);
+  BM_elem_float_data_set(&bm_copy->vdata, BM_vert_at_index_find(bm_copy, 0), CD_PROP_FLOAT, 9.0f);
+  BMeshToMeshParams to_me_params = {0};
+  BM_mesh_bm_to_me(NULL, bm_copy, me, &to_me_params);
+  EXPECT_EQ(uv_layer, CustomData_get_layer_n(&me->ldata, CD_MLOOPUV, 1));
+  EXPECT_NE(values_layer, CustomData_get_layer(&me->vdata, CD_PROP_FLOAT));
+  EXPECT_EQ(((const float *)CustomData_get_layer(&me->vdata, CD_PROP_FLOAT))[0], 9.0f);
+
+  BM_mesh_free(bm_copy);
+  BKE_id_free(NULL, me);
+  BM_mesh_free(bm);
+}
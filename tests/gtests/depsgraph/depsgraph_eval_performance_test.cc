@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "blendfile_loading_base_test.h"
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "BKE_global.h"
+#include "BKE_main.h"
+#include "BKE_scene.h"
+
+#include "BLI_listbase.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "BLO_readfile.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_debug.h"
+#include "DEG_depsgraph_query.h"
+
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "PIL_time.h"
+
+DEFINE_string(benchmark_files,
+              "modifier_stack/array_test.blend",
+              "Comma separated list of blend files to evaluate, relative to the test assets dir.");
+DEFINE_int32(benchmark_frames, 50, "Number of frames to evaluate, from the scene start frame.");
+DEFINE_int32(benchmark_threads, 1, "Number of threads used for evaluation.");
+DEFINE_string(benchmark_output, "", "File to append the report to, standard output when empty.");
+
+/* Times accumulated over all frames, in seconds, keyed and sorted by name so that the report
+ * of two runs can be compared line by line. */
+struct EvalTimes {
+  double total = 0.0;
+  std::map<std::string, double> components;
+  std::map<std::string, double> modifiers;
+};
+
+static void eval_times_add_component(void *user_data,
+                                     const char *id_name,
+                                     const char *component_name,
+                                     double time)
+{
+  EvalTimes *times = static_cast<EvalTimes *>(user_data);
+  times->components[std::string(id_name) + "\t" + component_name] += time;
+}
+
+class DepsgraphEvalPerformanceTest : public BlendfileLoadingBaseTest {
+ public:
+  static void SetUpTestCase()
+  {
+    BlendfileLoadingBaseTest::SetUpTestCase();
+
+    /* Fixed thread count, so that timings of different runs are comparable. */
+    BLI_system_num_threads_override_set(FLAGS_benchmark_threads);
+    BLI_task_scheduler_init();
+
+    /* Gather per operation timing during evaluation. */
+    G.debug |= G_DEBUG_DEPSGRAPH_TIME;
+  }
+
+  static void TearDownTestCase()
+  {
+    G.debug &= ~G_DEBUG_DEPSGRAPH_TIME;
+
+    BLI_task_scheduler_exit();
+    BLI_system_num_threads_override_set(0);
+
+    BlendfileLoadingBaseTest::TearDownTestCase();
+  }
+
+ protected:
+  /* Add the time spent in the modifiers of all evaluated objects, and reset it so objects which
+   * are not evaluated on the next frame aren't counted twice. */
+  void gather_modifier_times(EvalTimes *times)
+  {
+    LISTBASE_FOREACH (Object *, ob, &bfile->main->objects) {
+      Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob);
+      if (ob_eval == nullptr || !DEG_is_evaluated_object(ob_eval)) {
+        continue;
+      }
+      LISTBASE_FOREACH (ModifierData *, md, &ob_eval->modifiers) {
+        if (md->execution_time != 0.0f) {
+          times->modifiers[std::string(ob->id.name) + "\t" + md->name] += md->execution_time;
+          md->execution_time = 0.0f;
+        }
+      }
+    }
+  }
+
+  void evaluate_frames(EvalTimes *times)
+  {
+    Main *bmain = bfile->main;
+    Scene *scene = bfile->curscene;
+    const int start_frame = scene->r.sfra;
+
+    for (int i = 0; i < FLAGS_benchmark_frames; i++) {
+      scene->r.cfra = start_frame + i;
+
+      const double start_time = PIL_check_seconds_timer();
+      BKE_scene_graph_update_for_newframe(depsgraph, bmain);
+      times->total += PIL_check_seconds_timer() - start_time;
+
+      DEG_stats_foreach_component_time(depsgraph, eval_times_add_component, times);
+      gather_modifier_times(times);
+    }
+  }
+
+  /* One tab separated entry per line, see #EvalTimes. */
+  static void write_report(const std::string &filepath, const EvalTimes &times)
+  {
+    std::ostringstream report;
+    report.setf(std::ios::fixed);
+    report.precision(6);
+    report << "file\t" << filepath << "\n";
+    report << "frames\t" << FLAGS_benchmark_frames << "\n";
+    report << "threads\t" << FLAGS_benchmark_threads << "\n";
+    report << "total\t" << times.total << "\n";
+    for (const auto &item : times.components) {
+      report << "component\t" << item.first << "\t" << item.second << "\n";
+    }
+    for (const auto &item : times.modifiers) {
+      report << "modifier\t" << item.first << "\t" << item.second << "\n";
+    }
+
+    if (FLAGS_benchmark_output.empty()) {
+      fputs(report.str().c_str(), stdout);
+      return;
+    }
+    FILE *file = fopen(FLAGS_benchmark_output.c_str(), "a");
+    ASSERT_NE(file, nullptr) << "Unable to open " << FLAGS_benchmark_output;
+    fputs(report.str().c_str(), file);
+    fclose(file);
+  }
+};
+
+TEST_F(DepsgraphEvalPerformanceTest, EvaluateFrames)
+{
+  std::istringstream files(FLAGS_benchmark_files);
+  std::string filepath;
+  while (std::getline(files, filepath, ',')) {
+    if (filepath.empty()) {
+      continue;
+    }
+    if (!blendfile_load(filepath.c_str())) {
+      return;
+    }
+    depsgraph_create(DAG_EVAL_VIEWPORT);
+
+    EvalTimes times;
+    evaluate_frames(&times);
+    write_report(filepath, times);
+
+    depsgraph_free();
+    blendfile_free();
+  }
+}
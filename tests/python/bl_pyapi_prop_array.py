@@ -79,6 +79,40 @@ class TestPropArray(unittest.TestCase):
             self.assertEqual(v1, v2)
 
 
+class TestPropCollectionView(unittest.TestCase):
+    def setUp(self):
+        self.mesh = bpy.data.meshes.new("test_foreach_view")
+        self.mesh.from_pydata([(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0)], [], [(0, 1, 2, 3)])
+
+    def tearDown(self):
+        bpy.data.meshes.remove(self.mesh)
+
+    def test_foreach_view_read(self):
+        co = np.asarray(self.mesh.vertices.foreach_view("co"))
+        self.assertEqual(co.shape, (4, 3))
+        self.assertEqual(co.dtype, np.float32)
+        for v, v_co in zip(self.mesh.vertices, co):
+            self.assertEqual(tuple(v.co), tuple(v_co))
+
+        loop_vertex_index = np.asarray(self.mesh.loops.foreach_view("vertex_index"))
+        self.assertEqual(loop_vertex_index.shape, (4,))
+        self.assertEqual(list(loop_vertex_index), [0, 1, 2, 3])
+
+    def test_foreach_view_write(self):
+        co = np.asarray(self.mesh.vertices.foreach_view("co"))
+        co[:, 2] = 5.0
+        self.mesh.update()
+        for v in self.mesh.vertices:
+            self.assertEqual(v.co.z, 5.0)
+
+    def test_foreach_view_invalid(self):
+        with self.assertRaises(AttributeError):
+            self.mesh.vertices.foreach_view("not_an_attribute")
+        # Flags stored as bits are not plain arrays.
+        with self.assertRaises(TypeError):
+            self.mesh.vertices.foreach_view("select")
+
+
 if __name__ == '__main__':
     import sys
     sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])